@@ -18,11 +18,161 @@
 #endif
 
 
-static EVP_CIPHER_CTX *glb_cipher_ctx = NULL; /* need to maintain across calls for MCT */
-
+/*
+ * The cipher context is kept by each thread, see app_thread_cipher_ctx(): an
+ * MCT needs it across calls, and the other test cases reuse it
+ */
 void app_aes_cleanup(void) {
-    if (glb_cipher_ctx) EVP_CIPHER_CTX_free(glb_cipher_ctx);
-    glb_cipher_ctx = NULL;
+    app_thread_state_set(APP_STATE_AES, NULL, NULL);
+}
+
+static const EVP_CIPHER *app_aes_get_mct_cipher(ACVP_CIPHER cipher, unsigned int key_len) {
+    int k = key_len == 128 ? 0 : key_len == 192 ? 1 : key_len == 256 ? 2 : -1;
+
+    if (k < 0) {
+        return NULL;
+    }
+    switch (acvp_get_aes_alg(cipher)) {
+    case ACVP_SUB_AES_ECB:
+        return k == 0 ? EVP_aes_128_ecb() : k == 1 ? EVP_aes_192_ecb() : EVP_aes_256_ecb();
+    case ACVP_SUB_AES_CBC:
+        return k == 0 ? EVP_aes_128_cbc() : k == 1 ? EVP_aes_192_cbc() : EVP_aes_256_cbc();
+    case ACVP_SUB_AES_OFB:
+        return k == 0 ? EVP_aes_128_ofb() : k == 1 ? EVP_aes_192_ofb() : EVP_aes_256_ofb();
+    case ACVP_SUB_AES_CFB1:
+        return k == 0 ? EVP_aes_128_cfb1() : k == 1 ? EVP_aes_192_cfb1() : EVP_aes_256_cfb1();
+    case ACVP_SUB_AES_CFB8:
+        return k == 0 ? EVP_aes_128_cfb8() : k == 1 ? EVP_aes_192_cfb8() : EVP_aes_256_cfb8();
+    case ACVP_SUB_AES_CFB128:
+        return k == 0 ? EVP_aes_128_cfb128() : k == 1 ? EVP_aes_192_cfb128() : EVP_aes_256_cfb128();
+    case ACVP_SUB_AES_GCM:
+    case ACVP_SUB_AES_GCM_SIV:
+    case ACVP_SUB_AES_CCM:
+    case ACVP_SUB_AES_CBC_CS1:
+    case ACVP_SUB_AES_CBC_CS2:
+    case ACVP_SUB_AES_CBC_CS3:
+    case ACVP_SUB_AES_CTR:
+    case ACVP_SUB_AES_XTS:
+    case ACVP_SUB_AES_XPN:
+    case ACVP_SUB_AES_KW:
+    case ACVP_SUB_AES_KWP:
+    case ACVP_SUB_AES_GMAC:
+    default:
+        return NULL;
+    }
+}
+
+/*
+ * Runs a whole inner loop of an AES Monte Carlo test on one cipher context,
+ * feeding each iteration the input the MCT defines for the mode
+ */
+int app_aes_mct_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *tc = NULL;
+    EVP_CIPHER_CTX *cipher_ctx = NULL;
+    const EVP_CIPHER *cipher = NULL;
+    ACVP_SUB_AES alg;
+    unsigned char *in = NULL, *out = NULL, *tail = NULL;
+    unsigned int len = 0;
+    int j = 0, nbits = 128, enc = 0, rv = 1;
+
+    if (!test_case) {
+        return rv;
+    }
+    tc = test_case->tc.symmetric;
+    if (!tc || !tc->mct_tail || tc->test_type != ACVP_SYM_TEST_TYPE_MCT) {
+        return rv;
+    }
+
+    cipher = app_aes_get_mct_cipher(tc->cipher, tc->key_len);
+    if (!cipher) {
+        printf("Error: Unsupported AES mode or key length for MCT\n");
+        return rv;
+    }
+    alg = acvp_get_aes_alg(tc->cipher);
+    if (alg == ACVP_SUB_AES_CFB1) {
+        nbits = 1;
+    } else if (alg == ACVP_SUB_AES_CFB8) {
+        nbits = 8;
+    }
+
+    enc = tc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT;
+    in = enc ? tc->pt : tc->ct;
+    out = enc ? tc->ct : tc->pt;
+    len = enc ? tc->pt_len : tc->ct_len;
+
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
+    if (!cipher_ctx) {
+        printf("Failed to allocate cipher_ctx\n");
+        return rv;
+    }
+    EVP_CIPHER_CTX_reset(cipher_ctx);
+    if (EVP_CipherInit_ex(cipher_ctx, cipher, NULL, tc->key,
+                          alg == ACVP_SUB_AES_ECB ? NULL : tc->iv, enc) != 1) {
+        printf("Error initializing MCT cipher CTX\n");
+        goto end;
+    }
+    EVP_CIPHER_CTX_set_padding(cipher_ctx, 0);
+    if (nbits == 1) {
+        EVP_CIPHER_CTX_set_flags(cipher_ctx, EVP_CIPH_FLAG_LENGTH_BITS);
+    }
+
+    tail = tc->mct_tail;
+    memzero_s(tail, ACVP_SYM_MCT_TAIL_LEN);
+    for (j = 0; j < ACVP_AES_MCT_INNER; j++) {
+        if (EVP_Cipher(cipher_ctx, out, in, len) <= 0) {
+            printf("Error performing MCT operation in AES\n");
+            goto end;
+        }
+        app_mct_shift_in(tail, out, nbits);
+        if (j == ACVP_AES_MCT_INNER - 1) {
+            break;
+        }
+
+        /* Input of the next iteration; the tail ends with this one's output */
+        switch (alg) {
+        case ACVP_SUB_AES_ECB:
+            memcpy_s(in, 16, out, 16);
+            break;
+        case ACVP_SUB_AES_CBC:
+        case ACVP_SUB_AES_OFB:
+        case ACVP_SUB_AES_CFB128:
+            memcpy_s(in, 16, j == 0 ? tc->iv : tail, 16);
+            break;
+        case ACVP_SUB_AES_CFB8:
+            in[0] = j < 16 ? tc->iv[j] : tail[ACVP_SYM_MCT_TAIL_LEN - 1 - 16];
+            break;
+        case ACVP_SUB_AES_CFB1:
+            if (j < 128) {
+                in[0] = (unsigned char)(((tc->iv[j / 8] >> (7 - j % 8)) & 1) << 7);
+            } else {
+                in[0] = (unsigned char)((tail[ACVP_SYM_MCT_TAIL_LEN - 1 - 16] & 1) << 7);
+            }
+            break;
+        case ACVP_SUB_AES_GCM:
+        case ACVP_SUB_AES_GCM_SIV:
+        case ACVP_SUB_AES_CCM:
+        case ACVP_SUB_AES_CBC_CS1:
+        case ACVP_SUB_AES_CBC_CS2:
+        case ACVP_SUB_AES_CBC_CS3:
+        case ACVP_SUB_AES_CTR:
+        case ACVP_SUB_AES_XTS:
+        case ACVP_SUB_AES_XPN:
+        case ACVP_SUB_AES_KW:
+        case ACVP_SUB_AES_KWP:
+        case ACVP_SUB_AES_GMAC:
+        default:
+            goto end;
+        }
+    }
+    if (enc) {
+        tc->ct_len = tc->pt_len;
+    } else {
+        tc->pt_len = tc->ct_len;
+    }
+    rv = 0;
+
+end:
+    return rv;
 }
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -45,18 +195,15 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
 
     tc = test_case->tc.symmetric;
 
-    if (glb_cipher_ctx == NULL) {
-        glb_cipher_ctx = EVP_CIPHER_CTX_new();
-        if (glb_cipher_ctx == NULL) {
-            printf("Failed to allocate global cipher_ctx");
-            return 1;
-        }
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
+    if (cipher_ctx == NULL) {
+        printf("Failed to allocate cipher_ctx");
+        return 1;
     }
 
-    /* Begin encrypt code section */
-    cipher_ctx = glb_cipher_ctx;
-    if ((tc->test_type != ACVP_SYM_TEST_TYPE_MCT)) {
-        EVP_CIPHER_CTX_init(cipher_ctx);
+    /* Begin encrypt code section; an MCT keeps the context from its first iteration on */
+    if (tc->test_type != ACVP_SYM_TEST_TYPE_MCT || tc->mct_index == 0) {
+        EVP_CIPHER_CTX_reset(cipher_ctx);
     }
 
     alg = acvp_get_aes_alg(tc->cipher);
@@ -138,7 +285,7 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
     strncat_s(alg_name, 32, type, strnlen_s(type, 16));
     strncat_s(alg_name, 32, mode, strnlen_s(mode, 16));
 
-    cipher = EVP_CIPHER_fetch(NULL, alg_name, NULL);
+    cipher = app_cipher_fetch(alg_name, NULL);
     if (!cipher) {
         printf("Unable to fetch AES cipher\n");
         goto err;
@@ -191,10 +338,6 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
             printf("Unsupported direction\n");
             goto err;
         }
-        if (tc->mct_index == ACVP_AES_MCT_INNER - 1) {
-            EVP_CIPHER_CTX_free(cipher_ctx);
-            glb_cipher_ctx = NULL;
-        }
     } else {
         pbld = OSSL_PARAM_BLD_new();
         if (!pbld) {
@@ -245,16 +388,13 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
             printf("Unsupported direction\n");
             goto err;
         }
-
-        EVP_CIPHER_CTX_free(cipher_ctx);
-        glb_cipher_ctx = NULL;
     }
     rv = 0;
 
 err:
     if (rv != 0) {
-        if (glb_cipher_ctx) EVP_CIPHER_CTX_free(glb_cipher_ctx);
-        glb_cipher_ctx = NULL;
+        /* Nothing of a failed MCT is to be carried into the next call */
+        EVP_CIPHER_CTX_reset(cipher_ctx);
     }
     if (cipher) EVP_CIPHER_free(cipher);
     if (pbld) OSSL_PARAM_BLD_free(pbld);
@@ -279,12 +419,12 @@ int app_aes_keywrap_handler(ACVP_TEST_CASE *test_case) {
     tc = test_case->tc.symmetric;
 
     /* Begin encrypt code section */
-    cipher_ctx = EVP_CIPHER_CTX_new();
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
     if (!cipher_ctx) {
         printf("Error creating CTX in AES keywrap\n");
         goto err;
     }
-    EVP_CIPHER_CTX_init(cipher_ctx);
+    EVP_CIPHER_CTX_reset(cipher_ctx);
 
     alg = acvp_get_aes_alg(tc->cipher);
     if (alg == 0) {
@@ -347,7 +487,7 @@ int app_aes_keywrap_handler(ACVP_TEST_CASE *test_case) {
         strncat_s(alg_name, 32, inv, strnlen_s(inv, 16));
     }
 
-    cipher = EVP_CIPHER_fetch(NULL, alg_name, NULL);
+    cipher = app_cipher_fetch(alg_name, NULL);
     if (!cipher) {
         printf("Unable to fetch AES cipher\n");
         goto err;
@@ -372,7 +512,6 @@ int app_aes_keywrap_handler(ACVP_TEST_CASE *test_case) {
     rv = 0;
 err:
     /* Cleanup */
-    if (cipher_ctx) EVP_CIPHER_CTX_free(cipher_ctx);
     if (cipher) EVP_CIPHER_free(cipher);
     return rv;
 }
@@ -398,13 +537,13 @@ int app_aes_handler_aead(ACVP_TEST_CASE *test_case) {
     }
 
     /* Begin encrypt code section */
-    cipher_ctx = EVP_CIPHER_CTX_new();
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
     if (!cipher_ctx) {
         printf("Error initializing cipher CTX\n");
         rc = 1;
         goto err;
     }
-    EVP_CIPHER_CTX_init(cipher_ctx);
+    EVP_CIPHER_CTX_reset(cipher_ctx);
 
     /* Validate key length and assign OpenSSL EVP cipher */
     alg = acvp_get_aes_alg(tc->cipher);
@@ -431,7 +570,7 @@ int app_aes_handler_aead(ACVP_TEST_CASE *test_case) {
             goto err;
         }
 
-        cipher = EVP_CIPHER_fetch(NULL, alg_name, NULL);
+        cipher = app_cipher_fetch(alg_name, NULL);
         if (!cipher) {
             printf("Error fetching cipher in AES-GCM\n");
             goto err;
@@ -497,7 +636,7 @@ int app_aes_handler_aead(ACVP_TEST_CASE *test_case) {
             goto err;
         }
 
-        cipher = EVP_CIPHER_fetch(NULL, alg_name, NULL);
+        cipher = app_cipher_fetch(alg_name, NULL);
         if (!cipher) {
             printf("Error fetching cipher in AES-CCM\n");
             goto err;
@@ -557,7 +696,6 @@ int app_aes_handler_aead(ACVP_TEST_CASE *test_case) {
 
 err:
     /* Cleanup */
-    if (cipher_ctx) EVP_CIPHER_CTX_free(cipher_ctx);
     if (cipher) EVP_CIPHER_free(cipher);
     return rc;
 }
@@ -594,7 +732,7 @@ int app_aes_handler_gmac(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    mac = EVP_MAC_fetch(NULL, "GMAC", NULL);
+    mac = app_mac_fetch("GMAC", NULL);
     if (!mac) {
         printf("Error: unable to fetch HMAC");
         goto err;
@@ -680,18 +818,15 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
 
     tc = test_case->tc.symmetric;
 
-    if (glb_cipher_ctx == NULL) {
-        glb_cipher_ctx = EVP_CIPHER_CTX_new();
-        if (glb_cipher_ctx == NULL) {
-            printf("Failed to allocate global cipher_ctx");
-            return 1;
-        }
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
+    if (cipher_ctx == NULL) {
+        printf("Failed to allocate cipher_ctx");
+        return 1;
     }
 
-    /* Begin encrypt code section */
-    cipher_ctx = glb_cipher_ctx;
-    if ((tc->test_type != ACVP_SYM_TEST_TYPE_MCT)) {
-        EVP_CIPHER_CTX_init(cipher_ctx);
+    /* Begin encrypt code section; an MCT keeps the context from its first iteration on */
+    if (tc->test_type != ACVP_SYM_TEST_TYPE_MCT || tc->mct_index == 0) {
+        EVP_CIPHER_CTX_reset(cipher_ctx);
     }
 
     alg = acvp_get_aes_alg(tc->cipher);
@@ -899,10 +1034,6 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
             rv = 1;
             goto err;
         }
-        if (tc->mct_index == ACVP_AES_MCT_INNER - 1) {
-            EVP_CIPHER_CTX_free(cipher_ctx);
-            glb_cipher_ctx = NULL;
-        }
     } else {
         if (tc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             EVP_CipherInit_ex(cipher_ctx, cipher, NULL, tc->key, iv, 1);
@@ -925,13 +1056,11 @@ int app_aes_handler(ACVP_TEST_CASE *test_case) {
             rv = 1;
             goto err;
         }
-        EVP_CIPHER_CTX_free(cipher_ctx);
-        glb_cipher_ctx = NULL;
     }
     return rv;
 err:
-    if (glb_cipher_ctx) EVP_CIPHER_CTX_free(glb_cipher_ctx);
-    glb_cipher_ctx = NULL;
+    /* Nothing of a failed MCT is to be carried into the next call */
+    EVP_CIPHER_CTX_reset(cipher_ctx);
     return rv;
 }
 
@@ -956,12 +1085,12 @@ int app_aes_keywrap_handler(ACVP_TEST_CASE *test_case) {
     }
 
     /* Begin encrypt code section */
-    cipher_ctx = EVP_CIPHER_CTX_new();
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
     if (!cipher_ctx) {
         printf("Error creating CTX in AES keywrap\n");
         goto end;
     }
-    EVP_CIPHER_CTX_init(cipher_ctx);
+    EVP_CIPHER_CTX_reset(cipher_ctx);
 
     alg = acvp_get_aes_alg(tc->cipher);
     if (alg == 0) {
@@ -1039,9 +1168,6 @@ int app_aes_keywrap_handler(ACVP_TEST_CASE *test_case) {
     rc = 0;
 
 end:
-    /* Cleanup */
-    if (cipher_ctx) EVP_CIPHER_CTX_free(cipher_ctx);
-
     return rc;
 }
 
@@ -1075,13 +1201,13 @@ int app_aes_handler_aead(ACVP_TEST_CASE *test_case) {
     }
 
     /* Begin encrypt code section */
-    cipher_ctx = EVP_CIPHER_CTX_new();
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_AES);
     if (!cipher_ctx) {
         printf("Error initializing cipher CTX\n");
         rc = 1;
         goto end;
     }
-    EVP_CIPHER_CTX_init(cipher_ctx);
+    EVP_CIPHER_CTX_reset(cipher_ctx);
 
     /* Validate key length and assign OpenSSL EVP cipher */
     alg = acvp_get_aes_alg(tc->cipher);
@@ -1242,9 +1368,6 @@ int app_aes_handler_aead(ACVP_TEST_CASE *test_case) {
     }
 
 end:
-    /* Cleanup */
-    if (cipher_ctx) EVP_CIPHER_CTX_free(cipher_ctx);
-
     return rc;
 }
 
@@ -9,6 +9,8 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
 #include "ketopt.h"
 #include "app_lcl.h"
 #include "acvp/acvp.h"
@@ -38,6 +40,8 @@ static void print_usage(int code) {
     printf("      --status(default)\n");
     printf("      --info\n");
     printf("      --verbose\n");
+    printf("To write the log from a thread of its own, so that verbose logging does not slow testing:\n");
+    printf("      --async_log\n");
     printf("\n");
     if (code >= ACVP_LOG_LVL_VERBOSE) {
         printf("-The warn logging level logs events that should be acted upon but do not halt\n");
@@ -107,6 +111,10 @@ static void print_usage(int code) {
     printf("To retreive and output the JSON form of the currently registered capabilities:\n");
     printf("      --get_registration\n");
     printf("\n");
+    printf("To print the vector sets the registration is expected to generate, with the time and memory\n");
+    printf("each is expected to take and the wall time of the run with --parallel_vector_sets:\n");
+    printf("      --cost\n");
+    printf("\n");
     printf("To register and save the vectors to file:\n");
     printf("      --vector_req <file>\n");
     printf("      -r <file>\n");
@@ -117,18 +125,73 @@ static void print_usage(int code) {
     printf("      OR\n");
     printf("      -r <file>\n");
     printf("      -p <file>\n");
+    printf("            Note: either may be - to stream from stdin or to stdout, a vector set at a time\n");
+    printf("\n");
+    printf("To save vectors and responses to file as compact rather than pretty printed JSON:\n");
+    printf("      --compact\n");
+    printf("\n");
+    printf("To process up to N vector sets at once, each on its own thread and connection:\n");
+    printf("      --parallel_vector_sets <N>\n");
+    printf("\n");
+    printf("To spread the test cases of a test group across up to N threads:\n");
+    printf("      --threads <N>\n");
+    printf("\n");
+    printf("To pin the threads processing vector sets to CPUs, or spread them across NUMA nodes:\n");
+    printf("      --cpu_affinity <cpu>[-<cpu>][,...]\n");
+    printf("      --numa_affinity <node>[-<node>][,...] | all\n");
+    printf("\n");
+    printf("To write the time spent on, and memory held for, each vector set and test group to file as CSV:\n");
+    printf("      --metrics <file>\n");
+    printf("\n");
+    printf("To process only some of the saved vectors, by vsId or as shard k of N:\n");
+    printf("      --vs_ids <vsId>[,<vsId>...]\n");
+    printf("      --shard <k>/<N>\n");
+    printf("\n");
+    printf("To merge the response files of several shards into the file given by --vector_rsp:\n");
+    printf("      --merge_rsp <file>\n");
+    printf("            Note: give --merge_rsp once for each file to merge\n");
+    printf("\n");
+    printf("To save finished test groups to a journal, so a resumed or rerun session skips them:\n");
+    printf("      --journal <file>\n");
+    printf("\n");
+    printf("To keep downloaded vector sets in a directory, so a resumed session does not download them again:\n");
+    printf("      --vs_cache_dir <dir>\n");
+    printf("\n");
+    printf("To have worker processes sharing <dir> run the vector sets of the session, and to be one of them:\n");
+    printf("      --remote_workers <dir>\n");
+    printf("      --remote_worker <dir>\n");
+    printf("\n");
+    printf("To move the responses of a vector set to disk once they are larger than <MB> megabytes:\n");
+    printf("      --memory_budget <MB>\n");
+    printf("\n");
+    printf("To back large buffers, such as those vector sets are downloaded into, with huge pages:\n");
+    printf("      --huge_pages\n");
+    printf("\n");
+    printf("To give up on a GET from the server after <ms> milliseconds, and send it once more:\n");
+    printf("      --request_timeout <ms>\n");
+    printf("\n");
+    printf("To send a GET again when the server is slower than usual to answer it, taking the first answer:\n");
+    printf("      --hedge\n");
+    printf("\n");
+    printf("To connect to the server in the background while the capabilities are registered:\n");
+    printf("      --preconnect\n");
     printf("\n");
     printf("To upload vector responses from file:\n");
     printf("      --vector_upload <file>\n");
     printf("      -u <file>\n");
+    printf("            Note: <file> may be - to read from stdin\n");
     printf("\n");
-    printf("Note: --resume_session and --get_results use the test session info file created automatically by the library as input\n");
+    printf("Note: --resume_session, --rerun_failed and --get_results use the test session info file created automatically by the library as input\n");
     printf("\n");
     printf("To resume a previous test session that was interupted:\n");
     printf("      --resume_session <session_file>\n");
     printf("            Note: this does not save your arguments from your initial run and you MUST include them\n");
     printf("            again (e.x. --aes,  --vector_req and --fips_validation)\n");
     printf("\n");
+    printf("To run again only the vector sets of a test session that failed, and submit the new responses:\n");
+    printf("      --rerun_failed <session_file>\n");
+    printf("            Note: as with --resume_session, the arguments of the initial run MUST be included again\n");
+    printf("\n");
     printf("To cancel a test session that was previously initiated:\n");
     printf("      --cancel_session <session_file>\n");
     printf("            Note: This will request the server to halt all processing and delete all info related to the\n");
@@ -154,6 +217,10 @@ static void print_usage(int code) {
     printf("To get the expected results of a sample test session:\n");
     printf("      --get_expected_results <session_file>\n");
     printf("\n");
+    printf("To check the responses given by --vector_rsp against the saved expected results:\n");
+    printf("      --verify_expected <file>\n");
+    printf("            Note: with --vector_req too, the vectors are processed first\n");
+    printf("\n");
     printf("Some other options may support outputting to log OR saving to a file. To save to a file:\n");
     printf("      --save_to <file>\n");
     printf("      -s <file>\n");
@@ -237,6 +304,27 @@ static ko_longopt_t longopts[] = {
     { "debug", ko_no_argument, 417 },
     { "get_registration", ko_no_argument, 418 },
     { "set_max_hash_size", ko_required_argument, 419 },
+    { "compact", ko_no_argument, 420 },
+    { "threads", ko_required_argument, 421 },
+    { "parallel_vector_sets", ko_required_argument, 422 },
+    { "metrics", ko_required_argument, 423 },
+    { "vs_ids", ko_required_argument, 424 },
+    { "shard", ko_required_argument, 425 },
+    { "merge_rsp", ko_required_argument, 426 },
+    { "journal", ko_required_argument, 427 },
+    { "async_log", ko_no_argument, 428 },
+    { "preconnect", ko_no_argument, 429 },
+    { "verify_expected", ko_required_argument, 430 },
+    { "vs_cache_dir", ko_required_argument, 431 },
+    { "memory_budget", ko_required_argument, 432 },
+    { "cpu_affinity", ko_required_argument, 433 },
+    { "numa_affinity", ko_required_argument, 434 },
+    { "remote_workers", ko_required_argument, 435 },
+    { "remote_worker", ko_required_argument, 436 },
+    { "huge_pages", ko_no_argument, 437 },
+    { "request_timeout", ko_required_argument, 438 },
+    { "hedge", ko_no_argument, 439 },
+    { "rerun_failed", ko_required_argument, 440 },
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     { "disable_fips", ko_no_argument, 500 },
 #endif
@@ -295,6 +383,66 @@ static int check_option_length(const char *opt, int c, int maxAllowed) {
     return 1;
 }
 
+/* Reads a comma separated list of vsIds; returns 0 on success */
+static int app_parse_vs_ids(APP_CONFIG *cfg, const char *arg) {
+    const char *p = arg;
+    char *end = NULL;
+    long id = 0;
+
+    while (*p) {
+        if (cfg->vs_id_cnt >= APP_VS_IDS_MAX) {
+            printf("Too many vsIds provided (max %d)\n", APP_VS_IDS_MAX);
+            return 1;
+        }
+        id = strtol(p, &end, 10);
+        if (end == p || id < 1 || id > INT_MAX || (*end && *end != ',')) {
+            printf("Error reading in vsIds: invalid argument provided\n");
+            return 1;
+        }
+        cfg->vs_ids[cfg->vs_id_cnt++] = (int)id;
+        p = *end ? end + 1 : end;
+    }
+    if (!cfg->vs_id_cnt) {
+        printf("Error reading in vsIds: invalid argument provided\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* Reads a comma separated list of CPUs or NUMA nodes and ranges of them; returns 0 on success */
+static int app_parse_affinity_ids(APP_CONFIG *cfg, const char *arg) {
+    const char *p = arg;
+    char *end = NULL;
+    long lo = 0, hi = 0;
+
+    cfg->affinity_cnt = 0;
+    while (*p) {
+        lo = strtol(p, &end, 10);
+        hi = lo;
+        if (end != p && *end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+        }
+        if (end == p || lo < 0 || hi < lo || hi >= APP_AFFINITY_IDS_MAX || (*end && *end != ',')) {
+            printf("Error reading in affinity: invalid argument provided\n");
+            return 1;
+        }
+        for (; lo <= hi; lo++) {
+            if (cfg->affinity_cnt >= APP_AFFINITY_IDS_MAX) {
+                printf("Too many CPUs or NUMA nodes provided (max %d)\n", APP_AFFINITY_IDS_MAX);
+                return 1;
+            }
+            cfg->affinity_ids[cfg->affinity_cnt++] = (int)lo;
+        }
+        p = *end ? end + 1 : end;
+    }
+    if (!cfg->affinity_cnt) {
+        printf("Error reading in affinity: invalid argument provided\n");
+        return 1;
+    }
+    return 0;
+}
+
 int ingest_cli(APP_CONFIG *cfg, int argc, char **argv) {
     ketopt_t opt = KETOPT_INIT;
     int c = 0, diff = 0, len = 0, print_ver = 0, ldt_manually_set = 0;
@@ -585,6 +733,155 @@ int ingest_cli(APP_CONFIG *cfg, int argc, char **argv) {
             ldt_manually_set = 1;
             break;
 
+        case 420:
+            cfg->compact = 1;
+            break;
+
+        case 421:
+        case 422:
+            len = 0;
+            if (sscanf(opt.arg, "%d", &len) != 1) {
+                printf("Error reading in %s: invalid argument provided\n", lookup_arg_name(c));
+                return 1;
+            }
+            if (len < 1 || len > 64) {
+                printf("Provided %s invalid (must be > 0 and <= 64)\n", lookup_arg_name(c));
+                return 1;
+            }
+            if (c == 421) {
+                cfg->threads = len;
+            } else {
+                cfg->parallel_vs = len;
+            }
+            break;
+
+        case 423:
+            cfg->metrics = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->metrics_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 424:
+            if (app_parse_vs_ids(cfg, opt.arg)) {
+                return 1;
+            }
+            break;
+
+        case 425:
+            if (sscanf(opt.arg, "%d/%d", &cfg->shard, &cfg->shard_cnt) != 2 ||
+                    cfg->shard_cnt < 1 || cfg->shard < 1 || cfg->shard > cfg->shard_cnt) {
+                printf("Provided shard invalid (must be <k>/<N> with 1 <= k <= N)\n");
+                return 1;
+            }
+            break;
+
+        case 426:
+            if (cfg->merge_cnt >= APP_MERGE_FILES_MAX) {
+                printf("Too many files to merge (max %d)\n", APP_MERGE_FILES_MAX);
+                return 1;
+            }
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->merge_files[cfg->merge_cnt], JSON_FILENAME_LENGTH + 1, opt.arg);
+            cfg->merge_cnt++;
+            break;
+
+        case 427:
+            cfg->journal = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->journal_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 428:
+            cfg->async_log = 1;
+            break;
+
+        case 429:
+            cfg->preconnect = 1;
+            break;
+
+        case 430:
+            cfg->verify_expected = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->expected_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 431:
+            cfg->vs_cache = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->vs_cache_dir, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 435:
+        case 436:
+            cfg->remote = c == 435 ? 1 : 2;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->remote_dir, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 432:
+            len = 0;
+            if (sscanf(opt.arg, "%d", &len) != 1 || len < 1) {
+                printf("Error reading in %s: invalid argument provided (must be > 0)\n", lookup_arg_name(c));
+                return 1;
+            }
+            cfg->memory_budget = len;
+            break;
+
+        case 437:
+            cfg->huge_pages = 1;
+            break;
+
+        case 438:
+            len = 0;
+            if (sscanf(opt.arg, "%d", &len) != 1 || len < 1) {
+                printf("Error reading in %s: invalid argument provided (must be > 0)\n", lookup_arg_name(c));
+                return 1;
+            }
+            cfg->request_timeout = len;
+            break;
+
+        case 439:
+            cfg->hedge = 1;
+            break;
+
+        case 440:
+            cfg->rerun_failed = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->session_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 433:
+            cfg->affinity = ACVP_AFFINITY_CPUS;
+            if (app_parse_affinity_ids(cfg, opt.arg)) {
+                return 1;
+            }
+            break;
+
+        case 434:
+            cfg->affinity = ACVP_AFFINITY_NUMA;
+            len = strnlen_s(opt.arg, 4);
+            strncmp_s(opt.arg, len, "all", 3, &diff);
+            if (len == 3 && !diff) {
+                cfg->affinity_cnt = 0;
+            } else if (app_parse_affinity_ids(cfg, opt.arg)) {
+                return 1;
+            }
+            break;
+
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
         case 500:
             cfg->disable_fips = 1;
@@ -628,7 +925,8 @@ int ingest_cli(APP_CONFIG *cfg, int argc, char **argv) {
     //Many args do not need an alg specified. Todo: make cleaner
     if (cfg->empty_alg && !cfg->post && !cfg->get && !cfg->put && !cfg->get_results
             && !cfg->get_expected && !cfg->manual_reg && !cfg->vector_upload
-            && !cfg->delete && !cfg->cancel_session && !(cfg->resume_session && 
+            && !cfg->delete && !cfg->cancel_session && !cfg->merge_cnt && !cfg->verify_expected
+            && !((cfg->resume_session || cfg->rerun_failed) &&
             cfg->vector_req)) {
         /* The user needs to select at least 1 algorithm */
         printf(ANSI_COLOR_RED "Requires at least 1 Algorithm Test Suite\n"ANSI_COLOR_RESET);
@@ -636,7 +934,10 @@ int ingest_cli(APP_CONFIG *cfg, int argc, char **argv) {
         return 1;
     }
 
-    printf("\n");
+    /* stdout is left to the responses when --vector_rsp is - */
+    if (!cfg->vector_rsp || cfg->vector_rsp_file[0] != '-' || cfg->vector_rsp_file[1]) {
+        printf("\n");
+    }
 
     return 0;
 }
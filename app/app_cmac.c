@@ -19,6 +19,64 @@
 #endif
 
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static const char *app_cmac_cipher_name(ACVP_SUB_CMAC alg, int key_len) {
+    switch (alg) {
+    case ACVP_SUB_CMAC_AES:
+        switch (key_len * 8) {
+        case 128:
+            return "aes-128-cbc";
+        case 192:
+            return "aes-192-cbc";
+        case 256:
+            return "aes-256-cbc";
+        default:
+            return NULL;
+        }
+    case ACVP_SUB_CMAC_TDES:
+        return "des-ede3-cbc";
+    default:
+        return NULL;
+    }
+}
+
+/*
+ * Sets up the CMAC of a test group once, so its test cases only need to key
+ * it, see app_mac_group_ctx()
+ */
+int app_cmac_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_CMAC_TC *stc = NULL;
+    const char *alg_name = NULL;
+
+    if (!test_case || !test_case->tc.cmac) {
+        return 1;
+    }
+    stc = test_case->tc.cmac;
+
+    if (event == ACVP_TG_END) {
+        app_mac_group_free(stc->tg_ctx);
+        stc->tg_ctx = NULL;
+        return 0;
+    }
+
+    alg_name = app_cmac_cipher_name(acvp_get_cmac_alg(stc->cipher), stc->key_len);
+    if (!alg_name) {
+        printf("Error: Unsupported CMAC algorithm requested by ACVP server\n");
+        return 1;
+    }
+    stc->tg_ctx = app_mac_group_new("CMAC", OSSL_MAC_PARAM_CIPHER, alg_name);
+    return stc->tg_ctx ? 0 : 1;
+}
+#else
+int app_cmac_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+#endif
+
 int app_cmac_handler(ACVP_TEST_CASE *test_case) {
     ACVP_CMAC_TC *tc;
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -57,26 +115,14 @@ int app_cmac_handler(ACVP_TEST_CASE *test_case) {
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
  switch (alg) {
     case ACVP_SUB_CMAC_AES:
-        switch (tc->key_len * 8) {
-        case 128:
-            alg_name = "aes-128-cbc";
-            break;
-        case 192:
-            alg_name = "aes-192-cbc";
-            break;
-        case 256:
-            alg_name = "aes-256-cbc";
-            break;
-        default:
-            break;
-        }
+        alg_name = app_cmac_cipher_name(alg, tc->key_len);
         key_len = (tc->key_len);
         for (i = 0; i < key_len; i++) {
             full_key[i] = tc->key[i];
         }
         break;
     case ACVP_SUB_CMAC_TDES:
-        alg_name = "des-ede3-cbc";
+        alg_name = app_cmac_cipher_name(alg, tc->key_len);
         for (i = 0; i < 8; i++) {
             full_key[i] = tc->key[i];
         }
@@ -95,7 +141,17 @@ int app_cmac_handler(ACVP_TEST_CASE *test_case) {
 
     full_key[key_len] = '\0';
 
-    mac = EVP_MAC_fetch(NULL, "CMAC", NULL);
+    if (tc->tg_ctx) {
+        /* The group handler has the MAC set up; only the key may be new */
+        cmac_ctx = app_mac_group_ctx(tc->tg_ctx, tc->key_id, (unsigned char *)full_key, key_len);
+        if (!cmac_ctx) {
+            printf("\nCrypto module error, unable to key the CMAC of the group\n");
+            goto end;
+        }
+        goto update;
+    }
+
+    mac = app_mac_fetch("CMAC", NULL);
     if (!mac) {
         printf("Error: unable to fetch CMAC");
         goto end;
@@ -124,6 +180,7 @@ int app_cmac_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
+update:
     if (!EVP_MAC_update(cmac_ctx, tc->msg, tc->msg_len)) {
         printf("\nCrypto module error, EVP_MAC_update failed\n");
         goto end;
@@ -232,7 +289,7 @@ int app_cmac_handler(ACVP_TEST_CASE *test_case) {
 
 end:
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    if (cmac_ctx) EVP_MAC_CTX_free(cmac_ctx);
+    if (cmac_ctx && !tc->tg_ctx) EVP_MAC_CTX_free(cmac_ctx);
     if (mac) EVP_MAC_free(mac);
     if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (params) OSSL_PARAM_free(params);
@@ -15,16 +15,185 @@
 #include "safe_lib.h"
 
 
-static EVP_CIPHER_CTX *glb_cipher_ctx = NULL; /* need to maintain across calls for MCT */
-
+/*
+ * The cipher context is kept by each thread, see app_thread_cipher_ctx(): an
+ * MCT needs it across calls, and the other test cases reuse it
+ */
 void app_des_cleanup(void) {
-    if (glb_cipher_ctx) EVP_CIPHER_CTX_free(glb_cipher_ctx);
-    glb_cipher_ctx = NULL;
+    app_thread_state_set(APP_STATE_DES, NULL, NULL);
+}
+
+static void app_des_get_ctx_iv(EVP_CIPHER_CTX *cipher_ctx, unsigned char *iv) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_CIPHER_CTX_get_updated_iv(cipher_ctx, (void *)iv, 8);
+#else
+    memcpy_s(iv, 8, EVP_CIPHER_CTX_iv(cipher_ctx), 8);
+#endif
+}
+
+/*
+ * Runs a whole inner loop of a TDES Monte Carlo test on one cipher context,
+ * feeding each iteration the input the MCT defines for the mode
+ */
+int app_des_mct_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *tc = NULL;
+    EVP_CIPHER_CTX *cipher_ctx = NULL;
+    const EVP_CIPHER *cipher = NULL;
+    unsigned char *in = NULL, *out = NULL, *tail = NULL;
+    ACVP_SUB_TDES alg;
+    unsigned char old_iv[8];
+    unsigned int len = 0;
+    int j = 0, n = 0, nbits = 64, enc = 0, rv = 1;
+
+    if (!test_case) {
+        return rv;
+    }
+    tc = test_case->tc.symmetric;
+    if (!tc || !tc->mct_tail || !tc->iv_ret || !tc->iv_ret_after ||
+            tc->test_type != ACVP_SYM_TEST_TYPE_MCT) {
+        return rv;
+    }
+    if (tc->key_len != 192) {
+        printf("Unsupported DES key length\n");
+        return rv;
+    }
+
+    alg = acvp_get_tdes_alg(tc->cipher);
+    switch (alg) {
+    case ACVP_SUB_TDES_ECB:
+        cipher = EVP_des_ede3_ecb();
+        break;
+    case ACVP_SUB_TDES_CBC:
+        cipher = EVP_des_ede3_cbc();
+        break;
+    case ACVP_SUB_TDES_OFB:
+        cipher = EVP_des_ede3_ofb();
+        break;
+    case ACVP_SUB_TDES_CFB64:
+        cipher = EVP_des_ede3_cfb64();
+        break;
+    case ACVP_SUB_TDES_CFB8:
+        cipher = EVP_des_ede3_cfb8();
+        nbits = 8;
+        break;
+    case ACVP_SUB_TDES_CFB1:
+        cipher = EVP_des_ede3_cfb1();
+        nbits = 1;
+        break;
+    case ACVP_SUB_TDES_CBCI:
+    case ACVP_SUB_TDES_OFBI:
+    case ACVP_SUB_TDES_CFBP1:
+    case ACVP_SUB_TDES_CFBP8:
+    case ACVP_SUB_TDES_CFBP64:
+    case ACVP_SUB_TDES_CTR:
+    case ACVP_SUB_TDES_KW:
+    default:
+        printf("Error: Unsupported DES mode for MCT\n");
+        return rv;
+    }
+
+    enc = tc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT;
+    in = enc ? tc->pt : tc->ct;
+    out = enc ? tc->ct : tc->pt;
+    len = enc ? tc->pt_len : tc->ct_len;
+    memcpy_s(old_iv, sizeof(old_iv), tc->iv, 8);
+
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_DES);
+    if (!cipher_ctx) {
+        printf("Failed to allocate cipher_ctx\n");
+        return rv;
+    }
+    EVP_CIPHER_CTX_reset(cipher_ctx);
+    if (EVP_CipherInit_ex(cipher_ctx, cipher, NULL, tc->key,
+                          alg == ACVP_SUB_TDES_ECB ? NULL : tc->iv, enc) != 1) {
+        printf("Error initializing MCT cipher CTX\n");
+        goto end;
+    }
+    EVP_CIPHER_CTX_set_padding(cipher_ctx, 0);
+    if (nbits == 1) {
+        EVP_CIPHER_CTX_set_flags(cipher_ctx, EVP_CIPH_FLAG_LENGTH_BITS);
+    }
+
+    tail = tc->mct_tail;
+    memzero_s(tail, ACVP_SYM_MCT_TAIL_LEN);
+    for (j = 0; j < ACVP_DES_MCT_INNER; j++) {
+        /* TDES needs the pre-operation IV returned */
+        if (j > 0) {
+            app_des_get_ctx_iv(cipher_ctx, tc->iv_ret);
+        }
+        if (EVP_Cipher(cipher_ctx, out, in, len) <= 0) {
+            printf("Error performing MCT operation in TDES\n");
+            goto end;
+        }
+        app_mct_shift_in(tail, out, nbits);
+        if (j == ACVP_DES_MCT_INNER - 1) {
+            /* ...and the post-operation IV of the last one */
+            app_des_get_ctx_iv(cipher_ctx, tc->iv_ret_after);
+            break;
+        }
+
+        /* Input of the next iteration; the tail ends with this one's output */
+        switch (alg) {
+        case ACVP_SUB_TDES_ECB:
+            memcpy_s(in, 8, out, 8);
+            break;
+        case ACVP_SUB_TDES_CBC:
+            if (enc) {
+                memcpy_s(in, 8, j == 0 ? old_iv : tail + ACVP_SYM_MCT_TAIL_LEN - 16, 8);
+            } else {
+                memcpy_s(in, 8, out, 8);
+            }
+            break;
+        case ACVP_SUB_TDES_CFB64:
+        case ACVP_SUB_TDES_CFB8:
+        case ACVP_SUB_TDES_CFB1:
+            if (enc && alg == ACVP_SUB_TDES_CFB64) {
+                memcpy_s(in, 8, j == 0 ? old_iv : tail + ACVP_SYM_MCT_TAIL_LEN - 16, 8);
+            } else if (enc) {
+                memcpy_s(in, 8, j == 0 ? old_iv : tc->iv_ret, 8);
+            } else {
+                for (n = 0; n < 8; n++) {
+                    in[n] ^= out[n];
+                }
+            }
+            break;
+        case ACVP_SUB_TDES_OFB:
+            memcpy_s(in, 8, j == 0 ? old_iv : tc->iv_ret, 8);
+            break;
+        case ACVP_SUB_TDES_CBCI:
+        case ACVP_SUB_TDES_OFBI:
+        case ACVP_SUB_TDES_CFBP1:
+        case ACVP_SUB_TDES_CFBP8:
+        case ACVP_SUB_TDES_CFBP64:
+        case ACVP_SUB_TDES_CTR:
+        case ACVP_SUB_TDES_KW:
+        default:
+            goto end;
+        }
+    }
+    if (enc) {
+        tc->ct_len = tc->pt_len;
+    } else {
+        tc->pt_len = tc->ct_len;
+    }
+    rv = 0;
+
+end:
+    return rv;
+}
+
+/*
+ * Runs a whole TDES Monte Carlo test. The checkpoints are chained by
+ * libacvp's reference loop, which hands each inner loop straight to
+ * app_des_mct_handler().
+ */
+int app_des_mct_loop_handler(ACVP_TEST_CASE *test_case) {
+    return acvp_des_mct_loop(test_case, &app_des_mct_handler) == ACVP_SUCCESS ? 0 : 1;
 }
 
 int app_des_handler(ACVP_TEST_CASE *test_case) {
     ACVP_SYM_CIPHER_TC *tc;
-    EVP_CIPHER_CTX *cipher_ctx;
+    EVP_CIPHER_CTX *cipher_ctx = NULL;
     const EVP_CIPHER *cipher;
     unsigned char *iv = 0;
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -52,12 +221,10 @@ int app_des_handler(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    if (glb_cipher_ctx == NULL) {
-        glb_cipher_ctx = EVP_CIPHER_CTX_new();
-        if (glb_cipher_ctx == NULL) {
-            printf("Failed to allocate global cipher_ctx\n");
-            goto err;
-        }
+    cipher_ctx = app_thread_cipher_ctx(APP_STATE_DES);
+    if (cipher_ctx == NULL) {
+        printf("Failed to allocate cipher_ctx\n");
+        goto err;
     }
 
     if (!tc->iv_ret || !tc->iv_ret_after) {
@@ -65,8 +232,10 @@ int app_des_handler(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    /* Begin encrypt code section */
-    cipher_ctx = glb_cipher_ctx;
+    /* Begin encrypt code section; an MCT keeps the context from its first iteration on */
+    if (tc->test_type != ACVP_SYM_TEST_TYPE_MCT || tc->mct_index == 0) {
+        EVP_CIPHER_CTX_reset(cipher_ctx);
+    }
 
     alg = acvp_get_tdes_alg(tc->cipher);
     if (alg == 0) {
@@ -179,10 +348,6 @@ int app_des_handler(ACVP_TEST_CASE *test_case) {
             printf("Unsupported direction\n");
             goto err;
         }
-        if (tc->mct_index == ACVP_DES_MCT_INNER - 1) {
-            EVP_CIPHER_CTX_free(cipher_ctx);
-            glb_cipher_ctx = NULL;
-        }
     } else {
         if (tc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             EVP_CipherInit_ex(cipher_ctx, cipher, NULL, tc->key, iv, 1);
@@ -204,9 +369,6 @@ int app_des_handler(ACVP_TEST_CASE *test_case) {
             printf("Unsupported direction\n");
             goto err;
         }
-
-        EVP_CIPHER_CTX_free(glb_cipher_ctx);
-        glb_cipher_ctx = NULL;
     }
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     if (ctx_iv) free(ctx_iv);
@@ -216,8 +378,8 @@ err:
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     if (ctx_iv) free(ctx_iv);
 #endif
-    if (glb_cipher_ctx) EVP_CIPHER_CTX_free(glb_cipher_ctx);
-    glb_cipher_ctx = NULL;
+    /* Nothing of a failed MCT is to be carried into the next call */
+    if (cipher_ctx) EVP_CIPHER_CTX_reset(cipher_ctx);
     return 1;
 }
 
@@ -16,10 +16,76 @@
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
 #include <openssl/core_names.h>
 
+/*
+ * What the tests of a group share: the DRBG implementations, fetched once
+ * instead of for every test case
+ */
+typedef struct app_drbg_group_t {
+    EVP_RAND *test_rand;
+    EVP_RAND *rand;
+} APP_DRBG_GROUP;
+
+static const char *app_drbg_alg_name(ACVP_CIPHER cipher) {
+    switch (acvp_get_drbg_alg(cipher)) {
+    case ACVP_SUB_DRBG_HASH:
+        return "HASH-DRBG";
+    case ACVP_SUB_DRBG_HMAC:
+        return "HMAC-DRBG";
+    case ACVP_SUB_DRBG_CTR:
+        return "CTR-DRBG";
+    default:
+        return NULL;
+    }
+}
+
+int app_drbg_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_DRBG_TC *tc;
+    APP_DRBG_GROUP *group = NULL;
+    const char *alg_name = NULL;
+
+    if (!test_case) {
+        return 1;
+    }
+    tc = test_case->tc.drbg;
+
+    if (event == ACVP_TG_END) {
+        group = tc->tg_ctx;
+        if (group) {
+            if (group->test_rand) EVP_RAND_free(group->test_rand);
+            if (group->rand) EVP_RAND_free(group->rand);
+            free(group);
+            tc->tg_ctx = NULL;
+        }
+        return 0;
+    }
+
+    alg_name = app_drbg_alg_name(tc->cipher);
+    if (!alg_name) {
+        printf("Invalid DRBG cipher value\n");
+        return 1;
+    }
+    group = calloc(1, sizeof(APP_DRBG_GROUP));
+    if (!group) {
+        return 1;
+    }
+    /* See the note about TEST-RAND in app_drbg_handler() */
+    group->test_rand = app_rand_fetch("TEST-RAND", "fips=no");
+    group->rand = app_rand_fetch(alg_name, NULL);
+    if (!group->test_rand || !group->rand) {
+        printf("Error fetching DRBG implementations\n");
+        if (group->test_rand) EVP_RAND_free(group->test_rand);
+        if (group->rand) EVP_RAND_free(group->rand);
+        free(group);
+        return 1;
+    }
+    tc->tg_ctx = group;
+    return 0;
+}
+
 int app_drbg_handler(ACVP_TEST_CASE *test_case) {
     int rv = 1, der_func = 0;
     ACVP_DRBG_TC *tc;
-    ACVP_SUB_DRBG alg;
+    APP_DRBG_GROUP *group = NULL;
     EVP_RAND *rand = NULL;
     EVP_RAND_CTX *rctx = NULL, *test = NULL;
     OSSL_PARAM params[10] = { 0 };
@@ -38,25 +104,17 @@ int app_drbg_handler(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    alg = acvp_get_drbg_alg(tc->cipher);
-
-    switch (alg) {
-    case ACVP_SUB_DRBG_HASH:
-        alg_name = "HASH-DRBG";
-        param_str = OSSL_DRBG_PARAM_DIGEST;
-        break;
-    case ACVP_SUB_DRBG_HMAC:
-        alg_name = "HMAC-DRBG";
-        param_str = OSSL_DRBG_PARAM_DIGEST;
-        break;
-    case ACVP_SUB_DRBG_CTR:
-        alg_name = "CTR-DRBG";
-        param_str = OSSL_DRBG_PARAM_CIPHER;
-        break;
-    default:
+    alg_name = app_drbg_alg_name(tc->cipher);
+    if (!alg_name) {
         printf("Invalid DRBG cipher value\n");
         goto err;
     }
+    if (acvp_get_drbg_alg(tc->cipher) == ACVP_SUB_DRBG_CTR) {
+        param_str = OSSL_DRBG_PARAM_CIPHER;
+    } else {
+        param_str = OSSL_DRBG_PARAM_DIGEST;
+    }
+    group = tc->tg_ctx;
 
     switch (tc->mode) {
     case ACVP_DRBG_SHA_1:
@@ -119,7 +177,11 @@ int app_drbg_handler(ACVP_TEST_CASE *test_case) {
     * the property "fips=yes", which we use in the default library context. It has to be used with
     * fips=no in order to run it. Do NOT run this outside of the context of testing in any situation.
     */
-    rand = EVP_RAND_fetch(NULL, "TEST-RAND", "fips=no");
+    if (group && EVP_RAND_up_ref(group->test_rand)) {
+        rand = group->test_rand;
+    } else {
+        rand = app_rand_fetch("TEST-RAND", "fips=no");
+    }
 
     test = EVP_RAND_CTX_new(rand, NULL);
     if (rand) EVP_RAND_free(rand);
@@ -136,7 +198,11 @@ int app_drbg_handler(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    rand = EVP_RAND_fetch(NULL, alg_name, NULL);
+    if (group && EVP_RAND_up_ref(group->rand)) {
+        rand = group->rand;
+    } else {
+        rand = app_rand_fetch(alg_name, NULL);
+    }
     rctx = EVP_RAND_CTX_new(rand, test);
     if (!rctx) {
         printf("Error creating DRBG ctx\n");
@@ -221,6 +287,13 @@ err:
 
 #else
 
+int app_drbg_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    return 0;
+}
+
 int app_drbg_handler(ACVP_TEST_CASE *test_case) {
     if (!test_case) {
         return -1;
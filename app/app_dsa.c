@@ -20,52 +20,158 @@
 
 #define DSA_MAX_SEED 1024
 
-/* Re-use these when possible to speed up test cases */
-static EVP_PKEY_CTX *group_param_ctx = NULL;
-static EVP_PKEY_CTX *group_pctx = NULL;
-static EVP_PKEY *group_param_key = NULL;
-static EVP_PKEY *group_pkey = NULL;
-static int dsa_current_siggen_tg = 0;
-static int dsa_current_keygen_tg = 0;
+/*
+ * Re-use these when possible to speed up test cases. They are kept by the
+ * thread running the test group, see app_thread_state_get().
+ */
+typedef struct app_dsa_group_t {
+    EVP_PKEY_CTX *param_ctx;
+    EVP_PKEY_CTX *pctx;
+    EVP_PKEY *param_key;
+    EVP_PKEY *pkey;
+    int siggen_tg;
+    int keygen_tg;
+    int l, n;
+} APP_DSA_GROUP;
+
+static void app_dsa_group_clear(APP_DSA_GROUP *group) {
+    if (group->param_ctx) EVP_PKEY_CTX_free(group->param_ctx);
+    group->param_ctx = NULL;
+    if (group->pctx) EVP_PKEY_CTX_free(group->pctx);
+    group->pctx = NULL;
+    if (group->param_key) EVP_PKEY_free(group->param_key);
+    group->param_key = NULL;
+    if (group->pkey) EVP_PKEY_free(group->pkey);
+    group->pkey = NULL;
+}
+
+static void app_dsa_group_free(void *arg) {
+    APP_DSA_GROUP *group = arg;
+
+    if (!group) {
+        return;
+    }
+    app_dsa_group_clear(group);
+    free(group);
+}
+
+/* The group state of the calling thread, made on first use */
+static APP_DSA_GROUP *app_dsa_group(void) {
+    APP_DSA_GROUP *group = app_thread_state_get(APP_STATE_DSA);
+
+    if (group) {
+        return group;
+    }
+    group = calloc(1, sizeof(APP_DSA_GROUP));
+    if (group && app_thread_state_set(APP_STATE_DSA, group, app_dsa_group_free)) {
+        free(group);
+        group = NULL;
+    }
+    return group;
+}
 
 void app_dsa_cleanup(void) {
-    if (group_param_ctx) EVP_PKEY_CTX_free(group_param_ctx);
-    group_param_ctx = NULL;
-    if (group_pctx) EVP_PKEY_CTX_free(group_pctx);
-    group_pctx = NULL;
-    if (group_param_key) EVP_PKEY_free(group_param_key);
-    group_param_key = NULL;
-    if (group_pkey) EVP_PKEY_free(group_pkey);
-    group_pkey = NULL;
+    app_thread_state_set(APP_STATE_DSA, NULL, NULL);
 }
 
-static int init_group_pkey_paramgen(int l, int n) {
+/*
+ * Makes the group parameter key from the p, q and g libacvp kept from an
+ * earlier group, which is much cheaper than generating new ones
+ */
+static int init_group_pkey_given(APP_DSA_GROUP *group, ACVP_DSA_TC *tc) {
     int rv = 1;
-    group_param_ctx = EVP_PKEY_CTX_new_from_name(NULL, "DSA", NULL);
-    if (!group_param_ctx) {
+    BIGNUM *p = NULL, *q = NULL, *g = NULL;
+    OSSL_PARAM_BLD *pbld = NULL;
+    OSSL_PARAM *params = NULL;
+
+    p = BN_bin2bn(tc->p, tc->p_len, NULL);
+    q = BN_bin2bn(tc->q, tc->q_len, NULL);
+    g = BN_bin2bn(tc->g, tc->g_len, NULL);
+    if (!p || !q || !g) {
+        printf("Error converting P/Q/G to bignum in DSA\n");
+        goto err;
+    }
+
+    pbld = OSSL_PARAM_BLD_new();
+    if (!pbld) {
+        printf("Error creating param_bld in DSA\n");
+        goto err;
+    }
+    OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_FFC_P, p);
+    OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_FFC_Q, q);
+    OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_FFC_G, g);
+    params = OSSL_PARAM_BLD_to_param(pbld);
+    if (!params) {
+        printf("Error generating group params in DSA\n");
+        goto err;
+    }
+
+    group->param_ctx = EVP_PKEY_CTX_new_from_name(NULL, "DSA", NULL);
+    if (!group->param_ctx) {
+        printf("Error initializing param CTX in DSA\n");
+        goto err;
+    }
+    if (EVP_PKEY_fromdata_init(group->param_ctx) != 1 ||
+            EVP_PKEY_fromdata(group->param_ctx, &group->param_key, EVP_PKEY_KEY_PARAMETERS, params) != 1) {
+        printf("Error importing group params in DSA\n");
+        goto err;
+    }
+    rv = 0;
+err:
+    if (p) BN_free(p);
+    if (q) BN_free(q);
+    if (g) BN_free(g);
+    if (pbld) OSSL_PARAM_BLD_free(pbld);
+    if (params) OSSL_PARAM_free(params);
+    return rv;
+}
+
+static int init_group_pkey_generated(APP_DSA_GROUP *group, ACVP_DSA_TC *tc) {
+    int rv = 1;
+    group->param_ctx = EVP_PKEY_CTX_new_from_name(NULL, "DSA", NULL);
+    if (!group->param_ctx) {
         printf("Error initializing param CTX in DSA keygen\n");
         goto err;
     }
-    if (EVP_PKEY_paramgen_init(group_param_ctx) != 1) {
+    if (EVP_PKEY_paramgen_init(group->param_ctx) != 1) {
         printf("Error initializing param CTX in DSA keygen\n");
         goto err;
     }
 
-    if (EVP_PKEY_CTX_set_dsa_paramgen_bits(group_param_ctx, l) != 1 ||
-            EVP_PKEY_CTX_set_dsa_paramgen_q_bits(group_param_ctx, n) != 1) {
+    if (EVP_PKEY_CTX_set_dsa_paramgen_bits(group->param_ctx, tc->l) != 1 ||
+            EVP_PKEY_CTX_set_dsa_paramgen_q_bits(group->param_ctx, tc->n) != 1) {
         printf("Error setting keygen params in DSA\n");
         goto err;
     }
-    if (EVP_PKEY_paramgen(group_param_ctx, &group_param_key) != 1) {
+    app_set_pkey_gen_cb(group->param_ctx, tc->control);
+    if (EVP_PKEY_paramgen(group->param_ctx, &group->param_key) != 1) {
         printf("Error generating param key in DSA keygen\n");
         goto err;
     }
-    group_pctx = EVP_PKEY_CTX_new_from_pkey(NULL, group_param_key, NULL);
-    if (!group_pctx) {
+    rv = 0;
+err:
+    return rv;
+}
+
+static int init_group_pkey_paramgen(APP_DSA_GROUP *group, ACVP_DSA_TC *tc) {
+    int rv = 1;
+
+    if (tc->pqg_given) {
+        rv = init_group_pkey_given(group, tc);
+    } else {
+        rv = init_group_pkey_generated(group, tc);
+    }
+    if (rv) {
+        goto err;
+    }
+    rv = 1;
+
+    group->pctx = EVP_PKEY_CTX_new_from_pkey(NULL, group->param_key, NULL);
+    if (!group->pctx) {
         printf("Error creating group_pkey CTX in DSA keygen\n");
         goto err;
     }
-    if (EVP_PKEY_keygen_init(group_pctx) != 1) {
+    if (EVP_PKEY_keygen_init(group->pctx) != 1) {
         printf("Error initializing keygen in DSA keygen\n");
         goto err;
     }
@@ -90,20 +196,29 @@ int app_dsa_handler(ACVP_TEST_CASE *test_case) {
     EVP_PKEY *pkey = NULL;
     EVP_MD_CTX *sig_ctx = NULL;
     DSA_SIG *sig_obj = NULL;
+    APP_DSA_GROUP *group = NULL;
 
     tc = test_case->tc.dsa;
+    group = app_dsa_group();
+    if (!group) {
+        printf("Error allocating DSA group state\n");
+        return 1;
+    }
     switch (tc->mode) {
     case ACVP_DSA_MODE_KEYGEN:
-        if (dsa_current_keygen_tg != tc->tg_id) {
-            dsa_current_keygen_tg = tc->tg_id;
-            app_dsa_cleanup();
-            if (init_group_pkey_paramgen(tc->l, tc->n)) {
+        if (group->keygen_tg != tc->tg_id || group->l != tc->l || group->n != tc->n) {
+            group->keygen_tg = tc->tg_id;
+            group->siggen_tg = 0;
+            group->l = tc->l;
+            group->n = tc->n;
+            app_dsa_group_clear(group);
+            if (init_group_pkey_paramgen(group, tc)) {
                 printf("Error initiating group params in DSA keygen\n");
                 goto err;
             }
         }
 
-        if (EVP_PKEY_keygen(group_pctx, &pkey) != 1) {
+        if (EVP_PKEY_keygen(group->pctx, &pkey) != 1) {
             printf("Error generating group_pkey in DSA keygen\n");
             goto err;
         }
@@ -294,38 +409,41 @@ int app_dsa_handler(ACVP_TEST_CASE *test_case) {
         }
         break;
     case ACVP_DSA_MODE_SIGGEN:
-        if (dsa_current_siggen_tg != tc->tg_id) {
-            dsa_current_siggen_tg = tc->tg_id;
-            app_dsa_cleanup();
-
-            if (init_group_pkey_paramgen(tc->l, tc->n)) {
+        if (group->siggen_tg != tc->tg_id || group->l != tc->l || group->n != tc->n) {
+            group->siggen_tg = tc->tg_id;
+            group->keygen_tg = 0;
+            group->l = tc->l;
+            group->n = tc->n;
+            app_dsa_group_clear(group);
+
+            if (init_group_pkey_paramgen(group, tc)) {
                 printf("Error initiating group params in DSA siggen\n");
             }
-            if (EVP_PKEY_keygen(group_pctx, &group_pkey) != 1) {
+            if (EVP_PKEY_keygen(group->pctx, &group->pkey) != 1) {
                 printf("Error generating group_pkey in DSA siggen\n");
                 goto err;
             }
         }
 
-        if (EVP_PKEY_get_bn_param(group_pkey, OSSL_PKEY_PARAM_FFC_P, &p) == 1) {
+        if (EVP_PKEY_get_bn_param(group->pkey, OSSL_PKEY_PARAM_FFC_P, &p) == 1) {
             tc->p_len = BN_bn2bin(p, tc->p);
         } else {
             printf("Error getting 'p' in DSA siggen\n");
             goto err;
         }
-        if (EVP_PKEY_get_bn_param(group_pkey, OSSL_PKEY_PARAM_FFC_Q, &q) == 1) {
+        if (EVP_PKEY_get_bn_param(group->pkey, OSSL_PKEY_PARAM_FFC_Q, &q) == 1) {
             tc->q_len = BN_bn2bin(q, tc->q);
         } else {
             printf("Error getting 'q' in DSA siggen\n");
             goto err;
         }
-        if (EVP_PKEY_get_bn_param(group_pkey, OSSL_PKEY_PARAM_FFC_G, &g) == 1) {
+        if (EVP_PKEY_get_bn_param(group->pkey, OSSL_PKEY_PARAM_FFC_G, &g) == 1) {
             tc->g_len = BN_bn2bin(g, tc->g);
         } else {
             printf("Error getting 'g' in DSA siggen\n");
             goto err;
         }
-        if (EVP_PKEY_get_bn_param(group_pkey, OSSL_PKEY_PARAM_PUB_KEY, &pub_key) == 1) {
+        if (EVP_PKEY_get_bn_param(group->pkey, OSSL_PKEY_PARAM_PUB_KEY, &pub_key) == 1) {
             tc->y_len = BN_bn2bin(pub_key, tc->y);
         } else {
             printf("Error getting 'y' in DSA siggen\n");
@@ -342,7 +460,7 @@ int app_dsa_handler(ACVP_TEST_CASE *test_case) {
             printf("Error initializing sign CTX for DSA siggen\n");
             goto err;
         }
-        if (EVP_DigestSignInit_ex(sig_ctx, NULL, md, NULL, NULL, group_pkey, NULL) != 1) {
+        if (EVP_DigestSignInit_ex(sig_ctx, NULL, md, NULL, NULL, group->pkey, NULL) != 1) {
             printf("Error initializing signing for DSA siggen\n");
             goto err;
         }
@@ -439,6 +557,7 @@ int app_dsa_handler(ACVP_TEST_CASE *test_case) {
             }
         }
 
+        app_set_pkey_gen_cb(pctx, tc->control);
         if (EVP_PKEY_paramgen(pctx, &pkey) != 1) {
             printf("Error generating params in DSA pqggen\n");
             goto err;
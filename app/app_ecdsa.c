@@ -18,19 +18,128 @@
 #include <openssl/ec.h>
 #include "safe_lib.h"
 
-static BIGNUM *ecdsa_group_Qx = NULL;
-static BIGNUM *ecdsa_group_Qy = NULL;
-static int ecdsa_current_tg = 0;
+/*
+ * SigGen key of a test group, kept in tg_ctx by app_ecdsa_group_handler(),
+ * or by the thread running the group when there is no group handler
+ */
+typedef struct app_ecdsa_group_t {
+    int tg_id;
+    EVP_PKEY *pkey;
+    BIGNUM *qx;
+    BIGNUM *qy;
+} APP_ECDSA_GROUP;
 
-static EVP_PKEY *group_pkey = NULL;
+/* Generates the key a SigGen test group signs with */
+static int app_ecdsa_group_keygen(const char *curve, EVP_PKEY **pkey, BIGNUM **qx, BIGNUM **qy) {
+    int rv = 1;
+    EVP_PKEY_CTX *pkey_ctx = NULL;
+
+    pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
+    if (!pkey_ctx) {
+        printf("Error creating pkey CTX in ECDSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_keygen_init(pkey_ctx) != 1) {
+        printf("Error initializing keygen in ECDSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_CTX_set_group_name(pkey_ctx, curve) != 1) {
+        printf("Error setting curve for ECDSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_generate(pkey_ctx, pkey) != 1) {
+        printf("Error generating pkey in ECDSA siggen\n");
+        goto err;
+    }
+    EVP_PKEY_get_bn_param(*pkey, "qx", qx);
+    EVP_PKEY_get_bn_param(*pkey, "qy", qy);
+    if (!*qx || !*qy) {
+        printf("Error retrieving params from pkey in ECDSA siggen\n");
+        goto err;
+    }
+    rv = 0;
+err:
+    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
+    return rv;
+}
+
+static void app_ecdsa_group_free(void *arg) {
+    APP_ECDSA_GROUP *group = arg;
+
+    if (!group) {
+        return;
+    }
+    if (group->pkey) EVP_PKEY_free(group->pkey);
+    if (group->qx) BN_free(group->qx);
+    if (group->qy) BN_free(group->qy);
+    free(group);
+}
+
+/*
+ * Generates the key of each SigGen test group once, as the group starts,
+ * instead of on its first test case
+ */
+int app_ecdsa_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_ECDSA_TC *tc = NULL;
+    APP_ECDSA_GROUP *group = NULL;
+    const char *curve = NULL;
+
+    if (!test_case) {
+        return 1;
+    }
+    tc = test_case->tc.ecdsa;
+    if (tc->cipher != ACVP_ECDSA_SIGGEN && tc->cipher != ACVP_DET_ECDSA_SIGGEN) {
+        return 0;
+    }
+
+    if (event == ACVP_TG_END) {
+        app_ecdsa_group_free(tc->tg_ctx);
+        tc->tg_ctx = NULL;
+        return 0;
+    }
+
+    curve = OSSL_EC_curve_nid2name(get_nid_for_curve(tc->curve));
+    if (!curve) {
+        printf("Unable to lookup curve name for ECDSA\n");
+        return 1;
+    }
+    group = calloc(1, sizeof(APP_ECDSA_GROUP));
+    if (!group) {
+        return 1;
+    }
+    if (app_ecdsa_group_keygen(curve, &group->pkey, &group->qx, &group->qy)) {
+        app_ecdsa_group_free(group);
+        return 1;
+    }
+    tc->tg_ctx = group;
+    return 0;
+}
+
+/*
+ * The key of test group tg_id kept by the calling thread, generated when
+ * the thread moves on to a new group
+ */
+static APP_ECDSA_GROUP *app_ecdsa_thread_group(const char *curve, int tg_id) {
+    APP_ECDSA_GROUP *group = app_thread_state_get(APP_STATE_ECDSA);
+
+    if (group && group->tg_id == tg_id) {
+        return group;
+    }
+    group = calloc(1, sizeof(APP_ECDSA_GROUP));
+    if (!group) {
+        return NULL;
+    }
+    group->tg_id = tg_id;
+    if (app_ecdsa_group_keygen(curve, &group->pkey, &group->qx, &group->qy) ||
+            app_thread_state_set(APP_STATE_ECDSA, group, app_ecdsa_group_free)) {
+        app_ecdsa_group_free(group);
+        return NULL;
+    }
+    return group;
+}
 
 void app_ecdsa_cleanup(void) {
-    if (ecdsa_group_Qx) BN_free(ecdsa_group_Qx);
-    ecdsa_group_Qx = NULL;
-    if (ecdsa_group_Qy) BN_free(ecdsa_group_Qy);
-    ecdsa_group_Qy = NULL;
-    if (group_pkey) EVP_PKEY_free(group_pkey);
-    group_pkey = NULL;
+    app_thread_state_set(APP_STATE_ECDSA, NULL, NULL);
 }
 
 int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
@@ -51,6 +160,9 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
     BIGNUM *qx = NULL, *qy = NULL, *d = NULL;
     const BIGNUM *out_r = NULL, *out_s = NULL;
     BIGNUM *in_r = NULL, *in_s = NULL;
+    EVP_PKEY *sign_key = NULL;
+    const BIGNUM *sign_qx = NULL, *sign_qy = NULL;
+    APP_ECDSA_GROUP *group = NULL;
     if (!test_case) {
         printf("No test case found\n");
         return 1;
@@ -161,33 +273,18 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
         break;
     case ACVP_SUB_ECDSA_SIGGEN:
     case ACVP_SUB_DET_ECDSA_SIGGEN:
-        if (ecdsa_current_tg != tc->tg_id) {
-            ecdsa_current_tg = tc->tg_id;
+        /* The group handler generated the key of the group */
+        group = tc->tg_ctx;
+        if (!group) {
             /* First, generate key for every test group */
-            pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
-            if (!pkey_ctx) {
-                printf("Error creating pkey CTX in ECDSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_keygen_init(pkey_ctx) != 1) {
-                printf("Error initializing keygen in ECDSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_CTX_set_group_name(pkey_ctx, curve) != 1) {
-                printf("Error setting curve for ECDSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_generate(pkey_ctx, &group_pkey) != 1) {
-                printf("Error generating pkey in ECDSA siggen\n");
-                goto err;
-            }
-            EVP_PKEY_get_bn_param(group_pkey, "qx", &ecdsa_group_Qx);
-            EVP_PKEY_get_bn_param(group_pkey, "qy", &ecdsa_group_Qy);
-            if (!ecdsa_group_Qx || !ecdsa_group_Qy) {
-                printf("Error retrieving params from pkey in ECDSA siggen\n");
+            group = app_ecdsa_thread_group(curve, tc->tg_id);
+            if (!group) {
                 goto err;
             }
         }
+        sign_key = group->pkey;
+        sign_qx = group->qx;
+        sign_qy = group->qy;
 
         /* Then, for each test case, generate a signature */
         if (!tc->is_component) {
@@ -196,7 +293,7 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
                 printf("Error initializing sign CTX for ECDSA siggen\n");
                 goto err;
             }
-            if (EVP_DigestSignInit_ex(sig_ctx, NULL, md, NULL, NULL, group_pkey, NULL) != 1) {
+            if (EVP_DigestSignInit_ex(sig_ctx, NULL, md, NULL, NULL, sign_key, NULL) != 1) {
                 printf("Error initializing signing for ECDSA siggen\n");
                 goto err;
             }
@@ -223,7 +320,7 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
 #endif
                 if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
                 pkey_ctx = NULL;
-                if (EVP_DigestSignInit_ex(sig_ctx, &pkey_ctx, md, NULL, NULL, group_pkey, NULL) != 1) {
+                if (EVP_DigestSignInit_ex(sig_ctx, &pkey_ctx, md, NULL, NULL, sign_key, NULL) != 1) {
                     printf("Error initializing signing for DetECDSA siggen\n");
                     goto err;
                 }
@@ -235,7 +332,7 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
 
                 pkey_ctx = NULL; //freed with md ctx
             } else {
-                if (EVP_DigestSignInit_ex(sig_ctx, NULL, md, NULL, NULL, group_pkey, NULL) != 1) {
+                if (EVP_DigestSignInit_ex(sig_ctx, NULL, md, NULL, NULL, sign_key, NULL) != 1) {
                     printf("Error initializing signing for ECDSA siggen\n");
                     goto err;
                 }
@@ -253,7 +350,7 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
                 goto err;
             }
         } else {
-            comp_ctx = EVP_PKEY_CTX_new_from_pkey(NULL, group_pkey, NULL);
+            comp_ctx = EVP_PKEY_CTX_new_from_pkey(NULL, sign_key, NULL);
             if (!comp_ctx) {
                 printf("Error initializing sign CTX for ECDSA component siggen\n");
                 goto err;
@@ -289,8 +386,8 @@ int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
         /* and copy our values to the TC response */
         tc->r_len = BN_bn2bin(out_r, tc->r);
         tc->s_len = BN_bn2bin(out_s, tc->s);
-        tc->qx_len = BN_bn2bin(ecdsa_group_Qx, tc->qx);
-        tc->qy_len = BN_bn2bin(ecdsa_group_Qy, tc->qy);
+        tc->qx_len = BN_bn2bin(sign_qx, tc->qx);
+        tc->qy_len = BN_bn2bin(sign_qy, tc->qy);
         break;
     case ACVP_SUB_ECDSA_SIGVER:
         tc->ver_disposition = 0;
@@ -398,6 +495,14 @@ err:
 
 #else
 
+int app_ecdsa_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+
 int app_ecdsa_handler(ACVP_TEST_CASE *test_case) {
     if (!test_case) {
         return -1;
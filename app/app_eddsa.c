@@ -17,16 +17,131 @@
 #include <openssl/core_names.h>
 #include <openssl/err.h>
 
-static unsigned char *eddsa_group_q = NULL;
-static size_t group_q_len = 0;
-static EVP_PKEY *group_pkey = NULL;
-static int eddsa_current_tg = 0;
+/*
+ * SigGen key of a test group, kept in tg_ctx by app_eddsa_group_handler(),
+ * or by the thread running the group when there is no group handler
+ */
+typedef struct app_eddsa_group_t {
+    int tg_id;
+    EVP_PKEY *pkey;
+    unsigned char *q;
+    size_t q_len;
+} APP_EDDSA_GROUP;
 
 void app_eddsa_cleanup(void) {
-    if (eddsa_group_q) free(eddsa_group_q);
-    eddsa_group_q = NULL;
-    if (group_pkey) EVP_PKEY_free(group_pkey);
-    group_pkey = NULL;
+    app_thread_state_set(APP_STATE_EDDSA, NULL, NULL);
+}
+
+/* Generates the key a SigGen test group signs with */
+static int app_eddsa_group_keygen(const char *curve, EVP_PKEY **pkey, unsigned char **q, size_t *q_len) {
+    int rv = 1;
+    EVP_PKEY_CTX *pkey_ctx = NULL;
+
+    pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, curve, NULL);
+    if (!pkey_ctx) {
+        printf("Error creating pkey CTX in EDDSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_keygen_init(pkey_ctx) != 1) {
+        printf("Error initializing keygen in EDDSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_generate(pkey_ctx, pkey) != 1) {
+        printf("Error generating pkey in EDDSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_get_octet_string_param(*pkey, "pub", NULL, 0, q_len) == 1) {
+        *q = calloc(*q_len, sizeof(char));
+        if (!*q) {
+            printf("Error allocating memory for 'q' in EDDSA keygen\n");
+            goto err;
+        }
+        if (EVP_PKEY_get_octet_string_param(*pkey, "pub", *q, *q_len, q_len) != 1) {
+            printf("Error getting 'q' in EDDSA keygen\n");
+            goto err;
+        }
+    } else {
+        printf("Error getting 'q' in EDDSA siggen\n");
+        goto err;
+    }
+    rv = 0;
+err:
+    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
+    return rv;
+}
+
+static void app_eddsa_group_free(void *arg) {
+    APP_EDDSA_GROUP *group = arg;
+
+    if (!group) {
+        return;
+    }
+    if (group->pkey) EVP_PKEY_free(group->pkey);
+    if (group->q) free(group->q);
+    free(group);
+}
+
+/*
+ * The key of test group tg_id kept by the calling thread, generated when
+ * the thread moves on to a new group
+ */
+static APP_EDDSA_GROUP *app_eddsa_thread_group(const char *curve, int tg_id) {
+    APP_EDDSA_GROUP *group = app_thread_state_get(APP_STATE_EDDSA);
+
+    if (group && group->tg_id == tg_id) {
+        return group;
+    }
+    group = calloc(1, sizeof(APP_EDDSA_GROUP));
+    if (!group) {
+        return NULL;
+    }
+    group->tg_id = tg_id;
+    if (app_eddsa_group_keygen(curve, &group->pkey, &group->q, &group->q_len) ||
+            app_thread_state_set(APP_STATE_EDDSA, group, app_eddsa_group_free)) {
+        app_eddsa_group_free(group);
+        return NULL;
+    }
+    return group;
+}
+
+/*
+ * Generates the key of each SigGen test group once, as the group starts,
+ * instead of on its first test case
+ */
+int app_eddsa_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_EDDSA_TC *tc = NULL;
+    APP_EDDSA_GROUP *group = NULL;
+    const char *curve = NULL;
+
+    if (!test_case) {
+        return 1;
+    }
+    tc = test_case->tc.eddsa;
+    if (tc->cipher != ACVP_EDDSA_SIGGEN) {
+        return 0;
+    }
+
+    if (event == ACVP_TG_END) {
+        app_eddsa_group_free(tc->tg_ctx);
+        tc->tg_ctx = NULL;
+        return 0;
+    }
+
+    curve = get_ed_curve_string(tc->curve);
+    if (!curve) {
+        printf("Unable to lookup curve name for EDDSA\n");
+        return 1;
+    }
+    group = calloc(1, sizeof(APP_EDDSA_GROUP));
+    if (!group) {
+        return 1;
+    }
+    if (app_eddsa_group_keygen(curve, &group->pkey, &group->q, &group->q_len)) {
+        app_eddsa_group_free(group);
+        return 1;
+    }
+    tc->tg_ctx = group;
+    return 0;
 }
 
 int app_eddsa_handler(ACVP_TEST_CASE *test_case) {
@@ -43,6 +158,10 @@ int app_eddsa_handler(ACVP_TEST_CASE *test_case) {
     EVP_PKEY *pkey = NULL;
     OSSL_PARAM_BLD *pkey_pbld = NULL;
     OSSL_PARAM *params = NULL;
+    EVP_PKEY *sign_key = NULL;
+    unsigned char *sign_q = NULL;
+    size_t sign_q_len = 0;
+    APP_EDDSA_GROUP *group = NULL;
 
     if (!test_case) {
         printf("No test case found\n");
@@ -157,38 +276,18 @@ int app_eddsa_handler(ACVP_TEST_CASE *test_case) {
         }
         break;
     case ACVP_SUB_EDDSA_SIGGEN:
-        if (eddsa_current_tg != tc->tg_id) {
-            eddsa_current_tg = tc->tg_id;
+        /* The group handler generated the key of the group */
+        group = tc->tg_ctx;
+        if (!group) {
             /* First, generate key for every test group */
-            pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, curve, NULL);
-            if (!pkey_ctx) {
-                printf("Error creating pkey CTX in EDDSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_keygen_init(pkey_ctx) != 1) {
-                printf("Error initializing keygen in EDDSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_generate(pkey_ctx, &group_pkey) != 1) {
-                printf("Error generating pkey in EDDSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_get_octet_string_param(group_pkey, "pub", NULL, 0, &group_q_len) == 1) {
-                if (eddsa_group_q) free(eddsa_group_q);
-                eddsa_group_q = calloc(group_q_len, sizeof(char));
-                if (!eddsa_group_q) {
-                    printf("Error allocating memory for 'q' in EDDSA keygen\n");
-                    goto err;
-                }
-                if (EVP_PKEY_get_octet_string_param(group_pkey, "pub", eddsa_group_q, group_q_len, &group_q_len) != 1) {
-                    printf("Error getting 'q' in EDDSA keygen\n");
-                    goto err;
-                }
-            } else {
-                printf("Error getting 'q' in EDDSA siggen\n");
+            group = app_eddsa_thread_group(curve, tc->tg_id);
+            if (!group) {
                 goto err;
             }
         }
+        sign_key = group->pkey;
+        sign_q = group->q;
+        sign_q_len = group->q_len;
 
         /* Then, for each test case, generate a signature */
         sig_ctx = EVP_MD_CTX_new();
@@ -211,7 +310,7 @@ int app_eddsa_handler(ACVP_TEST_CASE *test_case) {
             printf("Error generating parameters for pkey generation in EDDSA siggen\n");
             goto err;
         }
-        if (EVP_DigestSignInit_ex(sig_ctx, NULL, NULL, NULL, NULL, group_pkey, params) != 1) {
+        if (EVP_DigestSignInit_ex(sig_ctx, NULL, NULL, NULL, NULL, sign_key, params) != 1) {
             printf("Error initializing signing for EDDSA siggen\n");
             goto err;
         }
@@ -228,8 +327,8 @@ int app_eddsa_handler(ACVP_TEST_CASE *test_case) {
         }
    
         /* and copy our values to the TC response */
-        tc->q_len = (int)group_q_len;
-        memcpy_s(tc->q, 8192, eddsa_group_q, group_q_len);
+        tc->q_len = (int)sign_q_len;
+        memcpy_s(tc->q, 8192, sign_q, sign_q_len);
         tc->signature_len = (int)sig_len;
         memcpy_s(tc->signature, 8192, sig, sig_len);
         break;
@@ -317,6 +416,14 @@ err:
 
 #else
 
+int app_eddsa_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+
 int app_eddsa_handler(ACVP_TEST_CASE *test_case) {
     if (!test_case) {
         return -1;
@@ -17,6 +17,73 @@
 #include "app_lcl.h"
 #include "safe_lib.h"
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static const char *app_hmac_md_name(ACVP_SUB_HMAC alg) {
+    switch (alg) {
+    case ACVP_SUB_HMAC_SHA1:
+        return ACVP_STR_SHA_1;
+    case ACVP_SUB_HMAC_SHA2_224:
+        return ACVP_STR_SHA2_224;
+    case ACVP_SUB_HMAC_SHA2_256:
+        return ACVP_STR_SHA2_256;
+    case ACVP_SUB_HMAC_SHA2_384:
+        return ACVP_STR_SHA2_384;
+    case ACVP_SUB_HMAC_SHA2_512:
+        return ACVP_STR_SHA2_512;
+    case ACVP_SUB_HMAC_SHA2_512_224:
+        return ACVP_STR_SHA2_512_224;
+    case ACVP_SUB_HMAC_SHA2_512_256:
+        return ACVP_STR_SHA2_512_256;
+    case ACVP_SUB_HMAC_SHA3_224:
+        return ACVP_STR_SHA3_224;
+    case ACVP_SUB_HMAC_SHA3_256:
+        return ACVP_STR_SHA3_256;
+    case ACVP_SUB_HMAC_SHA3_384:
+        return ACVP_STR_SHA3_384;
+    case ACVP_SUB_HMAC_SHA3_512:
+        return ACVP_STR_SHA3_512;
+    default:
+        return NULL;
+    }
+}
+
+/*
+ * Sets up the HMAC of a test group once, so its test cases only need to key
+ * it, see app_mac_group_ctx()
+ */
+int app_hmac_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_HMAC_TC *stc = NULL;
+    const char *md_name = NULL;
+
+    if (!test_case || !test_case->tc.hmac) {
+        return 1;
+    }
+    stc = test_case->tc.hmac;
+
+    if (event == ACVP_TG_END) {
+        app_mac_group_free(stc->tg_ctx);
+        stc->tg_ctx = NULL;
+        return 0;
+    }
+
+    md_name = app_hmac_md_name(acvp_get_hmac_alg(stc->cipher));
+    if (!md_name) {
+        printf("Error: Unsupported hash algorithm requested by ACVP server\n");
+        return 1;
+    }
+    stc->tg_ctx = app_mac_group_new("HMAC", OSSL_MAC_PARAM_DIGEST, md_name);
+    return stc->tg_ctx ? 0 : 1;
+}
+#else
+int app_hmac_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+#endif
+
 int app_hmac_handler(ACVP_TEST_CASE *test_case) {
     ACVP_HMAC_TC    *tc;
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -25,6 +92,7 @@ int app_hmac_handler(ACVP_TEST_CASE *test_case) {
     OSSL_PARAM_BLD *pbld = NULL;
     OSSL_PARAM *params = NULL;
     const char *md_name = NULL;
+    size_t mac_len = 0;
 #else
     const EVP_MD *md = NULL;
     HMAC_CTX *hmac_ctx = NULL;
@@ -49,48 +117,23 @@ int app_hmac_handler(ACVP_TEST_CASE *test_case) {
     msg_len = tc->msg_len;
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    switch (alg) {
-    case ACVP_SUB_HMAC_SHA1:
-        md_name = ACVP_STR_SHA_1;
-        break;
-    case ACVP_SUB_HMAC_SHA2_224:
-        md_name = ACVP_STR_SHA2_224;
-        break;
-    case ACVP_SUB_HMAC_SHA2_256:
-        md_name = ACVP_STR_SHA2_256;
-        break;
-    case ACVP_SUB_HMAC_SHA2_384:
-        md_name = ACVP_STR_SHA2_384;
-        break;
-    case ACVP_SUB_HMAC_SHA2_512:
-        md_name = ACVP_STR_SHA2_512;
-        break;
-    case ACVP_SUB_HMAC_SHA2_512_224:
-        md_name = ACVP_STR_SHA2_512_224;
-        break;
-    case ACVP_SUB_HMAC_SHA2_512_256:
-        md_name = ACVP_STR_SHA2_512_256;
-        break;
-    case ACVP_SUB_HMAC_SHA3_224:
-        md_name = ACVP_STR_SHA3_224;
-        break;
-    case ACVP_SUB_HMAC_SHA3_256:
-        md_name = ACVP_STR_SHA3_256;
-        break;
-    case ACVP_SUB_HMAC_SHA3_384:
-        md_name = ACVP_STR_SHA3_384;
-        break;
-    case ACVP_SUB_HMAC_SHA3_512:
-        md_name = ACVP_STR_SHA3_512;
-        break;
-    default:
+    md_name = app_hmac_md_name(alg);
+    if (!md_name) {
         printf("Error: Unsupported hash algorithm requested by ACVP server\n");
         return rc;
+    }
 
-        break;
+    if (tc->tg_ctx) {
+        /* The group handler has the MAC set up; only the key may be new */
+        hmac_ctx = app_mac_group_ctx(tc->tg_ctx, tc->key_id, tc->key, tc->key_len);
+        if (!hmac_ctx) {
+            printf("\nCrypto module error, unable to key the HMAC of the group\n");
+            goto end;
+        }
+        goto update;
     }
 
-    mac = EVP_MAC_fetch(NULL, "HMAC", NULL);
+    mac = app_mac_fetch("HMAC", NULL);
     if (!mac) {
         printf("Error: unable to fetch HMAC");
         goto end;
@@ -120,15 +163,17 @@ int app_hmac_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
+update:
     if (!EVP_MAC_update(hmac_ctx, tc->msg, msg_len)) {
         printf("\nCrypto module error, EVP_MAC_update failed\n");
         goto end;
     }
 
-    if (!EVP_MAC_final(hmac_ctx, tc->mac, (long unsigned int *)&tc->mac_len, HMAC_BUF_MAX)) {
+    if (!EVP_MAC_final(hmac_ctx, tc->mac, &mac_len, HMAC_BUF_MAX)) {
         printf("\nCrypto module error, EVP_MAC_final failed\n");
         goto end;
     }
+    tc->mac_len = (unsigned int)mac_len;
 
     rc = 0;
 
@@ -197,7 +242,7 @@ int app_hmac_handler(ACVP_TEST_CASE *test_case) {
 
 end:
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    if (hmac_ctx) EVP_MAC_CTX_free(hmac_ctx);
+    if (hmac_ctx && !tc->tg_ctx) EVP_MAC_CTX_free(hmac_ctx);
     if (mac) EVP_MAC_free(mac);
     if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (params) OSSL_PARAM_free(params);
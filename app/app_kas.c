@@ -435,19 +435,177 @@ err:
 }
 
 
+/*
+ * IUT key of a KAS-IFC or KTS-IFC test group, kept in tg_ctx by the group
+ * handlers. Test cases with the same key_id use the key already built.
+ */
+typedef struct app_ifc_group_t {
+    unsigned int key_id;
+    EVP_PKEY *pkey;
+} APP_IFC_GROUP;
+
+static int app_ifc_group_event(void **tg_ctx, ACVP_TG_EVENT event) {
+    APP_IFC_GROUP *group = NULL;
+
+    if (event == ACVP_TG_END) {
+        group = *tg_ctx;
+        if (group) {
+            if (group->pkey) EVP_PKEY_free(group->pkey);
+            free(group);
+        }
+        *tg_ctx = NULL;
+        return 0;
+    }
+    group = calloc(1, sizeof(APP_IFC_GROUP));
+    if (!group) {
+        return 1;
+    }
+    *tg_ctx = group;
+    return 0;
+}
+
+/* Returns a new reference to the key of key_id if the group has it, else NULL */
+static EVP_PKEY *app_ifc_group_get(APP_IFC_GROUP *group, unsigned int key_id) {
+    if (!group || !key_id || group->key_id != key_id || !group->pkey) {
+        return NULL;
+    }
+    if (EVP_PKEY_up_ref(group->pkey) != 1) {
+        return NULL;
+    }
+    return group->pkey;
+}
+
+/* Keeps pkey as the key of key_id, in place of the one the group had */
+static void app_ifc_group_put(APP_IFC_GROUP *group, unsigned int key_id, EVP_PKEY *pkey) {
+    if (!group || !key_id || EVP_PKEY_up_ref(pkey) != 1) {
+        return;
+    }
+    if (group->pkey) EVP_PKEY_free(group->pkey);
+    group->pkey = pkey;
+    group->key_id = key_id;
+}
+
+int app_kas_ifc_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    return app_ifc_group_event(&test_case->tc.kas_ifc->tg_ctx, event);
+}
+
+int app_kts_ifc_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    return app_ifc_group_event(&test_case->tc.kts_ifc->tg_ctx, event);
+}
+
+/* Builds the IUT keypair of a KAS-IFC test case */
+static int app_kas_ifc_iut_pkey(ACVP_KAS_IFC_TC *tc, EVP_PKEY **pkey) {
+    int rv = 1;
+    BIGNUM *p = NULL, *q = NULL, *n = NULL, *d = NULL, *e = NULL;
+    BIGNUM *dmp1 = NULL, *dmq1 = NULL, *iqmp = NULL;
+    EVP_PKEY_CTX *pkey_ctx = NULL;
+    OSSL_PARAM *params = NULL;
+    OSSL_PARAM_BLD *pbld = NULL;
+    BN_CTX *bctx = NULL;
+
+    n = BN_bin2bn(tc->n, tc->nlen, NULL);
+    e = BN_bin2bn(tc->e, tc->elen, NULL);
+    p = BN_bin2bn(tc->p, tc->plen, NULL);
+    q = BN_bin2bn(tc->q, tc->qlen, NULL);
+    if (!n || !e || !p || !q) {
+        printf("Error generating BN params from test case in KAS-IFC\n");
+        goto err;
+    }
+    if (tc->key_gen == ACVP_KAS_IFC_RSAKPG1_CRT || tc->key_gen == ACVP_KAS_IFC_RSAKPG2_CRT) {
+        dmp1 = BN_bin2bn(tc->dmp1, tc->dmp1_len, NULL);
+        dmq1 = BN_bin2bn(tc->dmq1, tc->dmq1_len, NULL);
+        iqmp = BN_bin2bn(tc->iqmp, tc->iqmp_len, NULL);
+        if (!dmp1 || !dmq1 || !iqmp) {
+            printf("Error generating BN params from test case in KAS-IFC\n");
+            goto err;
+        }
+        /* OpenSSL requires a D value for private keys, even for CRT. Fortunately, it is calculable. */
+        bctx = BN_CTX_new();
+        d = BN_dup(n);
+        BN_sub(d, d, p);
+        BN_sub(d, d, q);
+        BN_add_word(d, 1);
+        BN_mod_inverse(d, e, d, bctx);
+    } else {
+        d = BN_bin2bn(tc->d, tc->dlen, NULL);
+    }
+    if (!d) {
+        printf("Error generating BN params from test case in KAS-IFC\n");
+        goto err;
+    }
+
+    pbld = OSSL_PARAM_BLD_new();
+    if (!pbld) {
+        printf("Error creating param_bld in KAS-IFC\n");
+        goto err;
+    }
+
+    /* Note: rsakpg-prime-factor schemes should use P and Q as private key storage.
+     * OpenSSL claims support, but is unclear. Here we represent with our given (?) n value */
+    OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_N, n);
+    OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_E, e);
+    OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_D, d);
+    OSSL_PARAM_BLD_push_uint(pbld, OSSL_PKEY_PARAM_RSA_BITS, tc->modulo);
+    if (tc->key_gen == ACVP_KAS_IFC_RSAKPG1_CRT || tc->key_gen == ACVP_KAS_IFC_RSAKPG2_CRT) {
+        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_FACTOR1, p);
+        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_FACTOR2, q);
+        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_EXPONENT1, dmp1);
+        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_EXPONENT2, dmq1);
+        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_COEFFICIENT1, iqmp);
+    }
+
+    params = OSSL_PARAM_BLD_to_param(pbld);
+    if (!params) {
+        printf("Error generating parameters for pkey generation in KAS-IFC\n");
+        goto err;
+    }
+
+    pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
+    if (!pkey_ctx) {
+        printf("Error initializing pkey ctx for KAS-IFC\n");
+        goto err;
+    }
+    if (EVP_PKEY_fromdata_init(pkey_ctx) != 1) {
+        printf("Error initializing pkey in KAS-IFC\n");
+        goto err;
+    }
+    if (EVP_PKEY_fromdata(pkey_ctx, pkey, EVP_PKEY_KEYPAIR, params) != 1) {
+        printf("Error generating pkey in KAS-IFC\n");
+        goto err;
+    }
+    rv = 0;
+err:
+    if (p) BN_free(p);
+    if (q) BN_free(q);
+    if (n) BN_free(n);
+    if (d) BN_free(d);
+    if (e) BN_free(e);
+    if (dmp1) BN_free(dmp1);
+    if (dmq1) BN_free(dmq1);
+    if (iqmp) BN_free(iqmp);
+    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
+    if (params) OSSL_PARAM_free(params);
+    if (pbld) OSSL_PARAM_BLD_free(pbld);
+    if (bctx) BN_CTX_free(bctx);
+    return rv;
+}
+
 int app_kas_ifc_handler(ACVP_TEST_CASE *test_case) {
     ACVP_KAS_IFC_TC *tc = NULL;
     int rv = 1;
     size_t encap_s_len = 0, z_len = 0;
     unsigned char *encap_s = NULL, *z = NULL;
-    BIGNUM *p = NULL, *q = NULL, *n = NULL, *d = NULL, *e = NULL;
     BIGNUM *server_n = NULL, *server_e = NULL;
-    BIGNUM *dmp1 = NULL, *dmq1 = NULL, *iqmp = NULL;
     EVP_PKEY *pkey = NULL, *serv_pkey = NULL;
-    EVP_PKEY_CTX *pkey_ctx = NULL, *encap_ctx = NULL, *decap_ctx = NULL, *serv_ctx = NULL;
-    OSSL_PARAM *params = NULL, *serv_params = NULL;
-    OSSL_PARAM_BLD *pbld = NULL, *serv_pbld = NULL;
-    BN_CTX *bctx = NULL;
+    EVP_PKEY_CTX *encap_ctx = NULL, *decap_ctx = NULL, *serv_ctx = NULL;
+    OSSL_PARAM *serv_params = NULL;
+    OSSL_PARAM_BLD *serv_pbld = NULL;
 
     if (!test_case) {
         printf("Missing test_case\n");
@@ -490,36 +648,6 @@ int app_kas_ifc_handler(ACVP_TEST_CASE *test_case) {
             printf("Missing buffer for server Z in KAS-IFC test case\n");
             goto err;
         }
-        n = BN_bin2bn(tc->n, tc->nlen, NULL);
-        e = BN_bin2bn(tc->e, tc->elen, NULL);
-        p = BN_bin2bn(tc->p, tc->plen, NULL);
-        q = BN_bin2bn(tc->q, tc->qlen, NULL);
-        if (!n || !e || !p || !q) {
-            printf("Error generating BN params from test case in KAS-IFC\n");
-            goto err;
-        }
-        if (tc->key_gen == ACVP_KAS_IFC_RSAKPG1_CRT || tc->key_gen == ACVP_KAS_IFC_RSAKPG2_CRT) {
-            dmp1 = BN_bin2bn(tc->dmp1, tc->dmp1_len, NULL);
-            dmq1 = BN_bin2bn(tc->dmq1, tc->dmq1_len, NULL);
-            iqmp = BN_bin2bn(tc->iqmp, tc->iqmp_len, NULL);
-            if (!dmp1 || !dmq1 || !iqmp) {
-                printf("Error generating BN params from test case in KAS-IFC\n");
-                goto err;
-            }
-            /* OpenSSL requires a D value for private keys, even for CRT. Fortunately, it is calculable. */
-            bctx = BN_CTX_new();
-            d = BN_dup(n);
-            BN_sub(d, d, p);
-            BN_sub(d, d, q);
-            BN_add_word(d, 1);
-            BN_mod_inverse(d, e, d, bctx);
-        } else {
-            d = BN_bin2bn(tc->d, tc->dlen, NULL);
-        }
-        if (!d) {
-            printf("Error generating BN params from test case in KAS-IFC\n");
-            goto err;
-        }
     }
 
     /* Step 2a: build pkey structure for server public key */
@@ -556,46 +684,17 @@ int app_kas_ifc_handler(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    /* Step 2b: build pkey structure for IUT keypair (for all except KAS1 initiator cases) */
+    /*
+     * Step 2b: build pkey structure for IUT keypair (for all except KAS1 initiator cases),
+     * unless an earlier test case of the group already built the same key
+     */
     if (!(tc->scheme == ACVP_KAS_IFC_KAS1 && tc->kas_role == ACVP_KAS_IFC_INITIATOR)) {
-        pbld = OSSL_PARAM_BLD_new();
-        if (!pbld) {
-            printf("Error creating param_bld in KAS-IFC\n");
-            goto err;
-        }
-
-        /* Note: rsakpg-prime-factor schemes should use P and Q as private key storage.
-         * OpenSSL claims support, but is unclear. Here we represent with our given (?) n value */
-        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_N, n);
-        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_E, e);
-        OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_D, d);
-        OSSL_PARAM_BLD_push_uint(pbld, OSSL_PKEY_PARAM_RSA_BITS, tc->modulo);
-        if (tc->key_gen == ACVP_KAS_IFC_RSAKPG1_CRT || tc->key_gen == ACVP_KAS_IFC_RSAKPG2_CRT) {
-            OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_FACTOR1, p);
-            OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_FACTOR2, q);
-            OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_EXPONENT1, dmp1);
-            OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_EXPONENT2, dmq1);
-            OSSL_PARAM_BLD_push_BN(pbld, OSSL_PKEY_PARAM_RSA_COEFFICIENT1, iqmp);
-        }
-
-        params = OSSL_PARAM_BLD_to_param(pbld);
-        if (!params) {
-            printf("Error generating parameters for pkey generation in KAS-IFC\n");
-            goto err;
-        }
-
-        pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
-        if (!pkey_ctx) {
-            printf("Error initializing pkey ctx for KAS-IFC\n");
-            goto err;
-        }
-        if (EVP_PKEY_fromdata_init(pkey_ctx) != 1) {
-            printf("Error initializing pkey in KAS-IFC\n");
-            goto err;
-        }
-        if (EVP_PKEY_fromdata(pkey_ctx, &pkey, EVP_PKEY_KEYPAIR, params) != 1) {
-            printf("Error generating pkey in KAS-IFC\n");
-            goto err;
+        pkey = app_ifc_group_get(tc->tg_ctx, tc->key_id);
+        if (!pkey) {
+            if (app_kas_ifc_iut_pkey(tc, &pkey)) {
+                goto err;
+            }
+            app_ifc_group_put(tc->tg_ctx, tc->key_id, pkey);
         }
 
         decap_ctx = EVP_PKEY_CTX_new_from_pkey(NULL, pkey, NULL);
@@ -766,59 +865,27 @@ err:
     if (encap_s) free(encap_s);
     if (server_n) BN_free(server_n);
     if (server_e) BN_free(server_e);
-    if (p) BN_free(p);
-    if (q) BN_free(q);
-    if (n) BN_free(n);
-    if (d) BN_free(d);
-    if (e) BN_free(e);
-    if (dmp1) BN_free(dmp1);
-    if (dmq1) BN_free(dmq1);
-    if (iqmp) BN_free(iqmp);
     if (pkey) EVP_PKEY_free(pkey);
     if (serv_pkey) EVP_PKEY_free(serv_pkey);
     if (encap_ctx) EVP_PKEY_CTX_free(encap_ctx);
     if (decap_ctx) EVP_PKEY_CTX_free(decap_ctx);
-    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
     if (serv_ctx) EVP_PKEY_CTX_free(serv_ctx);
-    if (params) OSSL_PARAM_free(params);
     if (serv_params) OSSL_PARAM_free(serv_params);
-    if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (serv_pbld) OSSL_PARAM_BLD_free(serv_pbld);
-    if (bctx) BN_CTX_free(bctx);
     return rv;
 }
 
-int app_kts_ifc_handler(ACVP_TEST_CASE *test_case) {
-    ACVP_KTS_IFC_TC *tc;
+/* Builds the key of a KTS-IFC test case: the server public key or the IUT keypair */
+static int app_kts_ifc_pkey(ACVP_KTS_IFC_TC *tc, EVP_PKEY **pkey) {
     int rv = 1;
     BIGNUM *e = NULL, *n = NULL, *p = NULL, *q = NULL, *d = NULL,
            *dmp1 = NULL, *dmq1 = NULL, *iqmp = NULL;
-    const char *md = NULL;
-    size_t out_len = 0;
-    EVP_PKEY *pkey = NULL;
-    EVP_PKEY_CTX *pkey_ctx = NULL, *op_ctx = NULL;
-    OSSL_PARAM *params = NULL, *op_params = NULL;
-    OSSL_PARAM_BLD *pbld = NULL, *op_pbld = NULL;
+    EVP_PKEY_CTX *pkey_ctx = NULL;
+    OSSL_PARAM *params = NULL;
+    OSSL_PARAM_BLD *pbld = NULL;
     BN_CTX *bctx = NULL;
 
-    if (!test_case) {
-        printf("Error: test case not found in KTS-IFC handler\n");
-        goto err;
-    }
-
-    tc = test_case->tc.kts_ifc;
-    if (!tc) {
-        printf("Error: test case not found in KTS-IFC handler\n");
-        goto err;
-    }
-
-    md = get_md_string_for_hash_alg(tc->md, NULL);
-    if (!md) {
-        printf("Invalid hash alg for KTS-IFC\n");
-        goto err;
-    }
-
-     /* Convert all existing values into bignum */
+    /* Convert all existing values into bignum */
     n = BN_bin2bn(tc->n, tc->nlen, NULL);
     e = BN_bin2bn(tc->e, tc->elen, NULL);
     if (!n || !e) {
@@ -894,17 +961,70 @@ int app_kts_ifc_handler(ACVP_TEST_CASE *test_case) {
     }
 
     if (tc->kts_role == ACVP_KTS_IFC_INITIATOR) {
-        if (EVP_PKEY_fromdata(pkey_ctx, &pkey, EVP_PKEY_PUBLIC_KEY, params) != 1) {
+        if (EVP_PKEY_fromdata(pkey_ctx, pkey, EVP_PKEY_PUBLIC_KEY, params) != 1) {
             printf("Error generating pkey in KTS-IFC\n");
             goto err;
         }
     } else {
-        if (EVP_PKEY_fromdata(pkey_ctx, &pkey, EVP_PKEY_KEYPAIR, params) != 1) {
+        if (EVP_PKEY_fromdata(pkey_ctx, pkey, EVP_PKEY_KEYPAIR, params) != 1) {
             printf("Error generating pkey in KTS-IFC\n");
             goto err;
         }
     }
 
+    rv = 0;
+err:
+    if (e) BN_free(e);
+    if (n) BN_free(n);
+    if (p) BN_free(p);
+    if (q) BN_free(q);
+    if (d) BN_free(d);
+    if (dmp1) BN_free(dmp1);
+    if (dmq1) BN_free(dmq1);
+    if (iqmp) BN_free(iqmp);
+    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
+    if (params) OSSL_PARAM_free(params);
+    if (pbld) OSSL_PARAM_BLD_free(pbld);
+    if (bctx) BN_CTX_free(bctx);
+    return rv;
+}
+
+int app_kts_ifc_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_KTS_IFC_TC *tc;
+    int rv = 1;
+    const char *md = NULL;
+    size_t out_len = 0;
+    EVP_PKEY *pkey = NULL;
+    EVP_PKEY_CTX *op_ctx = NULL;
+    OSSL_PARAM *op_params = NULL;
+    OSSL_PARAM_BLD *op_pbld = NULL;
+
+    if (!test_case) {
+        printf("Error: test case not found in KTS-IFC handler\n");
+        goto err;
+    }
+
+    tc = test_case->tc.kts_ifc;
+    if (!tc) {
+        printf("Error: test case not found in KTS-IFC handler\n");
+        goto err;
+    }
+
+    md = get_md_string_for_hash_alg(tc->md, NULL);
+    if (!md) {
+        printf("Invalid hash alg for KTS-IFC\n");
+        goto err;
+    }
+
+    /* The IUT key may already have been built by an earlier test case of the group */
+    pkey = app_ifc_group_get(tc->tg_ctx, tc->key_id);
+    if (!pkey) {
+        if (app_kts_ifc_pkey(tc, &pkey)) {
+            goto err;
+        }
+        app_ifc_group_put(tc->tg_ctx, tc->key_id, pkey);
+    }
+
     op_ctx = EVP_PKEY_CTX_new_from_pkey(NULL, pkey, NULL);
     if (!op_ctx) {
         printf("Error creating CTX for KTS-IFC operation\n");
@@ -963,22 +1083,10 @@ int app_kts_ifc_handler(ACVP_TEST_CASE *test_case) {
     }
     rv = 0;
 err:
-    if (e) BN_free(e);
-    if (n) BN_free(n);
-    if (p) BN_free(p);
-    if (q) BN_free(q);
-    if (d) BN_free(d);
-    if (dmp1) BN_free(dmp1);
-    if (dmq1) BN_free(dmq1);
-    if (iqmp) BN_free(iqmp);
     if (pkey) EVP_PKEY_free(pkey);
-    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
     if (op_ctx) EVP_PKEY_CTX_free(op_ctx);
-    if (params) OSSL_PARAM_free(params);
     if (op_params) OSSL_PARAM_free(op_params);
-    if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (op_pbld) OSSL_PARAM_BLD_free(op_pbld);
-    if (bctx) BN_CTX_free(bctx);
     return rv;
 }
 
@@ -1173,6 +1281,22 @@ int app_kts_ifc_handler(ACVP_TEST_CASE *test_case) {
     return 1;
 }
 
+int app_kas_ifc_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+
+int app_kts_ifc_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+
 int app_safe_primes_handler(ACVP_TEST_CASE *test_case)
 {
     if (!test_case) {
@@ -18,144 +18,9 @@
 #include "acvp/acvp.h"
 #include "safe_lib.h"
 
-static unsigned char *fixed_info_gen_concat(ACVP_KDA_PATTERN_CANDIDATE *fixedInfoPattern,
-                                            unsigned char *literalCandidate,
-                                            unsigned char *uPartyId,
-                                            unsigned char *uEphemeralData,
-                                            unsigned char *vPartyId,
-                                            unsigned char *vEphemeralData,
-                                            unsigned char *algId,
-                                            unsigned char *label,
-                                            unsigned char *context,
-                                            unsigned char *t,
-                                            int literalLen,
-                                            int uPartyIdLen,
-                                            int uEphemeralLen,
-                                            int vPartyIdLen,
-                                            int vEphemeralLen,
-                                            int algIdLen,
-                                            int labelLen,
-                                            int contextLen,
-                                            int tLen,
-                                            int l,
-                                            int *fixedInfoLen) {
-    unsigned char *fixedInfo = NULL;
-    int totalLen = 0, i = 0, tmp = 0, lBits = 0, rv = 1;
-
-    //calculate the size of the buffer we need for fixed info, +4 incase L is included
-    totalLen = literalLen + uPartyIdLen + uEphemeralLen + vPartyIdLen
-                    + vEphemeralLen + algIdLen + labelLen + contextLen + tLen;
-    //add 4 bytes for the int of lengths is used
-    for (i = 0; i < ACVP_KDA_PATTERN_MAX; i++) {
-        if (fixedInfoPattern[i] == ACVP_KDA_PATTERN_L) {
-            totalLen += 4;
-            break;
-        }
-    }
-
-    fixedInfo = calloc(totalLen, sizeof(unsigned char));
-    if (!fixedInfo) {
-        printf("Error allocating memory for fixedInfo\n");
-        goto end;
-    }
-    for (i = 0; i < ACVP_KDA_PATTERN_MAX; i++) {
-        if (fixedInfoPattern[i] == 0) {
-            break;
-        }
-        switch(fixedInfoPattern[i]) {
-        case ACVP_KDA_PATTERN_LITERAL:
-            if (!literalCandidate) {
-                printf("Test case missing literal pattern data\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, literalCandidate, literalLen);
-            tmp += literalLen;
-            break;
-        case ACVP_KDA_PATTERN_UPARTYINFO:
-            if (!uPartyId) {
-                printf("Test case missing uPartyId\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, uPartyId, uPartyIdLen);
-            tmp += uPartyIdLen;
-            if (uEphemeralData) {
-                memcpy_s(fixedInfo + tmp, totalLen - tmp, uEphemeralData, uEphemeralLen);
-                tmp += uEphemeralLen;
-            }
-            break;
-        case ACVP_KDA_PATTERN_VPARTYINFO:
-            if (!vPartyId) {
-                printf("Test case missing vPartyId\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, vPartyId, vPartyIdLen);
-            tmp += vPartyIdLen;
-            if (vEphemeralData) {
-                memcpy_s(fixedInfo + tmp, totalLen - tmp, vEphemeralData, vEphemeralLen);
-                tmp += vEphemeralLen;
-            }
-            break;
-        case ACVP_KDA_PATTERN_ALGID:
-            if (!algId) {
-                printf("Test case missing algorithmId\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, algId, algIdLen);
-            tmp += algIdLen;
-            break;
-        case ACVP_KDA_PATTERN_LABEL:
-            if (!label) {
-                printf("Test case missing label\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, label, labelLen);
-            tmp += labelLen;
-            break;
-        case ACVP_KDA_PATTERN_CONTEXT:
-            if (!context) {
-                printf("Test case missing context\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, context, contextLen);
-            tmp += contextLen;
-            break;
-        case ACVP_KDA_PATTERN_L:
-            lBits = l * 8;
-            if (check_is_little_endian()) { lBits = swap_uint_endian(lBits); }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, (char *)&lBits, 4);
-            tmp += 4;
-            break;
-        case ACVP_KDA_PATTERN_T:
-            if (!t) {
-                printf("Test case missing t\n");
-                goto end;
-            }
-            memcpy_s(fixedInfo + tmp, totalLen - tmp, t, tLen);
-            tmp += tLen;
-            break;
-        case ACVP_KDA_PATTERN_NONE:
-        case ACVP_KDA_PATTERN_MAX:
-        default:
-            printf("Invalid fixedInfoPattern candidate value\n");
-            goto end;
-        }
-    }
-
-    rv = 0;
-end:
-    if (rv) {
-        if (fixedInfo) free(fixedInfo);
-        fixedInfo = NULL;
-    } else {
-        *fixedInfoLen = totalLen;
-    }
-    return fixedInfo;
-}
-
 int app_kda_hkdf_handler(ACVP_TEST_CASE *test_case) {
     ACVP_KDA_HKDF_TC *stc = NULL;
-    int rc = 1, fixedInfoLen = 0;
-    unsigned char *fixedInfo = NULL;
+    int rc = 1;
     OSSL_PARAM_BLD *pbld = NULL;
     OSSL_PARAM *params = NULL;
     EVP_KDF *kdf = NULL;
@@ -176,15 +41,8 @@ int app_kda_hkdf_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
-    fixedInfo = fixed_info_gen_concat(stc->fixedInfoPattern, stc->literalCandidate, stc->uPartyId,
-                                      stc->uEphemeralData, stc->vPartyId, stc->vEphemeralData,
-                                      stc->algorithmId, stc->label, stc->context, stc->t,
-                                      stc->literalLen, stc->uPartyIdLen, stc->uEphemeralLen,
-                                      stc->vPartyIdLen, stc->vEphemeralLen, stc->algIdLen,
-                                      stc->labelLen, stc->contextLen, stc->tLen, stc->l, 
-                                      &fixedInfoLen);
-    if (!fixedInfo) {
-        printf("Error creating fixed info\n");
+    if (!stc->fixedInfo) {
+        printf("Test case missing fixedInfo\n");
         goto end;
     }
 
@@ -193,7 +51,7 @@ int app_kda_hkdf_handler(ACVP_TEST_CASE *test_case) {
         printf("Invalid hmac alg in KDA-HKDF\n");
         goto end;
     }
-    kdf = EVP_KDF_fetch(NULL, "HKDF", NULL);
+    kdf = app_kdf_fetch("HKDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in HKDF\n");
@@ -206,7 +64,7 @@ int app_kda_hkdf_handler(ACVP_TEST_CASE *test_case) {
     }
     OSSL_PARAM_BLD_push_utf8_string(pbld, OSSL_KDF_PARAM_DIGEST, md, 0);
     OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_KEY, stc->z, (size_t)stc->zLen);
-    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, fixedInfo, (size_t)fixedInfoLen);
+    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, stc->fixedInfo, (size_t)stc->fixedInfoLen);
     OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_SALT, stc->salt, (size_t)stc->saltLen);
     params = OSSL_PARAM_BLD_to_param(pbld);
     if (!params) {
@@ -221,7 +79,6 @@ int app_kda_hkdf_handler(ACVP_TEST_CASE *test_case) {
 end:
     if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (params) OSSL_PARAM_free(params);
-    if (fixedInfo) free(fixedInfo);
     if (kdf) EVP_KDF_free(kdf);
     if (kctx) EVP_KDF_CTX_free(kctx);
     return rc;
@@ -230,8 +87,7 @@ end:
 
 int app_kda_onestep_handler(ACVP_TEST_CASE *test_case) {
     ACVP_KDA_ONESTEP_TC *stc = NULL;
-    int rc = 1, fixedInfoLen = 0;
-    unsigned char *fixedInfo = NULL;
+    int rc = 1;
     OSSL_PARAM_BLD *pbld = NULL;
     OSSL_PARAM *params = NULL;
     EVP_KDF *kdf = NULL;
@@ -254,15 +110,8 @@ int app_kda_onestep_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
-    fixedInfo = fixed_info_gen_concat(stc->fixedInfoPattern, stc->literalCandidate, stc->uPartyId,
-                                      stc->uEphemeralData, stc->vPartyId, stc->vEphemeralData,
-                                      stc->algorithmId, stc->label, stc->context, stc->t,
-                                      stc->literalLen, stc->uPartyIdLen, stc->uEphemeralLen,
-                                      stc->vPartyIdLen, stc->vEphemeralLen, stc->algIdLen,
-                                      stc->labelLen, stc->contextLen, stc->tLen, stc->l, 
-                                      &fixedInfoLen);
-    if (!fixedInfo) {
-        printf("Error creating fixed info\n");
+    if (!stc->fixedInfo) {
+        printf("Test case missing fixedInfo\n");
         goto end;
     }
 
@@ -363,7 +212,7 @@ int app_kda_onestep_handler(ACVP_TEST_CASE *test_case) {
         }
     }
 
-    kdf = EVP_KDF_fetch(NULL, "SSKDF", NULL);
+    kdf = app_kdf_fetch("SSKDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in KDA Onestep\n");
@@ -382,7 +231,7 @@ int app_kda_onestep_handler(ACVP_TEST_CASE *test_case) {
         OSSL_PARAM_BLD_push_utf8_string(pbld, OSSL_KDF_PARAM_DIGEST, md, 0);
     }
     OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_KEY, stc->z, (size_t)stc->zLen);
-    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, fixedInfo, (size_t)fixedInfoLen);
+    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, stc->fixedInfo, (size_t)stc->fixedInfoLen);
     params = OSSL_PARAM_BLD_to_param(pbld);
     if (!params) {
         printf("Error generating params in KDA Onestep\n");
@@ -396,7 +245,6 @@ int app_kda_onestep_handler(ACVP_TEST_CASE *test_case) {
 end:
     OSSL_PARAM_BLD_free(pbld);
     OSSL_PARAM_free(params);
-    if (fixedInfo) free(fixedInfo);
     if (kdf) EVP_KDF_free(kdf);
     if (kctx) EVP_KDF_CTX_free(kctx);
     return rc;
@@ -404,8 +252,7 @@ end:
 
 int app_kda_twostep_handler(ACVP_TEST_CASE *test_case) {
     ACVP_KDA_TWOSTEP_TC *stc = NULL;
-    int rc = 1, fixedInfoLen = 0;
-    unsigned char *fixedInfo = NULL;
+    int rc = 1;
     OSSL_PARAM_BLD *pbld = NULL;
     OSSL_PARAM *params = NULL;
     EVP_KDF *kdf = NULL;
@@ -425,15 +272,8 @@ int app_kda_twostep_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
-    fixedInfo = fixed_info_gen_concat(stc->fixedInfoPattern, stc->literalCandidate, stc->uPartyId,
-                                      stc->uEphemeralData, stc->vPartyId, stc->vEphemeralData,
-                                      stc->algorithmId, stc->label, stc->context, stc->t,
-                                      stc->literalLen, stc->uPartyIdLen, stc->uEphemeralLen,
-                                      stc->vPartyIdLen, stc->vEphemeralLen, stc->algIdLen,
-                                      stc->labelLen, stc->contextLen, stc->tLen, stc->l, 
-                                      &fixedInfoLen);
-    if (!fixedInfo) {
-        printf("Error creating fixed info\n");
+    if (!stc->fixedInfo) {
+        printf("Test case missing fixedInfo\n");
         goto end;
     }
 
@@ -484,7 +324,7 @@ int app_kda_twostep_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
-    kdf = EVP_KDF_fetch(NULL, "HKDF", NULL);
+    kdf = app_kdf_fetch("HKDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in KDA twostep\n");
@@ -497,7 +337,7 @@ int app_kda_twostep_handler(ACVP_TEST_CASE *test_case) {
     }
     OSSL_PARAM_BLD_push_utf8_string(pbld, OSSL_KDF_PARAM_DIGEST, alg, 0);
     OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_KEY, stc->z, (size_t)stc->zLen);
-    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, fixedInfo, (size_t)fixedInfoLen);
+    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, stc->fixedInfo, (size_t)stc->fixedInfoLen);
     OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_SALT, stc->salt, (size_t)stc->saltLen);
     params = OSSL_PARAM_BLD_to_param(pbld);
     if (!params) {
@@ -512,7 +352,6 @@ int app_kda_twostep_handler(ACVP_TEST_CASE *test_case) {
 end:
     if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (params) OSSL_PARAM_free(params);
-    if (fixedInfo) free(fixedInfo);
     if (kdf) EVP_KDF_free(kdf);
     if (kctx) EVP_KDF_CTX_free(kctx);
     return rc;
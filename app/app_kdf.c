@@ -102,7 +102,7 @@ int app_kdf135_x942_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
-    kdf = EVP_KDF_fetch(NULL, "X942KDF", NULL);
+    kdf = app_kdf_fetch("X942KDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in KDF X942\n");
@@ -215,7 +215,7 @@ int app_kdf135_x963_handler(ACVP_TEST_CASE *test_case) {
     }
     strcpy_s(aname, 256, alg);
 
-    kdf = EVP_KDF_fetch(NULL, "X963KDF", NULL);
+    kdf = app_kdf_fetch("X963KDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in KDF X963\n");
@@ -250,92 +250,75 @@ end:
     return rc;
 }
 
-int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
-    ACVP_KDF108_TC *stc = NULL;
-    int rc = 1, isHmac = 1, fixed_len = 64;
-    char *aname = NULL;
-    unsigned char *fixed = NULL;
-    OSSL_PARAM_BLD *pbld = NULL;
-    OSSL_PARAM *params = NULL;
-    EVP_KDF *kdf = NULL;
-    EVP_KDF_CTX *kctx = NULL;
-    const char *alg = NULL, *mac = NULL;
-
-    if (!test_case) {
-        printf("Missing kdf108 test case\n");
-        return -1;
-    }
-    stc = test_case->tc.kdf108;
-    if (!stc) {
-        printf("Missing kdf108 test case\n");
-        return -1;
-    }
-
-    switch (stc->mac_mode) {
+/* Looks up the MAC of a KDF108 PRF, and the digest or cipher it is built on */
+static int app_kdf108_prf(ACVP_KDF108_MAC_MODE_VAL mac_mode, const char **mac, const char **alg, int *isHmac) {
+    *alg = NULL;
+    *isHmac = 1;
+    switch (mac_mode) {
     case ACVP_KDF108_MAC_MODE_HMAC_SHA1:
-        alg = "SHA-1";
-        mac = "HMAC";
+        *alg = "SHA-1";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA224:
-        alg = "SHA2-224";
-        mac = "HMAC";
+        *alg = "SHA2-224";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA256:
-        alg = "SHA2-256";
-        mac = "HMAC";
+        *alg = "SHA2-256";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA384:
-        alg = "SHA2-384";
-        mac = "HMAC";
+        *alg = "SHA2-384";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA512:
-        alg = "SHA2-512";
-        mac = "HMAC";
+        *alg = "SHA2-512";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA512_224:
-        alg = "SHA2-512/224";
-        mac = "HMAC";
+        *alg = "SHA2-512/224";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA512_256:
-        alg = "SHA2-512/256";
-        mac = "HMAC";
+        *alg = "SHA2-512/256";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA3_224:
-        alg = "SHA3-224";
-        mac = "HMAC";
+        *alg = "SHA3-224";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA3_256:
-        alg = "SHA3-256";
-        mac = "HMAC";
+        *alg = "SHA3-256";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA3_384:
-        alg = "SHA3-384";
-        mac = "HMAC";
+        *alg = "SHA3-384";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_HMAC_SHA3_512:
-        alg = "SHA3-512";
-        mac = "HMAC";
+        *alg = "SHA3-512";
+        *mac = "HMAC";
         break;
     case ACVP_KDF108_MAC_MODE_CMAC_AES128:
-        alg = "AES128";
-        mac = "CMAC";
-        isHmac = 0;
+        *alg = "AES128";
+        *mac = "CMAC";
+        *isHmac = 0;
         break;
     case ACVP_KDF108_MAC_MODE_CMAC_AES192:
-        alg = "AES192";
-        mac = "CMAC";
-        isHmac = 0;
+        *alg = "AES192";
+        *mac = "CMAC";
+        *isHmac = 0;
         break;
     case ACVP_KDF108_MAC_MODE_CMAC_AES256:
-        alg = "AES256";
-        mac = "CMAC";
-        isHmac = 0;
+        *alg = "AES256";
+        *mac = "CMAC";
+        *isHmac = 0;
         break;
     case ACVP_KDF108_MAC_MODE_KMAC_128:
-        mac = "KMAC128";
+        *mac = "KMAC128";
         break;
     case ACVP_KDF108_MAC_MODE_KMAC_256:
-        mac = "KMAC256";
+        *mac = "KMAC256";
         break;
     case ACVP_KDF108_MAC_MODE_MIN:
     case ACVP_KDF108_MAC_MODE_CMAC_TDES:
@@ -344,6 +327,26 @@ int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
         printf("app_kda_kdf108_handler error: Unsupported mac algorithm\n");
         return 1;
     }
+    return 0;
+}
+
+/*
+ * Creates a KBKDF context holding what the test cases of a KDF108 group have
+ * in common: the MAC of the PRF, its digest or cipher, and the mode. Test
+ * cases set their key on it, which rekeys the MAC.
+ */
+static EVP_KDF_CTX *app_kdf108_ctx_new(ACVP_KDF108_TC *stc) {
+    int isHmac = 1;
+    char *aname = NULL;
+    OSSL_PARAM_BLD *pbld = NULL;
+    OSSL_PARAM *params = NULL;
+    EVP_KDF *kdf = NULL;
+    EVP_KDF_CTX *kctx = NULL;
+    const char *alg = NULL, *mac = NULL;
+
+    if (app_kdf108_prf(stc->mac_mode, &mac, &alg, &isHmac)) {
+        return NULL;
+    }
 
     if (alg) {
         aname = calloc(256, sizeof(char)); //avoid const removal warnings
@@ -354,18 +357,7 @@ int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
         strcpy_s(aname, 256, alg);
     }
 
-    if (stc->mac_mode != ACVP_KDF108_MAC_MODE_KMAC_128 && stc->mac_mode != ACVP_KDF108_MAC_MODE_KMAC_256) {
-        fixed = calloc(fixed_len, sizeof(char)); //arbitrary length fixed info
-        if (!fixed) {
-            printf("Error allocating memory for KDF 108\n");
-            goto end;
-        }
-        RAND_bytes(fixed, fixed_len);
-        memcpy_s(stc->fixed_data, ACVP_KDF108_FIXED_DATA_MAX, fixed, fixed_len);
-        stc->fixed_data_len = fixed_len;
-    }
-
-    kdf = EVP_KDF_fetch(NULL, "KBKDF", NULL);
+    kdf = app_kdf_fetch("KBKDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in kdf108\n");
@@ -374,17 +366,9 @@ int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
     pbld = OSSL_PARAM_BLD_new();
     if (!pbld) {
         printf("Error creating param_bld in kdf108\n");
-        goto end;
+        goto err;
     }
     OSSL_PARAM_BLD_push_utf8_string(pbld, OSSL_KDF_PARAM_MAC, mac, 0);
-    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_KEY, stc->key_in, stc->key_in_len);
-    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_SEED, stc->iv, stc->iv_len);
-    if (stc->mac_mode == ACVP_KDF108_MAC_MODE_KMAC_128 || stc->mac_mode == ACVP_KDF108_MAC_MODE_KMAC_256) {
-        OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, stc->context, stc->context_len);
-        OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_SALT, stc->label, stc->label_len);
-    } else {
-        OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, fixed, fixed_len);
-    }
     OSSL_PARAM_BLD_push_int(pbld, OSSL_KDF_PARAM_KBKDF_USE_SEPARATOR, 0);
     OSSL_PARAM_BLD_push_int(pbld, OSSL_KDF_PARAM_KBKDF_USE_L, 0);
 
@@ -402,6 +386,102 @@ int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
         OSSL_PARAM_BLD_push_utf8_string(pbld, OSSL_KDF_PARAM_MODE, "FEEDBACK", 0);
     }
 
+    params = OSSL_PARAM_BLD_to_param(pbld);
+    if (!params) {
+        printf("Error generating params in kdf108\n");
+        goto err;
+    }
+    if (EVP_KDF_CTX_set_params(kctx, params) != 1) {
+        printf("Error setting up KDF CTX in kdf108\n");
+        goto err;
+    }
+    goto end;
+
+err:
+    EVP_KDF_CTX_free(kctx);
+    kctx = NULL;
+end:
+    if (aname) free(aname);
+    if (pbld) OSSL_PARAM_BLD_free(pbld);
+    if (params) OSSL_PARAM_free(params);
+    if (kdf) EVP_KDF_free(kdf);
+    return kctx;
+}
+
+/*
+ * Sets up the PRF of each test group once, as the group starts, instead of
+ * fetching the KDF and building the MAC again for every test case
+ */
+int app_kdf108_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_KDF108_TC *stc = NULL;
+
+    if (!test_case || !test_case->tc.kdf108) {
+        return 1;
+    }
+    stc = test_case->tc.kdf108;
+
+    if (event == ACVP_TG_END) {
+        EVP_KDF_CTX_free(stc->tg_ctx);
+        stc->tg_ctx = NULL;
+        return 0;
+    }
+
+    stc->tg_ctx = app_kdf108_ctx_new(stc);
+    return stc->tg_ctx ? 0 : 1;
+}
+
+int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_KDF108_TC *stc = NULL;
+    int rc = 1, fixed_len = 64;
+    unsigned char *fixed = NULL;
+    OSSL_PARAM_BLD *pbld = NULL;
+    OSSL_PARAM *params = NULL;
+    EVP_KDF_CTX *kctx = NULL;
+
+    if (!test_case) {
+        printf("Missing kdf108 test case\n");
+        return -1;
+    }
+    stc = test_case->tc.kdf108;
+    if (!stc) {
+        printf("Missing kdf108 test case\n");
+        return -1;
+    }
+
+    if (stc->tg_ctx) {
+        kctx = stc->tg_ctx;
+    } else {
+        kctx = app_kdf108_ctx_new(stc);
+        if (!kctx) {
+            goto end;
+        }
+    }
+
+    if (stc->mac_mode != ACVP_KDF108_MAC_MODE_KMAC_128 && stc->mac_mode != ACVP_KDF108_MAC_MODE_KMAC_256) {
+        fixed = calloc(fixed_len, sizeof(char)); //arbitrary length fixed info
+        if (!fixed) {
+            printf("Error allocating memory for KDF 108\n");
+            goto end;
+        }
+        RAND_bytes(fixed, fixed_len);
+        memcpy_s(stc->fixed_data, ACVP_KDF108_FIXED_DATA_MAX, fixed, fixed_len);
+        stc->fixed_data_len = fixed_len;
+    }
+
+    pbld = OSSL_PARAM_BLD_new();
+    if (!pbld) {
+        printf("Error creating param_bld in kdf108\n");
+        goto end;
+    }
+    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_KEY, stc->key_in, stc->key_in_len);
+    OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_SEED, stc->iv, stc->iv_len);
+    if (stc->mac_mode == ACVP_KDF108_MAC_MODE_KMAC_128 || stc->mac_mode == ACVP_KDF108_MAC_MODE_KMAC_256) {
+        OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, stc->context, stc->context_len);
+        OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_SALT, stc->label, stc->label_len);
+    } else {
+        OSSL_PARAM_BLD_push_octet_string(pbld, OSSL_KDF_PARAM_INFO, fixed, fixed_len);
+    }
+
     params = OSSL_PARAM_BLD_to_param(pbld);
     if (!params) {
         printf("Error generating params in kdf108\n");
@@ -415,12 +495,10 @@ int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
 
     rc = 0;
 end:
-    if (aname) free(aname);
     if (fixed) free(fixed);
     if (pbld) OSSL_PARAM_BLD_free(pbld);
     if (params) OSSL_PARAM_free(params);
-    if (kdf) EVP_KDF_free(kdf);
-    if (kctx) EVP_KDF_CTX_free(kctx);
+    if (kctx && kctx != stc->tg_ctx) EVP_KDF_CTX_free(kctx);
     return rc;
 }
 
@@ -463,7 +541,7 @@ int app_kdf135_ssh_handler(ACVP_TEST_CASE *test_case) {
     }
     strcpy_s(aname, 256, alg);
 
-    kdf = EVP_KDF_fetch(NULL, "SSHKDF", NULL);
+    kdf = app_kdf_fetch("SSHKDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in kdf135-ssh\n");
@@ -554,7 +632,7 @@ int app_pbkdf_handler(ACVP_TEST_CASE *test_case) {
     }
     strcpy_s(aname, 256, alg);
 
-    kdf = EVP_KDF_fetch(NULL, "PBKDF2", NULL);
+    kdf = app_kdf_fetch("PBKDF2", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in PBKDF\n");
@@ -623,7 +701,7 @@ int app_kdf_tls12_handler(ACVP_TEST_CASE *test_case) {
         goto end;
     }
 
-    kdf = EVP_KDF_fetch(NULL, "TLS1-PRF", NULL);
+    kdf = app_kdf_fetch("TLS1-PRF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating KDF CTX in TLS1.2 KDF\n");
@@ -860,7 +938,7 @@ int app_kdf_tls13_handler(ACVP_TEST_CASE *test_case) {
     }
     EVP_MD_CTX_free(mctx);
 
-    kdf = EVP_KDF_fetch(NULL, "TLS13-KDF", NULL);
+    kdf = app_kdf_fetch("TLS13-KDF", NULL);
     kctx = EVP_KDF_CTX_new(kdf);
     if (!kctx) {
         printf("Error creating CTX in TLS1.3 KDF\n");
@@ -1054,6 +1132,14 @@ int app_kdf135_ikev2_handler(ACVP_TEST_CASE *test_case) {
     printf("No application support\n");
     return 1;
 }
+int app_kdf108_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+
 int app_kdf108_handler(ACVP_TEST_CASE *test_case) {
     if (!test_case) {
         return -1;
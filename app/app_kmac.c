@@ -66,7 +66,7 @@ int app_kmac_handler(ACVP_TEST_CASE *test_case) {
         return rv;
     }
 
-    mac = EVP_MAC_fetch(NULL, alg_name, NULL);
+    mac = app_mac_fetch(alg_name, NULL);
     if (!mac) {
         printf("Error: unable to fetch KMAC");
         goto end;
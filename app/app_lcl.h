@@ -27,6 +27,10 @@ extern "C"
 #define JSON_REQUEST_LENGTH 128
 #define PROVIDER_NAME_MAX_LEN 64
 #define ALG_STR_MAX_LEN 256 /* arbitrary */
+#define APP_VS_IDS_MAX 256 /* arbitrary */
+#define APP_AFFINITY_IDS_MAX 1024 /* as libacvp allows */
+#define APP_MERGE_FILES_MAX 64 /* arbitrary */
+#define APP_ASYNC_LOG_ENTRIES 1024 /* arbitrary */
 extern char value[JSON_STRING_LENGTH];
 
 #define ANSI_COLOR_RED "\x1b[31m"
@@ -43,6 +47,7 @@ typedef struct app_config {
     int get;
     int get_results;
     int resume_session;
+    int rerun_failed;
     int cancel_session;
     int post;
     int put;
@@ -53,6 +58,26 @@ typedef struct app_config {
     int save_to;
     int get_cost;
     int get_reg;
+    int compact;
+    int threads;
+    int parallel_vs;
+    int metrics;
+    int journal;
+    int vs_cache;
+    int remote; /* 1 coordinator, 2 worker */
+    int memory_budget; /* megabytes */
+    int huge_pages;
+    int request_timeout; /* milliseconds */
+    int hedge;
+    int affinity; /* ACVP_AFFINITY */
+    int affinity_cnt;
+    int async_log;
+    int preconnect;
+    int verify_expected;
+    int vs_id_cnt;
+    int shard;
+    int shard_cnt;
+    int merge_cnt;
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     int disable_fips;
 #endif
@@ -67,6 +92,14 @@ typedef struct app_config {
     char delete_url[JSON_REQUEST_LENGTH + 1];
     char validation_metadata_file[JSON_FILENAME_LENGTH + 1];
     char save_file[JSON_FILENAME_LENGTH + 1];
+    char metrics_file[JSON_FILENAME_LENGTH + 1];
+    char journal_file[JSON_FILENAME_LENGTH + 1];
+    char vs_cache_dir[JSON_FILENAME_LENGTH + 1];
+    char remote_dir[JSON_FILENAME_LENGTH + 1];
+    char expected_file[JSON_FILENAME_LENGTH + 1];
+    int vs_ids[APP_VS_IDS_MAX];
+    int affinity_ids[APP_AFFINITY_IDS_MAX];
+    char merge_files[APP_MERGE_FILES_MAX][JSON_FILENAME_LENGTH + 1];
 
     /* limit in GiB of hash tasting supported on the platform */
     int max_ldt_size;
@@ -98,17 +131,43 @@ int get_nid_for_curve(ACVP_EC_CURVE curve);
 const EVP_MD *get_md_for_hash_alg(ACVP_HASH_ALG alg);
 const char *get_md_string_for_hash_alg(ACVP_HASH_ALG alg, int *md_size);
 char *ec_point_to_pub_key(unsigned char *x, int x_len, unsigned char *y, int y_len, int *key_len);
+void app_mct_shift_in(unsigned char *tail, const unsigned char *out, int nbits);
+void app_set_pkey_gen_cb(EVP_PKEY_CTX *ctx, ACVP_TC_CONTROL *control);
+
+/* What a handler keeps from one call to the next, per thread */
+typedef enum app_state_slot {
+    APP_STATE_AES = 0,
+    APP_STATE_DES,
+    APP_STATE_DSA,
+    APP_STATE_RSA,
+    APP_STATE_ECDSA,
+    APP_STATE_EDDSA,
+    APP_STATE_MAC,
+    APP_STATE_MAX
+} APP_STATE_SLOT;
+
+void *app_thread_state_get(APP_STATE_SLOT slot);
+int app_thread_state_set(APP_STATE_SLOT slot, void *state, void (*free_fn)(void *state));
+void app_thread_state_cleanup(void);
+EVP_CIPHER_CTX *app_thread_cipher_ctx(APP_STATE_SLOT slot);
 
 void app_aes_cleanup(void);
 void app_des_cleanup(void);
 
 int app_aes_handler(ACVP_TEST_CASE *test_case);
+int app_aes_mct_handler(ACVP_TEST_CASE *test_case);
 int app_aes_handler_aead(ACVP_TEST_CASE *test_case);
 int app_aes_keywrap_handler(ACVP_TEST_CASE *test_case);
 int app_des_handler(ACVP_TEST_CASE *test_case);
+int app_des_mct_handler(ACVP_TEST_CASE *test_case);
+int app_des_mct_loop_handler(ACVP_TEST_CASE *test_case);
 int app_sha_handler(ACVP_TEST_CASE *test_case);
+int app_sha_mct_handler(ACVP_TEST_CASE *test_case);
+int app_sha_mct_loop_handler(ACVP_TEST_CASE *test_case);
 int app_hmac_handler(ACVP_TEST_CASE *test_case);
+int app_hmac_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_cmac_handler(ACVP_TEST_CASE *test_case);
+int app_cmac_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_kmac_handler(ACVP_TEST_CASE *test_case);
 
 #define ENGID1 "800002B805123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456"
@@ -119,6 +178,7 @@ int app_kdf135_ssh_handler(ACVP_TEST_CASE *test_case);
 int app_kdf135_srtp_handler(ACVP_TEST_CASE *test_case);
 int app_kdf135_ikev2_handler(ACVP_TEST_CASE *test_case);
 int app_kdf108_handler(ACVP_TEST_CASE *test_case);
+int app_kdf108_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_kdf135_ikev1_handler(ACVP_TEST_CASE *test_case);
 int app_kdf135_x942_handler(ACVP_TEST_CASE *test_case);
 int app_kdf135_x963_handler(ACVP_TEST_CASE *test_case);
@@ -135,17 +195,23 @@ int app_dsa_handler(ACVP_TEST_CASE *test_case);
 int app_kas_ecc_handler(ACVP_TEST_CASE *test_case);
 int app_kas_ffc_handler(ACVP_TEST_CASE *test_case);
 int app_kas_ifc_handler(ACVP_TEST_CASE *test_case);
+int app_kas_ifc_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_kda_hkdf_handler(ACVP_TEST_CASE *test_case);
 int app_kda_onestep_handler(ACVP_TEST_CASE *test_case);
 int app_kda_twostep_handler(ACVP_TEST_CASE *test_case);
 int app_kts_ifc_handler(ACVP_TEST_CASE *test_case);
+int app_kts_ifc_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_rsa_keygen_handler(ACVP_TEST_CASE *test_case);
 int app_rsa_sig_handler(ACVP_TEST_CASE *test_case);
+int app_rsa_sig_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_rsa_decprim_handler(ACVP_TEST_CASE *test_case);
 int app_rsa_sigprim_handler(ACVP_TEST_CASE *test_case);
 int app_ecdsa_handler(ACVP_TEST_CASE *test_case);
+int app_ecdsa_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_eddsa_handler(ACVP_TEST_CASE *test_case);
+int app_eddsa_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_drbg_handler(ACVP_TEST_CASE *test_case);
+int app_drbg_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event);
 int app_safe_primes_handler(ACVP_TEST_CASE *test_case);
 int app_lms_handler(ACVP_TEST_CASE *test_case);
 
@@ -155,6 +221,19 @@ const char *get_string_from_oid(unsigned char *oid, int oid_len);
 const char *get_ed_instance_param(ACVP_ED_CURVE curve, int is_prehash, int has_context);
 const char *get_ed_curve_string(ACVP_ED_CURVE curve);
 const char *get_provider_version(const char *provider_name);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+EVP_CIPHER *app_cipher_fetch(const char *name, const char *props);
+EVP_MAC *app_mac_fetch(const char *name, const char *props);
+EVP_KDF *app_kdf_fetch(const char *name, const char *props);
+EVP_RAND *app_rand_fetch(const char *name, const char *props);
+void app_fetch_cleanup(void);
+
+typedef struct app_mac_group_t APP_MAC_GROUP;
+APP_MAC_GROUP *app_mac_group_new(const char *mac_name, const char *param_name, const char *param_value);
+EVP_MAC_CTX *app_mac_group_ctx(APP_MAC_GROUP *group, unsigned int key_id,
+                               const unsigned char *key, size_t key_len);
+void app_mac_group_free(APP_MAC_GROUP *group);
+#endif
 #if 0 /* Will use in a future release */
 int provider_ver_str_to_int(const char *str);
 #endif
@@ -15,7 +15,9 @@ int app_lms_handler(ACVP_TEST_CASE *test_case) {
      * For LMS sigver, the output is the ver_disposition flag (1 if verified, <= 0 if failed)
      * For LMS siggen, the output for each test case is the signature in sig/sig_len. However, each test group also needs
      *     a public key. The library will grab your generated public key from pub_key/pub_key_len in the first test case
-     *     for each test group (see RSA and ECDSA siggen as they work similarly).
+     *     for each test group (see RSA and ECDSA siggen as they work similarly). A group handler, see
+     *     acvp_cap_set_group_handler(), can generate that key and its tree once when the group starts
+     *     and keep them in tg_ctx for every test case of the group to sign with.
      * For LMS keygen, the output is the generated public key stored in pub_key/pub_key_len.
      */
     if (!test_case) {
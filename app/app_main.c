@@ -70,6 +70,9 @@ char value[JSON_STRING_LENGTH] = "same";
 
 int max_ldt_size;
 
+/* Where status goes; stderr when the vector responses are streamed to stdout */
+static FILE *log_fp;
+
 #define CHECK_ENABLE_CAP_RV(rv) \
     if (rv != ACVP_SUCCESS) { \
         printf("Failed to register capability with libacvp (rv=%d: %s)\n", rv, acvp_lookup_error_string(rv)); \
@@ -102,14 +105,14 @@ static void setup_session_parameters(void) {
     cert_file = getenv("ACV_CERT_FILE");
     key_file = getenv("ACV_KEY_FILE");
 
-    printf("Using the following parameters:\n\n");
-    printf("    ACV_SERVER:     %s\n", server);
-    printf("    ACV_PORT:       %d\n", port);
-    printf("    ACV_URI_PREFIX: %s\n", path_segment);
-    if (ca_chain_file) printf("    ACV_CA_FILE:    %s\n", ca_chain_file);
-    if (cert_file) printf("    ACV_CERT_FILE:  %s\n", cert_file);
-    if (key_file) printf("    ACV_KEY_FILE:   %s\n", key_file);
-    printf("\n");
+    fprintf(log_fp, "Using the following parameters:\n\n");
+    fprintf(log_fp, "    ACV_SERVER:     %s\n", server);
+    fprintf(log_fp, "    ACV_PORT:       %d\n", port);
+    fprintf(log_fp, "    ACV_URI_PREFIX: %s\n", path_segment);
+    if (ca_chain_file) fprintf(log_fp, "    ACV_CA_FILE:    %s\n", ca_chain_file);
+    if (cert_file) fprintf(log_fp, "    ACV_CERT_FILE:  %s\n", cert_file);
+    if (key_file) fprintf(log_fp, "    ACV_KEY_FILE:   %s\n", key_file);
+    fprintf(log_fp, "\n");
 }
 
 #define CHECK_NON_ALLOWED_ALG(enabled, str) \
@@ -160,14 +163,14 @@ static int verify_algorithms(APP_CONFIG *cfg) {
 /* libacvp calls this function for status updates, debugs, warnings, and errors. */
 static ACVP_RESULT progress(char *msg, ACVP_LOG_LVL level) {
 
-    printf("[ACVP]");
+    fprintf(log_fp, "[ACVP]");
 
     switch (level) {
     case ACVP_LOG_LVL_ERR:
-        printf(ANSI_COLOR_RED "[ERROR]" ANSI_COLOR_RESET);
+        fprintf(log_fp, ANSI_COLOR_RED "[ERROR]" ANSI_COLOR_RESET);
         break;
     case ACVP_LOG_LVL_WARN:
-        printf(ANSI_COLOR_YELLOW "[WARNING]" ANSI_COLOR_RESET);
+        fprintf(log_fp, ANSI_COLOR_YELLOW "[WARNING]" ANSI_COLOR_RESET);
         break;
     case ACVP_LOG_LVL_STATUS:
     case ACVP_LOG_LVL_INFO:
@@ -179,7 +182,7 @@ static ACVP_RESULT progress(char *msg, ACVP_LOG_LVL level) {
         break;
     }
 
-    printf(": %s\n", msg);
+    fprintf(log_fp, ": %s\n", msg);
 
     return ACVP_SUCCESS;
 }
@@ -200,10 +203,60 @@ static void app_cleanup(ACVP_CTX *ctx) {
 #ifdef ACVP_FIPS186_5
     app_eddsa_cleanup();
 #endif
+    app_fetch_cleanup();
 #endif
+    app_thread_state_cleanup();
 }
 
 #ifndef ACVP_APP_LIB_WRAPPER
+static FILE *metrics_fp = NULL;
+
+/*
+ * libacvp calls this with the time spent on each test group and vector set,
+ * and the memory it held, possibly from several threads at once; each line
+ * is written in one call.
+ */
+static void metrics(const ACVP_METRICS *m, void *arg) {
+    FILE *fp = arg;
+
+    fprintf(fp, "%d,%d,%llu,%llu,%llu,%llu,%llu,%u,%llu,%llu\n", m->vs_id, m->tg_id,
+            m->ns[ACVP_METRICS_PARSE], m->ns[ACVP_METRICS_CRYPTO], m->ns[ACVP_METRICS_OUTPUT],
+            m->ns[ACVP_METRICS_SERIALIZE], m->ns[ACVP_METRICS_TRANSPORT], m->crypto_calls,
+            (unsigned long long)m->mem_current, (unsigned long long)m->mem_peak);
+}
+
+/*
+ * Prints what each vector set of the registration is expected to take, the
+ * ones on the critical path marked with a *, and the run as a whole.
+ */
+static void print_cost(ACVP_CTX *ctx) {
+    ACVP_VS_ESTIMATE *est = NULL;
+    ACVP_RUN_ESTIMATE run;
+    int count = 0, i = 0;
+
+    if (acvp_estimate_vector_sets(ctx, 0, NULL, 0, &count, NULL) != ACVP_SUCCESS || !count) {
+        return;
+    }
+    est = calloc(count, sizeof(ACVP_VS_ESTIMATE));
+    if (!est) {
+        return;
+    }
+    if (acvp_estimate_vector_sets(ctx, 0, est, count, &count, &run) != ACVP_SUCCESS) {
+        free(est);
+        return;
+    }
+    printf("  %-28s %10s %12s %10s %6s\n", "Vector set", "Test cases", "Seconds", "KB", "Worker");
+    for (i = 0; i < count; i++) {
+        printf("%c %-14s %-13s %10d %12.3f %10llu %6d\n", est[i].critical ? '*' : ' ',
+               est[i].algorithm ? est[i].algorithm : "?", est[i].mode ? est[i].mode : "",
+               est[i].test_cases, est[i].ns / 1e9, (unsigned long long)(est[i].bytes / 1024), est[i].worker);
+    }
+    printf("\nExpected to take %.3f seconds one after the other, and %.3f seconds (* above) on %d worker(s),\n",
+           run.total_ns / 1e9, run.wall_ns / 1e9, run.parallel);
+    printf("holding up to %llu KB at once.\n\n", (unsigned long long)(run.peak_bytes / 1024));
+    free(est);
+}
+
 int main(int argc, char **argv) {
     ACVP_RESULT rv = ACVP_SUCCESS;
     ACVP_CTX *ctx = NULL;
@@ -215,6 +268,15 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    log_fp = stdout;
+    if (cfg.vector_rsp && cfg.vector_rsp_file[0] == '-' && !cfg.vector_rsp_file[1]) {
+        if (cfg.verify_expected) {
+            printf("Checking against expected results requires --vector_rsp to be a file\n");
+            return 1;
+        }
+        log_fp = stderr;
+    }
+
     if (!verify_algorithms(&cfg)) {
         printf("\nAlgorithm tests not supported by this crypto module have been requested. Please \n");
         printf("verify your testing capablities and try again.\n");
@@ -239,13 +301,13 @@ int main(int argc, char **argv) {
             return 1;
         }
     } else {
-        printf("***********************************************************************************\n");
-        printf("* WARNING: You have chosen to not fetch the FIPS provider for this run. Any tests *\n");
-        printf("* created or performed during this run MUST NOT have any validation requested     *\n");
-        printf("* on it unless the FIPS provider is exclusively loaded or enabled by default in   *\n");
-        printf("* your configuration. Proceed at your own risk. Continuing in 5 seconds...        *\n");
-        printf("***********************************************************************************\n");
-        printf("\n");
+        fprintf(log_fp, "***********************************************************************************\n");
+        fprintf(log_fp, "* WARNING: You have chosen to not fetch the FIPS provider for this run. Any tests *\n");
+        fprintf(log_fp, "* created or performed during this run MUST NOT have any validation requested     *\n");
+        fprintf(log_fp, "* on it unless the FIPS provider is exclusively loaded or enabled by default in   *\n");
+        fprintf(log_fp, "* your configuration. Proceed at your own risk. Continuing in 5 seconds...        *\n");
+        fprintf(log_fp, "***********************************************************************************\n");
+        fprintf(log_fp, "\n");
         acvp_sleep(5);
     }
 #endif
@@ -262,6 +324,14 @@ int main(int argc, char **argv) {
         goto end;
     }
 
+    if (cfg.async_log) {
+        rv = acvp_set_async_log(ctx, APP_ASYNC_LOG_ENTRIES);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to start the async log\n");
+            goto end;
+        }
+    }
+
     /* Next we specify the ACVP server address */
     rv = acvp_set_server(ctx, server, port);
     if (rv != ACVP_SUCCESS) {
@@ -307,6 +377,15 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (cfg.preconnect) {
+        /* Handshakes with the server while the capabilities are set up */
+        rv = acvp_preconnect(ctx);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to start connecting to the server: %s\n", acvp_lookup_error_string(rv));
+            goto end;
+        }
+    }
+
     /*
      * Setup the Two-factor authentication
      * This may or may not be turned on...
@@ -339,11 +418,153 @@ int main(int argc, char **argv) {
         acvp_mark_as_request_only(ctx, cfg.vector_req_file);
     }
 
+    if (cfg.compact) {
+        acvp_set_vector_req_compact(ctx, 1);
+        acvp_set_vector_rsp_compact(ctx, 1);
+    }
+
+    if (cfg.parallel_vs) {
+        rv = acvp_set_max_parallel_vector_sets(ctx, cfg.parallel_vs);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set the number of parallel vector sets\n");
+            goto end;
+        }
+    }
+
+    if (cfg.threads) {
+        rv = acvp_set_max_parallel_test_cases(ctx, cfg.threads);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set the number of test case threads\n");
+            goto end;
+        }
+    }
+
+    if (cfg.affinity) {
+        rv = acvp_set_worker_affinity(ctx, (ACVP_AFFINITY)cfg.affinity, cfg.affinity_ids, cfg.affinity_cnt);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set the worker affinity\n");
+            goto end;
+        }
+    }
+
+    if (cfg.metrics) {
+        metrics_fp = fopen(cfg.metrics_file, "w");
+        if (!metrics_fp) {
+            printf("Failed to open metrics file %s\n", cfg.metrics_file);
+            rv = ACVP_INVALID_ARG;
+            goto end;
+        }
+        fprintf(metrics_fp, "vs_id,tg_id,parse_ns,crypto_ns,output_ns,serialize_ns,transport_ns,crypto_calls,mem_bytes,mem_peak_bytes\n");
+        rv = acvp_set_metrics_cb(ctx, metrics, metrics_fp);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set metrics callback\n");
+            goto end;
+        }
+    }
+
+    if (cfg.journal) {
+        rv = acvp_set_checkpoint_journal(ctx, cfg.journal_file);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set checkpoint journal\n");
+            goto end;
+        }
+    }
+
+    if (cfg.vs_cache) {
+        rv = acvp_set_vector_set_download_cache(ctx, cfg.vs_cache_dir);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set vector set download cache\n");
+            goto end;
+        }
+    }
+
+    if (cfg.remote == 1) {
+        rv = acvp_set_remote_workers(ctx, cfg.remote_dir, 0);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set the remote worker directory\n");
+            goto end;
+        }
+    }
+
+    if (cfg.memory_budget) {
+        rv = acvp_set_memory_budget(ctx, (size_t)cfg.memory_budget * 1024 * 1024);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set the memory budget\n");
+            goto end;
+        }
+    }
+
+    if (cfg.huge_pages) {
+        rv = acvp_set_huge_pages(ctx, 1);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to enable huge pages\n");
+            goto end;
+        }
+    }
+
+    if (cfg.request_timeout) {
+        rv = acvp_set_request_timeout(ctx, cfg.request_timeout);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to set the request timeout\n");
+            goto end;
+        }
+    }
+
+    if (cfg.hedge) {
+        rv = acvp_set_hedged_requests(ctx, 1);
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to enable hedged requests\n");
+            goto end;
+        }
+    }
+
+    if (cfg.merge_cnt) {
+        const char *merge_files[APP_MERGE_FILES_MAX];
+        int i = 0;
+
+        if (!cfg.vector_rsp || cfg.vector_req) {
+            printf("Merging response files requires --vector_rsp, and not --vector_req\n");
+            goto end;
+        }
+        for (i = 0; i < cfg.merge_cnt; i++) {
+            merge_files[i] = cfg.merge_files[i];
+        }
+        rv = acvp_merge_vector_rsp_files(ctx, merge_files, cfg.merge_cnt, cfg.vector_rsp_file);
+        goto end;
+    }
+
+    if (cfg.verify_expected && !cfg.vector_rsp) {
+        printf("Checking against expected results requires --vector_rsp\n");
+        goto end;
+    }
+
+    if (!cfg.vector_req && cfg.vector_rsp && cfg.verify_expected) {
+        rv = acvp_verify_vectors_from_file(ctx, cfg.vector_rsp_file, cfg.expected_file, NULL);
+        goto end;
+    }
+
     if (!cfg.vector_req && cfg.vector_rsp) {
         printf("Offline vector processing requires both options, --vector_req and --vector_rsp\n");
         goto end;
     }
 
+    if (cfg.vs_id_cnt || cfg.shard_cnt) {
+        if (!cfg.vector_rsp) {
+            printf("--vs_ids and --shard require both options, --vector_req and --vector_rsp\n");
+            goto end;
+        }
+        if (cfg.vs_id_cnt) {
+            rv = acvp_set_vector_set_filter(ctx, cfg.vs_ids, cfg.vs_id_cnt);
+        }
+        if (rv == ACVP_SUCCESS && cfg.shard_cnt) {
+            rv = acvp_set_vector_set_shard(ctx, cfg.shard, cfg.shard_cnt);
+        }
+        if (rv != ACVP_SUCCESS) {
+            printf("Failed to select the vector sets to process\n");
+            goto end;
+        }
+    }
+
     if (cfg.manual_reg) {
         /*
          * Using a JSON to register allows us to skip the
@@ -393,6 +614,7 @@ int main(int argc, char **argv) {
             printf("Unable to get expected vector set count with given test session context.\n\n");
         } else {
             printf("The given test session context is expected to generate %d vector sets.\n\n", diff);
+            print_cost(ctx);
         }
         goto end;
     }
@@ -418,8 +640,16 @@ int main(int argc, char **argv) {
         goto end;
     }
 
+    if (cfg.remote == 2) {
+        rv = acvp_run_remote_worker(ctx, cfg.remote_dir, 0);
+        goto end;
+    }
+
     if (cfg.vector_req && cfg.vector_rsp) {
        rv = acvp_run_vectors_from_file(ctx, cfg.vector_req_file, cfg.vector_rsp_file);
+       if (rv == ACVP_SUCCESS && cfg.verify_expected) {
+           rv = acvp_verify_vectors_from_file(ctx, cfg.vector_rsp_file, cfg.expected_file, NULL);
+       }
        goto end;
     }
 
@@ -475,6 +705,11 @@ int main(int argc, char **argv) {
         goto end;
     }
 
+    if (cfg.rerun_failed) {
+        rv = acvp_rerun_failed_vector_sets(ctx, cfg.session_file, cfg.fips_validation);
+        goto end;
+    }
+
     if (cfg.cancel_session) {
         if (cfg.save_to) {
             rv = acvp_cancel_test_session(ctx, cfg.session_file, cfg.save_file);
@@ -505,6 +740,7 @@ end:
      * both the application and libacvp.
      */
     app_cleanup(ctx);
+    if (metrics_fp) fclose(metrics_fp);
 
     return rv;
 }
@@ -512,6 +748,10 @@ end:
 
 static int enable_aes(ACVP_CTX *ctx) {
     ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+    static const ACVP_CIPHER aes_mct_algs[] = {
+        ACVP_AES_ECB, ACVP_AES_CBC, ACVP_AES_OFB, ACVP_AES_CFB1, ACVP_AES_CFB8, ACVP_AES_CFB128
+    };
 
     /* Enable AES_GCM */
     rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_GCM, &app_aes_handler_aead);
@@ -720,6 +960,12 @@ static int enable_aes(ACVP_CTX *ctx) {
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_OFB, ACVP_SYM_CIPH_KEYLEN, 256);
     CHECK_ENABLE_CAP_RV(rv);
 
+    /* Run the Monte Carlo inner loops without going back through the library */
+    for (i = 0; i < (int)(sizeof(aes_mct_algs) / sizeof(aes_mct_algs[0])); i++) {
+        rv = acvp_cap_sym_cipher_set_mct_handler(ctx, aes_mct_algs[i], &app_aes_mct_handler);
+        CHECK_ENABLE_CAP_RV(rv);
+    }
+
     /* Register AES CCM capabilities */
     rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_CCM, &app_aes_handler_aead);
     CHECK_ENABLE_CAP_RV(rv);
@@ -988,6 +1234,10 @@ static int enable_tdes(ACVP_CTX *ctx) {
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_ECB, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_ECB, &app_des_mct_handler);
+    CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_ECB, &app_des_mct_loop_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 
     /* Enable 3DES-CBC */
     rv = acvp_cap_sym_cipher_enable(ctx, ACVP_TDES_CBC, &app_des_handler);
@@ -996,6 +1246,10 @@ static int enable_tdes(ACVP_CTX *ctx) {
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CBC, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CBC, &app_des_mct_handler);
+    CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CBC, &app_des_mct_loop_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 
 #if 0
     /* Enable 3DES-CBCI */
@@ -1043,6 +1297,10 @@ static int enable_tdes(ACVP_CTX *ctx) {
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_OFB, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_OFB, &app_des_mct_handler);
+    CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_OFB, &app_des_mct_loop_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 
     /* Enable 3DES-CFB64 */
     rv = acvp_cap_sym_cipher_enable(ctx, ACVP_TDES_CFB64, &app_des_handler);
@@ -1051,6 +1309,10 @@ static int enable_tdes(ACVP_CTX *ctx) {
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CFB64, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CFB64, &app_des_mct_handler);
+    CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CFB64, &app_des_mct_loop_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 
     /* Enable 3DES-CFB8 */
     rv = acvp_cap_sym_cipher_enable(ctx, ACVP_TDES_CFB8, &app_des_handler);
@@ -1059,6 +1321,10 @@ static int enable_tdes(ACVP_CTX *ctx) {
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CFB8, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CFB8, &app_des_mct_handler);
+    CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CFB8, &app_des_mct_loop_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 
     /* Enable 3DES-CFB1 */
     rv = acvp_cap_sym_cipher_enable(ctx, ACVP_TDES_CFB1, &app_des_handler);
@@ -1067,6 +1333,10 @@ static int enable_tdes(ACVP_CTX *ctx) {
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CFB1, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CFB1, &app_des_mct_handler);
+    CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CFB1, &app_des_mct_loop_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 #endif
 
 end:
@@ -1077,103 +1347,63 @@ end:
 static int enable_hash(ACVP_CTX *ctx) {
     ACVP_RESULT rv = ACVP_SUCCESS;
     int i = 0;
-
-    /* Enable SHA-1 and SHA-2 */
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA1, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA1, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA224, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA224, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA256, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA384, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA384, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA512, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA512, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    /* SHA2-512/224 and SHA2-512/256 */
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA512_224, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA512_224, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA512_256, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA512_256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    /* SHA3 and SHAKE */
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA3_224, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_224, ACVP_HASH_IN_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_224, ACVP_HASH_IN_EMPTY, 1);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA3_224, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA3_256, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_256, ACVP_HASH_IN_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_256, ACVP_HASH_IN_EMPTY, 1);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA3_256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA3_384, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_384, ACVP_HASH_IN_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_384, ACVP_HASH_IN_EMPTY, 1);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA3_384, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA3_512, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_512, ACVP_HASH_IN_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHA3_512, ACVP_HASH_IN_EMPTY, 1);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA3_512, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
-
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHAKE_128, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHAKE_128, ACVP_HASH_IN_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHAKE_128, ACVP_HASH_OUT_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHAKE_128, ACVP_HASH_IN_EMPTY, 1);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHAKE_128, ACVP_HASH_OUT_LENGTH, 16, 65536, 8);
+    static const ACVP_CIPHER hash_algs[] = {
+        ACVP_HASH_SHA1, ACVP_HASH_SHA224, ACVP_HASH_SHA256, ACVP_HASH_SHA384, ACVP_HASH_SHA512,
+        ACVP_HASH_SHA512_224, ACVP_HASH_SHA512_256, ACVP_HASH_SHA3_224, ACVP_HASH_SHA3_256,
+        ACVP_HASH_SHA3_384, ACVP_HASH_SHA3_512, ACVP_HASH_SHAKE_128, ACVP_HASH_SHAKE_256
+    };
+    static const ACVP_CAP_PARM_ENTRY hash_parms[] = {
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA1, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA224, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA384, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA512, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA512_224, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA512_256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_224, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_224, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_224, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_256, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_256, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_384, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_384, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_384, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_512, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_512, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_512, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHAKE_128, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHAKE_128, ACVP_HASH_OUT_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHAKE_128, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHAKE_128, ACVP_HASH_OUT_LENGTH, 16, 65536, 8 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHAKE_256, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHAKE_256, ACVP_HASH_OUT_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHAKE_256, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHAKE_256, ACVP_HASH_OUT_LENGTH, 16, 65536, 8 }
+    };
+
+    /* SHA-1, SHA-2, SHA3 and SHAKE */
+    for (i = 0; i < (int)(sizeof(hash_algs) / sizeof(hash_algs[0])); i++) {
+        rv = acvp_cap_hash_enable(ctx, hash_algs[i], &app_sha_handler);
+        CHECK_ENABLE_CAP_RV(rv);
+    }
+    rv = acvp_cap_set_parms(ctx, hash_parms, sizeof(hash_parms) / sizeof(hash_parms[0]));
     CHECK_ENABLE_CAP_RV(rv);
 
+    /* Run the Monte Carlo inner loops without going back through the library */
+    for (i = 0; i < (int)(sizeof(hash_algs) / sizeof(hash_algs[0])); i++) {
+        rv = acvp_cap_hash_set_mct_handler(ctx, hash_algs[i], &app_sha_mct_handler);
+        CHECK_ENABLE_CAP_RV(rv);
+    }
 
-    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHAKE_256, &app_sha_handler);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHAKE_256, ACVP_HASH_IN_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHAKE_256, ACVP_HASH_OUT_BIT, 0);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_parm(ctx, ACVP_HASH_SHAKE_256, ACVP_HASH_IN_EMPTY, 1);
-    CHECK_ENABLE_CAP_RV(rv);
-    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHAKE_256, ACVP_HASH_OUT_LENGTH, 16, 65536, 8);
-    CHECK_ENABLE_CAP_RV(rv);
+    /* SHA-3 and SHAKE run all of their checkpoints in one call, keeping their state */
+    for (i = 0; i < (int)(sizeof(hash_algs) / sizeof(hash_algs[0])); i++) {
+        if (acvp_get_hash_alg(hash_algs[i]) < ACVP_SUB_HASH_SHA3_224) {
+            continue;
+        }
+        rv = acvp_cap_hash_set_mct_loop_handler(ctx, hash_algs[i], &app_sha_mct_loop_handler);
+        CHECK_ENABLE_CAP_RV(rv);
+    }
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000080L /* 3.0.8 or greater */
     /* valid LDT increments are 1, 2, 4, and 8 GiB */
@@ -1215,6 +1445,8 @@ static int enable_cmac(ACVP_CTX *ctx) {
     /* Enable CMAC */
     rv = acvp_cap_cmac_enable(ctx, ACVP_CMAC_AES, &app_cmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_CMAC_AES, &app_cmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_cmac_set_domain(ctx, ACVP_CMAC_AES, ACVP_CMAC_MSGLEN, 0, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_cmac_set_parm(ctx, ACVP_CMAC_AES, ACVP_CMAC_MACLEN, 128);
@@ -1235,6 +1467,8 @@ static int enable_cmac(ACVP_CTX *ctx) {
 #if OPENSSL_VERSION_NUMBER < 0x30000000L
     rv = acvp_cap_cmac_enable(ctx, ACVP_CMAC_TDES, &app_cmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_CMAC_TDES, &app_cmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_cmac_set_domain(ctx, ACVP_CMAC_TDES, ACVP_CMAC_MSGLEN, 0, 65536, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_cmac_set_parm(ctx, ACVP_CMAC_TDES, ACVP_CMAC_MACLEN, 64);
@@ -1295,6 +1529,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA1, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA1, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA1, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA1, ACVP_HMAC_MACLEN, 32, 160, 8);
@@ -1304,6 +1540,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA2_224, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA2_224, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_224, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_224, ACVP_HMAC_MACLEN, 32, 224, 8);
@@ -1313,6 +1551,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA2_256, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA2_256, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_256, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_256, ACVP_HMAC_MACLEN, 32, 256, 8);
@@ -1322,6 +1562,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA2_384, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA2_384, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_384, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_384, ACVP_HMAC_MACLEN, 32, 384, 8);
@@ -1331,6 +1573,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA2_512, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA2_512, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_512, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_512, ACVP_HMAC_MACLEN, 32, 512, 8);
@@ -1340,6 +1584,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA2_512_224, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA2_512_224, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_512_224, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_512_224, ACVP_HMAC_MACLEN, 32, 224, 8);
@@ -1349,6 +1595,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
 
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA2_512_256, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA2_512_256, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_512_256, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA2_512_256, ACVP_HMAC_MACLEN, 32, 256, 8);
@@ -1358,6 +1606,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
     
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA3_224, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA3_224, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_224, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_224, ACVP_HMAC_MACLEN, 32, 224, 8);
@@ -1367,6 +1617,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
     
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA3_256, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA3_256, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_256, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_256, ACVP_HMAC_MACLEN, 32, 256, 8);
@@ -1376,6 +1628,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
     
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA3_384, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA3_384, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_384, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_384, ACVP_HMAC_MACLEN, 32, 384, 8);
@@ -1385,6 +1639,8 @@ static int enable_hmac(ACVP_CTX *ctx) {
     
     rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA3_512, &app_hmac_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA3_512, &app_hmac_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_512, ACVP_HMAC_KEYLEN, 8, 524288, 8);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_hmac_set_domain(ctx, ACVP_HMAC_SHA3_512, ACVP_HMAC_MACLEN, 32, 512, 8);
@@ -1583,6 +1839,8 @@ static int enable_kdf(ACVP_CTX *ctx) {
     /* KDF108 Counter Mode */
     rv = acvp_cap_kdf108_enable(ctx, &app_kdf108_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_KDF108, &app_kdf108_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_KDF108, ACVP_PREREQ_HMAC, value);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_KDF108, ACVP_PREREQ_CMAC, value);
@@ -1904,6 +2162,8 @@ static int enable_kas_ifc(ACVP_CTX *ctx) {
 
     rv = acvp_cap_kas_ifc_enable(ctx, ACVP_KAS_IFC_SSC, &app_kas_ifc_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_KAS_IFC_SSC, &app_kas_ifc_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_KAS_IFC_SSC, ACVP_PREREQ_RSA, value);
     CHECK_ENABLE_CAP_RV(rv);
 #if 0 /* no longer used, left here for historical purposes */
@@ -1980,6 +2240,8 @@ static int enable_kts_ifc(ACVP_CTX *ctx) {
 
     rv = acvp_cap_kts_ifc_enable(ctx, ACVP_KTS_IFC, &app_kts_ifc_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_KTS_IFC, &app_kts_ifc_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_KTS_IFC, ACVP_PREREQ_RSA, value);
     CHECK_ENABLE_CAP_RV(rv);
 #if 0 /* no longer used, left here for historical purposes */
@@ -2717,6 +2979,8 @@ static int enable_rsa(ACVP_CTX *ctx) {
     /* Enable siggen */
     rv = acvp_cap_rsa_sig_enable(ctx, ACVP_RSA_SIGGEN, &app_rsa_sig_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_RSA_SIGGEN, &app_rsa_sig_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_RSA_SIGGEN, ACVP_PREREQ_SHA, value);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_RSA_SIGGEN, ACVP_PREREQ_DRBG, value);
@@ -2837,6 +3101,8 @@ static int enable_rsa(ACVP_CTX *ctx) {
     /* Enable sigver */
     rv = acvp_cap_rsa_sig_enable(ctx, ACVP_RSA_SIGVER, &app_rsa_sig_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_RSA_SIGVER, &app_rsa_sig_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_RSA_SIGVER, ACVP_PREREQ_SHA, value);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_RSA_SIGVER, ACVP_PREREQ_DRBG, value);
@@ -3166,6 +3432,8 @@ static int enable_ecdsa(ACVP_CTX *ctx) {
     /* Enable ECDSA sigGen... */
     rv = acvp_cap_ecdsa_enable(ctx, ACVP_ECDSA_SIGGEN, &app_ecdsa_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_ECDSA_SIGGEN, &app_ecdsa_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_ECDSA_SIGGEN, ACVP_PREREQ_SHA, value);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_ECDSA_SIGGEN, ACVP_PREREQ_DRBG, value);
@@ -3228,6 +3496,8 @@ static int enable_ecdsa(ACVP_CTX *ctx) {
     /* Enable ECDSA sigGen... */
     rv = acvp_cap_ecdsa_enable(ctx, ACVP_DET_ECDSA_SIGGEN, &app_ecdsa_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_DET_ECDSA_SIGGEN, &app_ecdsa_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_DET_ECDSA_SIGGEN, ACVP_PREREQ_SHA, value);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_DET_ECDSA_SIGGEN, ACVP_PREREQ_DRBG, value);
@@ -3352,6 +3622,8 @@ static int enable_eddsa(ACVP_CTX *ctx) {
 
     rv = acvp_cap_eddsa_enable(ctx, ACVP_EDDSA_SIGGEN, &app_eddsa_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_EDDSA_SIGGEN, &app_eddsa_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_eddsa_set_parm(ctx, ACVP_EDDSA_SIGGEN, ACVP_EDDSA_CURVE, ACVP_ED_CURVE_25519);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_eddsa_set_parm(ctx, ACVP_EDDSA_SIGGEN, ACVP_EDDSA_CURVE, ACVP_ED_CURVE_448);
@@ -3383,6 +3655,8 @@ static int enable_drbg(ACVP_CTX *ctx) {
     /* Hash DRBG */
     rv = acvp_cap_drbg_enable(ctx, ACVP_HASHDRBG, &app_drbg_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HASHDRBG, &app_drbg_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
 
     rv = acvp_cap_set_prereq(ctx, ACVP_HASHDRBG, ACVP_PREREQ_SHA, value);
     CHECK_ENABLE_CAP_RV(rv);
@@ -3497,6 +3771,8 @@ static int enable_drbg(ACVP_CTX *ctx) {
     /* HMAC DRBG */
     rv = acvp_cap_drbg_enable(ctx, ACVP_HMACDRBG, &app_drbg_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMACDRBG, &app_drbg_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_HMACDRBG, ACVP_PREREQ_SHA, value);
     CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_HMACDRBG,ACVP_PREREQ_HMAC, value);
@@ -3612,6 +3888,8 @@ static int enable_drbg(ACVP_CTX *ctx) {
     /* CTR DRBG */
     rv = acvp_cap_drbg_enable(ctx, ACVP_CTRDRBG, &app_drbg_handler);
     CHECK_ENABLE_CAP_RV(rv);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_CTRDRBG, &app_drbg_group_handler);
+    CHECK_ENABLE_CAP_RV(rv);
     rv = acvp_cap_set_prereq(ctx, ACVP_CTRDRBG, ACVP_PREREQ_AES, value);
     CHECK_ENABLE_CAP_RV(rv);
 
@@ -4030,9 +4308,58 @@ end:
 #endif
 
 #ifdef ACVP_APP_LIB_WRAPPER
+/*
+ * The capabilities enabled together for offline testing; each family takes
+ * in the ciphers after the previous family's, up to and including last
+ */
+typedef struct app_cap_family_t {
+    ACVP_CIPHER last;
+    int (*enable)(ACVP_CTX *ctx);
+} APP_CAP_FAMILY;
+
+static const APP_CAP_FAMILY app_cap_families[] = {
+    { ACVP_AES_XPN, enable_aes },
+    { ACVP_TDES_KW, enable_tdes },
+    { ACVP_HASH_SHAKE_256, enable_hash },
+    { ACVP_CTRDRBG, enable_drbg },
+    { ACVP_HMAC_SHA3_512, enable_hmac },
+    { ACVP_CMAC_TDES, enable_cmac },
+    { ACVP_KMAC_256, enable_kmac },
+    { ACVP_DSA_SIGVER, enable_dsa },
+    { ACVP_RSA_SIGPRIM, enable_rsa },
+    { ACVP_DET_ECDSA_SIGGEN, enable_ecdsa },
+    { ACVP_EDDSA_SIGVER, enable_eddsa },
+    { ACVP_KDF_TLS13, enable_kdf },
+    { ACVP_KAS_ECC_SSC, enable_kas_ecc },
+    { ACVP_KAS_FFC_SSC, enable_kas_ffc },
+    { ACVP_KAS_IFC_SSC, enable_kas_ifc },
+    { ACVP_KDA_HKDF, enable_kda },
+    { ACVP_KTS_IFC, enable_kts_ifc },
+    { ACVP_SAFE_PRIMES_KEYVER, enable_safe_primes },
+    { ACVP_LMS_SIGVER, enable_lms }
+};
+#define APP_CAP_FAMILY_CNT (int)(sizeof(app_cap_families) / sizeof(app_cap_families[0]))
+
+/*
+ * Capability loader, see acvp_set_cap_loader(): enables the family of the
+ * cipher, once; arg flags the families already enabled
+ */
+static ACVP_RESULT app_load_caps(ACVP_CTX *ctx, ACVP_CIPHER cipher, void *arg) {
+    int *loaded = arg;
+    int i = 0;
+
+    for (i = 0; i < APP_CAP_FAMILY_CNT && cipher > app_cap_families[i].last; i++);
+    if (i == APP_CAP_FAMILY_CNT || loaded[i]) {
+        return ACVP_SUCCESS;
+    }
+    loaded[i] = 1;
+    return app_cap_families[i].enable(ctx) ? ACVP_INVALID_ARG : ACVP_SUCCESS;
+}
+
 ACVP_RESULT acvp_app_run_vector_test_file(const char *path, const char *output, ACVP_LOG_LVL lvl, ACVP_RESULT (*logger)(char *)) {
     ACVP_RESULT rv = ACVP_SUCCESS;
     ACVP_CTX *ctx = NULL;
+    int loaded[APP_CAP_FAMILY_CNT] = { 0 };
 
     /*
      * We begin the libacvp usage flow here.
@@ -4045,28 +4372,12 @@ ACVP_RESULT acvp_app_run_vector_test_file(const char *path, const char *output,
     }
 
     /*
-    * We need to register all possible crypto capabilities; since this code
-    * just performs offline testing with already requested vectors
-    */
-    if (enable_aes(ctx)) goto end;
-    if (enable_tdes(ctx)) goto end;
-    if (enable_hash(ctx)) goto end;
-    if (enable_cmac(ctx)) goto end;
-    if (enable_hmac(ctx)) goto end;
-    if (enable_kmac(ctx)) goto end;
-    if (enable_kdf(ctx)) goto end;
-    if (enable_dsa(ctx)) goto end;
-    if (enable_rsa(ctx)) goto end;
-    if (enable_ecdsa(ctx)) goto end;
-    if (enable_eddsa(ctx)) goto end;
-    if (enable_drbg(ctx)) goto end;
-    if (enable_kas_ecc(ctx)) goto end;
-    if (enable_kas_ifc(ctx)) goto end;
-    if (enable_kts_ifc(ctx)) goto end;
-    if (enable_kas_ffc(ctx)) goto end;
-    if (enable_kda(ctx)) goto end;
-    if (enable_safe_primes(ctx)) goto end;
-    if (enable_lms(ctx)) goto end;
+     * This code just performs offline testing with already requested
+     * vectors, so only the capabilities the vector sets in the file are
+     * for need to be registered; they are, as the library asks for them
+     */
+    rv = acvp_set_cap_loader(ctx, app_load_caps, loaded);
+    if (rv != ACVP_SUCCESS) goto end;
 
     rv = acvp_run_vectors_from_file(ctx, path, output);
 
@@ -19,15 +19,41 @@
 
 #define RSA_BUF_MAX 8192
 
-int rsa_current_tg = 0;
-BIGNUM *group_n = NULL;
-EVP_PKEY *group_pkey = NULL;
+/*
+ * The key of the test group being signed on the calling thread, used when
+ * no group handler made one, see app_thread_state_get()
+ */
+typedef struct app_rsa_group_t {
+    int tg_id;
+    EVP_PKEY *pkey;
+} APP_RSA_GROUP;
+
+static void app_rsa_group_free(void *arg) {
+    APP_RSA_GROUP *group = arg;
+
+    if (!group) {
+        return;
+    }
+    if (group->pkey) EVP_PKEY_free(group->pkey);
+    free(group);
+}
+
+static APP_RSA_GROUP *app_rsa_group(void) {
+    APP_RSA_GROUP *group = app_thread_state_get(APP_STATE_RSA);
+
+    if (group) {
+        return group;
+    }
+    group = calloc(1, sizeof(APP_RSA_GROUP));
+    if (group && app_thread_state_set(APP_STATE_RSA, group, app_rsa_group_free)) {
+        free(group);
+        group = NULL;
+    }
+    return group;
+}
 
 void app_rsa_cleanup(void) {
-    if (group_pkey) EVP_PKEY_free(group_pkey);
-    group_pkey = NULL;
-    if (group_n) BN_free(group_n);
-    group_n = NULL;
+    app_thread_state_set(APP_STATE_RSA, NULL, NULL);
 }
 
 int app_rsa_keygen_handler(ACVP_TEST_CASE *test_case) {
@@ -91,6 +117,7 @@ int app_rsa_keygen_handler(ACVP_TEST_CASE *test_case) {
         printf("Error setting params for pkey generation in RSA keygen\n");
         goto err;
     }
+    app_set_pkey_gen_cb(pkey_ctx, tc->control);
     EVP_PKEY_keygen(pkey_ctx, &pkey);
     if (!pkey) {
         printf("Error generating pkey in RSA keygen\n");
@@ -148,15 +175,125 @@ err:
     return rv;
 }
 
+/* Builds the public key a SigVer test case is verified against */
+static int app_rsa_sig_import_pkey(const unsigned char *e_buf, int e_len,
+                                   const unsigned char *n_buf, int n_len,
+                                   EVP_PKEY **pkey) {
+    int rv = 1;
+    BIGNUM *e = NULL, *n = NULL;
+    EVP_PKEY_CTX *pkey_ctx = NULL;
+    OSSL_PARAM_BLD *pkey_pbld = NULL;
+    OSSL_PARAM *pkey_params = NULL;
+
+    e = BN_bin2bn(e_buf, e_len, NULL);
+    n = BN_bin2bn(n_buf, n_len, NULL);
+    if (!e || !n) {
+        printf("\nBN alloc failure (e, n)\n");
+        goto err;
+    }
+
+    pkey_pbld = OSSL_PARAM_BLD_new();
+    if (!pkey_pbld) {
+        printf("Error creating param_bld in RSA sigver\n");
+        goto err;
+    }
+    OSSL_PARAM_BLD_push_BN(pkey_pbld, OSSL_PKEY_PARAM_RSA_N, n);
+    OSSL_PARAM_BLD_push_BN(pkey_pbld, OSSL_PKEY_PARAM_RSA_E, e);
+    pkey_params = OSSL_PARAM_BLD_to_param(pkey_pbld);
+    if (!pkey_params) {
+        printf("Error building pkey params in RSA sigver\n");
+        goto err;
+    }
+
+    pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
+    if (!pkey_ctx) {
+        printf("Error initializing pkey ctx for RSA sigver\n");
+        goto err;
+    }
+    if (EVP_PKEY_fromdata_init(pkey_ctx) != 1) {
+        printf("Error initializing pkey in RSA ctx\n");
+        goto err;
+    }
+    if (EVP_PKEY_fromdata(pkey_ctx, pkey, EVP_PKEY_KEYPAIR, pkey_params) != 1) {
+        printf("Error generating pkey in RSA context\n");
+        goto err;
+    }
+    rv = 0;
+err:
+    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
+    if (pkey_pbld) OSSL_PARAM_BLD_free(pkey_pbld);
+    if (pkey_params) OSSL_PARAM_free(pkey_params);
+    if (e) BN_free(e);
+    if (n) BN_free(n);
+    return rv;
+}
+
+/* Generates the key a SigGen test group signs with */
+static int app_rsa_sig_keygen(unsigned int modulo, EVP_PKEY **pkey) {
+    int rv = 1;
+    EVP_PKEY_CTX *pkey_ctx = NULL;
+
+    pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
+    if (!pkey_ctx) {
+        printf("Error initializing pkey ctx for RSA siggen\n");
+        goto err;
+    }
+    if (EVP_PKEY_keygen_init(pkey_ctx) != 1) {
+        printf("Error initializing pkey in RSA ctx\n");
+        goto err;
+    }
+    EVP_PKEY_CTX_set_rsa_keygen_bits(pkey_ctx, modulo);
+
+    if (EVP_PKEY_keygen(pkey_ctx, pkey) != 1) {
+        printf("Error generating pkey in RSA context\n");
+        goto err;
+    }
+    rv = 0;
+err:
+    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
+    return rv;
+}
+
+/*
+ * Keeps the key of a test group in tg_ctx: the generated key for SigGen,
+ * the given public key for SigVer
+ */
+int app_rsa_sig_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_RSA_SIG_TC *tc = NULL;
+    EVP_PKEY *pkey = NULL;
+
+    if (!test_case) {
+        return 1;
+    }
+    tc = test_case->tc.rsa_sig;
+
+    if (event == ACVP_TG_END) {
+        if (tc->tg_ctx) EVP_PKEY_free(tc->tg_ctx);
+        tc->tg_ctx = NULL;
+        return 0;
+    }
+
+    if (tc->sig_mode == ACVP_RSA_SIGVER) {
+        if (app_rsa_sig_import_pkey(tc->e, tc->e_len, tc->n, tc->n_len, &pkey)) {
+            return 1;
+        }
+    } else {
+        if (app_rsa_sig_keygen(tc->modulo, &pkey)) {
+            return 1;
+        }
+    }
+    tc->tg_ctx = pkey;
+    return 0;
+}
+
 int app_rsa_sig_handler(ACVP_TEST_CASE *test_case) {
     EVP_MD_CTX *md_ctx = NULL;
-    EVP_PKEY *pkey = NULL;
-    EVP_PKEY_CTX *pkey_ctx = NULL;
-    OSSL_PARAM_BLD *pkey_pbld = NULL, *sig_pbld = NULL;
-    OSSL_PARAM *pkey_params = NULL, *sig_params = NULL;
+    EVP_PKEY *pkey = NULL, *sign_key = NULL;
+    OSSL_PARAM_BLD *sig_pbld = NULL;
+    OSSL_PARAM *sig_params = NULL;
     const char *padding = NULL, *md = NULL;
     int salt_len = -1;
-    BIGNUM *bn_e = NULL, *e = NULL, *n = NULL;
+    BIGNUM *e = NULL, *n = NULL;
     ACVP_RSA_SIG_TC *tc;
 
     int rv = 1;
@@ -173,12 +310,6 @@ int app_rsa_sig_handler(ACVP_TEST_CASE *test_case) {
         goto err;
     }
 
-    bn_e = BN_new();
-    if (!bn_e || !BN_set_word(bn_e, 0x10001)) {
-        printf("\nError: Issue with exponent in RSA Sig\n");
-        goto err;
-    }
-
     if (!tc->modulo) {
         printf("\nError: Issue with modulo in RSA Sig\n");
         goto err;
@@ -213,45 +344,14 @@ int app_rsa_sig_handler(ACVP_TEST_CASE *test_case) {
      * Else, generate a new key, retrieve and save values
      */
     if (tc->sig_mode == ACVP_RSA_SIGVER) {
-        e = BN_new();
-        if (!e) {
-            printf("\nBN alloc failure (e)\n");
-            goto err;
-        }
-        BN_bin2bn(tc->e, tc->e_len, e);
-
-        n = BN_new();
-        if (!n) {
-            printf("\nBN alloc failure (n)\n");
-            goto err;
-        }
-        BN_bin2bn(tc->n, tc->n_len, n);
-
-        pkey_pbld = OSSL_PARAM_BLD_new();
-        if (!pkey_pbld) {
-            printf("Error creating param_bld in RSA sigver\n");
-            goto err;
-        }
-        OSSL_PARAM_BLD_push_BN(pkey_pbld, OSSL_PKEY_PARAM_RSA_N, n);
-        OSSL_PARAM_BLD_push_BN(pkey_pbld, OSSL_PKEY_PARAM_RSA_E, e);
-        pkey_params = OSSL_PARAM_BLD_to_param(pkey_pbld);
-        if (!pkey_params) {
-            printf("Error building pkey params in RSA sigver\n");
-            goto err;
-        }
-
-        pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
-        if (!pkey_ctx) {
-            printf("Error initializing pkey ctx for RSA sigver\n");
-            goto err;
-        }
-        if (EVP_PKEY_fromdata_init(pkey_ctx) != 1) {
-            printf("Error initializing pkey in RSA ctx\n");
-            goto err;
-        }
-        if (EVP_PKEY_fromdata(pkey_ctx, &pkey, EVP_PKEY_KEYPAIR, pkey_params) != 1) {
-            printf("Error generating pkey in RSA context\n");
-            goto err;
+        if (tc->tg_ctx) {
+            /* The group handler imported the public key of the group */
+            sign_key = tc->tg_ctx;
+        } else {
+            if (app_rsa_sig_import_pkey(tc->e, tc->e_len, tc->n, tc->n_len, &pkey)) {
+                goto err;
+            }
+            sign_key = pkey;
         }
 
         //now we have the pkey, setup the digest ctx
@@ -273,46 +373,38 @@ int app_rsa_sig_handler(ACVP_TEST_CASE *test_case) {
             printf("Error creating MD CTX in RSA sigver\n");
             goto err;
         }
-        EVP_DigestVerifyInit_ex(md_ctx, NULL, md, NULL, NULL, pkey, sig_params);
+        EVP_DigestVerifyInit_ex(md_ctx, NULL, md, NULL, NULL, sign_key, sig_params);
         if (EVP_DigestVerify(md_ctx, tc->signature, tc->sig_len, tc->msg, tc->msg_len) == 1) {
             tc->ver_disposition = 1;
         }
     } else {
-        if (rsa_current_tg != tc->tg_id) {
-            rsa_current_tg = tc->tg_id;
-
-            if (group_pkey) EVP_PKEY_free(group_pkey);
-            group_pkey = NULL;
-            if (group_n) BN_free(group_n);
-            group_n = NULL;
+        if (tc->tg_ctx) {
+            /* The group handler generated the key of the group */
+            sign_key = tc->tg_ctx;
+        } else {
+            APP_RSA_GROUP *group = app_rsa_group();
 
-            pkey_ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
-            if (!pkey_ctx) {
-                printf("Error initializing pkey ctx for RSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_keygen_init(pkey_ctx) != 1) {
-                printf("Error initializing pkey in RSA ctx\n");
+            if (!group) {
+                printf("Error allocating RSA group state\n");
                 goto err;
             }
-            EVP_PKEY_CTX_set_rsa_keygen_bits(pkey_ctx, tc->modulo);
-
-            if (EVP_PKEY_keygen(pkey_ctx, &group_pkey) != 1) {
-                printf("Error generating pkey in RSA context\n");
-                goto err;
+            if (!group->pkey || group->tg_id != tc->tg_id) {
+                group->tg_id = tc->tg_id;
+                if (group->pkey) EVP_PKEY_free(group->pkey);
+                group->pkey = NULL;
+                if (app_rsa_sig_keygen(tc->modulo, &group->pkey)) {
+                    goto err;
+                }
             }
-            if (EVP_PKEY_get_bn_param(group_pkey, "e", &e) != 1) {
-                printf("Error retrieving e from generated pkey in RSA siggen\n");
-                goto err;
-            }
-            if (EVP_PKEY_get_bn_param(group_pkey, "n", &n) != 1) {
-                printf("Error retrieving n from generated pkey in RSA siggen\n");
-                goto err;
-            }
-            group_n = BN_dup(n);
-        } else {
-            e = BN_dup(bn_e);
-            n = BN_dup(group_n);
+            sign_key = group->pkey;
+        }
+        if (EVP_PKEY_get_bn_param(sign_key, "e", &e) != 1) {
+            printf("Error retrieving e from generated pkey in RSA siggen\n");
+            goto err;
+        }
+        if (EVP_PKEY_get_bn_param(sign_key, "n", &n) != 1) {
+            printf("Error retrieving n from generated pkey in RSA siggen\n");
+            goto err;
         }
         tc->e_len = BN_bn2bin(e, tc->e);
         tc->n_len = BN_bn2bin(n, tc->n);
@@ -338,7 +430,7 @@ int app_rsa_sig_handler(ACVP_TEST_CASE *test_case) {
             printf("Error creating MD CTX in RSA sigver\n");
             goto err;
         }
-        if (EVP_DigestSignInit_ex(md_ctx, NULL, md, NULL, NULL, group_pkey, sig_params) != 1) {
+        if (EVP_DigestSignInit_ex(md_ctx, NULL, md, NULL, NULL, sign_key, sig_params) != 1) {
             printf("Error initializing sign ctx in RSA siggen\n");
             goto err;
         }
@@ -353,13 +445,9 @@ int app_rsa_sig_handler(ACVP_TEST_CASE *test_case) {
 
 err:
     if (md_ctx) EVP_MD_CTX_free(md_ctx);
-    if (pkey_ctx) EVP_PKEY_CTX_free(pkey_ctx);
     if (pkey) EVP_PKEY_free(pkey);
-    if (pkey_pbld) OSSL_PARAM_BLD_free(pkey_pbld);
     if (sig_pbld) OSSL_PARAM_BLD_free(sig_pbld);
-    if (pkey_params) OSSL_PARAM_free(pkey_params);
     if (sig_params) OSSL_PARAM_free(sig_params);
-    if (bn_e) BN_free(bn_e);
     if (e) BN_free(e);
     if (n) BN_free(n);
 
@@ -645,6 +733,14 @@ err:
 
 #else
 
+int app_rsa_sig_group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (!test_case) {
+        return 1;
+    }
+    (void)event;
+    return 0;
+}
+
 int app_rsa_keygen_handler(ACVP_TEST_CASE *test_case) {
     if (!test_case) {
         return -1;
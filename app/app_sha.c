@@ -14,6 +14,48 @@
 
 int app_sha_ldt_handler(ACVP_HASH_TC *tc, const EVP_MD *md);
 
+/*
+ * Resolves the digest for a hash cipher, noting whether it is a SHA3 or
+ * SHAKE one. Returns NULL if it is not supported.
+ */
+static const EVP_MD *app_sha_get_md(ACVP_SUB_HASH alg, int *sha3, int *shake) {
+    *sha3 = alg == ACVP_SUB_HASH_SHA3_224 || alg == ACVP_SUB_HASH_SHA3_256 ||
+            alg == ACVP_SUB_HASH_SHA3_384 || alg == ACVP_SUB_HASH_SHA3_512;
+    *shake = alg == ACVP_SUB_HASH_SHAKE_128 || alg == ACVP_SUB_HASH_SHAKE_256;
+
+    switch (alg) {
+    case ACVP_SUB_HASH_SHA1:
+        return EVP_sha1();
+    case ACVP_SUB_HASH_SHA2_224:
+        return EVP_sha224();
+    case ACVP_SUB_HASH_SHA2_256:
+        return EVP_sha256();
+    case ACVP_SUB_HASH_SHA2_384:
+        return EVP_sha384();
+    case ACVP_SUB_HASH_SHA2_512:
+        return EVP_sha512();
+    case ACVP_SUB_HASH_SHA2_512_224:
+        return EVP_sha512_224();
+    case ACVP_SUB_HASH_SHA2_512_256:
+        return EVP_sha512_256();
+    case ACVP_SUB_HASH_SHA3_224:
+        return EVP_sha3_224();
+    case ACVP_SUB_HASH_SHA3_256:
+        return EVP_sha3_256();
+    case ACVP_SUB_HASH_SHA3_384:
+        return EVP_sha3_384();
+    case ACVP_SUB_HASH_SHA3_512:
+        return EVP_sha3_512();
+    case ACVP_SUB_HASH_SHAKE_128:
+        return EVP_shake128();
+    case ACVP_SUB_HASH_SHAKE_256:
+        return EVP_shake256();
+    default:
+        break;
+    }
+    return NULL;
+}
+
 int app_sha_handler(ACVP_TEST_CASE *test_case) {
     ACVP_HASH_TC    *tc;
     const EVP_MD    *md;
@@ -36,53 +78,8 @@ int app_sha_handler(ACVP_TEST_CASE *test_case) {
         return 1;
     }
 
-    switch (alg) {
-    case ACVP_SUB_HASH_SHA1:
-        md = EVP_sha1();
-        break;
-    case ACVP_SUB_HASH_SHA2_224:
-        md = EVP_sha224();
-        break;
-    case ACVP_SUB_HASH_SHA2_256:
-        md = EVP_sha256();
-        break;
-    case ACVP_SUB_HASH_SHA2_384:
-        md = EVP_sha384();
-        break;
-    case ACVP_SUB_HASH_SHA2_512:
-        md = EVP_sha512();
-        break;
-    case ACVP_SUB_HASH_SHA2_512_224:
-        md = EVP_sha512_224();
-        break;
-    case ACVP_SUB_HASH_SHA2_512_256:
-        md = EVP_sha512_256();
-        break;
-    case ACVP_SUB_HASH_SHA3_224:
-        md = EVP_sha3_224();
-        sha3 = 1;
-        break;
-    case ACVP_SUB_HASH_SHA3_256:
-        md = EVP_sha3_256();
-        sha3 = 1;
-        break;
-    case ACVP_SUB_HASH_SHA3_384:
-        md = EVP_sha3_384();
-        sha3 = 1;
-        break;
-    case ACVP_SUB_HASH_SHA3_512:
-        md = EVP_sha3_512();
-        sha3 = 1;
-        break;
-    case ACVP_SUB_HASH_SHAKE_128:
-        md = EVP_shake128();
-        shake = 1;
-        break;
-    case ACVP_SUB_HASH_SHAKE_256:
-        md = EVP_shake256();
-        shake = 1;
-        break;
-    default:
+    md = app_sha_get_md(alg, &sha3, &shake);
+    if (!md) {
         printf("Error: Unsupported hash algorithm requested by ACVP server\n");
         return ACVP_NO_CAP;
     }
@@ -158,32 +155,183 @@ end:
     return rc;
 }
 
-/**
- * 1) malloc buffer, concat full message, process with a single call;
- * 2) oneshot function or a single call to update; never multiple calls to update
- * 3) allowed for all SHA, not SHAKE
+/*
+ * One inner loop of a hash Monte Carlo test, from the seed in tc->msg to
+ * the checkpoint left in tc->md, using md and md_ctx throughout
  */
-int app_sha_ldt_handler(ACVP_HASH_TC *tc, const EVP_MD *md) {
-    unsigned char *large_data = NULL, *iter = NULL;
-    int numcopies = 0, i = 0, rv = 1;
+static int app_sha_mct_inner(ACVP_HASH_TC *tc, const EVP_MD *md, EVP_MD_CTX *md_ctx, int sha3, int shake) {
+    unsigned char m[3][EVP_MAX_MD_SIZE];
+    unsigned char shake_msg[16];
+    unsigned int out_len = 0, range = 0, len = 0, i = 0;
+
+    if (shake) {
+        if (tc->xof_max_len < tc->xof_min_len || !tc->xof_len) {
+            return 1;
+        }
+        range = tc->xof_max_len - tc->xof_min_len + 1;
+        out_len = tc->xof_len;
+        memzero_s(shake_msg, sizeof(shake_msg));
+        memcpy_s(shake_msg, sizeof(shake_msg), tc->msg,
+                 tc->msg_len < sizeof(shake_msg) ? tc->msg_len : sizeof(shake_msg));
+        for (i = 0; i < ACVP_HASH_MCT_INNER; i++) {
+            if (!EVP_DigestInit_ex(md_ctx, md, NULL) ||
+                !EVP_DigestUpdate(md_ctx, shake_msg, sizeof(shake_msg)) ||
+                !EVP_DigestFinalXOF(md_ctx, tc->md, out_len)) {
+                printf("\nCrypto module error, SHAKE digest failed\n");
+                return 1;
+            }
+            tc->md_len = out_len;
+
+            /* Leftmost 128 bits feed the next digest, rightmost 16 its length */
+            memzero_s(shake_msg, sizeof(shake_msg));
+            memcpy_s(shake_msg, sizeof(shake_msg), tc->md,
+                     out_len < sizeof(shake_msg) ? out_len : sizeof(shake_msg));
+            out_len = tc->xof_min_len +
+                      (((unsigned int)tc->md[out_len - 2] << 8 | tc->md[out_len - 1]) % range);
+        }
+        tc->xof_len = out_len;
+    } else if (sha3) {
+        if (!EVP_DigestInit_ex(md_ctx, md, NULL) ||
+            !EVP_DigestUpdate(md_ctx, tc->msg, tc->msg_len) ||
+            !EVP_DigestFinal_ex(md_ctx, tc->md, &tc->md_len)) {
+            printf("\nCrypto module error, SHA3 digest failed\n");
+            return 1;
+        }
+        for (i = 1; i < ACVP_HASH_MCT_INNER; i++) {
+            if (!EVP_DigestInit_ex(md_ctx, md, NULL) ||
+                !EVP_DigestUpdate(md_ctx, tc->md, tc->md_len) ||
+                !EVP_DigestFinal_ex(md_ctx, tc->md, &tc->md_len)) {
+                printf("\nCrypto module error, SHA3 digest failed\n");
+                return 1;
+            }
+        }
+    } else {
+        if (tc->msg_len > EVP_MAX_MD_SIZE) {
+            return 1;
+        }
+        memcpy_s(m[0], EVP_MAX_MD_SIZE, tc->msg, tc->msg_len);
+        memcpy_s(m[1], EVP_MAX_MD_SIZE, tc->msg, tc->msg_len);
+        memcpy_s(m[2], EVP_MAX_MD_SIZE, tc->msg, tc->msg_len);
+        len = tc->msg_len;
+        for (i = 0; i < ACVP_HASH_MCT_INNER; i++) {
+            if (!EVP_DigestInit_ex(md_ctx, md, NULL) ||
+                !EVP_DigestUpdate(md_ctx, m[0], len) ||
+                !EVP_DigestUpdate(md_ctx, m[1], len) ||
+                !EVP_DigestUpdate(md_ctx, m[2], len) ||
+                !EVP_DigestFinal_ex(md_ctx, tc->md, &tc->md_len)) {
+                printf("\nCrypto module error, SHA digest failed\n");
+                return 1;
+            }
+            memcpy_s(m[0], EVP_MAX_MD_SIZE, m[1], tc->md_len);
+            memcpy_s(m[1], EVP_MAX_MD_SIZE, m[2], tc->md_len);
+            memcpy_s(m[2], EVP_MAX_MD_SIZE, tc->md, tc->md_len);
+            len = tc->md_len;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Runs a whole inner loop of a hash Monte Carlo test, resolving the digest
+ * and setting up its context once instead of once per digest as
+ * app_sha_handler() would
+ */
+int app_sha_mct_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_HASH_TC *tc = NULL;
+    const EVP_MD *md = NULL;
     EVP_MD_CTX *md_ctx = NULL;
+    int sha3 = 0, shake = 0, rc = 1;
 
-    printf("Performing hash large data test (This may take time...)\n");
+    if (!test_case) {
+        return 1;
+    }
+    tc = test_case->tc.hash;
+    if (!tc || !tc->msg || !tc->md || tc->test_type != ACVP_HASH_TEST_TYPE_MCT) {
+        return 1;
+    }
+
+    md = app_sha_get_md(acvp_get_hash_alg(tc->cipher), &sha3, &shake);
+    if (!md) {
+        printf("Error: Unsupported hash algorithm requested by ACVP server\n");
+        return 1;
+    }
+    md_ctx = EVP_MD_CTX_create();
+    if (!md_ctx) {
+        return 1;
+    }
+
+    rc = app_sha_mct_inner(tc, md, md_ctx, sha3, shake);
+    EVP_MD_CTX_destroy(md_ctx);
+    return rc;
+}
+
+/*
+ * Runs every checkpoint of a hash Monte Carlo test from the one seed, so
+ * the digest context stays with the module for the whole test
+ */
+int app_sha_mct_loop_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_HASH_TC *tc = NULL;
+    const EVP_MD *md = NULL;
+    EVP_MD_CTX *md_ctx = NULL;
+    int sha3 = 0, shake = 0, rc = 1, i = 0;
+
+    if (!test_case) {
+        return 1;
+    }
+    tc = test_case->tc.hash;
+    if (!tc || !tc->msg || !tc->md || !tc->mct_md || !tc->mct_md_len ||
+            tc->test_type != ACVP_HASH_TEST_TYPE_MCT) {
+        return 1;
+    }
 
-    large_data = calloc(tc->exp_len, sizeof(unsigned char));
-    if (!large_data) {
-        printf("Error: Unable to allocate memory for large data test (Needed %llu bytes)\n", tc->exp_len);
+    md = app_sha_get_md(acvp_get_hash_alg(tc->cipher), &sha3, &shake);
+    if (!md) {
+        printf("Error: Unsupported hash algorithm requested by ACVP server\n");
+        return 1;
+    }
+    md_ctx = EVP_MD_CTX_create();
+    if (!md_ctx) {
         return 1;
     }
 
-    /* We have to copy the message into the buffer many times. Assume concatenation as it is the only mode currently */
-    numcopies = tc->exp_len / tc->msg_len;
-    iter = large_data;
-    for (i = 0; i < numcopies; i++) {
-        memcpy_s(iter, tc->exp_len - (i * tc->msg_len), tc->msg, tc->msg_len);
-        iter += tc->msg_len;
+    for (i = 0; i < ACVP_HASH_MCT_OUTER; i++) {
+        if (app_sha_mct_inner(tc, md, md_ctx, sha3, shake) || tc->md_len > tc->mct_md_stride) {
+            goto end;
+        }
+        memcpy_s(tc->mct_md + (size_t)i * tc->mct_md_stride, tc->mct_md_stride, tc->md, tc->md_len);
+        tc->mct_md_len[i] = tc->md_len;
+
+        /* The checkpoint seeds the next one */
+        if (shake) {
+            memzero_s(tc->msg, 16);
+            memcpy_s(tc->msg, 16, tc->md, tc->md_len < 16 ? tc->md_len : 16);
+            tc->msg_len = 16;
+        } else {
+            memcpy_s(tc->msg, tc->md_len, tc->md, tc->md_len);
+            tc->msg_len = tc->md_len;
+        }
     }
 
+    rc = 0;
+end:
+    EVP_MD_CTX_destroy(md_ctx);
+    return rc;
+}
+
+/**
+ * 1) the expanded message is given to the digest in one update where libacvp
+ *    can map it as a single buffer, otherwise a chunk at a time as libacvp
+ *    hands it out, so it never has to be held in memory in full;
+ * 2) allowed for all SHA, not SHAKE
+ */
+int app_sha_ldt_handler(ACVP_HASH_TC *tc, const EVP_MD *md) {
+    const unsigned char *chunk = NULL;
+    unsigned int chunk_len = 0;
+    int rv = 1;
+    EVP_MD_CTX *md_ctx = NULL;
+
+    printf("Performing hash large data test (This may take time...)\n");
+
     md_ctx = EVP_MD_CTX_create();
 
     if (!EVP_DigestInit_ex(md_ctx, md, NULL)) {
@@ -191,11 +339,21 @@ int app_sha_ldt_handler(ACVP_HASH_TC *tc, const EVP_MD *md) {
         goto end;
     }
 
-    /* Update MUST only be called once */
-    if (!EVP_DigestUpdate(md_ctx, large_data, tc->exp_len)) {
-        printf("\nCrypto module error, EVP_DigestUpdate failed\n");
-        goto end;
-    }
+    if (acvp_hash_ldt_map(tc, &chunk) == ACVP_SUCCESS) {
+        if (!EVP_DigestUpdate(md_ctx, chunk, (size_t)tc->exp_len)) {
+            printf("\nCrypto module error, EVP_DigestUpdate failed\n");
+            goto end;
+        }
+    } else do {
+        if (acvp_hash_ldt_next_chunk(tc, &chunk, &chunk_len) != ACVP_SUCCESS) {
+            printf("Error: Unable to get the large data test content\n");
+            goto end;
+        }
+        if (chunk_len && !EVP_DigestUpdate(md_ctx, chunk, chunk_len)) {
+            printf("\nCrypto module error, EVP_DigestUpdate failed\n");
+            goto end;
+        }
+    } while (chunk_len);
     if (!EVP_DigestFinal(md_ctx, tc->md, &tc->md_len)) {
         printf("\nCrypto module error, EVP_DigestFinal failed\n");
         goto end;
@@ -203,7 +361,6 @@ int app_sha_ldt_handler(ACVP_HASH_TC *tc, const EVP_MD *md) {
 
     rv = 0;
 end:
-    if (large_data) free(large_data);
     if (md_ctx) EVP_MD_CTX_destroy(md_ctx);
     return rv;
 }
@@ -13,6 +13,9 @@
 #include <openssl/safestack.h>
 #include <openssl/core_names.h>
 #include <openssl/provider.h>
+#include <openssl/crypto.h>
+#include <openssl/kdf.h>
+#include <openssl/param_build.h>
 #include "app_lcl.h"
 #include "safe_lib.h"
 
@@ -497,6 +500,160 @@ char *ec_point_to_pub_key(unsigned char *x, int x_len, unsigned char *y, int y_l
     return key;
 }
 
+/*
+ * Shifts the output of one Monte Carlo inner iteration into the end of the
+ * ACVP_SYM_MCT_TAIL_LEN byte tail of the output stream an MCT handler hands
+ * back. nbits is how much output each iteration makes; for 1 (CFB1) the bit
+ * is the top bit of out.
+ */
+void app_mct_shift_in(unsigned char *tail, const unsigned char *out, int nbits) {
+    int n = 0;
+
+    if (nbits == 1) {
+        for (n = 0; n < ACVP_SYM_MCT_TAIL_LEN - 1; n++) {
+            tail[n] = (unsigned char)(tail[n] << 1 | tail[n + 1] >> 7);
+        }
+        tail[n] = (unsigned char)(tail[n] << 1 | out[0] >> 7);
+        return;
+    }
+    memmove_s(tail, ACVP_SYM_MCT_TAIL_LEN, tail + nbits / 8, ACVP_SYM_MCT_TAIL_LEN - nbits / 8);
+    memcpy_s(tail + ACVP_SYM_MCT_TAIL_LEN - nbits / 8, nbits / 8, out, nbits / 8);
+}
+
+static int app_pkey_gen_cb(EVP_PKEY_CTX *ctx) {
+    /* OpenSSL stops generating when the callback returns 0 */
+    return !acvp_tc_progress(EVP_PKEY_CTX_get_app_data(ctx));
+}
+
+/*
+ * Has key or parameter generation on ctx report its progress to libacvp, so
+ * that a test case stuck finding primes can be given up on (see
+ * acvp_set_tc_deadline()). Nothing is done when the test case has no control.
+ */
+void app_set_pkey_gen_cb(EVP_PKEY_CTX *ctx, ACVP_TC_CONTROL *control) {
+    if (!ctx || !control) {
+        return;
+    }
+    EVP_PKEY_CTX_set_app_data(ctx, control);
+    EVP_PKEY_CTX_set_cb(ctx, app_pkey_gen_cb);
+}
+
+/*
+ * Per-thread handler state
+ *
+ * What a handler keeps from one call to the next, such as the cipher
+ * context of a Monte Carlo test or the key of a test group that has no
+ * group handler, is kept per thread. libacvp runs each MCT, and each test
+ * group of those capabilities, on a single thread, while other vector sets
+ * and the test cases of parallel groups may be run on other threads at the
+ * same time. What a thread keeps is released when the thread exits, and
+ * that of the main thread by app_thread_state_cleanup().
+ */
+typedef struct app_thread_state_t {
+    void *state[APP_STATE_MAX];
+    void (*free_fn[APP_STATE_MAX])(void *state);
+} APP_THREAD_STATE;
+
+static CRYPTO_THREAD_LOCAL thread_state_key;
+static CRYPTO_ONCE thread_state_once = CRYPTO_ONCE_STATIC_INIT;
+static int thread_state_ready = 0;
+
+static void app_thread_state_free(void *arg) {
+    APP_THREAD_STATE *ts = arg;
+    int i = 0;
+
+    if (!ts) {
+        return;
+    }
+    for (i = 0; i < APP_STATE_MAX; i++) {
+        if (ts->state[i] && ts->free_fn[i]) ts->free_fn[i](ts->state[i]);
+    }
+    free(ts);
+}
+
+static void app_thread_state_init(void) {
+    thread_state_ready = CRYPTO_THREAD_init_local(&thread_state_key, app_thread_state_free);
+}
+
+static APP_THREAD_STATE *app_thread_state(int create) {
+    APP_THREAD_STATE *ts = NULL;
+
+    if (!CRYPTO_THREAD_run_once(&thread_state_once, app_thread_state_init) || !thread_state_ready) {
+        return NULL;
+    }
+    ts = CRYPTO_THREAD_get_local(&thread_state_key);
+    if (!ts && create) {
+        ts = calloc(1, sizeof(APP_THREAD_STATE));
+        if (ts && !CRYPTO_THREAD_set_local(&thread_state_key, ts)) {
+            free(ts);
+            ts = NULL;
+        }
+    }
+    return ts;
+}
+
+/* What the calling thread keeps in the slot, or NULL */
+void *app_thread_state_get(APP_STATE_SLOT slot) {
+    APP_THREAD_STATE *ts = app_thread_state(0);
+
+    if (!ts || slot < 0 || slot >= APP_STATE_MAX) {
+        return NULL;
+    }
+    return ts->state[slot];
+}
+
+/*
+ * Has the calling thread keep state in the slot, releasing what it kept
+ * there before with its free_fn. Returns 0 on success; on failure the
+ * caller still owns state.
+ */
+int app_thread_state_set(APP_STATE_SLOT slot, void *state, void (*free_fn)(void *state)) {
+    APP_THREAD_STATE *ts = NULL;
+
+    if (slot < 0 || slot >= APP_STATE_MAX) {
+        return 1;
+    }
+    ts = app_thread_state(state != NULL);
+    if (!ts) {
+        return state ? 1 : 0;
+    }
+    if (ts->state[slot] && ts->state[slot] != state && ts->free_fn[slot]) {
+        ts->free_fn[slot](ts->state[slot]);
+    }
+    ts->state[slot] = state;
+    ts->free_fn[slot] = free_fn;
+    return 0;
+}
+
+/* Releases everything the calling thread keeps */
+void app_thread_state_cleanup(void) {
+    APP_THREAD_STATE *ts = app_thread_state(0);
+
+    if (ts) {
+        CRYPTO_THREAD_set_local(&thread_state_key, NULL);
+        app_thread_state_free(ts);
+    }
+}
+
+static void app_cipher_ctx_free(void *cipher_ctx) {
+    EVP_CIPHER_CTX_free(cipher_ctx);
+}
+
+/* The cipher context the calling thread keeps in the slot, made on first use */
+EVP_CIPHER_CTX *app_thread_cipher_ctx(APP_STATE_SLOT slot) {
+    EVP_CIPHER_CTX *cipher_ctx = app_thread_state_get(slot);
+
+    if (cipher_ctx) {
+        return cipher_ctx;
+    }
+    cipher_ctx = EVP_CIPHER_CTX_new();
+    if (cipher_ctx && app_thread_state_set(slot, cipher_ctx, app_cipher_ctx_free)) {
+        EVP_CIPHER_CTX_free(cipher_ctx);
+        cipher_ctx = NULL;
+    }
+    return cipher_ctx;
+}
+
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
 
 static const unsigned char sanity_msg[] = { 0xA5, 0x30, 0xD4, 0x60, 0x93, 0xA3, 0x5E, 0x50, 0x2C, 0xA1, 0x64, 0xB7,
@@ -582,6 +739,322 @@ const char *get_ed_curve_string(ACVP_ED_CURVE curve) {
     }
 }
 
+/*
+ * Fetched algorithm cache
+ *
+ * Fetching an algorithm from the providers is a lookup made under a lock,
+ * so the handlers get what they fetch from here instead of doing one for
+ * every test case. Each fetch is looked up by type, name and properties and
+ * kept until app_fetch_cleanup(); callers get a reference of their own and
+ * free it the same as one from EVP_*_fetch(). The handlers may be run from
+ * several threads at once, so the cache is guarded by a lock.
+ */
+#define APP_FETCH_CACHE_MAX 64
+#define APP_FETCH_NAME_MAX 64
+
+typedef enum app_fetch_type {
+    APP_FETCH_CIPHER = 1,
+    APP_FETCH_MAC,
+    APP_FETCH_KDF,
+    APP_FETCH_RAND
+} APP_FETCH_TYPE;
+
+typedef struct app_fetched_t {
+    APP_FETCH_TYPE type;
+    char name[APP_FETCH_NAME_MAX + 1];
+    char props[APP_FETCH_NAME_MAX + 1];
+    void *alg;
+} APP_FETCHED;
+
+static APP_FETCHED fetched[APP_FETCH_CACHE_MAX];
+static int fetched_cnt = 0;
+static CRYPTO_RWLOCK *fetch_lock = NULL;
+static CRYPTO_ONCE fetch_once = CRYPTO_ONCE_STATIC_INIT;
+
+static void app_fetch_init(void) {
+    fetch_lock = CRYPTO_THREAD_lock_new();
+}
+
+static void *app_fetch_new(APP_FETCH_TYPE type, const char *name, const char *props) {
+    switch (type) {
+    case APP_FETCH_CIPHER:
+        return EVP_CIPHER_fetch(NULL, name, props);
+    case APP_FETCH_MAC:
+        return EVP_MAC_fetch(NULL, name, props);
+    case APP_FETCH_KDF:
+        return EVP_KDF_fetch(NULL, name, props);
+    case APP_FETCH_RAND:
+        return EVP_RAND_fetch(NULL, name, props);
+    default:
+        return NULL;
+    }
+}
+
+static int app_fetch_up_ref(APP_FETCH_TYPE type, void *alg) {
+    switch (type) {
+    case APP_FETCH_CIPHER:
+        return EVP_CIPHER_up_ref(alg);
+    case APP_FETCH_MAC:
+        return EVP_MAC_up_ref(alg);
+    case APP_FETCH_KDF:
+        return EVP_KDF_up_ref(alg);
+    case APP_FETCH_RAND:
+        return EVP_RAND_up_ref(alg);
+    default:
+        return 0;
+    }
+}
+
+static void app_fetch_free(APP_FETCH_TYPE type, void *alg) {
+    switch (type) {
+    case APP_FETCH_CIPHER:
+        EVP_CIPHER_free(alg);
+        break;
+    case APP_FETCH_MAC:
+        EVP_MAC_free(alg);
+        break;
+    case APP_FETCH_KDF:
+        EVP_KDF_free(alg);
+        break;
+    case APP_FETCH_RAND:
+        EVP_RAND_free(alg);
+        break;
+    default:
+        break;
+    }
+}
+
+/* The cached fetch, or NULL; to be called with fetch_lock held */
+static void *app_fetch_find(APP_FETCH_TYPE type, const char *name, const char *props) {
+    int i = 0, diff = 0;
+
+    for (i = 0; i < fetched_cnt; i++) {
+        if (fetched[i].type != type) {
+            continue;
+        }
+        strcmp_s(fetched[i].name, APP_FETCH_NAME_MAX + 1, name, &diff);
+        if (diff) {
+            continue;
+        }
+        strcmp_s(fetched[i].props, APP_FETCH_NAME_MAX + 1, props, &diff);
+        if (!diff) {
+            return fetched[i].alg;
+        }
+    }
+    return NULL;
+}
+
+static void *app_fetch(APP_FETCH_TYPE type, const char *name, const char *props) {
+    void *alg = NULL, *found = NULL;
+
+    if (!name) {
+        return NULL;
+    }
+    if (!props) {
+        props = "";
+    }
+    /* Not worth caching, or no lock to guard the cache with */
+    if (strnlen_s(name, APP_FETCH_NAME_MAX + 1) > APP_FETCH_NAME_MAX ||
+            strnlen_s(props, APP_FETCH_NAME_MAX + 1) > APP_FETCH_NAME_MAX ||
+            !CRYPTO_THREAD_run_once(&fetch_once, app_fetch_init) || !fetch_lock) {
+        return app_fetch_new(type, name, *props ? props : NULL);
+    }
+
+    if (CRYPTO_THREAD_read_lock(fetch_lock)) {
+        found = app_fetch_find(type, name, props);
+        if (found && !app_fetch_up_ref(type, found)) {
+            found = NULL;
+        }
+        CRYPTO_THREAD_unlock(fetch_lock);
+    }
+    if (found) {
+        return found;
+    }
+
+    alg = app_fetch_new(type, name, *props ? props : NULL);
+    if (!alg || !CRYPTO_THREAD_write_lock(fetch_lock)) {
+        return alg;
+    }
+    /* Another thread may have got there first; keep the first one cached */
+    if (!app_fetch_find(type, name, props) && fetched_cnt < APP_FETCH_CACHE_MAX &&
+            app_fetch_up_ref(type, alg)) {
+        fetched[fetched_cnt].type = type;
+        strcpy_s(fetched[fetched_cnt].name, APP_FETCH_NAME_MAX + 1, name);
+        strcpy_s(fetched[fetched_cnt].props, APP_FETCH_NAME_MAX + 1, props);
+        fetched[fetched_cnt].alg = alg;
+        fetched_cnt++;
+    }
+    CRYPTO_THREAD_unlock(fetch_lock);
+    return alg;
+}
+
+EVP_CIPHER *app_cipher_fetch(const char *name, const char *props) {
+    return app_fetch(APP_FETCH_CIPHER, name, props);
+}
+
+EVP_MAC *app_mac_fetch(const char *name, const char *props) {
+    return app_fetch(APP_FETCH_MAC, name, props);
+}
+
+EVP_KDF *app_kdf_fetch(const char *name, const char *props) {
+    return app_fetch(APP_FETCH_KDF, name, props);
+}
+
+EVP_RAND *app_rand_fetch(const char *name, const char *props) {
+    return app_fetch(APP_FETCH_RAND, name, props);
+}
+
+/* Releases the cached fetches; no handler may be running */
+void app_fetch_cleanup(void) {
+    int i = 0;
+
+    for (i = 0; i < fetched_cnt; i++) {
+        app_fetch_free(fetched[i].type, fetched[i].alg);
+    }
+    memzero_s(fetched, sizeof(fetched));
+    fetched_cnt = 0;
+    if (fetch_lock) {
+        CRYPTO_THREAD_lock_free(fetch_lock);
+        fetch_lock = NULL;
+    }
+}
+
+/*
+ * Keyed MAC contexts of a test group
+ *
+ * The MAC and its digest or cipher are the same for all the test cases of
+ * a HMAC or CMAC test group, and many of them share a key. A group handler
+ * makes an APP_MAC_GROUP at the start of the group; each thread running
+ * its test cases then keeps one context with those parameters set, and
+ * only keys it again when the key of the test case differs from that of
+ * the last one, see app_mac_group_ctx(). Groups are told apart by a serial
+ * rather than their address, since that of a finished group may be reused.
+ */
+struct app_mac_group_t {
+    EVP_MAC *mac;
+    OSSL_PARAM *params;
+    int serial;
+};
+
+typedef struct app_mac_keyed_t {
+    int serial;
+    unsigned int key_id;
+    EVP_MAC_CTX *ctx;
+} APP_MAC_KEYED;
+
+static int mac_group_serial = 0;
+static CRYPTO_RWLOCK *mac_group_lock = NULL;
+static CRYPTO_ONCE mac_group_once = CRYPTO_ONCE_STATIC_INIT;
+
+static void app_mac_group_init(void) {
+    mac_group_lock = CRYPTO_THREAD_lock_new();
+}
+
+static void app_mac_keyed_free(void *state) {
+    APP_MAC_KEYED *keyed = state;
+
+    if (keyed->ctx) EVP_MAC_CTX_free(keyed->ctx);
+    free(keyed);
+}
+
+/*
+ * A group of the MAC mac_name, with the parameter param_name set to param_value
+ */
+APP_MAC_GROUP *app_mac_group_new(const char *mac_name, const char *param_name, const char *param_value) {
+    APP_MAC_GROUP *group = NULL;
+    OSSL_PARAM_BLD *pbld = NULL;
+
+    if (!CRYPTO_THREAD_run_once(&mac_group_once, app_mac_group_init) || !mac_group_lock) {
+        return NULL;
+    }
+    group = calloc(1, sizeof(APP_MAC_GROUP));
+    if (!group) {
+        return NULL;
+    }
+    group->mac = app_mac_fetch(mac_name, NULL);
+    if (!group->mac || !CRYPTO_atomic_add(&mac_group_serial, 1, &group->serial, mac_group_lock)) {
+        app_mac_group_free(group);
+        return NULL;
+    }
+    pbld = OSSL_PARAM_BLD_new();
+    if (!pbld || !OSSL_PARAM_BLD_push_utf8_string(pbld, param_name, param_value, 0)) {
+        OSSL_PARAM_BLD_free(pbld);
+        app_mac_group_free(group);
+        return NULL;
+    }
+    group->params = OSSL_PARAM_BLD_to_param(pbld);
+    OSSL_PARAM_BLD_free(pbld);
+    if (!group->params) {
+        app_mac_group_free(group);
+        return NULL;
+    }
+    return group;
+}
+
+/*
+ * The context the calling thread keeps for the group, ready for a message
+ * under the key. key_id is that of the test case, see ACVP_HMAC_TC; the
+ * context is only keyed again when it changes. The context stays with the
+ * thread, so the caller must not free it.
+ */
+EVP_MAC_CTX *app_mac_group_ctx(APP_MAC_GROUP *group, unsigned int key_id,
+                               const unsigned char *key, size_t key_len) {
+    APP_MAC_KEYED *keyed = app_thread_state_get(APP_STATE_MAC);
+
+    if (!group) {
+        return NULL;
+    }
+    if (!keyed) {
+        keyed = calloc(1, sizeof(APP_MAC_KEYED));
+        if (!keyed || app_thread_state_set(APP_STATE_MAC, keyed, app_mac_keyed_free)) {
+            free(keyed);
+            return NULL;
+        }
+    }
+
+    if (!keyed->ctx || keyed->serial != group->serial) {
+        if (keyed->ctx) EVP_MAC_CTX_free(keyed->ctx);
+        keyed->serial = group->serial;
+        keyed->key_id = 0;
+        keyed->ctx = EVP_MAC_CTX_new(group->mac);
+        if (!keyed->ctx || !EVP_MAC_CTX_set_params(keyed->ctx, group->params)) {
+            goto err;
+        }
+    } else if (key_id && key_id == keyed->key_id) {
+        /* Same key, only start over */
+        if (!EVP_MAC_init(keyed->ctx, NULL, 0, NULL)) {
+            goto err;
+        }
+        return keyed->ctx;
+    }
+
+    if (!EVP_MAC_init(keyed->ctx, key, key_len, NULL)) {
+        goto err;
+    }
+    keyed->key_id = key_id;
+    return keyed->ctx;
+
+err:
+    if (keyed->ctx) EVP_MAC_CTX_free(keyed->ctx);
+    keyed->ctx = NULL;
+    return NULL;
+}
+
+/* Releases the group, and the context the calling thread keeps for it */
+void app_mac_group_free(APP_MAC_GROUP *group) {
+    APP_MAC_KEYED *keyed = app_thread_state_get(APP_STATE_MAC);
+
+    if (!group) {
+        return;
+    }
+    if (keyed && keyed->serial == group->serial) {
+        app_thread_state_set(APP_STATE_MAC, NULL, NULL);
+    }
+    if (group->mac) EVP_MAC_free(group->mac);
+    if (group->params) OSSL_PARAM_free(group->params);
+    free(group);
+}
+
 /*
  * The following code was taken from OpenSSL and modified to meet libacvp's use case. The Apache
  * License V2 can be found in the root of this project.
@@ -47,6 +47,9 @@ extern "C"
 #define ACVP_AES_MCT_OUTER      100
 #define ACVP_DES_MCT_INNER      10000
 #define ACVP_DES_MCT_OUTER      400
+#define ACVP_SYM_MCT_TAIL_LEN   32
+#define ACVP_TDES_MCT_KEY_LEN   24
+#define ACVP_TDES_MCT_BLOCK_LEN 8
 
 /**
  * @enum ACVP_LOG_LVL
@@ -91,6 +94,12 @@ typedef enum acvp_log_lvl {
  */
 typedef struct acvp_ctx_t ACVP_CTX;
 
+/**
+ * @struct ACVP_ORCH
+ * @brief Runs the test sessions of several ACVP_CTX at once, see acvp_orch_run()
+ */
+typedef struct acvp_orch_t ACVP_ORCH;
+
 /**
  * @enum ACVP_RESULT
  * @brief This enum is used to indicate error conditions to the application
@@ -976,6 +985,20 @@ typedef enum acvp_rsa_prim_keyformat {
     ACVP_RSA_PRIM_KEYFORMAT_CRT
 } ACVP_RSA_PRIM_KEYFORMAT;
 
+/**
+ * @struct ACVP_BN
+ * @brief A big number given to the crypto module as 64 bit limbs, least significant limb first,
+ *        each in the byte order of the host, as most big number libraries keep them. With
+ *        acvp_cap_set_bn_limbs() the RSA, DSA, KAS-FFC, KAS-IFC and Safe Primes test cases have
+ *        their big number inputs decoded from hex straight into these, rather than into big endian
+ *        bytes the module would have to convert again.
+ */
+typedef struct acvp_bn_t {
+    unsigned long long int *limbs; /**< Least significant limb first */
+    int limbs_cnt;                 /**< Limbs in use, at least 1 */
+    int bits;                      /**< Bit length of the value, 0 for zero */
+} ACVP_BN;
+
 /**
  * @struct ACVP_RSA_PRIM_TC
  * @brief This struct holds data that represents a single test case for a RSA primitive cipher.
@@ -1022,6 +1045,19 @@ typedef struct acvp_rsa_prim_tc_t {
     int iqmp_len;
     int pt_len;
     int disposition;
+    /*
+     * With acvp_cap_set_bn_limbs() the inputs are given here instead, and
+     * the byte lengths above are 0
+     */
+    ACVP_BN cipher_bn;
+    ACVP_BN n_bn;
+    ACVP_BN e_bn;
+    ACVP_BN d_bn;
+    ACVP_BN p_bn;
+    ACVP_BN q_bn;
+    ACVP_BN dmp1_bn;
+    ACVP_BN dmq1_bn;
+    ACVP_BN iqmp_bn;
 } ACVP_RSA_PRIM_TC;
 
 
@@ -1145,6 +1181,38 @@ typedef enum acvp_kmac_parameter {
     ACVP_KMAC_HEX_CUSTOM_SUPPORT
 } ACVP_KMAC_PARM;
 
+/**
+ * @enum ACVP_CAP_PARM_KIND
+ * @brief The setter an ACVP_CAP_PARM_ENTRY given to acvp_cap_set_parms() stands for
+ */
+typedef enum acvp_cap_parm_kind {
+    ACVP_CAP_SYM_CIPHER_PARM = 1, /**< acvp_cap_sym_cipher_set_parm() */
+    ACVP_CAP_SYM_CIPHER_DOMAIN,   /**< acvp_cap_sym_cipher_set_domain() */
+    ACVP_CAP_HASH_PARM,           /**< acvp_cap_hash_set_parm() */
+    ACVP_CAP_HASH_DOMAIN,         /**< acvp_cap_hash_set_domain() */
+    ACVP_CAP_HMAC_PARM,           /**< acvp_cap_hmac_set_parm() */
+    ACVP_CAP_HMAC_DOMAIN,         /**< acvp_cap_hmac_set_domain() */
+    ACVP_CAP_CMAC_PARM,           /**< acvp_cap_cmac_set_parm() */
+    ACVP_CAP_CMAC_DOMAIN,         /**< acvp_cap_cmac_set_domain() */
+    ACVP_CAP_KMAC_PARM,           /**< acvp_cap_kmac_set_parm() */
+    ACVP_CAP_KMAC_DOMAIN          /**< acvp_cap_kmac_set_domain() */
+} ACVP_CAP_PARM_KIND;
+
+/**
+ * @struct ACVP_CAP_PARM_ENTRY
+ * @brief One parameter of a capability in a table given to acvp_cap_set_parms(). param holds
+ *        the parameter enum of the setter named by kind; value is the value of a parm, or the
+ *        minimum of a domain, in which case max and increment are used as well.
+ */
+typedef struct acvp_cap_parm_entry_t {
+    ACVP_CAP_PARM_KIND kind;
+    ACVP_CIPHER cipher;
+    int param;
+    int value;
+    int max;
+    int increment;
+} ACVP_CAP_PARM_ENTRY;
+
 /** @enum ACVP_CMAC_KEY_ATTR */
 typedef enum acvp_cmac_keylen {
     ACVP_CMAC_KEYING_OPTION_1 = 1,
@@ -1212,6 +1280,15 @@ typedef struct acvp_sym_cipher_tc_t {
     unsigned char *tag;          /**< Aead tag */
     unsigned char *iv_ret;       /**< updated IV used for TDES MCT */
     unsigned char *iv_ret_after; /**< updated IV used for TDES MCT */
+    unsigned char *mct_tail;     /**< End of the output stream of an MCT inner loop, only
+                                  * given to an MCT handler. See
+                                  * acvp_cap_sym_cipher_set_mct_handler() */
+    unsigned char *mct_key;      /**< Key of each checkpoint of a TDES MCT, ACVP_TDES_MCT_KEY_LEN
+                                  * bytes apart. Only given to an MCT loop handler, see
+                                  * acvp_cap_sym_cipher_set_mct_loop_handler() */
+    unsigned char *mct_iv;       /**< IV of each checkpoint, ACVP_TDES_MCT_BLOCK_LEN bytes apart */
+    unsigned char *mct_pt;       /**< pt of each checkpoint, ACVP_TDES_MCT_BLOCK_LEN bytes apart */
+    unsigned char *mct_ct;       /**< ct of each checkpoint, ACVP_TDES_MCT_BLOCK_LEN bytes apart */
     unsigned char *salt;         /**< For use with AES-XPN */
     ACVP_SYM_KW_MODE kwcipher;
     ACVP_SYM_CIPH_TWEAK_MODE tw_mode;
@@ -1232,9 +1309,71 @@ typedef struct acvp_sym_cipher_tc_t {
                                  * for decrypt only. 0 indicates is not applicable */
     unsigned int data_unit_len; /**< for AES-XTS rev 2.0, the amount of data that can be
                                  * processed at once may be lower than the total payload
-                                 * size. By default it will = payloadLen. */
+                                 * size. By default it will = payloadLen. For AFT, the
+                                 * library hands each data unit of a larger payload to
+                                 * the crypto module as a test case of its own, with pt
+                                 * and ct pointing into the payload and the tweak (iv or
+                                 * seq_num) already advanced to that unit, so the units
+                                 * may be run in parallel like other test cases. */
 } ACVP_SYM_CIPHER_TC;
 
+#define ACVP_SYM_SOA_KW_ROOM 16
+
+/**
+ * @struct ACVP_SYM_CIPHER_SOA
+ * @brief This struct holds the test cases of an AES test group laid out as arrays, for a crypto
+ *        module that works on many buffers at once. See acvp_cap_sym_cipher_set_soa_handler().
+ *
+ *        The values of test case i are found at i times the length of the value from the start
+ *        of each array: key + i * key_len, iv + i * iv_len, and so on. pt and ct are
+ *        data_stride bytes apart, the largest payload of the group, and each test case has
+ *        data_len[i] bytes of it. All lengths are in bytes.
+ *
+ *        For the AEAD modes, GCM, CCM, GCM-SIV and XPN, the tag is always in tag, apart from the
+ *        payload, including for CCM and GCM-SIV, where the protocol carries it at the end of ct.
+ *        When decrypting, the module clears tag_ok[i] for each tag that does not verify.
+ *
+ *        For KW and KWP, key is the KEK, and data_stride leaves ACVP_SYM_SOA_KW_ROOM bytes past
+ *        the largest input for the semiblock and padding wrapping adds. The output is not as
+ *        long as the input, so the module writes the length of each in out_len[i].
+ */
+typedef struct acvp_sym_cipher_soa_t {
+    ACVP_CIPHER cipher;
+    ACVP_SYM_CIPH_DIR direction;          /**< encrypt or decrypt, the same for the whole group */
+    ACVP_SYM_CIPH_IVGEN_SRC ivgen_source; /**< If internal, the module writes each IV it used */
+    int count;                            /**< Number of test cases */
+    unsigned int key_len;
+    unsigned int iv_len;
+    unsigned int aad_len;
+    unsigned int tag_len;
+    unsigned int data_stride;
+    unsigned int *data_len;               /**< Payload of each test case */
+    unsigned int *tc_id;                  /**< Test case id of each test case */
+    unsigned char *key;
+    unsigned char *iv;
+    unsigned char *aad;
+    unsigned char *pt;                    /**< Input when encrypting, output when decrypting */
+    unsigned char *ct;                    /**< Input when decrypting, output when encrypting */
+    unsigned char *tag;                   /**< AEAD modes only; output when encrypting */
+    int key_shared;                       /**< Set when all the test cases have the same key, so
+                                               one key schedule does for the whole group */
+    int *tag_ok;                          /**< Decrypting with an AEAD mode: 1 for every test case
+                                               until the module finds its tag does not verify */
+    ACVP_SYM_CIPH_SALT_SRC salt_source;   /**< XPN only; if internal, the module writes each salt */
+    unsigned int salt_len;
+    unsigned char *salt;                  /**< XPN only */
+    ACVP_SYM_KW_MODE kwcipher;            /**< KW and KWP only */
+    unsigned int *out_len;                /**< KW and KWP only; output of each test case */
+} ACVP_SYM_CIPHER_SOA;
+
+/**
+ * @brief Opaque destination a crypto module writes the output of a test case to with
+ *        acvp_output_write(), rather than to a buffer, when the capability has been set up with
+ *        acvp_cap_set_output_sink(). See \ref ACVP_HASH_TC.md_sink, \ref ACVP_KMAC_TC.mac_sink and
+ *        \ref ACVP_DRBG_TC.drb_sink.
+ */
+typedef struct acvp_output_sink_t ACVP_OUTPUT_SINK;
+
 /**
  * @struct ACVP_HASH_TC
  * @brief This struct holds data that represents a single test case for hash testing. This data is
@@ -1264,11 +1403,49 @@ typedef struct acvp_hash_tc_t {
     unsigned long long int exp_len; /**< The final length (in bytes) of the expanded content
                                          Only provided when \ref ACVP_HASH_TC.test_type is LDT */
     unsigned char *md; /**< The resulting digest calculated for the test case.
-                            SUPPLIED BY USER */
+                            SUPPLIED BY USER. NULL when md_sink is given */
     unsigned int md_len; /**< The length (in bytes) of \ref ACVP_HASH_TC.md
                               SUPPLIED BY USER */
+    ACVP_OUTPUT_SINK *md_sink; /**< Where the xof_len bytes of output go instead of md, with
+                                    acvp_output_write(). Only given for SHAKE VOT test cases of a
+                                    capability set up with acvp_cap_set_output_sink() */
+    unsigned int xof_min_len; /**< Smallest output length (in bytes) of a SHAKE MCT
+                                   Only provided to a hash MCT handler */
+    unsigned int xof_max_len; /**< Largest output length (in bytes) of a SHAKE MCT
+                                   Only provided to a hash MCT handler */
+    unsigned char *mct_md; /**< The checkpoints of an MCT, checkpoint i at mct_md + i * mct_md_stride
+                                Only provided to a hash MCT loop handler. SUPPLIED BY USER */
+    unsigned int mct_md_stride; /**< Bytes between two checkpoints in \ref ACVP_HASH_TC.mct_md */
+    unsigned int *mct_md_len; /**< The length (in bytes) of each checkpoint
+                                   Only provided to a hash MCT loop handler. SUPPLIED BY USER */
+    unsigned long long int ldt_offset; /**< How much of the expanded content (in bytes)
+                                            acvp_hash_ldt_next_chunk() has handed out */
+    unsigned char *ldt_chunk; /**< Internal to libacvp, used by acvp_hash_ldt_next_chunk() */
+    unsigned char *ldt_map; /**< Internal to libacvp, used by acvp_hash_ldt_map() */
+    unsigned long long int ldt_map_len; /**< Internal to libacvp, used by acvp_hash_ldt_map() */
 } ACVP_HASH_TC;
 
+/**
+ * @struct ACVP_HASH_SOA
+ * @brief This struct holds the messages of a hash AFT test group laid out as arrays, for a crypto
+ *        module that hashes many messages at once. See acvp_cap_hash_set_soa_handler().
+ *
+ *        The messages are back to back in msg, message i starting msg_off[i] bytes in and being
+ *        msg_len[i] bytes long. The module writes the digest of message i to md + i * md_stride
+ *        and its length to md_len[i]. All lengths are in bytes.
+ */
+typedef struct acvp_hash_soa_t {
+    ACVP_CIPHER cipher;
+    int count;                 /**< Number of test cases */
+    unsigned int *tc_id;       /**< Test case id of each test case */
+    unsigned char *msg;
+    size_t *msg_off;
+    unsigned int *msg_len;
+    unsigned char *md;         /**< SUPPLIED BY USER */
+    unsigned int md_stride;
+    unsigned int *md_len;      /**< SUPPLIED BY USER */
+} ACVP_HASH_SOA;
+
 /**
  * @struct ACVP_KDF135_IKEV2_TC
  * @brief This struct holds data that represents a single test case for kdf135 IKEV2 testing. This
@@ -1425,6 +1602,7 @@ typedef struct acvp_kdf108_tc_t {
                                      Must be <= ACVP_KDF108_FIXED_DATA_MAX */
     int counter_len;
     int deferred;
+    void *tg_ctx;               /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_KDF108_TC;
 
 /**
@@ -1587,6 +1765,8 @@ typedef struct acvp_hmac_tc_t {
     unsigned int mac_len;
     unsigned int key_len;
     unsigned char *key;
+    unsigned int key_id;   /**< Same for the test cases of a group with the same key, from 1 */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_HMAC_TC;
 
 /**
@@ -1608,6 +1788,9 @@ typedef struct acvp_cmac_tc_t {
     unsigned char *key; /**< for CMAC-AES */
     unsigned char *key2; /**< for CMAC-TDES */
     unsigned char *key3; /**< for CMAC-TDES */
+    unsigned int key_id;   /**< Same for the test cases of a group with the same key (all three for
+                                CMAC-TDES), from 1 */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_CMAC_TC;
 
 /**
@@ -1625,6 +1808,9 @@ typedef struct acvp_kmac_tc_t {
 
     unsigned char *msg;
     unsigned char *mac; /**< The resulting digest calculated for the test case, or provided when verifying */
+    ACVP_OUTPUT_SINK *mac_sink; /**< Where the mac_len bytes of an AFT test case go instead of mac,
+                                     with acvp_output_write(), when the capability has been set up
+                                     with acvp_cap_set_output_sink() */
     unsigned char *key;
     unsigned char *custom_hex;
     char *custom;
@@ -1633,8 +1819,18 @@ typedef struct acvp_kmac_tc_t {
     int mac_len;
     int key_len;
     int custom_len;
+    unsigned int key_id;   /**< Same for the test cases of a group with the same key and
+                                customization, from 1 */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_KMAC_TC;
 
+/**
+ * @brief Opaque progress and cancellation state of a long running test case (RSA KeyGen, DSA
+ *        PQGGen/KeyGen, safe primes KeyGen). The crypto module passes it to acvp_tc_progress()
+ *        while it generates primes; it is NULL when there is nothing to check.
+ */
+typedef struct acvp_tc_control_t ACVP_TC_CONTROL;
+
 /**
  * @struct ACVP_RSA_KEYGEN_TC
  * @brief This struct holds data that represents a single test case for RSA keygen testing. The
@@ -1696,6 +1892,7 @@ typedef struct acvp_rsa_keygen_tc_t {
     int xp_len;
     int xp1_len;
     int xp2_len;
+    ACVP_TC_CONTROL *control; /**< See acvp_tc_progress() */
 } ACVP_RSA_KEYGEN_TC;
 
 /**
@@ -1729,6 +1926,7 @@ typedef struct acvp_ecdsa_tc_t {
     ACVP_TEST_DISPOSITION ver_disposition; /**< Indicates pass/fail (only in "verify" direction)*/
     unsigned char *message;
     int msg_len;
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_ECDSA_TC;
 
 /**
@@ -1756,7 +1954,7 @@ typedef struct acvp_eddsa_tc_t {
     int signature_len;
 
     ACVP_TEST_DISPOSITION ver_disposition; /**< Indicates pass/fail output for verification */
-
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_EDDSA_TC;
 
 /**
@@ -1787,8 +1985,46 @@ typedef struct acvp_rsa_sig_tc_t {
     int sig_len;
     ACVP_CIPHER sig_mode;
     ACVP_TEST_DISPOSITION ver_disposition; /**< Indicates pass/fail (only in "verify" direction)*/
+    void *tg_ctx;       /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
+    ACVP_BN e_bn;       /**< SigVer with acvp_cap_set_bn_limbs(): e, n and the signature, */
+    ACVP_BN n_bn;       /**< given here instead, with e_len, n_len and sig_len 0 */
+    ACVP_BN sig_bn;
 } ACVP_RSA_SIG_TC;
 
+/**
+ * @struct ACVP_RSA_SIGVER_SOA
+ * @brief This struct holds an RSA SigVer test group laid out as what the test cases share, given
+ *        once, and arrays of what each test case has of its own, for a crypto module that
+ *        verifies many signatures at once. See acvp_cap_rsa_sigver_set_soa_handler().
+ *
+ *        The messages are back to back in msg, message i starting msg_off[i] bytes in and being
+ *        msg_len[i] bytes long. Signature i is sig_len[i] bytes at sig + i * sig_stride. The
+ *        module sets ver_disposition[i] to 1 if signature i verified and 0 if it did not. All
+ *        lengths are in bytes.
+ */
+typedef struct acvp_rsa_sigver_soa_t {
+    int tg_id;
+    ACVP_RSA_SIG_TYPE sig_type;
+    ACVP_HASH_ALG hash_alg;
+    ACVP_RSA_MASK_FUNCTION mask;
+    unsigned int modulo;
+    int salt_len;
+    unsigned char *e;          /**< Public key of the whole group */
+    int e_len;
+    unsigned char *n;
+    int n_len;
+    void *tg_ctx;              /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
+    int count;                 /**< Number of test cases */
+    unsigned int *tc_id;       /**< Test case id of each test case */
+    unsigned char *msg;
+    size_t *msg_off;
+    int *msg_len;
+    unsigned char *sig;
+    unsigned int sig_stride;
+    int *sig_len;
+    int *ver_disposition;      /**< SUPPLIED BY USER */
+} ACVP_RSA_SIGVER_SOA;
+
 /** @enum ACVP_DSA_MODE */
 typedef enum acvp_dsa_mode {
     ACVP_DSA_MODE_KEYGEN = 1,
@@ -1855,6 +2091,20 @@ typedef struct acvp_dsa_tc_t {
     int s_len;
     unsigned char *seed;
     unsigned char *msg;
+    int pqg_given; /**< KeyGen and SigGen: p, q and g are already filled in with domain parameters
+                        generated for an earlier group with the same l and n; the crypto module may
+                        generate its keys over them instead of generating new ones */
+    ACVP_TC_CONTROL *control; /**< PQGGen and KeyGen: see acvp_tc_progress() */
+    /*
+     * PQGVer and SigVer with acvp_cap_set_bn_limbs(): the inputs are given
+     * here instead, and their byte lengths above are 0
+     */
+    ACVP_BN p_bn;
+    ACVP_BN q_bn;
+    ACVP_BN g_bn;
+    ACVP_BN y_bn;
+    ACVP_BN r_bn;
+    ACVP_BN s_bn;
 } ACVP_DSA_TC;
 
 /** @enum ACVP_KAS_ECC_MODE */
@@ -1950,6 +2200,7 @@ typedef struct acvp_kas_ecc_tc_t {
     int dlen;
     int zlen;
     int chashlen;
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_KAS_ECC_TC;
 
 /** @enum ACVP_KAS_FFC_MODE */
@@ -2024,6 +2275,31 @@ typedef enum acvp_kas_ffc_test_type {
     ACVP_KAS_FFC_TT_VAL
 } ACVP_KAS_FFC_TEST_TYPE;
 
+/**
+ * @struct ACVP_FFC_GROUP
+ * @brief This struct holds the domain parameters of a named safe-prime group (the MODP groups of
+ *        RFC 3526 and the ffdhe groups of RFC 7919). libacvp keeps them in static tables and points
+ *        the Safe Primes and KAS-FFC test cases of these groups at them, so the crypto module need
+ *        not build p, q and g again for every test case. The limbs are 64 bits each, least
+ *        significant limb first, as most big number libraries keep them.
+ */
+typedef struct acvp_ffc_group_t {
+    const char *name;                      /**< As the server names it, e.g. "ffdhe2048" */
+    int bits;                              /**< Size of p in bits */
+    const unsigned char *p;                /**< Big endian, as the p of a test case */
+    int plen;
+    const unsigned char *q;                /**< (p - 1) / 2 */
+    int qlen;
+    const unsigned char *g;
+    int glen;
+    const unsigned long long int *p_limbs;
+    int p_limbs_cnt;
+    const unsigned long long int *q_limbs;
+    int q_limbs_cnt;
+    const unsigned long long int *g_limbs;
+    int g_limbs_cnt;
+} ACVP_FFC_GROUP;
+
 /**
  * @struct ACVP_KAS_FFC_TC
  * @brief This struct holds data that represents a single test case for KAS-FFC testing. This data
@@ -2057,6 +2333,18 @@ typedef struct acvp_kas_ffc_tc_t {
     int epuilen;
     int chashlen;
     int piutlen;
+    const ACVP_FFC_GROUP *group; /**< Domain parameters of a named group, NULL for FB and FC */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
+    /*
+     * With acvp_cap_set_bn_limbs() the inputs are given here instead, and
+     * their byte lengths above are 0. The limbs of a named group are in group.
+     */
+    ACVP_BN p_bn;
+    ACVP_BN q_bn;
+    ACVP_BN g_bn;
+    ACVP_BN eps_bn;
+    ACVP_BN epri_bn;
+    ACVP_BN epui_bn;
 } ACVP_KAS_FFC_TC;
 
 /** @enum ACVP_SAFE_PRIMES_PARAM */
@@ -2100,6 +2388,10 @@ typedef struct acvp_safe_primes_tc_t {
     ACVP_SAFE_PRIMES_TEST_TYPE test_type;
     ACVP_CIPHER cipher;
     ACVP_SAFE_PRIMES_MODE dgm;
+    const ACVP_FFC_GROUP *group; /**< Domain parameters of dgm */
+    ACVP_TC_CONTROL *control; /**< KeyGen: see acvp_tc_progress() */
+    ACVP_BN x_bn;             /**< KeyVer with acvp_cap_set_bn_limbs(): x and y, given here */
+    ACVP_BN y_bn;             /**< instead, with xlen and ylen 0 */
 } ACVP_SAFE_PRIMES_TC;
 
 /** @enum ACVP_KAS_IFC_PARAM */
@@ -2185,6 +2477,23 @@ typedef struct acvp_kas_ifc_tc_t {
     int server_ct_z_len;
     int provided_kas2_z_len;
     unsigned int modulo;
+    unsigned int key_id;   /**< Same for the test cases of a group with the same IUT key, from 1;
+                                0 when there is no IUT key */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
+    /*
+     * With acvp_cap_set_bn_limbs() the key parameters are given here
+     * instead, and their byte lengths above are 0
+     */
+    ACVP_BN server_n_bn;
+    ACVP_BN server_e_bn;
+    ACVP_BN p_bn;
+    ACVP_BN q_bn;
+    ACVP_BN d_bn;
+    ACVP_BN n_bn;
+    ACVP_BN e_bn;
+    ACVP_BN dmp1_bn;
+    ACVP_BN dmq1_bn;
+    ACVP_BN iqmp_bn;
 } ACVP_KAS_IFC_TC;
 
 /** @enum ACVP_KDA_ENCODING */
@@ -2282,6 +2591,8 @@ typedef struct acvp_kda_onestep_tc_t {
     unsigned char *vEphemeralData;
     unsigned char *providedDkm;
     unsigned char *outputDkm;
+    int fixedInfoLen;
+    unsigned char *fixedInfo; /**< Assembled by libacvp from fixedInfoPattern and the fields above */
 } ACVP_KDA_ONESTEP_TC;
 
 /**
@@ -2329,6 +2640,8 @@ typedef struct acvp_kda_twostep_tc_t {
     unsigned char *vEphemeralData;
     unsigned char *providedDkm;
     unsigned char *outputDkm;
+    int fixedInfoLen;
+    unsigned char *fixedInfo; /**< Assembled by libacvp from fixedInfoPattern and the fields above */
 } ACVP_KDA_TWOSTEP_TC;
 
 /**
@@ -2371,6 +2684,8 @@ typedef struct acvp_kda_hkdf_tc_t {
     unsigned char *vEphemeralData;
     unsigned char *providedDkm;
     unsigned char *outputDkm;
+    int fixedInfoLen;
+    unsigned char *fixedInfo; /**< Assembled by libacvp from fixedInfoPattern and the fields above */
 } ACVP_KDA_HKDF_TC;
 
 /** @enum ACVP_KTS_IFC_PARAM */
@@ -2465,6 +2780,9 @@ typedef struct acvp_kts_ifc_tc_t {
     int ct_len;
     int pt_len;
     int modulo;
+    unsigned int key_id;   /**< Same for the test cases of a group with the same IUT key, from 1;
+                                0 when there is no IUT key */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_KTS_IFC_TC;
 
 /**
@@ -2489,6 +2807,9 @@ typedef struct acvp_drbg_tc_t {
     unsigned char *entropy;
     unsigned char *nonce;
     unsigned char *drb; /**< The resulting pseudo random generated for the test case */
+    ACVP_OUTPUT_SINK *drb_sink; /**< Where the drb_len bytes of output go instead of drb, with
+                                     acvp_output_write(), when the capability has been set up with
+                                     acvp_cap_set_output_sink() */
 
     unsigned int der_func_enabled;
     unsigned int pred_resist_enabled;
@@ -2498,6 +2819,9 @@ typedef struct acvp_drbg_tc_t {
     unsigned int entropy_len;          /**< Entropy length (in bytes) */
     unsigned int nonce_len;            /**< Nonce length (in bytes) */
     unsigned int drb_len;              /**< Expected drb length (in bytes) */
+
+    unsigned int tg_id;    /**< Test group id */
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_DRBG_TC;
 
 /** @enum ACVP_LMS_PARAM */
@@ -2589,7 +2913,7 @@ typedef struct acvp_lms_tc_t {
     int msg_len;
     int sig_len;
     ACVP_TEST_DISPOSITION ver_disposition;
-
+    void *tg_ctx;          /**< Set by the group handler at ACVP_TG_BEGIN, if there is one */
 } ACVP_LMS_TC;
 
 /**
@@ -2636,6 +2960,34 @@ typedef struct acvp_test_case_t {
     } tc; /**< the union abstracting the test case for passing to the user application */
 } ACVP_TEST_CASE;
 
+/**
+ * @brief Opaque reference to a test case handed to an async crypto handler. It is passed back to
+ *        acvp_tc_complete() once the crypto module has finished the test case.
+ */
+typedef struct acvp_tc_handle_t ACVP_TC_HANDLE;
+
+/**
+ * @brief Opaque reference to a shared memory ring through which test cases are handed to a crypto
+ *        module running in another process, see acvp_ring_create() and acvp_cap_set_ring_handler().
+ */
+typedef struct acvp_ring_t ACVP_RING;
+
+/**
+ * @brief Opaque reference to the link to a remote device under test over which test cases are
+ *        tunnelled, see acvp_dut_create() and acvp_cap_set_dut_handler().
+ */
+typedef struct acvp_dut_t ACVP_DUT;
+
+/**
+ * @enum ACVP_TG_EVENT
+ * @brief Tells a group handler whether a test group is starting or has finished, see
+ *        acvp_cap_set_group_handler().
+ */
+typedef enum acvp_tg_event {
+    ACVP_TG_BEGIN = 1,
+    ACVP_TG_END
+} ACVP_TG_EVENT;
+
 
 
 /** @defgroup APIs Public APIs for libacvp
@@ -2646,6 +2998,37 @@ typedef struct acvp_test_case_t {
  * @{
  */
 
+/**
+ * @brief acvp_cap_set_deferred_validation() has the checks of a capability's settings against
+ *        each other made once, by acvp_cap_finalize(), rather than by each set call.
+ *
+ *        Some settings may only be made if others have not been, such as the ivLen list of a
+ *        symmetric cipher and its ivLen domain. Checked as it is set, each one has to come in the
+ *        right order. Once deferred, the settings of all capabilities can be made in any order
+ *        and are checked together. Each value is still checked on its own as it is set.
+ *        acvp_cap_finalize() is made by the library before it builds the registration if the
+ *        application has not made it.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param enable 1 to defer the checks, 0 to make them as each setting is made again.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_set_deferred_validation(ACVP_CTX *ctx, int enable);
+
+/**
+ * @brief acvp_cap_finalize() checks the settings of every enabled capability against each other,
+ *        in one pass, see acvp_cap_set_deferred_validation().
+ *
+ *        It may be called whether or not the checks were deferred, and as many times as needed.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ *
+ * @return ACVP_RESULT, ACVP_INVALID_ARG if a capability has settings that conflict, each of which
+ *         is logged
+ */
+ACVP_RESULT acvp_cap_finalize(ACVP_CTX *ctx);
+
 /**
  * @brief Allows an application to specify a symmetric cipher capability to be tested by the ACVP
  *        server.
@@ -2725,244 +3108,849 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
                                            int increment);
 
 /**
- * @brief acvp_cap_hash_enable() allows an application to specify a hash capability to be tested
- *        by the ACVP server.
+ * @brief acvp_cap_sym_cipher_set_mct_handler() allows an application to run the inner loop of
+ *        AES and TDES Monte Carlo tests itself, keeping the cipher context set up across it,
+ *        instead of libacvp calling the crypto_handler once per block.
  *
- *        This function should be called to enable crypto capabilities for hash algorithms that
- *        will be tested by the ACVP server. This includes SHA-1, SHA-256, SHA-384, etc. This
- *        function may be called multiple times to specify more than one crypto capability.
+ *        The mct_handler is called once per checkpoint (outer iteration) of an MCT with
+ *        \ref ACVP_SYM_CIPHER_TC.mct_index set to 0 and the key, iv and pt (encrypt) or ct
+ *        (decrypt) the checkpoint starts from. It runs the ACVP_AES_MCT_INNER or
+ *        ACVP_DES_MCT_INNER iterations of the inner loop, feeding each one the input defined for
+ *        the mode just as libacvp would between crypto_handler calls, and on return leaves:
+ *        - pt and ct: the input and output of the last inner iteration.
+ *        - iv_ret and iv_ret_after (TDES only): set for the last inner iteration as the
+ *          crypto_handler would set them.
+ *        - mct_tail: the last ACVP_SYM_MCT_TAIL_LEN bytes of the output stream of the inner loop.
+ *          That is the last blocks for the block modes, one byte per iteration for CFB8 and one
+ *          bit per iteration for CFB1, the output of the last iteration being at the end (the
+ *          least significant bit of the last byte for CFB1).
  *
- *        When the application enables a crypto capability, such as SHA-1, it also needs to specify
- *        a callback function that will be used by libacvp when that crypto capability is needed
- *        during a test session.
+ *        libacvp then records the checkpoint and derives the key, iv and input of the next one.
+ *        Only the modes with Monte Carlo tests take an MCT handler: AES ECB, CBC, OFB, CFB1, CFB8
+ *        and CFB128, and TDES ECB, CBC, OFB, CFB1, CFB8 and CFB64.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param crypto_handler Address of function implemented by application that is invoked by libacvp
- *        when the crypto capability is needed during a test session. This crypto_handler function
- *        is expected to return 0 on success and 1 for failure.
+ * @param mct_handler Address of function implemented by application that is invoked by libacvp
+ *        for each checkpoint. It is expected to return 0 on success and 1 for failure.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_hash_enable(ACVP_CTX *ctx,
-                                 ACVP_CIPHER cipher,
-                                 int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+ACVP_RESULT acvp_cap_sym_cipher_set_mct_handler(ACVP_CTX *ctx,
+                                                ACVP_CIPHER cipher,
+                                                int (*mct_handler)(ACVP_TEST_CASE *test_case));
 
 /**
- * @brief acvp_cap_hash_set_parm() allows an application to specify operational parameters to be
- *        used for a given hash alg during a test session with the ACVP server.
+ * @brief acvp_cap_sym_cipher_set_mct_loop_handler() allows an application to run the whole of a
+ *        TDES Monte Carlo test itself, the updates of the key between checkpoints (odd parity
+ *        included) and of the iv and input along with them, so libacvp hands it the start of the
+ *        test only once.
  *
- *        This function should be called to enable crypto capabilities for hash capabilities that
- *        will be tested by the ACVP server. This includes SHA-1, SHA-256, SHA-384, etc.
+ *        The mct_loop_handler is called once per MCT with the key, iv, keyingOption and pt
+ *        (encrypt) or ct (decrypt) of the test case. It runs the ACVP_DES_MCT_OUTER checkpoints
+ *        as the TDES MCT defines them, and for checkpoint i writes the key it starts from to
+ *        \ref ACVP_SYM_CIPHER_TC.mct_key + i * ACVP_TDES_MCT_KEY_LEN, and its iv, pt and ct to
+ *        \ref ACVP_SYM_CIPHER_TC.mct_iv, mct_pt and mct_ct + i * ACVP_TDES_MCT_BLOCK_LEN. The iv
+ *        is ignored for ECB, and for CFB1 pt and ct are a single bit, the most significant one
+ *        in their first byte. The other fields of the test case may be used as scratch space.
  *
- *        This function may be called multiple times to specify more than one crypto parameter
- *        value for the hash algorithm. The ACVP_CIPHER value passed to this function should
- *        already have been setup by invoking acvp_enable_hash_cap().
+ *        A crypto module that only wants to run the inner loop can have acvp_des_mct_loop() run
+ *        the rest of the test for it. Only TDES ECB, CBC, OFB, CFB1, CFB8 and CFB64 take an MCT
+ *        loop handler; it takes precedence over the mct_handler of the capability.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param param ACVP_HASH_PARM enum value identifying the algorithm parameter that is being
- *        specified. An example would be a flag indicating if empty input values are allowed.
- * @param value the value corresponding to the parameter being set
+ * @param mct_loop_handler Address of function implemented by application that is invoked by
+ *        libacvp for each MCT. It is expected to return 0 on success and 1 for failure.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_hash_set_parm(ACVP_CTX *ctx,
-                                   ACVP_CIPHER cipher,
-                                   ACVP_HASH_PARM param,
-                                   int value);
+ACVP_RESULT acvp_cap_sym_cipher_set_mct_loop_handler(ACVP_CTX *ctx,
+                                                     ACVP_CIPHER cipher,
+                                                     int (*mct_loop_handler)(ACVP_TEST_CASE *test_case));
 
 /**
- * @brief acvp_cap_hash_set_domain() functions similarly to @ref acvp_cap_hash_set_parm() but uses
- *        a range of values for certain parameters instead of a single value.
+ * @brief acvp_des_mct_loop() is the reference outer loop of a TDES Monte Carlo test, for an MCT
+ *        loop handler to call with the test case it was given.
  *
- * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param parm ACVP_HASH_PARM enum value identifying the algorithm parameter that is being
- *        specified. An example would be message length.
- * @param min the lower value of the supported range of values
- * @param max the maximum supported value for the given parameter
- * @param increment the supported increment for every value in between min and max
+ *        It runs the checkpoints just as libacvp does when there is no MCT loop handler, and
+ *        fills in the checkpoint arrays, but calls mct_handler directly for each inner loop. The
+ *        mct_handler is one that could be given to acvp_cap_sym_cipher_set_mct_handler().
+ *
+ * @param test_case The test case given to the mct_loop_handler.
+ * @param mct_handler Runs one inner loop of the MCT, returning 0 on success and 1 for failure.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_hash_set_domain(ACVP_CTX *ctx,
-                                     ACVP_CIPHER cipher,
-                                     ACVP_HASH_PARM parm,
-                                     int min,
-                                     int max,
-                                     int increment);
+ACVP_RESULT acvp_des_mct_loop(ACVP_TEST_CASE *test_case,
+                              int (*mct_handler)(ACVP_TEST_CASE *test_case));
 
 /**
- * @brief acvp_enable_drbg_cap() allows an application to specify a hash capability to be tested by
- *        the ACVP server.
+ * @brief acvp_cap_set_batch_handler() allows an application to have the test cases of a
+ *        capability handed to the crypto module a whole test group at a time.
  *
- *        This function should be called to enable crypto capabilities for drbg algorithms that
- *        will be tested by the ACVP server. This includes HASHDRBG, HMACDRBG, CTRDRBG. This
- *        function may be called multiple times to specify more than one crypto capability.
+ *        This is meant for modules that can pipeline or vectorize work internally, such as
+ *        hardware accelerators or offload engines. Batching is supported for the AES ciphers, the
+ *        hash and HMAC algorithms, RSA SigVer, where all test cases of a group are verified
+ *        against the same public key, so a multi-buffer RSA implementation can take the whole
+ *        group in one call, the RSA decryption (SP800-56Br2 revision) and signature
+ *        primitives, EdDSA SigVer, for batch verification of Ed25519 or Ed448 signatures, ECDSA KeyVer and
+ *        SigVer, DSA PQGVer and SigVer, KAS-ECC CDH, Component and SSC, where all test cases of
+ *        a group are scalar multiplications on the same curve, PBKDF, and the SNMP, SRTP and ANSI X9.63 KDFs. Monte Carlo tests, where each
+ *        test case depends on the previous one, still go through the crypto_handler the
+ *        capability was enabled with.
  *
- *        When the application enables a crypto capability, such as ACVP_HASHDRBG, it also needs to
- *        specify a callback function that will be used by libacvp when that crypto capability is
- *        needed during a test session.
+ *        The ACVP_CIPHER value passed to this function should already have been setup by
+ *        invoking the enable function for that cipher earlier.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param crypto_handler Address of function implemented by application that is invoked by libacvp
- *        when the crypto capability is needed during a test session. This crypto_handler function
- *        is expected to return 0 on success and 1 for failure.
+ * @param batch_handler Address of function implemented by application that is invoked by libacvp
+ *        with the count test cases of a test group. For each test case it sets results[i] to what
+ *        the crypto_handler would have returned for test_cases[i]. It is expected to return 0 on
+ *        success and 1 if the batch as a whole failed.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_drbg_enable(ACVP_CTX *ctx,
-                                 ACVP_CIPHER cipher,
-                                 int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+ACVP_RESULT acvp_cap_set_batch_handler(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
+                                       int (*batch_handler)(ACVP_TEST_CASE *test_cases,
+                                                            int *results,
+                                                            int count));
 
 /**
- * @brief acvp_cap_drbg_set_parm() allows an application to specify operational parameters to be
- *        used for a given DRBG alg during a test session with the ACVP server.
+ * @brief acvp_cap_sym_cipher_set_soa_handler() allows an application to have the AFT test groups
+ *        of an AES capability handed to the crypto module as arrays of keys, IVs and payloads
+ *        rather than one ACVP_SYM_CIPHER_TC at a time.
  *
- *        This function should be called to enable crypto capabilities for hash capabilities that
- *        will be tested by the ACVP server. This includes HASHDRBG, HMACDRBG, CTRDRBG. This
- *        function may be called multiple times to specify more than one crypto capability.
+ *        This is meant for multi-buffer implementations, such as AES-NI or VAES pipelines and
+ *        GPUs, that want the inputs of a whole group in contiguous memory. The SoA view is only
+ *        used for the AFT groups of ECB, CBC, CTR, GCM, CCM, GCM-SIV, XPN, KW and KWP; other
+ *        groups of the capability go to its batch handler if it has one, and its crypto_handler
+ *        otherwise.
+ *        An AEAD module can keep one cipher context for the group, set up the key once when
+ *        key_shared says it can, and pipeline the decryptions, many of which are expected to
+ *        fail, reporting each in tag_ok. Key wrap groups have one KEK size and direction, so a
+ *        module can do the same for wrapping and unwrapping, and as for the AEAD modes an unwrap
+ *        that fails its integrity check is a result of 1, not a failure of the group.
+ *
+ *        The ACVP_CIPHER value passed to this function should already have been setup by
+ *        invoking the enable function for that cipher earlier.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param mode ACVP_DRBG_MODE enum value specifying mode. An example would be ACVP_DRBG_SHA_1
- * @param group The group of capabilities for the given ACVP DRBG modes. Different groups can be
- *        defined for different capabilities; e.g. different lengths can be supported with and
- *        without derivation function support. Groups must be used in a linear fashion (group 0
- *        must be defined before you can define group 1, group 1 before group 2, etc)
- * @param param ACVP_DRBG_PARM enum value identifying the algorithm parameter that is being
- *        specified. An example would be prediction resistance.
- * @param value the value corresponding to the parameter being set
+ * @param soa_handler Address of function implemented by application that is invoked by libacvp
+ *        with the test cases of a test group. For each test case it sets results[i] to what the
+ *        crypto_handler would have returned for it, which for AEAD decryption may instead
+ *        report a tag that did not verify, as clearing tag_ok[i] does. It is expected to return
+ *        0 on success and 1 if the group as a whole failed.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_drbg_set_parm(ACVP_CTX *ctx,
-                                   ACVP_CIPHER cipher,
-                                   ACVP_DRBG_MODE mode,
-                                   int group,
-                                   ACVP_DRBG_PARM param,
-                                   int value);
+ACVP_RESULT acvp_cap_sym_cipher_set_soa_handler(ACVP_CTX *ctx,
+                                                ACVP_CIPHER cipher,
+                                                int (*soa_handler)(ACVP_SYM_CIPHER_SOA *group,
+                                                                   int *results));
 
 /**
- * @brief acvp_enable_drbg_length_cap() allows an application to register a DRBG capability
- *        length-based paramter.
+ * @brief acvp_cap_set_async_handler() allows an application to complete the test cases of a
+ *        capability asynchronously, with many of them in flight at once.
  *
- *        This function should be used to register a length-based parameter for a DRBG capability.
- *        An example would be entropy, nonce, perso where a minimum, step, and maximum can be
- *        specified.
+ *        This is meant for modules where each operation waits on a device round trip, such as an
+ *        HSM. libacvp submits the test cases of a test group one by one through async_handler and
+ *        keeps submitting until depth of them are waiting to complete. The crypto module reports
+ *        each test case done by calling acvp_tc_complete(), from any thread, and may do so from
+ *        within async_handler itself. Results are written to the response in test case order.
+ *
+ *        Async handlers are supported for the same capabilities and test types as batch handlers,
+ *        see acvp_cap_set_batch_handler(). If a capability has both, the batch handler is used.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param mode ACVP_DRBG_MODE enum value specifying mode. An example would be ACVP_DRBG_SHA_1
- * @param group The group of capabilities for the given ACVP DRBG modes. Different groups can be
- *        defined for different capabilities; e.g. different lengths can be supported with and
- *        without derivation function support. Groups must be used in a linear fashion (group 0
- *        must be defined before you can define group 1, group 1 before group 2, etc)
- * @param param ACVP_DRBG_PARM enum value specifying paramter. An example would be
- *        ACVP_DRBG_ENTROPY_LEN
- * @param min minimum value
- * @param step increment value
- * @param max maximum value
+ * @param async_handler Address of function implemented by application that is invoked by libacvp
+ *        to start a test case. It is expected to return 0 once the test case has been accepted,
+ *        in which case acvp_tc_complete() must be called exactly once with handle, and 1 if it
+ *        could not be started.
+ * @param depth The most test cases to have in flight at once. Must be at least 1.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_drbg_set_length(ACVP_CTX *ctx,
-                                     ACVP_CIPHER cipher,
-                                     ACVP_DRBG_MODE mode,
-                                     int group,
-                                     ACVP_DRBG_PARM param,
-                                     int min,
-                                     int step,
-                                     int max);
+ACVP_RESULT acvp_cap_set_async_handler(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
+                                       int (*async_handler)(ACVP_TEST_CASE *test_case,
+                                                            ACVP_TC_HANDLE *handle),
+                                       int depth);
 
 /**
- * @brief acvp_enable_dsa_cap()
- *        This function should be used to enable DSA capabilities. Specific modes and parameters
- *        can use acvp_cap_dsa_set_parm.
+ * @brief acvp_cap_set_output_sink() has the long outputs of a capability written by the crypto
+ *        module straight into the response, through acvp_output_write(), instead of to a buffer
+ *        libacvp then copies from.
  *
- *        When the application enables a crypto capability, such as DSA, it also needs to specify a
- *        callback function that will be used by libacvp when that crypto capability is needed
- *        during a test session.
+ *        Each chunk written is hex encoded into the string that goes into the response as it is,
+ *        so the output of a test case is only held once, however long it is, and an XOF or DRBG
+ *        can be squeezed a block at a time. The sink is given in place of the output buffer for
+ *        the SHAKE VOT test cases (\ref ACVP_HASH_TC.md_sink), the KMAC AFT test cases
+ *        (\ref ACVP_KMAC_TC.mac_sink) and the DRBG test cases (\ref ACVP_DRBG_TC.drb_sink).
+ *        Test cases handed to a crypto module in another process or on a remote device still get
+ *        the buffer.
+ *
+ *        The ACVP_CIPHER value passed to this function should already have been setup by
+ *        invoking the enable function for that cipher earlier.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param crypto_handler Address of function implemented by application that is invoked by libacvp
- *        when the crypto capability is needed during a test session. This crypto_handler function
- *        is expected to return 0 on success and 1 for failure.
+ * @param enable 1 to give the crypto module a sink, 0 to go back to the output buffer.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_dsa_enable(ACVP_CTX *ctx,
-                                ACVP_CIPHER cipher,
-                                int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+ACVP_RESULT acvp_cap_set_output_sink(ACVP_CTX *ctx, ACVP_CIPHER cipher, int enable);
 
 /**
- * @brief acvp_cap_dsa_set_parm() allows an application to specify operational parameters to be
- *        used for a given dsa alg during a test session with the ACVP server. This function
- *        should be called to enable crypto capabilities for DSA modes and functions. It may be
- *        called multiple times to specify more than one crypto capability.
+ * @brief acvp_cap_set_bn_limbs() has the big number inputs of the test cases of an RSA, DSA,
+ *        KAS-FFC, KAS-IFC or Safe Primes capability decoded from hex straight into 64 bit limbs
+ *        (\ref ACVP_BN), instead of into big endian bytes, for a crypto module whose big number
+ *        library would otherwise convert every value again.
+ *
+ *        The limbs are given in the _bn fields of the test case, such as
+ *        \ref ACVP_RSA_SIG_TC.n_bn, and the byte length of the value is left 0. Only inputs that
+ *        are numbers are given as limbs; messages, seeds and shared secrets, and everything the
+ *        module outputs, are bytes as before. The RSA SigVer SoA handler, and test cases handed to
+ *        a crypto module in another process or on a remote device, still get bytes.
+ *
+ *        The ACVP_CIPHER value passed to this function should already have been setup by
+ *        invoking the enable function for that cipher earlier.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param mode ACVP_DSA_MODE enum value specifying mode. An example would be ACVP_DSA_MODE_PQGGEN
- * @param param ACVP_DSA_PARM enum value identifying the algorithm parameter that is being
- *        specified. An example would be ACVP_DSA_GENPQ.
- * @param value the value corresponding to the parameter being set
+ * @param enable 1 to give the crypto module limbs, 0 to go back to bytes.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_dsa_set_parm(ACVP_CTX *ctx,
-                                  ACVP_CIPHER cipher,
-                                  ACVP_DSA_MODE mode,
-                                  ACVP_DSA_PARM param,
-                                  int value);
+ACVP_RESULT acvp_cap_set_bn_limbs(ACVP_CTX *ctx, ACVP_CIPHER cipher, int enable);
 
 /**
- * @brief acvp_enable_kas_ecc_cap()
- *        This function should be used to enable KAS-ECC capabilities. Specific modes and
- *        parameters can use acvp_cap_kas_ecc_set_parm.
+ * @brief acvp_output_write() appends output of a test case to its sink.
  *
- *        When the application enables a crypto capability, such as KAS-ECC, it also needs to
- *        specify a callback function that will be used by libacvp when that crypto capability is
- *        needed during a test session.
+ *        The crypto module must write exactly as many bytes as the test case asks for, in as many
+ *        calls as it likes; writing more fails without writing any of data.
  *
- * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param crypto_handler Address of function implemented by application that is invoked by libacvp
- *        when the crypto capability is needed during a test session. This crypto_handler function
- *        is expected to return 0 on success and 1 for failure.
+ * @param sink The sink of the test case, see acvp_cap_set_output_sink().
+ * @param data The next bytes of output.
+ * @param len The length (in bytes) of data.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_cap_kas_ecc_enable(ACVP_CTX *ctx,
-                                    ACVP_CIPHER cipher,
-                                    int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+ACVP_RESULT acvp_output_write(ACVP_OUTPUT_SINK *sink, const unsigned char *data, unsigned int len);
 
 /**
- * @brief acvp_enable_kas_ecc_prereq_cap() allows an application to specify a prerequisite
- *        algorithm for a given KAS-ECC mode during a test session with the ACVP server. This
- *        function should be called to enable a prerequisite for an KAS-ECC mode capability that
- *        will be tested by the server.
- *
- * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
- * @param mode ACVP_KAS_ECC_MODE enum value specifying mode. An example would be
- *        ACVP_KAS_ECC_MODE_PARTIAL
- * @param pre_req ACVP_PREREQ_ALG enum that the specified cipher/mode depends on
- * @param value "same" or number
+ * @brief acvp_tc_complete() is called by the crypto module when it has finished a test case that
+ *        was started through an async handler, see acvp_cap_set_async_handler(). The output
+ *        fields of the test case must be filled in before calling this.
  *
- * @return ACVP_RESULT
+ * @param handle The handle libacvp passed to the async handler along with the test case.
+ * @param result What a crypto_handler would have returned for the test case: 0 on success and 1
+ *        for failure.
  */
-ACVP_RESULT acvp_cap_kas_ecc_set_prereq(ACVP_CTX *ctx,
-                                        ACVP_CIPHER cipher,
-                                        ACVP_KAS_ECC_MODE mode,
-                                        ACVP_PREREQ_ALG pre_req,
-                                        char *value);
+void acvp_tc_complete(ACVP_TC_HANDLE *handle, int result);
 
 /**
- * @brief acvp_cap_kas_ecc_set_parm() allows an application to specify operational parameters to
+ * @brief acvp_ring_create() creates a ring of slots in shared memory, backed by the file at path,
+ *        over which the crypto module runs test cases from another process.
+ *
+ *        Each slot holds one test case as a fixed layout record: the test case struct and room for
+ *        each of its buffers, so the test case is copied in and out rather than serialized. The
+ *        file may be on a memory file system such as /dev/shm and is replaced if it exists. The
+ *        ring is used by handing it to acvp_cap_set_ring_handler() on one side and to
+ *        acvp_ring_serve() on the other, after that side has opened it with acvp_ring_open().
+ *        Either side may create it. Rings are only available on platforms with process shared
+ *        POSIX mutexes and condition variables.
+ *
+ * @param path The file backing the ring.
+ * @param slots How many test cases the ring holds at once, from 1 to 4096. Each slot takes about
+ *        70KB.
+ * @param ring Set to the new ring, to be released with acvp_ring_close().
+ *
+ * @return ACVP_RESULT, ACVP_UNSUPPORTED_OP on platforms without rings, ACVP_TRANSPORT_FAIL when
+ *         the file could not be created or mapped
+ */
+ACVP_RESULT acvp_ring_create(const char *path, int slots, ACVP_RING **ring);
+
+/**
+ * @brief acvp_ring_open() maps a ring created by another process with acvp_ring_create().
+ *
+ * @param path The file backing the ring.
+ * @param ring Set to the ring, to be released with acvp_ring_close().
+ *
+ * @return ACVP_RESULT, ACVP_INVALID_ARG when the file is not a ring made by this version of
+ *         libacvp, ACVP_TRANSPORT_FAIL when it could not be opened or mapped
+ */
+ACVP_RESULT acvp_ring_open(const char *path, ACVP_RING **ring);
+
+/**
+ * @brief acvp_ring_serve() runs the test cases libacvp puts in the ring on crypto_handler, in the
+ *        process of the crypto module, until the side that created the ring closes it.
+ *
+ *        Whenever libacvp rings the doorbell every slot found ready is run in turn before it is
+ *        signalled back, so a wake up covers as many test cases as libacvp filled. The test case
+ *        passed to crypto_handler points into the ring, with the same buffers and lengths the
+ *        crypto_handler of the capability would be given in process; pointers the ring does not
+ *        carry, such as a group handler's tg_ctx, are NULL. Several threads may serve the same
+ *        ring.
+ *
+ * @param ring The ring, from acvp_ring_create() or acvp_ring_open().
+ * @param crypto_handler The handler for the capabilities the ring was set for, expected to return
+ *        0 on success and 1 for failure as for acvp_cap_*_enable.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_ring_serve(ACVP_RING *ring, int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_ring_close() releases the ring. When called by the side that created it, the ring
+ *        is also shut down, which makes acvp_ring_serve() return on the other side, and its file
+ *        is removed.
+ *
+ * @param ring The ring, from acvp_ring_create() or acvp_ring_open().
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_ring_close(ACVP_RING *ring);
+
+/**
+ * @brief acvp_cap_set_ring_handler() has the test cases of a capability run by a crypto module in
+ *        another process, which serves the ring with acvp_ring_serve().
+ *
+ *        The test cases of each test group are put in the slots of the ring, up to depth of them
+ *        at once, and their results are written to the response in test case order once they
+ *        come back. Other workers of the session may use the same ring at the same time. Rings
+ *        are supported for the AES capabilities, other than AES-CFB1, and the hash and HMAC
+ *        capabilities, for the same test types as batch handlers, see
+ *        acvp_cap_set_batch_handler(); hash LDT test cases, and those of test types rings are not
+ *        supported for, still go to the crypto_handler of the capability. The ring is used over a
+ *        batch or async handler of the capability. The ring is not freed with the session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param ring The ring, from acvp_ring_create() or acvp_ring_open().
+ * @param depth The most test cases of a test group to have in the ring at once. Must be at least
+ *        1.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_set_ring_handler(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_RING *ring, int depth);
+
+/**
+ * @brief acvp_dut_create() sets up the link to a remote device under test, such as an embedded
+ *        target on a UART or TCP connection, over which test cases are sent in a compact binary
+ *        encoding.
+ *
+ *        libacvp does not open the connection itself, it moves bytes through send_cb and
+ *        recv_cb. Each test case is a frame of its scalars and input buffers, tagged so the
+ *        device may answer in any order; the frame format, all little endian, is described in
+ *        acvp_dut.c. The device side can be run with acvp_dut_serve(), or by firmware reading
+ *        the same frames.
+ *
+ * @param send_cb Writes all of the len bytes of buf to the link, returning 0 on success and 1 on
+ *        failure.
+ * @param recv_cb Reads exactly len bytes from the link into buf, blocking until they are there,
+ *        returning 0 on success and 1 on failure or when the link is closed.
+ * @param arg Handed to send_cb and recv_cb, such as the file descriptor of the connection.
+ * @param dut Set to the new link, to be released with acvp_dut_free().
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_dut_create(int (*send_cb)(void *arg, const unsigned char *buf, unsigned int len),
+                            int (*recv_cb)(void *arg, unsigned char *buf, unsigned int len),
+                            void *arg,
+                            ACVP_DUT **dut);
+
+/**
+ * @brief acvp_dut_free() releases a link from acvp_dut_create(). The connection itself is left to
+ *        the application to close.
+ *
+ * @param dut The link.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_dut_free(ACVP_DUT *dut);
+
+/**
+ * @brief acvp_dut_serve() is the device side of a link: it reads test cases from the link, runs
+ *        them on crypto_handler and sends back the answers, until the link is closed.
+ *
+ *        The test case passed to crypto_handler has the same buffers and lengths the
+ *        crypto_handler of the capability would be given in process; pointers the link does not
+ *        carry, such as a group handler's tg_ctx, are NULL.
+ *
+ * @param dut A link from acvp_dut_create() on the connection to the host running libacvp.
+ * @param crypto_handler The handler for the capabilities the link was set for, expected to return
+ *        0 on success and 1 for failure as for acvp_cap_*_enable.
+ *
+ * @return ACVP_RESULT, ACVP_SUCCESS once the link is closed between two frames,
+ *         ACVP_TRANSPORT_FAIL if it fails or a frame is malformed
+ */
+ACVP_RESULT acvp_dut_serve(ACVP_DUT *dut, int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_cap_set_dut_handler() has the test cases of a capability run by a remote device
+ *        under test over a link from acvp_dut_create().
+ *
+ *        Up to window test cases of each test group are sent before the first answer is read,
+ *        and more are sent as answers come in, so the round trip to the device is paid once per
+ *        window rather than once per test case. Results are written to the response in test case
+ *        order. The link should be able to buffer a window of frames each way. It carries one test
+ *        group at a time, workers of the session taking turns on it. Links are supported for the
+ *        same capabilities and test types as rings, see acvp_cap_set_ring_handler(); the test
+ *        cases they do not carry still go to the crypto_handler of the capability. The link is
+ *        used over a batch or async handler of the capability, and is not freed with the
+ *        session. Once it has failed, the test groups that would go over it fail as well.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param dut The link, from acvp_dut_create().
+ * @param window The most test cases to have sent and not yet answered. Must be at least 1.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_set_dut_handler(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_DUT *dut, int window);
+
+/**
+ * @brief acvp_cap_set_key_pool() has the keys of an ECDSA KeyGen or safe primes KeyGen capability
+ *        generated ahead of the test cases that ask for them.
+ *
+ *        The library keeps a pool of up to depth keys for every curve and secret generation mode,
+ *        or safe prime group, the capability is registered for, each filled by a thread of its
+ *        own from the time the vector sets of the session are fetched (for a curve, mode or group
+ *        the registration does not have, from its first test group), so the keys are generated
+ *        while the server generates the vectors rather than while the test cases wait on them. A
+ *        KeyGen test case is then given a key from the pool instead of being handed to the
+ *        crypto_handler, waiting only if the pool has run dry. The pools are kept across the
+ *        vector sets of the session and stopped when it is freed.
+ *
+ *        producer is given a KeyGen test case holding only the cipher and the curve and secret
+ *        generation mode (ECDSA) or safe prime group and test type (safe primes), with tc_id 0,
+ *        no tg_ctx or control, and buffers for the key as the crypto_handler would have: d, qx
+ *        and qy, or x and y. It is called from the threads of the pools, concurrently with the
+ *        crypto_handler of any capability. Should it fail, the pool stops and its test cases go
+ *        to the crypto_handler as they would without a pool.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_ECDSA_KEYGEN or ACVP_SAFE_PRIMES_KEYGEN.
+ * @param producer The function generating a key, expected to return 0 on success and 1 for
+ *        failure as a crypto_handler does; NULL to have the crypto_handler of the capability
+ *        generate them.
+ * @param depth The most keys to keep ahead per curve and mode, or group, 1 to 1024. The number of
+ *        test cases the server sends a test group is a good fit.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_set_key_pool(ACVP_CTX *ctx,
+                                  ACVP_CIPHER cipher,
+                                  int (*producer)(ACVP_TEST_CASE *test_case),
+                                  int depth);
+
+/**
+ * @brief acvp_cap_set_group_handler() lets the crypto module set up state once per test group
+ *        instead of once per test case.
+ *
+ *        group_handler is invoked with ACVP_TG_BEGIN before the first test case of each test
+ *        group and with ACVP_TG_END after the last one, or when the group is abandoned on an
+ *        error. It is given a test case holding only what the group has in common: the cipher,
+ *        mode and lengths (for ECDSA, EdDSA and KAS-ECC the curve, hash and the like, for LMS the
+ *        LMS and LM-OTS modes, for KAS-FFC the domain parameters p, q and g, for RSA SigVer the
+ *        public key e and n, for KDF108 the KDF and MAC modes, counter location and lengths,
+ *        for HMAC, CMAC and KMAC the test type, direction and lengths the group has), with tc_id
+ *        0 and no other data buffers. Whatever it stores in tg_ctx at ACVP_TG_BEGIN
+ *        is handed to the crypto_handler in every test case of the group and back to
+ *        group_handler at ACVP_TG_END, where it is to be released. An LMS SigGen module can, for
+ *        example, build the tree of the group's key once and sign every test case with it, a KAS
+ *        module can set up the curve or FFC group once so each test case only does the ephemeral
+ *        work, an RSA SigVer module can import the group's public key once, and a KDF108 module
+ *        can set up the MAC of the group's PRF once and only rekey it for each test case, as can
+ *        an HMAC, CMAC or KMAC module for the MAC itself. For KAS-IFC and KTS-IFC the test cases
+ *        also carry a key_id, which is the same for all test cases of the group using the same
+ *        IUT key, so the module can build that key once and keep it in tg_ctx; HMAC, CMAC and
+ *        KMAC test cases carry one for their key in the same way, so a keyed MAC context can
+ *        just be reset for a test case with the key of the one before.
+ *        Group handlers are supported for the DRBG, ECDSA, EdDSA, HMAC, CMAC, KMAC, KDF108, LMS,
+ *        RSA (SigGen and SigVer), KAS-ECC (CDH, Component and SSC), KAS-FFC (Component and SSC),
+ *        KAS-IFC and KTS-IFC capabilities.
+ *
+ *        The ACVP_CIPHER value passed to this function should already have been setup by
+ *        invoking the enable function for that cipher earlier.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param group_handler Address of function implemented by application that is invoked by libacvp
+ *        at the start and end of each test group. It is expected to return 0 on success and 1
+ *        for failure. A failure at ACVP_TG_BEGIN fails the vector set.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_set_group_handler(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
+                                       int (*group_handler)(ACVP_TEST_CASE *test_case,
+                                                            ACVP_TG_EVENT event));
+
+/**
+ * @brief acvp_cap_hash_enable() allows an application to specify a hash capability to be tested
+ *        by the ACVP server.
+ *
+ *        This function should be called to enable crypto capabilities for hash algorithms that
+ *        will be tested by the ACVP server. This includes SHA-1, SHA-256, SHA-384, etc. This
+ *        function may be called multiple times to specify more than one crypto capability.
+ *
+ *        When the application enables a crypto capability, such as SHA-1, it also needs to specify
+ *        a callback function that will be used by libacvp when that crypto capability is needed
+ *        during a test session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param crypto_handler Address of function implemented by application that is invoked by libacvp
+ *        when the crypto capability is needed during a test session. This crypto_handler function
+ *        is expected to return 0 on success and 1 for failure.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_hash_enable(ACVP_CTX *ctx,
+                                 ACVP_CIPHER cipher,
+                                 int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_cap_hash_set_parm() allows an application to specify operational parameters to be
+ *        used for a given hash alg during a test session with the ACVP server.
+ *
+ *        This function should be called to enable crypto capabilities for hash capabilities that
+ *        will be tested by the ACVP server. This includes SHA-1, SHA-256, SHA-384, etc.
+ *
+ *        This function may be called multiple times to specify more than one crypto parameter
+ *        value for the hash algorithm. The ACVP_CIPHER value passed to this function should
+ *        already have been setup by invoking acvp_enable_hash_cap().
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param param ACVP_HASH_PARM enum value identifying the algorithm parameter that is being
+ *        specified. An example would be a flag indicating if empty input values are allowed.
+ * @param value the value corresponding to the parameter being set
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_hash_set_parm(ACVP_CTX *ctx,
+                                   ACVP_CIPHER cipher,
+                                   ACVP_HASH_PARM param,
+                                   int value);
+
+/**
+ * @brief acvp_cap_hash_set_domain() functions similarly to @ref acvp_cap_hash_set_parm() but uses
+ *        a range of values for certain parameters instead of a single value.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param parm ACVP_HASH_PARM enum value identifying the algorithm parameter that is being
+ *        specified. An example would be message length.
+ * @param min the lower value of the supported range of values
+ * @param max the maximum supported value for the given parameter
+ * @param increment the supported increment for every value in between min and max
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_hash_set_domain(ACVP_CTX *ctx,
+                                     ACVP_CIPHER cipher,
+                                     ACVP_HASH_PARM parm,
+                                     int min,
+                                     int max,
+                                     int increment);
+
+/**
+ * @brief acvp_hash_ldt_next_chunk() hands out the expanded content of a hash large data test
+ *        (LDT) a chunk at a time.
+ *
+ *        The expanded content is \ref ACVP_HASH_TC.msg repeated until it is
+ *        \ref ACVP_HASH_TC.exp_len bytes long, which can be several gigabytes. Instead of building
+ *        all of it, the crypto_handler may call this until it returns a zero chunk_len and feed
+ *        each chunk to its digest, so the test runs in constant memory. Modules that have to show
+ *        a single update call copes with the full length should build the content themselves.
+ *
+ * @param tc The LDT test case given to the crypto_handler.
+ * @param chunk Set to the next chunk. It stays valid until the next call or the handler returns.
+ * @param chunk_len Set to the length (in bytes) of the chunk, 0 once all of the content has been
+ *        handed out.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_hash_ldt_next_chunk(ACVP_HASH_TC *tc,
+                                     const unsigned char **chunk,
+                                     unsigned int *chunk_len);
+
+/**
+ * @brief acvp_hash_ldt_map() gives the expanded content of a hash large data test (LDT) as one
+ *        contiguous buffer, for crypto modules that must take all of it in a single update call.
+ *
+ *        The buffer is read-only and made by mapping the same few megabytes of repeated
+ *        \ref ACVP_HASH_TC.msg over and over, so it costs address space rather than
+ *        \ref ACVP_HASH_TC.exp_len bytes of memory. It stays valid until the handler returns.
+ *        Where mapping is not available the module can fall back to
+ *        acvp_hash_ldt_next_chunk().
+ *
+ * @param tc The LDT test case given to the crypto_handler.
+ * @param data Set to the \ref ACVP_HASH_TC.exp_len bytes of expanded content.
+ *
+ * @return ACVP_RESULT, ACVP_UNSUPPORTED_OP when the buffer could not be mapped
+ */
+ACVP_RESULT acvp_hash_ldt_map(ACVP_HASH_TC *tc, const unsigned char **data);
+
+/**
+ * @brief acvp_cap_hash_set_mct_handler() allows an application to run the inner loop of hash
+ *        Monte Carlo tests itself, instead of libacvp calling the crypto_handler once per digest.
+ *
+ *        The mct_handler is called once per checkpoint (outer iteration) of an MCT with
+ *        \ref ACVP_HASH_TC.test_type set to MCT and the seed in \ref ACVP_HASH_TC.msg and
+ *        \ref ACVP_HASH_TC.msg_len. It computes the 1000 digests of the inner loop as defined for
+ *        the algorithm and leaves the last one in \ref ACVP_HASH_TC.md and
+ *        \ref ACVP_HASH_TC.md_len:
+ *        - SHA-1 and SHA-2: MD[i] = H(M[i-3] || M[i-2] || M[i-1]), with M[0..2] the seed.
+ *        - SHA-3: MD[i] = H(MD[i-1]), with MD[0] the seed.
+ *        - SHAKE: MD[i] = SHAKE(leftmost 128 bits of MD[i-1], zero padded), with MD[0] the seed.
+ *          The first output is \ref ACVP_HASH_TC.xof_len bytes long. Each following length is
+ *          xof_min_len + (rightmost 16 bits of the previous output, big endian, modulo
+ *          (xof_max_len - xof_min_len + 1)). The handler leaves the length for the output after
+ *          the last one in \ref ACVP_HASH_TC.xof_len, for the next checkpoint.
+ *
+ *        libacvp then records the checkpoint and seeds the next one from it. Non-MCT test cases
+ *        still go through the crypto_handler the capability was enabled with.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the hash capability, already enabled.
+ * @param mct_handler Address of function implemented by application. It is expected to return 0
+ *        on success and 1 for failure.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_hash_set_mct_handler(ACVP_CTX *ctx,
+                                          ACVP_CIPHER cipher,
+                                          int (*mct_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_cap_hash_set_mct_loop_handler() allows an application to run the whole of a hash
+ *        Monte Carlo test itself, outer loop included, so libacvp hands it the seed only once.
+ *
+ *        The mct_loop_handler is called once per MCT with \ref ACVP_HASH_TC.test_type set to MCT
+ *        and the seed in \ref ACVP_HASH_TC.msg and \ref ACVP_HASH_TC.msg_len. For SHAKE,
+ *        \ref ACVP_HASH_TC.xof_min_len and \ref ACVP_HASH_TC.xof_max_len hold the output lengths
+ *        of the test group and \ref ACVP_HASH_TC.xof_len the length of the first output. It runs
+ *        the ACVP_HASH_MCT_OUTER checkpoints, each the inner loop described for
+ *        acvp_cap_hash_set_mct_handler() and seeded from the one before it as libacvp would, and
+ *        writes checkpoint i to \ref ACVP_HASH_TC.mct_md + i * \ref ACVP_HASH_TC.mct_md_stride and
+ *        its length to \ref ACVP_HASH_TC.mct_md_len[i]. \ref ACVP_HASH_TC.msg and
+ *        \ref ACVP_HASH_TC.md may be used as scratch space.
+ *
+ *        It takes precedence over the mct_handler of the capability. Non-MCT test cases still go
+ *        through the crypto_handler the capability was enabled with.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the hash capability, already enabled.
+ * @param mct_loop_handler Address of function implemented by application. It is expected to
+ *        return 0 on success and 1 for failure.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_hash_set_mct_loop_handler(ACVP_CTX *ctx,
+                                               ACVP_CIPHER cipher,
+                                               int (*mct_loop_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_cap_hash_set_soa_handler() allows an application to have the AFT test groups of a
+ *        SHA-1, SHA-2 or SHA-3 capability handed to the crypto module as one array of messages,
+ *        along with their lengths, rather than one ACVP_HASH_TC at a time.
+ *
+ *        This is meant for multi-buffer hashing engines that fill their lanes from many
+ *        independent messages. The digests the module writes are put back into the response of
+ *        each test case. Other test types still go to the batch handler of the capability if it
+ *        has one, and its crypto_handler otherwise.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the hash capability, already enabled.
+ * @param soa_handler Address of function implemented by application that is invoked by libacvp
+ *        with the messages of a test group. For each message it sets results[i] to what the
+ *        crypto_handler would have returned for it. It is expected to return 0 on success and 1
+ *        if the group as a whole failed.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_hash_set_soa_handler(ACVP_CTX *ctx,
+                                          ACVP_CIPHER cipher,
+                                          int (*soa_handler)(ACVP_HASH_SOA *group, int *results));
+
+/**
+ * @brief acvp_enable_drbg_cap() allows an application to specify a hash capability to be tested by
+ *        the ACVP server.
+ *
+ *        This function should be called to enable crypto capabilities for drbg algorithms that
+ *        will be tested by the ACVP server. This includes HASHDRBG, HMACDRBG, CTRDRBG. This
+ *        function may be called multiple times to specify more than one crypto capability.
+ *
+ *        When the application enables a crypto capability, such as ACVP_HASHDRBG, it also needs to
+ *        specify a callback function that will be used by libacvp when that crypto capability is
+ *        needed during a test session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param crypto_handler Address of function implemented by application that is invoked by libacvp
+ *        when the crypto capability is needed during a test session. This crypto_handler function
+ *        is expected to return 0 on success and 1 for failure.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_drbg_enable(ACVP_CTX *ctx,
+                                 ACVP_CIPHER cipher,
+                                 int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_cap_drbg_set_parm() allows an application to specify operational parameters to be
+ *        used for a given DRBG alg during a test session with the ACVP server.
+ *
+ *        This function should be called to enable crypto capabilities for hash capabilities that
+ *        will be tested by the ACVP server. This includes HASHDRBG, HMACDRBG, CTRDRBG. This
+ *        function may be called multiple times to specify more than one crypto capability.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param mode ACVP_DRBG_MODE enum value specifying mode. An example would be ACVP_DRBG_SHA_1
+ * @param group The group of capabilities for the given ACVP DRBG modes. Different groups can be
+ *        defined for different capabilities; e.g. different lengths can be supported with and
+ *        without derivation function support. Groups must be used in a linear fashion (group 0
+ *        must be defined before you can define group 1, group 1 before group 2, etc)
+ * @param param ACVP_DRBG_PARM enum value identifying the algorithm parameter that is being
+ *        specified. An example would be prediction resistance.
+ * @param value the value corresponding to the parameter being set
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_drbg_set_parm(ACVP_CTX *ctx,
+                                   ACVP_CIPHER cipher,
+                                   ACVP_DRBG_MODE mode,
+                                   int group,
+                                   ACVP_DRBG_PARM param,
+                                   int value);
+
+/**
+ * @brief acvp_enable_drbg_length_cap() allows an application to register a DRBG capability
+ *        length-based paramter.
+ *
+ *        This function should be used to register a length-based parameter for a DRBG capability.
+ *        An example would be entropy, nonce, perso where a minimum, step, and maximum can be
+ *        specified.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param mode ACVP_DRBG_MODE enum value specifying mode. An example would be ACVP_DRBG_SHA_1
+ * @param group The group of capabilities for the given ACVP DRBG modes. Different groups can be
+ *        defined for different capabilities; e.g. different lengths can be supported with and
+ *        without derivation function support. Groups must be used in a linear fashion (group 0
+ *        must be defined before you can define group 1, group 1 before group 2, etc)
+ * @param param ACVP_DRBG_PARM enum value specifying paramter. An example would be
+ *        ACVP_DRBG_ENTROPY_LEN
+ * @param min minimum value
+ * @param step increment value
+ * @param max maximum value
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_drbg_set_length(ACVP_CTX *ctx,
+                                     ACVP_CIPHER cipher,
+                                     ACVP_DRBG_MODE mode,
+                                     int group,
+                                     ACVP_DRBG_PARM param,
+                                     int min,
+                                     int step,
+                                     int max);
+
+/**
+ * @brief acvp_enable_dsa_cap()
+ *        This function should be used to enable DSA capabilities. Specific modes and parameters
+ *        can use acvp_cap_dsa_set_parm.
+ *
+ *        When the application enables a crypto capability, such as DSA, it also needs to specify a
+ *        callback function that will be used by libacvp when that crypto capability is needed
+ *        during a test session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param crypto_handler Address of function implemented by application that is invoked by libacvp
+ *        when the crypto capability is needed during a test session. This crypto_handler function
+ *        is expected to return 0 on success and 1 for failure.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_dsa_enable(ACVP_CTX *ctx,
+                                ACVP_CIPHER cipher,
+                                int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_cap_dsa_set_parm() allows an application to specify operational parameters to be
+ *        used for a given dsa alg during a test session with the ACVP server. This function
+ *        should be called to enable crypto capabilities for DSA modes and functions. It may be
+ *        called multiple times to specify more than one crypto capability.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param mode ACVP_DSA_MODE enum value specifying mode. An example would be ACVP_DSA_MODE_PQGGEN
+ * @param param ACVP_DSA_PARM enum value identifying the algorithm parameter that is being
+ *        specified. An example would be ACVP_DSA_GENPQ.
+ * @param value the value corresponding to the parameter being set
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_dsa_set_parm(ACVP_CTX *ctx,
+                                  ACVP_CIPHER cipher,
+                                  ACVP_DSA_MODE mode,
+                                  ACVP_DSA_PARM param,
+                                  int value);
+
+/**
+ * @brief acvp_enable_kas_ecc_cap()
+ *        This function should be used to enable KAS-ECC capabilities. Specific modes and
+ *        parameters can use acvp_cap_kas_ecc_set_parm.
+ *
+ *        When the application enables a crypto capability, such as KAS-ECC, it also needs to
+ *        specify a callback function that will be used by libacvp when that crypto capability is
+ *        needed during a test session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param crypto_handler Address of function implemented by application that is invoked by libacvp
+ *        when the crypto capability is needed during a test session. This crypto_handler function
+ *        is expected to return 0 on success and 1 for failure.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_kas_ecc_enable(ACVP_CTX *ctx,
+                                    ACVP_CIPHER cipher,
+                                    int (*crypto_handler)(ACVP_TEST_CASE *test_case));
+
+/**
+ * @brief acvp_enable_kas_ecc_prereq_cap() allows an application to specify a prerequisite
+ *        algorithm for a given KAS-ECC mode during a test session with the ACVP server. This
+ *        function should be called to enable a prerequisite for an KAS-ECC mode capability that
+ *        will be tested by the server.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher ACVP_CIPHER enum value identifying the crypto capability.
+ * @param mode ACVP_KAS_ECC_MODE enum value specifying mode. An example would be
+ *        ACVP_KAS_ECC_MODE_PARTIAL
+ * @param pre_req ACVP_PREREQ_ALG enum that the specified cipher/mode depends on
+ * @param value "same" or number
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_kas_ecc_set_prereq(ACVP_CTX *ctx,
+                                        ACVP_CIPHER cipher,
+                                        ACVP_KAS_ECC_MODE mode,
+                                        ACVP_PREREQ_ALG pre_req,
+                                        char *value);
+
+/**
+ * @brief acvp_cap_kas_ecc_set_parm() allows an application to specify operational parameters to
  *        be used for a given kas-ecc alg during a test session with the ACVP server. This function
  *        should be called to enable crypto capabilities for KAS-ECC modes and functions. It may be
  *        called multiple times to specify more than one crypto capability.
@@ -3520,6 +4508,29 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_exponent(ACVP_CTX *ctx,
                                              ACVP_RSA_PARM param,
                                              char *value);
 
+/**
+ * @brief acvp_cap_rsa_sigver_set_soa_handler() allows an application to have the test groups of
+ *        the RSA SigVer capability handed to the crypto module as one public key and arrays of
+ *        messages and signatures, rather than one ACVP_RSA_SIG_TC at a time.
+ *
+ *        This is meant for multi-buffer RSA implementations that verify many signatures against
+ *        the same key. What the test cases of a group share, such as the key, the hash and the
+ *        padding, is given once, and the per test case values are packed so the module walks
+ *        them in order. The dispositions the module sets are put back into the response of each
+ *        test case. The SoA handler is used over a batch handler of the capability.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param soa_handler Address of function implemented by application that is invoked by libacvp
+ *        with the test cases of a test group. For each test case it sets results[i] to what the
+ *        crypto_handler would have returned for it. It is expected to return 0 on success and 1
+ *        if the group as a whole failed.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_rsa_sigver_set_soa_handler(ACVP_CTX *ctx,
+                                                int (*soa_handler)(ACVP_RSA_SIGVER_SOA *group,
+                                                                   int *results));
+
 /**
  * @brief acvp_cap_rsa_keygen_set_primes() allows an application to specify RSA key generation
  *        provable or probable primes parameters for use during a test session with the ACVP
@@ -3726,6 +4737,27 @@ ACVP_RESULT acvp_cap_kmac_set_domain(ACVP_CTX *ctx,
                                      int max,
                                      int increment);
 
+/**
+ * @brief acvp_cap_set_parms() sets the parameters of a table of entries, each of which stands
+ *        for one call to the set_parm or set_domain function of a symmetric cipher, hash, HMAC,
+ *        CMAC or KMAC capability. It is meant for applications that describe their capabilities
+ *        with a static table instead of a long sequence of calls.
+ *
+ *        The whole table is checked before any entry is applied: every cipher must already have
+ *        been enabled, with a capability of the type its kind sets. The entries are then applied
+ *        in order, with the same checks of their values as the individual functions make;
+ *        the entries before one that is rejected remain applied.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param table The entries to apply.
+ * @param count The number of entries in table.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_cap_set_parms(ACVP_CTX *ctx,
+                               const ACVP_CAP_PARM_ENTRY *table,
+                               int count);
+
 
 /**
  * @brief acvp_cap_kdf135_*_enable() allows an application to specify a kdf cipher capability to be
@@ -4332,6 +5364,21 @@ ACVP_RESULT acvp_create_test_session(ACVP_CTX **ctx,
  */
 ACVP_RESULT acvp_free_test_session(ACVP_CTX *ctx);
 
+/**
+ * @brief acvp_reset_session() clears the state a test session leaves in an ACVP_CTX, so the
+ *        context can be used for another test session. The URL, access token, vector set list
+ *        and registration of the previous session are dropped, while the capabilities, the
+ *        operating environment data, the server and TLS settings and the open connection to the
+ *        server are kept, so the next session can be started with acvp_run() right away.
+ *
+ *        acvp_free_test_session() still needs to be called once the context is no longer needed.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_reset_session(ACVP_CTX *ctx);
+
 /**
  * @brief acvp_set_server() specifies the ACVP server and TCP port number to use when contacting
  *        the server. This function is used to specify the hostname or IP address of the ACVP
@@ -4345,6 +5392,23 @@ ACVP_RESULT acvp_free_test_session(ACVP_CTX *ctx);
  */
 ACVP_RESULT acvp_set_server(ACVP_CTX *ctx, const char *server_name, int port);
 
+/**
+ * @brief acvp_preconnect() resolves the server name and opens the TLS connection to the server
+ *        on a thread of its own, so that the DNS lookup and handshakes are done while the
+ *        application goes on to register its capabilities rather than ahead of the login. The
+ *        login, and any other request, waits for it to finish and then uses the connection; later
+ *        connections, those of the parallel vector sets included, use the resolved address and
+ *        resume the TLS session. A pre-connect that fails is only logged. Call this once the
+ *        server and the TLS settings (acvp_set_cacerts(), acvp_set_certkey()) are set; changing
+ *        them again waits for the pre-connect first. Not available with murl or in offline
+ *        builds.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ *
+ * @return ACVP_RESULT, ACVP_UNSUPPORTED_OP when this build can not pre-connect
+ */
+ACVP_RESULT acvp_preconnect(ACVP_CTX *ctx);
+
 /**
  * @brief acvp_set_path_segment() specifies the URI prefix used by the ACVP server. Some ACVP
  *        servers use a prefix in the URI for the path to the ACVP REST interface. Calling this
@@ -4387,105 +5451,712 @@ ACVP_RESULT acvp_set_api_context(ACVP_CTX *ctx, const char *api_context);
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_set_cacerts(ACVP_CTX *ctx, const char *ca_file);
+ACVP_RESULT acvp_set_cacerts(ACVP_CTX *ctx, const char *ca_file);
+
+/**
+ * @brief acvp_set_certkey() specifies PEM encoded certificate and private key to use for
+ *        establishing the TLS session with the ACVP server. ACVP uses TLS as the transport. In
+ *        order for the ACVP server to verify the identity the DUT using libacvp, a certificate
+ *        needs to be presented during the TLS handshake. The certificate used by libacvp needs to
+ *        be trusted by the ACVP server. Otherwise the TLS handshake will fail.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cert_file Name of file containing the PEM encoded X.509 certificate to use as the client
+ *        identity.
+ * @param key_file Name of file containing PEM encoded private key associated with the client
+ *        certificate.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_certkey(ACVP_CTX *ctx, char *cert_file, char *key_file);
+
+/**
+ * @brief acvp_mark_as_sample() marks the registration as a sample. This function sets a flag that
+ *        will allow the client to retrieve the correct answers later on, allowing for comparison
+ *        and debugging.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_mark_as_sample(ACVP_CTX *ctx);
+
+/**
+ * @brief acvp_mark_as_request_only() marks the registration as a request only. This function sets
+ *         a flag that will allow the client to retrieve the vectors from the server and store them
+ *         in a file for later use.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param filename Name of the file to be used for the request vectors
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_mark_as_request_only(ACVP_CTX *ctx, char *filename);
+
+/**
+ * @brief acvp_set_vector_req_compact() selects whether the vector sets of a request only session
+ *        are saved as compact JSON rather than pretty printed. Compact files are smaller and faster
+ *        to write; both forms can be read back by acvp_run_vectors_from_file().
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param compact 1 to save compact JSON, 0 to pretty print (the default)
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_vector_req_compact(ACVP_CTX *ctx, int compact);
+
+/**
+ * @brief acvp_set_vector_rsp_compact() selects whether the responses acvp_run_vectors_from_file()
+ *        writes to the vector response file are compact JSON rather than pretty printed. Responses
+ *        are streamed to the file as they are serialized either way; both forms can be uploaded by
+ *        acvp_upload_vectors_from_file().
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param compact 1 to save compact JSON, 0 to pretty print (the default)
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_vector_rsp_compact(ACVP_CTX *ctx, int compact);
+
+/**
+ * @brief acvp_mark_as_get_only() marks the operation as a GET only. This function will take the
+ *        string parameter and perform a GET to check the get of a specific request. The request ID
+ *        must be part of the string.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param string used for the get, such as '/acvp/v1/requests/383'
+ * @param save_filename an optional parameter that results in the GET output being saved to a file
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_mark_as_get_only(ACVP_CTX *ctx, char *string, const char *save_filename);
+
+/**
+ * @brief acvp_mark_as_post_only() marks the operation as a POST only. This function will take the
+ *        filename and perform a POST of the data in the file to the URL
+ *        /acvp/v1/(first field in file)
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param filename file containing URL and content to POST
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_mark_as_post_only(ACVP_CTX *ctx, char *filename);
+
+/**
+ * @brief acvp_mark_as_delete only() marks the operation as a DELETE only. This function will
+ *        perform an HTTP DELETE call on the resource at the givenURL.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param request_url url of resource to delete
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_mark_as_delete_only(ACVP_CTX *ctx, char *request_url);
+
+/**
+ * @brief acvp_mark_as_put_after_test() will attempt to PUT the given file (with the URL inside)
+ *        at the conclusion of a test session run with the given CTX.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param filename the path to the file to PUT after the test session
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_mark_as_put_after_test(ACVP_CTX *ctx, char *filename);
+
+/**
+ * @brief acvp_get_vector_set_count will return the number of vector sets that are expected based on the current
+ * registration. This should be seen as a close estimate not an exact number, as different ACVP servers could
+ * possibly have different behaviors.
+ *
+ * @param ctx Pointer to ACVP_CTX with registered algorithms
+ *
+ * @return Count of expected vector sets
+ */
+int acvp_get_vector_set_count(ACVP_CTX *ctx);
+
+/**
+ * @brief acvp_set_max_parallel_vector_sets() sets the number of vector sets libacvp may download,
+ *        process and submit concurrently during a test session, or process concurrently in
+ *        acvp_run_vectors_from_file(). Each vector set is handled by its own worker thread, while
+ *        results and any saved request or response file keep the same per-vsId content and
+ *        ordering as a serial run. The default of 1 processes vector sets serially.
+ *        When a value greater than 1 is used, the crypto handlers registered by the application
+ *        may be invoked from multiple threads at once and must be reentrant.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param max_parallel Maximum number of vector sets to process at once, between 1 and 64.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_max_parallel_vector_sets(ACVP_CTX *ctx, int max_parallel);
+
+/**
+ * @brief acvp_set_test_case_cost() tells libacvp how long a test case of cipher takes, in place
+ *        of its built-in estimate. When the vector sets of acvp_run_vectors_from_file() are shared
+ *        among several workers, see acvp_set_max_parallel_vector_sets(), the ones expected to take
+ *        longest are started first, so a slow vector set (RSA KeyGen, DSA PQGGen, LMS, TDES
+ *        Monte Carlo tests) does not start last and hold up the end of the run. A vector set is
+ *        estimated from its test groups: the number of tests, the cost per test case of the
+ *        cipher, scaled with the cube of the modulus for groups that give one, or the number of
+ *        iterations for Monte Carlo tests. Timings reported to the metrics callback by an earlier
+ *        run, see acvp_set_metrics_cb(), divided by the number of test cases, make a good cost.
+ *        The vector sets of a test session are only known once downloaded, so they are processed
+ *        in the order the server lists them.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher The cipher the cost is for
+ * @param ns Nanoseconds a test case takes, 0 to go back to the built-in estimate
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_test_case_cost(ACVP_CTX *ctx, ACVP_CIPHER cipher, unsigned long long int ns);
+
+/**
+ * @struct ACVP_VS_ESTIMATE
+ * @brief What acvp_estimate_vector_sets() expects of one vector set of the registration
+ */
+typedef struct acvp_vs_estimate_t {
+    ACVP_CIPHER cipher;
+    const char *algorithm;         /**< Name of the algorithm, as registered */
+    const char *mode;              /**< Its mode, NULL if it has none */
+    int test_cases;                /**< Test cases expected */
+    unsigned long long int ns;     /**< Nanoseconds expected to process them */
+    size_t bytes;                  /**< Bytes expected to be held while they are processed */
+    int worker;                    /**< Worker it is scheduled on, from 0 */
+    unsigned long long int start_ns; /**< When that worker is expected to start it */
+    int critical;                  /**< 1 if on the worker that finishes last, the critical path */
+} ACVP_VS_ESTIMATE;
+
+/**
+ * @struct ACVP_RUN_ESTIMATE
+ * @brief What acvp_estimate_vector_sets() expects of the registration as a whole
+ */
+typedef struct acvp_run_estimate_t {
+    int parallel;                  /**< Workers the vector sets were scheduled on */
+    unsigned long long int total_ns; /**< Nanoseconds of all the vector sets, one after the other */
+    unsigned long long int wall_ns;  /**< Nanoseconds until the last worker is done, the critical path */
+    size_t peak_bytes;             /**< Most bytes expected to be held by the vector sets running at once */
+} ACVP_RUN_ESTIMATE;
+
+/**
+ * @brief acvp_estimate_vector_sets() predicts, before anything is sent to the server, how long
+ *        each vector set of the current registration will take to process and how much memory it
+ *        will hold, and how long the whole run will take with parallel workers, see
+ *        acvp_set_max_parallel_vector_sets(). The vector sets are those counted by
+ *        acvp_get_vector_set_count(), in the order the algorithms were registered.
+ *
+ *        The test groups and test cases are decided by the server, so each vector set is
+ *        estimated from its registered parameters: a test group for each key size and direction,
+ *        with a Monte Carlo test where the mode has one; a large data test for each size registered
+ *        for a hash; the modulus of RSA, scaled as its cube; the curves of ECDSA; and the iteration
+ *        counts of PBKDF. Each test case costs what acvp_set_test_case_cost() was given for the
+ *        cipher, or the built-in estimate. Timings from the metrics callback of an earlier run, see
+ *        acvp_set_metrics_cb(), divided by the number of test cases, make the prediction match the
+ *        module and machine the lab uses.
+ *
+ *        The vector sets are scheduled longest first onto whichever worker is free soonest, as
+ *        acvp_run_vectors_from_file() does. The ones on the worker that finishes last are marked
+ *        critical; their total is the wall time of the run.
+ *
+ * @param ctx Pointer to ACVP_CTX with registered algorithms
+ * @param parallel Number of workers to schedule on, 0 for the one given to
+ *        acvp_set_max_parallel_vector_sets()
+ * @param est Filled in with the first max vector sets, may be NULL when max is 0
+ * @param max Number of entries est has room for
+ * @param count Set to the number of vector sets, which may be more than max
+ * @param run Filled in with the totals of the run, may be NULL
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_estimate_vector_sets(ACVP_CTX *ctx, int parallel, ACVP_VS_ESTIMATE *est, int max,
+                                      int *count, ACVP_RUN_ESTIMATE *run);
+
+/**
+ * @brief acvp_set_max_parallel_test_cases() sets the number of threads the independent test cases
+ *        of a test group may be spread across. libacvp still parses the test group and writes the
+ *        responses on one thread and in test case order; only the calls to the crypto handler run
+ *        in parallel. Monte Carlo tests are always run serially. This applies to the AES, hash,
+ *        HMAC, RSA KeyGen and LMS SigVer capabilities, and not to capabilities given a batch or async
+ *        handler.
+ *        The default of 1 runs test cases serially.
+ *        When a value greater than 1 is used, the crypto handlers registered by the application
+ *        may be invoked from multiple threads at once and must be reentrant.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param max_parallel Maximum number of threads per test group, between 1 and 64.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_max_parallel_test_cases(ACVP_CTX *ctx, int max_parallel);
+
+/**
+ * @enum ACVP_AFFINITY
+ * @brief How the threads libacvp starts to process vector sets are placed, see
+ *        acvp_set_worker_affinity().
+ */
+typedef enum acvp_affinity {
+    ACVP_AFFINITY_NONE = 0, /**< Left to the operating system */
+    ACVP_AFFINITY_CPUS,     /**< Pinned to the CPUs given */
+    ACVP_AFFINITY_NUMA      /**< Pinned to the CPUs of one of the NUMA nodes given */
+} ACVP_AFFINITY;
+
+/**
+ * @brief acvp_set_worker_affinity() pins the worker threads of acvp_set_max_parallel_vector_sets(),
+ *        and the test case threads of acvp_set_max_parallel_test_cases() they start, so the
+ *        buffers and Monte Carlo state of a vector set stay in the caches, and on the NUMA node,
+ *        of the CPUs processing it. With ACVP_AFFINITY_CPUS the CPUs given are split evenly among
+ *        the workers, each worker sharing its CPUs with its test case threads. With
+ *        ACVP_AFFINITY_NUMA the workers are spread round robin across the NUMA nodes given, or all
+ *        of them if none are, each worker and its test case threads running on the CPUs of its
+ *        node. The memory a worker allocates is first touched on its node, and an idle worker
+ *        helps with the test cases of the workers on its own node before those of other nodes.
+ *        A thread that can not be pinned runs where the operating system puts it. The thread
+ *        that calls libacvp is never pinned.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param policy How to place the threads, ACVP_AFFINITY_NONE to stop pinning them
+ * @param ids The CPUs for ACVP_AFFINITY_CPUS, the NUMA nodes for ACVP_AFFINITY_NUMA, numbered
+ *        from 0 as the operating system numbers them. The list is copied.
+ * @param count Number of ids, up to 1024; may be 0 for ACVP_AFFINITY_NUMA
+ *
+ * @return ACVP_RESULT, ACVP_UNSUPPORTED_OP on platforms threads can not be pinned on
+ */
+ACVP_RESULT acvp_set_worker_affinity(ACVP_CTX *ctx, ACVP_AFFINITY policy, const int *ids, int count);
+
+/**
+ * @enum ACVP_METRICS_PHASE
+ * @brief The phases the time spent on a vector set is broken into by the metrics callback.
+ *        ACVP_METRICS_PARSE is turning the downloaded vector set into JSON,
+ *        ACVP_METRICS_CRYPTO is time spent in the crypto handlers of the module,
+ *        ACVP_METRICS_OUTPUT is the rest of the time in the KAT handler of the algorithm (reading
+ *        the test cases and building the responses), ACVP_METRICS_SERIALIZE is writing the
+ *        responses out as JSON text, and ACVP_METRICS_TRANSPORT is time spent talking to the server.
+ */
+typedef enum acvp_metrics_phase {
+    ACVP_METRICS_PARSE = 0,
+    ACVP_METRICS_CRYPTO,
+    ACVP_METRICS_OUTPUT,
+    ACVP_METRICS_SERIALIZE,
+    ACVP_METRICS_TRANSPORT,
+    ACVP_METRICS_PHASE_MAX
+} ACVP_METRICS_PHASE;
+
+/**
+ * @struct ACVP_METRICS
+ * @brief Timings reported by the metrics callback, for a vector set as a whole (tg_id is 0) or
+ *        for one of its test groups. Only the crypto and output phases are kept per test group.
+ *        The memory figures are as of the report, over the vector set so far.
+ */
+typedef struct acvp_metrics_t {
+    int vs_id;
+    int tg_id;                 /**< 0 for the totals of the vector set */
+    unsigned long long int ns[ACVP_METRICS_PHASE_MAX]; /**< Nanoseconds spent in each phase */
+    unsigned int crypto_calls; /**< Number of calls made into the crypto module */
+    size_t mem_current;        /**< Bytes held by the context processing the vector set, see acvp_get_memory_usage() */
+    size_t mem_peak;           /**< Most bytes it held since the vector set was started */
+} ACVP_METRICS;
+
+/**
+ * @brief acvp_set_metrics_cb() registers a callback that is given the time spent on each vector
+ *        set, broken down by ACVP_METRICS_PHASE. It is called once for each test group as the
+ *        KAT handler finishes with it, then once for the vector set as a whole when it has been
+ *        submitted (or written to the response file). No timing is done while no callback is
+ *        set. With acvp_set_max_parallel_vector_sets() above 1 the callback may be invoked from
+ *        several threads at once.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param metrics_cb The callback, or NULL to stop reporting.
+ * @param arg Passed back to the callback as is.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_metrics_cb(ACVP_CTX *ctx, void (*metrics_cb)(const ACVP_METRICS *metrics, void *arg), void *arg);
+
+/**
+ * @enum ACVP_EVENT_TYPE
+ * @brief What an ACVP_EVENT reports
+ */
+typedef enum acvp_event_type {
+    ACVP_EVENT_VS_START = 1, /**< Processing of a vector set is starting */
+    ACVP_EVENT_VS_DONE,      /**< A vector set is done, and submitted or written to file */
+    ACVP_EVENT_TG_DONE,      /**< A test group of the vector set is done */
+    ACVP_EVENT_TRANSFER,     /**< A request to the server has completed */
+    ACVP_EVENT_RETRY_WAIT    /**< The server asked us to wait before asking again */
+} ACVP_EVENT_TYPE;
+
+/**
+ * @struct ACVP_EVENT
+ * @brief A progress event, as given to the callback of acvp_set_event_cb(). Fields that do not
+ *        apply to the type of the event are 0.
+ */
+typedef struct acvp_event_t {
+    ACVP_EVENT_TYPE type;
+    int vs_id;               /**< 0 for a transfer or wait that is not about a vector set in progress */
+    int tg_id;               /**< ACVP_EVENT_TG_DONE: the test group done */
+    int tg_done;             /**< Test groups of the vector set done so far */
+    int tg_cnt;              /**< Test groups of the vector set to run */
+    ACVP_RESULT result;      /**< ACVP_EVENT_VS_DONE, ACVP_EVENT_TRANSFER: how it went */
+    int http_status;         /**< ACVP_EVENT_TRANSFER: HTTP status of the response */
+    const char *url;         /**< ACVP_EVENT_TRANSFER: only valid during the callback */
+    size_t bytes_in;         /**< ACVP_EVENT_TRANSFER: bytes received */
+    size_t bytes_out;        /**< ACVP_EVENT_TRANSFER: bytes sent */
+    int wait_seconds;        /**< ACVP_EVENT_RETRY_WAIT: how long until we ask again */
+    unsigned long long int elapsed_ns; /**< Time taken by the vector set, test group or request */
+    unsigned long long int time_ns;    /**< When the event happened, on a monotonic clock */
+} ACVP_EVENT;
+
+/**
+ * @brief acvp_set_event_cb() registers a callback that is given typed progress events, as an
+ *        alternative to parsing the messages given to the logging callback: the start and end
+ *        of each vector set, each test group as it is done, each request to the server with
+ *        the bytes transferred, and each wait the server asks for. Nothing is formatted for the
+ *        events, and they cost nothing while no callback is set. With
+ *        acvp_set_max_parallel_vector_sets() above 1 the callback may be invoked from several
+ *        threads at once.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param event_cb The callback, or NULL to stop reporting.
+ * @param arg Passed back to the callback as is.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_event_cb(ACVP_CTX *ctx, void (*event_cb)(const ACVP_EVENT *event, void *arg), void *arg);
+
+/**
+ * @brief The most test cases of each vector set acvp_set_crypto_latency() may keep as the slowest
+ */
+#define ACVP_LAT_SLOWEST_MAX 32
+
+/**
+ * @struct ACVP_LATENCY
+ * @brief The latency of the crypto handler of an algorithm, as given by
+ *        acvp_get_crypto_latency(). The percentiles are to within 1/16 of their value.
+ */
+typedef struct acvp_latency_t {
+    unsigned long long int count;   /**< Test cases timed */
+    unsigned long long int min_ns;
+    unsigned long long int max_ns;
+    unsigned long long int mean_ns;
+    unsigned long long int p50_ns;
+    unsigned long long int p90_ns;
+    unsigned long long int p99_ns;
+    unsigned long long int p999_ns;
+} ACVP_LATENCY;
+
+/**
+ * @brief acvp_set_crypto_latency() times each call into the crypto handlers and keeps a latency
+ *        histogram for each algorithm, over the life of the context, for acvp_get_crypto_latency()
+ *        to report on; an algorithm that has become much slower then shows up before sessions
+ *        start timing out. The test cases of a batch handler are each counted as the average of
+ *        their batch.
+ *
+ *        With slowest above 0 the tgId and tcId of the slowest test cases of each vector set are
+ *        kept as well, and added to the session info file under "slowestTestCases" once the
+ *        vector sets have been processed. Test cases of KAS and KTS carry no tcId, 0 is given
+ *        for them.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param enable 1 to time the crypto handlers, 0 to stop
+ * @param slowest How many of the slowest test cases of each vector set to keep, up to
+ *        ACVP_LAT_SLOWEST_MAX; 0 for none
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_crypto_latency(ACVP_CTX *ctx, int enable, int slowest);
+
+/**
+ * @brief acvp_get_crypto_latency() gives the latency of the crypto handler of an algorithm over
+ *        the vector sets done so far, see acvp_set_crypto_latency(). The count is 0 for an
+ *        algorithm that has not been timed.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cipher The algorithm
+ * @param latency Filled in with the latency
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_get_crypto_latency(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_LATENCY *latency);
+
+/**
+ * @brief acvp_set_adaptive_transfers() has the requests the session makes to the server, from
+ *        all of its threads, limited to a number that is tuned as they go: raised while doing so
+ *        brings more throughput, lowered when latency climbs, and halved on a 429 or 5xx
+ *        response. Without it each thread makes its requests as soon as it has them. Logins
+ *        are never held back. Set before acvp_process_tests() is called.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param enable 1 to enable, 0 to disable
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_adaptive_transfers(ACVP_CTX *ctx, int enable);
+
+/**
+ * @brief acvp_get_transfer_limit() gives the number of requests the session may have out at
+ *        once at the moment, see acvp_set_adaptive_transfers(); 0 when it is not enabled.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ *
+ * @return The limit
+ */
+int acvp_get_transfer_limit(ACVP_CTX *ctx);
+
+/**
+ * @brief acvp_set_request_timeout() limits how long each GET the session sends to the server
+ *        (vector sets, their results, the status of the session) may take, from connecting to
+ *        the last byte of the response. A GET that runs past it is given up on and sent once
+ *        more, on a new connection, so that one stalled connection does not hold the session
+ *        up. Uploads are not limited, as the server may already have taken what was sent.
+ *        Without it the defaults of libcurl apply. Needs libcurl.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param timeout_ms Milliseconds a GET may take, 0 for no limit
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_request_timeout(ACVP_CTX *ctx, int timeout_ms);
+
+/**
+ * @brief acvp_set_hedged_requests() has a GET the session sends to the server sent a second
+ *        time, on another connection, when the server has not started to answer it within the
+ *        95th percentile of the time recent GETs took to start being answered (and never within
+ *        10 ms); whichever answer comes in first is taken. This cuts the tail latency of a slow
+ *        proxy or server for about 5% more requests. Hedging starts once 8 GETs have been seen.
+ *        Needs libcurl.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param enable 1 to enable, 0 to disable
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_hedged_requests(ACVP_CTX *ctx, int enable);
+
+/**
+ * @brief acvp_get_hedge_delay() gives how long a GET may go unanswered at the moment before it
+ *        is sent again, see acvp_set_hedged_requests(); 0 when it is not enabled or too few GETs
+ *        have been seen yet.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ *
+ * @return The delay in milliseconds
+ */
+int acvp_get_hedge_delay(ACVP_CTX *ctx);
+
+/**
+ * @enum ACVP_SPAN_TYPE
+ * @brief What an ACVP_SPAN covers
+ */
+typedef enum acvp_span_type {
+    ACVP_SPAN_TRANSPORT = 1, /**< A request to the server, with any resends after a JWT refresh */
+    ACVP_SPAN_PARSE,         /**< Turning a downloaded vector set into JSON */
+    ACVP_SPAN_DISPATCH,      /**< Finding the KAT handler of a vector set and running it */
+    ACVP_SPAN_KAT_HANDLER,   /**< The KAT handler of the algorithm, inside ACVP_SPAN_DISPATCH */
+    ACVP_SPAN_TEST_GROUP     /**< One test group, inside ACVP_SPAN_KAT_HANDLER */
+} ACVP_SPAN_TYPE;
+
+/**
+ * @struct ACVP_SPAN
+ * @brief A trace span, as given to the callbacks of acvp_set_trace_cb(). The ids and times are
+ *        those of an OpenTelemetry span, the rest its attributes. Fields that do not apply to the
+ *        type of the span are 0; the strings are only valid during the callback.
+ */
+typedef struct acvp_span_t {
+    ACVP_SPAN_TYPE type;
+    const char *name;                  /**< Name for the span, such as "acvp.transport" */
+    unsigned long long int span_id;    /**< Never 0, unique within the process */
+    unsigned long long int parent_id;  /**< The span this one is inside of, 0 if none */
+    unsigned long long int start_ns;   /**< When the span started, on a monotonic clock */
+    unsigned long long int end_ns;     /**< When it ended; 0 in the start callback */
+    int vs_id;                         /**< The vector set being processed, if any */
+    int tg_id;                         /**< ACVP_SPAN_TEST_GROUP: the test group */
+    const char *algorithm;             /**< ACVP_SPAN_DISPATCH, ACVP_SPAN_KAT_HANDLER */
+    const char *mode;                  /**< ACVP_SPAN_DISPATCH, ACVP_SPAN_KAT_HANDLER, if it has one */
+    const char *action;                /**< ACVP_SPAN_TRANSPORT: the kind of request, such as "GET_VS" */
+    const char *url;                   /**< ACVP_SPAN_TRANSPORT */
+    size_t bytes_in;                   /**< ACVP_SPAN_TRANSPORT, ACVP_SPAN_PARSE: bytes received or parsed */
+    size_t bytes_out;                  /**< ACVP_SPAN_TRANSPORT: bytes sent */
+    int http_status;                   /**< ACVP_SPAN_TRANSPORT: HTTP status of the response */
+    int retries;                       /**< ACVP_SPAN_TRANSPORT: times the request was sent again */
+    ACVP_RESULT result;                /**< How it went; set in the end callback */
+} ACVP_SPAN;
+
+/**
+ * @brief acvp_set_trace_cb() registers callbacks that are given a span as it starts and as it
+ *        ends, around each request to the server, the parsing of each vector set, its dispatch
+ *        to the KAT handler and each of its test groups, for them to be passed on to an
+ *        OpenTelemetry collector. Spans are only made while an end callback is set. With
+ *        acvp_set_max_parallel_vector_sets() above 1 the callbacks may be invoked from several
+ *        threads at once; the spans of a vector set all come from the same thread.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param start_cb Called as a span starts, may be NULL.
+ * @param end_cb Called as a span ends, or NULL to stop tracing.
+ * @param arg Passed back to the callbacks as is.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_trace_cb(ACVP_CTX *ctx,
+                              void (*start_cb)(const ACVP_SPAN *span, void *arg),
+                              void (*end_cb)(const ACVP_SPAN *span, void *arg),
+                              void *arg);
 
 /**
- * @brief acvp_set_certkey() specifies PEM encoded certificate and private key to use for
- *        establishing the TLS session with the ACVP server. ACVP uses TLS as the transport. In
- *        order for the ACVP server to verify the identity the DUT using libacvp, a certificate
- *        needs to be presented during the TLS handshake. The certificate used by libacvp needs to
- *        be trusted by the ACVP server. Otherwise the TLS handshake will fail.
+ * @brief Opaque reference to an OpenMetrics exporter, see acvp_openmetrics_create().
+ */
+typedef struct acvp_openmetrics_t ACVP_OPENMETRICS;
+
+/**
+ * @brief acvp_openmetrics_create() sets up an exporter that keeps counters and histograms of the
+ *        work done by the sessions it is given to with acvp_set_openmetrics(), for a service that
+ *        runs libacvp for a long time to have them scraped: the vector sets processed, the test
+ *        cases handed to the crypto module and the time they took for each algorithm, the
+ *        latency of the crypto handlers, the waits the server asked for, the requests made to
+ *        the server with their bytes and latency, and the JWT refreshes. The counters are
+ *        written out in the OpenMetrics text format by acvp_openmetrics_write().
  *
- * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param cert_file Name of file containing the PEM encoded X.509 certificate to use as the client
- *        identity.
- * @param key_file Name of file containing PEM encoded private key associated with the client
- *        certificate.
+ *        One exporter may be shared by any number of sessions, from any number of threads.
+ *
+ * @param om Set to the new exporter, to be released with acvp_openmetrics_free().
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_set_certkey(ACVP_CTX *ctx, char *cert_file, char *key_file);
+ACVP_RESULT acvp_openmetrics_create(ACVP_OPENMETRICS **om);
 
 /**
- * @brief acvp_mark_as_sample() marks the registration as a sample. This function sets a flag that
- *        will allow the client to retrieve the correct answers later on, allowing for comparison
- *        and debugging.
+ * @brief acvp_openmetrics_free() releases an exporter from acvp_openmetrics_create(). The
+ *        sessions it was given to must have been freed, or given another exporter, first.
  *
- * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param om The exporter.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_mark_as_sample(ACVP_CTX *ctx);
+ACVP_RESULT acvp_openmetrics_free(ACVP_OPENMETRICS *om);
 
 /**
- * @brief acvp_mark_as_request_only() marks the registration as a request only. This function sets
- *         a flag that will allow the client to retrieve the vectors from the server and store them
- *         in a file for later use.
+ * @brief acvp_set_openmetrics() has a session count its work in an exporter. Nothing is counted
+ *        or timed for a session that has no exporter.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param filename Name of the file to be used for the request vectors
+ * @param om The exporter, or NULL to stop counting.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_mark_as_request_only(ACVP_CTX *ctx, char *filename);
+ACVP_RESULT acvp_set_openmetrics(ACVP_CTX *ctx, ACVP_OPENMETRICS *om);
 
 /**
- * @brief acvp_mark_as_get_only() marks the operation as a GET only. This function will take the
- *        string parameter and perform a GET to check the get of a specific request. The request ID
- *        must be part of the string.
+ * @brief acvp_openmetrics_write() writes the counters of an exporter in the OpenMetrics text
+ *        format, ending with "# EOF", such as in answer to a scrape of a /metrics endpoint.
+ *        The crypto handler timings of a vector set are added as each of its test groups is
+ *        done.
+ *
+ * @param om The exporter.
+ * @param writer Takes the next len bytes of the text, which is not NUL terminated, returning 0
+ *        on success and 1 to stop writing.
+ * @param arg Passed back to the writer as is.
+ *
+ * @return ACVP_RESULT, ACVP_TRANSPORT_FAIL when the writer fails
+ */
+ACVP_RESULT acvp_openmetrics_write(ACVP_OPENMETRICS *om,
+                                   int (*writer)(const char *buf, size_t len, void *arg),
+                                   void *arg);
+
+/**
+ * @brief acvp_set_idle_cb() registers a callback that is given the time libacvp would otherwise
+ *        spend asleep waiting on the server, such as when vector sets or test results are not
+ *        ready yet, to do precomputation with: warming the caches of the crypto module,
+ *        generating RSA prime candidates or DSA domain parameters for the registered sizes, and
+ *        the like. Vector sets that are ready are already downloaded and run while others wait.
+ *
+ *        The callback is given how many milliseconds are left in the wait and should return
+ *        within about that time, doing a bounded piece of work per call. It is called again
+ *        while time remains for as long as it returns 1; once it returns 0, having nothing more
+ *        to do for now, libacvp sleeps out the rest of the wait. With
+ *        acvp_set_max_parallel_vector_sets() above 1 the callback may be invoked from several
+ *        threads at once.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param string used for the get, such as '/acvp/v1/requests/383'
- * @param save_filename an optional parameter that results in the GET output being saved to a file
+ * @param idle_cb The callback, or NULL to just sleep.
+ * @param arg Passed back to the callback as is.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_mark_as_get_only(ACVP_CTX *ctx, char *string, const char *save_filename);
+ACVP_RESULT acvp_set_idle_cb(ACVP_CTX *ctx, int (*idle_cb)(unsigned int budget_ms, void *arg), void *arg);
 
 /**
- * @brief acvp_mark_as_post_only() marks the operation as a POST only. This function will take the
- *        filename and perform a POST of the data in the file to the URL
- *        /acvp/v1/(first field in file)
+ * @brief acvp_set_async_log() moves the calls to the logging callback given to
+ *        acvp_create_test_session() onto a writer thread of their own. Messages are formatted by
+ *        the thread logging them into a ring that holds up to entries of them, and the writer
+ *        hands them to the callback in the order they were logged; a thread that finds the ring
+ *        full waits for room rather than dropping the message. This keeps verbose logging from
+ *        holding up the KAT handlers. Everything still in the ring is written out when the
+ *        session is freed or this is called again.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param filename file containing URL and content to POST
+ * @param entries Most messages waiting in the ring, up to 4096; 0 logs from the calling thread
+ *        again.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_mark_as_post_only(ACVP_CTX *ctx, char *filename);
+ACVP_RESULT acvp_set_async_log(ACVP_CTX *ctx, int entries);
 
 /**
- * @brief acvp_mark_as_delete only() marks the operation as a DELETE only. This function will
- *        perform an HTTP DELETE call on the resource at the givenURL.
+ * @struct ACVP_TC_PROGRESS
+ * @brief Where a long running test case has got to, as given to the progress callback.
+ */
+typedef struct acvp_tc_progress_t {
+    ACVP_CIPHER cipher;
+    int vs_id;
+    int tg_id;
+    int tc_id;
+    unsigned int calls;        /**< Times the crypto module has reported progress on the test case */
+    unsigned long long int elapsed_ms; /**< Time since the first progress report */
+} ACVP_TC_PROGRESS;
+
+/**
+ * @brief acvp_set_tc_deadline() limits the time a single RSA KeyGen, DSA PQGGen/KeyGen or safe
+ *        primes KeyGen test case may spend generating primes. Once it is exceeded
+ *        acvp_tc_progress() tells the crypto module to give up; the test case is logged as
+ *        abandoned and its vector set fails with ACVP_CRYPTO_MODULE_FAIL, rather than holding on
+ *        to the session for the rest of its time on the server. The deadline is only checked
+ *        as often as the crypto module calls acvp_tc_progress().
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param request_url url of resource to delete
+ * @param seconds Seconds a test case may take, or 0 (the default) for no limit. At most
+ *        ACVP_MAX_WAIT_TIME.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_mark_as_delete_only(ACVP_CTX *ctx, char *request_url);
+ACVP_RESULT acvp_set_tc_deadline(ACVP_CTX *ctx, int seconds);
 
 /**
- * @brief acvp_mark_as_put_after_test() will attempt to PUT the given file (with the URL inside)
- *        at the conclusion of a test session run with the given CTX.
+ * @brief acvp_set_tc_progress_cb() registers a callback that acvp_tc_progress() hands the
+ *        progress of long running test cases to, for example to report them or to cancel one
+ *        on some condition of the application's own. It may be invoked from several threads at
+ *        once when test cases or vector sets are run in parallel.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param filename the path to the file to PUT after the test session
+ * @param progress_cb The callback, returning nonzero to cancel the test case, or NULL.
+ * @param arg Passed back to the callback as is.
  *
  * @return ACVP_RESULT
  */
-ACVP_RESULT acvp_mark_as_put_after_test(ACVP_CTX *ctx, char *filename);
+ACVP_RESULT acvp_set_tc_progress_cb(ACVP_CTX *ctx,
+                                    int (*progress_cb)(const ACVP_TC_PROGRESS *progress, void *arg),
+                                    void *arg);
 
 /**
- * @brief acvp_get_vector_set_count will return the number of vector sets that are expected based on the current
- * registration. This should be seen as a close estimate not an exact number, as different ACVP servers could
- * possibly have different behaviors.
+ * @brief acvp_tc_progress() is called by the crypto module from inside a long running test case,
+ *        such as from the callback of its prime generation, with the control of the test case.
+ *        It checks the deadline set by acvp_set_tc_deadline() and calls the progress callback.
+ *        When it returns nonzero the crypto module should stop and fail the test case.
  *
- * @param ctx Pointer to ACVP_CTX with registered algorithms
+ * @param control The control member of the test case; may be NULL.
  *
- * @return Count of expected vector sets
+ * @return 0 to carry on, 1 to give up on the test case
  */
-int acvp_get_vector_set_count(ACVP_CTX *ctx);
+int acvp_tc_progress(ACVP_TC_CONTROL *control);
 
 /**
  * @brief Performs the ACVP testing procedures.
@@ -4507,6 +6178,100 @@ int acvp_get_vector_set_count(ACVP_CTX *ctx);
  */
 ACVP_RESULT acvp_run(ACVP_CTX *ctx, int fips_validation);
 
+/**
+ * @brief acvp_session_step() performs the steps of acvp_run() one at a time, for applications
+ *        that drive many sessions from an event loop rather than a thread each. Each call does
+ *        one unit of the session - the login, the registration, one vector set (download,
+ *        processing and upload) or one poll of the results - and returns. Where acvp_run() would
+ *        wait for the server, because a vector set or the results are not ready yet, the call
+ *        returns at once and \p next_timeout says when to call again; the application is
+ *        expected to wait that long in its own loop.
+ *
+ *        The exchanges with the server are still done within the call, over the context's own
+ *        connection, so a call takes as long as the server takes to answer one request (and the
+ *        crypto module to process one vector set). \p next_fd is always set to -1, there being
+ *        no descriptor to wait on.
+ *
+ *        Contexts set up for a GET, POST or DELETE, or with remote workers, must be run with
+ *        acvp_run(). Once the session is done the same result is returned by every call, until
+ *        acvp_reset_session() clears it for another session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param fips_validation As for acvp_run(), used on the first call of the session only.
+ * @param next_fd Set to the descriptor to wait on, or -1 for none.
+ * @param next_timeout Set to the milliseconds to wait before the next call, 0 to call again right
+ *        away.
+ *
+ * @return ACVP_RESULT ACVP_KAT_DOWNLOAD_RETRY while the session has more steps to take; otherwise
+ *         the session is done, with the result acvp_run() would have returned.
+ */
+ACVP_RESULT acvp_session_step(ACVP_CTX *ctx, int fips_validation, int *next_fd, int *next_timeout);
+
+/**
+ * @brief acvp_orch_create() creates an orchestrator, which runs the test sessions of several
+ *        contexts (for example one per operating environment of a module) concurrently from one
+ *        process. The sessions share one pool of worker threads, one set of connections to the
+ *        server and one schedule for vector sets the server asks to be retried.
+ *
+ * @param orch Address of the pointer to the new orchestrator, which must be NULL.
+ * @param max_workers Number of worker threads, between 1 and 64. With more than 1 the crypto
+ *        handlers of the sessions may be invoked from multiple threads at once and must be
+ *        reentrant.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_orch_create(ACVP_ORCH **orch, int max_workers);
+
+/**
+ * @brief acvp_orch_add_session() adds a context to be run by acvp_orch_run(). The context is set
+ *        up as it would be for acvp_run(), and must not be used or freed until the orchestrator is
+ *        done with it. Contexts set up for a GET, POST or DELETE can not be added.
+ *
+ * @param orch Pointer to an orchestrator created by acvp_orch_create().
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param fips_validation As for acvp_run()
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_orch_add_session(ACVP_ORCH *orch, ACVP_CTX *ctx, int fips_validation);
+
+/**
+ * @brief acvp_orch_run() performs the steps of acvp_run() for all the sessions of the
+ *        orchestrator. The workers log in and register every session first, then take vector sets
+ *        from all sessions in the order the server expects them to be ready, and check the results
+ *        of each session once its vector sets are done. acvp_set_max_parallel_vector_sets() is not
+ *        used; the orchestrator's workers are shared by all sessions. For the sessions with
+ *        fips_validation set, a Vendor, Module, OE or Dependency that several of them have is
+ *        searched for in the server DB by one session and the result used by all, and the
+ *        validations are submitted by the workers at the same time, as each session's results
+ *        are checked. A failed session does not stop the others. This function blocks until every
+ *        session is done.
+ *
+ * @param orch Pointer to an orchestrator created by acvp_orch_create().
+ *
+ * @return ACVP_RESULT The result of the first failed session, in the order they were added. See
+ *         acvp_orch_get_result() for the result of each session.
+ */
+ACVP_RESULT acvp_orch_run(ACVP_ORCH *orch);
+
+/**
+ * @brief acvp_orch_get_result() gives the result a session had in the last acvp_orch_run().
+ *
+ * @param orch Pointer to an orchestrator created by acvp_orch_create().
+ * @param ctx A context added to the orchestrator.
+ * @param result Set to the result of the session.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_orch_get_result(ACVP_ORCH *orch, ACVP_CTX *ctx, ACVP_RESULT *result);
+
+/**
+ * @brief acvp_orch_free() frees an orchestrator. The contexts that were added are not freed.
+ *
+ * @param orch Pointer to an orchestrator created by acvp_orch_create(), may be NULL.
+ */
+void acvp_orch_free(ACVP_ORCH *orch);
+
 ACVP_RESULT acvp_oe_ingest_metadata(ACVP_CTX *ctx, const char *metadata_file);
 
 ACVP_RESULT acvp_oe_set_fips_validation_metadata(ACVP_CTX *ctx,
@@ -4557,10 +6322,13 @@ char *acvp_get_current_registration(ACVP_CTX *ctx, int *len);
 
 /**
  * @brief Uploads a set of vector set responses that were processed from an offline vector set JSON
- *        file.
+ *        file. Only the session identifiers of the file are parsed; each vector set is found by a
+ *        scan of the file and uploaded as it is there, so the size of the file does not matter.
+ *        With acvp_set_max_parallel_vector_sets() several vector sets are uploaded at once.
+ *        A rsp_filename of "-" reads the responses from stdin, uploading them as they arrive.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param rsp_filename Name of the file that contains the completed vector set results
+ * @param rsp_filename Name of the file that contains the completed vector set results, or "-"
  * @param fips_validation Should be != 0 in case of fips validation (metadata must be provided)
  *
  * @return ACVP_RESULT
@@ -4569,16 +6337,314 @@ ACVP_RESULT acvp_upload_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filenam
 
 /**
  * @brief Runs a set of tests from vector sets that were saved to a file and saves the results in a
- *        different file.
+ *        different file. The vector sets are spread across acvp_set_max_parallel_vector_sets()
+ *        worker threads; the results are saved in the order of the request file either way.
+ *        Either file may be "-" for stdin or stdout, to run in a pipeline: the vector sets are
+ *        then read and run as they arrive, max_parallel of them at a time, and each response is
+ *        written out once it and those before it are done. The vector set cache is not used for
+ *        stdin, and a filter or shard picks the vector sets by the vsIds of their URLs.
  *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
- * @param req_filename Name of the file that contains the unprocessed vector sets
- * @param rsp_filename Name of the file to save vector set test results to
+ * @param req_filename Name of the file that contains the unprocessed vector sets, or "-"
+ * @param rsp_filename Name of the file to save vector set test results to, or "-"
  *
  * @return ACVP_RESULT
  */
 ACVP_RESULT acvp_run_vectors_from_file(ACVP_CTX *ctx, const char *req_filename, const char *rsp_filename);
 
+/**
+ * @brief acvp_set_vector_set_filter() limits acvp_run_vectors_from_file() to the vector sets of
+ *        the request file with the given vsIds. The response file then holds only those vector
+ *        sets, with the vector set URLs of the session cut down to match, so it can be uploaded
+ *        by itself or merged with others by acvp_merge_vector_rsp_files().
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param vs_ids The vsIds to run, copied by the library; NULL to run every vector set again
+ * @param count Number of vsIds in vs_ids
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_vector_set_filter(ACVP_CTX *ctx, const int *vs_ids, int count);
+
+/**
+ * @brief acvp_set_vector_set_shard() splits the vector sets of a request file into shard_count
+ *        shards and limits acvp_run_vectors_from_file() to one of them, so that the work can be
+ *        spread across several machines. Vector sets are dealt out in file order: the first to
+ *        shard 1, the second to shard 2 and so on, starting over once every shard has one. When
+ *        a filter is also set, a vector set must be in both to run. The response file is cut
+ *        down as with acvp_set_vector_set_filter().
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param shard The shard to run, from 1 to shard_count
+ * @param shard_count Number of shards, or 0 (with shard 0) to run every vector set again
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_vector_set_shard(ACVP_CTX *ctx, int shard, int shard_count);
+
+/**
+ * @brief acvp_merge_vector_rsp_files() combines the response files written by several runs of
+ *        acvp_run_vectors_from_file() over parts of the same request file, for example its
+ *        shards, into one response file for acvp_upload_vectors_from_file(). The vector sets are
+ *        written in vsId order. All the files must belong to the same test session, and a
+ *        vector set may only be in one of them.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param rsp_filenames Names of the response files to merge
+ * @param count Number of names in rsp_filenames
+ * @param out_filename Name of the file to save the merged responses to
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_merge_vector_rsp_files(ACVP_CTX *ctx, const char **rsp_filenames, int count,
+                                        const char *out_filename);
+
+/**
+ * @brief acvp_set_vector_set_cache_file() names a cache file for acvp_run_vectors_from_file().
+ *        The first run compiles the request file into this binary cache; later runs over the
+ *        same, unmodified request file load the vector sets from the cache instead of parsing
+ *        the JSON again. The cache is rebuilt whenever the size or modification time of the
+ *        request file changes.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cache_filename Name of the cache file to create or load
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_vector_set_cache_file(ACVP_CTX *ctx, const char *cache_filename);
+
+/**
+ * @brief acvp_set_cap_loader() registers a callback that enables capabilities on demand for
+ *        acvp_run_vectors_from_file(). Replaying a request file only needs the capabilities of the
+ *        vector sets in it, so rather than enabling every capability beforehand the application
+ *        may leave them to the loader. Before any vector set is run, the loader is called once for
+ *        each cipher that a selected vector set of the file is for and that has not been enabled,
+ *        and is to enable it, along with its crypto handler and whatever parameters its KAT handler
+ *        reads, using the usual acvp_cap_*_enable() and acvp_cap_*_set_parm() calls. It may enable
+ *        more than it is asked for, such as the rest of the cipher's family. A vector set whose
+ *        cipher is still not enabled fails as it would without a loader.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param loader The callback, or NULL to remove it. Anything other than ACVP_SUCCESS stops the run
+ *        and is returned by acvp_run_vectors_from_file().
+ * @param arg Passed back to the callback as is.
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_cap_loader(ACVP_CTX *ctx, ACVP_RESULT (*loader)(ACVP_CTX *ctx, ACVP_CIPHER cipher, void *arg),
+                                void *arg);
+
+/**
+ * @brief acvp_set_registration_cache_file() names a cache file for the registration that
+ *        acvp_register() sends. The first session saves the serialized registration to it;
+ *        later sessions whose capabilities give the same registration send it from the cache
+ *        instead of serializing it again. The cache is keyed by a fingerprint of the
+ *        registered algorithms and the sample flag, and is rewritten when they change.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cache_filename Name of the cache file to create or load
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_registration_cache_file(ACVP_CTX *ctx, const char *cache_filename);
+
+/**
+ * @brief acvp_set_metadata_cache_file() names a cache file for the server DB lookups done by
+ *        acvp_verify_fips_validation_metadata(). The URLs of the Vendor, Module, OE and
+ *        Dependencies it finds are saved to the cache, keyed by a fingerprint of the server and
+ *        of the metadata they were found for. Later validations with the same metadata use the
+ *        saved URLs for up to ttl_seconds after they were found, instead of searching the server
+ *        DB again; entries that are missing or older than that are searched for as before.
+ *        Metadata that is not found on the server is never cached.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cache_filename Name of the cache file to create or load
+ * @param ttl_seconds How long a saved URL is used for, in seconds; must be positive
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_metadata_cache_file(ACVP_CTX *ctx, const char *cache_filename, long ttl_seconds);
+
+/**
+ * @brief acvp_set_checkpoint_journal() names a journal file for the test group responses of a
+ *        test session. As the KAT handlers finish each test group its responses are appended
+ *        to the journal, one line per group. When a vector set is processed again, after the
+ *        application was stopped and resumed the session or reran the request file, the groups
+ *        found in the journal are not run again and their responses are taken from it instead.
+ *        A group whose line was cut short is simply run again. The journal belongs to one test
+ *        session; the application should remove it once the session is done.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param journal_filename Name of the journal file to append to and resume from
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_checkpoint_journal(ACVP_CTX *ctx, const char *journal_filename);
+
+/**
+ * @brief acvp_set_result_memo() names a store of test group responses to reuse when the same
+ *        request files are replayed against new builds of the crypto module. Only the
+ *        deterministic algorithms are memoized: the symmetric ciphers, save for test groups
+ *        whose IV or salt the module generates, hashes, MACs and the KDFs. Each of their test
+ *        groups is keyed by the algorithm, mode and revision of the vector set and a
+ *        fingerprint of the group with its tgId and tcIds left out and the fields of every object
+ *        taken in name order. A group whose key is in the store is not run; its responses are
+ *        taken from the store and given the ids of the request. Of those, sample_pct percent,
+ *        picked at random, are run anyway and their responses compared to the stored ones; a
+ *        mismatch is logged as drift, the store is updated, and no more responses are taken
+ *        from it by the session. Groups not in the store are run and appended to it. The store
+ *        is a file of one line of JSON per group, loaded on first use.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param memo_filename Name of the store to load and append to, or NULL to stop using one
+ * @param sample_pct Percent of the groups found in the store to run anyway, 0 to 100
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_result_memo(ACVP_CTX *ctx, const char *memo_filename, int sample_pct);
+
+/**
+ * @struct ACVP_MEMO_STATS
+ * @brief What the result memo did for a session, as reported by acvp_get_memo_stats()
+ */
+typedef struct acvp_memo_stats_t {
+    int hits;     /**< Test groups found in the store, including those sampled */
+    int misses;   /**< Deterministic test groups not found in the store, and run */
+    int sampled;  /**< Test groups found in the store that were run anyway */
+    int drifted;  /**< Sampled test groups whose responses did not match the store */
+    int stored;   /**< Test group responses added to the store */
+} ACVP_MEMO_STATS;
+
+/**
+ * @brief acvp_get_memo_stats() reports what the result memo, see acvp_set_result_memo(), did
+ *        over the vector sets processed so far. A nonzero drifted means the module now gives
+ *        different results than when the store was made, and the responses the store gave for
+ *        groups that were not sampled may be wrong; the replay should be run again once the
+ *        store has been updated, or with a sample_pct of 100.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param stats Filled in with the counts
+ *
+ * @return ACVP_RESULT, ACVP_UNSUPPORTED_OP if there is no result memo
+ */
+ACVP_RESULT acvp_get_memo_stats(ACVP_CTX *ctx, ACVP_MEMO_STATS *stats);
+
+/**
+ * @brief acvp_set_vector_set_download_cache() names a directory to keep the vector sets of a test
+ *        session in as they are downloaded. Before a vector set is requested from the server the
+ *        cache is checked for it, so a vector set that is processed again, after the application
+ *        was stopped and resumed the session, is not downloaded again. Each vector set is kept in
+ *        a file of its own, named for a fingerprint of the server, the test session URL and the
+ *        vsId URL. Only complete vector sets are kept; a request to retry later is not. The
+ *        directory must exist. The cache belongs to the test sessions it was filled by; the
+ *        application should remove their files once the sessions are done.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param cache_dir Name of the directory to keep the downloaded vector sets in
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_vector_set_download_cache(ACVP_CTX *ctx, const char *cache_dir);
+
+/**
+ * @brief acvp_set_remote_workers() makes the test session a coordinator for worker processes on
+ *        other machines, see acvp_run_remote_worker(). The coordinator still logs in, registers,
+ *        downloads the vector sets and posts their responses, keeping the JWT to itself, but
+ *        rather than running the crypto handlers it writes each vector set to dir, a directory
+ *        shared with the workers, and waits for one of them to write back its responses. With
+ *        acvp_set_max_parallel_vector_sets() that many vector sets are out with the workers at
+ *        once. A vector set a worker fails to process fails the session as it would have locally.
+ *        Once the session is freed, a file named done is left in dir for the workers to stop on.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param dir Name of the directory shared with the workers; it must exist. NULL to process the
+ *        vector sets locally again.
+ * @param timeout Seconds to wait for the responses of a vector set, 0 for the default of 3 hours
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_remote_workers(ACVP_CTX *ctx, const char *dir, int timeout);
+
+/**
+ * @brief acvp_run_remote_worker() processes the vector sets a coordinator, see
+ *        acvp_set_remote_workers(), leaves in dir, one at a time, as acvp_run_vectors_from_file()
+ *        would, with the capabilities registered with ctx, until the coordinator is done with the
+ *        directory. Any number of workers may share the directory; each vector set is taken by
+ *        one of them. The worker never contacts the server.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session,
+ *        with the capabilities of the vector sets registered.
+ * @param dir Name of the directory shared with the coordinator
+ * @param idle_timeout Seconds without a vector set to take after which to stop anyway, 0 to wait
+ *        for the coordinator
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_run_remote_worker(ACVP_CTX *ctx, const char *dir, int idle_timeout);
+
+/**
+ * @brief acvp_set_memory_budget() limits how much of the responses of a vector set are kept in
+ *        memory while it is processed. The responses are counted by their serialized size as each
+ *        test group is finished; once they are larger than bytes, the finished test groups are
+ *        moved to a temporary file and freed. When the vector set is done the responses are
+ *        posted, or written to the response file of an offline run, streamed from a file with the
+ *        groups moved there first. Test groups are only moved out whole, so a single group larger
+ *        than the budget is still held in memory while it is run. Vector sets resumed from the
+ *        checkpoint journal keep their responses in memory. Builds that post responses from
+ *        memory (USE_MURL) only apply the budget to offline runs.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param bytes Serialized size of the responses of a vector set to keep in memory, 0 for no limit
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_memory_budget(ACVP_CTX *ctx, size_t bytes);
+
+/**
+ * @brief acvp_set_huge_pages() has the large buffers of the library backed by huge pages, to
+ *        save the page faults and TLB misses of filling and reading them. It applies to the
+ *        buffer server responses are received in (which holds whole vector sets) and to vector
+ *        sets loaded from the download cache, once they are 2 MiB or larger. They are mapped
+ *        from the huge pages the system has reserved if it has any (MAP_HUGETLB), and otherwise
+ *        from normal pages the kernel is advised to back with transparent huge pages; if that
+ *        fails too, or on systems without such mappings, they come from the heap as they do by
+ *        default.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param enable 1 to back large buffers with huge pages, 0 for the heap
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_set_huge_pages(ACVP_CTX *ctx, int enable);
+
+/**
+ * @struct ACVP_MEMORY_USAGE
+ * @brief Memory held by the library, as reported by acvp_get_memory_usage()
+ */
+typedef struct acvp_memory_usage_t {
+    size_t current; /**< Bytes held now, or when the vector set was done */
+    size_t peak;    /**< Most bytes held at any one time */
+} ACVP_MEMORY_USAGE;
+
+/**
+ * @brief acvp_get_memory_usage() reports how much memory the library holds for a test session,
+ *        to help choose a budget for acvp_set_memory_budget(). Counted are the buffers of the test
+ *        cases, the JSON of the vector sets and of their responses, the buffer server responses
+ *        are received in and the capabilities; memory the crypto module or the TLS library
+ *        allocate is not. With a vs_id of 0 the totals of the session, over all of the vector
+ *        sets processed at once, are given. Otherwise vs_id names a vector set the session has
+ *        finished with, and what the context that processed it held is given: the peak while it
+ *        was processed, and current when it was done. The metrics callback, see
+ *        acvp_set_metrics_cb(), is given the same figures as vector sets are processed.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param vs_id The vsId of a finished vector set, or 0 for the whole session
+ * @param usage Filled in with the memory in use
+ *
+ * @return ACVP_RESULT, ACVP_INVALID_ARG if no vector set vs_id has been finished
+ */
+ACVP_RESULT acvp_get_memory_usage(ACVP_CTX *ctx, int vs_id, ACVP_MEMORY_USAGE *usage);
+
 /**
  * @brief performs an HTTP PUT on a given libacvp JSON file to the ACV server
  *
@@ -4602,6 +6668,10 @@ ACVP_RESULT acvp_get_results_from_server(ACVP_CTX *ctx, const char *request_file
 /**
  * @brief Gets the expected test results for test sessions marked as samples
  *
+ *        The expected results of up to acvp_set_max_parallel_vector_sets() vector sets are
+ *        fetched at once, a few ahead of the one being written, and each is written to the file
+ *        as soon as it is in, in the order of the session, so only those few are held at once.
+ *
  * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
  * @param request_filename File containing the session info created by libacvp
  * @param save_filename path/name for file to save the expected results too. OPTIONAL. If null,
@@ -4611,6 +6681,29 @@ ACVP_RESULT acvp_get_results_from_server(ACVP_CTX *ctx, const char *request_file
  */
 ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filename, const char *save_filename);
 
+/**
+ * @brief acvp_verify_vectors_from_file() checks the responses that acvp_run_vectors_from_file()
+ *        saved against the expected results of a sample test session, as saved by
+ *        acvp_get_expected_results(), all locally. Each value of a test case response is compared
+ *        with the expected value of the same name; hex strings are compared without regard to
+ *        case. Each test case that does not match, or is missing, is logged with its vsId, tgId
+ *        and tcId, along with both values at ACVP_LOG_LVL_INFO. The test groups are checked by up
+ *        to acvp_set_max_parallel_vector_sets() threads.
+ *
+ *        Answers that the server can only check itself, such as generated signatures or keys, do
+ *        not match the expected results and are reported like any other.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param rsp_filename Name of the file that contains the completed vector set results
+ * @param expected_filename Name of the file acvp_get_expected_results() saved the expected
+ *        results to
+ * @param mismatches Optional, set to the number of test cases that do not match
+ *
+ * @return ACVP_RESULT, ACVP_SUCCESS once the files were compared, whether or not they matched
+ */
+ACVP_RESULT acvp_verify_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filename,
+                                          const char *expected_filename, int *mismatches);
+
 /**
  * @brief Queries the server for any vector sets that have not received a response (e.x. in case of
  *        lose of connectivity during testing), downloads those vector sets, and continues to
@@ -4624,6 +6717,24 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
  */
 ACVP_RESULT acvp_resume_test_session(ACVP_CTX *ctx, const char *request_filename, int fips_validation);
 
+/**
+ * @brief Queries the server for the vector sets of a session that failed (or ended in error),
+ *        and runs only those again: each is downloaded again, or loaded from the download cache
+ *        (see acvp_set_vector_set_download_cache()), processed and its new responses submitted
+ *        in place of the old ones, after which the results of the session are checked as usual.
+ *        Test groups kept in the checkpoint journal or the result memo are not used for them, as
+ *        those are the answers that failed. With acvp_mark_as_request_only() the failed vector
+ *        sets are saved to the file instead. Meant for checking a fix to an algorithm without
+ *        starting a new session.
+ *
+ * @param ctx Pointer to ACVP_CTX that was previously created by calling acvp_create_test_session.
+ * @param request_filename File containing the session info created by libacvp
+ * @param fips_validation Should be != 0 in case of fips validation (metadata must be provided)
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_rerun_failed_vector_sets(ACVP_CTX *ctx, const char *request_filename, int fips_validation);
+
 
 /**
  * @brief Requests the server to cancel a test session and delete associated data
@@ -4672,6 +6783,45 @@ ACVP_RESULT acvp_bin_to_hexstr(const unsigned char *src, int src_len, char *dest
  */
 ACVP_RESULT acvp_hexstr_to_bin(const char *src, unsigned char *dest, int dest_max, int *converted_len);
 
+/**
+ * @brief acvp_hexstr_to_bin_n() Converts a hex string of known length to binary
+ *
+ * Unlike acvp_hexstr_to_bin(), the source does not need to be NUL terminated
+ * and may hold an odd number of hex characters, in which case the last
+ * character is stored as the high nibble of the final byte.
+ *
+ * @param src Pointer to the hex source string
+ * @param src_len Number of hex characters in src
+ * @param dest Pointer to the destination binary buffer
+ * @param dest_max Maximum length allowed for destination
+ * @param converted_len the number of bytes converted (output length)
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_hexstr_to_bin_n(const char *src, int src_len, unsigned char *dest,
+                                 int dest_max, int *converted_len);
+
+/**
+ * @brief acvp_hexstr_to_bn() Converts the hex string of a big endian number to 64 bit limbs
+ *
+ * Any limbs bn already has are freed first; free the limbs with acvp_bn_free(). Only an even
+ * number of hex characters is accepted, as with acvp_hexstr_to_bin().
+ *
+ * @param src Pointer to the hex source string
+ * @param bn Pointer to the number to set
+ * @param byte_max Maximum length in bytes allowed for the number
+ *
+ * @return ACVP_RESULT
+ */
+ACVP_RESULT acvp_hexstr_to_bn(const char *src, ACVP_BN *bn, int byte_max);
+
+/**
+ * @brief acvp_bn_free() Frees the limbs of a number and zeroes it
+ *
+ * @param bn Pointer to the number, may be NULL
+ */
+void acvp_bn_free(ACVP_BN *bn);
+
 /**
  * @brief acvp_lookup_error_string() is a utility that returns a more descriptive string for an ACVP_RESULT
  *        error code
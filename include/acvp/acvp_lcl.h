@@ -11,34 +11,65 @@
 #define acvp_lcl_h
 
 #include "parson.h"
+#include <time.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+typedef HANDLE ACVP_THREAD;
+typedef CRITICAL_SECTION ACVP_MUTEX;
+typedef CONDITION_VARIABLE ACVP_COND;
+typedef INIT_ONCE ACVP_ONCE;
+#define ACVP_ONCE_INIT INIT_ONCE_STATIC_INIT
+#define ACVP_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+typedef pthread_t ACVP_THREAD;
+typedef pthread_mutex_t ACVP_MUTEX;
+typedef pthread_cond_t ACVP_COND;
+typedef pthread_once_t ACVP_ONCE;
+#define ACVP_ONCE_INIT PTHREAD_ONCE_INIT
+#define ACVP_THREAD_LOCAL __thread
+#endif
+
+/*
+ * Whether a message at lvl would be logged. The macros below check it
+ * before calling acvp_log_msg(), so a level that is off costs a compare and
+ * neither the call nor the evaluation of the arguments.
+ */
+#define ACVP_LOG_ENABLED(ctx, lvl) ((ctx) && (ctx)->test_progress_cb && (ctx)->log_lvl >= (lvl))
 
 #ifndef ACVP_LOG_ERR
 #define ACVP_LOG_ERR(msg, ...) do { \
-        acvp_log_msg(ctx, ACVP_LOG_LVL_ERR, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (ACVP_LOG_ENABLED(ctx, ACVP_LOG_LVL_ERR)) \
+            acvp_log_msg(ctx, ACVP_LOG_LVL_ERR, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef ACVP_LOG_WARN
 #define ACVP_LOG_WARN(msg, ...) do { \
-        acvp_log_msg(ctx, ACVP_LOG_LVL_WARN, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (ACVP_LOG_ENABLED(ctx, ACVP_LOG_LVL_WARN)) \
+            acvp_log_msg(ctx, ACVP_LOG_LVL_WARN, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef ACVP_LOG_STATUS
 #define ACVP_LOG_STATUS(msg, ...)  do { \
-        acvp_log_msg(ctx, ACVP_LOG_LVL_STATUS, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (ACVP_LOG_ENABLED(ctx, ACVP_LOG_LVL_STATUS)) \
+            acvp_log_msg(ctx, ACVP_LOG_LVL_STATUS, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef ACVP_LOG_INFO
 #define ACVP_LOG_INFO(msg, ...) do { \
-        acvp_log_msg(ctx, ACVP_LOG_LVL_INFO, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (ACVP_LOG_ENABLED(ctx, ACVP_LOG_LVL_INFO)) \
+            acvp_log_msg(ctx, ACVP_LOG_LVL_INFO, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef ACVP_LOG_VERBOSE
 #define ACVP_LOG_VERBOSE(msg, ...) do { \
-        acvp_log_msg(ctx, ACVP_LOG_LVL_VERBOSE, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (ACVP_LOG_ENABLED(ctx, ACVP_LOG_LVL_VERBOSE)) \
+            acvp_log_msg(ctx, ACVP_LOG_LVL_VERBOSE, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
@@ -52,6 +83,7 @@
 //This MUST be the length of the above string (want to avoid calculating at runtime frequently)
 #define ACVP_LOG_TRUNCATED_STR_LEN 14
 #define ACVP_LOG_MAX_MSG_LEN 2048
+#define ACVP_LOG_RING_MAX 4096 /**< Most messages the async log sink can hold */
 
 #define ACVP_BIT2BYTE(x) ((x + 7) >> 3) /**< Convert bit length (x, of type integer) into byte length */
 
@@ -538,6 +570,10 @@
 #define ACVP_SHAKE_MSG_BIT_MAX 131072                         /**< 131072 bits */
 #define ACVP_SHAKE_MSG_STR_MAX (ACVP_SHAKE_MSG_BIT_MAX >> 2)  /**< 32768 characters */
 #define ACVP_SHAKE_MSG_BYTE_MAX (ACVP_SHAKE_MSG_BIT_MAX >> 3) /**< 16384 bytes */
+#define ACVP_HASH_LDT_CHUNK_SIZE (1024 * 1024)                /**< Target size of an LDT chunk */
+
+#define ACVP_MAP_REPEAT_SEGMENT (16 * 1024 * 1024)     /**< Backing size of a repeated mapping */
+#define ACVP_MAP_REPEAT_SEGMENT_MAX (64 * 1024 * 1024) /**< Largest tile run that is mapped */
 
 #define ACVP_HASH_XOF_MD_BIT_MIN 16 /**< XOF (extendable output format) outLength minimum (in bits) */
 #define ACVP_HASH_XOF_MD_BIT_MAX 65536 /**< XOF (extendable output format) outLength maximum (in bits) */
@@ -892,20 +928,32 @@
 
 #define ACVP_LMS_TMP_MAX 65336 //arbitrary
 
-#define ACVP_CURL_BUF_MAX       (1024 * 1024 * 64) /**< 64 MB */
+#define ACVP_CURL_BUF_MAX       (1024 * 1024 * 64) /**< 64 MB, bound when scanning server error strings */
+#define ACVP_CURL_BUF_INIT      (1024 * 4) /**< Initial size of the receive buffer */
+#define ACVP_CURL_BUF_RETAIN    (1024 * 1024) /**< Largest receive buffer kept between requests */
+#define ACVP_HUGE_PAGE_SIZE     (1024 * 1024 * 2) /**< Buffers this large may be backed by huge pages */
 #define ACVP_RETRY_TIME_MIN     5 /* seconds */
 #define ACVP_RETRY_TIME_MAX     300 /* 5 minutes */
 #define ACVP_MAX_WAIT_TIME      10800 /* 3 hours */
 #define ACVP_RETRY_TIME         30
 #define ACVP_RETRY_MODIFIER_MAX 10
+#define ACVP_MAX_PARALLEL_VS    64 /* arbitrary upper bound on concurrent vector set workers */
+#define ACVP_MAX_PARALLEL_TC    64 /* arbitrary upper bound on test case threads per test group */
+#define ACVP_FETCH_WINDOW_PER_WORKER 2 /* expected results fetched ahead of the one written, per worker */
+#define ACVP_MAX_AFFINITY_IDS   1024 /* CPUs or NUMA nodes given to acvp_set_worker_affinity() */
 #define ACVP_JWT_TOKEN_MAX      4096 /* arbitrary, but 2048 too low in some cases */
+#define ACVP_JWT_REFRESH_MARGIN 60   /* seconds before the JWT expires that it is refreshed */
 #define ACVP_ATTR_URL_MAX       2083 /* MS IE's limit - arbitrary */
 
 #define ACVP_SESSION_PARAMS_STR_LEN_MAX 256
 #define ACVP_REQUEST_STR_LEN_MAX 128
 #define ACVP_OE_STR_MAX 256
+#define ACVP_OE_LOOKUPS_MAX 8    /* server DB lookups done at once when verifying validation metadata */
 #define ACVP_PATH_SEGMENT_DEFAULT ""
 #define ACVP_JSON_FILENAME_MAX 1024
+#define ACVP_IS_STDIO(filename) ((filename)[0] == '-' && !(filename)[1]) /* "-": stdin or stdout */
+#define ACVP_RING_SLOTS_MAX 4096     /* slots of a shared memory ring, see acvp_ring_create() */
+#define ACVP_KEY_POOL_DEPTH_MAX 1024 /* keys generated ahead per curve or group, see acvp_cap_set_key_pool() */
 
 /* 
  * This should NOT be made longer than ACVP_JSON_FILENAME_MAX - 15
@@ -981,27 +1029,6 @@ struct acvp_result_desc_t {
     const char *desc;
 };
 
-struct acvp_hash_alg_info {
-    ACVP_HASH_ALG id;
-    const char *name;
-};
-
-struct acvp_ec_curve_info {
-    ACVP_EC_CURVE id;
-    const char *name;
-};
-
-/* This is used when we need a table of acceptable ciphers for specific situations */
-struct acvp_function_info {
-    ACVP_CIPHER cipher;
-    const char *name;
-};
-
-struct acvp_alt_revision_info {
-    ACVP_REVISION revision;
-    const char *name;
-};
-
 /* A generic struct that can match an enum with a string */
 struct acvp_enum_string_pair {
     unsigned int enum_value;
@@ -1064,7 +1091,9 @@ typedef enum acvp_capability_type {
 } ACVP_CAP_TYPE;
 
 /*
- * Supported length list
+ * Supported length list. The nodes of the SL, param and name lists are
+ * kept in one array per list, see acvp_append_sl_list(). Like everything
+ * else a capability holds they come from the cap_pool of the context.
  */
 typedef struct acvp_sl_list_t {
     int length;
@@ -1317,11 +1346,6 @@ typedef struct acvp_drbg_capability {
     ACVP_DRBG_MODE_LIST *drbg_cap_mode;
 } ACVP_DRBG_CAP;
 
-struct acvp_drbg_mode_name_t {
-    ACVP_DRBG_MODE mode;
-    const char *name;
-};
-
 typedef struct acvp_rsa_hash_pair_list {
     ACVP_HASH_ALG alg;
     const char *name;
@@ -1653,10 +1677,171 @@ typedef struct acvp_caps_list_t {
     } cap;
 
     int (*crypto_handler)(ACVP_TEST_CASE *test_case);
+    int (*batch_handler)(ACVP_TEST_CASE *test_cases, int *results, int count); /**< Optional, per test group */
+    int (*async_handler)(ACVP_TEST_CASE *test_case, ACVP_TC_HANDLE *handle); /**< Optional, per test case */
+    int async_depth;   /**< Most test cases handed to async_handler and not yet completed */
+    int (*mct_handler)(ACVP_TEST_CASE *test_case); /**< Optional, runs a whole MCT inner loop */
+    int (*mct_loop_handler)(ACVP_TEST_CASE *test_case); /**< Optional, runs a whole hash or TDES MCT */
+    int (*group_handler)(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event); /**< Optional, per test group */
+    int (*soa_handler)(ACVP_SYM_CIPHER_SOA *group, int *results); /**< Optional, AES AFT groups as arrays */
+    int (*hash_soa_handler)(ACVP_HASH_SOA *group, int *results); /**< Optional, hash AFT groups as arrays */
+    int (*rsa_sigver_soa_handler)(ACVP_RSA_SIGVER_SOA *group, int *results); /**< Optional, RSA SigVer groups as arrays */
+    ACVP_RING *ring;   /**< Optional, test cases are run by a crypto module in another process */
+    int ring_depth;    /**< Most test cases of a batch in the ring at once */
+    ACVP_DUT *dut;     /**< Optional, test cases are run by a remote device under test */
+    int dut_window;    /**< Most test cases of a batch sent to the device and not yet answered */
+    int (*key_producer)(ACVP_TEST_CASE *test_case); /**< Optional, generates KeyGen keys ahead of the test cases */
+    int key_pool_depth; /**< Keys kept ahead per curve or group, 0 if there is no key pool */
+    int output_sink;   /**< Long outputs are written through an ACVP_OUTPUT_SINK */
+    int bn_limbs;      /**< Big number inputs are decoded into ACVP_BN limbs */
 
     struct acvp_caps_list_t *next;
 } ACVP_CAPS_LIST;
 
+/*
+ * The capabilities of a session as they were when it was registered, see
+ * acvp_cap_snapshot_take(). Exec contexts share it and look capabilities up
+ * in it without locks; it is never changed, and a capability enabled
+ * afterwards only shows in the next snapshot. The references are counted
+ * under the session_lock of the session.
+ */
+typedef struct acvp_cap_snapshot_t {
+    ACVP_CAPS_LIST *index[ACVP_CIPHER_END];
+    int refs;
+} ACVP_CAP_SNAPSHOT;
+
+/*
+ * Identifies a test case handed to an async handler, for acvp_tc_complete()
+ */
+struct acvp_tc_handle_t {
+    struct acvp_tc_batch_t *batch;
+    int index;
+};
+
+/*
+ * The test cases of one test group, collected so that they can be handed
+ * to a capability's batch handler in a single call, or kept in flight on
+ * its async handler. The kat handler owns the algorithm specific test case
+ * structs the abstracted test cases point to.
+ */
+typedef struct acvp_tc_batch_t {
+    ACVP_TEST_CASE *tcs;   /**< Test cases in the order they were added */
+    int *results;          /**< What the crypto handler returned for each test case */
+    JSON_Value **rsp;      /**< Response of each test case, until it is appended to the group */
+    int count;
+    int max;
+    ACVP_TC_HANDLE *handles; /**< One per test case, while running on an async handler */
+    ACVP_MUTEX lock;       /**< Guards in_flight, next and results while test cases are out */
+    ACVP_COND completed;   /**< Signalled by acvp_tc_complete() */
+    int in_flight;
+    int next;              /**< Next test case for a thread to take, when run in parallel */
+    int done;              /**< Test cases run so far, when run in parallel */
+    ACVP_CAPS_LIST *cap;   /**< Capability of the test cases, while they are run in parallel */
+    unsigned long long int *cost; /**< Estimated cost of each test case, if the kat handler gave one */
+    int *order;            /**< Test cases most costly first, while they are run in parallel or async */
+    struct acvp_tc_batch_t *next_open; /**< Next of the batches open to other threads, see ACVP_TC_SCHED */
+    int numa_node;         /**< NUMA node of the worker running the batch, preferred by idle workers */
+} ACVP_TC_BATCH;
+
+/*
+ * Hands out the test cases of the batches being run in parallel. A batch is
+ * open while it has test cases no thread has taken yet: the threads started
+ * for it take them, and so do the workers of the pool that have no vector
+ * set of their own left to start, whichever vector set the batch is from.
+ * The next, done and next_open fields of the open batches are guarded by
+ * lock.
+ */
+typedef struct acvp_tc_sched_t {
+    ACVP_MUTEX lock;
+    ACVP_COND cond;         /**< Signalled as batches open, batches finish and vector sets end */
+    ACVP_TC_BATCH *open;
+    int active;             /**< Vector sets of the pool being processed */
+    unsigned int ended;     /**< Bumped as each stops being processed, idle workers then look for another */
+} ACVP_TC_SCHED;
+
+/*
+ * Where a field of a KDF135 test case comes from, see ACVP_KDF135_FIELD
+ */
+typedef enum acvp_kdf135_field_scope_t {
+    ACVP_KDF135_FIELD_TEST = 0, /**< Hex string of each test case */
+    ACVP_KDF135_FIELD_GROUP,    /**< Hex string of the test group, decoded once for all of its test cases */
+    ACVP_KDF135_FIELD_OUTPUT    /**< Buffer the crypto module writes to */
+} ACVP_KDF135_FIELD_SCOPE;
+
+#define ACVP_KDF135_FIELD_NO_LEN ((size_t)-1)
+
+/*
+ * A binary field of a KDF135 test case struct: the buffer pointer at offset
+ * data is pointed at max bytes that acvp_kdf135_tg_run() owns, and the int
+ * at offset len, if there is one, gets the decoded length.
+ *
+ * An output field is written to the response as hex by acvp_kdf135_tg_run()
+ * itself, with the length of the int at offset len, in bits if bits is set,
+ * or else fixed bytes. One with neither is left to the output_tc of the
+ * ACVP_KDF135_TG.
+ */
+typedef struct acvp_kdf135_field_t {
+    const char *name;              /**< JSON key, also used in log messages */
+    ACVP_KDF135_FIELD_SCOPE scope;
+    size_t data;                   /**< offsetof() the buffer pointer */
+    size_t len;                    /**< offsetof() the int length, or ACVP_KDF135_FIELD_NO_LEN */
+    int max;                       /**< Bytes of the buffer */
+    ACVP_RESULT missing;           /**< Returned when the JSON lacks the field */
+    int bits;                      /**< The int at offset len of an output field is in bits */
+    int fixed;                     /**< Bytes of an output field without a length */
+} ACVP_KDF135_FIELD;
+
+/*
+ * Describes the test cases of a KDF135 kat handler to acvp_kdf135_tg_run()
+ */
+typedef struct acvp_kdf135_tg_t {
+    const char *name;              /**< For log messages */
+    size_t tc_size;                /**< sizeof() the test case struct */
+    size_t tc_id;                  /**< offsetof() its unsigned int tc_id */
+    const ACVP_KDF135_FIELD *fields;
+    int field_cnt;
+    /** Points the abstracted test case at the algorithm specific one */
+    void (*bind)(ACVP_TEST_CASE *tc, void *stc);
+    /** Optional, for what the fields do not cover; called once they are filled in */
+    ACVP_RESULT (*init_tc)(ACVP_CTX *ctx, void *stc, JSON_Object *testobj);
+    /** Optional, for what the output fields do not cover; called once they are output */
+    ACVP_RESULT (*output_tc)(ACVP_CTX *ctx, void *stc, JSON_Object *tc_rsp);
+} ACVP_KDF135_TG;
+
+/*
+ * The test cases and buffers of acvp_kdf135_tg_run(), kept from one test
+ * group to the next and released with acvp_kdf135_tg_free()
+ */
+typedef struct acvp_kdf135_tg_slots_t {
+    unsigned char *stcs;
+    unsigned char *buf;            /**< Buffers of the group fields, then those of each test case */
+    int size;                      /**< Test cases there is room for */
+} ACVP_KDF135_TG_SLOTS;
+
+/*
+ * Progress of a long running test case, see acvp_tc_progress(). It is
+ * only touched by the thread running the test case.
+ */
+struct acvp_tc_control_t {
+    ACVP_CTX *ctx;
+    ACVP_TC_PROGRESS progress;
+    unsigned long long int start;    /**< acvp_metrics_now() at the first progress report */
+    unsigned long long int deadline; /**< acvp_metrics_now() past which it is given up, 0 for never */
+    int cancelled;
+};
+
+/*
+ * The keys seen in a test group, see acvp_tg_key_id_parts(). Each key is
+ * kept as the part_cnt strings it is made of, one after the other. The
+ * strings are those of the vector set JSON, which outlives the group.
+ */
+typedef struct acvp_tg_keys_t {
+    const char **parts;
+    int part_cnt;
+    unsigned int count;
+    unsigned int size;
+} ACVP_TG_KEYS;
+
 typedef struct acvp_vendor_address_t {
     char *street_1;
     char *street_2;
@@ -1787,6 +1972,457 @@ typedef struct acvp_fips_t {
     ACVP_OE *oe; /* Pointer to the Operating Environment to use for this validation */
 } ACVP_FIPS;
 
+/*
+ * Transitory state for the single operation (vector set or HTTP exchange) a
+ * context is performing. Every context has its own, so several exec contexts
+ * derived from one session can be in flight on different threads at once.
+ */
+#define ACVP_ARENA_CHUNK_MIN (64 * 1024) /**< Smallest chunk the test case arena allocates */
+#define ACVP_VS_LAZY_PARSE_MIN (16 * 1024 * 1024) /**< Downloaded vector sets this large are parsed a test group at a time */
+#define ACVP_ARENA_ALIGN 16
+
+/*
+ * Bytes of memory a context holds, see acvp_get_memory_usage(). Its arenas,
+ * its curl_buf and the JSON values made on the heap while it processes a
+ * vector set are counted; every change is made to the counters of the
+ * session too, through parent. The counters of exec contexts are kept by the
+ * session until it is freed, as what they allocated may outlive them.
+ */
+typedef struct acvp_mem_acct_t {
+    volatile size_t current;
+    volatile size_t peak;
+    volatile size_t vs_peak;        /* Peak since the vector set being processed was started */
+    struct acvp_mem_acct_t *parent; /* The session's, NULL on the session itself */
+    struct acvp_mem_acct_t *next;   /* Next of the exec context counters the session keeps */
+} ACVP_MEM_ACCT;
+
+/*
+ * What a vector set the session has finished used, see acvp_get_memory_usage()
+ */
+typedef struct acvp_mem_vs_t {
+    int vs_id;
+    ACVP_MEMORY_USAGE usage;
+    struct acvp_mem_vs_t *next;
+} ACVP_MEM_VS;
+
+/*
+ * Bump allocator for the buffers of the test case being processed. Memory
+ * is handed out zeroed and is all given back, and wiped, at once by
+ * acvp_arena_reset(); after the first few test cases of a vector set no
+ * further allocations are made. A test group handed to a batch handler
+ * keeps the buffers of all its test cases until the group is output.
+ */
+typedef struct acvp_arena_chunk_t {
+    struct acvp_arena_chunk_t *next;
+    size_t size;            /* Usable bytes following the header */
+    size_t used;
+} ACVP_ARENA_CHUNK;
+
+typedef struct acvp_arena_t {
+    ACVP_ARENA_CHUNK *head; /* Chunk allocations are made from; older chunks follow */
+    size_t hint;            /* Size needed last time, so one chunk fits everything next time */
+    ACVP_MEM_ACCT *acct;    /* Charged for the chunks, if set */
+} ACVP_ARENA;
+
+/*
+ * Scratch buffer for test case output, such as the hex string of a key, that
+ * keeps track of how much of it holds data. Writing a value wipes only what
+ * is left of a longer one before it, and acvp_sbuf_release() wipes only the
+ * bytes that were used, not the whole ACVP_*_MAX sized buffer.
+ */
+typedef struct acvp_sbuf_t {
+    char *buf;
+    size_t size;            /* Bytes buf holds */
+    size_t used;            /* Bytes of buf that may hold data */
+    int owned;              /* buf was allocated by acvp_sbuf_init() */
+} ACVP_SBUF;
+
+/* An ACVP_SBUF over a caller's array, still to be given to acvp_sbuf_release() */
+#define ACVP_SBUF_WRAP(array) { (array), sizeof(array), 0, 0 }
+
+/*
+ * Output of a test case the crypto module writes with acvp_output_write(),
+ * see acvp_cap_set_output_sink(). It is hex encoded as it comes into a
+ * string from the JSON allocator, which then goes into the response as is.
+ */
+struct acvp_output_sink_t {
+    char *hex;              /* 2 * max + 1 chars, NULL once it is in the response */
+    unsigned int max;       /* Bytes the test case outputs */
+    unsigned int len;       /* Bytes written so far */
+};
+
+/* The async log sink, see acvp_set_async_log() */
+typedef struct acvp_log_ring_t ACVP_LOG_RING;
+
+/* An output file written by a thread of its own, see acvp_writer.c */
+typedef struct acvp_writer_t ACVP_WRITER;
+
+/*
+ * Test group responses of the vector set being processed that were moved out
+ * of memory, see acvp_set_memory_budget(). The groups are kept in fp as they
+ * are serialized, separated by commas, ready to go into a testGroups array.
+ */
+typedef struct acvp_rsp_spill_t {
+    FILE *fp;
+    long len;               /**< Bytes of fp that hold whole groups */
+    int count;              /**< Groups in fp */
+    int sized;              /**< Groups of rsp_groups counted in size */
+    size_t size;            /**< Serialized size of the groups of rsp_groups counted so far */
+    int failed;             /**< fp could not be written, the groups stay in memory */
+} ACVP_RSP_SPILL;
+
+/*
+ * Crypto handler timings gathered on an exec context for the exporter, see
+ * acvp_openmetrics.c. bucket holds the test cases that took up to each bound
+ * and is not cumulative.
+ */
+#define ACVP_OM_CRYPTO_BUCKETS 8
+typedef struct acvp_om_crypto_t {
+    unsigned long long int cases;
+    unsigned long long int ns;
+    unsigned long long int bucket[ACVP_OM_CRYPTO_BUCKETS];
+} ACVP_OM_CRYPTO;
+
+/*
+ * Crypto handler latency, see acvp_latency.c. Values below 2 * ACVP_LAT_SUB
+ * ns have a bucket each, then each power of two is split into ACVP_LAT_SUB
+ * buckets, up to about 78 hours.
+ */
+#define ACVP_LAT_SUB 16
+#define ACVP_LAT_BUCKETS 720
+typedef struct acvp_lat_hist_t {
+    unsigned long long int count;
+    unsigned long long int sum_ns;
+    unsigned long long int min_ns;
+    unsigned long long int max_ns;
+    unsigned long long int bucket[ACVP_LAT_BUCKETS];
+} ACVP_LAT_HIST;
+
+typedef struct acvp_lat_case_t {
+    int tg_id;
+    int tc_id;              /* 0 for algorithms whose test cases carry no tcId */
+    unsigned long long int ns;
+} ACVP_LAT_CASE;
+
+/* The slowest test cases of a vector set, slowest first */
+typedef struct acvp_lat_slowest_t {
+    int vs_id;
+    ACVP_CIPHER cipher;
+    int cnt;
+    ACVP_LAT_CASE cases[ACVP_LAT_SLOWEST_MAX];
+    struct acvp_lat_slowest_t *next;
+} ACVP_LAT_SLOWEST;
+
+/*
+ * Adaptive transfer concurrency, see acvp_xfer.c. Owned by the session,
+ * its exec contexts use the same one.
+ */
+typedef struct acvp_xfer_ctl_t {
+    ACVP_MUTEX lock;
+    ACVP_COND cond;             /* Signalled as requests finish */
+    int limit;                  /* Requests that may be out at once */
+    int max;
+    int in_flight;
+    int win_done;               /* Requests finished in the window */
+    unsigned long long int win_bytes;
+    unsigned long long int win_ns;  /* Summed latency of the requests of the window */
+    unsigned long long int win_start;
+    int win_full;               /* Set when the window had all slots taken at some point */
+    unsigned long long int prev_rate;
+    unsigned long long int best_lat;
+    unsigned long long int backoff_until;
+    int grew;                   /* Set when limit was raised at the end of the last window */
+    int hold;                   /* Windows left before limit may be raised again */
+} ACVP_XFER_CTL;
+
+#define ACVP_HEDGE_SAMPLES 64        /* Recent GETs the hedge delay is worked out from */
+#define ACVP_HEDGE_SAMPLES_MIN 8     /* GETs to see before any is hedged */
+#define ACVP_HEDGE_DELAY_MIN_MS 10   /* Never hedged sooner than this */
+
+/*
+ * Hedged GETs, see acvp_xfer.c. Owned by the session, its exec contexts
+ * use the same one.
+ */
+typedef struct acvp_hedge_ctl_t {
+    ACVP_MUTEX lock;
+    unsigned long long int ttfb[ACVP_HEDGE_SAMPLES]; /* Time to the first byte of recent GETs, a ring */
+    int cnt;
+    int next;
+    unsigned long long int hedged;  /* GETs sent a second time */
+    unsigned long long int won;     /* Of those, answered first by the second one */
+} ACVP_HEDGE_CTL;
+
+/*
+ * Result memo of deterministic test groups, see acvp_memo.c. Owned by the
+ * session, its exec contexts use the same one.
+ */
+typedef struct acvp_memo_t {
+    ACVP_MUTEX lock;
+    char *filename;
+    int sample_pct;
+    int loaded;                 /* Set once the store file has been read */
+    int drifted;                /* Set once a sampled group did not match; nothing more is taken from the store */
+    unsigned long long int rng; /* State of the xorshift picking the groups to sample */
+    JSON_Value *index;          /* Stored group responses keyed by acvp_memo_key() */
+    ACVP_MEMO_STATS stats;
+} ACVP_MEMO;
+
+/* The HTTP methods requests to the server are counted by */
+typedef enum acvp_om_method {
+    ACVP_OM_GET = 0,
+    ACVP_OM_POST,
+    ACVP_OM_PUT,
+    ACVP_OM_DELETE,
+    ACVP_OM_METHOD_MAX
+} ACVP_OM_METHOD;
+
+typedef struct acvp_exec_ctx_t {
+    int vs_id;              /* vs_id currently being processed */
+    JSON_Value *kat_resp;   /* holds the current set of vector responses */
+    char *curl_buf;         /**< Data buffer for inbound Curl messages */
+    int curl_read_ctr;      /**< Total number of bytes written to the curl_buf */
+    int curl_buf_size;      /**< Allocated size of curl_buf */
+    int curl_buf_mapped;    /**< curl_buf is a mapping rather than from the heap, see acvp_big_alloc() */
+    int huge_pages;         /**< See acvp_set_huge_pages(), copied to exec contexts */
+    ACVP_MEM_ACCT *mem;     /**< Memory held by the context, see acvp_mem_init() */
+    void *curl_hnd;         /**< Curl easy handle kept open across requests */
+    void *curl_hedge_hnd;   /**< Curl easy handle second GETs are sent on, see acvp_set_hedged_requests() */
+    void *curl_multi;       /**< Curl multi handle GETs are sent through when they may be hedged */
+    FILE *upload_fp;        /**< When set, body of the next POST/PUT is read from here */
+    FILE *vs_resp_fp;       /**< Vector set responses serialized by acvp_serialize_vs_resp(), posted next */
+    const char *vs_resp_str; /**< Vector set responses already serialized by the caller, posted next */
+    int vs_resp_len;        /**< Size of vs_resp_fp or vs_resp_str */
+    ACVP_ARENA tc_arena;    /**< Buffers of the test case being processed */
+    ACVP_ARENA json_arena;  /**< JSON values of the vector set being processed */
+    ACVP_METRICS vs_metrics; /**< Timings of the vector set being processed */
+    ACVP_METRICS tg_metrics; /**< Timings of the test group being processed, if tg_metrics.tg_id */
+    unsigned long long int tg_start; /**< When the current test group was started */
+    JSON_Array *rsp_groups; /**< Test group responses of the vector set being processed */
+    int rsp_groups_saved;   /**< How many of rsp_groups are in the checkpoint journal */
+    JSON_Value *journal;    /**< Test groups of the vector set taken from the checkpoint journal */
+    JSON_Value *memo;       /**< Test groups of the vector set run with a result memo, by tgId, see acvp_memo.c */
+    ACVP_RSP_SPILL spill;   /**< Test group responses moved to disk */
+    unsigned long long int vs_start; /**< When the vector set was started, for its events */
+    int tg_cnt;             /**< Test groups of the vector set to run, for its events */
+    int tg_done;            /**< Test groups of the vector set done so far */
+    int event_tg_id;        /**< Test group being processed, for its event; 0 if none */
+    unsigned long long int event_tg_start; /**< When event_tg_id was started */
+    int worker;             /**< Number of the pool worker the context is for, see acvp_worker_pin() */
+    int numa_node;          /**< NUMA node the worker is pinned to, 0 unless pinned to one */
+    ACVP_CIPHER cipher;     /**< Algorithm of the vector set being processed, for the exporter */
+    ACVP_OM_CRYPTO om_crypto; /**< Crypto handler timings not yet added to the exporter */
+    unsigned long long int span_cur; /**< Innermost open trace span, 0 if none */
+    ACVP_SPAN tg_span;      /**< Trace span of the test group in progress, if tg_span.span_id */
+    int tg_id;              /**< Test group the KAT handler is on, see acvp_metrics_tg_begin() */
+    ACVP_LAT_HIST *lat_vs;  /**< Crypto handler latency of the vector set being processed */
+    ACVP_LAT_CASE lat_cases[ACVP_LAT_SLOWEST_MAX]; /**< Its slowest test cases so far, unordered */
+    int lat_case_cnt;
+    int lat_tc_id_off;      /**< Offset of tc_id in the test cases of the vector set, -1 if none */
+} ACVP_EXEC_CTX;
+
+/*
+ * A vector set downloaded, and parsed unless it is large, by the reader of a
+ * pool ahead of the worker that processes it, see acvp_vs_reader()
+ */
+typedef struct acvp_vs_read_t {
+    char *buf;              /* As the download buffer of an exec context; NULL if nothing is waiting */
+    int len;
+    int size;
+    int mapped;
+    int cached;             /* From the download cache rather than the server */
+    int parsed;             /* buf was parsed in place into val, NULL if it did not parse */
+    JSON_Value *val;
+    unsigned long long int transport_ns; /* For the metrics of the worker */
+    unsigned long long int parse_ns;
+} ACVP_VS_READ;
+
+/*
+ * A single vector set queued for processing by a worker pool
+ */
+typedef struct acvp_vs_job_t {
+    char *vsid_url;
+    JSON_Object *vs_obj;    /* Offline runs: the vector set read from the request file */
+    ACVP_RESULT rv;
+    int done;
+    int in_progress;        /* A worker currently owns this job */
+    time_t next_try;        /* Earliest time the server said the vector set may be ready */
+    unsigned int waited;    /* Total time spent waiting on the server for this vector set */
+    double cost;            /* Estimated nanoseconds of work, 0 if unknown, see acvp_vs_cost() */
+    JSON_Value *saved;      /* Downloaded vector set (or offline responses) waiting to be written to file in order */
+    FILE *saved_fp;         /* Offline responses that were moved to disk, serialized, instead of saved */
+    int uploading;          /* The responses were handed to the sender, which finishes the job */
+    int reading;            /* The reader of the pool is downloading it */
+    int read_failed;        /* The reader could not download it; left to the worker */
+    ACVP_VS_READ read;
+} ACVP_VS_JOB;
+
+/*
+ * Responses of a vector set waiting for the sender of the pool to post them,
+ * along with what the worker that computed them knew of the vector set.
+ */
+typedef struct acvp_vs_upload_t {
+    int index;              /* Job of the pool */
+    int vs_id;
+    FILE *fp;               /* Serialized responses, see acvp_serialize_vs_resp() */
+    int len;
+    ACVP_METRICS metrics;   /* Timings of the vector set until now */
+    unsigned long long int vs_start; /* For the events of the vector set */
+    struct acvp_vs_upload_t *next;
+} ACVP_VS_UPLOAD;
+
+#define ACVP_VS_UPLOAD_QUEUE_MAX 8 /* Workers wait once this many responses are waiting to be posted */
+#define ACVP_VS_READ_QUEUE_MAX 2   /* The reader waits once this many vector sets are waiting for workers */
+
+/*
+ * Shared state for processing the vector sets of a session. Jobs are handed
+ * out in order of readiness, so a vector set the server is still generating
+ * does not hold up the ones behind it. Each worker thread runs with its own
+ * exec context (see acvp_create_exec_ctx); a serial run without a sender uses
+ * the session context as its only worker. The job queue, the sender queue and
+ * file output are guarded by the pool lock.
+ *
+ * When responses are posted to the server, sender threads of the pool can
+ * do that while the workers move on to the next vector set; a job whose
+ * responses wait in the sender queue stays in progress until they are sent.
+ * Likewise a reader thread downloads and parses the vector sets ahead of the
+ * workers, so the three stages of a vector set overlap with those of others.
+ */
+typedef struct acvp_worker_pool_t {
+    ACVP_MUTEX lock;
+    ACVP_VS_JOB *jobs;
+    int job_count;
+    int next_save;          /* Index of the next job whose vector set is written to file */
+    int abort;              /* Set once any job fails; workers stop picking up new jobs */
+    const char *rsp_filename; /* Offline runs: file the responses are written to */
+    ACVP_WRITER *rsp_writer; /* Offline runs: writes rsp_filename, opened and closed by the caller */
+    int sending;            /* Sender threads post the responses workers queue on uploads */
+    int sender_stop;        /* No more uploads will be queued; senders exit once they are posted */
+    ACVP_VS_UPLOAD *uploads; /* Oldest first */
+    ACVP_VS_UPLOAD *uploads_tail;
+    int upload_cnt;
+    ACVP_COND upload_cond;  /* Signalled as uploads are queued and taken */
+    int reading;            /* A reader thread downloads vector sets ahead of the workers */
+    int reader_stop;        /* The workers are done; the reader exits */
+    int read_cnt;           /* Jobs with a read waiting for a worker */
+    ACVP_COND read_cond;    /* Signalled as reads are done and taken */
+    int worker_cnt;         /* Workers processing the jobs */
+    ACVP_TC_SCHED sched;    /* Test cases of the vector sets in progress, shared among the workers */
+} ACVP_WORKER_POOL;
+
+/*
+ * A GET of a vector set, of its results or of its expected results, done
+ * with others at once, see acvp_fetch_vector_sets()
+ */
+typedef struct acvp_fetch_job_t {
+    const char *url;        /* Vector set URL */
+    char *body;             /* Response body, once fetched */
+    ACVP_RESULT rv;
+    int done;               /* Set once fetched, whether or not that worked */
+} ACVP_FETCH_JOB;
+
+/* What the jobs of a fetch pool GET */
+typedef enum acvp_fetch_kind {
+    ACVP_FETCH_VS = 0,
+    ACVP_FETCH_RESULTS,     /* The results of the vector sets */
+    ACVP_FETCH_EXPECTED     /* The expected results of the vector sets of a sample session */
+} ACVP_FETCH_KIND;
+
+typedef struct acvp_fetch_pool_t {
+    ACVP_MUTEX lock;        /* Guards next, taken, stop and the done flags of the jobs */
+    ACVP_COND cond;         /* Signalled as jobs are done and taken */
+    ACVP_CTX *ctx;          /* The session */
+    ACVP_FETCH_JOB *jobs;
+    int count;
+    int next;               /* Next job to hand out */
+    ACVP_FETCH_KIND kind;
+    int window;             /* Jobs that may be fetched ahead of those taken, 0 for no limit */
+    int taken;              /* Jobs taken by acvp_fetch_take() */
+    int stop;               /* Hand out no more jobs */
+    struct acvp_fetch_thread_t *workers;
+    ACVP_THREAD *threads;
+    int started;            /* Worker threads running, 0 if the jobs are fetched on the session */
+} ACVP_FETCH_POOL;
+
+/*
+ * Where a session run by an orchestrator is at, see acvp_orch_run()
+ */
+typedef enum acvp_orch_state {
+    ACVP_ORCH_PENDING = 0,  /* Waiting for a worker to log in and register */
+    ACVP_ORCH_REGISTERING,
+    ACVP_ORCH_VECTORS,      /* Vector sets are handed out from the pool */
+    ACVP_ORCH_RESULTS,      /* A worker is checking the results */
+    ACVP_ORCH_DONE
+} ACVP_ORCH_STATE;
+
+typedef struct acvp_orch_session_t {
+    ACVP_CTX *ctx;
+    int fips_validation;
+    ACVP_ORCH_STATE state;
+    ACVP_RESULT rv;
+    ACVP_WORKER_POOL pool;  /* Vector sets of the session while in ACVP_ORCH_VECTORS */
+    void *curl_share;       /* The session's own curl share, put back after the run */
+} ACVP_ORCH_SESSION;
+
+/*
+ * Where a session driven by acvp_session_step() is at
+ */
+typedef enum acvp_step_state {
+    ACVP_STEP_LOGIN = 0,
+    ACVP_STEP_REGISTER,
+    ACVP_STEP_VECTORS,      /* A vector set from the pool each step */
+    ACVP_STEP_RESULTS,      /* The results are polled for, a poll each step */
+    ACVP_STEP_DONE
+} ACVP_STEP_STATE;
+
+typedef struct acvp_step_t {
+    ACVP_STEP_STATE state;
+    int fips_validation;
+    ACVP_RESULT rv;         /* Of the session, once ACVP_STEP_DONE */
+    ACVP_WORKER_POOL pool;  /* Vector sets of the session while in ACVP_STEP_VECTORS */
+    int running;            /* Set during a step, so waits on the server are handed back rather than slept */
+    int wait;               /* Seconds the server asked for, set by acvp_retry_handler() while running */
+    int checking;           /* The results have been asked for at least once */
+    unsigned int waited;    /* Carried from one poll of the results to the next */
+    int retry_interval;
+} ACVP_STEP;
+
+/*
+ * The validation metadata lookups of the sessions of an orchestrator, so a
+ * Vendor, Module, OE or Dependency that several sessions have is searched
+ * for in the server DB once. entries is an array of objects keyed as the
+ * cache file is; an entry with "pending" set is being looked up by one
+ * session and the others wait on cond for it, one without "urls" was not
+ * found, and one with "retry" set failed to be looked up and is looked up
+ * again by the next session to ask for it. Entries are kept for the run
+ * only.
+ */
+typedef struct acvp_meta_share_t {
+    ACVP_MUTEX lock;
+    ACVP_COND cond;
+    JSON_Value *entries;
+} ACVP_META_SHARE;
+
+/*
+ * Runs the test sessions of several contexts with one set of worker threads.
+ * The workers register the sessions, then take vector sets from all of them
+ * in order of readiness, so one session waiting on the server does not hold
+ * up the others, and finally check the results of each session. All
+ * sessions use the same curl share and each worker keeps one curl handle to
+ * the server for whichever session it is working on. The session list and
+ * the session states are guarded by the lock.
+ */
+struct acvp_orch_t {
+    ACVP_MUTEX lock;
+    ACVP_ORCH_SESSION *sessions;
+    int session_cnt;
+    int session_max;        /* Allocated size of sessions */
+    int next_session;       /* Where the search for the next vector set starts */
+    int max_workers;
+    int running;
+    void *curl_share;
+    ACVP_META_SHARE *meta_share;  /* Set while running, when a session does a validation */
+};
+
 /*
  * This struct holds all the global data for a test session, such
  * as the server name, port#, etc.  Some of the values in this
@@ -1806,11 +2442,12 @@ struct acvp_ctx_t {
     char *tls_cert;         /* Location of PEM encoded X509 cert to use for TLS client auth */
     char *tls_key;          /* Location of PEM encoded priv key to use for TLS client auth */
 
-    char *http_user_agent;   /* String containing info to be sent with HTTP requests, currently OE info */
+    int user_agent_logged;   /* The HTTP user-agent, see acvp_http_user_agent(), has been logged */
     char *session_file_path; /* String containing the path of the testSession file after it is created when applicable */
     
     ACVP_OPERATING_ENV op_env; /**< The Operating Environment resources available */
     ACVP_STRING_LIST *vsid_url_list;
+    int rerun_failed;       /* Set while acvp_rerun_failed_vector_sets() runs vector sets */
     char *session_url;
     int session_passed;
 
@@ -1818,7 +2455,27 @@ struct acvp_ctx_t {
     int use_json;           /* flag to indicate a JSON file is being used for registration */
     int is_sample;          /* flag to idicate that we are requesting sample vector responses */
     char *vector_req_file;  /* filename to use to store vector request JSON */
+    char *vs_cache_file;    /* filename of the compiled cache of offline request files */
+    char *reg_cache_file;   /* filename of the cache of the serialized registration */
+    char *meta_cache_file;  /* filename of the cache of validation metadata lookups */
+    long meta_cache_ttl;    /* seconds the URLs in meta_cache_file are trusted for */
+    JSON_Value *meta_cache; /* meta_cache_file while the validation metadata is verified */
+    int meta_cache_dirty;   /* set when meta_cache has entries not yet saved */
+    ACVP_META_SHARE *meta_share; /* lookups shared with the other sessions of acvp_orch_run() */
+    char *journal_file;     /* filename of the checkpoint journal of finished test groups */
+    char *vs_dl_cache_dir;  /* directory of the cache of downloaded vector sets */
+    char *remote_dir;       /* directory shared with the remote workers, see acvp_set_remote_workers() */
+    int remote_timeout;     /* seconds to wait for a remote worker, 0 for ACVP_MAX_WAIT_TIME */
+    size_t memory_budget;   /* serialized size of a vector set's responses kept in memory, 0 for no limit */
     int vector_req;         /* flag to indicate we are storing vector request JSON in a file */
+    int vector_req_compact; /* flag to store vector request JSON compact rather than pretty */
+    int vector_rsp_compact; /* flag to store vector response JSON compact rather than pretty */
+    int *vs_filter;         /* vsIds acvp_run_vectors_from_file() is limited to, if vs_filter_cnt */
+    int vs_filter_cnt;
+    int vs_shard;           /* shard of the request file acvp_run_vectors_from_file() runs, from 1 */
+    int vs_shard_cnt;       /* number of shards the request file is split into, 0 for none */
+    ACVP_WRITER *vector_req_writer; /* writes vector_req_file while vector sets are being saved */
+    ACVP_WRITER *rsp_writer; /* writes the response file of an offline run while it is under way */
     int vector_rsp;         /* flag to indicate we are storing vector responses JSON in a file */
     int get;                /* flag to indicate we are only getting status or metadata */
     char *get_string;       /* string used for get request */
@@ -1835,38 +2492,108 @@ struct acvp_ctx_t {
     /* test session data */
     ACVP_VS_LIST *vs_list;
     char *jwt_token; /* access_token provided by server for authenticating REST calls */
+    time_t jwt_expiry; /* When jwt_token expires, 0 if unknown, see acvp_jwt_expiry() */
     char *tmp_jwt; /* access_token provided by server for authenticating a single REST call */
     int use_tmp_jwt; /* 1 if the tmp_jwt should be used */
     JSON_Value *registration; /* The capability registration string sent when creating a test session */
 
     /* crypto module capabilities list */
     ACVP_CAPS_LIST *caps_list;
+    /* everything caps_list holds is allocated from here and freed at once */
+    ACVP_ARENA cap_pool;
+    /* the entry of caps_list for each cipher, NULL if not registered */
+    ACVP_CAPS_LIST *caps_index[ACVP_CIPHER_END];
+    /* caps_index when the session was registered; exec contexts hold a reference to it */
+    ACVP_CAP_SNAPSHOT *caps_snap;
+    /* bumped by every change to the capabilities or the registration */
+    unsigned int caps_gen;
+    /* acvp_get_current_registration() as of caps_gen reg_str_gen, if set */
+    char *reg_str;
+    int reg_str_len;
+    unsigned int reg_str_gen;
     /* Maintain a count of the number of registered vector sets so we can evaluate cost. This can be >= caps_list size */
     int vs_count;
+    /* settings are checked against each other by acvp_cap_finalize(), not as they are made */
+    int caps_deferred;
 
     /* application callbacks */
     ACVP_RESULT (*test_progress_cb) (char *msg, ACVP_LOG_LVL level);
+    ACVP_LOG_RING *log_ring;   /**< Async log sink, shared with exec contexts; NULL if off */
 
     /* Two-factor authentication callback */
     ACVP_RESULT (*totp_cb) (char **token, int token_max);
 
     /* Transitory values */
-    int vs_id;      /* vs_id currently being processed */
+    ACVP_EXEC_CTX exec;        /**< State of the operation in progress on this context */
 
-    JSON_Value *kat_resp; /* holds the current set of vector responses */
-
-    char *curl_buf;       /**< Data buffer for inbound Curl messages */
-    int curl_read_ctr;    /**< Total number of bytes written to the curl_buf */
     int post_size_constraint;  /**< The number of bytes that the body of an HTTP POST may contain
                                     without requiring the use of the /large endpoint. If the POST body
                                     is larger than this value, then use of the /large endpoint is necessary */
 
+    int max_parallel_vs;       /**< Number of vector sets that may be processed concurrently */
+    int max_parallel_tc;       /**< Number of threads the test cases of a group may be spread across */
+    unsigned long long int tc_cost[ACVP_CIPHER_END]; /**< See acvp_set_test_case_cost(), 0 for the built-in estimate */
+    ACVP_AFFINITY affinity;    /**< See acvp_set_worker_affinity() */
+    int *affinity_ids;         /**< CPUs or NUMA nodes of affinity, owned by the session */
+    int affinity_cnt;
+    void (*metrics_cb)(const ACVP_METRICS *metrics, void *arg); /**< See acvp_set_metrics_cb() */
+    void *metrics_arg;
+    ACVP_RESULT (*cap_loader)(ACVP_CTX *ctx, ACVP_CIPHER cipher, void *arg); /**< See acvp_set_cap_loader() */
+    void *cap_loader_arg;
+    void (*event_cb)(const ACVP_EVENT *event, void *arg); /**< See acvp_set_event_cb() */
+    void *event_arg;
+    ACVP_OPENMETRICS *openmetrics; /**< See acvp_set_openmetrics(), owned by the application */
+    void (*span_start_cb)(const ACVP_SPAN *span, void *arg); /**< See acvp_set_trace_cb() */
+    void (*span_end_cb)(const ACVP_SPAN *span, void *arg);
+    void *span_arg;
+    int lat_enabled;           /**< See acvp_set_crypto_latency() */
+    int lat_slowest;           /**< Slowest test cases of each vector set to keep */
+    ACVP_LAT_HIST **lat_hist;  /**< Latency by cipher, guarded by session_lock; exec contexts use the session's */
+    ACVP_LAT_SLOWEST *lat_slowest_list; /**< Slowest test cases of the session, guarded by session_lock */
+    ACVP_XFER_CTL *xfer;       /**< See acvp_set_adaptive_transfers(); exec contexts use the session's */
+    ACVP_HEDGE_CTL *hedge;     /**< See acvp_set_hedged_requests(); exec contexts use the session's */
+    int request_timeout;       /**< Milliseconds a GET may take, see acvp_set_request_timeout(); 0 for no limit */
+    ACVP_MEMO *memo;           /**< See acvp_set_result_memo(); exec contexts use the session's */
+    int (*idle_cb)(unsigned int budget_ms, void *arg); /**< See acvp_set_idle_cb() */
+    void *idle_arg;
+    int tc_deadline;           /**< Seconds a long running test case may take, see acvp_set_tc_deadline() */
+    int (*tc_progress_cb)(const ACVP_TC_PROGRESS *progress, void *arg); /**< See acvp_set_tc_progress_cb() */
+    void *tc_progress_arg;
+    ACVP_WORKER_POOL *pool;    /**< Set only on worker contexts created by acvp_process_tests */
+    ACVP_STEP *step;           /**< See acvp_session_step(), not set on exec contexts */
+
+    ACVP_CTX *session;         /**< Set only on exec contexts; the context that owns the session */
+    ACVP_MUTEX session_lock;   /**< Serializes access to the session JWT from exec contexts */
+    ACVP_MEM_ACCT *mem_accts;  /**< Memory counters of the exec contexts, guarded by session_lock */
+    ACVP_MEM_VS *mem_vs;       /**< Memory used by the finished vector sets, guarded by session_lock */
+    struct acvp_dsa_pqg_t *dsa_pqg;   /**< DSA domain parameters kept for reuse, see acvp_dsa.c */
+    ACVP_MUTEX dsa_pqg_lock;   /**< Guards dsa_pqg; exec contexts use the session's */
+    struct acvp_key_pool_t *key_pools; /**< KeyGen keys generated ahead, see acvp_key_pool.c */
+    ACVP_MUTEX key_pool_lock;  /**< Guards key_pools; exec contexts use the session's */
+    ACVP_MUTEX meta_cache_lock; /**< Guards meta_cache; exec contexts use the session's */
+    ACVP_MUTEX journal_lock;   /**< Guards journal_file; exec contexts use the session's */
+    void *curl_share;          /**< Curl state (DNS, TLS sessions) shared with exec contexts */
+    void *preconnect;          /**< Connection to the server under way, see acvp_preconnect() */
 };
 
 ACVP_RESULT acvp_check_test_results(ACVP_CTX *ctx);
 
+void acvp_dsa_pqg_free(ACVP_CTX *ctx);
+
+void acvp_key_pool_prime(ACVP_CTX *ctx);
+int acvp_key_pool_take(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, int group, int mode, ACVP_TEST_CASE *tc);
+void acvp_key_pool_free(ACVP_CTX *ctx);
+
+const ACVP_FFC_GROUP *acvp_lookup_safe_primes_group(ACVP_SAFE_PRIMES_MODE dgm);
+const ACVP_FFC_GROUP *acvp_lookup_kas_ffc_group(ACVP_KAS_FFC_PARAM dgm);
+ACVP_ECDSA_SECRET_GEN_MODE acvp_ecdsa_read_secret_gen_mode(const char *str);
+
 ACVP_RESULT acvp_process_tests(ACVP_CTX *ctx);
 
+ACVP_CTX *acvp_create_exec_ctx(ACVP_CTX *session);
+
+void acvp_free_exec_ctx(ACVP_CTX *ctx);
+
 ACVP_RESULT acvp_send_test_session_registration(ACVP_CTX *ctx, char *reg, int len);
 
 ACVP_RESULT acvp_send_login(ACVP_CTX *ctx, char *login, int len);
@@ -1888,9 +2615,28 @@ ACVP_RESULT acvp_retrieve_vector_set_result(ACVP_CTX *ctx, const char *vsid_url)
 ACVP_RESULT acvp_retrieve_expected_result(ACVP_CTX *ctx, const char *api_url);
 
 ACVP_RESULT acvp_submit_vector_responses(ACVP_CTX *ctx, char *vsid_url);
+FILE *acvp_serialize_vs_resp(ACVP_CTX *ctx, int *len);
+
+void acvp_transport_release_buf(ACVP_CTX *ctx);
+
+void acvp_transport_init(ACVP_CTX *ctx);
+
+void acvp_transport_close(ACVP_CTX *ctx);
+
+ACVP_RESULT acvp_transport_preconnect(ACVP_CTX *ctx);
+
+void acvp_transport_preconnect_wait(ACVP_CTX *ctx);
+
+void *acvp_transport_share_new(void);
+
+void acvp_transport_share_free(void *share);
+
+void acvp_transport_free_handle(void *hnd);
 
 void acvp_log_msg(ACVP_CTX *ctx, ACVP_LOG_LVL level, const char *func, int line, const char *format, ...);
 void acvp_log_newline(ACVP_CTX *ctx);
+ACVP_RESULT acvp_log_ring_new(ACVP_CTX *ctx, int entries);
+void acvp_log_ring_free(ACVP_CTX *ctx);
 
 /*
  * These are the handler routines for each KAT operation
@@ -1999,6 +2745,10 @@ void acvp_oe_free_operating_env(ACVP_CTX *ctx);
 
 ACVP_RESULT acvp_verify_fips_validation_metadata(ACVP_CTX *ctx);
 
+ACVP_META_SHARE *acvp_meta_share_new(void);
+
+void acvp_meta_share_free(ACVP_META_SHARE *share);
+
 ACVP_RESULT acvp_notify_large(ACVP_CTX *ctx,
                               const char *url,
                               char *large_url,
@@ -2008,6 +2758,8 @@ ACVP_RESULT acvp_notify_large(ACVP_CTX *ctx,
  * ACVP utility functions used internally
  */
 ACVP_CAPS_LIST *acvp_locate_cap_entry(ACVP_CTX *ctx, ACVP_CIPHER cipher);
+ACVP_RESULT acvp_cap_snapshot_take(ACVP_CTX *ctx);
+void acvp_cap_snapshot_drop(ACVP_CTX *ctx);
 
 const char *acvp_lookup_cipher_name(ACVP_CIPHER alg);
 
@@ -2016,6 +2768,8 @@ ACVP_CIPHER acvp_lookup_cipher_index(const char *algorithm);
 ACVP_CIPHER acvp_lookup_cipher_w_mode_index(const char *algorithm,
                                             const char *mode);
 
+const ACVP_ALG_HANDLER *acvp_lookup_alg_handler(const char *algorithm, const char *mode);
+
 const char *acvp_lookup_cipher_mode_str(ACVP_CIPHER cipher);
 
 const char *acvp_lookup_cipher_revision(ACVP_CIPHER alg);
@@ -2025,9 +2779,9 @@ ACVP_REVISION acvp_lookup_alt_revision(const char *str);
 ACVP_DRBG_MODE acvp_lookup_drbg_mode_index(const char *mode);
 
 ACVP_DRBG_MODE_LIST *acvp_locate_drbg_mode_entry(ACVP_CAPS_LIST *cap, ACVP_DRBG_MODE mode);
-ACVP_DRBG_MODE_LIST *acvp_create_drbg_mode_entry(ACVP_CAPS_LIST *cap, ACVP_DRBG_MODE mode);
+ACVP_DRBG_MODE_LIST *acvp_create_drbg_mode_entry(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_DRBG_MODE mode);
 ACVP_DRBG_CAP_GROUP *acvp_locate_drbg_group_entry(ACVP_DRBG_MODE_LIST *mode, int group);
-ACVP_DRBG_CAP_GROUP *acvp_create_drbg_group(ACVP_DRBG_MODE_LIST *mode, int group);
+ACVP_DRBG_CAP_GROUP *acvp_create_drbg_group(ACVP_CTX *ctx, ACVP_DRBG_MODE_LIST *mode, int group);
 
 const char *acvp_lookup_rsa_sig_type_str(ACVP_RSA_SIG_TYPE type);
 const char *acvp_lookup_rsa_mask_func_str(ACVP_RSA_MASK_FUNCTION func);
@@ -2055,19 +2809,107 @@ ACVP_ED_CURVE acvp_lookup_ed_curve(const char *name);
 
 ACVP_RESULT acvp_refresh(ACVP_CTX *ctx);
 
-void acvp_http_user_agent_handler(ACVP_CTX *ctx);
+time_t acvp_jwt_expiry(const char *jwt);
+
+const char *acvp_http_user_agent(ACVP_CTX *ctx);
 
 ACVP_RESULT acvp_setup_json_rsp_group(ACVP_CTX **ctx,
+                                      JSON_Object *obj,
                                       JSON_Value **outer_arr_val,
                                       JSON_Value **r_vs_val,
                                       JSON_Object **r_vs,
                                       const char *alg_str,
                                       JSON_Array **groups_arr);
 
+JSON_Array *acvp_setup_json_rsp_tests(JSON_Object *r_gobj, JSON_Object *groupobj);
+
 void acvp_release_json(JSON_Value *r_vs_val,
                        JSON_Value *r_gval);
 
+void acvp_log_kat_resp(ACVP_CTX *ctx);
+
+int acvp_tc_batch_enabled(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap);
+
+ACVP_RESULT acvp_tc_batch_init(ACVP_TC_BATCH *batch, int max);
+
+ACVP_TEST_CASE *acvp_tc_batch_add(ACVP_TC_BATCH *batch, JSON_Value *r_tval);
+
+ACVP_RESULT acvp_tc_batch_set_cost(ACVP_TC_BATCH *batch, unsigned long long int cost);
+
+ACVP_RESULT acvp_tc_batch_run(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch);
+
+void acvp_tc_sched_init(ACVP_TC_SCHED *sched);
+void acvp_tc_sched_destroy(ACVP_TC_SCHED *sched);
+void acvp_tc_sched_vs_begin(ACVP_TC_SCHED *sched);
+void acvp_tc_sched_vs_end(ACVP_TC_SCHED *sched);
+int acvp_tc_sched_steal(ACVP_TC_SCHED *sched, int numa_node);
+
+int acvp_worker_pin(ACVP_CTX *ctx, int quiet);
+
+void acvp_tc_batch_free(ACVP_TC_BATCH *batch);
+
+/*
+ * The test cases with a fixed layout, which can be handed to a crypto
+ * module out of process, see acvp_tc_layout.c
+ */
+typedef enum acvp_tc_kind {
+    ACVP_TC_KIND_NONE = 0,
+    ACVP_TC_KIND_SYM,
+    ACVP_TC_KIND_HASH,
+    ACVP_TC_KIND_HMAC
+} ACVP_TC_KIND;
+
+#define ACVP_TC_FIELD_IN 1  /* Copied to the crypto module */
+#define ACVP_TC_FIELD_OUT 2 /* Copied back from it */
+#define ACVP_TC_FIELDS_MAX 14
+
+/*
+ * A buffer of a test case struct: where its pointer and length are, and
+ * the most the kat handlers allocate for it. Lengths are in bytes unless
+ * bits is set. Buffers with no dir are not carried, and NULL for the module.
+ */
+typedef struct acvp_tc_field_t {
+    size_t ptr;
+    size_t len;
+    int bits;
+    size_t cap;
+    int dir;
+} ACVP_TC_FIELD;
+
+ACVP_TC_KIND acvp_tc_layout_kind(ACVP_CAPS_LIST *cap);
+void acvp_tc_layout_fields(int kind, const ACVP_TC_FIELD **fields, int *cnt);
+size_t acvp_tc_layout_size(int kind);
+void *acvp_tc_layout_struct(ACVP_TEST_CASE *tc, int kind);
+ACVP_TEST_CASE acvp_tc_layout_wrap(void *stc, int kind);
+unsigned char **acvp_tc_layout_ptr(char *stc, const ACVP_TC_FIELD *field);
+size_t acvp_tc_layout_len(char *stc, const ACVP_TC_FIELD *field);
+int acvp_tc_layout_carries(ACVP_TEST_CASE *tc, int kind);
+
+ACVP_RESULT acvp_ring_run_batch(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch);
+ACVP_RESULT acvp_dut_run_batch(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch);
+
+ACVP_RESULT acvp_kdf135_tg_run(ACVP_CTX *ctx,
+                               ACVP_CAPS_LIST *cap,
+                               const ACVP_KDF135_TG *tg,
+                               ACVP_KDF135_TG_SLOTS *slots,
+                               void *group_tc,
+                               JSON_Object *groupobj,
+                               JSON_Array *tests,
+                               JSON_Array *r_tarr);
+
+void acvp_kdf135_tg_free(ACVP_KDF135_TG_SLOTS *slots);
+
+ACVP_TC_CONTROL *acvp_tc_control_begin(ACVP_CTX *ctx, ACVP_TC_CONTROL *control, ACVP_CIPHER cipher,
+                                       int tg_id, int tc_id);
+
+unsigned int acvp_tg_key_id(ACVP_TG_KEYS *keys, const char *n, const char *priv, int max_len);
+
+unsigned int acvp_tg_key_id_parts(ACVP_TG_KEYS *keys, const char **parts, int part_cnt, int max_len);
+
+void acvp_tg_keys_clear(ACVP_TG_KEYS *keys);
+
 JSON_Object *acvp_get_obj_from_rsp(ACVP_CTX *ctx, JSON_Value *arry_val);
+const char *acvp_json_get_string_n(const JSON_Object *obj, const char *key, int *len);
 
 int string_fits(const char *string, unsigned int max_allowed);
 
@@ -2078,9 +2920,10 @@ ACVP_RESULT acvp_kv_list_append(ACVP_KV_LIST **kv_list,
 void acvp_kv_list_free(ACVP_KV_LIST *kv_list);
 
 void acvp_free_str_list(ACVP_STRING_LIST **list);
-ACVP_RESULT acvp_append_sl_list(ACVP_SL_LIST **list, int length);
-ACVP_RESULT acvp_append_param_list(ACVP_PARAM_LIST **list, int param);
-ACVP_RESULT acvp_append_name_list(ACVP_NAME_LIST **list, const char *string);
+void *acvp_cap_calloc(ACVP_CTX *ctx, size_t count, size_t size);
+ACVP_RESULT acvp_append_sl_list(ACVP_CTX *ctx, ACVP_SL_LIST **list, int length);
+ACVP_RESULT acvp_append_param_list(ACVP_CTX *ctx, ACVP_PARAM_LIST **list, int param);
+ACVP_RESULT acvp_append_name_list(ACVP_CTX *ctx, ACVP_NAME_LIST **list, const char *string);
 int acvp_is_in_name_list(ACVP_NAME_LIST *list, const char *string);
 ACVP_RESULT acvp_append_str_list(ACVP_STRING_LIST **list, const char *string);
 int acvp_lookup_str_list(ACVP_STRING_LIST **list, const char *string);
@@ -2102,6 +2945,183 @@ ACVP_KDF108_MODE read_mode(const char *str);
 
 ACVP_RESULT acvp_json_serialize_to_file_pretty_a(const JSON_Value *value, const char *filename);
 ACVP_RESULT acvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const char *filename);
+ACVP_RESULT acvp_json_serialize_to_file_a(const JSON_Value *value, const char *filename, int compact);
+ACVP_RESULT acvp_json_serialize_to_file_w(const JSON_Value *value, const char *filename, int compact);
+JSON_Value *acvp_json_parse_file(const char *filename);
+char *acvp_file_load(const char *filename, size_t *len, size_t *map_len);
+void acvp_file_unload(char *buf, size_t map_len);
+
+/*
+ * A value found in the text of a JSON document, see acvp_json_slice_array()
+ */
+typedef struct acvp_json_slice_t {
+    const char *p;
+    size_t len;
+} ACVP_JSON_SLICE;
+
+int acvp_json_slice_array(const char *text, size_t len, ACVP_JSON_SLICE **slices);
+long acvp_json_slice_get_number(const ACVP_JSON_SLICE *slice, const char *name);
+
+/*
+ * The values of a JSON array read from a stream such as a pipe, one at a
+ * time, see acvp_json_stream_next()
+ */
+typedef struct acvp_json_stream_t {
+    FILE *fp;
+    char *buf;
+    size_t len;             /* Bytes read into buf */
+    size_t cap;
+    size_t pos;             /* End of the value handed out last */
+    int state;              /* ACVP_JSON_STREAM_* */
+} ACVP_JSON_STREAM;
+
+#define ACVP_JSON_STREAM_START 0    /* Before the '[' */
+#define ACVP_JSON_STREAM_FIRST 1    /* Before the first value, or the ']' of an empty array */
+#define ACVP_JSON_STREAM_VALUE 2    /* Before a value after a ',' */
+#define ACVP_JSON_STREAM_AFTER 3    /* After a value */
+#define ACVP_JSON_STREAM_DONE 4
+#define ACVP_JSON_STREAM_CHUNK (64 * 1024)
+
+void acvp_json_stream_init(ACVP_JSON_STREAM *s, FILE *fp);
+int acvp_json_stream_next(ACVP_JSON_STREAM *s, ACVP_JSON_SLICE *slice);
+JSON_Value *acvp_json_stream_parse(ACVP_JSON_STREAM *s, const ACVP_JSON_SLICE *slice);
+void acvp_json_stream_free(ACVP_JSON_STREAM *s);
+FILE *acvp_json_out_open(const char *filename, const char *mode);
+int acvp_json_out_close(FILE *fp);
+
+ACVP_RESULT acvp_writer_open(ACVP_WRITER **writer, const char *filename, const char *mode);
+ACVP_RESULT acvp_writer_write(ACVP_WRITER *writer, const char *data, size_t len);
+ACVP_RESULT acvp_writer_puts(ACVP_WRITER *writer, const char *str);
+ACVP_RESULT acvp_writer_json(ACVP_WRITER *writer, const char *sep, const JSON_Value *value, int compact);
+ACVP_RESULT acvp_writer_file(ACVP_WRITER *writer, FILE *fp);
+ACVP_RESULT acvp_writer_close(ACVP_WRITER *writer);
+unsigned char *acvp_map_repeated(const unsigned char *tile,
+                                 size_t tile_len,
+                                 unsigned long long int total,
+                                 size_t *map_len);
+char *acvp_big_alloc(size_t *size, int huge, int *mapped);
+void acvp_big_free(char *buf, size_t size, int mapped);
+void acvp_unmap_repeated(unsigned char *buf, size_t map_len);
+JSON_Value *acvp_vs_cache_load(ACVP_CTX *ctx, const char *req_filename, const char *cache_filename);
+#define ACVP_FP_OFFSET 14695981039346656037ULL
+void acvp_fp_bytes(unsigned long long *fp, const void *data, size_t len);
+unsigned long long int acvp_reg_fingerprint(const JSON_Value *algorithms, int is_sample);
+char *acvp_reg_cache_load(ACVP_CTX *ctx, const char *cache_filename, unsigned long long int fp, int *out_len);
+void acvp_reg_cache_save(ACVP_CTX *ctx, const char *cache_filename, unsigned long long int fp,
+                         const char *reg, int reg_len);
+int acvp_vs_dl_cache_load(ACVP_CTX *ctx, const char *vsid_url);
+void acvp_vs_dl_cache_save(ACVP_CTX *ctx, const char *vsid_url);
+void acvp_vs_dl_cache_keep(ACVP_CTX *ctx, const char *vsid_url, int keep);
+
+ACVP_RESULT acvp_remote_ship(ACVP_CTX *ctx, const char *vsid_url, JSON_Object *obj);
+ACVP_RESULT acvp_remote_wait(ACVP_CTX *ctx);
+void acvp_remote_finish(ACVP_CTX *ctx);
+
+/* Whether the calls into the crypto module are to be timed */
+#define ACVP_CRYPTO_TIMED(ctx) ((ctx)->metrics_cb || (ctx)->openmetrics || (ctx)->lat_enabled)
+
+unsigned long long int acvp_metrics_now(void);
+void acvp_metrics_add(ACVP_CTX *ctx, ACVP_METRICS_PHASE phase, unsigned long long int start);
+void acvp_metrics_crypto(ACVP_CTX *ctx, unsigned long long int start, int calls, ACVP_TEST_CASE *tc);
+void acvp_metrics_vs_begin(ACVP_CTX *ctx);
+void acvp_metrics_vs_end(ACVP_CTX *ctx);
+void acvp_metrics_tg_begin(ACVP_CTX *ctx, int tg_id);
+void acvp_metrics_tg_end(ACVP_CTX *ctx);
+
+void acvp_event_emit(ACVP_CTX *ctx, ACVP_EVENT *event);
+void acvp_event_vs_begin(ACVP_CTX *ctx, int tg_cnt);
+void acvp_event_vs_end(ACVP_CTX *ctx, ACVP_RESULT rv);
+void acvp_event_tg_end(ACVP_CTX *ctx);
+
+void acvp_om_crypto(ACVP_CTX *ctx, unsigned long long int ns, unsigned int calls);
+void acvp_om_flush(ACVP_CTX *ctx);
+void acvp_om_vs_done(ACVP_CTX *ctx, ACVP_RESULT rv);
+void acvp_om_retry_wait(ACVP_CTX *ctx, int seconds);
+void acvp_om_transfer(ACVP_CTX *ctx, ACVP_OM_METHOD method, int http_status,
+                      size_t bytes_in, size_t bytes_out, unsigned long long int ns);
+void acvp_om_jwt_refresh(ACVP_CTX *ctx, ACVP_RESULT rv);
+
+void acvp_span_begin(ACVP_CTX *ctx, ACVP_SPAN *span, ACVP_SPAN_TYPE type);
+void acvp_span_end(ACVP_CTX *ctx, ACVP_SPAN *span, ACVP_RESULT rv);
+void acvp_span_tg_begin(ACVP_CTX *ctx, int tg_id);
+void acvp_span_tg_end(ACVP_CTX *ctx);
+
+void acvp_lat_vs_begin(ACVP_CTX *ctx, ACVP_CIPHER cipher);
+void acvp_lat_add(ACVP_CTX *ctx, unsigned long long int ns, int calls, ACVP_TEST_CASE *tc);
+void acvp_lat_vs_done(ACVP_CTX *ctx);
+JSON_Value *acvp_lat_slowest_json(ACVP_CTX *ctx);
+void acvp_lat_clear_session(ACVP_CTX *ctx);
+void acvp_lat_free(ACVP_CTX *ctx);
+
+void acvp_xfer_acquire(ACVP_CTX *ctx);
+void acvp_xfer_release(ACVP_CTX *ctx, int http_status, size_t bytes, unsigned long long int ns);
+void acvp_xfer_free(ACVP_CTX *ctx);
+unsigned long long int acvp_hedge_delay(ACVP_CTX *ctx);
+void acvp_hedge_record(ACVP_CTX *ctx, unsigned long long int ttfb_ns, int hedged, int won);
+void acvp_hedge_free(ACVP_CTX *ctx);
+
+ACVP_RESULT acvp_journal_begin(ACVP_CTX *ctx, JSON_Object *obj);
+void acvp_journal_tg_done(ACVP_CTX *ctx);
+ACVP_RESULT acvp_journal_end(ACVP_CTX *ctx, ACVP_RESULT rv);
+
+ACVP_RESULT acvp_memo_lookup(ACVP_CTX *ctx, JSON_Object *obj, JSON_Value **groups_val, int *hits);
+void acvp_memo_end(ACVP_CTX *ctx, ACVP_RESULT rv);
+void acvp_memo_free(ACVP_CTX *ctx);
+
+void acvp_spill_tg_done(ACVP_CTX *ctx);
+FILE *acvp_spill_finish(ACVP_CTX *ctx, int whole, int *len);
+ACVP_RESULT acvp_spill_append(FILE *fp, ACVP_WRITER *writer);
+void acvp_spill_reset(ACVP_CTX *ctx);
+int acvp_crypto_call(ACVP_CTX *ctx, int (*handler)(ACVP_TEST_CASE *test_case), ACVP_TEST_CASE *tc);
+
+void acvp_idle(ACVP_CTX *ctx, int seconds);
+
+ACVP_RESULT acvp_thread_create(ACVP_THREAD *thread, void (*func)(void *arg), void *arg);
+void acvp_thread_join(ACVP_THREAD thread);
+void acvp_mutex_init(ACVP_MUTEX *mutex);
+void acvp_mutex_lock(ACVP_MUTEX *mutex);
+void acvp_mutex_unlock(ACVP_MUTEX *mutex);
+void acvp_mutex_destroy(ACVP_MUTEX *mutex);
+void acvp_cond_init(ACVP_COND *cond);
+void acvp_cond_wait(ACVP_COND *cond, ACVP_MUTEX *mutex);
+void acvp_cond_broadcast(ACVP_COND *cond);
+void acvp_cond_destroy(ACVP_COND *cond);
+void acvp_once(ACVP_ONCE *once, void (*func)(void));
+
+void *acvp_arena_calloc(ACVP_ARENA *arena, size_t size);
+void acvp_arena_reset(ACVP_ARENA *arena);
+void acvp_arena_free(ACVP_ARENA *arena);
+
+ACVP_RESULT acvp_sbuf_init(ACVP_SBUF *sb, size_t size);
+ACVP_RESULT acvp_sbuf_init_tc(ACVP_CTX *ctx, ACVP_SBUF *sb, size_t size);
+ACVP_RESULT acvp_sbuf_bin_to_hexstr(ACVP_SBUF *sb, const unsigned char *src, int src_len, int dest_max);
+ACVP_RESULT acvp_json_set_hex(JSON_Object *obj, const char *name, const unsigned char *src, int src_len, int dest_max);
+void acvp_sbuf_release(ACVP_SBUF *sb);
+
+int acvp_output_sink_enabled(ACVP_CAPS_LIST *cap);
+ACVP_OUTPUT_SINK *acvp_output_sink_new(unsigned int max);
+ACVP_RESULT acvp_output_sink_set(ACVP_OUTPUT_SINK *sink, JSON_Object *obj, const char *name);
+void acvp_output_sink_free(ACVP_OUTPUT_SINK *sink);
+
+int acvp_bn_limbs_enabled(ACVP_CAPS_LIST *cap);
+ACVP_RESULT acvp_hexstr_to_num(int limbs, const char *src, unsigned char *dest, int dest_max,
+                               int *converted_len, ACVP_BN *bn);
+
+void acvp_mem_init(ACVP_CTX *ctx);
+void acvp_mem_free(ACVP_CTX *ctx);
+void acvp_mem_charge(ACVP_MEM_ACCT *acct, size_t bytes);
+void acvp_mem_credit(ACVP_MEM_ACCT *acct, size_t bytes);
+ACVP_MEM_ACCT *acvp_mem_enter(ACVP_CTX *ctx);
+void acvp_mem_leave(ACVP_MEM_ACCT *prev);
+void acvp_mem_metrics(ACVP_CTX *ctx, ACVP_METRICS *metrics);
+void acvp_mem_vs_done(ACVP_CTX *ctx, const ACVP_METRICS *metrics);
+
+void *acvp_json_malloc(size_t size);
+void acvp_json_free(void *ptr);
+void acvp_json_arena_begin(ACVP_ARENA *arena);
+void acvp_json_arena_pause(int pause);
+void acvp_json_arena_end(void);
+void acvp_json_value_free(JSON_Value *val);
 
 
 #endif
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * The SSE2 intrinsics, for the code that has a 16 bytes at a time path.
+ * ACVP_SSE2 is defined where they are available.
+ */
+#ifndef acvp_sse2_h
+#define acvp_sse2_h
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+/* The compiler's own header casts const away, which --enable-cflags would report */
+#if defined __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#endif
+#include <emmintrin.h>
+#if defined __GNUC__
+#pragma GCC diagnostic pop
+#endif
+#define ACVP_SSE2
+#endif
+
+#endif
@@ -32,6 +32,7 @@ extern "C"
 #endif
 
 #include <stddef.h>   /* size_t */
+#include <stdio.h>    /* FILE */
 
 /* Types and enums */
 typedef struct json_object_t JSON_Object;
@@ -78,6 +79,17 @@ JSON_Value * json_parse_file_with_comments(const char *filename);
 /*  Parses first JSON value in a string, returns NULL in case of error */
 JSON_Value * json_parse_string(const char *string);
 
+/*  ACVP: Parses first JSON value in a string without copying string values: they are unescaped
+    and NUL terminated in place and point into string, so it must outlive the returned value and
+    not be changed while it is in use. Returns NULL in case of error, string may then have been
+    modified. */
+JSON_Value * json_parse_string_in_situ(char *string);
+
+/*  ACVP: Like json_parse_string_in_situ(), except that the items of "testGroups" arrays are only
+    parsed as json_array_get_value() asks for them, from copies of their text, and only one at a
+    time: getting another item frees the one got before it. Lazy arrays can not be changed. */
+JSON_Value * json_parse_string_lazy(char *string);
+
 /*  Parses first JSON value in a string and ignores comments (/ * * / and //),
     returns NULL in case of error */
 #if 0
@@ -89,12 +101,16 @@ size_t      json_serialization_size(const JSON_Value *value); /* returns 0 on fa
 JSON_Status json_serialize_to_buffer(const JSON_Value *value, char *buf, size_t buf_size_in_bytes);
 JSON_Status json_serialize_to_file(const JSON_Value *value, const char *filename);
 char *      json_serialize_to_string(const JSON_Value *value, int *len);
+/* Writes the same text as json_serialize_to_string to fp, without building it in memory */
+JSON_Status json_serialize_to_fp(const JSON_Value *value, FILE *fp);
 
 /* Pretty serialization */
 size_t      json_serialization_size_pretty(const JSON_Value *value); /* returns 0 on fail */
 JSON_Status json_serialize_to_buffer_pretty(const JSON_Value *value, char *buf, size_t buf_size_in_bytes);
 JSON_Status json_serialize_to_file_pretty(const JSON_Value *value, const char *filename);
 char *      json_serialize_to_string_pretty(const JSON_Value *value, int *len);
+/* Writes the same text as json_serialize_to_string_pretty to fp, without building it in memory */
+JSON_Status json_serialize_to_fp_pretty(const JSON_Value *value, FILE *fp);
 
 void        json_free_serialized_string(char *string); /* frees string from json_serialize_to_string and json_serialize_to_string_pretty */
 
@@ -122,6 +138,7 @@ size_t        json_object_get_string_len(const JSON_Object *object, const char *
 JSON_Object * json_object_get_object (const JSON_Object *object, const char *name);
 JSON_Array  * json_object_get_array  (const JSON_Object *object, const char *name);
 double        json_object_get_number (const JSON_Object *object, const char *name); /* returns 0 on fail */
+unsigned int  json_object_get_uint   (const JSON_Object *object, const char *name); /* ACVP: returns 0 on fail, or if not a whole number that fits */
 int           json_object_get_boolean(const JSON_Object *object, const char *name); /* returns -1 on fail */
 
 /* dotget functions enable addressing values with dot notation in nested objects,
@@ -155,6 +172,7 @@ int json_object_dothas_value_of_type(const JSON_Object *object, const char *name
 JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Value *value);
 JSON_Status json_object_set_string(JSON_Object *object, const char *name, const char *string);
 JSON_Status json_object_set_string_with_len(JSON_Object *object, const char *name, const char *string, size_t len);  /* length shouldn't include last null character */
+JSON_Status json_object_set_hex(JSON_Object *object, const char *name, const unsigned char *bytes, size_t length);  /* ACVP: see json_value_init_hex() */
 JSON_Status json_object_set_number(JSON_Object *object, const char *name, double number);
 JSON_Status json_object_set_boolean(JSON_Object *object, const char *name, int boolean);
 JSON_Status json_object_set_null(JSON_Object *object, const char *name);
@@ -188,6 +206,7 @@ size_t        json_array_get_string_len(const JSON_Array *array, size_t index);
 JSON_Object * json_array_get_object (const JSON_Array *array, size_t index);
 JSON_Array  * json_array_get_array  (const JSON_Array *array, size_t index);
 double        json_array_get_number (const JSON_Array *array, size_t index); /* returns 0 on fail */
+unsigned int  json_array_get_uint   (const JSON_Array *array, size_t index); /* ACVP: returns 0 on fail, or if not a whole number that fits */
 int           json_array_get_boolean(const JSON_Array *array, size_t index); /* returns -1 on fail */
 size_t        json_array_get_count  (const JSON_Array *array);
 JSON_Value  * json_array_get_wrapping_value(const JSON_Array *array);
@@ -211,6 +230,10 @@ JSON_Status json_array_replace_null(JSON_Array *array, size_t i);
 /* Frees and removes all values from array */
 JSON_Status json_array_clear(JSON_Array *array);
 
+/* ACVP: Makes room for at least capacity values, so that appending that many
+ * does not reallocate the array */
+JSON_Status json_array_reserve(JSON_Array *array, size_t capacity);
+
 /* Appends new value at the end of array.
  * json_array_append_value does not copy passed value so it shouldn't be freed afterwards. */
 JSON_Status json_array_append_value(JSON_Array *array, JSON_Value *value);
@@ -227,6 +250,8 @@ JSON_Value * json_value_init_object (void);
 JSON_Value * json_value_init_array  (void);
 JSON_Value * json_value_init_string (const char *string); /* copies passed string */
 JSON_Value * json_value_init_string_with_len(const char *string, size_t length); /* copies passed string, length shouldn't include last null character */
+JSON_Value * json_value_init_string_take(char *string, size_t length); /* takes passed string, which must come from the parson allocator and be null terminated at length */
+JSON_Value * json_value_init_hex(const unsigned char *bytes, size_t length); /* ACVP: copies passed bytes, a string of them hex encoded, encoded only when serialized or read */
 JSON_Value * json_value_init_number (double number);
 JSON_Value * json_value_init_boolean(int boolean);
 JSON_Value * json_value_init_null   (void);
@@ -239,6 +264,7 @@ JSON_Array  *   json_value_get_array  (const JSON_Value *value);
 const char  *   json_value_get_string (const JSON_Value *value);
 size_t          json_value_get_string_len(const JSON_Value *value); /* doesn't account for last null character */
 double          json_value_get_number (const JSON_Value *value);
+unsigned int    json_value_get_uint   (const JSON_Value *value); /* ACVP: returns 0 on fail, or if not a whole number that fits */
 int             json_value_get_boolean(const JSON_Value *value);
 JSON_Value  *   json_value_get_parent (const JSON_Value *value);
 
@@ -47,6 +47,10 @@
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
 #include <arpa/inet.h>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
@@ -59,6 +63,7 @@
 #include "murl_lcl.h"
 
 static unsigned int initialized = 0;
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
 #define DEBUGF(x) do { } while (0)
 
 void curl_free(void *p)
@@ -85,16 +90,21 @@ static int Curl_ossl_init(void)
     return 1;
 }
 
+static void murl_global_init_once(void)
+{
+    initialized = Curl_ossl_init();
+}
+
 /**
  * curl_global_init() globally initializes cURL given a bitwise set of the
- * different features of what to initialize.
+ * different features of what to initialize. It is done once, however many
+ * threads get here at the same time.
  */
 static CURLcode curl_global_init()
 {
-    if (initialized++)
-        return CURLE_OK;
+    pthread_once(&init_once, murl_global_init_once);
 
-    if (!Curl_ossl_init()) {
+    if (!initialized) {
         DEBUGF(fprintf(stderr, "Error: Curl_ssl_init failed\n"));
         return CURLE_FAILED_INIT;
     }
@@ -112,13 +122,11 @@ CURL *curl_easy_init(void)
     SessionHandle *data;
 
     /* Make sure we inited the global SSL stuff */
-    if (!initialized) {
-        result = curl_global_init();
-        if (result) {
-            /* something in the global init failed, return nothing */
-            DEBUGF(fprintf(stderr, "Error: curl_global_init failed\n"));
-            return NULL;
-        }
+    result = curl_global_init();
+    if (result) {
+        /* something in the global init failed, return nothing */
+        DEBUGF(fprintf(stderr, "Error: curl_global_init failed\n"));
+        return NULL;
     }
 
     /* We use curl_open() with undefined URL so far */
@@ -139,6 +147,7 @@ static CURLcode setstropt(char **charp, char *s)
        copy of `s'. Return CURLE_OK or CURLE_OUT_OF_MEMORY. */
 
     if (*charp) free(*charp);
+    *charp = NULL;
 
     if (s) {
         s = strdup(s);
@@ -647,54 +656,68 @@ static void murl_log_peer_cert(SSL *ssl)
 }
 
 
-#define TBUF_MAX 1024
-#define READ_CHUNK_SZ 16384
-CURLcode curl_easy_perform(CURL *curl)
+/*
+ * Compares two option strings, either of which may be unset
+ */
+static int murl_streq(const char *a, const char *b)
 {
-    BIO *conn;
-    int rv;
-    int ssl_err;
-    int read_cnt = 0;
-    char *rbuf = NULL;
-    char tbuf[TBUF_MAX];
-    SSL *ssl = NULL;
-    SSL_CTX *ssl_ctx = NULL;
-    X509_VERIFY_PARAM *vpm = NULL;
-    int cl;
-    SessionHandle *ctx = (SessionHandle*)curl;
-    struct curl_slist *hdrs;
-    unsigned long ossl_err;
-    CURLcode crv;
-
-    if (!ctx) {
-	return CURLE_UNKNOWN_OPTION;
+    if (!a || !b) {
+	return a == b;
     }
+    return !strcmp(a, b);
+}
 
-    /*
-     * Allocate some space to build the HTTP request
-     */
-    if (ctx->http_post && ctx->post_field_size) {
-        cl = ctx->post_field_size; 
-    } else if (ctx->http_post && ctx->post_fields) {
-        cl = strlen(ctx->post_fields); //FIXME: this is not safe
-    } else {
-        cl = 0;
-    }
-    if (cl > MURL_POST_MAX) {
-	fprintf(stderr, "POST data exceeds %d byte limit\n", MURL_POST_MAX);
-	return CURLE_FILESIZE_EXCEEDED;
-    }
-    rbuf = calloc(1, cl+MURL_HDR_MAX);
-    if (!rbuf) {
-        fprintf(stderr, "calloc failed.\n");
-        return CURLE_OUT_OF_MEMORY;
+/*
+ * Closes the keep-alive connection, if one is open
+ */
+static void murl_disconnect(SessionHandle *ctx)
+{
+    if (ctx->conn) {
+	SSL_shutdown(ctx->conn);
+	SSL_free(ctx->conn);
+	ctx->conn = NULL;
     }
+}
 
-    /*
-     * Split the URL into it's parts
-     */
-    crv = parseurl(ctx);
-    if (crv != CURLE_OK) goto easy_perform_cleanup;
+/*
+ * Releases the TLS state kept for the next request: the connection, the
+ * session to resume and the SSL context they were made with.
+ */
+static void murl_tls_free(SessionHandle *ctx)
+{
+    murl_disconnect(ctx);
+    if (ctx->ssl_session) SSL_SESSION_free(ctx->ssl_session);
+    ctx->ssl_session = NULL;
+    if (ctx->ssl_ctx) SSL_CTX_free(ctx->ssl_ctx);
+    ctx->ssl_ctx = NULL;
+    if (ctx->tls_ca_file) free(ctx->tls_ca_file);
+    if (ctx->tls_cert_file) free(ctx->tls_cert_file);
+    if (ctx->tls_key_file) free(ctx->tls_key_file);
+    ctx->tls_ca_file = NULL;
+    ctx->tls_cert_file = NULL;
+    ctx->tls_key_file = NULL;
+}
+
+/*
+ * Sets up the SSL context for the request. The one set up for an earlier
+ * request is kept as long as the trust anchors, client certificate and
+ * peer verification stay the same; otherwise its connection and session
+ * go with it.
+ */
+static CURLcode murl_get_ssl_ctx(SessionHandle *ctx)
+{
+    SSL_CTX *ssl_ctx = NULL;
+    X509_VERIFY_PARAM *vpm = NULL;
+
+    if (ctx->ssl_ctx) {
+	if (murl_streq(ctx->tls_ca_file, ctx->ca_file) &&
+	    murl_streq(ctx->tls_cert_file, ctx->ssl_cert_file) &&
+	    murl_streq(ctx->tls_key_file, ctx->ssl_key_file) &&
+	    ctx->tls_verify_peer == ctx->ssl_verify_peer) {
+	    return CURLE_OK;
+	}
+	murl_tls_free(ctx);
+    }
 
     /*
      * Setup OpenSSL API
@@ -703,8 +726,7 @@ CURLcode curl_easy_perform(CURL *curl)
     if (!ssl_ctx) {
         fprintf(stderr, "Failed to create SSL context.\n");
         ERR_print_errors_fp(stderr);
-        crv = CURLE_SSL_CONNECT_ERROR;
-	goto easy_perform_cleanup;
+        return CURLE_SSL_CONNECT_ERROR;
     }
     /*
      * This is optional.
@@ -723,8 +745,8 @@ CURLcode curl_easy_perform(CURL *curl)
         if (!SSL_CTX_load_verify_locations(ssl_ctx, ctx->ca_file, NULL)) {
             fprintf(stderr, "Failed to set trust anchors.\n");
             ERR_print_errors_fp(stderr);
-            crv = CURLE_SSL_CACERT_BADFILE;
-	    goto easy_perform_cleanup;
+	    SSL_CTX_free(ssl_ctx);
+            return CURLE_SSL_CACERT_BADFILE;
         }
         SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_PEER|SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
     }
@@ -733,8 +755,8 @@ CURLcode curl_easy_perform(CURL *curl)
     if (vpm == NULL) {
         fprintf(stderr, "Unable to allocate a verify parameter structure.\n");
         ERR_print_errors_fp(stderr);
-        crv = CURLE_SSL_CONNECT_ERROR;
-	goto easy_perform_cleanup;
+	SSL_CTX_free(ssl_ctx);
+        return CURLE_SSL_CONNECT_ERROR;
     }
 #if 0
     /* TODO: Enable CRL checks */
@@ -743,9 +765,6 @@ CURLcode curl_easy_perform(CURL *curl)
 #endif
     X509_VERIFY_PARAM_set_depth(vpm, 7);
     X509_VERIFY_PARAM_set_purpose(vpm, X509_PURPOSE_SSL_SERVER);
-    if (ctx->ssl_verify_hostname) {
-	X509_VERIFY_PARAM_set1_host(vpm, ctx->host_name, strnlen(ctx->host_name, MURL_HOSTNAME_MAX));
-    }
     SSL_CTX_set1_param(ssl_ctx, vpm);
     X509_VERIFY_PARAM_free(vpm);
 
@@ -753,17 +772,80 @@ CURLcode curl_easy_perform(CURL *curl)
         if (SSL_CTX_use_certificate_chain_file(ssl_ctx, ctx->ssl_cert_file) != 1) {
             fprintf(stderr,"Failed to load client certificate\n");
             ERR_print_errors_fp(stderr);
-            crv = CURLE_SSL_CERTPROBLEM;
-	    goto easy_perform_cleanup;
+	    SSL_CTX_free(ssl_ctx);
+            return CURLE_SSL_CERTPROBLEM;
         }
         if (SSL_CTX_use_PrivateKey_file(ssl_ctx, ctx->ssl_key_file, SSL_FILETYPE_PEM) != 1) {
             fprintf(stderr, "Failed to load client private key\n");
             ERR_print_errors_fp(stderr);
-            crv = CURLE_SSL_CERTPROBLEM;
-	    goto easy_perform_cleanup;
+	    SSL_CTX_free(ssl_ctx);
+            return CURLE_SSL_CERTPROBLEM;
         }
     }
 
+    ctx->ssl_ctx = ssl_ctx;
+    ctx->tls_verify_peer = ctx->ssl_verify_peer;
+    if (setstropt(&ctx->tls_ca_file, ctx->ca_file) != CURLE_OK ||
+	setstropt(&ctx->tls_cert_file, ctx->ssl_cert_file) != CURLE_OK ||
+	setstropt(&ctx->tls_key_file, ctx->ssl_key_file) != CURLE_OK) {
+	murl_tls_free(ctx);
+	return CURLE_OUT_OF_MEMORY;
+    }
+    return CURLE_OK;
+}
+
+/*
+ * Whether the keep-alive connection can carry the request: it goes to the
+ * same server, and the server has not closed it meanwhile (nothing, not
+ * even a close_notify, is waiting to be read on an idle connection).
+ */
+static int murl_conn_usable(SessionHandle *ctx)
+{
+    struct pollfd pfd;
+
+    if (!ctx->conn) {
+	return 0;
+    }
+    if (strncmp(ctx->conn_host, ctx->host_name, MURL_HOSTNAME_MAX) ||
+	ctx->conn_port != ctx->server_port) {
+	return 0;
+    }
+    if (SSL_pending(ctx->conn)) {
+	return 0;
+    }
+    memset(&pfd, 0, sizeof(pfd));
+    pfd.fd = SSL_get_fd(ctx->conn);
+    pfd.events = POLLIN;
+    if (pfd.fd < 0 || poll(&pfd, 1, 0) != 0) {
+	return 0;
+    }
+    return 1;
+}
+
+/*
+ * Opens a TLS connection with the server of the request. The session of
+ * the last connection to the same server is resumed when it can be, which
+ * saves the full handshake, client certificate included.
+ */
+static CURLcode murl_connect(SessionHandle *ctx)
+{
+    BIO *conn;
+    SSL *ssl;
+    int resume;
+    CURLcode crv;
+
+    crv = murl_get_ssl_ctx(ctx);
+    if (crv != CURLE_OK) {
+	return crv;
+    }
+
+    resume = ctx->ssl_session && ctx->conn_port == ctx->server_port &&
+	     !strncmp(ctx->conn_host, ctx->host_name, MURL_HOSTNAME_MAX);
+    /* Taken before create_connection_v6() strips the brackets */
+    strncpy(ctx->conn_host, ctx->host_name, MURL_HOSTNAME_MAX - 1);
+    ctx->conn_host[MURL_HOSTNAME_MAX - 1] = 0;
+    ctx->conn_port = ctx->server_port;
+
     /*
      * Open TCP connection with server
      */
@@ -772,23 +854,32 @@ CURLcode curl_easy_perform(CURL *curl)
     } else {
 	conn = create_connection(ctx->host_name, ctx->server_port);
     }
-    //FIXME: do we need to free conn, or is this handled by SSL_free?
     if (conn == NULL) {
         fprintf(stderr, "Unable to open socket with server.\n");
-        crv = CURLE_COULDNT_CONNECT;
-	goto easy_perform_cleanup;
+	return CURLE_COULDNT_CONNECT;
+    }
+    ssl = SSL_new(ctx->ssl_ctx);
+    if (!ssl) {
+        fprintf(stderr, "Failed to create SSL connection.\n");
+	BIO_free_all(conn);
+	return CURLE_OUT_OF_MEMORY;
     }
-    ssl = SSL_new(ssl_ctx);
     if (!SSL_set_tlsext_host_name(ssl, ctx->host_name)) {
         fprintf(stderr, "Warning: SNI extension not set.\n");
     }
+    if (ctx->ssl_verify_hostname) {
+	X509_VERIFY_PARAM_set1_host(SSL_get0_param(ssl), ctx->host_name, strnlen(ctx->host_name, MURL_HOSTNAME_MAX));
+    }
+    if (resume) {
+	SSL_set_session(ssl, ctx->ssl_session);
+    }
+    /* The BIO is freed along with ssl */
     SSL_set_bio(ssl, conn, conn);
-    rv = SSL_connect(ssl);
-    if (rv <= 0) {
+    if (SSL_connect(ssl) <= 0) {
         fprintf(stderr, "TLS handshake failed.\n");
         ERR_print_errors_fp(stderr);
-        crv = CURLE_SSL_CONNECT_ERROR;
-	goto easy_perform_cleanup;
+	SSL_free(ssl);
+	return CURLE_SSL_CONNECT_ERROR;
     }
 
     /*
@@ -798,11 +889,90 @@ CURLcode curl_easy_perform(CURL *curl)
 	murl_log_peer_cert(ssl);
     }
 
+    ctx->conn = ssl;
+    return CURLE_OK;
+}
+
+/*
+ * Writes all of buf to the connection. SIGPIPE is blocked for the calling
+ * thread meanwhile, and one raised by the write is taken off again, so a
+ * connection the server has just closed fails the write instead of ending
+ * the process. Other threads, which may be writing on handles of their own,
+ * are not affected.
+ */
+static CURLcode murl_send(SessionHandle *ctx, const char *buf, int len)
+{
+    sigset_t pipe_set, old_set, pending;
+    struct timespec no_wait = {0, 0};
+    int rv;
+
+    if (!len) {
+	return CURLE_OK;
+    }
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+    rv = SSL_write(ctx->conn, buf, len);
+    if (rv != len && !sigismember(&old_set, SIGPIPE) &&
+	!sigpending(&pending) && sigismember(&pending, SIGPIPE)) {
+	sigtimedwait(&pipe_set, NULL, &no_wait);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+    if (rv != len) {
+	ERR_clear_error();
+	return CURLE_SEND_ERROR;
+    }
+    return CURLE_OK;
+}
+
+#define TBUF_MAX 1024
+CURLcode curl_easy_perform(CURL *curl)
+{
+    char *rbuf = NULL;
+    char tbuf[TBUF_MAX];
+    int cl;
+    int reused;
+    int keep_alive = 0;
+    int got_data = 0;
+    int attempt;
+    SessionHandle *ctx = (SessionHandle*)curl;
+    struct curl_slist *hdrs;
+    SSL_SESSION *sess;
+    CURLcode crv;
+
+    if (!ctx) {
+	return CURLE_UNKNOWN_OPTION;
+    }
+
+    /*
+     * Allocate some space to build the HTTP request, the
+     * POST data is sent from where it is
+     */
+    if (ctx->http_post && ctx->post_field_size) {
+        cl = ctx->post_field_size; 
+    } else if (ctx->http_post && ctx->post_fields) {
+        cl = strlen(ctx->post_fields); //FIXME: this is not safe
+    } else {
+        cl = 0;
+    }
+    rbuf = calloc(1, MURL_HDR_MAX);
+    if (!rbuf) {
+        fprintf(stderr, "calloc failed.\n");
+        return CURLE_OUT_OF_MEMORY;
+    }
+
+    /*
+     * Split the URL into it's parts
+     */
+    crv = parseurl(ctx);
+    if (crv != CURLE_OK) goto easy_perform_cleanup;
+
     /*
-     * Build HTTP request
+     * Build HTTP request. HTTP/1.1 connections are kept alive
+     * unless one side says otherwise.
      */
     memset(tbuf, 0, sizeof(tbuf));
-    snprintf(tbuf, TBUF_MAX, "%s %s HTTP/1.0\r\n"
+    snprintf(tbuf, TBUF_MAX, "%s %s HTTP/1.1\r\n"
             "Host: %s:%d\r\n"
             "User-Agent: %s\r\n",
             (ctx->http_post ? "POST" : "GET"),
@@ -830,93 +1000,54 @@ CURLcode curl_easy_perform(CURL *curl)
     snprintf(tbuf, TBUF_MAX, "Content-Length: %d\r\n" "Accept: */*\r\n\r\n", cl);
     strcat(rbuf, tbuf); //FIXME: safe string handling needed
 
-    /*
-     * Send the HTTP request
-     */
-    SSL_write(ssl, rbuf, strlen(rbuf));
-    SSL_write(ssl, ctx->post_fields, cl);
-
-    ERR_clear_error();
-    free(rbuf);
-    rbuf = NULL;
-
-    /*
-     * Read the HTTP response
-     */
-    rv = 1;
-    while (rv) {
+    for (attempt = 0; attempt < 2; attempt++) {
 	/*
-	 * Allocate some space to receive the response from the server
+	 * Use the connection kept open by the last request if we can,
+	 * otherwise open a new one
 	 */
-	rbuf = realloc(rbuf, read_cnt + READ_CHUNK_SZ);
-	if (!rbuf) {
-	    fprintf(stderr, "realloc failed (%s).\n", __FUNCTION__);
-	    crv = CURLE_OUT_OF_MEMORY;
-	    goto easy_perform_cleanup;
+	reused = murl_conn_usable(ctx);
+	if (!reused) {
+	    murl_disconnect(ctx);
+	    crv = murl_connect(ctx);
+	    if (crv != CURLE_OK) goto easy_perform_cleanup;
 	}
-	memset(rbuf+read_cnt, 0x0, READ_CHUNK_SZ);
-	
+
 	/*
-	 * Read the next chunk from the server
+	 * Send the HTTP request and read the response
 	 */
-        rv = SSL_read(ssl, rbuf+read_cnt, READ_CHUNK_SZ);
-        if (rv <= 0) {
-            ssl_err = SSL_get_error(ssl, rv);
-            switch (ssl_err) {
-            case SSL_ERROR_NONE:
-            case SSL_ERROR_ZERO_RETURN:
-                //fprintf(stderr, "SSL_read finished\n");
-                break;
-            default:
-                ossl_err = ERR_get_error();
-                if ((rv < 0) || ossl_err) {
-                    fprintf(stderr, "SSL_read failed, rv=%d ssl_err=%d ossl_err=%d.\n",
-                            rv, ssl_err, (int)ossl_err);
-                    ERR_print_errors_fp(stderr);
-                    crv = CURLE_USE_SSL_FAILED;
-	            goto easy_perform_cleanup;
-                }
-                break;
-            }
-        }
-        read_cnt += rv;
-	
+	crv = murl_send(ctx, rbuf, strlen(rbuf));
+	if (crv == CURLE_OK) {
+	    crv = murl_send(ctx, ctx->post_fields, cl);
+	}
+	if (crv == CURLE_OK) {
+	    crv = murl_http_read_response(ctx, ctx->conn, &keep_alive, &got_data);
+	}
+	if (crv == CURLE_OK) {
+	    break;
+	}
+	murl_disconnect(ctx);
+	if (!reused || got_data) goto easy_perform_cleanup;
 	/*
-	 * Make sure we're not receving too much data from the server.
+	 * The server closed the idle connection as the request went
+	 * out, try again once on a new one
 	 */
-	if (read_cnt > MURL_RCV_MAX) {
-	    crv = CURLE_FILESIZE_EXCEEDED;
-	    goto easy_perform_cleanup;
-	}
     }
 
     /*
-     * make sure the data is null terminated
+     * Keep the session for the next connection. With TLS 1.3 the
+     * server sends it after the handshake, so it is only had now.
      */
-    rbuf[read_cnt] = 0;
-
-    /*
-     * Parse the HTTP response
-     */
-    if (murl_http_parse_response(ctx, rbuf)) {
-        crv = CURLE_HTTP2;
-	goto easy_perform_cleanup;
+    sess = SSL_get1_session(ctx->conn);
+    if (sess) {
+	if (ctx->ssl_session) SSL_SESSION_free(ctx->ssl_session);
+	ctx->ssl_session = sess;
     }
-
-    /*
-     * Send the data back to the user
-     */
-    if (ctx->write_func) {
-        (ctx->write_func)(ctx->recv_buf, 1, ctx->recv_ctr, ctx->write_ctx);
+    if (!keep_alive) {
+	murl_disconnect(ctx);
     }
 
     crv = CURLE_OK;
 easy_perform_cleanup:
-    if (ssl) {
-	SSL_shutdown(ssl);
-	SSL_free(ssl);
-    }
-    if (ssl_ctx) SSL_CTX_free(ssl_ctx);
     if (rbuf) free(rbuf);
     return crv;
 }
@@ -1099,10 +1230,8 @@ static void Curl_ossl_cleanup(void)
     ERR_remove_state(0);
 }
 
-void curl_easy_cleanup(CURL *curl)
+static void murl_free_options(SessionHandle *data)
 {
-    SessionHandle *data = (SessionHandle*)curl;
-
     if (data->user_agent) free(data->user_agent);
     if (data->url) free(data->url);
     if (data->post_fields) free(data->post_fields);
@@ -1111,8 +1240,49 @@ void curl_easy_cleanup(CURL *curl)
     if (data->ssl_cert_type) free(data->ssl_cert_type);
     if (data->ssl_key_file) free(data->ssl_key_file);
     if (data->ssl_key_type) free(data->ssl_key_type);
-    if (data->recv_buf) free(data->recv_buf);
     //if (data->headers) curl_slist_free_all(data->headers);
+}
+
+/*
+ * curl_easy_reset() puts the options of the handle back to their defaults.
+ * As with Curl, the connection kept open by the handle, and the TLS session
+ * to resume, are left for the next request.
+ */
+void curl_easy_reset(CURL *curl)
+{
+    SessionHandle *data = (SessionHandle*)curl;
+
+    if (!data)
+	return;
+
+    murl_free_options(data);
+    data->url = NULL;
+    data->use_ipv6 = 0;
+    data->user_agent = NULL;
+    data->http_post = 0;
+    data->post_fields = NULL;
+    data->post_field_size = 0;
+    data->ca_file = NULL;
+    data->ssl_verify_peer = 0;
+    data->ssl_verify_hostname = 1; /* default to verify server hostname */
+    data->ssl_certinfo = 0;
+    data->ssl_cert_file = NULL;
+    data->ssl_cert_type = NULL;
+    data->ssl_key_file = NULL;
+    data->ssl_key_type = NULL;
+    data->write_ctx = NULL;
+    data->headers = NULL;
+    data->write_func = NULL;
+    data->http_status_code = 0;
+    data->server_port = 443; /* default to HTTPS port */
+}
+
+void curl_easy_cleanup(CURL *curl)
+{
+    SessionHandle *data = (SessionHandle*)curl;
+
+    murl_free_options(data);
+    murl_tls_free(data);
 
     free(data);
 }
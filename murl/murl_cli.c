@@ -33,7 +33,8 @@ static size_t http_body_cb(void *ptr, size_t size, size_t nmemb, void *userdata)
         return 0;
     }
 
-    printf("%s", (char *)ptr);
+    /* The body comes in pieces, which are not NUL terminated */
+    fwrite(ptr, 1, nmemb, stdout);
 
     return nmemb;
 }
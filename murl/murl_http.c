@@ -51,324 +51,135 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <openssl/err.h>
 #include "murl_lcl.h"
 #include "http_parser.h"
 
-//FIXME: these are arbitrary values for now.  we're wasting memory since
-//       the query string, request path, etc. doesn't need to be this large.
-//       but the body size may need to be this large for ACVP, if not larger.
-//       we'll need to rethink how to allocate this memory for the various
-//       use cases.
-#define MAX_HEADERS 64
-#define MAX_ELEMENT_SIZE 64*1024
-#define MAX_BODY_SIZE 64*1024*1024
-
 /*
- * Using this global variable to track when all the HTTP data has been 
- * parsed.  This will need to be addressed if/when thread-safety is
- * desired.
+ * State of the response being read from the server
  */
-static int currently_parsing_eof;
-
-typedef struct message {
-    const char *name; // for debugging purposes
-    const char *raw;
-    enum http_parser_type type;
-    enum http_method method;
-    int status_code;
-    char request_path[MAX_ELEMENT_SIZE];
-    char request_url[MAX_ELEMENT_SIZE];
-    char fragment[MAX_ELEMENT_SIZE];
-    char query_string[MAX_ELEMENT_SIZE];
-    char body[MAX_BODY_SIZE];
-    size_t body_size;
-    int num_headers;
-    enum { NONE=0, FIELD, VALUE } last_header_element;
-    char headers[MAX_HEADERS][2][MAX_ELEMENT_SIZE];
-    int should_keep_alive;
-
-    int upgrade;
-
-    unsigned short http_major;
-    unsigned short http_minor;
-
-    int message_begin_cb_called;
-    int headers_complete_cb_called;
-    int message_complete_cb_called;
-    int message_complete_on_eof;
-} http_msg;
-
-int request_path_cb (http_parser *p, const char *buf, size_t len)
-{
-    http_msg *msg = p->data;
-
-    if (len > MAX_ELEMENT_SIZE) {
-        fprintf(stderr, "Maximum request path size exceeded\n");
-	return -1;
-    }
-    strncat(msg->request_path, buf, len);
-    return 0;
-}
-
-int request_url_cb (http_parser *p, const char *buf, size_t len)
-{
-    http_msg *msg = p->data;
-
-    if (len > MAX_ELEMENT_SIZE) {
-        fprintf(stderr, "Maximum URL size exceeded\n");
-	return -1;
-    }
-    strncat(msg->request_url, buf, len);
-    return 0;
-}
-
-int query_string_cb (http_parser *p, const char *buf, size_t len)
-{
-    http_msg *msg = p->data;
-
-    if (len > MAX_ELEMENT_SIZE) {
-        fprintf(stderr, "Maximum query string size exceeded\n");
-	return -1;
-    }
-    strncat(msg->query_string, buf, len);
-    return 0;
-}
-
-int fragment_cb (http_parser *p, const char *buf, size_t len)
-{
-    http_msg *msg = p->data;
-
-    if (len > MAX_ELEMENT_SIZE) {
-        fprintf(stderr, "Maximum fragment size exceeded\n");
-	return -1;
-    }
-    strncat(msg->fragment, buf, len);
-    return 0;
-}
-
-int header_field_cb (http_parser *p, const char *buf, size_t len)
-{
-    http_msg *msg = p->data;
-
-    if (len > MAX_ELEMENT_SIZE) {
-        fprintf(stderr, "Maximum header field size exceeded\n");
-	return -1;
-    }
-    if (msg->num_headers >= MAX_HEADERS) {
-        fprintf(stderr, "Maximum header count exceeded\n");
-	return -1;
-    }
-
-    if (msg->last_header_element != FIELD)
-        msg->num_headers++;
-
-    strncat(msg->headers[msg->num_headers-1][0], buf, len);
-
-    msg->last_header_element = FIELD;
-
-    return 0;
-}
-
-int header_value_cb (http_parser *p, const char *buf, size_t len)
+typedef struct murl_rsp_ {
+    SessionHandle *ctx;
+    int complete;       /* The whole response has been parsed */
+    int write_failed;   /* The write callback did not take the body */
+    int keep_alive;     /* The connection can carry another request */
+} murl_rsp;
+
+static int headers_complete_cb (http_parser *p)
 {
-    http_msg *msg = p->data;
-
-    if (len > MAX_ELEMENT_SIZE) {
-        fprintf(stderr, "Maximum header field size exceeded\n");
-	return -1;
-    }
-    if (msg->num_headers >= MAX_HEADERS) {
-        fprintf(stderr, "Maximum header count exceeded\n");
-	return -1;
-    }
-
-    strncat(msg->headers[msg->num_headers-1][1], buf, len);
-
-    msg->last_header_element = VALUE;
+    murl_rsp *rsp = p->data;
 
+    rsp->keep_alive = http_should_keep_alive(p);
     return 0;
 }
 
-int body_cb (http_parser *p, const char *buf, size_t len)
+/*
+ * Hands the body to the user as it arrives, rather than collecting all of
+ * it first, so there is no limit on its size
+ */
+static int body_cb (http_parser *p, const char *buf, size_t len)
 {
-    http_msg *msg = p->data;
+    murl_rsp *rsp = p->data;
+    SessionHandle *ctx = rsp->ctx;
 
-    if (msg->body_size + len >= MAX_BODY_SIZE) {
-        fprintf(stderr, "Maximum HTTP body size exceeded\n");
+    if (ctx->write_func &&
+        (ctx->write_func)((char *)buf, 1, len, ctx->write_ctx) != len) {
+        rsp->write_failed = 1;
         return -1;
     }
-    strncat(msg->body, buf, len);
-    msg->body_size += len;
-    return 0;
-}
-
-int count_body_cb (http_parser *p, const char *buf, size_t len)
-{
-    http_msg *msg = p->data;
-
-    msg->body_size += len;
     return 0;
 }
 
-int message_begin_cb (http_parser *p)
+static int message_complete_cb (http_parser *p)
 {
-    http_msg *msg = p->data;
-
-    msg->message_begin_cb_called = 1;
-    return 0;
-}
-
-int headers_complete_cb (http_parser *p)
-{
-    http_msg *msg = p->data;
-
-    msg->method = p->method;
-    msg->status_code = p->status_code;
-    msg->http_major = p->http_major;
-    msg->http_minor = p->http_minor;
-    msg->headers_complete_cb_called = 1;
-    msg->should_keep_alive = http_should_keep_alive(p);
-    return 0;
-}
-
-int message_complete_cb (http_parser *p)
-{
-    http_msg *msg = p->data;
-
-    if (msg->should_keep_alive != http_should_keep_alive(p))
-    {
-        fprintf(stderr, "\n\n *** Error http_should_keep_alive() should have same "
-                "value in both on_message_complete and on_headers_complete "
-                "but it doesn't! ***\n\n");
-        return 1;
-    }
-    msg->message_complete_cb_called = 1;
-
-    msg->message_complete_on_eof = currently_parsing_eof;
+    murl_rsp *rsp = p->data;
 
+    rsp->keep_alive = http_should_keep_alive(p);
+    rsp->complete = 1;
     return 0;
 }
 
-
-
-
 static http_parser_settings settings =
-{.on_message_begin = message_begin_cb
- ,.on_header_field = header_field_cb
- ,.on_header_value = header_value_cb
- ,.on_path = request_path_cb
- ,.on_url = request_url_cb
- ,.on_fragment = fragment_cb
- ,.on_query_string = query_string_cb
+{.on_headers_complete = headers_complete_cb
  ,.on_body = body_cb
- ,.on_headers_complete = headers_complete_cb
  ,.on_message_complete = message_complete_cb};
 
-http_parser * murl_http_parser_init (enum http_parser_type type, http_msg *msg)
-{
-    http_parser *parser;
-
-    parser = calloc(1, sizeof(http_parser));
-    if (!parser) {
-        fprintf(stderr, "malloc failed (%s)\n", __FUNCTION__);
-	return NULL;
-    }
-    http_parser_init(parser, type);
-    parser->data = msg;
-
-    return parser;
-}
-
-void murl_http_parser_free (http_parser *parser)
-{
-    free(parser);
-}
-
-size_t murl_http_parse (http_parser *parser, const char *buf, size_t len)
-{
-    size_t nparsed;
-    currently_parsing_eof = (len == 0);
-    nparsed = http_parser_execute(parser, &settings, buf, len);
-    return nparsed;
-}
-
 /*
- * This routine will perform HTTP parsing on the data provided.
+ * This routine reads the response to the request just sent over ssl and
+ * parses it as it comes in. The body is passed on to the write callback
+ * piece by piece.
+ *
+ * keep_alive is set when the connection can be used for another request.
+ * got_data is set once anything at all was read, which tells an idle
+ * connection the server had closed apart from a failed request.
  *
- * Returns 0 on success, non-zero on error.
+ * Returns CURLE_OK on success.
  */
-int murl_http_parse_response (SessionHandle *ctx, const char *buf)
+CURLcode murl_http_read_response (SessionHandle *ctx, SSL *ssl, int *keep_alive, int *got_data)
 {
+    http_parser parser;
+    murl_rsp rsp;
+    char buf[MURL_READ_CHUNK_SZ];
     size_t parsed;
+    unsigned long ossl_err;
+    int ssl_err;
     int rv;
-    int len;
-    http_parser *parser;
-    http_msg *msg;
 
-    msg = calloc(1, sizeof(http_msg));
-    if (!msg) {
-        fprintf(stderr, "malloc failed (%s)\n", __FUNCTION__);
-	return 1;
+    *keep_alive = 0;
+    *got_data = 0;
+    memset(&rsp, 0, sizeof(rsp));
+    rsp.ctx = ctx;
+    http_parser_init(&parser, HTTP_RESPONSE);
+    parser.data = &rsp;
+
+    ERR_clear_error();
+    while (!rsp.complete) {
+        rv = SSL_read(ssl, buf, sizeof(buf));
+        if (rv <= 0) {
+            ssl_err = SSL_get_error(ssl, rv);
+            if (ssl_err != SSL_ERROR_ZERO_RETURN) {
+                ossl_err = ERR_get_error();
+                if ((rv < 0) || ossl_err) {
+                    if (*got_data) {
+                        fprintf(stderr, "SSL_read failed, rv=%d ssl_err=%d ossl_err=%d.\n",
+                                rv, ssl_err, (int)ossl_err);
+                        ERR_print_errors_fp(stderr);
+                    }
+                    ERR_clear_error();
+                    return CURLE_RECV_ERROR;
+                }
+            }
+            /*
+             * The server closed the connection, which is how a body
+             * without a length ends
+             */
+            http_parser_execute(&parser, &settings, NULL, 0);
+            break;
+        }
+
+        *got_data = 1;
+        parsed = http_parser_execute(&parser, &settings, buf, rv);
+        if (rsp.write_failed) {
+            return CURLE_WRITE_ERROR;
+        }
+        if (parsed != (size_t)rv) {
+            fprintf(stderr, "HTTP parsing failed\n");
+            return CURLE_RECV_ERROR;
+        }
     }
 
-    /*
-     * Initialize the parser
-     */
-    parser = murl_http_parser_init(HTTP_RESPONSE, msg);
-    if (!parser) {
-        fprintf(stderr, "murl_http_parser_init failed (%s)\n", __FUNCTION__);
-	free(msg);
-	return 1;
-    }
-
-    /*
-     * Parse the data
-     */
-    parsed = murl_http_parse(parser, buf, strlen(buf));
-
-    /*
-     * check that all of it was parsed
-     */
-    rv = (parsed == strlen(buf));
-    parsed = murl_http_parse(parser, NULL, 0);
-    rv &= (parsed == 0);
-
     /*
      * Save the HTTP status code sent by the server
      */
-    ctx->http_status_code = parser->status_code;
-    murl_http_parser_free(parser);
-
-    if (!rv) {
-        fprintf(stderr, "HTTP parsing failed\n");
-	free(msg);
-        return 1;
-    }
+    ctx->http_status_code = parser.status_code;
 
-    len = msg->body_size;
-    if (ctx->recv_buf) {
-	free(ctx->recv_buf); 
-	ctx->recv_buf = NULL;
-	ctx->recv_ctr = 0;
-    }
-    ctx->recv_buf = calloc(1, len+1);
-    if (!ctx->recv_buf) {
-        fprintf(stderr, "\nmalloc failed in curl write reg func\n");
-	free(msg);
-        return 1;
+    if (!rsp.complete) {
+        if (!*got_data) {
+            return CURLE_GOT_NOTHING;
+        }
+        fprintf(stderr, "Connection closed before the HTTP response was complete\n");
+        return CURLE_PARTIAL_FILE;
     }
-
-    /*
-     * Copy the data to the Murl context
-     */
-    memcpy(ctx->recv_buf, msg->body, len);
-    ctx->recv_buf[len] = 0;
-    ctx->recv_ctr += len;
-    free(msg);
-
-    return 0;
+    *keep_alive = rsp.keep_alive;
+    return CURLE_OK;
 }
-
-
-
-
@@ -32,11 +32,10 @@ extern "C" {
 #include <openssl/ssl.h>
 #include "murl.h"
 
-/* Maximum size of data that can be in HTTP POST */
-#define MURL_POST_MAX	64*1024*1024
 /* Maximum size of HTTP request, minus the POST data */
 #define MURL_HDR_MAX	64*1024
-#define MURL_RCV_MAX	MURL_POST_MAX
+/* Size of the reads done while receiving the HTTP response */
+#define MURL_READ_CHUNK_SZ	16384
 
 #define MURL_HOSTNAME_MAX   256
 
@@ -62,18 +61,29 @@ typedef struct SessionHandle_ {
     struct curl_slist	    *headers;
     curl_write_callback	    write_func;
 
-    SSL	*ssl;
+    /*
+     * The following members outlive the options, see curl_easy_reset(), so
+     * the next request can go over the same connection, or at least resume
+     * the TLS session.
+     */
+    SSL_CTX		    *ssl_ctx;
+    char		    *tls_ca_file; /* Options ssl_ctx was set up with */
+    char		    *tls_cert_file;
+    char		    *tls_key_file;
+    int			    tls_verify_peer;
+    SSL			    *conn; /* Keep-alive connection, NULL if none is open */
+    SSL_SESSION		    *ssl_session; /* Of the last connection, to resume the next */
+    char		    conn_host[MURL_HOSTNAME_MAX]; /* Server of the last connection */
+    int			    conn_port;
 
     /* The following members are for HTTP parsing */
     int			http_status_code;  /* HTTP response from server */
-    char		*recv_buf;
-    int			recv_ctr;
     char		path_segment[256]; //FIXME: use a pointer
     char		host_name[MURL_HOSTNAME_MAX]; //FIXME: use a pointer
     int			server_port;
 } SessionHandle;
 
-int murl_http_parse_response(SessionHandle *ctx, const char *buf);
+CURLcode murl_http_read_response(SessionHandle *ctx, SSL *ssl, int *keep_alive, int *got_data);
 
 #ifdef  __cplusplus
 }
@@ -48,6 +48,7 @@ extern "C" {
 #include "safe_lib_errno.h"
 #include "safe_mem_lib.h"
 #include "safe_str_lib.h"
+#include "safe_lib_inline.h"
 
 
 #ifdef __cplusplus
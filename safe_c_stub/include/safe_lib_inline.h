@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------
+ * safe_lib_inline.h -- Inline versions of the hottest stub functions
+ *
+ * October 2008, Bo Berry
+ *
+ * Copyright (c) 2008-2011 by Cisco Systems, Inc
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *------------------------------------------------------------------
+ */
+#ifndef __SAFE_LIB_INLINE_H__
+#define __SAFE_LIB_INLINE_H__
+
+/*
+ * With SAFEC_STUB_INLINE defined, memcpy_s(), memzero_s() and strcmp_s()
+ * expand to the static inline functions below instead of calling into
+ * libsafe_lib. The checks and return values are those of the out of
+ * line stubs, which are still built, so code compiled against the real
+ * safec, or without SAFEC_STUB_INLINE, links as before. strnlen_s() stays
+ * out of line: callers pass the RSIZE_MAX_STR style bounds safec expects,
+ * which an inlined strnlen() warns about for every short literal.
+ */
+#if defined(SAFEC_STUB_INLINE) && !defined(SAFEC_STUB_BUILD) && !defined(_WIN32)
+
+#include <string.h>
+
+static inline errno_t safec_inline_memcpy_s(void *dest, rsize_t dmax, const void *src, rsize_t slen) {
+    if (!src || !dest) return (ESNULLP);
+    if (slen > dmax) return (ESLEMAX);
+    memcpy(dest, src, slen);
+    return (EOK);
+}
+#define memcpy_s safec_inline_memcpy_s
+
+#if defined(__GNUC__) || defined(__clang__)
+static inline errno_t safec_inline_memzero_s(void *dest, rsize_t dmax) {
+    if (!dest) return (ESNULLP);
+    memset(dest, 0, dmax);
+    /* Once inlined the wipe of a buffer about to be freed would be a dead store */
+    __asm__ __volatile__("" : : "r"(dest) : "memory");
+    return (EOK);
+}
+#define memzero_s safec_inline_memzero_s
+#endif
+
+static inline errno_t safec_inline_strcmp_s(const char *dest, rsize_t dmax, const char *src, int *indicator) {
+    if (!src || !dest) return (ESNULLP);
+    if (dmax == 0 || dmax > RSIZE_MAX_STR) return (ESZEROL);
+    *indicator = strcmp(dest, src);
+    return (EOK);
+}
+#define strcmp_s safec_inline_strcmp_s
+
+#endif /* SAFEC_STUB_INLINE */
+#endif /* __SAFE_LIB_INLINE_H__ */
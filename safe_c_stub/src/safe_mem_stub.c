@@ -35,6 +35,7 @@
 #include <string.h>
 #include <stdint.h>
 
+#define SAFEC_STUB_BUILD /* define the out of line functions */
 #include "safe_lib.h"
 
 /*
@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <ctype.h>
+#define SAFEC_STUB_BUILD /* define the out of line functions */
 #include "safe_lib.h"
 
 #define SAFEC_STUB_UNUSED(x) (void)(x)
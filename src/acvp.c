@@ -12,6 +12,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
+#include <limits.h>
 #include "acvp.h"
 #include "acvp_lcl.h"
 #include "parson.h"
@@ -32,25 +33,125 @@ static ACVP_RESULT acvp_parse_test_session_register(ACVP_CTX *ctx);
 
 static ACVP_RESULT acvp_parse_session_info_file(ACVP_CTX *ctx, const char *filename);
 
-static ACVP_RESULT acvp_process_vsid(ACVP_CTX *ctx, char *vsid_url, int count);
+static ACVP_RESULT acvp_process_vsid(ACVP_CTX *ctx, ACVP_VS_JOB *job, int count);
+
+static ACVP_RESULT acvp_run_vector_sets(ACVP_CTX *ctx, int vs_cnt, JSON_Array *reg_array,
+                                        const int *sel, const char *rsp_filename);
+
+static ACVP_RESULT acvp_save_vector_set(ACVP_CTX *ctx, JSON_Value *alg_val, int count);
+
+static ACVP_RESULT acvp_pool_save_vector_set(ACVP_CTX *ctx, JSON_Value *alg_val, int count);
+static void acvp_step_free(ACVP_CTX *ctx);
+
+static ACVP_RESULT acvp_close_vector_req_file(ACVP_CTX *ctx);
 
 static ACVP_RESULT acvp_process_vector_set(ACVP_CTX *ctx, JSON_Object *obj);
 
 static ACVP_RESULT acvp_dispatch_vector_set(ACVP_CTX *ctx, JSON_Object *obj);
 
-static void acvp_cap_free_sl(ACVP_SL_LIST *list);
+static ACVP_RESULT acvp_get_result_test_session(ACVP_CTX *ctx, char *session_url);
 
-static void acvp_cap_free_nl(ACVP_NAME_LIST *list);
+static ACVP_RESULT acvp_put_data_from_ctx(ACVP_CTX *ctx);
 
-static void acvp_cap_free_pl(ACVP_PARAM_LIST *list);
+static void acvp_fetch_start(ACVP_CTX *ctx, ACVP_FETCH_POOL *pool, ACVP_FETCH_JOB *jobs, int count,
+                             ACVP_FETCH_KIND kind, int window);
 
-static void acvp_cap_free_domain(ACVP_JSON_DOMAIN_OBJ *domain);
+static ACVP_FETCH_JOB *acvp_fetch_take(ACVP_FETCH_POOL *pool, int i);
 
-static void acvp_cap_free_hash_pairs(ACVP_RSA_HASH_PAIR_LIST *list);
+static void acvp_fetch_finish(ACVP_FETCH_POOL *pool);
 
-static ACVP_RESULT acvp_get_result_test_session(ACVP_CTX *ctx, char *session_url);
+static void acvp_free_fetch_jobs(ACVP_FETCH_JOB *jobs, int count);
 
-static ACVP_RESULT acvp_put_data_from_ctx(ACVP_CTX *ctx);
+/*
+ * The kat handler of an algorithm family, or NULL when the family was left
+ * out of the build with --enable-algorithms, so that its vector sets and
+ * capabilities are refused instead of linking in the handler.
+ */
+#ifdef ACVP_NO_AES
+#define ACVP_AES_KAT(handler) NULL
+#else
+#define ACVP_AES_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_TDES
+#define ACVP_TDES_KAT(handler) NULL
+#else
+#define ACVP_TDES_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_HASH
+#define ACVP_HASH_KAT(handler) NULL
+#else
+#define ACVP_HASH_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_DRBG
+#define ACVP_DRBG_KAT(handler) NULL
+#else
+#define ACVP_DRBG_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_HMAC
+#define ACVP_HMAC_KAT(handler) NULL
+#else
+#define ACVP_HMAC_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_CMAC
+#define ACVP_CMAC_KAT(handler) NULL
+#else
+#define ACVP_CMAC_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_KMAC
+#define ACVP_KMAC_KAT(handler) NULL
+#else
+#define ACVP_KMAC_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_RSA
+#define ACVP_RSA_KAT(handler) NULL
+#else
+#define ACVP_RSA_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_DSA
+#define ACVP_DSA_KAT(handler) NULL
+#else
+#define ACVP_DSA_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_ECDSA
+#define ACVP_ECDSA_KAT(handler) NULL
+#else
+#define ACVP_ECDSA_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_EDDSA
+#define ACVP_EDDSA_KAT(handler) NULL
+#else
+#define ACVP_EDDSA_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_KDF
+#define ACVP_KDF_KAT(handler) NULL
+#else
+#define ACVP_KDF_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_KAS
+#define ACVP_KAS_KAT(handler) NULL
+#else
+#define ACVP_KAS_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_KDA
+#define ACVP_KDA_KAT(handler) NULL
+#else
+#define ACVP_KDA_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_KTS
+#define ACVP_KTS_KAT(handler) NULL
+#else
+#define ACVP_KTS_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_SAFE_PRIMES
+#define ACVP_SAFE_PRIMES_KAT(handler) NULL
+#else
+#define ACVP_SAFE_PRIMES_KAT(handler) &handler
+#endif
+#ifdef ACVP_NO_LMS
+#define ACVP_LMS_KAT(handler) NULL
+#else
+#define ACVP_LMS_KAT(handler) &handler
+#endif
 
 /*
  * This table maps ACVP operations to handlers within libacvp.
@@ -63,115 +164,115 @@ static ACVP_RESULT acvp_put_data_from_ctx(ACVP_CTX *ctx);
  * This table is not sparse, it must contain ACVP_OP_MAX entries.
  */
 ACVP_ALG_HANDLER alg_tbl[ACVP_ALG_MAX] = {
-    { ACVP_AES_GCM,           &acvp_aes_kat_handler,              ACVP_ALG_AES_GCM,           NULL, ACVP_REV_AES_GCM, {ACVP_SUB_AES_GCM}},
-    { ACVP_AES_GCM_SIV,       &acvp_aes_kat_handler,              ACVP_ALG_AES_GCM_SIV,       NULL, ACVP_REV_AES_GCM_SIV, {ACVP_SUB_AES_GCM_SIV}},
-    { ACVP_AES_CCM,           &acvp_aes_kat_handler,              ACVP_ALG_AES_CCM,           NULL, ACVP_REV_AES_CCM, {ACVP_SUB_AES_CCM}},
-    { ACVP_AES_ECB,           &acvp_aes_kat_handler,              ACVP_ALG_AES_ECB,           NULL, ACVP_REV_AES_ECB, {ACVP_SUB_AES_ECB}},
-    { ACVP_AES_CBC,           &acvp_aes_kat_handler,              ACVP_ALG_AES_CBC,           NULL, ACVP_REV_AES_CBC, {ACVP_SUB_AES_CBC}},
-    { ACVP_AES_CBC_CS1,       &acvp_aes_kat_handler,              ACVP_ALG_AES_CBC_CS1,       NULL, ACVP_REV_AES_CBC_CS1, {ACVP_SUB_AES_CBC_CS1}},
-    { ACVP_AES_CBC_CS2,       &acvp_aes_kat_handler,              ACVP_ALG_AES_CBC_CS2,       NULL, ACVP_REV_AES_CBC_CS2, {ACVP_SUB_AES_CBC_CS2}},
-    { ACVP_AES_CBC_CS3,       &acvp_aes_kat_handler,              ACVP_ALG_AES_CBC_CS3,       NULL, ACVP_REV_AES_CBC_CS3, {ACVP_SUB_AES_CBC_CS3}},
-    { ACVP_AES_CFB1,          &acvp_aes_kat_handler,              ACVP_ALG_AES_CFB1,          NULL, ACVP_REV_AES_CFB1, {ACVP_SUB_AES_CFB1}},
-    { ACVP_AES_CFB8,          &acvp_aes_kat_handler,              ACVP_ALG_AES_CFB8,          NULL, ACVP_REV_AES_CFB8, {ACVP_SUB_AES_CFB8}},
-    { ACVP_AES_CFB128,        &acvp_aes_kat_handler,              ACVP_ALG_AES_CFB128,        NULL, ACVP_REV_AES_CFB128, {ACVP_SUB_AES_CFB128}},
-    { ACVP_AES_OFB,           &acvp_aes_kat_handler,              ACVP_ALG_AES_OFB,           NULL, ACVP_REV_AES_OFB, {ACVP_SUB_AES_OFB}},
-    { ACVP_AES_CTR,           &acvp_aes_kat_handler,              ACVP_ALG_AES_CTR,           NULL, ACVP_REV_AES_CTR, {ACVP_SUB_AES_CTR}},
-    { ACVP_AES_XTS,           &acvp_aes_kat_handler,              ACVP_ALG_AES_XTS,           NULL, ACVP_REV_AES_XTS, {ACVP_SUB_AES_XTS}},
-    { ACVP_AES_KW,            &acvp_aes_kat_handler,              ACVP_ALG_AES_KW,            NULL, ACVP_REV_AES_KW, {ACVP_SUB_AES_KW}},
-    { ACVP_AES_KWP,           &acvp_aes_kat_handler,              ACVP_ALG_AES_KWP,           NULL, ACVP_REV_AES_KWP, {ACVP_SUB_AES_KWP}},
-    { ACVP_AES_GMAC,          &acvp_aes_kat_handler,              ACVP_ALG_AES_GMAC,          NULL, ACVP_REV_AES_GMAC, {ACVP_SUB_AES_GMAC}},
-    { ACVP_AES_XPN,           &acvp_aes_kat_handler,              ACVP_ALG_AES_XPN ,          NULL, ACVP_REV_AES_XPN, {ACVP_SUB_AES_XPN}},
-    { ACVP_TDES_ECB,          &acvp_des_kat_handler,              ACVP_ALG_TDES_ECB,          NULL, ACVP_REV_TDES_ECB, {ACVP_SUB_TDES_ECB}},
-    { ACVP_TDES_CBC,          &acvp_des_kat_handler,              ACVP_ALG_TDES_CBC,          NULL, ACVP_REV_TDES_CBC, {ACVP_SUB_TDES_CBC}},
-    { ACVP_TDES_CBCI,         &acvp_des_kat_handler,              ACVP_ALG_TDES_CBCI,         NULL, ACVP_REV_TDES_CBCI, {ACVP_SUB_TDES_CBCI}},
-    { ACVP_TDES_OFB,          &acvp_des_kat_handler,              ACVP_ALG_TDES_OFB,          NULL, ACVP_REV_TDES_OFB, {ACVP_SUB_TDES_OFB}},
-    { ACVP_TDES_OFBI,         &acvp_des_kat_handler,              ACVP_ALG_TDES_OFBI,         NULL, ACVP_REV_TDES_OFBI, {ACVP_SUB_TDES_OFBI}},
-    { ACVP_TDES_CFB1,         &acvp_des_kat_handler,              ACVP_ALG_TDES_CFB1,         NULL, ACVP_REV_TDES_CFB1, {ACVP_SUB_TDES_CFB1}},
-    { ACVP_TDES_CFB8,         &acvp_des_kat_handler,              ACVP_ALG_TDES_CFB8,         NULL, ACVP_REV_TDES_CFB8, {ACVP_SUB_TDES_CFB8}},
-    { ACVP_TDES_CFB64,        &acvp_des_kat_handler,              ACVP_ALG_TDES_CFB64,        NULL, ACVP_REV_TDES_CFB64, {ACVP_SUB_TDES_CFB64}},
-    { ACVP_TDES_CFBP1,        &acvp_des_kat_handler,              ACVP_ALG_TDES_CFBP1,        NULL, ACVP_REV_TDES_CFBP1, {ACVP_SUB_TDES_CFBP1}},
-    { ACVP_TDES_CFBP8,        &acvp_des_kat_handler,              ACVP_ALG_TDES_CFBP8,        NULL, ACVP_REV_TDES_CFBP8, {ACVP_SUB_TDES_CFBP8}},
-    { ACVP_TDES_CFBP64,       &acvp_des_kat_handler,              ACVP_ALG_TDES_CFBP64,       NULL, ACVP_REV_TDES_CFBP64, {ACVP_SUB_TDES_CFBP64}},
-    { ACVP_TDES_CTR,          &acvp_des_kat_handler,              ACVP_ALG_TDES_CTR,          NULL, ACVP_REV_TDES_CTR, {ACVP_SUB_TDES_CTR}},
-    { ACVP_TDES_KW,           &acvp_des_kat_handler,              ACVP_ALG_TDES_KW,           NULL, ACVP_REV_TDES_KW, {ACVP_SUB_TDES_KW}},
-    { ACVP_HASH_SHA1,         &acvp_hash_kat_handler,             ACVP_ALG_SHA1,              NULL, ACVP_REV_HASH_SHA1, {ACVP_SUB_HASH_SHA1}},
-    { ACVP_HASH_SHA224,       &acvp_hash_kat_handler,             ACVP_ALG_SHA224,            NULL, ACVP_REV_HASH_SHA224, {ACVP_SUB_HASH_SHA2_224}},
-    { ACVP_HASH_SHA256,       &acvp_hash_kat_handler,             ACVP_ALG_SHA256,            NULL, ACVP_REV_HASH_SHA256, {ACVP_SUB_HASH_SHA2_256}},
-    { ACVP_HASH_SHA384,       &acvp_hash_kat_handler,             ACVP_ALG_SHA384,            NULL, ACVP_REV_HASH_SHA384, {ACVP_SUB_HASH_SHA2_384}},
-    { ACVP_HASH_SHA512,       &acvp_hash_kat_handler,             ACVP_ALG_SHA512,            NULL, ACVP_REV_HASH_SHA512, {ACVP_SUB_HASH_SHA2_512}},
-    { ACVP_HASH_SHA512_224,   &acvp_hash_kat_handler,             ACVP_ALG_SHA512_224,        NULL, ACVP_REV_HASH_SHA512_224, {ACVP_SUB_HASH_SHA2_512_224}},
-    { ACVP_HASH_SHA512_256,   &acvp_hash_kat_handler,             ACVP_ALG_SHA512_256,        NULL, ACVP_REV_HASH_SHA512_256, {ACVP_SUB_HASH_SHA2_512_256}},
-    { ACVP_HASH_SHA3_224,     &acvp_hash_kat_handler,             ACVP_ALG_SHA3_224,          NULL, ACVP_REV_HASH_SHA3_224, {ACVP_SUB_HASH_SHA3_224}},
-    { ACVP_HASH_SHA3_256,     &acvp_hash_kat_handler,             ACVP_ALG_SHA3_256,          NULL, ACVP_REV_HASH_SHA3_256, {ACVP_SUB_HASH_SHA3_256}},
-    { ACVP_HASH_SHA3_384,     &acvp_hash_kat_handler,             ACVP_ALG_SHA3_384,          NULL, ACVP_REV_HASH_SHA3_384, {ACVP_SUB_HASH_SHA3_384}},
-    { ACVP_HASH_SHA3_512,     &acvp_hash_kat_handler,             ACVP_ALG_SHA3_512,          NULL, ACVP_REV_HASH_SHA3_512, {ACVP_SUB_HASH_SHA3_512}},
-    { ACVP_HASH_SHAKE_128,    &acvp_hash_kat_handler,             ACVP_ALG_SHAKE_128,         NULL, ACVP_REV_HASH_SHAKE_128, {ACVP_SUB_HASH_SHAKE_128}},
-    { ACVP_HASH_SHAKE_256,    &acvp_hash_kat_handler,             ACVP_ALG_SHAKE_256,         NULL, ACVP_REV_HASH_SHAKE_256, {ACVP_SUB_HASH_SHAKE_256}},
-    { ACVP_HASHDRBG,          &acvp_drbg_kat_handler,             ACVP_ALG_HASHDRBG,          NULL, ACVP_REV_HASHDRBG, {ACVP_SUB_DRBG_HASH}},
-    { ACVP_HMACDRBG,          &acvp_drbg_kat_handler,             ACVP_ALG_HMACDRBG,          NULL, ACVP_REV_HMACDRBG, {ACVP_SUB_DRBG_HMAC}},
-    { ACVP_CTRDRBG,           &acvp_drbg_kat_handler,             ACVP_ALG_CTRDRBG,           NULL, ACVP_REV_CTRDRBG, {ACVP_SUB_DRBG_CTR}},
-    { ACVP_HMAC_SHA1,         &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA1,         NULL, ACVP_REV_HMAC_SHA1, {ACVP_SUB_HMAC_SHA1}},
-    { ACVP_HMAC_SHA2_224,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA2_224,     NULL, ACVP_REV_HMAC_SHA2_224, {ACVP_SUB_HMAC_SHA2_224}},
-    { ACVP_HMAC_SHA2_256,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA2_256,     NULL, ACVP_REV_HMAC_SHA2_256, {ACVP_SUB_HMAC_SHA2_256}},
-    { ACVP_HMAC_SHA2_384,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA2_384,     NULL, ACVP_REV_HMAC_SHA2_384, {ACVP_SUB_HMAC_SHA2_384}},
-    { ACVP_HMAC_SHA2_512,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA2_512,     NULL, ACVP_REV_HMAC_SHA2_512, {ACVP_SUB_HMAC_SHA2_512}},
-    { ACVP_HMAC_SHA2_512_224, &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA2_512_224, NULL, ACVP_REV_HMAC_SHA2_512_224, {ACVP_SUB_HMAC_SHA2_512_224}},
-    { ACVP_HMAC_SHA2_512_256, &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA2_512_256, NULL, ACVP_REV_HMAC_SHA2_512_256, {ACVP_SUB_HMAC_SHA2_512_256}},
-    { ACVP_HMAC_SHA3_224,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA3_224,     NULL, ACVP_REV_HMAC_SHA3_224, {ACVP_SUB_HMAC_SHA3_224}},
-    { ACVP_HMAC_SHA3_256,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA3_256,     NULL, ACVP_REV_HMAC_SHA3_256, {ACVP_SUB_HMAC_SHA3_256}},
-    { ACVP_HMAC_SHA3_384,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA3_384,     NULL, ACVP_REV_HMAC_SHA3_384, {ACVP_SUB_HMAC_SHA3_384}},
-    { ACVP_HMAC_SHA3_512,     &acvp_hmac_kat_handler,             ACVP_ALG_HMAC_SHA3_512,     NULL, ACVP_REV_HMAC_SHA3_512, {ACVP_SUB_HMAC_SHA3_512}},
-    { ACVP_CMAC_AES,          &acvp_cmac_kat_handler,             ACVP_ALG_CMAC_AES,          NULL, ACVP_REV_CMAC_AES, {ACVP_SUB_CMAC_AES}},
-    { ACVP_CMAC_TDES,         &acvp_cmac_kat_handler,             ACVP_ALG_CMAC_TDES,         NULL, ACVP_REV_CMAC_TDES, {ACVP_SUB_CMAC_TDES}},
-    { ACVP_KMAC_128,          &acvp_kmac_kat_handler,             ACVP_ALG_KMAC_128,          NULL, ACVP_REV_KMAC_128, {ACVP_SUB_KMAC_128}},
-    { ACVP_KMAC_256,          &acvp_kmac_kat_handler,             ACVP_ALG_KMAC_256,          NULL, ACVP_REV_KMAC_256, {ACVP_SUB_KMAC_256}},
-    { ACVP_DSA_KEYGEN,        &acvp_dsa_kat_handler,              ACVP_ALG_DSA,               ACVP_ALG_DSA_KEYGEN, ACVP_REV_DSA, {ACVP_SUB_DSA_KEYGEN}},
-    { ACVP_DSA_PQGGEN,        &acvp_dsa_kat_handler,              ACVP_ALG_DSA,               ACVP_ALG_DSA_PQGGEN, ACVP_REV_DSA, {ACVP_SUB_DSA_PQGGEN}},
-    { ACVP_DSA_PQGVER,        &acvp_dsa_kat_handler,              ACVP_ALG_DSA,               ACVP_ALG_DSA_PQGVER, ACVP_REV_DSA, {ACVP_SUB_DSA_PQGVER}},
-    { ACVP_DSA_SIGGEN,        &acvp_dsa_kat_handler,              ACVP_ALG_DSA,               ACVP_ALG_DSA_SIGGEN, ACVP_REV_DSA, {ACVP_SUB_DSA_SIGGEN}},
-    { ACVP_DSA_SIGVER,        &acvp_dsa_kat_handler,              ACVP_ALG_DSA,               ACVP_ALG_DSA_SIGVER, ACVP_REV_DSA, {ACVP_SUB_DSA_SIGVER}},
-    { ACVP_RSA_KEYGEN,        &acvp_rsa_keygen_kat_handler,       ACVP_ALG_RSA,               ACVP_MODE_KEYGEN, ACVP_REV_RSA, {ACVP_SUB_RSA_KEYGEN}},
-    { ACVP_RSA_SIGGEN,        &acvp_rsa_siggen_kat_handler,       ACVP_ALG_RSA,               ACVP_MODE_SIGGEN, ACVP_REV_RSA, {ACVP_SUB_RSA_SIGGEN}},
-    { ACVP_RSA_SIGVER,        &acvp_rsa_sigver_kat_handler,       ACVP_ALG_RSA,               ACVP_MODE_SIGVER, ACVP_REV_RSA, {ACVP_SUB_RSA_SIGVER}},
-    { ACVP_RSA_DECPRIM,       &acvp_rsa_decprim_kat_handler,      ACVP_ALG_RSA,               ACVP_MODE_DECPRIM, ACVP_REV_RSA_DECPRIM, {ACVP_SUB_RSA_DECPRIM}},
-    { ACVP_RSA_SIGPRIM,       &acvp_rsa_sigprim_kat_handler,      ACVP_ALG_RSA,               ACVP_MODE_SIGPRIM, ACVP_REV_RSA_SIGPRIM, {ACVP_SUB_RSA_SIGPRIM}},
-    { ACVP_ECDSA_KEYGEN,      &acvp_ecdsa_keygen_kat_handler,     ACVP_ALG_ECDSA,             ACVP_MODE_KEYGEN, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_KEYGEN}},
-    { ACVP_ECDSA_KEYVER,      &acvp_ecdsa_keyver_kat_handler,     ACVP_ALG_ECDSA,             ACVP_MODE_KEYVER, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_KEYVER}},
-    { ACVP_ECDSA_SIGGEN,      &acvp_ecdsa_siggen_kat_handler,     ACVP_ALG_ECDSA,             ACVP_MODE_SIGGEN, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_SIGGEN}},
-    { ACVP_ECDSA_SIGVER,      &acvp_ecdsa_sigver_kat_handler,     ACVP_ALG_ECDSA,             ACVP_MODE_SIGVER, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_SIGVER}},
-    { ACVP_DET_ECDSA_SIGGEN,  &acvp_det_ecdsa_siggen_kat_handler, ACVP_ALG_DET_ECDSA,         ACVP_MODE_SIGGEN, ACVP_REV_ECDSA, {ACVP_SUB_DET_ECDSA_SIGGEN}},
-    { ACVP_EDDSA_KEYGEN,      &acvp_eddsa_keygen_kat_handler,     ACVP_ALG_EDDSA,             ACVP_MODE_KEYGEN, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_KEYGEN}},
-    { ACVP_EDDSA_KEYVER,      &acvp_eddsa_keyver_kat_handler,     ACVP_ALG_EDDSA,             ACVP_MODE_KEYVER, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_KEYVER}},
-    { ACVP_EDDSA_SIGGEN,      &acvp_eddsa_siggen_kat_handler,     ACVP_ALG_EDDSA,             ACVP_MODE_SIGGEN, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_SIGGEN}},
-    { ACVP_EDDSA_SIGVER,      &acvp_eddsa_sigver_kat_handler,     ACVP_ALG_EDDSA,             ACVP_MODE_SIGVER, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_SIGVER}},
-    { ACVP_KDF135_SNMP,       &acvp_kdf135_snmp_kat_handler,      ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_SNMP, ACVP_REV_KDF135_SNMP, {ACVP_SUB_KDF_SNMP}},
-    { ACVP_KDF135_SSH,        &acvp_kdf135_ssh_kat_handler,       ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_SSH, ACVP_REV_KDF135_SSH, {ACVP_SUB_KDF_SSH}},
-    { ACVP_KDF135_SRTP,       &acvp_kdf135_srtp_kat_handler,      ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_SRTP, ACVP_REV_KDF135_SRTP, {ACVP_SUB_KDF_SRTP}},
-    { ACVP_KDF135_IKEV2,      &acvp_kdf135_ikev2_kat_handler,     ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_IKEV2, ACVP_REV_KDF135_IKEV2, {ACVP_SUB_KDF_IKEV2}},
-    { ACVP_KDF135_IKEV1,      &acvp_kdf135_ikev1_kat_handler,     ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_IKEV1, ACVP_REV_KDF135_IKEV1, {ACVP_SUB_KDF_IKEV1}},
-    { ACVP_KDF135_X942,       &acvp_kdf135_x942_kat_handler,      ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_X942, ACVP_REV_KDF135_X942, {ACVP_SUB_KDF_X942}},
-    { ACVP_KDF135_X963,       &acvp_kdf135_x963_kat_handler,      ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_X963, ACVP_REV_KDF135_X963, {ACVP_SUB_KDF_X963}},
-    { ACVP_KDF108,            &acvp_kdf108_kat_handler,           ACVP_ALG_KDF108,            NULL, ACVP_REV_KDF108, {ACVP_SUB_KDF_108}},
-    { ACVP_PBKDF,             &acvp_pbkdf_kat_handler,            ACVP_ALG_PBKDF,             NULL, ACVP_REV_PBKDF, {ACVP_SUB_KDF_PBKDF}},
-    { ACVP_KDF_TLS12,         &acvp_kdf_tls12_kat_handler,        ACVP_ALG_TLS12,             ACVP_ALG_KDF_TLS12, ACVP_REV_KDF_TLS12, {ACVP_SUB_KDF_TLS12}},
-    { ACVP_KDF_TLS13,         &acvp_kdf_tls13_kat_handler,        ACVP_ALG_TLS13,             ACVP_ALG_KDF_TLS13, ACVP_REV_KDF_TLS13, {ACVP_SUB_KDF_TLS13}},
-    { ACVP_KAS_ECC_CDH,       &acvp_kas_ecc_kat_handler,          ACVP_ALG_KAS_ECC,           ACVP_ALG_KAS_ECC_CDH, ACVP_REV_KAS_ECC, {ACVP_SUB_KAS_ECC_CDH}},
-    { ACVP_KAS_ECC_COMP,      &acvp_kas_ecc_kat_handler,          ACVP_ALG_KAS_ECC,           ACVP_ALG_KAS_ECC_COMP, ACVP_REV_KAS_ECC, {ACVP_SUB_KAS_ECC_COMP}},
-    { ACVP_KAS_ECC_NOCOMP,    &acvp_kas_ecc_kat_handler,          ACVP_ALG_KAS_ECC,           ACVP_ALG_KAS_ECC_NOCOMP, ACVP_REV_KAS_ECC, {ACVP_SUB_KAS_ECC_NOCOMP}},
-    { ACVP_KAS_ECC_SSC,       &acvp_kas_ecc_ssc_kat_handler,      ACVP_ALG_KAS_ECC_SSC,       ACVP_ALG_KAS_ECC_COMP, ACVP_REV_KAS_ECC_SSC, {ACVP_SUB_KAS_ECC_SSC}},
-    { ACVP_KAS_FFC_COMP,      &acvp_kas_ffc_kat_handler,          ACVP_ALG_KAS_FFC,           ACVP_ALG_KAS_FFC_COMP, ACVP_REV_KAS_FFC, {ACVP_SUB_KAS_FFC_COMP}},
-    { ACVP_KAS_FFC_NOCOMP,    &acvp_kas_ffc_kat_handler,          ACVP_ALG_KAS_FFC,           ACVP_ALG_KAS_FFC_NOCOMP, ACVP_REV_KAS_FFC, {ACVP_SUB_KAS_FFC_NOCOMP}},
-    { ACVP_KAS_FFC_SSC,       &acvp_kas_ffc_ssc_kat_handler,      ACVP_ALG_KAS_FFC_SSC,       ACVP_ALG_KAS_FFC_COMP, ACVP_REV_KAS_FFC_SSC, {ACVP_SUB_KAS_FFC_SSC}},
-    { ACVP_KAS_IFC_SSC,       &acvp_kas_ifc_ssc_kat_handler,      ACVP_ALG_KAS_IFC_SSC,       ACVP_ALG_KAS_IFC_COMP, ACVP_REV_KAS_IFC_SSC, {ACVP_SUB_KAS_IFC_SSC}},
-    { ACVP_KDA_ONESTEP,       &acvp_kda_onestep_kat_handler,      ACVP_ALG_KDA_ALG_STR,       ACVP_ALG_KDA_ONESTEP, ACVP_REV_KDA_ONESTEP, {ACVP_SUB_KDA_ONESTEP}},
-    { ACVP_KDA_TWOSTEP,       &acvp_kda_twostep_kat_handler,      ACVP_ALG_KDA_ALG_STR,       ACVP_ALG_KDA_TWOSTEP, ACVP_REV_KDA_TWOSTEP, {ACVP_SUB_KDA_TWOSTEP}},
-    { ACVP_KDA_HKDF,          &acvp_kda_hkdf_kat_handler,         ACVP_ALG_KDA_ALG_STR,       ACVP_ALG_KDA_HKDF, ACVP_REV_KDA_HKDF, {ACVP_SUB_KDA_HKDF}},
-    { ACVP_KTS_IFC,           &acvp_kts_ifc_kat_handler,          ACVP_ALG_KTS_IFC,           ACVP_ALG_KTS_IFC_COMP, ACVP_REV_KTS_IFC, {ACVP_SUB_KTS_IFC}},
-    { ACVP_SAFE_PRIMES_KEYGEN, &acvp_safe_primes_kat_handler,     ACVP_ALG_SAFE_PRIMES_STR,   ACVP_ALG_SAFE_PRIMES_KEYGEN, ACVP_REV_SAFE_PRIMES, {ACVP_SUB_SAFE_PRIMES_KEYGEN}},
-    { ACVP_SAFE_PRIMES_KEYVER, &acvp_safe_primes_kat_handler,     ACVP_ALG_SAFE_PRIMES_STR,   ACVP_ALG_SAFE_PRIMES_KEYVER, ACVP_REV_SAFE_PRIMES, {ACVP_SUB_SAFE_PRIMES_KEYVER}},
-    { ACVP_LMS_KEYGEN,        &acvp_lms_kat_handler,              ACVP_ALG_LMS,               ACVP_ALG_LMS_KEYGEN, ACVP_REV_LMS, {ACVP_SUB_LMS_KEYGEN}},
-    { ACVP_LMS_SIGGEN,        &acvp_lms_kat_handler,              ACVP_ALG_LMS,               ACVP_ALG_LMS_SIGGEN, ACVP_REV_LMS, {ACVP_SUB_LMS_SIGGEN}},
-    { ACVP_LMS_SIGVER,        &acvp_lms_kat_handler,              ACVP_ALG_LMS,               ACVP_ALG_LMS_SIGVER, ACVP_REV_LMS, {ACVP_SUB_LMS_SIGVER}}
+    { ACVP_AES_GCM,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_GCM,           NULL, ACVP_REV_AES_GCM, {ACVP_SUB_AES_GCM}},
+    { ACVP_AES_GCM_SIV,       ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_GCM_SIV,       NULL, ACVP_REV_AES_GCM_SIV, {ACVP_SUB_AES_GCM_SIV}},
+    { ACVP_AES_CCM,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CCM,           NULL, ACVP_REV_AES_CCM, {ACVP_SUB_AES_CCM}},
+    { ACVP_AES_ECB,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_ECB,           NULL, ACVP_REV_AES_ECB, {ACVP_SUB_AES_ECB}},
+    { ACVP_AES_CBC,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CBC,           NULL, ACVP_REV_AES_CBC, {ACVP_SUB_AES_CBC}},
+    { ACVP_AES_CBC_CS1,       ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CBC_CS1,       NULL, ACVP_REV_AES_CBC_CS1, {ACVP_SUB_AES_CBC_CS1}},
+    { ACVP_AES_CBC_CS2,       ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CBC_CS2,       NULL, ACVP_REV_AES_CBC_CS2, {ACVP_SUB_AES_CBC_CS2}},
+    { ACVP_AES_CBC_CS3,       ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CBC_CS3,       NULL, ACVP_REV_AES_CBC_CS3, {ACVP_SUB_AES_CBC_CS3}},
+    { ACVP_AES_CFB1,          ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CFB1,          NULL, ACVP_REV_AES_CFB1, {ACVP_SUB_AES_CFB1}},
+    { ACVP_AES_CFB8,          ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CFB8,          NULL, ACVP_REV_AES_CFB8, {ACVP_SUB_AES_CFB8}},
+    { ACVP_AES_CFB128,        ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CFB128,        NULL, ACVP_REV_AES_CFB128, {ACVP_SUB_AES_CFB128}},
+    { ACVP_AES_OFB,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_OFB,           NULL, ACVP_REV_AES_OFB, {ACVP_SUB_AES_OFB}},
+    { ACVP_AES_CTR,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_CTR,           NULL, ACVP_REV_AES_CTR, {ACVP_SUB_AES_CTR}},
+    { ACVP_AES_XTS,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_XTS,           NULL, ACVP_REV_AES_XTS, {ACVP_SUB_AES_XTS}},
+    { ACVP_AES_KW,            ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_KW,            NULL, ACVP_REV_AES_KW, {ACVP_SUB_AES_KW}},
+    { ACVP_AES_KWP,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_KWP,           NULL, ACVP_REV_AES_KWP, {ACVP_SUB_AES_KWP}},
+    { ACVP_AES_GMAC,          ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_GMAC,          NULL, ACVP_REV_AES_GMAC, {ACVP_SUB_AES_GMAC}},
+    { ACVP_AES_XPN,           ACVP_AES_KAT(acvp_aes_kat_handler),                 ACVP_ALG_AES_XPN ,          NULL, ACVP_REV_AES_XPN, {ACVP_SUB_AES_XPN}},
+    { ACVP_TDES_ECB,          ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_ECB,          NULL, ACVP_REV_TDES_ECB, {ACVP_SUB_TDES_ECB}},
+    { ACVP_TDES_CBC,          ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CBC,          NULL, ACVP_REV_TDES_CBC, {ACVP_SUB_TDES_CBC}},
+    { ACVP_TDES_CBCI,         ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CBCI,         NULL, ACVP_REV_TDES_CBCI, {ACVP_SUB_TDES_CBCI}},
+    { ACVP_TDES_OFB,          ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_OFB,          NULL, ACVP_REV_TDES_OFB, {ACVP_SUB_TDES_OFB}},
+    { ACVP_TDES_OFBI,         ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_OFBI,         NULL, ACVP_REV_TDES_OFBI, {ACVP_SUB_TDES_OFBI}},
+    { ACVP_TDES_CFB1,         ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CFB1,         NULL, ACVP_REV_TDES_CFB1, {ACVP_SUB_TDES_CFB1}},
+    { ACVP_TDES_CFB8,         ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CFB8,         NULL, ACVP_REV_TDES_CFB8, {ACVP_SUB_TDES_CFB8}},
+    { ACVP_TDES_CFB64,        ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CFB64,        NULL, ACVP_REV_TDES_CFB64, {ACVP_SUB_TDES_CFB64}},
+    { ACVP_TDES_CFBP1,        ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CFBP1,        NULL, ACVP_REV_TDES_CFBP1, {ACVP_SUB_TDES_CFBP1}},
+    { ACVP_TDES_CFBP8,        ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CFBP8,        NULL, ACVP_REV_TDES_CFBP8, {ACVP_SUB_TDES_CFBP8}},
+    { ACVP_TDES_CFBP64,       ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CFBP64,       NULL, ACVP_REV_TDES_CFBP64, {ACVP_SUB_TDES_CFBP64}},
+    { ACVP_TDES_CTR,          ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_CTR,          NULL, ACVP_REV_TDES_CTR, {ACVP_SUB_TDES_CTR}},
+    { ACVP_TDES_KW,           ACVP_TDES_KAT(acvp_des_kat_handler),                ACVP_ALG_TDES_KW,           NULL, ACVP_REV_TDES_KW, {ACVP_SUB_TDES_KW}},
+    { ACVP_HASH_SHA1,         ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA1,              NULL, ACVP_REV_HASH_SHA1, {ACVP_SUB_HASH_SHA1}},
+    { ACVP_HASH_SHA224,       ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA224,            NULL, ACVP_REV_HASH_SHA224, {ACVP_SUB_HASH_SHA2_224}},
+    { ACVP_HASH_SHA256,       ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA256,            NULL, ACVP_REV_HASH_SHA256, {ACVP_SUB_HASH_SHA2_256}},
+    { ACVP_HASH_SHA384,       ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA384,            NULL, ACVP_REV_HASH_SHA384, {ACVP_SUB_HASH_SHA2_384}},
+    { ACVP_HASH_SHA512,       ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA512,            NULL, ACVP_REV_HASH_SHA512, {ACVP_SUB_HASH_SHA2_512}},
+    { ACVP_HASH_SHA512_224,   ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA512_224,        NULL, ACVP_REV_HASH_SHA512_224, {ACVP_SUB_HASH_SHA2_512_224}},
+    { ACVP_HASH_SHA512_256,   ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA512_256,        NULL, ACVP_REV_HASH_SHA512_256, {ACVP_SUB_HASH_SHA2_512_256}},
+    { ACVP_HASH_SHA3_224,     ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA3_224,          NULL, ACVP_REV_HASH_SHA3_224, {ACVP_SUB_HASH_SHA3_224}},
+    { ACVP_HASH_SHA3_256,     ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA3_256,          NULL, ACVP_REV_HASH_SHA3_256, {ACVP_SUB_HASH_SHA3_256}},
+    { ACVP_HASH_SHA3_384,     ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA3_384,          NULL, ACVP_REV_HASH_SHA3_384, {ACVP_SUB_HASH_SHA3_384}},
+    { ACVP_HASH_SHA3_512,     ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHA3_512,          NULL, ACVP_REV_HASH_SHA3_512, {ACVP_SUB_HASH_SHA3_512}},
+    { ACVP_HASH_SHAKE_128,    ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHAKE_128,         NULL, ACVP_REV_HASH_SHAKE_128, {ACVP_SUB_HASH_SHAKE_128}},
+    { ACVP_HASH_SHAKE_256,    ACVP_HASH_KAT(acvp_hash_kat_handler),               ACVP_ALG_SHAKE_256,         NULL, ACVP_REV_HASH_SHAKE_256, {ACVP_SUB_HASH_SHAKE_256}},
+    { ACVP_HASHDRBG,          ACVP_DRBG_KAT(acvp_drbg_kat_handler),               ACVP_ALG_HASHDRBG,          NULL, ACVP_REV_HASHDRBG, {ACVP_SUB_DRBG_HASH}},
+    { ACVP_HMACDRBG,          ACVP_DRBG_KAT(acvp_drbg_kat_handler),               ACVP_ALG_HMACDRBG,          NULL, ACVP_REV_HMACDRBG, {ACVP_SUB_DRBG_HMAC}},
+    { ACVP_CTRDRBG,           ACVP_DRBG_KAT(acvp_drbg_kat_handler),               ACVP_ALG_CTRDRBG,           NULL, ACVP_REV_CTRDRBG, {ACVP_SUB_DRBG_CTR}},
+    { ACVP_HMAC_SHA1,         ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA1,         NULL, ACVP_REV_HMAC_SHA1, {ACVP_SUB_HMAC_SHA1}},
+    { ACVP_HMAC_SHA2_224,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA2_224,     NULL, ACVP_REV_HMAC_SHA2_224, {ACVP_SUB_HMAC_SHA2_224}},
+    { ACVP_HMAC_SHA2_256,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA2_256,     NULL, ACVP_REV_HMAC_SHA2_256, {ACVP_SUB_HMAC_SHA2_256}},
+    { ACVP_HMAC_SHA2_384,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA2_384,     NULL, ACVP_REV_HMAC_SHA2_384, {ACVP_SUB_HMAC_SHA2_384}},
+    { ACVP_HMAC_SHA2_512,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA2_512,     NULL, ACVP_REV_HMAC_SHA2_512, {ACVP_SUB_HMAC_SHA2_512}},
+    { ACVP_HMAC_SHA2_512_224, ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA2_512_224, NULL, ACVP_REV_HMAC_SHA2_512_224, {ACVP_SUB_HMAC_SHA2_512_224}},
+    { ACVP_HMAC_SHA2_512_256, ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA2_512_256, NULL, ACVP_REV_HMAC_SHA2_512_256, {ACVP_SUB_HMAC_SHA2_512_256}},
+    { ACVP_HMAC_SHA3_224,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA3_224,     NULL, ACVP_REV_HMAC_SHA3_224, {ACVP_SUB_HMAC_SHA3_224}},
+    { ACVP_HMAC_SHA3_256,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA3_256,     NULL, ACVP_REV_HMAC_SHA3_256, {ACVP_SUB_HMAC_SHA3_256}},
+    { ACVP_HMAC_SHA3_384,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA3_384,     NULL, ACVP_REV_HMAC_SHA3_384, {ACVP_SUB_HMAC_SHA3_384}},
+    { ACVP_HMAC_SHA3_512,     ACVP_HMAC_KAT(acvp_hmac_kat_handler),               ACVP_ALG_HMAC_SHA3_512,     NULL, ACVP_REV_HMAC_SHA3_512, {ACVP_SUB_HMAC_SHA3_512}},
+    { ACVP_CMAC_AES,          ACVP_CMAC_KAT(acvp_cmac_kat_handler),               ACVP_ALG_CMAC_AES,          NULL, ACVP_REV_CMAC_AES, {ACVP_SUB_CMAC_AES}},
+    { ACVP_CMAC_TDES,         ACVP_CMAC_KAT(acvp_cmac_kat_handler),               ACVP_ALG_CMAC_TDES,         NULL, ACVP_REV_CMAC_TDES, {ACVP_SUB_CMAC_TDES}},
+    { ACVP_KMAC_128,          ACVP_KMAC_KAT(acvp_kmac_kat_handler),               ACVP_ALG_KMAC_128,          NULL, ACVP_REV_KMAC_128, {ACVP_SUB_KMAC_128}},
+    { ACVP_KMAC_256,          ACVP_KMAC_KAT(acvp_kmac_kat_handler),               ACVP_ALG_KMAC_256,          NULL, ACVP_REV_KMAC_256, {ACVP_SUB_KMAC_256}},
+    { ACVP_DSA_KEYGEN,        ACVP_DSA_KAT(acvp_dsa_kat_handler),                 ACVP_ALG_DSA,               ACVP_ALG_DSA_KEYGEN, ACVP_REV_DSA, {ACVP_SUB_DSA_KEYGEN}},
+    { ACVP_DSA_PQGGEN,        ACVP_DSA_KAT(acvp_dsa_kat_handler),                 ACVP_ALG_DSA,               ACVP_ALG_DSA_PQGGEN, ACVP_REV_DSA, {ACVP_SUB_DSA_PQGGEN}},
+    { ACVP_DSA_PQGVER,        ACVP_DSA_KAT(acvp_dsa_kat_handler),                 ACVP_ALG_DSA,               ACVP_ALG_DSA_PQGVER, ACVP_REV_DSA, {ACVP_SUB_DSA_PQGVER}},
+    { ACVP_DSA_SIGGEN,        ACVP_DSA_KAT(acvp_dsa_kat_handler),                 ACVP_ALG_DSA,               ACVP_ALG_DSA_SIGGEN, ACVP_REV_DSA, {ACVP_SUB_DSA_SIGGEN}},
+    { ACVP_DSA_SIGVER,        ACVP_DSA_KAT(acvp_dsa_kat_handler),                 ACVP_ALG_DSA,               ACVP_ALG_DSA_SIGVER, ACVP_REV_DSA, {ACVP_SUB_DSA_SIGVER}},
+    { ACVP_RSA_KEYGEN,        ACVP_RSA_KAT(acvp_rsa_keygen_kat_handler),          ACVP_ALG_RSA,               ACVP_MODE_KEYGEN, ACVP_REV_RSA, {ACVP_SUB_RSA_KEYGEN}},
+    { ACVP_RSA_SIGGEN,        ACVP_RSA_KAT(acvp_rsa_siggen_kat_handler),          ACVP_ALG_RSA,               ACVP_MODE_SIGGEN, ACVP_REV_RSA, {ACVP_SUB_RSA_SIGGEN}},
+    { ACVP_RSA_SIGVER,        ACVP_RSA_KAT(acvp_rsa_sigver_kat_handler),          ACVP_ALG_RSA,               ACVP_MODE_SIGVER, ACVP_REV_RSA, {ACVP_SUB_RSA_SIGVER}},
+    { ACVP_RSA_DECPRIM,       ACVP_RSA_KAT(acvp_rsa_decprim_kat_handler),         ACVP_ALG_RSA,               ACVP_MODE_DECPRIM, ACVP_REV_RSA_DECPRIM, {ACVP_SUB_RSA_DECPRIM}},
+    { ACVP_RSA_SIGPRIM,       ACVP_RSA_KAT(acvp_rsa_sigprim_kat_handler),         ACVP_ALG_RSA,               ACVP_MODE_SIGPRIM, ACVP_REV_RSA_SIGPRIM, {ACVP_SUB_RSA_SIGPRIM}},
+    { ACVP_ECDSA_KEYGEN,      ACVP_ECDSA_KAT(acvp_ecdsa_keygen_kat_handler),      ACVP_ALG_ECDSA,             ACVP_MODE_KEYGEN, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_KEYGEN}},
+    { ACVP_ECDSA_KEYVER,      ACVP_ECDSA_KAT(acvp_ecdsa_keyver_kat_handler),      ACVP_ALG_ECDSA,             ACVP_MODE_KEYVER, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_KEYVER}},
+    { ACVP_ECDSA_SIGGEN,      ACVP_ECDSA_KAT(acvp_ecdsa_siggen_kat_handler),      ACVP_ALG_ECDSA,             ACVP_MODE_SIGGEN, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_SIGGEN}},
+    { ACVP_ECDSA_SIGVER,      ACVP_ECDSA_KAT(acvp_ecdsa_sigver_kat_handler),      ACVP_ALG_ECDSA,             ACVP_MODE_SIGVER, ACVP_REV_ECDSA, {ACVP_SUB_ECDSA_SIGVER}},
+    { ACVP_DET_ECDSA_SIGGEN,  ACVP_ECDSA_KAT(acvp_det_ecdsa_siggen_kat_handler),  ACVP_ALG_DET_ECDSA,         ACVP_MODE_SIGGEN, ACVP_REV_ECDSA, {ACVP_SUB_DET_ECDSA_SIGGEN}},
+    { ACVP_EDDSA_KEYGEN,      ACVP_EDDSA_KAT(acvp_eddsa_keygen_kat_handler),      ACVP_ALG_EDDSA,             ACVP_MODE_KEYGEN, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_KEYGEN}},
+    { ACVP_EDDSA_KEYVER,      ACVP_EDDSA_KAT(acvp_eddsa_keyver_kat_handler),      ACVP_ALG_EDDSA,             ACVP_MODE_KEYVER, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_KEYVER}},
+    { ACVP_EDDSA_SIGGEN,      ACVP_EDDSA_KAT(acvp_eddsa_siggen_kat_handler),      ACVP_ALG_EDDSA,             ACVP_MODE_SIGGEN, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_SIGGEN}},
+    { ACVP_EDDSA_SIGVER,      ACVP_EDDSA_KAT(acvp_eddsa_sigver_kat_handler),      ACVP_ALG_EDDSA,             ACVP_MODE_SIGVER, ACVP_REV_EDDSA, {ACVP_SUB_EDDSA_SIGVER}},
+    { ACVP_KDF135_SNMP,       ACVP_KDF_KAT(acvp_kdf135_snmp_kat_handler),         ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_SNMP, ACVP_REV_KDF135_SNMP, {ACVP_SUB_KDF_SNMP}},
+    { ACVP_KDF135_SSH,        ACVP_KDF_KAT(acvp_kdf135_ssh_kat_handler),          ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_SSH, ACVP_REV_KDF135_SSH, {ACVP_SUB_KDF_SSH}},
+    { ACVP_KDF135_SRTP,       ACVP_KDF_KAT(acvp_kdf135_srtp_kat_handler),         ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_SRTP, ACVP_REV_KDF135_SRTP, {ACVP_SUB_KDF_SRTP}},
+    { ACVP_KDF135_IKEV2,      ACVP_KDF_KAT(acvp_kdf135_ikev2_kat_handler),        ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_IKEV2, ACVP_REV_KDF135_IKEV2, {ACVP_SUB_KDF_IKEV2}},
+    { ACVP_KDF135_IKEV1,      ACVP_KDF_KAT(acvp_kdf135_ikev1_kat_handler),        ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_IKEV1, ACVP_REV_KDF135_IKEV1, {ACVP_SUB_KDF_IKEV1}},
+    { ACVP_KDF135_X942,       ACVP_KDF_KAT(acvp_kdf135_x942_kat_handler),         ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_X942, ACVP_REV_KDF135_X942, {ACVP_SUB_KDF_X942}},
+    { ACVP_KDF135_X963,       ACVP_KDF_KAT(acvp_kdf135_x963_kat_handler),         ACVP_KDF135_ALG_STR,        ACVP_ALG_KDF135_X963, ACVP_REV_KDF135_X963, {ACVP_SUB_KDF_X963}},
+    { ACVP_KDF108,            ACVP_KDF_KAT(acvp_kdf108_kat_handler),              ACVP_ALG_KDF108,            NULL, ACVP_REV_KDF108, {ACVP_SUB_KDF_108}},
+    { ACVP_PBKDF,             ACVP_KDF_KAT(acvp_pbkdf_kat_handler),               ACVP_ALG_PBKDF,             NULL, ACVP_REV_PBKDF, {ACVP_SUB_KDF_PBKDF}},
+    { ACVP_KDF_TLS12,         ACVP_KDF_KAT(acvp_kdf_tls12_kat_handler),           ACVP_ALG_TLS12,             ACVP_ALG_KDF_TLS12, ACVP_REV_KDF_TLS12, {ACVP_SUB_KDF_TLS12}},
+    { ACVP_KDF_TLS13,         ACVP_KDF_KAT(acvp_kdf_tls13_kat_handler),           ACVP_ALG_TLS13,             ACVP_ALG_KDF_TLS13, ACVP_REV_KDF_TLS13, {ACVP_SUB_KDF_TLS13}},
+    { ACVP_KAS_ECC_CDH,       ACVP_KAS_KAT(acvp_kas_ecc_kat_handler),             ACVP_ALG_KAS_ECC,           ACVP_ALG_KAS_ECC_CDH, ACVP_REV_KAS_ECC, {ACVP_SUB_KAS_ECC_CDH}},
+    { ACVP_KAS_ECC_COMP,      ACVP_KAS_KAT(acvp_kas_ecc_kat_handler),             ACVP_ALG_KAS_ECC,           ACVP_ALG_KAS_ECC_COMP, ACVP_REV_KAS_ECC, {ACVP_SUB_KAS_ECC_COMP}},
+    { ACVP_KAS_ECC_NOCOMP,    ACVP_KAS_KAT(acvp_kas_ecc_kat_handler),             ACVP_ALG_KAS_ECC,           ACVP_ALG_KAS_ECC_NOCOMP, ACVP_REV_KAS_ECC, {ACVP_SUB_KAS_ECC_NOCOMP}},
+    { ACVP_KAS_ECC_SSC,       ACVP_KAS_KAT(acvp_kas_ecc_ssc_kat_handler),         ACVP_ALG_KAS_ECC_SSC,       ACVP_ALG_KAS_ECC_COMP, ACVP_REV_KAS_ECC_SSC, {ACVP_SUB_KAS_ECC_SSC}},
+    { ACVP_KAS_FFC_COMP,      ACVP_KAS_KAT(acvp_kas_ffc_kat_handler),             ACVP_ALG_KAS_FFC,           ACVP_ALG_KAS_FFC_COMP, ACVP_REV_KAS_FFC, {ACVP_SUB_KAS_FFC_COMP}},
+    { ACVP_KAS_FFC_NOCOMP,    ACVP_KAS_KAT(acvp_kas_ffc_kat_handler),             ACVP_ALG_KAS_FFC,           ACVP_ALG_KAS_FFC_NOCOMP, ACVP_REV_KAS_FFC, {ACVP_SUB_KAS_FFC_NOCOMP}},
+    { ACVP_KAS_FFC_SSC,       ACVP_KAS_KAT(acvp_kas_ffc_ssc_kat_handler),         ACVP_ALG_KAS_FFC_SSC,       ACVP_ALG_KAS_FFC_COMP, ACVP_REV_KAS_FFC_SSC, {ACVP_SUB_KAS_FFC_SSC}},
+    { ACVP_KAS_IFC_SSC,       ACVP_KAS_KAT(acvp_kas_ifc_ssc_kat_handler),         ACVP_ALG_KAS_IFC_SSC,       ACVP_ALG_KAS_IFC_COMP, ACVP_REV_KAS_IFC_SSC, {ACVP_SUB_KAS_IFC_SSC}},
+    { ACVP_KDA_ONESTEP,       ACVP_KDA_KAT(acvp_kda_onestep_kat_handler),         ACVP_ALG_KDA_ALG_STR,       ACVP_ALG_KDA_ONESTEP, ACVP_REV_KDA_ONESTEP, {ACVP_SUB_KDA_ONESTEP}},
+    { ACVP_KDA_TWOSTEP,       ACVP_KDA_KAT(acvp_kda_twostep_kat_handler),         ACVP_ALG_KDA_ALG_STR,       ACVP_ALG_KDA_TWOSTEP, ACVP_REV_KDA_TWOSTEP, {ACVP_SUB_KDA_TWOSTEP}},
+    { ACVP_KDA_HKDF,          ACVP_KDA_KAT(acvp_kda_hkdf_kat_handler),            ACVP_ALG_KDA_ALG_STR,       ACVP_ALG_KDA_HKDF, ACVP_REV_KDA_HKDF, {ACVP_SUB_KDA_HKDF}},
+    { ACVP_KTS_IFC,           ACVP_KTS_KAT(acvp_kts_ifc_kat_handler),             ACVP_ALG_KTS_IFC,           ACVP_ALG_KTS_IFC_COMP, ACVP_REV_KTS_IFC, {ACVP_SUB_KTS_IFC}},
+    { ACVP_SAFE_PRIMES_KEYGEN, ACVP_SAFE_PRIMES_KAT(acvp_safe_primes_kat_handler), ACVP_ALG_SAFE_PRIMES_STR,   ACVP_ALG_SAFE_PRIMES_KEYGEN, ACVP_REV_SAFE_PRIMES, {ACVP_SUB_SAFE_PRIMES_KEYGEN}},
+    { ACVP_SAFE_PRIMES_KEYVER, ACVP_SAFE_PRIMES_KAT(acvp_safe_primes_kat_handler), ACVP_ALG_SAFE_PRIMES_STR,   ACVP_ALG_SAFE_PRIMES_KEYVER, ACVP_REV_SAFE_PRIMES, {ACVP_SUB_SAFE_PRIMES_KEYVER}},
+    { ACVP_LMS_KEYGEN,        ACVP_LMS_KAT(acvp_lms_kat_handler),                 ACVP_ALG_LMS,               ACVP_ALG_LMS_KEYGEN, ACVP_REV_LMS, {ACVP_SUB_LMS_KEYGEN}},
+    { ACVP_LMS_SIGGEN,        ACVP_LMS_KAT(acvp_lms_kat_handler),                 ACVP_ALG_LMS,               ACVP_ALG_LMS_SIGGEN, ACVP_REV_LMS, {ACVP_SUB_LMS_SIGGEN}},
+    { ACVP_LMS_SIGVER,        ACVP_LMS_KAT(acvp_lms_kat_handler),                 ACVP_ALG_LMS,               ACVP_ALG_LMS_SIGVER, ACVP_REV_LMS, {ACVP_SUB_LMS_SIGVER}}
 };
 
 /*
@@ -201,9 +302,94 @@ ACVP_RESULT acvp_create_test_session(ACVP_CTX **ctx,
         (*ctx)->debug = 1;
     }
 
+    acvp_mutex_init(&(*ctx)->session_lock);
+    acvp_mutex_init(&(*ctx)->dsa_pqg_lock);
+    acvp_mutex_init(&(*ctx)->key_pool_lock);
+    acvp_mutex_init(&(*ctx)->meta_cache_lock);
+    acvp_mutex_init(&(*ctx)->journal_lock);
+    acvp_mem_init(*ctx);
+    acvp_transport_init(*ctx);
+
     return ACVP_SUCCESS;
 }
 
+/*
+ * Creates an exec context for running one operation (e.g. a vector set)
+ * against an existing session concurrently with other operations. It shares
+ * the configuration, capabilities and session details of the session context
+ * but owns its own ACVP_EXEC_CTX and its own copy of the JWT, so it can send
+ * requests and build responses without touching any other context. JWT
+ * refreshes are done by the session under its session_lock.
+ */
+ACVP_CTX *acvp_create_exec_ctx(ACVP_CTX *session) {
+    ACVP_CTX *ctx = NULL;
+
+    if (!session) {
+        return NULL;
+    }
+
+    ctx = calloc(1, sizeof(ACVP_CTX));
+    if (!ctx) {
+        return NULL;
+    }
+    memcpy_s(ctx, sizeof(ACVP_CTX), session, sizeof(ACVP_CTX));
+
+    memzero_s(&ctx->exec, sizeof(ACVP_EXEC_CTX));
+    ctx->exec.huge_pages = session->exec.huge_pages;
+    ctx->tmp_jwt = NULL;
+    ctx->use_tmp_jwt = 0;
+    ctx->max_parallel_vs = 1;
+    ctx->pool = NULL;
+    ctx->step = NULL;
+    ctx->session = session;
+    acvp_mem_init(ctx);
+
+    ctx->jwt_token = NULL;
+    acvp_mutex_lock(&session->session_lock);
+    ctx->caps_snap = session->caps_snap;
+    if (ctx->caps_snap) {
+        ctx->caps_snap->refs++;
+    }
+    if (session->jwt_token) {
+        ctx->jwt_token = calloc(ACVP_JWT_TOKEN_MAX + 1, sizeof(char));
+        if (ctx->jwt_token) {
+            strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, session->jwt_token);
+            ctx->jwt_expiry = session->jwt_expiry;
+        }
+    }
+    acvp_mutex_unlock(&session->session_lock);
+    if (session->jwt_token && !ctx->jwt_token) {
+        acvp_cap_snapshot_drop(ctx);
+        free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+/*
+ * Frees only what an exec context owns; everything else belongs to the session.
+ */
+void acvp_free_exec_ctx(ACVP_CTX *ctx) {
+    if (!ctx || !ctx->session) {
+        return;
+    }
+    acvp_transport_close(ctx);
+    if (ctx->exec.kat_resp) { json_value_free(ctx->exec.kat_resp); }
+    acvp_transport_release_buf(ctx);
+    if (ctx->exec.journal) { json_value_free(ctx->exec.journal); }
+    if (ctx->exec.memo) { json_value_free(ctx->exec.memo); }
+    if (ctx->exec.vs_resp_fp) { fclose(ctx->exec.vs_resp_fp); }
+    acvp_spill_reset(ctx);
+    if (ctx->jwt_token) { free(ctx->jwt_token); }
+    if (ctx->tmp_jwt) { free(ctx->tmp_jwt); }
+    acvp_arena_free(&ctx->exec.tc_arena);
+    acvp_arena_free(&ctx->exec.json_arena);
+    if (ctx->exec.lat_vs) { free(ctx->exec.lat_vs); }
+    acvp_cap_snapshot_drop(ctx);
+    free(ctx);
+}
+
 ACVP_RESULT acvp_set_2fa_callback(ACVP_CTX *ctx, ACVP_RESULT (*totp_cb)(char **token, int token_max)) {
     if (totp_cb == NULL) {
         return ACVP_MISSING_ARG;
@@ -215,811 +401,568 @@ ACVP_RESULT acvp_set_2fa_callback(ACVP_CTX *ctx, ACVP_RESULT (*totp_cb)(char **t
     return ACVP_SUCCESS;
 }
 
-static void acvp_free_prereqs(ACVP_CAPS_LIST *cap_list) {
-    while (cap_list->prereq_vals) {
-        ACVP_PREREQ_LIST *temp_ptr;
-        temp_ptr = cap_list->prereq_vals;
-        cap_list->prereq_vals = cap_list->prereq_vals->next;
-        free(temp_ptr);
-    }
-}
-
 /*
- * Free internal memory for EC curve/hash alg list
+ * Clears what a test session left in ctx, so the context can run another
+ * session with the same capabilities, OE data and server settings without
+ * being created and set up again. The transport handle and the buffers of
+ * the context are kept warm.
  */
-static void acvp_cap_free_ec_alg_list(ACVP_CURVE_ALG_COMPAT_LIST *list) {
-    ACVP_CURVE_ALG_COMPAT_LIST *tmp = NULL, *tmp2 = NULL;
+static void acvp_clear_session(ACVP_CTX *ctx) {
+    ACVP_VS_LIST *vs_entry, *vs_e2;
 
-    if (!list) {
-        return;
+    acvp_step_free(ctx);
+    if (ctx->exec.kat_resp) {
+        json_value_free(ctx->exec.kat_resp);
+        ctx->exec.kat_resp = NULL;
     }
-
-    tmp = list;
-    while (tmp) {
-        tmp2 = tmp;
-        tmp = tmp->next;
-        free(tmp2);
+    ctx->exec.vs_id = 0;
+    if (ctx->vector_req_writer) {
+        acvp_writer_close(ctx->vector_req_writer);
+        ctx->vector_req_writer = NULL;
+    }
+    if (ctx->rsp_writer) {
+        acvp_writer_close(ctx->rsp_writer);
+        ctx->rsp_writer = NULL;
+    }
+    if (ctx->session_file_path) {
+        free(ctx->session_file_path);
+        ctx->session_file_path = NULL;
     }
+    if (ctx->session_url) {
+        free(ctx->session_url);
+        ctx->session_url = NULL;
+    }
+    ctx->session_passed = 0;
+    if (ctx->jwt_token) {
+        free(ctx->jwt_token);
+        ctx->jwt_token = NULL;
+    }
+    ctx->jwt_expiry = 0;
+    if (ctx->tmp_jwt) {
+        free(ctx->tmp_jwt);
+        ctx->tmp_jwt = NULL;
+    }
+    ctx->use_tmp_jwt = 0;
+    vs_entry = ctx->vs_list;
+    while (vs_entry) {
+        vs_e2 = vs_entry->next;
+        free(vs_entry);
+        vs_entry = vs_e2;
+    }
+    ctx->vs_list = NULL;
+    if (ctx->vsid_url_list) {
+        acvp_free_str_list(&ctx->vsid_url_list);
+    }
+    /* Built again from the capabilities when the next session registers */
+    if (ctx->registration) {
+        json_value_free(ctx->registration);
+        ctx->registration = NULL;
+        ctx->caps_gen++;
+    }
+    acvp_lat_clear_session(ctx);
 }
 
-/*
- * Free Internal memory for DSA operations. Since it supports
- * multiple modes, we have to free the whole list
- */
-static void acvp_cap_free_dsa_attrs(ACVP_CAPS_LIST *cap_entry) {
-    ACVP_DSA_ATTRS *attrs = NULL, *next = NULL;
-    ACVP_DSA_CAP_MODE *dsa_cap_mode = NULL;
-    int i;
-
-    for (i = 0; i <= ACVP_DSA_MAX_MODES - 1; i++) {
-        dsa_cap_mode = &cap_entry->cap.dsa_cap->dsa_cap_mode[i];
-        if (dsa_cap_mode->defined) {
-            next = dsa_cap_mode->dsa_attrs;
-            while (next) {
-                attrs = next;
-                next = attrs->next;
-                free(attrs);
-            }
-        }
+ACVP_RESULT acvp_reset_session(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->pool || ctx->session) {
+        ACVP_LOG_ERR("Only the context of the session itself can be reset");
+        return ACVP_INVALID_ARG;
     }
-    dsa_cap_mode = cap_entry->cap.dsa_cap->dsa_cap_mode;
-    free(dsa_cap_mode);
+    acvp_clear_session(ctx);
+    return ACVP_SUCCESS;
 }
 
 /*
- * Free Internal memory for keygen struct. Since it supports
- * multiple modes, we have to free the whole list
+ * The application will invoke this to free the ACVP context
+ * when the test session is finished.
  */
-static void acvp_cap_free_rsa_keygen_list(ACVP_CAPS_LIST *cap_list) {
-    ACVP_RSA_KEYGEN_CAP *keygen_cap = cap_list->cap.rsa_keygen_cap;
-    ACVP_RSA_KEYGEN_CAP *temp_keygen_cap;
-
-    acvp_free_prereqs(cap_list);
+ACVP_RESULT acvp_free_test_session(ACVP_CTX *ctx) {
+    if (!ctx) {
+        ACVP_LOG_STATUS("No ctx to free");
+        return ACVP_SUCCESS;
+    }
 
-    while (keygen_cap) {
-        if (keygen_cap->fixed_pub_exp) {
-            free(keygen_cap->fixed_pub_exp);
-        }
+    acvp_clear_session(ctx);
+    acvp_transport_close(ctx);
+    /* Writes out whatever is still in the async log sink */
+    acvp_log_ring_free(ctx);
+    acvp_transport_release_buf(ctx);
+    acvp_arena_free(&ctx->exec.tc_arena);
+    acvp_arena_free(&ctx->exec.json_arena);
+    if (ctx->server_name) { free(ctx->server_name); }
+    if (ctx->affinity_ids) { free(ctx->affinity_ids); }
+    if (ctx->path_segment) { free(ctx->path_segment); }
+    if (ctx->api_context) { free(ctx->api_context); }
+    if (ctx->cacerts_file) { free(ctx->cacerts_file); }
+    if (ctx->tls_cert) { free(ctx->tls_cert); }
+    if (ctx->tls_key) { free(ctx->tls_key); }
+    if (ctx->json_filename) { free(ctx->json_filename); }
+    if (ctx->vector_req_file) { free(ctx->vector_req_file); }
+    if (ctx->vs_cache_file) { free(ctx->vs_cache_file); }
+    if (ctx->reg_cache_file) { free(ctx->reg_cache_file); }
+    if (ctx->meta_cache_file) { free(ctx->meta_cache_file); }
+    if (ctx->journal_file) { free(ctx->journal_file); }
+    if (ctx->vs_dl_cache_dir) { free(ctx->vs_dl_cache_dir); }
+    acvp_remote_finish(ctx);
+    if (ctx->remote_dir) { free(ctx->remote_dir); }
+    if (ctx->exec.journal) { json_value_free(ctx->exec.journal); }
+    if (ctx->exec.memo) { json_value_free(ctx->exec.memo); }
+    acvp_spill_reset(ctx);
+    if (ctx->vs_filter) { free(ctx->vs_filter); }
+    if (ctx->get_string) { free(ctx->get_string); }
+    if (ctx->delete_string) { free(ctx->delete_string); }
+    if (ctx->save_filename) { free(ctx->save_filename); }
+    if (ctx->post_filename) { free(ctx->post_filename); }
+    if (ctx->put_filename) { free(ctx->put_filename); }
+    if (ctx->jwt_token) { free(ctx->jwt_token); }
+    /* The capabilities and everything they hold, see acvp_cap_calloc() */
+    acvp_cap_snapshot_drop(ctx);
+    if (ctx->reg_str) { json_free_serialized_string(ctx->reg_str); }
+    acvp_arena_free(&ctx->cap_pool);
 
-        ACVP_RSA_MODE_CAPS_LIST *mode_list = keygen_cap->mode_capabilities;
-        ACVP_RSA_MODE_CAPS_LIST *temp_mode_list;
+    /*
+     * Free everything in the Operating Environment structs
+     */
+    acvp_oe_free_operating_env(ctx);
 
-        while (mode_list) {
-            acvp_cap_free_pl(mode_list->hash_algs);
-            acvp_cap_free_pl(mode_list->prime_tests);
+#ifndef ACVP_NO_DSA
+    acvp_dsa_pqg_free(ctx);
+#endif
+    acvp_mutex_destroy(&ctx->dsa_pqg_lock);
+    acvp_key_pool_free(ctx);
+    acvp_lat_free(ctx);
+    acvp_xfer_free(ctx);
+    acvp_hedge_free(ctx);
+    acvp_memo_free(ctx);
+    acvp_mutex_destroy(&ctx->key_pool_lock);
+    acvp_mutex_destroy(&ctx->meta_cache_lock);
+    acvp_mutex_destroy(&ctx->journal_lock);
+    acvp_mutex_destroy(&ctx->session_lock);
+    acvp_mem_free(ctx);
 
-            temp_mode_list = mode_list;
-            mode_list = mode_list->next;
-            free(temp_mode_list);
-            temp_mode_list = NULL;
-        }
+    /* Free the ACVP_CTX struct */
+    free(ctx);
 
-        temp_keygen_cap = keygen_cap;
-        keygen_cap = keygen_cap->next;
-        free(temp_keygen_cap);
-        temp_keygen_cap = NULL;
-    }
+    return ACVP_SUCCESS;
 }
 
-/*
- * Free Internal memory for keygen struct. Since it supports
- * multiple modes, we have to free the whole list
- */
-static void acvp_cap_free_rsa_sig_list(ACVP_CAPS_LIST *cap_list) {
-    ACVP_RSA_SIG_CAP *sig_cap = NULL, *temp_sig_cap = NULL;
-
-    if (cap_list->cipher == ACVP_RSA_SIGGEN) {
-        sig_cap = cap_list->cap.rsa_siggen_cap;
-    } else if (cap_list->cipher == ACVP_RSA_SIGVER) {
-        sig_cap = cap_list->cap.rsa_sigver_cap;
-    } else {
+static void acvp_list_failing_algorithms(ACVP_CTX *ctx, ACVP_STRING_LIST **list, ACVP_STRING_LIST **modes) {
+    if (!list || *list == NULL) {
         return;
     }
-
-    acvp_free_prereqs(cap_list);
-
-    while (sig_cap) {
-        ACVP_RSA_MODE_CAPS_LIST *mode_list = sig_cap->mode_capabilities;
-        ACVP_RSA_MODE_CAPS_LIST *temp_mode_list;
-
-        if (sig_cap->fixed_pub_exp) {
-            free(sig_cap->fixed_pub_exp);
-        }
-        while (mode_list) {
-            acvp_cap_free_hash_pairs(mode_list->hash_pair);
-            acvp_cap_free_pl(mode_list->mask_functions);
-            temp_mode_list = mode_list;
-            mode_list = mode_list->next;
-            free(temp_mode_list);
-            temp_mode_list = NULL;
+    ACVP_STRING_LIST *iterator = *list;
+    ACVP_STRING_LIST *mode_iterator = *modes;
+    if (!iterator || !iterator->string || !mode_iterator || !mode_iterator->string) {
+        return;
+    }
+    ACVP_LOG_STATUS("Failing algorithms:");
+    while (iterator && iterator->string && mode_iterator && mode_iterator->string) {
+        if (strnlen_s(mode_iterator->string, ACVP_ALG_MODE_MAX) < 1) {
+            ACVP_LOG_STATUS("    %s", iterator->string);
+        } else {
+            ACVP_LOG_STATUS("    %s, Mode: %s", iterator->string, mode_iterator->string);
         }
-
-        temp_sig_cap = sig_cap;
-        sig_cap = sig_cap->next;
-        free(temp_sig_cap);
-        temp_sig_cap = NULL;
+        iterator = iterator->next;
+        mode_iterator = mode_iterator->next;
     }
 }
 
-/*
- * Free Internal memory for KAS-ECC Data struct
- */
-static void acvp_cap_free_kas_ecc_mode(ACVP_CAPS_LIST *cap_list) {
-    ACVP_KAS_ECC_CAP *kas_ecc_cap = cap_list->cap.kas_ecc_cap;
-    ACVP_KAS_ECC_CAP_MODE *mode;
-    int i;
-
-    if (kas_ecc_cap) {
-        ACVP_PREREQ_LIST *current_pre_req_vals;
-        ACVP_PREREQ_LIST *next_pre_req_vals;
-        ACVP_KAS_ECC_PSET *current_pset;
-        ACVP_KAS_ECC_PSET *next_pset;
-        ACVP_KAS_ECC_SCHEME *current_scheme;
-        ACVP_KAS_ECC_SCHEME *next_scheme;
-
-        if (kas_ecc_cap->kas_ecc_mode) {
-            for (i = 0; i < ACVP_KAS_ECC_MAX_MODES; i++) {
-                mode = &kas_ecc_cap->kas_ecc_mode[i];
-                current_pre_req_vals = mode->prereq_vals;
-                /*
-                 * Delete all pre_req
-                 */
-                if (current_pre_req_vals) {
-                    do {
-                        next_pre_req_vals = current_pre_req_vals->next;
-                        free(current_pre_req_vals);
-                        current_pre_req_vals = next_pre_req_vals;
-                    } while (current_pre_req_vals);
-                }
-                /*
-                 * Delete all function name lists
-                 */
-                acvp_cap_free_pl(mode->function);
-
-                /*
-                 * Delete all curve name lists
-                 */
-                acvp_cap_free_pl(mode->curve);
+static int acvp_vs_filter_has(ACVP_CTX *ctx, int vs_id) {
+    int i = 0;
 
-                /*
-                 * Delete all schemes, psets and their param lists
-                 */
-                current_scheme = mode->scheme;
-                if (current_scheme) {
-                    do {
-                        acvp_cap_free_pl(current_scheme->role);
-                        current_pset = current_scheme->pset;
-                        if (current_pset) {
-                            do {
-                                acvp_cap_free_pl(current_pset->sha);
-                                next_pset = current_pset->next;
-                                free(current_pset);
-                                current_pset = next_pset;
-                            } while (current_pset);
-                        }
-                        next_scheme = current_scheme->next;
-                        free(current_scheme);
-                        current_scheme = next_scheme;
-                    } while (current_scheme);
-                }
-            }
+    for (i = 0; i < ctx->vs_filter_cnt; i++) {
+        if (ctx->vs_filter[i] == vs_id) {
+            return 1;
         }
     }
-    free(cap_list->cap.kas_ecc_cap->kas_ecc_mode);
-    free(cap_list->cap.kas_ecc_cap);
+    return 0;
 }
 
 /*
- * Free Internal memory for KAS-FFC Data struct
+ * Picks the vector sets of a request file that the filter and shard of ctx
+ * leave to this run. sel is set to their positions among the first vs_cnt
+ * vector sets and sel_cnt to how many there are, and the URLs of the session
+ * identifiers are cut down to theirs, so that the response file is complete
+ * by itself. sel is left NULL when every vector set is to be run.
  */
-static void acvp_cap_free_kas_ffc_mode(ACVP_CAPS_LIST *cap_list) {
-    ACVP_KAS_FFC_CAP *kas_ffc_cap = cap_list->cap.kas_ffc_cap;
-    ACVP_KAS_FFC_CAP_MODE *mode;
-    int i;
+static ACVP_RESULT acvp_select_vector_sets(ACVP_CTX *ctx, JSON_Array *reg_array, int vs_cnt,
+                                           int **sel, int *sel_cnt) {
+    JSON_Object *ids = json_array_get_object(reg_array, 0);
+    JSON_Array *urls = json_object_get_array(ids, "vectorSetUrls");
+    JSON_Value *kept_val = NULL;
+    JSON_Array *kept = NULL;
+    int i = 0, j = 0, keep = 0, vs_id = 0;
+
+    *sel = NULL;
+    *sel_cnt = vs_cnt;
+    if (!ctx->vs_filter_cnt && !ctx->vs_shard_cnt) {
+        return ACVP_SUCCESS;
+    }
 
-    if (kas_ffc_cap) {
-        ACVP_PREREQ_LIST *current_pre_req_vals;
-        ACVP_PREREQ_LIST *next_pre_req_vals;
-        ACVP_KAS_FFC_PSET *current_pset;
-        ACVP_KAS_FFC_PSET *next_pset;
-        ACVP_KAS_FFC_SCHEME *current_scheme;
-        ACVP_KAS_FFC_SCHEME *next_scheme;
-
-        if (kas_ffc_cap->kas_ffc_mode) {
-            for (i = 0; i < ACVP_KAS_FFC_MAX_MODES; i++) {
-                mode = &kas_ffc_cap->kas_ffc_mode[i];
-                current_pre_req_vals = mode->prereq_vals;
-                /*
-                 * Delete all pre_req
-                 */
-                if (current_pre_req_vals) {
-                    do {
-                        next_pre_req_vals = current_pre_req_vals->next;
-                        free(current_pre_req_vals);
-                        current_pre_req_vals = next_pre_req_vals;
-                    } while (current_pre_req_vals);
-                }
-                /*
-                 * Delete all generation methods
-                 */
-                acvp_cap_free_pl(mode->genmeth);
+    *sel = calloc(vs_cnt, sizeof(int));
+    kept_val = json_value_init_array();
+    kept = json_value_get_array(kept_val);
+    if (!*sel || !kept) {
+        if (kept_val) json_value_free(kept_val);
+        return ACVP_MALLOC_FAIL;
+    }
 
-                /*
-                 * Delete all function name lists
-                 */
-                acvp_cap_free_pl(mode->function);
+    *sel_cnt = 0;
+    for (i = 0; i < vs_cnt; i++) {
+        keep = !ctx->vs_shard_cnt || i % ctx->vs_shard_cnt == ctx->vs_shard - 1;
+        if (keep && ctx->vs_filter_cnt) {
+            vs_id = json_object_get_number(json_array_get_object(reg_array, i + 1), "vsId");
+            keep = acvp_vs_filter_has(ctx, vs_id);
+        }
+        if (!keep) {
+            continue;
+        }
+        (*sel)[(*sel_cnt)++] = i;
+        json_array_append_string(kept, json_array_get_string(urls, i));
+    }
 
-                /*
-                 * Delete all schemes, psets and their param lists
-                 */
-                current_scheme = mode->scheme;
-                if (current_scheme) {
-                    do {
-                        acvp_cap_free_pl(current_scheme->role);
-                        current_pset = current_scheme->pset;
-                        if (current_pset) {
-                            do {
-                                acvp_cap_free_pl(current_pset->sha);
-                                next_pset = current_pset->next;
-                                free(current_pset);
-                                current_pset = next_pset;
-                            } while (current_pset);
-                        }
-                        next_scheme = current_scheme->next;
-                        free(current_scheme);
-                        current_scheme = next_scheme;
-                    } while (current_scheme);
-                }
+    for (i = 0; i < ctx->vs_filter_cnt; i++) {
+        for (j = 0; j < vs_cnt; j++) {
+            vs_id = json_object_get_number(json_array_get_object(reg_array, j + 1), "vsId");
+            if (vs_id == ctx->vs_filter[i]) {
+                break;
             }
         }
+        if (j == vs_cnt) {
+            ACVP_LOG_WARN("Vector set %d is not in the request file", ctx->vs_filter[i]);
+        }
+    }
+
+    if (json_object_set_value(ids, "vectorSetUrls", kept_val) != JSONSuccess) {
+        json_value_free(kept_val);
+        return ACVP_JSON_ERR;
     }
-    free(cap_list->cap.kas_ffc_cap->kas_ffc_mode);
-    free(cap_list->cap.kas_ffc_cap);
+    ACVP_LOG_STATUS("Running %d of the %d vector sets in the request file", *sel_cnt, vs_cnt);
+    return ACVP_SUCCESS;
 }
 
 /*
- * Free Internal memory for DRBG Data struct
+ * Has the capability loader, see acvp_set_cap_loader(), enable what the
+ * selected vector sets of the request file need that is not enabled yet.
+ * This is done before any of them are run, and the capabilities are then
+ * snapshot, as exec contexts do not see capabilities added after they are
+ * made.
  */
-static void acvp_free_drbg_struct(ACVP_CAPS_LIST *cap_list) {
-    ACVP_DRBG_CAP *drbg_cap = cap_list->cap.drbg_cap;
-
-    if (drbg_cap) {
-        ACVP_DRBG_MODE_LIST *mode_list = drbg_cap->drbg_cap_mode;
-        ACVP_DRBG_MODE_LIST *next_mode_list;
-        ACVP_DRBG_GROUP_LIST *group_list;
-        ACVP_DRBG_GROUP_LIST *next_group_list;
-        ACVP_PREREQ_LIST *current_pre_req_vals;
-        ACVP_PREREQ_LIST *next_pre_req_vals;
-
-        current_pre_req_vals = drbg_cap->prereq_vals;
-        while (current_pre_req_vals) {
-            next_pre_req_vals = current_pre_req_vals->next;
-            free(current_pre_req_vals);
-            current_pre_req_vals = next_pre_req_vals;
+static ACVP_RESULT acvp_load_vs_caps(ACVP_CTX *ctx, JSON_Array *reg_array, const int *sel, int sel_cnt) {
+    const ACVP_ALG_HANDLER *entry = NULL;
+    JSON_Object *vs_obj = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    for (i = 0; ctx->cap_loader && i < sel_cnt; i++) {
+        vs_obj = json_array_get_object(reg_array, (sel ? sel[i] : i) + 1);
+        entry = acvp_lookup_alg_handler(json_object_get_string(vs_obj, "algorithm"),
+                                        json_object_get_string(vs_obj, "mode"));
+        /* Unknown algorithms are reported when the vector set is run */
+        if (!entry || acvp_locate_cap_entry(ctx, entry->cipher)) {
+            continue;
         }
-
-        while (mode_list) {
-            group_list = mode_list->groups;
-            while (group_list) {
-                next_group_list = group_list->next;
-                if (group_list->group) {
-                    free(group_list->group);
-                }
-                free(group_list);
-                group_list = next_group_list;
-            }
-            next_mode_list = mode_list->next;
-            free(mode_list);
-            mode_list = next_mode_list;
+        rv = (ctx->cap_loader)(ctx, entry->cipher, ctx->cap_loader_arg);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Unable to load the capabilities for vector set %d (%s)",
+                         (int)json_object_get_uint(vs_obj, "vsId"), acvp_lookup_error_string(rv));
+            return rv;
         }
-        free(drbg_cap);
-        drbg_cap = NULL;
-        cap_list->cap.drbg_cap = NULL;
     }
+    return acvp_cap_snapshot_take(ctx);
 }
 
 /*
- * Free Internal memory for KDF108 Cap struct
+ * Takes the session identifiers at the start of a request file: the session
+ * URL, JWT and the URLs of the vector sets, whose number vs_cnt is set to.
+ * It is left 0 if any of them are missing, as the results of the vector sets
+ * could not be POSTed to the server then, and nothing is run.
  */
-static void acvp_cap_free_kdf108(ACVP_KDF108_CAP *cap) {
-    ACVP_KDF108_MODE_PARAMS *mode_obj = NULL;
-
-    if (cap) {
-        if (cap->counter_mode.kdf_mode) {
-            mode_obj = &cap->counter_mode;
-            if (mode_obj->mac_mode) {
-                acvp_cap_free_nl(mode_obj->mac_mode);
-            }
-            if (mode_obj->data_order) {
-                acvp_cap_free_nl(mode_obj->data_order);
-            }
-            if (mode_obj->counter_lens) {
-                acvp_cap_free_sl(mode_obj->counter_lens);
-            }
-            acvp_cap_free_domain(&mode_obj->supported_lens);
-        }
+static ACVP_RESULT acvp_load_offline_ids(ACVP_CTX *ctx, JSON_Object *obj, int *vs_cnt) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Array *vect_sets = NULL;
+    const char *test_session_url = NULL;
+    const char *jwt = NULL;
+    int i = 0, cnt = 0, isSample = 0;
 
-        if (cap->feedback_mode.kdf_mode) {
-            mode_obj = &cap->feedback_mode;
-            if (mode_obj->mac_mode) {
-                acvp_cap_free_nl(mode_obj->mac_mode);
-            }
-            if (mode_obj->data_order) {
-                acvp_cap_free_nl(mode_obj->data_order);
-            }
-            if (mode_obj->counter_lens) {
-                acvp_cap_free_sl(mode_obj->counter_lens);
-            }
-            acvp_cap_free_domain(&mode_obj->supported_lens);
-        }
+    *vs_cnt = 0;
 
-        if (cap->dpi_mode.kdf_mode) {
-            mode_obj = &cap->dpi_mode;
-            if (mode_obj->mac_mode) {
-                acvp_cap_free_nl(mode_obj->mac_mode);
-            }
-            if (mode_obj->data_order) {
-                acvp_cap_free_nl(mode_obj->data_order);
-            }
-            if (mode_obj->counter_lens) {
-                acvp_cap_free_sl(mode_obj->counter_lens);
-            }
-            acvp_cap_free_domain(&mode_obj->supported_lens);
-        }
+    /*
+     * This is the identifiers provided by the server
+     * for this specific test session!
+     */
+    test_session_url = json_object_get_string(obj, "url");
+    if (test_session_url) {
+        ctx->session_url = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
+        strcpy_s(ctx->session_url, ACVP_ATTR_URL_MAX + 1, test_session_url);
+    } else {
+        ACVP_LOG_WARN("Missing session URL, results will not be POSTed to server");
+        return ACVP_SUCCESS;
+    }
 
-        if (cap->kmac_mode.kdf_mode) {
-            mode_obj = &cap->kmac_mode;
-            if (mode_obj->mac_mode) {
-                acvp_cap_free_nl(mode_obj->mac_mode);
-            }
-            acvp_cap_free_domain(&mode_obj->derivation_keylens);
-            acvp_cap_free_domain(&mode_obj->derived_keylens);
-            acvp_cap_free_domain(&mode_obj->context_lens);
-            acvp_cap_free_domain(&mode_obj->label_lens);
-        }
+    jwt = json_object_get_string(obj, "jwt");
+    if (jwt) {
+        ctx->jwt_token = calloc(ACVP_JWT_TOKEN_MAX + 1, sizeof(char));
+        strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, jwt);
+        ctx->jwt_expiry = acvp_jwt_expiry(ctx->jwt_token);
+    } else {
+        ACVP_LOG_WARN("Missing JWT, results will not be POSTed to server");
+        return ACVP_SUCCESS;
+    }
 
-        cap = NULL;
+    isSample = json_object_get_boolean(obj, "isSample");
+    if (json_object_has_value(obj, "isSample")) {
+        ctx->is_sample = isSample;
+    } else {
+        ACVP_LOG_WARN("Missing indication of whether tests are sample in file, continuing");
     }
-}
 
-static void acvp_cap_free_kts_ifc_schemes(ACVP_CAPS_LIST *cap_entry) {
-    ACVP_KTS_IFC_SCHEMES *current_scheme;
+    vect_sets = json_object_get_array(obj, "vectorSetUrls");
+    cnt = json_array_get_count(vect_sets);
+    for (i = 0; i < cnt; i++) {
+        const char *vsid_url = json_array_get_string(vect_sets, i);
 
+        if (!vsid_url) {
+            ACVP_LOG_WARN("No vsId URL, results will not be POSTed to server");
+            return ACVP_SUCCESS;
+        }
 
-    current_scheme = cap_entry->cap.kts_ifc_cap->schemes;
-    while (current_scheme) {
-        acvp_cap_free_pl(current_scheme->roles);
-        acvp_cap_free_pl(current_scheme->hash);
-        free(current_scheme->assoc_data_pattern);
-        free(current_scheme->encodings);
-        current_scheme = current_scheme->next;
+        rv = acvp_append_vsid_url(ctx, vsid_url);
+        if (rv != ACVP_SUCCESS) return rv;
+        ACVP_LOG_INFO("Received vsid_url=%s", vsid_url);
     }
-    free(cap_entry->cap.kts_ifc_cap->schemes);
+    *vs_cnt = cnt;
+    return ACVP_SUCCESS;
 }
 
-static void acvp_cap_free_lms(ACVP_LMS_CAP *cap) {
-    ACVP_LMS_SPECIFIC_LIST *prev = NULL, *curr = cap->specific_list;
+/*
+ * Whether the filter and shard of ctx leave the vector set at position i of
+ * a streamed request file to this run. Its vsId is taken from its URL, as
+ * the URLs are written out before the vector sets are read.
+ */
+static int acvp_stream_keep_vs(ACVP_CTX *ctx, int i, const char *url) {
+    const char *id = NULL;
 
-    acvp_cap_free_pl(cap->lms_modes);
-    acvp_cap_free_pl(cap->lmots_modes);
-    while (curr) {
-        prev = curr;
-        curr = curr->next;
-        free(prev);
+    if (ctx->vs_shard_cnt && i % ctx->vs_shard_cnt != ctx->vs_shard - 1) {
+        return 0;
+    }
+    if (!ctx->vs_filter_cnt) {
+        return 1;
     }
-    free(cap);
+    id = strrchr(url, '/');
+    return id && acvp_vs_filter_has(ctx, atoi(id + 1));
 }
+
 /*
- * The application will invoke this to free the ACVP context
- * when the test session is finished.
+ * Starts the response file of an offline run with the '[' and the session
+ * identifiers, on a writer the responses of the vector sets are then queued
+ * on as they are done, see acvp_pool_save_response().
  */
-ACVP_RESULT acvp_free_test_session(ACVP_CTX *ctx) {
-    ACVP_VS_LIST *vs_entry, *vs_e2;
-    ACVP_CAPS_LIST *cap_entry, *cap_e2;
-
-    if (!ctx) {
-        ACVP_LOG_STATUS("No ctx to free");
-        return ACVP_SUCCESS;
-    }
+static ACVP_RESULT acvp_rsp_file_begin(ACVP_CTX *ctx, const char *rsp_filename, const JSON_Value *ids_val) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
 
-    if (ctx->kat_resp) { json_value_free(ctx->kat_resp); }
-    if (ctx->curl_buf) { free(ctx->curl_buf); }
-    if (ctx->server_name) { free(ctx->server_name); }
-    if (ctx->path_segment) { free(ctx->path_segment); }
-    if (ctx->api_context) { free(ctx->api_context); }
-    if (ctx->cacerts_file) { free(ctx->cacerts_file); }
-    if (ctx->tls_cert) { free(ctx->tls_cert); }
-    if (ctx->tls_key) { free(ctx->tls_key); }
-    if (ctx->http_user_agent) { free(ctx->http_user_agent); }
-    if (ctx->session_file_path) { free(ctx->session_file_path); }
-    if (ctx->json_filename) { free(ctx->json_filename); }
-    if (ctx->session_url) { free(ctx->session_url); }
-    if (ctx->vector_req_file) { free(ctx->vector_req_file); }
-    if (ctx->get_string) { free(ctx->get_string); }
-    if (ctx->delete_string) { free(ctx->delete_string); }
-    if (ctx->save_filename) { free(ctx->save_filename); }
-    if (ctx->post_filename) { free(ctx->post_filename); }
-    if (ctx->put_filename) { free(ctx->put_filename); }
-    if (ctx->jwt_token) { free(ctx->jwt_token); }
-    if (ctx->tmp_jwt) { free(ctx->tmp_jwt); }
-    if (ctx->vs_list) {
-        vs_entry = ctx->vs_list;
-        while (vs_entry) {
-            vs_e2 = vs_entry->next;
-            free(vs_entry);
-            vs_entry = vs_e2;
-        }
-    }
-    if (ctx->vsid_url_list) {
-        acvp_free_str_list(&ctx->vsid_url_list);
-    }
-    if (ctx->registration) {
-            json_value_free(ctx->registration);
-    }
-    if (ctx->caps_list) {
-        cap_entry = ctx->caps_list;
-        while (cap_entry) {
-            cap_e2 = cap_entry->next;
-            if (cap_entry->prereq_vals) {
-                acvp_free_prereqs(cap_entry);
-            }
-            switch (cap_entry->cap_type) {
-            case ACVP_SYM_TYPE:
-                acvp_cap_free_sl(cap_entry->cap.sym_cap->keylen);
-                acvp_cap_free_sl(cap_entry->cap.sym_cap->ptlen);
-                acvp_cap_free_sl(cap_entry->cap.sym_cap->ivlen);
-                acvp_cap_free_sl(cap_entry->cap.sym_cap->aadlen);
-                acvp_cap_free_sl(cap_entry->cap.sym_cap->taglen);
-                acvp_cap_free_sl(cap_entry->cap.sym_cap->tweak);
-                free(cap_entry->cap.sym_cap);
-                break;
-            case ACVP_HASH_TYPE:
-                acvp_cap_free_sl(cap_entry->cap.hash_cap->large_lens);
-                free(cap_entry->cap.hash_cap);
-                break;
-            case ACVP_DRBG_TYPE:
-                acvp_free_drbg_struct(cap_entry);
-                break;
-            case ACVP_HMAC_TYPE:
-                acvp_cap_free_domain(&cap_entry->cap.hmac_cap->key_len);
-                acvp_cap_free_domain(&cap_entry->cap.hmac_cap->mac_len);
-                free(cap_entry->cap.hmac_cap);
-                break;
-            case ACVP_CMAC_TYPE:
-                acvp_cap_free_sl(cap_entry->cap.cmac_cap->key_len);
-                acvp_cap_free_sl(cap_entry->cap.cmac_cap->keying_option);
-                acvp_cap_free_domain(&cap_entry->cap.cmac_cap->msg_len);
-                acvp_cap_free_domain(&cap_entry->cap.cmac_cap->mac_len);
-                free(cap_entry->cap.cmac_cap);
-                break;
-            case ACVP_KMAC_TYPE:
-                acvp_cap_free_domain(&cap_entry->cap.kmac_cap->key_len);
-                acvp_cap_free_domain(&cap_entry->cap.kmac_cap->msg_len);
-                acvp_cap_free_domain(&cap_entry->cap.kmac_cap->mac_len);
-                free(cap_entry->cap.kmac_cap);
-                break;
-            case ACVP_DSA_TYPE:
-                acvp_cap_free_dsa_attrs(cap_entry);
-                free(cap_entry->cap.dsa_cap);
-                break;
-            case ACVP_KAS_ECC_CDH_TYPE:
-            case ACVP_KAS_ECC_COMP_TYPE:
-            case ACVP_KAS_ECC_NOCOMP_TYPE:
-            case ACVP_KAS_ECC_SSC_TYPE:
-                acvp_cap_free_kas_ecc_mode(cap_entry);
-                break;
-            case ACVP_KAS_FFC_SSC_TYPE:
-            case ACVP_KAS_FFC_COMP_TYPE:
-            case ACVP_KAS_FFC_NOCOMP_TYPE:
-                acvp_cap_free_kas_ffc_mode(cap_entry);
-                break;
-            case ACVP_KAS_IFC_TYPE:
-                acvp_cap_free_pl(cap_entry->cap.kas_ifc_cap->kas1_roles);
-                acvp_cap_free_pl(cap_entry->cap.kas_ifc_cap->kas2_roles);
-                acvp_cap_free_pl(cap_entry->cap.kas_ifc_cap->keygen_method);
-                acvp_cap_free_sl(cap_entry->cap.kas_ifc_cap->modulo);
-                free(cap_entry->cap.kas_ifc_cap->fixed_pub_exp);
-                free(cap_entry->cap.kas_ifc_cap);
-                break;
-            case ACVP_KDA_ONESTEP_TYPE:
-                if (cap_entry->cap.kda_onestep_cap->literal_pattern_candidate) {
-                    free(cap_entry->cap.kda_onestep_cap->literal_pattern_candidate);
-                }
-                acvp_cap_free_pl(cap_entry->cap.kda_onestep_cap->patterns);
-                acvp_cap_free_pl(cap_entry->cap.kda_onestep_cap->encodings);
-                acvp_cap_free_nl(cap_entry->cap.kda_onestep_cap->aux_functions);
-                acvp_cap_free_nl(cap_entry->cap.kda_onestep_cap->mac_salt_methods);
-                free(cap_entry->cap.kda_onestep_cap);
-                break;
-            case ACVP_KDA_TWOSTEP_TYPE:
-                if (cap_entry->cap.kda_twostep_cap->literal_pattern_candidate) {
-                    free(cap_entry->cap.kda_twostep_cap->literal_pattern_candidate);
-                }
-                acvp_cap_free_nl(cap_entry->cap.kda_twostep_cap->mac_salt_methods);
-                acvp_cap_free_pl(cap_entry->cap.kda_twostep_cap->patterns);
-                acvp_cap_free_pl(cap_entry->cap.kda_twostep_cap->encodings);
-                acvp_cap_free_domain(&cap_entry->cap.kda_twostep_cap->aux_secret_len);
-                acvp_cap_free_kdf108(&cap_entry->cap.kda_twostep_cap->kdf_params);
-                free(cap_entry->cap.kda_twostep_cap);
-                break;
-            case ACVP_KDA_HKDF_TYPE:
-                if (cap_entry->cap.kda_hkdf_cap->literal_pattern_candidate) {
-                    free(cap_entry->cap.kda_hkdf_cap->literal_pattern_candidate);
-                }
-                acvp_cap_free_pl(cap_entry->cap.kda_hkdf_cap->patterns);
-                acvp_cap_free_pl(cap_entry->cap.kda_hkdf_cap->encodings);
-                acvp_cap_free_nl(cap_entry->cap.kda_hkdf_cap->hmac_algs);
-                acvp_cap_free_nl(cap_entry->cap.kda_hkdf_cap->mac_salt_methods);
-                acvp_cap_free_domain(&cap_entry->cap.kda_hkdf_cap->aux_secret_len);
-                free(cap_entry->cap.kda_hkdf_cap);
-                break;
-            case ACVP_KTS_IFC_TYPE:
-                acvp_cap_free_pl(cap_entry->cap.kts_ifc_cap->keygen_method);
-                acvp_cap_free_pl(cap_entry->cap.kts_ifc_cap->functions);
-                acvp_cap_free_sl(cap_entry->cap.kts_ifc_cap->modulo);
-                free(cap_entry->cap.kts_ifc_cap->fixed_pub_exp);
-                free(cap_entry->cap.kts_ifc_cap->iut_id);
-                acvp_cap_free_kts_ifc_schemes(cap_entry);
-                free(cap_entry->cap.kts_ifc_cap);
-                break;
-            case ACVP_RSA_KEYGEN_TYPE:
-                acvp_cap_free_rsa_keygen_list(cap_entry);
-                break;
-            case ACVP_RSA_SIGGEN_TYPE:
-                acvp_cap_free_rsa_sig_list(cap_entry);
-                break;
-            case ACVP_RSA_SIGVER_TYPE:
-                acvp_cap_free_rsa_sig_list(cap_entry);
-                break;
-            case ACVP_RSA_PRIM_TYPE:
-                if (cap_entry->cap.rsa_prim_cap->fixed_pub_exp) {
-                    free(cap_entry->cap.rsa_prim_cap->fixed_pub_exp);
-                }
-                acvp_cap_free_sl(cap_entry->cap.rsa_prim_cap->modulo);
-                acvp_cap_free_pl(cap_entry->cap.rsa_prim_cap->key_formats);
-                free(cap_entry->cap.rsa_prim_cap);
-                break;
-            case ACVP_ECDSA_KEYGEN_TYPE:
-                acvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_keygen_cap->curves);
-                acvp_cap_free_nl(cap_entry->cap.ecdsa_keygen_cap->secret_gen_modes);
-                free(cap_entry->cap.ecdsa_keygen_cap);
-                break;
-            case ACVP_ECDSA_KEYVER_TYPE:
-                acvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_keyver_cap->curves);
-                acvp_cap_free_nl(cap_entry->cap.ecdsa_keyver_cap->secret_gen_modes);
-                free(cap_entry->cap.ecdsa_keyver_cap);
-                break;
-            case ACVP_ECDSA_SIGGEN_TYPE:
-                acvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_siggen_cap->curves);
-                free(cap_entry->cap.ecdsa_siggen_cap);
-                break;
-            case ACVP_ECDSA_SIGVER_TYPE:
-                acvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_sigver_cap->curves);
-                free(cap_entry->cap.ecdsa_sigver_cap);
-                break;
-            case ACVP_DET_ECDSA_SIGGEN_TYPE:
-                acvp_cap_free_ec_alg_list(cap_entry->cap.det_ecdsa_siggen_cap->curves);
-                free(cap_entry->cap.det_ecdsa_siggen_cap);
-                break;
-            case ACVP_EDDSA_KEYGEN_TYPE:
-                acvp_cap_free_pl(cap_entry->cap.eddsa_keygen_cap->curves);
-                free(cap_entry->cap.eddsa_keygen_cap);
-                break;
-            case ACVP_EDDSA_KEYVER_TYPE:
-                acvp_cap_free_pl(cap_entry->cap.eddsa_keyver_cap->curves);
-                free(cap_entry->cap.eddsa_keyver_cap);
-                break;
-            case ACVP_EDDSA_SIGGEN_TYPE:
-                acvp_cap_free_pl(cap_entry->cap.eddsa_siggen_cap->curves);
-                free(cap_entry->cap.eddsa_siggen_cap);
-                break;
-            case ACVP_EDDSA_SIGVER_TYPE:
-                acvp_cap_free_pl(cap_entry->cap.eddsa_sigver_cap->curves);
-                free(cap_entry->cap.eddsa_sigver_cap);
-                break;
-            case ACVP_KDF135_SRTP_TYPE:
-                acvp_cap_free_sl(cap_entry->cap.kdf135_srtp_cap->aes_keylens);
-                free(cap_entry->cap.kdf135_srtp_cap);
-                break;
-            case ACVP_KDF108_TYPE:
-                acvp_cap_free_kdf108(cap_entry->cap.kdf108_cap);
-                free(cap_entry->cap.kdf108_cap);
-                break;
-            case ACVP_KDF135_SNMP_TYPE:
-                acvp_cap_free_sl(cap_entry->cap.kdf135_snmp_cap->pass_lens);
-                acvp_cap_free_nl(cap_entry->cap.kdf135_snmp_cap->eng_ids);
-                free(cap_entry->cap.kdf135_snmp_cap);
-                break;
-            case ACVP_KDF135_SSH_TYPE:
-                free(cap_entry->cap.kdf135_ssh_cap);
-                break;
-            case ACVP_KDF135_IKEV2_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.kdf135_ikev2_cap->hash_algs);
-                acvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->init_nonce_len_domain);
-                acvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->respond_nonce_len_domain);
-                acvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->dh_secret_len);
-                acvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->key_material_len);
-                free(cap_entry->cap.kdf135_ikev2_cap);
-                break;
-            case ACVP_KDF135_IKEV1_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.kdf135_ikev1_cap->hash_algs);
-                free(cap_entry->cap.kdf135_ikev1_cap);
-                break;
-            case ACVP_KDF135_X942_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.kdf135_x942_cap->hash_algs);
-                acvp_cap_free_nl(cap_entry->cap.kdf135_x942_cap->oids);
-                free(cap_entry->cap.kdf135_x942_cap);
-                break;
-            case ACVP_KDF135_X963_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.kdf135_x963_cap->hash_algs);
-                acvp_cap_free_sl(cap_entry->cap.kdf135_x963_cap->shared_info_lengths);
-                acvp_cap_free_sl(cap_entry->cap.kdf135_x963_cap->field_sizes);
-                acvp_cap_free_sl(cap_entry->cap.kdf135_x963_cap->key_data_lengths);
-                free(cap_entry->cap.kdf135_x963_cap);
-                break;
-            case ACVP_PBKDF_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.pbkdf_cap->hmac_algs);
-                free(cap_entry->cap.pbkdf_cap);
-                break;
-            case ACVP_KDF_TLS13_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.kdf_tls13_cap->hmac_algs);
-                acvp_cap_free_pl(cap_entry->cap.kdf_tls13_cap->running_mode);
-                free(cap_entry->cap.kdf_tls13_cap);
-                break;
-            case ACVP_KDF_TLS12_TYPE:
-                acvp_cap_free_nl(cap_entry->cap.kdf_tls12_cap->hash_algs);
-                free(cap_entry->cap.kdf_tls12_cap);
-                break;
-            case ACVP_SAFE_PRIMES_KEYGEN_TYPE:
-                if (cap_entry->cap.safe_primes_keygen_cap->mode->genmeth) {
-                    acvp_cap_free_pl(cap_entry->cap.safe_primes_keygen_cap->mode->genmeth);
-                }
-                free(cap_entry->cap.safe_primes_keygen_cap->mode);
-                free(cap_entry->cap.safe_primes_keygen_cap);
-                break;
-            case ACVP_SAFE_PRIMES_KEYVER_TYPE:
-                if (cap_entry->cap.safe_primes_keyver_cap->mode->genmeth) {
-                    acvp_cap_free_pl(cap_entry->cap.safe_primes_keyver_cap->mode->genmeth);
-                }
-                free(cap_entry->cap.safe_primes_keyver_cap->mode);
-                free(cap_entry->cap.safe_primes_keyver_cap);
-                break;
-            case ACVP_LMS_KEYGEN_TYPE:
-                acvp_cap_free_lms(cap_entry->cap.lms_keygen_cap);
-                break;
-            case ACVP_LMS_SIGGEN_TYPE:
-                acvp_cap_free_lms(cap_entry->cap.lms_siggen_cap);
-                break;
-            case ACVP_LMS_SIGVER_TYPE:
-                acvp_cap_free_lms(cap_entry->cap.lms_sigver_cap);
-                break;
-            case ACVP_KDF135_TPM_TYPE:
-            default:
-                return ACVP_INVALID_ARG;
-            }
-            free(cap_entry);
-            cap_entry = cap_e2;
-        }
+    rv = acvp_writer_open(&ctx->rsp_writer, rsp_filename, "w");
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Unable to open response file %s", rsp_filename);
+        return rv;
     }
-
-    /*
-     * Free everything in the Operating Environment structs
-     */
-    acvp_oe_free_operating_env(ctx);
-
-    /* Free the ACVP_CTX struct */
-    free(ctx);
-
-    return ACVP_SUCCESS;
+    return acvp_writer_json(ctx->rsp_writer, "[ ", ids_val, ctx->vector_rsp_compact);
 }
 
 /*
- * Simple utility function to free a supported length
- * list from the capabilities structure.
+ * Ends the response file with the closing ']' if the run, whose result is
+ * rv, went well, and waits for it to be written out and synced.
  */
-static void acvp_cap_free_sl(ACVP_SL_LIST *list) {
-    ACVP_SL_LIST *top = list;
-    ACVP_SL_LIST *tmp;
+static ACVP_RESULT acvp_rsp_file_end(ACVP_CTX *ctx, ACVP_RESULT rv) {
+    ACVP_RESULT close_rv = ACVP_SUCCESS;
 
-    while (top) {
-        tmp = top;
-        top = top->next;
-        free(tmp);
+    if (!ctx->rsp_writer) {
+        return rv;
+    }
+    if (rv == ACVP_SUCCESS) {
+        rv = acvp_writer_puts(ctx->rsp_writer, " ]");
     }
+    close_rv = acvp_writer_close(ctx->rsp_writer);
+    ctx->rsp_writer = NULL;
+    if (rv == ACVP_SUCCESS && close_rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("File write error");
+        rv = close_rv;
+    }
+    return rv;
 }
 
 /*
- * Simple utility function to free a supported param
- * list from the capabilities structure.
+ * Runs the vector sets at the cnt positions of sel in reg_array, and then
+ * drops them, leaving nulls in their place
  */
-static void acvp_cap_free_pl(ACVP_PARAM_LIST *list) {
-    ACVP_PARAM_LIST *top = list;
-    ACVP_PARAM_LIST *tmp;
+static ACVP_RESULT acvp_run_stream_batch(ACVP_CTX *ctx, JSON_Array *reg_array, int *sel, int cnt,
+                                         const char *rsp_filename) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
 
-    while (top) {
-        tmp = top;
-        top = top->next;
-        free(tmp);
+    rv = acvp_load_vs_caps(ctx, reg_array, sel, cnt);
+    if (rv == ACVP_SUCCESS) {
+        rv = acvp_run_vector_sets(ctx, cnt, reg_array, sel, rsp_filename);
     }
+    for (i = 0; i < cnt; i++) {
+        json_array_replace_value(reg_array, sel[i] + 1, json_value_init_null());
+    }
+    return rv;
 }
 
 /*
- * Simple utility function to free a name
- * list from the capabilities structure.
+ * acvp_run_vectors_from_file() with a request file of "-": the vector sets
+ * are read from fp as they come, and run as soon as there are enough of them
+ * for the workers, so that no more than max_parallel_vs of them are held at
+ * once, however long the stream. The response file is written as they are
+ * done, as it is for a request file.
  */
-static void acvp_cap_free_nl(ACVP_NAME_LIST *list) {
-    ACVP_NAME_LIST *top = list;
-    ACVP_NAME_LIST *tmp;
+static ACVP_RESULT acvp_run_vectors_from_stream(ACVP_CTX *ctx, FILE *fp, const char *rsp_filename) {
+    ACVP_JSON_STREAM stream;
+    ACVP_JSON_SLICE slice;
+    ACVP_STRING_LIST *vs_entry = NULL;
+    JSON_Value *reg_val = NULL, *ids_val = NULL, *vs_val = NULL, *kept_val = NULL;
+    JSON_Array *reg_array = NULL, *kept = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int *sel = NULL;
+    int url_cnt = 0, batch = 0, sel_cnt = 0, kept_cnt = 0, i = 0, rc = 0;
 
-    while (top) {
-        tmp = top;
-        top = top->next;
-        free(tmp);
+    if (ctx->vs_cache_file) {
+        ACVP_LOG_WARN("The vector set cache is not used for a request file read from stdin");
     }
-}
-
-static void acvp_cap_free_domain(ACVP_JSON_DOMAIN_OBJ *domain) {
-    if (!domain) {
-        return;
+    acvp_json_stream_init(&stream, fp);
+    if (acvp_json_stream_next(&stream, &slice) != 1) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        rv = ACVP_MALFORMED_JSON;
+        goto end;
+    }
+    ids_val = acvp_json_stream_parse(&stream, &slice);
+    if (!json_value_get_object(ids_val)) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        rv = ACVP_MALFORMED_JSON;
+        goto end;
+    }
+    rv = acvp_load_offline_ids(ctx, json_value_get_object(ids_val), &url_cnt);
+    if (rv != ACVP_SUCCESS || !url_cnt) {
+        goto end;
     }
-    acvp_cap_free_sl(domain->values);
-    return;
-}
-
-static void acvp_cap_free_hash_pairs(ACVP_RSA_HASH_PAIR_LIST *list) {
-    ACVP_RSA_HASH_PAIR_LIST *top = list;
-    ACVP_RSA_HASH_PAIR_LIST *tmp;
-
-    while (top) {
-        tmp = top;
 
-        top = top->next;
-        free(tmp);
+    /* The identifiers go out first, with the URLs of the vector sets this run keeps */
+    if (ctx->vs_filter_cnt || ctx->vs_shard_cnt) {
+        kept_val = json_value_init_array();
+        kept = json_value_get_array(kept_val);
+        if (!kept) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+        for (i = 0, vs_entry = ctx->vsid_url_list; vs_entry; i++, vs_entry = vs_entry->next) {
+            if (acvp_stream_keep_vs(ctx, i, vs_entry->string)) {
+                json_array_append_string(kept, vs_entry->string);
+                kept_cnt++;
+            }
+        }
+        if (json_object_set_value(json_value_get_object(ids_val), "vectorSetUrls", kept_val) != JSONSuccess) {
+            json_value_free(kept_val);
+            rv = ACVP_JSON_ERR;
+            goto end;
+        }
+        ACVP_LOG_STATUS("Running %d of the %d vector sets in the request stream", kept_cnt, url_cnt);
+    }
+    rv = acvp_rsp_file_begin(ctx, rsp_filename, ids_val);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("File write error");
+        goto end;
     }
-}
 
-static void acvp_list_failing_algorithms(ACVP_CTX *ctx, ACVP_STRING_LIST **list, ACVP_STRING_LIST **modes) {
-    if (!list || *list == NULL) {
-        return;
+    /*
+     * The vector sets keep their positions in reg_array, as the pool finds
+     * their URLs by them; the identifiers, written already, and the vector
+     * sets done or not kept are nulls.
+     */
+    batch = ctx->max_parallel_vs > 1 ? ctx->max_parallel_vs : 1;
+    reg_val = json_value_init_array();
+    reg_array = json_value_get_array(reg_val);
+    sel = calloc(batch, sizeof(int));
+    if (!reg_array || !sel || json_array_append_null(reg_array) != JSONSuccess) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
     }
-    ACVP_STRING_LIST *iterator = *list;
-    ACVP_STRING_LIST *mode_iterator = *modes;
-    if (!iterator || !iterator->string || !mode_iterator || !mode_iterator->string) {
-        return;
+    vs_entry = ctx->vsid_url_list;
+    for (i = 0; vs_entry; i++, vs_entry = vs_entry->next) {
+        rc = acvp_json_stream_next(&stream, &slice);
+        if (rc <= 0) {
+            break;
+        }
+        vs_val = NULL;
+        if (acvp_stream_keep_vs(ctx, i, vs_entry->string)) {
+            vs_val = acvp_json_stream_parse(&stream, &slice);
+            if (!vs_val) {
+                ACVP_LOG_ERR("JSON parse error in vector set %d of the request stream", i + 1);
+                rv = ACVP_MALFORMED_JSON;
+                goto end;
+            }
+        }
+        if (json_array_append_value(reg_array, vs_val ? vs_val : json_value_init_null()) != JSONSuccess) {
+            if (vs_val) json_value_free(vs_val);
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+        if (!vs_val) {
+            continue;
+        }
+        sel[sel_cnt++] = i;
+        if (sel_cnt == batch) {
+            rv = acvp_run_stream_batch(ctx, reg_array, sel, sel_cnt, rsp_filename);
+            sel_cnt = 0;
+            if (rv != ACVP_SUCCESS) {
+                goto end;
+            }
+        }
     }
-    ACVP_LOG_STATUS("Failing algorithms:");
-    while (iterator && iterator->string && mode_iterator && mode_iterator->string) {
-        if (strnlen_s(mode_iterator->string, ACVP_ALG_MODE_MAX) < 1) {
-            ACVP_LOG_STATUS("    %s", iterator->string);
-        } else {
-            ACVP_LOG_STATUS("    %s, Mode: %s", iterator->string, mode_iterator->string);
+    if (sel_cnt) {
+        rv = acvp_run_stream_batch(ctx, reg_array, sel, sel_cnt, rsp_filename);
+        if (rv != ACVP_SUCCESS) {
+            goto end;
         }
-        iterator = iterator->next;
-        mode_iterator = mode_iterator->next;
     }
+    if (rc < 0) {
+        ACVP_LOG_ERR("Request stream ended before its JSON array did");
+        rv = ACVP_MALFORMED_JSON;
+        goto end;
+    }
+    if (vs_entry) {
+        ACVP_LOG_WARN("Request stream has %d of its %d vector sets", i, url_cnt);
+    }
+
+    ACVP_LOG_STATUS("Completed processing of vector sets. Responses saved in specified file.");
+end:
+    /* The final ']' makes the JSON work */
+    rv = acvp_rsp_file_end(ctx, rv);
+    if (sel) free(sel);
+    if (reg_val) json_value_free(reg_val);
+    if (ids_val) json_value_free(ids_val);
+    acvp_json_stream_free(&stream);
+    return rv;
 }
 
 /*
  * Allows application to load JSON vector file(req_filename) within context
  * to be read in and used for vector testing. The results are
- * then saved in a response file(rsp_filename).
+ * then saved in a response file(rsp_filename). A req_filename of "-" has
+ * the vector sets read from stdin, and a rsp_filename of "-" has the
+ * responses written to stdout, each as it is done.
  */
 ACVP_RESULT acvp_run_vectors_from_file(ACVP_CTX *ctx, const char *req_filename, const char *rsp_filename) {
     JSON_Object *obj = NULL;
     JSON_Value *val = NULL;
     JSON_Array *reg_array;
-    JSON_Value *file_val = NULL;
-    JSON_Value *kat_val = NULL;
-    JSON_Array *kat_array;
-    JSON_Value *rsp_val = NULL;
     ACVP_RESULT rv = ACVP_SUCCESS;
-    int n, i;
+    int n;
     ACVP_STRING_LIST *vs_entry;
-    JSON_Array *vect_sets = NULL;
-    const char *test_session_url = NULL;
-    int vs_cnt = 0, isSample = 0;
-    const char *jwt = NULL;
-    char *json_result = NULL;
+    int vs_cnt = 0, sel_cnt = 0;
+    int *sel = NULL;
 
     ACVP_LOG_STATUS("Beginning offline processing of vector sets...");
 
@@ -1036,7 +979,15 @@ ACVP_RESULT acvp_run_vectors_from_file(ACVP_CTX *ctx, const char *req_filename,
         return ACVP_INVALID_ARG;
     }
 
-    val = json_parse_file(req_filename);
+    if (ACVP_IS_STDIO(req_filename)) {
+        return acvp_run_vectors_from_stream(ctx, stdin, rsp_filename);
+    }
+
+    if (ctx->vs_cache_file) {
+        val = acvp_vs_cache_load(ctx, req_filename, ctx->vs_cache_file);
+    } else {
+        val = acvp_json_parse_file(req_filename);
+    }
 
     n = 0;
     reg_array = json_value_get_array(val);
@@ -1046,50 +997,11 @@ ACVP_RESULT acvp_run_vectors_from_file(ACVP_CTX *ctx, const char *req_filename,
         goto end;
     }
 
-    /*
-     * This is the identifiers provided by the server
-     * for this specific test session!
-     */
-    test_session_url = json_object_get_string(obj, "url");
-    if (test_session_url) {
-        ctx->session_url = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
-        strcpy_s(ctx->session_url, ACVP_ATTR_URL_MAX + 1, test_session_url);
-    } else {
-        ACVP_LOG_WARN("Missing session URL, results will not be POSTed to server");
-        goto end;
-    }
-
-    jwt = json_object_get_string(obj, "jwt");
-    if (jwt) {
-        ctx->jwt_token = calloc(ACVP_JWT_TOKEN_MAX + 1, sizeof(char));
-        strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, jwt);
-    } else {
-        ACVP_LOG_WARN("Missing JWT, results will not be POSTed to server");
+    rv = acvp_load_offline_ids(ctx, obj, &vs_cnt);
+    if (rv != ACVP_SUCCESS || !vs_cnt) {
         goto end;
     }
 
-    isSample = json_object_get_boolean(obj, "isSample");
-    if (json_object_has_value(obj, "isSample")) {
-        ctx->is_sample = isSample;
-    } else {
-        ACVP_LOG_WARN("Missing indication of whether tests are sample in file, continuing");
-    }
-
-    vect_sets = json_object_get_array(obj, "vectorSetUrls");
-    vs_cnt = json_array_get_count(vect_sets);
-    for (i = 0; i < vs_cnt; i++) {
-        const char *vsid_url = json_array_get_string(vect_sets, i);
-
-        if (!vsid_url) {
-            ACVP_LOG_WARN("No vsId URL, results will not be POSTed to server");
-            goto end;
-        }
-
-        rv = acvp_append_vsid_url(ctx, vsid_url);
-        if (rv != ACVP_SUCCESS) goto end;
-        ACVP_LOG_INFO("Received vsid_url=%s", vsid_url);
-    }
-
     n++;        /* bump past the version or url, jwt, url sets */
     obj = json_array_get_object(reg_array, n);
     if (!obj) {
@@ -1097,93 +1009,280 @@ ACVP_RESULT acvp_run_vectors_from_file(ACVP_CTX *ctx, const char *req_filename,
         goto end;
     }
 
+    /* One vector set per URL, for as long as the file has them */
+    vs_cnt = 0;
     vs_entry = ctx->vsid_url_list;
-    if (!vs_entry) {
+    while (vs_entry && json_array_get_object(reg_array, vs_cnt + 1)) {
+        vs_entry = vs_entry->next;
+        vs_cnt++;
+    }
+    if (!vs_cnt) {
         goto end;
     }
 
-    while (obj) {
-        if (!vs_entry) {
-            goto end;
-        }
-        /* Process the kat vector(s) */
-        rv  = acvp_dispatch_vector_set(ctx, obj);
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("KAT dispatch error");
-            goto end;
-        }
-        ACVP_LOG_STATUS("Writing vector set responses for vector set %d...", ctx->vs_id);
+    rv = acvp_select_vector_sets(ctx, reg_array, vs_cnt, &sel, &sel_cnt);
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
+    if (!sel_cnt) {
+        /* Still write the identifiers, so the file can be merged with the others */
+        rv = acvp_rsp_file_begin(ctx, rsp_filename, json_array_get_value(reg_array, 0));
+        goto end;
+    }
 
-        /* 
-         * Convert the JSON from a fully qualified to a value that can be 
-         * added to the file. Kind of klumsy, but it works.
-         */
-        kat_array = json_value_get_array(ctx->kat_resp);
-        kat_val = json_array_get_value(kat_array, 1);
-        if (!kat_val) {
-            ACVP_LOG_ERR("JSON val parse error");
-            goto end;
-        }
-        json_result = json_serialize_to_string_pretty(kat_val, NULL);
-        file_val = json_parse_string(json_result);
-        json_free_serialized_string(json_result);
+    rv = acvp_load_vs_caps(ctx, reg_array, sel, sel_cnt);
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
 
-        /* track first vector set with file count */
-        if (n == 1) {
+    rv = acvp_rsp_file_begin(ctx, rsp_filename, json_array_get_value(reg_array, 0));
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
+    /*
+     * The vector sets are processed by the worker pool, in parallel when
+     * max_parallel_vs allows it; responses are written in file order.
+     */
+    rv = acvp_run_vector_sets(ctx, sel_cnt, reg_array, sel, rsp_filename);
+    if (rv == ACVP_SUCCESS) {
+        ACVP_LOG_STATUS("Completed processing of vector sets. Responses saved in specified file.");
+    }
+end:
+    /* The final ']' makes the JSON work */
+    rv = acvp_rsp_file_end(ctx, rv);
+    if (sel) free(sel);
+    json_value_free(val);
+    return rv;
+}
 
-            rsp_val = json_array_get_value(reg_array, 0);
-            /* start the file with the '[' and identifiers array */
-            rv = acvp_json_serialize_to_file_pretty_w(rsp_val, rsp_filename);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("File write error");
-                json_value_free(file_val);
-                goto end;
+/*
+ * A vector set of a response file being uploaded, see
+ * acvp_upload_vectors_from_file()
+ */
+typedef struct acvp_upload_job_t {
+    char *url;                  /* Vector set URL */
+    const ACVP_JSON_SLICE *vs;  /* Its responses, as they are in the file */
+    int vs_id;
+    ACVP_RESULT rv;
+} ACVP_UPLOAD_JOB;
+
+typedef struct acvp_upload_pool_t {
+    ACVP_MUTEX lock;            /* Guards next */
+    ACVP_UPLOAD_JOB *jobs;
+    int count;
+    int next;                   /* Next job to hand out */
+} ACVP_UPLOAD_POOL;
+
+#define ACVP_UPLOAD_PREFIX "[{\"acvVersion\":\"" ACVP_PROTOCOL_VERSION "\"},"
+
+/*
+ * Works through the jobs of the upload pool until none are left. Each body
+ * is the text of the vector set in the file, after the protocol version.
+ */
+static void acvp_upload_worker(ACVP_CTX *ctx, ACVP_UPLOAD_POOL *pool) {
+    ACVP_UPLOAD_JOB *job = NULL;
+    size_t prefix_len = sizeof(ACVP_UPLOAD_PREFIX) - 1, len = 0;
+    char *body = NULL;
+    int i = 0;
+
+    while (1) {
+        acvp_mutex_lock(&pool->lock);
+        i = pool->next++;
+        acvp_mutex_unlock(&pool->lock);
+        if (i >= pool->count) {
+            break;
+        }
+        job = &pool->jobs[i];
+        ctx->exec.vs_id = job->vs_id;
+
+        len = prefix_len + job->vs->len + 1;
+        if (len >= INT_MAX) {
+            ACVP_LOG_ERR("Responses for vector set %d are too large to upload", job->vs_id);
+            job->rv = ACVP_INVALID_ARG;
+            continue;
+        }
+        body = malloc(len + 1);
+        if (!body) {
+            job->rv = ACVP_MALLOC_FAIL;
+            continue;
+        }
+        memcpy_s(body, len + 1, ACVP_UPLOAD_PREFIX, prefix_len);
+        memcpy_s(body + prefix_len, len + 1 - prefix_len, job->vs->p, job->vs->len);
+        body[len - 1] = ']';
+        body[len] = '\0';
+
+        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
+            printf("\n\n%s\n\n", body);
+        } else {
+            ACVP_LOG_INFO("\n\n%s\n\n", body);
+        }
+        ACVP_LOG_STATUS("Sending responses for vector set %d", job->vs_id);
+        ctx->exec.vs_resp_str = body;
+        ctx->exec.vs_resp_len = (int)len;
+        job->rv = acvp_submit_vector_responses(ctx, job->url);
+        ctx->exec.vs_resp_str = NULL;
+        if (job->rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Failed to submit test results for vector set - skipping...");
+        }
+        free(body);
+    }
+}
+
+typedef struct acvp_upload_thread_t {
+    ACVP_CTX *ctx;
+    ACVP_UPLOAD_POOL *pool;
+} ACVP_UPLOAD_THREAD;
+
+static void acvp_upload_thread(void *arg) {
+    ACVP_UPLOAD_THREAD *t = arg;
+
+    acvp_upload_worker(t->ctx, t->pool);
+}
+
+/*
+ * Uploads the responses of count jobs, with up to max_parallel_vs of them in
+ * flight at once, each on its own exec context, or one at a time on this
+ * thread if no workers can be started. The outcome of each is left in its
+ * job.
+ */
+static void acvp_upload_vector_sets(ACVP_CTX *ctx, ACVP_UPLOAD_JOB *jobs, int count) {
+    ACVP_UPLOAD_POOL pool;
+    ACVP_UPLOAD_THREAD *workers = NULL;
+    ACVP_THREAD *threads = NULL;
+    int worker_cnt = 0, started = 0, i = 0;
+
+    memzero_s(&pool, sizeof(ACVP_UPLOAD_POOL));
+    pool.jobs = jobs;
+    pool.count = count;
+    acvp_mutex_init(&pool.lock);
+
+    worker_cnt = ctx->max_parallel_vs < count ? ctx->max_parallel_vs : count;
+    if (worker_cnt > 1) {
+        workers = calloc(worker_cnt, sizeof(ACVP_UPLOAD_THREAD));
+        threads = calloc(worker_cnt, sizeof(ACVP_THREAD));
+    }
+    if (workers && threads) {
+        for (i = 0; i < worker_cnt; i++) {
+            workers[i].pool = &pool;
+            workers[i].ctx = acvp_create_exec_ctx(ctx);
+            if (!workers[i].ctx) {
+                break;
             }
-        } 
-        /* append vector sets */
-        rv = acvp_json_serialize_to_file_pretty_a(file_val, rsp_filename);
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("File write error");
-            json_value_free(file_val);
-            goto end;
+            if (acvp_thread_create(&threads[i], acvp_upload_thread, &workers[i]) != ACVP_SUCCESS) {
+                acvp_free_exec_ctx(workers[i].ctx);
+                break;
+            }
+            started++;
         }
+    }
+
+    /* As for fetches, the session context only uploads when there are no workers */
+    if (!started) {
+        acvp_upload_worker(ctx, &pool);
+    }
+
+    for (i = 0; i < started; i++) {
+        acvp_thread_join(threads[i]);
+        acvp_free_exec_ctx(workers[i].ctx);
+    }
+    if (workers) free(workers);
+    if (threads) free(threads);
+    acvp_mutex_destroy(&pool.lock);
+}
 
-        json_value_free(file_val);
-        n++;
-        obj = json_array_get_object(reg_array, n);
+/*
+ * Uploads the vector sets of a response file read from stream, after its
+ * identifiers, in batches of max_parallel_vs as they are read
+ */
+static ACVP_RESULT acvp_upload_vector_stream(ACVP_CTX *ctx, ACVP_JSON_STREAM *stream, int vs_cnt) {
+    ACVP_STRING_LIST *vs_entry = ctx->vsid_url_list;
+    ACVP_UPLOAD_JOB *jobs = NULL;
+    ACVP_JSON_SLICE *copies = NULL, slice;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    char *text = NULL, **texts = NULL;
+    int batch = 0, cnt = 0, done = 0, rc = 0, i = 0;
+
+    batch = ctx->max_parallel_vs > 1 ? ctx->max_parallel_vs : 1;
+    jobs = calloc(batch, sizeof(ACVP_UPLOAD_JOB));
+    copies = calloc(batch, sizeof(ACVP_JSON_SLICE));
+    /* The slices only read their copies, which are freed through texts */
+    texts = calloc(batch, sizeof(char *));
+    if (!jobs || !copies || !texts) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    while (vs_entry) {
+        rc = acvp_json_stream_next(stream, &slice);
+        if (rc <= 0) {
+            break;
+        }
+        /* The stream buffer moves on with the next one */
+        text = malloc(slice.len);
+        if (!text) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+        memcpy_s(text, slice.len, slice.p, slice.len);
+        texts[cnt] = text;
+        copies[cnt].p = text;
+        copies[cnt].len = slice.len;
+        jobs[cnt].url = vs_entry->string;
+        jobs[cnt].vs = &copies[cnt];
+        jobs[cnt].vs_id = (int)acvp_json_slice_get_number(&copies[cnt], "vsId");
+        cnt++;
+        done++;
         vs_entry = vs_entry->next;
+        if (cnt == batch) {
+            acvp_upload_vector_sets(ctx, jobs, cnt);
+            for (i = 0; i < cnt; i++) {
+                free(texts[i]);
+            }
+            cnt = 0;
+        }
+    }
+    if (cnt) {
+        acvp_upload_vector_sets(ctx, jobs, cnt);
+    }
+    if (rc < 0) {
+        ACVP_LOG_ERR("Response stream ended before its JSON array did");
+        rv = ACVP_MALFORMED_JSON;
+    } else if (vs_entry) {
+        ACVP_LOG_WARN("Response file has responses for %d of its %d vector sets", done, vs_cnt);
     }
-    /* append the final ']' to make the JSON work */ 
-    rv = acvp_json_serialize_to_file_pretty_a(NULL, rsp_filename);
-    ACVP_LOG_STATUS("Completed processing of vector sets. Responses saved in specified file.");
 end:
-    json_value_free(val);
+    for (i = 0; texts && i < cnt; i++) {
+        free(texts[i]);
+    }
+    if (jobs) free(jobs);
+    if (copies) free(copies);
+    if (texts) free(texts);
     return rv;
 }
 
 /*
  * Allows application to read JSON vector responses from a file(rsp_filename)
- * and upload them to the server for verification.
+ * and upload them to the server for verification. The file is not parsed as
+ * a whole: it is scanned for its vector sets, and each is uploaded as the
+ * text it has in the file, several at a time when
+ * acvp_set_max_parallel_vector_sets() allows it. A rsp_filename of "-" is
+ * read from stdin, see acvp_upload_vector_stream().
  */
 ACVP_RESULT acvp_upload_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filename, int fips_validation) {
     JSON_Object *obj = NULL;
-    JSON_Object *rsp_obj = NULL;
-    JSON_Object *ver_obj = NULL;
-    JSON_Value *vs_val = NULL;
-    JSON_Value *new_val = NULL;
-    JSON_Value *ver_val = NULL;
     JSON_Value *val = NULL;
     ACVP_RESULT rv = ACVP_SUCCESS;
-    JSON_Array *reg_array;
-    int n, i;
+    int i;
     ACVP_STRING_LIST *vs_entry;
     JSON_Array *vect_sets = NULL;
     const char *test_session_url = NULL;
-    int vs_cnt = 0, isSample = 0;
+    int vs_cnt = 0, isSample = 0, slice_cnt = 0, job_cnt = 0;
     const char *jwt = NULL;
-    char *json_result = NULL;
-    JSON_Array *vec_array = NULL;
-    JSON_Value *vec_array_val = NULL;
+    char *buf = NULL, *ids = NULL;
+    size_t len = 0, map_len = 0;
+    ACVP_JSON_SLICE *slices = NULL;
+    ACVP_UPLOAD_JOB *jobs = NULL;
+    ACVP_JSON_STREAM stream;
+    ACVP_JSON_SLICE ids_slice;
 
     ACVP_LOG_STATUS("Uploading vectors from response file...");
 
@@ -1200,13 +1299,37 @@ ACVP_RESULT acvp_upload_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filenam
         return ACVP_INVALID_ARG;
     }
 
-    val = json_parse_file(rsp_filename);
-    if (!val) {
-        ACVP_LOG_ERR("JSON val parse error");
-        return ACVP_MALFORMED_JSON;
+    acvp_json_stream_init(&stream, stdin);
+    if (ACVP_IS_STDIO(rsp_filename)) {
+        /* Read from stdin a vector set at a time as they are uploaded */
+        if (acvp_json_stream_next(&stream, &ids_slice) != 1) {
+            ACVP_LOG_ERR("JSON val parse error");
+            rv = ACVP_MALFORMED_JSON;
+            goto end;
+        }
+        val = acvp_json_stream_parse(&stream, &ids_slice);
+    } else {
+        /* Mapped, and kept until all of its vector sets are uploaded */
+        buf = acvp_file_load(rsp_filename, &len, &map_len);
+        if (buf) {
+            slice_cnt = acvp_json_slice_array(buf, len, &slices);
+        }
+        if (slice_cnt < 1) {
+            ACVP_LOG_ERR("JSON val parse error");
+            rv = ACVP_MALFORMED_JSON;
+            goto end;
+        }
+
+        /* Only the identifiers are parsed */
+        ids = calloc(slices[0].len + 1, sizeof(char));
+        if (!ids) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+        memcpy_s(ids, slices[0].len + 1, slices[0].p, slices[0].len);
+        val = json_parse_string(ids);
     }
-    reg_array = json_value_get_array(val);
-    obj = json_array_get_object(reg_array, 0);
+    obj = json_value_get_object(val);
     if (!obj) {
         ACVP_LOG_ERR("JSON obj parse error");
         rv = ACVP_MALFORMED_JSON;
@@ -1250,6 +1373,7 @@ ACVP_RESULT acvp_upload_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filenam
     }
 
     strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, jwt);
+    ctx->jwt_expiry = acvp_jwt_expiry(ctx->jwt_token);
 
     vect_sets = json_object_get_array(obj, "vectorSetUrls");
     vs_cnt = json_array_get_count(vect_sets);
@@ -1284,51 +1408,29 @@ ACVP_RESULT acvp_upload_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filenam
         ctx->fips.do_validation = 0; /* Disable */
     }
 
-    n = 1;    /* start with second array index */
-    reg_array = json_value_get_array(val);
-    vs_val = json_array_get_value(reg_array, n);
-
-    while (vs_entry) {
-
-        /* check vsId compared to vs URL */
-        rsp_obj = json_array_get_object(reg_array, n);
-        ctx->vs_id = json_object_get_number(rsp_obj, "vsId");
-
-        vec_array_val = json_value_init_array();
-        vec_array = json_array((const JSON_Value *)vec_array_val);
-
-        ver_val = json_value_init_object();
-        ver_obj = json_value_get_object(ver_val);
-
-        json_object_set_string(ver_obj, "acvVersion", ACVP_PROTOCOL_VERSION);
-        json_array_append_value(vec_array, ver_val);
-
-        json_result = json_serialize_to_string_pretty(vs_val, NULL);
-        new_val = json_parse_string(json_result);
-        json_free_serialized_string(json_result);
-
-        json_array_append_value(vec_array, new_val);
-
-        ctx->kat_resp = vec_array_val;
-
-        json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
-            printf("\n\n%s\n\n", json_result);
-        } else {
-            ACVP_LOG_INFO("\n\n%s\n\n", json_result);
-        }
-        json_free_serialized_string(json_result);
-        ACVP_LOG_STATUS("Sending responses for vector set %d", ctx->vs_id);
-        rv = acvp_submit_vector_responses(ctx, vs_entry->string);
+    if (ACVP_IS_STDIO(rsp_filename)) {
+        rv = acvp_upload_vector_stream(ctx, &stream, vs_cnt);
         if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("Failed to submit test results for vector set - skipping...");
+            goto end;
         }
-
-        json_value_free(vec_array_val);
-        ctx->kat_resp = NULL;
-        n++;
-        vs_val = json_array_get_value(reg_array, n);
-        vs_entry = vs_entry->next;
+    } else {
+        /* The vector sets follow the identifiers, in the order of their URLs */
+        jobs = calloc(vs_cnt, sizeof(ACVP_UPLOAD_JOB));
+        if (!jobs) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+        while (vs_entry && job_cnt + 1 < slice_cnt) {
+            jobs[job_cnt].url = vs_entry->string;
+            jobs[job_cnt].vs = &slices[job_cnt + 1];
+            jobs[job_cnt].vs_id = (int)acvp_json_slice_get_number(&slices[job_cnt + 1], "vsId");
+            job_cnt++;
+            vs_entry = vs_entry->next;
+        }
+        if (vs_entry) {
+            ACVP_LOG_WARN("Response file has responses for %d of its %d vector sets", job_cnt, vs_cnt);
+        }
+        acvp_upload_vector_sets(ctx, jobs, job_cnt);
     }
 
     /*
@@ -1351,7 +1453,165 @@ ACVP_RESULT acvp_upload_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filenam
         }
     }
 end:
-    json_value_free(val);
+    if (jobs) free(jobs);
+    if (val) json_value_free(val);
+    if (ids) free(ids);
+    if (slices) free(slices);
+    acvp_file_unload(buf, map_len);
+    acvp_json_stream_free(&stream);
+    return rv;
+}
+
+/*
+ * A vector set of a response file being merged, see acvp_merge_vector_rsp_files()
+ */
+typedef struct acvp_merge_vs_t {
+    int vs_id;
+    const char *url;
+    JSON_Value *vs_val;
+} ACVP_MERGE_VS;
+
+static int acvp_merge_vs_cmp(const void *a, const void *b) {
+    const ACVP_MERGE_VS *x = a, *y = b;
+
+    return (x->vs_id > y->vs_id) - (x->vs_id < y->vs_id);
+}
+
+/*
+ * Combines the response files of runs over parts of one request file into
+ * a single response file, with the vector sets in vsId order. The session
+ * identifiers are those of the first file with all of the URLs.
+ */
+ACVP_RESULT acvp_merge_vector_rsp_files(ACVP_CTX *ctx, const char **rsp_filenames, int count,
+                                        const char *out_filename) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value **vals = NULL;
+    JSON_Value *ids_val = NULL, *urls_val = NULL;
+    JSON_Array *arr = NULL, *urls = NULL, *merged_urls = NULL;
+    JSON_Object *ids = NULL;
+    ACVP_MERGE_VS *sets = NULL;
+    const char *session_url = NULL, *url = NULL;
+    int i = 0, j = 0, n = 0, diff = 0, total = 0, set_cnt = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!rsp_filenames || count < 1 || !out_filename) {
+        ACVP_LOG_ERR("Must provide the response files to merge and a file to save them to");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(out_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided out_filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    vals = calloc(count, sizeof(JSON_Value *));
+    if (!vals) {
+        return ACVP_MALLOC_FAIL;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!rsp_filenames[i] ||
+                strnlen_s(rsp_filenames[i], ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+            ACVP_LOG_ERR("Invalid name given for response file %d", i + 1);
+            rv = ACVP_INVALID_ARG;
+            goto end;
+        }
+        vals[i] = acvp_json_parse_file(rsp_filenames[i]);
+        if (!vals[i]) {
+            ACVP_LOG_ERR("Unable to parse response file %s", rsp_filenames[i]);
+            rv = ACVP_MALFORMED_JSON;
+            goto end;
+        }
+        arr = json_value_get_array(vals[i]);
+        ids = json_array_get_object(arr, 0);
+        url = json_object_get_string(ids, "url");
+        if (!url) {
+            ACVP_LOG_ERR("Missing session URL in %s", rsp_filenames[i]);
+            rv = ACVP_MALFORMED_JSON;
+            goto end;
+        }
+        if (!session_url) {
+            session_url = url;
+        } else {
+            strcmp_s(session_url, ACVP_ATTR_URL_MAX, url, &diff);
+            if (diff) {
+                ACVP_LOG_ERR("%s is not from the same test session as %s", rsp_filenames[i], rsp_filenames[0]);
+                rv = ACVP_INVALID_ARG;
+                goto end;
+            }
+        }
+        total += json_array_get_count(arr) - 1;
+    }
+
+    sets = calloc(total ? total : 1, sizeof(ACVP_MERGE_VS));
+    if (!sets) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    for (i = 0; i < count; i++) {
+        arr = json_value_get_array(vals[i]);
+        urls = json_object_get_array(json_array_get_object(arr, 0), "vectorSetUrls");
+        n = json_array_get_count(arr) - 1;
+        for (j = 0; j < n; j++) {
+            url = json_array_get_string(urls, j);
+            if (!url) {
+                ACVP_LOG_ERR("Missing vector set URL in %s", rsp_filenames[i]);
+                rv = ACVP_MALFORMED_JSON;
+                goto end;
+            }
+            sets[set_cnt].vs_id = json_object_get_number(json_array_get_object(arr, j + 1), "vsId");
+            sets[set_cnt].url = url;
+            sets[set_cnt].vs_val = json_array_get_value(arr, j + 1);
+            set_cnt++;
+        }
+    }
+
+    qsort(sets, set_cnt, sizeof(ACVP_MERGE_VS), acvp_merge_vs_cmp);
+    for (i = 1; i < set_cnt; i++) {
+        if (sets[i].vs_id == sets[i - 1].vs_id) {
+            ACVP_LOG_ERR("Vector set %d is in more than one response file", sets[i].vs_id);
+            rv = ACVP_INVALID_ARG;
+            goto end;
+        }
+    }
+
+    ids_val = json_value_deep_copy(json_array_get_value(json_value_get_array(vals[0]), 0));
+    urls_val = json_value_init_array();
+    merged_urls = json_value_get_array(urls_val);
+    if (!ids_val || !merged_urls) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    for (i = 0; i < set_cnt; i++) {
+        json_array_append_string(merged_urls, sets[i].url);
+    }
+    if (json_object_set_value(json_value_get_object(ids_val), "vectorSetUrls", urls_val) != JSONSuccess) {
+        rv = ACVP_JSON_ERR;
+        goto end;
+    }
+    urls_val = NULL;
+
+    /* Each vector set is serialized while the one before it is written out */
+    rv = acvp_rsp_file_begin(ctx, out_filename, ids_val);
+    for (i = 0; i < set_cnt && rv == ACVP_SUCCESS; i++) {
+        rv = acvp_writer_json(ctx->rsp_writer, ", ", sets[i].vs_val, ctx->vector_rsp_compact);
+    }
+    rv = acvp_rsp_file_end(ctx, rv);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("File write error");
+        goto end;
+    }
+    ACVP_LOG_STATUS("Merged %d vector sets from %d response files into %s", set_cnt, count, out_filename);
+
+end:
+    if (urls_val) json_value_free(urls_val);
+    if (ids_val) json_value_free(ids_val);
+    if (sets) free(sets);
+    for (i = 0; i < count; i++) {
+        if (vals[i]) json_value_free(vals[i]);
+    }
+    free(vals);
     return rv;
 }
 
@@ -1392,7 +1652,14 @@ end:
 ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filename, const char *save_filename) {
     JSON_Value *val = NULL, *fw_val = NULL;
     JSON_Object *obj = NULL, *fw_obj = NULL;
-    ACVP_RESULT rv = ACVP_SUCCESS;
+    ACVP_RESULT rv = ACVP_SUCCESS, close_rv = ACVP_SUCCESS;
+    ACVP_FETCH_POOL pool;
+    ACVP_FETCH_JOB *jobs = NULL, *job = NULL;
+    ACVP_WRITER *writer = NULL;
+    int count = 0, i = 0, window = 0, fetching = 0;
+    JSON_Array *results = NULL;
+    JSON_Object *current = NULL;
+    const char *vsid_url = NULL;
 
     if (!ctx) {
         return ACVP_NO_CTX;
@@ -1426,7 +1693,7 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
         goto end;
     }
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("Error while parsing json from server!");
         rv = ACVP_JSON_ERR;
@@ -1439,11 +1706,6 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
         goto end;
     }
 
-    JSON_Array *results = NULL;
-    int count = 0, i = 0;
-    JSON_Object *current = NULL;
-    const char *vsid_url = NULL;
-
     results = json_object_get_array(obj, "results");
     if (!results) {
         ACVP_LOG_ERR("Error parsing status from server");
@@ -1451,6 +1713,36 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
         goto end;
     }
 
+    count = (int)json_array_get_count(results);
+    if (count) {
+        jobs = calloc(count, sizeof(ACVP_FETCH_JOB));
+        if (!jobs) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+    }
+    for (i = 0; i < count; i++) {
+        current = json_array_get_object(results, i);
+        if (!current) {
+            ACVP_LOG_ERR("Error parsing status from server");
+            rv = ACVP_JSON_ERR;
+            goto end;
+        }
+        
+        vsid_url = json_object_get_string(current, "vectorSetUrl");
+        if (!vsid_url) {
+            ACVP_LOG_ERR("Error parsing vector set URL from server");
+            rv = ACVP_JSON_ERR;
+            goto end;
+        }
+        if (strnlen_s(vsid_url, ACVP_ATTR_URL_MAX + 1) > ACVP_ATTR_URL_MAX) {
+            ACVP_LOG_ERR("URL is too long. Cannot proceed.");
+            rv = ACVP_TRANSPORT_FAIL;
+            goto end;
+        }
+        jobs[i].url = vsid_url;
+    }
+
     ACVP_LOG_STATUS("Beginning output of expected results...");
 
     if (save_filename) {
@@ -1469,10 +1761,12 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
         }
         json_object_set_string(fw_obj, "jwt", ctx->jwt_token);
         json_object_set_string(fw_obj, "url", ctx->session_url);
-        rv = acvp_json_serialize_to_file_pretty_w(fw_val, save_filename);
+        rv = acvp_writer_open(&writer, save_filename, "w");
+        if (rv == ACVP_SUCCESS) {
+            rv = acvp_writer_json(writer, "[ ", fw_val, 0);
+        }
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error writing to provided file.");
-            json_value_free(fw_val);
             goto end;
         }
         json_value_free(fw_val);
@@ -1480,28 +1774,16 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
         fw_obj = NULL;
     }
 
-    count = (int)json_array_get_count(results);
+    /*
+     * Fetched a few at a time ahead of the one being written, which is
+     * written as soon as it is in, so only those few are held at once
+     */
+    window = ctx->max_parallel_vs * ACVP_FETCH_WINDOW_PER_WORKER;
+    acvp_fetch_start(ctx, &pool, jobs, count, ACVP_FETCH_EXPECTED, window > 0 ? window : 1);
+    fetching = 1;
     for (i = 0; i < count; i++) {
-        current = json_array_get_object(results, i);
-        if (!current) {
-            ACVP_LOG_ERR("Error parsing status from server");
-            rv = ACVP_JSON_ERR;
-            goto end;
-        }
-        
-        vsid_url = json_object_get_string(current, "vectorSetUrl");
-        if (!vsid_url) {
-            ACVP_LOG_ERR("Error parsing vector set URL from server");
-            rv = ACVP_JSON_ERR;
-            goto end;
-        }
-        if (strnlen_s(vsid_url, ACVP_ATTR_URL_MAX + 1) > ACVP_ATTR_URL_MAX) {
-            ACVP_LOG_ERR("URL is too long. Cannot proceed.");
-            rv = ACVP_TRANSPORT_FAIL;
-            goto end;
-        }
-
-        rv = acvp_retrieve_expected_result(ctx, vsid_url);
+        job = acvp_fetch_take(&pool, i);
+        rv = job->rv;
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error retrieving expected results from server");
             goto end;
@@ -1509,14 +1791,14 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
 
         //If save_filename != null, we are saving to file, otherwise log it all
         if (save_filename) {
-            fw_val = json_parse_string(ctx->curl_buf);
+            fw_val = json_parse_string(job->body);
             if (!fw_val) {
                 ACVP_LOG_ERR("Error parsing JSON from server response");
                 rv = ACVP_TRANSPORT_FAIL;
                 goto end;
             }
             /* append data */
-            rv = acvp_json_serialize_to_file_pretty_a(fw_val, save_filename);
+            rv = acvp_writer_json(writer, ", ", fw_val, 0);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Error writing to file");
                 goto end;
@@ -1524,13 +1806,27 @@ ACVP_RESULT acvp_get_expected_results(ACVP_CTX *ctx, const char *request_filenam
             json_value_free(fw_val);
             fw_val = NULL;
         } else {
-            printf("%s,\n", ctx->curl_buf);
+            printf("%s,\n", job->body);
+        }
+        free(job->body);
+        job->body = NULL;
+    }
+    if (writer) {
+        //append the final ']'
+        rv = acvp_writer_puts(writer, " ]");
+        close_rv = acvp_writer_close(writer);
+        writer = NULL;
+        if (rv == ACVP_SUCCESS) rv = close_rv;
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Error writing to file");
+            goto end;
         }
     }
-    //append the final ']'
-    rv = acvp_json_serialize_to_file_pretty_a(NULL, save_filename);
     ACVP_LOG_STATUS("Completed output of expected results.");
 end:
+   if (fetching) acvp_fetch_finish(&pool);
+   acvp_free_fetch_jobs(jobs, count);
+   if (writer) acvp_writer_close(writer);
    if (fw_val) json_value_free(fw_val);
    if (val) json_value_free(val);
    return rv;
@@ -1539,16 +1835,23 @@ end:
 /**
  * Allows application to continue a previous test session by checking which KAT responses the server is missing
  */
-ACVP_RESULT acvp_resume_test_session(ACVP_CTX *ctx, const char *request_filename, int fips_validation) {
+/*
+ * Runs the vector sets of the session in request_filename again: those the
+ * server has no response to, or with failed set those it failed, see
+ * acvp_rerun_failed_vector_sets()
+ */
+static ACVP_RESULT acvp_resume_vector_sets(ACVP_CTX *ctx, const char *request_filename, int fips_validation,
+                                           int failed) {
     JSON_Value *val = NULL;
     JSON_Object *obj = NULL;
     ACVP_RESULT rv = ACVP_SUCCESS;
+    int failed_cnt = 0;
     
-    if (!ctx) {
-        return ACVP_NO_CTX;
+    if (failed) {
+        ACVP_LOG_STATUS("Rerunning the failed vector sets of the session...");
+    } else {
+        ACVP_LOG_STATUS("Resuming session...");
     }
-    
-    ACVP_LOG_STATUS("Resuming session...");
     if (ctx->vector_req) {
         ACVP_LOG_STATUS("Restarting download of vector sets to file...");
     }
@@ -1571,7 +1874,7 @@ ACVP_RESULT acvp_resume_test_session(ACVP_CTX *ctx, const char *request_filename
         goto end;
     }
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("Error while parsing json from server!");
         rv = ACVP_JSON_ERR;
@@ -1635,7 +1938,22 @@ ACVP_RESULT acvp_resume_test_session(ACVP_CTX *ctx, const char *request_filename
             goto end;
         }
         
-        if (ctx->vector_req) {
+        if (failed) {
+            /*
+             * Only the vector sets that failed, whether saved to file or run
+             */
+            strcmp_s("fail", 4, status, &diff);
+            if (diff)
+                strcmp_s("error", 5, status, &diff);
+            if (!diff) {
+                rv = acvp_append_vsid_url(ctx, vsid_url);
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Error rerunning failed vector sets");
+                    goto end;
+                }
+                failed_cnt++;
+            }
+        } else if (ctx->vector_req) {
             //If we are just saving to file, we don't need to check status, download all VS
             rv = acvp_append_vsid_url(ctx, vsid_url);
             if (rv != ACVP_SUCCESS) {
@@ -1665,10 +1983,19 @@ ACVP_RESULT acvp_resume_test_session(ACVP_CTX *ctx, const char *request_filename
     }
 
     if (!ctx->vsid_url_list) {
-        ACVP_LOG_STATUS("All vector set results already uploaded. Nothing to resume.");
+        if (failed) {
+            ACVP_LOG_STATUS("No vector set of the session failed. Nothing to rerun.");
+        } else {
+            ACVP_LOG_STATUS("All vector set results already uploaded. Nothing to resume.");
+        }
         goto end;
     } else {
+        if (failed) {
+            ACVP_LOG_STATUS("Rerunning %d failed vector sets", failed_cnt);
+        }
+        ctx->rerun_failed = failed;
         rv = acvp_process_tests(ctx);
+        ctx->rerun_failed = 0;
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Failed to process vectors");
             goto end;
@@ -1708,6 +2035,24 @@ end:
     return rv;
 }
 
+ACVP_RESULT acvp_resume_test_session(ACVP_CTX *ctx, const char *request_filename, int fips_validation) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    return acvp_resume_vector_sets(ctx, request_filename, fips_validation, 0);
+}
+
+/*
+ * Runs the vector sets the server failed in the session again, and submits
+ * the new responses to them, for a fix to be checked without a new session
+ */
+ACVP_RESULT acvp_rerun_failed_vector_sets(ACVP_CTX *ctx, const char *request_filename, int fips_validation) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    return acvp_resume_vector_sets(ctx, request_filename, fips_validation, 1);
+}
+
 /**
  * Allows application (with proper authentication) to connect to server and request
  * it cancel the session, halting processing and deleting related data
@@ -1750,7 +2095,7 @@ ACVP_RESULT acvp_cancel_test_session(ACVP_CTX *ctx, const char *request_filename
     }
     if (save_filename) {
         ACVP_LOG_STATUS("Saving cancel request response to specified file...");
-        val = json_parse_string(ctx->curl_buf);
+        val = json_parse_string(ctx->exec.curl_buf);
         if (!val) {
             ACVP_LOG_ERR("Unable to parse JSON. printing output instead...");
         } else {
@@ -1765,7 +2110,7 @@ ACVP_RESULT acvp_cancel_test_session(ACVP_CTX *ctx, const char *request_filename
             }
         }
     }
-    ACVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->curl_buf);
+    ACVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->exec.curl_buf);
 
 end:
     if (val) json_value_free(val);
@@ -1807,9 +2152,252 @@ ACVP_RESULT acvp_set_registration_file(ACVP_CTX *ctx, const char *json_filename)
     return ACVP_SUCCESS;
 }
 
+/*
+ * Allows application to name a cache file that acvp_run_vectors_from_file
+ * compiles the request file into, and loads it from on later runs
+ */
+ACVP_RESULT acvp_set_vector_set_cache_file(ACVP_CTX *ctx, const char *cache_filename) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!cache_filename) {
+        ACVP_LOG_ERR("Must provide value for cache filename");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(cache_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided cache_filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    if (ctx->vs_cache_file) { free(ctx->vs_cache_file); }
+    ctx->vs_cache_file = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!ctx->vs_cache_file) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(ctx->vs_cache_file, ACVP_JSON_FILENAME_MAX + 1, cache_filename);
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to name a cache file that acvp_register() saves the
+ * serialized registration to, and reuses it from for the same capabilities
+ */
+ACVP_RESULT acvp_set_registration_cache_file(ACVP_CTX *ctx, const char *cache_filename) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!cache_filename) {
+        ACVP_LOG_ERR("Must provide value for cache filename");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(cache_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided cache_filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    if (ctx->reg_cache_file) { free(ctx->reg_cache_file); }
+    ctx->reg_cache_file = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!ctx->reg_cache_file) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(ctx->reg_cache_file, ACVP_JSON_FILENAME_MAX + 1, cache_filename);
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to name a cache file of the server DB URLs that
+ * acvp_verify_fips_validation_metadata() finds, so later validations with
+ * the same metadata skip searching the server DB for them
+ */
+ACVP_RESULT acvp_set_metadata_cache_file(ACVP_CTX *ctx, const char *cache_filename, long ttl_seconds) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!cache_filename) {
+        ACVP_LOG_ERR("Must provide value for cache filename");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(cache_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided cache_filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+    if (ttl_seconds <= 0) {
+        ACVP_LOG_ERR("Cache TTL must be a positive number of seconds");
+        return ACVP_INVALID_ARG;
+    }
+
+    if (ctx->meta_cache_file) { free(ctx->meta_cache_file); }
+    ctx->meta_cache_file = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!ctx->meta_cache_file) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(ctx->meta_cache_file, ACVP_JSON_FILENAME_MAX + 1, cache_filename);
+    ctx->meta_cache_ttl = ttl_seconds;
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to name a journal that the responses of each test
+ * group are appended to as they are done, so a vector set that is processed
+ * again, during a resumed session, skips the groups already in it
+ */
+ACVP_RESULT acvp_set_checkpoint_journal(ACVP_CTX *ctx, const char *journal_filename) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!journal_filename) {
+        ACVP_LOG_ERR("Must provide value for journal filename");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(journal_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided journal_filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    if (ctx->journal_file) { free(ctx->journal_file); }
+    ctx->journal_file = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!ctx->journal_file) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(ctx->journal_file, ACVP_JSON_FILENAME_MAX + 1, journal_filename);
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to name a directory that the vector sets of a test
+ * session are kept in as they are downloaded, so processing a vector set
+ * again, during a resumed session, does not download it again
+ */
+ACVP_RESULT acvp_set_vector_set_download_cache(ACVP_CTX *ctx, const char *cache_dir) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!cache_dir) {
+        ACVP_LOG_ERR("Must provide value for cache directory");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(cache_dir, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided cache_dir length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    if (ctx->vs_dl_cache_dir) { free(ctx->vs_dl_cache_dir); }
+    ctx->vs_dl_cache_dir = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!ctx->vs_dl_cache_dir) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(ctx->vs_dl_cache_dir, ACVP_JSON_FILENAME_MAX + 1, cache_dir);
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to have the vector sets of the session processed by
+ * worker processes sharing dir, see acvp_remote.c
+ */
+ACVP_RESULT acvp_set_remote_workers(ACVP_CTX *ctx, const char *dir, int timeout) {
+    char path[ACVP_JSON_FILENAME_MAX + 8];
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        /* Exec contexts share the directory of their session */
+        return ACVP_INVALID_ARG;
+    }
+    if (timeout < 0) {
+        ACVP_LOG_ERR("Remote worker timeout must not be negative");
+        return ACVP_INVALID_ARG;
+    }
+    if (dir && strnlen_s(dir, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided dir length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    if (ctx->remote_dir) { free(ctx->remote_dir); }
+    ctx->remote_dir = NULL;
+    ctx->remote_timeout = timeout;
+    if (!dir) {
+        return ACVP_SUCCESS;
+    }
+    ctx->remote_dir = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!ctx->remote_dir) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(ctx->remote_dir, ACVP_JSON_FILENAME_MAX + 1, dir);
+
+    /* Left by an earlier coordinator, the workers would stop right away */
+    snprintf(path, sizeof(path), "%s/done", dir);
+    remove(path);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to limit how much of the responses of a vector set
+ * are kept in memory; beyond that they are moved to a temporary file
+ */
+ACVP_RESULT acvp_set_memory_budget(ACVP_CTX *ctx, size_t bytes) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->memory_budget = bytes;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Allows application to have large buffers backed by huge pages
+ */
+ACVP_RESULT acvp_set_huge_pages(ACVP_CTX *ctx, int enable) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        return ACVP_INVALID_ARG;
+    }
+    ctx->exec.huge_pages = enable ? 1 : 0;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_get_memory_usage(ACVP_CTX *ctx, int vs_id, ACVP_MEMORY_USAGE *usage) {
+    ACVP_CTX *session = NULL;
+    ACVP_MEM_VS *vs = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!usage || vs_id < 0) {
+        return ACVP_INVALID_ARG;
+    }
+    memzero_s(usage, sizeof(ACVP_MEMORY_USAGE));
+    session = ctx->session ? ctx->session : ctx;
+    if (!vs_id) {
+        if (session->exec.mem) {
+            usage->current = session->exec.mem->current;
+            usage->peak = session->exec.mem->peak;
+        }
+        return ACVP_SUCCESS;
+    }
+
+    acvp_mutex_lock(&session->session_lock);
+    for (vs = session->mem_vs; vs && vs->vs_id != vs_id; vs = vs->next);
+    if (vs) {
+        *usage = vs->usage;
+    } else {
+        rv = ACVP_INVALID_ARG;
+    }
+    acvp_mutex_unlock(&session->session_lock);
+    return rv;
+}
+
 /*
  * This will return a string form of the current registration, regardless of whether the session
- * has already been started
+ * has already been started. The string is kept on the context until the capabilities or the
+ * registration change, so asking again only makes a copy of it.
  */
 char *acvp_get_current_registration(ACVP_CTX *ctx, int *len) {
     char *registration = NULL;
@@ -1819,21 +2407,36 @@ char *acvp_get_current_registration(ACVP_CTX *ctx, int *len) {
         return NULL;
     }
 
-    /* If we have a registration saved already, use that. Otherwise, build it and return it */
-    if (ctx->registration) {
-        reg = ctx->registration;
-    } else {
-        if (acvp_build_registration_json(ctx, &reg) != ACVP_SUCCESS) {
+    if (!ctx->reg_str || ctx->reg_str_gen != ctx->caps_gen) {
+        /* If we have a registration saved already, use that. Otherwise, build it */
+        if (ctx->registration) {
+            reg = ctx->registration;
+        } else {
+            if (acvp_build_registration_json(ctx, &reg) != ACVP_SUCCESS) {
+                return NULL;
+            }
+        }
+        registration = json_serialize_to_string_pretty(reg, &length);
+
+        /* free the JSON_Value if built on the fly */
+        if (!ctx->registration) {
+            json_value_free(reg);
+        }
+        if (!registration) {
             return NULL;
         }
+        if (ctx->reg_str) json_free_serialized_string(ctx->reg_str);
+        ctx->reg_str = registration;
+        ctx->reg_str_len = length;
+        ctx->reg_str_gen = ctx->caps_gen;
     }
-    registration = json_serialize_to_string_pretty(reg, &length);
-    if (len) *len = length;
 
-    /* free the JSON_Value if built on the fly */
-    if (!ctx->registration) {
-        json_value_free(reg);
+    registration = malloc((size_t)ctx->reg_str_len + 1);
+    if (!registration) {
+        return NULL;
     }
+    memcpy_s(registration, (size_t)ctx->reg_str_len + 1, ctx->reg_str, (size_t)ctx->reg_str_len + 1);
+    if (len) *len = ctx->reg_str_len;
     return registration;
 }
 
@@ -1848,6 +2451,8 @@ ACVP_RESULT acvp_set_server(ACVP_CTX *ctx, const char *server_name, int port) {
     if (!server_name || port < 1) {
         return ACVP_INVALID_ARG;
     }
+    /* Not while a pre-connect is reading the old name */
+    acvp_transport_preconnect_wait(ctx);
     if (strnlen_s(server_name, ACVP_SESSION_PARAMS_STR_LEN_MAX + 1) > ACVP_SESSION_PARAMS_STR_LEN_MAX) {
         ACVP_LOG_ERR("Server name string(s) too long");
         return ACVP_INVALID_ARG;
@@ -1863,11 +2468,6 @@ ACVP_RESULT acvp_set_server(ACVP_CTX *ctx, const char *server_name, int port) {
 
     ctx->server_port = port;
 
-    if (!ctx->http_user_agent) {
-        //generate user-agent string to send with HTTP requests
-        acvp_http_user_agent_handler(ctx);
-    }
-
     return ACVP_SUCCESS;
 }
 
@@ -1937,6 +2537,7 @@ ACVP_RESULT acvp_set_cacerts(ACVP_CTX *ctx, const char *ca_file) {
     if (!ca_file) {
         return ACVP_MISSING_ARG;
     }
+    acvp_transport_preconnect_wait(ctx);
 
     if (strnlen_s(ca_file, ACVP_SESSION_PARAMS_STR_LEN_MAX + 1) > ACVP_SESSION_PARAMS_STR_LEN_MAX) {
         ACVP_LOG_ERR("CA filename is suspiciously long...");
@@ -1969,6 +2570,7 @@ ACVP_RESULT acvp_set_certkey(ACVP_CTX *ctx, char *cert_file, char *key_file) {
     if (!cert_file || !key_file) {
         return ACVP_MISSING_ARG;
     }
+    acvp_transport_preconnect_wait(ctx);
     if (strnlen_s(cert_file, ACVP_SESSION_PARAMS_STR_LEN_MAX + 1) > ACVP_SESSION_PARAMS_STR_LEN_MAX ||
         strnlen_s(key_file, ACVP_SESSION_PARAMS_STR_LEN_MAX + 1) > ACVP_SESSION_PARAMS_STR_LEN_MAX) {
         ACVP_LOG_ERR("CA filename is suspiciously long...");
@@ -2023,6 +2625,60 @@ ACVP_RESULT acvp_mark_as_request_only(ACVP_CTX *ctx, char *filename) {
     return ACVP_SUCCESS;
 }
 
+ACVP_RESULT acvp_set_vector_req_compact(ACVP_CTX *ctx, int compact) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->vector_req_compact = compact ? 1 : 0;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_vector_rsp_compact(ACVP_CTX *ctx, int compact) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->vector_rsp_compact = compact ? 1 : 0;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_vector_set_filter(ACVP_CTX *ctx, const int *vs_ids, int count) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (count < 0 || (count && !vs_ids)) {
+        ACVP_LOG_ERR("Invalid vector set filter");
+        return ACVP_INVALID_ARG;
+    }
+    if (ctx->vs_filter) free(ctx->vs_filter);
+    ctx->vs_filter = NULL;
+    ctx->vs_filter_cnt = 0;
+    if (!vs_ids || !count) {
+        return ACVP_SUCCESS;
+    }
+
+    ctx->vs_filter = calloc(count, sizeof(int));
+    if (!ctx->vs_filter) {
+        return ACVP_MALLOC_FAIL;
+    }
+    memcpy_s(ctx->vs_filter, count * sizeof(int), vs_ids, count * sizeof(int));
+    ctx->vs_filter_cnt = count;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_vector_set_shard(ACVP_CTX *ctx, int shard, int shard_count) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (shard_count < 0 || (shard_count && (shard < 1 || shard > shard_count)) ||
+            (!shard_count && shard)) {
+        ACVP_LOG_ERR("Shard must be between 1 and the number of shards");
+        return ACVP_INVALID_ARG;
+    }
+    ctx->vs_shard = shard;
+    ctx->vs_shard_cnt = shard_count;
+    return ACVP_SUCCESS;
+}
+
 ACVP_RESULT acvp_mark_as_get_only(ACVP_CTX *ctx, char *string, const char *save_filename) {
     int len = 0;
 
@@ -2141,42 +2797,214 @@ int acvp_get_vector_set_count(ACVP_CTX *ctx) {
     return ctx->vs_count;
 }
 
-/*
- * This function builds the JSON login message that
- * will be sent to the ACVP server. If enabled,
- * it will perform the second of the two-factor
- * authentications using a TOTP.
- */
-static ACVP_RESULT acvp_build_login(ACVP_CTX *ctx, char **login, int *login_len, int refresh) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    JSON_Value *reg_arry_val = NULL;
-    JSON_Value *ver_val = NULL;
-    JSON_Object *ver_obj = NULL;
-    JSON_Value *pw_val = NULL;
-    JSON_Object *pw_obj = NULL;
-    JSON_Array *reg_arry = NULL;
-    char *token = NULL;
-
-    if (!login_len) return ACVP_INVALID_ARG;
-
-    /*
-     * Start the login array
-     */
-    reg_arry_val = json_value_init_array();
-    reg_arry = json_array((const JSON_Value *)reg_arry_val);
-
-    ver_val = json_value_init_object();
-    ver_obj = json_value_get_object(ver_val);
-
-    json_object_set_string(ver_obj, "acvVersion", ACVP_PROTOCOL_VERSION);
-    json_array_append_value(reg_arry, ver_val);
+ACVP_RESULT acvp_set_max_parallel_vector_sets(ACVP_CTX *ctx, int max_parallel) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (max_parallel < 1 || max_parallel > ACVP_MAX_PARALLEL_VS) {
+        ACVP_LOG_ERR("Number of parallel vector sets must be between 1 and %d", ACVP_MAX_PARALLEL_VS);
+        return ACVP_INVALID_ARG;
+    }
+    ctx->max_parallel_vs = max_parallel;
+    return ACVP_SUCCESS;
+}
 
-    if (ctx->totp_cb || refresh) {
-        pw_val = json_value_init_object();
-        pw_obj = json_value_get_object(pw_val);
+ACVP_RESULT acvp_set_test_case_cost(ACVP_CTX *ctx, ACVP_CIPHER cipher, unsigned long long int ns) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (cipher <= ACVP_CIPHER_START || cipher >= ACVP_CIPHER_END) {
+        return ACVP_INVALID_ARG;
     }
+    ctx->tc_cost[cipher] = ns;
+    return ACVP_SUCCESS;
+}
 
-    if (ctx->totp_cb) {
+ACVP_RESULT acvp_set_metrics_cb(ACVP_CTX *ctx, void (*metrics_cb)(const ACVP_METRICS *metrics, void *arg), void *arg) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->metrics_cb = metrics_cb;
+    ctx->metrics_arg = arg;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_cap_loader(ACVP_CTX *ctx, ACVP_RESULT (*loader)(ACVP_CTX *ctx, ACVP_CIPHER cipher, void *arg),
+                                void *arg) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->cap_loader = loader;
+    ctx->cap_loader_arg = arg;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_event_cb(ACVP_CTX *ctx, void (*event_cb)(const ACVP_EVENT *event, void *arg), void *arg) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->event_cb = event_cb;
+    ctx->event_arg = arg;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_idle_cb(ACVP_CTX *ctx, int (*idle_cb)(unsigned int budget_ms, void *arg), void *arg) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->idle_cb = idle_cb;
+    ctx->idle_arg = arg;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_async_log(ACVP_CTX *ctx, int entries) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        /* Exec contexts share the sink of their session */
+        return ACVP_INVALID_ARG;
+    }
+    if (entries < 0 || entries > ACVP_LOG_RING_MAX) {
+        ACVP_LOG_ERR("Number of async log entries must be between 0 and %d", ACVP_LOG_RING_MAX);
+        return ACVP_INVALID_ARG;
+    }
+    acvp_log_ring_free(ctx);
+    if (!entries || !ctx->test_progress_cb) {
+        return ACVP_SUCCESS;
+    }
+    return acvp_log_ring_new(ctx, entries);
+}
+
+ACVP_RESULT acvp_preconnect(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        /* Exec contexts connect on their own as they need to */
+        return ACVP_INVALID_ARG;
+    }
+    if (!ctx->server_name || !ctx->server_port) {
+        ACVP_LOG_ERR("Call acvp_set_server() before acvp_preconnect()");
+        return ACVP_MISSING_ARG;
+    }
+    return acvp_transport_preconnect(ctx);
+}
+
+ACVP_RESULT acvp_set_max_parallel_test_cases(ACVP_CTX *ctx, int max_parallel) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (max_parallel < 1 || max_parallel > ACVP_MAX_PARALLEL_TC) {
+        ACVP_LOG_ERR("Number of parallel test cases must be between 1 and %d", ACVP_MAX_PARALLEL_TC);
+        return ACVP_INVALID_ARG;
+    }
+    ctx->max_parallel_tc = max_parallel;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_worker_affinity(ACVP_CTX *ctx, ACVP_AFFINITY policy, const int *ids, int count) {
+    int *copy = NULL, i = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        /* Exec contexts share the list of their session */
+        return ACVP_INVALID_ARG;
+    }
+    if (policy < ACVP_AFFINITY_NONE || policy > ACVP_AFFINITY_NUMA || count < 0 ||
+            count > ACVP_MAX_AFFINITY_IDS || (count && !ids) ||
+            (policy == ACVP_AFFINITY_CPUS && !count)) {
+        ACVP_LOG_ERR("Invalid worker affinity");
+        return ACVP_INVALID_ARG;
+    }
+#if !defined _WIN32 && !defined __linux__
+    if (policy != ACVP_AFFINITY_NONE) {
+        ACVP_LOG_ERR("Worker threads can not be pinned on this platform");
+        return ACVP_UNSUPPORTED_OP;
+    }
+#endif
+    for (i = 0; i < count; i++) {
+        if (ids[i] < 0 || ids[i] >= ACVP_MAX_AFFINITY_IDS) {
+            ACVP_LOG_ERR("CPUs and NUMA nodes must be between 0 and %d", ACVP_MAX_AFFINITY_IDS - 1);
+            return ACVP_INVALID_ARG;
+        }
+    }
+    if (policy != ACVP_AFFINITY_NONE && count) {
+        copy = calloc(count, sizeof(int));
+        if (!copy) {
+            return ACVP_MALLOC_FAIL;
+        }
+        memcpy_s(copy, count * sizeof(int), ids, count * sizeof(int));
+    }
+
+    if (ctx->affinity_ids) free(ctx->affinity_ids);
+    ctx->affinity = policy;
+    ctx->affinity_ids = copy;
+    ctx->affinity_cnt = copy ? count : 0;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_tc_deadline(ACVP_CTX *ctx, int seconds) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (seconds < 0 || seconds > ACVP_MAX_WAIT_TIME) {
+        ACVP_LOG_ERR("Test case deadline must be between 0 and %d seconds", ACVP_MAX_WAIT_TIME);
+        return ACVP_INVALID_ARG;
+    }
+    ctx->tc_deadline = seconds;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_tc_progress_cb(ACVP_CTX *ctx,
+                                    int (*progress_cb)(const ACVP_TC_PROGRESS *progress, void *arg),
+                                    void *arg) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->tc_progress_cb = progress_cb;
+    ctx->tc_progress_arg = arg;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * This function builds the JSON login message that
+ * will be sent to the ACVP server. If enabled,
+ * it will perform the second of the two-factor
+ * authentications using a TOTP.
+ */
+static ACVP_RESULT acvp_build_login(ACVP_CTX *ctx, char **login, int *login_len, int refresh) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *reg_arry_val = NULL;
+    JSON_Value *ver_val = NULL;
+    JSON_Object *ver_obj = NULL;
+    JSON_Value *pw_val = NULL;
+    JSON_Object *pw_obj = NULL;
+    JSON_Array *reg_arry = NULL;
+    char *token = NULL;
+
+    if (!login_len) return ACVP_INVALID_ARG;
+
+    /*
+     * Start the login array
+     */
+    reg_arry_val = json_value_init_array();
+    reg_arry = json_array((const JSON_Value *)reg_arry_val);
+
+    ver_val = json_value_init_object();
+    ver_obj = json_value_get_object(ver_val);
+
+    json_object_set_string(ver_obj, "acvVersion", ACVP_PROTOCOL_VERSION);
+    json_array_append_value(reg_arry, ver_val);
+
+    if (ctx->totp_cb || refresh) {
+        pw_val = json_value_init_object();
+        pw_obj = json_value_get_object(pw_val);
+    }
+
+    if (ctx->totp_cb) {
         token = calloc(ACVP_TOTP_TOKEN_MAX + 1, sizeof(char));
         if (!token) return ACVP_MALLOC_FAIL;
 
@@ -2208,62 +3036,104 @@ err:
 }
 
 /*
- * This function is used to register the DUT with the server.
- * Registration allows the DUT to advertise it's capabilities to
- * the server.  The server will respond with a set of vector set
- * identifiers that the client will need to process.
+ * A registration built and serialized by a thread of its own, while the
+ * login waits on the server, see acvp_run()
  */
-static ACVP_RESULT acvp_register(ACVP_CTX *ctx) {
+typedef struct acvp_reg_build_t {
+    ACVP_CTX *ctx;
+    char *reg;
+    int reg_len;
+    ACVP_RESULT rv;
+} ACVP_REG_BUILD;
+
+/*
+ * Builds the registration of the capabilities, or reads it from the
+ * capabilities file, into ctx->registration, and serializes it with the
+ * rest of the test session request into reg.
+ */
+static ACVP_RESULT acvp_build_register(ACVP_CTX *ctx, char **reg, int *reg_len) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *reg = NULL;
-    int reg_len = 0, count = 0;
+    int count = 0;
 
     JSON_Value *tmp_json = NULL;
     JSON_Array *tmp_arr = NULL;
-    if (!ctx) {
-        return ACVP_NO_CTX;
-    }
 
-    /*
-     * Send the capabilities to the ACVP server and get the response,
-     * which should be a list of vector set ID urls
-     */
     if (ctx->use_json) {
         ACVP_LOG_STATUS("Reading capabilities registration file...");
         tmp_json = json_parse_file(ctx->json_filename);
         if (!tmp_json) {
             ACVP_LOG_ERR("Error reading capabilities file");
-            rv = ACVP_JSON_ERR;
-            goto end;
+            return ACVP_JSON_ERR;
         }
         /* Quickly sanity check format */
         tmp_arr = json_value_get_array(tmp_json);
         if (!tmp_arr) {
             ACVP_LOG_ERR("Provided capabilities file in invalid format");
-            rv = ACVP_JSON_ERR;
-            goto end;
+            json_value_free(tmp_json);
+            return ACVP_JSON_ERR;
         }
         count = json_array_get_count(tmp_arr);
         if (count < 1 || count > ACVP_CAP_MAX) {
             ACVP_LOG_ERR("Invalid number of capability objects in provided file! Min: 1, Max: %d", ACVP_CAP_MAX);
-            rv = ACVP_JSON_ERR;
-            goto end;
+            json_value_free(tmp_json);
+            return ACVP_JSON_ERR;
         }
         ctx->registration = tmp_json;
+        ctx->caps_gen++;
     } else {
         ACVP_LOG_STATUS("Building registration of capabilities...");
         rv = acvp_build_registration_json(ctx, &tmp_json);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Unable to build registration");
-            goto end;
+            return rv;
         } else {
             ctx->registration = tmp_json;
+            ctx->caps_gen++;
         }
     }
 
-    rv = acvp_build_full_registration(ctx, &reg, &reg_len);
+    rv = acvp_build_full_registration(ctx, reg, reg_len);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Error occurred building registration JSON: %d", rv);
+    }
+    return rv;
+}
+
+static void acvp_build_register_thread(void *arg) {
+    ACVP_REG_BUILD *build = arg;
+
+    build->rv = acvp_build_register(build->ctx, &build->reg, &build->reg_len);
+}
+
+/*
+ * This function is used to register the DUT with the server.
+ * Registration allows the DUT to advertise it's capabilities to
+ * the server.  The server will respond with a set of vector set
+ * identifiers that the client will need to process.
+ * The registration is built here unless built is given, which holds one
+ * built already; the caller frees what it holds.
+ */
+static ACVP_RESULT acvp_register(ACVP_CTX *ctx, ACVP_REG_BUILD *built) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    char *reg = NULL;
+    int reg_len = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    /*
+     * Send the capabilities to the ACVP server and get the response,
+     * which should be a list of vector set ID urls
+     */
+    if (built) {
+        rv = built->rv;
+        reg = built->reg;
+        reg_len = built->reg_len;
+    } else {
+        rv = acvp_build_register(ctx, &reg, &reg_len);
+    }
+    if (rv != ACVP_SUCCESS) {
         goto end;
     }
 
@@ -2278,12 +3148,13 @@ static ACVP_RESULT acvp_register(ACVP_CTX *ctx) {
         }
         ACVP_LOG_STATUS("Successfully sent registration and received list of vector set URLs");
         ACVP_LOG_STATUS("Test session URL: %s", ctx->session_url);
+        rv = acvp_cap_snapshot_take(ctx);
     } else {
         ACVP_LOG_ERR("Failed to send registration");
     }
 
 end:
-    if (reg) json_free_serialized_string(reg);
+    if (reg && !built) json_free_serialized_string(reg);
     return rv;
 }
 
@@ -2329,7 +3200,7 @@ static ACVP_RESULT acvp_append_vsid_url(ACVP_CTX *ctx, const char *vsid_url) {
 static ACVP_RESULT acvp_parse_login(ACVP_CTX *ctx) {
     JSON_Value *val;
     JSON_Object *obj = NULL;
-    char *json_buf = ctx->curl_buf;
+    char *json_buf = ctx->exec.curl_buf;
     const char *jwt;
 #ifdef ACVP_DEPRECATED
     int large_required = 0;
@@ -2373,6 +3244,7 @@ static ACVP_RESULT acvp_parse_login(ACVP_CTX *ctx) {
 
         ctx->jwt_token = calloc(ACVP_JWT_TOKEN_MAX + 1, sizeof(char));
         strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, jwt);
+        ctx->jwt_expiry = acvp_jwt_expiry(ctx->jwt_token);
     }
 end:
     json_value_free(val);
@@ -2389,7 +3261,7 @@ static ACVP_RESULT acvp_parse_validation(ACVP_CTX *ctx) {
     /*
      * Parse the JSON
      */
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -2522,7 +3394,7 @@ ACVP_RESULT acvp_notify_large(ACVP_CTX *ctx,
         goto err;
     }
 
-    server_val = json_parse_string(ctx->curl_buf);
+    server_val = json_parse_string(ctx->exec.curl_buf);
     if (!server_val) {
         ACVP_LOG_ERR("JSON parse error");
         rv = ACVP_JSON_ERR;
@@ -2591,7 +3463,7 @@ static ACVP_RESULT acvp_parse_test_session_register(ACVP_CTX *ctx) {
     /*
      * Parse the JSON
      */
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -2625,6 +3497,7 @@ static ACVP_RESULT acvp_parse_test_session_register(ACVP_CTX *ctx) {
     }
     memzero_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1);
     strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, access_token);
+    ctx->jwt_expiry = acvp_jwt_expiry(ctx->jwt_token);
 
     /*
      * Identify the VS identifiers provided by the server, save them for
@@ -2714,6 +3587,7 @@ static ACVP_RESULT acvp_parse_session_info_file(ACVP_CTX *ctx, const char *filen
         goto end;
     }
     strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, jwt);
+    ctx->jwt_expiry = acvp_jwt_expiry(ctx->jwt_token);
 
     isSample = json_object_get_boolean(obj, "isSample");
     if (json_object_has_value(obj, "isSample")) {
@@ -2728,957 +3602,3353 @@ end:
 }
 
 /*
- * This function is used by the application after registration
- * to commence the testing.  All the testing will be handled
- * by libacvp.  This function will block the caller.  Therefore,
- * it should be run on a separate thread if needed.
+ * Writes a downloaded vector set to the vector request file. The first
+ * vector set (count == 0) opens the file and starts it with the session
+ * identifiers; it then stays open, written by a thread of its own (see
+ * acvp_writer.c), until acvp_close_vector_req_file() ends it after the
+ * last vector set.
  */
-ACVP_RESULT acvp_process_tests(ACVP_CTX *ctx) {
+static ACVP_RESULT acvp_save_vector_set(ACVP_CTX *ctx, JSON_Value *alg_val, int count) {
     ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *ts_val = NULL;
+    JSON_Object *ts_obj = NULL;
+    JSON_Array *url_arr = NULL;
     ACVP_STRING_LIST *vs_entry = NULL;
-    int count = 0;
 
-    if (!ctx) {
-        return ACVP_NO_CTX;
-    }
+    /* track first vector set with file count */
+    if (count == 0) {
+        ts_val = json_value_init_object();
+        ts_obj = json_value_get_object(ts_val);
 
-    /*
-     * Iterate through the VS identifiers the server sent to us
-     * in the test session register response.  Process each vector set and
-     * return the results to the server.
-     */
-    vs_entry = ctx->vsid_url_list;
-    if (!vs_entry) {
-        return ACVP_MISSING_ARG;
-    }
-    while (vs_entry) {
-        rv = acvp_process_vsid(ctx, vs_entry->string, count);
+        json_object_set_string(ts_obj, "jwt", ctx->jwt_token);
+        json_object_set_string(ts_obj, "url", ctx->session_url);
+        json_object_set_boolean(ts_obj, "isSample", ctx->is_sample);
+
+        json_object_set_value(ts_obj, "vectorSetUrls", json_value_init_array());
+        url_arr = json_object_get_array(ts_obj, "vectorSetUrls");
+
+        vs_entry = ctx->vsid_url_list;
+        while (vs_entry) {
+            json_array_append_string(url_arr, vs_entry->string);
+            vs_entry = vs_entry->next;
+        }
+        if (ctx->vector_req_writer) {
+            acvp_writer_close(ctx->vector_req_writer);
+            ctx->vector_req_writer = NULL;
+        }
+        rv = acvp_writer_open(&ctx->vector_req_writer, ctx->vector_req_file, "w");
         if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("Unable to process vector set! Error: %d", rv);
+            json_value_free(ts_val);
+            ACVP_LOG_ERR("Unable to open vector request file %s", ctx->vector_req_file);
+            return rv;
+        }
+
+        /* Start with '[' and the identifiers */
+        rv = acvp_writer_json(ctx->vector_req_writer, "[ ", ts_val, ctx->vector_req_compact);
+        json_value_free(ts_val);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("File write error");
             return rv;
         }
-        vs_entry = vs_entry->next;
-        count++;
     }
-    /* Need to add the ending ']' here */
-    if (ctx->vector_req) {
-        rv = acvp_json_serialize_to_file_pretty_a(NULL, ctx->vector_req_file);
+    if (!ctx->vector_req_writer) {
+        ACVP_LOG_ERR("Vector request file is not open");
+        return ACVP_INTERNAL_ERR;
+    }
+    /* append vector set */
+    rv = acvp_writer_json(ctx->vector_req_writer, ", ", alg_val, ctx->vector_req_compact);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("File write error");
     }
     return rv;
 }
 
 /*
- * This is a retry handler, which pauses for a specific time.
- * This allows the server time to generate the vectors on behalf of
- * the client and to process the vector responses. The caller of this function
- * can choose to implement a retry backoff using 'modifier'. Additionally, this
- * function will ensure that retry periods will sum to no longer than ACVP_MAX_WAIT_TIME.
+ * Ends the vector request file with the closing ']' and closes it, once
+ * it has been written out and synced.
  */
-static ACVP_RESULT acvp_retry_handler(ACVP_CTX *ctx, int *retry_period, unsigned int *waited_so_far, int modifier, ACVP_WAITING_STATUS situation) {
-    /* perform check at beginning of function call, so library can check one more time when max
-     * time is reached to see if server status has changed */
-    if (*waited_so_far >= ACVP_MAX_WAIT_TIME) {
-        return ACVP_TRANSPORT_FAIL;
-    }
-    
-    if (*waited_so_far + *retry_period > ACVP_MAX_WAIT_TIME) {
-        *retry_period = ACVP_MAX_WAIT_TIME - *waited_so_far;
-    }
-    if (*retry_period <= ACVP_RETRY_TIME_MIN || *retry_period > ACVP_RETRY_TIME_MAX) {
-        *retry_period = ACVP_RETRY_TIME_MAX;
-        ACVP_LOG_WARN("retry_period not found, using max retry period!");
-    }
-    if (situation == ACVP_WAITING_FOR_TESTS) {
-        ACVP_LOG_STATUS("Vector sets not yet ready, server requesting we wait %u seconds and try again...", *retry_period);
-    } else if (situation == ACVP_WAITING_FOR_RESULTS) {
-        ACVP_LOG_STATUS("Test results not yet ready, waiting %u seconds and trying again...", *retry_period);
-    } else {
-        ACVP_LOG_STATUS("Waiting %u seconds and trying again...", *retry_period);
-    }
-
-    acvp_sleep(*retry_period);
+static ACVP_RESULT acvp_close_vector_req_file(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
 
-    /* ensure that all parameters are valid and that we do not wait longer than ACVP_MAX_WAIT_TIME */
-    if (modifier < 1 || modifier > ACVP_RETRY_MODIFIER_MAX) {
-        ACVP_LOG_WARN("retry modifier not valid, defaulting to 1 (no change)");
-        modifier = 1;
+    if (!ctx->vector_req_writer) {
+        /* Nothing was saved by this session, just end what is there */
+        return acvp_json_serialize_to_file_pretty_a(NULL, ctx->vector_req_file);
     }
-    if ((*retry_period *= modifier) > ACVP_RETRY_TIME_MAX) {
-        *retry_period = ACVP_RETRY_TIME_MAX;
+    rv = acvp_writer_puts(ctx->vector_req_writer, " ]");
+    if (acvp_writer_close(ctx->vector_req_writer) != ACVP_SUCCESS) {
+        rv = ACVP_JSON_ERR;
     }
-
-    *waited_so_far += *retry_period;
-
-    return ACVP_KAT_DOWNLOAD_RETRY;
+    ctx->vector_req_writer = NULL;
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("File write error");
+    }
+    return rv;
 }
 
 /*
- * This routine will iterate through all the vector sets, requesting
- * the test result from the server for each set.
+ * Called in place of acvp_save_vector_set() while the pool runs. Vector sets
+ * may finish downloading in any order. The one the file is waiting for is
+ * written right away, any other is parked on its job as a copy, and the file
+ * is then extended with the longest run of parked jobs that follows. This
+ * keeps the vector sets in the file in list order.
  */
-ACVP_RESULT acvp_check_test_results(ACVP_CTX *ctx) {
+static ACVP_RESULT acvp_pool_save_vector_set(ACVP_CTX *ctx, JSON_Value *alg_val, int count) {
     ACVP_RESULT rv = ACVP_SUCCESS;
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    ACVP_VS_JOB *job = NULL;
 
-    if (!ctx) {
-        return ACVP_NO_CTX;
+    acvp_mutex_lock(&pool->lock);
+    if (count == pool->next_save) {
+        /* Next in line, written straight from the caller's value */
+        rv = acvp_save_vector_set(ctx->session ? ctx->session : ctx, alg_val, count);
+        if (rv != ACVP_SUCCESS) {
+            goto end;
+        }
+        pool->next_save++;
+    } else {
+        pool->jobs[count].saved = json_value_deep_copy(alg_val);
+        if (!pool->jobs[count].saved) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
     }
 
-    rv = acvp_get_result_test_session(ctx, ctx->session_url);
+    while (pool->next_save < pool->job_count) {
+        job = &pool->jobs[pool->next_save];
+        if (!job->saved) {
+            break;
+        }
+        rv = acvp_save_vector_set(ctx->session ? ctx->session : ctx, job->saved, pool->next_save);
+        json_value_free(job->saved);
+        job->saved = NULL;
+        if (rv != ACVP_SUCCESS) {
+            break;
+        }
+        pool->next_save++;
+    }
+
+end:
+    acvp_mutex_unlock(&pool->lock);
     return rv;
 }
 
-/***************************************************************************************************************
-* Begin vector processing logic
-***************************************************************************************************************/
+/*
+ * How far the reader of the pool got with the vector set of job: 2 once it
+ * is downloaded, 1 while being downloaded
+ */
+static int acvp_pool_read_rank(const ACVP_VS_JOB *job) {
+    return job->read.buf ? 2 : job->reading;
+}
 
-static ACVP_RESULT acvp_login(ACVP_CTX *ctx, int refresh) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    char *login = NULL;
-    int login_len = 0;
+/*
+ * Picks the next vector set for a worker: of the pending jobs that can be
+ * started, the one expected to take longest, then the one the reader of the
+ * pool got furthest with, then the one the server said was ready first, in
+ * list order among equals. Returns its index, or -1 if
+ * none can be started now, in which case wait is set to the number of
+ * seconds until one can (0 when nothing is left for this worker to do).
+ * Must be called with the pool lock held.
+ */
+static int acvp_pool_next_job(ACVP_WORKER_POOL *pool, int *wait) {
+    ACVP_VS_JOB *job = NULL, *best_job = NULL;
+    time_t now = time(NULL);
+    int i = 0, best = -1, soonest = -1, rank = 0;
 
-    ACVP_LOG_STATUS("Logging in...");
-    rv = acvp_build_login(ctx, &login, &login_len, refresh);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Unable to build login message");
-        goto end;
+    *wait = 0;
+    if (pool->abort) {
+        return -1;
     }
 
-    /*
-     * Send the login to the ACVP server and get the response,
-     */
-    rv = acvp_send_login(ctx, login, login_len);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Login Send Failed");
-        goto end;
+    for (i = 0; i < pool->job_count; i++) {
+        job = &pool->jobs[i];
+        if (job->done || job->in_progress) {
+            continue;
+        }
+        if (job->next_try > now) {
+            if (soonest < 0 || job->next_try < pool->jobs[soonest].next_try) {
+                soonest = i;
+            }
+            continue;
+        }
+        best_job = best < 0 ? NULL : &pool->jobs[best];
+        if (!best_job || job->cost > best_job->cost) {
+            best = i;
+        } else if (!(job->cost < best_job->cost)) { /* Costs that tie */
+            rank = acvp_pool_read_rank(job) - acvp_pool_read_rank(best_job);
+            if (rank > 0 || (!rank && job->next_try < best_job->next_try)) {
+                best = i;
+            }
+        }
     }
-
-    rv = acvp_parse_login(ctx);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_STATUS("Login Response Failed, %d", rv);
-    } else {
-        ACVP_LOG_STATUS("Login successful");
+    if (best < 0) {
+        if (soonest >= 0) {
+            *wait = (int)(pool->jobs[soonest].next_try - now);
+        }
+        return -1;
     }
-end:
-    if (login) free(login);
-    return rv;
+
+    pool->jobs[best].in_progress = 1;
+    acvp_tc_sched_vs_begin(&pool->sched);
+    return best;
 }
 
-ACVP_RESULT acvp_refresh(ACVP_CTX *ctx) {
-    if (!ctx) {
-        return ACVP_NO_CTX;
-    }
+/*
+ * Built-in estimates of the nanoseconds a test case takes, for the ciphers
+ * whose test cases are far slower than the rest; see acvp_set_test_case_cost().
+ */
+#define ACVP_TC_COST_DEFAULT 20000ULL /* Parsing the test case and building its response */
+#define ACVP_TC_COST_MCT_ITER 500ULL  /* Each iteration of a Monte Carlo test */
+#define ACVP_TC_COST_MODULUS 2048.0   /* Modulus the estimates are for */
+
+static const struct {
+    ACVP_CIPHER cipher;
+    unsigned long long int ns;
+} acvp_tc_cost_tbl[] = {
+    { ACVP_RSA_KEYGEN,         200000000ULL },
+    { ACVP_RSA_SIGGEN,         2000000ULL },
+    { ACVP_RSA_DECPRIM,        2000000ULL },
+    { ACVP_RSA_SIGPRIM,        2000000ULL },
+    { ACVP_DSA_PQGGEN,         100000000ULL },
+    { ACVP_DSA_PQGVER,         20000000ULL },
+    { ACVP_DSA_KEYGEN,         1000000ULL },
+    { ACVP_DSA_SIGGEN,         1000000ULL },
+    { ACVP_KAS_IFC_SSC,        50000000ULL },
+    { ACVP_KTS_IFC,            50000000ULL },
+    { ACVP_SAFE_PRIMES_KEYGEN, 1000000ULL },
+    { ACVP_ECDSA_KEYGEN,       1000000ULL },
+    { ACVP_ECDSA_SIGGEN,       1000000ULL },
+    { ACVP_LMS_KEYGEN,         500000000ULL },
+    { ACVP_LMS_SIGGEN,         500000000ULL }
+};
 
-    return acvp_login(ctx, 1);
-}
+static unsigned long long int acvp_tc_cost(ACVP_CTX *ctx, ACVP_CIPHER cipher) {
+    size_t i = 0;
 
+    if (ctx->tc_cost[cipher]) {
+        return ctx->tc_cost[cipher];
+    }
+    for (i = 0; i < sizeof(acvp_tc_cost_tbl) / sizeof(acvp_tc_cost_tbl[0]); i++) {
+        if (acvp_tc_cost_tbl[i].cipher == cipher) {
+            return acvp_tc_cost_tbl[i].ns;
+        }
+    }
+    return ACVP_TC_COST_DEFAULT;
+}
 
 /*
- * This function will process a single KAT vector set.  Each KAT
- * vector set has an identifier associated with it, called
- * the vs_id.  During registration, libacvp will receive the
- * list of vs_id's that need to be processed during the test
- * session.  This routine will execute the test flow for a single
- * vs_id.  The flow is:
- *    a) Download the KAT vector set from the server using the vs_id
- *    b) Parse the KAT vectors
- *    c) Process each test case in the KAT vector set
- *    d) Generate the response data
- *    e) Send the response data back to the ACVP server
+ * Estimates the nanoseconds the vector set vs_obj takes to process, from the
+ * shape of each of its test groups. 0 if its cipher is not known.
  */
-static ACVP_RESULT acvp_process_vsid(ACVP_CTX *ctx, char *vsid_url, int count) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    JSON_Value *val = NULL;
-    JSON_Value *alg_val = NULL;
-    JSON_Array *alg_array = NULL;
-    JSON_Array *url_arr = NULL;
-    JSON_Value *ts_val = NULL;
-    JSON_Object *ts_obj = NULL;
-    JSON_Object *obj = NULL;
-    ACVP_STRING_LIST *vs_entry = NULL;
-    int retry_period = 0;
-    int retry = 1;
-    unsigned int time_waited_so_far = 0;
-    while (retry) {
-        /*
-         * Get the KAT vector set
-         */
-        rv = acvp_retrieve_vector_set(ctx, vsid_url);
-        if (rv != ACVP_SUCCESS) goto end;
+static double acvp_vs_cost(ACVP_CTX *ctx, JSON_Object *vs_obj) {
+    const ACVP_ALG_HANDLER *entry = NULL;
+    ACVP_CIPHER cipher = ACVP_CIPHER_START;
+    JSON_Array *groups = NULL;
+    JSON_Object *group = NULL;
+    const char *test_type = NULL;
+    double cost = 0, tc_cost = 0, bits = 0;
+    unsigned long long int iters = 0, base = 0;
+    size_t tests = 0;
+    int i = 0, count = 0, diff = 1;
+
+    entry = acvp_lookup_alg_handler(json_object_get_string(vs_obj, "algorithm"),
+                                    json_object_get_string(vs_obj, "mode"));
+    if (!entry) {
+        return 0;
+    }
+    cipher = entry->cipher;
+    if (cipher >= ACVP_TDES_ECB && cipher <= ACVP_TDES_KW) {
+        iters = (unsigned long long int)ACVP_DES_MCT_OUTER * ACVP_DES_MCT_INNER;
+    } else {
+        iters = (unsigned long long int)ACVP_AES_MCT_OUTER * ACVP_AES_MCT_INNER;
+    }
 
-        val = json_parse_string(ctx->curl_buf);
-        if (!val) {
-            ACVP_LOG_ERR("JSON parse error");
-            rv = ACVP_JSON_ERR;
-            goto end;
-        }
-        obj = acvp_get_obj_from_rsp(ctx, val);
+    base = acvp_tc_cost(ctx, cipher);
 
-        /*
-         * Check if we received a retry response
-         */
-        retry_period = (int) json_object_get_number(obj, "retry");
-        if (retry_period) {
-            /*
-             * Wait and try again to retrieve the VectorSet
-             */
-            if (acvp_retry_handler(ctx, &retry_period, &time_waited_so_far, 1, ACVP_WAITING_FOR_TESTS) != ACVP_KAT_DOWNLOAD_RETRY) {
-                ACVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", ACVP_MAX_WAIT_TIME);
-                rv = ACVP_TRANSPORT_FAIL;
-                goto end;
-            };
-            retry = 1;
+    groups = json_object_get_array(vs_obj, "testGroups");
+    count = (int)json_array_get_count(groups);
+    for (i = 0; i < count; i++) {
+        group = json_array_get_object(groups, i);
+        test_type = json_object_get_string(group, "testType");
+        tc_cost = (double)base;
+        diff = 1;
+        if (test_type) strcmp_s("MCT", 3, test_type, &diff);
+        if (!diff) {
+            tc_cost = (double)(iters * ACVP_TC_COST_MCT_ITER);
         } else {
-            /*
-             * Save the KAT VectorSet to file
-             */
-            if (ctx->vector_req) {
-                
-                ACVP_LOG_STATUS("Saving vector set %s to file...", vsid_url);
-                alg_array = json_value_get_array(val);
-                alg_val = json_array_get_value(alg_array, 1);
-
-                /* track first vector set with file count */
-                if (count == 0) {
-                    ts_val = json_value_init_object();
-                    ts_obj = json_value_get_object(ts_val);
-
-                    json_object_set_string(ts_obj, "jwt", ctx->jwt_token);
-                    json_object_set_string(ts_obj, "url", ctx->session_url);
-                    json_object_set_boolean(ts_obj, "isSample", ctx->is_sample);
-
-                    json_object_set_value(ts_obj, "vectorSetUrls", json_value_init_array());
-                    url_arr = json_object_get_array(ts_obj, "vectorSetUrls");
-
-                    vs_entry = ctx->vsid_url_list;
-                    while (vs_entry) {
-                        json_array_append_string(url_arr, vs_entry->string);
-                        vs_entry = vs_entry->next;
-                    }
-                    /* Start with identifiers */
-                    rv = acvp_json_serialize_to_file_pretty_w(ts_val, ctx->vector_req_file);
-                    if (rv != ACVP_SUCCESS) {
-                        ACVP_LOG_ERR("File write error");
-                        json_value_free(ts_val);
-                        goto end;
-                    }
-                } 
-                /* append vector set */
-                rv = acvp_json_serialize_to_file_pretty_a(alg_val, ctx->vector_req_file);
-                json_value_free(ts_val);
-                goto end;
+            bits = json_object_get_number(group, "modulo");
+            if (bits <= 0) bits = json_object_get_number(group, "l");
+            if (bits > ACVP_TC_COST_MODULUS) {
+                bits /= ACVP_TC_COST_MODULUS;
+                tc_cost *= bits * bits * bits;
             }
-            /*
-             * Process the KAT VectorSet
-             */
-            rv = acvp_process_vector_set(ctx, obj);
-            json_value_free(ts_val);
-            retry = 0;
         }
-
-        if (rv != ACVP_SUCCESS) goto end;
-        json_value_free(val);
-        val = NULL;
+        tests = json_array_get_count(json_object_get_array(group, "tests"));
+        cost += tc_cost * (double)tests;
     }
-
-    /*
-     * Send the responses to the ACVP server
-     */
-    ACVP_LOG_STATUS("Posting vector set responses for vsId %d...", ctx->vs_id);
-    rv = acvp_submit_vector_responses(ctx, vsid_url);
-
-end:
-    if (val) json_value_free(val);
-    return rv;
+    return cost;
 }
 
 /*
- * This function is used to invoke the appropriate handler function
- * for a given ACV operation.  The operation is specified in the
- * KAT vector set that was previously downloaded.  The handler function
- * is looked up in the alg_tbl[] and invoked here.
+ * What a vector set is expected to hold, for acvp_estimate_vector_sets(),
+ * which has only the registration to go on: the server decides the test
+ * groups and how many test cases each has.
  */
-static ACVP_RESULT acvp_dispatch_vector_set(ACVP_CTX *ctx, JSON_Object *obj) {
-    int i;
-    const char *err = json_object_get_string(obj, "error");
-    const char *alg = json_object_get_string(obj, "algorithm");
-    const char *mode = json_object_get_string(obj, "mode");
-    int vs_id = (int) json_object_get_number(obj, "vsId");
-    int diff = 1;
+#define ACVP_EST_GROUP_TCS 25        /* Test cases of a test group */
+#define ACVP_EST_VS_TCS 100          /* Test cases of a vector set with no known groups */
+#define ACVP_EST_TC_BYTES 2048       /* Held per test case: request, parsed JSON and response */
+#define ACVP_EST_MCT_RESULT_BYTES 256 /* Held per outer iteration of a Monte Carlo test */
+#define ACVP_TC_COST_LDT_GIB 2000000000ULL /* Hashing a GiB of a large data test */
+#define ACVP_TC_COST_PBKDF_ITER 1000ULL    /* Each PBKDF iteration */
+
+static int acvp_est_sl_count(ACVP_SL_LIST *list) {
+    int count = 0;
 
-    ctx->vs_id = vs_id;
-    ACVP_RESULT rv;
+    for (; list; list = list->next) count++;
+    return count ? count : 1;
+}
 
-    if (err) {
-        ACVP_LOG_ERR("ACVP Server error detected -- An algorithm may have been skipped during vector generation.  Please manually check the file.");
-        return ACVP_NO_DATA;
+static int acvp_est_param_count(ACVP_PARAM_LIST *list) {
+    int count = 0;
+
+    for (; list; list = list->next) count++;
+    return count ? count : 1;
+}
+
+static int acvp_est_has_mct(ACVP_CIPHER cipher) {
+    switch (acvp_get_aes_alg(cipher)) {
+    case ACVP_SUB_AES_ECB:
+    case ACVP_SUB_AES_CBC:
+    case ACVP_SUB_AES_CFB1:
+    case ACVP_SUB_AES_CFB8:
+    case ACVP_SUB_AES_CFB128:
+    case ACVP_SUB_AES_OFB:
+        return 1;
+    case ACVP_SUB_AES_GCM:
+    case ACVP_SUB_AES_GCM_SIV:
+    case ACVP_SUB_AES_CCM:
+    case ACVP_SUB_AES_CBC_CS1:
+    case ACVP_SUB_AES_CBC_CS2:
+    case ACVP_SUB_AES_CBC_CS3:
+    case ACVP_SUB_AES_CTR:
+    case ACVP_SUB_AES_XTS:
+    case ACVP_SUB_AES_XPN:
+    case ACVP_SUB_AES_KW:
+    case ACVP_SUB_AES_KWP:
+    case ACVP_SUB_AES_GMAC:
+        return 0;
+    default:
+        break;
     }
 
-    if (!alg) {
-        ACVP_LOG_ERR("JSON parse error: ACV algorithm not found");
-        return ACVP_JSON_ERR;
+    switch (acvp_get_tdes_alg(cipher)) {
+    case ACVP_SUB_TDES_ECB:
+    case ACVP_SUB_TDES_CBC:
+    case ACVP_SUB_TDES_CBCI:
+    case ACVP_SUB_TDES_OFB:
+    case ACVP_SUB_TDES_OFBI:
+    case ACVP_SUB_TDES_CFB1:
+    case ACVP_SUB_TDES_CFB8:
+    case ACVP_SUB_TDES_CFB64:
+    case ACVP_SUB_TDES_CFBP1:
+    case ACVP_SUB_TDES_CFBP8:
+    case ACVP_SUB_TDES_CFBP64:
+        return 1;
+    case ACVP_SUB_TDES_CTR:
+    case ACVP_SUB_TDES_KW:
+        return 0;
+    default:
+        return cipher >= ACVP_HASH_SHA1 && cipher <= ACVP_HASH_SHAKE_256;
     }
+}
 
-    ACVP_LOG_STATUS("Processing vector set: %d", vs_id);
-    ACVP_LOG_STATUS("Algorithm: %s", alg);
-    if (mode) {
-        ACVP_LOG_STATUS("Mode: %s", mode);
+/* tc_cost scaled with the cube of the modulus, as in acvp_vs_cost() */
+static double acvp_est_modulus_cost(double tc_cost, unsigned int modulo) {
+    double bits = (double)modulo;
+
+    if (bits > ACVP_TC_COST_MODULUS) {
+        bits /= ACVP_TC_COST_MODULUS;
+        tc_cost *= bits * bits * bits;
     }
-    for (i = 0; i < ACVP_ALG_MAX; i++) {
-        strcmp_s(alg_tbl[i].name,
-                 ACVP_ALG_NAME_MAX,
-                 alg, &diff);
-        if (!diff) {
-            if (mode == NULL || alg_tbl[i].cipher == ACVP_KDF108) { // KDF108-KMAC has a mode!
-                rv = (alg_tbl[i].handler)(ctx, obj);
-                return rv;
-            }
+    return tc_cost;
+}
 
-            if (alg_tbl[i].mode != NULL) {
-                strcmp_s(alg_tbl[i].mode,
-                        ACVP_ALG_MODE_MAX,
-                        mode, &diff);
-                if (!diff) {
-                    rv = (alg_tbl[i].handler)(ctx, obj);
-                    return rv;
-                }
+/* Adds a test group for each modulus of modes, and for each hash of it with per_hash */
+static void acvp_est_rsa_modes(ACVP_VS_ESTIMATE *est, double tc_cost,
+                               ACVP_RSA_MODE_CAPS_LIST *modes, int per_hash) {
+    ACVP_RSA_HASH_PAIR_LIST *pair = NULL;
+    int groups = 0;
+
+    for (; modes; modes = modes->next) {
+        groups = 1;
+        if (per_hash) {
+            if (modes->hash_pair) {
+                for (groups = 0, pair = modes->hash_pair; pair; pair = pair->next) groups++;
+            } else {
+                groups = acvp_est_param_count(modes->hash_algs);
             }
         }
+        est->test_cases += groups * ACVP_EST_GROUP_TCS;
+        est->ns += (unsigned long long int)(acvp_est_modulus_cost(tc_cost, modes->modulo) *
+                                            groups * ACVP_EST_GROUP_TCS);
+        est->bytes += (size_t)groups * ACVP_EST_GROUP_TCS * ACVP_EST_TC_BYTES *
+                      (modes->modulo > ACVP_TC_COST_MODULUS ? modes->modulo / ACVP_TC_COST_MODULUS : 1);
     }
+}
 
-    ACVP_LOG_ERR("Unsupported algorithm or mode requested");
-    return ACVP_UNSUPPORTED_OP;
+/*
+ * Estimates one vector set of the capability cap from what was registered:
+ * a test group for each key size (and direction) with MCT groups where the
+ * mode has them, one for each large data size of a hash, the modulus of
+ * RSA, the curves of ECDSA and the iteration counts of PBKDF.
+ */
+static void acvp_estimate_cap(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_VS_ESTIMATE *est) {
+    ACVP_SYM_CIPHER_CAP *sym = NULL;
+    ACVP_RSA_KEYGEN_CAP *keygen = NULL;
+    ACVP_RSA_SIG_CAP *sig = NULL;
+    ACVP_CURVE_ALG_COMPAT_LIST *curve = NULL;
+    ACVP_JSON_DOMAIN_OBJ *domain = NULL;
+    ACVP_NAME_LIST *alg = NULL;
+    ACVP_SL_LIST *sl = NULL;
+    unsigned long long int tc_cost = acvp_tc_cost(ctx, cap->cipher);
+    unsigned long long int iters = 0, outer = 0;
+    int groups = 1, count = 0;
+
+    memzero_s(est, sizeof(ACVP_VS_ESTIMATE));
+    est->cipher = cap->cipher;
+    est->algorithm = acvp_lookup_cipher_name(cap->cipher);
+    est->mode = acvp_lookup_cipher_mode_str(cap->cipher);
+
+    switch (cap->cap_type) {
+    case ACVP_SYM_TYPE:
+        sym = cap->cap.sym_cap;
+        groups = acvp_est_sl_count(sym->keylen);
+        if (sym->direction == ACVP_SYM_CIPH_DIR_BOTH) groups *= 2;
+        est->test_cases = groups * ACVP_EST_GROUP_TCS;
+        est->ns = tc_cost * est->test_cases;
+        est->bytes = (size_t)est->test_cases * ACVP_EST_TC_BYTES;
+        if (acvp_est_has_mct(cap->cipher)) {
+            if (cap->cipher >= ACVP_TDES_ECB && cap->cipher <= ACVP_TDES_KW) {
+                outer = ACVP_DES_MCT_OUTER;
+                iters = outer * ACVP_DES_MCT_INNER;
+            } else {
+                outer = ACVP_AES_MCT_OUTER;
+                iters = outer * ACVP_AES_MCT_INNER;
+            }
+            /* One test case per group */
+            est->test_cases += groups;
+            est->ns += iters * ACVP_TC_COST_MCT_ITER * groups;
+            est->bytes += (size_t)(outer * ACVP_EST_MCT_RESULT_BYTES) * groups;
+        }
+        break;
+    case ACVP_HASH_TYPE:
+        est->test_cases = ACVP_EST_GROUP_TCS + 1;
+        outer = ACVP_HASH_MCT_OUTER;
+        est->ns = tc_cost * ACVP_EST_GROUP_TCS + outer * ACVP_HASH_MCT_INNER * ACVP_TC_COST_MCT_ITER;
+        est->bytes = (size_t)ACVP_EST_GROUP_TCS * ACVP_EST_TC_BYTES + outer * ACVP_EST_MCT_RESULT_BYTES;
+        for (sl = cap->cap.hash_cap->large_lens; sl; sl = sl->next) {
+            est->test_cases++;
+            est->ns += (unsigned long long int)sl->length * ACVP_TC_COST_LDT_GIB;
+            est->bytes += ACVP_EST_TC_BYTES;
+        }
+        break;
+    case ACVP_RSA_KEYGEN_TYPE:
+        for (keygen = cap->cap.rsa_keygen_cap; keygen; keygen = keygen->next) {
+            acvp_est_rsa_modes(est, (double)tc_cost, keygen->mode_capabilities, 0);
+        }
+        break;
+    case ACVP_RSA_SIGGEN_TYPE:
+    case ACVP_RSA_SIGVER_TYPE:
+        for (sig = cap->cap.rsa_siggen_cap; sig; sig = sig->next) {
+            acvp_est_rsa_modes(est, (double)tc_cost, sig->mode_capabilities, 1);
+        }
+        break;
+    case ACVP_ECDSA_KEYGEN_TYPE:
+    case ACVP_ECDSA_KEYVER_TYPE:
+    case ACVP_ECDSA_SIGGEN_TYPE:
+    case ACVP_ECDSA_SIGVER_TYPE:
+    case ACVP_DET_ECDSA_SIGGEN_TYPE:
+        for (curve = cap->cap.ecdsa_keygen_cap->curves; curve; curve = curve->next) count++;
+        groups = count ? count : 1;
+        est->test_cases = groups * ACVP_EST_GROUP_TCS;
+        est->ns = tc_cost * est->test_cases;
+        est->bytes = (size_t)est->test_cases * ACVP_EST_TC_BYTES;
+        break;
+    case ACVP_PBKDF_TYPE:
+        domain = &cap->cap.pbkdf_cap->iteration_count_domain;
+        if (domain->values) {
+            for (sl = domain->values; sl; sl = sl->next, count++) iters += (unsigned long long int)sl->length;
+            iters /= (unsigned long long int)count;
+        } else if (domain->max > 0) {
+            iters = ((unsigned long long int)domain->min + (unsigned long long int)domain->max) / 2;
+        }
+        for (count = 0, alg = cap->cap.pbkdf_cap->hmac_algs; alg; alg = alg->next) count++;
+        groups = count ? count : 1;
+        est->test_cases = groups * ACVP_EST_GROUP_TCS;
+        est->ns = (tc_cost + iters * ACVP_TC_COST_PBKDF_ITER) * est->test_cases;
+        est->bytes = (size_t)est->test_cases * ACVP_EST_TC_BYTES;
+        break;
+    case ACVP_DRBG_TYPE:
+    case ACVP_HMAC_TYPE:
+    case ACVP_CMAC_TYPE:
+    case ACVP_KMAC_TYPE:
+    case ACVP_RSA_PRIM_TYPE:
+    case ACVP_EDDSA_KEYGEN_TYPE:
+    case ACVP_EDDSA_KEYVER_TYPE:
+    case ACVP_EDDSA_SIGGEN_TYPE:
+    case ACVP_EDDSA_SIGVER_TYPE:
+    case ACVP_DSA_TYPE:
+    case ACVP_KDF135_SNMP_TYPE:
+    case ACVP_KDF135_SSH_TYPE:
+    case ACVP_KDF135_SRTP_TYPE:
+    case ACVP_KDF135_IKEV2_TYPE:
+    case ACVP_KDF135_IKEV1_TYPE:
+    case ACVP_KDF135_X942_TYPE:
+    case ACVP_KDF135_X963_TYPE:
+    case ACVP_KDF135_TPM_TYPE:
+    case ACVP_KDF108_TYPE:
+    case ACVP_KDF_TLS12_TYPE:
+    case ACVP_KDF_TLS13_TYPE:
+    case ACVP_KAS_ECC_CDH_TYPE:
+    case ACVP_KAS_ECC_COMP_TYPE:
+    case ACVP_KAS_ECC_NOCOMP_TYPE:
+    case ACVP_KAS_ECC_SSC_TYPE:
+    case ACVP_KAS_FFC_COMP_TYPE:
+    case ACVP_KAS_FFC_SSC_TYPE:
+    case ACVP_KAS_FFC_NOCOMP_TYPE:
+    case ACVP_KAS_IFC_TYPE:
+    case ACVP_KDA_ONESTEP_TYPE:
+    case ACVP_KDA_TWOSTEP_TYPE:
+    case ACVP_KDA_HKDF_TYPE:
+    case ACVP_KTS_IFC_TYPE:
+    case ACVP_SAFE_PRIMES_KEYGEN_TYPE:
+    case ACVP_SAFE_PRIMES_KEYVER_TYPE:
+    case ACVP_LMS_KEYGEN_TYPE:
+    case ACVP_LMS_SIGGEN_TYPE:
+    case ACVP_LMS_SIGVER_TYPE:
+    default:
+        est->test_cases = ACVP_EST_VS_TCS;
+        est->ns = tc_cost * ACVP_EST_VS_TCS;
+        est->bytes = (size_t)ACVP_EST_VS_TCS * ACVP_EST_TC_BYTES;
+        break;
+    }
 }
 
 /*
- * This function is used to process the test cases for
- * a given KAT vector set.  This is invoked after the
- * KAT vector set has been downloaded from the server.  The
- * vectors are stored on the ACVP_CTX in one of the
- * transitory fields.  Therefore, the vs_id isn't needed
- * here to know which vectors need to be processed.
- *
- * The processing logic is:
- *    a) JSON parse the data
- *    b) Identify the ACVP operation to be performed (e.g. AES encrypt)
- *    c) Dispatch the vectors to the handler for the
- *       specified ACVP operation.
+ * The number of vector sets cap is expected to generate, as counted for
+ * acvp_get_vector_set_count()
  */
-static ACVP_RESULT acvp_process_vector_set(ACVP_CTX *ctx, JSON_Object *obj) {
-    ACVP_RESULT rv;
+static int acvp_est_cap_sets(ACVP_CAPS_LIST *cap) {
+    if (cap->cap_type == ACVP_SYM_TYPE) {
+        return cap->cap.sym_cap->ivgen_source == ACVP_SYM_CIPH_IVGEN_SRC_EITHER ? 2 : 1;
+    }
+    if (cap->cap_type == ACVP_ECDSA_SIGGEN_TYPE || cap->cap_type == ACVP_ECDSA_SIGVER_TYPE ||
+        cap->cap_type == ACVP_DET_ECDSA_SIGGEN_TYPE) {
+        return cap->cap.ecdsa_siggen_cap->component == ACVP_ECDSA_COMPONENT_MODE_BOTH ? 2 : 1;
+    }
+    return 1;
+}
 
-    rv = acvp_dispatch_vector_set(ctx, obj);
-    if (rv != ACVP_SUCCESS) {
-        return rv;
+/* Longest first, then in registration order */
+static int acvp_est_cmp(const void *a, const void *b) {
+    const ACVP_VS_ESTIMATE *x = *(const ACVP_VS_ESTIMATE *const *)a;
+    const ACVP_VS_ESTIMATE *y = *(const ACVP_VS_ESTIMATE *const *)b;
+
+    if (x->ns != y->ns) {
+        return x->ns < y->ns ? 1 : -1;
     }
+    return x < y ? -1 : (x > y);
+}
 
-    ACVP_LOG_STATUS("Successfully processed vector set");
-    return ACVP_SUCCESS;
+ACVP_RESULT acvp_estimate_vector_sets(ACVP_CTX *ctx, int parallel, ACVP_VS_ESTIMATE *est, int max,
+                                      int *count, ACVP_RUN_ESTIMATE *run) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_VS_ESTIMATE *all = NULL, **order = NULL;
+    unsigned long long int *load = NULL;
+    unsigned long long int end = 0;
+    size_t bytes = 0;
+    int n = 0, i = 0, j = 0, w = 0, last = 0;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!count || (!est && max) || max < 0 || parallel < 0 || parallel > ACVP_MAX_PARALLEL_VS) {
+        return ACVP_INVALID_ARG;
+    }
+    if (!parallel) {
+        parallel = ctx->max_parallel_vs > 0 ? ctx->max_parallel_vs : 1;
+    }
+    *count = 0;
+    if (run) {
+        memzero_s(run, sizeof(ACVP_RUN_ESTIMATE));
+    }
+
+    for (cap = ctx->caps_list; cap; cap = cap->next) {
+        n += acvp_est_cap_sets(cap);
+    }
+    if (!n) {
+        return ACVP_SUCCESS;
+    }
+
+    all = calloc((size_t)n, sizeof(ACVP_VS_ESTIMATE));
+    order = calloc((size_t)n, sizeof(ACVP_VS_ESTIMATE *));
+    load = calloc((size_t)parallel, sizeof(unsigned long long int));
+    if (!all || !order || !load) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    for (i = 0, cap = ctx->caps_list; cap; cap = cap->next) {
+        acvp_estimate_cap(ctx, cap, &all[i]);
+        /* The second vector set of a pair is like the first */
+        for (j = acvp_est_cap_sets(cap); j > 1; j--, i++) {
+            all[i + 1] = all[i];
+        }
+        i++;
+    }
+    for (i = 0; i < n; i++) {
+        order[i] = &all[i];
+    }
+
+    /*
+     * Longest first onto whichever worker frees up first, as the pool of
+     * acvp_run_vectors_from_file() orders them by acvp_vs_cost().
+     */
+    qsort(order, (size_t)n, sizeof(ACVP_VS_ESTIMATE *), acvp_est_cmp);
+    for (i = 0; i < n; i++) {
+        for (w = 0, j = 1; j < parallel; j++) {
+            if (load[j] < load[w]) w = j;
+        }
+        order[i]->worker = w;
+        order[i]->start_ns = load[w];
+        load[w] += order[i]->ns;
+        if (run) run->total_ns += order[i]->ns;
+    }
+    for (w = 1; w < parallel; w++) {
+        if (load[w] > load[last]) last = w;
+    }
+    for (i = 0; i < n; i++) {
+        all[i].critical = all[i].worker == last;
+    }
+
+    if (run) {
+        run->wall_ns = load[last];
+        run->parallel = parallel;
+        /* Most held at once: look as each vector set starts */
+        for (i = 0; i < n; i++) {
+            bytes = 0;
+            for (j = 0; j < n; j++) {
+                end = all[j].start_ns + all[j].ns;
+                if (all[j].start_ns <= all[i].start_ns && (end > all[i].start_ns || j == i)) {
+                    bytes += all[j].bytes;
+                }
+            }
+            if (bytes > run->peak_bytes) run->peak_bytes = bytes;
+        }
+    }
+
+    for (i = 0; i < n && i < max; i++) {
+        est[i] = all[i];
+    }
+    *count = n;
+
+end:
+    if (all) free(all);
+    if (order) free(order);
+    if (load) free(load);
+    return rv;
 }
 
 /*
- * This function will get the test results for a test session by checking the results of each vector set
+ * Called by a worker of an offline run once it has the responses of a vector
+ * set. The responses are parked on the job, like downloaded vector sets in
+ * acvp_pool_save_vector_set(), and queued in order on the writer of the
+ * response file, which acvp_rsp_file_begin() started.
  */
-static ACVP_RESULT acvp_get_result_test_session(ACVP_CTX *ctx, char *session_url) {
+static ACVP_RESULT acvp_pool_save_response(ACVP_CTX *ctx, int count) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    JSON_Value *val = NULL;
-    JSON_Value *val2 = NULL;
-    JSON_Object *obj = NULL;
-    JSON_Object *obj2 = NULL;
-    int count = 0, i = 0, passed = 0;
-    JSON_Array *results = NULL;
-    JSON_Object *current = NULL;
-    const char *status = NULL, *alg = NULL, *mode = NULL;
-    unsigned int time_waited_so_far = 0;
-    int retry_interval = ACVP_RETRY_TIME;
-    //Maintains a list of names of algorithms that have failed
-    ACVP_STRING_LIST *failedAlgList = NULL;
-    ACVP_STRING_LIST *failedModeList = NULL;
-    /*
-     * Maintains a list of the vector set URLs we have already looked up,
-     * so we don't redownload failed vector sets every time a retry is done
-     */
-     ACVP_STRING_LIST *failedVsList = NULL;
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    ACVP_VS_JOB *job = NULL;
+    JSON_Value *kat_val = NULL;
+    FILE *fp = NULL;
+    int len = 0;
 
-    while (1) {
-        int testsCompleted = 0;
+    if (ctx->exec.spill.count) {
+        /* Some of the responses are on disk, they wait there as a whole */
+        fp = acvp_spill_finish(ctx, 0, &len);
+        if (!fp) {
+            return ACVP_JSON_ERR;
+        }
+    }
 
-        /*
-         * Get the KAT vector set
-         */
-        rv = acvp_retrieve_vector_set_result(ctx, session_url);
+    acvp_mutex_lock(&pool->lock);
+    if (fp) {
+        pool->jobs[count].saved_fp = fp;
+    } else {
+        pool->jobs[count].saved = ctx->exec.kat_resp;
+        ctx->exec.kat_resp = NULL;
+    }
+
+    while (pool->next_save < pool->job_count) {
+        job = &pool->jobs[pool->next_save];
+        if (!job->saved && !job->saved_fp) {
+            break;
+        }
+        if (job->saved_fp) {
+            /* the writer closes it */
+            rv = acvp_spill_append(job->saved_fp, pool->rsp_writer);
+            job->saved_fp = NULL;
+        } else {
+            /* append the vector set responses, the array entry after the version */
+            kat_val = json_array_get_value(json_value_get_array(job->saved), 1);
+            rv = acvp_writer_json(pool->rsp_writer, ", ", kat_val, ctx->vector_rsp_compact);
+        }
+        if (job->saved) json_value_free(job->saved);
+        job->saved = NULL;
         if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("Error retrieving vector set results!");
-            goto end;
+            ACVP_LOG_ERR("File write error");
+            break;
         }
+        pool->next_save++;
+    }
 
-        val = json_parse_string(ctx->curl_buf);
-        if (!val) {
-            ACVP_LOG_ERR("Error while parsing json from server!");
-            rv = ACVP_JSON_ERR;
-            goto end;
-        }
-        obj = acvp_get_obj_from_rsp(ctx, val);
-        if (!obj) {
-            ACVP_LOG_ERR("Error while parsing json from server!");
-            rv = ACVP_JSON_ERR;
-            goto end;
+    acvp_mutex_unlock(&pool->lock);
+    return rv;
+}
+
+/*
+ * Processes a vector set of an offline run, read from the request file,
+ * and hands its responses over to be written to the response file.
+ */
+static ACVP_RESULT acvp_process_offline_vs(ACVP_CTX *ctx, ACVP_VS_JOB *job, int count) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Array *kat_array = NULL;
+    unsigned long long int start = 0;
+
+    /* Process the kat vector(s) */
+    rv = acvp_dispatch_vector_set(ctx, job->vs_obj);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("KAT dispatch error");
+        return rv;
+    }
+    ACVP_LOG_STATUS("Writing vector set responses for vector set %d...", ctx->exec.vs_id);
+
+    kat_array = json_value_get_array(ctx->exec.kat_resp);
+    if (!json_array_get_value(kat_array, 1)) {
+        ACVP_LOG_ERR("JSON val parse error");
+        return ACVP_JSON_ERR;
+    }
+
+    if (ctx->metrics_cb) start = acvp_metrics_now();
+    rv = acvp_pool_save_response(ctx, count);
+    acvp_metrics_add(ctx, ACVP_METRICS_SERIALIZE, start);
+    return rv;
+}
+
+/*
+ * Hands the responses of the vector set of the job at index over to the
+ * sender of the pool, serialized, so the worker can move on while they are
+ * posted. Waits while the sender queue is full. Anything but ACVP_SUCCESS
+ * leaves the responses with ctx, to be posted by the caller.
+ */
+static ACVP_RESULT acvp_pool_queue_upload(ACVP_CTX *ctx, int index) {
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    ACVP_VS_UPLOAD *upload = NULL;
+
+    upload = calloc(1, sizeof(ACVP_VS_UPLOAD));
+    if (!upload) {
+        return ACVP_MALLOC_FAIL;
+    }
+    upload->fp = acvp_serialize_vs_resp(ctx, &upload->len);
+    if (!upload->fp) {
+        free(upload);
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    /* The sender reports the vector set once it is posted */
+    acvp_metrics_tg_end(ctx);
+    upload->index = index;
+    upload->vs_id = ctx->exec.vs_id;
+    acvp_mem_metrics(ctx, &ctx->exec.vs_metrics);
+    upload->metrics = ctx->exec.vs_metrics;
+    upload->vs_start = ctx->exec.vs_start;
+    ctx->exec.vs_start = 0;
+    pool->jobs[index].uploading = 1;
+
+    acvp_mutex_lock(&pool->lock);
+    while (pool->upload_cnt >= ACVP_VS_UPLOAD_QUEUE_MAX) {
+        acvp_cond_wait(&pool->upload_cond, &pool->lock);
+    }
+    if (pool->uploads_tail) {
+        pool->uploads_tail->next = upload;
+    } else {
+        pool->uploads = upload;
+    }
+    pool->uploads_tail = upload;
+    pool->upload_cnt++;
+    acvp_cond_broadcast(&pool->upload_cond);
+    acvp_mutex_unlock(&pool->lock);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Records how the job at index went. A vector set the server was not ready
+ * to give us goes back into the pool; any other failure stops the pool.
+ */
+static void acvp_pool_job_done(ACVP_WORKER_POOL *pool, int index, ACVP_RESULT rv) {
+    ACVP_VS_JOB *job = &pool->jobs[index];
+
+    acvp_mutex_lock(&pool->lock);
+    job->in_progress = 0;
+    acvp_tc_sched_vs_end(&pool->sched);
+    if (rv != ACVP_KAT_DOWNLOAD_RETRY) {
+        job->rv = rv;
+        job->done = 1;
+        if (rv != ACVP_SUCCESS) {
+            pool->abort = 1;
         }
+    }
+    /* A vector set back in the pool may be read again */
+    acvp_cond_broadcast(&pool->read_cond);
+    acvp_mutex_unlock(&pool->lock);
+}
 
-        /*
-         * Check the results for each vector set - flag if some are incomplete,
-         * or name failed algorithms (even if others are still incomplete)
-         */
-        results = json_object_get_array(obj, "results");
-        count = (int)json_array_get_count(results);
-        for (i = 0; i < count; i++) {
-            int diff = 1;
-            current = json_array_get_object(results, i);
-            status = json_object_get_string(current, "status");
-            if (!status) {
-                goto end;
-            }
-            strcmp_s("expired", 7, status, &diff);
-            if (!diff) {
-                ACVP_LOG_ERR("One or more vector sets expired before results were submitted. Please start a new test session.");
-                goto end;
-            }
-            
-            strcmp_s("unreceived", 10, status, &diff);
-            if (!diff) {
-                ACVP_LOG_ERR("Missing submissions for one or more vector sets. Please submit responses for all vector sets.");
-                goto end;
+/*
+ * Processes the vector set of the job at index, handed out to ctx by
+ * acvp_pool_next_job().
+ */
+static void acvp_pool_run_job(ACVP_CTX *ctx, int index) {
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    ACVP_VS_JOB *job = &pool->jobs[index];
+    ACVP_MEM_ACCT *mem = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    mem = acvp_mem_enter(ctx);
+    acvp_metrics_vs_begin(ctx);
+    if (pool->rsp_filename) {
+        rv = acvp_process_offline_vs(ctx, job, index);
+    } else {
+        rv = acvp_process_vsid(ctx, job, index);
+    }
+    if (job->uploading) {
+        /* Finished by the sender once the responses are posted */
+        acvp_mem_leave(mem);
+        return;
+    }
+    if (rv != ACVP_KAT_DOWNLOAD_RETRY) {
+        acvp_metrics_vs_end(ctx);
+        acvp_event_vs_end(ctx, rv);
+        acvp_om_vs_done(ctx, rv);
+    }
+    acvp_mem_leave(mem);
+    if (rv != ACVP_SUCCESS && rv != ACVP_KAT_DOWNLOAD_RETRY) {
+        ACVP_LOG_ERR("Unable to process vector set %s! Error: %d", job->vsid_url, rv);
+    }
+    acvp_pool_job_done(pool, index, rv);
+}
+
+/*
+ * Posts the responses the workers of the pool queue, oldest first,
+ * and finishes their jobs. Runs with an exec context of its own
+ * until the workers are done and the queue is empty.
+ */
+static void acvp_vs_sender(void *arg) {
+    ACVP_CTX *ctx = (ACVP_CTX *)arg;
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    ACVP_VS_UPLOAD *upload = NULL;
+    ACVP_VS_JOB *job = NULL;
+    ACVP_MEM_ACCT *mem = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int index = 0;
+
+    while (1) {
+        acvp_mutex_lock(&pool->lock);
+        while (!pool->uploads && !pool->sender_stop) {
+            acvp_cond_wait(&pool->upload_cond, &pool->lock);
+        }
+        upload = pool->uploads;
+        if (upload) {
+            pool->uploads = upload->next;
+            if (!pool->uploads) {
+                pool->uploads_tail = NULL;
             }
-            /*
-             * If the result is incomplete, set the flag so it keeps retrying
-             */
-            strcmp_s("incomplete", 10, status, &diff);
-            if (!diff) {
-                continue;
+            pool->upload_cnt--;
+            acvp_cond_broadcast(&pool->upload_cond);
+        }
+        acvp_mutex_unlock(&pool->lock);
+        if (!upload) {
+            break;
+        }
+
+        index = upload->index;
+        job = &pool->jobs[index];
+        ctx->exec.vs_id = upload->vs_id;
+        ctx->exec.vs_metrics = upload->metrics;
+        ctx->exec.vs_start = upload->vs_start;
+        ctx->exec.vs_resp_fp = upload->fp;
+        ctx->exec.vs_resp_len = upload->len;
+        free(upload);
+
+        ACVP_LOG_STATUS("Posting vector set responses for vsId %d...", ctx->exec.vs_id);
+        mem = acvp_mem_enter(ctx);
+        rv = acvp_submit_vector_responses(ctx, job->vsid_url);
+        if (ctx->exec.vs_resp_fp) {
+            /* Not taken by a request */
+            fclose(ctx->exec.vs_resp_fp);
+            ctx->exec.vs_resp_fp = NULL;
+        }
+        acvp_metrics_vs_end(ctx);
+        acvp_event_vs_end(ctx, rv);
+        acvp_om_vs_done(ctx, rv);
+        acvp_mem_leave(mem);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Unable to process vector set %s! Error: %d", job->vsid_url, rv);
+        }
+        acvp_pool_job_done(pool, index, rv);
+    }
+}
+
+/*
+ * Picks the next vector set for the reader of the pool: the first one that
+ * no worker has started and that the server should have ready by now.
+ * Returns -1 if there is none, or if ACVP_VS_READ_QUEUE_MAX of them already
+ * wait for the workers. Must be called with the pool lock held.
+ */
+static int acvp_pool_next_read(ACVP_WORKER_POOL *pool) {
+    ACVP_VS_JOB *job = NULL;
+    time_t now = time(NULL);
+    int i = 0;
+
+    if (pool->abort || pool->read_cnt >= ACVP_VS_READ_QUEUE_MAX) {
+        return -1;
+    }
+    for (i = 0; i < pool->job_count; i++) {
+        job = &pool->jobs[i];
+        if (!job->done && !job->in_progress && !job->read.buf && !job->read_failed &&
+                job->next_try <= now) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Downloads the vector sets of the pool ahead of the workers and parses
+ * them, so a worker done with one vector set finds the next one ready
+ * rather than waiting on the server and the parser; with the senders posting
+ * the responses, the crypto module is kept busy. Vector sets large enough
+ * to be parsed a test group at a time are only downloaded. One the reader
+ * fails to download is left to its worker, which reports the error. Runs
+ * with an exec context of its own until the pool is stopped.
+ */
+static void acvp_vs_reader(void *arg) {
+    ACVP_CTX *ctx = (ACVP_CTX *)arg;
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    ACVP_VS_JOB *job = NULL;
+    ACVP_VS_READ read;
+    ACVP_MEM_ACCT *mem = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long int start = 0;
+    ACVP_SPAN span;
+    int index = 0;
+
+    mem = acvp_mem_enter(ctx);
+    acvp_mutex_lock(&pool->lock);
+    while (!pool->reader_stop) {
+        index = acvp_pool_next_read(pool);
+        if (index < 0) {
+            acvp_cond_wait(&pool->read_cond, &pool->lock);
+            continue;
+        }
+        job = &pool->jobs[index];
+        job->reading = 1;
+        acvp_mutex_unlock(&pool->lock);
+
+        memzero_s(&read, sizeof(ACVP_VS_READ));
+        acvp_metrics_vs_begin(ctx);
+        rv = ACVP_SUCCESS;
+        read.cached = acvp_vs_dl_cache_load(ctx, job->vsid_url);
+        if (!read.cached) {
+            rv = acvp_retrieve_vector_set(ctx, job->vsid_url);
+            if (rv == ACVP_SUCCESS) {
+                /* Before it is parsed in place */
+                acvp_vs_dl_cache_save(ctx, job->vsid_url);
             }
-            /*
-             * If the result is fail, retrieve vector set, get algorithm name, add to list
-             */
-            strcmp_s("fail", 4, status, &diff);
-            if (!diff) {
-                const char *vsurl = json_object_get_string(current, "vectorSetUrl");
-                if (!vsurl) {
-                    ACVP_LOG_ERR("No vector set URL when generating failed algorithm list");
-                    break;
-                }
-                if (!acvp_lookup_str_list(&failedVsList, vsurl)) {
-                    //append the vsurl to the list so we dont download/check same one twice
-                    rv = acvp_append_str_list(&failedVsList, vsurl);
-                    if (rv != ACVP_SUCCESS) {
-                        ACVP_LOG_ERR("Error appending failed algorithm name to list, skipping...");
-                        continue;
-                    }
-                    //retrieve_vector_set expects a non-const string
-                    char *vs_url = calloc(ACVP_REQUEST_STR_LEN_MAX + 1, sizeof(char));
-                    if (!vs_url) {
-                        ACVP_LOG_ERR("Unable to calloc when reporting failed algorithms, skipping...");
-                        continue;                    
-                    }
-                    strncpy_s(vs_url, ACVP_REQUEST_STR_LEN_MAX + 1, vsurl, ACVP_REQUEST_STR_LEN_MAX);
-                    rv = acvp_retrieve_vector_set(ctx, vs_url);
-                    free(vs_url);
-                    if (rv != ACVP_SUCCESS) {
-                        ACVP_LOG_ERR("Unable to retrieve vector set while reporting failed algorithms, skipping...");
-                        continue;
-                    }
+        }
+        if (rv == ACVP_SUCCESS && ctx->exec.curl_buf && ctx->exec.curl_read_ctr < ACVP_VS_LAZY_PARSE_MIN) {
+            if (ctx->metrics_cb) start = acvp_metrics_now();
+            acvp_span_begin(ctx, &span, ACVP_SPAN_PARSE);
+            span.bytes_in = ctx->exec.curl_read_ctr;
+            read.val = json_parse_string_in_situ(ctx->exec.curl_buf);
+            acvp_metrics_add(ctx, ACVP_METRICS_PARSE, start);
+            acvp_span_end(ctx, &span, read.val ? ACVP_SUCCESS : ACVP_JSON_ERR);
+            read.parsed = 1;
+        }
+        if (rv == ACVP_SUCCESS && ctx->exec.curl_buf) {
+            /* The download buffer goes to the worker, with the values parsed in it */
+            read.buf = ctx->exec.curl_buf;
+            read.len = ctx->exec.curl_read_ctr;
+            read.size = ctx->exec.curl_buf_size;
+            read.mapped = ctx->exec.curl_buf_mapped;
+            acvp_mem_credit(ctx->exec.mem, (size_t)read.size);
+            ctx->exec.curl_buf = NULL;
+            ctx->exec.curl_buf_size = 0;
+            ctx->exec.curl_buf_mapped = 0;
+            ctx->exec.curl_read_ctr = 0;
+            read.transport_ns = ctx->exec.vs_metrics.ns[ACVP_METRICS_TRANSPORT];
+            read.parse_ns = ctx->exec.vs_metrics.ns[ACVP_METRICS_PARSE];
+        } else {
+            ACVP_LOG_WARN("Unable to read vector set %s ahead, leaving it to its worker", job->vsid_url);
+            acvp_transport_release_buf(ctx);
+        }
 
-                    val2 = json_parse_string(ctx->curl_buf);
-                    if (!val2) {
-                        ACVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
-                        continue;
-                    }
-                    obj2 = acvp_get_obj_from_rsp(ctx, val2);
-                    if (!obj2) {
-                        json_value_free(val2);
-                        ACVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
-                        continue;
-                    }
-                    alg = json_object_get_string(obj2, "algorithm");
-                    if (!alg) {
-                        ACVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
-                        continue;
-                    }
-                    //Some algorithms have the same names, but different modes. Need to differentiate.
-                    if (json_object_get_string(obj2, "mode")) {
-                        mode = json_object_get_string(obj2, "mode");
-                    }
-                    if (!acvp_lookup_str_list(&failedAlgList, alg) || !acvp_lookup_str_list(&failedModeList, mode)) {
-                        rv = acvp_append_str_list(&failedAlgList, alg);
-                        if (rv != ACVP_SUCCESS) {
-                            ACVP_LOG_ERR("Error appending failed algorithm name to list, skipping...");
-                            continue;
-                        }
-                        if (mode) {
-                            rv = acvp_append_str_list(&failedModeList, mode);
-                        } else {
-                            //use empty node to keep mode and algorithm indexes aligned in lists
-                            rv = acvp_append_str_list(&failedModeList, "");
-                        }
-                        if (rv != ACVP_SUCCESS) {
-                            ACVP_LOG_ERR("Error appending failed mode name to list, skipping...");
-                            continue;
-                        }
-                        if (val2) json_value_free(val2);
-                        val2 = NULL;
-                    } else {
-                        if (val2) json_value_free(val2);
-                        val2 = NULL;
-                    }
+        acvp_mutex_lock(&pool->lock);
+        job->reading = 0;
+        if (read.buf) {
+            job->read = read;
+            pool->read_cnt++;
+        } else {
+            job->read_failed = 1;
+        }
+        acvp_cond_broadcast(&pool->read_cond);
+    }
+    acvp_mutex_unlock(&pool->lock);
+    acvp_mem_leave(mem);
+}
+
+/*
+ * Takes what the reader of the pool has of the vector set of job, waiting
+ * for it if the reader is downloading it. Returns 0 if it has nothing, and
+ * the worker gets the vector set itself. Otherwise the vector set is in the
+ * download buffer of ctx, and read says whether it was parsed and where
+ * from it came.
+ */
+static int acvp_pool_take_read(ACVP_CTX *ctx, ACVP_VS_JOB *job, ACVP_VS_READ *read) {
+    ACVP_WORKER_POOL *pool = ctx->pool;
+
+    acvp_mutex_lock(&pool->lock);
+    while (job->reading) {
+        acvp_cond_wait(&pool->read_cond, &pool->lock);
+    }
+    *read = job->read;
+    if (read->buf) {
+        memzero_s(&job->read, sizeof(ACVP_VS_READ));
+        pool->read_cnt--;
+        acvp_cond_broadcast(&pool->read_cond);
+    }
+    acvp_mutex_unlock(&pool->lock);
+    if (!read->buf) {
+        return 0;
+    }
+
+    acvp_transport_release_buf(ctx);
+    ctx->exec.curl_buf = read->buf;
+    ctx->exec.curl_buf_size = read->size;
+    ctx->exec.curl_buf_mapped = read->mapped;
+    ctx->exec.curl_read_ctr = read->len;
+    acvp_mem_charge(ctx->exec.mem, (size_t)read->size);
+    if (ctx->metrics_cb) {
+        ctx->exec.vs_metrics.ns[ACVP_METRICS_TRANSPORT] += read->transport_ns;
+        ctx->exec.vs_metrics.ns[ACVP_METRICS_PARSE] += read->parse_ns;
+    }
+    return 1;
+}
+
+/*
+ * Works through the vector sets of the pool until none are left. A vector set
+ * the server is not ready to give us yet goes back into the pool with the
+ * time it is expected to be ready, and the worker moves on to another one.
+ * With none left to start, it helps the other workers through the test cases
+ * of their vector sets until one of them is done.
+ */
+static void acvp_vs_worker(void *arg) {
+    ACVP_CTX *ctx = (ACVP_CTX *)arg;
+    ACVP_WORKER_POOL *pool = ctx->pool;
+    int index = 0, wait = 0;
+
+    if (ctx->session) {
+        /* Started for the pool, so placed as the session has it */
+        ctx->exec.numa_node = acvp_worker_pin(ctx, 0);
+    }
+    while (1) {
+        acvp_mutex_lock(&pool->lock);
+        index = acvp_pool_next_job(pool, &wait);
+        acvp_mutex_unlock(&pool->lock);
+        if (index < 0) {
+            if (!wait) {
+                if (!acvp_tc_sched_steal(&pool->sched, ctx->exec.numa_node)) {
+                    break;
                 }
+                continue;
             }
-            testsCompleted++;
+            acvp_idle(ctx, wait);
+            continue;
         }
-        if (testsCompleted >= count) {
-            passed = json_object_get_boolean(obj, "passed");
-            if (passed == 1) {
-                /*
-                 * Pass, exit loop
-                 */
-                ACVP_LOG_STATUS("Passed all vectors in test session!");
-                ctx->session_passed = 1;
-                rv = ACVP_SUCCESS;
-                goto end;
-            } else {
-                 /*
-                  * Fail, continue with reporting results
-                  */
-                 ACVP_LOG_STATUS("Test session complete: some vectors failed, reporting results...");
-                 ACVP_LOG_STATUS("Note: Use verbose-level logging to see results of each test case");
-                 acvp_list_failing_algorithms(ctx, &failedAlgList, &failedModeList);
-             }
-        } else {
-              /*
-             * If any tests are incomplete, retry, even if some have failed
-             */
-            acvp_list_failing_algorithms(ctx, &failedAlgList, &failedModeList);
-            ACVP_LOG_STATUS("TestSession results incomplete...");
-            if (acvp_retry_handler(ctx, &retry_interval, &time_waited_so_far, 1, ACVP_WAITING_FOR_RESULTS) != ACVP_KAT_DOWNLOAD_RETRY) {
-                ACVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", ACVP_MAX_WAIT_TIME);
-                rv = ACVP_TRANSPORT_FAIL;
-                goto end;
+        acvp_pool_run_job(ctx, index);
+    }
+}
+
+/*
+ * Sets up the pool with a job for each of the first vs_cnt vector sets of
+ * the session, or for the vs_cnt of them at the positions listed in sel if
+ * it is set. See acvp_run_vector_sets() for reg_array and rsp_filename.
+ */
+static ACVP_RESULT acvp_pool_init(ACVP_CTX *ctx, ACVP_WORKER_POOL *pool, int vs_cnt,
+                                  JSON_Array *reg_array, const int *sel, const char *rsp_filename) {
+    ACVP_STRING_LIST *vs_entry = NULL;
+    int i = 0, j = 0;
+
+    memzero_s(pool, sizeof(ACVP_WORKER_POOL));
+    pool->jobs = calloc(vs_cnt, sizeof(ACVP_VS_JOB));
+    if (!pool->jobs) {
+        return ACVP_MALLOC_FAIL;
+    }
+    pool->job_count = vs_cnt;
+
+    vs_entry = ctx->vsid_url_list;
+    for (i = 0; j < vs_cnt && vs_entry; i++) {
+        if (!sel || sel[j] == i) {
+            pool->jobs[j].vsid_url = vs_entry->string;
+            if (rsp_filename) {
+                pool->jobs[j].vs_obj = json_array_get_object(reg_array, i + 1);
             }
+            j++;
+        }
+        vs_entry = vs_entry->next;
+    }
+    if (rsp_filename) {
+        pool->rsp_filename = rsp_filename;
+        pool->rsp_writer = ctx->rsp_writer;
+    }
+
+    acvp_mutex_init(&pool->lock);
+    acvp_cond_init(&pool->upload_cond);
+    acvp_cond_init(&pool->read_cond);
+    acvp_tc_sched_init(&pool->sched);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Returns the error of the first failed vector set, in list order
+ */
+static ACVP_RESULT acvp_pool_result(ACVP_WORKER_POOL *pool) {
+    int i = 0;
+
+    for (i = 0; i < pool->job_count; i++) {
+        if (pool->jobs[i].done && pool->jobs[i].rv != ACVP_SUCCESS) {
+            return pool->jobs[i].rv;
+        }
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Returns non-zero while a worker is processing a vector set of the pool.
+ * Must be called with the pool lock held.
+ */
+static int acvp_pool_busy(ACVP_WORKER_POOL *pool) {
+    int i = 0;
+
+    for (i = 0; i < pool->job_count; i++) {
+        if (pool->jobs[i].in_progress) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void acvp_pool_free(ACVP_WORKER_POOL *pool) {
+    ACVP_VS_UPLOAD *upload = NULL;
+    int i = 0;
+
+    if (!pool->jobs) {
+        return;
+    }
+    acvp_mutex_destroy(&pool->lock);
+    acvp_cond_destroy(&pool->upload_cond);
+    acvp_cond_destroy(&pool->read_cond);
+    acvp_tc_sched_destroy(&pool->sched);
+    while (pool->uploads) {
+        upload = pool->uploads;
+        pool->uploads = upload->next;
+        fclose(upload->fp);
+        free(upload);
+    }
+    for (i = 0; i < pool->job_count; i++) {
+        if (pool->jobs[i].saved) json_value_free(pool->jobs[i].saved);
+        if (pool->jobs[i].saved_fp) fclose(pool->jobs[i].saved_fp);
+        /* Read ahead and never taken; the values parsed in the buffer go first */
+        if (pool->jobs[i].read.val) json_value_free(pool->jobs[i].read.val);
+        acvp_big_free(pool->jobs[i].read.buf, (size_t)pool->jobs[i].read.size, pool->jobs[i].read.mapped);
+    }
+    free(pool->jobs);
+    memzero_s(pool, sizeof(ACVP_WORKER_POOL));
+}
+
+/*
+ * Starts up to count senders for the pool, see acvp_vs_sender(), and returns
+ * how many were started. If none can be, the workers post their responses
+ * themselves.
+ */
+static int acvp_pool_start_senders(ACVP_CTX *ctx, ACVP_WORKER_POOL *pool, int count,
+                                   ACVP_CTX **senders, ACVP_THREAD *threads) {
+    int started = 0;
+
+    for (started = 0; started < count; started++) {
+        senders[started] = acvp_create_exec_ctx(ctx);
+        if (!senders[started]) {
+            break;
+        }
+        senders[started]->pool = pool;
+        pool->sending = 1;
+        if (acvp_thread_create(&threads[started], acvp_vs_sender, senders[started]) != ACVP_SUCCESS) {
+            acvp_free_exec_ctx(senders[started]);
+            senders[started] = NULL;
+            break;
+        }
+    }
+    pool->sending = started > 0;
+    if (started < count) {
+        ACVP_LOG_WARN("Unable to start vector set sender %d, continuing with %d senders", started, started);
+    }
+    return started;
+}
+
+/*
+ * Waits for the senders to post what is left in the queue, once the workers
+ * are done
+ */
+static void acvp_pool_stop_senders(ACVP_WORKER_POOL *pool, int count, ACVP_CTX **senders, ACVP_THREAD *threads) {
+    int i = 0;
+
+    acvp_mutex_lock(&pool->lock);
+    pool->sender_stop = 1;
+    acvp_cond_broadcast(&pool->upload_cond);
+    acvp_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < count; i++) {
+        acvp_thread_join(threads[i]);
+        acvp_free_exec_ctx(senders[i]);
+    }
+    pool->sending = 0;
+}
+
+/*
+ * Starts the reader of the pool, see acvp_vs_reader(). Returns 0 if it can
+ * not be started, and the workers get their vector sets themselves.
+ */
+static int acvp_pool_start_reader(ACVP_CTX *ctx, ACVP_WORKER_POOL *pool, ACVP_CTX **reader, ACVP_THREAD *thread) {
+    *reader = acvp_create_exec_ctx(ctx);
+    if (*reader) {
+        (*reader)->pool = pool;
+        pool->reading = 1;
+        if (acvp_thread_create(thread, acvp_vs_reader, *reader) == ACVP_SUCCESS) {
+            return 1;
+        }
+        pool->reading = 0;
+        acvp_free_exec_ctx(*reader);
+        *reader = NULL;
+    }
+    ACVP_LOG_WARN("Unable to start the vector set reader, continuing without it");
+    return 0;
+}
+
+/*
+ * Stops the reader once the workers are done; what it read that no worker
+ * took is freed with the pool
+ */
+static void acvp_pool_stop_reader(ACVP_WORKER_POOL *pool, ACVP_CTX *reader, ACVP_THREAD thread) {
+    acvp_mutex_lock(&pool->lock);
+    pool->reader_stop = 1;
+    acvp_cond_broadcast(&pool->read_cond);
+    acvp_mutex_unlock(&pool->lock);
+
+    acvp_thread_join(thread);
+    acvp_free_exec_ctx(reader);
+    pool->reading = 0;
+}
+
+/*
+ * Processes the vector sets of the session. With max_parallel_vs above one
+ * they are shared among that many worker threads, otherwise the session
+ * context works through them on the calling thread. When the responses are
+ * posted to the server, that is done by a sender thread for each worker
+ * while the workers carry on with the vector sets after them, and a reader
+ * thread downloads and parses the vector sets ahead of the workers; the one
+ * worker is then an exec context on a thread of its own too, as a sender or
+ * the reader may refresh the JWT of the session context meanwhile. On failure the workers
+ * finish what they are doing, no new vector sets are started, and the error
+ * of the first failed vector set (in list order) is returned.
+ *
+ * For an offline run, rsp_filename is set and reg_array holds the contents
+ * of the request file: the session identifiers followed by the vector sets.
+ * If sel is set, only the vs_cnt vector sets at the (ascending) positions it
+ * lists are run. Otherwise the vector sets are fetched from the server.
+ */
+static ACVP_RESULT acvp_run_vector_sets(ACVP_CTX *ctx, int vs_cnt, JSON_Array *reg_array,
+                                        const int *sel, const char *rsp_filename) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    ACVP_WORKER_POOL pool;
+    ACVP_CTX **workers = NULL, **senders = NULL, *reader = NULL;
+    ACVP_THREAD *threads = NULL, *sender_threads = NULL, reader_thread;
+    int worker_cnt = 0, started = 0, sender_cnt = 0, reading = 0, i = 0;
+
+    worker_cnt = ctx->max_parallel_vs < vs_cnt ? ctx->max_parallel_vs : vs_cnt;
+    if (worker_cnt < 1) {
+        worker_cnt = 1;
+    }
+
+    rv = acvp_pool_init(ctx, &pool, vs_cnt, reg_array, sel, rsp_filename);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+    pool.worker_cnt = worker_cnt;
+    /* KeyGen keys are generated while the vector sets are fetched */
+    acvp_key_pool_prime(ctx);
+    if (rsp_filename && worker_cnt > 1) {
+        /* Longest first, so the slowest vector sets do not hold up the end of the run */
+        for (i = 0; i < vs_cnt; i++) {
+            pool.jobs[i].cost = acvp_vs_cost(ctx, pool.jobs[i].vs_obj);
+        }
+    }
+    if (!rsp_filename && !ctx->vector_req) {
+        senders = calloc(worker_cnt, sizeof(ACVP_CTX *));
+        sender_threads = calloc(worker_cnt, sizeof(ACVP_THREAD));
+        if (senders && sender_threads) {
+            sender_cnt = acvp_pool_start_senders(ctx, &pool, worker_cnt, senders, sender_threads);
+        }
+        if (!ctx->remote_dir) {
+            reading = acvp_pool_start_reader(ctx, &pool, &reader, &reader_thread);
+        }
+    }
+
+    if (worker_cnt == 1 && !sender_cnt && !reading) {
+        ctx->pool = &pool;
+        acvp_vs_worker(ctx);
+        ctx->pool = NULL;
+        started = 1;
+    } else {
+        workers = calloc(worker_cnt, sizeof(ACVP_CTX *));
+        threads = calloc(worker_cnt, sizeof(ACVP_THREAD));
+        if (!workers || !threads) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+
+        if (worker_cnt > 1) {
+            ACVP_LOG_STATUS("Processing %d vector sets using %d workers...", vs_cnt, worker_cnt);
+        }
+        for (i = 0; i < worker_cnt; i++) {
+            workers[i] = acvp_create_exec_ctx(ctx);
+            if (!workers[i]) {
+                ACVP_LOG_WARN("Unable to allocate worker %d, continuing with %d workers", i, started);
+                break;
+            }
+            workers[i]->pool = &pool;
+            workers[i]->exec.worker = i;
+            if (acvp_thread_create(&threads[i], acvp_vs_worker, workers[i]) != ACVP_SUCCESS) {
+                ACVP_LOG_WARN("Unable to start worker %d, continuing with %d workers", i, started);
+                acvp_free_exec_ctx(workers[i]);
+                workers[i] = NULL;
+                break;
+            }
+            started++;
+        }
+
+        for (i = 0; i < started; i++) {
+            acvp_thread_join(threads[i]);
+            acvp_free_exec_ctx(workers[i]);
+        }
+    }
+
+    if (!started) {
+        ACVP_LOG_ERR("Unable to start any vector set workers");
+        rv = ACVP_INTERNAL_ERR;
+        goto end;
+    }
+
+    if (reading) acvp_pool_stop_reader(&pool, reader, reader_thread);
+    reading = 0;
+    acvp_pool_stop_senders(&pool, sender_cnt, senders, sender_threads);
+    sender_cnt = 0;
+    rv = acvp_pool_result(&pool);
+
+end:
+    if (reading) acvp_pool_stop_reader(&pool, reader, reader_thread);
+    if (sender_cnt) acvp_pool_stop_senders(&pool, sender_cnt, senders, sender_threads);
+    acvp_pool_free(&pool);
+    if (workers) free(workers);
+    if (threads) free(threads);
+    if (senders) free(senders);
+    if (sender_threads) free(sender_threads);
+    return rv;
+}
+
+/*
+ * This function is used by the application after registration
+ * to commence the testing.  All the testing will be handled
+ * by libacvp.  This function will block the caller.  Therefore,
+ * it should be run on a separate thread if needed.
+ */
+ACVP_RESULT acvp_process_tests(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    ACVP_STRING_LIST *vs_entry = NULL;
+    int count = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    /*
+     * Iterate through the VS identifiers the server sent to us
+     * in the test session register response.  Process each vector set and
+     * return the results to the server.
+     */
+    vs_entry = ctx->vsid_url_list;
+    if (!vs_entry) {
+        return ACVP_MISSING_ARG;
+    }
+    while (vs_entry) {
+        vs_entry = vs_entry->next;
+        count++;
+    }
+
+    rv = acvp_run_vector_sets(ctx, count, NULL, NULL, NULL);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Unable to process vector set! Error: %d", rv);
+        return rv;
+    }
+    /* Need to add the ending ']' here */
+    if (ctx->vector_req) {
+        rv = acvp_close_vector_req_file(ctx);
+    }
+    return rv;
+}
+
+/*
+ * Works out how long to wait before asking the server again. This allows the
+ * server time to generate the vectors on behalf of the client and to process
+ * the vector responses. The caller of this function can choose to implement a
+ * retry backoff using 'modifier'. Additionally, this function will ensure that
+ * retry periods will sum to no longer than ACVP_MAX_WAIT_TIME. The wait itself
+ * is left to the caller, who gets the number of seconds in delay.
+ */
+static ACVP_RESULT acvp_retry_schedule(ACVP_CTX *ctx, int *retry_period, unsigned int *waited_so_far, int modifier, ACVP_WAITING_STATUS situation, int *delay) {
+    /* perform check at beginning of function call, so library can check one more time when max
+     * time is reached to see if server status has changed */
+    if (*waited_so_far >= ACVP_MAX_WAIT_TIME) {
+        return ACVP_TRANSPORT_FAIL;
+    }
+    
+    if (*waited_so_far + *retry_period > ACVP_MAX_WAIT_TIME) {
+        *retry_period = ACVP_MAX_WAIT_TIME - *waited_so_far;
+    }
+    if (*retry_period <= ACVP_RETRY_TIME_MIN || *retry_period > ACVP_RETRY_TIME_MAX) {
+        *retry_period = ACVP_RETRY_TIME_MAX;
+        ACVP_LOG_WARN("retry_period not found, using max retry period!");
+    }
+    if (situation == ACVP_WAITING_FOR_TESTS) {
+        ACVP_LOG_STATUS("Vector sets not yet ready, server requesting we wait %u seconds and try again...", *retry_period);
+    } else if (situation == ACVP_WAITING_FOR_RESULTS) {
+        ACVP_LOG_STATUS("Test results not yet ready, waiting %u seconds and trying again...", *retry_period);
+    } else {
+        ACVP_LOG_STATUS("Waiting %u seconds and trying again...", *retry_period);
+    }
+
+    *delay = *retry_period;
+    if (ctx->event_cb) {
+        ACVP_EVENT event;
+
+        memzero_s(&event, sizeof(ACVP_EVENT));
+        event.type = ACVP_EVENT_RETRY_WAIT;
+        event.wait_seconds = *delay;
+        acvp_event_emit(ctx, &event);
+    }
+    acvp_om_retry_wait(ctx, *delay);
+
+    /* ensure that all parameters are valid and that we do not wait longer than ACVP_MAX_WAIT_TIME */
+    if (modifier < 1 || modifier > ACVP_RETRY_MODIFIER_MAX) {
+        ACVP_LOG_WARN("retry modifier not valid, defaulting to 1 (no change)");
+        modifier = 1;
+    }
+    if ((*retry_period *= modifier) > ACVP_RETRY_TIME_MAX) {
+        *retry_period = ACVP_RETRY_TIME_MAX;
+    }
+
+    *waited_so_far += *retry_period;
+
+    return ACVP_KAT_DOWNLOAD_RETRY;
+}
+
+/*
+ * Non-zero while acvp_session_step() is taking a step of the session of ctx
+ */
+static int acvp_stepping(ACVP_CTX *ctx) {
+    return ctx->step && ctx->step->running;
+}
+
+/*
+ * This is a retry handler, which pauses for the time given by
+ * acvp_retry_schedule() before the caller asks the server again, handing
+ * the time to the idle callback if there is one. During a step of
+ * acvp_session_step() it only records the time, for the step to return.
+ */
+static ACVP_RESULT acvp_retry_handler(ACVP_CTX *ctx, int *retry_period, unsigned int *waited_so_far, int modifier, ACVP_WAITING_STATUS situation) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int delay = 0;
+
+    rv = acvp_retry_schedule(ctx, retry_period, waited_so_far, modifier, situation, &delay);
+    if (rv != ACVP_KAT_DOWNLOAD_RETRY) {
+        return rv;
+    }
+    if (acvp_stepping(ctx)) {
+        /* acvp_session_step() hands the wait back to the application */
+        ctx->step->wait = delay;
+        return rv;
+    }
+    acvp_idle(ctx, delay);
+    return rv;
+}
+
+/*
+ * This routine will iterate through all the vector sets, requesting
+ * the test result from the server for each set.
+ */
+ACVP_RESULT acvp_check_test_results(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    rv = acvp_get_result_test_session(ctx, ctx->session_url);
+    return rv;
+}
+
+/***************************************************************************************************************
+* Begin vector processing logic
+***************************************************************************************************************/
+
+static ACVP_RESULT acvp_login(ACVP_CTX *ctx, int refresh) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    char *login = NULL;
+    int login_len = 0;
+
+    ACVP_LOG_STATUS("Logging in...");
+    rv = acvp_build_login(ctx, &login, &login_len, refresh);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Unable to build login message");
+        goto end;
+    }
+
+    /*
+     * Send the login to the ACVP server and get the response,
+     */
+    rv = acvp_send_login(ctx, login, login_len);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Login Send Failed");
+        goto end;
+    }
+
+    rv = acvp_parse_login(ctx);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_STATUS("Login Response Failed, %d", rv);
+    } else {
+        ACVP_LOG_STATUS("Login successful");
+    }
+end:
+    if (refresh) {
+        acvp_om_jwt_refresh(ctx, rv);
+    }
+    if (login) free(login);
+    return rv;
+}
+
+/*
+ * Exec contexts never log in themselves. The session context refreshes the
+ * shared JWT (once, even if several exec contexts see it expire together) and
+ * the exec context takes a copy of the new token.
+ */
+static ACVP_RESULT acvp_refresh_from_session(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    ACVP_CTX *session = ctx->session;
+    int diff = 1;
+
+    acvp_mutex_lock(&session->session_lock);
+    if (ctx->jwt_token && session->jwt_token) {
+        strcmp_s(session->jwt_token, ACVP_JWT_TOKEN_MAX, ctx->jwt_token, &diff);
+    }
+    if (!diff) {
+        /* Nobody has refreshed the token this worker saw expire yet */
+        rv = acvp_login(session, 1);
+    }
+    if (rv == ACVP_SUCCESS && session->jwt_token) {
+        if (!ctx->jwt_token) {
+            ctx->jwt_token = calloc(ACVP_JWT_TOKEN_MAX + 1, sizeof(char));
+        }
+        if (!ctx->jwt_token) {
+            rv = ACVP_MALLOC_FAIL;
+        } else {
+            strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, session->jwt_token);
+            ctx->jwt_expiry = session->jwt_expiry;
+        }
+    }
+    acvp_mutex_unlock(&session->session_lock);
+    return rv;
+}
+
+ACVP_RESULT acvp_refresh(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    if (ctx->session) {
+        return acvp_refresh_from_session(ctx);
+    }
+    return acvp_login(ctx, 1);
+}
+
+
+/*
+ * This function will process a single KAT vector set.  Each KAT
+ * vector set has an identifier associated with it, called
+ * the vs_id.  During registration, libacvp will receive the
+ * list of vs_id's that need to be processed during the test
+ * session.  This routine will execute the test flow for a single
+ * vs_id.  The flow is:
+ *    a) Download the KAT vector set from the server using the vs_id
+ *    b) Parse the KAT vectors
+ *    c) Process each test case in the KAT vector set
+ *    d) Generate the response data
+ *    e) Send the response data back to the ACVP server
+ */
+/*
+ * Makes one attempt at a vector set: downloads it and, if the server has it
+ * ready, processes it and posts the responses (or saves it to file when only
+ * requesting vectors). If the server is still generating it, the time it is
+ * expected to be ready is recorded on the job and ACVP_KAT_DOWNLOAD_RETRY is
+ * returned so the caller can get on with other vector sets in the meantime.
+ */
+static ACVP_RESULT acvp_process_vsid(ACVP_CTX *ctx, ACVP_VS_JOB *job, int count) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *val = NULL;
+    JSON_Value *alg_val = NULL;
+    JSON_Array *alg_array = NULL;
+    JSON_Object *obj = NULL;
+    char *vsid_url = job->vsid_url;
+    double retry = 0;
+    int retry_period = 0;
+    int delay = 0;
+    int cached = 0, lazy = 0, arena = 0, ahead = 0;
+    unsigned long long int start = 0;
+    ACVP_VS_READ read;
+    ACVP_SPAN span;
+
+    /*
+     * Get the KAT vector set: from the reader of the pool if it got to it
+     * first, otherwise from the download cache if it has it
+     */
+    memzero_s(&read, sizeof(ACVP_VS_READ));
+    if (ctx->pool && ctx->pool->reading) {
+        ahead = acvp_pool_take_read(ctx, job, &read);
+    }
+    if (ahead) {
+        cached = read.cached;
+    } else {
+        cached = acvp_vs_dl_cache_load(ctx, vsid_url);
+        if (!cached) {
+            rv = acvp_retrieve_vector_set(ctx, vsid_url);
+            if (rv != ACVP_SUCCESS) goto end;
+            /* Before it is parsed in place */
+            acvp_vs_dl_cache_save(ctx, vsid_url);
+        }
+    }
+
+    /*
+     * A very large vector set is only parsed a test group at a time, as the
+     * KAT handler gets to it, see json_parse_string_lazy(), so the groups
+     * it is done with can be freed; they are not put in the arena then,
+     * nor are they with a memory budget, whose responses may be freed once
+     * they are moved to disk. Otherwise the vector set DOM and the responses
+     * built from it live in the JSON arena of this context until the
+     * responses have been sent. Vector sets saved to file or handed to a
+     * remote worker are written out whole, so they are parsed whole.
+     */
+    lazy = !ctx->vector_req && !ctx->remote_dir && ctx->exec.curl_read_ctr >= ACVP_VS_LAZY_PARSE_MIN;
+    arena = !lazy && !ctx->memory_budget;
+    if (arena) acvp_json_arena_begin(&ctx->exec.json_arena);
+    if (read.parsed) {
+        /* By the reader, on the heap */
+        val = read.val;
+    } else {
+        if (ctx->metrics_cb) start = acvp_metrics_now();
+        acvp_span_begin(ctx, &span, ACVP_SPAN_PARSE);
+        span.bytes_in = ctx->exec.curl_read_ctr;
+        /*
+         * Vector sets can be very large; their string values are left in the
+         * download buffer rather than copied, so it is kept until the parsed
+         * vector set is released.
+         */
+        val = lazy ? json_parse_string_lazy(ctx->exec.curl_buf) : json_parse_string_in_situ(ctx->exec.curl_buf);
+        acvp_metrics_add(ctx, ACVP_METRICS_PARSE, start);
+        acvp_span_end(ctx, &span, val ? ACVP_SUCCESS : ACVP_JSON_ERR);
+    }
+    if (!val) {
+        ACVP_LOG_ERR("JSON parse error");
+        if (!cached) acvp_vs_dl_cache_keep(ctx, vsid_url, 0);
+        rv = ACVP_JSON_ERR;
+        goto end;
+    }
+    obj = acvp_get_obj_from_rsp(ctx, val);
+
+    /*
+     * Check if we received a retry response
+     */
+    retry = json_object_get_number(obj, "retry");
+    retry_period = (int)retry;
+    if (!cached) {
+        /* Only the vector set itself is worth keeping */
+        acvp_vs_dl_cache_keep(ctx, vsid_url, !retry_period && json_object_get_value(obj, "vsId") &&
+                              !json_object_get_value(obj, "error"));
+    }
+    if (retry_period) {
+        /*
+         * Try again to retrieve the VectorSet once the server expects it to be ready
+         */
+        if (acvp_retry_schedule(ctx, &retry_period, &job->waited, 1, ACVP_WAITING_FOR_TESTS, &delay) != ACVP_KAT_DOWNLOAD_RETRY) {
+            ACVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", ACVP_MAX_WAIT_TIME);
+            rv = ACVP_TRANSPORT_FAIL;
+            goto end;
+        }
+        job->next_try = time(NULL) + delay;
+        rv = ACVP_KAT_DOWNLOAD_RETRY;
+        goto end;
+    }
+
+    /*
+     * Save the KAT VectorSet to file
+     */
+    if (ctx->vector_req) {
+        ACVP_LOG_STATUS("Saving vector set %s to file...", vsid_url);
+        alg_array = json_value_get_array(val);
+        alg_val = json_array_get_value(alg_array, 1);
+
+        /* A copy kept for writing out later has to outlive the arena */
+        acvp_json_arena_pause(1);
+        rv = acvp_pool_save_vector_set(ctx, alg_val, count);
+        acvp_json_arena_pause(0);
+        goto end;
+    }
+    /*
+     * Process the KAT VectorSet, or have a remote worker process it
+     */
+    if (ctx->remote_dir) {
+        rv = acvp_remote_ship(ctx, vsid_url, obj);
+    } else {
+        rv = acvp_process_vector_set(ctx, obj);
+    }
+    if (rv != ACVP_SUCCESS) goto end;
+    acvp_json_value_free(val);
+    val = NULL;
+    acvp_transport_release_buf(ctx);
+    if (ctx->remote_dir) {
+        rv = acvp_remote_wait(ctx);
+        if (rv != ACVP_SUCCESS) goto end;
+    }
+
+    /*
+     * Send the responses to the ACVP server, through the sender of the pool
+     * if it has one
+     */
+    if (ctx->pool && ctx->pool->sending && acvp_pool_queue_upload(ctx, count) == ACVP_SUCCESS) {
+        ACVP_LOG_STATUS("Queued vector set responses for vsId %d for posting", ctx->exec.vs_id);
+        goto end;
+    }
+    ACVP_LOG_STATUS("Posting vector set responses for vsId %d...", ctx->exec.vs_id);
+    rv = acvp_submit_vector_responses(ctx, vsid_url);
+
+end:
+    if (val) {
+        acvp_json_value_free(val);
+        acvp_transport_release_buf(ctx);
+    }
+    /* Responses left behind by a failed handler go with the arena */
+    if (ctx->exec.kat_resp) acvp_json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    acvp_spill_reset(ctx);
+    if (arena) acvp_json_arena_end();
+    return rv;
+}
+
+/*
+ * Runs the KAT handler of a vector set in a trace span of its own. The span
+ * of the last test group it started is closed with it.
+ */
+static ACVP_RESULT acvp_run_kat_handler(ACVP_CTX *ctx, const ACVP_ALG_HANDLER *entry, JSON_Object *obj) {
+    ACVP_SPAN span;
+    ACVP_RESULT rv;
+
+    acvp_span_begin(ctx, &span, ACVP_SPAN_KAT_HANDLER);
+    span.algorithm = entry->name;
+    span.mode = entry->mode;
+    rv = (entry->handler)(ctx, obj);
+    acvp_span_tg_end(ctx);
+    acvp_span_end(ctx, &span, rv);
+    return rv;
+}
+
+/*
+ * This function is used to invoke the appropriate handler function
+ * for a given ACV operation.  The operation is specified in the
+ * KAT vector set that was previously downloaded.  The handler function
+ * is looked up in the alg_tbl[] and invoked here.
+ */
+static ACVP_RESULT acvp_dispatch_vs_handler(ACVP_CTX *ctx, JSON_Object *obj) {
+    const ACVP_ALG_HANDLER *entry = NULL;
+    const char *err = json_object_get_string(obj, "error");
+    const char *alg = json_object_get_string(obj, "algorithm");
+    const char *mode = json_object_get_string(obj, "mode");
+    int vs_id = (int)json_object_get_uint(obj, "vsId");
+    unsigned long long int start = 0, crypto_ns = 0;
+
+    ctx->exec.vs_id = vs_id;
+    ACVP_RESULT rv;
+
+    if (err) {
+        ACVP_LOG_ERR("ACVP Server error detected -- An algorithm may have been skipped during vector generation.  Please manually check the file.");
+        return ACVP_NO_DATA;
+    }
+
+    if (!alg) {
+        ACVP_LOG_ERR("JSON parse error: ACV algorithm not found");
+        return ACVP_JSON_ERR;
+    }
+
+    ACVP_LOG_STATUS("Processing vector set: %d", vs_id);
+    ACVP_LOG_STATUS("Algorithm: %s", alg);
+    if (mode) {
+        ACVP_LOG_STATUS("Mode: %s", mode);
+    }
+    entry = acvp_lookup_alg_handler(alg, mode);
+    if (entry && !entry->handler) {
+        ACVP_LOG_ERR("Support for this algorithm was left out of the build (--enable-algorithms)");
+        return ACVP_UNSUPPORTED_OP;
+    }
+    if (entry) {
+        acvp_spill_reset(ctx);
+        ctx->exec.cipher = entry->cipher;
+        /* Leaves out the test groups already in the checkpoint journal or the result memo */
+        rv = acvp_journal_begin(ctx, obj);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+        if (ctx->event_cb) {
+            acvp_event_vs_begin(ctx, json_array_get_count(json_object_get_array(obj, "testGroups")));
+        }
+        if (ctx->lat_enabled) {
+            acvp_lat_vs_begin(ctx, entry->cipher);
+        }
+        if (!ctx->metrics_cb) {
+            rv = acvp_run_kat_handler(ctx, entry, obj);
+            acvp_event_tg_end(ctx);
+            acvp_om_flush(ctx);
+            acvp_lat_vs_done(ctx);
+            return acvp_journal_end(ctx, rv);
+        }
+        start = acvp_metrics_now();
+        crypto_ns = ctx->exec.vs_metrics.ns[ACVP_METRICS_CRYPTO];
+        rv = acvp_run_kat_handler(ctx, entry, obj);
+        acvp_event_tg_end(ctx);
+        acvp_om_flush(ctx);
+        acvp_lat_vs_done(ctx);
+        acvp_metrics_tg_end(ctx);
+        /* What the handler did besides calling the module */
+        crypto_ns = ctx->exec.vs_metrics.ns[ACVP_METRICS_CRYPTO] - crypto_ns;
+        start += crypto_ns;
+        acvp_metrics_add(ctx, ACVP_METRICS_OUTPUT, start);
+        return acvp_journal_end(ctx, rv);
+    }
+
+    ACVP_LOG_ERR("Unsupported algorithm or mode requested");
+    return ACVP_UNSUPPORTED_OP;
+}
+
+/*
+ * Dispatches a vector set to its KAT handler in a trace span, which is there
+ * for the vector sets that fail before getting to the handler too
+ */
+static ACVP_RESULT acvp_dispatch_vector_set(ACVP_CTX *ctx, JSON_Object *obj) {
+    ACVP_SPAN span;
+    ACVP_RESULT rv;
+
+    acvp_span_begin(ctx, &span, ACVP_SPAN_DISPATCH);
+    span.vs_id = (int)json_object_get_uint(obj, "vsId");
+    span.algorithm = json_object_get_string(obj, "algorithm");
+    span.mode = json_object_get_string(obj, "mode");
+    rv = acvp_dispatch_vs_handler(ctx, obj);
+    acvp_span_end(ctx, &span, rv);
+    return rv;
+}
+
+/*
+ * This function is used to process the test cases for
+ * a given KAT vector set.  This is invoked after the
+ * KAT vector set has been downloaded from the server.  The
+ * vectors are stored on the ACVP_CTX in one of the
+ * transitory fields.  Therefore, the vs_id isn't needed
+ * here to know which vectors need to be processed.
+ *
+ * The processing logic is:
+ *    a) JSON parse the data
+ *    b) Identify the ACVP operation to be performed (e.g. AES encrypt)
+ *    c) Dispatch the vectors to the handler for the
+ *       specified ACVP operation.
+ */
+static ACVP_RESULT acvp_process_vector_set(ACVP_CTX *ctx, JSON_Object *obj) {
+    ACVP_RESULT rv;
+
+    rv = acvp_dispatch_vector_set(ctx, obj);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    ACVP_LOG_STATUS("Successfully processed vector set");
+    return ACVP_SUCCESS;
+}
+
+/*
+ * GETs what job is for on ctx, keeping a copy of the response body
+ */
+static void acvp_fetch_one(ACVP_CTX *ctx, ACVP_FETCH_POOL *pool, ACVP_FETCH_JOB *job) {
+    char vs_url[ACVP_REQUEST_STR_LEN_MAX + 1];
+
+    switch (pool->kind) {
+    case ACVP_FETCH_RESULTS:
+        job->rv = acvp_retrieve_vector_set_result(ctx, job->url);
+        break;
+    case ACVP_FETCH_EXPECTED:
+        job->rv = acvp_retrieve_expected_result(ctx, job->url);
+        break;
+    case ACVP_FETCH_VS:
+    default:
+        //retrieve_vector_set expects a non-const string
+        strncpy_s(vs_url, sizeof(vs_url), job->url, ACVP_REQUEST_STR_LEN_MAX);
+        job->rv = acvp_retrieve_vector_set(ctx, vs_url);
+        break;
+    }
+    if (job->rv != ACVP_SUCCESS) {
+        return;
+    }
+    job->body = calloc(ctx->exec.curl_read_ctr + 1, sizeof(char));
+    if (!job->body) {
+        job->rv = ACVP_MALLOC_FAIL;
+        return;
+    }
+    memcpy_s(job->body, ctx->exec.curl_read_ctr + 1, ctx->exec.curl_buf, ctx->exec.curl_read_ctr);
+}
+
+/*
+ * Works through the jobs of the fetch pool until none are left, staying
+ * no more than the window of the pool ahead of those taken.
+ */
+static void acvp_fetch_worker(ACVP_CTX *ctx, ACVP_FETCH_POOL *pool) {
+    ACVP_FETCH_JOB *job = NULL;
+    int i = 0;
+
+    while (1) {
+        acvp_mutex_lock(&pool->lock);
+        while (pool->window && pool->next < pool->count && pool->next >= pool->taken + pool->window &&
+               !pool->stop) {
+            acvp_cond_wait(&pool->cond, &pool->lock);
+        }
+        i = pool->stop ? pool->count : pool->next++;
+        acvp_mutex_unlock(&pool->lock);
+        if (i >= pool->count) {
+            break;
+        }
+        job = &pool->jobs[i];
+
+        acvp_fetch_one(ctx, pool, job);
+
+        acvp_mutex_lock(&pool->lock);
+        job->done = 1;
+        acvp_cond_broadcast(&pool->cond);
+        acvp_mutex_unlock(&pool->lock);
+    }
+}
+
+typedef struct acvp_fetch_thread_t {
+    ACVP_CTX *ctx;
+    ACVP_FETCH_POOL *pool;
+} ACVP_FETCH_THREAD;
+
+static void acvp_fetch_thread(void *arg) {
+    ACVP_FETCH_THREAD *t = arg;
+
+    acvp_fetch_worker(t->ctx, t->pool);
+}
+
+/*
+ * Starts fetching the count jobs of kind, with up to max_parallel_vs of them
+ * in flight at once, each on its own exec context, and never more than
+ * window of them (unless 0) ahead of those taken with acvp_fetch_take().
+ * If no workers can be started, each job is fetched on this thread once it
+ * is taken. Ended by acvp_fetch_finish().
+ */
+static void acvp_fetch_start(ACVP_CTX *ctx, ACVP_FETCH_POOL *pool, ACVP_FETCH_JOB *jobs, int count,
+                             ACVP_FETCH_KIND kind, int window) {
+    int worker_cnt = 0, i = 0;
+
+    memzero_s(pool, sizeof(ACVP_FETCH_POOL));
+    pool->ctx = ctx;
+    pool->jobs = jobs;
+    pool->count = count;
+    pool->kind = kind;
+    pool->window = window;
+    acvp_mutex_init(&pool->lock);
+    acvp_cond_init(&pool->cond);
+
+    worker_cnt = ctx->max_parallel_vs < count ? ctx->max_parallel_vs : count;
+    if (window && worker_cnt > window) {
+        worker_cnt = window;
+    }
+    if (worker_cnt > 1) {
+        pool->workers = calloc(worker_cnt, sizeof(ACVP_FETCH_THREAD));
+        pool->threads = calloc(worker_cnt, sizeof(ACVP_THREAD));
+    }
+    if (pool->workers && pool->threads) {
+        for (i = 0; i < worker_cnt; i++) {
+            pool->workers[i].pool = pool;
+            pool->workers[i].ctx = acvp_create_exec_ctx(ctx);
+            if (!pool->workers[i].ctx) {
+                break;
+            }
+            if (acvp_thread_create(&pool->threads[i], acvp_fetch_thread, &pool->workers[i]) != ACVP_SUCCESS) {
+                acvp_free_exec_ctx(pool->workers[i].ctx);
+                break;
+            }
+            pool->started++;
+        }
+    }
+}
+
+/*
+ * Waits for job i of the pool, the next in order, to be fetched and lets
+ * the workers move on past it. With no workers, it is fetched here. The
+ * session context is left alone while workers use it for JWT refreshes.
+ */
+static ACVP_FETCH_JOB *acvp_fetch_take(ACVP_FETCH_POOL *pool, int i) {
+    ACVP_FETCH_JOB *job = &pool->jobs[i];
+
+    if (!pool->started) {
+        acvp_fetch_one(pool->ctx, pool, job);
+        job->done = 1;
+        pool->taken = i + 1;
+        return job;
+    }
+    acvp_mutex_lock(&pool->lock);
+    while (!job->done) {
+        acvp_cond_wait(&pool->cond, &pool->lock);
+    }
+    pool->taken = i + 1;
+    acvp_cond_broadcast(&pool->cond);
+    acvp_mutex_unlock(&pool->lock);
+    return job;
+}
+
+/*
+ * Stops handing out jobs, waits for the workers and frees them. The jobs
+ * are left to the caller.
+ */
+static void acvp_fetch_finish(ACVP_FETCH_POOL *pool) {
+    int i = 0;
+
+    acvp_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    acvp_cond_broadcast(&pool->cond);
+    acvp_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->started; i++) {
+        acvp_thread_join(pool->threads[i]);
+        acvp_free_exec_ctx(pool->workers[i].ctx);
+    }
+    if (pool->workers) free(pool->workers);
+    if (pool->threads) free(pool->threads);
+    acvp_cond_destroy(&pool->cond);
+    acvp_mutex_destroy(&pool->lock);
+}
+
+/*
+ * GETs the vector sets of count jobs, or what kind says of them, with up to
+ * max_parallel_vs of them in flight at once. The outcome of each is left in
+ * its job.
+ */
+static void acvp_fetch_vector_sets(ACVP_CTX *ctx, ACVP_FETCH_JOB *jobs, int count, ACVP_FETCH_KIND kind) {
+    ACVP_FETCH_POOL pool;
+    int i = 0;
+
+    acvp_fetch_start(ctx, &pool, jobs, count, kind, 0);
+    for (i = 0; i < count; i++) {
+        acvp_fetch_take(&pool, i);
+    }
+    acvp_fetch_finish(&pool);
+}
+
+static void acvp_free_fetch_jobs(ACVP_FETCH_JOB *jobs, int count) {
+    int i = 0;
+
+    if (!jobs) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (jobs[i].body) free(jobs[i].body);
+    }
+    free(jobs);
+}
+
+/*
+ * Adds the algorithm and mode of each failed vector set fetched to the lists
+ * of failed algorithms, once per algorithm and mode.
+ */
+static void acvp_add_failed_algs(ACVP_CTX *ctx, ACVP_FETCH_JOB *jobs, int count,
+                                 ACVP_STRING_LIST **failedAlgList, ACVP_STRING_LIST **failedModeList) {
+    JSON_Value *val = NULL;
+    JSON_Object *obj = NULL;
+    const char *alg = NULL, *mode = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    for (i = 0; i < count; i++) {
+        if (jobs[i].rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Unable to retrieve vector set while reporting failed algorithms, skipping...");
+            continue;
+        }
+        val = json_parse_string(jobs[i].body);
+        obj = acvp_get_obj_from_rsp(ctx, val);
+        alg = json_object_get_string(obj, "algorithm");
+        if (!alg) {
+            ACVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
+            if (val) json_value_free(val);
+            continue;
+        }
+        //Some algorithms have the same names, but different modes. Need to differentiate.
+        mode = json_object_get_string(obj, "mode");
+        if (!acvp_lookup_str_list(failedAlgList, alg) || !acvp_lookup_str_list(failedModeList, mode)) {
+            rv = acvp_append_str_list(failedAlgList, alg);
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("Error appending failed algorithm name to list, skipping...");
+            } else {
+                //use empty node to keep mode and algorithm indexes aligned in lists
+                rv = acvp_append_str_list(failedModeList, mode ? mode : "");
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Error appending failed mode name to list, skipping...");
+                }
+            }
+        }
+        json_value_free(val);
+    }
+}
+
+/*
+ * This function will get the test results for a test session by checking the results of each vector set.
+ * The server is polled for as long as it asks, and the vector sets that failed are fetched several at a
+ * time when acvp_set_max_parallel_vector_sets() allows it.
+ */
+static ACVP_RESULT acvp_get_result_test_session(ACVP_CTX *ctx, char *session_url) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *val = NULL;
+    JSON_Object *obj = NULL;
+    int count = 0, i = 0, passed = 0, pending = 0;
+    double retry = 0;
+    JSON_Array *results = NULL;
+    JSON_Object *current = NULL;
+    const char *status = NULL;
+    unsigned int time_waited_so_far = 0;
+    int retry_interval = ACVP_RETRY_TIME;
+    ACVP_FETCH_JOB *jobs = NULL;
+    //Maintains a list of names of algorithms that have failed
+    ACVP_STRING_LIST *failedAlgList = NULL;
+    ACVP_STRING_LIST *failedModeList = NULL;
+    /*
+     * Maintains a list of the vector set URLs we have already looked up,
+     * so we don't redownload failed vector sets every time a retry is done
+     */
+     ACVP_STRING_LIST *failedVsList = NULL;
+
+    if (acvp_stepping(ctx) && ctx->step->checking) {
+        /* Polled again by the next step once the server's wait is over */
+        time_waited_so_far = ctx->step->waited;
+        retry_interval = ctx->step->retry_interval;
+    }
+
+    while (1) {
+        int testsCompleted = 0;
+
+        /*
+         * Get the KAT vector set
+         */
+        rv = acvp_retrieve_vector_set_result(ctx, session_url);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Error retrieving vector set results!");
+            goto end;
+        }
+
+        val = json_parse_string(ctx->exec.curl_buf);
+        if (!val) {
+            ACVP_LOG_ERR("Error while parsing json from server!");
+            rv = ACVP_JSON_ERR;
+            goto end;
+        }
+        obj = acvp_get_obj_from_rsp(ctx, val);
+        if (!obj) {
+            ACVP_LOG_ERR("Error while parsing json from server!");
+            rv = ACVP_JSON_ERR;
+            goto end;
+        }
+
+        /*
+         * The server may tell us when to ask again, rather than giving results
+         */
+        retry = json_object_get_number(obj, "retry");
+        if (retry >= 1) {
+            retry_interval = (int)retry;
+            if (acvp_retry_handler(ctx, &retry_interval, &time_waited_so_far, 1, ACVP_WAITING_FOR_RESULTS) != ACVP_KAT_DOWNLOAD_RETRY) {
+                ACVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", ACVP_MAX_WAIT_TIME);
+                rv = ACVP_TRANSPORT_FAIL;
+                goto end;
+            }
+            if (acvp_stepping(ctx)) {
+                ctx->step->waited = time_waited_so_far;
+                ctx->step->retry_interval = retry_interval;
+                rv = ACVP_KAT_DOWNLOAD_RETRY;
+                goto end;
+            }
+            json_value_free(val);
+            val = NULL;
+            continue;
+        }
+
+        /*
+         * Check the results for each vector set - flag if some are incomplete,
+         * or name failed algorithms (even if others are still incomplete)
+         */
+        results = json_object_get_array(obj, "results");
+        count = (int)json_array_get_count(results);
+        if (count) {
+            jobs = calloc(count, sizeof(ACVP_FETCH_JOB));
+            if (!jobs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto end;
+            }
+        }
+        pending = 0;
+        for (i = 0; i < count; i++) {
+            int diff = 1;
+            current = json_array_get_object(results, i);
+            status = json_object_get_string(current, "status");
+            if (!status) {
+                goto end;
+            }
+            strcmp_s("expired", 7, status, &diff);
+            if (!diff) {
+                ACVP_LOG_ERR("One or more vector sets expired before results were submitted. Please start a new test session.");
+                goto end;
+            }
+            
+            strcmp_s("unreceived", 10, status, &diff);
+            if (!diff) {
+                ACVP_LOG_ERR("Missing submissions for one or more vector sets. Please submit responses for all vector sets.");
+                goto end;
+            }
+            /*
+             * If the result is incomplete, set the flag so it keeps retrying
+             */
+            strcmp_s("incomplete", 10, status, &diff);
+            if (!diff) {
+                continue;
+            }
+            /*
+             * If the result is fail, queue the vector set to be fetched for its algorithm name
+             */
+            strcmp_s("fail", 4, status, &diff);
+            if (!diff) {
+                const char *vsurl = json_object_get_string(current, "vectorSetUrl");
+                if (!vsurl) {
+                    ACVP_LOG_ERR("No vector set URL when generating failed algorithm list");
+                    break;
+                }
+                if (!acvp_lookup_str_list(&failedVsList, vsurl)) {
+                    //append the vsurl to the list so we dont download/check same one twice
+                    rv = acvp_append_str_list(&failedVsList, vsurl);
+                    if (rv != ACVP_SUCCESS) {
+                        ACVP_LOG_ERR("Error appending failed algorithm name to list, skipping...");
+                        continue;
+                    }
+                    jobs[pending++].url = vsurl;
+                }
+            }
+            testsCompleted++;
+        }
+
+        /* All of the newly failed vector sets at once */
+        if (pending) {
+            acvp_fetch_vector_sets(ctx, jobs, pending, ACVP_FETCH_VS);
+            acvp_add_failed_algs(ctx, jobs, pending, &failedAlgList, &failedModeList);
+        }
+        acvp_free_fetch_jobs(jobs, pending);
+        jobs = NULL;
+
+        if (testsCompleted >= count) {
+            passed = json_object_get_boolean(obj, "passed");
+            if (passed == 1) {
+                /*
+                 * Pass, exit loop
+                 */
+                ACVP_LOG_STATUS("Passed all vectors in test session!");
+                ctx->session_passed = 1;
+                rv = ACVP_SUCCESS;
+                goto end;
+            } else {
+                 /*
+                  * Fail, continue with reporting results
+                  */
+                 ACVP_LOG_STATUS("Test session complete: some vectors failed, reporting results...");
+                 ACVP_LOG_STATUS("Note: Use verbose-level logging to see results of each test case");
+                 acvp_list_failing_algorithms(ctx, &failedAlgList, &failedModeList);
+             }
+        } else {
+              /*
+             * If any tests are incomplete, retry, even if some have failed
+             */
+            acvp_list_failing_algorithms(ctx, &failedAlgList, &failedModeList);
+            ACVP_LOG_STATUS("TestSession results incomplete...");
+            if (acvp_retry_handler(ctx, &retry_interval, &time_waited_so_far, 1, ACVP_WAITING_FOR_RESULTS) != ACVP_KAT_DOWNLOAD_RETRY) {
+                ACVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", ACVP_MAX_WAIT_TIME);
+                rv = ACVP_TRANSPORT_FAIL;
+                goto end;
+            }
+            if (acvp_stepping(ctx)) {
+                ctx->step->waited = time_waited_so_far;
+                ctx->step->retry_interval = retry_interval;
+                rv = ACVP_KAT_DOWNLOAD_RETRY;
+                goto end;
+            }
+
+            if (val) json_value_free(val);
+            val = NULL;
+            continue;
+        }
+
+        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE && count) {
+            jobs = calloc(count, sizeof(ACVP_FETCH_JOB));
+            if (!jobs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto end;
+            }
+            pending = 0;
+            for (i = 0; i < count; i++) {
+                int diff = 1;
+                current = json_array_get_object(results, i);
+
+                status = json_object_get_string(current, "status");
+                if (!status) {
+                    goto end;
+                }
+                strcmp_s("fail", 4, status, &diff);
+                if (diff)
+                    strcmp_s("error", 5, status, &diff);
+                if (!diff) {
+                    jobs[pending++].url = json_object_get_string(current, "vectorSetUrl");
+                }
+            }
+
+            if (pending) {
+                ACVP_LOG_STATUS("Getting details for %d failed Vector Sets...", pending);
+                acvp_fetch_vector_sets(ctx, jobs, pending, ACVP_FETCH_RESULTS);
+            }
+            for (i = 0; i < pending; i++) {
+                rv = jobs[i].rv;
+                if (rv != ACVP_SUCCESS) goto end;
+                printf("\n%s\n", jobs[i].body);
+            }
+        }
+        
+        /* If we got here, the testSession failed, exit loop*/
+        break;
+    }
+
+end:
+    acvp_free_fetch_jobs(jobs, pending);
+    if (val) json_value_free(val);
+    if (failedAlgList) {
+        acvp_free_str_list(&failedAlgList);
+    }
+    if (failedModeList) {
+        acvp_free_str_list(&failedModeList);
+    }
+    if (failedVsList) {
+        acvp_free_str_list(&failedVsList);
+    }
+    return rv;
+}
+
+static ACVP_RESULT acvp_validate_test_session(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    char *validation = NULL;
+    int validation_len = 0;
+
+    if (ctx == NULL) return ACVP_NO_CTX;
+
+    if (ctx->session_passed != 1) {
+        ACVP_LOG_ERR("This testSession cannot be certified. Required disposition == 'pass'.");
+        return ACVP_SUCCESS; // Technically no error occurred
+    }
+
+    rv = acvp_build_validation(ctx, &validation, &validation_len);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Unable to build Validation message");
+        goto end;
+    }
+
+    /*
+     * PUT the validation with the ACVP server and get the response,
+     */
+    rv = acvp_transport_put_validation(ctx, validation, validation_len);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_STATUS("Validation send failed");
+        goto end;
+    }
+
+    rv = acvp_parse_validation(ctx);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_STATUS("Failed to parse Validation response");
+    }
+
+end:
+    if (validation) free(validation);
+
+    return rv;
+}
+
+
+static
+ACVP_RESULT acvp_post_data(ACVP_CTX *ctx, char *filename) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *reg_arry_val = NULL;
+    JSON_Object *reg_obj = NULL;
+    JSON_Array *reg_arry = NULL;
+    JSON_Array *data_array = NULL;
+    JSON_Object *obj = NULL;
+    JSON_Value *val = NULL;
+    JSON_Value *post_val = NULL;
+    JSON_Value *raw_val = NULL;
+    const char *path = NULL;
+    char *json_result = NULL;
+    int len;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!filename) {
+        ACVP_LOG_ERR("Must provide value for JSON filename");
+        return ACVP_MISSING_ARG;
+    }
+
+    if (strnlen_s(filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    val = json_parse_file(filename);
+    if (!val) {
+        ACVP_LOG_ERR("JSON val parse error");
+        return ACVP_MALFORMED_JSON;
+    }
+
+    data_array = json_value_get_array(val);
+    obj = json_array_get_object(data_array, 0);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        goto end;
+    }
+    path = json_object_get_string(obj, "url");
+    if (!path) {
+        ACVP_LOG_WARN("Missing path, POST aborted");
+        goto end;
+    }
+
+    raw_val = json_array_get_value(data_array, 1);
+    post_val = json_value_deep_copy(raw_val);
+
+    rv = acvp_create_array(&reg_obj, &reg_arry_val, &reg_arry);
+    json_array_append_value(reg_arry, post_val);
+
+    json_result = json_serialize_to_string_pretty(reg_arry_val, &len);
+    ACVP_LOG_INFO("\nPOST Data: %s\n\n", json_result);
+    json_value_free(reg_arry_val);
+
+    rv = acvp_transport_post(ctx, path, json_result, len);
+    ACVP_LOG_STATUS("POST response:\n\n%s\n", ctx->exec.curl_buf);
+    json_free_serialized_string(json_result);
+
+end:
+    json_value_free(val);
+    return rv;
+
+}
+
+#define TEST_SESSION "testSessions/"
+
+/**
+ * Creates a file with the test session info, which can be used to access the test session
+ * in the future.
+ *
+ * This function should not modify the ctx, only read it.
+ */
+static ACVP_RESULT acvp_write_session_info(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_INTERNAL_ERR;
+    JSON_Value *ts_val = NULL, *slowest = NULL;
+    JSON_Object *ts_obj = NULL;
+    char *filename = NULL, *ptr = NULL, *path = NULL, *prefix = NULL;
+    ACVP_WRITER *writer = NULL;
+    int diff;
+    int pathLen = 0, allocedPrefix = 0;
+
+    filename = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!filename) {
+        return ACVP_MALLOC_FAIL;
+    }
+
+    ts_val = json_value_init_object();
+    ts_obj = json_value_get_object(ts_val);
+    if (!ts_obj) {
+        goto end;
+    }
+
+    json_object_set_string(ts_obj, "url", ctx->session_url);
+    json_object_set_string(ts_obj, "jwt", ctx->jwt_token);
+    json_object_set_boolean(ts_obj, "isSample", ctx->is_sample);
+    json_object_set_value(ts_obj, "registration", ctx->registration);
+    slowest = acvp_lat_slowest_json(ctx);
+    if (slowest) {
+        json_object_set_value(ts_obj, "slowestTestCases", slowest);
+    }
+
+    /* pull test session ID out of URL */
+    ptr = ctx->session_url;
+    while(*ptr != 0) {
+        memcmp_s(ptr, strlen(TEST_SESSION), TEST_SESSION, strlen(TEST_SESSION), &diff);
+        if (!diff) {
+            break;
+        }
+        ptr++;
+    }
+
+    ptr+= strnlen_s(TEST_SESSION, ACVP_ATTR_URL_MAX);
+
+    path = getenv("ACV_SESSION_SAVE_PATH");
+    prefix = getenv("ACV_SESSION_SAVE_PREFIX");
+
+    /*
+     * Check the total length of our path, prefix, and total concatenated filename. 
+     * Add 6 to checks for .json and the _ beteween prefix and session ID
+     * If any lengths are too long, just use default prefix and location
+     */
+    if (path) {
+        pathLen += strnlen_s(path, ACVP_JSON_FILENAME_MAX + 1);
+    }
+    if (prefix) {
+        pathLen += strnlen_s(prefix, ACVP_JSON_FILENAME_MAX + 1);
+    }
+    pathLen += strnlen_s(ptr, ACVP_JSON_FILENAME_MAX + 1);
+    
+    if (pathLen > ACVP_JSON_FILENAME_MAX - 6) {
+        ACVP_LOG_WARN("Provided ACV_SESSION_SAVE information too long (current max path len: %d). Using defaults", \
+                      ACVP_JSON_FILENAME_MAX);
+        path = NULL;
+        prefix = NULL;
+    }
+    if (!prefix) {
+        int len = strnlen_s(ACVP_SAVE_DEFAULT_PREFIX, ACVP_JSON_FILENAME_MAX);
+        prefix = calloc(len + 1, sizeof(char));
+        if (!prefix) {
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+        strncpy_s(prefix, len + 1, ACVP_SAVE_DEFAULT_PREFIX, len);
+        allocedPrefix = 1;
+    }
+
+    //if we have a path, use it, otherwise use default (usually directory of parent application)
+    if (path) {
+        diff = snprintf(filename, ACVP_JSON_FILENAME_MAX, "%s/%s_%s.json", path, prefix, ptr);
+    } else {
+        diff = snprintf(filename, ACVP_JSON_FILENAME_MAX, "%s_%s.json", prefix, ptr);
+    }
+    if (diff < 0) {
+        rv = ACVP_UNSUPPORTED_OP;
+        goto end;
+    }
+    /* Synced before going on, a session can only be resumed from it */
+    rv = acvp_writer_open(&writer, filename, "w");
+    if (rv == ACVP_SUCCESS) {
+        rv = acvp_writer_json(writer, "[ ", ts_val, 0);
+        if (rv == ACVP_SUCCESS) {
+            rv = acvp_writer_puts(writer, " ]");
+        }
+        if (acvp_writer_close(writer) != ACVP_SUCCESS) {
+            rv = ACVP_JSON_ERR;
+        }
+    }
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("File write error. Check that directory exists and allows writes.");
+        goto end;
+    }
+
+    if (ctx->session_file_path) {
+        free(ctx->session_file_path);
+    }
+    ctx->session_file_path = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (strncpy_s(ctx->session_file_path, ACVP_JSON_FILENAME_MAX + 1, filename, 
+                  ACVP_JSON_FILENAME_MAX)) {
+        ACVP_LOG_ERR("Buffer write error while trying to save session file path to CTX");
+        rv = ACVP_UNSUPPORTED_OP;
+        goto end;
+    }
+
+    rv = ACVP_SUCCESS;
+end:
+    if (allocedPrefix && prefix) free(prefix);
+    if (ts_obj) json_object_soft_remove(ts_obj, "registration");
+    if (ts_val) json_value_free(ts_val);
+    free(filename);
+    return rv;
+}
+
+
+/*
+ * The part of acvp_run() that registers the session, once logged in
+ */
+static ACVP_RESULT acvp_run_register(ACVP_CTX *ctx, int fips_validation, ACVP_REG_BUILD *built) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (fips_validation) {
+        rv = acvp_verify_fips_validation_metadata(ctx);
+        if (ACVP_SUCCESS != rv) {
+            ACVP_LOG_ERR("Issue(s) with validation metadata, not continuing with session.");
+            return ACVP_UNSUPPORTED_OP;
+        }
+
+        ctx->fips.do_validation = 1; /* Enable */
+    } else {
+        ctx->fips.do_validation = 0; /* Disable */
+    }
+
+    /*
+     * Register with the server to advertise our capabilities and receive
+     * the vector sets identifiers.
+     */
+    rv = acvp_register(ctx, built);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Failed to register with ACVP server");
+        return rv;
+    }
+    
+    //write session info so if we time out or lose connection waiting for results, we can recheck later on
+    if (!ctx->put) {
+        if (acvp_write_session_info(ctx) != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Error writing the session info file. Continuing, but session will not be able to be resumed or checked later on");
+        }
+    }
+
+    ACVP_LOG_STATUS("Beginning to download and process vector sets...");
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The part of acvp_run() after the vector sets are processed. During a step
+ * of acvp_session_step() it returns ACVP_KAT_DOWNLOAD_RETRY while the server
+ * has the results pending, and picks up from there on the next call.
+ */
+static ACVP_RESULT acvp_run_results(ACVP_CTX *ctx, int fips_validation) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!acvp_stepping(ctx) || !ctx->step->checking) {
+        /* Written again, now with the slowest test cases of the vector sets */
+        if (ctx->lat_slowest_list && !ctx->put) {
+            if (acvp_write_session_info(ctx) != ACVP_SUCCESS) {
+                ACVP_LOG_WARN("Unable to add the slowest test cases to the session info file");
+            }
+        }
+
+        if (ctx->vector_req) {
+            ACVP_LOG_STATUS("Successfully downloaded vector sets and saved to specified file.");
+            return ACVP_SUCCESS;
+        }
+        ACVP_LOG_STATUS("Tests complete, checking results...");
+    }
+
+    /*
+     * Check the test results.
+     */
+    rv = acvp_check_test_results(ctx);
+    if (acvp_stepping(ctx)) {
+        ctx->step->checking = 1;
+        if (rv == ACVP_KAT_DOWNLOAD_RETRY) {
+            return rv;
+        }
+    }
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Unable to retrieve test results");
+        return rv;
+    }
+
+    if (fips_validation) {
+        /*
+         * Tell the server to provision a FIPS certificate for this testSession.
+         */
+        rv = acvp_validate_test_session(ctx);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Failed to perform Validation of testSession");
+            return rv;
+        }
+    }
+
+   if (ctx->put) {
+       rv = acvp_put_data_from_ctx(ctx);
+   }
+   return rv;
+}
+
+
+ACVP_RESULT acvp_run(ACVP_CTX *ctx, int fips_validation) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *val = NULL;
+    ACVP_REG_BUILD built;
+    ACVP_THREAD builder;
+    int building = 0;
+
+    if (ctx == NULL) return ACVP_NO_CTX;
+
+    /*
+     * The registration does not depend on the login, so it is built while
+     * the login waits on the server, ready to be sent once there is a JWT
+     */
+    memzero_s(&built, sizeof(ACVP_REG_BUILD));
+    built.ctx = ctx;
+    if (!ctx->get && !ctx->post && !ctx->delete) {
+        building = acvp_thread_create(&builder, acvp_build_register_thread, &built) == ACVP_SUCCESS;
+    }
 
-            if (val) json_value_free(val);
-            val = NULL;
-            continue;
-        }
+    rv = acvp_login(ctx, 0);
+    if (building) {
+        acvp_thread_join(builder);
+    }
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Failed to login with ACVP server");
+        goto end;
+    }
 
-        for (i = 0; i < count; i++) {
-            int diff = 1;
-            current = json_array_get_object(results, i);
 
-            status = json_object_get_string(current, "status");
-            if (!status) {
-                goto end;
-            }
-            strcmp_s("fail", 4, status, &diff);
-            if (diff)
-                strcmp_s("error", 5, status, &diff);
-            if (!diff) {
-                const char *vs_url = json_object_get_string(current, "vectorSetUrl");
-                if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
-                    ACVP_LOG_STATUS("Getting details for failed Vector Set...");
-                    rv = acvp_retrieve_vector_set_result(ctx, vs_url);
-                    printf("\n%s\n", ctx->curl_buf);
-                    if (rv != ACVP_SUCCESS) goto end;
+    if (ctx->get) { 
+        rv = acvp_transport_get(ctx, ctx->get_string, NULL);
+        if (ctx->save_filename) {
+            ACVP_LOG_STATUS("Saving GET result to specified file...");
+            val = json_parse_string(ctx->exec.curl_buf);
+            if (!val) {
+                ACVP_LOG_ERR("Unable to parse JSON. printing output instead...");
+            } else {
+                rv = acvp_json_serialize_to_file_pretty_w(val, ctx->save_filename);
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to write file, printing instead...");
+                } else {
+                    rv = acvp_json_serialize_to_file_pretty_a(NULL, ctx->save_filename);
+                    if (rv != ACVP_SUCCESS)
+                        ACVP_LOG_WARN("Unable to append ending ] to write file");
+                    goto end;
                 }
             }
         }
-        
-        /* If we got here, the testSession failed, exit loop*/
-        break;
+        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
+            printf("\n\n%s\n\n", ctx->exec.curl_buf);
+        } else {
+            ACVP_LOG_STATUS("GET Response:\n\n%s\n", ctx->exec.curl_buf);
+        }
+        goto end;
     }
 
-end:
-    if (val) json_value_free(val);
-    if (failedAlgList) {
-        acvp_free_str_list(&failedAlgList);
-    }
-    if (failedModeList) {
-        acvp_free_str_list(&failedModeList);
-    }
-    if (failedVsList) {
-        acvp_free_str_list(&failedVsList);
+    if (ctx->post) { 
+        rv = acvp_post_data(ctx, ctx->post_filename);
+        goto end;
     }
-    return rv;
-}
-
-static ACVP_RESULT acvp_validate_test_session(ACVP_CTX *ctx) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    char *validation = NULL;
-    int validation_len = 0;
-
-    if (ctx == NULL) return ACVP_NO_CTX;
 
-    if (ctx->session_passed != 1) {
-        ACVP_LOG_ERR("This testSession cannot be certified. Required disposition == 'pass'.");
-        return ACVP_SUCCESS; // Technically no error occurred
+    if (ctx->delete) {
+        rv = acvp_transport_delete(ctx, ctx->delete_string);
+        if (ctx->save_filename) {
+            ACVP_LOG_STATUS("Saving DELETE response to specified file...");
+            val = json_parse_string(ctx->exec.curl_buf);
+            if (!val) {
+                ACVP_LOG_ERR("Unable to parse JSON. printing output instead...");
+            } else {
+                rv = acvp_json_serialize_to_file_pretty_w(val, ctx->save_filename);
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to write file, printing instead...");
+                } else {
+                    rv = acvp_json_serialize_to_file_pretty_a(NULL, ctx->save_filename);
+                    if (rv != ACVP_SUCCESS)
+                        ACVP_LOG_WARN("Unable to append ending ] to write file");
+                    goto end;
+                }
+            }
+        }
+        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
+            printf("\n\n%s\n\n", ctx->exec.curl_buf);
+        } else {
+            ACVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->exec.curl_buf);
+        }
+        goto end;
     }
 
-    rv = acvp_build_validation(ctx, &validation, &validation_len);
+    rv = acvp_run_register(ctx, fips_validation, building ? &built : NULL);
     if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Unable to build Validation message");
         goto end;
     }
 
     /*
-     * PUT the validation with the ACVP server and get the response,
+     * Now we process the test cases given to us during
+     * registration earlier.
      */
-    rv = acvp_transport_put_validation(ctx, validation, validation_len);
+    rv = acvp_process_tests(ctx);
     if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_STATUS("Validation send failed");
+        ACVP_LOG_ERR("Failed to process vectors");
         goto end;
     }
+    rv = acvp_run_results(ctx, fips_validation);
+end:
+    if (val) json_value_free(val);
+    if (built.reg) json_free_serialized_string(built.reg);
+    return rv;
+}
 
-    rv = acvp_parse_validation(ctx);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_STATUS("Failed to parse Validation response");
+static void acvp_step_free(ACVP_CTX *ctx) {
+    if (!ctx->step) {
+        return;
     }
+    acvp_pool_free(&ctx->step->pool);
+    free(ctx->step);
+    ctx->step = NULL;
+}
 
-end:
-    if (validation) free(validation);
+/*
+ * Takes the next step of the session of ctx, see acvp_session_step(). Returns
+ * ACVP_KAT_DOWNLOAD_RETRY while there is more to do, setting wait to the
+ * seconds until there is.
+ */
+static ACVP_RESULT acvp_step(ACVP_CTX *ctx, int *wait) {
+    ACVP_STEP *step = ctx->step;
+    ACVP_STRING_LIST *vs_entry = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int job = 0, count = 0;
 
-    return rv;
-}
+    switch (step->state) {
+    case ACVP_STEP_LOGIN:
+        rv = acvp_login(ctx, 0);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Failed to login with ACVP server");
+            return rv;
+        }
+        step->state = ACVP_STEP_REGISTER;
+        return ACVP_KAT_DOWNLOAD_RETRY;
+
+    case ACVP_STEP_REGISTER:
+        rv = acvp_run_register(ctx, step->fips_validation, NULL);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+        for (vs_entry = ctx->vsid_url_list; vs_entry; vs_entry = vs_entry->next) {
+            count++;
+        }
+        if (!count) {
+            return ACVP_MISSING_ARG;
+        }
+        rv = acvp_pool_init(ctx, &step->pool, count, NULL, NULL, NULL);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+        step->state = ACVP_STEP_VECTORS;
+        return ACVP_KAT_DOWNLOAD_RETRY;
+
+    case ACVP_STEP_VECTORS:
+        /* One vector set each step, those the server is not ready with are left for later */
+        acvp_mutex_lock(&step->pool.lock);
+        job = acvp_pool_next_job(&step->pool, wait);
+        acvp_mutex_unlock(&step->pool.lock);
+        if (job >= 0) {
+            ctx->pool = &step->pool;
+            acvp_pool_run_job(ctx, job);
+            ctx->pool = NULL;
+            return ACVP_KAT_DOWNLOAD_RETRY;
+        }
+        if (*wait) {
+            return ACVP_KAT_DOWNLOAD_RETRY;
+        }
 
+        rv = acvp_pool_result(&step->pool);
+        acvp_pool_free(&step->pool);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Failed to process vectors");
+            return rv;
+        }
+        /* Need to add the ending ']' here */
+        if (ctx->vector_req) {
+            rv = acvp_close_vector_req_file(ctx);
+            if (rv != ACVP_SUCCESS) {
+                return rv;
+            }
+        }
+        step->state = ACVP_STEP_RESULTS;
+        return ACVP_KAT_DOWNLOAD_RETRY;
 
-static
-ACVP_RESULT acvp_post_data(ACVP_CTX *ctx, char *filename) {
+    case ACVP_STEP_RESULTS:
+        rv = acvp_run_results(ctx, step->fips_validation);
+        if (rv == ACVP_KAT_DOWNLOAD_RETRY) {
+            *wait = step->wait;
+        }
+        return rv;
+
+    case ACVP_STEP_DONE:
+    default:
+        return step->rv;
+    }
+}
+
+ACVP_RESULT acvp_session_step(ACVP_CTX *ctx, int fips_validation, int *next_fd, int *next_timeout) {
+    ACVP_STEP *step = NULL;
     ACVP_RESULT rv = ACVP_SUCCESS;
-    JSON_Value *reg_arry_val = NULL;
-    JSON_Object *reg_obj = NULL;
-    JSON_Array *reg_arry = NULL;
-    JSON_Array *data_array = NULL;
-    JSON_Object *obj = NULL;
-    JSON_Value *val = NULL;
-    JSON_Value *post_val = NULL;
-    JSON_Value *raw_val = NULL;
-    const char *path = NULL;
-    char *json_result = NULL;
-    int len;
+    int wait = 0;
 
     if (!ctx) {
         return ACVP_NO_CTX;
     }
-    if (!filename) {
-        ACVP_LOG_ERR("Must provide value for JSON filename");
+    if (!next_fd || !next_timeout) {
         return ACVP_MISSING_ARG;
     }
-
-    if (strnlen_s(filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
-        ACVP_LOG_ERR("Provided filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+    /* The exchanges with the server are done within the step, so there is no descriptor to wait on */
+    *next_fd = -1;
+    *next_timeout = 0;
+    if (ctx->pool || ctx->session) {
+        ACVP_LOG_ERR("Only the context of the session itself can be stepped");
         return ACVP_INVALID_ARG;
     }
-
-    val = json_parse_file(filename);
-    if (!val) {
-        ACVP_LOG_ERR("JSON val parse error");
-        return ACVP_MALFORMED_JSON;
+    if (ctx->get || ctx->post || ctx->delete || ctx->remote_dir) {
+        ACVP_LOG_ERR("Sessions set up for a GET, POST, DELETE or remote workers must be run with acvp_run()");
+        return ACVP_UNSUPPORTED_OP;
     }
 
-    data_array = json_value_get_array(val);
-    obj = json_array_get_object(data_array, 0);
-    if (!obj) {
-        ACVP_LOG_ERR("JSON obj parse error");
-        goto end;
+    if (!ctx->step) {
+        ctx->step = calloc(1, sizeof(ACVP_STEP));
+        if (!ctx->step) {
+            return ACVP_MALLOC_FAIL;
+        }
+        ctx->step->fips_validation = fips_validation;
     }
-    path = json_object_get_string(obj, "url");
-    if (!path) {
-        ACVP_LOG_WARN("Missing path, POST aborted");
-        goto end;
+    step = ctx->step;
+    if (step->state == ACVP_STEP_DONE) {
+        return step->rv;
     }
 
-    raw_val = json_array_get_value(data_array, 1);
-    json_result = json_serialize_to_string_pretty(raw_val, NULL);
-    post_val = json_parse_string(json_result);
-    json_free_serialized_string(json_result);
-
-    rv = acvp_create_array(&reg_obj, &reg_arry_val, &reg_arry);
-    json_array_append_value(reg_arry, post_val);
-
-    json_result = json_serialize_to_string_pretty(reg_arry_val, &len);
-    ACVP_LOG_INFO("\nPOST Data: %s\n\n", json_result);
-    json_value_free(reg_arry_val);
-
-    rv = acvp_transport_post(ctx, path, json_result, len);
-    ACVP_LOG_STATUS("POST response:\n\n%s\n", ctx->curl_buf);
-    json_free_serialized_string(json_result);
-
-end:
-    json_value_free(val);
+    step->running = 1;
+    step->wait = 0;
+    rv = acvp_step(ctx, &wait);
+    step->running = 0;
+    if (rv != ACVP_KAT_DOWNLOAD_RETRY) {
+        acvp_pool_free(&step->pool);
+        step->state = ACVP_STEP_DONE;
+        step->rv = rv;
+        return rv;
+    }
+    *next_timeout = wait * 1000;
     return rv;
-
 }
 
-#define TEST_SESSION "testSessions/"
-
-/**
- * Creates a file with the test session info, which can be used to access the test session
- * in the future.
- *
- * This function should not modify the ctx, only read it.
+/*
+ * A worker of acvp_orch_run(). The curl handle is lent to each context the
+ * worker runs, so a worker keeps one connection to the server no matter how
+ * many sessions it works on.
  */
-static ACVP_RESULT acvp_write_session_info(ACVP_CTX *ctx) {
-    ACVP_RESULT rv = ACVP_INTERNAL_ERR;
-    JSON_Value *ts_val = NULL;
-    JSON_Object *ts_obj = NULL;
-    char *filename = NULL, *ptr = NULL, *path = NULL, *prefix = NULL;
-    int diff;
-    int pathLen = 0, allocedPrefix = 0;
+typedef struct acvp_orch_worker_t {
+    ACVP_ORCH *orch;
+    void *curl_hnd;
+} ACVP_ORCH_WORKER;
 
-    filename = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
-    if (!filename) {
+ACVP_RESULT acvp_orch_create(ACVP_ORCH **orch, int max_workers) {
+    if (!orch) {
+        return ACVP_INVALID_ARG;
+    }
+    if (*orch) {
+        return ACVP_CTX_NOT_EMPTY;
+    }
+    if (max_workers < 1 || max_workers > ACVP_MAX_PARALLEL_VS) {
+        return ACVP_INVALID_ARG;
+    }
+    *orch = calloc(1, sizeof(ACVP_ORCH));
+    if (!*orch) {
         return ACVP_MALLOC_FAIL;
     }
+    (*orch)->max_workers = max_workers;
+    acvp_mutex_init(&(*orch)->lock);
+    return ACVP_SUCCESS;
+}
 
-    ts_val = json_value_init_object();
-    ts_obj = json_value_get_object(ts_val);
-    if (!ts_obj) {
-        goto end;
+static ACVP_ORCH_SESSION *acvp_orch_find(ACVP_ORCH *orch, ACVP_CTX *ctx) {
+    int i = 0;
+
+    for (i = 0; i < orch->session_cnt; i++) {
+        if (orch->sessions[i].ctx == ctx) {
+            return &orch->sessions[i];
+        }
     }
+    return NULL;
+}
 
-    json_object_set_string(ts_obj, "url", ctx->session_url);
-    json_object_set_string(ts_obj, "jwt", ctx->jwt_token);
-    json_object_set_boolean(ts_obj, "isSample", ctx->is_sample);
-    json_object_set_value(ts_obj, "registration", ctx->registration);
+ACVP_RESULT acvp_orch_add_session(ACVP_ORCH *orch, ACVP_CTX *ctx, int fips_validation) {
+    ACVP_ORCH_SESSION *sessions = NULL;
+    int max = 0;
 
-    /* pull test session ID out of URL */
-    ptr = ctx->session_url;
-    while(*ptr != 0) {
-        memcmp_s(ptr, strlen(TEST_SESSION), TEST_SESSION, strlen(TEST_SESSION), &diff);
-        if (!diff) {
-            break;
+    if (!orch) {
+        return ACVP_MISSING_ARG;
+    }
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (orch->running || ctx->session) {
+        return ACVP_UNSUPPORTED_OP;
+    }
+    if (acvp_orch_find(orch, ctx)) {
+        ACVP_LOG_ERR("The context was already added to the orchestrator");
+        return ACVP_INVALID_ARG;
+    }
+    if (ctx->get || ctx->post || ctx->delete) {
+        ACVP_LOG_ERR("Only contexts that register a test session can be run by an orchestrator");
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    if (orch->session_cnt == orch->session_max) {
+        max = orch->session_max ? orch->session_max * 2 : 4;
+        sessions = realloc(orch->sessions, max * sizeof(ACVP_ORCH_SESSION));
+        if (!sessions) {
+            return ACVP_MALLOC_FAIL;
         }
-        ptr++;
+        orch->sessions = sessions;
+        orch->session_max = max;
     }
+    memzero_s(&orch->sessions[orch->session_cnt], sizeof(ACVP_ORCH_SESSION));
+    orch->sessions[orch->session_cnt].ctx = ctx;
+    orch->sessions[orch->session_cnt].fips_validation = fips_validation;
+    orch->session_cnt++;
+    return ACVP_SUCCESS;
+}
 
-    ptr+= strnlen_s(TEST_SESSION, ACVP_ATTR_URL_MAX);
+/*
+ * Picks the next thing for a worker to do: registering a session that has
+ * not been registered yet, then the vector set of any session the server
+ * expects to be ready soonest (searching from a different session each
+ * time, so the sessions take turns), then checking the results of a
+ * session with no vector sets left. Returns NULL when there is nothing to
+ * do now, with wait set to the seconds to wait before asking again, 0 if all
+ * sessions are done. index is set to the job in the pool of the session, or
+ * -1 for registering or checking results. Must be called with the lock held.
+ */
+static ACVP_ORCH_SESSION *acvp_orch_next_task(ACVP_ORCH *orch, int *index, int *wait) {
+    ACVP_ORCH_SESSION *s = NULL;
+    int i = 0, k = 0, job = 0, job_wait = 0, busy = 0, active = 0;
 
-    path = getenv("ACV_SESSION_SAVE_PATH");
-    prefix = getenv("ACV_SESSION_SAVE_PREFIX");
+    *index = -1;
+    *wait = 0;
 
-    /*
-     * Check the total length of our path, prefix, and total concatenated filename. 
-     * Add 6 to checks for .json and the _ beteween prefix and session ID
-     * If any lengths are too long, just use default prefix and location
-     */
-    if (path) {
-        pathLen += strnlen_s(path, ACVP_JSON_FILENAME_MAX + 1);
-    }
-    if (prefix) {
-        pathLen += strnlen_s(prefix, ACVP_JSON_FILENAME_MAX + 1);
-    }
-    pathLen += strnlen_s(ptr, ACVP_JSON_FILENAME_MAX + 1);
-    
-    if (pathLen > ACVP_JSON_FILENAME_MAX - 6) {
-        ACVP_LOG_WARN("Provided ACV_SESSION_SAVE information too long (current max path len: %d). Using defaults", \
-                      ACVP_JSON_FILENAME_MAX);
-        path = NULL;
-        prefix = NULL;
-    }
-    if (!prefix) {
-        int len = strnlen_s(ACVP_SAVE_DEFAULT_PREFIX, ACVP_JSON_FILENAME_MAX);
-        prefix = calloc(len + 1, sizeof(char));
-        if (!prefix) {
-            rv = ACVP_MALLOC_FAIL;
-            goto end;
+    for (i = 0; i < orch->session_cnt; i++) {
+        if (orch->sessions[i].state == ACVP_ORCH_PENDING) {
+            orch->sessions[i].state = ACVP_ORCH_REGISTERING;
+            return &orch->sessions[i];
         }
-        strncpy_s(prefix, len + 1, ACVP_SAVE_DEFAULT_PREFIX, len);
-        allocedPrefix = 1;
     }
 
-    //if we have a path, use it, otherwise use default (usually directory of parent application)
-    if (path) {
-        diff = snprintf(filename, ACVP_JSON_FILENAME_MAX, "%s/%s_%s.json", path, prefix, ptr);
-    } else {
-        diff = snprintf(filename, ACVP_JSON_FILENAME_MAX, "%s_%s.json", prefix, ptr);
+    for (i = 0; i < orch->session_cnt; i++) {
+        k = (orch->next_session + i) % orch->session_cnt;
+        s = &orch->sessions[k];
+        if (s->state == ACVP_ORCH_DONE) {
+            continue;
+        }
+        active = 1;
+        if (s->state != ACVP_ORCH_VECTORS) {
+            continue;
+        }
+
+        acvp_mutex_lock(&s->pool.lock);
+        job = acvp_pool_next_job(&s->pool, &job_wait);
+        busy = acvp_pool_busy(&s->pool);
+        acvp_mutex_unlock(&s->pool.lock);
+        if (job >= 0) {
+            orch->next_session = (k + 1) % orch->session_cnt;
+            *index = job;
+            return s;
+        }
+        if (!job_wait && !busy) {
+            s->state = ACVP_ORCH_RESULTS;
+            return s;
+        }
+        if (job_wait && (!*wait || job_wait < *wait)) {
+            *wait = job_wait;
+        }
     }
-    if (diff < 0) {
-        rv = ACVP_UNSUPPORTED_OP;
-        goto end;
+
+    /*
+     * Sessions being registered, and vector sets other workers have, may
+     * make more work at any time
+     */
+    if (active && (!*wait || *wait > 1)) {
+        *wait = 1;
     }
-    rv = acvp_json_serialize_to_file_pretty_w(ts_val, filename);
+    return NULL;
+}
+
+/*
+ * Logs in and registers the session, and sets up its pool of vector sets
+ */
+static ACVP_RESULT acvp_orch_register(ACVP_ORCH_SESSION *s) {
+    ACVP_CTX *ctx = s->ctx;
+    ACVP_STRING_LIST *vs_entry = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int count = 0;
+
+    rv = acvp_login(ctx, 0);
     if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("File write error. Check that directory exists and allows writes.");
-        goto end;
+        ACVP_LOG_ERR("Failed to login with ACVP server");
+        return rv;
     }
-
-    rv = acvp_json_serialize_to_file_pretty_a(NULL, filename);
+    rv = acvp_run_register(ctx, s->fips_validation, NULL);
     if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("File write error. Check that directory exists and allows writes.");
-        goto end;
+        return rv;
     }
 
-    if (ctx->session_file_path) {
-        free(ctx->session_file_path);
+    for (vs_entry = ctx->vsid_url_list; vs_entry; vs_entry = vs_entry->next) {
+        count++;
     }
-    ctx->session_file_path = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
-    if (strncpy_s(ctx->session_file_path, ACVP_JSON_FILENAME_MAX + 1, filename, 
-                  ACVP_JSON_FILENAME_MAX)) {
-        ACVP_LOG_ERR("Buffer write error while trying to save session file path to CTX");
-        rv = ACVP_UNSUPPORTED_OP;
-        goto end;
+    if (!count) {
+        return ACVP_MISSING_ARG;
     }
-
-    rv = ACVP_SUCCESS;
-end:
-    if (allocedPrefix && prefix) free(prefix);
-    if (ts_obj) json_object_soft_remove(ts_obj, "registration");
-    if (ts_val) json_value_free(ts_val);
-    free(filename);
-    return rv;
+    return acvp_pool_init(ctx, &s->pool, count, NULL, NULL, NULL);
 }
 
+/*
+ * Finishes the session once its vector sets are done, as acvp_run() does
+ */
+static ACVP_RESULT acvp_orch_results(ACVP_ORCH_SESSION *s) {
+    ACVP_CTX *ctx = s->ctx;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    rv = acvp_pool_result(&s->pool);
+    acvp_pool_free(&s->pool);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Failed to process vectors");
+        return rv;
+    }
+    /* Need to add the ending ']' here */
+    if (ctx->vector_req) {
+        rv = acvp_close_vector_req_file(ctx);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+    }
+    return acvp_run_results(ctx, s->fips_validation);
+}
 
+static void acvp_orch_swap_hnd(ACVP_ORCH_WORKER *worker, ACVP_CTX *ctx) {
+    void *hnd = ctx->exec.curl_hnd;
 
-ACVP_RESULT acvp_run(ACVP_CTX *ctx, int fips_validation) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    JSON_Value *val = NULL;
+    ctx->exec.curl_hnd = worker->curl_hnd;
+    worker->curl_hnd = hnd;
+}
 
-    if (ctx == NULL) return ACVP_NO_CTX;
+/*
+ * Processes a vector set of the session with an exec context of its own
+ */
+static void acvp_orch_run_job(ACVP_ORCH_WORKER *worker, ACVP_ORCH_SESSION *s, int index) {
+    ACVP_CTX *ctx = s->ctx, *exec = NULL;
 
-    rv = acvp_login(ctx, 0);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Failed to login with ACVP server");
-        goto end;
+    exec = acvp_create_exec_ctx(ctx);
+    if (!exec) {
+        ACVP_LOG_ERR("Unable to allocate a worker for vector set %s", s->pool.jobs[index].vsid_url);
+        acvp_pool_job_done(&s->pool, index, ACVP_MALLOC_FAIL);
+        return;
     }
+    exec->pool = &s->pool;
+    acvp_orch_swap_hnd(worker, exec);
+    acvp_pool_run_job(exec, index);
+    acvp_orch_swap_hnd(worker, exec);
+    acvp_free_exec_ctx(exec);
+}
 
+static void acvp_orch_worker(void *arg) {
+    ACVP_ORCH_WORKER *worker = (ACVP_ORCH_WORKER *)arg;
+    ACVP_ORCH *orch = worker->orch;
+    ACVP_ORCH_SESSION *s = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int index = 0, wait = 0;
 
-    if (ctx->get) { 
-        rv = acvp_transport_get(ctx, ctx->get_string, NULL);
-        if (ctx->save_filename) {
-            ACVP_LOG_STATUS("Saving GET result to specified file...");
-            val = json_parse_string(ctx->curl_buf);
-            if (!val) {
-                ACVP_LOG_ERR("Unable to parse JSON. printing output instead...");
-            } else {
-                rv = acvp_json_serialize_to_file_pretty_w(val, ctx->save_filename);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("Failed to write file, printing instead...");
-                } else {
-                    rv = acvp_json_serialize_to_file_pretty_a(NULL, ctx->save_filename);
-                    if (rv != ACVP_SUCCESS)
-                        ACVP_LOG_WARN("Unable to append ending ] to write file");
-                    goto end;
-                }
+    while (1) {
+        acvp_mutex_lock(&orch->lock);
+        s = acvp_orch_next_task(orch, &index, &wait);
+        acvp_mutex_unlock(&orch->lock);
+        if (!s) {
+            if (!wait) {
+                break;
             }
+            acvp_sleep(wait);
+            continue;
         }
-        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
-            printf("\n\n%s\n\n", ctx->curl_buf);
+        if (index >= 0) {
+            acvp_orch_run_job(worker, s, index);
+            continue;
+        }
+
+        acvp_orch_swap_hnd(worker, s->ctx);
+        if (s->state == ACVP_ORCH_REGISTERING) {
+            rv = acvp_orch_register(s);
         } else {
-            ACVP_LOG_STATUS("GET Response:\n\n%s\n", ctx->curl_buf);
+            rv = acvp_orch_results(s);
         }
-        goto end;
+        acvp_orch_swap_hnd(worker, s->ctx);
+
+        acvp_mutex_lock(&orch->lock);
+        s->rv = rv;
+        if (rv != ACVP_SUCCESS || s->state == ACVP_ORCH_RESULTS) {
+            acvp_pool_free(&s->pool);
+            s->state = ACVP_ORCH_DONE;
+        } else {
+            s->state = ACVP_ORCH_VECTORS;
+        }
+        acvp_mutex_unlock(&orch->lock);
     }
+}
 
-    if (ctx->post) { 
-        rv = acvp_post_data(ctx, ctx->post_filename);
-        goto end;
+ACVP_RESULT acvp_orch_run(ACVP_ORCH *orch) {
+    ACVP_ORCH_WORKER *workers = NULL;
+    ACVP_THREAD *threads = NULL;
+    ACVP_ORCH_SESSION *s = NULL;
+    int worker_cnt = 0, started = 0, i = 0;
+
+    if (!orch) {
+        return ACVP_MISSING_ARG;
+    }
+    if (!orch->session_cnt) {
+        return ACVP_NO_CTX;
+    }
+    if (orch->running) {
+        return ACVP_UNSUPPORTED_OP;
     }
 
-    if (ctx->delete) {
-        rv = acvp_transport_delete(ctx, ctx->delete_string);
-        if (ctx->save_filename) {
-            ACVP_LOG_STATUS("Saving DELETE response to specified file...");
-            val = json_parse_string(ctx->curl_buf);
-            if (!val) {
-                ACVP_LOG_ERR("Unable to parse JSON. printing output instead...");
-            } else {
-                rv = acvp_json_serialize_to_file_pretty_w(val, ctx->save_filename);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("Failed to write file, printing instead...");
-                } else {
-                    rv = acvp_json_serialize_to_file_pretty_a(NULL, ctx->save_filename);
-                    if (rv != ACVP_SUCCESS)
-                        ACVP_LOG_WARN("Unable to append ending ] to write file");
-                    goto end;
-                }
-            }
-        }
-        if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
-            printf("\n\n%s\n\n", ctx->curl_buf);
-        } else {
-            ACVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->curl_buf);
-        }
-        goto end;
+    worker_cnt = orch->max_workers;
+    workers = calloc(worker_cnt, sizeof(ACVP_ORCH_WORKER));
+    threads = calloc(worker_cnt, sizeof(ACVP_THREAD));
+    if (!workers || !threads) {
+        if (workers) free(workers);
+        if (threads) free(threads);
+        return ACVP_MALLOC_FAIL;
     }
 
-    if (fips_validation) {
-        rv = acvp_verify_fips_validation_metadata(ctx);
-        if (ACVP_SUCCESS != rv) {
-            ACVP_LOG_ERR("Issue(s) with validation metadata, not continuing with session.");
-            return ACVP_UNSUPPORTED_OP;
+    orch->running = 1;
+    orch->next_session = 0;
+    orch->curl_share = acvp_transport_share_new();
+    for (i = 0; i < orch->session_cnt; i++) {
+        if (orch->sessions[i].fips_validation) {
+            /* Without it each session just looks its metadata up itself */
+            orch->meta_share = acvp_meta_share_new();
+            break;
+        }
+    }
+    for (i = 0; i < orch->session_cnt; i++) {
+        s = &orch->sessions[i];
+        s->ctx->meta_share = orch->meta_share;
+        s->state = ACVP_ORCH_PENDING;
+        s->rv = ACVP_SUCCESS;
+        /* The pre-connect of the session uses its own share */
+        acvp_transport_preconnect_wait(s->ctx);
+        s->curl_share = s->ctx->curl_share;
+        if (orch->curl_share) {
+            s->ctx->curl_share = orch->curl_share;
         }
+    }
 
-        ctx->fips.do_validation = 1; /* Enable */
+    for (i = 0; i < worker_cnt; i++) {
+        workers[i].orch = orch;
+    }
+    if (worker_cnt == 1) {
+        acvp_orch_worker(&workers[0]);
+        started = 1;
     } else {
-        ctx->fips.do_validation = 0; /* Disable */
+        for (i = 0; i < worker_cnt; i++) {
+            if (acvp_thread_create(&threads[i], acvp_orch_worker, &workers[i]) != ACVP_SUCCESS) {
+                break;
+            }
+            started++;
+        }
+        if (!started) {
+            /* Still get the sessions done, on this thread */
+            acvp_orch_worker(&workers[0]);
+            started = 1;
+        } else {
+            for (i = 0; i < started; i++) {
+                acvp_thread_join(threads[i]);
+            }
+        }
     }
 
-    /*
-     * Register with the server to advertise our capabilities and receive
-     * the vector sets identifiers.
-     */
-    rv = acvp_register(ctx);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Failed to register with ACVP server");
-        goto end;
+    for (i = 0; i < started; i++) {
+        acvp_transport_free_handle(workers[i].curl_hnd);
     }
-    
-    //write session info so if we time out or lose connection waiting for results, we can recheck later on
-    if (!ctx->put) {
-        if (acvp_write_session_info(ctx) != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("Error writing the session info file. Continuing, but session will not be able to be resumed or checked later on");
+    for (i = 0; i < orch->session_cnt; i++) {
+        orch->sessions[i].ctx->curl_share = orch->sessions[i].curl_share;
+        orch->sessions[i].ctx->meta_share = NULL;
+    }
+    acvp_transport_share_free(orch->curl_share);
+    orch->curl_share = NULL;
+    acvp_meta_share_free(orch->meta_share);
+    orch->meta_share = NULL;
+    orch->running = 0;
+    free(workers);
+    free(threads);
+
+    for (i = 0; i < orch->session_cnt; i++) {
+        if (orch->sessions[i].rv != ACVP_SUCCESS) {
+            return orch->sessions[i].rv;
         }
     }
+    return ACVP_SUCCESS;
+}
 
-    ACVP_LOG_STATUS("Beginning to download and process vector sets...");
+ACVP_RESULT acvp_orch_get_result(ACVP_ORCH *orch, ACVP_CTX *ctx, ACVP_RESULT *result) {
+    ACVP_ORCH_SESSION *s = NULL;
 
-    /*
-     * Now we process the test cases given to us during
-     * registration earlier.
-     */
-    rv = acvp_process_tests(ctx);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Failed to process vectors");
-        goto end;
+    if (!orch || !result) {
+        return ACVP_MISSING_ARG;
     }
-    if (ctx->vector_req) {
-        ACVP_LOG_STATUS("Successfully downloaded vector sets and saved to specified file.");
-        return ACVP_SUCCESS;
+    if (!ctx) {
+        return ACVP_NO_CTX;
     }
-
-    /*
-     * Check the test results.
-     */
-    ACVP_LOG_STATUS("Tests complete, checking results...");
-    rv = acvp_check_test_results(ctx);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Unable to retrieve test results");
-        goto end;
+    s = acvp_orch_find(orch, ctx);
+    if (!s) {
+        return ACVP_INVALID_ARG;
     }
+    *result = s->rv;
+    return ACVP_SUCCESS;
+}
 
-    if (fips_validation) {
-        /*
-         * Tell the server to provision a FIPS certificate for this testSession.
-         */
-        rv = acvp_validate_test_session(ctx);
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("Failed to perform Validation of testSession");
-            goto end;
-        }
+void acvp_orch_free(ACVP_ORCH *orch) {
+    if (!orch) {
+        return;
     }
-
-   if (ctx->put) {
-       rv = acvp_put_data_from_ctx(ctx);
-   }
-end:
-    if (val) json_value_free(val);
-    return rv;
+    if (orch->sessions) free(orch->sessions);
+    acvp_mutex_destroy(&orch->lock);
+    free(orch);
 }
 
 const char *acvp_version(void) {
@@ -3750,6 +7020,7 @@ ACVP_RESULT acvp_put_data_from_file(ACVP_CTX *ctx, const char *put_filename) {
             goto end;
         }
         strcpy_s(ctx->jwt_token, ACVP_JWT_TOKEN_MAX + 1, jwt);
+        ctx->jwt_expiry = acvp_jwt_expiry(ctx->jwt_token);
     } else {
         rv = acvp_login(ctx, 0);
         if (rv != ACVP_SUCCESS) {
@@ -3799,7 +7070,7 @@ ACVP_RESULT acvp_put_data_from_file(ACVP_CTX *ctx, const char *put_filename) {
             ACVP_LOG_STATUS("Failed to parse Validation response");
         }
     } else {
-        ACVP_LOG_STATUS("PUT response: \n%s", ctx->curl_buf);
+        ACVP_LOG_STATUS("PUT response: \n%s", ctx->exec.curl_buf);
     }
 end:
     if (json_result) {json_free_serialized_string(json_result);}
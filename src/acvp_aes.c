@@ -55,18 +55,57 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
                                     int seq_num,
                                     ACVP_SYM_CIPH_SALT_SRC salt_src);
 
-static ACVP_RESULT acvp_aes_release_tc(ACVP_SYM_CIPHER_TC *stc);
+static ACVP_RESULT acvp_aes_release_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc);
+
+static ACVP_RESULT acvp_aes_run_batch(ACVP_CTX *ctx,
+                                      ACVP_CAPS_LIST *cap,
+                                      ACVP_TC_BATCH *batch,
+                                      JSON_Array *r_tarr);
+
+static void acvp_aes_release_batch(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC **stcs, ACVP_TC_BATCH *batch);
+
+static ACVP_RESULT acvp_aes_run_soa(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch);
+
+static unsigned int acvp_aes_data_units(const ACVP_SYM_CIPHER_TC *stc);
+
+static ACVP_RESULT acvp_aes_run_data_units(ACVP_CTX *ctx,
+                                           ACVP_CAPS_LIST *cap,
+                                           ACVP_TEST_CASE *tcs,
+                                           int *results,
+                                           int count);
+
+/*
+ * MCT values are a single block, IV or key; twice the largest key covers
+ * any of them in hex
+ */
+#define ACVP_AES_MCT_HEX_MAX (2 * ACVP_SYM_KEY_MAX_BYTES)
+
+/* Bytes of pt/ct beyond the payload that modules and MCT may write */
+#define ACVP_AES_TC_HEADROOM 32
 
-#define KEY_COL_LEN 101
 #define KEY_ROW_LEN 32
-#define IV_COL_LEN 101
 #define IV_ROW_LEN 16
-#define TEXT_COL_LEN 1001
 #define TEXT_ROW_LEN 32
-static unsigned char mkey[KEY_COL_LEN][KEY_ROW_LEN];
-static unsigned char miv[IV_COL_LEN][IV_ROW_LEN];
-static unsigned char ptext[TEXT_COL_LEN][TEXT_ROW_LEN];
-static unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
+
+/*
+ * The MCT only ever looks back a bounded number of inner iterations (at most
+ * one per key bit, for CFB1 with a 256 bit key) and writes at most one row
+ * ahead, so the history of pt/ct values is kept in a ring rather than one row
+ * per iteration. The ring size must be a power of two.
+ */
+#define MCT_HIST_LEN 512
+#define MCT_ROW(j) ((j) & (MCT_HIST_LEN - 1))
+
+/*
+ * Monte Carlo history for one test case. It lives on the stack of
+ * acvp_aes_mct_tc() so that MCT groups may be run concurrently.
+ */
+typedef struct acvp_aes_mct_state_t {
+    unsigned char key[KEY_ROW_LEN];             /* Key at the start of the outer iteration */
+    unsigned char iv[2][IV_ROW_LEN];            /* IV of outer iteration i is at i & 1 */
+    unsigned char ptext[MCT_HIST_LEN][TEXT_ROW_LEN];
+    unsigned char ctext[MCT_HIST_LEN][TEXT_ROW_LEN];
+} ACVP_AES_MCT_STATE;
 
 #define gb(a, b) (((a)[(b) / 8] >> (7 - (b) % 8)) & 1)
 #define sb(a, b, v) ((a)[(b) / 8] = ((a)[(b) / 8] & ~(1 << (7 - (b) % 8))) | (!!(v) << (7 - (b) % 8)))
@@ -76,19 +115,20 @@ static unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
  * and/or pt/ct information may need to be modified.  This function
  * performs the iteration depdedent upon the cipher type and direction.
  */
-static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc, int i) {
+static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc,
+                                           ACVP_AES_MCT_STATE *st, int i) {
     int j = stc->mct_index;
     ACVP_SUB_AES alg;
 
     if (stc->cipher != ACVP_AES_CFB1) {
-        memcpy_s(ctext[j], TEXT_ROW_LEN, stc->ct, stc->ct_len);
-        memcpy_s(ptext[j], TEXT_ROW_LEN, stc->pt, stc->pt_len);
+        memcpy_s(st->ctext[MCT_ROW(j)], TEXT_ROW_LEN, stc->ct, stc->ct_len);
+        memcpy_s(st->ptext[MCT_ROW(j)], TEXT_ROW_LEN, stc->pt, stc->pt_len);
     } else {
-        ctext[j][0] = stc->ct[0];
-        ptext[j][0] = stc->pt[0];
+        st->ctext[MCT_ROW(j)][0] = stc->ct[0];
+        st->ptext[MCT_ROW(j)][0] = stc->pt[0];
     }
     if (j == 0) {
-        memcpy_s(mkey[j], KEY_ROW_LEN, stc->key, stc->key_len / 8);
+        memcpy_s(st->key, KEY_ROW_LEN, stc->key, stc->key_len / 8);
     }
 
     alg = acvp_get_aes_alg(stc->cipher);
@@ -100,9 +140,9 @@ static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *st
     switch (alg) {
     case ACVP_SUB_AES_ECB:
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-            memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, ctext[j], stc->ct_len);
+            memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->ctext[MCT_ROW(j)], stc->ct_len);
         } else {
-            memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, ptext[j], stc->pt_len);
+            memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, st->ptext[MCT_ROW(j)], stc->pt_len);
         }
         break;
     case ACVP_SUB_AES_CBC:
@@ -116,11 +156,11 @@ static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *st
             }
         } else {
             if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, ctext[j - 1], stc->ct_len);
-                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, ctext[j], stc->ct_len);
+                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->ctext[MCT_ROW(j - 1)], stc->ct_len);
+                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, st->ctext[MCT_ROW(j)], stc->ct_len);
             } else {
-                memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, ptext[j - 1], stc->pt_len);
-                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, ptext[j], stc->pt_len);
+                memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, st->ptext[MCT_ROW(j - 1)], stc->pt_len);
+                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, st->ptext[MCT_ROW(j)], stc->pt_len);
             }
         }
         break;
@@ -129,31 +169,31 @@ static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *st
             if (j < 16) {
                 memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, &stc->iv[j], stc->iv_len);
             } else {
-                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, ctext[j - 16], stc->ct_len);
+                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->ctext[MCT_ROW(j - 16)], stc->ct_len);
             }
         } else {
             if (j < 16) {
                 memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, &stc->iv[j], stc->iv_len);
             } else {
-                memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, ptext[j - 16], stc->pt_len);
+                memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, st->ptext[MCT_ROW(j - 16)], stc->pt_len);
             }
         }
         break;
     case ACVP_SUB_AES_CFB1:
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             if (j < 128) {
-                sb(ptext[j + 1], 0, gb(miv[i], j));
+                sb(st->ptext[MCT_ROW(j + 1)], 0, gb(st->iv[i & 1], j));
             } else {
-                sb(ptext[j + 1], 0, gb(ctext[j - 128], 0));
+                sb(st->ptext[MCT_ROW(j + 1)], 0, gb(st->ctext[MCT_ROW(j - 128)], 0));
             }
-            stc->pt[0] = ptext[j + 1][0];
+            stc->pt[0] = st->ptext[MCT_ROW(j + 1)][0];
         } else {
             if (j < 128) {
-                sb(ctext[j + 1], 0, gb(miv[i], j));
+                sb(st->ctext[MCT_ROW(j + 1)], 0, gb(st->iv[i & 1], j));
             } else {
-                sb(ctext[j + 1], 0, gb(ptext[j - 128], 0));
+                sb(st->ctext[MCT_ROW(j + 1)], 0, gb(st->ptext[MCT_ROW(j - 128)], 0));
             }
-            stc->ct[0] = ctext[j + 1][0];
+            stc->ct[0] = st->ctext[MCT_ROW(j + 1)][0];
         }
         break;
     case ACVP_SUB_AES_CBC_CS1:
@@ -175,6 +215,75 @@ static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *st
     return ACVP_SUCCESS;
 }
 
+/*
+ * Runs one inner loop of an MCT through the capability's MCT handler. The
+ * history the outer iteration looks back on is rebuilt from the tail of the
+ * output stream the crypto module hands back, and the last inner iteration
+ * is then adjusted for like any other, so the checkpoint and the next one
+ * come out exactly as if every block had gone through the crypto_handler.
+ */
+static ACVP_RESULT acvp_aes_mct_inner_offload(ACVP_CTX *ctx,
+                                              ACVP_CAPS_LIST *cap,
+                                              ACVP_TEST_CASE *tc,
+                                              ACVP_SYM_CIPHER_TC *stc,
+                                              ACVP_AES_MCT_STATE *st,
+                                              int i) {
+    unsigned char tail[ACVP_SYM_MCT_TAIL_LEN] = { 0 };
+    unsigned char (*out)[TEXT_ROW_LEN] = NULL;
+    int j = ACVP_AES_MCT_INNER - 1, k = 0, rc = 0;
+
+    memcpy_s(st->key, KEY_ROW_LEN, stc->key, stc->key_len / 8);
+
+    stc->mct_index = 0;
+    stc->mct_tail = tail;
+    rc = acvp_crypto_call(ctx, cap->mct_handler, tc);
+    stc->mct_tail = NULL;
+    if (rc) {
+        ACVP_LOG_ERR("crypto module failed the MCT operation");
+        return ACVP_CRYPTO_MODULE_FAIL;
+    }
+
+    out = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? st->ctext : st->ptext;
+    switch (acvp_get_aes_alg(stc->cipher)) {
+    case ACVP_SUB_AES_CFB1:
+        for (k = 0; k < ACVP_SYM_MCT_TAIL_LEN * 8; k++) {
+            out[MCT_ROW(j - k)][0] = gb(tail, ACVP_SYM_MCT_TAIL_LEN * 8 - 1 - k) << 7;
+        }
+        break;
+    case ACVP_SUB_AES_CFB8:
+        for (k = 0; k < ACVP_SYM_MCT_TAIL_LEN; k++) {
+            out[MCT_ROW(j - k)][0] = tail[ACVP_SYM_MCT_TAIL_LEN - 1 - k];
+        }
+        break;
+    case ACVP_SUB_AES_ECB:
+    case ACVP_SUB_AES_CBC:
+    case ACVP_SUB_AES_OFB:
+    case ACVP_SUB_AES_CFB128:
+    case ACVP_SUB_AES_GCM:
+    case ACVP_SUB_AES_GCM_SIV:
+    case ACVP_SUB_AES_CCM:
+    case ACVP_SUB_AES_CBC_CS1:
+    case ACVP_SUB_AES_CBC_CS2:
+    case ACVP_SUB_AES_CBC_CS3:
+    case ACVP_SUB_AES_CTR:
+    case ACVP_SUB_AES_XTS:
+    case ACVP_SUB_AES_XPN:
+    case ACVP_SUB_AES_KW:
+    case ACVP_SUB_AES_KWP:
+    case ACVP_SUB_AES_GMAC:
+    default:
+        /* One 16 byte block per iteration */
+        for (k = 0; k < ACVP_SYM_MCT_TAIL_LEN / 16; k++) {
+            memcpy_s(out[MCT_ROW(j - k)], TEXT_ROW_LEN,
+                     tail + ACVP_SYM_MCT_TAIL_LEN - (k + 1) * 16, 16);
+        }
+        break;
+    }
+
+    stc->mct_index = j;
+    return acvp_aes_mct_iterate_tc(ctx, stc, st, i);
+}
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -183,68 +292,36 @@ static ACVP_RESULT acvp_aes_mct_iterate_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *st
  */
 static ACVP_RESULT acvp_aes_output_mct_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc, JSON_Object *r_tobj) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_SYM_CT_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
-    rv = acvp_bin_to_hexstr(stc->key, stc->key_len / 8, tmp, ACVP_SYM_CT_MAX);
+    rv = acvp_json_set_hex(r_tobj, "key", stc->key, stc->key_len / 8, ACVP_AES_MCT_HEX_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (key)");
         goto end;
     }
-    json_object_set_string(r_tobj, "key", tmp);
 
     if (stc->cipher != ACVP_AES_ECB) {
-        memzero_s(tmp, ACVP_SYM_CT_MAX);
-        rv = acvp_bin_to_hexstr(stc->iv, stc->iv_len, tmp, ACVP_SYM_CT_MAX);
+        rv = acvp_json_set_hex(r_tobj, "iv", stc->iv, stc->iv_len, ACVP_AES_MCT_HEX_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (iv)");
             goto end;
         }
-        json_object_set_string(r_tobj, "iv", tmp);
     }
 
     if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-        memzero_s(tmp, ACVP_SYM_CT_MAX);
-
-        if (stc->cipher == ACVP_AES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->pt, 1, tmp, ACVP_SYM_PT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (pt)");
-                goto end;
-            }
-        } else {
-            rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_SYM_PT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (pt)");
-                goto end;
-            }
+        rv = acvp_json_set_hex(r_tobj, "pt", stc->pt, stc->cipher == ACVP_AES_CFB1 ? 1 : stc->pt_len, ACVP_AES_MCT_HEX_MAX);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("hex conversion failure (pt)");
+            goto end;
         }
-        json_object_set_string(r_tobj, "pt", tmp);
     } else {
-        memzero_s(tmp, ACVP_SYM_CT_MAX);
-        if (stc->cipher == ACVP_AES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->ct, 1, tmp, ACVP_SYM_CT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (ct)");
-                goto end;
-            }
-        } else {
-            rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp, ACVP_SYM_CT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (ct)");
-                goto end;
-            }
+        rv = acvp_json_set_hex(r_tobj, "ct", stc->ct, stc->cipher == ACVP_AES_CFB1 ? 1 : stc->ct_len, ACVP_AES_MCT_HEX_MAX);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("hex conversion failure (ct)");
+            goto end;
         }
-        json_object_set_string(r_tobj, "ct", tmp);
     }
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -264,17 +341,13 @@ static ACVP_RESULT acvp_aes_mct_tc(ACVP_CTX *ctx,
     ACVP_RESULT rv;
     JSON_Value *r_tval = NULL;  /* Response testval */
     JSON_Object *r_tobj = NULL; /* Response testobj */
-    char *tmp = NULL;
 #define MCT_CT_LEN 68 /* 64 + 4 */
     unsigned char ciphertext[MCT_CT_LEN] = { 0 };
+    ACVP_AES_MCT_STATE st;
 
-    tmp = calloc(ACVP_SYM_CT_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
+    memzero_s(&st, sizeof(ACVP_AES_MCT_STATE));
 
-    memcpy_s(miv[0], IV_ROW_LEN, stc->iv, stc->iv_len);
+    memcpy_s(st.iv[0], IV_ROW_LEN, stc->iv, stc->iv_len);
     for (i = 0; i < ACVP_AES_MCT_OUTER; ++i) {
         /*
          * Create a new test case in the response
@@ -289,16 +362,21 @@ static ACVP_RESULT acvp_aes_mct_tc(ACVP_CTX *ctx,
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("JSON output failure in AES module");
             json_value_free(r_tval);
-            free(tmp);
             return rv;
         }
 
-        for (j = 0; j < ACVP_AES_MCT_INNER; ++j) {
+        if (cap->mct_handler) {
+            rv = acvp_aes_mct_inner_offload(ctx, cap, tc, stc, &st, i);
+            if (rv != ACVP_SUCCESS) {
+                json_value_free(r_tval);
+                return rv;
+            }
+        }
+        for (j = 0; j < ACVP_AES_MCT_INNER && !cap->mct_handler; ++j) {
             stc->mct_index = j;    /* indicates init vs. update */
             /* Process the current AES encrypt test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
-                free(tmp);
                 json_value_free(r_tval);
                 return ACVP_CRYPTO_MODULE_FAIL;
             }
@@ -306,68 +384,55 @@ static ACVP_RESULT acvp_aes_mct_tc(ACVP_CTX *ctx,
             /*
              * Adjust the parameters for next iteration if needed.
              */
-            rv = acvp_aes_mct_iterate_tc(ctx, stc, i);
+            rv = acvp_aes_mct_iterate_tc(ctx, stc, &st, i);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Failed the MCT iteration changes");
-                free(tmp);
                 return rv;
             }
         }
 
         j = 999;
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-            memzero_s(tmp, ACVP_SYM_CT_MAX);
-            if (stc->cipher == ACVP_AES_CFB1) {
-                rv = acvp_bin_to_hexstr(stc->ct, 1, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (ct)");
-                    free(tmp);
-                    return rv;
-                }
-            } else {
-                rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (ct)");
-                    free(tmp);
-                    return rv;
-                }
+            rv = acvp_json_set_hex(r_tobj, "ct", stc->ct, stc->cipher == ACVP_AES_CFB1 ? 1 : stc->ct_len, ACVP_AES_MCT_HEX_MAX);
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("hex conversion failure (ct)");
+                return rv;
             }
-            json_object_set_string(r_tobj, "ct", tmp);
 
             if (stc->cipher == ACVP_AES_CFB8) {
                 /* ct = CT[j-15] || CT[j-14] || ... || CT[j] */
                 for (n1 = 0, n2 = stc->key_len / 8 - 1; n1 < stc->key_len / 8; ++n1, --n2) {
-                    ciphertext[n1] = ctext[j - n2][0];
+                    ciphertext[n1] = st.ctext[MCT_ROW(j - n2)][0];
                 }
 
                 /* IV[i+1] = ct */
                 for (n1 = 0, n2 = 15; n1 < 16; ++n1, --n2) {
-                    stc->iv[n1] = ctext[j - n2][0];
+                    stc->iv[n1] = st.ctext[MCT_ROW(j - n2)][0];
                 }
-                ptext[0][0] = ctext[j - 16][0];
+                st.ptext[0][0] = st.ctext[MCT_ROW(j - 16)][0];
             } else if (stc->cipher == ACVP_AES_CFB1) {
                 for (n1 = 0, n2 = stc->key_len - 1; n1 < stc->key_len; ++n1, --n2) {
-                    sb(ciphertext, n1, gb(ctext[j - n2], 0));
+                    sb(ciphertext, n1, gb(st.ctext[MCT_ROW(j - n2)], 0));
                 }
 
                 for (n1 = 0, n2 = 127; n1 < 128; ++n1, --n2) {
-                    sb(miv[i + 1], n1, gb(ctext[j - n2], 0));
+                    sb(st.iv[(i + 1) & 1], n1, gb(st.ctext[MCT_ROW(j - n2)], 0));
                 }
-                ptext[0][0] = ctext[j - 128][0] & 0x80;
-                stc->pt[0] = ptext[0][0];
-                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, miv[i + 1], stc->iv_len);
+                st.ptext[0][0] = st.ctext[MCT_ROW(j - 128)][0] & 0x80;
+                stc->pt[0] = st.ptext[0][0];
+                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, st.iv[(i + 1) & 1], stc->iv_len);
             } else {
                 switch (stc->key_len) {
                 case 128:
-                    memcpy_s(ciphertext, MCT_CT_LEN, ctext[j], 16);
+                    memcpy_s(ciphertext, MCT_CT_LEN, st.ctext[MCT_ROW(j)], 16);
                     break;
                 case 192:
-                    memcpy_s(ciphertext, MCT_CT_LEN, ctext[j - 1] + 8, 8);
-                    memcpy_s(ciphertext + 8, (MCT_CT_LEN - 8), ctext[j], 16);
+                    memcpy_s(ciphertext, MCT_CT_LEN, st.ctext[MCT_ROW(j - 1)] + 8, 8);
+                    memcpy_s(ciphertext + 8, (MCT_CT_LEN - 8), st.ctext[MCT_ROW(j)], 16);
                     break;
                 case 256:
-                    memcpy_s(ciphertext, MCT_CT_LEN, ctext[j - 1], 16);
-                    memcpy_s(ciphertext + 16, (MCT_CT_LEN - 16), ctext[j], 16);
+                    memcpy_s(ciphertext, MCT_CT_LEN, st.ctext[MCT_ROW(j - 1)], 16);
+                    memcpy_s(ciphertext + 16, (MCT_CT_LEN - 16), st.ctext[MCT_ROW(j)], 16);
                     break;
                 default:
                     ACVP_LOG_ERR("Illegal case switch %d", stc->key_len);
@@ -375,60 +440,46 @@ static ACVP_RESULT acvp_aes_mct_tc(ACVP_CTX *ctx,
                 }
             }
         } else {
-            memzero_s(tmp, ACVP_SYM_CT_MAX);
-
-            if (stc->cipher == ACVP_AES_CFB1) {
-                rv = acvp_bin_to_hexstr(stc->pt, 1, tmp, ACVP_SYM_PT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (pt)");
-                    json_value_free(r_tval);
-                    free(tmp);
-                    return rv;
-                }
-            } else {
-                rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (pt)");
-                    free(tmp);
-                    json_value_free(r_tval);
-                    return rv;
-                }
+            rv = acvp_json_set_hex(r_tobj, "pt", stc->pt, stc->cipher == ACVP_AES_CFB1 ? 1 : stc->pt_len, ACVP_AES_MCT_HEX_MAX);
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("hex conversion failure (pt)");
+                json_value_free(r_tval);
+                return rv;
             }
-            json_object_set_string(r_tobj, "pt", tmp);
 
             if (stc->cipher == ACVP_AES_CFB8) {
                 /* ct = CT[j-15] || CT[j-14] || ... || CT[j] */
                 for (n1 = 0, n2 = stc->key_len / 8 - 1; n1 < stc->key_len / 8; ++n1, --n2) {
-                    ciphertext[n1] = ptext[j - n2][0];
+                    ciphertext[n1] = st.ptext[MCT_ROW(j - n2)][0];
                 }
 
                 for (n1 = 0, n2 = 15; n1 < 16; ++n1, --n2) {
-                    stc->iv[n1] = ptext[j - n2][0];
+                    stc->iv[n1] = st.ptext[MCT_ROW(j - n2)][0];
                 }
-                ctext[0][0] = ptext[j - 16][0];
+                st.ctext[0][0] = st.ptext[MCT_ROW(j - 16)][0];
             } else if (stc->cipher == ACVP_AES_CFB1) {
                 for (n1 = 0, n2 = stc->key_len - 1; n1 < stc->key_len; ++n1, --n2) {
-                    sb(ciphertext, n1, gb(ptext[j - n2], 0));
+                    sb(ciphertext, n1, gb(st.ptext[MCT_ROW(j - n2)], 0));
                 }
 
                 for (n1 = 0, n2 = 127; n1 < 128; ++n1, --n2) {
-                    sb(miv[i + 1], n1, gb(ptext[j - n2], 0));
+                    sb(st.iv[(i + 1) & 1], n1, gb(st.ptext[MCT_ROW(j - n2)], 0));
                 }
-                ctext[0][0] = ptext[j - 128][0] & 0x80;
-                stc->ct[0] = ctext[0][0];
-                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, miv[i + 1], stc->iv_len);
+                st.ctext[0][0] = st.ptext[MCT_ROW(j - 128)][0] & 0x80;
+                stc->ct[0] = st.ctext[0][0];
+                memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX, st.iv[(i + 1) & 1], stc->iv_len);
             } else {
                 switch (stc->key_len) {
                 case 128:
-                    memcpy_s(ciphertext, MCT_CT_LEN, ptext[j], 16);
+                    memcpy_s(ciphertext, MCT_CT_LEN, st.ptext[MCT_ROW(j)], 16);
                     break;
                 case 192:
-                    memcpy_s(ciphertext, MCT_CT_LEN, ptext[j - 1] + 8, 8);
-                    memcpy_s(ciphertext + 8, (MCT_CT_LEN - 8), ptext[j], 16);
+                    memcpy_s(ciphertext, MCT_CT_LEN, st.ptext[MCT_ROW(j - 1)] + 8, 8);
+                    memcpy_s(ciphertext + 8, (MCT_CT_LEN - 8), st.ptext[MCT_ROW(j)], 16);
                     break;
                 case 256:
-                    memcpy_s(ciphertext, MCT_CT_LEN, ptext[j - 1], 16);
-                    memcpy_s(ciphertext + 16, (MCT_CT_LEN - 16), ptext[j], 16);
+                    memcpy_s(ciphertext, MCT_CT_LEN, st.ptext[MCT_ROW(j - 1)], 16);
+                    memcpy_s(ciphertext + 16, (MCT_CT_LEN - 16), st.ptext[MCT_ROW(j)], 16);
                     break;
                 default:
                     ACVP_LOG_ERR("Illegal case switch %d", stc->key_len);
@@ -439,14 +490,12 @@ static ACVP_RESULT acvp_aes_mct_tc(ACVP_CTX *ctx,
 
         /* create the key for the next loop */
         for (n = 0; n < stc->key_len / 8; ++n) {
-            stc->key[n] = mkey[0][n] ^ ciphertext[n];
+            stc->key[n] = st.key[n] ^ ciphertext[n];
         }
 
         /* Append the test response value to array */
         json_array_append_value(res_array, r_tval);
     }
-
-    free(tmp);
     return ACVP_SUCCESS;
 }
 
@@ -643,9 +692,11 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_SYM_CIPHER_TC stc;
+    ACVP_SYM_CIPHER_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
     ACVP_TEST_CASE tc;
+    ACVP_TC_BATCH batch;
+    int use_batch = 0;
     ACVP_RESULT rv;
-    char *json_result = NULL;
     const char *alg_str = NULL;
     const char *tw_mode = NULL;
     ACVP_CIPHER alg_id = 0;
@@ -670,6 +721,7 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
 
     tc.tc.symmetric = &stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     /* Get the crypto module handler for AES mode */
     alg_id = acvp_lookup_cipher_index(alg_str);
@@ -694,7 +746,7 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
 
     /* Start to build the JSON response */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -724,15 +776,15 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON group obj");
             rv = ACVP_TC_MISSING_DATA;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         dir_str = json_object_get_string(groupobj, "direction");
         if (!dir_str) {
@@ -971,6 +1023,24 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Groups other than MCT are set up in one piece, then run together,
+         * when batching or parallel test cases were asked for
+         */
+        use_batch = acvp_tc_batch_enabled(ctx, cap) &&
+                    test_type != ACVP_SYM_TEST_TYPE_MCT && t_cnt > 0;
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_SYM_CIPHER_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             const char *pt = NULL, *ct = NULL, *iv = NULL,
                        *key = NULL, *tag = NULL, *aad = NULL, *salt = NULL;
@@ -981,7 +1051,7 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!json_object_has_value(testobj, "tcId")) {
                 ACVP_LOG_ERR("Server JSON missing 'tcId'");
                 rv = ACVP_TC_MISSING_DATA;
@@ -1020,8 +1090,8 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             }
 
             if (dir == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-                unsigned int tmp_pt_len = 0;
-                pt = json_object_get_string(testobj, "pt");
+                int tmp_pt_len = 0;
+                pt = acvp_json_get_string_n(testobj, "pt", &tmp_pt_len);
                 if (alg_id == ACVP_AES_GMAC) {
                     if (pt) {
                         ACVP_LOG_ERR("'pt' not allowed for AES-GMAC");
@@ -1034,7 +1104,6 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                         rv = ACVP_TC_MISSING_DATA;
                         goto err;
                     }
-                    tmp_pt_len = strnlen_s(pt, ACVP_SYM_PT_MAX + 1);
                     if (tmp_pt_len > ACVP_SYM_PT_MAX) {
                         ACVP_LOG_ERR("'pt' too long, max allowed=(%d)",
                                     ACVP_SYM_PT_MAX);
@@ -1043,9 +1112,9 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                     }
                 }
             } else {
-                unsigned int tmp_ct_len = 0;
+                int tmp_ct_len = 0;
 
-                ct = json_object_get_string(testobj, "ct");
+                ct = acvp_json_get_string_n(testobj, "ct", &tmp_ct_len);
                 if (alg_id == ACVP_AES_GMAC) {
                     if (ct) {
                         ACVP_LOG_ERR("'ct' not allowed for AES-GMAC");
@@ -1058,7 +1127,6 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                         rv = ACVP_TC_MISSING_DATA;
                         goto err;
                     }
-                    tmp_ct_len = strnlen_s(ct, ACVP_SYM_CT_MAX + 1);
                     if (tmp_ct_len > ACVP_SYM_CT_MAX) {
                         ACVP_LOG_ERR("'ct' too long, max allowed=(%d)",
                                     ACVP_SYM_CT_MAX);
@@ -1203,16 +1271,24 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_aes_init_tc(ctx, &stc, tc_id, test_type, key, pt, ct, iv, tag, 
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_aes_init_tc(ctx, cur, tc_id, test_type, key, pt, ct, iv, tag, 
                                   aad, salt, kwcipher, keylen, ivlen, datalen, paylen,
                                   taglen, aadlen, saltLen, dataUnitLen, conformance, alg_id, dir, iv_gen,
                                   iv_gen_mode, incr_ctr, ovrflw_ctr, tweak_mode, seq_num, salt_src);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Init for stc (test case) failed");
-                acvp_aes_release_tc(&stc);
+                acvp_aes_release_tc(ctx, cur);
+                json_value_free(r_tval);
                 goto err;
             }
 
+            if (use_batch) {
+                /* Processed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.symmetric = cur;
+                continue;
+            }
+
             /* If Monte Carlo start that here */
             if (stc.test_type == ACVP_SYM_TEST_TYPE_MCT) {
                 json_object_set_value(r_tobj, "resultsArray", json_value_init_array());
@@ -1221,18 +1297,29 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("crypto module failed the MCT operation");
                     json_value_free(r_tval);
-                    acvp_aes_release_tc(&stc);
+                    acvp_aes_release_tc(ctx, &stc);
                     goto err;
                 }
             } else {
                 /* Process the current AES KAT test vector... */
-                int t_rv = (cap->crypto_handler)(&tc);
+                int t_rv = 0;
+
+                if (acvp_aes_data_units(&stc) > 1) {
+                    rv = acvp_aes_run_data_units(ctx, cap, &tc, &t_rv, 1);
+                    if (rv != ACVP_SUCCESS) {
+                        acvp_aes_release_tc(ctx, &stc);
+                        json_value_free(r_tval);
+                        goto err;
+                    }
+                } else {
+                    t_rv = acvp_crypto_call(ctx, cap->crypto_handler, &tc);
+                }
                 if (t_rv) {
                     if (alg_id != ACVP_AES_KW && alg_id != ACVP_AES_GCM &&
-                            alg_id != ACVP_AES_GCM_SIV && alg_id != ACVP_AES_CCM 
-                            && alg_id != ACVP_AES_KWP && alg_id != ACVP_AES_GMAC) {
+                            alg_id != ACVP_AES_GCM_SIV && alg_id != ACVP_AES_CCM &&
+                            alg_id != ACVP_AES_XPN && alg_id != ACVP_AES_KWP && alg_id != ACVP_AES_GMAC) {
                         ACVP_LOG_ERR("ERROR: crypto module failed the operation");
-                        acvp_aes_release_tc(&stc);
+                        acvp_aes_release_tc(ctx, &stc);
                         json_value_free(r_tval);
                         rv = ACVP_CRYPTO_MODULE_FAIL;
                         goto err;
@@ -1246,7 +1333,7 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("JSON output failure in AES module");
                     json_value_free(r_tval);
-                    acvp_aes_release_tc(&stc);
+                    acvp_aes_release_tc(ctx, &stc);
                     goto err;
                 }
             }
@@ -1254,27 +1341,435 @@ ACVP_RESULT acvp_aes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /*
              * Release all the memory associated with the test case
              */
-            acvp_aes_release_tc(&stc);
+            acvp_aes_release_tc(ctx, &stc);
 
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        if (use_batch) {
+            rv = acvp_aes_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_aes_release_batch(ctx, &stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     json_array_append_value(reg_arry, r_vs_val);
     rv = ACVP_SUCCESS;
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
 
 err:
+    acvp_aes_release_batch(ctx, &stcs, &batch);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
 
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ * As with single test cases, a failed test case is only an error for the
+ * modes where failure is not itself a valid result.
+ */
+static ACVP_RESULT acvp_aes_run_batch(ACVP_CTX *ctx,
+                                      ACVP_CAPS_LIST *cap,
+                                      ACVP_TC_BATCH *batch,
+                                      JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    ACVP_CIPHER alg_id = cap->cipher;
+    int i = 0, split = 0;
+
+    for (i = 0; i < batch->count && !split; i++) {
+        split = acvp_aes_data_units(batch->tcs[i].tc.symmetric) > 1;
+    }
+    if (split) {
+        rv = acvp_aes_run_data_units(ctx, cap, batch->tcs, batch->results, batch->count);
+    } else if (cap->soa_handler && batch->count &&
+            batch->tcs[0].tc.symmetric->test_type == ACVP_SYM_TEST_TYPE_AFT) {
+        rv = acvp_aes_run_soa(ctx, cap, batch);
+    } else {
+        rv = acvp_tc_batch_run(ctx, cap, batch);
+    }
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            if (alg_id != ACVP_AES_KW && alg_id != ACVP_AES_GCM &&
+                    alg_id != ACVP_AES_GCM_SIV && alg_id != ACVP_AES_CCM &&
+                    alg_id != ACVP_AES_XPN && alg_id != ACVP_AES_KWP && alg_id != ACVP_AES_GMAC) {
+                ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+                return ACVP_CRYPTO_MODULE_FAIL;
+            }
+        }
+        rv = acvp_aes_output_tc(ctx, batch->tcs[i].tc.symmetric,
+                                json_value_get_object(batch->rsp[i]), batch->results[i]);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in AES module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The number of data units an AES-XTS AFT test case is run as. When the
+ * server sends a dataUnitLen below the payload, each data unit is
+ * encrypted on its own with the next tweak (IEEE 1619), so the units can
+ * be handed to the crypto module as test cases of their own. Everything
+ * else is a single unit.
+ */
+static unsigned int acvp_aes_data_units(const ACVP_SYM_CIPHER_TC *stc) {
+    unsigned int len = 0;
+
+    if (!stc || stc->cipher != ACVP_AES_XTS || stc->test_type != ACVP_SYM_TEST_TYPE_AFT ||
+            !stc->data_unit_len) {
+        return 1;
+    }
+    len = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? stc->pt_len : stc->ct_len;
+    if (stc->data_unit_len >= len) {
+        return 1;
+    }
+    return (len + stc->data_unit_len - 1) / stc->data_unit_len;
+}
+
+/* Adds n to an XTS tweak, a 128 bit little endian integer */
+static void acvp_aes_tweak_add(unsigned char *tweak, unsigned int n) {
+    unsigned int carry = n;
+    int i = 0;
+
+    for (i = 0; i < ACVP_BLOCK_LEN_AES128 && carry; i++) {
+        carry += tweak[i];
+        tweak[i] = carry & 0xff;
+        carry >>= 8;
+    }
+}
+
+/*
+ * Runs test cases with the data units of each one as test cases of their
+ * own, see acvp_aes_data_units(), so that the units of a large payload are
+ * spread over the parallel test cases, batch or async handler like any
+ * other test cases. A unit points into the pt and ct of its test case, so
+ * nothing is copied but the tweak; unit i gets the tweak value plus i, or
+ * the sequence number plus i. The result of a test case is that of the
+ * first of its units to fail, and 0 once all of them succeed.
+ */
+static ACVP_RESULT acvp_aes_run_data_units(ACVP_CTX *ctx,
+                                           ACVP_CAPS_LIST *cap,
+                                           ACVP_TEST_CASE *tcs,
+                                           int *results,
+                                           int count) {
+    ACVP_SYM_CIPHER_TC *stc = NULL, *units = NULL;
+    ACVP_TC_BATCH batch;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned char *tweaks = NULL;
+    unsigned int n = 0, len = 0, off = 0, u = 0;
+    int *parent = NULL;
+    int i = 0, k = 0, total = 0;
+
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
+    for (i = 0; i < count; i++) {
+        total += acvp_aes_data_units(tcs[i].tc.symmetric);
+    }
+    units = calloc(total, sizeof(ACVP_SYM_CIPHER_TC));
+    tweaks = calloc(total, ACVP_SYM_IV_BYTE_MAX);
+    parent = calloc(total, sizeof(int));
+    if (!units || !tweaks || !parent) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    rv = acvp_tc_batch_init(&batch, total);
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
+
+    for (i = 0; i < count; i++) {
+        stc = tcs[i].tc.symmetric;
+        n = acvp_aes_data_units(stc);
+        results[i] = 0;
+        if (n == 1) {
+            /* The module fills in the test case itself */
+            parent[k++] = i;
+            acvp_tc_batch_add(&batch, NULL)->tc.symmetric = stc;
+            continue;
+        }
+        len = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? stc->pt_len : stc->ct_len;
+        for (u = 0, off = 0; u < n; u++, off += stc->data_unit_len, k++) {
+            memcpy_s(&units[k], sizeof(ACVP_SYM_CIPHER_TC), stc, sizeof(ACVP_SYM_CIPHER_TC));
+            units[k].pt = stc->pt + off;
+            units[k].ct = stc->ct + off;
+            units[k].pt_len = len - off < stc->data_unit_len ? len - off : stc->data_unit_len;
+            units[k].ct_len = units[k].pt_len;
+            units[k].data_unit_len = units[k].pt_len;
+            units[k].iv = tweaks + (size_t)k * ACVP_SYM_IV_BYTE_MAX;
+            memcpy_s(units[k].iv, ACVP_SYM_IV_BYTE_MAX, stc->iv, ACVP_SYM_IV_BYTE_MAX);
+            acvp_aes_tweak_add(units[k].iv, u);
+            units[k].seq_num = stc->seq_num + u;
+            parent[k] = i;
+            acvp_tc_batch_add(&batch, NULL)->tc.symmetric = &units[k];
+        }
+    }
+
+    rv = acvp_tc_batch_run(ctx, cap, &batch);
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
+    for (k = 0; k < batch.count; k++) {
+        if (batch.results[k] && !results[parent[k]]) {
+            results[parent[k]] = batch.results[k];
+        }
+    }
+    for (i = 0; i < count; i++) {
+        stc = tcs[i].tc.symmetric;
+        if (acvp_aes_data_units(stc) > 1) {
+            /* The output covers the whole payload, not the last unit */
+            if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+                stc->ct_len = stc->pt_len;
+            } else {
+                stc->pt_len = stc->ct_len;
+            }
+        }
+    }
+
+end:
+    acvp_tc_batch_free(&batch);
+    if (units) free(units);
+    if (tweaks) free(tweaks);
+    if (parent) free(parent);
+    return rv;
+}
+
+/* Copies len bytes of one test case between its buffer and the arrays */
+static void acvp_aes_soa_copy(unsigned char *dst, const unsigned char *src, unsigned int len) {
+    if (len) {
+        memcpy_s(dst, len, src, len);
+    }
+}
+
+/*
+ * The payload of a test case in the SoA view, without the tag CCM and
+ * GCM-SIV carry at the end of the ciphertext. -1 if it is too short to
+ * hold the tag.
+ */
+static int acvp_aes_soa_data_len(ACVP_SYM_CIPHER_TC *stc, int encrypt) {
+    if (encrypt) {
+        return (int)stc->pt_len;
+    }
+    if (stc->cipher == ACVP_AES_GCM_SIV) {
+        return stc->ct_len < stc->tag_len ? -1 : (int)(stc->ct_len - stc->tag_len);
+    }
+    return (int)stc->ct_len;
+}
+
+/*
+ * Where the tag of a test case with data_len bytes of payload is kept
+ */
+static unsigned char *acvp_aes_soa_tag(ACVP_SYM_CIPHER_TC *stc, unsigned int data_len) {
+    if (stc->cipher == ACVP_AES_CCM || stc->cipher == ACVP_AES_GCM_SIV) {
+        return stc->ct + data_len;
+    }
+    return stc->tag;
+}
+
+/*
+ * Hands an AFT group to the SoA handler of the capability, see
+ * acvp_cap_sym_cipher_set_soa_handler(). The inputs of the test cases are
+ * copied into arrays, and once the module is done, what it wrote is copied
+ * back into the test cases for acvp_aes_output_tc().
+ * For the AEAD modes the tags are kept apart from the payloads, and a tag
+ * the module found not to verify fails its test case, as a nonzero result
+ * does. Key wrap outputs are sized by the module, in out_len.
+ */
+static ACVP_RESULT acvp_aes_run_soa(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_SYM_CIPHER_TC *stc = batch->tcs[0].tc.symmetric;
+    ACVP_SYM_CIPHER_SOA soa;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long int start = 0;
+    unsigned char *in = NULL, *out = NULL;
+    size_t data_bytes = 0;
+    int encrypt = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT;
+    int aead = stc->cipher == ACVP_AES_GCM || stc->cipher == ACVP_AES_CCM ||
+               stc->cipher == ACVP_AES_GCM_SIV || stc->cipher == ACVP_AES_XPN;
+    int kw = stc->cipher == ACVP_AES_KW || stc->cipher == ACVP_AES_KWP;
+    unsigned int out_len = 0;
+    int i = 0, len = 0, diff = 0;
+
+    memzero_s(&soa, sizeof(ACVP_SYM_CIPHER_SOA));
+    soa.cipher = stc->cipher;
+    soa.direction = stc->direction;
+    soa.ivgen_source = stc->ivgen_source;
+    soa.salt_source = stc->salt_source;
+    soa.count = batch->count;
+    soa.key_len = stc->key_len / 8;
+    soa.iv_len = stc->iv_len;
+    soa.aad_len = stc->aad_len;
+    soa.tag_len = stc->tag_len;
+    soa.salt_len = stc->cipher == ACVP_AES_XPN ? stc->salt_len : 0;
+    soa.kwcipher = stc->kwcipher;
+    soa.key_shared = 1;
+    for (i = 0; i < batch->count; i++) {
+        stc = batch->tcs[i].tc.symmetric;
+        len = acvp_aes_soa_data_len(stc, encrypt);
+        if (stc->key_len / 8 != soa.key_len || stc->iv_len != soa.iv_len ||
+                stc->aad_len != soa.aad_len || stc->tag_len != soa.tag_len ||
+                (soa.salt_len && stc->salt_len != soa.salt_len) || len < 0) {
+            /* Not one layout for the whole group, which ACVP does not send */
+            ACVP_LOG_VERBOSE("Test case lengths differ within the group, not using the SoA handler");
+            return acvp_tc_batch_run(ctx, cap, batch);
+        }
+        if ((unsigned int)len > soa.data_stride) {
+            soa.data_stride = len;
+        }
+        if (soa.key_shared && i && soa.key_len) {
+            memcmp_s(stc->key, soa.key_len, batch->tcs[0].tc.symmetric->key, soa.key_len, &diff);
+            soa.key_shared = !diff;
+        }
+    }
+    if (kw) {
+        soa.data_stride += ACVP_SYM_SOA_KW_ROOM;
+    }
+
+    data_bytes = (size_t)soa.count * (soa.data_stride ? soa.data_stride : 1);
+    soa.data_len = calloc(soa.count, sizeof(unsigned int));
+    soa.tc_id = calloc(soa.count, sizeof(unsigned int));
+    soa.key = calloc((size_t)soa.count * (soa.key_len ? soa.key_len : 1), sizeof(unsigned char));
+    soa.iv = calloc((size_t)soa.count * (soa.iv_len ? soa.iv_len : 1), sizeof(unsigned char));
+    soa.aad = calloc((size_t)soa.count * (soa.aad_len ? soa.aad_len : 1), sizeof(unsigned char));
+    soa.tag = calloc((size_t)soa.count * (soa.tag_len ? soa.tag_len : 1), sizeof(unsigned char));
+    soa.pt = calloc(data_bytes, sizeof(unsigned char));
+    soa.ct = calloc(data_bytes, sizeof(unsigned char));
+    if (!soa.data_len || !soa.tc_id || !soa.key || !soa.iv || !soa.aad || !soa.tag || !soa.pt || !soa.ct) {
+        ACVP_LOG_ERR("Unable to allocate the SoA view of the test group");
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    if (soa.salt_len) {
+        soa.salt = calloc((size_t)soa.count * soa.salt_len, sizeof(unsigned char));
+        if (!soa.salt) {
+            ACVP_LOG_ERR("Unable to allocate the SoA view of the test group");
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+    }
+    if (kw) {
+        soa.out_len = calloc(soa.count, sizeof(unsigned int));
+        if (!soa.out_len) {
+            ACVP_LOG_ERR("Unable to allocate the SoA view of the test group");
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+    }
+    if (aead && !encrypt) {
+        soa.tag_ok = calloc(soa.count, sizeof(int));
+        if (!soa.tag_ok) {
+            ACVP_LOG_ERR("Unable to allocate the SoA view of the test group");
+            rv = ACVP_MALLOC_FAIL;
+            goto end;
+        }
+    }
+
+    in = encrypt ? soa.pt : soa.ct;
+    for (i = 0; i < soa.count; i++) {
+        stc = batch->tcs[i].tc.symmetric;
+        soa.tc_id[i] = stc->tc_id;
+        soa.data_len[i] = acvp_aes_soa_data_len(stc, encrypt);
+        acvp_aes_soa_copy(soa.key + (size_t)i * soa.key_len, stc->key, soa.key_len);
+        acvp_aes_soa_copy(soa.iv + (size_t)i * soa.iv_len, stc->iv, soa.iv_len);
+        acvp_aes_soa_copy(soa.aad + (size_t)i * soa.aad_len, stc->aad, soa.aad_len);
+        if (!encrypt) {
+            acvp_aes_soa_copy(soa.tag + (size_t)i * soa.tag_len,
+                              acvp_aes_soa_tag(stc, soa.data_len[i]), soa.tag_len);
+        }
+        if (soa.salt) {
+            acvp_aes_soa_copy(soa.salt + (size_t)i * soa.salt_len, stc->salt, soa.salt_len);
+        }
+        if (soa.tag_ok) {
+            soa.tag_ok[i] = 1;
+        }
+        acvp_aes_soa_copy(in + (size_t)i * soa.data_stride, encrypt ? stc->pt : stc->ct, soa.data_len[i]);
+    }
+
+    memzero_s(batch->results, batch->max * sizeof(int));
+    ACVP_LOG_VERBOSE("Handing %d test cases to the SoA handler", soa.count);
+    if (ACVP_CRYPTO_TIMED(ctx)) start = acvp_metrics_now();
+    if ((cap->soa_handler)(&soa, batch->results)) {
+        ACVP_LOG_ERR("crypto module failed the SoA operation");
+        rv = ACVP_CRYPTO_MODULE_FAIL;
+        goto end;
+    }
+    acvp_metrics_crypto(ctx, start, soa.count, NULL);
+
+    out = encrypt ? soa.ct : soa.pt;
+    for (i = 0; i < soa.count; i++) {
+        stc = batch->tcs[i].tc.symmetric;
+        out_len = soa.out_len ? soa.out_len[i] : soa.data_len[i];
+        if (out_len > soa.data_stride) {
+            ACVP_LOG_ERR("crypto module output is longer than the SoA stride (tc %d)", stc->tc_id);
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+        if (encrypt) {
+            acvp_aes_soa_copy(stc->ct, out + (size_t)i * soa.data_stride, out_len);
+            stc->ct_len = out_len;
+            acvp_aes_soa_copy(acvp_aes_soa_tag(stc, soa.data_len[i]),
+                              soa.tag + (size_t)i * soa.tag_len, soa.tag_len);
+            if (stc->cipher == ACVP_AES_CCM || stc->cipher == ACVP_AES_GCM_SIV) {
+                stc->ct_len += soa.tag_len;
+            }
+            if (soa.ivgen_source == ACVP_SYM_CIPH_IVGEN_SRC_INT) {
+                acvp_aes_soa_copy(stc->iv, soa.iv + (size_t)i * soa.iv_len, soa.iv_len);
+            }
+            if (soa.salt && soa.salt_source == ACVP_SYM_CIPH_SALT_SRC_INT) {
+                acvp_aes_soa_copy(stc->salt, soa.salt + (size_t)i * soa.salt_len, soa.salt_len);
+            }
+        } else {
+            if (soa.tag_ok && !soa.tag_ok[i]) {
+                batch->results[i] = 1;
+            }
+            acvp_aes_soa_copy(stc->pt, out + (size_t)i * soa.data_stride, out_len);
+            stc->pt_len = out_len;
+        }
+    }
+
+end:
+    if (soa.data_len) free(soa.data_len);
+    if (soa.tc_id) free(soa.tc_id);
+    if (soa.key) free(soa.key);
+    if (soa.iv) free(soa.iv);
+    if (soa.aad) free(soa.aad);
+    if (soa.tag) free(soa.tag);
+    if (soa.pt) free(soa.pt);
+    if (soa.ct) free(soa.ct);
+    if (soa.salt) free(soa.salt);
+    if (soa.tag_ok) free(soa.tag_ok);
+    if (soa.out_len) free(soa.out_len);
+    return rv;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_aes_release_batch(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_aes_release_tc(ctx, &(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -1286,13 +1781,18 @@ static ACVP_RESULT acvp_aes_output_tc(ACVP_CTX *ctx,
                                       JSON_Object *tc_rsp,
                                       int opt_rv) {
     ACVP_RESULT rv;
-    char *tmp = NULL;
+    unsigned int len = 0;
+    int tmp_max = 0;
 
-    tmp = calloc(ACVP_SYM_CT_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
+    /*
+     * Cap the hex output at the largest value written below. CFB1
+     * lengths are in bits, which only overestimates.
+     */
+    len = stc->pt_len > stc->ct_len ? stc->pt_len : stc->ct_len;
+    if (stc->iv_len > len) len = stc->iv_len;
+    if (stc->tag_len > len) len = stc->tag_len;
+    if (stc->salt_len > len) len = stc->salt_len;
+    tmp_max = len * 2 < ACVP_SYM_CT_MAX ? len * 2 : ACVP_SYM_CT_MAX;
 
     /*
      * Only return IV on AES ciphers with internal IV generation
@@ -1300,51 +1800,46 @@ static ACVP_RESULT acvp_aes_output_tc(ACVP_CTX *ctx,
     if (stc->ivgen_source == ACVP_SYM_CIPH_IVGEN_SRC_INT &&
           (stc->cipher == ACVP_AES_GCM || stc->cipher == ACVP_AES_GMAC || stc->cipher == ACVP_AES_XPN ||
           (stc->cipher == ACVP_AES_CTR && stc->conformance == ACVP_CONFORMANCE_RFC3686))) {
-        rv = acvp_bin_to_hexstr(stc->iv, stc->iv_len, tmp, ACVP_SYM_CT_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "iv", stc->iv, stc->iv_len, tmp_max);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (iv)");
-            goto err;
+            return rv;
         }
-        json_object_set_string(tc_rsp, "iv", tmp);
     }
 
     if (stc->cipher == ACVP_AES_XPN && stc->salt_source == ACVP_SYM_CIPH_SALT_SRC_INT) {
-        rv = acvp_bin_to_hexstr(stc->salt, stc->salt_len, tmp, ACVP_AES_XPN_SALTLEN);
+        rv = acvp_json_set_hex(tc_rsp, "salt", stc->salt, stc->salt_len, ACVP_AES_XPN_SALTLEN);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (salt)");
-            goto err;
+            return rv;
         }
-        json_object_set_string(tc_rsp, "salt", tmp);
     }
 
     if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-        memzero_s(tmp, ACVP_SYM_CT_MAX);
         if (stc->cipher == ACVP_AES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->ct, (stc->ct_len + 7) / 8, tmp, ACVP_SYM_CT_MAX);
+            len = (stc->ct_len + 7) / 8;
         } else if (stc->cipher == ACVP_AES_GCM) {
-            rv = acvp_bin_to_hexstr(stc->ct, stc->pt_len, tmp, ACVP_SYM_CT_MAX);
+            len = stc->pt_len;
         } else {
-            rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp, ACVP_SYM_CT_MAX);
-        }
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("hex conversion failure (ct)");
-            goto err;
+            len = stc->ct_len;
         }
         if (stc->cipher != ACVP_AES_GMAC) {
-            json_object_set_string(tc_rsp, "ct", tmp);
+            rv = acvp_json_set_hex(tc_rsp, "ct", stc->ct, len, tmp_max);
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("hex conversion failure (ct)");
+                return rv;
+            }
         }
 
         /*
          * AES-GCM ciphers need to include the tag
          */
         if (stc->cipher == ACVP_AES_GCM || stc->cipher == ACVP_AES_GMAC || stc->cipher == ACVP_AES_XPN) {
-            memzero_s(tmp, ACVP_SYM_CT_MAX);
-            rv = acvp_bin_to_hexstr(stc->tag, stc->tag_len, tmp, ACVP_SYM_CT_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "tag", stc->tag, stc->tag_len, tmp_max);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (tag)");
-                goto err;
+                return rv;
             }
-            json_object_set_string(tc_rsp, "tag", tmp);
         }
     } else {
         if (stc->cipher == ACVP_AES_GCM || stc->cipher == ACVP_AES_CCM ||
@@ -1353,7 +1848,6 @@ static ACVP_RESULT acvp_aes_output_tc(ACVP_CTX *ctx,
                 stc->cipher == ACVP_AES_XPN) {
             if (opt_rv != 0) {
                 json_object_set_boolean(tc_rsp, "testPassed", 0);
-                free(tmp);
                 return ACVP_SUCCESS;
             } else {
                 json_object_set_boolean(tc_rsp, "testPassed", 1);
@@ -1361,27 +1855,22 @@ static ACVP_RESULT acvp_aes_output_tc(ACVP_CTX *ctx,
         }
 
         if (stc->cipher == ACVP_AES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->pt, (stc->pt_len + 7) / 8, tmp, ACVP_SYM_PT_MAX);
+            len = (stc->pt_len + 7) / 8;
         } else if (stc->cipher == ACVP_AES_GCM) {
-            rv = acvp_bin_to_hexstr(stc->pt, stc->ct_len, tmp, ACVP_SYM_PT_MAX);
+            len = stc->ct_len;
         } else {
-            rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_SYM_PT_MAX);
-        }
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("hex conversion failure (pt)");
-            goto err;
+            len = stc->pt_len;
         }
         if (stc->cipher != ACVP_AES_GMAC) {
-            json_object_set_string(tc_rsp, "pt", tmp);
+            rv = acvp_json_set_hex(tc_rsp, "pt", stc->pt, len, tmp_max);
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("hex conversion failure (pt)");
+                return rv;
+            }
         }
     }
-    free(tmp);
 
     return ACVP_SUCCESS;
-
-err:
-    if (tmp) free(tmp);
-    return rv;
 }
 
 /*
@@ -1425,22 +1914,49 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
                                     ACVP_SYM_CIPH_SALT_SRC salt_src) {
 
     ACVP_RESULT rv;
+    unsigned int data_max = 0, aad_max = 0, len = 0;
 
     memzero_s(stc, sizeof(ACVP_SYM_CIPHER_TC));
 
-    stc->key = calloc(ACVP_SYM_KEY_MAX_BYTES, 1);
+    /*
+     * Size pt and ct for the payload of this test case instead of the
+     * protocol maximum. The headroom leaves space for what modules append
+     * to the output, such as KW/KWP padding and GCM-SIV or CCM tags, and
+     * for the blocks MCT copies in.
+     */
+    data_max = pt_len > 0 ? (pt_len + 7) / 8 : 0;
+    if (j_pt) {
+        len = (strnlen_s(j_pt, ACVP_SYM_PT_MAX + 1) + 1) / 2;
+        if (len > data_max) data_max = len;
+    }
+    if (j_ct) {
+        len = (strnlen_s(j_ct, ACVP_SYM_CT_MAX + 1) + 1) / 2;
+        if (len > data_max) data_max = len;
+    }
+    data_max += ACVP_AES_TC_HEADROOM;
+    if (data_max > ACVP_SYM_PT_BYTE_MAX) data_max = ACVP_SYM_PT_BYTE_MAX;
+
+    aad_max = aad_len / 8;
+    if (j_aad) {
+        len = (strnlen_s(j_aad, ACVP_SYM_AAD_MAX + 1) + 1) / 2;
+        if (len > aad_max) aad_max = len;
+    }
+    if (aad_max > ACVP_SYM_AAD_BYTE_MAX) aad_max = ACVP_SYM_AAD_BYTE_MAX;
+    if (!aad_max) aad_max = 1;
+
+    stc->key = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_KEY_MAX_BYTES);
     if (!stc->key) { return ACVP_MALLOC_FAIL; }
-    stc->pt = calloc( ACVP_SYM_PT_BYTE_MAX, 1);
+    stc->pt = acvp_arena_calloc(&ctx->exec.tc_arena, data_max);
     if (!stc->pt) { return ACVP_MALLOC_FAIL; }
-    stc->ct = calloc(ACVP_SYM_CT_BYTE_MAX, 1);
+    stc->ct = acvp_arena_calloc(&ctx->exec.tc_arena, data_max);
     if (!stc->ct) { return ACVP_MALLOC_FAIL; }
-    stc->tag = calloc(ACVP_SYM_TAG_BYTE_MAX, 1);
+    stc->tag = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_TAG_BYTE_MAX);
     if (!stc->tag) { return ACVP_MALLOC_FAIL; }
-    stc->iv = calloc(ACVP_SYM_IV_BYTE_MAX, 1);
+    stc->iv = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_IV_BYTE_MAX);
     if (!stc->iv) { return ACVP_MALLOC_FAIL; }
-    stc->aad = calloc(ACVP_SYM_AAD_BYTE_MAX, 1);
+    stc->aad = acvp_arena_calloc(&ctx->exec.tc_arena, aad_max);
     if (!stc->aad) { return ACVP_MALLOC_FAIL; }
-    stc->salt = calloc(ACVP_AES_XPN_SALTLEN, 1);
+    stc->salt = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_AES_XPN_SALTLEN);
     if (!stc->salt) { return ACVP_MALLOC_FAIL; }
 
     /*
@@ -1478,7 +1994,7 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
 
     if (j_pt) {
         if (alg_id == ACVP_AES_CFB1) {
-            rv = acvp_hexstr_to_bin(j_pt, stc->pt, ACVP_SYM_PT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_pt, stc->pt, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (pt)");
                 return rv;
@@ -1486,7 +2002,7 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
             stc->data_len = data_len;
             stc->pt_len = data_len;
         } else {
-            rv = acvp_hexstr_to_bin(j_pt, stc->pt, ACVP_SYM_PT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_pt, stc->pt, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (pt)");
                 return rv;
@@ -1501,7 +2017,7 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
 
     if (j_ct) {
         if (alg_id == ACVP_AES_CFB1) {
-            rv = acvp_hexstr_to_bin(j_ct, stc->ct, ACVP_SYM_CT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_ct, stc->ct, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (ct)");
                 return rv;
@@ -1509,7 +2025,7 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
             stc->data_len = data_len;
             stc->ct_len = data_len;
         } else {
-            rv = acvp_hexstr_to_bin(j_ct, stc->ct, ACVP_SYM_CT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_ct, stc->ct, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (ct)");
                 return rv;
@@ -1544,7 +2060,7 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
     }
 
     if (j_aad) {
-        rv = acvp_hexstr_to_bin(j_aad, stc->aad, ACVP_SYM_AAD_BYTE_MAX, NULL);
+        rv = acvp_hexstr_to_bin(j_aad, stc->aad, aad_max, NULL);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (aad)");
             return rv;
@@ -1566,14 +2082,8 @@ static ACVP_RESULT acvp_aes_init_tc(ACVP_CTX *ctx,
  * This function simply releases the data associated with
  * a test case.
  */
-static ACVP_RESULT acvp_aes_release_tc(ACVP_SYM_CIPHER_TC *stc) {
-    if (stc->key) free(stc->key);
-    if (stc->pt) free(stc->pt);
-    if (stc->ct) free(stc->ct);
-    if (stc->tag) free(stc->tag);
-    if (stc->iv) free(stc->iv);
-    if (stc->aad) free(stc->aad);
-    if (stc->salt) free(stc->salt);
+static ACVP_RESULT acvp_aes_release_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc) {
+    acvp_arena_reset(&ctx->exec.tc_arena);
     memzero_s(stc, sizeof(ACVP_SYM_CIPHER_TC));
 
     return ACVP_SUCCESS;
@@ -0,0 +1,239 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Pins the threads started for the worker pool as the session has it, see
+ * acvp_set_worker_affinity(). Each worker gets its share of the CPUs, or the
+ * CPUs of its NUMA node, and the threads it starts for the test cases of its
+ * groups get the same, so the test case buffers and Monte Carlo state of a
+ * vector set are not passed between sockets. No NUMA library is needed: the
+ * arenas of a worker are allocated, and so first touched, by the worker
+ * itself once it is pinned, which puts them on its node.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#ifdef __linux__
+/*
+ * Adds the CPUs of a list such as "0-3,8,10-11", as sysfs has them, to set.
+ * Returns how many were added.
+ */
+static int acvp_affinity_parse_cpus(const char *list, cpu_set_t *set) {
+    const char *p = list;
+    char *end = NULL;
+    long lo = 0, hi = 0;
+    int n = 0;
+
+    while (*p) {
+        lo = strtol(p, &end, 10);
+        if (end == p || lo < 0) {
+            break;
+        }
+        hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+            if (end == p || hi < lo) {
+                break;
+            }
+        }
+        for (; lo <= hi && lo < CPU_SETSIZE; lo++) {
+            CPU_SET(lo, set);
+            n++;
+        }
+        if (*end != ',') {
+            break;
+        }
+        p = end + 1;
+    }
+    return n;
+}
+
+/*
+ * Adds the CPUs of NUMA node to set, returning how many; 0 if there is no
+ * such node
+ */
+static int acvp_affinity_node_cpus(int node, cpu_set_t *set) {
+    char path[64], buf[1024];
+    FILE *fp = NULL;
+    int n = 0;
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    fp = fopen(path, "r");
+    if (!fp) {
+        return 0;
+    }
+    if (fgets(buf, sizeof(buf), fp)) {
+        n = acvp_affinity_parse_cpus(buf, set);
+    }
+    fclose(fp);
+    return n;
+}
+
+/*
+ * Lists the NUMA nodes the system has online in nodes, returning how many
+ */
+static int acvp_affinity_nodes(int *nodes) {
+    cpu_set_t set;
+    char buf[1024];
+    FILE *fp = NULL;
+    int cnt = 0, i = 0;
+
+    /* Same format as a list of CPUs */
+    CPU_ZERO(&set);
+    fp = fopen("/sys/devices/system/node/online", "r");
+    if (!fp) {
+        return 0;
+    }
+    if (fgets(buf, sizeof(buf), fp)) {
+        acvp_affinity_parse_cpus(buf, &set);
+    }
+    fclose(fp);
+    for (i = 0; i < CPU_SETSIZE && cnt < ACVP_MAX_AFFINITY_IDS; i++) {
+        if (CPU_ISSET(i, &set)) {
+            nodes[cnt++] = i;
+        }
+    }
+    return cnt;
+}
+#elif defined _WIN32
+static int acvp_affinity_nodes(int *nodes) {
+    ULONG highest = 0, i = 0;
+    ULONGLONG mask = 0;
+    int cnt = 0;
+
+    if (!GetNumaHighestNodeNumber(&highest)) {
+        return 0;
+    }
+    for (i = 0; i <= highest && cnt < ACVP_MAX_AFFINITY_IDS; i++) {
+        if (GetNumaNodeProcessorMask((UCHAR)i, &mask) && mask) {
+            nodes[cnt++] = (int)i;
+        }
+    }
+    return cnt;
+}
+#endif
+
+#if defined __linux__ || defined _WIN32
+/*
+ * The NUMA node of the worker: the workers go round robin across the nodes
+ * given to acvp_set_worker_affinity(), or all of them the system has.
+ * Returns -1 if there are none.
+ */
+static int acvp_affinity_pick_node(ACVP_CTX *ctx, int worker) {
+    int nodes[ACVP_MAX_AFFINITY_IDS];
+    int cnt = 0;
+
+    if (ctx->affinity_cnt) {
+        return ctx->affinity_ids[worker % ctx->affinity_cnt];
+    }
+    cnt = acvp_affinity_nodes(nodes);
+    return cnt ? nodes[worker % cnt] : -1;
+}
+#endif
+
+/*
+ * Pins the calling thread, started for the worker of the pool the exec
+ * context ctx is for, as the affinity policy of the session has it. With
+ * ACVP_AFFINITY_CPUS the CPUs are split into as many slices as there are
+ * workers, a CPU being shared when there are fewer of them than workers.
+ * Failing to pin is not an error, only logged unless quiet; the thread just
+ * runs where it is. Returns the NUMA node the thread was pinned to, 0 if it
+ * was not pinned to one.
+ */
+int acvp_worker_pin(ACVP_CTX *ctx, int quiet) {
+    int worker = ctx->exec.worker, worker_cnt = 1, first = 0, last = 0, node = -1, i = 0;
+
+    if (ctx->affinity == ACVP_AFFINITY_NONE) {
+        return 0;
+    }
+    if (ctx->pool && ctx->pool->worker_cnt > 1) {
+        worker_cnt = ctx->pool->worker_cnt;
+    }
+
+    if (ctx->affinity == ACVP_AFFINITY_CPUS) {
+        first = worker * ctx->affinity_cnt / worker_cnt;
+        last = (worker + 1) * ctx->affinity_cnt / worker_cnt;
+        if (last == first) {
+            last = first + 1;
+        }
+    }
+#if defined __linux__ || defined _WIN32
+    if (ctx->affinity == ACVP_AFFINITY_NUMA) {
+        node = acvp_affinity_pick_node(ctx, worker);
+        if (node < 0) {
+            if (!quiet) ACVP_LOG_WARN("No NUMA nodes found, worker %d is not pinned", worker);
+            return 0;
+        }
+    }
+#endif
+
+#ifdef __linux__
+    {
+        cpu_set_t set;
+        int n = 0;
+
+        CPU_ZERO(&set);
+        if (node >= 0) {
+            n = acvp_affinity_node_cpus(node, &set);
+        } else {
+            for (i = first; i < last; i++) {
+                if (ctx->affinity_ids[i] < CPU_SETSIZE) {
+                    CPU_SET(ctx->affinity_ids[i], &set);
+                    n++;
+                }
+            }
+        }
+        if (!n || sched_setaffinity(0, sizeof(cpu_set_t), &set)) {
+            if (!quiet) ACVP_LOG_WARN("Unable to pin worker %d to its CPUs", worker);
+            return 0;
+        }
+    }
+#elif defined _WIN32
+    {
+        ULONGLONG mask = 0;
+
+        if (node >= 0) {
+            GetNumaNodeProcessorMask((UCHAR)node, &mask);
+        } else {
+            for (i = first; i < last; i++) {
+                if (ctx->affinity_ids[i] < 64) {
+                    mask |= 1ULL << ctx->affinity_ids[i];
+                }
+            }
+        }
+        if (!mask || !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask)) {
+            if (!quiet) ACVP_LOG_WARN("Unable to pin worker %d to its CPUs", worker);
+            return 0;
+        }
+    }
+#else
+    (void)first;
+    (void)last;
+    (void)i;
+    (void)quiet;
+    return 0;
+#endif
+    return node > 0 ? node : 0;
+}
@@ -4993,6 +4993,13 @@ ACVP_RESULT acvp_build_registration_json(ACVP_CTX *ctx, JSON_Value **reg) {
         return ACVP_NO_CTX;
     }
 
+    /* Settings made with their checks deferred have not been checked against each other yet */
+    if (ctx->caps_deferred) {
+        rv = acvp_cap_finalize(ctx);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+    }
 
     val = json_value_init_array();
     caps_arr = json_value_get_array(val);
@@ -5355,10 +5362,26 @@ static JSON_Value *acvp_version_json_value(void) {
     return version_val;
 }
 
+/*
+ * Serializes the registration of ctx->registration, or takes it from
+ * the registration cache if one is set and was saved for the same
+ * registration; see acvp_set_registration_cache_file().
+ */
 ACVP_RESULT acvp_build_full_registration(ACVP_CTX *ctx, char **out, int *out_len) {
     JSON_Value *top_array_val = NULL, *val = NULL;
     JSON_Array *top_array = NULL;
     JSON_Object *obj = NULL;
+    unsigned long long int fp = 0;
+    int len = 0;
+
+    if (ctx->reg_cache_file) {
+        fp = acvp_reg_fingerprint(ctx->registration, ctx->is_sample);
+        *out = acvp_reg_cache_load(ctx, ctx->reg_cache_file, fp, &len);
+        if (*out) {
+            if (out_len) *out_len = len;
+            return ACVP_SUCCESS;
+        }
+    }
 
     /*
      * Start top-level array
@@ -5377,10 +5400,15 @@ ACVP_RESULT acvp_build_full_registration(ACVP_CTX *ctx, char **out, int *out_len
     json_object_set_value(obj, "algorithms", ctx->registration);
 
     json_array_append_value(top_array, val);
-    *out = json_serialize_to_string(top_array_val, out_len);
+    *out = json_serialize_to_string(top_array_val, &len);
+    if (out_len) *out_len = len;
 
     json_object_soft_remove(obj, "algorithms");
     if (top_array_val) json_value_free(top_array_val);
+
+    if (ctx->reg_cache_file && *out) {
+        acvp_reg_cache_save(ctx, ctx->reg_cache_file, fp, *out, len);
+    }
     return ACVP_SUCCESS;
 }
 
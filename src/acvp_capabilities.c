@@ -21,6 +21,8 @@
 #include "parson.h"
 #include "safe_str_lib.h"
 
+extern ACVP_ALG_HANDLER alg_tbl[];
+
 static ACVP_RESULT validate_domain_range(int min, int max, int inc) {
     if (min > max || min < 0 || max < 0 || inc < 0 || (max - min) % inc != 0) {
         return ACVP_INVALID_ARG;
@@ -28,19 +30,18 @@ static ACVP_RESULT validate_domain_range(int min, int max, int inc) {
     return ACVP_SUCCESS;
 }
 
-static ACVP_DSA_CAP *allocate_dsa_cap(void) {
+static ACVP_DSA_CAP *allocate_dsa_cap(ACVP_CTX *ctx) {
     ACVP_DSA_CAP *cap = NULL;
     ACVP_DSA_CAP_MODE *modes = NULL;
     int i = 0;
 
     // Allocate the capability object
-    cap = calloc(1, sizeof(ACVP_DSA_CAP));
+    cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DSA_CAP));
     if (!cap) return NULL;
 
     // Allocate the array of dsa_mode
-    modes = calloc(ACVP_DSA_MAX_MODES, sizeof(ACVP_DSA_CAP_MODE));
+    modes = acvp_cap_calloc(ctx, ACVP_DSA_MAX_MODES, sizeof(ACVP_DSA_CAP_MODE));
     if (!modes) {
-        free(cap);
         return NULL;
     }
     cap->dsa_cap_mode = modes;
@@ -56,19 +57,18 @@ static ACVP_DSA_CAP *allocate_dsa_cap(void) {
     return cap;
 }
 
-static ACVP_KAS_ECC_CAP *allocate_kas_ecc_cap(void) {
+static ACVP_KAS_ECC_CAP *allocate_kas_ecc_cap(ACVP_CTX *ctx) {
     ACVP_KAS_ECC_CAP *cap = NULL;
     ACVP_KAS_ECC_CAP_MODE *modes = NULL;
     int i = 0;
 
-    cap = calloc(1, sizeof(ACVP_KAS_ECC_CAP));
+    cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_ECC_CAP));
     if (!cap) {
         return NULL;
     }
 
-    modes = calloc(ACVP_KAS_ECC_MAX_MODES, sizeof(ACVP_KAS_ECC_CAP_MODE));
+    modes = acvp_cap_calloc(ctx, ACVP_KAS_ECC_MAX_MODES, sizeof(ACVP_KAS_ECC_CAP_MODE));
     if (!modes) {
-        free(cap);
         return NULL;
     }
     cap->kas_ecc_mode = (ACVP_KAS_ECC_CAP_MODE *)modes;
@@ -80,19 +80,18 @@ static ACVP_KAS_ECC_CAP *allocate_kas_ecc_cap(void) {
     return cap;
 }
 
-static ACVP_KAS_FFC_CAP *allocate_kas_ffc_cap(void) {
+static ACVP_KAS_FFC_CAP *allocate_kas_ffc_cap(ACVP_CTX *ctx) {
     ACVP_KAS_FFC_CAP *cap = NULL;
     ACVP_KAS_FFC_MODE *modes = NULL;
     int i = 0;
 
-    cap = calloc(1, sizeof(ACVP_KAS_FFC_CAP));
+    cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_FFC_CAP));
     if (!cap) {
         return NULL;
     }
 
-    modes = calloc(ACVP_KAS_FFC_MAX_MODES, sizeof(ACVP_KAS_FFC_CAP_MODE));
+    modes = acvp_cap_calloc(ctx, ACVP_KAS_FFC_MAX_MODES, sizeof(ACVP_KAS_FFC_CAP_MODE));
     if (!modes) {
-        free(cap);
         return NULL;
     }
 
@@ -104,10 +103,10 @@ static ACVP_KAS_FFC_CAP *allocate_kas_ffc_cap(void) {
     return cap;
 }
 
-static ACVP_KAS_IFC_CAP *allocate_kas_ifc_cap(void) {
+static ACVP_KAS_IFC_CAP *allocate_kas_ifc_cap(ACVP_CTX *ctx) {
     ACVP_KAS_IFC_CAP *cap = NULL;
 
-    cap = calloc(1, sizeof(ACVP_KAS_IFC_CAP));
+    cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_IFC_CAP));
     if (!cap) {
         return NULL;
     }
@@ -115,10 +114,10 @@ static ACVP_KAS_IFC_CAP *allocate_kas_ifc_cap(void) {
     return cap;
 }
 
-static ACVP_KTS_IFC_CAP *allocate_kts_ifc_cap(void) {
+static ACVP_KTS_IFC_CAP *allocate_kts_ifc_cap(ACVP_CTX *ctx) {
     ACVP_KTS_IFC_CAP *cap = NULL;
 
-    cap = calloc(1, sizeof(ACVP_KTS_IFC_CAP));
+    cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KTS_IFC_CAP));
     if (!cap) {
         return NULL;
     }
@@ -126,10 +125,10 @@ static ACVP_KTS_IFC_CAP *allocate_kts_ifc_cap(void) {
     return cap;
 }
 
-static ACVP_SAFE_PRIMES_CAP *allocate_safe_primes_cap(void) {
+static ACVP_SAFE_PRIMES_CAP *allocate_safe_primes_cap(ACVP_CTX *ctx) {
     ACVP_SAFE_PRIMES_CAP *cap = NULL;
 
-    cap = calloc(1, sizeof(ACVP_SAFE_PRIMES_CAP));
+    cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_SAFE_PRIMES_CAP));
     if (!cap) {
         return NULL;
     }
@@ -137,6 +136,18 @@ static ACVP_SAFE_PRIMES_CAP *allocate_safe_primes_cap(void) {
     return cap;
 }
 
+/*
+ * Looks up the capability of cipher for one of its settings to be
+ * changed, which makes the saved serialization of the registration out
+ * of date, see acvp_get_current_registration()
+ */
+static ACVP_CAPS_LIST *acvp_cap_entry_update(ACVP_CTX *ctx, ACVP_CIPHER cipher) {
+    if (ctx) {
+        ctx->caps_gen++;
+    }
+    return acvp_locate_cap_entry(ctx, cipher);
+}
+
 /*!
  * @brief Create and append an ACVP_CAPS_LIST object
  *        to the current list.
@@ -158,21 +169,30 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_entry, *cap_e2;
     ACVP_RESULT rv = ACVP_SUCCESS;
 
+    if (cipher <= ACVP_CIPHER_START || cipher >= ACVP_CIPHER_END) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher'");
+        return ACVP_INVALID_ARG;
+    }
+    if (!alg_tbl[cipher - 1].handler) {
+        ACVP_LOG_ERR("Support for this algorithm was left out of the build (--enable-algorithms)");
+        return ACVP_UNSUPPORTED_OP;
+    }
+
     /*
      * Check for duplicate entry
      */
-    if (acvp_locate_cap_entry(ctx, cipher)) {
+    if (acvp_cap_entry_update(ctx, cipher)) {
         return ACVP_DUP_CIPHER;
     }
 
-    cap_entry = calloc(1, sizeof(ACVP_CAPS_LIST));
+    cap_entry = acvp_cap_calloc(ctx, 1, sizeof(ACVP_CAPS_LIST));
     if (!cap_entry) {
         return ACVP_MALLOC_FAIL;
     }
 
     switch (type) {
     case ACVP_CMAC_TYPE:
-        cap_entry->cap.cmac_cap = calloc(1, sizeof(ACVP_CMAC_CAP));
+        cap_entry->cap.cmac_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_CMAC_CAP));
         if (!cap_entry->cap.cmac_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -180,7 +200,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_KMAC_TYPE:
-        cap_entry->cap.kmac_cap = calloc(1, sizeof(ACVP_KMAC_CAP));
+        cap_entry->cap.kmac_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KMAC_CAP));
         if (!cap_entry->cap.kmac_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -188,7 +208,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_DRBG_TYPE:
-        cap_entry->cap.drbg_cap = calloc(1, sizeof(ACVP_DRBG_CAP));
+        cap_entry->cap.drbg_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DRBG_CAP));
         if (!cap_entry->cap.drbg_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -196,7 +216,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_DSA_TYPE:
-        cap_entry->cap.dsa_cap = allocate_dsa_cap();
+        cap_entry->cap.dsa_cap = allocate_dsa_cap(ctx);
         if (!cap_entry->cap.dsa_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -208,7 +228,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_keygen_cap = calloc(1, sizeof(ACVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_keygen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_keygen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -220,7 +240,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_keyver_cap = calloc(1, sizeof(ACVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_keyver_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_keyver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -232,7 +252,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_siggen_cap = calloc(1, sizeof(ACVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_siggen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_siggen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -244,7 +264,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_sigver_cap = calloc(1, sizeof(ACVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_sigver_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_sigver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -256,7 +276,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.det_ecdsa_siggen_cap = calloc(1, sizeof(ACVP_ECDSA_CAP));
+        cap_entry->cap.det_ecdsa_siggen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_ECDSA_CAP));
         if (!cap_entry->cap.det_ecdsa_siggen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -268,7 +288,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.eddsa_keygen_cap = calloc(1, sizeof(ACVP_EDDSA_CAP));
+        cap_entry->cap.eddsa_keygen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_EDDSA_CAP));
         if (!cap_entry->cap.eddsa_keygen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -280,7 +300,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.eddsa_keyver_cap = calloc(1, sizeof(ACVP_EDDSA_CAP));
+        cap_entry->cap.eddsa_keyver_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_EDDSA_CAP));
         if (!cap_entry->cap.eddsa_keyver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -292,7 +312,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.eddsa_siggen_cap = calloc(1, sizeof(ACVP_EDDSA_CAP));
+        cap_entry->cap.eddsa_siggen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_EDDSA_CAP));
         if (!cap_entry->cap.eddsa_siggen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -304,7 +324,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.eddsa_sigver_cap = calloc(1, sizeof(ACVP_EDDSA_CAP));
+        cap_entry->cap.eddsa_sigver_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_EDDSA_CAP));
         if (!cap_entry->cap.eddsa_sigver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -312,7 +332,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_HASH_TYPE:
-        cap_entry->cap.hash_cap = calloc(1, sizeof(ACVP_HASH_CAP));
+        cap_entry->cap.hash_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_HASH_CAP));
         if (!cap_entry->cap.hash_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -320,7 +340,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_HMAC_TYPE:
-        cap_entry->cap.hmac_cap = calloc(1, sizeof(ACVP_HMAC_CAP));
+        cap_entry->cap.hmac_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_HMAC_CAP));
         if (!cap_entry->cap.hmac_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -332,7 +352,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap();
+        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap(ctx);
         if (!cap_entry->cap.kas_ecc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -344,7 +364,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap();
+        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap(ctx);
         if (!cap_entry->cap.kas_ecc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -356,7 +376,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap();
+        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap(ctx);
         if (!cap_entry->cap.kas_ecc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -368,7 +388,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap();
+        cap_entry->cap.kas_ecc_cap = allocate_kas_ecc_cap(ctx);
         if (!cap_entry->cap.kas_ecc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -380,7 +400,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ffc_cap = allocate_kas_ffc_cap();
+        cap_entry->cap.kas_ffc_cap = allocate_kas_ffc_cap(ctx);
         if (!cap_entry->cap.kas_ffc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -391,7 +411,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ffc_cap = allocate_kas_ffc_cap();
+        cap_entry->cap.kas_ffc_cap = allocate_kas_ffc_cap(ctx);
         if (!cap_entry->cap.kas_ffc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -403,7 +423,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ffc_cap = allocate_kas_ffc_cap();
+        cap_entry->cap.kas_ffc_cap = allocate_kas_ffc_cap(ctx);
         if (!cap_entry->cap.kas_ffc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -415,7 +435,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kda_hkdf_cap = calloc(1, sizeof(ACVP_KDA_HKDF_CAP));
+        cap_entry->cap.kda_hkdf_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDA_HKDF_CAP));
         if (!cap_entry->cap.kda_hkdf_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -427,7 +447,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kda_onestep_cap = calloc(1, sizeof(ACVP_KDA_ONESTEP_CAP));
+        cap_entry->cap.kda_onestep_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDA_ONESTEP_CAP));
         if (!cap_entry->cap.kda_onestep_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -439,7 +459,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kda_twostep_cap = calloc(1, sizeof(ACVP_KDA_TWOSTEP_CAP));
+        cap_entry->cap.kda_twostep_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDA_TWOSTEP_CAP));
         if (!cap_entry->cap.kda_twostep_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -451,7 +471,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kas_ifc_cap = allocate_kas_ifc_cap();
+        cap_entry->cap.kas_ifc_cap = allocate_kas_ifc_cap(ctx);
         if (!cap_entry->cap.kas_ifc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -463,7 +483,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kts_ifc_cap = allocate_kts_ifc_cap();
+        cap_entry->cap.kts_ifc_cap = allocate_kts_ifc_cap(ctx);
         if (!cap_entry->cap.kts_ifc_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -475,7 +495,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf108_cap = calloc(1, sizeof(ACVP_KDF108_CAP));
+        cap_entry->cap.kdf108_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF108_CAP));
         if (!cap_entry->cap.kdf108_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -487,7 +507,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_ikev1_cap = calloc(1, sizeof(ACVP_KDF135_IKEV1_CAP));
+        cap_entry->cap.kdf135_ikev1_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_IKEV1_CAP));
         if (!cap_entry->cap.kdf135_ikev1_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -499,7 +519,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_ikev2_cap = calloc(1, sizeof(ACVP_KDF135_IKEV2_CAP));
+        cap_entry->cap.kdf135_ikev2_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_IKEV2_CAP));
         if (!cap_entry->cap.kdf135_ikev2_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -511,7 +531,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_snmp_cap = calloc(1, sizeof(ACVP_KDF135_SNMP_CAP));
+        cap_entry->cap.kdf135_snmp_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_SNMP_CAP));
         if (!cap_entry->cap.kdf135_snmp_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -523,7 +543,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_srtp_cap = calloc(1, sizeof(ACVP_KDF135_SRTP_CAP));
+        cap_entry->cap.kdf135_srtp_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_SRTP_CAP));
         if (!cap_entry->cap.kdf135_srtp_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -535,7 +555,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_ssh_cap = calloc(1, sizeof(ACVP_KDF135_SSH_CAP));
+        cap_entry->cap.kdf135_ssh_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_SSH_CAP));
         if (!cap_entry->cap.kdf135_ssh_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -547,7 +567,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_x942_cap = calloc(1, sizeof(ACVP_KDF135_X942_CAP));
+        cap_entry->cap.kdf135_x942_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_X942_CAP));
         if (!cap_entry->cap.kdf135_x942_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -559,7 +579,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_x963_cap = calloc(1, sizeof(ACVP_KDF135_X963_CAP));
+        cap_entry->cap.kdf135_x963_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF135_X963_CAP));
         if (!cap_entry->cap.kdf135_x963_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -571,7 +591,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.pbkdf_cap = calloc(1, sizeof(ACVP_PBKDF_CAP));
+        cap_entry->cap.pbkdf_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_PBKDF_CAP));
         if (!cap_entry->cap.pbkdf_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -583,7 +603,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf_tls12_cap = calloc(1, sizeof(ACVP_KDF_TLS12_CAP));
+        cap_entry->cap.kdf_tls12_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF_TLS12_CAP));
         if (!cap_entry->cap.kdf_tls12_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -595,7 +615,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf_tls13_cap = calloc(1, sizeof(ACVP_KDF_TLS13_CAP));
+        cap_entry->cap.kdf_tls13_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KDF_TLS13_CAP));
         if (!cap_entry->cap.kdf_tls13_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -607,7 +627,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_keygen_cap = calloc(1, sizeof(ACVP_RSA_KEYGEN_CAP));
+        cap_entry->cap.rsa_keygen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_KEYGEN_CAP));
         if (!cap_entry->cap.rsa_keygen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -619,7 +639,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_siggen_cap = calloc(1, sizeof(ACVP_RSA_SIG_CAP));
+        cap_entry->cap.rsa_siggen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_SIG_CAP));
         if (!cap_entry->cap.rsa_siggen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -630,7 +650,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_sigver_cap = calloc(1, sizeof(ACVP_RSA_SIG_CAP));
+        cap_entry->cap.rsa_sigver_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_SIG_CAP));
         if (!cap_entry->cap.rsa_sigver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -641,14 +661,14 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_prim_cap = calloc(1, sizeof(ACVP_RSA_PRIM_CAP));
+        cap_entry->cap.rsa_prim_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_PRIM_CAP));
         if (!cap_entry->cap.rsa_prim_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
         }
         break;
     case ACVP_SYM_TYPE:
-        cap_entry->cap.sym_cap = calloc(1, sizeof(ACVP_SYM_CIPHER_CAP));
+        cap_entry->cap.sym_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_SYM_CIPHER_CAP));
         if (!cap_entry->cap.sym_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -658,7 +678,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_SAFE_PRIMES_KEYGEN_TYPE:
-        cap_entry->cap.safe_primes_keygen_cap = allocate_safe_primes_cap();
+        cap_entry->cap.safe_primes_keygen_cap = allocate_safe_primes_cap(ctx);
         if (!cap_entry->cap.safe_primes_keygen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -666,7 +686,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_SAFE_PRIMES_KEYVER_TYPE:
-        cap_entry->cap.safe_primes_keyver_cap = allocate_safe_primes_cap();
+        cap_entry->cap.safe_primes_keyver_cap = allocate_safe_primes_cap(ctx);
         if (!cap_entry->cap.safe_primes_keyver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -674,7 +694,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_LMS_KEYGEN_TYPE:
-        cap_entry->cap.lms_keygen_cap = calloc(1, sizeof(ACVP_LMS_CAP));
+        cap_entry->cap.lms_keygen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_LMS_CAP));
         if (!cap_entry->cap.lms_keygen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -682,7 +702,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_LMS_SIGGEN_TYPE:
-        cap_entry->cap.lms_siggen_cap = calloc(1, sizeof(ACVP_LMS_CAP));
+        cap_entry->cap.lms_siggen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_LMS_CAP));
         if (!cap_entry->cap.lms_siggen_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -690,7 +710,7 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         break;
 
     case ACVP_LMS_SIGVER_TYPE:
-        cap_entry->cap.lms_sigver_cap = calloc(1, sizeof(ACVP_LMS_CAP));
+        cap_entry->cap.lms_sigver_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_LMS_CAP));
         if (!cap_entry->cap.lms_sigver_cap) {
             rv = ACVP_MALLOC_FAIL;
             goto err;
@@ -719,14 +739,16 @@ static ACVP_RESULT acvp_cap_list_append(ACVP_CTX *ctx,
         }
         cap_e2->next = cap_entry;
     }
+    ctx->caps_index[cipher] = cap_entry;
+    /* A snapshot taken before does not have it */
+    acvp_cap_snapshot_drop(ctx);
+    ctx->caps_gen++;
 
     /* Assume here one cap = one vector set; for special cases we will handle those as the parameter is set */
     ctx->vs_count++;
     return ACVP_SUCCESS;
 
 err:
-    if (cap_entry) free(cap_entry);
-
     return rv;
 }
 
@@ -852,7 +874,8 @@ static ACVP_RESULT acvp_validate_kdf108_param_value(ACVP_CTX *ctx, ACVP_KDF108_P
     return retval;
 }
 
-static ACVP_RESULT acvp_dsa_set_modulo(ACVP_DSA_CAP_MODE *dsa_cap_mode,
+static ACVP_RESULT acvp_dsa_set_modulo(ACVP_CTX *ctx,
+                                       ACVP_DSA_CAP_MODE *dsa_cap_mode,
                                        ACVP_DSA_PARM param,
                                        ACVP_HASH_ALG value) {
     ACVP_DSA_ATTRS *attrs;
@@ -863,7 +886,7 @@ static ACVP_RESULT acvp_dsa_set_modulo(ACVP_DSA_CAP_MODE *dsa_cap_mode,
 
     attrs = dsa_cap_mode->dsa_attrs;
     if (!attrs) {
-        attrs = calloc(1, sizeof(ACVP_DSA_ATTRS));
+        attrs = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DSA_ATTRS));
         if (!attrs) {
             return ACVP_MALLOC_FAIL;
         }
@@ -881,7 +904,7 @@ static ACVP_RESULT acvp_dsa_set_modulo(ACVP_DSA_CAP_MODE *dsa_cap_mode,
         }
         attrs = attrs->next;
     }
-    attrs->next = calloc(1, sizeof(ACVP_DSA_ATTRS));
+    attrs->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DSA_ATTRS));
     if (!attrs->next) {
         return ACVP_MALLOC_FAIL;
     }
@@ -912,7 +935,7 @@ static ACVP_RESULT acvp_add_dsa_mode_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    rv = acvp_dsa_set_modulo(dsa_cap_mode, param, value);
+    rv = acvp_dsa_set_modulo(ctx, dsa_cap_mode, param, value);
     if (rv != ACVP_SUCCESS) {
         return rv;
     }
@@ -2240,25 +2263,25 @@ static ACVP_RESULT acvp_validate_prereq_val(ACVP_CIPHER cipher, ACVP_PREREQ_ALG
 /*
  * Append a pre req val to the list of prereqs
  */
-static ACVP_RESULT acvp_add_prereq_val(ACVP_CIPHER cipher,
+static ACVP_RESULT acvp_add_prereq_val(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
                                        ACVP_CAPS_LIST *cap_list,
                                        ACVP_PREREQ_ALG pre_req,
                                        char *value) {
     ACVP_PREREQ_LIST *prereq_entry, *prereq_entry_2;
     ACVP_RESULT result;
 
-    prereq_entry = calloc(1, sizeof(ACVP_PREREQ_LIST));
+    result = acvp_validate_prereq_val(cipher, pre_req);
+    if (result != ACVP_SUCCESS) {
+        return result;
+    }
+
+    prereq_entry = acvp_cap_calloc(ctx, 1, sizeof(ACVP_PREREQ_LIST));
     if (!prereq_entry) {
         return ACVP_MALLOC_FAIL;
     }
     prereq_entry->prereq_alg_val.alg = pre_req;
     prereq_entry->prereq_alg_val.val = value;
-
-    result = acvp_validate_prereq_val(cipher, pre_req);
-    if (result != ACVP_SUCCESS) {
-        free(prereq_entry);
-        return result;
-    }
     /*
      * 1st entry
      */
@@ -2293,7 +2316,7 @@ ACVP_RESULT acvp_cap_set_prereq(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -2303,7 +2326,70 @@ ACVP_RESULT acvp_cap_set_prereq(ACVP_CTX *ctx,
     /*
      * Add the value to the cap
      */
-    return acvp_add_prereq_val(cipher, cap_list, pre_req_cap, value);
+    return acvp_add_prereq_val(ctx, cipher, cap_list, pre_req_cap, value);
+}
+
+ACVP_RESULT acvp_cap_set_deferred_validation(ACVP_CTX *ctx, int enable) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->caps_deferred = enable ? 1 : 0;
+    ctx->caps_gen++;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The checks acvp_cap_sym_cipher_set_parm() and _set_domain() make against
+ * settings already made, for all of them at once. Returns the number of
+ * conflicts, each of which is logged.
+ */
+static int acvp_cap_sym_cipher_check(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap) {
+    ACVP_SYM_CIPHER_CAP *symcap = cap->cap.sym_cap;
+    const char *name = acvp_lookup_cipher_name(cap->cipher);
+    int bad = 0;
+
+    if (symcap->ivlen && acvp_is_domain_already_set(&symcap->iv_len)) {
+        ACVP_LOG_ERR("%s: ivLen set with both acvp_cap_sym_cipher_set_parm() and _set_domain()", name);
+        bad++;
+    }
+    if (symcap->ptlen && acvp_is_domain_already_set(&symcap->payload_len)) {
+        ACVP_LOG_ERR("%s: ptLen set with both acvp_cap_sym_cipher_set_parm() and _set_domain()", name);
+        bad++;
+    }
+    if (symcap->aadlen && acvp_is_domain_already_set(&symcap->aad_len)) {
+        ACVP_LOG_ERR("%s: aadLen set with both acvp_cap_sym_cipher_set_parm() and _set_domain()", name);
+        bad++;
+    }
+    if (symcap->dulen_matches_paylen && acvp_is_domain_already_set(&symcap->du_len)) {
+        ACVP_LOG_ERR("%s: ACVP_SYM_CIPH_DOMAIN_DULEN can only be set if "
+                     "ACVP_SYM_CIPH_PARM_DULEN_MATCHES_PAYLOADLEN is 0 (false)", name);
+        bad++;
+    }
+    if (!symcap->perform_ctr_tests && (symcap->ctr_incr || symcap->ctr_ovrflw)) {
+        ACVP_LOG_WARN("%s: Perform counter test set to false, but value for ctr increment or ctr "
+                      "overflow set. Server will ignore other values. Continuing...", name);
+    }
+    return bad;
+}
+
+ACVP_RESULT acvp_cap_finalize(ACVP_CTX *ctx) {
+    ACVP_CAPS_LIST *cap = NULL;
+    int bad = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    for (cap = ctx->caps_list; cap; cap = cap->next) {
+        if (cap->cap_type == ACVP_SYM_TYPE && cap->cap.sym_cap) {
+            bad += acvp_cap_sym_cipher_check(ctx, cap);
+        }
+    }
+    if (bad) {
+        ACVP_LOG_ERR("%d capability setting(s) conflict", bad);
+        return ACVP_INVALID_ARG;
+    }
+    return ACVP_SUCCESS;
 }
 
 /*
@@ -2449,7 +2535,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found, use acvp_enable_sym_cipher_cap() first.");
         return ACVP_NO_CAP;
@@ -2462,7 +2548,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
 
     switch (parm) {
     case ACVP_SYM_CIPH_DOMAIN_IVLEN:
-        if (symcap->ivlen) {
+        if (!ctx->caps_deferred && symcap->ivlen) {
             ACVP_LOG_ERR("ivLen already defined using acvp_sym_cipher_set_parm. Please set ivLen using only one function "
                          "(Using set_parm for ivLen will eventually be depreciated).");
             return ACVP_INVALID_ARG;
@@ -2477,7 +2563,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
         symcap->iv_len.increment = increment;
         break;
     case ACVP_SYM_CIPH_DOMAIN_PTLEN:
-        if (symcap->ptlen) {
+        if (!ctx->caps_deferred && symcap->ptlen) {
             ACVP_LOG_ERR("ptLen already defined using acvp_sym_cipher_set_parm. Please set ptLen using only one function "
                          "(Using set_parm for ptLen will eventually be depreciated).");
             return ACVP_INVALID_ARG;
@@ -2492,7 +2578,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
         symcap->payload_len.increment = increment;
         break;
     case ACVP_SYM_CIPH_DOMAIN_AADLEN:
-        if (symcap->aadlen) {
+        if (!ctx->caps_deferred && symcap->aadlen) {
             ACVP_LOG_ERR("aadLen already defined using acvp_sym_cipher_set_parm. Please set aadLen using only one function "
                          "(Using set_parm for aadLen will eventually be depreciated).");
             return ACVP_INVALID_ARG;
@@ -2507,7 +2593,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
         symcap->aad_len.increment = increment;
         break;
     case ACVP_SYM_CIPH_DOMAIN_DULEN:
-        if (symcap->dulen_matches_paylen) {
+        if (!ctx->caps_deferred && symcap->dulen_matches_paylen) {
             ACVP_LOG_ERR("ACVP_SYM_CIPH_DOMAIN_DULEN can only be set if "
                          "ACVP_SYM_CIPH_PARM_DULEN_MATCHES_PAYLOADLEN is already set to 0 (false)");
             return ACVP_INVALID_ARG;
@@ -2533,6 +2619,556 @@ ACVP_RESULT acvp_cap_sym_cipher_set_domain(ACVP_CTX *ctx,
     return ACVP_SUCCESS;
 }
 
+/*
+ * The optional handlers a capability may be given, by cipher and by
+ * capability type; see acvp_cap_hooks()
+ */
+#define ACVP_CAP_HOOK_BATCH       0x01 /* acvp_cap_set_batch_handler(), acvp_cap_set_async_handler() */
+#define ACVP_CAP_HOOK_GROUP       0x02 /* acvp_cap_set_group_handler() */
+#define ACVP_CAP_HOOK_SOA         0x04 /* acvp_cap_sym_cipher_set_soa_handler() */
+#define ACVP_CAP_HOOK_MCT_LOOP    0x08 /* acvp_cap_sym_cipher_set_mct_loop_handler() */
+#define ACVP_CAP_HOOK_OUTPUT_SINK 0x10 /* acvp_cap_set_output_sink() */
+#define ACVP_CAP_HOOK_BN_LIMBS    0x20 /* acvp_cap_set_bn_limbs() */
+
+static const struct {
+    ACVP_CIPHER cipher;
+    unsigned int hooks;
+} acvp_cap_hook_tbl[] = {
+    { ACVP_AES_GCM,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_GCM_SIV,        ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_CCM,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_ECB,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_CBC,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_CBC_CS1,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_CBC_CS2,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_CBC_CS3,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_CFB1,           ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_CFB8,           ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_CFB128,         ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_OFB,            ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_CTR,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_XTS,            ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_KW,             ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_KWP,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_AES_GMAC,           ACVP_CAP_HOOK_BATCH },
+    { ACVP_AES_XPN,            ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_SOA },
+    { ACVP_TDES_ECB,           ACVP_CAP_HOOK_MCT_LOOP },
+    { ACVP_TDES_CBC,           ACVP_CAP_HOOK_MCT_LOOP },
+    { ACVP_TDES_OFB,           ACVP_CAP_HOOK_MCT_LOOP },
+    { ACVP_TDES_CFB1,          ACVP_CAP_HOOK_MCT_LOOP },
+    { ACVP_TDES_CFB8,          ACVP_CAP_HOOK_MCT_LOOP },
+    { ACVP_TDES_CFB64,         ACVP_CAP_HOOK_MCT_LOOP },
+    { ACVP_RSA_SIGVER,         ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_RSA_DECPRIM,        ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_RSA_SIGPRIM,        ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_EDDSA_SIGVER,       ACVP_CAP_HOOK_BATCH },
+    { ACVP_ECDSA_KEYVER,       ACVP_CAP_HOOK_BATCH },
+    { ACVP_ECDSA_SIGVER,       ACVP_CAP_HOOK_BATCH },
+    { ACVP_DSA_PQGVER,         ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_DSA_SIGVER,         ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_KAS_ECC_CDH,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_KAS_ECC_COMP,       ACVP_CAP_HOOK_BATCH },
+    { ACVP_KAS_ECC_SSC,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_PBKDF,              ACVP_CAP_HOOK_BATCH },
+    { ACVP_KDF135_SNMP,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_KDF135_SRTP,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_KDF135_X963,        ACVP_CAP_HOOK_BATCH },
+    { ACVP_HASH_SHAKE_128,     ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_HASH_SHAKE_256,     ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_KMAC_128,           ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_KMAC_256,           ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_HASHDRBG,           ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_HMACDRBG,           ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_CTRDRBG,            ACVP_CAP_HOOK_OUTPUT_SINK },
+    { ACVP_KAS_FFC_COMP,       ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_KAS_FFC_NOCOMP,     ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_KAS_FFC_SSC,        ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_KAS_IFC_SSC,        ACVP_CAP_HOOK_BN_LIMBS },
+    { ACVP_SAFE_PRIMES_KEYVER, ACVP_CAP_HOOK_BN_LIMBS }
+};
+
+static const struct {
+    ACVP_CAP_TYPE cap_type;
+    unsigned int hooks;
+} acvp_cap_type_hook_tbl[] = {
+    { ACVP_HASH_TYPE,             ACVP_CAP_HOOK_BATCH },
+    { ACVP_HMAC_TYPE,             ACVP_CAP_HOOK_BATCH | ACVP_CAP_HOOK_GROUP },
+    { ACVP_DRBG_TYPE,             ACVP_CAP_HOOK_GROUP },
+    { ACVP_ECDSA_KEYGEN_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_ECDSA_KEYVER_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_ECDSA_SIGGEN_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_ECDSA_SIGVER_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_DET_ECDSA_SIGGEN_TYPE, ACVP_CAP_HOOK_GROUP },
+    { ACVP_EDDSA_KEYGEN_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_EDDSA_KEYVER_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_EDDSA_SIGGEN_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_EDDSA_SIGVER_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_CMAC_TYPE,             ACVP_CAP_HOOK_GROUP },
+    { ACVP_KMAC_TYPE,             ACVP_CAP_HOOK_GROUP },
+    { ACVP_KDF108_TYPE,           ACVP_CAP_HOOK_GROUP },
+    { ACVP_LMS_KEYGEN_TYPE,       ACVP_CAP_HOOK_GROUP },
+    { ACVP_LMS_SIGGEN_TYPE,       ACVP_CAP_HOOK_GROUP },
+    { ACVP_LMS_SIGVER_TYPE,       ACVP_CAP_HOOK_GROUP },
+    { ACVP_RSA_SIGGEN_TYPE,       ACVP_CAP_HOOK_GROUP },
+    { ACVP_RSA_SIGVER_TYPE,       ACVP_CAP_HOOK_GROUP },
+    { ACVP_KAS_ECC_CDH_TYPE,      ACVP_CAP_HOOK_GROUP },
+    { ACVP_KAS_ECC_COMP_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_KAS_ECC_SSC_TYPE,      ACVP_CAP_HOOK_GROUP },
+    { ACVP_KAS_FFC_COMP_TYPE,     ACVP_CAP_HOOK_GROUP },
+    { ACVP_KAS_FFC_SSC_TYPE,      ACVP_CAP_HOOK_GROUP },
+    { ACVP_KAS_IFC_TYPE,          ACVP_CAP_HOOK_GROUP },
+    { ACVP_KTS_IFC_TYPE,          ACVP_CAP_HOOK_GROUP }
+};
+
+/*
+ * The ACVP_CAP_HOOK_* flags of the handlers cipher, or a capability of
+ * cap_type, may be given. A cap_type of 0 looks at the cipher only, and a
+ * cipher of ACVP_CIPHER_START at the cap_type only.
+ */
+static unsigned int acvp_cap_hooks(ACVP_CIPHER cipher, ACVP_CAP_TYPE cap_type) {
+    unsigned int hooks = 0;
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(acvp_cap_hook_tbl) / sizeof(acvp_cap_hook_tbl[0]); i++) {
+        if (acvp_cap_hook_tbl[i].cipher == cipher) {
+            hooks |= acvp_cap_hook_tbl[i].hooks;
+            break;
+        }
+    }
+    for (i = 0; i < sizeof(acvp_cap_type_hook_tbl) / sizeof(acvp_cap_type_hook_tbl[0]); i++) {
+        if (acvp_cap_type_hook_tbl[i].cap_type == cap_type) {
+            hooks |= acvp_cap_type_hook_tbl[i].hooks;
+            break;
+        }
+    }
+    return hooks;
+}
+
+/*
+ * Finds the capability for a batch or async handler, if its kat handler
+ * knows how to use one, as the ACVP_CAP_HOOK_BATCH rows of acvp_cap_hooks() say
+ */
+static ACVP_RESULT acvp_locate_batch_cap(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_CAPS_LIST **cap) {
+    *cap = acvp_cap_entry_update(ctx, cipher);
+    if (!*cap) {
+        ACVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return ACVP_NO_CAP;
+    }
+
+    if (!(acvp_cap_hooks(cipher, (*cap)->cap_type) & ACVP_CAP_HOOK_BATCH)) {
+        ACVP_LOG_ERR("Batch and async handlers are not supported for this capability");
+        return ACVP_UNSUPPORTED_OP;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Returns 1 when the AES or TDES mode has Monte Carlo tests
+ */
+static int acvp_sym_cipher_has_mct(ACVP_CIPHER cipher) {
+    switch (acvp_get_aes_alg(cipher)) {
+    case ACVP_SUB_AES_ECB:
+    case ACVP_SUB_AES_CBC:
+    case ACVP_SUB_AES_OFB:
+    case ACVP_SUB_AES_CFB1:
+    case ACVP_SUB_AES_CFB8:
+    case ACVP_SUB_AES_CFB128:
+        return 1;
+    case ACVP_SUB_AES_GCM:
+    case ACVP_SUB_AES_GCM_SIV:
+    case ACVP_SUB_AES_CCM:
+    case ACVP_SUB_AES_CBC_CS1:
+    case ACVP_SUB_AES_CBC_CS2:
+    case ACVP_SUB_AES_CBC_CS3:
+    case ACVP_SUB_AES_CTR:
+    case ACVP_SUB_AES_XTS:
+    case ACVP_SUB_AES_XPN:
+    case ACVP_SUB_AES_KW:
+    case ACVP_SUB_AES_KWP:
+    case ACVP_SUB_AES_GMAC:
+        return 0;
+    default:
+        break;
+    }
+
+    switch (acvp_get_tdes_alg(cipher)) {
+    case ACVP_SUB_TDES_ECB:
+    case ACVP_SUB_TDES_CBC:
+    case ACVP_SUB_TDES_OFB:
+    case ACVP_SUB_TDES_CFB1:
+    case ACVP_SUB_TDES_CFB8:
+    case ACVP_SUB_TDES_CFB64:
+        return 1;
+    case ACVP_SUB_TDES_CBCI:
+    case ACVP_SUB_TDES_OFBI:
+    case ACVP_SUB_TDES_CFBP1:
+    case ACVP_SUB_TDES_CFBP8:
+    case ACVP_SUB_TDES_CFBP64:
+    case ACVP_SUB_TDES_CTR:
+    case ACVP_SUB_TDES_KW:
+    default:
+        return 0;
+    }
+}
+
+/*
+ * The user may call this after enabling an AES or TDES capability to run
+ * the Monte Carlo inner loops in the crypto module, see
+ * acvp_cap_sym_cipher_set_mct_handler() in acvp.h for what it is given.
+ */
+ACVP_RESULT acvp_cap_sym_cipher_set_mct_handler(ACVP_CTX *ctx,
+                                                ACVP_CIPHER cipher,
+                                                int (*mct_handler)(ACVP_TEST_CASE *test_case)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!mct_handler) {
+        ACVP_LOG_ERR("NULL parameter 'mct_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_sym_cipher_enable() first.");
+        return ACVP_NO_CAP;
+    }
+
+    if (!acvp_sym_cipher_has_mct(cipher)) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher', no Monte Carlo tests for this capability");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap->mct_handler = mct_handler;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling a TDES capability to run its whole
+ * Monte Carlo tests in the crypto module, key schedule included, see
+ * acvp_cap_sym_cipher_set_mct_loop_handler() in acvp.h for what it is given.
+ */
+ACVP_RESULT acvp_cap_sym_cipher_set_mct_loop_handler(ACVP_CTX *ctx,
+                                                     ACVP_CIPHER cipher,
+                                                     int (*mct_loop_handler)(ACVP_TEST_CASE *test_case)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!mct_loop_handler) {
+        ACVP_LOG_ERR("NULL parameter 'mct_loop_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_sym_cipher_enable() first.");
+        return ACVP_NO_CAP;
+    }
+
+    if (!(acvp_cap_hooks(cipher, 0) & ACVP_CAP_HOOK_MCT_LOOP)) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher', no TDES Monte Carlo tests for this capability");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap->mct_loop_handler = mct_loop_handler;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling AES ECB, CBC, CTR, GCM, CCM,
+ * GCM-SIV, XPN, KW or KWP to have the AFT groups of that capability handed
+ * to the crypto module as arrays, see acvp_aes_run_soa().
+ */
+ACVP_RESULT acvp_cap_sym_cipher_set_soa_handler(ACVP_CTX *ctx,
+                                                ACVP_CIPHER cipher,
+                                                int (*soa_handler)(ACVP_SYM_CIPHER_SOA *group,
+                                                                   int *results)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!soa_handler) {
+        ACVP_LOG_ERR("NULL parameter 'soa_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_sym_cipher_enable() first.");
+        return ACVP_NO_CAP;
+    }
+
+    if (!(acvp_cap_hooks(cipher, 0) & ACVP_CAP_HOOK_SOA)) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher', no array layout for this capability");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap->soa_handler = soa_handler;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling an AES, hash, HMAC, RSA SigVer, RSA
+ * primitive or PBKDF capability to have the non-MCT test groups of that capability
+ * handed to the crypto module a whole group at a time. The crypto_handler given to the enable call is
+ * still used for the Monte Carlo tests.
+ */
+ACVP_RESULT acvp_cap_set_batch_handler(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
+                                       int (*batch_handler)(ACVP_TEST_CASE *test_cases,
+                                                            int *results,
+                                                            int count)) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!batch_handler) {
+        ACVP_LOG_ERR("NULL parameter 'batch_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    rv = acvp_locate_batch_cap(ctx, cipher, &cap);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    cap->batch_handler = batch_handler;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Like acvp_cap_set_batch_handler(), but the test cases of a group are
+ * started one at a time and completed by the crypto module through
+ * acvp_tc_complete(), with up to depth of them outstanding.
+ */
+ACVP_RESULT acvp_cap_set_async_handler(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
+                                       int (*async_handler)(ACVP_TEST_CASE *test_case,
+                                                            ACVP_TC_HANDLE *handle),
+                                       int depth) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!async_handler) {
+        ACVP_LOG_ERR("NULL parameter 'async_handler'");
+        return ACVP_INVALID_ARG;
+    }
+    if (depth < 1) {
+        ACVP_LOG_ERR("Invalid async depth %d, must be at least 1", depth);
+        return ACVP_INVALID_ARG;
+    }
+
+    rv = acvp_locate_batch_cap(ctx, cipher, &cap);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    cap->async_handler = async_handler;
+    cap->async_depth = depth;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling a SHAKE, KMAC or DRBG capability to
+ * have the crypto module write its long outputs straight into the response
+ */
+ACVP_RESULT acvp_cap_set_output_sink(ACVP_CTX *ctx, ACVP_CIPHER cipher, int enable) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    if (!(acvp_cap_hooks(cipher, 0) & ACVP_CAP_HOOK_OUTPUT_SINK)) {
+        ACVP_LOG_ERR("Output sinks are not supported for this cipher");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return ACVP_NO_CAP;
+    }
+
+    cap->output_sink = enable ? 1 : 0;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling an RSA, DSA, KAS-FFC, KAS-IFC or
+ * safe primes capability to have its big number inputs given as limbs
+ */
+ACVP_RESULT acvp_cap_set_bn_limbs(ACVP_CTX *ctx, ACVP_CIPHER cipher, int enable) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+
+    if (!(acvp_cap_hooks(cipher, 0) & ACVP_CAP_HOOK_BN_LIMBS)) {
+        ACVP_LOG_ERR("Big number limbs are not supported for this cipher");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return ACVP_NO_CAP;
+    }
+
+    cap->bn_limbs = enable ? 1 : 0;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling an AES, hash or HMAC capability to
+ * have its test cases run by a crypto module in another process, over a
+ * shared memory ring
+ */
+ACVP_RESULT acvp_cap_set_ring_handler(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_RING *ring, int depth) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!ring) {
+        ACVP_LOG_ERR("NULL parameter 'ring'");
+        return ACVP_INVALID_ARG;
+    }
+    if (depth < 1) {
+        ACVP_LOG_ERR("Invalid ring depth %d, must be at least 1", depth);
+        return ACVP_INVALID_ARG;
+    }
+
+    rv = acvp_locate_batch_cap(ctx, cipher, &cap);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+    if (!acvp_tc_layout_kind(cap)) {
+        ACVP_LOG_ERR("Rings are not supported for this capability");
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    cap->ring = ring;
+    cap->ring_depth = depth;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling an AES, hash or HMAC capability to
+ * have its test cases run by a remote device under test
+ */
+ACVP_RESULT acvp_cap_set_dut_handler(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_DUT *dut, int window) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!dut) {
+        ACVP_LOG_ERR("NULL parameter 'dut'");
+        return ACVP_INVALID_ARG;
+    }
+    if (window < 1) {
+        ACVP_LOG_ERR("Invalid window %d, must be at least 1", window);
+        return ACVP_INVALID_ARG;
+    }
+
+    rv = acvp_locate_batch_cap(ctx, cipher, &cap);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+    if (!acvp_tc_layout_kind(cap)) {
+        ACVP_LOG_ERR("Devices under test are not supported for this capability");
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    cap->dut = dut;
+    cap->dut_window = window;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling ECDSA KeyGen or safe primes KeyGen
+ * to have the keys of its test cases generated ahead of them, see
+ * acvp_key_pool.c
+ */
+ACVP_RESULT acvp_cap_set_key_pool(ACVP_CTX *ctx,
+                                  ACVP_CIPHER cipher,
+                                  int (*producer)(ACVP_TEST_CASE *test_case),
+                                  int depth) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        ACVP_LOG_ERR("Key pools are set on the context of the session itself");
+        return ACVP_INVALID_ARG;
+    }
+    if (depth < 1 || depth > ACVP_KEY_POOL_DEPTH_MAX) {
+        ACVP_LOG_ERR("Invalid key pool depth %d, must be 1 to %d", depth, ACVP_KEY_POOL_DEPTH_MAX);
+        return ACVP_INVALID_ARG;
+    }
+    if (cipher != ACVP_ECDSA_KEYGEN && cipher != ACVP_SAFE_PRIMES_KEYGEN) {
+        ACVP_LOG_ERR("Key pools are only supported for ECDSA and safe primes KeyGen");
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return ACVP_NO_CAP;
+    }
+
+    cap->key_producer = producer;
+    cap->key_pool_depth = depth;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling a DRBG, ECDSA, EdDSA, LMS, RSA
+ * signature, KAS or KTS capability to have the crypto module told when each
+ * test group starts and ends, so that what the test cases of a group share is set up once.
+ */
+ACVP_RESULT acvp_cap_set_group_handler(ACVP_CTX *ctx,
+                                       ACVP_CIPHER cipher,
+                                       int (*group_handler)(ACVP_TEST_CASE *test_case,
+                                                            ACVP_TG_EVENT event)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!group_handler) {
+        ACVP_LOG_ERR("NULL parameter 'group_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return ACVP_NO_CAP;
+    }
+    if (!(acvp_cap_hooks(ACVP_CIPHER_START, cap->cap_type) & ACVP_CAP_HOOK_GROUP)) {
+        ACVP_LOG_ERR("Group handlers are not supported for this capability");
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    cap->group_handler = group_handler;
+    return ACVP_SUCCESS;
+}
+
 /*
  * The user should call this after invoking acvp_enable_sym_cipher_cap()
  * to specify the supported key lengths, direction, etc. This is called by the 
@@ -2668,7 +3304,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_parm(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found, use acvp_cap_sym_cipher_enable() first.");
         return ACVP_NO_CAP;
@@ -2707,7 +3343,8 @@ ACVP_RESULT acvp_cap_sym_cipher_set_parm(ACVP_CTX *ctx,
 
     case ACVP_SYM_CIPH_PARM_PERFORM_CTR:
         if (value == 0 || value == 1) {
-            if (value == 0 && (cap->cap.sym_cap->ctr_incr || cap->cap.sym_cap->ctr_ovrflw)) {
+            if (!ctx->caps_deferred && value == 0 &&
+                    (cap->cap.sym_cap->ctr_incr || cap->cap.sym_cap->ctr_ovrflw)) {
                 ACVP_LOG_WARN("Perform counter test set to false, but value for ctr increment or ctr overflow already set. Server will ignore other values. Continuing...");
             }
             cap->cap.sym_cap->perform_ctr_tests = value;
@@ -2718,7 +3355,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_parm(ACVP_CTX *ctx,
         }
 
     case ACVP_SYM_CIPH_PARM_CTR_INCR:
-        if (cap->cap.sym_cap->perform_ctr_tests == 0) {
+        if (!ctx->caps_deferred && cap->cap.sym_cap->perform_ctr_tests == 0) {
             ACVP_LOG_WARN("Perform counter test set to false, but value for ctr increment being set; server will ignore this. Continuing...");
         }
         if (value == 0 || value == 1) {
@@ -2730,7 +3367,7 @@ ACVP_RESULT acvp_cap_sym_cipher_set_parm(ACVP_CTX *ctx,
         }
 
     case ACVP_SYM_CIPH_PARM_CTR_OVRFLW:
-        if (cap->cap.sym_cap->perform_ctr_tests == 0) {
+        if (!ctx->caps_deferred && cap->cap.sym_cap->perform_ctr_tests == 0) {
             ACVP_LOG_WARN("Perform counter test set to false, but value for ctr overflow being set; server will ignore this. Continuing...");
         }
         if (value == 0 || value == 1) {
@@ -2783,7 +3420,8 @@ ACVP_RESULT acvp_cap_sym_cipher_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_ERR("ACVP_SYM_CIPH_PARM_DULEN_MATCHES_PAYLOADLEN can only be set for AES-XTS");
             return ACVP_INVALID_ARG;
         }
-        if ((cap->cap.sym_cap->du_len.max != 0 || cap->cap.sym_cap->du_len.increment != 0)) {
+        if (!ctx->caps_deferred &&
+                (cap->cap.sym_cap->du_len.max != 0 || cap->cap.sym_cap->du_len.increment != 0)) {
             ACVP_LOG_ERR("ACVP_SYM_CIPH_DULEN_MATCHES_PAYLOADLEN cannot be changed after setting "
                          "ACVP_SYM_CIPH_DOMAIN_DULEN");
             return ACVP_INVALID_ARG;
@@ -2811,37 +3449,37 @@ ACVP_RESULT acvp_cap_sym_cipher_set_parm(ACVP_CTX *ctx,
 
     switch (parm) {
     case ACVP_SYM_CIPH_KEYLEN:
-        acvp_append_sl_list(&cap->cap.sym_cap->keylen, value);
+        acvp_append_sl_list(ctx, &cap->cap.sym_cap->keylen, value);
         break;
     case ACVP_SYM_CIPH_TAGLEN:
-        acvp_append_sl_list(&cap->cap.sym_cap->taglen, value);
+        acvp_append_sl_list(ctx, &cap->cap.sym_cap->taglen, value);
         break;
     case ACVP_SYM_CIPH_IVLEN:
-        if (acvp_is_domain_already_set(&cap->cap.sym_cap->iv_len)) {
+        if (!ctx->caps_deferred && acvp_is_domain_already_set(&cap->cap.sym_cap->iv_len)) {
             ACVP_LOG_ERR("ivLen already defined using acvp_sym_cipher_set_domain. Please set ivLen using only one function "
                         "(Using set_parm for ivLen will eventually be depreciated).");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_sl_list(&cap->cap.sym_cap->ivlen, value);
+        acvp_append_sl_list(ctx, &cap->cap.sym_cap->ivlen, value);
         break;
     case ACVP_SYM_CIPH_PTLEN:
-        if (acvp_is_domain_already_set(&cap->cap.sym_cap->payload_len)) {
+        if (!ctx->caps_deferred && acvp_is_domain_already_set(&cap->cap.sym_cap->payload_len)) {
             ACVP_LOG_ERR("payloadLen already defined using acvp_sym_cipher_set_domain. Please set payloadLen using only one function "
                          "(Using set_parm for payloadLen will eventually be depreciated).");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_sl_list(&cap->cap.sym_cap->ptlen, value);
+        acvp_append_sl_list(ctx, &cap->cap.sym_cap->ptlen, value);
         break;
     case ACVP_SYM_CIPH_TWEAK:
-        acvp_append_sl_list(&cap->cap.sym_cap->tweak, value);
+        acvp_append_sl_list(ctx, &cap->cap.sym_cap->tweak, value);
         break;
     case ACVP_SYM_CIPH_AADLEN:
-        if (acvp_is_domain_already_set(&cap->cap.sym_cap->aad_len)) {
+        if (!ctx->caps_deferred && acvp_is_domain_already_set(&cap->cap.sym_cap->aad_len)) {
             ACVP_LOG_ERR("aadLen already defined using acvp_sym_cipher_set_domain. Please set aadLen using only one function "
                          "(Using set_parm for aadLen will eventually be depreciated).");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_sl_list(&cap->cap.sym_cap->aadlen, value);
+        acvp_append_sl_list(ctx, &cap->cap.sym_cap->aadlen, value);
         break;
     case ACVP_SYM_CIPH_KW_MODE:
     case ACVP_SYM_CIPH_PARM_DIR:
@@ -3132,7 +3770,7 @@ ACVP_RESULT acvp_cap_hash_set_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -3177,7 +3815,7 @@ ACVP_RESULT acvp_cap_hash_set_parm(ACVP_CTX *ctx,
         hash_cap->out_bit = value;
         break;
     case ACVP_HASH_LARGE_DATA:
-        if (acvp_append_sl_list(&hash_cap->large_lens, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &hash_cap->large_lens, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding LDT len to list");
             return ACVP_MALLOC_FAIL;
         }
@@ -3235,7 +3873,7 @@ ACVP_RESULT acvp_cap_hash_set_domain(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -3304,6 +3942,100 @@ ACVP_RESULT acvp_cap_hash_set_domain(ACVP_CTX *ctx,
     return ACVP_SUCCESS;
 }
 
+/*
+ * The user may call this after acvp_cap_hash_enable() to have the crypto
+ * module run each Monte Carlo inner loop in a single call
+ */
+ACVP_RESULT acvp_cap_hash_set_mct_handler(ACVP_CTX *ctx,
+                                          ACVP_CIPHER cipher,
+                                          int (*mct_handler)(ACVP_TEST_CASE *test_case)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!mct_handler) {
+        ACVP_LOG_ERR("NULL parameter 'mct_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_hash_enable() first.");
+        return ACVP_NO_CAP;
+    }
+    if (cap->cap_type != ACVP_HASH_TYPE) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher', not a hash capability");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap->mct_handler = mct_handler;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after acvp_cap_hash_enable() to have the crypto
+ * module run every checkpoint of a Monte Carlo test in a single call
+ */
+ACVP_RESULT acvp_cap_hash_set_mct_loop_handler(ACVP_CTX *ctx,
+                                               ACVP_CIPHER cipher,
+                                               int (*mct_loop_handler)(ACVP_TEST_CASE *test_case)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!mct_loop_handler) {
+        ACVP_LOG_ERR("NULL parameter 'mct_loop_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_hash_enable() first.");
+        return ACVP_NO_CAP;
+    }
+    if (cap->cap_type != ACVP_HASH_TYPE) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher', not a hash capability");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap->mct_loop_handler = mct_loop_handler;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The user may call this after enabling a SHA-1, SHA-2 or SHA-3 capability
+ * to have its AFT groups handed to the crypto module as arrays, see
+ * acvp_hash_run_soa().
+ */
+ACVP_RESULT acvp_cap_hash_set_soa_handler(ACVP_CTX *ctx,
+                                          ACVP_CIPHER cipher,
+                                          int (*soa_handler)(ACVP_HASH_SOA *group, int *results)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!soa_handler) {
+        ACVP_LOG_ERR("NULL parameter 'soa_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, cipher);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_hash_enable() first.");
+        return ACVP_NO_CAP;
+    }
+    if (cap->cap_type != ACVP_HASH_TYPE || cipher == ACVP_HASH_SHAKE_128 || cipher == ACVP_HASH_SHAKE_256) {
+        ACVP_LOG_ERR("Invalid parameter 'cipher', not a SHA-1, SHA-2 or SHA-3 capability");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap->hash_soa_handler = soa_handler;
+    return ACVP_SUCCESS;
+}
+
 static ACVP_RESULT acvp_validate_hmac_parm_value(ACVP_CIPHER cipher,
                                                  ACVP_HMAC_PARM parm,
                                                  int value) {
@@ -3422,7 +4154,7 @@ ACVP_RESULT acvp_cap_hmac_set_domain(ACVP_CTX *ctx,
     ACVP_JSON_DOMAIN_OBJ *domain;
     ACVP_HMAC_CAP *current_hmac_cap;
 
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -3478,7 +4210,7 @@ ACVP_RESULT acvp_cap_hmac_set_parm(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found, use acvp_enable_hmac_cipher_cap() first.");
         return ACVP_NO_CAP;
@@ -3491,13 +4223,13 @@ ACVP_RESULT acvp_cap_hmac_set_parm(ACVP_CTX *ctx,
 
     switch (parm) {
     case ACVP_HMAC_KEYLEN:
-        if (acvp_append_sl_list(&cap->cap.hmac_cap->key_len.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &cap->cap.hmac_cap->key_len.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding HMAC key length to list");
             return ACVP_MALLOC_FAIL;
         }
         break;
     case ACVP_HMAC_MACLEN:
-        if (acvp_append_sl_list(&cap->cap.hmac_cap->mac_len.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &cap->cap.hmac_cap->mac_len.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding HMAC mac length to list");
             return ACVP_MALLOC_FAIL;
         }
@@ -3599,7 +4331,7 @@ ACVP_RESULT acvp_cap_cmac_set_domain(ACVP_CTX *ctx,
     ACVP_JSON_DOMAIN_OBJ *domain;
     ACVP_CMAC_CAP *current_cmac_cap;
 
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -3658,7 +4390,7 @@ ACVP_RESULT acvp_cap_cmac_set_parm(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found, use acvp_enable_cmac_cipher_cap() first.");
         return ACVP_NO_CAP;
@@ -3670,13 +4402,13 @@ ACVP_RESULT acvp_cap_cmac_set_parm(ACVP_CTX *ctx,
 
     switch (parm) {
     case ACVP_CMAC_MSGLEN:
-        if (acvp_append_sl_list(&current_cmac_cap->msg_len.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &current_cmac_cap->msg_len.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding CMAC msg len to list");
             return ACVP_MALLOC_FAIL;
         }
         break;
     case ACVP_CMAC_MACLEN:
-        if (acvp_append_sl_list(&current_cmac_cap->mac_len.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &current_cmac_cap->mac_len.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding CMAC mac len to list");
             return ACVP_MALLOC_FAIL;
         }
@@ -3688,11 +4420,11 @@ ACVP_RESULT acvp_cap_cmac_set_parm(ACVP_CTX *ctx,
         cap->cap.cmac_cap->direction_ver = value;
         break;
     case ACVP_CMAC_KEYLEN:
-        acvp_append_sl_list(&cap->cap.cmac_cap->key_len, value);
+        acvp_append_sl_list(ctx, &cap->cap.cmac_cap->key_len, value);
         break;
     case ACVP_CMAC_KEYING_OPTION:
         if (cipher == ACVP_CMAC_TDES) {
-            acvp_append_sl_list(&cap->cap.cmac_cap->keying_option, value);
+            acvp_append_sl_list(ctx, &cap->cap.cmac_cap->keying_option, value);
             break;
         }
         return ACVP_INVALID_ARG;
@@ -3751,7 +4483,7 @@ ACVP_RESULT acvp_cap_kmac_set_parm(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found, use acvp_enable_kmac_cipher_cap() first.");
         return ACVP_NO_CAP;
@@ -3803,7 +4535,7 @@ ACVP_RESULT acvp_cap_kmac_set_domain(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         ACVP_LOG_ERR("Cap entry not found, use acvp_enable_kmac_cipher_cap() first.");
         return ACVP_NO_CAP;
@@ -3854,6 +4586,106 @@ ACVP_RESULT acvp_cap_kmac_set_domain(ACVP_CTX *ctx,
 
 }
 
+/*
+ * The type of capability each kind of ACVP_CAP_PARM_ENTRY sets
+ */
+static ACVP_CAP_TYPE acvp_cap_parm_kind_type(ACVP_CAP_PARM_KIND kind) {
+    switch (kind) {
+    case ACVP_CAP_SYM_CIPHER_PARM:
+    case ACVP_CAP_SYM_CIPHER_DOMAIN:
+        return ACVP_SYM_TYPE;
+    case ACVP_CAP_HASH_PARM:
+    case ACVP_CAP_HASH_DOMAIN:
+        return ACVP_HASH_TYPE;
+    case ACVP_CAP_HMAC_PARM:
+    case ACVP_CAP_HMAC_DOMAIN:
+        return ACVP_HMAC_TYPE;
+    case ACVP_CAP_CMAC_PARM:
+    case ACVP_CAP_CMAC_DOMAIN:
+        return ACVP_CMAC_TYPE;
+    case ACVP_CAP_KMAC_PARM:
+    case ACVP_CAP_KMAC_DOMAIN:
+        return ACVP_KMAC_TYPE;
+    default:
+        return 0;
+    }
+}
+
+static ACVP_RESULT acvp_cap_set_parm_entry(ACVP_CTX *ctx, const ACVP_CAP_PARM_ENTRY *e) {
+    switch (e->kind) {
+    case ACVP_CAP_SYM_CIPHER_PARM:
+        return acvp_cap_sym_cipher_set_parm(ctx, e->cipher, e->param, e->value);
+    case ACVP_CAP_SYM_CIPHER_DOMAIN:
+        return acvp_cap_sym_cipher_set_domain(ctx, e->cipher, e->param, e->value, e->max, e->increment);
+    case ACVP_CAP_HASH_PARM:
+        return acvp_cap_hash_set_parm(ctx, e->cipher, e->param, e->value);
+    case ACVP_CAP_HASH_DOMAIN:
+        return acvp_cap_hash_set_domain(ctx, e->cipher, e->param, e->value, e->max, e->increment);
+    case ACVP_CAP_HMAC_PARM:
+        return acvp_cap_hmac_set_parm(ctx, e->cipher, e->param, e->value);
+    case ACVP_CAP_HMAC_DOMAIN:
+        return acvp_cap_hmac_set_domain(ctx, e->cipher, e->param, e->value, e->max, e->increment);
+    case ACVP_CAP_CMAC_PARM:
+        return acvp_cap_cmac_set_parm(ctx, e->cipher, e->param, e->value);
+    case ACVP_CAP_CMAC_DOMAIN:
+        return acvp_cap_cmac_set_domain(ctx, e->cipher, e->param, e->value, e->max, e->increment);
+    case ACVP_CAP_KMAC_PARM:
+        return acvp_cap_kmac_set_parm(ctx, e->cipher, e->param, e->value);
+    case ACVP_CAP_KMAC_DOMAIN:
+        return acvp_cap_kmac_set_domain(ctx, e->cipher, e->param, e->value, e->max, e->increment);
+    default:
+        return ACVP_INVALID_ARG;
+    }
+}
+
+/*
+ * Applies a table of set_parm/set_domain calls. The capabilities the
+ * table names are all checked up front, so a table with an entry for a
+ * cipher that was never enabled is rejected before anything is changed.
+ */
+ACVP_RESULT acvp_cap_set_parms(ACVP_CTX *ctx,
+                               const ACVP_CAP_PARM_ENTRY *table,
+                               int count) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_CAP_TYPE type = 0;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!table || count <= 0) {
+        ACVP_LOG_ERR("Missing table of capability parameters");
+        return ACVP_INVALID_ARG;
+    }
+
+    for (i = 0; i < count; i++) {
+        type = acvp_cap_parm_kind_type(table[i].kind);
+        if (!type) {
+            ACVP_LOG_ERR("Invalid kind of capability parameter (entry %d)", i);
+            return ACVP_INVALID_ARG;
+        }
+        cap = acvp_cap_entry_update(ctx, table[i].cipher);
+        if (!cap) {
+            ACVP_LOG_ERR("Cap entry not found for entry %d, enable the cipher first", i);
+            return ACVP_NO_CAP;
+        }
+        if (cap->cap_type != type) {
+            ACVP_LOG_ERR("Entry %d does not match the type of its capability", i);
+            return ACVP_INVALID_ARG;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        rv = acvp_cap_set_parm_entry(ctx, &table[i]);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Failed to set capability parameter (entry %d)", i);
+            return rv;
+        }
+    }
+    return ACVP_SUCCESS;
+}
+
 /*
  * Add DRBG Length Range
  */
@@ -3920,7 +4752,7 @@ ACVP_RESULT acvp_cap_drbg_set_length(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -3932,7 +4764,7 @@ ACVP_RESULT acvp_cap_drbg_set_length(ACVP_CTX *ctx,
      */
     drbg_cap_mode  = acvp_locate_drbg_mode_entry(cap_list, mode);
     if (!drbg_cap_mode) {
-        drbg_cap_mode = acvp_create_drbg_mode_entry(cap_list, mode);
+        drbg_cap_mode = acvp_create_drbg_mode_entry(ctx, cap_list, mode);
         if (!drbg_cap_mode) {
             ACVP_LOG_ERR("Malloc Failed.");
             return ACVP_MALLOC_FAIL;
@@ -3941,7 +4773,7 @@ ACVP_RESULT acvp_cap_drbg_set_length(ACVP_CTX *ctx,
 
     grp = acvp_locate_drbg_group_entry(drbg_cap_mode, group);
     if (!grp) {
-        grp = acvp_create_drbg_group(drbg_cap_mode, group);
+        grp = acvp_create_drbg_group(ctx, drbg_cap_mode, group);
         if (!grp) {
             ACVP_LOG_ERR("Error creating group for DRBG capabilities");
             return ACVP_MALLOC_FAIL;
@@ -4067,7 +4899,7 @@ ACVP_RESULT acvp_cap_drbg_set_parm(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4084,7 +4916,7 @@ ACVP_RESULT acvp_cap_drbg_set_parm(ACVP_CTX *ctx,
 
     cap_mode = acvp_locate_drbg_mode_entry(cap_list, mode);
     if (!cap_mode) {
-        cap_mode = acvp_create_drbg_mode_entry(cap_list, mode);
+        cap_mode = acvp_create_drbg_mode_entry(ctx, cap_list, mode);
         if (!cap_mode) {
             ACVP_LOG_ERR("Malloc Failed.");
             return ACVP_MALLOC_FAIL;
@@ -4093,7 +4925,7 @@ ACVP_RESULT acvp_cap_drbg_set_parm(ACVP_CTX *ctx,
 
     grp = acvp_locate_drbg_group_entry(cap_mode, group);
     if (!grp) {
-        grp = acvp_create_drbg_group(cap_mode, group);
+        grp = acvp_create_drbg_group(ctx, cap_mode, group);
         if (!grp) {
             ACVP_LOG_ERR("Error creating group for DRBG capabilities");
             return ACVP_MALLOC_FAIL;
@@ -4183,7 +5015,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_mode(ACVP_CTX *ctx,
     ACVP_RSA_KEYGEN_CAP *keygen_cap;
     ACVP_RESULT result = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_KEYGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_KEYGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4199,7 +5031,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_mode(ACVP_CTX *ctx,
             return ACVP_DUP_CIPHER;
         }
         if (!keygen_cap->next) {
-            keygen_cap->next = calloc(1, sizeof(ACVP_RSA_KEYGEN_CAP));
+            keygen_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_KEYGEN_CAP));
             keygen_cap = keygen_cap->next;
             break;
         }
@@ -4220,7 +5052,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_parm(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list;
     ACVP_RESULT rv = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_KEYGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_KEYGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4314,7 +5146,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4352,7 +5184,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_parm(ACVP_CTX *ctx,
                                          int value) {
     ACVP_CAPS_LIST *cap_list;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGVER);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGVER);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4392,7 +5224,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_type(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list;
     ACVP_RSA_SIG_CAP *sigver_cap;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGVER);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGVER);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4413,7 +5245,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_type(ACVP_CTX *ctx,
             return ACVP_DUP_CIPHER;
         }
         if (!sigver_cap->next) {
-            sigver_cap->next = calloc(1, sizeof(ACVP_RSA_SIG_CAP));
+            sigver_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_SIG_CAP));
             sigver_cap = sigver_cap->next;
             break;
         }
@@ -4442,14 +5274,14 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_type(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list;
     ACVP_RSA_SIG_CAP *siggen_cap;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
     }
 
     if (!cap_list->cap.rsa_siggen_cap) {
-        cap_list->cap.rsa_siggen_cap = calloc(1, sizeof(ACVP_RSA_SIG_CAP));
+        cap_list->cap.rsa_siggen_cap = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_SIG_CAP));
     }
     siggen_cap = cap_list->cap.rsa_siggen_cap;
 
@@ -4466,7 +5298,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_type(ACVP_CTX *ctx,
             return ACVP_DUP_CIPHER;
         }
         if (!siggen_cap->next) {
-            siggen_cap->next = calloc(1, sizeof(ACVP_RSA_SIG_CAP));
+            siggen_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_SIG_CAP));
             siggen_cap = siggen_cap->next;
             break;
         }
@@ -4497,7 +5329,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_exponent(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list = NULL;
     ACVP_RSA_KEYGEN_CAP *cap = NULL;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_KEYGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_KEYGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4522,7 +5354,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_exponent(ACVP_CTX *ctx,
                     return ACVP_INVALID_ARG;
                 }
 
-                cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+                cap->fixed_pub_exp = acvp_cap_calloc(ctx, len + 1, sizeof(char));
                 strcpy_s(cap->fixed_pub_exp, len + 1, value);
             } else {
                 ACVP_LOG_ERR("ACVP_FIXED_PUB_EXP_VAL has already been set.");
@@ -4553,7 +5385,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_exponent(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list = NULL;
     ACVP_RSA_SIG_CAP *cap = NULL;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGVER);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGVER);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4578,7 +5410,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_exponent(ACVP_CTX *ctx,
                     return ACVP_INVALID_ARG;
                 }
 
-                cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+                cap->fixed_pub_exp = acvp_cap_calloc(ctx, len + 1, sizeof(char));
                 strcpy_s(cap->fixed_pub_exp, len + 1, value);
             } else {
                 ACVP_LOG_ERR("ACVP_FIXED_PUB_EXP_VAL has already been set.");
@@ -4600,6 +5432,34 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_exponent(ACVP_CTX *ctx,
     return ACVP_SUCCESS;
 }
 
+/*
+ * The user may call this after enabling RSA SigVer to have its test groups
+ * handed to the crypto module as one key and arrays of messages and
+ * signatures, see acvp_rsa_sigver_run_soa().
+ */
+ACVP_RESULT acvp_cap_rsa_sigver_set_soa_handler(ACVP_CTX *ctx,
+                                                int (*soa_handler)(ACVP_RSA_SIGVER_SOA *group,
+                                                                   int *results)) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!soa_handler) {
+        ACVP_LOG_ERR("NULL parameter 'soa_handler'");
+        return ACVP_INVALID_ARG;
+    }
+
+    cap = acvp_cap_entry_update(ctx, ACVP_RSA_SIGVER);
+    if (!cap) {
+        ACVP_LOG_ERR("Cap entry not found, use acvp_cap_rsa_sig_enable() first.");
+        return ACVP_NO_CAP;
+    }
+
+    cap->rsa_sigver_soa_handler = soa_handler;
+    return ACVP_SUCCESS;
+}
+
 /*
  * The user should call this after invoking acvp_enable_rsa_cap_parm()
  * and setting the randPQ value.
@@ -4615,7 +5475,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_primes(ACVP_CTX *ctx,
     ACVP_RESULT result = ACVP_SUCCESS;
     int found = 0;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_KEYGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_KEYGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4641,7 +5501,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_primes(ACVP_CTX *ctx,
     }
 
     if (!keygen_cap->mode_capabilities) {
-        keygen_cap->mode_capabilities = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+        keygen_cap->mode_capabilities = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
         if (!keygen_cap->mode_capabilities) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -4655,7 +5515,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_primes(ACVP_CTX *ctx,
         do {
             if (current_prime->modulo != mod) {
                 if (current_prime->next == NULL) {
-                    current_prime->next = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+                    current_prime->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
                     if (!current_prime->next) {
                         ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
                         return ACVP_MALLOC_FAIL;
@@ -4675,7 +5535,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_primes(ACVP_CTX *ctx,
     switch(param) {
     case ACVP_RSA_PRIME_HASH_ALG:
         if(acvp_lookup_hash_alg_name(value)) {
-            result = acvp_append_param_list(&current_prime->hash_algs, value);
+            result = acvp_append_param_list(ctx, &current_prime->hash_algs, value);
         } else {
             ACVP_LOG_ERR("Invalid 'value' for ACVP_RSA_HASH_ALG");
             result = ACVP_INVALID_ARG;
@@ -4684,7 +5544,7 @@ ACVP_RESULT acvp_cap_rsa_keygen_set_primes(ACVP_CTX *ctx,
     case ACVP_RSA_PRIME_TEST:
         /* Just use the string lookup to make sure its a valid value) */
         if (acvp_lookup_rsa_prime_test_name(value)) {
-            acvp_append_param_list(&current_prime->prime_tests, value);
+            acvp_append_param_list(ctx, &current_prime->prime_tests, value);
         } else {
             ACVP_LOG_ERR("Invalid 'value' for ACVP_RSA_PRIME_TEST");
             result = ACVP_INVALID_ARG;
@@ -4746,7 +5606,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGVER);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGVER);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4765,7 +5625,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_parm(ACVP_CTX *ctx,
     }
 
     if (!sigver_cap->mode_capabilities) {
-        sigver_cap->mode_capabilities = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+        sigver_cap->mode_capabilities = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
         if (!sigver_cap->mode_capabilities) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -4779,7 +5639,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_parm(ACVP_CTX *ctx,
         do {
             if (current_cap->modulo != mod) {
                 if (current_cap->next == NULL) {
-                    current_cap->next = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+                    current_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
                     if (!current_cap->next) {
                         ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
                         return ACVP_MALLOC_FAIL;
@@ -4797,7 +5657,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_parm(ACVP_CTX *ctx,
     }
 
     if (!current_cap->hash_pair) {
-        current_cap->hash_pair = calloc(1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
+        current_cap->hash_pair = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
         if (!current_cap->hash_pair) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -4811,7 +5671,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_parm(ACVP_CTX *ctx,
         while (current_hash->next != NULL) {
             current_hash = current_hash->next;
         }
-        current_hash->next = calloc(1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
+        current_hash->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
         if (!current_hash->next) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -4851,7 +5711,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_mask(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4871,7 +5731,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_mask(ACVP_CTX *ctx,
     }
 
     if (!siggen_cap->mode_capabilities) {
-        siggen_cap->mode_capabilities = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+        siggen_cap->mode_capabilities = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
         if (!siggen_cap->mode_capabilities) {
             ACVP_LOG_ERR("Failure allocating memory for RSA siggen capability obj");
             return ACVP_MALLOC_FAIL;
@@ -4885,7 +5745,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_mask(ACVP_CTX *ctx,
         do {
             if (current_cap->modulo != mod) {
                 if (current_cap->next == NULL) {
-                    current_cap->next = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+                    current_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
                     if (!current_cap->next) {
                         ACVP_LOG_ERR("Failure allocating memory for RSA siggen capability obj");
                         return ACVP_MALLOC_FAIL;
@@ -4902,7 +5762,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_mask(ACVP_CTX *ctx,
         } while (!found && current_cap);
     }
 
-    acvp_append_param_list(&current_cap->mask_functions, value);
+    acvp_append_param_list(ctx, &current_cap->mask_functions, value);
 
     return ACVP_SUCCESS;
 }
@@ -4933,7 +5793,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_mask(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGVER);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGVER);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -4953,7 +5813,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_mask(ACVP_CTX *ctx,
     }
 
     if (!sigver_cap->mode_capabilities) {
-        sigver_cap->mode_capabilities = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+        sigver_cap->mode_capabilities = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
         if (!sigver_cap->mode_capabilities) {
             ACVP_LOG_ERR("Failure allocating memory for RSA sigver capability obj");
             return ACVP_MALLOC_FAIL;
@@ -4967,7 +5827,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_mask(ACVP_CTX *ctx,
         do {
             if (current_cap->modulo != mod) {
                 if (current_cap->next == NULL) {
-                    current_cap->next = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+                    current_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
                     if (!current_cap->next) {
                         ACVP_LOG_ERR("Failure allocating memory for RSA sigver capability obj");
                         return ACVP_MALLOC_FAIL;
@@ -4984,7 +5844,7 @@ ACVP_RESULT acvp_cap_rsa_sigver_set_mod_mask(ACVP_CTX *ctx,
         } while (!found && current_cap);
     }
 
-    acvp_append_param_list(&current_cap->mask_functions, value);
+    acvp_append_param_list(ctx, &current_cap->mask_functions, value);
 
     return ACVP_SUCCESS;
 }
@@ -5013,7 +5873,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_RSA_SIGGEN);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_RSA_SIGGEN);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -5047,7 +5907,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_parm(ACVP_CTX *ctx,
     }
 
     if (!siggen_cap->mode_capabilities) {
-        siggen_cap->mode_capabilities = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+        siggen_cap->mode_capabilities = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
         if (!siggen_cap->mode_capabilities) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -5061,7 +5921,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_parm(ACVP_CTX *ctx,
         do {
             if (current_cap->modulo != mod) {
                 if (current_cap->next == NULL) {
-                    current_cap->next = calloc(1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
+                    current_cap->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_MODE_CAPS_LIST));
                     if (!current_cap->next) {
                         ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
                         return ACVP_MALLOC_FAIL;
@@ -5079,7 +5939,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_parm(ACVP_CTX *ctx,
     }
 
     if (!current_cap->hash_pair) {
-        current_cap->hash_pair = calloc(1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
+        current_cap->hash_pair = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
         if (!current_cap->hash_pair) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -5091,7 +5951,7 @@ ACVP_RESULT acvp_cap_rsa_siggen_set_mod_parm(ACVP_CTX *ctx,
         while (current_hash->next != NULL) {
             current_hash = current_hash->next;
         }
-        current_hash->next = calloc(1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
+        current_hash->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_RSA_HASH_PAIR_LIST));
         if (!current_hash->next) {
             ACVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return ACVP_MALLOC_FAIL;
@@ -5237,7 +6097,7 @@ ACVP_RESULT acvp_cap_rsa_prim_set_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -5262,7 +6122,7 @@ ACVP_RESULT acvp_cap_rsa_prim_set_parm(ACVP_CTX *ctx,
         switch (value) {
         case ACVP_RSA_KEY_FORMAT_STANDARD:
         case ACVP_RSA_KEY_FORMAT_CRT:
-            acvp_append_param_list(&cap_list->cap.rsa_prim_cap->key_formats, value);
+            acvp_append_param_list(ctx, &cap_list->cap.rsa_prim_cap->key_formats, value);
             break;
         default:
             ACVP_LOG_ERR("Invalid key format provided for RSA primitive");
@@ -5289,7 +6149,7 @@ ACVP_RESULT acvp_cap_rsa_prim_set_parm(ACVP_CTX *ctx,
             rv = ACVP_INVALID_ARG;
             break;
         }
-        acvp_append_sl_list(&cap_list->cap.rsa_prim_cap->modulo, value);
+        acvp_append_sl_list(ctx, &cap_list->cap.rsa_prim_cap->modulo, value);
         break;
     case ACVP_RSA_PARM_FIXED_PUB_EXP_VAL:
     case ACVP_RSA_PARM_RAND_PQ:
@@ -5317,7 +6177,7 @@ ACVP_RESULT acvp_cap_rsa_prim_set_exponent(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -5347,7 +6207,7 @@ ACVP_RESULT acvp_cap_rsa_prim_set_exponent(ACVP_CTX *ctx,
                     return ACVP_INVALID_ARG;
                 }
 
-                cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+                cap->fixed_pub_exp = acvp_cap_calloc(ctx, len + 1, sizeof(char));
                 strcpy_s(cap->fixed_pub_exp, len + 1, value);
             } else {
                 ACVP_LOG_ERR("ACVP_FIXED_PUB_EXP_VAL has already been set.");
@@ -5383,7 +6243,7 @@ ACVP_RESULT acvp_cap_ecdsa_set_parm(ACVP_CTX *ctx,
     ACVP_SUB_ECDSA alg;
     ACVP_RESULT result = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -5430,10 +6290,10 @@ ACVP_RESULT acvp_cap_ecdsa_set_parm(ACVP_CTX *ctx,
             while (current_curve->next) {
                 current_curve = current_curve->next;
             }
-            current_curve->next = calloc(1, sizeof(ACVP_CURVE_ALG_COMPAT_LIST));
+            current_curve->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_CURVE_ALG_COMPAT_LIST));
             current_curve->next->curve = value;
         } else {
-            cap->curves = calloc(1, sizeof(ACVP_CURVE_ALG_COMPAT_LIST));
+            cap->curves = acvp_cap_calloc(ctx, 1, sizeof(ACVP_CURVE_ALG_COMPAT_LIST));
             cap->curves->curve = value;
         }
         break;
@@ -5454,7 +6314,7 @@ ACVP_RESULT acvp_cap_ecdsa_set_parm(ACVP_CTX *ctx,
             return ACVP_INVALID_ARG;
         }
 
-        result = acvp_append_name_list(&cap->secret_gen_modes, string);
+        result = acvp_append_name_list(ctx, &cap->secret_gen_modes, string);
         break;
     case ACVP_ECDSA_HASH_ALG:
         if (cipher != ACVP_ECDSA_SIGGEN && cipher != ACVP_ECDSA_SIGVER && cipher != ACVP_DET_ECDSA_SIGGEN) {
@@ -5523,7 +6383,7 @@ ACVP_RESULT acvp_cap_ecdsa_set_curve_hash_alg(ACVP_CTX *ctx, ACVP_CIPHER cipher,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -5614,12 +6474,11 @@ ACVP_RESULT acvp_cap_eddsa_set_parm(ACVP_CTX *ctx,
                                     ACVP_EDDSA_PARM param,
                                     int value) {
     ACVP_CAPS_LIST *cap_list;
-    ACVP_PARAM_LIST *current_curve;
     ACVP_EDDSA_CAP *cap;
     ACVP_SUB_EDDSA alg;
     ACVP_RESULT result = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -5659,23 +6518,7 @@ ACVP_RESULT acvp_cap_eddsa_set_parm(ACVP_CTX *ctx,
             return ACVP_INVALID_ARG;
         }
 
-        current_curve = cap->curves;
-        if (current_curve) {
-            while (current_curve->next) {
-                current_curve = current_curve->next;
-            }
-            current_curve->next = calloc(1, sizeof(ACVP_PARAM_LIST));
-            if (!current_curve->next) {
-                return ACVP_MALLOC_FAIL;
-            }
-            current_curve->next->param = value;
-        } else {
-            cap->curves = calloc(1, sizeof(ACVP_PARAM_LIST));
-            if (!cap->curves) {
-                return ACVP_MALLOC_FAIL;
-            }
-            cap->curves->param = value;
-        }
+        result = acvp_append_param_list(ctx, &cap->curves, value);
         break;
     case ACVP_EDDSA_SUPPORTS_PURE:
         cap->supports_pure = value;
@@ -5759,7 +6602,7 @@ ACVP_RESULT acvp_cap_dsa_set_parm(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -5831,7 +6674,7 @@ ACVP_RESULT acvp_cap_kdf135_snmp_set_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, kcap);
+    cap = acvp_cap_entry_update(ctx, kcap);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -5841,7 +6684,7 @@ ACVP_RESULT acvp_cap_kdf135_snmp_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CAP;
     }
 
-    acvp_append_sl_list(&kdf135_snmp_cap->pass_lens, value);
+    acvp_append_sl_list(ctx, &kdf135_snmp_cap->pass_lens, value);
 
     return ACVP_SUCCESS;
 }
@@ -5870,7 +6713,7 @@ ACVP_RESULT acvp_cap_kdf135_snmp_set_engid(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, kcap);
+    cap = acvp_cap_entry_update(ctx, kcap);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -5880,7 +6723,7 @@ ACVP_RESULT acvp_cap_kdf135_snmp_set_engid(ACVP_CTX *ctx,
         return ACVP_NO_CAP;
     }
 
-    result = acvp_append_name_list(&kdf135_snmp_cap->eng_ids, engid);
+    result = acvp_append_name_list(ctx, &kdf135_snmp_cap->eng_ids, engid);
 
     return result;
 }
@@ -6104,7 +6947,7 @@ ACVP_RESULT acvp_cap_pbkdf_set_domain(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list;
     ACVP_JSON_DOMAIN_OBJ *domain;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_PBKDF);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_PBKDF);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6168,7 +7011,7 @@ ACVP_RESULT acvp_cap_pbkdf_set_parm(ACVP_CTX *ctx,
     const char *alg_str = NULL;
     ACVP_RESULT result = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_PBKDF);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_PBKDF);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found. You must enable algorithm before setting parameters.");
         return ACVP_NO_CAP;
@@ -6188,7 +7031,7 @@ ACVP_RESULT acvp_cap_pbkdf_set_parm(ACVP_CTX *ctx,
     if (acvp_is_in_name_list(cap->hmac_algs, alg_str)) {
         ACVP_LOG_WARN("Attempting to register an hmac alg with PBKDF that has already been registered, skipping.");
     } else {
-        result = acvp_append_name_list(&cap->hmac_algs, alg_str);
+        result = acvp_append_name_list(ctx, &cap->hmac_algs, alg_str);
     }
     return result;
 }
@@ -6208,7 +7051,7 @@ ACVP_RESULT acvp_cap_kdf135_ssh_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, kcap);
+    cap = acvp_cap_entry_update(ctx, kcap);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -6263,7 +7106,7 @@ ACVP_RESULT acvp_cap_kdf108_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, ACVP_KDF108);
+    cap = acvp_cap_entry_update(ctx, ACVP_KDF108);
 
     if (!cap) {
         return ACVP_NO_CAP;
@@ -6328,79 +7171,79 @@ ACVP_RESULT acvp_cap_kdf108_set_parm(ACVP_CTX *ctx,
     case ACVP_KDF108_MAC_MODE:
         switch (value) {
         case ACVP_KDF108_MAC_MODE_CMAC_AES128:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_AES_128);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_AES_128);
             break;
         case ACVP_KDF108_MAC_MODE_CMAC_AES192:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_AES_192);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_AES_192);
             break;
         case ACVP_KDF108_MAC_MODE_CMAC_AES256:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_AES_256);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_AES_256);
             break;
         case ACVP_KDF108_MAC_MODE_CMAC_TDES:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_TDES);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_TDES);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA1:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA1);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA1);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA224:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_224);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_224);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA256:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_256);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_256);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA384:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_384);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_384);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA512:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA512_224:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_224);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_224);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA512_256:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_256);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_256);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA3_224:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_224);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_224);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA3_256:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_256);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_256);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA3_384:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_384);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_384);
             break;
         case ACVP_KDF108_MAC_MODE_HMAC_SHA3_512:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_512);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_512);
             break;
         case ACVP_KDF108_MAC_MODE_KMAC_128:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_KMAC_128);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_KMAC_128);
             break;
         case ACVP_KDF108_MAC_MODE_KMAC_256:
-            result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_KMAC_256);
+            result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_KMAC_256);
             break;
         default:
             return ACVP_INVALID_ARG;
         }
         break;
     case ACVP_KDF108_COUNTER_LEN:
-        acvp_append_sl_list(&mode_obj->counter_lens, value);
+        acvp_append_sl_list(ctx, &mode_obj->counter_lens, value);
         break;
     case ACVP_KDF108_FIXED_DATA_ORDER:
         switch (value) {
         case ACVP_KDF108_FIXED_DATA_ORDER_AFTER:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_AFTER_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_AFTER_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_BEFORE:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_MIDDLE:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_MIDDLE_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_MIDDLE_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_NONE:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_NONE_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_NONE_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_BEFORE_ITERATOR:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_ITERATOR_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_ITERATOR_STR);
             break;
         default:
             return ACVP_INVALID_ARG;
@@ -6418,31 +7261,31 @@ ACVP_RESULT acvp_cap_kdf108_set_parm(ACVP_CTX *ctx,
        }
        break;
     case ACVP_KDF108_SUPPORTED_LEN:
-        if (acvp_append_sl_list(&mode_obj->supported_lens.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &mode_obj->supported_lens.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding supported length for KDF108 to list");
             return ACVP_MALLOC_FAIL;
         }
         break;
     case ACVP_KDF108_DERIVATION_KEYLEN: /**< KDF108-KMAC only */
-        if (acvp_append_sl_list(&mode_obj->derivation_keylens.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &mode_obj->derivation_keylens.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding derivation key length for KDF108 to list");
             return ACVP_MALLOC_FAIL;
         }
         break;
     case ACVP_KDF108_DERIVED_KEYLEN:    /**< KDF108-KMAC only */
-        if (acvp_append_sl_list(&mode_obj->derived_keylens.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &mode_obj->derived_keylens.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding derived key length for KDF108 to list");
             return ACVP_MALLOC_FAIL;
         }
         break;
     case ACVP_KDF108_CONTEXT_LEN:       /**< KDF108-KMAC only */
-        if (acvp_append_sl_list(&mode_obj->context_lens.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &mode_obj->context_lens.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding context length for KDF108 to list");
             return ACVP_MALLOC_FAIL;
         }
         break;
     case ACVP_KDF108_LABEL_LEN:         /**< KDF108-KMAC only */
-        if (acvp_append_sl_list(&mode_obj->label_lens.values, value) != ACVP_SUCCESS) {
+        if (acvp_append_sl_list(ctx, &mode_obj->label_lens.values, value) != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Error adding label length for KDF108 to list");
             return ACVP_MALLOC_FAIL;
         }
@@ -6476,7 +7319,7 @@ ACVP_RESULT acvp_cap_kdf135_srtp_set_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -6497,7 +7340,7 @@ ACVP_RESULT acvp_cap_kdf135_srtp_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_ERR("invalid aes keylen");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_sl_list(&kdf135_srtp_cap->aes_keylens, value);
+        acvp_append_sl_list(ctx, &kdf135_srtp_cap->aes_keylens, value);
         break;
     case ACVP_SRTP_SUPPORT_ZERO_KDR:
         if (is_valid_tf_param(value) != ACVP_SUCCESS) {
@@ -6551,7 +7394,7 @@ ACVP_RESULT acvp_cap_kdf135_ikev2_set_parm(ACVP_CTX *ctx,
     ACVP_KDF135_IKEV2_CAP *cap = NULL;
     ACVP_RESULT result = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_IKEV2);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_IKEV2);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6565,19 +7408,19 @@ ACVP_RESULT acvp_cap_kdf135_ikev2_set_parm(ACVP_CTX *ctx,
 
     switch (value) {
     case ACVP_SHA1:
-        result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA_1);
+        result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA_1);
         break;
     case ACVP_SHA224:
-        result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_224);
+        result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_224);
         break;
     case ACVP_SHA256:
-        result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_256);
+        result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_256);
         break;
     case ACVP_SHA384:
-        result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_384);
+        result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_384);
         break;
     case ACVP_SHA512:
-        result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_512);
+        result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_512);
         break;
     default:
         ACVP_LOG_ERR("Invalid hash algorithm.");
@@ -6594,7 +7437,7 @@ ACVP_RESULT acvp_cap_kdf135_ikev2_set_length(ACVP_CTX *ctx,
     ACVP_KDF135_IKEV2_CAP *cap;
     ACVP_JSON_DOMAIN_OBJ *domain;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_IKEV2);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_IKEV2);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6639,7 +7482,7 @@ ACVP_RESULT acvp_cap_kdf135_ikev2_set_length(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    if (acvp_append_sl_list(&domain->values, value) != ACVP_SUCCESS) {
+    if (acvp_append_sl_list(ctx, &domain->values, value) != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Error adding provided length to list for IKEV2");
         return ACVP_MALLOC_FAIL;
     }
@@ -6654,7 +7497,7 @@ ACVP_RESULT acvp_cap_kdf135_ikev1_set_parm(ACVP_CTX *ctx,
     ACVP_RESULT result = ACVP_SUCCESS;
     ACVP_KDF135_IKEV1_CAP *cap;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_IKEV1);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_IKEV1);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6664,19 +7507,19 @@ ACVP_RESULT acvp_cap_kdf135_ikev1_set_parm(ACVP_CTX *ctx,
     if (param == ACVP_KDF_IKEv1_HASH_ALG) {
         switch (value) {
         case ACVP_SHA1:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA_1);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA_1);
             break;
         case ACVP_SHA224:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_224);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_224);
             break;
         case ACVP_SHA256:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_256);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_256);
             break;
         case ACVP_SHA384:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_384);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_384);
             break;
         case ACVP_SHA512:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_512);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_512);
             break;
         default:
             ACVP_LOG_ERR("Invalid hash algorithm.");
@@ -6717,7 +7560,7 @@ ACVP_RESULT acvp_cap_kdf135_x942_set_domain(ACVP_CTX *ctx,
     ACVP_KDF135_X942_CAP *cap = NULL;
     ACVP_JSON_DOMAIN_OBJ *domain = NULL;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_X942);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_X942);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6764,7 +7607,7 @@ ACVP_RESULT acvp_cap_kdf135_x942_set_parm(ACVP_CTX *ctx,
     ACVP_KDF135_X942_CAP *cap;
     const char *alg = NULL;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_X942);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_X942);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6786,21 +7629,21 @@ ACVP_RESULT acvp_cap_kdf135_x942_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_ERR("Invalid hash alg provided for kdf135-x942");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_name_list(&cap->hash_algs, alg);
+        acvp_append_name_list(ctx, &cap->hash_algs, alg);
         break;
     case ACVP_KDF_X942_OID:
         switch (value) {
         case ACVP_KDF_X942_OID_TDES:
-            acvp_append_name_list(&cap->oids, "TDES");
+            acvp_append_name_list(ctx, &cap->oids, "TDES");
             break;
         case ACVP_KDF_X942_OID_AES128KW:
-            acvp_append_name_list(&cap->oids, "AES-128-KW");
+            acvp_append_name_list(ctx, &cap->oids, "AES-128-KW");
             break;
         case ACVP_KDF_X942_OID_AES192KW:
-            acvp_append_name_list(&cap->oids, "AES-192-KW");
+            acvp_append_name_list(ctx, &cap->oids, "AES-192-KW");
             break;
         case ACVP_KDF_X942_OID_AES256KW:
-            acvp_append_name_list(&cap->oids, "AES-256-KW");
+            acvp_append_name_list(ctx, &cap->oids, "AES-256-KW");
             break;
         default:
             ACVP_LOG_ERR("Invalid OID provided for kdf135-x942");
@@ -6827,7 +7670,7 @@ ACVP_RESULT acvp_cap_kdf135_x963_set_parm(ACVP_CTX *ctx,
     ACVP_KDF135_X963_CAP *cap;
     ACVP_RESULT result = ACVP_SUCCESS;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_X963);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_X963);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6837,16 +7680,16 @@ ACVP_RESULT acvp_cap_kdf135_x963_set_parm(ACVP_CTX *ctx,
     if (param == ACVP_KDF_X963_HASH_ALG) {
         switch (value) {
         case ACVP_SHA224:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_224);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_224);
             break;
         case ACVP_SHA256:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_256);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_256);
             break;
         case ACVP_SHA384:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_384);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_384);
             break;
         case ACVP_SHA512:
-            result = acvp_append_name_list(&cap->hash_algs, ACVP_STR_SHA2_512);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, ACVP_STR_SHA2_512);
             break;
         default:
             ACVP_LOG_ERR("Invalid hash alg");
@@ -6860,7 +7703,7 @@ ACVP_RESULT acvp_cap_kdf135_x963_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid key len value");
                 return ACVP_INVALID_ARG;
             }
-            acvp_append_sl_list(&cap->key_data_lengths, value);
+            acvp_append_sl_list(ctx, &cap->key_data_lengths, value);
             break;
         case ACVP_KDF_X963_FIELD_SIZE:
             if (value != ACVP_KDF135_X963_FIELD_SIZE_224 &&
@@ -6874,7 +7717,7 @@ ACVP_RESULT acvp_cap_kdf135_x963_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid field size value");
                 return ACVP_INVALID_ARG;
             }
-            acvp_append_sl_list(&cap->field_sizes, value);
+            acvp_append_sl_list(ctx, &cap->field_sizes, value);
             break;
         case ACVP_KDF_X963_SHARED_INFO_LEN:
             if (value < ACVP_KDF135_X963_SHARED_INFO_LEN_MIN ||
@@ -6882,7 +7725,7 @@ ACVP_RESULT acvp_cap_kdf135_x963_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid shared info len value");
                 return ACVP_INVALID_ARG;
             }
-            acvp_append_sl_list(&cap->shared_info_lengths, value);
+            acvp_append_sl_list(ctx, &cap->shared_info_lengths, value);
             break;
         case ACVP_KDF_X963_HASH_ALG:
         default:
@@ -6901,7 +7744,7 @@ ACVP_RESULT acvp_cap_kdf135_ikev2_set_domain(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list;
     ACVP_JSON_DOMAIN_OBJ *domain;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_IKEV2);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_IKEV2);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -6960,7 +7803,7 @@ ACVP_RESULT acvp_cap_kdf135_ikev1_set_domain(ACVP_CTX *ctx,
     ACVP_CAPS_LIST *cap_list;
     ACVP_JSON_DOMAIN_OBJ *domain;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF135_IKEV1);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF135_IKEV1);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -7021,7 +7864,7 @@ ACVP_RESULT acvp_cap_kdf108_set_domain(ACVP_CTX *ctx,
     ACVP_JSON_DOMAIN_OBJ *domain;
     ACVP_KDF108_MODE_PARAMS *mode_obj;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF108);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF108);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -7150,7 +7993,7 @@ ACVP_RESULT acvp_cap_kdf_tls12_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF_TLS12);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF_TLS12);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found. You must enable algorithm before setting parameters.");
         return ACVP_NO_CAP;
@@ -7172,7 +8015,7 @@ ACVP_RESULT acvp_cap_kdf_tls12_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_WARN("Attempting to register a hash alg with TLS 1.2 KDF that has already been registered, skipping.");
             return ACVP_SUCCESS;
         } else {
-            result = acvp_append_name_list(&cap->hash_algs, alg_str);
+            result = acvp_append_name_list(ctx, &cap->hash_algs, alg_str);
         }
         break;
     case ACVP_KDF_TLS12_PARAM_MIN:
@@ -7217,7 +8060,7 @@ ACVP_RESULT acvp_cap_kdf_tls13_set_parm(ACVP_CTX *ctx,
     ACVP_RESULT result = ACVP_SUCCESS;
     const char *alg_str = NULL;
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDF_TLS13);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDF_TLS13);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found. You must enable algorithm before setting parameters.");
         return ACVP_NO_CAP;
@@ -7235,7 +8078,7 @@ ACVP_RESULT acvp_cap_kdf_tls13_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_WARN("Attempting to register an hmac alg with TLS 1.3 KDF that has already been registered, skipping.");
             return ACVP_SUCCESS;
         } else {
-            result = acvp_append_name_list(&cap->hmac_algs, alg_str);
+            result = acvp_append_name_list(ctx, &cap->hmac_algs, alg_str);
         }
         break;
     case ACVP_KDF_TLS13_RUNNING_MODE:
@@ -7243,7 +8086,7 @@ ACVP_RESULT acvp_cap_kdf_tls13_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_ERR("Invalid TLS 1.3 KDF running mode provided");
             return ACVP_INVALID_ARG;
         }
-        result = acvp_append_param_list(&cap->running_mode, value);
+        result = acvp_append_param_list(ctx, &cap->running_mode, value);
         break;
     case ACVP_KDF_TLS13_PARAM_MIN:
     default:
@@ -7256,12 +8099,13 @@ ACVP_RESULT acvp_cap_kdf_tls13_set_parm(ACVP_CTX *ctx,
 /*
  * Append a KAS-ECC pre req val to the capabilities
  */
-static ACVP_RESULT acvp_add_kas_ecc_prereq_val(ACVP_KAS_ECC_CAP_MODE *kas_ecc_mode,
+static ACVP_RESULT acvp_add_kas_ecc_prereq_val(ACVP_CTX *ctx,
+                                               ACVP_KAS_ECC_CAP_MODE *kas_ecc_mode,
                                                ACVP_PREREQ_ALG pre_req,
                                                char *value) {
     ACVP_PREREQ_LIST *prereq_entry, *prereq_entry_2;
 
-    prereq_entry = calloc(1, sizeof(ACVP_PREREQ_LIST));
+    prereq_entry = acvp_cap_calloc(ctx, 1, sizeof(ACVP_PREREQ_LIST));
     if (!prereq_entry) {
         return ACVP_MALLOC_FAIL;
     }
@@ -7323,7 +8167,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_prereq(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -7338,7 +8182,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_prereq(ACVP_CTX *ctx,
     /*
      * Add the value to the cap
      */
-    return acvp_add_kas_ecc_prereq_val(kas_ecc_mode, pre_req, value);
+    return acvp_add_kas_ecc_prereq_val(ctx, kas_ecc_mode, pre_req, value);
 }
 
 ACVP_RESULT acvp_cap_kas_ecc_enable(ACVP_CTX *ctx,
@@ -7441,7 +8285,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -7460,7 +8304,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid kas ecc function");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_param_list(&kas_ecc_cap_mode->function, value);
+            result = acvp_append_param_list(ctx, &kas_ecc_cap_mode->function, value);
             break;
         case ACVP_KAS_ECC_REVISION:
             if (cipher == ACVP_KAS_ECC_CDH) {
@@ -7487,7 +8331,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid kas ecc curve attr");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_param_list(&kas_ecc_cap_mode->curve, value);
+            result = acvp_append_param_list(ctx, &kas_ecc_cap_mode->curve, value);
             break;
         case ACVP_KAS_ECC_NONE:
             if (cipher == ACVP_KAS_ECC_SSC) {
@@ -7516,7 +8360,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid kas ecc function");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_param_list(&kas_ecc_cap_mode->function, value);
+            result = acvp_append_param_list(ctx, &kas_ecc_cap_mode->function, value);
             break;
         case ACVP_KAS_ECC_REVISION:
         case ACVP_KAS_ECC_CURVE:
@@ -7592,7 +8436,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_scheme(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -7620,7 +8464,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_scheme(ACVP_CTX *ctx,
         }
         /* if there are none or didn't find the one we're looking for... */
         if (current_scheme == NULL) {
-            kas_ecc_cap_mode->scheme = calloc(1, sizeof(ACVP_KAS_ECC_SCHEME));
+            kas_ecc_cap_mode->scheme = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_ECC_SCHEME));
             kas_ecc_cap_mode->scheme->scheme = scheme;
             current_scheme = kas_ecc_cap_mode->scheme;
         }
@@ -7636,7 +8480,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_scheme(ACVP_CTX *ctx,
                 value != ACVP_KAS_ECC_ROLE_RESPONDER) {
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_param_list(&current_scheme->role, value);
+            result = acvp_append_param_list(ctx, &current_scheme->role, value);
             break;
         case ACVP_KAS_ECC_EB:
         case ACVP_KAS_ECC_EC:
@@ -7652,7 +8496,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_scheme(ACVP_CTX *ctx,
                 }
             }
             if (!current_pset) {
-                current_pset = calloc(1, sizeof(ACVP_KAS_ECC_PSET));
+                current_pset = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_ECC_PSET));
                 if (current_scheme->pset == NULL) {
                     current_scheme->pset = current_pset;
                 } else {
@@ -7662,7 +8506,7 @@ ACVP_RESULT acvp_cap_kas_ecc_set_scheme(ACVP_CTX *ctx,
                 current_pset->curve = option;
             }
             //then set sha in a param list
-            result = acvp_append_param_list(&current_pset->sha, value);
+            result = acvp_append_param_list(ctx, &current_pset->sha, value);
             break;
         case ACVP_KAS_ECC_NONE:
             break;
@@ -7697,7 +8541,7 @@ static ACVP_RESULT acvp_add_kas_ffc_prereq_val(ACVP_CTX *ctx, ACVP_KAS_FFC_CAP_M
                                                char *value) {
     ACVP_PREREQ_LIST *prereq_entry, *prereq_entry_2;
 
-    prereq_entry = calloc(1, sizeof(ACVP_PREREQ_LIST));
+    prereq_entry = acvp_cap_calloc(ctx, 1, sizeof(ACVP_PREREQ_LIST));
     if (!prereq_entry) {
         return ACVP_MALLOC_FAIL;
     }
@@ -7759,7 +8603,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_prereq(ACVP_CTX *ctx,
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -7875,7 +8719,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_parm(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -7893,7 +8737,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_parm(ACVP_CTX *ctx,
                 ACVP_LOG_ERR("invalid kas ffc function");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_param_list(&kas_ffc_cap_mode->function, value);
+            result = acvp_append_param_list(ctx, &kas_ffc_cap_mode->function, value);
             break;
         case ACVP_KAS_FFC_CURVE:
         case ACVP_KAS_FFC_ROLE:
@@ -7922,7 +8766,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_parm(ACVP_CTX *ctx,
     case ACVP_KAS_FFC_MODE_NONE:
         switch (param) {
         case ACVP_KAS_FFC_GEN_METH:
-            result = acvp_append_param_list(&kas_ffc_cap_mode->genmeth, value);
+            result = acvp_append_param_list(ctx, &kas_ffc_cap_mode->genmeth, value);
             break;
         case ACVP_KAS_FFC_HASH:
             if ((value < ACVP_NO_SHA || value >= ACVP_HASH_ALG_MAX) && !(value & (value - 1))) {
@@ -7983,7 +8827,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_scheme(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -8011,7 +8855,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_scheme(ACVP_CTX *ctx,
         }
         /* if there are none or didn't find the one we're looking for... */
         if (current_scheme == NULL) {
-            kas_ffc_cap_mode->scheme = calloc(1, sizeof(ACVP_KAS_FFC_SCHEME));
+            kas_ffc_cap_mode->scheme = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_FFC_SCHEME));
             kas_ffc_cap_mode->scheme->scheme = scheme;
             current_scheme = kas_ffc_cap_mode->scheme;
         }
@@ -8027,7 +8871,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_scheme(ACVP_CTX *ctx,
                 value != ACVP_KAS_FFC_ROLE_RESPONDER) {
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_param_list(&current_scheme->role, value);
+            result = acvp_append_param_list(ctx, &current_scheme->role, value);
             break;
         case ACVP_KAS_FFC_FB:
         case ACVP_KAS_FFC_FC:
@@ -8051,7 +8895,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_scheme(ACVP_CTX *ctx,
                 }
             }
             if (!current_pset) {
-                current_pset = calloc(1, sizeof(ACVP_KAS_FFC_PSET));
+                current_pset = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KAS_FFC_PSET));
                 if (current_scheme->pset == NULL) {
                     current_scheme->pset = current_pset;
                 } else {
@@ -8060,7 +8904,7 @@ ACVP_RESULT acvp_cap_kas_ffc_set_scheme(ACVP_CTX *ctx,
                 current_pset->set = param;
             }
             //then set sha in a param list
-            result = acvp_append_param_list(&current_pset->sha, value);
+            result = acvp_append_param_list(ctx, &current_pset->sha, value);
             break;
         case ACVP_KAS_FFC_FUNCTION:
         case ACVP_KAS_FFC_CURVE:
@@ -8121,7 +8965,7 @@ ACVP_RESULT acvp_cap_kas_ifc_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -8134,16 +8978,16 @@ ACVP_RESULT acvp_cap_kas_ifc_set_parm(ACVP_CTX *ctx,
     switch (param)
     {
     case ACVP_KAS_IFC_KAS1:
-        result = acvp_append_param_list(&kas_ifc_cap->kas1_roles, value);
+        result = acvp_append_param_list(ctx, &kas_ifc_cap->kas1_roles, value);
         break;
     case ACVP_KAS_IFC_KAS2:
-        result = acvp_append_param_list(&kas_ifc_cap->kas2_roles, value);
+        result = acvp_append_param_list(ctx, &kas_ifc_cap->kas2_roles, value);
         break;
     case ACVP_KAS_IFC_KEYGEN_METHOD:
-        result = acvp_append_param_list(&kas_ifc_cap->keygen_method, value);
+        result = acvp_append_param_list(ctx, &kas_ifc_cap->keygen_method, value);
         break;
     case ACVP_KAS_IFC_MODULO:
-        acvp_append_sl_list(&kas_ifc_cap->modulo, value);
+        acvp_append_sl_list(ctx, &kas_ifc_cap->modulo, value);
         break;
     case ACVP_KAS_IFC_HASH:
         if ((value < ACVP_NO_SHA || value >= ACVP_HASH_ALG_MAX) && !(value & (value - 1))) {
@@ -8173,7 +9017,7 @@ ACVP_RESULT acvp_cap_kas_ifc_set_exponent(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -8193,7 +9037,7 @@ ACVP_RESULT acvp_cap_kas_ifc_set_exponent(ACVP_CTX *ctx,
     if (param != ACVP_KAS_IFC_FIXEDPUBEXP) {
         return ACVP_INVALID_ARG;
     }        
-    kas_ifc_cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+    kas_ifc_cap->fixed_pub_exp = acvp_cap_calloc(ctx, len + 1, sizeof(char));
     strcpy_s(kas_ifc_cap->fixed_pub_exp, len + 1, value);
     return ACVP_SUCCESS;
 }
@@ -8282,7 +9126,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -8305,7 +9149,6 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
         case ACVP_KDA_PATTERN:
             if (value == ACVP_KDA_PATTERN_LITERAL && os_cap->literal_pattern_candidate) {
                 ACVP_LOG_WARN("Literal pattern candidate was already previously set. Replacing...");
-                free(os_cap->literal_pattern_candidate);
                 os_cap->literal_pattern_candidate = NULL;
             }
             if (value == ACVP_KDA_PATTERN_LITERAL) {
@@ -8317,7 +9160,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                     ACVP_LOG_ERR("Provided literal string empty");
                     return ACVP_INVALID_ARG;
                 }
-                os_cap->literal_pattern_candidate = calloc(ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
+                os_cap->literal_pattern_candidate = acvp_cap_calloc(ctx, ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
                 if (!os_cap->literal_pattern_candidate) {
                     ACVP_LOG_ERR("Unable to allocate memory for literal pattern candidate");
                     return ACVP_MALLOC_FAIL;
@@ -8326,7 +9169,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                           ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX, string, len);
             }
             if (value > ACVP_KDA_PATTERN_NONE && value < ACVP_KDA_PATTERN_MAX) {
-                result = acvp_append_param_list(&os_cap->patterns, value);
+                result = acvp_append_param_list(ctx, &os_cap->patterns, value);
             } else {
                 ACVP_LOG_ERR("Invalid pattern type specified when setting param for KDA onestep.");
                 return ACVP_INVALID_ARG;
@@ -8341,7 +9184,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
             break;
         case ACVP_KDA_ENCODING_TYPE:
             if (value > ACVP_KDA_ENCODING_NONE && value < ACVP_KDA_ENCODING_MAX) {
-                result = acvp_append_param_list(&os_cap->encodings, value);
+                result = acvp_append_param_list(ctx, &os_cap->encodings, value);
             } else {
                 ACVP_LOG_ERR("Invalid encoding type specified when setting param for KDA onestep.");
                 return ACVP_INVALID_ARG;
@@ -8360,10 +9203,10 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
             break;
         case ACVP_KDA_MAC_SALT:
             if (value == ACVP_KDA_MAC_SALT_METHOD_DEFAULT) {
-                result = acvp_append_name_list(&os_cap->mac_salt_methods,
+                result = acvp_append_name_list(ctx, &os_cap->mac_salt_methods,
                                                ACVP_KDA_MAC_SALT_METHOD_DEFAULT_STR);
             } else if (value == ACVP_KDA_MAC_SALT_METHOD_RANDOM) {
-                result = acvp_append_name_list(&os_cap->mac_salt_methods,
+                result = acvp_append_name_list(ctx, &os_cap->mac_salt_methods,
                                                ACVP_KDA_MAC_SALT_METHOD_RANDOM_STR);
             } else {
                 ACVP_LOG_ERR("Invalid value for ACVK_KDA_MAC_SALT");
@@ -8376,7 +9219,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                 ACVP_LOG_ERR("Invalid aux function cipher provided");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_name_list(&os_cap->aux_functions, tmp);
+            result = acvp_append_name_list(ctx, &os_cap->aux_functions, tmp);
             break;
         case ACVP_KDA_Z:
         case ACVP_KDA_USE_HYBRID_SECRET:
@@ -8402,7 +9245,6 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
         case ACVP_KDA_PATTERN:
             if (value == ACVP_KDA_PATTERN_LITERAL && hkdf_cap->literal_pattern_candidate) {
                 ACVP_LOG_WARN("Literal pattern candidate was already previously set. Replacing...");
-                free(hkdf_cap->literal_pattern_candidate);
                 hkdf_cap->literal_pattern_candidate = NULL;
             }
             if (value == ACVP_KDA_PATTERN_LITERAL) {
@@ -8414,7 +9256,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                     ACVP_LOG_ERR("Provided literal string empty");
                     return ACVP_INVALID_ARG;
                 }
-                hkdf_cap->literal_pattern_candidate = calloc(ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
+                hkdf_cap->literal_pattern_candidate = acvp_cap_calloc(ctx, ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
                 if (!hkdf_cap->literal_pattern_candidate) {
                     ACVP_LOG_ERR("Unable to allocate memory for literal pattern candidate");
                     return ACVP_MALLOC_FAIL;
@@ -8427,7 +9269,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                 return ACVP_INVALID_ARG;
             }
             if (value > ACVP_KDA_PATTERN_NONE && value < ACVP_KDA_PATTERN_MAX) {
-                result = acvp_append_param_list(&hkdf_cap->patterns, value);
+                result = acvp_append_param_list(ctx, &hkdf_cap->patterns, value);
             } else {
                 ACVP_LOG_ERR("Invalid pattern type specified when setting param for KDA-HKDF.");
                 return ACVP_INVALID_ARG;
@@ -8442,7 +9284,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
             break;
         case ACVP_KDA_ENCODING_TYPE:
             if (value > ACVP_KDA_ENCODING_NONE && value < ACVP_KDA_ENCODING_MAX) {
-                result = acvp_append_param_list(&hkdf_cap->encodings, value);
+                result = acvp_append_param_list(ctx, &hkdf_cap->encodings, value);
             } else {
                 ACVP_LOG_ERR("Invalid encoding type specified when setting param for KDA-HKDF.");
                 return ACVP_INVALID_ARG;
@@ -8461,10 +9303,10 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
             break;
         case ACVP_KDA_MAC_SALT:
             if (value == ACVP_KDA_MAC_SALT_METHOD_DEFAULT) {
-                result = acvp_append_name_list(&hkdf_cap->mac_salt_methods,
+                result = acvp_append_name_list(ctx, &hkdf_cap->mac_salt_methods,
                                                ACVP_KDA_MAC_SALT_METHOD_DEFAULT_STR);
             } else if (value == ACVP_KDA_MAC_SALT_METHOD_RANDOM) {
-                result = acvp_append_name_list(&hkdf_cap->mac_salt_methods,
+                result = acvp_append_name_list(ctx, &hkdf_cap->mac_salt_methods,
                                                ACVP_KDA_MAC_SALT_METHOD_RANDOM_STR);
             } else {
                 ACVP_LOG_ERR("Invalid value for ACVK_KDA_MAC_SALT");
@@ -8477,7 +9319,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                 ACVP_LOG_ERR("Invalid value for hmac alg for KDA-HKDF");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_name_list(&hkdf_cap->hmac_algs, tmp);
+            result = acvp_append_name_list(ctx, &hkdf_cap->hmac_algs, tmp);
             break;
         case ACVP_KDA_USE_HYBRID_SECRET:
             /* revision is only set for non-default revisions */
@@ -8485,7 +9327,7 @@ ACVP_RESULT acvp_cap_kda_set_parm(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_PA
                 ACVP_LOG_ERR("Hybrid secrets for HKDF can only be set for revision SP800-56Cr2");
                 return ACVP_INVALID_ARG;
             }
-            result = acvp_append_sl_list(&cap_list->cap.kda_hkdf_cap->aux_secret_len.values, value);
+            result = acvp_append_sl_list(ctx, &cap_list->cap.kda_hkdf_cap->aux_secret_len.values, value);
             if (result == ACVP_SUCCESS) {
                 cap_list->cap.kda_hkdf_cap->use_hybrid_shared_secret = 1;
             }
@@ -8540,7 +9382,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
         return ACVP_NO_CTX;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDA_TWOSTEP);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDA_TWOSTEP);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found. You must enable algorithm before setting parameters.");
         return ACVP_NO_CAP;
@@ -8608,7 +9450,6 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
     case ACVP_KDA_PATTERN:
         if (value == ACVP_KDA_PATTERN_LITERAL && cap->literal_pattern_candidate) {
             ACVP_LOG_WARN("Literal pattern candidate was already previously set. Replacing...");
-            free(cap->literal_pattern_candidate);
             cap->literal_pattern_candidate = NULL;
         }
         if (value == ACVP_KDA_PATTERN_LITERAL) {
@@ -8620,7 +9461,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
                 ACVP_LOG_ERR("Provided literal string empty");
                 return ACVP_INVALID_ARG;
             }
-            cap->literal_pattern_candidate = calloc(ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
+            cap->literal_pattern_candidate = acvp_cap_calloc(ctx, ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
             if (!cap->literal_pattern_candidate) {
                 ACVP_LOG_ERR("Unable to allocate memory for literal pattern candidate");
                 return ACVP_MALLOC_FAIL;
@@ -8629,7 +9470,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
                         ACVP_KDA_PATTERN_LITERAL_STR_LEN_MAX, string, len);
         }
         if (value > ACVP_KDA_PATTERN_NONE && value < ACVP_KDA_PATTERN_MAX) {
-            result = acvp_append_param_list(&cap->patterns, value);
+            result = acvp_append_param_list(ctx, &cap->patterns, value);
         } else {
             ACVP_LOG_ERR("Invalid pattern type specified when setting param for KDA twostep.");
             return ACVP_INVALID_ARG;
@@ -8644,7 +9485,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
         break;
     case ACVP_KDA_ENCODING_TYPE:
         if (value > ACVP_KDA_ENCODING_NONE && value < ACVP_KDA_ENCODING_MAX) {
-            result = acvp_append_param_list(&cap->encodings, value);
+            result = acvp_append_param_list(ctx, &cap->encodings, value);
         } else {
             ACVP_LOG_ERR("Invalid encoding type specified when setting param for KDA twostep.");
             return ACVP_INVALID_ARG;
@@ -8663,10 +9504,10 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
         break;
     case ACVP_KDA_MAC_SALT:
         if (value == ACVP_KDA_MAC_SALT_METHOD_DEFAULT) {
-            result = acvp_append_name_list(&cap->mac_salt_methods,
+            result = acvp_append_name_list(ctx, &cap->mac_salt_methods,
                                             ACVP_KDA_MAC_SALT_METHOD_DEFAULT_STR);
         } else if (value == ACVP_KDA_MAC_SALT_METHOD_RANDOM) {
-            result = acvp_append_name_list(&cap->mac_salt_methods,
+            result = acvp_append_name_list(ctx, &cap->mac_salt_methods,
                                             ACVP_KDA_MAC_SALT_METHOD_RANDOM_STR);
         } else {
             ACVP_LOG_ERR("Invalid value for ACVK_KDA_MAC_SALT");
@@ -8676,46 +9517,46 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
     case ACVP_KDA_MAC_ALG:
         switch (value) {
             case ACVP_KDF108_MAC_MODE_CMAC_AES128:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_AES_128);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_AES_128);
                 break;
             case ACVP_KDF108_MAC_MODE_CMAC_AES192:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_AES_192);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_AES_192);
                 break;
             case ACVP_KDF108_MAC_MODE_CMAC_AES256:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_CMAC_AES_256);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_CMAC_AES_256);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA1:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA1);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA1);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA224:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_224);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_224);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA256:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_256);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_256);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA384:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_384);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_384);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA512:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA512_224:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_224);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_224);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA512_256:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_256);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA2_512_256);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA3_224:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_224);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_224);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA3_256:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_256);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_256);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA3_384:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_384);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_384);
                 break;
             case ACVP_KDF108_MAC_MODE_HMAC_SHA3_512:
-                result = acvp_append_name_list(&mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_512);
+                result = acvp_append_name_list(ctx, &mode_obj->mac_mode, ACVP_ALG_HMAC_SHA3_512);
                 break;
             case ACVP_KDF108_MAC_MODE_CMAC_TDES:
             default:
@@ -8728,7 +9569,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
             ACVP_LOG_ERR("Hybrid secrets for twostep can only be set for revision SP800-56Cr2");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_sl_list(&cap_list->cap.kda_twostep_cap->aux_secret_len.values, value);
+        acvp_append_sl_list(ctx, &cap_list->cap.kda_twostep_cap->aux_secret_len.values, value);
         cap_list->cap.kda_twostep_cap->use_hybrid_shared_secret = 1;
         break;
     case ACVP_KDA_PERFORM_MULTIEXPANSION_TESTS:
@@ -8742,19 +9583,19 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
     case ACVP_KDA_TWOSTEP_FIXED_DATA_ORDER:
         switch (value) {
         case ACVP_KDF108_FIXED_DATA_ORDER_AFTER:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_AFTER_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_AFTER_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_BEFORE:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_MIDDLE:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_MIDDLE_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_MIDDLE_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_NONE:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_NONE_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_NONE_STR);
             break;
         case ACVP_KDF108_FIXED_DATA_ORDER_BEFORE_ITERATOR:
-            result = acvp_append_name_list(&mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_ITERATOR_STR);
+            result = acvp_append_name_list(ctx, &mode_obj->data_order, ACVP_FIXED_DATA_ORDER_BEFORE_ITERATOR_STR);
             break;
         default:
             ACVP_LOG_ERR("Invalid fixed data order provided for KDA Twostep");
@@ -8766,7 +9607,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
             ACVP_LOG_ERR("Invalid value provided for KDA twostep supported length");
             return ACVP_INVALID_ARG;
         }
-        acvp_append_sl_list(&mode_obj->counter_lens, value);
+        acvp_append_sl_list(ctx, &mode_obj->counter_lens, value);
         break;
     case ACVP_KDA_TWOSTEP_SUPPORTS_EMPTY_IV:
         mode_obj->empty_iv_support = value;
@@ -8780,7 +9621,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_parm(ACVP_CTX *ctx, ACVP_KDA_PARM param,
         }
         break;
     case ACVP_KDA_TWOSTEP_SUPPORTED_LEN:
-        result = acvp_append_sl_list(&mode_obj->supported_lens.values, value);
+        result = acvp_append_sl_list(ctx, &mode_obj->supported_lens.values, value);
         break;
     case ACVP_KDA_Z:
     case ACVP_KDA_ONESTEP_AUX_FUNCTION:
@@ -8804,7 +9645,7 @@ ACVP_RESULT acvp_cap_kda_twostep_set_domain(ACVP_CTX *ctx, ACVP_KDA_PARM param,
         return ACVP_NO_CTX;
     }
 
-    cap_list = acvp_locate_cap_entry(ctx, ACVP_KDA_TWOSTEP);
+    cap_list = acvp_cap_entry_update(ctx, ACVP_KDA_TWOSTEP);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found. You must enable algorithm before setting parameters.");
         return ACVP_NO_CAP;
@@ -8906,7 +9747,7 @@ ACVP_RESULT acvp_cap_kda_set_domain(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_KDA_
     /*
      * Locate this cipher in the caps array
      */
-    cap_list = acvp_locate_cap_entry(ctx, cipher);
+    cap_list = acvp_cap_entry_update(ctx, cipher);
     if (!cap_list) {
         ACVP_LOG_ERR("Cap entry not found.");
         return ACVP_NO_CAP;
@@ -9067,7 +9908,7 @@ ACVP_RESULT acvp_cap_kts_ifc_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-      cap = acvp_locate_cap_entry(ctx, cipher);
+      cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9080,13 +9921,13 @@ ACVP_RESULT acvp_cap_kts_ifc_set_parm(ACVP_CTX *ctx,
     switch (param)
     {
     case ACVP_KTS_IFC_KEYGEN_METHOD:
-        result = acvp_append_param_list(&kts_ifc_cap->keygen_method, value);
+        result = acvp_append_param_list(ctx, &kts_ifc_cap->keygen_method, value);
         break;
     case ACVP_KTS_IFC_FUNCTION:
-        result = acvp_append_param_list(&kts_ifc_cap->functions, value);
+        result = acvp_append_param_list(ctx, &kts_ifc_cap->functions, value);
         break;
     case ACVP_KTS_IFC_MODULO:
-        acvp_append_sl_list(&kts_ifc_cap->modulo, value);
+        acvp_append_sl_list(ctx, &kts_ifc_cap->modulo, value);
         break;
     case ACVP_KTS_IFC_SCHEME:
         current_scheme = kts_ifc_cap->schemes;
@@ -9094,10 +9935,10 @@ ACVP_RESULT acvp_cap_kts_ifc_set_parm(ACVP_CTX *ctx,
             while (current_scheme->next) {
                 current_scheme = current_scheme->next;
             }
-            current_scheme->next = calloc(1, sizeof(ACVP_KTS_IFC_SCHEMES));
+            current_scheme->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KTS_IFC_SCHEMES));
             current_scheme->next->scheme = value;
         } else {
-            kts_ifc_cap->schemes = calloc(1, sizeof(ACVP_KTS_IFC_SCHEMES));
+            kts_ifc_cap->schemes = acvp_cap_calloc(ctx, 1, sizeof(ACVP_KTS_IFC_SCHEMES));
             kts_ifc_cap->schemes->scheme = value;
         }
         break;
@@ -9127,7 +9968,7 @@ ACVP_RESULT acvp_cap_kts_ifc_set_scheme_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9161,10 +10002,10 @@ ACVP_RESULT acvp_cap_kts_ifc_set_scheme_parm(ACVP_CTX *ctx,
         current_scheme->l = value;
         break;
     case ACVP_KTS_IFC_ROLE:
-        result = acvp_append_param_list(&current_scheme->roles, value);
+        result = acvp_append_param_list(ctx, &current_scheme->roles, value);
         break;
     case ACVP_KTS_IFC_HASH:
-        result = acvp_append_param_list(&current_scheme->hash, value);
+        result = acvp_append_param_list(ctx, &current_scheme->hash, value);
         break;
     case ACVP_KTS_IFC_AD_PATTERN:
     case ACVP_KTS_IFC_ENCODING:
@@ -9189,7 +10030,7 @@ ACVP_RESULT acvp_cap_kts_ifc_set_param_string(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9208,11 +10049,11 @@ ACVP_RESULT acvp_cap_kts_ifc_set_param_string(ACVP_CTX *ctx,
     switch (param)
     {
     case ACVP_KTS_IFC_FIXEDPUBEXP:
-        kts_ifc_cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+        kts_ifc_cap->fixed_pub_exp = acvp_cap_calloc(ctx, len + 1, sizeof(char));
         strcpy_s(kts_ifc_cap->fixed_pub_exp, len + 1, value);
         break;
     case ACVP_KTS_IFC_IUT_ID:
-        kts_ifc_cap->iut_id = calloc(len + 1, sizeof(char));
+        kts_ifc_cap->iut_id = acvp_cap_calloc(ctx, len + 1, sizeof(char));
         strcpy_s(kts_ifc_cap->iut_id, len + 1, value);
         break;
     case ACVP_KTS_IFC_KEYGEN_METHOD:
@@ -9244,7 +10085,7 @@ ACVP_RESULT acvp_cap_kts_ifc_set_scheme_string(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9280,11 +10121,11 @@ ACVP_RESULT acvp_cap_kts_ifc_set_scheme_string(ACVP_CTX *ctx,
     switch (param)
     {
     case ACVP_KTS_IFC_AD_PATTERN:
-        current_scheme->assoc_data_pattern = calloc(len + 1, sizeof(char));
+        current_scheme->assoc_data_pattern = acvp_cap_calloc(ctx, len + 1, sizeof(char));
         strcpy_s(current_scheme->assoc_data_pattern, len + 1, value);
         break;
     case ACVP_KTS_IFC_ENCODING:
-        current_scheme->encodings = calloc(len + 1, sizeof(char));
+        current_scheme->encodings = acvp_cap_calloc(ctx, len + 1, sizeof(char));
         strcpy_s(current_scheme->encodings, len + 1, value);
         break;
     case ACVP_KTS_IFC_NULL_ASSOC_DATA:
@@ -9345,7 +10186,7 @@ ACVP_RESULT acvp_cap_safe_primes_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9363,7 +10204,7 @@ ACVP_RESULT acvp_cap_safe_primes_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CAP;
     }
     if (!safe_primes_cap->mode) {
-        safe_primes_cap->mode = calloc(1, sizeof(ACVP_SAFE_PRIMES_CAP_MODE));
+        safe_primes_cap->mode = acvp_cap_calloc(ctx, 1, sizeof(ACVP_SAFE_PRIMES_CAP_MODE));
     }
 
     safe_primes_cap_mode = safe_primes_cap->mode;
@@ -9380,7 +10221,7 @@ ACVP_RESULT acvp_cap_safe_primes_set_parm(ACVP_CTX *ctx,
     case ACVP_SUB_SAFE_PRIMES_KEYVER:
         switch (param) {
         case ACVP_SAFE_PRIMES_GENMETH:
-            result = acvp_append_param_list(&safe_primes_cap_mode->genmeth, mode);
+            result = acvp_append_param_list(ctx, &safe_primes_cap_mode->genmeth, mode);
             break;
         default:
             break;
@@ -9389,7 +10230,7 @@ ACVP_RESULT acvp_cap_safe_primes_set_parm(ACVP_CTX *ctx,
     case ACVP_SUB_SAFE_PRIMES_KEYGEN:
         switch (param) {
         case ACVP_SAFE_PRIMES_GENMETH:
-            result = acvp_append_param_list(&safe_primes_cap_mode->genmeth, mode);
+            result = acvp_append_param_list(ctx, &safe_primes_cap_mode->genmeth, mode);
             break;
         default:
             break;
@@ -9464,7 +10305,7 @@ ACVP_RESULT acvp_cap_lms_set_parm(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9490,14 +10331,14 @@ ACVP_RESULT acvp_cap_lms_set_parm(ACVP_CTX *ctx,
             ACVP_LOG_ERR("Invalid LMS mode provided");
             return ACVP_INVALID_ARG;
         }
-        return acvp_append_param_list(&lms_cap->lms_modes, value);
+        return acvp_append_param_list(ctx, &lms_cap->lms_modes, value);
         break;
     case ACVP_LMS_PARAM_LMOTS_MODE:
         if (value <= ACVP_LMOTS_MODE_NONE || value >= ACVP_LMOTS_MODE_MAX) {
             ACVP_LOG_ERR("Invalid LMOTS mode provided");
             return ACVP_INVALID_ARG;
         }
-        return acvp_append_param_list(&lms_cap->lmots_modes, value);
+        return acvp_append_param_list(ctx, &lms_cap->lmots_modes, value);
         break;
     default:
         break;
@@ -9519,7 +10360,7 @@ ACVP_RESULT acvp_cap_lms_set_mode_compatability_pair(ACVP_CTX *ctx,
         return ACVP_NO_CTX;
     }
 
-    cap = acvp_locate_cap_entry(ctx, cipher);
+    cap = acvp_cap_entry_update(ctx, cipher);
     if (!cap) {
         return ACVP_NO_CAP;
     }
@@ -9551,7 +10392,7 @@ ACVP_RESULT acvp_cap_lms_set_mode_compatability_pair(ACVP_CTX *ctx,
 
     list = lms_cap->specific_list;
     if (!list) {
-        lms_cap->specific_list = calloc(1, sizeof(ACVP_LMS_SPECIFIC_LIST));
+        lms_cap->specific_list = acvp_cap_calloc(ctx, 1, sizeof(ACVP_LMS_SPECIFIC_LIST));
         if (!lms_cap->specific_list) {
             return ACVP_MALLOC_FAIL;
         }
@@ -9561,7 +10402,7 @@ ACVP_RESULT acvp_cap_lms_set_mode_compatability_pair(ACVP_CTX *ctx,
         while (list->next) {
             list = list->next;
         }
-        list->next = calloc(1, sizeof(ACVP_LMS_SPECIFIC_LIST));
+        list->next = acvp_cap_calloc(ctx, 1, sizeof(ACVP_LMS_SPECIFIC_LIST));
         if (!list->next) {
             return ACVP_MALLOC_FAIL;
         }
@@ -31,6 +31,7 @@ static ACVP_RESULT acvp_cmac_init_tc(ACVP_CTX *ctx,
                                      unsigned int mac_len,
                                      ACVP_CIPHER alg_id) {
     ACVP_RESULT rv;
+    unsigned int msg_max = 0;
 
     if (!ctx) {
         return ACVP_NO_CTX;
@@ -53,12 +54,15 @@ static ACVP_RESULT acvp_cmac_init_tc(ACVP_CTX *ctx,
     memzero_s(stc, sizeof(ACVP_CMAC_TC));
 
     stc->test_type = testtype;
-    stc->msg = calloc(ACVP_CMAC_MSGLEN_MAX_STR, sizeof(unsigned char));
+    /* Sized for this test case, from the test case arena */
+    msg_max = (strnlen_s(msg, ACVP_CMAC_MSGLEN_MAX_STR + 1) + 1) / 2;
+    if (!msg_max) msg_max = 1;
+    stc->msg = acvp_arena_calloc(&ctx->exec.tc_arena, msg_max);
     if (!stc->msg) { return ACVP_MALLOC_FAIL; }
 
-    stc->mac = calloc(ACVP_CMAC_MACLEN_MAX, sizeof(unsigned char));
+    stc->mac = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_CMAC_MACLEN_MAX);
     if (!stc->mac) { return ACVP_MALLOC_FAIL; }
-    stc->key = calloc(1, ACVP_CMAC_KEY_MAX);
+    stc->key = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_CMAC_KEY_MAX);
     if (!stc->key) { return ACVP_MALLOC_FAIL; }
     stc->mac_len = mac_len;
 
@@ -70,12 +74,12 @@ static ACVP_RESULT acvp_cmac_init_tc(ACVP_CTX *ctx,
         }
     }
 
-    stc->key2 = calloc(1, ACVP_CMAC_KEY_MAX);
+    stc->key2 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_CMAC_KEY_MAX);
     if (!stc->key2) { return ACVP_MALLOC_FAIL; }
-    stc->key3 = calloc(1, ACVP_CMAC_KEY_MAX);
+    stc->key3 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_CMAC_KEY_MAX);
     if (!stc->key3) { return ACVP_MALLOC_FAIL; }
 
-    rv = acvp_hexstr_to_bin(msg, stc->msg, ACVP_CMAC_MSGLEN_MAX_STR, NULL);
+    rv = acvp_hexstr_to_bin(msg, stc->msg, msg_max, NULL);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex converstion failure (msg)");
         return rv;
@@ -124,28 +128,18 @@ static ACVP_RESULT acvp_cmac_init_tc(ACVP_CTX *ctx,
  */
 static ACVP_RESULT acvp_cmac_output_tc(ACVP_CTX *ctx, ACVP_CMAC_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_CMAC_MACLEN_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_cmac_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->verify) {
         json_object_set_boolean(tc_rsp, "testPassed", stc->ver_disposition);
     } else {
-        rv = acvp_bin_to_hexstr(stc->mac, stc->mac_len, tmp, ACVP_CMAC_MACLEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "mac", stc->mac, stc->mac_len, ACVP_CMAC_MACLEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (mac)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "mac", tmp);
     }
 
 end:
-    if (tmp) free(tmp);
-
     return rv;
 }
 
@@ -153,12 +147,8 @@ end:
  * This function simply releases the data associated with
  * a test case.
  */
-static ACVP_RESULT acvp_cmac_release_tc(ACVP_CMAC_TC *stc) {
-    if (stc->msg) free(stc->msg);
-    if (stc->mac) free(stc->mac);
-    if (stc->key) free(stc->key);
-    if (stc->key2) free(stc->key2);
-    if (stc->key3) free(stc->key3);
+static ACVP_RESULT acvp_cmac_release_tc(ACVP_CTX *ctx, ACVP_CMAC_TC *stc) {
+    acvp_arena_reset(&ctx->exec.tc_arena);
     memzero_s(stc, sizeof(ACVP_CMAC_TC));
 
     return ACVP_SUCCESS;
@@ -187,13 +177,16 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_CMAC_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_CMAC_TC stc, group_stc;
+    ACVP_TEST_CASE tc, group_tc;
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
     ACVP_CMAC_TESTTYPE testtype;
+    ACVP_TG_KEYS keys;
+    const char *key_parts[3];
+    unsigned int key_id = 0;
+    int group_open = 0;
     const char *direction = NULL, *test_type_str = NULL;
     int key1_len, key2_len, key3_len, json_msglen;
 
@@ -216,6 +209,9 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.cmac = &stc;
+    group_tc.tc.cmac = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_CMAC_TC));
+    memzero_s(&keys, sizeof(ACVP_TG_KEYS));
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -243,7 +239,7 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -264,15 +260,15 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON group obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         if (alg_id == ACVP_CMAC_AES) {
             keyLen = json_object_get_number(groupobj, "keyLen");
@@ -344,6 +340,25 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             ACVP_LOG_VERBOSE("        maclen: %d", maclen);
         }
 
+        /*
+         * Let the crypto module set up the MAC of the group once; each
+         * test case then only brings its key and message
+         */
+        if (cap->group_handler) {
+            memzero_s(&group_stc, sizeof(ACVP_CMAC_TC));
+            group_stc.cipher = alg_id;
+            group_stc.test_type = testtype;
+            group_stc.verify = verify;
+            group_stc.msg_len = msglen;
+            group_stc.mac_len = maclen;
+            group_stc.key_len = keyLen / 8;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
 
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
@@ -353,7 +368,7 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             msg = json_object_get_string(testobj, "message");
 
             /* msg can be null if msglen is 0 */
@@ -433,6 +448,11 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             if (verify) {
                 ACVP_LOG_VERBOSE("              mac: %s", mac);
             }
+            key_parts[0] = key1;
+            key_parts[1] = key2;
+            key_parts[2] = key3;
+            key_id = acvp_tg_key_id_parts(&keys, key_parts, alg_id == ACVP_CMAC_TDES ? 3 : 1,
+                                          ACVP_CMAC_KEY_MAX + 1);
 
             /*
              * Create a new test case in the response
@@ -449,15 +469,17 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             rv = acvp_cmac_init_tc(ctx, &stc, tc_id, testtype, msg, msglen, key1, key2, key3,
                                    verify, mac, maclen, alg_id);
             if (rv != ACVP_SUCCESS) {
-                acvp_cmac_release_tc(&stc);
+                acvp_cmac_release_tc(ctx, &stc);
                 json_value_free(r_tval);
                 goto err;
             }
+            stc.key_id = key_id;
+            stc.tg_ctx = group_stc.tg_ctx;
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("ERROR: crypto module failed the operation");
-                acvp_cmac_release_tc(&stc);
+                acvp_cmac_release_tc(ctx, &stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
                 json_value_free(r_tval);
                 goto err;
@@ -469,7 +491,7 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             rv = acvp_cmac_output_tc(ctx, &stc, r_tobj);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("ERROR: JSON output failure in hash module");
-                acvp_cmac_release_tc(&stc);
+                acvp_cmac_release_tc(ctx, &stc);
                 json_value_free(r_tval);
                 goto err;
             }
@@ -477,22 +499,33 @@ ACVP_RESULT acvp_cmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /*
              * Release all the memory associated with the test case
              */
-            acvp_cmac_release_tc(&stc);
+            acvp_cmac_release_tc(ctx, &stc);
 
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        acvp_tg_keys_clear(&keys);
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-     ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_tg_keys_clear(&keys);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
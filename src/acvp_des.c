@@ -43,14 +43,27 @@ static ACVP_RESULT acvp_des_init_tc(ACVP_CTX *ctx,
                                     unsigned int ovrflw_ctr,
                                     unsigned int keyingOption);
 
-static ACVP_RESULT acvp_des_release_tc(ACVP_SYM_CIPHER_TC *stc);
+static ACVP_RESULT acvp_des_release_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc);
 
 #define OLD_IV_LEN 8
-#define TEXT_COL_LEN 10001
 #define TEXT_ROW_LEN 8
-static unsigned char old_iv[OLD_IV_LEN];
-static unsigned char ptext[TEXT_COL_LEN][TEXT_ROW_LEN];
-static unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
+
+/* Bytes of pt/ct beyond the payload that modules and MCT may write */
+#define ACVP_DES_TC_HEADROOM 16
+
+/*
+ * Monte Carlo history for one test case. The iteration never looks further
+ * back than the previous inner iteration, apart from the values of the first
+ * one, so only those rows are kept. It lives on the stack of acvp_des_mct_run()
+ * so that MCT groups may be run concurrently.
+ */
+typedef struct acvp_des_mct_state_t {
+    unsigned char old_iv[OLD_IV_LEN];
+    unsigned char first_ptext[TEXT_ROW_LEN];    /* pt/ct of inner iteration 0 */
+    unsigned char first_ctext[TEXT_ROW_LEN];
+    unsigned char ptext[2][TEXT_ROW_LEN];       /* pt/ct of inner iteration j is at j & 1 */
+    unsigned char ctext[2][TEXT_ROW_LEN];
+} ACVP_DES_MCT_STATE;
 
 static void shiftin(unsigned char *dst, int dst_max, unsigned char *src, int nbits) {
     int n = 0, move_bytes = 0, copy_bytes = 0;
@@ -82,13 +95,18 @@ static void shiftin(unsigned char *dst, int dst_max, unsigned char *src, int nbi
  * performs the iteration depdedent upon the cipher type and direction.
  */
 static ACVP_RESULT acvp_des_mct_iterate_tc(ACVP_CTX *ctx,
-                                           ACVP_SYM_CIPHER_TC *stc) {
+                                           ACVP_SYM_CIPHER_TC *stc,
+                                           ACVP_DES_MCT_STATE *st) {
     int j = stc->mct_index;
     int n;
     ACVP_SUB_TDES alg;
 
-    memcpy_s(ctext[j], TEXT_ROW_LEN,  stc->ct, stc->ct_len);
-    memcpy_s(ptext[j], TEXT_ROW_LEN, stc->pt, stc->pt_len);
+    memcpy_s(st->ctext[j & 1], TEXT_ROW_LEN,  stc->ct, stc->ct_len);
+    memcpy_s(st->ptext[j & 1], TEXT_ROW_LEN, stc->pt, stc->pt_len);
+    if (j == 0) {
+        memcpy_s(st->first_ctext, TEXT_ROW_LEN, stc->ct, stc->ct_len);
+        memcpy_s(st->first_ptext, TEXT_ROW_LEN, stc->pt, stc->pt_len);
+    }
 
     alg = acvp_get_tdes_alg(stc->cipher);
     if (alg == 0) {
@@ -100,22 +118,22 @@ static ACVP_RESULT acvp_des_mct_iterate_tc(ACVP_CTX *ctx,
     case ACVP_SUB_TDES_CBC:
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             if (j == 0) {
-                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, old_iv, 8);
+                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->old_iv, 8);
             } else {
                 for (n = 0; n < 8; ++n) {
-                    stc->pt[n] = ctext[j - 1][n];
+                    stc->pt[n] = st->ctext[(j - 1) & 1][n];
                 }
             }
             for (n = 0; n < 8; ++n) {
-                stc->iv[n] = ctext[j][n];
+                stc->iv[n] = st->ctext[j & 1][n];
             }
         } else {
             for (n = 0; n < 8; ++n) {
-                stc->ct[n] = ptext[j][n];
+                stc->ct[n] = st->ptext[j & 1][n];
             }
             if (j != 0) {
                 for (n = 0; n < 8; ++n) {
-                    stc->iv[n] = ptext[j - 1][n];
+                    stc->iv[n] = st->ptext[(j - 1) & 1][n];
                 }
             }
         }
@@ -123,14 +141,14 @@ static ACVP_RESULT acvp_des_mct_iterate_tc(ACVP_CTX *ctx,
     case ACVP_SUB_TDES_CFB64:
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             if (j == 0) {
-                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, old_iv, 8);
+                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->old_iv, 8);
             } else {
                 for (n = 0; n < 8; ++n) {
-                    stc->pt[n] = ctext[j - 1][n];
+                    stc->pt[n] = st->ctext[(j - 1) & 1][n];
                 }
             }
             for (n = 0; n < 8; ++n) {
-                stc->iv[n] = ctext[j][n];
+                stc->iv[n] = st->ctext[j & 1][n];
             }
         } else {
             for (n = 0; n < 8; ++n) {
@@ -145,7 +163,7 @@ static ACVP_RESULT acvp_des_mct_iterate_tc(ACVP_CTX *ctx,
     case ACVP_SUB_TDES_OFB:
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             if (j == 0) {
-                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, old_iv, 8);
+                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->old_iv, 8);
             } else {
                 for (n = 0; n < 8; ++n) {
                     stc->pt[n] = stc->iv_ret[n];
@@ -153,7 +171,7 @@ static ACVP_RESULT acvp_des_mct_iterate_tc(ACVP_CTX *ctx,
             }
         } else {
             if (j == 0) {
-                memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, old_iv, 8);
+                memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX, st->old_iv, 8);
             } else {
                 for (n = 0; n < 8; ++n) {
                     stc->ct[n] = stc->iv_ret[n];
@@ -165,7 +183,7 @@ static ACVP_RESULT acvp_des_mct_iterate_tc(ACVP_CTX *ctx,
     case ACVP_SUB_TDES_CFB8:
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
             if (j == 0) {
-                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, old_iv, 8);
+                memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX, st->old_iv, 8);
             } else {
                 for (n = 0; n < 8; ++n) {
                     stc->pt[n] = stc->iv_ret[n];
@@ -214,139 +232,65 @@ static ACVP_RESULT acvp_des_output_mct_tc(ACVP_CTX *ctx,
     ACVP_RESULT rv = ACVP_SUCCESS;
     int single_key_str_len = 0;
     int single_key_byte_len = 0;
-    char *tmp_k1 = NULL;
-    char *tmp_k2 = NULL;
-    char *tmp_k3 = NULL;
-    char *tmp_pt = NULL;
-    char *tmp_ct = NULL;
-    char *tmp_iv = NULL;
 
     single_key_str_len = (ACVP_TDES_KEY_STR_LEN / 3);
     single_key_byte_len = (ACVP_TDES_KEY_BYTE_LEN / 3);
 
-    tmp_k1 = calloc(single_key_str_len + 1, sizeof(char));
-    if (!tmp_k1) {
-        ACVP_LOG_ERR("Unable to malloc");
-        rv = ACVP_MALLOC_FAIL;
-        goto err;
-    }
-    tmp_k2 = calloc(single_key_str_len + 1, sizeof(char));
-    if (!tmp_k2) {
-        ACVP_LOG_ERR("Unable to malloc");
-        rv = ACVP_MALLOC_FAIL;
-        goto err;
-    }
-    tmp_k3 = calloc(single_key_str_len + 1, sizeof(char));
-    if (!tmp_k3) {
-        ACVP_LOG_ERR("Unable to malloc");
-        rv = ACVP_MALLOC_FAIL;
-        goto err;
-    }
-
     /*
      * Split the 48 byte key into 3 parts, and convert to hex.
      */
-    rv = acvp_bin_to_hexstr(stc->key, single_key_byte_len,
-                            tmp_k1, single_key_str_len);
+    rv = acvp_json_set_hex(r_tobj, "key1", stc->key, single_key_byte_len, single_key_str_len);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (key)");
-        goto err;
+        return rv;
     }
 
-    rv = acvp_bin_to_hexstr(stc->key + 8, single_key_byte_len,
-                            tmp_k2, single_key_str_len);
+    rv = acvp_json_set_hex(r_tobj, "key2", stc->key + 8, single_key_byte_len, single_key_str_len);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (key)");
-        goto err;
+        return rv;
     }
 
-    rv = acvp_bin_to_hexstr(stc->key + 16, single_key_byte_len,
-                            tmp_k3, single_key_str_len);
+    rv = acvp_json_set_hex(r_tobj, "key3", stc->key + 16, single_key_byte_len, single_key_str_len);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (key)");
-        goto err;
+        return rv;
     }
 
-    json_object_set_string(r_tobj, "key1", tmp_k1);
-    json_object_set_string(r_tobj, "key2", tmp_k2);
-    json_object_set_string(r_tobj, "key3", tmp_k3);
-
     if (stc->cipher != ACVP_TDES_ECB) {
-        tmp_iv = calloc(ACVP_SYM_IV_MAX + 1, sizeof(char));
-        if (!tmp_iv) {
-            ACVP_LOG_ERR("Unable to malloc");
-            rv = ACVP_MALLOC_FAIL;
-            goto err;
-        }
-
-        rv = acvp_bin_to_hexstr(stc->iv, stc->iv_len, tmp_iv, ACVP_SYM_IV_MAX);
+        rv = acvp_json_set_hex(r_tobj, "iv", stc->iv, stc->iv_len, ACVP_SYM_IV_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (iv)");
-            goto err;
+            return rv;
         }
-        json_object_set_string(r_tobj, "iv", tmp_iv);
     }
 
     if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-        tmp_pt = calloc(ACVP_SYM_PT_MAX + 1, sizeof(char));
-        if (!tmp_pt) {
-            ACVP_LOG_ERR("Unable to malloc");
-            rv = ACVP_MALLOC_FAIL;
-            goto err;
-        }
-
         if (stc->cipher == ACVP_TDES_CFB1) {
             stc->pt[0] &= ACVP_CFB1_BIT_MASK;
-            rv = acvp_bin_to_hexstr(stc->pt, 1, tmp_pt, ACVP_SYM_PT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (pt)");
-                goto err;
-            }
-            json_object_set_string(r_tobj, "pt", tmp_pt);
+            rv = acvp_json_set_hex(r_tobj, "pt", stc->pt, 1, ACVP_SYM_PT_MAX);
         } else {
-            rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp_pt, ACVP_SYM_PT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (pt)");
-                goto err;
-            }
-            json_object_set_string(r_tobj, "pt", tmp_pt);
+            rv = acvp_json_set_hex(r_tobj, "pt", stc->pt, stc->pt_len, ACVP_SYM_PT_MAX);
+        }
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("hex conversion failure (pt)");
+            return rv;
         }
     } else {
         /*
          * Decrypt
          */
-        tmp_ct = calloc(ACVP_SYM_CT_MAX + 1, sizeof(char));
-        if (!tmp_ct) {
-            ACVP_LOG_ERR("Unable to malloc");
-            rv = ACVP_MALLOC_FAIL;
-            goto err;
-        }
-
         if (stc->cipher == ACVP_TDES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->ct, 1, tmp_ct, ACVP_SYM_CT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (ct)");
-                goto err;
-            }
-            json_object_set_string(r_tobj, "ct", tmp_ct);
+            rv = acvp_json_set_hex(r_tobj, "ct", stc->ct, 1, ACVP_SYM_CT_MAX);
         } else {
-            rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp_ct, ACVP_SYM_CT_MAX);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("hex conversion failure (ct)");
-                goto err;
-            }
-            json_object_set_string(r_tobj, "ct", tmp_ct);
+            rv = acvp_json_set_hex(r_tobj, "ct", stc->ct, stc->ct_len, ACVP_SYM_CT_MAX);
+        }
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("hex conversion failure (ct)");
+            return rv;
         }
     }
 
-err:
-    if (tmp_k1) free(tmp_k1);
-    if (tmp_k2) free(tmp_k2);
-    if (tmp_k3) free(tmp_k3);
-    if (tmp_pt) free(tmp_pt);
-    if (tmp_ct) free(tmp_ct);
-    if (tmp_iv) free(tmp_iv);
-
     return rv;
 }
 
@@ -378,38 +322,83 @@ static void acvp_des_set_odd_parity(unsigned char *key) {
 }
 
 /*
- * This is the handler for DES MCT values.  This will parse
- * a JSON encoded vector set for DES.  Each test case is
- * parsed, processed, and a response is generated to be sent
- * back to the ACV server by the transport layer.
+ * Hands a test case to a handler of the crypto module. There is no ctx to
+ * keep the metrics in when acvp_des_mct_loop() runs the MCT on behalf of an
+ * MCT loop handler.
  */
-static ACVP_RESULT acvp_des_mct_tc(ACVP_CTX *ctx,
-                                   ACVP_CAPS_LIST *cap,
-                                   ACVP_TEST_CASE *tc,
-                                   ACVP_SYM_CIPHER_TC *stc,
-                                   JSON_Array *res_array) {
+static int acvp_des_mct_call(ACVP_CTX *ctx, int (*handler)(ACVP_TEST_CASE *test_case), ACVP_TEST_CASE *tc) {
+    return ctx ? acvp_crypto_call(ctx, handler, tc) : handler(tc);
+}
+
+/*
+ * Runs one inner loop of an MCT through an MCT handler. The tail of the
+ * output stream the crypto module hands back is what the key of the next
+ * outer iteration is made from, and the block before the last is what the
+ * last inner iteration is adjusted with, so the rest of the outer iteration
+ * goes on as if every block had gone through the crypto_handler.
+ */
+static ACVP_RESULT acvp_des_mct_inner_offload(ACVP_CTX *ctx,
+                                              int (*mct_handler)(ACVP_TEST_CASE *test_case),
+                                              ACVP_TEST_CASE *tc,
+                                              ACVP_SYM_CIPHER_TC *stc,
+                                              ACVP_DES_MCT_STATE *st,
+                                              unsigned char *nk) {
+    unsigned char tail[ACVP_SYM_MCT_TAIL_LEN] = { 0 };
+    int j = ACVP_DES_MCT_INNER - 1, rc = 0;
+
+    memcpy_s(st->old_iv, OLD_IV_LEN, stc->iv, stc->iv_len);
+    memcpy_s(st->first_ptext, TEXT_ROW_LEN, stc->pt, stc->pt_len);
+    memcpy_s(st->first_ctext, TEXT_ROW_LEN, stc->ct, stc->ct_len);
+
+    stc->mct_index = 0;
+    stc->mct_tail = tail;
+    rc = acvp_des_mct_call(ctx, mct_handler, tc);
+    stc->mct_tail = NULL;
+    if (rc) {
+        ACVP_LOG_ERR("crypto module failed the MCT operation");
+        return ACVP_CRYPTO_MODULE_FAIL;
+    }
+
+    /* The key is made from the last 192 bits of output */
+    memcpy_s(nk, 3 * 8, tail + ACVP_SYM_MCT_TAIL_LEN - 3 * 8, 3 * 8);
+    if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+        memcpy_s(st->ctext[(j - 1) & 1], TEXT_ROW_LEN,
+                 tail + ACVP_SYM_MCT_TAIL_LEN - 2 * TEXT_ROW_LEN, TEXT_ROW_LEN);
+    } else {
+        memcpy_s(st->ptext[(j - 1) & 1], TEXT_ROW_LEN,
+                 tail + ACVP_SYM_MCT_TAIL_LEN - 2 * TEXT_ROW_LEN, TEXT_ROW_LEN);
+    }
+
+    stc->mct_index = j;
+    return acvp_des_mct_iterate_tc(ctx, stc, st);
+}
+
+/*
+ * Runs the outer loop of an MCT, the inner loops going to mct_handler if it
+ * is set and a block at a time to crypto_handler otherwise, and records
+ * each checkpoint in the mct_key, mct_iv, mct_pt and mct_ct arrays of stc.
+ * ctx is NULL when run by acvp_des_mct_loop().
+ */
+static ACVP_RESULT acvp_des_mct_run(ACVP_CTX *ctx,
+                                    int (*crypto_handler)(ACVP_TEST_CASE *test_case),
+                                    int (*mct_handler)(ACVP_TEST_CASE *test_case),
+                                    ACVP_TEST_CASE *tc,
+                                    ACVP_SYM_CIPHER_TC *stc) {
     int i, j, n, bit_len;
     ACVP_RESULT rv;
-    JSON_Value *r_tval = NULL;  /* Response testval */
-    JSON_Object *r_tobj = NULL; /* Response testobj */
-    char *tmp = NULL;
 #define NK_LEN 32 /* Longest key + 8 */
     unsigned char nk[NK_LEN];
     ACVP_SUB_TDES alg;
+    ACVP_DES_MCT_STATE st;
 
-    tmp = calloc(1, ACVP_SYM_CT_MAX + 1);
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_des_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
+    memzero_s(&st, sizeof(ACVP_DES_MCT_STATE));
 
     alg = acvp_get_tdes_alg(stc->cipher);
     if (alg == 0) {
         ACVP_LOG_ERR("Invalid cipher value");
-        free(tmp);
         return ACVP_INVALID_ARG;
     }
-    
+
     switch (alg) {
     case ACVP_SUB_TDES_CBC:
     case ACVP_SUB_TDES_OFB:
@@ -432,39 +421,42 @@ static ACVP_RESULT acvp_des_mct_tc(ACVP_CTX *ctx,
     case ACVP_SUB_TDES_KW:
     default:
         ACVP_LOG_ERR("unsupported algorithm (%d)", stc->cipher);
-        free(tmp);
         return ACVP_UNSUPPORTED_OP;
     }
 
-
     for (i = 0; i < ACVP_DES_MCT_OUTER; ++i) {
         /*
-         * Create a new test case in the response
-         */
-        r_tval = json_value_init_object();
-        r_tobj = json_value_get_object(r_tval);
-
-        /*
-         * Output the test case request values using JSON
+         * Record what the checkpoint starts from
          */
-        rv = acvp_des_output_mct_tc(ctx, stc, r_tobj);
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("JSON output failure in DES module");
-            free(tmp);
-            json_value_free(r_tval);
-            return rv;
+        if (stc->cipher == ACVP_TDES_CFB1 && stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+            stc->pt[0] &= ACVP_CFB1_BIT_MASK;
+        }
+        memcpy_s(stc->mct_key + i * ACVP_TDES_MCT_KEY_LEN, ACVP_TDES_MCT_KEY_LEN,
+                 stc->key, ACVP_TDES_MCT_KEY_LEN);
+        memcpy_s(stc->mct_iv + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN,
+                 stc->iv, ACVP_TDES_MCT_BLOCK_LEN);
+        if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+            memcpy_s(stc->mct_pt + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN,
+                     stc->pt, ACVP_TDES_MCT_BLOCK_LEN);
+        } else {
+            memcpy_s(stc->mct_ct + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN,
+                     stc->ct, ACVP_TDES_MCT_BLOCK_LEN);
         }
 
-        for (j = 0; j < ACVP_DES_MCT_INNER; ++j) {
+        if (mct_handler) {
+            rv = acvp_des_mct_inner_offload(ctx, mct_handler, tc, stc, &st, nk);
+            if (rv != ACVP_SUCCESS) {
+                return rv;
+            }
+        }
+        for (j = 0; j < ACVP_DES_MCT_INNER && !mct_handler; ++j) {
             if (j == 0) {
-                memcpy_s(old_iv, OLD_IV_LEN, stc->iv, stc->iv_len);
+                memcpy_s(st.old_iv, OLD_IV_LEN, stc->iv, stc->iv_len);
             }
             stc->mct_index = j;    /* indicates init vs. update */
             /* Process the current DES encrypt test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_des_mct_call(ctx, crypto_handler, tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
-                free(tmp);
-                json_value_free(r_tval);
                 return ACVP_CRYPTO_MODULE_FAIL;
             }
             /*
@@ -475,11 +467,9 @@ static ACVP_RESULT acvp_des_mct_tc(ACVP_CTX *ctx,
             } else {
                 shiftin(nk, NK_LEN, stc->pt, bit_len);
             }
-            rv = acvp_des_mct_iterate_tc(ctx, stc);
+            rv = acvp_des_mct_iterate_tc(ctx, stc, &st);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Failed the MCT iteration changes");
-                free(tmp);
-                json_value_free(r_tval);
                 return rv;
             }
         }
@@ -506,65 +496,163 @@ static ACVP_RESULT acvp_des_mct_tc(ACVP_CTX *ctx,
         if (stc->cipher == ACVP_TDES_OFB) {
             if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
                 for (n = 0; n < 8; ++n) {
-                    stc->pt[n] = ptext[0][n] ^ stc->iv_ret[n];
+                    stc->pt[n] = st.first_ptext[n] ^ stc->iv_ret[n];
                 }
             } else {
                 for (n = 0; n < 8; ++n) {
-                    stc->ct[n] = ctext[0][n] ^ stc->iv_ret[n];
+                    stc->ct[n] = st.first_ctext[n] ^ stc->iv_ret[n];
                 }
             }
         }
 
+        /*
+         * Record the result of the checkpoint
+         */
         if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-            memzero_s(tmp, ACVP_SYM_CT_MAX);
             if (stc->cipher == ACVP_TDES_CFB1) {
                 stc->ct[0] &= ACVP_CFB1_BIT_MASK;
-                rv = acvp_bin_to_hexstr(stc->ct, 1, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (ct)");
-                    free(tmp);
-                    json_value_free(r_tval);
-                    return rv;
-                }
+            }
+            memcpy_s(stc->mct_ct + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN,
+                     stc->ct, ACVP_TDES_MCT_BLOCK_LEN);
+        } else {
+            memcpy_s(stc->mct_pt + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN,
+                     stc->pt, ACVP_TDES_MCT_BLOCK_LEN);
+        }
+    }
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Runs a whole MCT for an MCT loop handler from the inner loop of the
+ * crypto module, see acvp.h
+ */
+ACVP_RESULT acvp_des_mct_loop(ACVP_TEST_CASE *test_case, int (*mct_handler)(ACVP_TEST_CASE *test_case)) {
+    ACVP_SYM_CIPHER_TC *stc = NULL;
+
+    if (!test_case || !mct_handler) {
+        return ACVP_INVALID_ARG;
+    }
+    stc = test_case->tc.symmetric;
+    if (!stc || stc->test_type != ACVP_SYM_TEST_TYPE_MCT ||
+            !stc->mct_key || !stc->mct_iv || !stc->mct_pt || !stc->mct_ct) {
+        return ACVP_INVALID_ARG;
+    }
+    return acvp_des_mct_run(NULL, NULL, mct_handler, test_case, stc);
+}
+
+/*
+ * This is the handler for DES MCT values.  This will parse
+ * a JSON encoded vector set for DES.  Each test case is
+ * parsed, processed, and a response is generated to be sent
+ * back to the ACV server by the transport layer.
+ *
+ * The checkpoints are run first, by the MCT loop handler of the
+ * capability when it has one, and then output from the arrays they were
+ * recorded in.
+ */
+static ACVP_RESULT acvp_des_mct_tc(ACVP_CTX *ctx,
+                                   ACVP_CAPS_LIST *cap,
+                                   ACVP_TEST_CASE *tc,
+                                   ACVP_SYM_CIPHER_TC *stc,
+                                   JSON_Array *res_array) {
+    int i;
+    unsigned int len;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *r_tval = NULL;  /* Response testval */
+    JSON_Object *r_tobj = NULL; /* Response testobj */
+    unsigned char *checkpoints = NULL;
+
+    checkpoints = calloc(ACVP_DES_MCT_OUTER, ACVP_TDES_MCT_KEY_LEN + 3 * ACVP_TDES_MCT_BLOCK_LEN);
+    if (!checkpoints) {
+        ACVP_LOG_ERR("Unable to malloc in acvp_des_mct_tc");
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+    stc->mct_key = checkpoints;
+    stc->mct_iv = stc->mct_key + ACVP_DES_MCT_OUTER * ACVP_TDES_MCT_KEY_LEN;
+    stc->mct_pt = stc->mct_iv + ACVP_DES_MCT_OUTER * ACVP_TDES_MCT_BLOCK_LEN;
+    stc->mct_ct = stc->mct_pt + ACVP_DES_MCT_OUTER * ACVP_TDES_MCT_BLOCK_LEN;
+
+    if (cap->mct_loop_handler) {
+        if (acvp_crypto_call(ctx, cap->mct_loop_handler, tc)) {
+            ACVP_LOG_ERR("crypto module failed the MCT operation");
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+    } else {
+        rv = acvp_des_mct_run(ctx, cap->crypto_handler, cap->mct_handler, tc, stc);
+        if (rv != ACVP_SUCCESS) {
+            goto end;
+        }
+    }
+
+    /* The lengths of the input hold for the output of every checkpoint */
+    len = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? stc->pt_len : stc->ct_len;
+    stc->pt_len = len;
+    stc->ct_len = len;
+
+    for (i = 0; i < ACVP_DES_MCT_OUTER; ++i) {
+        memcpy_s(stc->key, ACVP_SYM_KEY_MAX_BYTES,
+                 stc->mct_key + i * ACVP_TDES_MCT_KEY_LEN, ACVP_TDES_MCT_KEY_LEN);
+        memcpy_s(stc->iv, ACVP_SYM_IV_BYTE_MAX,
+                 stc->mct_iv + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN);
+        memcpy_s(stc->pt, ACVP_SYM_PT_BYTE_MAX,
+                 stc->mct_pt + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN);
+        memcpy_s(stc->ct, ACVP_SYM_CT_BYTE_MAX,
+                 stc->mct_ct + i * ACVP_TDES_MCT_BLOCK_LEN, ACVP_TDES_MCT_BLOCK_LEN);
+
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        r_tobj = json_value_get_object(r_tval);
+
+        /*
+         * Output the test case request values using JSON
+         */
+        rv = acvp_des_output_mct_tc(ctx, stc, r_tobj);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in DES module");
+            goto end;
+        }
+
+        if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+            if (stc->cipher == ACVP_TDES_CFB1) {
+                stc->ct[0] &= ACVP_CFB1_BIT_MASK;
+                rv = acvp_json_set_hex(r_tobj, "ct", stc->ct, 1, ACVP_SYM_CT_MAX);
             } else {
-                rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (ct)");
-                    free(tmp);
-                    json_value_free(r_tval);
-                    return rv;
-                }
+                rv = acvp_json_set_hex(r_tobj, "ct", stc->ct, stc->ct_len, ACVP_SYM_CT_MAX);
+            }
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("hex conversion failure (ct)");
+                goto end;
             }
-            json_object_set_string(r_tobj, "ct", tmp);
         } else {
-            memzero_s(tmp, ACVP_SYM_CT_MAX);
             if (stc->cipher == ACVP_TDES_CFB1) {
-                rv = acvp_bin_to_hexstr(stc->pt, 1, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (pt)");
-                    free(tmp);
-                    json_value_free(r_tval);
-                    return rv;
-                }
+                rv = acvp_json_set_hex(r_tobj, "pt", stc->pt, 1, ACVP_SYM_CT_MAX);
             } else {
-                rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_SYM_CT_MAX);
-                if (rv != ACVP_SUCCESS) {
-                    ACVP_LOG_ERR("hex conversion failure (pt)");
-                    free(tmp);
-                    json_value_free(r_tval);
-                    return rv;
-                }
+                rv = acvp_json_set_hex(r_tobj, "pt", stc->pt, stc->pt_len, ACVP_SYM_CT_MAX);
+            }
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("hex conversion failure (pt)");
+                goto end;
             }
-            json_object_set_string(r_tobj, "pt", tmp);
         }
         /* Append the test response value to array */
         json_array_append_value(res_array, r_tval);
+        r_tval = NULL;
     }
 
+end:
+    if (r_tval) json_value_free(r_tval);
+    if (checkpoints) free(checkpoints);
+    stc->mct_key = NULL;
+    stc->mct_iv = NULL;
+    stc->mct_pt = NULL;
+    stc->mct_ct = NULL;
 
-    free(tmp);
-
-    return ACVP_SUCCESS;
+    return rv;
 }
 
 /**
@@ -654,7 +742,6 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_SYM_CIPH_TESTTYPE test_type = 0;
     ACVP_SYM_CIPH_DIR dir = 0;
     ACVP_CIPHER alg_id = 0;
-    char *json_result = NULL;
     const char *test_type_str = NULL, *dir_str = NULL;
     unsigned int tc_id = 0, keylen = 0, keyingOption = 0;
     unsigned int ovrflw_ctr = 0, incr_ctr = 0;  /* assume false */
@@ -701,7 +788,7 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -720,15 +807,15 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         dir_str = json_object_get_string(groupobj, "direction");
         if (!dir_str) {
@@ -798,14 +885,14 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             const char *pt = NULL, *ct = NULL, *iv = NULL;
             const char *key1 = NULL, *key2 = NULL, *key3 = NULL;
             unsigned int ivlen = 0, ptlen = 0, ctlen = 0, tmp_key_len = 0;
-            char *key = NULL;
+            char key[ACVP_SYM_KEY_MAX_STR + 1];
 
             
             ACVP_LOG_VERBOSE("Found new 3DES test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             key1 = json_object_get_string(testobj, "key1");
             if (!key1) {
@@ -849,24 +936,14 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 goto err;
             }
 
-            if (key == NULL) {
-                key = calloc(ACVP_SYM_KEY_MAX_STR + 1, sizeof(char));
-                if (!key) {
-                    ACVP_LOG_ERR("Unable to malloc");
-                    rv = ACVP_MALLOC_FAIL;
-                    goto err;
-                }
-
-                strcpy_s(key, ACVP_SYM_KEY_MAX_STR + 1, key1);
-                strcpy_s(key + 16, ((ACVP_SYM_KEY_MAX_STR + 1) - 16), key2);
-                strcpy_s(key + 32, ((ACVP_SYM_KEY_MAX_STR + 1) - 32), key3);
-            }
+            strcpy_s(key, ACVP_SYM_KEY_MAX_STR + 1, key1);
+            strcpy_s(key + 16, ((ACVP_SYM_KEY_MAX_STR + 1) - 16), key2);
+            strcpy_s(key + 32, ((ACVP_SYM_KEY_MAX_STR + 1) - 32), key3);
 
             if (dir == ACVP_SYM_CIPH_DIR_ENCRYPT) {
                 pt = json_object_get_string(testobj, "pt");
                 if (!pt) {
                     ACVP_LOG_ERR("Server JSON missing 'pt'");
-                    free(key);
                     rv = ACVP_MISSING_ARG;
                     goto err;
                 }
@@ -875,7 +952,6 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 if (ptlen > ACVP_SYM_PT_MAX) {
                     ACVP_LOG_ERR("'pt' too long, max allowed=(%d)",
                                  ACVP_SYM_PT_MAX);
-                    free(key);
                     rv = ACVP_INVALID_ARG;
                     goto err;
                 }
@@ -894,7 +970,6 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 ct = json_object_get_string(testobj, "ct");
                 if (!ct) {
                     ACVP_LOG_ERR("Server JSON missing 'ct'");
-                    free(key);
                     rv = ACVP_MISSING_ARG;
                     goto err;
                 }
@@ -903,7 +978,6 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 if (ctlen > ACVP_SYM_CT_MAX) {
                     ACVP_LOG_ERR("'ct' too long, max allowed=(%d)",
                                  ACVP_SYM_CT_MAX);
-                    free(key);
                     rv = ACVP_INVALID_ARG;
                     goto err;
                 }
@@ -924,7 +998,6 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 iv = json_object_get_string(testobj, "iv");
                 if (!iv) {
                     ACVP_LOG_ERR("Server JSON missing 'iv'");
-                    free(key);
                     rv = ACVP_MISSING_ARG;
                     goto err;
                 }
@@ -932,7 +1005,6 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 ivlen = strnlen_s(iv, ACVP_SYM_IV_MAX + 1);
                 if (ivlen != 16) {
                     ACVP_LOG_ERR("Invalid 'iv' length (%u). Expected (%u)", ivlen, 16);
-                    free(key);
                     rv = ACVP_INVALID_ARG;
                     goto err;
                 }
@@ -966,15 +1038,12 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             rv = acvp_des_init_tc(ctx, &stc, tc_id, test_type, key, pt, ct, iv,
                                   keylen, ivlen, ptlen, ctlen, alg_id, dir,
                                   incr_ctr, ovrflw_ctr, keyingOption);
+            memzero_s(key, sizeof(key));
             if (rv != ACVP_SUCCESS) {
-                acvp_des_release_tc(&stc);
-                free(key);
+                acvp_des_release_tc(ctx, &stc);
                 goto err;
             }
 
-            // Key has been copied, we can free here
-            free(key);
-
             /* If Monte Carlo start that here */
             if (stc.test_type == ACVP_SYM_TEST_TYPE_MCT) {
                 json_object_set_value(r_tobj, "resultsArray", json_value_init_array());
@@ -983,17 +1052,17 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 if (rv != ACVP_SUCCESS) {
                     json_value_free(r_tval);
                     ACVP_LOG_ERR("crypto module failed the DES MCT operation");
-                    acvp_des_release_tc(&stc);
+                    acvp_des_release_tc(ctx, &stc);
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     goto err;
                 }
             } else {
                 /* Process the current DES encrypt test vector... */
-                int t_rv = (cap->crypto_handler)(&tc);
+                int t_rv = acvp_crypto_call(ctx, cap->crypto_handler, &tc);
                 if (t_rv) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     json_value_free(r_tval);
-                    acvp_des_release_tc(&stc);
+                    acvp_des_release_tc(ctx, &stc);
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     goto err;
                 }
@@ -1004,7 +1073,7 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 rv = acvp_des_output_tc(ctx, &stc, r_tobj, t_rv);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("JSON output failure in 3DES module");
-                    acvp_des_release_tc(&stc);
+                    acvp_des_release_tc(ctx, &stc);
                     goto err;
                 }
             }
@@ -1012,7 +1081,7 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /*
              * Release all the memory associated with the test case
              */
-            acvp_des_release_tc(&stc);
+            acvp_des_release_tc(ctx, &stc);
 
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
@@ -1023,9 +1092,7 @@ ACVP_RESULT acvp_des_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     json_array_append_value(reg_arry, r_vs_val);
     rv = ACVP_SUCCESS;
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
 
 err:
     if (rv != ACVP_SUCCESS) {
@@ -1045,61 +1112,42 @@ static ACVP_RESULT acvp_des_output_tc(ACVP_CTX *ctx,
                                       JSON_Object *tc_rsp,
                                       int opt_rv) {
     ACVP_RESULT rv;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_SYM_CT_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_des_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
-        memzero_s(tmp, ACVP_SYM_CT_MAX);
         if (stc->cipher == ACVP_TDES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->ct, (stc->ct_len + 7) / 8, tmp, ACVP_SYM_CT_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "ct", stc->ct, (stc->ct_len + 7) / 8, ACVP_SYM_CT_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (ct)");
-                free(tmp);
                 return rv;
             }
-            json_object_set_string(tc_rsp, "ct", tmp);
         } else {
-            rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp, ACVP_SYM_CT_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "ct", stc->ct, stc->ct_len, ACVP_SYM_CT_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (ct)");
-                free(tmp);
                 return rv;
             }
-            json_object_set_string(tc_rsp, "ct", tmp);
         }
     } else {
         if ((stc->cipher == ACVP_TDES_KW) && (opt_rv != 0)) {
             json_object_set_boolean(tc_rsp, "testPassed", 1);
-            free(tmp);
             return ACVP_SUCCESS;
         }
 
-        memzero_s(tmp, ACVP_SYM_CT_MAX);
         if (stc->cipher == ACVP_TDES_CFB1) {
-            rv = acvp_bin_to_hexstr(stc->pt, (stc->pt_len + 7) / 8, tmp, ACVP_SYM_CT_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "pt", stc->pt, (stc->pt_len + 7) / 8, ACVP_SYM_CT_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (pt)");
-                free(tmp);
                 return rv;
             }
-            json_object_set_string(tc_rsp, "pt", tmp);
         } else {
-            rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_SYM_CT_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "pt", stc->pt, stc->pt_len, ACVP_SYM_CT_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (pt)");
-                free(tmp);
                 return rv;
             }
-            json_object_set_string(tc_rsp, "pt", tmp);
         }
     }
 
-    free(tmp);
     return ACVP_SUCCESS;
 }
 
@@ -1130,20 +1178,37 @@ static ACVP_RESULT acvp_des_init_tc(ACVP_CTX *ctx,
                                     unsigned int ovrflw_ctr,
                                     unsigned int keyingOption) {
     ACVP_RESULT rv;
+    unsigned int data_max = 0, len = 0;
 
     memzero_s(stc, sizeof(ACVP_SYM_CIPHER_TC));
 
-    stc->key = calloc(1, ACVP_SYM_KEY_MAX_BYTES);
+    /*
+     * Like AES, pt and ct come from the test case arena sized for the
+     * payload of this test case rather than the protocol maximum, with
+     * headroom for what the MCT copies in
+     */
+    if (j_pt) {
+        len = (strnlen_s(j_pt, ACVP_SYM_PT_MAX + 1) + 1) / 2;
+        if (len > data_max) data_max = len;
+    }
+    if (j_ct) {
+        len = (strnlen_s(j_ct, ACVP_SYM_CT_MAX + 1) + 1) / 2;
+        if (len > data_max) data_max = len;
+    }
+    data_max += ACVP_DES_TC_HEADROOM;
+    if (data_max > ACVP_SYM_PT_BYTE_MAX) data_max = ACVP_SYM_PT_BYTE_MAX;
+
+    stc->key = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_KEY_MAX_BYTES);
     if (!stc->key) { return ACVP_MALLOC_FAIL; }
-    stc->pt = calloc(1, ACVP_SYM_PT_BYTE_MAX);
+    stc->pt = acvp_arena_calloc(&ctx->exec.tc_arena, data_max);
     if (!stc->pt) { return ACVP_MALLOC_FAIL; }
-    stc->ct = calloc(1, ACVP_SYM_CT_BYTE_MAX);
+    stc->ct = acvp_arena_calloc(&ctx->exec.tc_arena, data_max);
     if (!stc->ct) { return ACVP_MALLOC_FAIL; }
-    stc->iv = calloc(1, ACVP_SYM_IV_BYTE_MAX);
+    stc->iv = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_IV_BYTE_MAX);
     if (!stc->iv) { return ACVP_MALLOC_FAIL; }
-    stc->iv_ret = calloc(1, ACVP_SYM_IV_BYTE_MAX);
+    stc->iv_ret = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_IV_BYTE_MAX);
     if (!stc->iv_ret) { return ACVP_MALLOC_FAIL; }
-    stc->iv_ret_after = calloc(1, ACVP_SYM_IV_BYTE_MAX);
+    stc->iv_ret_after = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_SYM_IV_BYTE_MAX);
     if (!stc->iv_ret_after) { return ACVP_MALLOC_FAIL; }
 
     rv = acvp_hexstr_to_bin(j_key, stc->key, ACVP_SYM_KEY_MAX_BYTES, NULL);
@@ -1154,13 +1219,13 @@ static ACVP_RESULT acvp_des_init_tc(ACVP_CTX *ctx,
 
     if (j_pt) {
         if (alg_id == ACVP_TDES_CFB1) {
-            rv = acvp_hexstr_to_bin(j_pt, stc->pt, ACVP_SYM_PT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_pt, stc->pt, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (pt)");
                 return rv;
             }
         } else {
-            rv = acvp_hexstr_to_bin(j_pt, stc->pt, ACVP_SYM_PT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_pt, stc->pt, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex converstion failure (pt)");
                 return rv;
@@ -1170,13 +1235,13 @@ static ACVP_RESULT acvp_des_init_tc(ACVP_CTX *ctx,
 
     if (j_ct) {
         if (alg_id == ACVP_TDES_CFB1) {
-            rv = acvp_hexstr_to_bin(j_ct, stc->ct, ACVP_SYM_PT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_ct, stc->ct, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (ct)");
                 return rv;
             }
         } else {
-            rv = acvp_hexstr_to_bin(j_ct, stc->ct, ACVP_SYM_CT_BYTE_MAX, NULL);
+            rv = acvp_hexstr_to_bin(j_ct, stc->ct, data_max, NULL);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex converstion failure (ct)");
                 return rv;
@@ -1221,13 +1286,8 @@ static ACVP_RESULT acvp_des_init_tc(ACVP_CTX *ctx,
  * This function simply releases the data associated with
  * a test case.
  */
-static ACVP_RESULT acvp_des_release_tc(ACVP_SYM_CIPHER_TC *stc) {
-    if (stc->key) free(stc->key);
-    if (stc->pt) free(stc->pt);
-    if (stc->ct) free(stc->ct);
-    if (stc->iv) free(stc->iv);
-    if (stc->iv_ret) free(stc->iv_ret);
-    if (stc->iv_ret_after) free(stc->iv_ret_after);
+static ACVP_RESULT acvp_des_release_tc(ACVP_CTX *ctx, ACVP_SYM_CIPHER_TC *stc) {
+    acvp_arena_reset(&ctx->exec.tc_arena);
     memzero_s(stc, sizeof(ACVP_SYM_CIPHER_TC));
 
     return ACVP_SUCCESS;
@@ -45,9 +45,10 @@ static ACVP_RESULT acvp_drbg_init_tc(ACVP_CTX *ctx,
                                      unsigned int nonce_len,
                                      unsigned int drb_len,
                                      ACVP_DRBG_MODE mode_id,
-                                     ACVP_CIPHER alg_id);
+                                     ACVP_CIPHER alg_id,
+                                     int use_sink);
 
-static ACVP_RESULT acvp_drbg_release_tc(ACVP_DRBG_TC *stc);
+static ACVP_RESULT acvp_drbg_release_tc(ACVP_CTX *ctx, ACVP_DRBG_TC *stc);
 
 ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     char *json_result = NULL;
@@ -71,9 +72,10 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_DRBG_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_DRBG_TC stc, group_stc;
+    ACVP_TEST_CASE tc, group_tc;
     ACVP_RESULT rv;
+    int group_open = 0;
     const char *alg_str = NULL, *int_use = NULL;
     ACVP_CIPHER alg_id;
     ACVP_DRBG_MODE mode_id;
@@ -97,6 +99,7 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.drbg = &stc;
+    group_tc.tc.drbg = &group_stc;
 
     /*
      * Get the crypto module handler for this DRBG algorithm
@@ -125,7 +128,7 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -149,15 +152,15 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         /*
          * Get DRBG Mode index
@@ -257,6 +260,30 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         ACVP_LOG_VERBOSE("    nonceLen: %d", nonce_len);
         ACVP_LOG_VERBOSE("    returnedBitsLen: %d", drb_len);
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_DRBG_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = alg_id;
+            group_stc.mode = mode_id;
+            group_stc.tg_id = tgId;
+            group_stc.der_func_enabled = der_func_enabled;
+            group_stc.pred_resist_enabled = pred_resist_enabled;
+            group_stc.reseed = reseed;
+            group_stc.additional_input_len = ACVP_BIT2BYTE(additional_input_len);
+            group_stc.perso_string_len = ACVP_BIT2BYTE(perso_string_len);
+            group_stc.entropy_len = ACVP_BIT2BYTE(entropy_len);
+            group_stc.nonce_len = ACVP_BIT2BYTE(nonce_len);
+            group_stc.drb_len = ACVP_BIT2BYTE(drb_len);
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         /*
          * Handle test array
          */
@@ -276,11 +303,13 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            json_result = json_serialize_to_string_pretty(testval, NULL);
-            ACVP_LOG_VERBOSE("json testval count: %d\n %s\n", i, json_result);
-            json_free_serialized_string(json_result);
+            if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
+                json_result = json_serialize_to_string_pretty(testval, NULL);
+                ACVP_LOG_VERBOSE("json testval count: %d\n %s\n", i, json_result);
+                json_free_serialized_string(json_result);
+            }
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             perso_string = json_object_get_string(testobj, "persoString");
             if (!perso_string) {
@@ -524,19 +553,22 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                                    der_func_enabled, pred_resist_enabled,
                                    additional_input_len, perso_string_len,
                                    entropy_len, nonce_len,
-                                   drb_len, mode_id, alg_id);
+                                   drb_len, mode_id, alg_id,
+                                   acvp_output_sink_enabled(cap));
 
             if (rv != ACVP_SUCCESS) {
-                acvp_drbg_release_tc(&stc);
+                acvp_drbg_release_tc(ctx, &stc);
                 json_value_free(r_tval);
                 goto err;
             }
+            stc.tg_id = tgId;
+            stc.tg_ctx = group_stc.tg_ctx;
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
-                acvp_drbg_release_tc(&stc);
+                acvp_drbg_release_tc(ctx, &stc);
                 json_value_free(r_tval);
                 goto err;
             }
@@ -547,7 +579,7 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             rv = acvp_drbg_output_tc(ctx, &stc, r_tobj);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("JSON output failure in DRBG module");
-                acvp_drbg_release_tc(&stc);
+                acvp_drbg_release_tc(ctx, &stc);
                 json_value_free(r_tval);
                 goto err;
             }
@@ -555,21 +587,30 @@ ACVP_RESULT acvp_drbg_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /*
              * Release all the memory associated with the test case
              */
-            acvp_drbg_release_tc(&stc);
+            acvp_drbg_release_tc(ctx, &stc);
 
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
 
     rv = ACVP_SUCCESS;
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
@@ -584,23 +625,27 @@ err:
  */
 static ACVP_RESULT acvp_drbg_output_tc(ACVP_CTX *ctx, ACVP_DRBG_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
-    tmp = calloc(ACVP_DRB_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_drbg_output_tc");
-        return ACVP_MALLOC_FAIL;
+    if (stc->drb_sink) {
+        if (stc->drb_sink->len != stc->drb_sink->max) {
+            ACVP_LOG_ERR("crypto module wrote %u of the %u bytes of output", stc->drb_sink->len,
+                         stc->drb_sink->max);
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_output_sink_set(stc->drb_sink, tc_rsp, "returnedBits");
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure (returnedBits)");
+        }
+        return rv;
     }
 
-    rv = acvp_bin_to_hexstr(stc->drb, stc->drb_len, tmp, ACVP_DRB_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "returnedBits", stc->drb, stc->drb_len, ACVP_DRB_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (returnedBits)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "returnedBits", tmp);
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -628,30 +673,37 @@ static ACVP_RESULT acvp_drbg_init_tc(ACVP_CTX *ctx,
                                      unsigned int nonce_len,
                                      unsigned int drb_len,
                                      ACVP_DRBG_MODE mode_id,
-                                     ACVP_CIPHER alg_id) {
+                                     ACVP_CIPHER alg_id,
+                                     int use_sink) {
     ACVP_RESULT rv;
 
     memzero_s(stc, sizeof(ACVP_DRBG_TC));
 
-    stc->drb = calloc(ACVP_DRB_BYTE_MAX, sizeof(unsigned char));
-    if (!stc->drb) { return ACVP_MALLOC_FAIL; }
-    stc->additional_input_0 = calloc(ACVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
+    if (use_sink) {
+        /* The crypto module writes the returned bits straight into the response */
+        stc->drb_sink = acvp_output_sink_new(ACVP_BIT2BYTE(drb_len));
+        if (!stc->drb_sink) { return ACVP_MALLOC_FAIL; }
+    } else {
+        stc->drb = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRB_BYTE_MAX);
+        if (!stc->drb) { return ACVP_MALLOC_FAIL; }
+    }
+    stc->additional_input_0 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ADDI_IN_BYTE_MAX);
     if (!stc->additional_input_0) { return ACVP_MALLOC_FAIL; }
-    stc->additional_input_1 = calloc(ACVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->additional_input_1 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ADDI_IN_BYTE_MAX);
     if (!stc->additional_input_1) { return ACVP_MALLOC_FAIL; }
-    stc->additional_input_2 = calloc(ACVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->additional_input_2 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ADDI_IN_BYTE_MAX);
     if (!stc->additional_input_2) { return ACVP_MALLOC_FAIL; }
-    stc->entropy = calloc(ACVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ENTPY_IN_BYTE_MAX);
     if (!stc->entropy) { return ACVP_MALLOC_FAIL; }
-    stc->entropy_input_pr_0 = calloc(ACVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy_input_pr_0 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ENTPY_IN_BYTE_MAX);
     if (!stc->entropy_input_pr_0) { return ACVP_MALLOC_FAIL; }
-    stc->entropy_input_pr_1 = calloc(ACVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy_input_pr_1 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ENTPY_IN_BYTE_MAX);
     if (!stc->entropy_input_pr_1) { return ACVP_MALLOC_FAIL; }
-    stc->entropy_input_pr_2 = calloc(ACVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy_input_pr_2 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_ENTPY_IN_BYTE_MAX);
     if (!stc->entropy_input_pr_2) { return ACVP_MALLOC_FAIL; }
-    stc->nonce = calloc(ACVP_DRBG_NONCE_BYTE_MAX, sizeof(unsigned char));
+    stc->nonce = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_NONCE_BYTE_MAX);
     if (!stc->nonce) { return ACVP_MALLOC_FAIL; }
-    stc->perso_string = calloc(ACVP_DRBG_PER_SO_BYTE_MAX, sizeof(unsigned char));
+    stc->perso_string = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_DRBG_PER_SO_BYTE_MAX);
     if (!stc->perso_string) { return ACVP_MALLOC_FAIL; }
 
     if (additional_input_0) {
@@ -757,17 +809,9 @@ static ACVP_RESULT acvp_drbg_init_tc(ACVP_CTX *ctx,
  * This function simply releases the data associated with
  * a test case.
  */
-static ACVP_RESULT acvp_drbg_release_tc(ACVP_DRBG_TC *stc) {
-    if (stc->drb) free(stc->drb);
-    if (stc->additional_input_0) free(stc->additional_input_0);
-    if (stc->additional_input_1) free(stc->additional_input_1);
-    if (stc->additional_input_2) free(stc->additional_input_2);
-    if (stc->entropy) free(stc->entropy);
-    if (stc->entropy_input_pr_0) free(stc->entropy_input_pr_0);
-    if (stc->entropy_input_pr_1) free(stc->entropy_input_pr_1);
-    if (stc->entropy_input_pr_2) free(stc->entropy_input_pr_2);
-    if (stc->nonce) free(stc->nonce);
-    if (stc->perso_string) free(stc->perso_string);
+static ACVP_RESULT acvp_drbg_release_tc(ACVP_CTX *ctx, ACVP_DRBG_TC *stc) {
+    acvp_output_sink_free(stc->drb_sink);
+    acvp_arena_reset(&ctx->exec.tc_arena);
 
     memzero_s(stc, sizeof(ACVP_DRBG_TC));
     return ACVP_SUCCESS;
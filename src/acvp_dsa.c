@@ -17,6 +17,112 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+/*
+ * Domain parameters the crypto module generated for a KeyGen or SigGen
+ * group. They are kept on the session, keyed on L and N, and handed to
+ * later groups of the same size, in any vector set of the session, so that
+ * the module need not generate them again.
+ */
+typedef struct acvp_dsa_pqg_t {
+    int l;
+    int n;
+    unsigned char *p;
+    int p_len;
+    unsigned char *q;
+    int q_len;
+    unsigned char *g;
+    int g_len;
+    struct acvp_dsa_pqg_t *next;
+} ACVP_DSA_PQG;
+
+static ACVP_CTX *acvp_dsa_pqg_owner(ACVP_CTX *ctx) {
+    return ctx->session ? ctx->session : ctx;
+}
+
+/*
+ * Fills in p, q and g of the test case if domain parameters of its size
+ * have been generated before
+ */
+static void acvp_dsa_pqg_lookup(ACVP_CTX *ctx, ACVP_DSA_TC *stc) {
+    ACVP_CTX *owner = acvp_dsa_pqg_owner(ctx);
+    ACVP_DSA_PQG *pqg = NULL;
+
+    acvp_mutex_lock(&owner->dsa_pqg_lock);
+    for (pqg = owner->dsa_pqg; pqg; pqg = pqg->next) {
+        if (pqg->l == stc->l && pqg->n == stc->n) {
+            break;
+        }
+    }
+    if (pqg) {
+        memcpy_s(stc->p, ACVP_DSA_MAX_STRING, pqg->p, pqg->p_len);
+        stc->p_len = pqg->p_len;
+        memcpy_s(stc->q, ACVP_DSA_MAX_STRING, pqg->q, pqg->q_len);
+        stc->q_len = pqg->q_len;
+        memcpy_s(stc->g, ACVP_DSA_MAX_STRING, pqg->g, pqg->g_len);
+        stc->g_len = pqg->g_len;
+        stc->pqg_given = 1;
+    }
+    acvp_mutex_unlock(&owner->dsa_pqg_lock);
+}
+
+/*
+ * Keeps the domain parameters the crypto module returned in a test case,
+ * unless parameters of that size are already kept or p and q are not the
+ * size the group asked for
+ */
+static ACVP_RESULT acvp_dsa_pqg_save(ACVP_CTX *ctx, const ACVP_DSA_TC *stc) {
+    ACVP_CTX *owner = acvp_dsa_pqg_owner(ctx);
+    ACVP_DSA_PQG *pqg = NULL;
+
+    if (stc->pqg_given) {
+        return ACVP_SUCCESS;
+    }
+    if (stc->p_len * 8 != stc->l || stc->q_len * 8 != stc->n ||
+            stc->p_len > ACVP_DSA_MAX_STRING || stc->q_len > ACVP_DSA_MAX_STRING ||
+            stc->g_len <= 0 || stc->g_len > ACVP_DSA_MAX_STRING) {
+        return ACVP_SUCCESS;
+    }
+
+    acvp_mutex_lock(&owner->dsa_pqg_lock);
+    for (pqg = owner->dsa_pqg; pqg; pqg = pqg->next) {
+        if (pqg->l == stc->l && pqg->n == stc->n) {
+            acvp_mutex_unlock(&owner->dsa_pqg_lock);
+            return ACVP_SUCCESS;
+        }
+    }
+    pqg = calloc(1, sizeof(ACVP_DSA_PQG) + stc->p_len + stc->q_len + stc->g_len);
+    if (!pqg) {
+        acvp_mutex_unlock(&owner->dsa_pqg_lock);
+        return ACVP_MALLOC_FAIL;
+    }
+    pqg->l = stc->l;
+    pqg->n = stc->n;
+    pqg->p = (unsigned char *)(pqg + 1);
+    pqg->q = pqg->p + stc->p_len;
+    pqg->g = pqg->q + stc->q_len;
+    memcpy_s(pqg->p, stc->p_len, stc->p, stc->p_len);
+    pqg->p_len = stc->p_len;
+    memcpy_s(pqg->q, stc->q_len, stc->q, stc->q_len);
+    pqg->q_len = stc->q_len;
+    memcpy_s(pqg->g, stc->g_len, stc->g, stc->g_len);
+    pqg->g_len = stc->g_len;
+    pqg->next = owner->dsa_pqg;
+    owner->dsa_pqg = pqg;
+    acvp_mutex_unlock(&owner->dsa_pqg_lock);
+
+    return ACVP_SUCCESS;
+}
+
+void acvp_dsa_pqg_free(ACVP_CTX *ctx) {
+    ACVP_DSA_PQG *pqg = NULL, *next = NULL;
+
+    for (pqg = ctx->dsa_pqg; pqg; pqg = next) {
+        next = pqg->next;
+        free(pqg);
+    }
+    ctx->dsa_pqg = NULL;
+}
+
 static ACVP_RESULT acvp_dsa_keygen_init_tc(ACVP_DSA_TC *stc,
                                            int tg_id,
                                            unsigned int tc_id,
@@ -107,7 +213,8 @@ static ACVP_RESULT acvp_dsa_sigver_init_tc(ACVP_CTX *ctx,
                                            const char *r,
                                            const char *s,
                                            const char *y,
-                                           const char *msg) {
+                                           const char *msg,
+                                           int limbs) {
     ACVP_RESULT rv;
 
     stc->l = l;
@@ -142,32 +249,32 @@ static ACVP_RESULT acvp_dsa_sigver_init_tc(ACVP_CTX *ctx,
         ACVP_LOG_ERR("Hex conversion failure (msg)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(p, stc->p, ACVP_DSA_MAX_STRING, &(stc->p_len));
+    rv = acvp_hexstr_to_num(limbs, p, stc->p, ACVP_DSA_MAX_STRING, &(stc->p_len), &stc->p_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (p)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(q, stc->q, ACVP_DSA_MAX_STRING, &(stc->q_len));
+    rv = acvp_hexstr_to_num(limbs, q, stc->q, ACVP_DSA_MAX_STRING, &(stc->q_len), &stc->q_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (q)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(g, stc->g, ACVP_DSA_MAX_STRING, &(stc->g_len));
+    rv = acvp_hexstr_to_num(limbs, g, stc->g, ACVP_DSA_MAX_STRING, &(stc->g_len), &stc->g_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (g)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(r, stc->r, ACVP_DSA_MAX_STRING, &(stc->r_len));
+    rv = acvp_hexstr_to_num(limbs, r, stc->r, ACVP_DSA_MAX_STRING, &(stc->r_len), &stc->r_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (r)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(s, stc->s, ACVP_DSA_MAX_STRING, &(stc->s_len));
+    rv = acvp_hexstr_to_num(limbs, s, stc->s, ACVP_DSA_MAX_STRING, &(stc->s_len), &stc->s_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (s)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(y, stc->y, ACVP_DSA_MAX_STRING, &(stc->y_len));
+    rv = acvp_hexstr_to_num(limbs, y, stc->y, ACVP_DSA_MAX_STRING, &(stc->y_len), &stc->y_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (y)");
         return rv;
@@ -188,7 +295,8 @@ static ACVP_RESULT acvp_dsa_pqgver_init_tc(ACVP_CTX *ctx,
                                            const char *g,
                                            const char *h,
                                            const char *seed,
-                                           unsigned int pqg) {
+                                           unsigned int pqg,
+                                           int limbs) {
     ACVP_RESULT rv;
 
     stc->l = l;
@@ -238,19 +346,19 @@ static ACVP_RESULT acvp_dsa_pqgver_init_tc(ACVP_CTX *ctx,
         }
     }
 
-    rv = acvp_hexstr_to_bin(p, stc->p, ACVP_DSA_MAX_STRING, &(stc->p_len));
+    rv = acvp_hexstr_to_num(limbs, p, stc->p, ACVP_DSA_MAX_STRING, &(stc->p_len), &stc->p_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (p)");
         return rv;
     }
-    rv = acvp_hexstr_to_bin(q, stc->q, ACVP_DSA_MAX_STRING, &(stc->q_len));
+    rv = acvp_hexstr_to_num(limbs, q, stc->q, ACVP_DSA_MAX_STRING, &(stc->q_len), &stc->q_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (q)");
         return rv;
     }
 
     if (g) {
-        rv = acvp_hexstr_to_bin(g, stc->g, ACVP_DSA_MAX_STRING, &(stc->g_len));
+        rv = acvp_hexstr_to_num(limbs, g, stc->g, ACVP_DSA_MAX_STRING, &(stc->g_len), &stc->g_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (g)");
             return rv;
@@ -346,55 +454,37 @@ static ACVP_RESULT acvp_dsa_pqggen_init_tc(ACVP_CTX *ctx,
  */
 static ACVP_RESULT acvp_dsa_output_tc(ACVP_CTX *ctx, ACVP_DSA_TC *stc, JSON_Object *r_tobj) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
     switch (stc->mode) {
     case ACVP_DSA_MODE_PQGGEN:
         switch (stc->gen_pq) {
         case ACVP_DSA_CANONICAL:
         case ACVP_DSA_UNVERIFIABLE:
-            tmp = calloc(ACVP_DSA_PQG_MAX + 1, sizeof(char));
-            if (!tmp) {
-                ACVP_LOG_ERR("Unable to malloc in acvp_dsa_output_tc");
-                return ACVP_MALLOC_FAIL;
-            }
-            rv = acvp_bin_to_hexstr(stc->g, stc->g_len, tmp, ACVP_DSA_PQG_MAX);
+            rv = acvp_json_set_hex(r_tobj, "g", stc->g, stc->g_len, ACVP_DSA_PQG_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (g)");
                 goto err;
             }
-            json_object_set_string(r_tobj, "g", (const char *)tmp);
-            memzero_s(tmp, ACVP_DSA_PQG_MAX + 1);
             break;
         case ACVP_DSA_PROBABLE:
         case ACVP_DSA_PROVABLE:
-            tmp = calloc(ACVP_DSA_PQG_MAX + 1, sizeof(char));
-            if (!tmp) {
-                ACVP_LOG_ERR("Unable to malloc in acvp_dsa_output_tc");
-                return ACVP_MALLOC_FAIL;
-            }
-            rv = acvp_bin_to_hexstr(stc->p, stc->p_len, tmp, ACVP_DSA_PQG_MAX);
+            rv = acvp_json_set_hex(r_tobj, "p", stc->p, stc->p_len, ACVP_DSA_PQG_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (p)");
                 goto err;
             }
-            json_object_set_string(r_tobj, "p", (const char *)tmp);
-            memzero_s(tmp, ACVP_DSA_PQG_MAX + 1);
 
-            rv = acvp_bin_to_hexstr(stc->q, stc->q_len, tmp, ACVP_DSA_PQG_MAX);
+            rv = acvp_json_set_hex(r_tobj, "q", stc->q, stc->q_len, ACVP_DSA_PQG_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (q)");
                 goto err;
             }
-            json_object_set_string(r_tobj, "q", (const char *)tmp);
 
-            memzero_s(tmp, ACVP_DSA_SEED_MAX);
-            rv = acvp_bin_to_hexstr(stc->seed, stc->seedlen, tmp, ACVP_DSA_SEED_MAX);
+            rv = acvp_json_set_hex(r_tobj, "domainSeed", stc->seed, stc->seedlen, ACVP_DSA_SEED_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (p)");
                 goto err;
             }
-            json_object_set_string(r_tobj, "domainSeed", tmp);
             json_object_set_number(r_tobj, "counter", stc->counter);
             break;
         default:
@@ -405,53 +495,35 @@ static ACVP_RESULT acvp_dsa_output_tc(ACVP_CTX *ctx, ACVP_DSA_TC *stc, JSON_Obje
         }
         break;
     case ACVP_DSA_MODE_SIGGEN:
-        tmp = calloc(ACVP_DSA_PQG_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in acvp_dsa_output_tc");
-            return ACVP_MALLOC_FAIL;
-        }
-        rv = acvp_bin_to_hexstr(stc->r, stc->r_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_tobj, "r", stc->r, stc->r_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (r)");
             goto err;
         }
-        json_object_set_string(r_tobj, "r", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->s, stc->s_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_tobj, "s", stc->s, stc->s_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (s)");
             goto err;
         }
-        json_object_set_string(r_tobj, "s", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
         break;
     case ACVP_DSA_MODE_SIGVER:
         json_object_set_boolean(r_tobj, "testPassed", stc->result);
         break;
     case ACVP_DSA_MODE_KEYGEN:
-        tmp = calloc(ACVP_DSA_PQG_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in acvp_dsa_output_tc");
-            return ACVP_MALLOC_FAIL;
-        }
 
-        rv = acvp_bin_to_hexstr(stc->y, stc->y_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_tobj, "y", stc->y, stc->y_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (y)");
             goto err;
         }
-        json_object_set_string(r_tobj, "y", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->x, stc->x_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_tobj, "x", stc->x, stc->x_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (x)");
             goto err;
         }
-        json_object_set_string(r_tobj, "x", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
         break;
     case ACVP_DSA_MODE_PQGVER:
@@ -462,7 +534,6 @@ static ACVP_RESULT acvp_dsa_output_tc(ACVP_CTX *ctx, ACVP_DSA_TC *stc, JSON_Obje
     }
 
 err:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -481,12 +552,67 @@ static ACVP_RESULT acvp_dsa_release_tc(ACVP_DSA_TC *stc) {
     if (stc->s) free(stc->s);
     if (stc->seed) free(stc->seed);
     if (stc->msg) free(stc->msg);
+    acvp_bn_free(&stc->p_bn);
+    acvp_bn_free(&stc->q_bn);
+    acvp_bn_free(&stc->g_bn);
+    acvp_bn_free(&stc->y_bn);
+    acvp_bn_free(&stc->r_bn);
+    acvp_bn_free(&stc->s_bn);
 
     memzero_s(stc, sizeof(ACVP_DSA_TC));
 
     return ACVP_SUCCESS;
 }
 
+/*
+ * Runs the test cases collected for a PQGVer or SigVer test group, see
+ * acvp_tc_batch_run(), and outputs their results, in test case order,
+ * into the group's tests array.
+ */
+static ACVP_RESULT acvp_dsa_run_batch(ACVP_CTX *ctx,
+                                      ACVP_CAPS_LIST *cap,
+                                      ACVP_TC_BATCH *batch,
+                                      JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_dsa_output_tc(ctx, batch->tcs[i].tc.dsa, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in DSA module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_dsa_release_batch(ACVP_DSA_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_dsa_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
+
 static ACVP_RESULT acvp_dsa_keygen_handler(ACVP_CTX *ctx,
                                     ACVP_TEST_CASE tc,
                                     ACVP_CAPS_LIST *cap,
@@ -503,6 +629,7 @@ static ACVP_RESULT acvp_dsa_keygen_handler(ACVP_CTX *ctx,
     JSON_Value *mval;
     JSON_Object *mobj = NULL;
     ACVP_DSA_TC *stc;
+    ACVP_TC_CONTROL control;
 
     l = json_object_get_number(groupobj, "l");
     if (!l) {
@@ -540,7 +667,7 @@ static ACVP_RESULT acvp_dsa_keygen_handler(ACVP_CTX *ctx,
         testval = json_array_get_value(tests, j);
         testobj = json_value_get_object(testval);
 
-        tc_id = json_object_get_number(testobj, "tcId");
+        tc_id = json_object_get_uint(testobj, "tcId");
         if (!tc_id) {
             ACVP_LOG_ERR("Failed to include tc_id. ");
             return ACVP_MISSING_ARG;
@@ -557,13 +684,19 @@ static ACVP_RESULT acvp_dsa_keygen_handler(ACVP_CTX *ctx,
         if (rv != ACVP_SUCCESS) {
             goto err;
         }
+        acvp_dsa_pqg_lookup(ctx, stc);
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        stc->control = acvp_tc_control_begin(ctx, &control, ACVP_DSA_KEYGEN, tg_id, tc_id);
+        if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
             ACVP_LOG_ERR("crypto module failed the operation");
             rv = ACVP_CRYPTO_MODULE_FAIL;
             goto err;
         }
+        rv = acvp_dsa_pqg_save(ctx, stc);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
+        }
 
         mval = json_value_init_object();
         mobj = json_value_get_object(mval);
@@ -572,38 +705,23 @@ static ACVP_RESULT acvp_dsa_keygen_handler(ACVP_CTX *ctx,
         /*
          * Set the values for the group (p,q,g)
          */
-        char *tmp = calloc(ACVP_DSA_PQG_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in acvp_dsa_output_tc");
-            return ACVP_MALLOC_FAIL;
-        }
-        rv = acvp_bin_to_hexstr(stc->p, stc->p_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "p", stc->p, stc->p_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (p)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "p", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->q, stc->q_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "q", stc->q, stc->q_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (q)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "q", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->g, stc->g_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "g", stc->g, stc->g_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (g)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "g", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
-        free(tmp);
 
         /*
          * Output the test case results using JSON
@@ -664,7 +782,8 @@ ACVP_RESULT acvp_dsa_pqggen_handler(ACVP_CTX *ctx,
                                     ACVP_TEST_CASE tc,
                                     ACVP_CAPS_LIST *cap,
                                     JSON_Array *r_tarr,
-                                    JSON_Object *groupobj) {
+                                    JSON_Object *groupobj,
+                                    int tg_id) {
     const char *idx = NULL;
     JSON_Array *tests;
     JSON_Value *testval;
@@ -676,6 +795,7 @@ ACVP_RESULT acvp_dsa_pqggen_handler(ACVP_CTX *ctx,
     unsigned gpq = 0, n, l;
     const char *p = NULL, *q = NULL, *seed = NULL;
     ACVP_DSA_TC *stc;
+    ACVP_TC_CONTROL control;
     ACVP_HASH_ALG sha = 0;
     const char *sha_str = NULL, *gen_g = NULL, *gen_pq = NULL;
 
@@ -744,7 +864,7 @@ ACVP_RESULT acvp_dsa_pqggen_handler(ACVP_CTX *ctx,
         testval = json_array_get_value(tests, j);
         testobj = json_value_get_object(testval);
 
-        tc_id = json_object_get_number(testobj, "tcId");
+        tc_id = json_object_get_uint(testobj, "tcId");
         if (!tc_id) {
             ACVP_LOG_ERR("Failed to include tc_id. ");
             return ACVP_MISSING_ARG;
@@ -825,7 +945,8 @@ ACVP_RESULT acvp_dsa_pqggen_handler(ACVP_CTX *ctx,
             }
 
             /* Process the current DSA test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            stc->control = acvp_tc_control_begin(ctx, &control, ACVP_DSA_PQGGEN, tg_id, tc_id);
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 acvp_dsa_release_tc(stc);
                 json_value_free(r_tval);
@@ -866,7 +987,8 @@ ACVP_RESULT acvp_dsa_pqggen_handler(ACVP_CTX *ctx,
                 return rv;
             }
 
-            if ((cap->crypto_handler)(&tc)) {
+            stc->control = acvp_tc_control_begin(ctx, &control, ACVP_DSA_PQGGEN, tg_id, tc_id);
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 acvp_dsa_release_tc(stc);
                 json_value_free(r_tval);
@@ -964,7 +1086,7 @@ static ACVP_RESULT acvp_dsa_siggen_handler(ACVP_CTX *ctx,
         testval = json_array_get_value(tests, j);
         testobj = json_value_get_object(testval);
 
-        tc_id = json_object_get_number(testobj, "tcId");
+        tc_id = json_object_get_uint(testobj, "tcId");
         if (!tc_id) {
             ACVP_LOG_ERR("Failed to include tc_id. ");
             return ACVP_MISSING_ARG;
@@ -988,13 +1110,18 @@ static ACVP_RESULT acvp_dsa_siggen_handler(ACVP_CTX *ctx,
         if (rv != ACVP_SUCCESS) {
             goto err;
         }
+        acvp_dsa_pqg_lookup(ctx, stc);
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
             ACVP_LOG_ERR("crypto module failed the operation");
             rv = ACVP_CRYPTO_MODULE_FAIL;
             goto err;
         }
+        rv = acvp_dsa_pqg_save(ctx, stc);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
+        }
 
         mval = json_value_init_object();
         mobj = json_value_get_object(mval);
@@ -1003,48 +1130,30 @@ static ACVP_RESULT acvp_dsa_siggen_handler(ACVP_CTX *ctx,
         /*
          * Set the p,q,g,y values in the group obj
          */
-        char *tmp = calloc(ACVP_DSA_PQG_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in acvp_dsa_siggen_handler");
-            return ACVP_MALLOC_FAIL;
-        }
 
-        rv = acvp_bin_to_hexstr(stc->p, stc->p_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "p", stc->p, stc->p_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (p)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "p", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->q, stc->q_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "q", stc->q, stc->q_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (q)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "q", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->g, stc->g_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "g", stc->g, stc->g_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (g)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "g", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->y, stc->y_len, tmp, ACVP_DSA_PQG_MAX);
+        rv = acvp_json_set_hex(r_gobj, "y", stc->y, stc->y_len, ACVP_DSA_PQG_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (y)");
-            free(tmp);
             goto err;
         }
-        json_object_set_string(r_gobj, "y", (const char *)tmp);
-        memzero_s(tmp, ACVP_DSA_PQG_MAX);
-        free(tmp);
 
         /*
          * Output the test case results using JSON
@@ -1083,7 +1192,9 @@ static ACVP_RESULT acvp_dsa_pqgver_handler(ACVP_CTX *ctx,
     JSON_Value *mval;
     JSON_Object *mobj = NULL;
     const char *p = NULL, *q = NULL, *h = NULL;
-    ACVP_DSA_TC *stc;
+    ACVP_DSA_TC *stc, *cur = NULL, *stcs = NULL;
+    ACVP_TC_BATCH batch;
+    int use_batch = 0;
     ACVP_HASH_ALG sha = 0;
     const char *sha_str = NULL;
 
@@ -1140,18 +1251,39 @@ static ACVP_RESULT acvp_dsa_pqgver_handler(ACVP_CTX *ctx,
     }
 
     stc = tc.tc.dsa;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
+
+    /*
+     * The test cases of the group do not depend on each other, so they can
+     * be set up in one piece and then verified together. Each test case
+     * keeps its own buffers.
+     */
+    use_batch = acvp_tc_batch_enabled(ctx, cap);
+    if (use_batch) {
+        stcs = calloc(t_cnt, sizeof(ACVP_DSA_TC));
+        if (!stcs) {
+            return ACVP_MALLOC_FAIL;
+        }
+        rv = acvp_tc_batch_init(&batch, t_cnt);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
+        }
+    }
 
     for (j = 0; j < t_cnt; j++) {
         ACVP_LOG_VERBOSE("Found new DSA PQGVer test vector...");
-        stc->mode = ACVP_DSA_MODE_PQGVER;
+        cur = use_batch ? &stcs[j] : stc;
+        cur->cipher = cap->cipher;
+        cur->mode = ACVP_DSA_MODE_PQGVER;
 
         testval = json_array_get_value(tests, j);
         testobj = json_value_get_object(testval);
 
-        tc_id = json_object_get_number(testobj, "tcId");
+        tc_id = json_object_get_uint(testobj, "tcId");
         if (!tc_id) {
             ACVP_LOG_ERR("Failed to include tc_id. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
 
         seed = json_object_get_string(testobj, "domainSeed");
@@ -1161,13 +1293,15 @@ static ACVP_RESULT acvp_dsa_pqgver_handler(ACVP_CTX *ctx,
         p = json_object_get_string(testobj, "p");
         if (!p) {
             ACVP_LOG_ERR("Failed to include p. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
 
         q = json_object_get_string(testobj, "q");
         if (!q) {
             ACVP_LOG_ERR("Failed to include q. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
 
         g = json_object_get_string(testobj, "g");
@@ -1194,50 +1328,66 @@ static ACVP_RESULT acvp_dsa_pqgver_handler(ACVP_CTX *ctx,
         switch (gpq) {
         case ACVP_DSA_PROVABLE:
             ACVP_LOG_ERR("libacvp does not fully support \"provable\" method for pqgVer at this time");
-            return ACVP_UNSUPPORTED_OP;
+            rv = ACVP_UNSUPPORTED_OP;
+            goto err;
         case ACVP_DSA_PROBABLE:
             if (!seed) {
                 ACVP_LOG_ERR("Failed to include seed. ");
-                return ACVP_MISSING_ARG;
+                rv = ACVP_MISSING_ARG;
+                goto err;
             }
             break;
         case ACVP_DSA_CANONICAL:
             if (!idx) {
                 ACVP_LOG_ERR("Failed to include idx. ");
-                return ACVP_MISSING_ARG;
+                rv = ACVP_MISSING_ARG;
+                goto err;
             }
             if (!g) {
                 ACVP_LOG_ERR("Failed to include q. ");
-                return ACVP_MISSING_ARG;
+                rv = ACVP_MISSING_ARG;
+                goto err;
             }
             break;
         case ACVP_DSA_UNVERIFIABLE:
             if (!seed) {
                 ACVP_LOG_ERR("Failed to include seed. ");
-                return ACVP_MISSING_ARG;
+                rv = ACVP_MISSING_ARG;
+                goto err;
             }
             if (!h) {
                 ACVP_LOG_ERR("Failed to include h. ");
-                return ACVP_MISSING_ARG;
+                rv = ACVP_MISSING_ARG;
+                goto err;
             }
             break;
         default:
             ACVP_LOG_ERR("Failed to include valid gen_pq. ");
-            return ACVP_UNSUPPORTED_OP;
+            rv = ACVP_UNSUPPORTED_OP;
+            goto err;
         }
 
         /*
          * Setup the test case data that will be passed down to
          * the crypto module.
          */
-        rv = acvp_dsa_pqgver_init_tc(ctx, stc, l, n, c, idx, sha, p, q, g, h, seed, gpq);
+        rv = acvp_dsa_pqgver_init_tc(ctx, cur, l, n, c, idx, sha, p, q, g, h, seed, gpq,
+                                     acvp_bn_limbs_enabled(cap));
         if (rv != ACVP_SUCCESS) {
-            acvp_dsa_release_tc(stc);
-            return rv;
+            acvp_dsa_release_tc(cur);
+            goto err;
+        }
+
+        if (use_batch) {
+            mval = json_value_init_object();
+            json_object_set_number(json_value_get_object(mval), "tcId", tc_id);
+            /* Verified with the rest of the group below */
+            acvp_tc_batch_add(&batch, mval)->tc.dsa = cur;
+            continue;
         }
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
             ACVP_LOG_ERR("crypto module failed the operation");
             acvp_dsa_release_tc(stc);
             return ACVP_CRYPTO_MODULE_FAIL;
@@ -1260,8 +1410,14 @@ static ACVP_RESULT acvp_dsa_pqgver_handler(ACVP_CTX *ctx,
         /* Append the test response value to array */
         json_array_append_value(r_tarr, mval);
     }
+    if (use_batch) {
+        rv = acvp_dsa_run_batch(ctx, cap, &batch, r_tarr);
+    }
     /* Append the test response value to array */
     json_array_append_value(r_tarr, r_tval);
+
+err:
+    acvp_dsa_release_batch(&stcs, &batch);
     return rv;
 }
 
@@ -1280,7 +1436,9 @@ static ACVP_RESULT acvp_dsa_sigver_handler(ACVP_CTX *ctx,
     JSON_Value *mval;
     JSON_Object *mobj = NULL;
     const char *p = NULL, *q = NULL;
-    ACVP_DSA_TC *stc;
+    ACVP_DSA_TC *stc, *cur = NULL, *stcs = NULL;
+    ACVP_TC_BATCH batch;
+    int use_batch = 0;
     ACVP_HASH_ALG sha = 0;
     const char *sha_str = NULL;
 
@@ -1324,6 +1482,7 @@ static ACVP_RESULT acvp_dsa_sigver_handler(ACVP_CTX *ctx,
     }
 
     stc = tc.tc.dsa;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     p = json_object_get_string(groupobj, "p");
     if (!p) {
@@ -1343,38 +1502,62 @@ static ACVP_RESULT acvp_dsa_sigver_handler(ACVP_CTX *ctx,
         return ACVP_MISSING_ARG;
     }
 
+    /*
+     * The test cases of the group do not depend on each other, so they can
+     * be set up in one piece and then verified together. Each test case
+     * keeps its own buffers.
+     */
+    use_batch = acvp_tc_batch_enabled(ctx, cap);
+    if (use_batch) {
+        stcs = calloc(t_cnt, sizeof(ACVP_DSA_TC));
+        if (!stcs) {
+            return ACVP_MALLOC_FAIL;
+        }
+        rv = acvp_tc_batch_init(&batch, t_cnt);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
+        }
+    }
+
     for (j = 0; j < t_cnt; j++) {
         ACVP_LOG_VERBOSE("Found new DSA SigVer test vector...");
-        stc->mode = ACVP_DSA_MODE_SIGVER;
+        cur = use_batch ? &stcs[j] : stc;
+        cur->cipher = cap->cipher;
+        cur->mode = ACVP_DSA_MODE_SIGVER;
 
         testval = json_array_get_value(tests, j);
         testobj = json_value_get_object(testval);
 
-        tc_id = json_object_get_number(testobj, "tcId");
+        tc_id = json_object_get_uint(testobj, "tcId");
         if (!tc_id) {
             ACVP_LOG_ERR("Failed to include tc_id. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
 
         msg = json_object_get_string(testobj, "message");
         if (!msg) {
             ACVP_LOG_ERR("Failed to include message. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
         r = json_object_get_string(testobj, "r");
         if (!r) {
             ACVP_LOG_ERR("Failed to include r. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
         s = json_object_get_string(testobj, "s");
         if (!s) {
             ACVP_LOG_ERR("Failed to include s. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
         y = json_object_get_string(testobj, "y");
         if (!y) {
             ACVP_LOG_ERR("Failed to include y. ");
-            return ACVP_MISSING_ARG;
+            rv = ACVP_MISSING_ARG;
+            goto err;
         }
 
         ACVP_LOG_VERBOSE("       Test case: %d", j);
@@ -1391,14 +1574,23 @@ static ACVP_RESULT acvp_dsa_sigver_handler(ACVP_CTX *ctx,
          * Setup the test case data that will be passed down to
          * the crypto module.
          */
-        rv = acvp_dsa_sigver_init_tc(ctx, stc, l, n, sha, p, q, g, r, s, y, msg);
+        rv = acvp_dsa_sigver_init_tc(ctx, cur, l, n, sha, p, q, g, r, s, y, msg,
+                                     acvp_bn_limbs_enabled(cap));
         if (rv != ACVP_SUCCESS) {
-            acvp_dsa_release_tc(stc);
-            return rv;
+            acvp_dsa_release_tc(cur);
+            goto err;
+        }
+
+        if (use_batch) {
+            mval = json_value_init_object();
+            json_object_set_number(json_value_get_object(mval), "tcId", tc_id);
+            /* Verified with the rest of the group below */
+            acvp_tc_batch_add(&batch, mval)->tc.dsa = cur;
+            continue;
         }
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
             ACVP_LOG_ERR("crypto module failed the operation");
             acvp_dsa_release_tc(stc);
             return ACVP_CRYPTO_MODULE_FAIL;
@@ -1421,8 +1613,14 @@ static ACVP_RESULT acvp_dsa_sigver_handler(ACVP_CTX *ctx,
         /* Append the test response value to array */
         json_array_append_value(r_tarr, mval);
     }
+    if (use_batch) {
+        rv = acvp_dsa_run_batch(ctx, cap, &batch, r_tarr);
+    }
     /* Append the test response value to array */
     json_array_append_value(r_tarr, r_tval);
+
+err:
+    acvp_dsa_release_batch(&stcs, &batch);
     return rv;
 }
 
@@ -1442,7 +1640,6 @@ static ACVP_RESULT acvp_dsa_pqgver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
     unsigned int g_cnt, i;
 
     if (!alg_str) {
@@ -1478,7 +1675,7 @@ static ACVP_RESULT acvp_dsa_pqgver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1505,15 +1702,15 @@ static ACVP_RESULT acvp_dsa_pqgver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         stc.mode = ACVP_DSA_MODE_PQGVER;
 
@@ -1528,16 +1725,7 @@ static ACVP_RESULT acvp_dsa_pqgver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     }
     memzero_s(&stc, sizeof(ACVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    if (!json_result) {
-        ACVP_LOG_ERR("JSON unable to be serialized");
-        rv = ACVP_JSON_ERR;
-        goto err;
-    }
-
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1564,7 +1752,6 @@ static ACVP_RESULT acvp_dsa_pqggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
     unsigned int g_cnt, i;
 
     if (!alg_str) {
@@ -1600,7 +1787,7 @@ static ACVP_RESULT acvp_dsa_pqggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1626,21 +1813,21 @@ static ACVP_RESULT acvp_dsa_pqggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         stc.mode = ACVP_DSA_MODE_PQGGEN;
 
         ACVP_LOG_VERBOSE("    Test group: %d", i);
 
-        rv = acvp_dsa_pqggen_handler(ctx, tc, cap, r_tarr, groupobj);
+        rv = acvp_dsa_pqggen_handler(ctx, tc, cap, r_tarr, groupobj, tgId);
         if (rv != ACVP_SUCCESS) {
             goto err;
         }
@@ -1650,9 +1837,7 @@ static ACVP_RESULT acvp_dsa_pqggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(ACVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1679,7 +1864,6 @@ static ACVP_RESULT acvp_dsa_siggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
     unsigned int g_cnt, i;
 
     if (!alg_str) {
@@ -1715,7 +1899,7 @@ static ACVP_RESULT acvp_dsa_siggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1741,15 +1925,15 @@ static ACVP_RESULT acvp_dsa_siggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         stc.mode = ACVP_DSA_MODE_SIGGEN;
 
@@ -1766,10 +1950,7 @@ static ACVP_RESULT acvp_dsa_siggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(ACVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1796,7 +1977,6 @@ static ACVP_RESULT acvp_dsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
     unsigned int g_cnt, i;
 
     if (!alg_str) {
@@ -1832,7 +2012,7 @@ static ACVP_RESULT acvp_dsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1858,15 +2038,15 @@ static ACVP_RESULT acvp_dsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         stc.mode = ACVP_DSA_MODE_KEYGEN;
 
@@ -1882,10 +2062,7 @@ static ACVP_RESULT acvp_dsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(ACVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1912,7 +2089,6 @@ static ACVP_RESULT acvp_dsa_sigver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
     unsigned int g_cnt, i;
 
     if (!alg_str) {
@@ -1948,7 +2124,7 @@ static ACVP_RESULT acvp_dsa_sigver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1974,15 +2150,15 @@ static ACVP_RESULT acvp_dsa_sigver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         stc.mode = ACVP_DSA_MODE_SIGVER;
 
@@ -1998,15 +2174,7 @@ static ACVP_RESULT acvp_dsa_sigver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(ACVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    if (!json_result) {
-        ACVP_LOG_ERR("JSON unable to be serialized");
-        rv = ACVP_JSON_ERR;
-        goto err;
-    }
-
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -0,0 +1,534 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Tunnels the test cases of a batch to a remote device under test over a
+ * byte stream the application provides, such as a UART or a TCP socket,
+ * see acvp_cap_set_dut_handler(). Each test case goes out as one frame
+ * holding its scalars and input buffers; up to a window of them are sent
+ * before the first answer is read, so the link is kept busy instead of
+ * waiting out a round trip per test case. Answers carry the tag of their
+ * test case and may come back in any order; the results are still written
+ * in test case order.
+ *
+ * All integers on the wire are little endian. A request is
+ *
+ *     u32 length of the rest of the frame
+ *     u32 tag
+ *     u8  kind: 1 AES, 2 hash, 3 HMAC
+ *     u32 each scalar of the kind, in the order of the tables below
+ *     u32 length and the bytes of each input buffer, in the order of
+ *         acvp_tc_layout.c
+ *
+ * and a response
+ *
+ *     u32 length of the rest of the frame
+ *     u32 tag of the request
+ *     u8  what the crypto handler returned, 0 for success
+ *     u32 each scalar of the kind, as the crypto handler left it
+ *     u32 length and the bytes of each output buffer
+ *
+ * A buffer that is both input and output is sent both ways.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+/* The unsigned int and enum members of the test case structs sent as scalars */
+static const size_t acvp_dut_sym_scalars[] = {
+    offsetof(ACVP_SYM_CIPHER_TC, cipher),
+    offsetof(ACVP_SYM_CIPHER_TC, conformance),
+    offsetof(ACVP_SYM_CIPHER_TC, test_type),
+    offsetof(ACVP_SYM_CIPHER_TC, direction),
+    offsetof(ACVP_SYM_CIPHER_TC, ivgen_source),
+    offsetof(ACVP_SYM_CIPHER_TC, ivgen_mode),
+    offsetof(ACVP_SYM_CIPHER_TC, salt_source),
+    offsetof(ACVP_SYM_CIPHER_TC, tc_id),
+    offsetof(ACVP_SYM_CIPHER_TC, kwcipher),
+    offsetof(ACVP_SYM_CIPHER_TC, tw_mode),
+    offsetof(ACVP_SYM_CIPHER_TC, seq_num),
+    offsetof(ACVP_SYM_CIPHER_TC, key_len),
+    offsetof(ACVP_SYM_CIPHER_TC, pt_len),
+    offsetof(ACVP_SYM_CIPHER_TC, data_len),
+    offsetof(ACVP_SYM_CIPHER_TC, aad_len),
+    offsetof(ACVP_SYM_CIPHER_TC, iv_len),
+    offsetof(ACVP_SYM_CIPHER_TC, ct_len),
+    offsetof(ACVP_SYM_CIPHER_TC, tag_len),
+    offsetof(ACVP_SYM_CIPHER_TC, salt_len),
+    offsetof(ACVP_SYM_CIPHER_TC, incr_ctr),
+    offsetof(ACVP_SYM_CIPHER_TC, ovrflw_ctr),
+    offsetof(ACVP_SYM_CIPHER_TC, keyingOption),
+    offsetof(ACVP_SYM_CIPHER_TC, data_unit_len)
+};
+
+static const size_t acvp_dut_hash_scalars[] = {
+    offsetof(ACVP_HASH_TC, cipher),
+    offsetof(ACVP_HASH_TC, tc_id),
+    offsetof(ACVP_HASH_TC, test_type),
+    offsetof(ACVP_HASH_TC, msg_len),
+    offsetof(ACVP_HASH_TC, xof_len),
+    offsetof(ACVP_HASH_TC, xof_bit_len),
+    offsetof(ACVP_HASH_TC, md_len)
+};
+
+static const size_t acvp_dut_hmac_scalars[] = {
+    offsetof(ACVP_HMAC_TC, cipher),
+    offsetof(ACVP_HMAC_TC, tc_id),
+    offsetof(ACVP_HMAC_TC, msg_len),
+    offsetof(ACVP_HMAC_TC, mac_len),
+    offsetof(ACVP_HMAC_TC, key_len),
+    offsetof(ACVP_HMAC_TC, key_id)
+};
+
+#define ACVP_DUT_SCALAR_CNT(scalars) ((int)(sizeof(scalars) / sizeof(size_t)))
+#define ACVP_DUT_HDR_LEN 9 /* Length, tag and kind or result */
+/* Room for whichever test case struct acvp_dut_serve() decodes into */
+#define ACVP_DUT_TC_ROOM (sizeof(ACVP_SYM_CIPHER_TC) + sizeof(ACVP_HASH_TC) + sizeof(ACVP_HMAC_TC))
+
+struct acvp_dut_t {
+    int (*send_cb)(void *arg, const unsigned char *buf, unsigned int len);
+    int (*recv_cb)(void *arg, unsigned char *buf, unsigned int len);
+    void *arg;
+    ACVP_MUTEX lock;     /* Held for a whole batch, one batch is on the link at a time */
+    int broken;          /* The link failed mid frame and can not be used again */
+    unsigned char *frame;
+    size_t frame_max;
+    char *scratch;       /* The test case acvp_dut_serve() decodes into */
+};
+
+/* Writes to or reads from a frame, err being set once it runs out of room */
+typedef struct acvp_dut_cursor_t {
+    unsigned char *buf;
+    size_t pos;
+    size_t max;
+    int err;
+} ACVP_DUT_CURSOR;
+
+static void acvp_dut_kind_scalars(int kind, const size_t **scalars, int *cnt) {
+    switch (kind) {
+    case ACVP_TC_KIND_SYM:
+        *scalars = acvp_dut_sym_scalars;
+        *cnt = ACVP_DUT_SCALAR_CNT(acvp_dut_sym_scalars);
+        break;
+    case ACVP_TC_KIND_HASH:
+        *scalars = acvp_dut_hash_scalars;
+        *cnt = ACVP_DUT_SCALAR_CNT(acvp_dut_hash_scalars);
+        break;
+    case ACVP_TC_KIND_HMAC:
+        *scalars = acvp_dut_hmac_scalars;
+        *cnt = ACVP_DUT_SCALAR_CNT(acvp_dut_hmac_scalars);
+        break;
+    default:
+        *scalars = NULL;
+        *cnt = 0;
+        break;
+    }
+}
+
+static void acvp_dut_put_u32(ACVP_DUT_CURSOR *c, unsigned int v) {
+    if (c->err || c->max - c->pos < 4) {
+        c->err = 1;
+        return;
+    }
+    c->buf[c->pos++] = v & 0xff;
+    c->buf[c->pos++] = (v >> 8) & 0xff;
+    c->buf[c->pos++] = (v >> 16) & 0xff;
+    c->buf[c->pos++] = (v >> 24) & 0xff;
+}
+
+static unsigned int acvp_dut_get_u32(ACVP_DUT_CURSOR *c) {
+    unsigned int v = 0;
+
+    if (c->err || c->max - c->pos < 4) {
+        c->err = 1;
+        return 0;
+    }
+    v = (unsigned int)c->buf[c->pos] | ((unsigned int)c->buf[c->pos + 1] << 8) |
+        ((unsigned int)c->buf[c->pos + 2] << 16) | ((unsigned int)c->buf[c->pos + 3] << 24);
+    c->pos += 4;
+    return v;
+}
+
+static void acvp_dut_put_buf(ACVP_DUT_CURSOR *c, const unsigned char *buf, size_t len) {
+    acvp_dut_put_u32(c, (unsigned int)len);
+    if (c->err || c->max - c->pos < len) {
+        c->err = 1;
+        return;
+    }
+    if (len) memcpy_s(c->buf + c->pos, c->max - c->pos, buf, len);
+    c->pos += len;
+}
+
+/* Copies a buffer of up to cap bytes from the frame to buf, NULL to skip it */
+static size_t acvp_dut_get_buf(ACVP_DUT_CURSOR *c, unsigned char *buf, size_t cap) {
+    size_t len = acvp_dut_get_u32(c);
+
+    if (c->err || len > cap || c->max - c->pos < len) {
+        c->err = 1;
+        return 0;
+    }
+    if (buf && len) memcpy_s(buf, cap, c->buf + c->pos, len);
+    c->pos += len;
+    return len;
+}
+
+/* Starts a frame, leaving room for its length */
+static void acvp_dut_begin(ACVP_DUT *dut, ACVP_DUT_CURSOR *c, unsigned int tag, int byte) {
+    c->buf = dut->frame;
+    c->max = dut->frame_max;
+    c->pos = 4;
+    c->err = 0;
+    acvp_dut_put_u32(c, tag);
+    c->buf[c->pos++] = (unsigned char)byte;
+}
+
+static int acvp_dut_send(ACVP_DUT *dut, ACVP_DUT_CURSOR *c) {
+    ACVP_DUT_CURSOR hdr = { c->buf, 0, 4, 0 };
+
+    acvp_dut_put_u32(&hdr, (unsigned int)(c->pos - 4));
+    return (dut->send_cb)(dut->arg, c->buf, (unsigned int)c->pos);
+}
+
+/* Reads a whole frame into dut->frame, c being left on its tag */
+static int acvp_dut_recv(ACVP_DUT *dut, ACVP_DUT_CURSOR *c, int *eof) {
+    size_t len = 0;
+
+    c->buf = dut->frame;
+    c->pos = 0;
+    c->max = 4;
+    c->err = 0;
+    if ((dut->recv_cb)(dut->arg, dut->frame, 4)) {
+        if (eof) *eof = 1;
+        return 1;
+    }
+    len = acvp_dut_get_u32(c);
+    if (len < ACVP_DUT_HDR_LEN - 4 || len > dut->frame_max - 4 ||
+            (dut->recv_cb)(dut->arg, dut->frame + 4, (unsigned int)len)) {
+        return 1;
+    }
+    c->max = len + 4;
+    return 0;
+}
+
+/* The largest frame either side sends, for a test case of kind */
+static size_t acvp_dut_kind_frame(int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    const size_t *scalars = NULL;
+    size_t size = ACVP_DUT_HDR_LEN;
+    int cnt = 0, i = 0;
+
+    acvp_dut_kind_scalars(kind, &scalars, &cnt);
+    size += (size_t)cnt * 4;
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        if (fields[i].dir) size += 4 + fields[i].cap;
+    }
+    return size;
+}
+
+ACVP_RESULT acvp_dut_create(int (*send_cb)(void *arg, const unsigned char *buf, unsigned int len),
+                            int (*recv_cb)(void *arg, unsigned char *buf, unsigned int len),
+                            void *arg,
+                            ACVP_DUT **dut) {
+    ACVP_DUT *d = NULL;
+    size_t size = 0;
+    int kind = 0;
+
+    if (!send_cb || !recv_cb || !dut) {
+        return ACVP_MISSING_ARG;
+    }
+
+    d = calloc(1, sizeof(ACVP_DUT));
+    if (!d) {
+        return ACVP_MALLOC_FAIL;
+    }
+    for (kind = ACVP_TC_KIND_SYM; kind <= ACVP_TC_KIND_HMAC; kind++) {
+        size = acvp_dut_kind_frame(kind);
+        if (size > d->frame_max) d->frame_max = size;
+    }
+    d->frame = calloc(1, d->frame_max);
+    if (!d->frame) {
+        free(d);
+        return ACVP_MALLOC_FAIL;
+    }
+    d->send_cb = send_cb;
+    d->recv_cb = recv_cb;
+    d->arg = arg;
+    acvp_mutex_init(&d->lock);
+    *dut = d;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_dut_free(ACVP_DUT *dut) {
+    if (!dut) {
+        return ACVP_MISSING_ARG;
+    }
+    acvp_mutex_destroy(&dut->lock);
+    free(dut->frame);
+    if (dut->scratch) free(dut->scratch);
+    free(dut);
+    return ACVP_SUCCESS;
+}
+
+static void acvp_dut_put_scalars(ACVP_DUT_CURSOR *c, char *stc, int kind) {
+    const size_t *scalars = NULL;
+    unsigned int v = 0;
+    int cnt = 0, i = 0;
+
+    acvp_dut_kind_scalars(kind, &scalars, &cnt);
+    for (i = 0; i < cnt; i++) {
+        memcpy_s(&v, sizeof(v), stc + scalars[i], sizeof(unsigned int));
+        acvp_dut_put_u32(c, v);
+    }
+}
+
+static void acvp_dut_get_scalars(ACVP_DUT_CURSOR *c, char *stc, int kind) {
+    const size_t *scalars = NULL;
+    unsigned int v = 0;
+    int cnt = 0, i = 0;
+
+    acvp_dut_kind_scalars(kind, &scalars, &cnt);
+    for (i = 0; i < cnt; i++) {
+        v = acvp_dut_get_u32(c);
+        memcpy_s(stc + scalars[i], sizeof(unsigned int), &v, sizeof(v));
+    }
+}
+
+/*
+ * Sends test case k of the batch. Returns 1 if it does not fit in a frame,
+ * -1 if the link failed.
+ */
+static int acvp_dut_send_tc(ACVP_DUT *dut, ACVP_TC_BATCH *batch, int k, int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    ACVP_DUT_CURSOR c;
+    char *stc = acvp_tc_layout_struct(&batch->tcs[k], kind);
+    size_t len = 0;
+    int cnt = 0, i = 0;
+
+    acvp_dut_begin(dut, &c, (unsigned int)k, kind);
+    acvp_dut_put_scalars(&c, stc, kind);
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        if (!(fields[i].dir & ACVP_TC_FIELD_IN)) {
+            continue;
+        }
+        len = acvp_tc_layout_len(stc, &fields[i]);
+        if (len > fields[i].cap || (len && !*acvp_tc_layout_ptr(stc, &fields[i]))) {
+            return 1;
+        }
+        acvp_dut_put_buf(&c, *acvp_tc_layout_ptr(stc, &fields[i]), len);
+    }
+    if (c.err) {
+        return 1;
+    }
+    return acvp_dut_send(dut, &c) ? -1 : 0;
+}
+
+/*
+ * Reads the next answer and copies it back into its test case of the
+ * batch. Returns the index of the test case, -1 if the link failed or the
+ * answer was not for a test case in flight.
+ */
+static int acvp_dut_recv_tc(ACVP_DUT *dut, ACVP_TC_BATCH *batch, char *in_flight, int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    ACVP_DUT_CURSOR c;
+    char *stc = NULL;
+    unsigned int k = 0;
+    int result = 0, cnt = 0, i = 0;
+
+    if (acvp_dut_recv(dut, &c, NULL)) {
+        return -1;
+    }
+    k = acvp_dut_get_u32(&c);
+    if (c.err || k >= (unsigned int)batch->count || !in_flight[k]) {
+        return -1;
+    }
+    result = c.buf[c.pos++];
+    stc = acvp_tc_layout_struct(&batch->tcs[k], kind);
+    acvp_dut_get_scalars(&c, stc, kind);
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        if (fields[i].dir & ACVP_TC_FIELD_OUT) {
+            acvp_dut_get_buf(&c, *acvp_tc_layout_ptr(stc, &fields[i]), fields[i].cap);
+        }
+    }
+    if (c.err) {
+        return -1;
+    }
+    in_flight[k] = 0;
+    batch->results[k] = result;
+    return (int)k;
+}
+
+/*
+ * Runs the test cases of the batch on the device, keeping up to dut_window
+ * of them on the link at once, and returns once every one has been
+ * answered. The batches of other workers wait for the link.
+ */
+ACVP_RESULT acvp_dut_run_batch(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_DUT *dut = cap->dut;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    char *in_flight = NULL;
+    int kind = 0, next = 0, sent = 0, answered = 0, i = 0, k = 0, ret = 0;
+
+    kind = acvp_tc_layout_kind(cap);
+    if (!kind) {
+        return ACVP_UNSUPPORTED_OP;
+    }
+    in_flight = calloc(batch->count, sizeof(char));
+    if (!in_flight) {
+        return ACVP_MALLOC_FAIL;
+    }
+
+    /* What can not be sent is left for the crypto handler */
+    for (i = 0; i < batch->count; i++) {
+        if (!acvp_tc_layout_carries(&batch->tcs[i], kind)) {
+            batch->results[i] = (cap->crypto_handler)(&batch->tcs[i]);
+        }
+    }
+
+    acvp_mutex_lock(&dut->lock);
+    if (dut->broken) {
+        ACVP_LOG_ERR("The link to the device under test has failed before");
+        rv = ACVP_TRANSPORT_FAIL;
+        goto end;
+    }
+    ACVP_LOG_VERBOSE("Sending %d test cases to the device under test, up to %d at a time",
+                     batch->count, cap->dut_window);
+    for (;;) {
+        /* Keep the window full, then take answers as they come */
+        while (next < batch->count && rv == ACVP_SUCCESS && sent - answered < cap->dut_window) {
+            k = batch->order ? batch->order[next] : next;
+            next++;
+            if (!acvp_tc_layout_carries(&batch->tcs[k], kind)) {
+                continue;
+            }
+            ret = acvp_dut_send_tc(dut, batch, k, kind);
+            if (ret < 0) {
+                ACVP_LOG_ERR("Unable to send test case %d to the device under test", k);
+                dut->broken = 1;
+                rv = ACVP_TRANSPORT_FAIL;
+                goto end;
+            }
+            if (ret > 0) {
+                ACVP_LOG_ERR("Test case %d does not fit in a frame to the device under test", k);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                break;
+            }
+            in_flight[k] = 1;
+            sent++;
+        }
+        if (answered == sent) {
+            break;
+        }
+        if (acvp_dut_recv_tc(dut, batch, in_flight, kind) < 0) {
+            ACVP_LOG_ERR("Lost the link to the device under test with %d test cases in flight",
+                         sent - answered);
+            dut->broken = 1;
+            rv = ACVP_TRANSPORT_FAIL;
+            goto end;
+        }
+        answered++;
+    }
+
+end:
+    acvp_mutex_unlock(&dut->lock);
+    free(in_flight);
+    return rv;
+}
+
+/*
+ * Sets up the scratch test case of acvp_dut_serve() for a request of kind:
+ * the carried buffers point at their regions of the scratch, the rest are
+ * NULL
+ */
+static char *acvp_dut_scratch(ACVP_DUT *dut, int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    unsigned char *buf = NULL;
+    char *stc = dut->scratch;
+    int cnt = 0, i = 0;
+
+    memzero_s(stc, ACVP_DUT_TC_ROOM);
+    buf = (unsigned char *)stc + ACVP_DUT_TC_ROOM;
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        if (fields[i].dir) {
+            *acvp_tc_layout_ptr(stc, &fields[i]) = buf;
+            buf += fields[i].cap;
+        }
+    }
+    return stc;
+}
+
+ACVP_RESULT acvp_dut_serve(ACVP_DUT *dut, int (*crypto_handler)(ACVP_TEST_CASE *test_case)) {
+    const ACVP_TC_FIELD *fields = NULL;
+    ACVP_DUT_CURSOR c;
+    ACVP_TEST_CASE tc;
+    unsigned int tag = 0;
+    size_t len = 0;
+    char *stc = NULL;
+    int kind = 0, result = 0, cnt = 0, i = 0, eof = 0;
+
+    if (!dut || !crypto_handler) {
+        return ACVP_MISSING_ARG;
+    }
+    if (!dut->scratch) {
+        /* The struct, then room for the buffers of the largest frame */
+        dut->scratch = calloc(1, ACVP_DUT_TC_ROOM + dut->frame_max);
+        if (!dut->scratch) {
+            return ACVP_MALLOC_FAIL;
+        }
+    }
+
+    for (;;) {
+        if (acvp_dut_recv(dut, &c, &eof)) {
+            /* The other side closing the link between frames is the end */
+            return eof ? ACVP_SUCCESS : ACVP_TRANSPORT_FAIL;
+        }
+        tag = acvp_dut_get_u32(&c);
+        kind = c.buf[c.pos++];
+        if (kind < ACVP_TC_KIND_SYM || kind > ACVP_TC_KIND_HMAC) {
+            return ACVP_TRANSPORT_FAIL;
+        }
+        stc = acvp_dut_scratch(dut, kind);
+        acvp_dut_get_scalars(&c, stc, kind);
+        acvp_tc_layout_fields(kind, &fields, &cnt);
+        for (i = 0; i < cnt; i++) {
+            if (fields[i].dir & ACVP_TC_FIELD_IN) {
+                acvp_dut_get_buf(&c, *acvp_tc_layout_ptr(stc, &fields[i]), fields[i].cap);
+            }
+        }
+        if (c.err) {
+            return ACVP_TRANSPORT_FAIL;
+        }
+
+        tc = acvp_tc_layout_wrap(stc, kind);
+        result = (crypto_handler)(&tc) ? 1 : 0;
+
+        acvp_dut_begin(dut, &c, tag, result);
+        acvp_dut_put_scalars(&c, stc, kind);
+        for (i = 0; i < cnt; i++) {
+            if (fields[i].dir & ACVP_TC_FIELD_OUT) {
+                len = acvp_tc_layout_len(stc, &fields[i]);
+                if (len > fields[i].cap) len = fields[i].cap;
+                acvp_dut_put_buf(&c, *acvp_tc_layout_ptr(stc, &fields[i]), len);
+            }
+        }
+        if (c.err || acvp_dut_send(dut, &c)) {
+            return ACVP_TRANSPORT_FAIL;
+        }
+    }
+}
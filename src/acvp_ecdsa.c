@@ -19,6 +19,13 @@
 
 static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *obj, ACVP_CIPHER cipher);
 
+static ACVP_RESULT acvp_ecdsa_run_batch(ACVP_CTX *ctx,
+                                       ACVP_CAPS_LIST *cap,
+                                       ACVP_CIPHER cipher,
+                                       ACVP_TC_BATCH *batch,
+                                       JSON_Array *r_tarr);
+
+static void acvp_ecdsa_release_batch(ACVP_ECDSA_TC **stcs, ACVP_TC_BATCH *batch);
 
 /*
  * After the test case has been processed by the DUT, the results
@@ -28,58 +35,44 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
  */
 static ACVP_RESULT acvp_ecdsa_output_tc(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_ECDSA_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_ECDSA_EXP_LEN_MAX + 1, sizeof(char));
 
     if (cipher == ACVP_ECDSA_KEYGEN) {
-        rv = acvp_bin_to_hexstr(stc->qy, stc->qy_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "qy", stc->qy, stc->qy_len, ACVP_ECDSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (qy)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "qy", (const char *)tmp);
-        memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->qx, stc->qx_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "qx", stc->qx, stc->qx_len, ACVP_ECDSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (qx)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "qx", (const char *)tmp);
-        memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->d, stc->d_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "d", stc->d, stc->d_len, ACVP_ECDSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (d)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "d", (const char *)tmp);
-        memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
     }
     if (cipher == ACVP_ECDSA_KEYVER || cipher == ACVP_ECDSA_SIGVER) {
         json_object_set_boolean(tc_rsp, "testPassed", stc->ver_disposition);
     }
     if (cipher == ACVP_ECDSA_SIGGEN || cipher == ACVP_DET_ECDSA_SIGGEN) {
-        rv = acvp_bin_to_hexstr(stc->r, stc->r_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "r", stc->r, stc->r_len, ACVP_ECDSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (r)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "r", (const char *)tmp);
-        memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->s, stc->s_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "s", stc->s, stc->s_len, ACVP_ECDSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (s)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "s", (const char *)tmp);
-        memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
     }
 
 err:
-    free(tmp);
     return ACVP_SUCCESS;
 }
 
@@ -213,7 +206,7 @@ ACVP_RESULT acvp_ecdsa_sigver_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     return acvp_ecdsa_kat_handler_internal(ctx, obj, ACVP_ECDSA_SIGVER);
 }
 
-static ACVP_ECDSA_SECRET_GEN_MODE read_secret_gen_mode(const char *str) {
+ACVP_ECDSA_SECRET_GEN_MODE acvp_ecdsa_read_secret_gen_mode(const char *str) {
     int diff = 1;
 
     strcmp_s(ACVP_ECDSA_EXTRA_BITS_STR,
@@ -251,12 +244,14 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_ECDSA_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_ECDSA_TC stc, group_stc;
+    ACVP_ECDSA_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TEST_CASE tc, group_tc;
+    ACVP_TC_BATCH batch;
     ACVP_RESULT rv;
+    int group_open = 0, use_batch = 0;
 
     ACVP_CIPHER alg_id;
-    char *json_result = NULL;
     const char *alg_str, *mode_str, *qx = NULL, *qy = NULL, *r = NULL, *s = NULL, *message = NULL;
 
     if (!ctx) {
@@ -272,6 +267,8 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
 
     memzero_s(&stc, sizeof(ACVP_ECDSA_TC));
     tc.tc.ecdsa = &stc;
+    group_tc.tc.ecdsa = &group_stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
     mode_str = json_object_get_string(obj, "mode");
     if (!mode_str) {
         ACVP_LOG_ERR("Server JSON missing 'mode_str'");
@@ -303,7 +300,7 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -335,15 +332,15 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MISSING_ARG;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         /*
          * Get a reference to the abstracted test case
@@ -370,7 +367,7 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
                 goto err;
             }
 
-            secret_gen_mode = read_secret_gen_mode(secret_gen_mode_str);
+            secret_gen_mode = acvp_ecdsa_read_secret_gen_mode(secret_gen_mode_str);
             if (!secret_gen_mode) {
                 ACVP_LOG_ERR("Server JSON invalid 'secretGenerationMode'");
                 rv = ACVP_INVALID_ARG;
@@ -407,11 +404,49 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
             goto err;
         }
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_ECDSA_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = alg_id;
+            group_stc.tg_id = tgId;
+            group_stc.curve = curve;
+            group_stc.secret_gen_mode = secret_gen_mode;
+            group_stc.hash_alg = hash_alg;
+            group_stc.is_component = is_component;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * KeyVer and SigVer test cases are independent of each other, so
+         * the group can be set up in one piece and then verified together.
+         * Each test case keeps its own buffers.
+         */
+        use_batch = (alg_id == ACVP_ECDSA_KEYVER || alg_id == ACVP_ECDSA_SIGVER) &&
+                    acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_ECDSA_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new ECDSA test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             if (alg_id == ACVP_ECDSA_KEYVER || alg_id == ACVP_ECDSA_SIGVER) {
                 qx = json_object_get_string(testobj, "qx");
@@ -468,11 +503,26 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
-            rv = acvp_ecdsa_init_tc(ctx, alg_id, is_component, &stc, tgId, tc_id, curve, secret_gen_mode, hash_alg, qx, qy, message, r, s);
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_ecdsa_init_tc(ctx, alg_id, is_component, cur, tgId, tc_id, curve, secret_gen_mode, hash_alg, qx, qy, message, r, s);
+            cur->tg_ctx = group_stc.tg_ctx;
 
-            /* Process the current test vector... */
+            if (use_batch) {
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to initialize ECDSA test case");
+                    acvp_ecdsa_release_tc(cur);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                /* Verified with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.ecdsa = cur;
+                continue;
+            }
+
+            /* Process the current test vector, KeyGen ones from the key pool if there is one */
             if (rv == ACVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (!(alg_id == ACVP_ECDSA_KEYGEN && acvp_key_pool_take(ctx, cap, curve, secret_gen_mode, &tc)) &&
+                        acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -488,27 +538,19 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
              * Output the test case results using JSON
              */
             if (cipher == ACVP_ECDSA_SIGGEN || cipher == ACVP_DET_ECDSA_SIGGEN) {
-                char *tmp = calloc(ACVP_ECDSA_EXP_LEN_MAX + 1, sizeof(char));
-                rv = acvp_bin_to_hexstr(stc.qy, stc.qy_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+                rv = acvp_json_set_hex(r_gobj, "qy", stc.qy, stc.qy_len, ACVP_ECDSA_EXP_LEN_MAX);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("hex conversion failure (qy)");
-                    free(tmp);
                     json_value_free(r_tval);
                     goto err;
                 }
-                json_object_set_string(r_gobj, "qy", (const char *)tmp);
-                memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
 
-                rv = acvp_bin_to_hexstr(stc.qx, stc.qx_len, tmp, ACVP_ECDSA_EXP_LEN_MAX);
+                rv = acvp_json_set_hex(r_gobj, "qx", stc.qx, stc.qx_len, ACVP_ECDSA_EXP_LEN_MAX);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("hex conversion failure (qx)");
-                    free(tmp);
                     json_value_free(r_tval);
                     goto err;
                 }
-                json_object_set_string(r_gobj, "qx", (const char *)tmp);
-                memzero_s(tmp, ACVP_ECDSA_EXP_LEN_MAX);
-                free(tmp);
             }
             rv = acvp_ecdsa_output_tc(ctx, alg_id, &stc, r_tobj);
             if (rv != ACVP_SUCCESS) {
@@ -525,20 +567,87 @@ static ACVP_RESULT acvp_ecdsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
              */
             acvp_ecdsa_release_tc(&stc);
         }
+        if (use_batch) {
+            rv = acvp_ecdsa_run_batch(ctx, cap, alg_id, &batch, r_tarr);
+            acvp_ecdsa_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_ecdsa_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         acvp_ecdsa_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_ecdsa_run_batch(ACVP_CTX *ctx,
+                                       ACVP_CAPS_LIST *cap,
+                                       ACVP_CIPHER cipher,
+                                       ACVP_TC_BATCH *batch,
+                                       JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_ecdsa_output_tc(ctx, cipher, batch->tcs[i].tc.ecdsa, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in ECDSA module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_ecdsa_release_batch(ACVP_ECDSA_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_ecdsa_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
@@ -19,6 +19,13 @@
 
 static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *obj, ACVP_CIPHER cipher);
 
+static ACVP_RESULT acvp_eddsa_run_batch(ACVP_CTX *ctx,
+                                        ACVP_CAPS_LIST *cap,
+                                        ACVP_TC_BATCH *batch,
+                                        JSON_Array *r_tarr);
+
+static void acvp_eddsa_release_batch(ACVP_EDDSA_TC **stcs, ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -27,47 +34,35 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
  */
 static ACVP_RESULT acvp_eddsa_output_tc(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_EDDSA_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
     if (cipher == ACVP_EDDSA_SIGVER || cipher == ACVP_EDDSA_KEYVER) {
         json_object_set_boolean(tc_rsp, "testPassed", stc->ver_disposition);
     } else {
-        tmp = calloc(ACVP_EDDSA_MSG_LEN_MAX + 1, sizeof(char));
-        if (!tmp) {
-            return ACVP_MALLOC_FAIL;
-        }
     }
 
     if (cipher == ACVP_EDDSA_KEYGEN) {
-        rv = acvp_bin_to_hexstr(stc->d, stc->d_len, tmp, ACVP_EDDSA_MSG_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "d", stc->d, stc->d_len, ACVP_EDDSA_MSG_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (d)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "d", (const char *)tmp);
-        memzero_s(tmp, ACVP_EDDSA_MSG_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->q, stc->q_len, tmp, ACVP_EDDSA_MSG_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "q", stc->q, stc->q_len, ACVP_EDDSA_MSG_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (q)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "q", (const char *)tmp);
-        memzero_s(tmp, ACVP_EDDSA_MSG_LEN_MAX);
     }
 
     if (cipher == ACVP_EDDSA_SIGGEN) {
-        rv = acvp_bin_to_hexstr(stc->signature, stc->signature_len, tmp, ACVP_EDDSA_MSG_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "signature", stc->signature, stc->signature_len, ACVP_EDDSA_MSG_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (signature)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "signature", (const char *)tmp);
-        memzero_s(tmp, ACVP_EDDSA_MSG_LEN_MAX);
     }
 
 err:
-    if (tmp) free(tmp);
     return rv;
 }
 
@@ -216,13 +211,15 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_EDDSA_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_EDDSA_TC stc, group_stc;
+    ACVP_EDDSA_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TEST_CASE tc, group_tc;
+    ACVP_TC_BATCH batch;
     ACVP_RESULT rv;
+    int group_open = 0, use_batch = 0;
 
     ACVP_CIPHER alg_id;
     ACVP_EDDSA_TESTTYPE test_type;
-    char *json_result = NULL;
     const char *alg_str, *mode_str, *q = NULL, *sig = NULL, *message = NULL, *context = NULL;
 
     if (!ctx) {
@@ -237,7 +234,9 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
     }
 
     memzero_s(&stc, sizeof(ACVP_EDDSA_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
     tc.tc.eddsa = &stc;
+    group_tc.tc.eddsa = &group_stc;
     mode_str = json_object_get_string(obj, "mode");
     if (!mode_str) {
         ACVP_LOG_ERR("Server JSON missing 'mode_str'");
@@ -269,7 +268,7 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -298,15 +297,15 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MISSING_ARG;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         curve_str = json_object_get_string(groupobj, "curve");
         if (!curve_str) {
@@ -359,11 +358,47 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
             goto err;
         }
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_EDDSA_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = alg_id;
+            group_stc.tg_id = tgId;
+            group_stc.curve = curve;
+            group_stc.use_prehash = use_prehash;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * SigVer test cases are independent of each other, so the group
+         * can be set up in one piece and then verified together, such as
+         * by a module doing Ed25519 batch verification. Each test case
+         * keeps its own buffers.
+         */
+        use_batch = alg_id == ACVP_EDDSA_SIGVER && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_EDDSA_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new EDDSA test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             if (alg_id == ACVP_EDDSA_KEYVER || alg_id == ACVP_EDDSA_SIGVER) {
                 q = json_object_get_string(testobj, "q");
@@ -437,11 +472,25 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
-            rv = acvp_eddsa_init_tc(ctx, alg_id, &stc, tgId, tc_id, use_prehash, curve, q, message, context, sig);
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_eddsa_init_tc(ctx, alg_id, cur, tgId, tc_id, use_prehash, curve, q, message, context, sig);
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to initialize EDDSA test case");
+                    acvp_eddsa_release_tc(cur);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                /* Verified with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.eddsa = cur;
+                continue;
+            }
 
             /* Process the current test vector... */
             if (rv == ACVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -455,22 +504,12 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
 
             /* Output the test case results using JSON. et "q" at the GROUP level for siggen */
             if (cipher == ACVP_EDDSA_SIGGEN) {
-                char *tmp = calloc(ACVP_EDDSA_POINT_LEN_MAX + 1, sizeof(char));
-                if (!tmp) {
-                    ACVP_LOG_ERR("Failed to allocate outbut buffer for 'q' in EDDSA siggen");
-                    json_value_free(r_tval);
-                    goto err;
-                }
-                rv = acvp_bin_to_hexstr(stc.q, stc.q_len, tmp, ACVP_EDDSA_POINT_LEN_MAX);
+                rv = acvp_json_set_hex(r_gobj, "q", stc.q, stc.q_len, ACVP_EDDSA_POINT_LEN_MAX);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("hex conversion failure (q)");
-                    free(tmp);
                     json_value_free(r_tval);
                     goto err;
                 }
-                json_object_set_string(r_gobj, "q", (const char *)tmp);
-                memzero_s(tmp, ACVP_EDDSA_POINT_LEN_MAX);
-                free(tmp);
             }
             rv = acvp_eddsa_output_tc(ctx, alg_id, &stc, r_tobj);
             if (rv != ACVP_SUCCESS) {
@@ -487,20 +526,87 @@ static ACVP_RESULT acvp_eddsa_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *o
              */
             acvp_eddsa_release_tc(&stc);
         }
+        if (use_batch) {
+            rv = acvp_eddsa_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_eddsa_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_eddsa_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         acvp_eddsa_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_eddsa_run_batch(ACVP_CTX *ctx,
+                                        ACVP_CAPS_LIST *cap,
+                                        ACVP_TC_BATCH *batch,
+                                        JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_eddsa_output_tc(ctx, cap->cipher, batch->tcs[i].tc.eddsa,
+                                  json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in EDDSA module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_eddsa_release_batch(ACVP_EDDSA_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_eddsa_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
@@ -34,9 +34,19 @@ static ACVP_RESULT acvp_hash_init_tc(ACVP_CTX *ctx,
                                      unsigned int xof_len,
                                      unsigned long long int exp_len,  // LDT expected data length
                                      ACVP_HASH_EXPANSION_METHOD exp_method,
-                                     ACVP_CIPHER alg_id);
+                                     ACVP_CIPHER alg_id,
+                                     int use_sink);
 
-static ACVP_RESULT acvp_hash_release_tc(ACVP_HASH_TC *stc);
+static ACVP_RESULT acvp_hash_release_tc(ACVP_CTX *ctx, ACVP_HASH_TC *stc);
+
+static ACVP_RESULT acvp_hash_run_batch(ACVP_CTX *ctx,
+                                       ACVP_CAPS_LIST *cap,
+                                       ACVP_TC_BATCH *batch,
+                                       JSON_Array *r_tarr);
+
+static void acvp_hash_release_batch(ACVP_CTX *ctx, ACVP_HASH_TC **stcs, ACVP_TC_BATCH *batch);
+
+static ACVP_RESULT acvp_hash_run_soa(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch);
 
 
 /*
@@ -63,36 +73,24 @@ static ACVP_RESULT acvp_hash_mct_iterate_tc(ACVP_HASH_TC *stc) {
  */
 static ACVP_RESULT acvp_hash_output_mct_tc(ACVP_CTX *ctx, ACVP_HASH_TC *stc, JSON_Object *r_tobj) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
+    int tmp_max = 0;
 
     if (stc->cipher == ACVP_HASH_SHAKE_128 || stc->cipher == ACVP_HASH_SHAKE_256) {
-        tmp = calloc(ACVP_HASH_XOF_MD_STR_MAX + 1, sizeof(char));
+        tmp_max = ACVP_HASH_XOF_MD_STR_MAX;
     } else {
-        tmp = calloc(ACVP_HASH_MD_STR_MAX + 1, sizeof(char));
-    }
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_hash_output_tc");
-        return ACVP_MALLOC_FAIL;
+        tmp_max = ACVP_HASH_MD_STR_MAX;
     }
 
-    if (stc->cipher == ACVP_HASH_SHAKE_128 || stc->cipher == ACVP_HASH_SHAKE_256) {
-        rv = acvp_bin_to_hexstr(stc->md, stc->md_len, tmp, ACVP_HASH_XOF_MD_STR_MAX);
-    } else {
-        rv = acvp_bin_to_hexstr(stc->md, stc->md_len, tmp, ACVP_HASH_MD_STR_MAX);
-    }
+    rv = acvp_json_set_hex(r_tobj, "md", stc->md, stc->md_len, tmp_max);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (md)");
         goto end;
     }
-
-    json_object_set_string(r_tobj, "md", tmp);
     if (stc->cipher == ACVP_HASH_SHAKE_128 || stc->cipher == ACVP_HASH_SHAKE_256) {
         json_object_set_number(r_tobj, "outLen", stc->md_len * 8);
     }
 
 end:
-    if (tmp) free(tmp);
-
     return rv;
 }
 
@@ -111,13 +109,6 @@ static ACVP_RESULT acvp_hash_mct_tc(ACVP_CTX *ctx,
     ACVP_RESULT rv;
     JSON_Value *r_tval = NULL;  /* Response testval */
     JSON_Object *r_tobj = NULL; /* Response testobj */
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_HASH_MSG_STR_MAX * 3, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     memcpy_s(stc->m1, ACVP_HASH_MD_BYTE_MAX, stc->msg, stc->msg_len);
     memcpy_s(stc->m2, ACVP_HASH_MD_BYTE_MAX, stc->msg, stc->msg_len);
@@ -132,10 +123,9 @@ static ACVP_RESULT acvp_hash_mct_tc(ACVP_CTX *ctx,
 
         for (j = 0; j < ACVP_HASH_MCT_INNER; ++j) {
             /* Process the current SHA test vector... */
-            rv = (cap->crypto_handler)(tc);
+            rv = acvp_crypto_call(ctx, cap->crypto_handler, tc);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("crypto module failed the operation");
-                free(tmp);
                 json_value_free(r_tval);
                 return ACVP_CRYPTO_MODULE_FAIL;
             }
@@ -146,7 +136,6 @@ static ACVP_RESULT acvp_hash_mct_tc(ACVP_CTX *ctx,
             rv = acvp_hash_mct_iterate_tc(stc);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Failed the MCT iteration changes");
-                free(tmp);
                 json_value_free(r_tval);
                 return rv;
             }
@@ -157,7 +146,6 @@ static ACVP_RESULT acvp_hash_mct_tc(ACVP_CTX *ctx,
         rv = acvp_hash_output_mct_tc(ctx, stc, r_tobj);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("JSON output failure in HASH module");
-            free(tmp);
             json_value_free(r_tval);
             return rv;
         }
@@ -170,7 +158,6 @@ static ACVP_RESULT acvp_hash_mct_tc(ACVP_CTX *ctx,
 
     }
 
-    free(tmp);
     return ACVP_SUCCESS;
 }
 
@@ -229,7 +216,7 @@ static ACVP_RESULT acvp_hash_sha3_mct(ACVP_CTX *ctx,
             memzero_s(stc->md, ACVP_HASH_MD_BYTE_MAX);
 
             /* Process the current SHA test vector... */
-            rv = (cap->crypto_handler)(tc);
+            rv = acvp_crypto_call(ctx, cap->crypto_handler, tc);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -333,7 +320,7 @@ static ACVP_RESULT acvp_hash_shake_mct(ACVP_CTX *ctx,
             memzero_s(stc->md, ACVP_HASH_XOF_MD_BYTE_MAX);
 
             /* Process the current SHA test vector... */
-            rv = (cap->crypto_handler)(tc);
+            rv = acvp_crypto_call(ctx, cap->crypto_handler, tc);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -372,6 +359,160 @@ end:
     return rv;
 }
 
+/*
+ * Monte Carlo test for a capability with an MCT handler: the crypto module
+ * runs each inner loop itself, see acvp_cap_hash_set_mct_handler(), and
+ * only the checkpoints come back here to be recorded and fed forward as
+ * the seed of the next one.
+ */
+static ACVP_RESULT acvp_hash_mct_handler_tc(ACVP_CTX *ctx,
+                                            ACVP_CAPS_LIST *cap,
+                                            ACVP_TEST_CASE *tc,
+                                            ACVP_HASH_TC *stc,
+                                            JSON_Array *res_array,
+                                            unsigned int min_xof_bits,
+                                            unsigned int max_xof_bits) {
+    int i = 0, shake = 0;
+    unsigned int leftmost_bytes = 16, msg_max = ACVP_HASH_MSG_BYTE_MAX;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *r_tval = NULL;  /* Response testval */
+    JSON_Object *r_tobj = NULL; /* Response testobj */
+
+    shake = stc->cipher == ACVP_HASH_SHAKE_128 || stc->cipher == ACVP_HASH_SHAKE_256;
+    if (shake) {
+        msg_max = ACVP_SHAKE_MSG_BYTE_MAX;
+        stc->xof_min_len = min_xof_bits / 8;
+        stc->xof_max_len = max_xof_bits / 8;
+        /* Initial Outputlen = (floor(maxoutlen/8) )*8 */
+        stc->xof_len = stc->xof_max_len;
+        stc->msg_len = leftmost_bytes;
+    }
+
+    for (i = 0; i < ACVP_HASH_MCT_OUTER; i++) {
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        r_tobj = json_value_get_object(r_tval);
+
+        memzero_s(stc->md, shake ? ACVP_HASH_XOF_MD_BYTE_MAX : ACVP_HASH_MD_BYTE_MAX);
+        if (acvp_crypto_call(ctx, cap->mct_handler, tc)) {
+            ACVP_LOG_ERR("crypto module failed the MCT operation");
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+        if (!stc->md_len || stc->md_len > (shake ? ACVP_HASH_XOF_MD_BYTE_MAX : ACVP_HASH_MD_BYTE_MAX)) {
+            ACVP_LOG_ERR("crypto module returned an invalid md_len (%u)", stc->md_len);
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+
+        /*
+         * Output the test case request values using JSON
+         */
+        rv = acvp_hash_output_mct_tc(ctx, stc, r_tobj);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure");
+            goto end;
+        }
+
+        /* Append the test response value to array */
+        json_array_append_value(res_array, r_tval);
+        r_tval = NULL;
+
+        /* The checkpoint seeds the next outer iteration */
+        memzero_s(stc->msg, msg_max);
+        if (shake) {
+            memcpy_s(stc->msg, msg_max, stc->md,
+                     stc->md_len < leftmost_bytes ? stc->md_len : leftmost_bytes);
+            stc->msg_len = leftmost_bytes;
+        } else {
+            memcpy_s(stc->msg, msg_max, stc->md, stc->md_len);
+            stc->msg_len = stc->md_len;
+        }
+    }
+
+end:
+    if (r_tval) json_value_free(r_tval);
+
+    return rv;
+}
+
+/*
+ * Monte Carlo test for a capability with an MCT loop handler: the crypto
+ * module is given the seed once and runs all of the outer and inner loops
+ * itself, see acvp_cap_hash_set_mct_loop_handler(), leaving every
+ * checkpoint in the arrays of the test case to be recorded here.
+ */
+static ACVP_RESULT acvp_hash_mct_loop_tc(ACVP_CTX *ctx,
+                                         ACVP_CAPS_LIST *cap,
+                                         ACVP_TEST_CASE *tc,
+                                         ACVP_HASH_TC *stc,
+                                         JSON_Array *res_array,
+                                         unsigned int min_xof_bits,
+                                         unsigned int max_xof_bits) {
+    int i = 0, shake = 0;
+    unsigned int md_max = ACVP_HASH_MD_BYTE_MAX;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    JSON_Value *r_tval = NULL;  /* Response testval */
+    JSON_Object *r_tobj = NULL; /* Response testobj */
+
+    shake = stc->cipher == ACVP_HASH_SHAKE_128 || stc->cipher == ACVP_HASH_SHAKE_256;
+    if (shake) {
+        md_max = ACVP_HASH_XOF_MD_BYTE_MAX;
+        stc->xof_min_len = min_xof_bits / 8;
+        stc->xof_max_len = max_xof_bits / 8;
+        /* Initial Outputlen = (floor(maxoutlen/8) )*8 */
+        stc->xof_len = stc->xof_max_len;
+        stc->msg_len = 16;
+    }
+
+    stc->mct_md_stride = md_max;
+    stc->mct_md = acvp_arena_calloc(&ctx->exec.tc_arena, (size_t)md_max * ACVP_HASH_MCT_OUTER);
+    stc->mct_md_len = acvp_arena_calloc(&ctx->exec.tc_arena, sizeof(unsigned int) * ACVP_HASH_MCT_OUTER);
+    if (!stc->mct_md || !stc->mct_md_len) {
+        ACVP_LOG_ERR("Unable to malloc the MCT checkpoints");
+        return ACVP_MALLOC_FAIL;
+    }
+
+    if (acvp_crypto_call(ctx, cap->mct_loop_handler, tc)) {
+        ACVP_LOG_ERR("crypto module failed the MCT operation");
+        return ACVP_CRYPTO_MODULE_FAIL;
+    }
+
+    for (i = 0; i < ACVP_HASH_MCT_OUTER; i++) {
+        if (!stc->mct_md_len[i] || stc->mct_md_len[i] > md_max) {
+            ACVP_LOG_ERR("crypto module returned an invalid md_len (%u) for checkpoint %d",
+                         stc->mct_md_len[i], i);
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        /* Recorded as though the checkpoint had been left in md */
+        stc->md = stc->mct_md + (size_t)i * md_max;
+        stc->md_len = stc->mct_md_len[i];
+
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        r_tobj = json_value_get_object(r_tval);
+
+        /*
+         * Output the test case request values using JSON
+         */
+        rv = acvp_hash_output_mct_tc(ctx, stc, r_tobj);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure");
+            json_value_free(r_tval);
+            return rv;
+        }
+
+        /* Append the test response value to array */
+        json_array_append_value(res_array, r_tval);
+    }
+
+    return ACVP_SUCCESS;
+}
+
 static ACVP_HASH_TESTTYPE read_test_type(const char *tt_str) {
     int diff = 0;
 
@@ -433,12 +574,14 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_HASH_TC stc;
+    ACVP_HASH_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
     ACVP_TEST_CASE tc;
+    ACVP_TC_BATCH batch;
+    int use_batch = 0;
     JSON_Array *res_tarr = NULL; /* Response resultsArray */
     ACVP_RESULT rv = ACVP_SUCCESS;
     ACVP_CIPHER alg_id = 0;
     ACVP_HASH_EXPANSION_METHOD exp_method = 0;
-    char *json_result = NULL;
     const char *alg_str = NULL;
     const char *test_type_str, *msg = NULL;
     const char *exp_method_str = NULL;
@@ -458,6 +601,7 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.hash = &stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -485,7 +629,7 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -508,15 +652,15 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         ACVP_LOG_VERBOSE("    Test group: %d", i);
 
@@ -561,8 +705,26 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Groups other than MCT are set up in one piece, then run together,
+         * when batching or parallel test cases were asked for
+         */
+        use_batch = acvp_tc_batch_enabled(ctx, cap) &&
+                    test_type != ACVP_HASH_TEST_TYPE_MCT && t_cnt > 0;
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_HASH_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
-            unsigned int tmp_msg_len = 0;
+            int tmp_msg_len = 0;
             unsigned int xof_len = 0;
             unsigned int max_len = 0;
 
@@ -570,7 +732,7 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             // Based on test type: LDT vs AFT && VOT
             if (test_type == ACVP_HASH_TEST_TYPE_LDT) {
@@ -582,15 +744,14 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
                 ldtobj = json_object_get_object(testobj, "largeMsg");
 
-                msg = json_object_get_string(ldtobj, "content");
+                msg = acvp_json_get_string_n(ldtobj, "content", &tmp_msg_len);
                 if (!msg) {
                     ACVP_LOG_ERR("Server JSON missing 'content'");
                     rv = ACVP_MISSING_ARG;
                     goto err;
                 }
                 max_len = ACVP_HASH_MSG_STR_MAX;
-                tmp_msg_len = strnlen_s(msg, max_len + 1);
-                if (tmp_msg_len > max_len) {
+                if (tmp_msg_len < 0 || (unsigned int)tmp_msg_len > max_len) {
                     ACVP_LOG_ERR("'msg' too long, max allowed=(%d)", max_len);
                     rv = ACVP_INVALID_ARG;
                     goto err;
@@ -615,7 +776,7 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                     goto err;
                 }
             } else {
-                msg = json_object_get_string(testobj, "msg");
+                msg = acvp_json_get_string_n(testobj, "msg", &tmp_msg_len);
                 if (!msg) {
                     ACVP_LOG_ERR("Server JSON missing 'msg'");
                     rv = ACVP_MISSING_ARG;
@@ -626,8 +787,7 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 } else {
                     max_len = ACVP_SHAKE_MSG_STR_MAX;
                 }
-                tmp_msg_len = strnlen_s(msg, max_len + 1);
-                if (tmp_msg_len > max_len) {
+                if (tmp_msg_len < 0 || (unsigned int)tmp_msg_len > max_len) {
                     ACVP_LOG_ERR("'msg' too long, max allowed=(%d)", max_len);
                     rv = ACVP_INVALID_ARG;
                     goto err;
@@ -672,21 +832,35 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_hash_init_tc(ctx, &stc, tc_id, test_type, msglen, msg, 
-                                    xof_len, exp_len, exp_method, alg_id);
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_hash_init_tc(ctx, cur, tc_id, test_type, msglen, msg, 
+                                    xof_len, exp_len, exp_method, alg_id,
+                                    acvp_output_sink_enabled(cap));
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Init for stc (test case) failed");
-                acvp_hash_release_tc(&stc);
+                acvp_hash_release_tc(ctx, cur);
                 json_value_free(r_tval);
                 goto err;
             }
 
+            if (use_batch) {
+                /* Processed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.hash = cur;
+                continue;
+            }
+
             /* If Monte Carlo start that here */
             if (stc.test_type == ACVP_HASH_TEST_TYPE_MCT) {
                 json_object_set_value(r_tobj, "resultsArray", json_value_init_array());
                 res_tarr = json_object_get_array(r_tobj, "resultsArray");
 
-                if (alg_id == ACVP_HASH_SHA3_224 || alg_id == ACVP_HASH_SHA3_256 ||
+                if (cap->mct_loop_handler) {
+                    rv = acvp_hash_mct_loop_tc(ctx, cap, &tc, &stc, res_tarr,
+                                               min_xof_len, max_xof_len);
+                } else if (cap->mct_handler) {
+                    rv = acvp_hash_mct_handler_tc(ctx, cap, &tc, &stc, res_tarr,
+                                                  min_xof_len, max_xof_len);
+                } else if (alg_id == ACVP_HASH_SHA3_224 || alg_id == ACVP_HASH_SHA3_256 ||
                     alg_id == ACVP_HASH_SHA3_384 || alg_id == ACVP_HASH_SHA3_512) {
                     rv = acvp_hash_sha3_mct(ctx, cap, &tc, &stc, res_tarr);
                 } else if (alg_id == ACVP_HASH_SHAKE_128 || alg_id == ACVP_HASH_SHAKE_256) {
@@ -698,15 +872,15 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("crypto module failed the HASH MCT operation");
-                    acvp_hash_release_tc(&stc);
+                    acvp_hash_release_tc(ctx, &stc);
                     json_value_free(r_tval);
                     goto err;
                 }
             } else {
                 /* Process the current test vector... */
-                if ((cap->crypto_handler)(&tc)) {
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("crypto module failed the operation");
-                    acvp_hash_release_tc(&stc);
+                    acvp_hash_release_tc(ctx, &stc);
                     json_value_free(r_tval);
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     goto err;
@@ -718,7 +892,7 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 rv = acvp_hash_output_tc(ctx, &stc, r_tobj);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("JSON output failure in hash module");
-                    acvp_hash_release_tc(&stc);
+                    acvp_hash_release_tc(ctx, &stc);
                     json_value_free(r_tval);
                     goto err;
                 }
@@ -726,28 +900,174 @@ ACVP_RESULT acvp_hash_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /*
              * Release all the memory associated with the test case
              */
-            acvp_hash_release_tc(&stc);
+            acvp_hash_release_tc(ctx, &stc);
 
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        if (use_batch) {
+            rv = acvp_hash_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_hash_release_batch(ctx, &stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_hash_release_batch(ctx, &stcs, &batch);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
 
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_hash_run_batch(ACVP_CTX *ctx,
+                                       ACVP_CAPS_LIST *cap,
+                                       ACVP_TC_BATCH *batch,
+                                       JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    if (cap->hash_soa_handler && batch->count &&
+            batch->tcs[0].tc.hash->test_type == ACVP_HASH_TEST_TYPE_AFT) {
+        rv = acvp_hash_run_soa(ctx, cap, batch);
+    } else {
+        rv = acvp_tc_batch_run(ctx, cap, batch);
+    }
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_hash_output_tc(ctx, batch->tcs[i].tc.hash, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in hash module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Hands an AFT group to the SoA handler of the capability, see
+ * acvp_cap_hash_set_soa_handler(). The messages are packed back to back,
+ * and the digests the module writes are copied back into the test cases
+ * for acvp_hash_output_tc().
+ */
+static ACVP_RESULT acvp_hash_run_soa(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_HASH_TC *stc = NULL;
+    ACVP_HASH_SOA soa;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long int start = 0;
+    size_t msg_bytes = 0, count = 0;
+    int i = 0;
+
+    if (batch->count < 1) {
+        ACVP_LOG_ERR("No test cases in the SoA view of the test group");
+        return ACVP_INVALID_ARG;
+    }
+    count = (size_t)batch->count;
+
+    memzero_s(&soa, sizeof(ACVP_HASH_SOA));
+    soa.cipher = batch->tcs[0].tc.hash->cipher;
+    soa.count = batch->count;
+    soa.md_stride = ACVP_HASH_MD_BYTE_MAX;
+    for (i = 0; i < batch->count; i++) {
+        msg_bytes += batch->tcs[i].tc.hash->msg_len;
+    }
+
+    soa.tc_id = calloc(count, sizeof(unsigned int));
+    soa.msg = calloc(msg_bytes ? msg_bytes : 1, sizeof(unsigned char));
+    soa.msg_off = calloc(count, sizeof(size_t));
+    soa.msg_len = calloc(count, sizeof(unsigned int));
+    soa.md = calloc(count * soa.md_stride, sizeof(unsigned char));
+    soa.md_len = calloc(count, sizeof(unsigned int));
+    if (!soa.tc_id || !soa.msg || !soa.msg_off || !soa.msg_len || !soa.md || !soa.md_len) {
+        ACVP_LOG_ERR("Unable to allocate the SoA view of the test group");
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+
+    msg_bytes = 0;
+    for (i = 0; i < soa.count; i++) {
+        stc = batch->tcs[i].tc.hash;
+        soa.tc_id[i] = stc->tc_id;
+        soa.msg_off[i] = msg_bytes;
+        soa.msg_len[i] = stc->msg_len;
+        if (stc->msg_len) {
+            memcpy_s(soa.msg + msg_bytes, stc->msg_len, stc->msg, stc->msg_len);
+        }
+        msg_bytes += stc->msg_len;
+    }
+
+    memzero_s(batch->results, batch->max * sizeof(int));
+    ACVP_LOG_VERBOSE("Handing %d messages to the SoA handler", soa.count);
+    if (ACVP_CRYPTO_TIMED(ctx)) start = acvp_metrics_now();
+    if ((cap->hash_soa_handler)(&soa, batch->results)) {
+        ACVP_LOG_ERR("crypto module failed the SoA operation");
+        rv = ACVP_CRYPTO_MODULE_FAIL;
+        goto end;
+    }
+    acvp_metrics_crypto(ctx, start, soa.count, NULL);
+
+    for (i = 0; i < soa.count; i++) {
+        stc = batch->tcs[i].tc.hash;
+        if (soa.md_len[i] > soa.md_stride) {
+            ACVP_LOG_ERR("crypto module returned a digest longer than the md array allows");
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+        stc->md_len = soa.md_len[i];
+        if (stc->md_len) {
+            memcpy_s(stc->md, ACVP_HASH_MD_BYTE_MAX, soa.md + (size_t)i * soa.md_stride, stc->md_len);
+        }
+    }
+
+end:
+    if (soa.tc_id) free(soa.tc_id);
+    if (soa.msg) free(soa.msg);
+    if (soa.msg_off) free(soa.msg_off);
+    if (soa.msg_len) free(soa.msg_len);
+    if (soa.md) free(soa.md);
+    if (soa.md_len) free(soa.md_len);
+    return rv;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_hash_release_batch(ACVP_CTX *ctx, ACVP_HASH_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_hash_release_tc(ctx, &(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -756,35 +1076,40 @@ err:
  */
 static ACVP_RESULT acvp_hash_output_tc(ACVP_CTX *ctx, ACVP_HASH_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
+    int tmp_max = 0;
 
-    if (stc->test_type == ACVP_HASH_TEST_TYPE_VOT) {
-        tmp = calloc(ACVP_HASH_XOF_MD_STR_MAX + 1, sizeof(char));
-    } else {
-        tmp = calloc(ACVP_HASH_MD_STR_MAX + 1, sizeof(char));
-    }
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_hash_output_tc");
-        return ACVP_MALLOC_FAIL;
+    if (stc->md_sink) {
+        if (stc->md_sink->len != stc->md_sink->max) {
+            ACVP_LOG_ERR("crypto module wrote %u of the %u bytes of output", stc->md_sink->len,
+                         stc->md_sink->max);
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        stc->md_len = stc->md_sink->len;
+        rv = acvp_output_sink_set(stc->md_sink, tc_rsp, "md");
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure (md)");
+            return rv;
+        }
+        json_object_set_number(tc_rsp, "outLen", stc->md_len * 8);
+        return ACVP_SUCCESS;
     }
 
     if (stc->test_type == ACVP_HASH_TEST_TYPE_VOT) {
-        rv = acvp_bin_to_hexstr(stc->md, stc->md_len, tmp, ACVP_HASH_XOF_MD_STR_MAX);
+        tmp_max = ACVP_HASH_XOF_MD_STR_MAX;
     } else {
-        rv = acvp_bin_to_hexstr(stc->md, stc->md_len, tmp, ACVP_HASH_MD_STR_MAX);
+        tmp_max = ACVP_HASH_MD_STR_MAX;
     }
+
+    rv = acvp_json_set_hex(tc_rsp, "md", stc->md, stc->md_len, tmp_max);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (msg)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "md", tmp);
     if (stc->cipher == ACVP_HASH_SHAKE_128 || stc->cipher == ACVP_HASH_SHAKE_256) {
         json_object_set_number(tc_rsp, "outLen", stc->md_len * 8);
     }
 
 end:
-    if (tmp) free(tmp);
-
     return rv;
 }
 
@@ -797,58 +1122,68 @@ static ACVP_RESULT acvp_hash_init_tc(ACVP_CTX *ctx,
                                      unsigned int xof_len,
                                      unsigned long long int exp_len,  // LDT expected data length
                                      ACVP_HASH_EXPANSION_METHOD exp_method,
-                                     ACVP_CIPHER alg_id) {
+                                     ACVP_CIPHER alg_id,
+                                     int use_sink) {
     ACVP_RESULT rv;
+    int hex_len, msg_max;
 
     memzero_s(stc, sizeof(ACVP_HASH_TC));
+
+    /* The caller has already measured msg; LDT lengths are in bytes, others in bits */
+    hex_len = test_type == ACVP_HASH_TEST_TYPE_LDT ? msg_len * 2 : msg_len / 4;
     if (alg_id != ACVP_HASH_SHAKE_128 && alg_id != ACVP_HASH_SHAKE_256) {
-        stc->msg = calloc(1, ACVP_HASH_MSG_BYTE_MAX);
+        msg_max = ACVP_HASH_MSG_BYTE_MAX;
     } else {
-        stc->msg = calloc(1, ACVP_SHAKE_MSG_BYTE_MAX);
+        msg_max = ACVP_SHAKE_MSG_BYTE_MAX;
+    }
+    /* MCT feeds digests back in as the message, so only the other tests can be sized to it */
+    if (test_type != ACVP_HASH_TEST_TYPE_MCT && (hex_len + 1) / 2 < msg_max) {
+        msg_max = hex_len ? (hex_len + 1) / 2 : 1;
     }
+    stc->msg = acvp_arena_calloc(&ctx->exec.tc_arena, msg_max);
     if (!stc->msg) { return ACVP_MALLOC_FAIL; }
 
     if (test_type == ACVP_HASH_TEST_TYPE_AFT ||
         test_type == ACVP_HASH_TEST_TYPE_LDT) {
         /* AFT */
-        stc->md = calloc(1, ACVP_HASH_MD_BYTE_MAX);
+        stc->md = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_MD_BYTE_MAX);
         if (!stc->md) { return ACVP_MALLOC_FAIL; }
+    } else if (test_type == ACVP_HASH_TEST_TYPE_VOT && use_sink && xof_len) {
+        /* The crypto module writes the output straight into the response */
+        stc->md_sink = acvp_output_sink_new((xof_len + 7) / 8);
+        if (!stc->md_sink) { return ACVP_MALLOC_FAIL; }
     } else if (test_type == ACVP_HASH_TEST_TYPE_VOT) {
-        /* VOT */
-        stc->md = calloc(1, ACVP_HASH_XOF_MD_BYTE_MAX);
+        /* VOT; outLen has already been checked against the XOF maximum */
+        stc->md = acvp_arena_calloc(&ctx->exec.tc_arena, xof_len ? (xof_len + 7) / 8 : ACVP_HASH_XOF_MD_BYTE_MAX);
         if (!stc->md) { return ACVP_MALLOC_FAIL; }
     } else {
         /* MCT */
         if (alg_id == ACVP_HASH_SHA3_224 || alg_id == ACVP_HASH_SHA3_256 ||
             alg_id == ACVP_HASH_SHA3_384 || alg_id == ACVP_HASH_SHA3_512) {
             /* SHA3 only needs the md buffer */
-            stc->md = calloc(1, ACVP_HASH_MD_BYTE_MAX);
+            stc->md = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_MD_BYTE_MAX);
             if (!stc->md) { return ACVP_MALLOC_FAIL; }
         } else if (alg_id == ACVP_HASH_SHAKE_128 ||
                    alg_id == ACVP_HASH_SHAKE_256) {
             /* SHAKE needs the md to support XOF length */
-            stc->md = calloc(1, ACVP_HASH_XOF_MD_BYTE_MAX);
+            stc->md = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_XOF_MD_BYTE_MAX);
             if (!stc->md) { return ACVP_MALLOC_FAIL; }
         } else {
             /* SHA/SHA2 */
-            stc->md = calloc(1, ACVP_HASH_MD_BYTE_MAX);
+            stc->md = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_MD_BYTE_MAX);
             if (!stc->md) { return ACVP_MALLOC_FAIL; }
 
-            stc->m1 = calloc(1, ACVP_HASH_MD_BYTE_MAX);
+            stc->m1 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_MD_BYTE_MAX);
             if (!stc->m1) { return ACVP_MALLOC_FAIL; }
 
-            stc->m2 = calloc(1, ACVP_HASH_MD_BYTE_MAX);
+            stc->m2 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_MD_BYTE_MAX);
             if (!stc->m2) { return ACVP_MALLOC_FAIL; }
 
-            stc->m3 = calloc(1, ACVP_HASH_MD_BYTE_MAX);
+            stc->m3 = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HASH_MD_BYTE_MAX);
             if (!stc->m3) { return ACVP_MALLOC_FAIL; }
         }
     }
-    if (alg_id != ACVP_HASH_SHAKE_128 && alg_id != ACVP_HASH_SHAKE_256) {
-        rv = acvp_hexstr_to_bin(msg, stc->msg, ACVP_HASH_MSG_BYTE_MAX, NULL);
-    } else {
-        rv = acvp_hexstr_to_bin(msg, stc->msg, ACVP_SHAKE_MSG_BYTE_MAX, NULL);
-    }
+    rv = acvp_hexstr_to_bin_n(msg, hex_len, stc->msg, msg_max, NULL);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex converstion failure (msg)");
         return rv;
@@ -872,16 +1207,87 @@ static ACVP_RESULT acvp_hash_init_tc(ACVP_CTX *ctx,
     return ACVP_SUCCESS;
 }
 
+/*
+ * The chunk buffer holds whole copies of the content, at least two and about
+ * ACVP_HASH_LDT_CHUNK_SIZE bytes of them, so every chunk can start at the
+ * right place within a copy and still be a full chunk long.
+ */
+ACVP_RESULT acvp_hash_ldt_next_chunk(ACVP_HASH_TC *tc,
+                                     const unsigned char **chunk,
+                                     unsigned int *chunk_len) {
+    unsigned long long int remaining = 0;
+    unsigned int copies = 0, i = 0, start = 0;
+
+    if (!tc || !chunk || !chunk_len) {
+        return ACVP_INVALID_ARG;
+    }
+    *chunk = NULL;
+    *chunk_len = 0;
+    if (tc->test_type != ACVP_HASH_TEST_TYPE_LDT || !tc->msg || !tc->msg_len) {
+        return ACVP_INVALID_ARG;
+    }
+
+    copies = ACVP_HASH_LDT_CHUNK_SIZE / tc->msg_len + 1;
+    if (copies < 2) {
+        copies = 2;
+    }
+    if (!tc->ldt_chunk) {
+        tc->ldt_chunk = malloc((size_t)copies * tc->msg_len);
+        if (!tc->ldt_chunk) {
+            return ACVP_MALLOC_FAIL;
+        }
+        for (i = 0; i < copies; i++) {
+            memcpy_s(tc->ldt_chunk + i * tc->msg_len, (copies - i) * tc->msg_len,
+                     tc->msg, tc->msg_len);
+        }
+    }
+
+    if (tc->ldt_offset >= tc->exp_len) {
+        return ACVP_SUCCESS;
+    }
+    remaining = tc->exp_len - tc->ldt_offset;
+    start = (unsigned int)(tc->ldt_offset % tc->msg_len);
+
+    *chunk = tc->ldt_chunk + start;
+    *chunk_len = (copies - 1) * tc->msg_len;
+    if (remaining < *chunk_len) {
+        *chunk_len = (unsigned int)remaining;
+    }
+    tc->ldt_offset += *chunk_len;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_hash_ldt_map(ACVP_HASH_TC *tc, const unsigned char **data) {
+    size_t map_len = 0;
+
+    if (!tc || !data) {
+        return ACVP_INVALID_ARG;
+    }
+    *data = NULL;
+    if (tc->test_type != ACVP_HASH_TEST_TYPE_LDT || !tc->msg || !tc->msg_len || !tc->exp_len) {
+        return ACVP_INVALID_ARG;
+    }
+
+    if (!tc->ldt_map) {
+        tc->ldt_map = acvp_map_repeated(tc->msg, tc->msg_len, tc->exp_len, &map_len);
+        if (!tc->ldt_map) {
+            return ACVP_UNSUPPORTED_OP;
+        }
+        tc->ldt_map_len = map_len;
+    }
+    *data = tc->ldt_map;
+    return ACVP_SUCCESS;
+}
+
 /*
  * This function simply releases the data associated with
  * a test case.
  */
-static ACVP_RESULT acvp_hash_release_tc(ACVP_HASH_TC *stc) {
-    if (stc->msg) free(stc->msg);
-    if (stc->md) free(stc->md);
-    if (stc->m1) free(stc->m1);
-    if (stc->m2) free(stc->m2);
-    if (stc->m3) free(stc->m3);
+static ACVP_RESULT acvp_hash_release_tc(ACVP_CTX *ctx, ACVP_HASH_TC *stc) {
+    if (stc->ldt_chunk) free(stc->ldt_chunk);
+    if (stc->ldt_map) acvp_unmap_repeated(stc->ldt_map, (size_t)stc->ldt_map_len);
+    acvp_output_sink_free(stc->md_sink);
+    acvp_arena_reset(&ctx->exec.tc_arena);
     memzero_s(stc, sizeof(ACVP_HASH_TC));
 
     return ACVP_SUCCESS;
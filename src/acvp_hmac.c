@@ -27,23 +27,32 @@ static ACVP_RESULT acvp_hmac_init_tc(ACVP_CTX *ctx,
                                      const char *key,
                                      ACVP_CIPHER alg_id) {
     ACVP_RESULT rv;
+    unsigned int msg_max = 0, key_max = 0;
 
     memzero_s(stc, sizeof(ACVP_HMAC_TC));
 
-    stc->msg = calloc(1, ACVP_HMAC_MSG_MAX);
+    /* Sized for this test case, from the test case arena */
+    msg_max = (strnlen_s(msg, 2 * ACVP_HMAC_MSG_MAX + 1) + 1) / 2;
+    if (msg_max > ACVP_HMAC_MSG_MAX) msg_max = ACVP_HMAC_MSG_MAX;
+    if (!msg_max) msg_max = 1;
+    key_max = (strnlen_s(key, ACVP_HMAC_KEY_STR_MAX + 1) + 1) / 2;
+    if (key_max > ACVP_HMAC_KEY_BYTE_MAX) key_max = ACVP_HMAC_KEY_BYTE_MAX;
+    if (!key_max) key_max = 1;
+
+    stc->msg = acvp_arena_calloc(&ctx->exec.tc_arena, msg_max);
     if (!stc->msg) { return ACVP_MALLOC_FAIL; }
-    stc->mac = calloc(1, ACVP_HMAC_MAC_BYTE_MAX);
+    stc->mac = acvp_arena_calloc(&ctx->exec.tc_arena, ACVP_HMAC_MAC_BYTE_MAX);
     if (!stc->mac) { return ACVP_MALLOC_FAIL; }
-    stc->key = calloc(1, ACVP_HMAC_KEY_BYTE_MAX);
+    stc->key = acvp_arena_calloc(&ctx->exec.tc_arena, key_max);
     if (!stc->key) { return ACVP_MALLOC_FAIL; }
 
-    rv = acvp_hexstr_to_bin(msg, stc->msg, ACVP_HMAC_MSG_MAX, NULL);
+    rv = acvp_hexstr_to_bin(msg, stc->msg, msg_max, NULL);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex converstion failure (msg)");
         return rv;
     }
 
-    rv = acvp_hexstr_to_bin(key, stc->key, ACVP_HMAC_KEY_BYTE_MAX, NULL);
+    rv = acvp_hexstr_to_bin(key, stc->key, key_max, NULL);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex converstion failure (key)");
         return rv;
@@ -66,23 +75,12 @@ static ACVP_RESULT acvp_hmac_init_tc(ACVP_CTX *ctx,
  */
 static ACVP_RESULT acvp_hmac_output_tc(ACVP_CTX *ctx, ACVP_HMAC_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_HMAC_MAC_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_hmac_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
-    rv = acvp_bin_to_hexstr(stc->mac, stc->mac_len, tmp, ACVP_HMAC_MAC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "mac", stc->mac, stc->mac_len, ACVP_HMAC_MAC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (mac)");
-        goto end;
+        return rv;
     }
-    json_object_set_string(tc_rsp, "mac", tmp);
-
-end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -91,18 +89,66 @@ end:
  * This function simply releases the data associated with
  * a test case.
  */
-static ACVP_RESULT acvp_hmac_release_tc(ACVP_HMAC_TC *stc) {
-    free(stc->msg);
-    free(stc->mac);
-    free(stc->key);
+static ACVP_RESULT acvp_hmac_release_tc(ACVP_CTX *ctx, ACVP_HMAC_TC *stc) {
+    acvp_arena_reset(&ctx->exec.tc_arena);
     memzero_s(stc, sizeof(ACVP_HMAC_TC));
 
     return ACVP_SUCCESS;
 }
 
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_hmac_run_batch(ACVP_CTX *ctx,
+                                       ACVP_CAPS_LIST *cap,
+                                       ACVP_TC_BATCH *batch,
+                                       JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_hmac_output_tc(ctx, batch->tcs[i].tc.hmac, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in hash module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_hmac_release_batch(ACVP_CTX *ctx, ACVP_HMAC_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_hmac_release_tc(ctx, &(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
+
 ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     unsigned int tc_id = 0, msglen = 0, keylen = 0, maclen = 0;
     const char *msg = NULL, *key = NULL;
+    int msg_str_len = 0, key_str_len = 0;
     JSON_Value *groupval;
     JSON_Object *groupobj = NULL;
     JSON_Value *testval;
@@ -123,12 +169,16 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_HMAC_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_HMAC_TC stc, group_stc;
+    ACVP_HMAC_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TEST_CASE tc, group_tc;
+    ACVP_TC_BATCH batch;
+    ACVP_TG_KEYS keys;
+    unsigned int key_id = 0;
+    int use_batch = 0, group_open = 0;
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -149,6 +199,10 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.hmac = &stc;
+    group_tc.tc.hmac = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_HMAC_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
+    memzero_s(&keys, sizeof(ACVP_TG_KEYS));
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -176,7 +230,7 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -200,15 +254,15 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         msglen = json_object_get_number(groupobj, "msgLen");
         if (!msglen) {
@@ -248,41 +302,76 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             goto err;
         }
 
+        /*
+         * Let the crypto module set up the MAC of the group once; each
+         * test case then only brings its key and message
+         */
+        if (cap->group_handler) {
+            memzero_s(&group_stc, sizeof(ACVP_HMAC_TC));
+            group_stc.cipher = alg_id;
+            group_stc.msg_len = msglen / 8;
+            group_stc.mac_len = maclen / 8;
+            group_stc.key_len = keylen / 8;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * The group is set up in one piece, then run together, when
+         * batching or parallel test cases were asked for
+         */
+        use_batch = acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_HMAC_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new hash test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Failed to include tc_id. ");
                 rv = ACVP_MISSING_ARG;
                 goto err;
             }
-            msg = json_object_get_string(testobj, "msg");
+            msg = acvp_json_get_string_n(testobj, "msg", &msg_str_len);
             if (!msg) {
                 ACVP_LOG_ERR("Failed to include msg. ");
                 rv = ACVP_MISSING_ARG;
                 goto err;
             }
 
-            if (strnlen_s(msg, ACVP_HMAC_MSG_MAX) != msglen * 2 / 8) {
-                ACVP_LOG_ERR("msgLen(%d) or msg length(%zu) incorrect",
-                             msglen, strnlen_s(msg, ACVP_HMAC_MSG_MAX) * 8 / 2);
+            if (msg_str_len != (int)(msglen * 2 / 8)) {
+                ACVP_LOG_ERR("msgLen(%d) or msg length(%d) incorrect",
+                             msglen, msg_str_len * 8 / 2);
                 rv = ACVP_INVALID_ARG;
                 goto err;
             }
 
-            key = json_object_get_string(testobj, "key");
+            key = acvp_json_get_string_n(testobj, "key", &key_str_len);
             if (!key) {
                 ACVP_LOG_ERR("Failed to include key. ");
                 rv = ACVP_MISSING_ARG;
                 goto err;
             }
 
-            if (strnlen_s(key, ACVP_HMAC_KEY_STR_MAX) != (keylen / 4)) {
-                ACVP_LOG_ERR("keyLen(%d) or key length(%zu) incorrect",
-                             keylen, strnlen_s(key, ACVP_HMAC_KEY_STR_MAX) * 4);
+            if (key_str_len != (int)(keylen / 4)) {
+                ACVP_LOG_ERR("keyLen(%d) or key length(%d) incorrect",
+                             keylen, key_str_len * 4);
                 rv = ACVP_INVALID_ARG;
                 goto err;
             }
@@ -294,6 +383,7 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             ACVP_LOG_VERBOSE("              msg: %s", msg);
             ACVP_LOG_VERBOSE("           keyLen: %d", keylen);
             ACVP_LOG_VERBOSE("              key: %s", key);
+            key_id = acvp_tg_key_id_parts(&keys, &key, 1, ACVP_HMAC_KEY_STR_MAX);
 
             /*
              * Create a new test case in the response
@@ -307,17 +397,26 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_hmac_init_tc(ctx, &stc, tc_id, msglen, msg, maclen, keylen, key, alg_id);
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_hmac_init_tc(ctx, cur, tc_id, msglen, msg, maclen, keylen, key, alg_id);
             if (rv != ACVP_SUCCESS) {
-                acvp_hmac_release_tc(&stc);
+                acvp_hmac_release_tc(ctx, cur);
                 json_value_free(r_tval);
                 goto err;
             }
+            cur->key_id = key_id;
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                /* Processed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.hmac = cur;
+                continue;
+            }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("ERROR: crypto module failed the operation");
-                acvp_hmac_release_tc(&stc);
+                acvp_hmac_release_tc(ctx, &stc);
                 json_value_free(r_tval);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
                 goto err;
@@ -330,28 +429,48 @@ ACVP_RESULT acvp_hmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("ERROR: JSON output failure in hash module");
                 json_value_free(r_tval);
-                acvp_hmac_release_tc(&stc);
+                acvp_hmac_release_tc(ctx, &stc);
                 goto err;
             }
             /*
              * Release all the memory associated with the test case
              */
-            acvp_hmac_release_tc(&stc);
+            acvp_hmac_release_tc(ctx, &stc);
 
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        if (use_batch) {
+            rv = acvp_hmac_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_hmac_release_batch(ctx, &stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        acvp_tg_keys_clear(&keys);
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_hmac_release_batch(ctx, &stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_tg_keys_clear(&keys);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
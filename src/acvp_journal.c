@@ -0,0 +1,335 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * The checkpoint journal, see acvp_set_checkpoint_journal(). The responses
+ * of each test group are appended to the journal as the KAT handler
+ * finishes with the group, one line of JSON per group:
+ *
+ *     {"vsId":1234,"tgId":5,"response":{"tgId":5,"tests":[...]}}
+ *
+ * When a vector set is dispatched again, for example after the process was
+ * restarted and the session resumed, the groups found in the journal are
+ * taken out of the vector set before it is handed to the KAT handler, and
+ * their responses are put back in among the others once it is done. A line
+ * that can not be parsed, such as one cut short by a crash, is ignored and
+ * its group run again. The groups found in the result memo, see
+ * acvp_memo.c, are taken out and put back the same way.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+static ACVP_MUTEX *acvp_journal_lock(ACVP_CTX *ctx) {
+    return ctx->session ? &ctx->session->journal_lock : &ctx->journal_lock;
+}
+
+/*
+ * Reads the journal file into a heap buffer, followed by a zero byte.
+ * NULL if there is no journal yet.
+ */
+static char *acvp_journal_read(const char *filename) {
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long size = 0;
+
+    fp = fopen(filename, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET)) {
+        fclose(fp);
+        return NULL;
+    }
+    buf = calloc((size_t)size + 1, sizeof(char));
+    if (buf && fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    return buf;
+}
+
+/*
+ * Returns the test group responses the journal has for vs_id, as an object
+ * of group responses keyed by tgId, or NULL if it has none.
+ */
+static JSON_Value *acvp_journal_load(ACVP_CTX *ctx, int vs_id) {
+    JSON_Value *groups_val = NULL, *line_val = NULL, *rsp_val = NULL;
+    JSON_Object *groups = NULL, *line_obj = NULL;
+    char *buf = NULL, *line = NULL, *end = NULL;
+    char key[16];
+    int tg_id = 0;
+
+    acvp_mutex_lock(acvp_journal_lock(ctx));
+    buf = acvp_journal_read(ctx->journal_file);
+    acvp_mutex_unlock(acvp_journal_lock(ctx));
+    if (!buf) {
+        return NULL;
+    }
+
+    for (line = buf; *line; line = end) {
+        end = strchr(line, '\n');
+        if (end) {
+            *end++ = '\0';
+        } else {
+            end = line + strnlen_s(line, RSIZE_MAX_STR);
+        }
+        line_val = json_parse_string(line);
+        line_obj = json_value_get_object(line_val);
+        tg_id = (int)json_object_get_uint(line_obj, "tgId");
+        rsp_val = json_object_get_value(line_obj, "response");
+        if (!tg_id || !rsp_val || (int)json_object_get_uint(line_obj, "vsId") != vs_id) {
+            if (line_val) json_value_free(line_val);
+            continue;
+        }
+
+        if (!groups_val) {
+            groups_val = json_value_init_object();
+            groups = json_value_get_object(groups_val);
+        }
+        snprintf(key, sizeof(key), "%d", tg_id);
+        if (groups && !json_object_has_value(groups, key)) {
+            json_object_set_value(groups, key, json_value_deep_copy(rsp_val));
+        }
+        json_value_free(line_val);
+    }
+    free(buf);
+
+    if (groups_val && !json_object_get_count(groups)) {
+        json_value_free(groups_val);
+        groups_val = NULL;
+    }
+    return groups_val;
+}
+
+/*
+ * Whether a tgId appears more than once in the test groups
+ */
+static int acvp_journal_has_dup(JSON_Array *tg_arr) {
+    int i = 0, j = 0, count = json_array_get_count(tg_arr);
+    int tg_id = 0;
+
+    for (i = 0; i < count; i++) {
+        tg_id = (int)json_object_get_uint(json_array_get_object(tg_arr, i), "tgId");
+        for (j = i + 1; j < count; j++) {
+            if (tg_id == (int)json_object_get_uint(json_array_get_object(tg_arr, j), "tgId")) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Called before the vector set obj is handed to its KAT handler. When the
+ * journal already has some of its test groups, they are taken out of obj
+ * and kept, along with the order of the groups, to be merged back into the
+ * responses by acvp_journal_end().
+ */
+ACVP_RESULT acvp_journal_begin(ACVP_CTX *ctx, JSON_Object *obj) {
+    JSON_Value *groups_val = NULL, *order_val = NULL, *todo_val = NULL;
+    JSON_Object *groups = NULL;
+    JSON_Array *tg_arr = NULL, *order = NULL, *todo = NULL;
+    JSON_Object *tg_obj = NULL;
+    char key[16];
+    int i = 0, count = 0, tg_id = 0, memo_hits = 0;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    ctx->exec.rsp_groups = NULL;
+    ctx->exec.rsp_groups_saved = 0;
+    if (ctx->exec.journal) json_value_free(ctx->exec.journal);
+    ctx->exec.journal = NULL;
+    if (!ctx->journal_file && !ctx->memo) {
+        return ACVP_SUCCESS;
+    }
+    if (ctx->rerun_failed) {
+        /* What was kept of these vector sets is what failed */
+        if (ctx->exec.memo) json_value_free(ctx->exec.memo);
+        ctx->exec.memo = NULL;
+        return ACVP_SUCCESS;
+    }
+
+    if (ctx->journal_file) {
+        groups_val = acvp_journal_load(ctx, ctx->exec.vs_id);
+    }
+    /* Adds the groups found in the result memo */
+    rv = acvp_memo_lookup(ctx, obj, &groups_val, &memo_hits);
+    if (rv != ACVP_SUCCESS) {
+        if (groups_val) json_value_free(groups_val);
+        return rv;
+    }
+    if (!groups_val) {
+        return ACVP_SUCCESS;
+    }
+    groups = json_value_get_object(groups_val);
+
+    tg_arr = json_object_get_array(obj, "testGroups");
+    count = json_array_get_count(tg_arr);
+    if (acvp_journal_has_dup(tg_arr)) {
+        /* The journal can not tell these groups apart */
+        ACVP_LOG_WARN("Vector set %d repeats a tgId, running all of its test groups again", ctx->exec.vs_id);
+        json_value_free(groups_val);
+        acvp_memo_end(ctx, ACVP_INVALID_ARG);
+        return ACVP_SUCCESS;
+    }
+    order_val = json_value_init_array();
+    order = json_value_get_array(order_val);
+    todo_val = json_value_init_array();
+    todo = json_value_get_array(todo_val);
+    if (!order || !todo) {
+        goto err;
+    }
+    for (i = 0; i < count; i++) {
+        tg_obj = json_array_get_object(tg_arr, i);
+        tg_id = (int)json_object_get_uint(tg_obj, "tgId");
+        json_array_append_number(order, tg_id);
+        snprintf(key, sizeof(key), "%d", tg_id);
+        if (tg_id && json_object_has_value(groups, key)) {
+            continue;
+        }
+        json_array_append_value(todo, json_value_deep_copy(json_array_get_value(tg_arr, i)));
+    }
+
+    if (count - (int)json_array_get_count(todo) > memo_hits) {
+        ACVP_LOG_STATUS("Resuming vector set %d from the checkpoint journal, %d of its %d test groups are done",
+                        ctx->exec.vs_id, count - (int)json_array_get_count(todo) - memo_hits, count);
+    }
+    if (json_object_set_value(obj, "testGroups", todo_val) != JSONSuccess) {
+        goto err;
+    }
+    todo_val = NULL;
+
+    json_object_set_value(groups, "order", order_val);
+    ctx->exec.journal = groups_val;
+    return ACVP_SUCCESS;
+
+err:
+    if (todo_val) json_value_free(todo_val);
+    if (order_val) json_value_free(order_val);
+    json_value_free(groups_val);
+    return ACVP_MALLOC_FAIL;
+}
+
+/*
+ * Appends the test groups the KAT handler has finished since the last call
+ * to the journal. Called as each group starts, see acvp_metrics_tg_begin(),
+ * so the responses of every group before it are complete, and once more as
+ * the vector set is done. A group that can not be written is only logged;
+ * it is just run again should the vector set be resumed.
+ */
+void acvp_journal_tg_done(ACVP_CTX *ctx) {
+    JSON_Value *group = NULL;
+    FILE *fp = NULL;
+    char *str = NULL;
+    int count = 0;
+
+    if (!ctx->journal_file || !ctx->exec.rsp_groups) {
+        return;
+    }
+    count = json_array_get_count(ctx->exec.rsp_groups);
+    if (ctx->exec.rsp_groups_saved >= count) {
+        return;
+    }
+
+    acvp_mutex_lock(acvp_journal_lock(ctx));
+    fp = fopen(ctx->journal_file, "a+");
+    if (fp && !fseek(fp, -1, SEEK_END) && fgetc(fp) != '\n' && !fseek(fp, 0, SEEK_END)) {
+        /* Ends the line cut short by a crash, so it is not part of the next */
+        fputc('\n', fp);
+    }
+    while (fp && ctx->exec.rsp_groups_saved < count) {
+        group = json_array_get_value(ctx->exec.rsp_groups, ctx->exec.rsp_groups_saved);
+        str = json_serialize_to_string(group, NULL);
+        if (!str || fprintf(fp, "{\"vsId\":%d,\"tgId\":%d,\"response\":%s}\n", ctx->exec.vs_id,
+                            (int)json_object_get_uint(json_value_get_object(group), "tgId"), str) < 0) {
+            ACVP_LOG_WARN("Unable to write test group to the checkpoint journal");
+        }
+        if (str) json_free_serialized_string(str);
+        ctx->exec.rsp_groups_saved++;
+    }
+    if (!fp) {
+        ACVP_LOG_WARN("Unable to open the checkpoint journal %s", ctx->journal_file);
+    } else if (fclose(fp) == EOF) {
+        ACVP_LOG_WARN("Unable to write the checkpoint journal %s", ctx->journal_file);
+    }
+    acvp_mutex_unlock(acvp_journal_lock(ctx));
+
+    /* Nothing is written twice, even when it could not be written at all */
+    ctx->exec.rsp_groups_saved = count;
+}
+
+/*
+ * Called once the KAT handler returns rv. The test groups it finished last
+ * are written to the journal, and those taken from the journal by
+ * acvp_journal_begin() are put back into the responses, in the order of the
+ * vector set.
+ */
+ACVP_RESULT acvp_journal_end(ACVP_CTX *ctx, ACVP_RESULT rv) {
+    JSON_Value *merged_val = NULL;
+    JSON_Array *merged = NULL, *done = NULL, *order = NULL;
+    JSON_Object *r_vs = NULL, *groups = NULL;
+    char key[16];
+    int i = 0, next = 0, count = 0;
+
+    if (rv == ACVP_SUCCESS) {
+        acvp_journal_tg_done(ctx);
+    }
+    /* Sees to the groups run for the result memo while only they are in the responses */
+    acvp_memo_end(ctx, rv);
+    ctx->exec.rsp_groups = NULL;
+    ctx->exec.rsp_groups_saved = 0;
+    if (!ctx->exec.journal) {
+        return rv;
+    }
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
+
+    groups = json_value_get_object(ctx->exec.journal);
+    order = json_object_get_array(groups, "order");
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    done = json_object_get_array(r_vs, "testGroups");
+    merged_val = json_value_init_array();
+    merged = json_value_get_array(merged_val);
+    if (!done || !merged) {
+        ACVP_LOG_ERR("Unable to merge the checkpoint journal into the responses");
+        rv = done ? ACVP_MALLOC_FAIL : ACVP_JSON_ERR;
+        goto end;
+    }
+
+    count = json_array_get_count(order);
+    for (i = 0; i < count; i++) {
+        snprintf(key, sizeof(key), "%d", (int)json_array_get_uint(order, i));
+        if (json_object_has_value(groups, key)) {
+            json_array_append_value(merged, json_value_deep_copy(json_object_get_value(groups, key)));
+        } else {
+            /* The rest were run in order by the handler */
+            json_array_append_value(merged, json_value_deep_copy(json_array_get_value(done, next++)));
+        }
+    }
+    if (json_object_set_value(r_vs, "testGroups", merged_val) != JSONSuccess) {
+        rv = ACVP_JSON_ERR;
+        goto end;
+    }
+    merged_val = NULL;
+
+end:
+    if (merged_val) json_value_free(merged_val);
+    json_value_free(ctx->exec.journal);
+    ctx->exec.journal = NULL;
+    return rv;
+}
@@ -17,6 +17,17 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+static ACVP_RESULT acvp_kas_ecc_output_ssc_tc(ACVP_CTX *ctx,
+                                              ACVP_KAS_ECC_TC *stc,
+                                              JSON_Object *tc_rsp);
+
+static ACVP_RESULT acvp_kas_ecc_run_batch(ACVP_CTX *ctx,
+                                          ACVP_CAPS_LIST *cap,
+                                          ACVP_TC_BATCH *batch,
+                                          JSON_Array *r_tarr);
+
+static void acvp_kas_ecc_release_batch(ACVP_KAS_ECC_TC **stcs, ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -27,39 +38,26 @@ static ACVP_RESULT acvp_kas_ecc_output_cdh_tc(ACVP_CTX *ctx,
                                               ACVP_KAS_ECC_TC *stc,
                                               JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
-    tmp = calloc(ACVP_KAS_ECC_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
-
-    rv = acvp_bin_to_hexstr(stc->pix, stc->pixlen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "publicIutX", stc->pix, stc->pixlen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (pix)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "publicIutX", tmp);
 
-    memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->piy, stc->piylen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "publicIutY", stc->piy, stc->piylen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (piy)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "publicIutY", tmp);
 
-    memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->z, stc->zlen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "z", stc->z, stc->zlen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (Z)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "z", tmp);
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -74,23 +72,10 @@ static ACVP_RESULT acvp_kas_ecc_output_comp_tc(ACVP_CTX *ctx,
                                                ACVP_KAS_ECC_TC *stc,
                                                JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(1, ACVP_KAS_ECC_STR_MAX + 1);
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->test_type == ACVP_KAS_ECC_TT_VAL) {
         int diff = 1;
 
-        memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->chash, stc->chashlen, tmp, ACVP_KAS_ECC_STR_MAX);
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("hex conversion failure (Z)");
-            goto end;
-        }
         memcmp_s(stc->chash, ACVP_KAS_ECC_BYTE_MAX, stc->z, stc->zlen, &diff);
         if (!diff) {
             json_object_set_boolean(tc_rsp, "testPassed", 1);
@@ -100,40 +85,31 @@ static ACVP_RESULT acvp_kas_ecc_output_comp_tc(ACVP_CTX *ctx,
         goto end;
     }
 
-    memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->pix, stc->pixlen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "ephemeralPublicIutX", stc->pix, stc->pixlen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (pix)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "ephemeralPublicIutX", tmp);
 
-    memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->piy, stc->piylen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "ephemeralPublicIutY", stc->piy, stc->piylen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (piy)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "ephemeralPublicIutY", tmp);
 
-    memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->d, stc->dlen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "ephemeralPrivateIut", stc->d, stc->dlen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (d)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "ephemeralPrivateIut", tmp);
 
-    memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->chash, stc->chashlen, tmp, ACVP_KAS_ECC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "hashZIut", stc->chash, stc->chashlen, ACVP_KAS_ECC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (Z)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "hashZIut", tmp);
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -306,6 +282,14 @@ static ACVP_RESULT acvp_kas_ecc_cdh(ACVP_CTX *ctx,
     unsigned int i, g_cnt;
     int j, t_cnt, tc_id;
     ACVP_RESULT rv;
+    ACVP_TEST_CASE group_tc;
+    ACVP_KAS_ECC_TC group_stc;
+    ACVP_KAS_ECC_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TC_BATCH batch;
+    int group_open = 0, use_batch = 0;
+
+    group_tc.tc.kas_ecc = &group_stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
@@ -325,15 +309,15 @@ static ACVP_RESULT acvp_kas_ecc_cdh(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         curve_str = json_object_get_string(groupobj, "curve");
         if (!curve_str) {
@@ -367,13 +351,48 @@ static ACVP_RESULT acvp_kas_ecc_cdh(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_KAS_ECC_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = cap->cipher;
+            group_stc.test_type = test_type;
+            group_stc.mode = ACVP_KAS_ECC_MODE_CDH;
+            group_stc.curve = curve;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * The test cases of a group are independent scalar multiplications
+         * on the same curve, so the group can be set up in one piece and
+         * handed to the crypto module together.
+         */
+        use_batch = t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_KAS_ECC_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             const char *psx = NULL, *psy = NULL;
 
             ACVP_LOG_VERBOSE("Found new KAS-ECC CDH test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             /*
              * Create a new test case in the response
@@ -420,16 +439,25 @@ static ACVP_RESULT acvp_kas_ecc_cdh(ACVP_CTX *ctx,
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_kas_ecc_init_cdh_tc(ctx, stc, test_type,
+            cur = use_batch ? &stcs[j] : stc;
+            cur->cipher = cap->cipher;
+            rv = acvp_kas_ecc_init_cdh_tc(ctx, cur, test_type,
                                           curve, psx, psy);
             if (rv != ACVP_SUCCESS) {
-                acvp_kas_ecc_release_tc(stc);
+                acvp_kas_ecc_release_tc(cur);
                 json_value_free(r_tval);
                 goto err;
             }
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                /* Processed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.kas_ecc = cur;
+                continue;
+            }
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kas_ecc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -456,11 +484,30 @@ static ACVP_RESULT acvp_kas_ecc_cdh(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_kas_ecc_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_kas_ecc_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kas_ecc_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -484,6 +531,14 @@ static ACVP_RESULT acvp_kas_ecc_comp(ACVP_CTX *ctx,
     unsigned int i, g_cnt;
     int j, t_cnt, tc_id;
     ACVP_RESULT rv;
+    ACVP_TEST_CASE group_tc;
+    ACVP_KAS_ECC_TC group_stc;
+    ACVP_KAS_ECC_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TC_BATCH batch;
+    int group_open = 0, use_batch = 0;
+
+    group_tc.tc.kas_ecc = &group_stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
@@ -504,15 +559,15 @@ static ACVP_RESULT acvp_kas_ecc_comp(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         curve_str = json_object_get_string(groupobj, "curve");
         if (!curve_str) {
@@ -563,6 +618,42 @@ static ACVP_RESULT acvp_kas_ecc_comp(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_KAS_ECC_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = cap->cipher;
+            group_stc.test_type = test_type;
+            group_stc.mode = ACVP_KAS_ECC_MODE_COMPONENT;
+            group_stc.curve = curve;
+            group_stc.md = hash;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * The test cases of a group are independent scalar multiplications
+         * on the same curve, so the group can be set up in one piece and
+         * handed to the crypto module together.
+         */
+        use_batch = t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_KAS_ECC_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             const char *psx = NULL, *psy = NULL, *pix = NULL,
                        *piy = NULL, *d = NULL, *z = NULL;
@@ -570,7 +661,7 @@ static ACVP_RESULT acvp_kas_ecc_comp(ACVP_CTX *ctx,
             ACVP_LOG_VERBOSE("Found new KAS-ECC Component test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             /*
              * Create a new test case in the response
@@ -684,17 +775,26 @@ static ACVP_RESULT acvp_kas_ecc_comp(ACVP_CTX *ctx,
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_kas_ecc_init_comp_tc(ctx, stc, test_type,
+            cur = use_batch ? &stcs[j] : stc;
+            cur->cipher = cap->cipher;
+            rv = acvp_kas_ecc_init_comp_tc(ctx, cur, test_type,
                                            curve, hash, psx, psy,
                                            d, pix, piy, z);
             if (rv != ACVP_SUCCESS) {
-                acvp_kas_ecc_release_tc(stc);
+                acvp_kas_ecc_release_tc(cur);
                 json_value_free(r_tval);
                 goto err;
             }
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                /* Processed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.kas_ecc = cur;
+                continue;
+            }
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kas_ecc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -721,11 +821,30 @@ static ACVP_RESULT acvp_kas_ecc_comp(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_kas_ecc_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_kas_ecc_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kas_ecc_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -744,7 +863,6 @@ ACVP_RESULT acvp_kas_ecc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KAS_ECC_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
     const char *mode_str = NULL;
     ACVP_SUB_KAS alg;
 
@@ -777,7 +895,7 @@ ACVP_RESULT acvp_kas_ecc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -852,9 +970,7 @@ ACVP_RESULT acvp_kas_ecc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -876,23 +992,10 @@ static ACVP_RESULT acvp_kas_ecc_output_ssc_tc(ACVP_CTX *ctx,
                                               ACVP_KAS_ECC_TC *stc,
                                               JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(1, ACVP_KAS_ECC_STR_MAX + 1);
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->test_type == ACVP_KAS_ECC_TT_VAL) {
         int diff = 1;
 
-        memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->chash, stc->chashlen, tmp, ACVP_KAS_ECC_STR_MAX);
-        if (rv != ACVP_SUCCESS) {
-            ACVP_LOG_ERR("hex conversion failure (Z)");
-            goto end;
-        }
         memcmp_s(stc->chash, ACVP_KAS_ECC_BYTE_MAX, stc->z, stc->zlen, &diff);
         if (!diff) {
             json_object_set_boolean(tc_rsp, "testPassed", 1);
@@ -901,44 +1004,32 @@ static ACVP_RESULT acvp_kas_ecc_output_ssc_tc(ACVP_CTX *ctx,
         }
         goto end;
     } else {
-        memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->pix, stc->pixlen, tmp, ACVP_KAS_ECC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "ephemeralPublicIutX", stc->pix, stc->pixlen, ACVP_KAS_ECC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (pix)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "ephemeralPublicIutX", tmp);
 
-        memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->piy, stc->piylen, tmp, ACVP_KAS_ECC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "ephemeralPublicIutY", stc->piy, stc->piylen, ACVP_KAS_ECC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (piy)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "ephemeralPublicIutY", tmp);
 
-        memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->d, stc->dlen, tmp, ACVP_KAS_ECC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "ephemeralPrivateIut", stc->d, stc->dlen, ACVP_KAS_ECC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (d)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "ephemeralPrivateIut", tmp);
 
-        memzero_s(tmp, ACVP_KAS_ECC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->chash, stc->chashlen, tmp, ACVP_KAS_ECC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, stc->md == ACVP_NO_SHA ? "Z" : "hashZ",
+                               stc->chash, stc->chashlen, ACVP_KAS_ECC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (Z)");
             goto end;
         }
-        if (stc->md == ACVP_NO_SHA) {
-            json_object_set_string(tc_rsp, "Z", tmp);
-        } else {
-            json_object_set_string(tc_rsp, "hashZ", tmp);
-        }
     }
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -961,6 +1052,14 @@ static ACVP_RESULT acvp_kas_ecc_ssc(ACVP_CTX *ctx,
     unsigned int i, g_cnt;
     int j, t_cnt, tc_id;
     ACVP_RESULT rv;
+    ACVP_TEST_CASE group_tc;
+    ACVP_KAS_ECC_TC group_stc;
+    ACVP_KAS_ECC_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TC_BATCH batch;
+    int group_open = 0, use_batch = 0;
+
+    group_tc.tc.kas_ecc = &group_stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
@@ -981,15 +1080,15 @@ static ACVP_RESULT acvp_kas_ecc_ssc(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         curve_str = json_object_get_string(groupobj, "domainParameterGenerationMode");
         if (!curve_str) {
@@ -1062,6 +1161,42 @@ static ACVP_RESULT acvp_kas_ecc_ssc(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_KAS_ECC_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = cap->cipher;
+            group_stc.test_type = test_type;
+            group_stc.mode = ACVP_KAS_ECC_MODE_COMPONENT;
+            group_stc.curve = curve;
+            group_stc.md = hash;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * The test cases of a group are independent scalar multiplications
+         * on the same curve, so the group can be set up in one piece and
+         * handed to the crypto module together.
+         */
+        use_batch = t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_KAS_ECC_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             const char *psx = NULL, *psy = NULL, *pix = NULL,
                        *piy = NULL, *d = NULL, *z = NULL;
@@ -1069,7 +1204,7 @@ static ACVP_RESULT acvp_kas_ecc_ssc(ACVP_CTX *ctx,
             ACVP_LOG_VERBOSE("Found new KAS-ECC-SSC Component test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             /*
              * Create a new test case in the response
@@ -1199,17 +1334,26 @@ static ACVP_RESULT acvp_kas_ecc_ssc(ACVP_CTX *ctx,
              * we can use the comp init since the only difference between
              * ECC_SSC and comp is the keywords used - why NIST did that ???
              */
-            rv = acvp_kas_ecc_init_comp_tc(ctx, stc, test_type,
+            cur = use_batch ? &stcs[j] : stc;
+            cur->cipher = cap->cipher;
+            rv = acvp_kas_ecc_init_comp_tc(ctx, cur, test_type,
                                            curve, hash, psx, psy,
                                            d, pix, piy, z);
             if (rv != ACVP_SUCCESS) {
-                acvp_kas_ecc_release_tc(stc);
+                acvp_kas_ecc_release_tc(cur);
                 json_value_free(r_tval);
                 goto err;
             }
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                /* Processed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.kas_ecc = cur;
+                continue;
+            }
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kas_ecc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -1236,11 +1380,30 @@ static ACVP_RESULT acvp_kas_ecc_ssc(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_kas_ecc_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_kas_ecc_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kas_ecc_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -1259,7 +1422,6 @@ ACVP_RESULT acvp_kas_ecc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KAS_ECC_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -1290,7 +1452,7 @@ ACVP_RESULT acvp_kas_ecc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1308,9 +1470,7 @@ ACVP_RESULT acvp_kas_ecc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1320,3 +1480,60 @@ err:
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a CDH, Component or SSC test group, see
+ * acvp_tc_batch_run(), and outputs their results, in test case order, into
+ * the group's tests array.
+ */
+static ACVP_RESULT acvp_kas_ecc_run_batch(ACVP_CTX *ctx,
+                                          ACVP_CAPS_LIST *cap,
+                                          ACVP_TC_BATCH *batch,
+                                          JSON_Array *r_tarr) {
+    ACVP_KAS_ECC_TC *stc = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        stc = batch->tcs[i].tc.kas_ecc;
+        if (cap->cipher == ACVP_KAS_ECC_SSC) {
+            rv = acvp_kas_ecc_output_ssc_tc(ctx, stc, json_value_get_object(batch->rsp[i]));
+        } else if (stc->mode == ACVP_KAS_ECC_MODE_CDH) {
+            rv = acvp_kas_ecc_output_cdh_tc(ctx, stc, json_value_get_object(batch->rsp[i]));
+        } else {
+            rv = acvp_kas_ecc_output_comp_tc(ctx, stc, json_value_get_object(batch->rsp[i]));
+        }
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in KAS-ECC module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_kas_ecc_release_batch(ACVP_KAS_ECC_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_kas_ecc_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
@@ -63,13 +63,6 @@ static ACVP_RESULT acvp_kas_ffc_output_ssc_tc(ACVP_CTX *ctx,
                                                ACVP_KAS_FFC_TC *stc,
                                                JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KAS_FFC_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->test_type == ACVP_KAS_FFC_TT_VAL) {
         int diff = 1;
@@ -83,28 +76,20 @@ static ACVP_RESULT acvp_kas_ffc_output_ssc_tc(ACVP_CTX *ctx,
         }
         goto end;
     } else {
-        memzero_s(tmp, ACVP_KAS_FFC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->piut, stc->piutlen, tmp, ACVP_KAS_FFC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "ephemeralPublicIut", stc->piut, stc->piutlen, ACVP_KAS_FFC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (IUT Pub)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "ephemeralPublicIut", tmp);
 
-        memzero_s(tmp, ACVP_KAS_FFC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->chash, stc->chashlen, tmp, ACVP_KAS_FFC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, stc->md == ACVP_NO_SHA ? "Z" : "hashZ",
+                               stc->chash, stc->chashlen, ACVP_KAS_FFC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (Z)");
             goto end;
         }
-        if(stc->md == ACVP_NO_SHA) {
-            json_object_set_string(tc_rsp, "Z", tmp);
-        } else {
-            json_object_set_string(tc_rsp, "hashZ", tmp);
-        }
     }
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -113,13 +98,6 @@ static ACVP_RESULT acvp_kas_ffc_output_comp_tc(ACVP_CTX *ctx,
                                                ACVP_KAS_FFC_TC *stc,
                                                JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KAS_FFC_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->test_type == ACVP_KAS_FFC_TT_VAL) {
         int diff = 1;
@@ -134,74 +112,132 @@ static ACVP_RESULT acvp_kas_ffc_output_comp_tc(ACVP_CTX *ctx,
         goto end;
     }
 
-    memzero_s(tmp, ACVP_KAS_FFC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->piut, stc->piutlen, tmp, ACVP_KAS_FFC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "ephemeralPublicIut", stc->piut, stc->piutlen, ACVP_KAS_FFC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (Z)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "ephemeralPublicIut", tmp);
 
-    memzero_s(tmp, ACVP_KAS_FFC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->chash, stc->chashlen, tmp, ACVP_KAS_FFC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "hashZIut", stc->chash, stc->chashlen, ACVP_KAS_FFC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (Z)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "hashZIut", tmp);
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
 
-static ACVP_RESULT acvp_kas_ffc_init_comp_tc(ACVP_CTX *ctx,
-                                             ACVP_KAS_FFC_TC *stc,
-                                             ACVP_HASH_ALG hash_alg,
-                                             ACVP_KAS_FFC_PARAM dgm,
-                                             const char *p,
-                                             const char *q,
-                                             const char *g,
-                                             const char *eps,
-                                             const char *epri,
-                                             const char *epui,
-                                             const char *z,
-                                             ACVP_KAS_FFC_TEST_TYPE test_type) {
+/*
+ * The domain parameters are the same for every test case of a group,
+ * so they are converted once here and copied into each test case.
+ */
+static ACVP_RESULT acvp_kas_ffc_init_group(ACVP_CTX *ctx,
+                                           ACVP_KAS_FFC_TC *group,
+                                           ACVP_CIPHER cipher,
+                                           ACVP_HASH_ALG hash_alg,
+                                           ACVP_KAS_FFC_PARAM dgm,
+                                           const char *p,
+                                           const char *q,
+                                           const char *g,
+                                           ACVP_KAS_FFC_TEST_TYPE test_type,
+                                           int limbs) {
     ACVP_RESULT rv;
 
-    stc->mode = ACVP_KAS_FFC_MODE_COMPONENT;
-    stc->md = hash_alg;
-    stc->test_type = test_type;
+    group->cipher = cipher;
+    group->mode = ACVP_KAS_FFC_MODE_COMPONENT;
+    group->md = hash_alg;
+    group->test_type = test_type;
+    group->dgm = dgm;
+    group->group = acvp_lookup_kas_ffc_group(dgm);
 
     if ((dgm == ACVP_KAS_FFC_FB) || (dgm == ACVP_KAS_FFC_FC)) {
-        stc->p = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
-        if (!stc->p) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(p, stc->p, ACVP_KAS_FFC_BYTE_MAX, &(stc->plen));
+        group->p = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
+        if (!group->p) { return ACVP_MALLOC_FAIL; }
+        rv = acvp_hexstr_to_num(limbs, p, group->p, ACVP_KAS_FFC_BYTE_MAX, &(group->plen), &group->p_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (p)");
             return rv;
         }
 
-        stc->q = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
-        if (!stc->q) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(q, stc->q, ACVP_KAS_FFC_BYTE_MAX, &(stc->qlen));
+        group->q = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
+        if (!group->q) { return ACVP_MALLOC_FAIL; }
+        rv = acvp_hexstr_to_num(limbs, q, group->q, ACVP_KAS_FFC_BYTE_MAX, &(group->qlen), &group->q_bn);
         if (rv != ACVP_SUCCESS) {
            ACVP_LOG_ERR("Hex conversion failure (q)");
            return rv;
         }
 
-        stc->g = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
-        if (!stc->g) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(g, stc->g, ACVP_KAS_FFC_BYTE_MAX, &(stc->glen));
+        group->g = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
+        if (!group->g) { return ACVP_MALLOC_FAIL; }
+        rv = acvp_hexstr_to_num(limbs, g, group->g, ACVP_KAS_FFC_BYTE_MAX, &(group->glen), &group->g_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (g)");
             return rv;
         }
     }
+    return ACVP_SUCCESS;
+}
+
+static ACVP_RESULT acvp_kas_ffc_bn_copy(ACVP_BN *dest, const ACVP_BN *src) {
+    size_t size = 0;
+
+    if (!src->limbs) {
+        return ACVP_SUCCESS;
+    }
+    size = sizeof(unsigned long long int) * src->limbs_cnt;
+    dest->limbs = malloc(size);
+    if (!dest->limbs) { return ACVP_MALLOC_FAIL; }
+    memcpy_s(dest->limbs, size, src->limbs, size);
+    dest->limbs_cnt = src->limbs_cnt;
+    dest->bits = src->bits;
+    return ACVP_SUCCESS;
+}
+
+static ACVP_RESULT acvp_kas_ffc_init_comp_tc(ACVP_CTX *ctx,
+                                             ACVP_KAS_FFC_TC *stc,
+                                             const ACVP_KAS_FFC_TC *group,
+                                             const char *eps,
+                                             const char *epri,
+                                             const char *epui,
+                                             const char *z,
+                                             int limbs) {
+    ACVP_RESULT rv;
+
+    stc->cipher = group->cipher;
+    stc->mode = group->mode;
+    stc->md = group->md;
+    stc->test_type = group->test_type;
+    stc->dgm = group->dgm;
+    stc->group = group->group;
+    stc->tg_ctx = group->tg_ctx;
+
+    if (group->p) {
+        stc->p = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
+        if (!stc->p) { return ACVP_MALLOC_FAIL; }
+        memcpy_s(stc->p, ACVP_KAS_FFC_BYTE_MAX, group->p, group->plen);
+        stc->plen = group->plen;
+        rv = acvp_kas_ffc_bn_copy(&stc->p_bn, &group->p_bn);
+        if (rv != ACVP_SUCCESS) { return rv; }
+
+        stc->q = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
+        if (!stc->q) { return ACVP_MALLOC_FAIL; }
+        memcpy_s(stc->q, ACVP_KAS_FFC_BYTE_MAX, group->q, group->qlen);
+        stc->qlen = group->qlen;
+        rv = acvp_kas_ffc_bn_copy(&stc->q_bn, &group->q_bn);
+        if (rv != ACVP_SUCCESS) { return rv; }
+
+        stc->g = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
+        if (!stc->g) { return ACVP_MALLOC_FAIL; }
+        memcpy_s(stc->g, ACVP_KAS_FFC_BYTE_MAX, group->g, group->glen);
+        stc->glen = group->glen;
+        rv = acvp_kas_ffc_bn_copy(&stc->g_bn, &group->g_bn);
+        if (rv != ACVP_SUCCESS) { return rv; }
+    }
     stc->eps = calloc(1, ACVP_KAS_FFC_BYTE_MAX);
     if (!stc->eps) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(eps, stc->eps, ACVP_KAS_FFC_BYTE_MAX, &(stc->epslen));
+    rv = acvp_hexstr_to_num(limbs, eps, stc->eps, ACVP_KAS_FFC_BYTE_MAX, &(stc->epslen), &stc->eps_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (eps)");
         return rv;
@@ -225,19 +261,18 @@ static ACVP_RESULT acvp_kas_ffc_init_comp_tc(ACVP_CTX *ctx,
             ACVP_LOG_ERR("Hex conversion failure (z)");
             return rv;
         }
-        rv = acvp_hexstr_to_bin(epri, stc->epri, ACVP_KAS_FFC_BYTE_MAX, &(stc->eprilen));
+        rv = acvp_hexstr_to_num(limbs, epri, stc->epri, ACVP_KAS_FFC_BYTE_MAX, &(stc->eprilen), &stc->epri_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (epri)");
             return rv;
         }
-        rv = acvp_hexstr_to_bin(epui, stc->epui, ACVP_KAS_FFC_BYTE_MAX, &(stc->epuilen));
+        rv = acvp_hexstr_to_num(limbs, epui, stc->epui, ACVP_KAS_FFC_BYTE_MAX, &(stc->epuilen), &stc->epui_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (epui)");
             return rv;
         }
     }
 
-    stc->dgm = dgm;
     return ACVP_SUCCESS;
 }
 
@@ -255,6 +290,12 @@ static ACVP_RESULT acvp_kas_ffc_release_tc(ACVP_KAS_FFC_TC *stc) {
     if (stc->p) free(stc->p);
     if (stc->q) free(stc->q);
     if (stc->g) free(stc->g);
+    acvp_bn_free(&stc->p_bn);
+    acvp_bn_free(&stc->q_bn);
+    acvp_bn_free(&stc->g_bn);
+    acvp_bn_free(&stc->eps_bn);
+    acvp_bn_free(&stc->epri_bn);
+    acvp_bn_free(&stc->epui_bn);
     memzero_s(stc, sizeof(ACVP_KAS_FFC_TC));
     return ACVP_SUCCESS;
 }
@@ -291,10 +332,16 @@ static ACVP_RESULT acvp_kas_ffc_comp(ACVP_CTX *ctx,
     unsigned int i, g_cnt;
     int j, t_cnt, tc_id;
     ACVP_RESULT rv;
+    ACVP_TEST_CASE group_tc;
+    ACVP_KAS_FFC_TC group_stc;
+    int group_open = 0;
     const char *test_type_str;
     ACVP_KAS_FFC_TEST_TYPE test_type;
     ACVP_KAS_FFC_PARAM pms;
 
+    group_tc.tc.kas_ffc = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_KAS_FFC_TC));
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
 
@@ -309,15 +356,15 @@ static ACVP_RESULT acvp_kas_ffc_comp(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         hash_str = json_object_get_string(groupobj, "hashAlg");
         if (!hash_str) {
@@ -410,13 +457,31 @@ static ACVP_RESULT acvp_kas_ffc_comp(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        rv = acvp_kas_ffc_init_group(ctx, &group_stc, cap->cipher, hash_alg, pms,
+                                     p, q, g, test_type, acvp_bn_limbs_enabled(cap));
+        if (rv != ACVP_SUCCESS) {
+            goto err;
+        }
+
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        if (cap->group_handler) {
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         for (j = 0; j < t_cnt; j++) {
             const char *eps = NULL, *z = NULL, *epri = NULL, *epui = NULL;
 
             ACVP_LOG_VERBOSE("Found new KAS-FFC Component test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             eps = json_object_get_string(testobj, "ephemeralPublicServer");
             if (!eps) {
@@ -495,8 +560,8 @@ static ACVP_RESULT acvp_kas_ffc_comp(ACVP_CTX *ctx,
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_kas_ffc_init_comp_tc(ctx, stc, hash_alg, pms, 
-                                           p, q, g, eps, epri, epui, z, test_type);
+            rv = acvp_kas_ffc_init_comp_tc(ctx, stc, &group_stc,
+                                           eps, epri, epui, z, acvp_bn_limbs_enabled(cap));
             if (rv != ACVP_SUCCESS) {
                 acvp_kas_ffc_release_tc(stc);
                 json_value_free(r_tval);
@@ -504,7 +569,7 @@ static ACVP_RESULT acvp_kas_ffc_comp(ACVP_CTX *ctx,
             }
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kas_ffc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -531,11 +596,24 @@ static ACVP_RESULT acvp_kas_ffc_comp(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
+        acvp_kas_ffc_release_tc(&group_stc);
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_kas_ffc_release_tc(&group_stc);
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -554,7 +632,6 @@ ACVP_RESULT acvp_kas_ffc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KAS_FFC_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
     const char *mode_str = NULL;
     ACVP_SUB_KAS alg;
 
@@ -587,7 +664,7 @@ ACVP_RESULT acvp_kas_ffc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -648,9 +725,7 @@ ACVP_RESULT acvp_kas_ffc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -682,9 +757,15 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
     unsigned int i, g_cnt;
     int j, t_cnt, tc_id;
     ACVP_RESULT rv;
+    ACVP_TEST_CASE group_tc;
+    ACVP_KAS_FFC_TC group_stc;
+    int group_open = 0;
     const char *test_type_str;
     ACVP_KAS_FFC_TEST_TYPE test_type;
     ACVP_KAS_FFC_PARAM dgm;
+    group_tc.tc.kas_ffc = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_KAS_FFC_TC));
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
 
@@ -699,7 +780,8 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
@@ -720,8 +802,7 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
         }
 
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         //If the user doesn't specify a hash function, neither does the server
         if (cap && cap->cap.kas_ffc_cap) {
@@ -822,13 +903,31 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        rv = acvp_kas_ffc_init_group(ctx, &group_stc, cap->cipher, hash_alg, dgm,
+                                     p, q, g, test_type, acvp_bn_limbs_enabled(cap));
+        if (rv != ACVP_SUCCESS) {
+            goto err;
+        }
+
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        if (cap->group_handler) {
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         for (j = 0; j < t_cnt; j++) {
             const char *eps = NULL, *z = NULL, *epri = NULL, *epui = NULL;
 
             ACVP_LOG_VERBOSE("Found new KAS-FFC SSC test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             eps = json_object_get_string(testobj, "ephemeralPublicServer");
             if (!eps) {
@@ -918,8 +1017,8 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_kas_ffc_init_comp_tc(ctx, stc, hash_alg, dgm,
-                                           p, q, g, eps, epri, epui, z, test_type);
+            rv = acvp_kas_ffc_init_comp_tc(ctx, stc, &group_stc,
+                                           eps, epri, epui, z, acvp_bn_limbs_enabled(cap));
             if (rv != ACVP_SUCCESS) {
                 acvp_kas_ffc_release_tc(stc);
                 json_value_free(r_tval);
@@ -927,7 +1026,7 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
             }
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kas_ffc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -954,11 +1053,24 @@ static ACVP_RESULT acvp_kas_ffc_ssc(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
+        acvp_kas_ffc_release_tc(&group_stc);
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_kas_ffc_release_tc(&group_stc);
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -977,7 +1089,6 @@ ACVP_RESULT acvp_kas_ffc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KAS_FFC_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -1008,7 +1119,7 @@ ACVP_RESULT acvp_kas_ffc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1025,9 +1136,7 @@ ACVP_RESULT acvp_kas_ffc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
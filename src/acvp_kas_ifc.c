@@ -27,75 +27,54 @@ static ACVP_RESULT acvp_kas_ifc_ssc_output_tc(ACVP_CTX *ctx,
                                               ACVP_KAS_IFC_TC *stc,
                                               JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_INVALID_ARG;
-    char *tmp = NULL;
     unsigned char *merge = NULL;
     int z_len = 0;
 
-    tmp = calloc(ACVP_KAS_IFC_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
-
     if (stc->kas_role == ACVP_KAS_IFC_INITIATOR) {
-        rv = acvp_bin_to_hexstr(stc->iut_ct_z, stc->iut_ct_z_len, tmp, ACVP_KAS_IFC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "iutC", stc->iut_ct_z, stc->iut_ct_z_len, ACVP_KAS_IFC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (iut_ct_z)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "iutC", tmp);
 
-        rv = acvp_bin_to_hexstr(stc->iut_pt_z, stc->iut_pt_z_len, tmp, ACVP_KAS_IFC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, stc->md == ACVP_NO_SHA ? "iutZ" : "iutHashZ",
+                               stc->iut_pt_z, stc->iut_pt_z_len, ACVP_KAS_IFC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (iut_pt_z)");
             goto end;
         }
-        if (stc->md == ACVP_NO_SHA) {
-            json_object_set_string(tc_rsp, "iutZ", tmp);
-        } else {
-            json_object_set_string(tc_rsp, "iutHashZ", tmp);
-        }
         /* for KAS1, z is just iutZ. For KAS2, its the combined z. */
-        if (stc->md == ACVP_NO_SHA) {
-            json_object_set_string(tc_rsp, "z", tmp);
-        } else {
-            json_object_set_string(tc_rsp, "hashZ", tmp);
+        rv = acvp_json_set_hex(tc_rsp, stc->md == ACVP_NO_SHA ? "z" : "hashZ",
+                               stc->iut_pt_z, stc->iut_pt_z_len, ACVP_KAS_IFC_STR_MAX);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("hex conversion failure (iut_pt_z)");
+            goto end;
         }
     } else { /* if role = responder */
         if (stc->scheme == ACVP_KAS_IFC_KAS2) {
-            rv = acvp_bin_to_hexstr(stc->iut_ct_z, stc->iut_ct_z_len, tmp, ACVP_KAS_IFC_STR_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "iutC", stc->iut_ct_z, stc->iut_ct_z_len, ACVP_KAS_IFC_STR_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (iut_ct_z)");
                 goto end;
             }
-            json_object_set_string(tc_rsp, "iutC", tmp);
 
-            rv = acvp_bin_to_hexstr(stc->iut_pt_z, stc->iut_pt_z_len, tmp, ACVP_KAS_IFC_STR_MAX);
+            rv = acvp_json_set_hex(tc_rsp, stc->md == ACVP_NO_SHA ? "iutZ" : "iutHashZ",
+                                   stc->iut_pt_z, stc->iut_pt_z_len, ACVP_KAS_IFC_STR_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (iut_pt_z)");
                 goto end;
             }
-            if (stc->md == ACVP_NO_SHA) {
-                json_object_set_string(tc_rsp, "iutZ", tmp);
-            } else {
-                json_object_set_string(tc_rsp, "iutHashZ", tmp);
-            }
         } else {
-            rv = acvp_bin_to_hexstr(stc->server_pt_z, stc->server_pt_z_len, tmp, ACVP_KAS_IFC_STR_MAX);
+            rv = acvp_json_set_hex(tc_rsp, stc->md == ACVP_NO_SHA ? "z" : "hashZ",
+                                   stc->server_pt_z, stc->server_pt_z_len, ACVP_KAS_IFC_STR_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (server_pt_z)");
                 goto end;
             }
-            if (stc->md == ACVP_NO_SHA) {
-                json_object_set_string(tc_rsp, "z", tmp);
-            } else {
-                json_object_set_string(tc_rsp, "hashZ", tmp);
-            }
         }
     }
 
     if (stc->scheme == ACVP_KAS_IFC_KAS2) {
-        memzero_s(tmp, ACVP_KAS_IFC_STR_MAX);
 
         z_len = stc->iut_pt_z_len + stc->server_pt_z_len;
         merge = calloc(z_len, sizeof(unsigned char));
@@ -112,17 +91,15 @@ static ACVP_RESULT acvp_kas_ifc_ssc_output_tc(ACVP_CTX *ctx,
             memcpy_s(merge + stc->server_pt_z_len, z_len - stc->server_pt_z_len,
                         stc->iut_pt_z, stc->iut_pt_z_len);
         }
-        rv = acvp_bin_to_hexstr((const unsigned char *)merge, z_len, tmp, ACVP_KAS_IFC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "z", (const unsigned char *)merge, z_len, ACVP_KAS_IFC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (KAS2 combined Z)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "z", tmp);
 
     }
 
 end:
-    if (tmp) free(tmp);
     if (merge) free(merge);
     return rv;
 }
@@ -207,7 +184,8 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
                                             const char *dmq1,
                                             const char *iqmp,
                                             unsigned int modulo,
-                                            ACVP_KAS_IFC_TEST_TYPE test_type) {
+                                            ACVP_KAS_IFC_TEST_TYPE test_type,
+                                            int limbs) {
     ACVP_RESULT rv;
 
     stc->test_type = test_type;
@@ -220,7 +198,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (p) {
         stc->p = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->p) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(p, stc->p, ACVP_KAS_IFC_BYTE_MAX, &(stc->plen));
+        rv = acvp_hexstr_to_num(limbs, p, stc->p, ACVP_KAS_IFC_BYTE_MAX, &(stc->plen), &stc->p_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (p)");
             return rv;
@@ -230,7 +208,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (q) {
         stc->q = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->q) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(q, stc->q, ACVP_KAS_IFC_BYTE_MAX, &(stc->qlen));
+        rv = acvp_hexstr_to_num(limbs, q, stc->q, ACVP_KAS_IFC_BYTE_MAX, &(stc->qlen), &stc->q_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (q)");
             return rv;
@@ -240,7 +218,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (d) {
         stc->d = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->d) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(d, stc->d, ACVP_KAS_IFC_BYTE_MAX, &(stc->dlen));
+        rv = acvp_hexstr_to_num(limbs, d, stc->d, ACVP_KAS_IFC_BYTE_MAX, &(stc->dlen), &stc->d_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (d)");
             return rv;
@@ -250,7 +228,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (n) {
         stc->n = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->n) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(n, stc->n, ACVP_KAS_IFC_BYTE_MAX, &(stc->nlen));
+        rv = acvp_hexstr_to_num(limbs, n, stc->n, ACVP_KAS_IFC_BYTE_MAX, &(stc->nlen), &stc->n_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (n)");
             return rv;
@@ -260,7 +238,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (e) {
         stc->e = calloc(1, ACVP_RSA_EXP_LEN_MAX);
         if (!stc->e) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(e, stc->e, ACVP_RSA_EXP_LEN_MAX, &(stc->elen));
+        rv = acvp_hexstr_to_num(limbs, e, stc->e, ACVP_RSA_EXP_LEN_MAX, &(stc->elen), &stc->e_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (e)");
             return rv;
@@ -270,7 +248,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (dmp1) {
         stc->dmp1 = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->dmp1) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(dmp1, stc->dmp1, ACVP_KAS_IFC_BYTE_MAX, &(stc->dmp1_len));
+        rv = acvp_hexstr_to_num(limbs, dmp1, stc->dmp1, ACVP_KAS_IFC_BYTE_MAX, &(stc->dmp1_len), &stc->dmp1_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dmp1)");
             return rv;
@@ -280,7 +258,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (dmq1) {
         stc->dmq1 = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->dmq1) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(dmq1, stc->dmq1, ACVP_KAS_IFC_BYTE_MAX, &(stc->dmq1_len));
+        rv = acvp_hexstr_to_num(limbs, dmq1, stc->dmq1, ACVP_KAS_IFC_BYTE_MAX, &(stc->dmq1_len), &stc->dmq1_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dmq1)");
             return rv;
@@ -290,7 +268,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (iqmp) {
         stc->iqmp = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->iqmp) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(iqmp, stc->iqmp, ACVP_KAS_IFC_BYTE_MAX, &(stc->iqmp_len));
+        rv = acvp_hexstr_to_num(limbs, iqmp, stc->iqmp, ACVP_KAS_IFC_BYTE_MAX, &(stc->iqmp_len), &stc->iqmp_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (iqmp)");
             return rv;
@@ -320,7 +298,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (server_n) {
         stc->server_n = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->server_n) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(server_n, stc->server_n, ACVP_KAS_IFC_BYTE_MAX, &(stc->server_nlen));
+        rv = acvp_hexstr_to_num(limbs, server_n, stc->server_n, ACVP_KAS_IFC_BYTE_MAX, &(stc->server_nlen), &stc->server_n_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (server_n)");
             return rv;
@@ -330,7 +308,7 @@ static ACVP_RESULT acvp_kas_ifc_ssc_init_tc(ACVP_CTX *ctx,
     if (server_e) {
         stc->server_e = calloc(1, ACVP_KAS_IFC_BYTE_MAX);
         if (!stc->server_e) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(server_e, stc->server_e, ACVP_RSA_EXP_LEN_MAX, &(stc->server_elen));
+        rv = acvp_hexstr_to_num(limbs, server_e, stc->server_e, ACVP_RSA_EXP_LEN_MAX, &(stc->server_elen), &stc->server_e_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (server_e)");
             return rv;
@@ -403,6 +381,16 @@ static ACVP_RESULT acvp_kas_ifc_release_tc(ACVP_KAS_IFC_TC *stc) {
     if (stc->server_pt_z) free(stc->server_pt_z);
     if (stc->server_ct_z) free(stc->server_ct_z);
     if (stc->provided_kas2_z) free(stc->provided_kas2_z);
+    acvp_bn_free(&stc->server_n_bn);
+    acvp_bn_free(&stc->server_e_bn);
+    acvp_bn_free(&stc->p_bn);
+    acvp_bn_free(&stc->q_bn);
+    acvp_bn_free(&stc->d_bn);
+    acvp_bn_free(&stc->e_bn);
+    acvp_bn_free(&stc->n_bn);
+    acvp_bn_free(&stc->dmp1_bn);
+    acvp_bn_free(&stc->dmq1_bn);
+    acvp_bn_free(&stc->iqmp_bn);
     memzero_s(stc, sizeof(ACVP_KAS_IFC_TC));
     return ACVP_SUCCESS;
 }
@@ -469,6 +457,15 @@ static ACVP_RESULT acvp_kas_ifc_ssc(ACVP_CTX *ctx,
     ACVP_KAS_IFC_PARAM scheme = ACVP_KAS_IFC_KAS1;
     ACVP_KAS_IFC_KEYGEN key_gen = 0;
 
+    ACVP_TEST_CASE group_tc;
+    ACVP_KAS_IFC_TC group_stc;
+    ACVP_TG_KEYS keys;
+    unsigned int key_id = 0;
+    int group_open = 0;
+
+    group_tc.tc.kas_ifc = &group_stc;
+    memzero_s(&keys, sizeof(ACVP_TG_KEYS));
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
 
@@ -483,15 +480,15 @@ static ACVP_RESULT acvp_kas_ifc_ssc(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
 
         test_type_str = json_object_get_string(groupobj, "testType");
@@ -608,12 +605,41 @@ static ACVP_RESULT acvp_kas_ifc_ssc(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_KAS_IFC_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = cap->cipher;
+            group_stc.test_type = test_type;
+            group_stc.key_gen = key_gen;
+            group_stc.md = hash_alg;
+            group_stc.scheme = scheme;
+            group_stc.kas_role = role;
+            group_stc.modulo = modulo;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         for (j = 0; j < t_cnt; j++) {
 
             ACVP_LOG_VERBOSE("Found new KAS-IFC Component test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
+
+            /*
+             * Which of these a test case has depends on the group, none
+             * may be left over from a test case of another group, which
+             * need not be parsed any more, see json_parse_string_lazy()
+             */
+            p = q = n = d = e = dmp1 = dmq1 = iqmp = NULL;
+            server_n = server_e = NULL;
+            ct_z = pt_z = kas2_z = server_ct_z = NULL;
 
             if (role == ACVP_KAS_IFC_RESPONDER || scheme == ACVP_KAS_IFC_KAS2) {
                 p = json_object_get_string(testobj, "iutP");
@@ -863,6 +889,11 @@ static ACVP_RESULT acvp_kas_ifc_ssc(ACVP_CTX *ctx,
             }
             ACVP_LOG_VERBOSE("              c: %s", ct_z);
 
+            key_id = 0;
+            if (role == ACVP_KAS_IFC_RESPONDER || scheme == ACVP_KAS_IFC_KAS2) {
+                key_id = acvp_tg_key_id(&keys, n, (key_gen == ACVP_KAS_IFC_RSAKPG1_CRT || key_gen == ACVP_KAS_IFC_RSAKPG2_CRT) ? dmp1 : d, ACVP_KAS_IFC_STR_MAX);
+            }
+
             /*
              * Create a new test case in the response
              */
@@ -876,15 +907,18 @@ static ACVP_RESULT acvp_kas_ifc_ssc(ACVP_CTX *ctx,
              */
             rv = acvp_kas_ifc_ssc_init_tc(ctx, stc, key_gen, hash_alg, scheme, role, pt_z, ct_z,
                                           server_ct_z, kas2_z, server_n, server_e, p, q, d, n,
-                                          e, dmp1, dmq1, iqmp, modulo, test_type);
+                                          e, dmp1, dmq1, iqmp, modulo, test_type,
+                                          acvp_bn_limbs_enabled(cap));
             if (rv != ACVP_SUCCESS) {
                 acvp_kas_ifc_release_tc(stc);
                 json_value_free(r_tval);
                 goto err;
             }
+            stc->key_id = key_id;
+            stc->tg_ctx = group_stc.tg_ctx;
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kas_ifc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -915,11 +949,24 @@ static ACVP_RESULT acvp_kas_ifc_ssc(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        acvp_tg_keys_clear(&keys);
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_tg_keys_clear(&keys);
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -938,7 +985,6 @@ ACVP_RESULT acvp_kas_ifc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KAS_IFC_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -969,7 +1015,7 @@ ACVP_RESULT acvp_kas_ifc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -986,9 +1032,7 @@ ACVP_RESULT acvp_kas_ifc_ssc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
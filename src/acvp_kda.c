@@ -17,6 +17,169 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+/*
+ * A fixedInfoPattern compiled once for a test group: the candidates in the
+ * order they are concatenated, the decoded literal (if any), and the number
+ * of bytes the literal and L add to the fixedInfo of every test case.
+ */
+typedef struct acvp_kda_fixed_info_plan_t {
+    ACVP_KDA_PATTERN_CANDIDATE cand[ACVP_KDA_PATTERN_MAX];
+    int count;
+    unsigned char *literal;
+    int literalLen;
+    int constLen;
+} ACVP_KDA_FIXED_INFO_PLAN;
+
+static void acvp_kda_release_plan(ACVP_KDA_FIXED_INFO_PLAN *plan) {
+    if (plan->literal) free(plan->literal);
+    memzero_s(plan, sizeof(ACVP_KDA_FIXED_INFO_PLAN));
+}
+
+static void acvp_kda_append(unsigned char *buf, int total, int *off, const unsigned char *src, int len) {
+    if (len <= 0) {
+        return;
+    }
+    memcpy_s(buf + *off, total - *off, src, len);
+    *off += len;
+}
+
+/*
+ * Concatenates the fixedInfo of a test case in the order of the group's plan.
+ * The length is summed from the plan before anything is copied so the buffer
+ * is allocated once. l is in bits.
+ */
+static ACVP_RESULT acvp_kda_build_fixed_info(ACVP_CTX *ctx,
+                                             const ACVP_KDA_FIXED_INFO_PLAN *plan,
+                                             const unsigned char *uPartyId, int uPartyIdLen,
+                                             const unsigned char *uEphemeralData, int uEphemeralLen,
+                                             const unsigned char *vPartyId, int vPartyIdLen,
+                                             const unsigned char *vEphemeralData, int vEphemeralLen,
+                                             const unsigned char *algId, int algIdLen,
+                                             const unsigned char *label, int labelLen,
+                                             const unsigned char *context, int contextLen,
+                                             const unsigned char *t, int tLen,
+                                             int l,
+                                             unsigned char **fixedInfo,
+                                             int *fixedInfoLen) {
+    unsigned char *buf = NULL, lBits[4];
+    int i = 0, total = plan->constLen, off = 0;
+
+    for (i = 0; i < plan->count; i++) {
+        switch (plan->cand[i]) {
+        case ACVP_KDA_PATTERN_UPARTYINFO:
+            if (!uPartyId) goto missing;
+            total += uPartyIdLen + uEphemeralLen;
+            break;
+        case ACVP_KDA_PATTERN_VPARTYINFO:
+            if (!vPartyId) goto missing;
+            total += vPartyIdLen + vEphemeralLen;
+            break;
+        case ACVP_KDA_PATTERN_ALGID:
+            if (!algId) goto missing;
+            total += algIdLen;
+            break;
+        case ACVP_KDA_PATTERN_LABEL:
+            if (!label) goto missing;
+            total += labelLen;
+            break;
+        case ACVP_KDA_PATTERN_CONTEXT:
+            if (!context) goto missing;
+            total += contextLen;
+            break;
+        case ACVP_KDA_PATTERN_T:
+            if (!t) goto missing;
+            total += tLen;
+            break;
+        case ACVP_KDA_PATTERN_LITERAL:
+        case ACVP_KDA_PATTERN_L:
+            break;
+        case ACVP_KDA_PATTERN_NONE:
+        case ACVP_KDA_PATTERN_MAX:
+        default:
+            ACVP_LOG_ERR("Invalid fixedInfoPattern candidate value");
+            return ACVP_INVALID_ARG;
+        }
+    }
+    if (total <= 0) {
+        ACVP_LOG_ERR("Test case fixedInfo is empty");
+        return ACVP_TC_INVALID_DATA;
+    }
+
+    buf = calloc(total, sizeof(unsigned char));
+    if (!buf) {
+        ACVP_LOG_ERR("Failed to allocate fixedInfo initializing test case");
+        return ACVP_MALLOC_FAIL;
+    }
+
+    lBits[0] = (l >> 24) & 0xff;
+    lBits[1] = (l >> 16) & 0xff;
+    lBits[2] = (l >> 8) & 0xff;
+    lBits[3] = l & 0xff;
+    for (i = 0; i < plan->count; i++) {
+        switch (plan->cand[i]) {
+        case ACVP_KDA_PATTERN_LITERAL:
+            acvp_kda_append(buf, total, &off, plan->literal, plan->literalLen);
+            break;
+        case ACVP_KDA_PATTERN_UPARTYINFO:
+            acvp_kda_append(buf, total, &off, uPartyId, uPartyIdLen);
+            acvp_kda_append(buf, total, &off, uEphemeralData, uEphemeralLen);
+            break;
+        case ACVP_KDA_PATTERN_VPARTYINFO:
+            acvp_kda_append(buf, total, &off, vPartyId, vPartyIdLen);
+            acvp_kda_append(buf, total, &off, vEphemeralData, vEphemeralLen);
+            break;
+        case ACVP_KDA_PATTERN_ALGID:
+            acvp_kda_append(buf, total, &off, algId, algIdLen);
+            break;
+        case ACVP_KDA_PATTERN_LABEL:
+            acvp_kda_append(buf, total, &off, label, labelLen);
+            break;
+        case ACVP_KDA_PATTERN_CONTEXT:
+            acvp_kda_append(buf, total, &off, context, contextLen);
+            break;
+        case ACVP_KDA_PATTERN_L:
+            acvp_kda_append(buf, total, &off, lBits, sizeof(lBits));
+            break;
+        case ACVP_KDA_PATTERN_T:
+            acvp_kda_append(buf, total, &off, t, tLen);
+            break;
+        case ACVP_KDA_PATTERN_NONE:
+        case ACVP_KDA_PATTERN_MAX:
+        default:
+            break;
+        }
+    }
+
+    *fixedInfo = buf;
+    *fixedInfoLen = total;
+    return ACVP_SUCCESS;
+
+missing:
+    ACVP_LOG_ERR("Test case missing data for fixedInfoPattern candidate");
+    return ACVP_TC_MISSING_DATA;
+}
+
+/*
+ * Copies the group's decoded literal into the test case, which the crypto
+ * module may still read alongside the assembled fixedInfo.
+ */
+static ACVP_RESULT acvp_kda_copy_literal(ACVP_CTX *ctx,
+                                         const ACVP_KDA_FIXED_INFO_PLAN *plan,
+                                         unsigned char **literal,
+                                         int *literalLen) {
+    if (!plan->literal) {
+        return ACVP_SUCCESS;
+    }
+    *literal = calloc(ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, 1);
+    if (!*literal) {
+        ACVP_LOG_ERR("Failed to allocate memory when setting literal pattern");
+        return ACVP_MALLOC_FAIL;
+    }
+    memcpy_s(*literal, ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, plan->literal, plan->literalLen);
+    *literalLen = plan->literalLen;
+    return ACVP_SUCCESS;
+}
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -27,13 +190,6 @@ static ACVP_RESULT acvp_kda_hkdf_output_tc(ACVP_CTX *ctx,
                                                ACVP_KDA_HKDF_TC *stc,
                                                JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDA_DKM_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_kda_hkdf_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->type == ACVP_KDA_TT_VAL) {
         int diff = 1;
@@ -48,17 +204,13 @@ static ACVP_RESULT acvp_kda_hkdf_output_tc(ACVP_CTX *ctx,
         goto end;
     }
 
-    memzero_s(tmp, ACVP_KDA_DKM_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->outputDkm, stc->l, tmp, ACVP_KDA_DKM_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "dkm", stc->outputDkm, stc->l, ACVP_KDA_DKM_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (dkm)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "dkm", tmp);
-
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -67,13 +219,6 @@ static ACVP_RESULT acvp_kda_onestep_output_tc(ACVP_CTX *ctx,
                                                ACVP_KDA_ONESTEP_TC *stc,
                                                JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDA_DKM_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_kda_onestep_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->type == ACVP_KDA_TT_VAL) {
         int diff = 1;
@@ -88,17 +233,13 @@ static ACVP_RESULT acvp_kda_onestep_output_tc(ACVP_CTX *ctx,
         goto end;
     }
 
-    memzero_s(tmp, ACVP_KDA_DKM_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->outputDkm, stc->l, tmp, ACVP_KDA_DKM_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "dkm", stc->outputDkm, stc->l, ACVP_KDA_DKM_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (dkm)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "dkm", tmp);
-
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -122,7 +263,7 @@ static ACVP_RESULT acvp_kda_onestep_init_tc(ACVP_CTX *ctx,
                                              const int saltLen,
                                              ACVP_KDA_MAC_SALT_METHOD saltMethod,
                                              ACVP_KDA_ENCODING encoding,
-                                             ACVP_KDA_PATTERN_CANDIDATE *fixedArr,
+                                             const ACVP_KDA_FIXED_INFO_PLAN *plan,
                                              ACVP_KDA_TEST_TYPE test_type) {
     ACVP_RESULT rv;
 
@@ -134,11 +275,15 @@ static ACVP_RESULT acvp_kda_onestep_init_tc(ACVP_CTX *ctx,
     stc->encoding = encoding;
     stc->saltMethod = saltMethod;
 
-    if (memcpy_s(stc->fixedInfoPattern, ACVP_KDA_PATTERN_MAX * sizeof(int), fixedArr, ACVP_KDA_PATTERN_MAX * sizeof(int))) {
+    if (memcpy_s(stc->fixedInfoPattern, ACVP_KDA_PATTERN_MAX * sizeof(int), plan->cand, ACVP_KDA_PATTERN_MAX * sizeof(int))) {
         ACVP_LOG_ERR("Error copying array of fixedInfoPattern candidates into test case structure");
         rv = ACVP_MALLOC_FAIL;
         return rv;
-    } 
+    }
+    rv = acvp_kda_copy_literal(ctx, plan, &stc->literalCandidate, &stc->literalLen);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
     if (salt) {
         stc->salt = calloc(1, ACVP_KDA_SALT_BYTE_MAX);
         if (!stc->salt) { return ACVP_MALLOC_FAIL; }
@@ -247,20 +392,21 @@ static ACVP_RESULT acvp_kda_onestep_init_tc(ACVP_CTX *ctx,
         }
     }
 
-    return ACVP_SUCCESS;
+    return acvp_kda_build_fixed_info(ctx, plan, stc->uPartyId, stc->uPartyIdLen,
+                                     stc->uEphemeralData, stc->uEphemeralLen,
+                                     stc->vPartyId, stc->vPartyIdLen,
+                                     stc->vEphemeralData, stc->vEphemeralLen,
+                                     stc->algorithmId, stc->algIdLen,
+                                     stc->label, stc->labelLen,
+                                     stc->context, stc->contextLen,
+                                     stc->t, stc->tLen, l,
+                                     &stc->fixedInfo, &stc->fixedInfoLen);
 }
 
 static ACVP_RESULT acvp_kda_twostep_output_tc(ACVP_CTX *ctx,
                                                ACVP_KDA_TWOSTEP_TC *stc,
                                                JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDA_DKM_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_kda_twostep_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->type == ACVP_KDA_TT_VAL) {
         int diff = 1;
@@ -276,17 +422,13 @@ static ACVP_RESULT acvp_kda_twostep_output_tc(ACVP_CTX *ctx,
         goto end;
     }
 
-    memzero_s(tmp, ACVP_KDA_DKM_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->outputDkm, stc->l, tmp, ACVP_KDA_DKM_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "dkm", stc->outputDkm, stc->l, ACVP_KDA_DKM_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (dkm)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "dkm", tmp);
-
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -316,7 +458,7 @@ static ACVP_RESULT acvp_kda_twostep_init_tc(ACVP_CTX *ctx,
                                              ACVP_KDF108_MODE kdfMode,
                                              ACVP_KDF108_FIXED_DATA_ORDER_VAL counterLocation,
                                              ACVP_KDA_ENCODING encoding,
-                                             ACVP_KDA_PATTERN_CANDIDATE *fixedArr,
+                                             const ACVP_KDA_FIXED_INFO_PLAN *plan,
                                              ACVP_KDA_TEST_TYPE test_type) {
     ACVP_RESULT rv;
 
@@ -332,11 +474,15 @@ static ACVP_RESULT acvp_kda_twostep_init_tc(ACVP_CTX *ctx,
     stc->counterLen = counterLen;
     stc->uses_hybrid_secret = hybrid_secret;
 
-    if (memcpy_s(stc->fixedInfoPattern, ACVP_KDA_PATTERN_MAX * sizeof(int), fixedArr, ACVP_KDA_PATTERN_MAX * sizeof(int))) {
+    if (memcpy_s(stc->fixedInfoPattern, ACVP_KDA_PATTERN_MAX * sizeof(int), plan->cand, ACVP_KDA_PATTERN_MAX * sizeof(int))) {
         ACVP_LOG_ERR("Error copying array of fixedInfoPattern candidates into test case structure");
         rv = ACVP_MALLOC_FAIL;
         return rv;
-    } 
+    }
+    rv = acvp_kda_copy_literal(ctx, plan, &stc->literalCandidate, &stc->literalLen);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
 
     stc->salt = calloc(1, ACVP_KDA_SALT_BYTE_MAX);
     if (!stc->salt) { return ACVP_MALLOC_FAIL; }
@@ -455,7 +601,15 @@ static ACVP_RESULT acvp_kda_twostep_init_tc(ACVP_CTX *ctx,
         }
     }
 
-    return ACVP_SUCCESS;
+    return acvp_kda_build_fixed_info(ctx, plan, stc->uPartyId, stc->uPartyIdLen,
+                                     stc->uEphemeralData, stc->uEphemeralLen,
+                                     stc->vPartyId, stc->vPartyIdLen,
+                                     stc->vEphemeralData, stc->vEphemeralLen,
+                                     stc->algorithmId, stc->algIdLen,
+                                     stc->label, stc->labelLen,
+                                     stc->context, stc->contextLen,
+                                     stc->t, stc->tLen, l,
+                                     &stc->fixedInfo, &stc->fixedInfoLen);
 }
 
 static ACVP_RESULT acvp_kda_hkdf_init_tc(ACVP_CTX *ctx,
@@ -478,7 +632,7 @@ static ACVP_RESULT acvp_kda_hkdf_init_tc(ACVP_CTX *ctx,
                                              const int saltLen,
                                              ACVP_KDA_MAC_SALT_METHOD saltMethod,
                                              ACVP_KDA_ENCODING encoding,
-                                             ACVP_KDA_PATTERN_CANDIDATE *fixedArr,
+                                             const ACVP_KDA_FIXED_INFO_PLAN *plan,
                                              ACVP_KDA_TEST_TYPE test_type) {
     ACVP_RESULT rv;
 
@@ -491,11 +645,15 @@ static ACVP_RESULT acvp_kda_hkdf_init_tc(ACVP_CTX *ctx,
     stc->saltMethod = saltMethod;
     stc->uses_hybrid_secret = hybrid_secret;
 
-    if (memcpy_s(stc->fixedInfoPattern, ACVP_KDA_PATTERN_MAX * sizeof(int), fixedArr, ACVP_KDA_PATTERN_MAX * sizeof(int))) {
+    if (memcpy_s(stc->fixedInfoPattern, ACVP_KDA_PATTERN_MAX * sizeof(int), plan->cand, ACVP_KDA_PATTERN_MAX * sizeof(int))) {
         ACVP_LOG_ERR("Error copying array of fixedInfoPattern candidates into test case structure");
         rv = ACVP_MALLOC_FAIL;
         return rv;
-    } 
+    }
+    rv = acvp_kda_copy_literal(ctx, plan, &stc->literalCandidate, &stc->literalLen);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
 
     stc->salt = calloc(1, ACVP_KDA_SALT_BYTE_MAX);
     if (!stc->salt) { return ACVP_MALLOC_FAIL; }
@@ -603,7 +761,15 @@ static ACVP_RESULT acvp_kda_hkdf_init_tc(ACVP_CTX *ctx,
         }
     }
 
-    return ACVP_SUCCESS;
+    return acvp_kda_build_fixed_info(ctx, plan, stc->uPartyId, stc->uPartyIdLen,
+                                     stc->uEphemeralData, stc->uEphemeralLen,
+                                     stc->vPartyId, stc->vPartyIdLen,
+                                     stc->vEphemeralData, stc->vEphemeralLen,
+                                     stc->algorithmId, stc->algIdLen,
+                                     stc->label, stc->labelLen,
+                                     stc->context, stc->contextLen,
+                                     stc->t, stc->tLen, l,
+                                     &stc->fixedInfo, &stc->fixedInfoLen);
 }
 
 /*
@@ -626,6 +792,7 @@ static ACVP_RESULT acvp_kda_release_tc(ACVP_CIPHER cipher, ACVP_TEST_CASE *tc) {
         if (stc->vEphemeralData) free(stc->vEphemeralData);
         if (stc->providedDkm) free(stc->providedDkm);
         if (stc->outputDkm) free(stc->outputDkm);
+        if (stc->fixedInfo) free(stc->fixedInfo);
         memzero_s(stc, sizeof(ACVP_KDA_HKDF_TC));
     } else if (cipher == ACVP_KDA_ONESTEP) {
         ACVP_KDA_ONESTEP_TC *stc = tc->tc.kda_onestep;
@@ -642,6 +809,7 @@ static ACVP_RESULT acvp_kda_release_tc(ACVP_CIPHER cipher, ACVP_TEST_CASE *tc) {
         if (stc->vEphemeralData) free(stc->vEphemeralData);
         if (stc->providedDkm) free(stc->providedDkm);
         if (stc->outputDkm) free(stc->outputDkm);
+        if (stc->fixedInfo) free(stc->fixedInfo);
         memzero_s(stc, sizeof(ACVP_KDA_ONESTEP_TC));
     } else if (cipher == ACVP_KDA_TWOSTEP) {
         ACVP_KDA_TWOSTEP_TC *stc = tc->tc.kda_twostep;
@@ -659,6 +827,7 @@ static ACVP_RESULT acvp_kda_release_tc(ACVP_CIPHER cipher, ACVP_TEST_CASE *tc) {
         if (stc->vEphemeralData) free(stc->vEphemeralData);
         if (stc->providedDkm) free(stc->providedDkm);
         if (stc->outputDkm) free(stc->outputDkm);
+        if (stc->fixedInfo) free(stc->fixedInfo);
         memzero_s(stc, sizeof(ACVP_KDA_TWOSTEP_TC));
     } else {
         return ACVP_UNSUPPORTED_OP;
@@ -678,7 +847,7 @@ static ACVP_KDA_TEST_TYPE read_test_type(const char *str) {
     return 0;
 }
 
-ACVP_KDA_PATTERN_CANDIDATE cmp_pattern_str(ACVP_CTX *ctx, ACVP_CIPHER cipher, const char *str, ACVP_TEST_CASE *tc) {
+static ACVP_KDA_PATTERN_CANDIDATE cmp_pattern_str(ACVP_CTX *ctx, const char *str, ACVP_KDA_FIXED_INFO_PLAN *plan) {
     //size of (preprocessor string) includes null terminator
     ACVP_RESULT rv =  ACVP_SUCCESS;
     char *tmp = NULL, *lit = NULL, *token = NULL;
@@ -743,26 +912,22 @@ ACVP_KDA_PATTERN_CANDIDATE cmp_pattern_str(ACVP_CTX *ctx, ACVP_CIPHER cipher, co
                 ACVP_LOG_ERR("Patttern literal too long");
                 goto err;
             }
-            if (cipher == ACVP_KDA_HKDF) {
-                tc->tc.kda_hkdf->literalCandidate = calloc(ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, 1);
-                if (!tc->tc.kda_hkdf->literalCandidate) {
-                    ACVP_LOG_ERR("Failed to allocate memory when setting literal pattern");
-                    goto err;
-                }
-                rv = acvp_hexstr_to_bin(token, tc->tc.kda_hkdf->literalCandidate, ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, &(tc->tc.kda_hkdf->literalLen));
-            } else {
-                tc->tc.kda_onestep->literalCandidate = calloc(ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, 1);
-                if (!tc->tc.kda_onestep->literalCandidate) {
-                    ACVP_LOG_ERR("Failed to allocate memory when setting literal pattern");
-                    goto err;
-                }
-                rv = acvp_hexstr_to_bin(token, tc->tc.kda_onestep->literalCandidate, ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, &(tc->tc.kda_onestep->literalLen));
+            if (plan->literal) {
+                ACVP_LOG_ERR("Pattern string has more than one literal");
+                goto err;
             }
+            plan->literal = calloc(ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, 1);
+            if (!plan->literal) {
+                ACVP_LOG_ERR("Failed to allocate memory when setting literal pattern");
+                goto err;
+            }
+            rv = acvp_hexstr_to_bin(token, plan->literal, ACVP_KDA_PATTERN_LITERAL_BYTE_MAX, &(plan->literalLen));
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Hex conversion failure (literal candidate)");
                 goto err;
             }
             if (tmp) free(tmp);
+            plan->constLen += plan->literalLen;
             return ACVP_KDA_PATTERN_LITERAL;
         }
     }
@@ -773,53 +938,47 @@ err:
     return 0;
 }
 
-static ACVP_KDA_PATTERN_CANDIDATE* read_info_pattern(ACVP_CTX *ctx, ACVP_CIPHER cipher, const char *str, ACVP_TEST_CASE *tc) {
+/*
+ * Tokenizes the fixedInfoPattern of a test group into plan, which is then
+ * reused for every test case of the group.
+ */
+static ACVP_RESULT read_info_pattern(ACVP_CTX *ctx, const char *str, ACVP_KDA_FIXED_INFO_PLAN *plan) {
     ACVP_KDA_PATTERN_CANDIDATE currentCand;
     char *cpy = NULL;
-    ACVP_KDA_PATTERN_CANDIDATE *rv = NULL;
+    ACVP_RESULT rv = ACVP_MALFORMED_JSON;
     int hasUParty = 0, hasVParty = 0; //Currently, these are required
     if (!str) {
-        return NULL;
+        return ACVP_MISSING_ARG;
     }
     rsize_t len = strnlen_s(str, ACVP_KDA_PATTERN_REG_STR_MAX + 1);
     if (len > ACVP_KDA_PATTERN_REG_STR_MAX || len < 1) {
-        return NULL;
+        return ACVP_INVALID_ARG;
     }
     cpy = calloc(ACVP_KDA_PATTERN_REG_STR_MAX + 1, sizeof(char));
     if (!cpy) {
         ACVP_LOG_ERR("Failed to allocate memory in temp string while reading info pattern");
-        return NULL;
+        return ACVP_MALLOC_FAIL;
     }
     if (strncpy_s(cpy, ACVP_KDA_PATTERN_REG_STR_MAX + 1, str, ACVP_KDA_PATTERN_REG_STR_MAX)) {
         ACVP_LOG_ERR("Failed to copy string into temp holder for tokenization");
 
     }
-    //we return this to be used in the test case struct, so we want it to survive the scope of this function
-    ACVP_KDA_PATTERN_CANDIDATE *arr = calloc(ACVP_KDA_PATTERN_MAX, sizeof(int));
-    if (!arr) {
-        ACVP_LOG_ERR("Failed to allocate memory for reading fixedInfoPattern");
-        goto err;
-    }
     const char *token = NULL;
     char *tmp = NULL;
     token = strtok_s(cpy, &len, "||", &tmp);
-    int count = 0;
     if (!token) {
         ACVP_LOG_ERR("Server JSON invalid 'fixedInfoPattern'");
-        free(arr);
         goto err;
     } 
 
     do {
-        if (count >= ACVP_KDA_PATTERN_MAX) {
+        if (plan->count >= ACVP_KDA_PATTERN_MAX) {
             ACVP_LOG_ERR("Pattern string has too many elements");
-            free(arr);
             goto err;
         }
-        currentCand = cmp_pattern_str(ctx, cipher, token, tc);
+        currentCand = cmp_pattern_str(ctx, token, plan);
         if (currentCand >= ACVP_KDA_PATTERN_MAX || currentCand <= ACVP_KDA_PATTERN_NONE) {
             ACVP_LOG_ERR("Invalid pattern candidate supplied by server JSON");
-            free(arr);
             goto err;
         } else {
             if (currentCand == ACVP_KDA_PATTERN_UPARTYINFO) {
@@ -828,19 +987,22 @@ static ACVP_KDA_PATTERN_CANDIDATE* read_info_pattern(ACVP_CTX *ctx, ACVP_CIPHER
             if (currentCand == ACVP_KDA_PATTERN_VPARTYINFO) {
                 hasVParty = 1;
             }
-            arr[count] = currentCand;
+            if (currentCand == ACVP_KDA_PATTERN_L) {
+                plan->constLen += 4;
+            }
+            plan->cand[plan->count] = currentCand;
         }
-        count++;
+        plan->count++;
         token = strtok_s(NULL, &len, "||", &tmp);
     } while(token);
 
     if (!hasUParty || !hasVParty) {
-        free(arr);
         goto err;
     }
-    rv = arr;
+    rv = ACVP_SUCCESS;
 err:
     if (cpy) free(cpy);
+    if (rv != ACVP_SUCCESS) acvp_kda_release_plan(plan);
     return rv;
 }
 
@@ -907,7 +1069,7 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
     ACVP_RESULT rv;
     const char *test_type_str = NULL;
     ACVP_KDA_TEST_TYPE test_type;
-    ACVP_KDA_PATTERN_CANDIDATE *arr = NULL;
+    ACVP_KDA_FIXED_INFO_PLAN plan;
     ACVP_KDA_ENCODING encoding;
     ACVP_KDA_MAC_SALT_METHOD salt_method;
     ACVP_CAPS_LIST *kdfcap = NULL;
@@ -920,6 +1082,8 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
     ACVP_KDF108_MAC_MODE_VAL mac_mode = 0;
     ACVP_KDF108_FIXED_DATA_ORDER_VAL ctr_loc = 0;
 
+    memzero_s(&plan, sizeof(ACVP_KDA_FIXED_INFO_PLAN));
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
 
@@ -937,7 +1101,8 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
@@ -1032,6 +1197,12 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
+        rv = read_info_pattern(ctx, pattern_str, &plan);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Invalid fixedInfoPattern provided by server");
+            rv = ACVP_MALFORMED_JSON;
+            goto err;
+        }
 
         encoding_str = json_object_get_string(configobj, "fixedInfoEncoding");
         encoding = read_encoding_type(encoding_str);
@@ -1148,8 +1319,7 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
         /* in case of value not existing or being false, we have the same outcome */
         hybrid_secret = json_object_get_boolean(paramobj, "usesHybridSharedSecret");
 
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
 
         ACVP_LOG_VERBOSE("     Test group: %d", i);
@@ -1184,15 +1354,8 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
             paramobj = json_object_get_object(testobj, "kdfParameter");
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             salt = json_object_get_string(paramobj, "salt");
-          
-            arr = read_info_pattern(ctx, cipher, pattern_str, tc);
-            if (!arr || arr[0] <= ACVP_KDA_PATTERN_NONE || arr[0] > ACVP_KDA_PATTERN_MAX) {
-                ACVP_LOG_ERR("Invalid fixedInfoPattern provided by server");
-                rv = ACVP_MALFORMED_JSON;
-                goto err;
-            }
 
             //for onestep, salt only exists for HMAC aux functions
             if (cipher != ACVP_KDA_ONESTEP) {
@@ -1231,11 +1394,8 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
             }
 
             //Read the array of pattern candidates, read specific JSON objects based on whats there
-            for (k = 0; k < ACVP_KDA_PATTERN_MAX; k++) {
-                if (arr[k] >= ACVP_KDA_PATTERN_MAX || arr[k] <= ACVP_KDA_PATTERN_NONE) {
-                    break;
-                }
-                switch (arr[k]) {                    
+            for (k = 0; k < plan.count; k++) {
+                switch (plan.cand[k]) {                    
                 case ACVP_KDA_PATTERN_UPARTYINFO:
                     upartyobj = json_object_get_object(testobj, "fixedInfoPartyU");
                     if (!upartyobj) {
@@ -1375,20 +1535,17 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
             if (cipher == ACVP_KDA_HKDF) {
                 rv = acvp_kda_hkdf_init_tc(ctx, tc->tc.kda_hkdf, tc_id, hmac_alg, hybrid_secret, salt, z, t, uparty, uephemeral,
                                             vparty, vephemeral, algid, context, label, dkm, l, saltLen,
-                                            salt_method, encoding, arr, test_type);
+                                            salt_method, encoding, &plan, test_type);
             } else if (cipher == ACVP_KDA_ONESTEP) {
                 rv = acvp_kda_onestep_init_tc(ctx, tc->tc.kda_onestep, tc_id, aux_function, salt, z, t, uparty, uephemeral,
                                                 vparty, vephemeral, algid, context, label, dkm, l, saltLen,
-                                                salt_method, encoding, arr, test_type);
+                                                salt_method, encoding, &plan, test_type);
             } else {
                 rv = acvp_kda_twostep_init_tc(ctx, tc->tc.kda_twostep, tc_id, mac_mode, hybrid_secret, salt, z, iv_str, t, uparty,
                                                 uephemeral, vparty, vephemeral, algid, context, label, dkm, l, saltLen, iv_len,
-                                                ctr_len, salt_method, kdf_mode, ctr_loc, encoding, arr, test_type);
+                                                ctr_len, salt_method, kdf_mode, ctr_loc, encoding, &plan, test_type);
             }
 
-            if (arr) free(arr);
-            arr = NULL;
-
             if (rv != ACVP_SUCCESS) {
                 if (cipher == ACVP_KDA_HKDF) {
                     acvp_kda_release_tc(ACVP_KDA_HKDF, tc);
@@ -1401,7 +1558,7 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
                 goto err;
             }
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 if (cipher == ACVP_KDA_HKDF) {
                     acvp_kda_release_tc(ACVP_KDA_HKDF, tc);
                 } else if (cipher == ACVP_KDA_ONESTEP) {
@@ -1459,13 +1616,13 @@ static ACVP_RESULT acvp_kda_process(ACVP_CTX *ctx,
             json_array_append_value(r_tarr, r_tval);
         }
         json_array_append_value(r_garr, r_gval);
-        if (arr) { free(arr); arr = NULL; }
+        acvp_kda_release_plan(&plan);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kda_release_plan(&plan);
     if (rv != ACVP_SUCCESS) {
-        if (arr) free(arr);
         json_value_free(r_gval);
     }
     return rv;
@@ -1483,7 +1640,6 @@ ACVP_RESULT acvp_kda_hkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KDA_HKDF_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
     const char *mode_str = NULL;
 
     if (!ctx) {
@@ -1515,7 +1671,7 @@ ACVP_RESULT acvp_kda_hkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1554,9 +1710,7 @@ ACVP_RESULT acvp_kda_hkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1579,7 +1733,6 @@ ACVP_RESULT acvp_kda_onestep_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KDA_ONESTEP_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
     const char *mode_str = NULL;
 
     if (!ctx) {
@@ -1611,7 +1764,7 @@ ACVP_RESULT acvp_kda_onestep_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1650,9 +1803,7 @@ ACVP_RESULT acvp_kda_onestep_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -1675,7 +1826,6 @@ ACVP_RESULT acvp_kda_twostep_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KDA_TWOSTEP_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
     const char *mode_str = NULL;
 
     if (!ctx) {
@@ -1707,7 +1857,7 @@ ACVP_RESULT acvp_kda_twostep_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -1746,9 +1896,7 @@ ACVP_RESULT acvp_kda_twostep_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
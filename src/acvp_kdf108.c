@@ -27,13 +27,6 @@ static ACVP_RESULT acvp_kdf108_output_tc(ACVP_CTX *ctx,
                                          ACVP_KDF108_TC *stc,
                                          JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDF108_KEYOUT_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     /*
      * Length check
@@ -41,50 +34,32 @@ static ACVP_RESULT acvp_kdf108_output_tc(ACVP_CTX *ctx,
     if (stc->key_out_len > ACVP_KDF108_KEYOUT_BYTE_MAX) {
         ACVP_LOG_ERR("stc->key_out_len > ACVP_KDF108_KEYOUT_BYTE_MAX(%u)",
                      ACVP_KDF108_KEYOUT_BYTE_MAX);
-        rv = ACVP_INVALID_ARG;
-        goto end;
+        return ACVP_INVALID_ARG;
     }
 
-    rv = acvp_bin_to_hexstr(stc->key_out, stc->key_out_len,
-                            tmp, ACVP_KDF108_KEYOUT_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, stc->mode == ACVP_KDF108_MODE_KMAC ? "derivedKey" : "keyOut",
+                           stc->key_out, stc->key_out_len, ACVP_KDF108_KEYOUT_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (key_out)");
-        goto end;
+        return rv;
     }
-    if (stc->mode == ACVP_KDF108_MODE_KMAC) {
-        json_object_set_string(tc_rsp, "derivedKey", tmp);
-    } else {
-        json_object_set_string(tc_rsp, "keyOut", tmp);
-        free(tmp);
-
-        tmp = calloc(ACVP_KDF108_FIXED_DATA_STR_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc");
-            return ACVP_MALLOC_FAIL;
-        }
-
+    if (stc->mode != ACVP_KDF108_MODE_KMAC) {
         /*
         * Length check
         */
         if (stc->fixed_data_len > ACVP_KDF108_FIXED_DATA_BYTE_MAX) {
             ACVP_LOG_ERR("stc->fixed_data_len > ACVP_KDF108_FIXED_DATA_BYTE_MAX(%u)",
                         ACVP_KDF108_FIXED_DATA_BYTE_MAX);
-            rv = ACVP_INVALID_ARG;
-            goto end;
+            return ACVP_INVALID_ARG;
         }
 
-        rv = acvp_bin_to_hexstr(stc->fixed_data, stc->fixed_data_len,
-                                tmp, ACVP_KDF108_FIXED_DATA_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "fixedData", stc->fixed_data, stc->fixed_data_len, ACVP_KDF108_FIXED_DATA_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (fixed_data)");
-            goto end;
+            return rv;
         }
-        json_object_set_string(tc_rsp, "fixedData", tmp);
     }
 
-end:
-    if (tmp) free(tmp);
-
     return rv;
 }
 
@@ -334,12 +309,12 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
 
     ACVP_CAPS_LIST *cap;
-    ACVP_KDF108_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_KDF108_TC stc, group_stc;
+    ACVP_TEST_CASE tc, group_tc;
     ACVP_RESULT rv;
+    int group_open = 0;
     const char *alg_str = NULL;
     ACVP_CIPHER alg_id = 0;
-    char *json_result;
 
     ACVP_KDF108_MODE kdf_mode = 0;
     ACVP_KDF108_MAC_MODE_VAL mac_mode = 0;
@@ -370,6 +345,8 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.kdf108 = &stc;
+    group_tc.tc.kdf108 = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_KDF108_TC));
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -392,7 +369,7 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -421,15 +398,15 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         /* Process testGroups header info */
         if (kdf_mode == ACVP_KDF108_MODE_KMAC) {
@@ -518,6 +495,28 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         ACVP_LOG_VERBOSE("    counterLoc: %s", ctr_loc_str);
         }
 
+        /*
+         * Let the crypto module set up the group's PRF once; each test
+         * case then only brings its own key and inputs
+         */
+        if (cap->group_handler) {
+            memzero_s(&group_stc, sizeof(ACVP_KDF108_TC));
+            group_stc.cipher = ACVP_KDF108;
+            group_stc.mode = kdf_mode;
+            group_stc.mac_mode = mac_mode;
+            if (kdf_mode != ACVP_KDF108_MODE_KMAC) {
+                group_stc.counter_location = ctr_loc;
+                group_stc.counter_len = ctr_len;
+                group_stc.key_out_len = key_out_len;
+            }
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
         for (j = 0; j < t_cnt; j++) {
@@ -525,7 +524,7 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             if (kdf_mode == ACVP_KDF108_MODE_KMAC) {
                 key_in_str = json_object_get_string(testobj, "keyDerivationKey");
@@ -660,9 +659,10 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 acvp_kdf108_release_tc(&stc);
                 goto err;
             }
+            stc.tg_ctx = group_stc.tg_ctx;
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 acvp_kdf108_release_tc(&stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -695,17 +695,26 @@ ACVP_RESULT acvp_kdf108_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
@@ -22,56 +22,38 @@
  */
 static ACVP_RESULT acvp_kdf135_ikev2_output_tc(ACVP_CTX *ctx, ACVP_KDF135_IKEV2_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
-    tmp = calloc(ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX + 1, sizeof(char));
-    if (!tmp) { return ACVP_MALLOC_FAIL; }
-
-    rv = acvp_bin_to_hexstr(stc->s_key_seed, stc->key_out_len, tmp, ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "sKeySeed", stc->s_key_seed, stc->key_out_len, ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (s_key_seed)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "sKeySeed", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->s_key_seed_rekey, stc->key_out_len, tmp, ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "sKeySeedReKey", stc->s_key_seed_rekey, stc->key_out_len, ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (s_key_seed_rekey)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "sKeySeedReKey", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_IKEV2_SKEY_SEED_STR_MAX);
-    free(tmp);
-
 
-    tmp = calloc(ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX, sizeof(char));
-    rv = acvp_bin_to_hexstr(stc->derived_keying_material, stc->keying_material_len, tmp, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "derivedKeyingMaterial", stc->derived_keying_material, stc->keying_material_len, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (derived_keying_material)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "derivedKeyingMaterial", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->derived_keying_material_child, stc->keying_material_len, tmp, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "derivedKeyingMaterialChild", stc->derived_keying_material_child, stc->keying_material_len, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (derived_keying_material)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "derivedKeyingMaterialChild", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->derived_keying_material_child_dh, stc->keying_material_len, tmp, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "derivedKeyingMaterialDh", stc->derived_keying_material_child_dh, stc->keying_material_len, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (derived_keying_material)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "derivedKeyingMaterialDh", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_IKEV2_DKEY_MATERIAL_STR_MAX);
 
 err:
-    free(tmp);
     return rv;
 }
 
@@ -224,7 +206,6 @@ ACVP_RESULT acvp_kdf135_ikev2_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
     ACVP_CIPHER alg_id;
-    char *json_result;
 
     ACVP_HASH_ALG hash_alg;
     const char *hash_alg_str = NULL;
@@ -279,7 +260,7 @@ ACVP_RESULT acvp_kdf135_ikev2_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -298,15 +279,15 @@ ACVP_RESULT acvp_kdf135_ikev2_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         hash_alg_str = json_object_get_string(groupobj, "hashAlg");
         if (!hash_alg_str) {
@@ -370,7 +351,7 @@ ACVP_RESULT acvp_kdf135_ikev2_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             init_nonce = json_object_get_string(testobj, "nInit");
             if (!init_nonce) {
@@ -484,7 +465,7 @@ ACVP_RESULT acvp_kdf135_ikev2_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed");
                 acvp_kdf135_ikev2_release_tc(&stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -515,9 +496,7 @@ ACVP_RESULT acvp_kdf135_ikev2_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -9,6 +9,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -20,25 +21,27 @@
 /*
  * Forward prototypes for local functions
  */
-static ACVP_RESULT acvp_kdf135_snmp_output_tc(ACVP_CTX *ctx, ACVP_KDF135_SNMP_TC *stc, JSON_Object *tc_rsp);
+static ACVP_RESULT acvp_kdf135_snmp_init_tc(ACVP_CTX *ctx, void *tc, JSON_Object *testobj);
 
-static ACVP_RESULT acvp_kdf135_snmp_init_tc(ACVP_CTX *ctx,
-                                            ACVP_KDF135_SNMP_TC *stc,
-                                            unsigned int tc_id,
-                                            ACVP_CIPHER alg_id,
-                                            const char *engine_id,
-                                            const char *password,
-                                            unsigned int p_len);
+static void acvp_kdf135_snmp_bind(ACVP_TEST_CASE *tc, void *stc);
 
-static ACVP_RESULT acvp_kdf135_snmp_release_tc(ACVP_KDF135_SNMP_TC *stc);
+static const ACVP_KDF135_FIELD acvp_kdf135_snmp_fields[] = {
+    { "engineId", ACVP_KDF135_FIELD_GROUP, offsetof(ACVP_KDF135_SNMP_TC, engine_id),
+      offsetof(ACVP_KDF135_SNMP_TC, engine_id_len), ACVP_KDF135_SNMP_ENGID_MAX_BYTES, ACVP_MISSING_ARG, 0, 0 },
+    { "sharedKey", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SNMP_TC, s_key),
+      offsetof(ACVP_KDF135_SNMP_TC, skey_len), ACVP_KDF135_SNMP_SKEY_MAX * 2, ACVP_SUCCESS, 0, 0 }
+};
+
+static const ACVP_KDF135_TG acvp_kdf135_snmp_tg = {
+    "KDF135 SNMP", sizeof(ACVP_KDF135_SNMP_TC), offsetof(ACVP_KDF135_SNMP_TC, tc_id),
+    acvp_kdf135_snmp_fields, sizeof(acvp_kdf135_snmp_fields) / sizeof(ACVP_KDF135_FIELD),
+    acvp_kdf135_snmp_bind, acvp_kdf135_snmp_init_tc, NULL
+};
 
 
 ACVP_RESULT acvp_kdf135_snmp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
-    unsigned int tc_id;
     JSON_Value *groupval;
     JSON_Object *groupobj = NULL;
-    JSON_Value *testval;
-    JSON_Object *testobj = NULL;
     JSON_Array *groups;
     JSON_Array *tests;
 
@@ -47,25 +50,24 @@ ACVP_RESULT acvp_kdf135_snmp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
 
     int i, g_cnt;
-    int j, t_cnt;
+    int t_cnt;
 
     JSON_Value *r_vs_val = NULL;
     JSON_Object *r_vs = NULL;
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
-    JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
-    JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
+    JSON_Value *r_gval = NULL;  /* Response groupval */
+    JSON_Object *r_gobj = NULL; /* Response groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_KDF135_SNMP_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_KDF135_TG_SLOTS slots;
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
     ACVP_CIPHER alg_id;
-    const char *password = NULL;
     const char *engine_id = NULL;
     unsigned int p_len;
-    char *json_result;
 
+    memzero_s(&slots, sizeof(ACVP_KDF135_TG_SLOTS));
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -89,12 +91,6 @@ ACVP_RESULT acvp_kdf135_snmp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         return ACVP_INVALID_ARG;
     }
 
-    /*
-     * Get a reference to the abstracted test case
-     */
-    tc.tc.kdf135_snmp = &stc;
-    stc.cipher = alg_id;
-
     cap = acvp_locate_cap_entry(ctx, alg_id);
     if (!cap) {
         ACVP_LOG_ERR("ACVP server requesting unsupported capability");
@@ -113,7 +109,7 @@ ACVP_RESULT acvp_kdf135_snmp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -138,15 +134,15 @@ ACVP_RESULT acvp_kdf135_snmp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         p_len = json_object_get_number(groupobj, "passwordLength");
         if (!p_len) {
@@ -180,92 +176,29 @@ ACVP_RESULT acvp_kdf135_snmp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             goto err;
         }
 
-        for (j = 0; j < t_cnt; j++) {
-            ACVP_LOG_VERBOSE("Found new hash test vector...");
-            testval = json_array_get_value(tests, j);
-            testobj = json_value_get_object(testval);
-
-            tc_id = json_object_get_number(testobj, "tcId");
-            if (!tc_id) {
-                ACVP_LOG_ERR("Failed to include tc_id. ");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            password = json_object_get_string(testobj, "password");
-            if (!password) {
-                ACVP_LOG_ERR("Failed to include password");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-            unsigned int actual_len = strnlen_s(password, ACVP_KDF135_SNMP_PASS_LEN_MAX);
-            if (actual_len != p_len / 8) {
-                ACVP_LOG_ERR("pLen(%d) or password length(%d) incorrect", p_len, actual_len);
-                rv = ACVP_INVALID_ARG;
-                goto err;
-            }
-
-            ACVP_LOG_VERBOSE("        Test case: %d", j);
-            ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
-            ACVP_LOG_VERBOSE("         password: %s", password);
-
-            /*
-             * Create a new test case in the response
-             */
-            r_tval = json_value_init_object();
-            r_tobj = json_value_get_object(r_tval);
-
-            json_object_set_number(r_tobj, "tcId", tc_id);
-
-            /*
-             * Setup the test case data that will be passed down to
-             * the crypto module.
-             */
-            rv = acvp_kdf135_snmp_init_tc(ctx, &stc, tc_id, alg_id, engine_id, password, p_len);
-            if (rv != ACVP_SUCCESS) {
-                acvp_kdf135_snmp_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
-                ACVP_LOG_ERR("crypto module failed the operation");
-                acvp_kdf135_snmp_release_tc(&stc);
-                json_value_free(r_tval);
-                rv = ACVP_CRYPTO_MODULE_FAIL;
-                goto err;
-            }
-
-            /*
-             * Output the test case results using JSON
-             */
-            rv = acvp_kdf135_snmp_output_tc(ctx, &stc, r_tobj);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("JSON output failure in hash module");
-                acvp_kdf135_snmp_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-            /*
-             * Release all the memory associated with the test case
-             */
-            acvp_kdf135_snmp_release_tc(&stc);
-
-            /* Append the test response value to array */
-            json_array_append_value(r_tarr, r_tval);
+        /*
+         * Setup the test case data that will be passed down to
+         * the crypto module, the rest of it comes from the tests.
+         */
+        memzero_s(&stc, sizeof(ACVP_KDF135_SNMP_TC));
+        stc.cipher = alg_id;
+        stc.p_len = p_len / 8;
+        stc.skey_len = 160 / 8;
+
+        rv = acvp_kdf135_tg_run(ctx, cap, &acvp_kdf135_snmp_tg, &slots, &stc, groupobj, tests, r_tarr);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
         }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kdf135_tg_free(&slots);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
@@ -273,68 +206,27 @@ err:
 }
 
 /*
- * After the test case has been processed by the DUT, the results
- * need to be JSON formated to be included in the vector set results
- * file that will be uploaded to the server.  This routine handles
- * the JSON processing for a single test case.
+ * The password is used as it is in the JSON, which outlives the test case
  */
-static ACVP_RESULT acvp_kdf135_snmp_output_tc(ACVP_CTX *ctx, ACVP_KDF135_SNMP_TC *stc, JSON_Object *tc_rsp) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDF135_SNMP_SKEY_MAX + 1, sizeof(char));
-
-    rv = acvp_bin_to_hexstr(stc->s_key, stc->skey_len, tmp, ACVP_KDF135_SNMP_SKEY_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (s_key)");
-        goto err;
+static ACVP_RESULT acvp_kdf135_snmp_init_tc(ACVP_CTX *ctx, void *tc, JSON_Object *testobj) {
+    ACVP_KDF135_SNMP_TC *stc = tc;
+    unsigned int actual_len = 0;
+
+    stc->password = json_object_get_string(testobj, "password");
+    if (!stc->password) {
+        ACVP_LOG_ERR("Failed to include password");
+        return ACVP_MISSING_ARG;
     }
-    json_object_set_string(tc_rsp, "sharedKey", (const char *)tmp);
-
-err:
-    free(tmp);
-    return rv;
-}
-
-static ACVP_RESULT acvp_kdf135_snmp_init_tc(ACVP_CTX *ctx,
-                                            ACVP_KDF135_SNMP_TC *stc,
-                                            unsigned int tc_id,
-                                            ACVP_CIPHER alg_id,
-                                            const char *engine_id,
-                                            const char *password,
-                                            unsigned int p_len) {
-    ACVP_RESULT rv;
-
-    memzero_s(stc, sizeof(ACVP_KDF135_SNMP_TC));
-
-    stc->s_key = calloc(ACVP_KDF135_SNMP_SKEY_MAX * 2, sizeof(char));
-    if (!stc->s_key) { return ACVP_MALLOC_FAIL; }
-
-    stc->engine_id = calloc(ACVP_KDF135_SNMP_ENGID_MAX_BYTES, sizeof(char));
-    if (!stc->engine_id) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(engine_id, stc->engine_id,
-                            ACVP_KDF135_SNMP_ENGID_MAX_BYTES, (int*)&stc->engine_id_len);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (init_nonce)");
-        return rv;
+    actual_len = strnlen_s(stc->password, ACVP_KDF135_SNMP_PASS_LEN_MAX);
+    if (actual_len != stc->p_len) {
+        ACVP_LOG_ERR("pLen(%d) or password length(%d) incorrect", stc->p_len * 8, actual_len);
+        return ACVP_INVALID_ARG;
     }
-
-    stc->tc_id = tc_id;
-    stc->cipher = alg_id;
-    stc->p_len = p_len / 8;
-    stc->skey_len = 160 / 8;
-    stc->password = password;
+    ACVP_LOG_VERBOSE("         password: %s", stc->password);
 
     return ACVP_SUCCESS;
 }
 
-/*
- * This function simply releases the data associated with
- * a test case.
- */
-static ACVP_RESULT acvp_kdf135_snmp_release_tc(ACVP_KDF135_SNMP_TC *stc) {
-    if (stc->s_key) free(stc->s_key);
-    if (stc->engine_id) free(stc->engine_id);
-    memzero_s(stc, sizeof(ACVP_KDF135_SNMP_TC));
-    return ACVP_SUCCESS;
+static void acvp_kdf135_snmp_bind(ACVP_TEST_CASE *tc, void *stc) {
+    tc->tc.kdf135_snmp = stc;
 }
@@ -9,6 +9,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -17,179 +18,44 @@
 #include "parson.h"
 #include "safe_lib.h"
 
-/*
- * After the test case has been processed by the DUT, the results
- * need to be JSON formated to be included in the vector set results
- * file that will be uploaded to the server.  This routine handles
- * the JSON processing for a single test case.
- */
-static ACVP_RESULT acvp_kdf135_srtp_output_tc(ACVP_CTX *ctx, ACVP_KDF135_SRTP_TC *stc, JSON_Object *tc_rsp) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX + 1, sizeof(char));
-    if (!tmp) { return ACVP_MALLOC_FAIL; }
-
-    rv = acvp_bin_to_hexstr(stc->srtp_ke, stc->aes_keylen / 8, tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (srtp_ke)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "srtpKe", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->srtp_ka, 160 / 8, tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (srtp_ka)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "srtpKa", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->srtp_ks, 112 / 8, tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (srtp_ks)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "srtpKs", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->srtcp_ke, stc->aes_keylen / 8, tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (srtcp_ke)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "srtcpKe", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->srtcp_ka, 160 / 8, tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (srtcp_ka)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "srtcpKa", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->srtcp_ks, 112 / 8, tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (srtcp_ks)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "srtcpKs", (const char *)tmp);
-    memzero_s(tmp, ACVP_KDF135_SRTP_OUTPUT_MAX);
-
-err:
-    free(tmp);
-    return rv;
+static void acvp_kdf135_srtp_bind(ACVP_TEST_CASE *tc, void *stc) {
+    tc->tc.kdf135_srtp = stc;
 }
 
-/*
- * This function simply releases the data associated with
- * a test case.
- */
-static ACVP_RESULT acvp_kdf135_srtp_release_tc(ACVP_KDF135_SRTP_TC *stc) {
-    if (stc->kdr) free(stc->kdr);
-    if (stc->master_key) free(stc->master_key);
-    if (stc->master_salt) free(stc->master_salt);
-    if (stc->idx) free(stc->idx);
-    if (stc->srtcp_idx) free(stc->srtcp_idx);
-    if (stc->srtp_ke) free(stc->srtp_ke);
-    if (stc->srtp_ka) free(stc->srtp_ka);
-    if (stc->srtp_ks) free(stc->srtp_ks);
-    if (stc->srtcp_ke) free(stc->srtcp_ke);
-    if (stc->srtcp_ka) free(stc->srtcp_ka);
-    if (stc->srtcp_ks) free(stc->srtcp_ks);
-    memzero_s(stc, sizeof(ACVP_KDF135_SRTP_TC));
-    return ACVP_SUCCESS;
-}
-
-static ACVP_RESULT acvp_kdf135_srtp_init_tc(ACVP_CTX *ctx,
-                                            ACVP_KDF135_SRTP_TC *stc,
-                                            unsigned int tc_id,
-                                            int aes_keylen,
-                                            const char *kdr,
-                                            const char *master_key,
-                                            const char *master_salt,
-                                            const char *idx,
-                                            const char *srtcp_idx) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-
-    memzero_s(stc, sizeof(ACVP_KDF135_SRTP_TC));
-
-    if (!kdr || !master_key || !master_salt || !idx || !srtcp_idx) {
-        ACVP_LOG_ERR("Missing parameters - initalize KDF SRTP test case");
-        return ACVP_INVALID_ARG;
-    }
-
-    stc->tc_id = tc_id;
-    stc->aes_keylen = aes_keylen;
-
-    stc->kdr = calloc(ACVP_KDF135_SRTP_KDR_STR_MAX, sizeof(char));
-    if (!stc->kdr) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(kdr, stc->kdr, ACVP_KDF135_SRTP_KDR_STR_MAX, &(stc->kdr_len));
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (kdr)");
-        return rv;
-    }
-
-    stc->master_key = calloc(ACVP_KDF135_SRTP_MASTER_MAX, sizeof(char));
-    if (!stc->master_key) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(master_key, (unsigned char *)stc->master_key,
-                            ACVP_KDF135_SRTP_MASTER_MAX, NULL);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (master_key)");
-        return rv;
-    }
-
-    stc->master_salt = calloc(ACVP_KDF135_SRTP_MASTER_MAX, sizeof(char));
-    if (!stc->master_salt) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(master_salt, (unsigned char *)stc->master_salt,
-                            ACVP_KDF135_SRTP_MASTER_MAX, NULL);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (master_salt)");
-        return rv;
-    }
-
-    stc->idx = calloc(ACVP_KDF135_SRTP_INDEX_MAX, sizeof(char));
-    if (!stc->idx) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(idx, (unsigned char *)stc->idx, ACVP_KDF135_SRTP_INDEX_MAX,
-                            NULL);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (idx)");
-        return rv;
-    }
-
-    stc->srtcp_idx = calloc(ACVP_KDF135_SRTP_INDEX_MAX, sizeof(char));
-    if (!stc->srtcp_idx) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(srtcp_idx, (unsigned char *)stc->srtcp_idx,
-                            ACVP_KDF135_SRTP_INDEX_MAX, NULL);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (srtcp_idx)");
-        return rv;
-    }
-
-    stc->srtp_ka = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
-    if (!stc->srtp_ka) { return ACVP_MALLOC_FAIL; }
-    stc->srtp_ke = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
-    if (!stc->srtp_ke) { return ACVP_MALLOC_FAIL; }
-    stc->srtp_ks = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
-    if (!stc->srtp_ks) { return ACVP_MALLOC_FAIL; }
-    stc->srtcp_ka = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
-    if (!stc->srtcp_ka) { return ACVP_MALLOC_FAIL; }
-    stc->srtcp_ke = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
-    if (!stc->srtcp_ke) { return ACVP_MALLOC_FAIL; }
-    stc->srtcp_ks = calloc(ACVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
-    if (!stc->srtcp_ks) { return ACVP_MALLOC_FAIL; }
-
-    return ACVP_SUCCESS;
-}
+static const ACVP_KDF135_FIELD acvp_kdf135_srtp_fields[] = {
+    { "kdr", ACVP_KDF135_FIELD_GROUP, offsetof(ACVP_KDF135_SRTP_TC, kdr),
+      offsetof(ACVP_KDF135_SRTP_TC, kdr_len), ACVP_KDF135_SRTP_KDR_STR_MAX, ACVP_MISSING_ARG, 0, 0 },
+    { "masterKey", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SRTP_TC, master_key),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_MASTER_MAX, ACVP_MISSING_ARG, 0, 0 },
+    { "masterSalt", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SRTP_TC, master_salt),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_MASTER_MAX, ACVP_MISSING_ARG, 0, 0 },
+    { "index", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SRTP_TC, idx),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_INDEX_MAX, ACVP_MISSING_ARG, 0, 0 },
+    { "srtcpIndex", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SRTP_TC, srtcp_idx),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_INDEX_MAX, ACVP_MISSING_ARG, 0, 0 },
+    { "srtpKe", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SRTP_TC, srtp_ke),
+      offsetof(ACVP_KDF135_SRTP_TC, aes_keylen), ACVP_KDF135_SRTP_OUTPUT_MAX, ACVP_SUCCESS, 1, 0 },
+    { "srtpKa", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SRTP_TC, srtp_ka),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_OUTPUT_MAX, ACVP_SUCCESS, 0, 160 / 8 },
+    { "srtpKs", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SRTP_TC, srtp_ks),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_OUTPUT_MAX, ACVP_SUCCESS, 0, 112 / 8 },
+    { "srtcpKe", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SRTP_TC, srtcp_ke),
+      offsetof(ACVP_KDF135_SRTP_TC, aes_keylen), ACVP_KDF135_SRTP_OUTPUT_MAX, ACVP_SUCCESS, 1, 0 },
+    { "srtcpKa", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SRTP_TC, srtcp_ka),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_OUTPUT_MAX, ACVP_SUCCESS, 0, 160 / 8 },
+    { "srtcpKs", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SRTP_TC, srtcp_ks),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_SRTP_OUTPUT_MAX, ACVP_SUCCESS, 0, 112 / 8 }
+};
+
+static const ACVP_KDF135_TG acvp_kdf135_srtp_tg = {
+    "KDF135 SRTP", sizeof(ACVP_KDF135_SRTP_TC), offsetof(ACVP_KDF135_SRTP_TC, tc_id),
+    acvp_kdf135_srtp_fields, sizeof(acvp_kdf135_srtp_fields) / sizeof(ACVP_KDF135_FIELD),
+    acvp_kdf135_srtp_bind, NULL, NULL
+};
 
 ACVP_RESULT acvp_kdf135_srtp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
-    unsigned int tc_id;
     JSON_Value *groupval;
     JSON_Object *groupobj = NULL;
-    JSON_Value *testval;
-    JSON_Object *testobj = NULL;
     JSON_Array *groups;
     JSON_Array *tests;
 
@@ -198,24 +64,24 @@ ACVP_RESULT acvp_kdf135_srtp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
 
     int i, g_cnt;
-    int j, t_cnt;
 
     JSON_Value *r_vs_val = NULL;
     JSON_Object *r_vs = NULL;
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
-    JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
-    JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
+    JSON_Value *r_gval = NULL;  /* Response groupval */
+    JSON_Object *r_gobj = NULL; /* Response groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_KDF135_SRTP_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_KDF135_TG_SLOTS slots;
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
     ACVP_CIPHER alg_id;
-    char *json_result;
 
     int aes_key_length;
-    const char *kdr = NULL, *master_key = NULL, *master_salt = NULL, *idx = NULL, *srtcp_idx = NULL;
+    const char *kdr = NULL;
+
+    memzero_s(&slots, sizeof(ACVP_KDF135_TG_SLOTS));
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -239,12 +105,6 @@ ACVP_RESULT acvp_kdf135_srtp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         return ACVP_INVALID_ARG;
     }
 
-    /*
-     * Get a reference to the abstracted test case
-     */
-    tc.tc.kdf135_srtp = &stc;
-    stc.cipher = alg_id;
-
     cap = acvp_locate_cap_entry(ctx, alg_id);
     if (!cap) {
         ACVP_LOG_ERR("ACVP server requesting unsupported capability %s : %d.", alg_str, alg_id);
@@ -263,7 +123,7 @@ ACVP_RESULT acvp_kdf135_srtp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         goto err;
@@ -282,15 +142,15 @@ ACVP_RESULT acvp_kdf135_srtp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         aes_key_length = json_object_get_number(groupobj, "aesKeyLength");
         if (!aes_key_length) {
@@ -311,107 +171,29 @@ ACVP_RESULT acvp_kdf135_srtp_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         ACVP_LOG_VERBOSE("    key length: %d", aes_key_length);
 
         tests = json_object_get_array(groupobj, "tests");
-        t_cnt = json_array_get_count(tests);
-
-        for (j = 0; j < t_cnt; j++) {
-            ACVP_LOG_VERBOSE("Found new KDF SRTP test vector...");
-            testval = json_array_get_value(tests, j);
-            testobj = json_value_get_object(testval);
-
-            tc_id = json_object_get_number(testobj, "tcId");
-
-            master_key = json_object_get_string(testobj, "masterKey");
-            if (!master_key) {
-                ACVP_LOG_ERR("Failed to include JSON key:\"masterKey\"");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            master_salt = json_object_get_string(testobj, "masterSalt");
-            if (!master_salt) {
-                ACVP_LOG_ERR("Failed to include JSON key:\"masterSalt\"");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
 
-            idx = json_object_get_string(testobj, "index");
-            if (!idx) {
-                ACVP_LOG_ERR("Failed to include JSON key:\"idx\"");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            srtcp_idx = json_object_get_string(testobj, "srtcpIndex");
-            if (!srtcp_idx) {
-                ACVP_LOG_ERR("Failed to include JSON key:\"srtcpIndex\"");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            ACVP_LOG_VERBOSE("        Test case: %d", j);
-            ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
-            ACVP_LOG_VERBOSE("        masterKey: %s", master_key);
-            ACVP_LOG_VERBOSE("       masterSalt: %s", master_salt);
-            ACVP_LOG_VERBOSE("            idx: %s", idx);
-            ACVP_LOG_VERBOSE("       srtcpIndex: %s", srtcp_idx);
-
-            /*
-             * Create a new test case in the response
-             */
-            r_tval = json_value_init_object();
-            r_tobj = json_value_get_object(r_tval);
-
-            json_object_set_number(r_tobj, "tcId", tc_id);
-
-            /*
-             * Setup the test case data that will be passed down to
-             * the crypto module.
-             */
-            rv = acvp_kdf135_srtp_init_tc(ctx, &stc, tc_id, aes_key_length, kdr, master_key, master_salt, idx, srtcp_idx);
-            if (rv != ACVP_SUCCESS) {
-                acvp_kdf135_srtp_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
-                ACVP_LOG_ERR("crypto module failed");
-                acvp_kdf135_srtp_release_tc(&stc);
-                rv = ACVP_CRYPTO_MODULE_FAIL;
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /*
-             * Output the test case results using JSON
-             */
-            rv = acvp_kdf135_srtp_output_tc(ctx, &stc, r_tobj);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("JSON output failure");
-                acvp_kdf135_srtp_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-            /*
-             * Release all the memory associated with the test case
-             */
-            acvp_kdf135_srtp_release_tc(&stc);
+        /*
+         * Setup the test case data that will be passed down to
+         * the crypto module, the rest of it comes from the tests.
+         */
+        memzero_s(&stc, sizeof(ACVP_KDF135_SRTP_TC));
+        stc.cipher = alg_id;
+        stc.aes_keylen = aes_key_length;
 
-            /* Append the test response value to array */
-            json_array_append_value(r_tarr, r_tval);
+        rv = acvp_kdf135_tg_run(ctx, cap, &acvp_kdf135_srtp_tg, &slots, &stc, groupobj, tests, r_tarr);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
         }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kdf135_tg_free(&slots);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
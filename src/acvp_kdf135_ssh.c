@@ -9,6 +9,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -17,31 +18,44 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+static void acvp_kdf135_ssh_bind(ACVP_TEST_CASE *tc, void *stc) {
+    tc->tc.kdf135_ssh = stc;
+}
+
 /*
- * Forward prototypes for local functions
+ * The lengths of the keys and IVs come from the cipher and hash of the
+ * group, so they are in the template rather than decoded.
  */
-static ACVP_RESULT acvp_kdf135_ssh_output_tc(ACVP_CTX *ctx, ACVP_KDF135_SSH_TC *stc, JSON_Object *tc_rsp);
-
-static ACVP_RESULT acvp_kdf135_ssh_init_tc(ACVP_KDF135_SSH_TC *stc,
-                                           unsigned int tc_id,
-                                           ACVP_CIPHER alg_id,
-                                           unsigned int sha_type,
-                                           unsigned int e_key_len,
-                                           unsigned int i_key_len,
-                                           unsigned int iv_len,
-                                           unsigned int hash_len,
-                                           const char *shared_secret_k,
-                                           const char *hash_h,
-                                           const char *session_id);
-
-static ACVP_RESULT acvp_kdf135_ssh_release_tc(ACVP_KDF135_SSH_TC *stc);
+static const ACVP_KDF135_FIELD acvp_kdf135_ssh_fields[] = {
+    { "k", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SSH_TC, shared_secret_k),
+      offsetof(ACVP_KDF135_SSH_TC, shared_secret_len), ACVP_KDF135_SSH_STR_IN_MAX / 2, ACVP_MISSING_ARG, 0, 0 },
+    { "h", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SSH_TC, hash_h),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_SHA512_BYTE_LEN, ACVP_MISSING_ARG, 0, 0 },
+    { "sessionId", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_SSH_TC, session_id),
+      offsetof(ACVP_KDF135_SSH_TC, session_id_len), ACVP_KDF135_SSH_STR_IN_MAX / 2, ACVP_MISSING_ARG, 0, 0 },
+    { "initialIvClient", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SSH_TC, cs_init_iv),
+      offsetof(ACVP_KDF135_SSH_TC, iv_len), ACVP_KDF135_SSH_IV_MAX, ACVP_SUCCESS, 0, 0 },
+    { "encryptionKeyClient", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SSH_TC, cs_encrypt_key),
+      offsetof(ACVP_KDF135_SSH_TC, e_key_len), ACVP_KDF135_SSH_EKEY_MAX, ACVP_SUCCESS, 0, 0 },
+    { "integrityKeyClient", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SSH_TC, cs_integrity_key),
+      offsetof(ACVP_KDF135_SSH_TC, i_key_len), ACVP_KDF135_SSH_IKEY_MAX, ACVP_SUCCESS, 0, 0 },
+    { "initialIvServer", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SSH_TC, sc_init_iv),
+      offsetof(ACVP_KDF135_SSH_TC, iv_len), ACVP_KDF135_SSH_IV_MAX, ACVP_SUCCESS, 0, 0 },
+    { "encryptionKeyServer", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SSH_TC, sc_encrypt_key),
+      offsetof(ACVP_KDF135_SSH_TC, e_key_len), ACVP_KDF135_SSH_EKEY_MAX, ACVP_SUCCESS, 0, 0 },
+    { "integrityKeyServer", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_SSH_TC, sc_integrity_key),
+      offsetof(ACVP_KDF135_SSH_TC, i_key_len), ACVP_KDF135_SSH_IKEY_MAX, ACVP_SUCCESS, 0, 0 }
+};
+
+static const ACVP_KDF135_TG acvp_kdf135_ssh_tg = {
+    "KDF SSH", sizeof(ACVP_KDF135_SSH_TC), offsetof(ACVP_KDF135_SSH_TC, tc_id),
+    acvp_kdf135_ssh_fields, sizeof(acvp_kdf135_ssh_fields) / sizeof(ACVP_KDF135_FIELD),
+    acvp_kdf135_ssh_bind, NULL, NULL
+};
 
 ACVP_RESULT acvp_kdf135_ssh_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
-    unsigned int tc_id;
     JSON_Value *groupval;
     JSON_Object *groupobj = NULL;
-    JSON_Value *testval;
-    JSON_Object *testobj = NULL;
     JSON_Array *groups;
     JSON_Array *tests;
 
@@ -50,26 +64,23 @@ ACVP_RESULT acvp_kdf135_ssh_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
 
     int i, g_cnt;
-    int j, t_cnt;
 
     JSON_Value *r_vs_val = NULL;
     JSON_Object *r_vs = NULL;
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
-    JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
-    JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
+    JSON_Value *r_gval = NULL;  /* Response groupval */
+    JSON_Object *r_gobj = NULL; /* Response groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_KDF135_SSH_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_KDF135_TG_SLOTS slots;
     ACVP_RESULT rv;
 
     ACVP_CIPHER alg_id;
     const char *alg_str = NULL;
     const char *mode_str = NULL;
     const char *cipher_str = NULL;
-    const char *shared_secret_str = NULL;
-    const char *session_id_str = NULL;
-    const char *hash_str = NULL;
-    char *json_result;
+
+    memzero_s(&slots, sizeof(ACVP_KDF135_TG_SLOTS));
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -99,11 +110,6 @@ ACVP_RESULT acvp_kdf135_ssh_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         return ACVP_INVALID_ARG;
     }
 
-    /*
-     * Get a reference to the abstracted test case
-     */
-    tc.tc.kdf135_ssh = &stc;
-
     /*
      * Get the crypto module handler for this hash algorithm
      */
@@ -125,7 +131,7 @@ ACVP_RESULT acvp_kdf135_ssh_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -155,15 +161,15 @@ ACVP_RESULT acvp_kdf135_ssh_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         // Get the expected (user will generate) key and iv lengths
         cipher_str = json_object_get_string(groupobj, "cipher");
@@ -245,281 +251,40 @@ ACVP_RESULT acvp_kdf135_ssh_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             goto err;
         }
 
-        t_cnt = json_array_get_count(tests);
-        if (!t_cnt) {
+        if (!json_array_get_count(tests)) {
             ACVP_LOG_ERR("Failed to include tests in array. ");
             rv = ACVP_MISSING_ARG;
             goto err;
         }
 
-        for (j = 0; j < t_cnt; j++) {
-            ACVP_LOG_VERBOSE("Found new KDF SSH test vector...");
-            testval = json_array_get_value(tests, j);
-            testobj = json_value_get_object(testval);
-
-            tc_id = json_object_get_number(testobj, "tcId");
-            if (!tc_id) {
-                ACVP_LOG_ERR("Failed to include tc_id. ");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            shared_secret_str = json_object_get_string(testobj, "k");
-            if (!shared_secret_str) {
-                ACVP_LOG_ERR("Failed to include k. ");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            hash_str = json_object_get_string(testobj, "h");
-            if (!hash_str) {
-                ACVP_LOG_ERR("Failed to include h. ");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            session_id_str = json_object_get_string(testobj, "sessionId");
-            if (!session_id_str) {
-                ACVP_LOG_ERR("Failed to include sessionId. ");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            ACVP_LOG_VERBOSE("        Test case: %d", j);
-            ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
-            ACVP_LOG_VERBOSE("                k: %s", shared_secret_str);
-            ACVP_LOG_VERBOSE("                h: %s", hash_str);
-            ACVP_LOG_VERBOSE("       session_id: %s", session_id_str);
-
-            /*
-             * Create a new test case in the response
-             */
-            r_tval = json_value_init_object();
-            r_tobj = json_value_get_object(r_tval);
-
-            json_object_set_number(r_tobj, "tcId", tc_id);
-
-            /*
-             * Setup the test case data that will be passed down to
-             * the crypto module.
-             */
-            rv = acvp_kdf135_ssh_init_tc(&stc, tc_id, alg_id,
-                                         sha_type, e_key_len, i_key_len, iv_len, hash_len,
-                                         shared_secret_str, hash_str, session_id_str);
-            if (rv != ACVP_SUCCESS) {
-                acvp_kdf135_ssh_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
-                ACVP_LOG_ERR("crypto module failed the KDF SSH operation");
-                acvp_kdf135_ssh_release_tc(&stc);
-                rv = ACVP_CRYPTO_MODULE_FAIL;
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /*
-             * Output the test case results using JSON
-             */
-            rv = acvp_kdf135_ssh_output_tc(ctx, &stc, r_tobj);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("JSON output failure in hash module");
-                acvp_kdf135_ssh_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-            /*
-             * Release all the memory associated with the test case
-             */
-            acvp_kdf135_ssh_release_tc(&stc);
-
-            /* Append the test response value to array */
-            json_array_append_value(r_tarr, r_tval);
+        /*
+         * Setup the test case data that will be passed down to
+         * the crypto module, the rest of it comes from the tests.
+         */
+        memzero_s(&stc, sizeof(ACVP_KDF135_SSH_TC));
+        stc.cipher = alg_id;
+        stc.sha_type = sha_type;
+        stc.e_key_len = e_key_len;
+        stc.i_key_len = i_key_len;
+        stc.iv_len = iv_len;
+        stc.hash_len = hash_len;
+
+        rv = acvp_kdf135_tg_run(ctx, cap, &acvp_kdf135_ssh_tg, &slots, &stc, groupobj, tests, r_tarr);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
         }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kdf135_tg_free(&slots);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
-
-/*
- * After the test case has been processed by the DUT, the results
- * need to be JSON formated to be included in the vector set results
- * file that will be uploaded to the server.  This routine handles
- * the JSON processing for a single test case.
- */
-static ACVP_RESULT acvp_kdf135_ssh_output_tc(ACVP_CTX *ctx,
-                                             ACVP_KDF135_SSH_TC *stc,
-                                             JSON_Object *tc_rsp) {
-    char *tmp = NULL;
-    ACVP_RESULT rv = ACVP_SUCCESS;
-
-    if ((stc->iv_len * 2) > ACVP_KDF135_SSH_STR_OUT_MAX ||
-        (stc->e_key_len * 2) > ACVP_KDF135_SSH_STR_OUT_MAX ||
-        (stc->i_key_len * 2) > ACVP_KDF135_SSH_STR_OUT_MAX) {
-        ACVP_LOG_ERR("iv_len*2(%u) || e_key_len*2(%u) || i_key_len*2(%u) > ACVP_KDF135_SSH_STR_OUT_MAX(%u)",
-                     (stc->iv_len * 2), (stc->e_key_len * 2), (stc->i_key_len * 2),
-                     ACVP_KDF135_SSH_STR_OUT_MAX);
-        ACVP_LOG_ERR("Hint, make sure user isn't modifying those field values");
-        return ACVP_DATA_TOO_LARGE;
-    }
-
-    tmp = calloc(ACVP_KDF135_SSH_STR_OUT_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc");
-        return ACVP_MALLOC_FAIL;
-    }
-
-    rv = acvp_bin_to_hexstr(stc->cs_init_iv, stc->iv_len, tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("acvp_bin_to_hexstr() failure");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "initialIvClient", tmp);
-    memzero_s(tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->cs_encrypt_key, stc->e_key_len, tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("acvp_bin_to_hexstr() failure");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "encryptionKeyClient", tmp);
-    memzero_s(tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->cs_integrity_key, stc->i_key_len, tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("acvp_bin_to_hexstr() failure");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "integrityKeyClient", tmp);
-    memzero_s(tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->sc_init_iv, stc->iv_len, tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("acvp_bin_to_hexstr() failure");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "initialIvServer", tmp);
-    memzero_s(tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->sc_encrypt_key, stc->e_key_len, tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("acvp_bin_to_hexstr() failure");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "encryptionKeyServer", tmp);
-    memzero_s(tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-
-    rv = acvp_bin_to_hexstr(stc->sc_integrity_key, stc->i_key_len, tmp, ACVP_KDF135_SSH_STR_OUT_MAX);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("acvp_bin_to_hexstr() failure");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "integrityKeyServer", tmp);
-
-err:
-    free(tmp);
-    return rv;
-}
-
-static ACVP_RESULT acvp_kdf135_ssh_init_tc(ACVP_KDF135_SSH_TC *stc,
-                                           unsigned int tc_id,
-                                           ACVP_CIPHER alg_id,
-                                           ACVP_HASH_ALG sha_type,
-                                           unsigned int e_key_len,
-                                           unsigned int i_key_len,
-                                           unsigned int iv_len,
-                                           unsigned int hash_len,
-                                           const char *shared_secret_k,
-                                           const char *hash_h,
-                                           const char *session_id) {
-    unsigned int shared_secret_len = 0;
-    unsigned int session_id_len = 0;
-    ACVP_RESULT rv;
-
-    memzero_s(stc, sizeof(ACVP_KDF135_SSH_TC));
-
-    // Get the byte lengths
-    shared_secret_len = strnlen_s(shared_secret_k, ACVP_KDF135_SSH_STR_IN_MAX) / 2;
-    session_id_len = strnlen_s(session_id, ACVP_KDF135_SSH_STR_IN_MAX) / 2;
-
-    stc->shared_secret_k = calloc(shared_secret_len, sizeof(unsigned char));
-    if (!stc->shared_secret_k) { return ACVP_MALLOC_FAIL; }
-    stc->hash_h = calloc(hash_len, sizeof(unsigned char));
-    if (!stc->hash_h) { return ACVP_MALLOC_FAIL; }
-    stc->session_id = calloc(session_id_len, sizeof(unsigned char));
-    if (!stc->session_id) { return ACVP_MALLOC_FAIL; }
-
-    // Convert from hex string to binary
-    rv = acvp_hexstr_to_bin(shared_secret_k, (unsigned char *)stc->shared_secret_k,
-                            shared_secret_len, NULL);
-    if (rv != ACVP_SUCCESS) return rv;
-
-    rv = acvp_hexstr_to_bin(hash_h, (unsigned char *)stc->hash_h, hash_len, NULL);
-    if (rv != ACVP_SUCCESS) return rv;
-
-    rv = acvp_hexstr_to_bin(session_id, (unsigned char *)stc->session_id, session_id_len, NULL);
-    if (rv != ACVP_SUCCESS) return rv;
-
-    // Allocate answer buffers
-    stc->cs_init_iv = calloc(ACVP_KDF135_SSH_IV_MAX, sizeof(unsigned char));
-    if (!stc->cs_init_iv) { return ACVP_MALLOC_FAIL; }
-    stc->sc_init_iv = calloc(ACVP_KDF135_SSH_IV_MAX, sizeof(unsigned char));
-    if (!stc->sc_init_iv) { return ACVP_MALLOC_FAIL; }
-
-    stc->cs_encrypt_key = calloc(ACVP_KDF135_SSH_EKEY_MAX, sizeof(unsigned char));
-    if (!stc->cs_encrypt_key) { return ACVP_MALLOC_FAIL; }
-    stc->sc_encrypt_key = calloc(ACVP_KDF135_SSH_EKEY_MAX, sizeof(unsigned char));
-    if (!stc->sc_encrypt_key) { return ACVP_MALLOC_FAIL; }
-
-    stc->cs_integrity_key = calloc(ACVP_KDF135_SSH_IKEY_MAX, sizeof(unsigned char));
-    if (!stc->cs_integrity_key) { return ACVP_MALLOC_FAIL; }
-    stc->sc_integrity_key = calloc(ACVP_KDF135_SSH_IKEY_MAX, sizeof(unsigned char));
-    if (!stc->sc_integrity_key) { return ACVP_MALLOC_FAIL; }
-
-    stc->tc_id = tc_id;
-    stc->cipher = alg_id;
-    stc->sha_type = sha_type;
-    stc->e_key_len = e_key_len;
-    stc->i_key_len = i_key_len;
-    stc->iv_len = iv_len;
-    stc->shared_secret_len = shared_secret_len;
-    stc->hash_len = hash_len;
-    stc->session_id_len = session_id_len;
-
-    return ACVP_SUCCESS;
-}
-
-/*
- * This function simply releases the data associated with
- * a test case.
- */
-static ACVP_RESULT acvp_kdf135_ssh_release_tc(ACVP_KDF135_SSH_TC *stc) {
-    if (stc->shared_secret_k) free(stc->shared_secret_k);
-    if (stc->hash_h) free(stc->hash_h);
-    if (stc->session_id) free(stc->session_id);
-    if (stc->cs_init_iv) free(stc->cs_init_iv);
-    if (stc->sc_init_iv) free(stc->sc_init_iv);
-    if (stc->cs_encrypt_key) free(stc->cs_encrypt_key);
-    if (stc->sc_encrypt_key) free(stc->sc_encrypt_key);
-    if (stc->cs_integrity_key) free(stc->cs_integrity_key);
-    if (stc->sc_integrity_key) free(stc->sc_integrity_key);
-
-    memzero_s(stc, sizeof(ACVP_KDF135_SSH_TC));
-
-    return ACVP_SUCCESS;
-}
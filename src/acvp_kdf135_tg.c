@@ -0,0 +1,361 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * The test case loop shared by the KDF135 kat handlers. A handler describes
+ * its test case struct with an ACVP_KDF135_TG, parses the group level
+ * values itself into a test case that serves as the template of the group,
+ * and hands the tests array to acvp_kdf135_tg_run(), which decodes the
+ * fields into buffers that are allocated once and reused, runs the test
+ * cases one at a time or as a batch, and writes the output fields to the
+ * response. The tables are all most handlers need; init_tc and output_tc
+ * are only for values that are not hex strings.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define ACVP_KDF135_TG_PTR(stc, off) ((unsigned char **)((unsigned char *)(stc) + (off)))
+
+/*
+ * Bytes of the buffers of the group fields if group is set, and
+ * otherwise those each test case needs for its test case and output fields.
+ */
+static int acvp_kdf135_tg_bytes(const ACVP_KDF135_TG *tg, int group) {
+    int i = 0, bytes = 0;
+
+    for (i = 0; i < tg->field_cnt; i++) {
+        if ((tg->fields[i].scope == ACVP_KDF135_FIELD_GROUP) == group) {
+            bytes += tg->fields[i].max;
+        }
+    }
+    return bytes;
+}
+
+/*
+ * Makes room for count test cases, keeping what is there if there is
+ * enough of it already. The buffers of the group come first.
+ */
+static ACVP_RESULT acvp_kdf135_tg_reserve(ACVP_KDF135_TG_SLOTS *slots, const ACVP_KDF135_TG *tg, int count) {
+    size_t bytes = 0;
+
+    if (slots->stcs && count <= slots->size) {
+        return ACVP_SUCCESS;
+    }
+    acvp_kdf135_tg_free(slots);
+
+    bytes = (size_t)acvp_kdf135_tg_bytes(tg, 1) + (size_t)acvp_kdf135_tg_bytes(tg, 0) * count;
+    slots->stcs = calloc(count, tg->tc_size);
+    slots->buf = calloc(bytes ? bytes : 1, sizeof(unsigned char));
+    if (!slots->stcs || !slots->buf) {
+        acvp_kdf135_tg_free(slots);
+        return ACVP_MALLOC_FAIL;
+    }
+    slots->size = count;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Points a field of the test case at its buffer, clearing it, and decodes
+ * the hex string into it if one is given.
+ */
+static ACVP_RESULT acvp_kdf135_tg_fill(ACVP_CTX *ctx,
+                                       const ACVP_KDF135_FIELD *field,
+                                       void *stc,
+                                       unsigned char *buf,
+                                       const char *hex) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int len = 0;
+
+    memzero_s(buf, field->max);
+    *ACVP_KDF135_TG_PTR(stc, field->data) = buf;
+    if (!hex) {
+        return ACVP_SUCCESS;
+    }
+    rv = acvp_hexstr_to_bin(hex, buf, field->max, &len);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Hex conversion failure (%s)", field->name);
+        return rv;
+    }
+    if (field->len != ACVP_KDF135_FIELD_NO_LEN) {
+        memcpy_s((unsigned char *)stc + field->len, sizeof(int), &len, sizeof(int));
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Fills in a test case from the template of the group and the JSON of the
+ * test case, using the test case's share of the buffers.
+ */
+static ACVP_RESULT acvp_kdf135_tg_init_tc(ACVP_CTX *ctx,
+                                          const ACVP_KDF135_TG *tg,
+                                          const void *group_tc,
+                                          void *stc,
+                                          unsigned char *buf,
+                                          JSON_Object *testobj) {
+    const ACVP_KDF135_FIELD *field = NULL;
+    const char *hex = NULL;
+    unsigned int tc_id = 0;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    memcpy_s(stc, tg->tc_size, group_tc, tg->tc_size);
+
+    tc_id = json_object_get_uint(testobj, "tcId");
+    if (!tc_id) {
+        ACVP_LOG_ERR("Failed to include tc_id. ");
+        return ACVP_MISSING_ARG;
+    }
+    memcpy_s((unsigned char *)stc + tg->tc_id, sizeof(unsigned int), &tc_id, sizeof(unsigned int));
+    ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
+
+    for (i = 0; i < tg->field_cnt; i++) {
+        field = &tg->fields[i];
+        if (field->scope == ACVP_KDF135_FIELD_GROUP) {
+            continue;
+        }
+        hex = NULL;
+        if (field->scope == ACVP_KDF135_FIELD_TEST) {
+            hex = json_object_get_string(testobj, field->name);
+            if (!hex) {
+                ACVP_LOG_ERR("Failed to include %s. ", field->name);
+                return field->missing;
+            }
+            ACVP_LOG_VERBOSE("%17s: %s", field->name, hex);
+        }
+        rv = acvp_kdf135_tg_fill(ctx, field, stc, buf, hex);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+        buf += field->max;
+    }
+
+    if (tg->init_tc) {
+        return tg->init_tc(ctx, stc, testobj);
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Writes the output fields of a test case that have a length to tc_rsp,
+ * then hands it to the output_tc of the handler, if it has one.
+ */
+static ACVP_RESULT acvp_kdf135_tg_output_tc(ACVP_CTX *ctx,
+                                            const ACVP_KDF135_TG *tg,
+                                            void *stc,
+                                            JSON_Object *tc_rsp) {
+    const ACVP_KDF135_FIELD *field = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0, len = 0;
+
+    for (i = 0; i < tg->field_cnt; i++) {
+        field = &tg->fields[i];
+        if (field->scope != ACVP_KDF135_FIELD_OUTPUT) {
+            continue;
+        }
+        if (field->len != ACVP_KDF135_FIELD_NO_LEN) {
+            memcpy_s(&len, sizeof(int), (unsigned char *)stc + field->len, sizeof(int));
+            if (field->bits) {
+                len /= 8;
+            }
+        } else if (field->fixed) {
+            len = field->fixed;
+        } else {
+            continue;
+        }
+        rv = acvp_json_set_hex(tc_rsp, field->name, *ACVP_KDF135_TG_PTR(stc, field->data), len, field->max * 2);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("hex conversion failure (%s)", field->name);
+            return rv;
+        }
+    }
+
+    if (tg->output_tc) {
+        return tg->output_tc(ctx, stc, tc_rsp);
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Runs the test cases collected for the group, see acvp_tc_batch_run(), and
+ * outputs their results, in test case order, into the group's tests array.
+ */
+static ACVP_RESULT acvp_kdf135_tg_run_batch(ACVP_CTX *ctx,
+                                            ACVP_CAPS_LIST *cap,
+                                            const ACVP_KDF135_TG *tg,
+                                            ACVP_KDF135_TG_SLOTS *slots,
+                                            ACVP_TC_BATCH *batch,
+                                            JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("crypto module failed the %s operation", tg->name);
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        /* The test cases were added in the order of their slots */
+        rv = acvp_kdf135_tg_output_tc(ctx, tg, slots->stcs + (size_t)i * tg->tc_size,
+                                      json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in %s module", tg->name);
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Runs the test cases of a group. group_tc holds what the test cases of the
+ * group share; the group fields of tg are decoded into it here, so it must
+ * not be used once slots are freed. The test cases go to the batch or async
+ * handler of the capability if it has one, and to its crypto handler one at
+ * a time otherwise.
+ */
+ACVP_RESULT acvp_kdf135_tg_run(ACVP_CTX *ctx,
+                               ACVP_CAPS_LIST *cap,
+                               const ACVP_KDF135_TG *tg,
+                               ACVP_KDF135_TG_SLOTS *slots,
+                               void *group_tc,
+                               JSON_Object *groupobj,
+                               JSON_Array *tests,
+                               JSON_Array *r_tarr) {
+    const ACVP_KDF135_FIELD *field = NULL;
+    const char *hex = NULL;
+    unsigned char *buf = NULL, *stc = NULL;
+    JSON_Value *r_tval = NULL;
+    ACVP_TEST_CASE tc;
+    ACVP_TC_BATCH batch;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int tc_bytes = acvp_kdf135_tg_bytes(tg, 0);
+    int i = 0, t_cnt = 0, use_batch = 0;
+
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
+
+    t_cnt = json_array_get_count(tests);
+    if (!t_cnt) {
+        return ACVP_SUCCESS;
+    }
+    use_batch = acvp_tc_batch_enabled(ctx, cap);
+
+    rv = acvp_kdf135_tg_reserve(slots, tg, use_batch ? t_cnt : 1);
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Error allocating memory for %s test cases", tg->name);
+        return rv;
+    }
+
+    buf = slots->buf;
+    for (i = 0; i < tg->field_cnt; i++) {
+        field = &tg->fields[i];
+        if (field->scope != ACVP_KDF135_FIELD_GROUP) {
+            continue;
+        }
+        hex = json_object_get_string(groupobj, field->name);
+        if (!hex) {
+            ACVP_LOG_ERR("Failed to include %s. ", field->name);
+            return field->missing;
+        }
+        rv = acvp_kdf135_tg_fill(ctx, field, group_tc, buf, hex);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+        buf += field->max;
+    }
+
+    if (use_batch) {
+        rv = acvp_tc_batch_init(&batch, t_cnt);
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Error allocating memory for %s test cases", tg->name);
+            return rv;
+        }
+    }
+
+    for (i = 0; i < t_cnt; i++) {
+        JSON_Object *testobj = json_value_get_object(json_array_get_value(tests, i));
+
+        ACVP_LOG_VERBOSE("Found new %s test vector...", tg->name);
+        ACVP_LOG_VERBOSE("        Test case: %d", i);
+        stc = slots->stcs + (size_t)(use_batch ? i : 0) * tg->tc_size;
+        rv = acvp_kdf135_tg_init_tc(ctx, tg, group_tc, stc,
+                                    buf + (size_t)(use_batch ? i : 0) * tc_bytes, testobj);
+        if (rv != ACVP_SUCCESS) {
+            goto end;
+        }
+
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        json_object_set_number(json_value_get_object(r_tval), "tcId",
+                               json_object_get_number(testobj, "tcId"));
+
+        if (use_batch) {
+            /* Run with the rest of the group below */
+            tg->bind(acvp_tc_batch_add(&batch, r_tval), stc);
+            r_tval = NULL;
+            continue;
+        }
+
+        /* Process the current test vector... */
+        tg->bind(&tc, stc);
+        if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
+            ACVP_LOG_ERR("crypto module failed the %s operation", tg->name);
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+
+        /*
+         * Output the test case results using JSON
+         */
+        rv = acvp_kdf135_tg_output_tc(ctx, tg, stc, json_value_get_object(r_tval));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure in %s module", tg->name);
+            goto end;
+        }
+
+        /* Append the test response value to array */
+        json_array_append_value(r_tarr, r_tval);
+        r_tval = NULL;
+    }
+
+    if (use_batch) {
+        rv = acvp_kdf135_tg_run_batch(ctx, cap, tg, slots, &batch, r_tarr);
+    }
+
+end:
+    if (r_tval) json_value_free(r_tval);
+    acvp_tc_batch_free(&batch);
+    return rv;
+}
+
+/*
+ * Releases the test cases and buffers of acvp_kdf135_tg_run()
+ */
+void acvp_kdf135_tg_free(ACVP_KDF135_TG_SLOTS *slots) {
+    if (!slots) {
+        return;
+    }
+    if (slots->stcs) free(slots->stcs);
+    if (slots->buf) free(slots->buf);
+    memzero_s(slots, sizeof(ACVP_KDF135_TG_SLOTS));
+}
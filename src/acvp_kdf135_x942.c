@@ -25,20 +25,13 @@
  */
 static ACVP_RESULT acvp_kdf135_x942_output_tc(ACVP_CTX *ctx, ACVP_KDF135_X942_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv;
-    char *tmp = NULL;
 
     if (stc->dkm_len == stc->key_len) {
-        tmp = calloc(ACVP_KDF135_X942_STR_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Error allocating memory in X942 KDF TC output");
-            return ACVP_MALLOC_FAIL;
-        }
-        rv = acvp_bin_to_hexstr(stc->dkm, stc->dkm_len, tmp, ACVP_KDF135_X942_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "derivedKey", stc->dkm, stc->dkm_len, ACVP_KDF135_X942_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dkm)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "derivedKey", (const char *)tmp);
     } else {
         ACVP_LOG_ERR("Error outputting test case for X942 KDF. Dkm_len MUST equal key_len.");
         rv = ACVP_TC_INVALID_DATA;
@@ -46,7 +39,6 @@ static ACVP_RESULT acvp_kdf135_x942_output_tc(ACVP_CTX *ctx, ACVP_KDF135_X942_TC
     }
     rv = ACVP_SUCCESS;
 err:
-    if (tmp) free(tmp);
     return rv;
 }
 
@@ -168,7 +160,6 @@ ACVP_RESULT acvp_kdf135_x942_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                *party_v = NULL, *supp_pub = NULL, *supp_priv = NULL, *zz = NULL;
     ACVP_CIPHER alg_id;
     ACVP_KDF_X942_TYPE kdf_type;
-    char *json_result;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -222,7 +213,7 @@ ACVP_RESULT acvp_kdf135_x942_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -251,15 +242,15 @@ ACVP_RESULT acvp_kdf135_x942_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         kdf_type_str = json_object_get_string(groupobj, "kdfType");
         if (!kdf_type_str) {
@@ -325,7 +316,7 @@ ACVP_RESULT acvp_kdf135_x942_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Server JSON missing 'tcId'");
                 rv = ACVP_MISSING_ARG;
@@ -440,7 +431,7 @@ ACVP_RESULT acvp_kdf135_x942_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the KDF X942 operation");
                 acvp_kdf135_x942_release_tc(&stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -471,9 +462,7 @@ ACVP_RESULT acvp_kdf135_x942_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
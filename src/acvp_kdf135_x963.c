@@ -9,6 +9,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -17,97 +18,28 @@
 #include "parson.h"
 #include "safe_lib.h"
 
-/*
- * After the test case has been processed by the DUT, the results
- * need to be JSON formated to be included in the vector set results
- * file that will be uploaded to the server.  This routine handles
- * the JSON processing for a single test case.
- */
-static ACVP_RESULT acvp_kdf135_x963_output_tc(ACVP_CTX *ctx, ACVP_KDF135_X963_TC *stc, JSON_Object *tc_rsp) {
-    ACVP_RESULT rv;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KDF135_X963_KEYDATA_MAX_CHARS + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Error allocating memory in X963 KDF TC output");
-        return ACVP_MALLOC_FAIL;
-    }
-    rv = acvp_bin_to_hexstr(stc->key_data, stc->key_data_len, tmp, ACVP_KDF135_X963_KEYDATA_MAX_CHARS);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("hex conversion failure (key_data)");
-        goto err;
-    }
-    json_object_set_string(tc_rsp, "keyData", (const char *)tmp);
-
-err:
-    if (tmp) free(tmp);
-    return ACVP_SUCCESS;
+static void acvp_kdf135_x963_bind(ACVP_TEST_CASE *tc, void *stc) {
+    tc->tc.kdf135_x963 = stc;
 }
 
-/*
- * This function simply releases the data associated with
- * a test case.
- */
-static ACVP_RESULT acvp_kdf135_x963_release_tc(ACVP_KDF135_X963_TC *stc) {
-    if (stc->z) free(stc->z);
-    if (stc->shared_info) free(stc->shared_info);
-    if (stc->key_data) free(stc->key_data);
-    memzero_s(stc, sizeof(ACVP_KDF135_X963_TC));
-    return ACVP_SUCCESS;
-}
-
-static ACVP_RESULT acvp_kdf135_x963_init_tc(ACVP_CTX *ctx,
-                                            ACVP_KDF135_X963_TC *stc,
-                                            unsigned int tc_id,
-                                            ACVP_HASH_ALG hash_alg,
-                                            int field_size,
-                                            int key_data_length,
-                                            int shared_info_length,
-                                            const char *z,
-                                            const char *shared_info) {
-    ACVP_RESULT rv = ACVP_SUCCESS;
-
-    memzero_s(stc, sizeof(ACVP_KDF135_X963_TC));
-
-    if (!hash_alg || !z || !shared_info) {
-        ACVP_LOG_ERR("Missing parameters - initalize KDF135 X963 test case");
-        return ACVP_INVALID_ARG;
-    }
-
-    stc->tc_id = tc_id;
-    stc->hash_alg = hash_alg;
-    stc->field_size = field_size / 8;
-    stc->key_data_len = key_data_length / 8;
-    stc->shared_info_len = shared_info_length / 8;
-
-    stc->z = calloc(ACVP_KDF135_X963_INPUT_MAX, sizeof(char));
-    if (!stc->z) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(z, stc->z, ACVP_KDF135_X963_INPUT_MAX, &stc->z_len);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (z)");
-        return rv;
-    }
-
-    stc->shared_info = calloc(ACVP_KDF135_X963_INPUT_MAX, sizeof(char));
-    if (!stc->shared_info) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(shared_info, stc->shared_info, ACVP_KDF135_X963_INPUT_MAX, NULL);
-    if (rv != ACVP_SUCCESS) {
-        ACVP_LOG_ERR("Hex conversion failure (shared_info)");
-        return rv;
-    }
-
-    stc->key_data = calloc(ACVP_KDF135_X963_KEYDATA_MAX_BYTES, sizeof(char));
-    if (!stc->key_data) { return ACVP_MALLOC_FAIL; }
-
-    return ACVP_SUCCESS;
-}
+static const ACVP_KDF135_FIELD acvp_kdf135_x963_fields[] = {
+    { "z", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_X963_TC, z),
+      offsetof(ACVP_KDF135_X963_TC, z_len), ACVP_KDF135_X963_INPUT_MAX, ACVP_INVALID_ARG, 0, 0 },
+    { "sharedInfo", ACVP_KDF135_FIELD_TEST, offsetof(ACVP_KDF135_X963_TC, shared_info),
+      ACVP_KDF135_FIELD_NO_LEN, ACVP_KDF135_X963_INPUT_MAX, ACVP_INVALID_ARG, 0, 0 },
+    { "keyData", ACVP_KDF135_FIELD_OUTPUT, offsetof(ACVP_KDF135_X963_TC, key_data),
+      offsetof(ACVP_KDF135_X963_TC, key_data_len), ACVP_KDF135_X963_KEYDATA_MAX_BYTES, ACVP_SUCCESS, 0, 0 }
+};
+
+static const ACVP_KDF135_TG acvp_kdf135_x963_tg = {
+    "KDF135 X963", sizeof(ACVP_KDF135_X963_TC), offsetof(ACVP_KDF135_X963_TC, tc_id),
+    acvp_kdf135_x963_fields, sizeof(acvp_kdf135_x963_fields) / sizeof(ACVP_KDF135_FIELD),
+    acvp_kdf135_x963_bind, NULL, NULL
+};
 
 ACVP_RESULT acvp_kdf135_x963_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
-    unsigned int tc_id;
     JSON_Value *groupval;
     JSON_Object *groupobj = NULL;
-    JSON_Value *testval;
-    JSON_Object *testobj = NULL;
     JSON_Array *groups;
     JSON_Array *tests;
 
@@ -116,24 +48,24 @@ ACVP_RESULT acvp_kdf135_x963_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
 
     int i = 0, g_cnt = 0;
-    int j = 0, t_cnt = 0;
+    int t_cnt = 0;
 
     JSON_Value *r_vs_val = NULL;
     JSON_Object *r_vs = NULL;
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
-    JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
-    JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
+    JSON_Value *r_gval = NULL;  /* Response groupval */
+    JSON_Object *r_gobj = NULL; /* Response groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_KDF135_X963_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_KDF135_TG_SLOTS slots;
     ACVP_RESULT rv;
     const char *alg_str = NULL;
     const char *mode_str = NULL;
     ACVP_CIPHER alg_id;
-    char *json_result;
 
     int field_size = 0, key_data_length = 0, shared_info_len = 0;
-    const char *z = NULL, *shared_info = NULL;
+
+    memzero_s(&slots, sizeof(ACVP_KDF135_TG_SLOTS));
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -163,12 +95,6 @@ ACVP_RESULT acvp_kdf135_x963_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         return ACVP_INVALID_ARG;
     }
 
-    /*
-     * Get a reference to the abstracted test case
-     */
-    tc.tc.kdf135_x963 = &stc;
-    stc.cipher = alg_id;
-
     cap = acvp_locate_cap_entry(ctx, alg_id);
     if (!cap) {
         ACVP_LOG_ERR("ACVP server requesting unsupported capability %s : %d.", alg_str, alg_id);
@@ -187,7 +113,7 @@ ACVP_RESULT acvp_kdf135_x963_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -216,15 +142,15 @@ ACVP_RESULT acvp_kdf135_x963_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         field_size = json_object_get_number(groupobj, "fieldSize");
         if (!field_size) {
@@ -276,94 +202,31 @@ ACVP_RESULT acvp_kdf135_x963_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             goto err;
         }
 
-        for (j = 0; j < t_cnt; j++) {
-            ACVP_LOG_VERBOSE("Found new KDF135 X963 test vector...");
-            testval = json_array_get_value(tests, j);
-            testobj = json_value_get_object(testval);
-
-            tc_id = json_object_get_number(testobj, "tcId");
-            if (!tc_id) {
-                ACVP_LOG_ERR("Failed to include tc_id. ");
-                rv = ACVP_MISSING_ARG;
-                goto err;
-            }
-
-            z = json_object_get_string(testobj, "z");
-            shared_info = json_object_get_string(testobj, "sharedInfo");
-            if (!z) {
-                ACVP_LOG_ERR("Failed to include z. ");
-                rv = ACVP_INVALID_ARG;
-                goto err;
-            }
-
-            if (!shared_info) {
-                ACVP_LOG_ERR("Failed to include shared_info. ");
-                rv = ACVP_INVALID_ARG;
-                goto err;
-            }
-
-            ACVP_LOG_VERBOSE("        Test case: %d", j);
-            ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
-
-            /*
-             * Create a new test case in the response
-             */
-            r_tval = json_value_init_object();
-            r_tobj = json_value_get_object(r_tval);
-
-            json_object_set_number(r_tobj, "tcId", tc_id);
-
-            /*
-             * Setup the test case data that will be passed down to
-             * the crypto module.
-             */
-            rv = acvp_kdf135_x963_init_tc(ctx, &stc, tc_id, hash_alg,
-                                          field_size, key_data_length,
-                                          shared_info_len, z, shared_info);
-            if (rv != ACVP_SUCCESS) {
-                acvp_kdf135_x963_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
-                ACVP_LOG_ERR("crypto module failed the KDF SSH operation");
-                acvp_kdf135_x963_release_tc(&stc);
-                rv = ACVP_CRYPTO_MODULE_FAIL;
-                json_value_free(r_tval);
-                goto err;
-            }
-
-            /*
-             * Output the test case results using JSON
-             */
-            rv = acvp_kdf135_x963_output_tc(ctx, &stc, r_tobj);
-            if (rv != ACVP_SUCCESS) {
-                ACVP_LOG_ERR("JSON output failure in hash module");
-                acvp_kdf135_x963_release_tc(&stc);
-                json_value_free(r_tval);
-                goto err;
-            }
-            /*
-             * Release all the memory associated with the test case
-             */
-            acvp_kdf135_x963_release_tc(&stc);
-
-            /* Append the test response value to array */
-            json_array_append_value(r_tarr, r_tval);
+        /*
+         * Setup the test case data that will be passed down to
+         * the crypto module, the rest of it comes from the tests.
+         */
+        memzero_s(&stc, sizeof(ACVP_KDF135_X963_TC));
+        stc.cipher = alg_id;
+        stc.hash_alg = hash_alg;
+        stc.field_size = field_size / 8;
+        stc.key_data_len = key_data_length / 8;
+        stc.shared_info_len = shared_info_len / 8;
+
+        rv = acvp_kdf135_tg_run(ctx, cap, &acvp_kdf135_x963_tg, &slots, &stc, groupobj, tests, r_tarr);
+        if (rv != ACVP_SUCCESS) {
+            goto err;
         }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_kdf135_tg_free(&slots);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
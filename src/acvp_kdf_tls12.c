@@ -71,7 +71,6 @@ ACVP_RESULT acvp_kdf_tls12_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     const char *c_rnd = NULL;
     const char *sha = NULL;
     unsigned int kb_len, pm_len;
-    char *json_result;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -118,7 +117,7 @@ ACVP_RESULT acvp_kdf_tls12_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         goto err;
@@ -137,15 +136,15 @@ ACVP_RESULT acvp_kdf_tls12_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         pm_len = json_object_get_number(groupobj, "preMasterSecretLength");
         if (!pm_len) {
@@ -187,7 +186,7 @@ ACVP_RESULT acvp_kdf_tls12_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             pm_secret = json_object_get_string(testobj, "preMasterSecret");
             if (!pm_secret) {
@@ -251,7 +250,7 @@ ACVP_RESULT acvp_kdf_tls12_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 acvp_kdf_tls12_release_tc(&stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -283,9 +282,7 @@ ACVP_RESULT acvp_kdf_tls12_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -302,32 +299,21 @@ err:
  * the JSON processing for a single test case.
  */
 static ACVP_RESULT acvp_kdf_tls12_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS12_TC *stc, JSON_Object *tc_rsp) {
-    char *tmp = NULL;
     ACVP_RESULT rv = ACVP_SUCCESS;
 
-    tmp = calloc(1, ACVP_KDF_TLS12_MSG_MAX + 1);
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_kdf_tls12_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
-
-    rv = acvp_bin_to_hexstr(stc->msecret, stc->pm_len, tmp, ACVP_KDF_TLS12_MSG_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "masterSecret", stc->msecret, stc->pm_len, ACVP_KDF_TLS12_MSG_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (mac)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "masterSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS12_MSG_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->kblock, stc->kb_len, tmp, ACVP_KDF_TLS12_MSG_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "keyBlock", stc->kblock, stc->kb_len, ACVP_KDF_TLS12_MSG_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (mac)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "keyBlock", tmp);
 
 err:
-    free(tmp);
 
     return rv;
 }
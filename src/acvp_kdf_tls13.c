@@ -96,7 +96,6 @@ ACVP_RESULT acvp_kdf_tls13_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KDF_TLS13_TESTTYPE type = 0;
     ACVP_HASH_ALG hmac = 0;
     ACVP_KDF_TLS13_RUN_MODE runmode = 0;
-    char *json_result;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -143,7 +142,7 @@ ACVP_RESULT acvp_kdf_tls13_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         goto err;
@@ -162,15 +161,15 @@ ACVP_RESULT acvp_kdf_tls13_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         type_str = json_object_get_string(groupobj, "testType");
         if (!type_str) {
@@ -229,7 +228,7 @@ ACVP_RESULT acvp_kdf_tls13_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Server json missing 'tcId");
                 rv = ACVP_MISSING_ARG;
@@ -317,7 +316,7 @@ ACVP_RESULT acvp_kdf_tls13_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 acvp_kdf_tls13_release_tc(&stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -349,9 +348,7 @@ ACVP_RESULT acvp_kdf_tls13_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -368,28 +365,19 @@ err:
  * the JSON processing for a single test case.
  */
 static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *stc, JSON_Object *tc_rsp) {
-    char *tmp = NULL;
     ACVP_RESULT rv = ACVP_SUCCESS;
 
-    tmp = calloc(1, ACVP_KDF_TLS13_DATA_LEN_STR_MAX + 1);
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_kdf_tls13_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
-
     //append client early traffic secret 
     if (stc->cets_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
         ACVP_LOG_ERR("Provided length for test case output too long: cets_len");
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->c_early_traffic_secret, stc->cets_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "clientEarlyTrafficSecret", stc->c_early_traffic_secret, stc->cets_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (client early traffic secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "clientEarlyTrafficSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
 
     //append early export master secret
     if (stc->eems_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -397,13 +385,11 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->early_expt_master_secret, stc->eems_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "earlyExporterMasterSecret", stc->early_expt_master_secret, stc->eems_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (early export master secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "earlyExporterMasterSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
 
     //append client handshake traffic secret
     if (stc->chts_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -411,13 +397,11 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->c_hs_traffic_secret, stc->chts_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "clientHandshakeTrafficSecret", stc->c_hs_traffic_secret, stc->chts_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (client handshake traffic secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "clientHandshakeTrafficSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
 
     //append server handshake traffic secret
     if (stc->shts_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -425,13 +409,11 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->s_hs_traffic_secret, stc->shts_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "serverHandshakeTrafficSecret", stc->s_hs_traffic_secret, stc->shts_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (server handshake traffic secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "serverHandshakeTrafficSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
 
     //append client app traffic secret
     if (stc->cats_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -439,14 +421,11 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->c_app_traffic_secret, stc->cats_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "clientApplicationTrafficSecret", stc->c_app_traffic_secret, stc->cats_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (client app traffic secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "clientApplicationTrafficSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
-
 
     //append server app traffic secret
     if (stc->sats_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -454,14 +433,11 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->s_app_traffic_secret, stc->sats_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "serverApplicationTrafficSecret", stc->s_app_traffic_secret, stc->sats_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (server app traffic secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "serverApplicationTrafficSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
-
 
     //append exporter master secret
     if (stc->ems_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -469,13 +445,11 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->expt_master_secret, stc->ems_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "exporterMasterSecret", stc->expt_master_secret, stc->ems_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (exporter master secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "exporterMasterSecret", tmp);
-    memzero_s(tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
 
     //append resumption master secret
     if (stc->rms_len > ACVP_KDF_TLS13_DATA_LEN_BYTE_MAX) {
@@ -483,15 +457,13 @@ static ACVP_RESULT acvp_kdf_tls13_output_tc(ACVP_CTX *ctx, ACVP_KDF_TLS13_TC *st
         rv = ACVP_INVALID_ARG;
         goto err;
     }
-    rv = acvp_bin_to_hexstr(stc->resume_master_secret, stc->rms_len, tmp, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "resumptionMasterSecret", stc->resume_master_secret, stc->rms_len, ACVP_KDF_TLS13_DATA_LEN_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (resumption master secret)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "resumptionMasterSecret", tmp);
 
 err:
-    free(tmp);
 
     return rv;
 }
@@ -0,0 +1,366 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Keys generated ahead of the test cases that ask for them, see
+ * acvp_cap_set_key_pool(). There is a pool per capability and curve (ECDSA
+ * KeyGen, along with the secret generation mode) or safe prime group, kept
+ * on the session and filled by a thread of its own, which hands the producer
+ * of the capability a test case holding only what the pool has in common and
+ * keeps what it generates, up to the depth of the registration. The pools of
+ * everything registered are started before the vector sets are fetched, so
+ * the keys are made while the server generates the vectors; a KeyGen test
+ * case then only has a key copied into it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+#define ACVP_KEY_POOL_FIELDS 3       /* ECDSA: d, qx and qy; safe primes: x and y */
+#define ACVP_KEY_POOL_FIELD_MAX 2048 /* ACVP_RSA_EXP_LEN_MAX and ACVP_SAFE_PRIMES_BYTE_MAX */
+
+/*
+ * A key as the producer returned it, the fields one after the other
+ */
+typedef struct acvp_pooled_key_t {
+    int len[ACVP_KEY_POOL_FIELDS];
+    unsigned char data[];
+} ACVP_POOLED_KEY;
+
+typedef struct acvp_key_pool_t {
+    ACVP_CIPHER cipher;
+    int group;                  /* ECDSA: curve; safe primes: safe prime group */
+    int mode;                   /* ECDSA: secret generation mode */
+    int (*producer)(ACVP_TEST_CASE *test_case);
+    int depth;
+    ACVP_POOLED_KEY **keys;     /* Ring of depth keys, count of them from head */
+    int head;
+    int count;
+    int stop;                   /* Set when the session is freed */
+    int failed;                 /* The producer failed, test cases go to the crypto_handler */
+    ACVP_MUTEX lock;            /* Guards keys, head, count, stop and failed */
+    ACVP_COND cond;             /* Signalled as keys are added and taken */
+    ACVP_THREAD thread;
+    struct acvp_key_pool_t *next;
+} ACVP_KEY_POOL;
+
+static ACVP_CTX *acvp_key_pool_owner(ACVP_CTX *ctx) {
+    return ctx->session ? ctx->session : ctx;
+}
+
+/*
+ * Points buf and len at the key fields of a KeyGen test case of cipher.
+ * Returns how many there are, 0 if cipher has no key pool.
+ */
+static int acvp_key_pool_fields(ACVP_CIPHER cipher, ACVP_TEST_CASE *tc, unsigned char **buf, int **len) {
+    ACVP_ECDSA_TC *ecdsa = NULL;
+    ACVP_SAFE_PRIMES_TC *safe_primes = NULL;
+
+    if (cipher == ACVP_ECDSA_KEYGEN) {
+        ecdsa = tc->tc.ecdsa;
+        buf[0] = ecdsa->d;
+        len[0] = &ecdsa->d_len;
+        buf[1] = ecdsa->qx;
+        len[1] = &ecdsa->qx_len;
+        buf[2] = ecdsa->qy;
+        len[2] = &ecdsa->qy_len;
+        return 3;
+    }
+    if (cipher == ACVP_SAFE_PRIMES_KEYGEN) {
+        safe_primes = tc->tc.safe_primes;
+        buf[0] = safe_primes->x;
+        len[0] = &safe_primes->xlen;
+        buf[1] = safe_primes->y;
+        len[1] = &safe_primes->ylen;
+        return 2;
+    }
+    return 0;
+}
+
+static void acvp_key_pool_free_key(ACVP_POOLED_KEY *key) {
+    int i = 0, total = 0;
+
+    for (i = 0; i < ACVP_KEY_POOL_FIELDS; i++) {
+        total += key->len[i];
+    }
+    if (total) {
+        memzero_s(key->data, total);
+    }
+    free(key);
+}
+
+/*
+ * Has the producer generate one key over the parameters of the pool, in the
+ * scratch test case tc whose fields are buf. Returns NULL if it failed or
+ * returned fields that would not fit a test case.
+ */
+static ACVP_POOLED_KEY *acvp_key_pool_produce(ACVP_KEY_POOL *pool, ACVP_TEST_CASE *tc, unsigned char *scratch) {
+    ACVP_ECDSA_TC *ecdsa = tc->tc.ecdsa;
+    ACVP_SAFE_PRIMES_TC *safe_primes = tc->tc.safe_primes;
+    ACVP_POOLED_KEY *key = NULL;
+    unsigned char *buf[ACVP_KEY_POOL_FIELDS];
+    int *len[ACVP_KEY_POOL_FIELDS];
+    int cnt = 0, i = 0, total = 0, off = 0;
+
+    memzero_s(scratch, ACVP_KEY_POOL_FIELDS * ACVP_KEY_POOL_FIELD_MAX);
+    if (pool->cipher == ACVP_ECDSA_KEYGEN) {
+        memzero_s(ecdsa, sizeof(ACVP_ECDSA_TC));
+        ecdsa->cipher = pool->cipher;
+        ecdsa->curve = pool->group;
+        ecdsa->secret_gen_mode = pool->mode;
+        ecdsa->d = scratch;
+        ecdsa->qx = scratch + ACVP_KEY_POOL_FIELD_MAX;
+        ecdsa->qy = scratch + 2 * ACVP_KEY_POOL_FIELD_MAX;
+    } else {
+        memzero_s(safe_primes, sizeof(ACVP_SAFE_PRIMES_TC));
+        safe_primes->cipher = pool->cipher;
+        safe_primes->dgm = pool->group;
+        safe_primes->group = acvp_lookup_safe_primes_group(pool->group);
+        safe_primes->test_type = ACVP_SAFE_PRIMES_TT_AFT;
+        safe_primes->x = scratch;
+        safe_primes->y = scratch + ACVP_KEY_POOL_FIELD_MAX;
+    }
+
+    if ((pool->producer)(tc)) {
+        return NULL;
+    }
+
+    cnt = acvp_key_pool_fields(pool->cipher, tc, buf, len);
+    for (i = 0; i < cnt; i++) {
+        if (*len[i] <= 0 || *len[i] > ACVP_KEY_POOL_FIELD_MAX) {
+            return NULL;
+        }
+        total += *len[i];
+    }
+    key = calloc(1, sizeof(ACVP_POOLED_KEY) + total);
+    if (!key) {
+        return NULL;
+    }
+    for (i = 0; i < cnt; i++) {
+        memcpy_s(key->data + off, total - off, buf[i], *len[i]);
+        key->len[i] = *len[i];
+        off += *len[i];
+    }
+    return key;
+}
+
+/*
+ * The thread of a pool: keeps it at its depth until the session is freed or
+ * the producer fails
+ */
+static void acvp_key_pool_fill(void *arg) {
+    ACVP_KEY_POOL *pool = arg;
+    ACVP_TEST_CASE tc;
+    ACVP_ECDSA_TC ecdsa;
+    ACVP_SAFE_PRIMES_TC safe_primes;
+    ACVP_POOLED_KEY *key = NULL;
+    unsigned char *scratch = NULL;
+
+    memzero_s(&tc, sizeof(ACVP_TEST_CASE));
+    if (pool->cipher == ACVP_ECDSA_KEYGEN) {
+        tc.tc.ecdsa = &ecdsa;
+    } else {
+        tc.tc.safe_primes = &safe_primes;
+    }
+    scratch = calloc(ACVP_KEY_POOL_FIELDS, ACVP_KEY_POOL_FIELD_MAX);
+
+    acvp_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->count == pool->depth) {
+            acvp_cond_wait(&pool->cond, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        acvp_mutex_unlock(&pool->lock);
+        key = scratch ? acvp_key_pool_produce(pool, &tc, scratch) : NULL;
+        acvp_mutex_lock(&pool->lock);
+        if (!key) {
+            pool->failed = 1;
+            acvp_cond_broadcast(&pool->cond);
+            break;
+        }
+        pool->keys[(pool->head + pool->count) % pool->depth] = key;
+        pool->count++;
+        acvp_cond_broadcast(&pool->cond);
+    }
+    acvp_mutex_unlock(&pool->lock);
+
+    if (scratch) {
+        memzero_s(scratch, ACVP_KEY_POOL_FIELDS * ACVP_KEY_POOL_FIELD_MAX);
+        free(scratch);
+    }
+}
+
+/*
+ * Finds the pool of cap for group and mode, starting it if there is none yet.
+ * Returns NULL if cap has no key pool or one cannot be started. The caller
+ * holds the key_pool_lock of the session.
+ */
+static ACVP_KEY_POOL *acvp_key_pool_get(ACVP_CTX *owner, ACVP_CAPS_LIST *cap, int group, int mode) {
+    ACVP_KEY_POOL *pool = NULL;
+    int (*producer)(ACVP_TEST_CASE *test_case) = cap->key_producer ? cap->key_producer : cap->crypto_handler;
+
+    if (!cap->key_pool_depth || !producer) {
+        return NULL;
+    }
+    for (pool = owner->key_pools; pool; pool = pool->next) {
+        if (pool->cipher == cap->cipher && pool->group == group && pool->mode == mode) {
+            return pool;
+        }
+    }
+
+    pool = calloc(1, sizeof(ACVP_KEY_POOL));
+    if (!pool) {
+        return NULL;
+    }
+    pool->keys = calloc(cap->key_pool_depth, sizeof(ACVP_POOLED_KEY *));
+    if (!pool->keys) {
+        free(pool);
+        return NULL;
+    }
+    pool->cipher = cap->cipher;
+    pool->group = group;
+    pool->mode = mode;
+    pool->producer = producer;
+    pool->depth = cap->key_pool_depth;
+    acvp_mutex_init(&pool->lock);
+    acvp_cond_init(&pool->cond);
+    if (acvp_thread_create(&pool->thread, acvp_key_pool_fill, pool) != ACVP_SUCCESS) {
+        acvp_cond_destroy(&pool->cond);
+        acvp_mutex_destroy(&pool->lock);
+        free(pool->keys);
+        free(pool);
+        return NULL;
+    }
+    pool->next = owner->key_pools;
+    owner->key_pools = pool;
+    return pool;
+}
+
+/*
+ * Starts the pools of every curve and secret generation mode, or safe prime
+ * group, registered for the capabilities that have a key pool
+ */
+void acvp_key_pool_prime(ACVP_CTX *ctx) {
+    ACVP_CTX *owner = acvp_key_pool_owner(ctx);
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_CURVE_ALG_COMPAT_LIST *curve = NULL;
+    ACVP_NAME_LIST *mode = NULL;
+    ACVP_PARAM_LIST *group = NULL;
+
+    acvp_mutex_lock(&owner->key_pool_lock);
+    for (cap = ctx->caps_list; cap; cap = cap->next) {
+        if (!cap->key_pool_depth) {
+            continue;
+        }
+#ifndef ACVP_NO_ECDSA
+        if (cap->cipher == ACVP_ECDSA_KEYGEN && cap->cap.ecdsa_keygen_cap) {
+            for (curve = cap->cap.ecdsa_keygen_cap->curves; curve; curve = curve->next) {
+                for (mode = cap->cap.ecdsa_keygen_cap->secret_gen_modes; mode; mode = mode->next) {
+                    acvp_key_pool_get(owner, cap, curve->curve, acvp_ecdsa_read_secret_gen_mode(mode->name));
+                }
+            }
+            continue;
+        }
+#endif
+        if (cap->cipher == ACVP_SAFE_PRIMES_KEYGEN && cap->cap.safe_primes_keygen_cap &&
+                   cap->cap.safe_primes_keygen_cap->mode) {
+            for (group = cap->cap.safe_primes_keygen_cap->mode->genmeth; group; group = group->next) {
+                acvp_key_pool_get(owner, cap, group->param, 0);
+            }
+        }
+    }
+    acvp_mutex_unlock(&owner->key_pool_lock);
+}
+
+/*
+ * Fills the KeyGen test case tc of cap, whose key fields are allocated, with
+ * a key from the pool for group and mode, waiting for one to be generated if
+ * the pool is empty. Returns 1 if it did, 0 if the test case is to be handed
+ * to the crypto_handler as usual: the capability has no key pool, or its
+ * producer has failed.
+ */
+int acvp_key_pool_take(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, int group, int mode, ACVP_TEST_CASE *tc) {
+    ACVP_CTX *owner = acvp_key_pool_owner(ctx);
+    ACVP_KEY_POOL *pool = NULL;
+    ACVP_POOLED_KEY *key = NULL;
+    unsigned char *buf[ACVP_KEY_POOL_FIELDS];
+    int *len[ACVP_KEY_POOL_FIELDS];
+    int cnt = 0, i = 0, off = 0;
+
+    if (!cap->key_pool_depth) {
+        return 0;
+    }
+    acvp_mutex_lock(&owner->key_pool_lock);
+    pool = acvp_key_pool_get(owner, cap, group, mode);
+    acvp_mutex_unlock(&owner->key_pool_lock);
+    if (!pool) {
+        return 0;
+    }
+
+    acvp_mutex_lock(&pool->lock);
+    while (!pool->count && !pool->failed) {
+        acvp_cond_wait(&pool->cond, &pool->lock);
+    }
+    if (pool->count) {
+        key = pool->keys[pool->head];
+        pool->keys[pool->head] = NULL;
+        pool->head = (pool->head + 1) % pool->depth;
+        pool->count--;
+        acvp_cond_broadcast(&pool->cond);
+    }
+    acvp_mutex_unlock(&pool->lock);
+    if (!key) {
+        ACVP_LOG_WARN("Key pool producer failed, the crypto module generates the key");
+        return 0;
+    }
+
+    cnt = acvp_key_pool_fields(cap->cipher, tc, buf, len);
+    for (i = 0; i < cnt; i++) {
+        memcpy_s(buf[i], ACVP_KEY_POOL_FIELD_MAX, key->data + off, key->len[i]);
+        *len[i] = key->len[i];
+        off += key->len[i];
+    }
+    acvp_key_pool_free_key(key);
+    return 1;
+}
+
+/*
+ * Stops the pools of the session and releases the keys left in them
+ */
+void acvp_key_pool_free(ACVP_CTX *ctx) {
+    ACVP_KEY_POOL *pool = NULL, *next = NULL;
+    int i = 0;
+
+    for (pool = ctx->key_pools; pool; pool = pool->next) {
+        acvp_mutex_lock(&pool->lock);
+        pool->stop = 1;
+        acvp_cond_broadcast(&pool->cond);
+        acvp_mutex_unlock(&pool->lock);
+    }
+    for (pool = ctx->key_pools; pool; pool = next) {
+        next = pool->next;
+        acvp_thread_join(pool->thread);
+        for (i = 0; i < pool->count; i++) {
+            acvp_key_pool_free_key(pool->keys[(pool->head + i) % pool->depth]);
+        }
+        acvp_cond_destroy(&pool->cond);
+        acvp_mutex_destroy(&pool->lock);
+        free(pool->keys);
+        free(pool);
+    }
+    ctx->key_pools = NULL;
+}
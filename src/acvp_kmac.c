@@ -30,7 +30,8 @@ static ACVP_RESULT acvp_kmac_init_tc(ACVP_CTX *ctx,
                                      int mac_len,
                                      const char *key,
                                      int key_len,
-                                     const char *custom) {
+                                     const char *custom,
+                                     int use_sink) {
 
     ACVP_RESULT rv;
     int len = 0;
@@ -38,8 +39,14 @@ static ACVP_RESULT acvp_kmac_init_tc(ACVP_CTX *ctx,
 
     stc->msg = calloc(1, ACVP_KMAC_MSG_BYTE_MAX);
     if (!stc->msg) { return ACVP_MALLOC_FAIL; }
-    stc->mac = calloc(1, ACVP_KMAC_MAC_BYTE_MAX);
-    if (!stc->mac) { return ACVP_MALLOC_FAIL; }
+    if (type == ACVP_KMAC_TEST_TYPE_AFT && use_sink) {
+        /* The crypto module writes the mac straight into the response */
+        stc->mac_sink = acvp_output_sink_new(mac_len / 8);
+        if (!stc->mac_sink) { return ACVP_MALLOC_FAIL; }
+    } else {
+        stc->mac = calloc(1, ACVP_KMAC_MAC_BYTE_MAX);
+        if (!stc->mac) { return ACVP_MALLOC_FAIL; }
+    }
     stc->key = calloc(1, ACVP_KMAC_KEY_BYTE_MAX);
     if (!stc->key) { return ACVP_MALLOC_FAIL; }
     if (hex_customization) {
@@ -109,27 +116,29 @@ static ACVP_RESULT acvp_kmac_init_tc(ACVP_CTX *ctx,
  */
 static ACVP_RESULT acvp_kmac_output_tc(ACVP_CTX *ctx, ACVP_KMAC_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
-    if (stc->test_type == ACVP_KMAC_TEST_TYPE_AFT) {
-        tmp = calloc(ACVP_KMAC_MAC_STR_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in acvp_kmac_output_tc");
-            return ACVP_MALLOC_FAIL;
+    if (stc->mac_sink) {
+        if (stc->mac_sink->len != stc->mac_sink->max) {
+            ACVP_LOG_ERR("crypto module wrote %u of the %u bytes of output", stc->mac_sink->len,
+                         stc->mac_sink->max);
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_output_sink_set(stc->mac_sink, tc_rsp, "mac");
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure (mac)");
         }
+    } else if (stc->test_type == ACVP_KMAC_TEST_TYPE_AFT) {
 
-        rv = acvp_bin_to_hexstr(stc->mac, stc->mac_len, tmp, ACVP_KMAC_MAC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "mac", stc->mac, stc->mac_len, ACVP_KMAC_MAC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (mac)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "mac", tmp);
     } else { /* verify */
         json_object_set_boolean(tc_rsp, "testPassed", stc->disposition);
     }
 
 end:
-    if (tmp) free(tmp);
     return rv;
 }
 
@@ -140,6 +149,7 @@ end:
 static ACVP_RESULT acvp_kmac_release_tc(ACVP_KMAC_TC *stc) {
     if (stc->msg) free(stc->msg);
     if (stc->mac) free(stc->mac);
+    acvp_output_sink_free(stc->mac_sink);
     if (stc->key) free(stc->key);
     if (stc->custom) free(stc->custom);
     if (stc->custom_hex) free(stc->custom_hex);
@@ -185,12 +195,15 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_KMAC_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_KMAC_TC stc, group_stc;
+    ACVP_TEST_CASE tc, group_tc;
+    ACVP_TG_KEYS keys;
+    const char *key_parts[2];
+    unsigned int key_id = 0;
+    int group_open = 0;
     ACVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     ACVP_CIPHER alg_id;
-    char *json_result;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -209,6 +222,9 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     /* Get a reference to the abstracted test case */
     tc.tc.kmac = &stc;
+    group_tc.tc.kmac = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_KMAC_TC));
+    memzero_s(&keys, sizeof(ACVP_TG_KEYS));
 
     /* Get the crypto module handler for this kmac algorithm */
     alg_id = acvp_lookup_cipher_index(alg_str);
@@ -234,7 +250,7 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -258,15 +274,15 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_TC_MISSING_DATA;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         type_str = json_object_get_string(groupobj, "testType");
         if (!type_str) {
@@ -313,12 +329,30 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             goto err;
         }
 
+        /*
+         * Let the crypto module set up the MAC of the group once; the
+         * lengths are those of each test case
+         */
+        if (cap->group_handler) {
+            memzero_s(&group_stc, sizeof(ACVP_KMAC_TC));
+            group_stc.cipher = alg_id;
+            group_stc.test_type = type;
+            group_stc.xof = xof;
+            group_stc.hex_customization = hex_customization;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new kmac test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Failed to include tc_id. ");
                 rv = ACVP_TC_MISSING_DATA;
@@ -416,6 +450,9 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             ACVP_LOG_VERBOSE("              msg: %s", msg);
             ACVP_LOG_VERBOSE("           keyLen: %d", keylen);
             ACVP_LOG_VERBOSE("              key: %s", key);
+            key_parts[0] = key;
+            key_parts[1] = custom;
+            key_id = acvp_tg_key_id_parts(&keys, key_parts, 2, ACVP_KMAC_KEY_STR_MAX + 1);
 
             /*
              * Create a new test case in the response
@@ -430,16 +467,19 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
              * the crypto module.
              */
             rv = acvp_kmac_init_tc(ctx, &stc, alg_id, tc_id, type, xof, hex_customization,
-                                     msg, msglen, mac, maclen, key, keylen, custom);
+                                     msg, msglen, mac, maclen, key, keylen, custom,
+                                     acvp_output_sink_enabled(cap));
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("Error initializing KMAC test case");
                 acvp_kmac_release_tc(&stc);
                 json_value_free(r_tval);
                 goto err;
             }
+            stc.key_id = key_id;
+            stc.tg_ctx = group_stc.tg_ctx;
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                 acvp_kmac_release_tc(&stc);
                 json_value_free(r_tval);
@@ -465,17 +505,28 @@ ACVP_RESULT acvp_kmac_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        acvp_tg_keys_clear(&keys);
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_tg_keys_clear(&keys);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
@@ -27,36 +27,22 @@ static ACVP_RESULT acvp_kts_ifc_output_tc(ACVP_CTX *ctx,
                                               ACVP_KTS_IFC_TC *stc,
                                               JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_KTS_IFC_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_aes_output_mct_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->kts_role == ACVP_KTS_IFC_INITIATOR) {
-        memzero_s(tmp, ACVP_KTS_IFC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->ct, stc->ct_len, tmp, ACVP_KTS_IFC_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "iutC", stc->ct, stc->ct_len, ACVP_KTS_IFC_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (iutC)");
             goto end;
         }
-
-        json_object_set_string(tc_rsp, "iutC", tmp);
     }
 
-    memzero_s(tmp, ACVP_KTS_IFC_STR_MAX);
-    rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_KTS_IFC_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "dkm", stc->pt, stc->pt_len, ACVP_KTS_IFC_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (dkm)");
         goto end;
     }
 
-    json_object_set_string(tc_rsp, "dkm", tmp);
-
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -253,6 +239,15 @@ static ACVP_RESULT acvp_kts_ifc(ACVP_CTX *ctx,
     ACVP_KTS_IFC_ROLES role = 0;
     ACVP_KTS_IFC_KEYGEN key_gen = 0;
 
+    ACVP_TEST_CASE group_tc;
+    ACVP_KTS_IFC_TC group_stc;
+    ACVP_TG_KEYS keys;
+    unsigned int key_id = 0;
+    int group_open = 0;
+
+    group_tc.tc.kts_ifc = &group_stc;
+    memzero_s(&keys, sizeof(ACVP_TG_KEYS));
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
 
@@ -267,15 +262,15 @@ static ACVP_RESULT acvp_kts_ifc(ACVP_CTX *ctx,
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
 
         test_type_str = json_object_get_string(groupobj, "testType");
@@ -413,12 +408,32 @@ static ACVP_RESULT acvp_kts_ifc(ACVP_CTX *ctx,
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Let the crypto module set up what the tests of this group share
+         */
+        memzero_s(&group_stc, sizeof(ACVP_KTS_IFC_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = cap->cipher;
+            group_stc.test_type = test_type;
+            group_stc.key_gen = key_gen;
+            group_stc.md = hash_alg;
+            group_stc.kts_role = role;
+            group_stc.modulo = modulo;
+            group_stc.llen = llen / 8;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
         for (j = 0; j < t_cnt; j++) {
 
             ACVP_LOG_VERBOSE("Found new KTS-IFC Component test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             if (role == ACVP_KTS_IFC_RESPONDER) {
                 ct = json_object_get_string(testobj, "serverC");
@@ -574,6 +589,11 @@ static ACVP_RESULT acvp_kts_ifc(ACVP_CTX *ctx,
             ACVP_LOG_VERBOSE("              e: %s", e);
 
 
+            key_id = 0;
+            if (role == ACVP_KTS_IFC_RESPONDER) {
+                key_id = acvp_tg_key_id(&keys, n, (key_gen == ACVP_KTS_IFC_RSAKPG1_CRT || key_gen == ACVP_KTS_IFC_RSAKPG2_CRT) ? dmp1 : d, ACVP_KTS_IFC_STR_MAX);
+            }
+
             /*
              * Create a new test case in the response
              */
@@ -592,9 +612,11 @@ static ACVP_RESULT acvp_kts_ifc(ACVP_CTX *ctx,
                 json_value_free(r_tval);
                 goto err;
             }
+            stc->key_id = key_id;
+            stc->tg_ctx = group_stc.tg_ctx;
 
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, tc)) {
                 acvp_kts_ifc_release_tc(stc);
                 ACVP_LOG_ERR("crypto module failed the operation");
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -621,11 +643,24 @@ static ACVP_RESULT acvp_kts_ifc(ACVP_CTX *ctx,
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        acvp_tg_keys_clear(&keys);
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     rv = ACVP_SUCCESS;
 
 err:
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_tg_keys_clear(&keys);
     if (rv != ACVP_SUCCESS) {
         json_value_free(r_gval);
     }
@@ -644,7 +679,6 @@ ACVP_RESULT acvp_kts_ifc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_KTS_IFC_TC stc;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL;
-    char *json_result = NULL;
 
     if (!ctx) {
         ACVP_LOG_ERR("No ctx for handler operation");
@@ -675,7 +709,7 @@ ACVP_RESULT acvp_kts_ifc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -692,9 +726,7 @@ ACVP_RESULT acvp_kts_ifc_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
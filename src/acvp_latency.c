@@ -0,0 +1,447 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Crypto handler latency, see acvp_set_crypto_latency(). The histograms are
+ * log-linear, as HDR histograms are: below 2 * ACVP_LAT_SUB ns each
+ * nanosecond has a bucket, and above that each power of two is split into
+ * ACVP_LAT_SUB buckets, which keeps any value to within 1/ACVP_LAT_SUB of
+ * what it was in a fixed number of counters.
+ *
+ * An exec context keeps the histogram and the slowest test cases of the
+ * vector set it is processing, which is all of one algorithm, and adds them
+ * to those of the session under its session_lock once the KAT handler is
+ * done, see acvp_lat_vs_done().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+ACVP_RESULT acvp_set_crypto_latency(ACVP_CTX *ctx, int enable, int slowest) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (slowest < 0 || slowest > ACVP_LAT_SLOWEST_MAX || (slowest && !enable)) {
+        ACVP_LOG_ERR("The slowest test cases kept must be between 0 and %d, and latency enabled",
+                     ACVP_LAT_SLOWEST_MAX);
+        return ACVP_INVALID_ARG;
+    }
+    ctx->lat_enabled = enable ? 1 : 0;
+    ctx->lat_slowest = slowest;
+    return ACVP_SUCCESS;
+}
+
+static int acvp_lat_index(unsigned long long int ns) {
+    unsigned long long int v = ns;
+    int e = 0, idx = 0;
+
+    if (ns < 2 * ACVP_LAT_SUB) {
+        return (int)ns;
+    }
+    while (v >= 2 * ACVP_LAT_SUB) {
+        v >>= 1;
+        e++;
+    }
+    idx = (e + 1) * ACVP_LAT_SUB + (int)(v - ACVP_LAT_SUB);
+    return idx < ACVP_LAT_BUCKETS ? idx : ACVP_LAT_BUCKETS - 1;
+}
+
+/* The highest value that goes in bucket idx */
+static unsigned long long int acvp_lat_value(int idx) {
+    unsigned long long int v = 0;
+    int e = 0;
+
+    if (idx < 2 * ACVP_LAT_SUB) {
+        return (unsigned long long int)idx;
+    }
+    e = idx / ACVP_LAT_SUB - 1;
+    v = ACVP_LAT_SUB + idx % ACVP_LAT_SUB;
+    return ((v + 1) << e) - 1;
+}
+
+/*
+ * Where the tcId is kept in the test cases of a capability type, -1 for the
+ * types whose test cases do not have one
+ */
+static int acvp_lat_tc_id_offset(ACVP_CAP_TYPE type) {
+    switch (type) {
+    case ACVP_SYM_TYPE:
+        return (int)offsetof(ACVP_SYM_CIPHER_TC, tc_id);
+    case ACVP_HASH_TYPE:
+        return (int)offsetof(ACVP_HASH_TC, tc_id);
+    case ACVP_DRBG_TYPE:
+        return (int)offsetof(ACVP_DRBG_TC, tc_id);
+    case ACVP_HMAC_TYPE:
+        return (int)offsetof(ACVP_HMAC_TC, tc_id);
+    case ACVP_CMAC_TYPE:
+        return (int)offsetof(ACVP_CMAC_TC, tc_id);
+    case ACVP_KMAC_TYPE:
+        return (int)offsetof(ACVP_KMAC_TC, tc_id);
+    case ACVP_RSA_KEYGEN_TYPE:
+        return (int)offsetof(ACVP_RSA_KEYGEN_TC, tc_id);
+    case ACVP_RSA_SIGGEN_TYPE:
+    case ACVP_RSA_SIGVER_TYPE:
+        return (int)offsetof(ACVP_RSA_SIG_TC, tc_id);
+    case ACVP_RSA_PRIM_TYPE:
+        return (int)offsetof(ACVP_RSA_PRIM_TC, tc_id);
+    case ACVP_ECDSA_KEYGEN_TYPE:
+    case ACVP_ECDSA_KEYVER_TYPE:
+    case ACVP_ECDSA_SIGGEN_TYPE:
+    case ACVP_ECDSA_SIGVER_TYPE:
+    case ACVP_DET_ECDSA_SIGGEN_TYPE:
+        return (int)offsetof(ACVP_ECDSA_TC, tc_id);
+    case ACVP_EDDSA_KEYGEN_TYPE:
+    case ACVP_EDDSA_KEYVER_TYPE:
+    case ACVP_EDDSA_SIGGEN_TYPE:
+    case ACVP_EDDSA_SIGVER_TYPE:
+        return (int)offsetof(ACVP_EDDSA_TC, tc_id);
+    case ACVP_DSA_TYPE:
+        return (int)offsetof(ACVP_DSA_TC, tc_id);
+    case ACVP_KDF135_SNMP_TYPE:
+        return (int)offsetof(ACVP_KDF135_SNMP_TC, tc_id);
+    case ACVP_KDF135_SSH_TYPE:
+        return (int)offsetof(ACVP_KDF135_SSH_TC, tc_id);
+    case ACVP_KDF135_SRTP_TYPE:
+        return (int)offsetof(ACVP_KDF135_SRTP_TC, tc_id);
+    case ACVP_KDF135_IKEV2_TYPE:
+        return (int)offsetof(ACVP_KDF135_IKEV2_TC, tc_id);
+    case ACVP_KDF135_IKEV1_TYPE:
+        return (int)offsetof(ACVP_KDF135_IKEV1_TC, tc_id);
+    case ACVP_KDF135_X942_TYPE:
+        return (int)offsetof(ACVP_KDF135_X942_TC, tc_id);
+    case ACVP_KDF135_X963_TYPE:
+        return (int)offsetof(ACVP_KDF135_X963_TC, tc_id);
+    case ACVP_KDF108_TYPE:
+        return (int)offsetof(ACVP_KDF108_TC, tc_id);
+    case ACVP_PBKDF_TYPE:
+        return (int)offsetof(ACVP_PBKDF_TC, tc_id);
+    case ACVP_KDF_TLS12_TYPE:
+        return (int)offsetof(ACVP_KDF_TLS12_TC, tc_id);
+    case ACVP_KDF_TLS13_TYPE:
+        return (int)offsetof(ACVP_KDF_TLS13_TC, tc_id);
+    case ACVP_KDA_ONESTEP_TYPE:
+        return (int)offsetof(ACVP_KDA_ONESTEP_TC, tc_id);
+    case ACVP_KDA_TWOSTEP_TYPE:
+        return (int)offsetof(ACVP_KDA_TWOSTEP_TC, tc_id);
+    case ACVP_KDA_HKDF_TYPE:
+        return (int)offsetof(ACVP_KDA_HKDF_TC, tc_id);
+    case ACVP_SAFE_PRIMES_KEYGEN_TYPE:
+    case ACVP_SAFE_PRIMES_KEYVER_TYPE:
+        return (int)offsetof(ACVP_SAFE_PRIMES_TC, tc_id);
+    case ACVP_LMS_KEYGEN_TYPE:
+    case ACVP_LMS_SIGGEN_TYPE:
+    case ACVP_LMS_SIGVER_TYPE:
+        return (int)offsetof(ACVP_LMS_TC, tc_id);
+    case ACVP_KDF135_TPM_TYPE:
+    case ACVP_KAS_ECC_CDH_TYPE:
+    case ACVP_KAS_ECC_COMP_TYPE:
+    case ACVP_KAS_ECC_NOCOMP_TYPE:
+    case ACVP_KAS_ECC_SSC_TYPE:
+    case ACVP_KAS_FFC_COMP_TYPE:
+    case ACVP_KAS_FFC_SSC_TYPE:
+    case ACVP_KAS_FFC_NOCOMP_TYPE:
+    case ACVP_KAS_IFC_TYPE:
+    case ACVP_KTS_IFC_TYPE:
+    default:
+        return -1;
+    }
+}
+
+/*
+ * Called as a vector set is handed to its KAT handler
+ */
+void acvp_lat_vs_begin(ACVP_CTX *ctx, ACVP_CIPHER cipher) {
+    ACVP_CAPS_LIST *cap = NULL;
+
+    ctx->exec.lat_case_cnt = 0;
+    ctx->exec.lat_tc_id_off = -1;
+    if (!ctx->lat_slowest) {
+        return;
+    }
+    cap = acvp_locate_cap_entry(ctx, cipher);
+    if (cap) {
+        ctx->exec.lat_tc_id_off = acvp_lat_tc_id_offset(cap->cap_type);
+    }
+}
+
+/*
+ * Keeps a test case if it is among the slowest of the vector set so far
+ */
+static void acvp_lat_keep_slowest(ACVP_CTX *ctx, unsigned long long int ns, ACVP_TEST_CASE *tc) {
+    ACVP_LAT_CASE *cases = ctx->exec.lat_cases;
+    ACVP_LAT_CASE *slot = NULL;
+    int i = 0, tc_id = 0;
+
+    if (ctx->exec.lat_case_cnt < ctx->lat_slowest) {
+        slot = &cases[ctx->exec.lat_case_cnt++];
+    } else {
+        slot = &cases[0];
+        for (i = 1; i < ctx->exec.lat_case_cnt; i++) {
+            if (cases[i].ns < slot->ns) {
+                slot = &cases[i];
+            }
+        }
+        if (ns <= slot->ns) {
+            return;
+        }
+    }
+    if (ctx->exec.lat_tc_id_off >= 0 && tc->tc.symmetric) {
+        memcpy_s(&tc_id, sizeof(int), (const char *)tc->tc.symmetric + ctx->exec.lat_tc_id_off, sizeof(int));
+    }
+    slot->tg_id = ctx->exec.tg_id;
+    slot->tc_id = tc_id;
+    slot->ns = ns;
+}
+
+/*
+ * Notes that calls test cases took ns in the crypto handler. A batch is only
+ * timed as a whole, so each of its test cases counts as the average of the
+ * batch, and tc is NULL for it: none of them are kept as the slowest.
+ */
+void acvp_lat_add(ACVP_CTX *ctx, unsigned long long int ns, int calls, ACVP_TEST_CASE *tc) {
+    ACVP_LAT_HIST *hist = ctx->exec.lat_vs;
+    unsigned long long int each = 0;
+
+    if (calls <= 0) {
+        return;
+    }
+    if (!hist) {
+        hist = calloc(1, sizeof(ACVP_LAT_HIST));
+        if (!hist) {
+            return;
+        }
+        ctx->exec.lat_vs = hist;
+    }
+    each = ns / calls;
+    if (!hist->count || each < hist->min_ns) {
+        hist->min_ns = each;
+    }
+    if (each > hist->max_ns) {
+        hist->max_ns = each;
+    }
+    hist->count += calls;
+    hist->sum_ns += ns;
+    hist->bucket[acvp_lat_index(each)] += calls;
+    if (tc && ctx->lat_slowest) {
+        acvp_lat_keep_slowest(ctx, ns, tc);
+    }
+}
+
+static int acvp_lat_case_cmp(const void *a, const void *b) {
+    const ACVP_LAT_CASE *x = a, *y = b;
+
+    if (x->ns == y->ns) {
+        return 0;
+    }
+    return x->ns < y->ns ? 1 : -1;
+}
+
+static void acvp_lat_merge(ACVP_LAT_HIST *to, const ACVP_LAT_HIST *from) {
+    int i = 0;
+
+    if (!to->count || from->min_ns < to->min_ns) {
+        to->min_ns = from->min_ns;
+    }
+    if (from->max_ns > to->max_ns) {
+        to->max_ns = from->max_ns;
+    }
+    to->count += from->count;
+    to->sum_ns += from->sum_ns;
+    for (i = 0; i < ACVP_LAT_BUCKETS; i++) {
+        to->bucket[i] += from->bucket[i];
+    }
+}
+
+/*
+ * Adds the latency of the vector set the KAT handler is done with to the
+ * session, along with its slowest test cases
+ */
+void acvp_lat_vs_done(ACVP_CTX *ctx) {
+    ACVP_CTX *owner = ctx->session ? ctx->session : ctx;
+    ACVP_LAT_HIST *hist = ctx->exec.lat_vs;
+    ACVP_CIPHER cipher = ctx->exec.cipher;
+    ACVP_LAT_SLOWEST *slowest = NULL, **tail = NULL;
+
+    if (!hist || !hist->count) {
+        ctx->exec.lat_case_cnt = 0;
+        return;
+    }
+    if (cipher <= ACVP_CIPHER_START || cipher >= ACVP_CIPHER_END) {
+        cipher = ACVP_CIPHER_START;
+    }
+    if (ctx->exec.lat_case_cnt) {
+        slowest = calloc(1, sizeof(ACVP_LAT_SLOWEST));
+        if (slowest) {
+            slowest->vs_id = ctx->exec.vs_id;
+            slowest->cipher = cipher;
+            slowest->cnt = ctx->exec.lat_case_cnt;
+            memcpy_s(slowest->cases, sizeof(slowest->cases), ctx->exec.lat_cases,
+                     slowest->cnt * sizeof(ACVP_LAT_CASE));
+            qsort(slowest->cases, slowest->cnt, sizeof(ACVP_LAT_CASE), &acvp_lat_case_cmp);
+        }
+    }
+
+    acvp_mutex_lock(&owner->session_lock);
+    if (!owner->lat_hist) {
+        owner->lat_hist = calloc(ACVP_CIPHER_END, sizeof(ACVP_LAT_HIST *));
+    }
+    if (owner->lat_hist && !owner->lat_hist[cipher]) {
+        owner->lat_hist[cipher] = calloc(1, sizeof(ACVP_LAT_HIST));
+    }
+    if (owner->lat_hist && owner->lat_hist[cipher]) {
+        acvp_lat_merge(owner->lat_hist[cipher], hist);
+    }
+    if (slowest) {
+        for (tail = &owner->lat_slowest_list; *tail; tail = &(*tail)->next);
+        *tail = slowest;
+    }
+    acvp_mutex_unlock(&owner->session_lock);
+
+    memzero_s(hist, sizeof(ACVP_LAT_HIST));
+    ctx->exec.lat_case_cnt = 0;
+}
+
+static unsigned long long int acvp_lat_percentile(const ACVP_LAT_HIST *hist, unsigned int per_mille) {
+    unsigned long long int target = 0, seen = 0, value = 0;
+    int i = 0;
+
+    target = (hist->count * per_mille + 999) / 1000;
+    if (!target) {
+        target = 1;
+    }
+    for (i = 0; i < ACVP_LAT_BUCKETS; i++) {
+        seen += hist->bucket[i];
+        if (seen >= target) {
+            break;
+        }
+    }
+    value = acvp_lat_value(i < ACVP_LAT_BUCKETS ? i : ACVP_LAT_BUCKETS - 1);
+    return value < hist->max_ns ? value : hist->max_ns;
+}
+
+ACVP_RESULT acvp_get_crypto_latency(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_LATENCY *latency) {
+    const ACVP_LAT_HIST *hist = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!latency || cipher <= ACVP_CIPHER_START || cipher >= ACVP_CIPHER_END) {
+        return ACVP_INVALID_ARG;
+    }
+    if (ctx->session) {
+        ctx = ctx->session;
+    }
+    memzero_s(latency, sizeof(ACVP_LATENCY));
+    acvp_mutex_lock(&ctx->session_lock);
+    if (ctx->lat_hist) {
+        hist = ctx->lat_hist[cipher];
+    }
+    if (hist && hist->count) {
+        latency->count = hist->count;
+        latency->min_ns = hist->min_ns;
+        latency->max_ns = hist->max_ns;
+        latency->mean_ns = hist->sum_ns / hist->count;
+        latency->p50_ns = acvp_lat_percentile(hist, 500);
+        latency->p90_ns = acvp_lat_percentile(hist, 900);
+        latency->p99_ns = acvp_lat_percentile(hist, 990);
+        latency->p999_ns = acvp_lat_percentile(hist, 999);
+    }
+    acvp_mutex_unlock(&ctx->session_lock);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The slowest test cases of each vector set, for the session info file, or
+ * NULL if none were kept
+ */
+JSON_Value *acvp_lat_slowest_json(ACVP_CTX *ctx) {
+    JSON_Value *val = NULL, *vs_val = NULL, *tc_val = NULL;
+    JSON_Array *arr = NULL, *tests = NULL;
+    JSON_Object *vs_obj = NULL, *tc_obj = NULL;
+    const ACVP_LAT_SLOWEST *slowest = NULL;
+    const char *name = NULL;
+    int i = 0;
+
+    acvp_mutex_lock(&ctx->session_lock);
+    if (!ctx->lat_slowest_list) {
+        goto end;
+    }
+    val = json_value_init_array();
+    arr = json_value_get_array(val);
+    for (slowest = ctx->lat_slowest_list; slowest && arr; slowest = slowest->next) {
+        vs_val = json_value_init_object();
+        vs_obj = json_value_get_object(vs_val);
+        if (!vs_obj) {
+            break;
+        }
+        json_object_set_number(vs_obj, "vsId", slowest->vs_id);
+        name = acvp_lookup_cipher_name(slowest->cipher);
+        if (name) {
+            json_object_set_string(vs_obj, "algorithm", name);
+        }
+        json_object_set_value(vs_obj, "tests", json_value_init_array());
+        tests = json_object_get_array(vs_obj, "tests");
+        for (i = 0; i < slowest->cnt && tests; i++) {
+            tc_val = json_value_init_object();
+            tc_obj = json_value_get_object(tc_val);
+            if (!tc_obj) {
+                break;
+            }
+            json_object_set_number(tc_obj, "tgId", slowest->cases[i].tg_id);
+            json_object_set_number(tc_obj, "tcId", slowest->cases[i].tc_id);
+            json_object_set_number(tc_obj, "nanoseconds", (double)slowest->cases[i].ns);
+            json_array_append_value(tests, tc_val);
+        }
+        json_array_append_value(arr, vs_val);
+    }
+end:
+    acvp_mutex_unlock(&ctx->session_lock);
+    return val;
+}
+
+/*
+ * Drops the slowest test cases of the session; the histograms are kept for
+ * the life of the context
+ */
+void acvp_lat_clear_session(ACVP_CTX *ctx) {
+    ACVP_LAT_SLOWEST *slowest = NULL, *next = NULL;
+
+    for (slowest = ctx->lat_slowest_list; slowest; slowest = next) {
+        next = slowest->next;
+        free(slowest);
+    }
+    ctx->lat_slowest_list = NULL;
+}
+
+/*
+ * Frees the latency kept by a session context
+ */
+void acvp_lat_free(ACVP_CTX *ctx) {
+    int i = 0;
+
+    acvp_lat_clear_session(ctx);
+    if (ctx->lat_hist) {
+        for (i = 0; i < ACVP_CIPHER_END; i++) {
+            if (ctx->lat_hist[i]) free(ctx->lat_hist[i]);
+        }
+        free(ctx->lat_hist);
+        ctx->lat_hist = NULL;
+    }
+    if (ctx->exec.lat_vs) {
+        free(ctx->exec.lat_vs);
+        ctx->exec.lat_vs = NULL;
+    }
+}
@@ -17,6 +17,13 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+static ACVP_RESULT acvp_lms_run_batch(ACVP_CTX *ctx,
+                                      ACVP_CAPS_LIST *cap,
+                                      ACVP_TC_BATCH *batch,
+                                      JSON_Array *r_tarr);
+
+static void acvp_lms_release_batch(ACVP_LMS_TC **stcs, ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -26,33 +33,27 @@
 static ACVP_RESULT acvp_lms_output_tc(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_LMS_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv;
     ACVP_SUB_LMS mode;
-    char *tmp = NULL;
 
     mode = acvp_get_lms_alg(cipher);
     if (!mode) {
         return ACVP_INTERNAL_ERR;
     }
 
-    tmp = calloc(ACVP_LMS_TMP_MAX + 1, sizeof(char));
-
     switch (mode) {
     case ACVP_SUB_LMS_KEYGEN:
-        memzero_s(tmp, ACVP_KTS_IFC_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->pub_key, stc->pub_key_len, tmp, ACVP_LMS_TMP_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "publicKey", stc->pub_key, stc->pub_key_len, ACVP_LMS_TMP_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (publicKey)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "publicKey", tmp);
         break;
     case ACVP_SUB_LMS_SIGGEN:
         /* This also needs publicKey in the test group response, handled elsewhere */
-        rv = acvp_bin_to_hexstr(stc->sig, stc->sig_len, tmp, ACVP_LMS_TMP_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "signature", stc->sig, stc->sig_len, ACVP_LMS_TMP_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (signature)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "signature", tmp);
         break;
     case ACVP_SUB_LMS_SIGVER:
         json_object_set_boolean(tc_rsp, "testPassed", stc->ver_disposition);
@@ -64,7 +65,6 @@ static ACVP_RESULT acvp_lms_output_tc(ACVP_CTX *ctx, ACVP_CIPHER cipher, ACVP_LM
     }
 
 end:
-    free(tmp);
     return rv;
 }
 
@@ -207,12 +207,14 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap = NULL;
-    ACVP_LMS_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_LMS_TC stc, group_stc;
+    ACVP_LMS_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TEST_CASE tc, group_tc;
+    ACVP_TC_BATCH batch;
     ACVP_RESULT rv;
+    int group_open = 0, use_batch = 0;
 
     ACVP_CIPHER alg_id;
-    char *json_result = NULL;
 
     ACVP_LMS_MODE lms_mode = 0;
     ACVP_LMOTS_MODE lmots_mode = 0;
@@ -232,7 +234,9 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
 
     memzero_s(&stc, sizeof(ACVP_LMS_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
     tc.tc.lms = &stc;
+    group_tc.tc.lms = &group_stc;
     mode_str = json_object_get_string(obj, "mode");
     if (!mode_str) {
         ACVP_LOG_ERR("Server JSON missing 'mode'");
@@ -264,7 +268,7 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -290,15 +294,15 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tg_id = json_object_get_number(groupobj, "tgId");
+        tg_id = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tg_id);
         if (!tg_id) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MISSING_ARG;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tg_id);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         type_str = json_object_get_string(groupobj, "testType");
         if (!type_str) {
@@ -367,11 +371,48 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             goto err;
         }
 
+        /*
+         * Let the crypto module set up what the tests of this group share,
+         * such as the tree of a SigGen group's key
+         */
+        memzero_s(&group_stc, sizeof(ACVP_LMS_TC));
+        if (cap->group_handler) {
+            group_stc.cipher = alg_id;
+            group_stc.tg_id = tg_id;
+            group_stc.type = type;
+            group_stc.lms_mode = lms_mode;
+            group_stc.lmots_mode = lmots_mode;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tg_id);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * SigVer test cases are independent of each other; when they are
+         * to be run in parallel the group is set up in one piece and then
+         * verified together. Each test case keeps its own buffers.
+         */
+        use_batch = alg_id == ACVP_LMS_SIGVER && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_LMS_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new LMS test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             if (alg_id == ACVP_LMS_KEYGEN) {
                 i_str = json_object_get_string(testobj, "i");
@@ -416,12 +457,26 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
-            rv = acvp_lms_init_tc(ctx, &stc, alg_id, tc_id, tg_id, type, lms_mode, lmots_mode, pub_str,
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_lms_init_tc(ctx, cur, alg_id, tc_id, tg_id, type, lms_mode, lmots_mode, pub_str,
                                   i_str, seed_str, msg_str, sig_str);
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to initialize LMS test case");
+                    acvp_lms_release_tc(cur);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                /* Verified with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.lms = cur;
+                continue;
+            }
 
             /* Process the current test vector... */
             if (rv == ACVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -437,17 +492,12 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
             /* For siggen, we need a public key for the test group object, grab from first TC for group */
             if (alg_id == ACVP_LMS_SIGGEN && !j) {
-                char *tmp = calloc(ACVP_LMS_TMP_MAX + 1, sizeof(char));
-                rv = acvp_bin_to_hexstr(stc.pub_key, stc.pub_key_len, tmp, ACVP_LMS_TMP_MAX);
+                rv = acvp_json_set_hex(r_gobj, "publicKey", stc.pub_key, stc.pub_key_len, ACVP_LMS_TMP_MAX);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("hex conversion failure (pub_key)");
-                    free(tmp);
                     json_value_free(r_tval);
                     goto err;
                 }
-                json_object_set_string(r_gobj, "publicKey", (const char *)tmp);
-                memzero_s(tmp, ACVP_LMS_TMP_MAX);
-                free(tmp);
             }
             rv = acvp_lms_output_tc(ctx, alg_id, &stc, r_tobj);
             if (rv != ACVP_SUCCESS) {
@@ -464,20 +514,87 @@ ACVP_RESULT acvp_lms_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
              */
             acvp_lms_release_tc(&stc);
         }
+        if (use_batch) {
+            rv = acvp_lms_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_lms_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tg_id);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_lms_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
     if (rv != ACVP_SUCCESS) {
         acvp_lms_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_lms_run_batch(ACVP_CTX *ctx,
+                                      ACVP_CAPS_LIST *cap,
+                                      ACVP_TC_BATCH *batch,
+                                      JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_lms_output_tc(ctx, batch->tcs[i].tc.lms->cipher, batch->tcs[i].tc.lms,
+                                json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in LMS module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_lms_release_batch(ACVP_LMS_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_lms_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
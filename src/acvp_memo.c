@@ -0,0 +1,590 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * The result memo, see acvp_set_result_memo(). The responses of the test
+ * groups of deterministic algorithms are kept in a store, one line of JSON
+ * per group:
+ *
+ *     {"key":"<fingerprint>","response":{"tgId":5,"tests":[...]}}
+ *
+ * keyed by a fingerprint of the vector set algorithm, mode and revision and
+ * of the test group without its ids. It rides on the checkpoint journal:
+ * acvp_memo_lookup() is called by acvp_journal_begin() and adds the groups
+ * it finds in the store to those the journal took out of the vector set, and
+ * acvp_journal_end() puts them back among the responses of the KAT handler.
+ * The groups that were run, because they were not in the store or were
+ * picked to be sampled, are looked at by acvp_memo_end() first: new ones
+ * are appended to the store and sampled ones are compared to it. Later lines
+ * of the store take the place of earlier ones with the same key.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define ACVP_MEMO_KEY_MAX 40
+
+ACVP_RESULT acvp_set_result_memo(ACVP_CTX *ctx, const char *memo_filename, int sample_pct) {
+    ACVP_MEMO *memo = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        ACVP_LOG_ERR("The result memo can only be set on the context of the session");
+        return ACVP_INVALID_ARG;
+    }
+    if (!memo_filename) {
+        acvp_memo_free(ctx);
+        return ACVP_SUCCESS;
+    }
+    if (strnlen_s(memo_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided memo_filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+    if (sample_pct < 0 || sample_pct > 100) {
+        ACVP_LOG_ERR("Result memo sample_pct must be from 0 to 100");
+        return ACVP_INVALID_ARG;
+    }
+
+    memo = calloc(1, sizeof(ACVP_MEMO));
+    if (!memo) {
+        return ACVP_MALLOC_FAIL;
+    }
+    memo->filename = calloc(ACVP_JSON_FILENAME_MAX + 1, sizeof(char));
+    if (!memo->filename) {
+        free(memo);
+        return ACVP_MALLOC_FAIL;
+    }
+    strcpy_s(memo->filename, ACVP_JSON_FILENAME_MAX + 1, memo_filename);
+    memo->sample_pct = sample_pct;
+    /* Different groups are sampled with every replay */
+    memo->rng = ((unsigned long long int)time(NULL) ^ acvp_metrics_now()) | 1;
+    acvp_mutex_init(&memo->lock);
+
+    acvp_memo_free(ctx);
+    ctx->memo = memo;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_get_memo_stats(ACVP_CTX *ctx, ACVP_MEMO_STATS *stats) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!stats) {
+        return ACVP_MISSING_ARG;
+    }
+    if (!ctx->memo) {
+        return ACVP_UNSUPPORTED_OP;
+    }
+    acvp_mutex_lock(&ctx->memo->lock);
+    memcpy_s(stats, sizeof(ACVP_MEMO_STATS), &ctx->memo->stats, sizeof(ACVP_MEMO_STATS));
+    acvp_mutex_unlock(&ctx->memo->lock);
+    return ACVP_SUCCESS;
+}
+
+void acvp_memo_free(ACVP_CTX *ctx) {
+    if (!ctx->memo) {
+        return;
+    }
+    if (ctx->memo->index) json_value_free(ctx->memo->index);
+    free(ctx->memo->filename);
+    acvp_mutex_destroy(&ctx->memo->lock);
+    free(ctx->memo);
+    ctx->memo = NULL;
+}
+
+/*
+ * Whether the responses of test group tg_obj of the vector set being
+ * processed depend only on the group, and so can be taken from the store
+ */
+static int acvp_memo_deterministic(ACVP_CTX *ctx, JSON_Object *tg_obj) {
+    ACVP_CAPS_LIST *cap = acvp_locate_cap_entry(ctx, ctx->exec.cipher);
+    const char *gen = NULL;
+
+    if (!cap) {
+        return 0;
+    }
+    switch (cap->cap_type) {
+    case ACVP_SYM_TYPE:
+        /* Encryptions with an IV or salt of the module's own making */
+        gen = json_object_get_string(tg_obj, "ivGen");
+        if (gen && !strncmp(gen, "internal", 9)) {
+            return 0;
+        }
+        gen = json_object_get_string(tg_obj, "saltGen");
+        if (gen && !strncmp(gen, "internal", 9)) {
+            return 0;
+        }
+        return 1;
+    case ACVP_HASH_TYPE:
+    case ACVP_HMAC_TYPE:
+    case ACVP_CMAC_TYPE:
+    case ACVP_KMAC_TYPE:
+    case ACVP_KDF135_SNMP_TYPE:
+    case ACVP_KDF135_SSH_TYPE:
+    case ACVP_KDF135_SRTP_TYPE:
+    case ACVP_KDF135_IKEV2_TYPE:
+    case ACVP_KDF135_IKEV1_TYPE:
+    case ACVP_KDF135_X942_TYPE:
+    case ACVP_KDF135_X963_TYPE:
+    case ACVP_KDF135_TPM_TYPE:
+    case ACVP_KDF108_TYPE:
+    case ACVP_PBKDF_TYPE:
+    case ACVP_KDF_TLS12_TYPE:
+    case ACVP_KDF_TLS13_TYPE:
+    case ACVP_KDA_ONESTEP_TYPE:
+    case ACVP_KDA_TWOSTEP_TYPE:
+    case ACVP_KDA_HKDF_TYPE:
+        return 1;
+    /* Random values, key pairs and signatures of the module's own making */
+    case ACVP_DRBG_TYPE:
+    case ACVP_RSA_KEYGEN_TYPE:
+    case ACVP_RSA_SIGGEN_TYPE:
+    case ACVP_RSA_SIGVER_TYPE:
+    case ACVP_RSA_PRIM_TYPE:
+    case ACVP_ECDSA_KEYGEN_TYPE:
+    case ACVP_ECDSA_KEYVER_TYPE:
+    case ACVP_ECDSA_SIGGEN_TYPE:
+    case ACVP_ECDSA_SIGVER_TYPE:
+    case ACVP_DET_ECDSA_SIGGEN_TYPE:
+    case ACVP_EDDSA_KEYGEN_TYPE:
+    case ACVP_EDDSA_KEYVER_TYPE:
+    case ACVP_EDDSA_SIGGEN_TYPE:
+    case ACVP_EDDSA_SIGVER_TYPE:
+    case ACVP_DSA_TYPE:
+    case ACVP_KAS_ECC_CDH_TYPE:
+    case ACVP_KAS_ECC_COMP_TYPE:
+    case ACVP_KAS_ECC_NOCOMP_TYPE:
+    case ACVP_KAS_ECC_SSC_TYPE:
+    case ACVP_KAS_FFC_COMP_TYPE:
+    case ACVP_KAS_FFC_SSC_TYPE:
+    case ACVP_KAS_FFC_NOCOMP_TYPE:
+    case ACVP_KAS_IFC_TYPE:
+    case ACVP_KTS_IFC_TYPE:
+    case ACVP_SAFE_PRIMES_KEYGEN_TYPE:
+    case ACVP_SAFE_PRIMES_KEYVER_TYPE:
+    case ACVP_LMS_KEYGEN_TYPE:
+    case ACVP_LMS_SIGGEN_TYPE:
+    case ACVP_LMS_SIGVER_TYPE:
+    default:
+        return 0;
+    }
+}
+
+static void acvp_memo_fp_bytes(unsigned long long *fp, size_t *n, const void *data, size_t len) {
+    unsigned char b[4];
+
+    /* Each run of bytes is preceded by its length, so runs can not be confused */
+    b[0] = len & 0xFF;
+    b[1] = (len >> 8) & 0xFF;
+    b[2] = (len >> 16) & 0xFF;
+    b[3] = (len >> 24) & 0xFF;
+    acvp_fp_bytes(fp, b, sizeof(b));
+    acvp_fp_bytes(fp, data, len);
+    *n += sizeof(b) + len;
+}
+
+static int acvp_memo_name_cmp(const void *a, const void *b) {
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+/*
+ * Takes val into the fingerprint in a canonical form: the fields of objects
+ * in name order, and without the tgId and tcId fields. Returns 1 if it ran
+ * out of memory.
+ */
+static int acvp_memo_fp_value(unsigned long long *fp, size_t *n, const JSON_Value *val) {
+    unsigned char type = (unsigned char)json_value_get_type(val);
+    const char **names = NULL;
+    JSON_Object *obj = NULL;
+    JSON_Array *arr = NULL;
+    const char *str = NULL;
+    double num = 0;
+    size_t i = 0, count = 0, kept = 0;
+    int rc = 0;
+
+    acvp_memo_fp_bytes(fp, n, &type, 1);
+    switch (json_value_get_type(val)) {
+    case JSONBoolean:
+        type = (unsigned char)json_value_get_boolean(val);
+        acvp_memo_fp_bytes(fp, n, &type, 1);
+        break;
+    case JSONNumber:
+        num = json_value_get_number(val);
+        acvp_memo_fp_bytes(fp, n, &num, sizeof(num));
+        break;
+    case JSONString:
+        str = json_value_get_string(val);
+        acvp_memo_fp_bytes(fp, n, str, json_value_get_string_len(val));
+        break;
+    case JSONArray:
+        arr = json_value_get_array(val);
+        count = json_array_get_count(arr);
+        acvp_memo_fp_bytes(fp, n, &count, sizeof(count));
+        for (i = 0; i < count && !rc; i++) {
+            rc = acvp_memo_fp_value(fp, n, json_array_get_value(arr, i));
+        }
+        break;
+    case JSONObject:
+        obj = json_value_get_object(val);
+        count = json_object_get_count(obj);
+        if (!count) {
+            break;
+        }
+        names = calloc(count, sizeof(char *));
+        if (!names) {
+            return 1;
+        }
+        for (i = 0; i < count; i++) {
+            str = json_object_get_name(obj, i);
+            if (!strncmp(str, "tgId", 5) || !strncmp(str, "tcId", 5)) {
+                continue;
+            }
+            names[kept++] = str;
+        }
+        qsort(names, kept, sizeof(char *), acvp_memo_name_cmp);
+        for (i = 0; i < kept && !rc; i++) {
+            acvp_memo_fp_bytes(fp, n, names[i], strlen(names[i]));
+            rc = acvp_memo_fp_value(fp, n, json_object_get_value(obj, names[i]));
+        }
+        free(names);
+        break;
+    case JSONNull:
+    case JSONError:
+    default:
+        break;
+    }
+    return rc;
+}
+
+/*
+ * The key of test group tg_val of vector set obj in the store
+ */
+static int acvp_memo_key(JSON_Object *obj, const JSON_Value *tg_val, char *key) {
+    static const char *fields[] = { "algorithm", "mode", "revision" };
+    unsigned long long fp = ACVP_FP_OFFSET;
+    const char *str = NULL;
+    size_t n = 0, i = 0;
+
+    for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        str = json_object_get_string(obj, fields[i]);
+        if (!str) str = "";
+        acvp_memo_fp_bytes(&fp, &n, str, strnlen_s(str, ACVP_CAPABILITY_STR_MAX));
+    }
+    if (acvp_memo_fp_value(&fp, &n, tg_val)) {
+        return 1;
+    }
+    /* The length makes a collision of the fingerprint alone harmless */
+    snprintf(key, ACVP_MEMO_KEY_MAX, "%016llx-%lx", fp, (unsigned long)n);
+    return 0;
+}
+
+/*
+ * Reads the store into the index, with the JSON arena paused as it is kept
+ * for the session. A line that can not be parsed is skipped. Called with
+ * the lock of the memo held.
+ */
+static void acvp_memo_load(ACVP_CTX *ctx, ACVP_MEMO *memo) {
+    JSON_Value *line_val = NULL, *rsp_val = NULL;
+    JSON_Object *line_obj = NULL;
+    FILE *fp = NULL;
+    char *buf = NULL, *line = NULL, *end = NULL;
+    const char *key = NULL;
+    long size = 0;
+    int count = 0;
+
+    memo->loaded = 1;
+    acvp_json_arena_pause(1);
+    memo->index = json_value_init_object();
+    if (!memo->index) {
+        goto end;
+    }
+    fp = fopen(memo->filename, "rb");
+    if (!fp) {
+        ACVP_LOG_STATUS("Starting a new result memo %s", memo->filename);
+        goto end;
+    }
+    if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET)) {
+        goto end;
+    }
+    buf = calloc((size_t)size + 1, sizeof(char));
+    if (!buf || fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        ACVP_LOG_WARN("Unable to read the result memo %s, starting over", memo->filename);
+        goto end;
+    }
+
+    for (line = buf; *line; line = end) {
+        end = strchr(line, '\n');
+        if (end) {
+            *end++ = '\0';
+        } else {
+            end = line + strnlen_s(line, RSIZE_MAX_STR);
+        }
+        line_val = json_parse_string(line);
+        line_obj = json_value_get_object(line_val);
+        key = json_object_get_string(line_obj, "key");
+        rsp_val = json_object_get_value(line_obj, "response");
+        if (key && json_value_get_object(rsp_val) &&
+                json_object_set_value(json_value_get_object(memo->index), key,
+                                      json_value_deep_copy(rsp_val)) == JSONSuccess) {
+            count++;
+        }
+        if (line_val) json_value_free(line_val);
+    }
+    ACVP_LOG_STATUS("Loaded %d test group responses from the result memo %s", count, memo->filename);
+
+end:
+    acvp_json_arena_pause(0);
+    if (buf) free(buf);
+    if (fp) fclose(fp);
+}
+
+/*
+ * Whether a group found in the store is picked to be run anyway. Called with
+ * the lock of the memo held.
+ */
+static int acvp_memo_sample(ACVP_MEMO *memo) {
+    if (memo->sample_pct >= 100) {
+        return 1;
+    }
+    if (memo->sample_pct <= 0) {
+        return 0;
+    }
+    memo->rng ^= memo->rng << 13;
+    memo->rng ^= memo->rng >> 7;
+    memo->rng ^= memo->rng << 17;
+    return (int)(memo->rng % 100) < memo->sample_pct;
+}
+
+/*
+ * Gives a copy of the stored response of a group the ids of the request:
+ * the tgId of the group and, in order, the tcId of each test. Returns 1 if
+ * the tests of the two do not line up.
+ */
+static int acvp_memo_rename(JSON_Value *rsp_val, JSON_Object *tg_obj) {
+    JSON_Object *rsp = json_value_get_object(rsp_val);
+    JSON_Array *tests = json_object_get_array(rsp, "tests");
+    JSON_Array *req = json_object_get_array(tg_obj, "tests");
+    int i = 0, count = json_array_get_count(req);
+
+    if (!rsp || !tests || (int)json_array_get_count(tests) != count) {
+        return 1;
+    }
+    json_object_set_number(rsp, "tgId", json_object_get_number(tg_obj, "tgId"));
+    for (i = 0; i < count; i++) {
+        json_object_set_number(json_array_get_object(tests, i), "tcId",
+                               json_object_get_number(json_array_get_object(req, i), "tcId"));
+    }
+    return 0;
+}
+
+/*
+ * Called by acvp_journal_begin() with the groups of vector set obj the
+ * journal already has, keyed by tgId, in *groups_val, which may be NULL.
+ * The deterministic groups found in the store are added to them, but for
+ * those picked to be sampled. The groups left to run are kept in
+ * ctx->exec.memo for acvp_memo_end(), with the keys they are stored under
+ * and, when sampled, the responses to expect. hits is the number of groups
+ * added.
+ */
+ACVP_RESULT acvp_memo_lookup(ACVP_CTX *ctx, JSON_Object *obj, JSON_Value **groups_val, int *hits) {
+    ACVP_MEMO *memo = ctx->memo;
+    JSON_Value *pending_val = NULL, *entry_val = NULL, *rsp_val = NULL;
+    JSON_Object *pending = NULL, *entry = NULL, *tg_obj = NULL;
+    JSON_Array *tg_arr = NULL;
+    char key[ACVP_MEMO_KEY_MAX], id[16];
+    int i = 0, count = 0, sample = 0;
+
+    *hits = 0;
+    if (ctx->exec.memo) json_value_free(ctx->exec.memo);
+    ctx->exec.memo = NULL;
+    if (!memo) {
+        return ACVP_SUCCESS;
+    }
+
+    tg_arr = json_object_get_array(obj, "testGroups");
+    count = json_array_get_count(tg_arr);
+    for (i = 0; i < count; i++) {
+        tg_obj = json_array_get_object(tg_arr, i);
+        snprintf(id, sizeof(id), "%d", (int)json_object_get_uint(tg_obj, "tgId"));
+        if (!json_object_get_uint(tg_obj, "tgId") ||
+                (*groups_val && json_object_has_value(json_value_get_object(*groups_val), id))) {
+            continue;
+        }
+        if (!acvp_memo_deterministic(ctx, tg_obj)) {
+            continue;
+        }
+        if (acvp_memo_key(obj, json_array_get_value(tg_arr, i), key)) {
+            goto err;
+        }
+
+        rsp_val = NULL;
+        sample = 0;
+        acvp_mutex_lock(&memo->lock);
+        if (!memo->loaded) {
+            acvp_memo_load(ctx, memo);
+        }
+        if (!memo->drifted) {
+            rsp_val = json_value_deep_copy(json_object_get_value(json_value_get_object(memo->index), key));
+        }
+        if (rsp_val && acvp_memo_rename(rsp_val, tg_obj)) {
+            json_value_free(rsp_val);
+            rsp_val = NULL;
+        }
+        if (rsp_val) {
+            memo->stats.hits++;
+            sample = acvp_memo_sample(memo);
+            if (sample) memo->stats.sampled++;
+        } else {
+            memo->stats.misses++;
+        }
+        acvp_mutex_unlock(&memo->lock);
+
+        if (rsp_val && !sample) {
+            if (!*groups_val) {
+                *groups_val = json_value_init_object();
+            }
+            if (!*groups_val ||
+                    json_object_set_value(json_value_get_object(*groups_val), id, rsp_val) != JSONSuccess) {
+                json_value_free(rsp_val);
+                goto err;
+            }
+            (*hits)++;
+            continue;
+        }
+
+        if (!pending_val) {
+            pending_val = json_value_init_object();
+            pending = json_value_get_object(pending_val);
+        }
+        entry_val = json_value_init_object();
+        entry = json_value_get_object(entry_val);
+        if (!pending || !entry || json_object_set_string(entry, "key", key) != JSONSuccess ||
+                (rsp_val && json_object_set_value(entry, "response", rsp_val) != JSONSuccess)) {
+            if (entry_val) json_value_free(entry_val);
+            if (rsp_val) json_value_free(rsp_val);
+            goto err;
+        }
+        if (json_object_set_value(pending, id, entry_val) != JSONSuccess) {
+            json_value_free(entry_val);
+            goto err;
+        }
+    }
+
+    if (*hits) {
+        ACVP_LOG_STATUS("Took %d of the %d test groups of vector set %d from the result memo",
+                        *hits, count, ctx->exec.vs_id);
+    }
+    ctx->exec.memo = pending_val;
+    return ACVP_SUCCESS;
+
+err:
+    ACVP_LOG_ERR("Unable to look up vector set %d in the result memo", ctx->exec.vs_id);
+    if (pending_val) json_value_free(pending_val);
+    return ACVP_MALLOC_FAIL;
+}
+
+/*
+ * Adds the response of a group that was run to the index, under key, and
+ * writes it to the store fp. Called with the lock of the memo held.
+ */
+static void acvp_memo_store(ACVP_CTX *ctx, ACVP_MEMO *memo, FILE *fp, const char *key, const JSON_Value *group) {
+    JSON_Value *copy = NULL;
+    char *str = NULL;
+
+    acvp_json_arena_pause(1);
+    copy = json_value_deep_copy(group);
+    acvp_json_arena_pause(0);
+    if (!copy || json_object_set_value(json_value_get_object(memo->index), key, copy) != JSONSuccess) {
+        if (copy) json_value_free(copy);
+        ACVP_LOG_WARN("Unable to add test group to the result memo");
+        return;
+    }
+    memo->stats.stored++;
+
+    str = json_serialize_to_string(group, NULL);
+    if (!fp || !str || fprintf(fp, "{\"key\":\"%s\",\"response\":%s}\n", key, str) < 0) {
+        ACVP_LOG_WARN("Unable to write test group to the result memo %s", memo->filename);
+    }
+    if (str) json_free_serialized_string(str);
+}
+
+/*
+ * Called by acvp_journal_end() once the KAT handler returns rv, before the
+ * groups from the journal and the store are merged back in, so the
+ * responses are those of the groups that were run. They are compared to the
+ * store if sampled, and are put in the store if they are not, or did not
+ * match.
+ */
+void acvp_memo_end(ACVP_CTX *ctx, ACVP_RESULT rv) {
+    ACVP_MEMO *memo = ctx->memo;
+    JSON_Object *pending = NULL, *entry = NULL, *r_vs = NULL;
+    JSON_Array *done = NULL;
+    JSON_Value *group = NULL, *expect = NULL;
+    FILE *fp = NULL;
+    char id[16];
+    int i = 0, count = 0;
+
+    if (!ctx->exec.memo) {
+        return;
+    }
+    if (rv != ACVP_SUCCESS || !memo) {
+        goto end;
+    }
+
+    pending = json_value_get_object(ctx->exec.memo);
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    done = json_object_get_array(r_vs, "testGroups");
+    count = json_array_get_count(done);
+
+    acvp_mutex_lock(&memo->lock);
+    for (i = 0; i < count; i++) {
+        group = json_array_get_value(done, i);
+        snprintf(id, sizeof(id), "%d", (int)json_object_get_uint(json_value_get_object(group), "tgId"));
+        entry = json_object_get_object(pending, id);
+        if (!entry) {
+            continue;
+        }
+        expect = json_object_get_value(entry, "response");
+        if (expect && json_value_equals(expect, group)) {
+            continue;
+        }
+        if (expect) {
+            ACVP_LOG_ERR("Result drift in test group %s of vector set %d: the responses do not match the "
+                         "result memo, responses no longer taken from it", id, ctx->exec.vs_id);
+            memo->stats.drifted++;
+            memo->drifted = 1;
+        }
+        if (!fp) {
+            fp = fopen(memo->filename, "a+");
+            if (fp && !fseek(fp, -1, SEEK_END) && fgetc(fp) != '\n' && !fseek(fp, 0, SEEK_END)) {
+                /* Ends a line cut short by a crash, so it is not part of the next */
+                fputc('\n', fp);
+            }
+        }
+        acvp_memo_store(ctx, memo, fp, json_object_get_string(entry, "key"), group);
+    }
+    if (fp && fclose(fp) == EOF) {
+        ACVP_LOG_WARN("Unable to write the result memo %s", memo->filename);
+    }
+    acvp_mutex_unlock(&memo->lock);
+
+end:
+    json_value_free(ctx->exec.memo);
+    ctx->exec.memo = NULL;
+}
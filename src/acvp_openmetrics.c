@@ -0,0 +1,432 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * The OpenMetrics exporter, see acvp_openmetrics_create(). One exporter may
+ * be shared by any number of sessions, and the contexts of each session may
+ * be working on several vector sets at once, so the counters are kept under
+ * a lock. The crypto handler timings are the exception: there is one per
+ * test case, so they are gathered on the exec context and added a test group
+ * at a time (acvp_om_flush()), rather than taking the lock for each call.
+ *
+ * Nothing here is done for a session that has no exporter set.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+/* Upper bounds of the crypto handler latency buckets, the last one is +Inf */
+static const unsigned long long int acvp_om_crypto_le_ns[ACVP_OM_CRYPTO_BUCKETS - 1] = {
+    10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL
+};
+static const char *acvp_om_crypto_le[ACVP_OM_CRYPTO_BUCKETS] = {
+    "1e-05", "0.0001", "0.001", "0.01", "0.1", "1.0", "10.0", "+Inf"
+};
+
+/* Upper bounds of the HTTP request latency buckets, the last one is +Inf */
+#define ACVP_OM_HTTP_BUCKETS 10
+static const unsigned long long int acvp_om_http_le_ns[ACVP_OM_HTTP_BUCKETS - 1] = {
+    50000000ULL, 100000000ULL, 250000000ULL, 500000000ULL, 1000000000ULL,
+    2500000000ULL, 5000000000ULL, 10000000000ULL, 30000000000ULL
+};
+static const char *acvp_om_http_le[ACVP_OM_HTTP_BUCKETS] = {
+    "0.05", "0.1", "0.25", "0.5", "1.0", "2.5", "5.0", "10.0", "30.0", "+Inf"
+};
+
+static const char *acvp_om_method_name[ACVP_OM_METHOD_MAX] = {
+    "GET", "POST", "PUT", "DELETE"
+};
+
+typedef struct acvp_om_counts_t {
+    unsigned long long int vs_success;
+    unsigned long long int vs_failure;
+    unsigned long long int cases[ACVP_CIPHER_END];
+    unsigned long long int cases_ns[ACVP_CIPHER_END];
+    ACVP_OM_CRYPTO crypto;       /* All algorithms together */
+    unsigned long long int retry_waits;
+    unsigned long long int retry_wait_seconds;
+    unsigned long long int http_requests[ACVP_OM_METHOD_MAX];
+    unsigned long long int http_errors[ACVP_OM_METHOD_MAX];
+    unsigned long long int http_bytes_in[ACVP_OM_METHOD_MAX];
+    unsigned long long int http_bytes_out[ACVP_OM_METHOD_MAX];
+    unsigned long long int http_ns;
+    unsigned long long int http_bucket[ACVP_OM_HTTP_BUCKETS];
+    unsigned long long int jwt_refresh_success;
+    unsigned long long int jwt_refresh_failure;
+} ACVP_OM_COUNTS;
+
+struct acvp_openmetrics_t {
+    ACVP_MUTEX lock;
+    ACVP_OM_COUNTS counts;
+};
+
+/* Text not yet handed to the writer of acvp_openmetrics_write() */
+typedef struct acvp_om_out_t {
+    char buf[2048];
+    size_t len;
+    int (*writer)(const char *buf, size_t len, void *arg);
+    void *arg;
+    int failed;
+} ACVP_OM_OUT;
+
+ACVP_RESULT acvp_openmetrics_create(ACVP_OPENMETRICS **om) {
+    ACVP_OPENMETRICS *new_om = NULL;
+
+    if (!om) {
+        return ACVP_INVALID_ARG;
+    }
+    new_om = calloc(1, sizeof(ACVP_OPENMETRICS));
+    if (!new_om) {
+        return ACVP_MALLOC_FAIL;
+    }
+    acvp_mutex_init(&new_om->lock);
+    *om = new_om;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_openmetrics_free(ACVP_OPENMETRICS *om) {
+    if (!om) {
+        return ACVP_INVALID_ARG;
+    }
+    acvp_mutex_destroy(&om->lock);
+    free(om);
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_openmetrics(ACVP_CTX *ctx, ACVP_OPENMETRICS *om) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    ctx->openmetrics = om;
+    return ACVP_SUCCESS;
+}
+
+static int acvp_om_bucket(const unsigned long long int *le_ns, int cnt, unsigned long long int ns) {
+    int i = 0;
+
+    for (i = 0; i < cnt - 1; i++) {
+        if (ns <= le_ns[i]) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+ * Notes that calls test cases took ns in the crypto module. A batch is timed
+ * as a whole, so each of its test cases is put in the bucket of the average.
+ */
+void acvp_om_crypto(ACVP_CTX *ctx, unsigned long long int ns, unsigned int calls) {
+    ACVP_OM_CRYPTO *crypto = &ctx->exec.om_crypto;
+
+    if (!calls) {
+        return;
+    }
+    crypto->cases += calls;
+    crypto->ns += ns;
+    crypto->bucket[acvp_om_bucket(acvp_om_crypto_le_ns, ACVP_OM_CRYPTO_BUCKETS, ns / calls)] += calls;
+}
+
+/*
+ * Adds the crypto handler timings gathered on ctx to the exporter, against
+ * the algorithm of the vector set in progress.
+ */
+void acvp_om_flush(ACVP_CTX *ctx) {
+    ACVP_OPENMETRICS *om = ctx->openmetrics;
+    ACVP_OM_CRYPTO *crypto = &ctx->exec.om_crypto;
+    ACVP_CIPHER cipher = ctx->exec.cipher;
+    int i = 0;
+
+    if (!om || !crypto->cases) {
+        return;
+    }
+    if (cipher <= ACVP_CIPHER_START || cipher >= ACVP_CIPHER_END) {
+        cipher = ACVP_CIPHER_START;
+    }
+    acvp_mutex_lock(&om->lock);
+    om->counts.cases[cipher] += crypto->cases;
+    om->counts.cases_ns[cipher] += crypto->ns;
+    om->counts.crypto.cases += crypto->cases;
+    om->counts.crypto.ns += crypto->ns;
+    for (i = 0; i < ACVP_OM_CRYPTO_BUCKETS; i++) {
+        om->counts.crypto.bucket[i] += crypto->bucket[i];
+    }
+    acvp_mutex_unlock(&om->lock);
+    memzero_s(crypto, sizeof(ACVP_OM_CRYPTO));
+}
+
+void acvp_om_vs_done(ACVP_CTX *ctx, ACVP_RESULT rv) {
+    ACVP_OPENMETRICS *om = ctx->openmetrics;
+
+    if (!om) {
+        return;
+    }
+    acvp_om_flush(ctx);
+    acvp_mutex_lock(&om->lock);
+    if (rv == ACVP_SUCCESS) {
+        om->counts.vs_success++;
+    } else {
+        om->counts.vs_failure++;
+    }
+    acvp_mutex_unlock(&om->lock);
+}
+
+void acvp_om_retry_wait(ACVP_CTX *ctx, int seconds) {
+    ACVP_OPENMETRICS *om = ctx->openmetrics;
+
+    if (!om) {
+        return;
+    }
+    acvp_mutex_lock(&om->lock);
+    om->counts.retry_waits++;
+    om->counts.retry_wait_seconds += seconds > 0 ? (unsigned long long int)seconds : 0;
+    acvp_mutex_unlock(&om->lock);
+}
+
+/*
+ * Notes a request to the server. One that got no response, or a response
+ * other than 2xx, also counts as an error.
+ */
+void acvp_om_transfer(ACVP_CTX *ctx, ACVP_OM_METHOD method, int http_status,
+                      size_t bytes_in, size_t bytes_out, unsigned long long int ns) {
+    ACVP_OPENMETRICS *om = ctx->openmetrics;
+
+    if (!om || method < 0 || method >= ACVP_OM_METHOD_MAX) {
+        return;
+    }
+    acvp_mutex_lock(&om->lock);
+    om->counts.http_requests[method]++;
+    if (http_status < 200 || http_status >= 300) {
+        om->counts.http_errors[method]++;
+    }
+    om->counts.http_bytes_in[method] += bytes_in;
+    om->counts.http_bytes_out[method] += bytes_out;
+    om->counts.http_ns += ns;
+    om->counts.http_bucket[acvp_om_bucket(acvp_om_http_le_ns, ACVP_OM_HTTP_BUCKETS, ns)]++;
+    acvp_mutex_unlock(&om->lock);
+}
+
+void acvp_om_jwt_refresh(ACVP_CTX *ctx, ACVP_RESULT rv) {
+    ACVP_OPENMETRICS *om = ctx->openmetrics;
+
+    if (!om) {
+        return;
+    }
+    acvp_mutex_lock(&om->lock);
+    if (rv == ACVP_SUCCESS) {
+        om->counts.jwt_refresh_success++;
+    } else {
+        om->counts.jwt_refresh_failure++;
+    }
+    acvp_mutex_unlock(&om->lock);
+}
+
+static void acvp_om_out_flush(ACVP_OM_OUT *out) {
+    if (!out->failed && out->len && (out->writer)(out->buf, out->len, out->arg)) {
+        out->failed = 1;
+    }
+    out->len = 0;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+static void acvp_om_printf(ACVP_OM_OUT *out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+#endif
+
+static void acvp_om_printf(ACVP_OM_OUT *out, const char *fmt, ...) {
+    va_list ap;
+    int len = 0;
+
+    if (out->failed) {
+        return;
+    }
+    va_start(ap, fmt);
+    len = vsnprintf(out->buf + out->len, sizeof(out->buf) - out->len, fmt, ap);
+    va_end(ap);
+    if (len < 0) {
+        out->failed = 1;
+        return;
+    }
+    if ((size_t)len >= sizeof(out->buf) - out->len) {
+        /* Did not fit behind what is there, the lines are all far shorter than buf */
+        acvp_om_out_flush(out);
+        va_start(ap, fmt);
+        len = vsnprintf(out->buf, sizeof(out->buf), fmt, ap);
+        va_end(ap);
+        if (len < 0 || (size_t)len >= sizeof(out->buf)) {
+            out->failed = 1;
+            return;
+        }
+    }
+    out->len += len;
+}
+
+static void acvp_om_family(ACVP_OM_OUT *out, const char *name, const char *type, const char *unit,
+                           const char *help) {
+    acvp_om_printf(out, "# TYPE %s %s\n", name, type);
+    if (unit) {
+        acvp_om_printf(out, "# UNIT %s %s\n", name, unit);
+    }
+    acvp_om_printf(out, "# HELP %s %s\n", name, help);
+}
+
+static void acvp_om_seconds(ACVP_OM_OUT *out, const char *sample, const char *labels,
+                            unsigned long long int ns) {
+    acvp_om_printf(out, "%s%s %llu.%09llu\n", sample, labels, ns / 1000000000ULL, ns % 1000000000ULL);
+}
+
+static void acvp_om_histogram(ACVP_OM_OUT *out, const char *name, const char **le,
+                              const unsigned long long int *bucket, int cnt,
+                              unsigned long long int total, unsigned long long int ns) {
+    unsigned long long int sum = 0;
+    int i = 0;
+
+    for (i = 0; i < cnt; i++) {
+        sum += bucket[i];
+        acvp_om_printf(out, "%s_bucket{le=\"%s\"} %llu\n", name, le[i], sum);
+    }
+    acvp_om_printf(out, "%s_count %llu\n", name, total);
+    acvp_om_printf(out, "%s_sum %llu.%09llu\n", name, ns / 1000000000ULL, ns % 1000000000ULL);
+}
+
+/* The labels of the test case counters of an algorithm */
+static void acvp_om_cipher_labels(ACVP_CIPHER cipher, char *labels, size_t max) {
+    const char *name = NULL, *mode = NULL;
+
+    if (cipher == ACVP_CIPHER_START) {
+        snprintf(labels, max, "{algorithm=\"unknown\"}");
+        return;
+    }
+    name = acvp_lookup_cipher_name(cipher);
+    mode = acvp_lookup_cipher_mode_str(cipher);
+    if (mode) {
+        snprintf(labels, max, "{algorithm=\"%s\",mode=\"%s\"}", name ? name : "unknown", mode);
+    } else {
+        snprintf(labels, max, "{algorithm=\"%s\"}", name ? name : "unknown");
+    }
+}
+
+static void acvp_om_write_counts(ACVP_OM_OUT *out, const ACVP_OM_COUNTS *c) {
+    char labels[128];
+    unsigned long long int requests = 0;
+    int i = 0;
+
+    acvp_om_family(out, "acvp_vector_sets", "counter", NULL,
+                   "Vector sets processed, and submitted or written to file.");
+    acvp_om_printf(out, "acvp_vector_sets_total{result=\"success\"} %llu\n", c->vs_success);
+    acvp_om_printf(out, "acvp_vector_sets_total{result=\"failure\"} %llu\n", c->vs_failure);
+
+    acvp_om_family(out, "acvp_test_cases", "counter", NULL,
+                   "Test cases handed to the crypto module.");
+    for (i = ACVP_CIPHER_START; i < ACVP_CIPHER_END; i++) {
+        if (!c->cases[i]) {
+            continue;
+        }
+        acvp_om_cipher_labels((ACVP_CIPHER)i, labels, sizeof(labels));
+        acvp_om_printf(out, "acvp_test_cases_total%s %llu\n", labels, c->cases[i]);
+    }
+    acvp_om_family(out, "acvp_test_case_seconds", "counter", "seconds",
+                   "Time spent in the crypto module on test cases.");
+    for (i = ACVP_CIPHER_START; i < ACVP_CIPHER_END; i++) {
+        if (!c->cases[i]) {
+            continue;
+        }
+        acvp_om_cipher_labels((ACVP_CIPHER)i, labels, sizeof(labels));
+        acvp_om_seconds(out, "acvp_test_case_seconds_total", labels, c->cases_ns[i]);
+    }
+
+    acvp_om_family(out, "acvp_crypto_handler_seconds", "histogram", "seconds",
+                   "Time taken by the crypto handler for a test case.");
+    acvp_om_histogram(out, "acvp_crypto_handler_seconds", acvp_om_crypto_le, c->crypto.bucket,
+                      ACVP_OM_CRYPTO_BUCKETS, c->crypto.cases, c->crypto.ns);
+
+    acvp_om_family(out, "acvp_retry_waits", "counter", NULL,
+                   "Times the server asked for a wait before asking again.");
+    acvp_om_printf(out, "acvp_retry_waits_total %llu\n", c->retry_waits);
+    acvp_om_family(out, "acvp_retry_wait_seconds", "counter", "seconds",
+                   "Seconds of waiting the server asked for.");
+    acvp_om_printf(out, "acvp_retry_wait_seconds_total %llu\n", c->retry_wait_seconds);
+
+    acvp_om_family(out, "acvp_http_requests", "counter", NULL, "Requests made to the server.");
+    for (i = 0; i < ACVP_OM_METHOD_MAX; i++) {
+        acvp_om_printf(out, "acvp_http_requests_total{method=\"%s\"} %llu\n",
+                       acvp_om_method_name[i], c->http_requests[i]);
+    }
+    acvp_om_family(out, "acvp_http_errors", "counter", NULL,
+                   "Requests that got no response, or a response other than 2xx.");
+    for (i = 0; i < ACVP_OM_METHOD_MAX; i++) {
+        acvp_om_printf(out, "acvp_http_errors_total{method=\"%s\"} %llu\n",
+                       acvp_om_method_name[i], c->http_errors[i]);
+    }
+    acvp_om_family(out, "acvp_http_received_bytes", "counter", "bytes",
+                   "Bytes received from the server.");
+    for (i = 0; i < ACVP_OM_METHOD_MAX; i++) {
+        acvp_om_printf(out, "acvp_http_received_bytes_total{method=\"%s\"} %llu\n",
+                       acvp_om_method_name[i], c->http_bytes_in[i]);
+    }
+    acvp_om_family(out, "acvp_http_sent_bytes", "counter", "bytes", "Bytes sent to the server.");
+    for (i = 0; i < ACVP_OM_METHOD_MAX; i++) {
+        acvp_om_printf(out, "acvp_http_sent_bytes_total{method=\"%s\"} %llu\n",
+                       acvp_om_method_name[i], c->http_bytes_out[i]);
+    }
+    acvp_om_family(out, "acvp_http_request_seconds", "histogram", "seconds",
+                   "Time taken by a request to the server.");
+    for (i = 0; i < ACVP_OM_METHOD_MAX; i++) {
+        requests += c->http_requests[i];
+    }
+    acvp_om_histogram(out, "acvp_http_request_seconds", acvp_om_http_le, c->http_bucket,
+                      ACVP_OM_HTTP_BUCKETS, requests, c->http_ns);
+
+    acvp_om_family(out, "acvp_jwt_refreshes", "counter", NULL, "Logins made to refresh the JWT.");
+    acvp_om_printf(out, "acvp_jwt_refreshes_total{result=\"success\"} %llu\n", c->jwt_refresh_success);
+    acvp_om_printf(out, "acvp_jwt_refreshes_total{result=\"failure\"} %llu\n", c->jwt_refresh_failure);
+
+    acvp_om_printf(out, "# EOF\n");
+}
+
+ACVP_RESULT acvp_openmetrics_write(ACVP_OPENMETRICS *om,
+                                   int (*writer)(const char *buf, size_t len, void *arg),
+                                   void *arg) {
+    ACVP_OM_COUNTS *counts = NULL;
+    ACVP_OM_OUT *out = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!om || !writer) {
+        return ACVP_INVALID_ARG;
+    }
+    counts = calloc(1, sizeof(ACVP_OM_COUNTS));
+    out = calloc(1, sizeof(ACVP_OM_OUT));
+    if (!counts || !out) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+
+    /* Formatted from a copy, so that the sessions are not kept waiting on the writer */
+    acvp_mutex_lock(&om->lock);
+    memcpy_s(counts, sizeof(ACVP_OM_COUNTS), &om->counts, sizeof(ACVP_OM_COUNTS));
+    acvp_mutex_unlock(&om->lock);
+
+    out->writer = writer;
+    out->arg = arg;
+    acvp_om_write_counts(out, counts);
+    acvp_om_out_flush(out);
+    if (out->failed) {
+        rv = ACVP_TRANSPORT_FAIL;
+    }
+end:
+    if (counts) free(counts);
+    if (out) free(out);
+    return rv;
+}
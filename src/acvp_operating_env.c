@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include "acvp.h"
 #include "acvp_lcl.h"
@@ -603,6 +604,497 @@ ACVP_RESULT acvp_oe_module_set_type_version_desc(ACVP_CTX *ctx,
     return ACVP_SUCCESS;
 }
 
+/*
+ * Validation metadata cache, see acvp_set_metadata_cache_file()
+ *
+ * Maps a fingerprint of a Dependency, OE, Vendor or Module, together with
+ * the server it was looked up on, to the URLs that searching the server DB
+ * found for it. The first URL is that of the object itself; a Vendor also
+ * has those of its address and of each of its contacts. The cache is kept
+ * in meta_cache of the session context while the metadata is verified:
+ *   {"version": 1, "entries": [{"key": "<hex>", "saved": <time>, "urls": [...]}]}
+ */
+#define ACVP_META_CACHE_VERSION 1
+#define ACVP_META_CACHE_KEY_LEN 16
+#define ACVP_META_CACHE_URLS_MAX (2 + LIBACVP_PERSONS_MAX)
+
+static void meta_fp_str(unsigned long long int *fp, const char *str) {
+    unsigned char present = str ? 1 : 0;
+    unsigned int len = 0;
+
+    acvp_fp_bytes(fp, &present, 1);
+    if (str) {
+        len = (unsigned int)strnlen_s(str, ACVP_ATTR_URL_MAX + 1);
+        acvp_fp_bytes(fp, &len, sizeof(len));
+        acvp_fp_bytes(fp, str, len);
+    }
+}
+
+static void meta_fp_count(unsigned long long int *fp, unsigned int count) {
+    acvp_fp_bytes(fp, &count, sizeof(count));
+}
+
+/* Every key covers the server and the kind of object */
+static unsigned long long int meta_fp_start(ACVP_CTX *ctx, const char *kind) {
+    unsigned long long int fp = ACVP_FP_OFFSET;
+
+    meta_fp_str(&fp, ctx->server_name);
+    meta_fp_count(&fp, (unsigned int)ctx->server_port);
+    meta_fp_str(&fp, ctx->path_segment);
+    meta_fp_str(&fp, kind);
+    return fp;
+}
+
+static void meta_fp_emails(unsigned long long int *fp, const ACVP_STRING_LIST *emails) {
+    const ACVP_STRING_LIST *email = NULL;
+    unsigned int count = 0;
+
+    for (email = emails; email; email = email->next) count++;
+    meta_fp_count(fp, count);
+    for (email = emails; email; email = email->next) {
+        meta_fp_str(fp, email->string);
+    }
+}
+
+static void meta_fp_phones(unsigned long long int *fp, const ACVP_OE_PHONE_LIST *phones) {
+    const ACVP_OE_PHONE_LIST *phone = NULL;
+    unsigned int count = 0;
+
+    for (phone = phones; phone; phone = phone->next) count++;
+    meta_fp_count(fp, count);
+    for (phone = phones; phone; phone = phone->next) {
+        meta_fp_str(fp, phone->number);
+        meta_fp_str(fp, phone->type);
+    }
+}
+
+/* The fields compare_dependencies() matches on */
+static unsigned long long int meta_key_dependency(ACVP_CTX *ctx, const ACVP_DEPENDENCY *dep) {
+    unsigned long long int fp = meta_fp_start(ctx, "dependency");
+
+    meta_fp_str(&fp, dep->name);
+    meta_fp_str(&fp, dep->type);
+    meta_fp_str(&fp, dep->description);
+    meta_fp_str(&fp, dep->series);
+    meta_fp_str(&fp, dep->family);
+    meta_fp_str(&fp, dep->version);
+    meta_fp_str(&fp, dep->manufacturer);
+    return fp;
+}
+
+/* The name and the URLs of the linked Dependencies, as match_oes_page() */
+static unsigned long long int meta_key_oe(ACVP_CTX *ctx, const ACVP_OE *oe) {
+    unsigned long long int fp = meta_fp_start(ctx, "oe");
+    unsigned int i = 0;
+
+    meta_fp_str(&fp, oe->name);
+    meta_fp_count(&fp, oe->dependencies.count);
+    for (i = 0; i < oe->dependencies.count; i++) {
+        meta_fp_str(&fp, oe->dependencies.deps[i]->url);
+    }
+    return fp;
+}
+
+/* The vendor fields, address and contacts match_vendors_page() matches on */
+static unsigned long long int meta_key_vendor(ACVP_CTX *ctx, const ACVP_VENDOR *vendor) {
+    unsigned long long int fp = meta_fp_start(ctx, "vendor");
+    const ACVP_VENDOR_ADDRESS *address = &vendor->address;
+    int i = 0;
+
+    meta_fp_str(&fp, vendor->name);
+    meta_fp_str(&fp, vendor->website);
+    meta_fp_emails(&fp, vendor->emails);
+    meta_fp_phones(&fp, vendor->phone_numbers);
+    meta_fp_str(&fp, address->street_1);
+    meta_fp_str(&fp, address->street_2);
+    meta_fp_str(&fp, address->street_3);
+    meta_fp_str(&fp, address->locality);
+    meta_fp_str(&fp, address->region);
+    meta_fp_str(&fp, address->country);
+    meta_fp_str(&fp, address->postal_code);
+    meta_fp_count(&fp, (unsigned int)vendor->persons.count);
+    for (i = 0; i < vendor->persons.count; i++) {
+        meta_fp_str(&fp, vendor->persons.person[i].full_name);
+        meta_fp_emails(&fp, vendor->persons.person[i].emails);
+        meta_fp_phones(&fp, vendor->persons.person[i].phone_numbers);
+    }
+    return fp;
+}
+
+/* The fields compare_modules() matches on */
+static unsigned long long int meta_key_module(ACVP_CTX *ctx, const ACVP_MODULE *module) {
+    unsigned long long int fp = meta_fp_start(ctx, "module");
+    int i = 0;
+
+    meta_fp_str(&fp, module->name);
+    meta_fp_str(&fp, module->type);
+    meta_fp_str(&fp, module->version);
+    meta_fp_str(&fp, module->description);
+    meta_fp_str(&fp, module->vendor->url);
+    meta_fp_str(&fp, module->vendor->address.url);
+    meta_fp_count(&fp, (unsigned int)module->vendor->persons.count);
+    for (i = 0; i < module->vendor->persons.count; i++) {
+        meta_fp_str(&fp, module->vendor->persons.person[i].url);
+    }
+    return fp;
+}
+
+static int meta_cache_expired(ACVP_CTX *session, JSON_Object *entry, time_t now) {
+    double saved = json_object_get_number(entry, "saved");
+
+    return saved <= 0 || saved > (double)now || (double)now - saved >= (double)session->meta_cache_ttl;
+}
+
+/* The index of the entry with the key, or -1 */
+static int meta_cache_find(JSON_Array *entries, const char *key) {
+    const char *entry_key = NULL;
+    int i = 0, count = (int)json_array_get_count(entries), diff = 0;
+
+    for (i = 0; i < count; i++) {
+        entry_key = json_object_get_string(json_array_get_object(entries, i), "key");
+        if (!entry_key) {
+            continue;
+        }
+        strcmp_s(entry_key, ACVP_META_CACHE_KEY_LEN + 1, key, &diff);
+        if (!diff) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Copies the count URLs of saved into found. Returns 1 if it did, and 0,
+ * with nothing left in found, if one is missing or too long.
+ */
+static int meta_urls_copy(JSON_Array *saved, char *found[], int count) {
+    const char *url = NULL;
+    int i = 0;
+
+    if (!saved || (int)json_array_get_count(saved) != count) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        url = json_array_get_string(saved, i);
+        if (!url || strnlen_s(url, ACVP_ATTR_URL_MAX + 1) > ACVP_ATTR_URL_MAX) {
+            break;
+        }
+        found[i] = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
+        if (!found[i]) {
+            break;
+        }
+        strcpy_s(found[i], ACVP_ATTR_URL_MAX + 1, url);
+    }
+    if (i == count) {
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        if (found[i]) free(found[i]);
+        found[i] = NULL;
+    }
+    return 0;
+}
+
+ACVP_META_SHARE *acvp_meta_share_new(void) {
+    ACVP_META_SHARE *share = calloc(1, sizeof(ACVP_META_SHARE));
+
+    if (!share) {
+        return NULL;
+    }
+    share->entries = json_value_init_array();
+    if (!share->entries) {
+        free(share);
+        return NULL;
+    }
+    acvp_mutex_init(&share->lock);
+    acvp_cond_init(&share->cond);
+    return share;
+}
+
+void acvp_meta_share_free(ACVP_META_SHARE *share) {
+    if (!share) {
+        return;
+    }
+    json_value_free(share->entries);
+    acvp_cond_destroy(&share->cond);
+    acvp_mutex_destroy(&share->lock);
+    free(share);
+}
+
+/*
+ * Looks the key up in the lookups shared with the other sessions, waiting
+ * while another session has it pending. Returns 1 with the URLs in found,
+ * -1 if the other session did not find it, and 0 if it is this session's
+ * to look up; the entry is then pending until meta_share_done().
+ */
+static int meta_share_get(ACVP_META_SHARE *share, const char *key, char *found[], int count) {
+    JSON_Array *entries = json_value_get_array(share->entries);
+    JSON_Object *entry = NULL;
+    JSON_Value *val = NULL;
+    int idx = 0, rv = 0;
+
+    acvp_mutex_lock(&share->lock);
+    while ((idx = meta_cache_find(entries, key)) >= 0) {
+        entry = json_array_get_object(entries, idx);
+        if (json_object_get_boolean(entry, "pending") != 1) {
+            break;
+        }
+        acvp_cond_wait(&share->cond, &share->lock);
+    }
+    if (idx >= 0 && json_object_get_boolean(entry, "retry") == 1) {
+        /* The session that had it could not search the server DB */
+        json_object_remove(entry, "retry");
+        json_object_set_boolean(entry, "pending", 1);
+    } else if (idx >= 0) {
+        if (json_object_has_value(entry, "urls")) {
+            rv = meta_urls_copy(json_object_get_array(entry, "urls"), found, count);
+        } else {
+            rv = -1;
+        }
+    } else {
+        val = json_value_init_object();
+        entry = json_value_get_object(val);
+        if (entry && json_object_set_string(entry, "key", key) == JSONSuccess &&
+                json_object_set_boolean(entry, "pending", 1) == JSONSuccess &&
+                json_array_append_value(entries, val) == JSONSuccess) {
+            val = NULL;
+        }
+        if (val) json_value_free(val);
+    }
+    acvp_mutex_unlock(&share->lock);
+    return rv;
+}
+
+/*
+ * Ends the lookup meta_share_get() left pending, if the URLs were not
+ * shared with meta_cache_put(). A search of the server DB that worked but
+ * did not find a match is kept, so the other sessions do not search again;
+ * one that failed is marked for the next session to try again.
+ */
+static void meta_share_done(ACVP_CTX *ctx, unsigned long long int fp, ACVP_RESULT rv) {
+    ACVP_CTX *session = ctx->session ? ctx->session : ctx;
+    ACVP_META_SHARE *share = session->meta_share;
+    char key[ACVP_META_CACHE_KEY_LEN + 1];
+    JSON_Array *entries = NULL;
+    JSON_Object *entry = NULL;
+    int idx = 0;
+
+    if (!share) {
+        return;
+    }
+    snprintf(key, sizeof(key), "%016llx", fp);
+
+    acvp_mutex_lock(&share->lock);
+    entries = json_value_get_array(share->entries);
+    idx = meta_cache_find(entries, key);
+    if (idx >= 0) {
+        entry = json_array_get_object(entries, idx);
+    }
+    if (entry && json_object_get_boolean(entry, "pending") == 1) {
+        json_object_remove(entry, "pending");
+        if (rv != ACVP_SUCCESS) {
+            json_object_set_boolean(entry, "retry", 1);
+        }
+        acvp_cond_broadcast(&share->cond);
+    }
+    acvp_mutex_unlock(&share->lock);
+}
+
+/*
+ * Sets the count URLs from the cache entry of the fingerprint, if there is
+ * one that holds as many and has not expired, or else from the lookups of
+ * the other sessions of an orchestrator.
+ * Returns 1 if it did, or if another session searched the server DB for
+ * the same and found nothing, and 0 if the server DB needs to be searched.
+ */
+static int meta_cache_get(ACVP_CTX *ctx, unsigned long long int fp, char **urls[], int count) {
+    ACVP_CTX *session = ctx->session ? ctx->session : ctx;
+    char key[ACVP_META_CACHE_KEY_LEN + 1];
+    char *found[ACVP_META_CACHE_URLS_MAX];
+    JSON_Object *entry = NULL;
+    int i = 0, idx = 0, hit = 0;
+
+    if ((!session->meta_cache && !session->meta_share) || count > ACVP_META_CACHE_URLS_MAX) {
+        return 0;
+    }
+    snprintf(key, sizeof(key), "%016llx", fp);
+    memzero_s(found, sizeof(found));
+
+    if (session->meta_cache) {
+        acvp_mutex_lock(&session->meta_cache_lock);
+        idx = meta_cache_find(json_object_get_array(json_value_get_object(session->meta_cache), "entries"), key);
+        if (idx >= 0) {
+            entry = json_array_get_object(json_object_get_array(json_value_get_object(session->meta_cache),
+                                                                "entries"), idx);
+            if (!meta_cache_expired(session, entry, time(NULL))) {
+                hit = meta_urls_copy(json_object_get_array(entry, "urls"), found, count);
+            }
+        }
+        acvp_mutex_unlock(&session->meta_cache_lock);
+    }
+    if (!hit && session->meta_share) {
+        hit = meta_share_get(session->meta_share, key, found, count);
+        if (hit < 0) {
+            ACVP_LOG_INFO("Another session found no matching entry, not searching again");
+            return 1;
+        }
+    }
+    if (!hit) {
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (*urls[i]) free(*urls[i]);
+        *urls[i] = found[i];
+    }
+    ACVP_LOG_INFO("Found a cached entry! Url: %s", *urls[0]);
+    return 1;
+}
+
+/*
+ * Saves the URLs the server DB search found under the fingerprint, replacing
+ * any entry there was, and shares them with the other sessions of an
+ * orchestrator. Nothing is saved unless all of them were found.
+ */
+static void meta_cache_put(ACVP_CTX *ctx, unsigned long long int fp, char **urls[], int count) {
+    ACVP_CTX *session = ctx->session ? ctx->session : ctx;
+    ACVP_META_SHARE *share = session->meta_share;
+    char key[ACVP_META_CACHE_KEY_LEN + 1];
+    JSON_Value *entry_val = NULL, *urls_val = NULL, *shared_val = NULL;
+    JSON_Object *entry = NULL;
+    JSON_Array *entries = NULL;
+    time_t saved = time(NULL);
+    int i = 0, idx = 0;
+
+    if (!session->meta_cache && !share) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (!*urls[i]) return;
+    }
+    snprintf(key, sizeof(key), "%016llx", fp);
+
+    entry_val = json_value_init_object();
+    urls_val = json_value_init_array();
+    if (!entry_val || !urls_val) {
+        if (entry_val) json_value_free(entry_val);
+        if (urls_val) json_value_free(urls_val);
+        return;
+    }
+    entry = json_value_get_object(entry_val);
+    json_object_set_string(entry, "key", key);
+    json_object_set_number(entry, "saved", (double)saved);
+    for (i = 0; i < count; i++) {
+        json_array_append_string(json_value_get_array(urls_val), *urls[i]);
+    }
+    json_object_set_value(entry, "urls", urls_val);
+
+    if (share) {
+        shared_val = session->meta_cache ? json_value_deep_copy(entry_val) : entry_val;
+        acvp_mutex_lock(&share->lock);
+        entries = json_value_get_array(share->entries);
+        idx = meta_cache_find(entries, key);
+        if (shared_val && ((idx >= 0 && json_array_replace_value(entries, idx, shared_val) == JSONSuccess) ||
+                (idx < 0 && json_array_append_value(entries, shared_val) == JSONSuccess))) {
+            shared_val = NULL;
+        }
+        acvp_cond_broadcast(&share->cond);
+        acvp_mutex_unlock(&share->lock);
+        if (shared_val) json_value_free(shared_val);
+        if (!session->meta_cache) {
+            return;
+        }
+    }
+
+    acvp_mutex_lock(&session->meta_cache_lock);
+    entries = json_object_get_array(json_value_get_object(session->meta_cache), "entries");
+    idx = meta_cache_find(entries, key);
+    if ((idx >= 0 && json_array_replace_value(entries, idx, entry_val) == JSONSuccess) ||
+            (idx < 0 && json_array_append_value(entries, entry_val) == JSONSuccess)) {
+        session->meta_cache_dirty = 1;
+        entry_val = NULL;
+    }
+    acvp_mutex_unlock(&session->meta_cache_lock);
+
+    if (entry_val) json_value_free(entry_val);
+}
+
+/*
+ * Loads the cache file if one is set, keeping the entries that have not
+ * expired. A cache file that can not be read is started over.
+ */
+static void meta_cache_load(ACVP_CTX *ctx) {
+    JSON_Value *file_val = NULL, *val = NULL, *entries_val = NULL;
+    JSON_Object *file_obj = NULL, *obj = NULL;
+    JSON_Array *file_entries = NULL, *entries = NULL;
+    time_t now = time(NULL);
+    int i = 0, count = 0;
+
+    if (!ctx->meta_cache_file || ctx->meta_cache) {
+        return;
+    }
+
+    val = json_value_init_object();
+    entries_val = json_value_init_array();
+    obj = json_value_get_object(val);
+    if (!obj || !entries_val || json_object_set_number(obj, "version", ACVP_META_CACHE_VERSION) != JSONSuccess ||
+            json_object_set_value(obj, "entries", entries_val) != JSONSuccess) {
+        if (val) json_value_free(val);
+        if (entries_val) json_value_free(entries_val);
+        ACVP_LOG_WARN("Unable to use validation metadata cache %s", ctx->meta_cache_file);
+        return;
+    }
+    entries = json_value_get_array(entries_val);
+    ctx->meta_cache = val;
+    ctx->meta_cache_dirty = 0;
+
+    file_val = json_parse_file(ctx->meta_cache_file);
+    file_obj = json_value_get_object(file_val);
+    if (file_obj && json_object_get_uint(file_obj, "version") == ACVP_META_CACHE_VERSION) {
+        file_entries = json_object_get_array(file_obj, "entries");
+    }
+    count = (int)json_array_get_count(file_entries);
+    for (i = 0; i < count; i++) {
+        JSON_Object *entry = json_array_get_object(file_entries, i);
+        JSON_Value *copy = NULL;
+
+        if (!entry || !json_object_get_string(entry, "key") || meta_cache_expired(ctx, entry, now)) {
+            /* Dropped from the file the next time it is saved */
+            ctx->meta_cache_dirty = 1;
+            continue;
+        }
+        copy = json_value_deep_copy(json_array_get_value(file_entries, i));
+        if (!copy || json_array_append_value(entries, copy) != JSONSuccess) {
+            if (copy) json_value_free(copy);
+            ctx->meta_cache_dirty = 1;
+        }
+    }
+    if (file_val) json_value_free(file_val);
+
+    ACVP_LOG_STATUS("Loaded %u validation metadata cache entries from %s",
+                    (unsigned int)json_array_get_count(entries), ctx->meta_cache_file);
+}
+
+/*
+ * Saves the cache file if anything changed and releases the cache; failing
+ * to save is not an error, the next validation just searches the server DB.
+ */
+static void meta_cache_save(ACVP_CTX *ctx) {
+    if (!ctx->meta_cache) {
+        return;
+    }
+    if (ctx->meta_cache_dirty) {
+        if (json_serialize_to_file_pretty(ctx->meta_cache, ctx->meta_cache_file) == JSONSuccess) {
+            ACVP_LOG_STATUS("Saved validation metadata cache %s", ctx->meta_cache_file);
+        } else {
+            ACVP_LOG_WARN("Unable to write validation metadata cache %s", ctx->meta_cache_file);
+        }
+    }
+    json_value_free(ctx->meta_cache);
+    ctx->meta_cache = NULL;
+    ctx->meta_cache_dirty = 0;
+}
+
 /**
  * @brief Compare two dependencies to see if they are equal.
  *
@@ -714,7 +1206,7 @@ static ACVP_RESULT match_dependencies_page(ACVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -836,6 +1328,8 @@ static ACVP_RESULT query_dependency(ACVP_CTX *ctx,
     ACVP_RESULT rv = 0;
     ACVP_KV_LIST *parameters = NULL;
     char *first_endpoint = NULL, *next_endpoint = NULL;
+    char **urls[1];
+    unsigned long long int fp = 0;
     int match = 0;
 
     if (!ctx) return ACVP_NO_CTX;
@@ -852,9 +1346,16 @@ static ACVP_RESULT query_dependency(ACVP_CTX *ctx,
     }
 
     if (endpoint == NULL) {
+        urls[0] = &dep->url;
+        fp = meta_key_dependency(ctx, dep);
+        if (meta_cache_get(ctx, fp, urls, 1)) {
+            return ACVP_SUCCESS;
+        }
+
         first_endpoint = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
         if (first_endpoint == NULL) {
             ACVP_LOG_ERR("Failed to malloc");
+            meta_share_done(ctx, fp, ACVP_MALLOC_FAIL);
             return ACVP_MALLOC_FAIL;
         }
         endpoint = first_endpoint;
@@ -919,14 +1420,95 @@ static ACVP_RESULT query_dependency(ACVP_CTX *ctx,
         ACVP_LOG_INFO("No matching dependency on this page, moving to next page...");
     } while (endpoint);
 
+    if (rv == ACVP_SUCCESS && match && first_endpoint) {
+        meta_cache_put(ctx, fp, urls, 1);
+    }
+
 end:
-    if (first_endpoint) free(first_endpoint);
+    if (first_endpoint) {
+        meta_share_done(ctx, fp, rv);
+        free(first_endpoint);
+    }
     if (next_endpoint) free(next_endpoint);
     if (parameters) acvp_kv_list_free(parameters);
 
     return rv;
 }
 
+/*
+ * A lookup in the server DB that does not depend on any other running at
+ * the same time, see run_lookups()
+ */
+typedef struct acvp_oe_lookup_t {
+    ACVP_RESULT (*fn)(ACVP_CTX *ctx, void *arg);
+    void *arg;
+    ACVP_CTX *ctx;      /* Exec context the lookup runs on, if it has its own thread */
+    ACVP_RESULT rv;
+} ACVP_OE_LOOKUP;
+
+static void lookup_thread(void *arg) {
+    ACVP_OE_LOOKUP *lookup = (ACVP_OE_LOOKUP *)arg;
+
+    lookup->rv = lookup->fn(lookup->ctx, lookup->arg);
+}
+
+/*
+ * Runs the lookups, up to ACVP_OE_LOOKUPS_MAX at once, each with an exec
+ * context of its own so it has its own connection and response buffer. A
+ * lookup that can not get a thread is run on ctx once the others are done,
+ * and one without a function is skipped.
+ * Returns the first failure in list order; all lookups are run either way.
+ */
+static ACVP_RESULT run_lookups(ACVP_CTX *ctx, ACVP_OE_LOOKUP *lookups, int count) {
+    ACVP_CTX *session = ctx->session ? ctx->session : ctx;
+    ACVP_THREAD threads[ACVP_OE_LOOKUPS_MAX];
+    int started[ACVP_OE_LOOKUPS_MAX];
+    int i = 0, j = 0, batch = 0;
+
+    for (i = 0; i < count; i += batch) {
+        batch = count - i < ACVP_OE_LOOKUPS_MAX ? count - i : ACVP_OE_LOOKUPS_MAX;
+        for (j = 0; j < batch; j++) {
+            ACVP_OE_LOOKUP *lookup = &lookups[i + j];
+
+            started[j] = 0;
+            if (count == 1 || !lookup->fn) {
+                continue;
+            }
+            lookup->ctx = acvp_create_exec_ctx(session);
+            if (!lookup->ctx) {
+                continue;
+            }
+            if (acvp_thread_create(&threads[j], lookup_thread, lookup) != ACVP_SUCCESS) {
+                acvp_free_exec_ctx(lookup->ctx);
+                continue;
+            }
+            started[j] = 1;
+        }
+        for (j = 0; j < batch; j++) {
+            ACVP_OE_LOOKUP *lookup = &lookups[i + j];
+
+            if (started[j]) {
+                acvp_thread_join(threads[j]);
+                acvp_free_exec_ctx(lookup->ctx);
+            } else if (lookup->fn) {
+                lookup->rv = lookup->fn(ctx, lookup->arg);
+            }
+            lookup->ctx = NULL;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        if (lookups[i].rv != ACVP_SUCCESS) {
+            return lookups[i].rv;
+        }
+    }
+    return ACVP_SUCCESS;
+}
+
+static ACVP_RESULT lookup_dependency(ACVP_CTX *ctx, void *arg) {
+    return query_dependency(ctx, (ACVP_DEPENDENCY *)arg, NULL);
+}
+
 /**
  * @brief Verify the OE dependencies data which the user intends to send for a FIPS validation.
  *
@@ -945,6 +1527,7 @@ end:
 static ACVP_RESULT verify_fips_oe_dependencies(ACVP_CTX *ctx,
                                                ACVP_OE_DEPENDENCIES *dependencies) {
     ACVP_RESULT rv = 0;
+    ACVP_OE_LOOKUP *lookups = NULL;
     unsigned int i = 0, all_incomplete = 1;
 
     if (!ctx) return ACVP_NO_CTX;
@@ -953,13 +1536,34 @@ static ACVP_RESULT verify_fips_oe_dependencies(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
+    /* The Dependencies are independent of each other, so look them all up at once */
+    if (dependencies->count) {
+        lookups = calloc(dependencies->count, sizeof(ACVP_OE_LOOKUP));
+        if (!lookups) {
+            ACVP_LOG_ERR("Failed to malloc");
+            return ACVP_MALLOC_FAIL;
+        }
+        for (i = 0; i < dependencies->count; i++) {
+            unsigned int j = 0;
+
+            lookups[i].arg = dependencies->deps[i];
+            for (j = 0; j < i && lookups[j].arg != lookups[i].arg; j++);
+            if (j == i) {
+                /* Linked more than once, only looked up once */
+                lookups[i].fn = lookup_dependency;
+            }
+        }
+        run_lookups(ctx, lookups, dependencies->count);
+    }
+
     dependencies->status = ACVP_RESOURCE_STATUS_COMPLETE; // Start with this
     for (i = 0; i < dependencies->count; i++) {
         ACVP_DEPENDENCY *cur_dep = dependencies->deps[i];
 
-        rv = query_dependency(ctx, cur_dep, NULL);
+        rv = lookups[i].rv;
         if (ACVP_SUCCESS != rv) {
             ACVP_LOG_ERR("Unable to query this Dependency[%d]", i);
+            free(lookups);
             return rv;
         }
 
@@ -977,6 +1581,7 @@ static ACVP_RESULT verify_fips_oe_dependencies(ACVP_CTX *ctx,
         dependencies->status = ACVP_RESOURCE_STATUS_INCOMPLETE;
     }
 
+    if (lookups) free(lookups);
     return ACVP_SUCCESS;
 }
 
@@ -1019,7 +1624,7 @@ static ACVP_RESULT match_oes_page(ACVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -1143,6 +1748,8 @@ static ACVP_RESULT query_oe(ACVP_CTX *ctx,
     ACVP_RESULT rv = 0;
     ACVP_KV_LIST *parameters = NULL;
     char *first_endpoint = NULL, *next_endpoint = NULL;
+    char **urls[1];
+    unsigned long long int fp = 0;
     int match = 0;
 
     if (!ctx) return ACVP_NO_CTX;
@@ -1159,9 +1766,16 @@ static ACVP_RESULT query_oe(ACVP_CTX *ctx,
     }
 
     if (endpoint == NULL) {
+        urls[0] = &oe->url;
+        fp = meta_key_oe(ctx, oe);
+        if (meta_cache_get(ctx, fp, urls, 1)) {
+            return ACVP_SUCCESS;
+        }
+
         first_endpoint = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
         if (first_endpoint == NULL) {
             ACVP_LOG_ERR("Failed to malloc");
+            meta_share_done(ctx, fp, ACVP_MALLOC_FAIL);
             return ACVP_MALLOC_FAIL;
         }
         endpoint = first_endpoint;
@@ -1210,8 +1824,15 @@ static ACVP_RESULT query_oe(ACVP_CTX *ctx,
         ACVP_LOG_INFO("No matching OE on this page, moving to next page...");
     } while (endpoint);
 
+    if (rv == ACVP_SUCCESS && match && first_endpoint) {
+        meta_cache_put(ctx, fp, urls, 1);
+    }
+
 end:
-    if (first_endpoint) free(first_endpoint);
+    if (first_endpoint) {
+        meta_share_done(ctx, fp, rv);
+        free(first_endpoint);
+    }
     if (next_endpoint) free(next_endpoint);
     if (parameters) acvp_kv_list_free(parameters);
 
@@ -1612,7 +2233,7 @@ static ACVP_RESULT query_vendor_contacts(ACVP_CTX *ctx,
         return rv;
     }
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -1760,7 +2381,7 @@ static ACVP_RESULT match_vendors_page(ACVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -1914,7 +2535,9 @@ static ACVP_RESULT query_vendor(ACVP_CTX *ctx,
     ACVP_RESULT rv = 0;
     ACVP_KV_LIST *parameters = NULL;
     char *first_endpoint = NULL, *next_endpoint = NULL;
-    int match = 0;
+    char **urls[ACVP_META_CACHE_URLS_MAX];
+    unsigned long long int fp = 0;
+    int match = 0, i = 0;
 
     if (!ctx) return ACVP_NO_CTX;
     if (vendor == NULL) {
@@ -1930,9 +2553,20 @@ static ACVP_RESULT query_vendor(ACVP_CTX *ctx,
     }
 
     if (endpoint == NULL) {
+        urls[0] = &vendor->url;
+        urls[1] = &vendor->address.url;
+        for (i = 0; i < vendor->persons.count; i++) {
+            urls[2 + i] = &vendor->persons.person[i].url;
+        }
+        fp = meta_key_vendor(ctx, vendor);
+        if (meta_cache_get(ctx, fp, urls, 2 + vendor->persons.count)) {
+            return ACVP_SUCCESS;
+        }
+
         first_endpoint = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
         if (first_endpoint == NULL) {
             ACVP_LOG_ERR("Failed to malloc");
+            meta_share_done(ctx, fp, ACVP_MALLOC_FAIL);
             return ACVP_MALLOC_FAIL;
         }
         endpoint = first_endpoint;
@@ -1997,8 +2631,15 @@ static ACVP_RESULT query_vendor(ACVP_CTX *ctx,
         ACVP_LOG_INFO("No matching vendor on this page, moving to next page...");
     } while (endpoint);
 
+    if (rv == ACVP_SUCCESS && match && first_endpoint) {
+        meta_cache_put(ctx, fp, urls, 2 + vendor->persons.count);
+    }
+
 end:
-    if (first_endpoint) free(first_endpoint);
+    if (first_endpoint) {
+        meta_share_done(ctx, fp, rv);
+        free(first_endpoint);
+    }
     if (next_endpoint) free(next_endpoint);
     if (parameters) acvp_kv_list_free(parameters);
 
@@ -2100,7 +2741,7 @@ static ACVP_RESULT match_modules_page(ACVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->exec.curl_buf);
     if (!val) {
         ACVP_LOG_ERR("JSON parse error");
         return ACVP_JSON_ERR;
@@ -2287,6 +2928,8 @@ static ACVP_RESULT query_module(ACVP_CTX *ctx,
     ACVP_RESULT rv = 0;
     ACVP_KV_LIST *parameters = NULL;
     char *first_endpoint = NULL, *next_endpoint = NULL;
+    char **urls[1];
+    unsigned long long int fp = 0;
     int match = 0;
 
     if (!ctx) return ACVP_NO_CTX;
@@ -2303,9 +2946,16 @@ static ACVP_RESULT query_module(ACVP_CTX *ctx,
         size_t vendor_url_len = 0;
         char *ptr = NULL, *ptr_old = NULL;
 
+        urls[0] = &module->url;
+        fp = meta_key_module(ctx, module);
+        if (meta_cache_get(ctx, fp, urls, 1)) {
+            return ACVP_SUCCESS;
+        }
+
         first_endpoint = calloc(ACVP_ATTR_URL_MAX + 1, sizeof(char));
         if (first_endpoint == NULL) {
             ACVP_LOG_ERR("Failed to malloc");
+            meta_share_done(ctx, fp, ACVP_MALLOC_FAIL);
             return ACVP_MALLOC_FAIL;
         }
         endpoint = first_endpoint;
@@ -2398,8 +3048,15 @@ static ACVP_RESULT query_module(ACVP_CTX *ctx,
         ACVP_LOG_INFO("No matching module on this page, moving to next page...");
     } while (endpoint);
     
+    if (rv == ACVP_SUCCESS && match && first_endpoint) {
+        meta_cache_put(ctx, fp, urls, 1);
+    }
+
 end:
-    if (first_endpoint) free(first_endpoint);
+    if (first_endpoint) {
+        meta_share_done(ctx, fp, rv);
+        free(first_endpoint);
+    }
     if (next_endpoint) free(next_endpoint);
     if (parameters) acvp_kv_list_free(parameters);
 
@@ -2455,6 +3112,16 @@ static ACVP_RESULT verify_fips_module(ACVP_CTX *ctx) {
     return ACVP_SUCCESS;
 }
 
+static ACVP_RESULT lookup_module(ACVP_CTX *ctx, void *arg) {
+    (void)arg;
+    return verify_fips_module(ctx);
+}
+
+static ACVP_RESULT lookup_oe(ACVP_CTX *ctx, void *arg) {
+    (void)arg;
+    return verify_fips_oe(ctx);
+}
+
 /**
  * @brief Verify that the selected FIPS validation metadata is sane.
  *
@@ -2475,8 +3142,12 @@ static ACVP_RESULT verify_fips_module(ACVP_CTX *ctx) {
  */
 ACVP_RESULT acvp_verify_fips_validation_metadata(ACVP_CTX *ctx) {
     ACVP_RESULT rv = 0;
+    ACVP_OE_LOOKUP lookups[2];
+    ACVP_CTX *session = NULL;
 
     if (!ctx) return ACVP_NO_CTX;
+    session = ctx->session ? ctx->session : ctx;
+    memzero_s(lookups, sizeof(lookups));
 
     if (ctx->fips.module == NULL) {
         ACVP_LOG_ERR("Need to specify 'Module' via acvp_oe_set_fips_validation_metadata()");
@@ -2490,12 +3161,22 @@ ACVP_RESULT acvp_verify_fips_validation_metadata(ACVP_CTX *ctx) {
 
     ACVP_LOG_STATUS("Checking validation metadata for correctness and pre-existing server entries...");
 
+    /*
+     * The Module (with its Vendor) and the OE (with its Dependencies) are
+     * looked up at the same time, they do not depend on each other.
+     */
+    ACVP_LOG_INFO("Verifying module (includes vendor) and OE (includes dependencies)...");
+    lookups[0].fn = lookup_module;
+    lookups[1].fn = lookup_oe;
+    meta_cache_load(session);
+    run_lookups(ctx, lookups, 2);
+    meta_cache_save(session);
+
     /*
      * Verify the Module.
      * This includes the linked Vendor.
      */
-    ACVP_LOG_INFO("Verifying module (includes vendor)...");
-    rv = verify_fips_module(ctx);
+    rv = lookups[0].rv;
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Unable to verify Vendor");
         return rv;
@@ -2510,8 +3191,7 @@ ACVP_RESULT acvp_verify_fips_validation_metadata(ACVP_CTX *ctx) {
      * Verify the OE.
      * This includes the linked Dependencies.
      */
-    ACVP_LOG_INFO("Verifying OE (includes dependencies)...");
-    rv = verify_fips_oe(ctx);
+    rv = lookups[1].rv;
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Unable to verify Module");
         return rv;
@@ -17,6 +17,13 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+static ACVP_RESULT acvp_pbkdf_run_batch(ACVP_CTX *ctx,
+                                        ACVP_CAPS_LIST *cap,
+                                        ACVP_TC_BATCH *batch,
+                                        JSON_Array *r_tarr);
+
+static void acvp_pbkdf_release_batch(ACVP_PBKDF_TC **stcs, ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -27,7 +34,6 @@ static ACVP_RESULT acvp_pbkdf_output_tc(ACVP_CTX *ctx,
                                          ACVP_PBKDF_TC *stc,
                                          JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
     if ((stc->key_len) > ACVP_PBKDF_KEY_BYTE_MAX) {
         ACVP_LOG_ERR("key len too long. Ensure user is not modifying.");
@@ -37,22 +43,13 @@ static ACVP_RESULT acvp_pbkdf_output_tc(ACVP_CTX *ctx,
         return ACVP_INVALID_ARG;
     }
 
-    tmp = calloc(ACVP_PBKDF_KEY_STR_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc");
-        return ACVP_MALLOC_FAIL;
-    }
-
-    rv = acvp_bin_to_hexstr(stc->key, stc->key_len,
-                            tmp, ACVP_PBKDF_KEY_STR_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "derivedKey", stc->key, stc->key_len, ACVP_PBKDF_KEY_STR_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (key)");
         goto end;
     }
-    json_object_set_string(tc_rsp, "derivedKey", tmp);
 
 end:
-    if (tmp) free(tmp);
     return rv;
 }
 
@@ -116,6 +113,44 @@ static ACVP_RESULT acvp_pbkdf_release_tc(ACVP_PBKDF_TC *stc) {
     return ACVP_SUCCESS;
 }
 
+/*
+ * Estimated cost of a test case: PBKDF2 runs iterationCount HMACs for
+ * every block of output, a block being one digest of the PRF
+ */
+static unsigned long long int acvp_pbkdf_tc_cost(ACVP_HASH_ALG hmac_alg, int key_len, int iteration_count) {
+    int block_len = 0;
+
+    switch (hmac_alg) {
+    case ACVP_SHA1:
+        block_len = 20;
+        break;
+    case ACVP_SHA224:
+    case ACVP_SHA512_224:
+    case ACVP_SHA3_224:
+        block_len = 28;
+        break;
+    case ACVP_SHA384:
+    case ACVP_SHA3_384:
+        block_len = 48;
+        break;
+    case ACVP_SHA512:
+    case ACVP_SHA3_512:
+        block_len = 64;
+        break;
+    case ACVP_SHA256:
+    case ACVP_SHA512_256:
+    case ACVP_SHA3_256:
+    case ACVP_NO_SHA:
+    case ACVP_SHAKE_128:
+    case ACVP_SHAKE_256:
+    case ACVP_HASH_ALG_MAX:
+    default:
+        block_len = 32;
+        break;
+    }
+    return (unsigned long long int)iteration_count * ((key_len + block_len - 1) / block_len);
+}
+
 static ACVP_PBKDF_TESTTYPE read_test_type(const char *str) {
     int diff = 1;
 
@@ -210,11 +245,13 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     ACVP_CAPS_LIST *cap;
     ACVP_PBKDF_TC stc;
+    ACVP_PBKDF_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
     ACVP_TEST_CASE tc;
+    ACVP_TC_BATCH batch;
     ACVP_RESULT rv;
+    int use_batch = 0;
     const char *alg_str = NULL;
     ACVP_CIPHER alg_id = 0;
-    char *json_result;
 
     ACVP_PBKDF_TESTTYPE test_type = 0;
     ACVP_HASH_ALG hmac_alg = 0;
@@ -243,6 +280,7 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.pbkdf = &stc;
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -265,7 +303,7 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -284,15 +322,15 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         test_type_str = json_object_get_string(groupobj, "testType");
         if (!test_type_str) {
@@ -329,12 +367,32 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
+
+        /*
+         * Iteration counts within a group range from a handful to millions.
+         * When the group is run in parallel or on an async handler it is
+         * set up in one piece, and the cases with the most iterations are
+         * started first so one long case does not finish the group alone.
+         */
+        use_batch = t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_PBKDF_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new pbkdf test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
 
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Server JSON missing 'tcId'");
                 rv = ACVP_MISSING_ARG;
@@ -411,16 +469,29 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
              * Setup the test case data that will be passed down to
              * the crypto module.
              */
-            rv = acvp_pbkdf_init_tc(&stc, tc_id, hmac_alg, test_type,
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_pbkdf_init_tc(cur, tc_id, hmac_alg, test_type,
                                      salt_str, password_str, iteration_count,
                                      key_len, salt_len, password_len);
             if (rv != ACVP_SUCCESS) {
-                acvp_pbkdf_release_tc(&stc);
+                acvp_pbkdf_release_tc(cur);
                 goto err;
             }
 
+            if (use_batch) {
+                r_tval = json_value_init_object();
+                json_object_set_number(json_value_get_object(r_tval), "tcId", tc_id);
+                /* Run with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.pbkdf = cur;
+                rv = acvp_tc_batch_set_cost(&batch, acvp_pbkdf_tc_cost(hmac_alg, key_len, iteration_count));
+                if (rv != ACVP_SUCCESS) {
+                    goto err;
+                }
+                continue;
+            }
+
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                 ACVP_LOG_ERR("crypto module failed the operation");
                 acvp_pbkdf_release_tc(&stc);
                 rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -453,19 +524,74 @@ ACVP_RESULT acvp_pbkdf_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_pbkdf_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_pbkdf_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_pbkdf_release_batch(&stcs, &batch);
     if (rv != ACVP_SUCCESS) {
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_pbkdf_run_batch(ACVP_CTX *ctx,
+                                        ACVP_CAPS_LIST *cap,
+                                        ACVP_TC_BATCH *batch,
+                                        JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_pbkdf_output_tc(ctx, batch->tcs[i].tc.pbkdf, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("JSON output failure for pbkdf tc");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_pbkdf_release_batch(ACVP_PBKDF_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_pbkdf_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
@@ -0,0 +1,348 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Remote workers, see acvp_set_remote_workers() and acvp_run_remote_worker().
+ * The coordinator, which owns the test session, and the workers, which run
+ * the crypto handlers, share a directory, over NFS or the like. Each vector
+ * set the coordinator downloads is written there as a request file with that
+ * one vector set, as acvp_run_vectors_from_file() reads it, and a worker
+ * hands back a response file, as it writes it:
+ *
+ *     <dir>/vs-<vsId>.req.json    waiting for a worker
+ *     <dir>/vs-<vsId>.run.json    taken by a worker, renamed from .req.json
+ *     <dir>/vs-<vsId>.rsp.json    the responses, for the coordinator to post
+ *     <dir>/vs-<vsId>.err         the ACVP_RESULT the worker failed with
+ *     <dir>/done                  the coordinator is finished with the directory
+ *
+ * Every file is written under another name and renamed into place, so it is
+ * only seen whole; a request goes to the one worker whose rename succeeds.
+ * The request file has the session URL but not the JWT, which stays with the
+ * coordinator along with every request made of the server.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define ACVP_REMOTE_POLL 1 /* seconds between looks at the directory */
+
+static int acvp_remote_path(char *path, size_t len, const char *dir, int vs_id, const char *ext) {
+    int n = 0;
+
+    if (vs_id) {
+        n = snprintf(path, len, "%s/vs-%d.%s", dir, vs_id, ext);
+    } else {
+        n = snprintf(path, len, "%s/%s", dir, ext);
+    }
+    return n > 0 && (size_t)n < len;
+}
+
+static int acvp_remote_exists(const char *path) {
+    FILE *fp = fopen(path, "rb");
+
+    if (!fp) {
+        return 0;
+    }
+    fclose(fp);
+    return 1;
+}
+
+/*
+ * Moves the file written as tmp into place as path
+ */
+static int acvp_remote_publish(const char *tmp, const char *path) {
+    /* rename() does not replace an existing file everywhere */
+    remove(path);
+    if (rename(tmp, path)) {
+        remove(tmp);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Writes the vector set of the coordinator, obj as downloaded for vsid_url,
+ * to the directory for a worker to take
+ */
+ACVP_RESULT acvp_remote_ship(ACVP_CTX *ctx, const char *vsid_url, JSON_Object *obj) {
+    char tmp[ACVP_JSON_FILENAME_MAX + 32], path[ACVP_JSON_FILENAME_MAX + 32];
+    JSON_Value *ids_val = NULL, *urls_val = NULL;
+    JSON_Object *ids = NULL;
+    FILE *fp = NULL;
+    int vs_id = (int)json_object_get_uint(obj, "vsId"), ok = 0;
+
+    ctx->exec.vs_id = vs_id;
+    if (json_object_get_string(obj, "error")) {
+        ACVP_LOG_ERR("ACVP Server error detected -- An algorithm may have been skipped during vector generation.  Please manually check the file.");
+        return ACVP_NO_DATA;
+    }
+    if (vs_id <= 0 || !acvp_remote_path(tmp, sizeof(tmp), ctx->remote_dir, vs_id, "req.tmp") ||
+            !acvp_remote_path(path, sizeof(path), ctx->remote_dir, vs_id, "req.json")) {
+        ACVP_LOG_ERR("Unable to name the request file for vector set %s", vsid_url);
+        return ACVP_INVALID_ARG;
+    }
+
+    /* The identifiers of a request file, without the JWT */
+    ids_val = json_value_init_object();
+    urls_val = json_value_init_array();
+    ids = json_value_get_object(ids_val);
+    if (!ids || !urls_val) {
+        goto end;
+    }
+    json_object_set_string(ids, "url", ctx->session_url ? ctx->session_url : "");
+    json_object_set_string(ids, "jwt", "");
+    json_object_set_boolean(ids, "isSample", ctx->is_sample);
+    json_array_append_string(json_value_get_array(urls_val), vsid_url);
+    json_object_set_value(ids, "vectorSetUrls", urls_val);
+    urls_val = NULL;
+
+    fp = fopen(tmp, "w");
+    if (!fp) {
+        goto end;
+    }
+    ok = fputc('[', fp) != EOF && json_serialize_to_fp(ids_val, fp) == JSONSuccess && fputc(',', fp) != EOF &&
+         json_serialize_to_fp(json_object_get_wrapping_value(obj), fp) == JSONSuccess && fputc(']', fp) != EOF;
+    if (fclose(fp) == EOF) {
+        ok = 0;
+    }
+    ok = ok && acvp_remote_publish(tmp, path);
+
+end:
+    if (urls_val) acvp_json_value_free(urls_val);
+    if (ids_val) acvp_json_value_free(ids_val);
+    if (!ok) {
+        remove(tmp);
+        ACVP_LOG_ERR("Unable to write vector set %d for the remote workers", vs_id);
+        return ACVP_JSON_ERR;
+    }
+    ACVP_LOG_STATUS("Handed vector set %d to the remote workers", vs_id);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Waits for a worker to hand back the responses of the vector set shipped by
+ * acvp_remote_ship(), and leaves them in ctx->exec.kat_resp as the KAT handler
+ * would have, to be posted. Gives up after the remote timeout of ctx.
+ */
+ACVP_RESULT acvp_remote_wait(ACVP_CTX *ctx) {
+    char path[ACVP_JSON_FILENAME_MAX + 32], err[ACVP_JSON_FILENAME_MAX + 32];
+    JSON_Value *val = NULL, *ver_val = NULL;
+    JSON_Array *arr = NULL;
+    FILE *fp = NULL;
+    int vs_id = ctx->exec.vs_id, code = 0;
+    time_t deadline = time(NULL) + (ctx->remote_timeout ? ctx->remote_timeout : ACVP_MAX_WAIT_TIME);
+
+    if (!acvp_remote_path(path, sizeof(path), ctx->remote_dir, vs_id, "rsp.json") ||
+            !acvp_remote_path(err, sizeof(err), ctx->remote_dir, vs_id, "err")) {
+        return ACVP_INVALID_ARG;
+    }
+    while (!acvp_remote_exists(path)) {
+        fp = fopen(err, "r");
+        if (fp) {
+            if (fscanf(fp, "%d", &code) != 1 || code == ACVP_SUCCESS) {
+                code = ACVP_INTERNAL_ERR;
+            }
+            fclose(fp);
+            remove(err);
+            ACVP_LOG_ERR("Remote worker failed to process vector set %d (%s)", vs_id,
+                         acvp_lookup_error_string((ACVP_RESULT)code));
+            return (ACVP_RESULT)code;
+        }
+        if (time(NULL) >= deadline) {
+            ACVP_LOG_ERR("No remote worker processed vector set %d in time", vs_id);
+            return ACVP_TRANSPORT_FAIL;
+        }
+        acvp_sleep(ACVP_REMOTE_POLL);
+    }
+
+    /* [identifiers, responses], posted as [version, responses] */
+    val = json_parse_file(path);
+    arr = json_value_get_array(val);
+    if (!arr || (int)json_object_get_uint(json_array_get_object(arr, 1), "vsId") != vs_id) {
+        ACVP_LOG_ERR("Responses of the remote worker for vector set %d do not parse", vs_id);
+        if (val) acvp_json_value_free(val);
+        return ACVP_JSON_ERR;
+    }
+    ver_val = json_value_init_object();
+    if (!ver_val) {
+        acvp_json_value_free(val);
+        return ACVP_MALLOC_FAIL;
+    }
+    json_object_set_string(json_value_get_object(ver_val), "acvVersion", ACVP_PROTOCOL_VERSION);
+    json_array_replace_value(arr, 0, ver_val);
+    remove(path);
+
+    if (ctx->exec.kat_resp) acvp_json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = val;
+    ACVP_LOG_STATUS("Received responses for vector set %d from a remote worker", vs_id);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Tells the workers the coordinator is done with the directory, as its
+ * session is freed
+ */
+void acvp_remote_finish(ACVP_CTX *ctx) {
+    char path[ACVP_JSON_FILENAME_MAX + 32];
+    FILE *fp = NULL;
+
+    if (!ctx->remote_dir || !acvp_remote_path(path, sizeof(path), ctx->remote_dir, 0, "done")) {
+        return;
+    }
+    fp = fopen(path, "w");
+    if (fp) fclose(fp);
+}
+
+/*
+ * Takes a request file out of the directory, renaming it to run. Returns its
+ * vsId, or 0 when there is none to take.
+ */
+static int acvp_remote_claim(const char *dir, char *run, size_t len) {
+    char path[ACVP_JSON_FILENAME_MAX + 32];
+    const char *name = NULL;
+    int vs_id = 0, n = 0, taken = 0;
+#ifdef _WIN32
+    struct _finddata_t fd;
+    intptr_t h = -1;
+
+    if (!acvp_remote_path(path, sizeof(path), dir, 0, "vs-*.req.json")) {
+        return 0;
+    }
+    h = _findfirst(path, &fd);
+    if (h == -1) {
+        return 0;
+    }
+    do {
+        name = fd.name;
+#else
+    DIR *d = NULL;
+    struct dirent *ent = NULL;
+
+    d = opendir(dir);
+    if (!d) {
+        return 0;
+    }
+    while ((ent = readdir(d)) != NULL) {
+        name = ent->d_name;
+#endif
+        n = 0;
+        if (sscanf(name, "vs-%d.req.json%n", &vs_id, &n) == 1 && vs_id > 0 &&
+                n == (int)strnlen_s(name, ACVP_JSON_FILENAME_MAX) &&
+                acvp_remote_path(path, sizeof(path), dir, vs_id, "req.json") &&
+                acvp_remote_path(run, len, dir, vs_id, "run.json") &&
+                !rename(path, run)) {
+            /* Another worker may have been first */
+            taken = vs_id;
+            break;
+        }
+#ifdef _WIN32
+    } while (!_findnext(h, &fd));
+    _findclose(h);
+#else
+    }
+    closedir(d);
+#endif
+    return taken;
+}
+
+static void acvp_remote_fail(const char *dir, int vs_id, ACVP_RESULT rv) {
+    char tmp[ACVP_JSON_FILENAME_MAX + 32], path[ACVP_JSON_FILENAME_MAX + 32];
+    FILE *fp = NULL;
+    int ok = 0;
+
+    if (!acvp_remote_path(tmp, sizeof(tmp), dir, vs_id, "err.tmp") ||
+            !acvp_remote_path(path, sizeof(path), dir, vs_id, "err")) {
+        return;
+    }
+    fp = fopen(tmp, "w");
+    if (fp) {
+        ok = fprintf(fp, "%d\n", (int)rv) > 0;
+        if (fclose(fp) == EOF) ok = 0;
+    }
+    if (ok) {
+        acvp_remote_publish(tmp, path);
+    } else {
+        remove(tmp);
+    }
+}
+
+ACVP_RESULT acvp_run_remote_worker(ACVP_CTX *ctx, const char *dir, int idle_timeout) {
+    char run[ACVP_JSON_FILENAME_MAX + 32], tmp[ACVP_JSON_FILENAME_MAX + 32], path[ACVP_JSON_FILENAME_MAX + 32];
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int vs_id = 0, idle = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!dir) {
+        ACVP_LOG_ERR("Must provide value for the remote worker directory");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(dir, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX || idle_timeout < 0) {
+        ACVP_LOG_ERR("Provided dir length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+    if (ctx->pool || ctx->session) {
+        ACVP_LOG_ERR("Only the context of the session itself can be a remote worker");
+        return ACVP_INVALID_ARG;
+    }
+
+    ACVP_LOG_STATUS("Waiting for vector sets in %s...", dir);
+    while (1) {
+        vs_id = acvp_remote_claim(dir, run, sizeof(run));
+        if (!vs_id) {
+            if (!acvp_remote_path(path, sizeof(path), dir, 0, "done") || acvp_remote_exists(path)) {
+                break;
+            }
+            if (idle_timeout && idle >= idle_timeout) {
+                ACVP_LOG_STATUS("No vector sets for %d seconds, stopping", idle);
+                break;
+            }
+            acvp_sleep(ACVP_REMOTE_POLL);
+            idle += ACVP_REMOTE_POLL;
+            continue;
+        }
+        idle = 0;
+
+        ACVP_LOG_STATUS("Took vector set %d", vs_id);
+        if (!acvp_remote_path(tmp, sizeof(tmp), dir, vs_id, "rsp.tmp") ||
+                !acvp_remote_path(path, sizeof(path), dir, vs_id, "rsp.json")) {
+            rv = ACVP_INVALID_ARG;
+        } else {
+            /* Each request file is a session of its own */
+            acvp_reset_session(ctx);
+            rv = acvp_run_vectors_from_file(ctx, run, tmp);
+        }
+        if (rv == ACVP_SUCCESS && !acvp_remote_publish(tmp, path)) {
+            rv = ACVP_JSON_ERR;
+        }
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("Failed to process vector set %d (%s)", vs_id, acvp_lookup_error_string(rv));
+            remove(tmp);
+            acvp_remote_fail(dir, vs_id, rv);
+        }
+        remove(run);
+    }
+    acvp_reset_session(ctx);
+    return ACVP_SUCCESS;
+}
@@ -0,0 +1,562 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Hands the test cases of a batch to a crypto module running in another
+ * process, see acvp_cap_set_ring_handler(). The two processes map the same
+ * file, which holds a header with a process shared lock and two condition
+ * variables, then a fixed number of slots. Each slot has room for one test
+ * case: the algorithm specific struct followed by a region for each of its
+ * buffers, sized as the kat handlers allocate them, so nothing has to be
+ * serialized. The library copies a test case in, marks the slot ready and,
+ * once it has filled all the slots it may, rings the doorbell; the module
+ * rebuilds the pointers of the struct into its own mapping, runs its
+ * crypto handler on all the slots it finds ready, marks them done and
+ * signals back. One wake up on either side covers as many test cases as
+ * there were slots ready.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+#if !defined _WIN32 && defined _POSIX_THREAD_PROCESS_SHARED && _POSIX_THREAD_PROCESS_SHARED > 0
+#define ACVP_RING_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef ACVP_RING_SUPPORTED
+
+#define ACVP_RING_MAGIC 0x41525447u
+#define ACVP_RING_VERSION 1
+#define ACVP_RING_ALIGN 64
+#define ACVP_RING_ROUND(x) (((x) + ACVP_RING_ALIGN - 1) & ~(size_t)(ACVP_RING_ALIGN - 1))
+#define ACVP_RING_TAKE_MAX 16 /**< Slots the module takes at a time */
+
+typedef enum acvp_ring_state {
+    ACVP_RING_FREE = 0,
+    ACVP_RING_FILLING,   /* The library is copying a test case in */
+    ACVP_RING_READY,     /* Waiting for the module */
+    ACVP_RING_BUSY,      /* The module is running it */
+    ACVP_RING_DONE,      /* Waiting for the library to copy it out */
+    ACVP_RING_COLLECTING
+} ACVP_RING_STATE;
+
+/* Room for the largest of the test case structs a slot may hold */
+#define ACVP_RING_TC_MAX ACVP_RING_ROUND(sizeof(ACVP_SYM_CIPHER_TC) > sizeof(ACVP_HASH_TC) ? \
+                                         (sizeof(ACVP_SYM_CIPHER_TC) > sizeof(ACVP_HMAC_TC) ? \
+                                          sizeof(ACVP_SYM_CIPHER_TC) : sizeof(ACVP_HMAC_TC)) : \
+                                         (sizeof(ACVP_HASH_TC) > sizeof(ACVP_HMAC_TC) ? \
+                                          sizeof(ACVP_HASH_TC) : sizeof(ACVP_HMAC_TC)))
+
+typedef struct acvp_ring_slot_t {
+    int state;                /* ACVP_RING_STATE */
+    int kind;                 /* ACVP_TC_KIND */
+    int index;                /* Of the test case in the batch of the owner */
+    int result;               /* What the crypto handler of the module returned */
+    unsigned long long owner; /* The batch the slot was filled for */
+} ACVP_RING_SLOT;
+
+typedef struct acvp_ring_hdr_t {
+    unsigned int magic;
+    unsigned int version;
+    int slot_cnt;
+    int shutdown;             /* Set by acvp_ring_close() on the creator's side */
+    size_t slot_size;
+    unsigned long long next_owner;
+    pthread_mutex_t lock;
+    pthread_cond_t doorbell;  /* Slots have become ready, or the ring is shut down */
+    pthread_cond_t done;      /* Slots are done or free again */
+} ACVP_RING_HDR;
+
+#define ACVP_RING_HDR_SIZE ACVP_RING_ROUND(sizeof(ACVP_RING_HDR))
+#define ACVP_RING_SLOT_HDR_SIZE ACVP_RING_ROUND(sizeof(ACVP_RING_SLOT))
+
+struct acvp_ring_t {
+    ACVP_RING_HDR *hdr;
+    size_t map_len;
+    char *path;
+    int creator;
+};
+
+/* What a slot needs for the test cases of kind */
+static size_t acvp_ring_kind_size(int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    size_t size = ACVP_RING_SLOT_HDR_SIZE + ACVP_RING_TC_MAX;
+    int cnt = 0, i = 0;
+
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        size += ACVP_RING_ROUND(fields[i].cap);
+    }
+    return size;
+}
+
+static size_t acvp_ring_slot_size(void) {
+    size_t size = 0, max = 0;
+    int kind = 0;
+
+    for (kind = ACVP_TC_KIND_SYM; kind <= ACVP_TC_KIND_HMAC; kind++) {
+        size = acvp_ring_kind_size(kind);
+        if (size > max) max = size;
+    }
+    return max;
+}
+
+static ACVP_RING_SLOT *acvp_ring_slot(ACVP_RING *ring, int i) {
+    return (ACVP_RING_SLOT *)((char *)ring->hdr + ACVP_RING_HDR_SIZE + (size_t)i * ring->hdr->slot_size);
+}
+
+static char *acvp_ring_slot_tc(ACVP_RING_SLOT *slot) {
+    return (char *)slot + ACVP_RING_SLOT_HDR_SIZE;
+}
+
+/* The region of field i of the slot, the fields being laid out in table order */
+static unsigned char *acvp_ring_slot_buf(ACVP_RING_SLOT *slot, const ACVP_TC_FIELD *fields, int i) {
+    unsigned char *buf = (unsigned char *)acvp_ring_slot_tc(slot) + ACVP_RING_TC_MAX;
+    int k = 0;
+
+    for (k = 0; k < i; k++) {
+        buf += ACVP_RING_ROUND(fields[k].cap);
+    }
+    return buf;
+}
+
+static ACVP_RESULT acvp_ring_map(const char *path, int fd, size_t len, int creator, ACVP_RING **ring) {
+    ACVP_RING *r = NULL;
+    void *map = NULL;
+    size_t path_len = strnlen_s(path, ACVP_JSON_FILENAME_MAX + 1);
+
+    map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return ACVP_TRANSPORT_FAIL;
+    }
+    r = calloc(1, sizeof(ACVP_RING));
+    if (r) r->path = calloc(path_len + 1, sizeof(char));
+    if (!r || !r->path) {
+        if (r) free(r);
+        munmap(map, len);
+        return ACVP_MALLOC_FAIL;
+    }
+    memcpy_s(r->path, path_len + 1, path, path_len);
+    r->hdr = map;
+    r->map_len = len;
+    r->creator = creator;
+    *ring = r;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_ring_create(const char *path, int slots, ACVP_RING **ring) {
+    pthread_mutexattr_t mattr;
+    pthread_condattr_t cattr;
+    ACVP_RING_HDR *hdr = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    size_t slot_size = acvp_ring_slot_size(), len = 0;
+    int fd = -1;
+
+    if (!path || !ring) {
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(path, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX ||
+            slots < 1 || slots > ACVP_RING_SLOTS_MAX) {
+        return ACVP_INVALID_ARG;
+    }
+    len = ACVP_RING_HDR_SIZE + (size_t)slots * slot_size;
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return ACVP_TRANSPORT_FAIL;
+    }
+    if (ftruncate(fd, (off_t)len)) {
+        close(fd);
+        unlink(path);
+        return ACVP_TRANSPORT_FAIL;
+    }
+    rv = acvp_ring_map(path, fd, len, 1, ring);
+    close(fd);
+    if (rv != ACVP_SUCCESS) {
+        unlink(path);
+        return rv;
+    }
+
+    hdr = (*ring)->hdr;
+    pthread_mutexattr_init(&mattr);
+    pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&hdr->lock, &mattr);
+    pthread_mutexattr_destroy(&mattr);
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&hdr->doorbell, &cattr);
+    pthread_cond_init(&hdr->done, &cattr);
+    pthread_condattr_destroy(&cattr);
+    hdr->slot_cnt = slots;
+    hdr->slot_size = slot_size;
+    hdr->next_owner = 1;
+    hdr->version = ACVP_RING_VERSION;
+    /* Last, so the ring is not opened before it is set up */
+    __sync_synchronize();
+    hdr->magic = ACVP_RING_MAGIC;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_ring_open(const char *path, ACVP_RING **ring) {
+    ACVP_RING_HDR *hdr = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    struct stat st;
+    size_t len = 0;
+    int fd = -1;
+
+    if (!path || !ring) {
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(path, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        return ACVP_INVALID_ARG;
+    }
+
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return ACVP_TRANSPORT_FAIL;
+    }
+    if (fstat(fd, &st) || (size_t)st.st_size < ACVP_RING_HDR_SIZE) {
+        close(fd);
+        return ACVP_TRANSPORT_FAIL;
+    }
+    len = (size_t)st.st_size;
+    rv = acvp_ring_map(path, fd, len, 0, ring);
+    close(fd);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    /* Made by another build, or not yet set up */
+    hdr = (*ring)->hdr;
+    if (hdr->magic != ACVP_RING_MAGIC || hdr->version != ACVP_RING_VERSION ||
+            hdr->slot_size != acvp_ring_slot_size() || hdr->slot_cnt < 1 ||
+            len < ACVP_RING_HDR_SIZE + (size_t)hdr->slot_cnt * hdr->slot_size) {
+        acvp_ring_close(*ring);
+        *ring = NULL;
+        return ACVP_INVALID_ARG;
+    }
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_ring_close(ACVP_RING *ring) {
+    ACVP_RING_HDR *hdr = NULL;
+
+    if (!ring) {
+        return ACVP_MISSING_ARG;
+    }
+    hdr = ring->hdr;
+    if (ring->creator) {
+        pthread_mutex_lock(&hdr->lock);
+        hdr->shutdown = 1;
+        pthread_cond_broadcast(&hdr->doorbell);
+        pthread_cond_broadcast(&hdr->done);
+        pthread_mutex_unlock(&hdr->lock);
+        /* The other side keeps its mapping until it closes the ring as well */
+        unlink(ring->path);
+    }
+    munmap(ring->hdr, ring->map_len);
+    free(ring->path);
+    free(ring);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Points the struct copied into the slot at the regions of the slot in the
+ * mapping of the module, and clears what is not carried
+ */
+static ACVP_TEST_CASE acvp_ring_slot_rebuild(ACVP_RING_SLOT *slot) {
+    const ACVP_TC_FIELD *fields = NULL;
+    ACVP_TEST_CASE tc;
+    char *stc = acvp_ring_slot_tc(slot);
+    int cnt = 0, i = 0;
+
+    acvp_tc_layout_fields(slot->kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        *acvp_tc_layout_ptr(stc, &fields[i]) = fields[i].dir ? acvp_ring_slot_buf(slot, fields, i) : NULL;
+    }
+
+    tc = acvp_tc_layout_wrap(stc, slot->kind);
+    return tc;
+}
+
+ACVP_RESULT acvp_ring_serve(ACVP_RING *ring, int (*crypto_handler)(ACVP_TEST_CASE *test_case)) {
+    ACVP_RING_HDR *hdr = NULL;
+    ACVP_RING_SLOT *slot = NULL, *taken[ACVP_RING_TAKE_MAX];
+    ACVP_TEST_CASE tc;
+    int n = 0, i = 0, known = 0;
+
+    if (!ring || !crypto_handler) {
+        return ACVP_MISSING_ARG;
+    }
+    hdr = ring->hdr;
+
+    pthread_mutex_lock(&hdr->lock);
+    while (!hdr->shutdown) {
+        n = 0;
+        for (i = 0; i < hdr->slot_cnt && n < ACVP_RING_TAKE_MAX; i++) {
+            slot = acvp_ring_slot(ring, i);
+            if (slot->state == ACVP_RING_READY) {
+                slot->state = ACVP_RING_BUSY;
+                taken[n++] = slot;
+            }
+        }
+        if (!n) {
+            pthread_cond_wait(&hdr->doorbell, &hdr->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&hdr->lock);
+
+        for (i = 0; i < n; i++) {
+            known = taken[i]->kind >= ACVP_TC_KIND_SYM && taken[i]->kind <= ACVP_TC_KIND_HMAC;
+            if (known) {
+                tc = acvp_ring_slot_rebuild(taken[i]);
+            }
+            taken[i]->result = known ? (crypto_handler)(&tc) : 1;
+        }
+
+        pthread_mutex_lock(&hdr->lock);
+        for (i = 0; i < n; i++) {
+            taken[i]->state = ACVP_RING_DONE;
+        }
+        pthread_cond_broadcast(&hdr->done);
+    }
+    pthread_mutex_unlock(&hdr->lock);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Copies test case k of the batch into the slot. Fails when a buffer is
+ * larger than the slot has room for.
+ */
+static int acvp_ring_fill(ACVP_RING_SLOT *slot, ACVP_TC_BATCH *batch, int k, int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    char *stc = acvp_ring_slot_tc(slot), *src = acvp_tc_layout_struct(&batch->tcs[k], kind);
+    unsigned char *buf = NULL;
+    size_t len = 0;
+    int cnt = 0, i = 0;
+
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    memcpy_s(stc, ACVP_RING_TC_MAX, src, acvp_tc_layout_size(kind));
+    for (i = 0; i < cnt; i++) {
+        if (!fields[i].dir) {
+            continue;
+        }
+        buf = *acvp_tc_layout_ptr(src, &fields[i]);
+        len = acvp_tc_layout_len(src, &fields[i]);
+        if (len > fields[i].cap) {
+            return 1;
+        }
+        if ((fields[i].dir & ACVP_TC_FIELD_IN) && buf && len) {
+            memcpy_s(acvp_ring_slot_buf(slot, fields, i), fields[i].cap, buf, len);
+        }
+    }
+    slot->kind = kind;
+    slot->index = k;
+    return 0;
+}
+
+/*
+ * Copies what the module wrote into the slot back to its test case of the
+ * batch, keeping the buffers, and group context, the test case points to
+ */
+static void acvp_ring_collect(ACVP_RING_SLOT *slot, ACVP_TC_BATCH *batch, int kind) {
+    const ACVP_TC_FIELD *fields = NULL;
+    char *stc = acvp_ring_slot_tc(slot), *dst = acvp_tc_layout_struct(&batch->tcs[slot->index], kind);
+    unsigned char *saved[ACVP_TC_FIELDS_MAX];
+    unsigned char *buf = NULL;
+    size_t len = 0;
+    int cnt = 0, i = 0;
+
+    acvp_tc_layout_fields(kind, &fields, &cnt);
+    for (i = 0; i < cnt; i++) {
+        saved[i] = *acvp_tc_layout_ptr(dst, &fields[i]);
+    }
+    memcpy_s(dst, acvp_tc_layout_size(kind), stc, acvp_tc_layout_size(kind));
+    for (i = 0; i < cnt; i++) {
+        buf = saved[i];
+        *acvp_tc_layout_ptr(dst, &fields[i]) = buf;
+        len = acvp_tc_layout_len(dst, &fields[i]);
+        if (len > fields[i].cap) len = fields[i].cap;
+        if ((fields[i].dir & ACVP_TC_FIELD_OUT) && buf && len) {
+            memcpy_s(buf, len, acvp_ring_slot_buf(slot, fields, i), len);
+        }
+    }
+    batch->results[slot->index] = slot->result;
+}
+
+/*
+ * Runs the test cases of the batch through the ring of the capability,
+ * keeping up to ring_depth of them in the slots at once, and returns once
+ * every one has come back. Other batches, from other workers, may be using
+ * the ring at the same time; each only collects the slots it filled.
+ */
+ACVP_RESULT acvp_ring_run_batch(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_RING *ring = cap->ring;
+    ACVP_RING_HDR *hdr = ring->hdr;
+    ACVP_RING_SLOT *slot = NULL, **fill = NULL, **collect = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long owner = 0;
+    int kind = 0, next = 0, in_flight = 0, left = 0, nfill = 0, ncollect = 0, i = 0, k = 0;
+
+    kind = acvp_tc_layout_kind(cap);
+    if (!kind) {
+        return ACVP_UNSUPPORTED_OP;
+    }
+
+    fill = calloc(hdr->slot_cnt, sizeof(ACVP_RING_SLOT *));
+    collect = calloc(hdr->slot_cnt, sizeof(ACVP_RING_SLOT *));
+    if (!fill || !collect) {
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+
+    /* What the ring can not carry is left for the crypto handler */
+    for (i = 0; i < batch->count; i++) {
+        if (!acvp_tc_layout_carries(&batch->tcs[i], kind)) {
+            batch->results[i] = (cap->crypto_handler)(&batch->tcs[i]);
+        } else {
+            left++;
+        }
+    }
+
+    ACVP_LOG_VERBOSE("Handing %d test cases to the crypto module through its ring, up to %d at a time",
+                     left, cap->ring_depth);
+    pthread_mutex_lock(&hdr->lock);
+    owner = hdr->next_owner++;
+    while (left) {
+        nfill = 0;
+        ncollect = 0;
+        while (!hdr->shutdown) {
+            for (i = 0; i < hdr->slot_cnt; i++) {
+                slot = acvp_ring_slot(ring, i);
+                if (slot->state == ACVP_RING_DONE && slot->owner == owner) {
+                    slot->state = ACVP_RING_COLLECTING;
+                    collect[ncollect++] = slot;
+                } else if (slot->state == ACVP_RING_FREE && rv == ACVP_SUCCESS &&
+                           in_flight + nfill < cap->ring_depth) {
+                    while (next < batch->count && !acvp_tc_layout_carries(&batch->tcs[batch->order ? batch->order[next] : next], kind)) {
+                        next++;
+                    }
+                    if (next < batch->count) {
+                        slot->state = ACVP_RING_FILLING;
+                        slot->owner = owner;
+                        slot->index = batch->order ? batch->order[next] : next;
+                        next++;
+                        fill[nfill++] = slot;
+                    }
+                }
+            }
+            if (nfill || ncollect) {
+                break;
+            }
+            pthread_cond_wait(&hdr->done, &hdr->lock);
+        }
+        if (hdr->shutdown) {
+            ACVP_LOG_ERR("The ring of the crypto module was shut down with %d test cases left", left);
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            break;
+        }
+        pthread_mutex_unlock(&hdr->lock);
+
+        /* Copies are made without the lock */
+        for (i = 0; i < ncollect; i++) {
+            acvp_ring_collect(collect[i], batch, kind);
+        }
+        for (i = 0; i < nfill; i++) {
+            k = fill[i]->index;
+            if (acvp_ring_fill(fill[i], batch, k, kind)) {
+                ACVP_LOG_ERR("Test case %d does not fit in a slot of the ring", k);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                fill[i]->index = -1;
+            }
+        }
+
+        pthread_mutex_lock(&hdr->lock);
+        for (i = 0; i < ncollect; i++) {
+            collect[i]->state = ACVP_RING_FREE;
+            collect[i]->owner = 0;
+        }
+        left -= ncollect;
+        in_flight -= ncollect;
+        for (i = 0; i < nfill; i++) {
+            if (fill[i]->index < 0) {
+                /* Did not fit, given back */
+                fill[i]->state = ACVP_RING_FREE;
+                fill[i]->owner = 0;
+            } else {
+                fill[i]->state = ACVP_RING_READY;
+                in_flight++;
+            }
+        }
+        if (rv != ACVP_SUCCESS) {
+            /* No more are filled, only what is in flight is waited for */
+            left = in_flight;
+        }
+        /* One wake up for everything filled this round */
+        if (nfill) {
+            pthread_cond_broadcast(&hdr->doorbell);
+        }
+        if (ncollect) {
+            pthread_cond_broadcast(&hdr->done);
+        }
+    }
+    pthread_mutex_unlock(&hdr->lock);
+
+end:
+    if (fill) free(fill);
+    if (collect) free(collect);
+    return rv;
+}
+
+#else
+
+ACVP_RESULT acvp_ring_create(const char *path, int slots, ACVP_RING **ring) {
+    (void)path;
+    (void)slots;
+    (void)ring;
+    return ACVP_UNSUPPORTED_OP;
+}
+
+ACVP_RESULT acvp_ring_open(const char *path, ACVP_RING **ring) {
+    (void)path;
+    (void)ring;
+    return ACVP_UNSUPPORTED_OP;
+}
+
+ACVP_RESULT acvp_ring_serve(ACVP_RING *ring, int (*crypto_handler)(ACVP_TEST_CASE *test_case)) {
+    (void)ring;
+    (void)crypto_handler;
+    return ACVP_UNSUPPORTED_OP;
+}
+
+ACVP_RESULT acvp_ring_close(ACVP_RING *ring) {
+    (void)ring;
+    return ACVP_UNSUPPORTED_OP;
+}
+
+ACVP_RESULT acvp_ring_run_batch(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    (void)ctx;
+    (void)cap;
+    (void)batch;
+    return ACVP_UNSUPPORTED_OP;
+}
+
+#endif
@@ -17,6 +17,15 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+static ACVP_RESULT acvp_rsa_keygen_run_batch(ACVP_CTX *ctx,
+                                             ACVP_CAPS_LIST *cap,
+                                             ACVP_TC_BATCH *batch,
+                                             JSON_Array *r_tarr);
+
+static void acvp_rsa_keygen_release_batch(ACVP_RSA_KEYGEN_TC **stcs,
+                                          ACVP_TC_CONTROL **controls,
+                                          ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -25,106 +34,78 @@
  */
 static ACVP_RESULT acvp_rsa_output_tc(ACVP_CTX *ctx, ACVP_RSA_KEYGEN_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
     if ((stc->rand_pq == ACVP_RSA_KEYGEN_B33 || stc->rand_pq == ACVP_RSA_KEYGEN_PROBABLE) && stc->test_type == ACVP_RSA_TESTTYPE_KAT) {
         json_object_set_boolean(tc_rsp, "testPassed", stc->test_disposition);
         goto err;
     }
 
-    tmp = calloc(ACVP_RSA_EXP_LEN_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_kdf135 tpm_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
-
-    rv = acvp_bin_to_hexstr(stc->p, stc->p_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "p", stc->p, stc->p_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (p)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "p", (const char *)tmp);
-    memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->q, stc->q_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "q", stc->q, stc->q_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (q)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "q", (const char *)tmp);
-    memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->n, stc->n_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "n", stc->n, stc->n_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (n)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "n", (const char *)tmp);
-    memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->d, stc->d_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "d", stc->d, stc->d_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (d)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "d", (const char *)tmp);
-    memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->e, stc->e_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "e", stc->e, stc->e_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (e)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "e", (const char *)tmp);
 
     if (stc->rand_pq == ACVP_RSA_KEYGEN_B36 || stc->rand_pq == ACVP_RSA_KEYGEN_PROB_W_PROB_AUX) {
-        rv = acvp_bin_to_hexstr(stc->xp, stc->xp_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "xP", stc->xp, stc->xp_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (xp)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "xP", (const char *)tmp);
-        memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->xp1, stc->xp1_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "xP1", stc->xp1, stc->xp1_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (xp1)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "xP1", (const char *)tmp);
-        memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->xp2, stc->xp2_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "xP2", stc->xp2, stc->xp2_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (xp2)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "xP2", (const char *)tmp);
-        memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->xq, stc->xq_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "xQ", stc->xq, stc->xq_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (xq)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "xQ", (const char *)tmp);
-        memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->xq1, stc->xq1_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "xQ1", stc->xq1, stc->xq1_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (xq1)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "xQ1", (const char *)tmp);
-        memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-        rv = acvp_bin_to_hexstr(stc->xq2, stc->xq2_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "xQ2", stc->xq2, stc->xq2_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (xq2)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "xQ2", (const char *)tmp);
-        memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
     }
 
     if (stc->info_gen_by_server) {
@@ -138,13 +119,11 @@ static ACVP_RESULT acvp_rsa_output_tc(ACVP_CTX *ctx, ACVP_RSA_KEYGEN_TC *stc, JS
         }
     } else {
         if (!(stc->rand_pq == ACVP_RSA_KEYGEN_B33 || stc->rand_pq == ACVP_RSA_KEYGEN_PROBABLE)) {
-            rv = acvp_bin_to_hexstr(stc->seed, stc->seed_len, tmp, ACVP_RSA_SEEDLEN_MAX);
+            rv = acvp_json_set_hex(tc_rsp, "seed", stc->seed, stc->seed_len, ACVP_RSA_SEEDLEN_MAX);
             if (rv != ACVP_SUCCESS) {
                 ACVP_LOG_ERR("hex conversion failure (seed)");
                 goto err;
             }
-            json_object_set_string(tc_rsp, "seed", (const char *)tmp);
-            memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
         }
     }
 
@@ -158,7 +137,6 @@ static ACVP_RESULT acvp_rsa_output_tc(ACVP_CTX *ctx, ACVP_RSA_KEYGEN_TC *stc, JS
     }
 
 err:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -393,11 +371,14 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_RSA_KEYGEN_TC stc;
+    ACVP_RSA_KEYGEN_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
     ACVP_TEST_CASE tc;
+    ACVP_TC_BATCH batch;
+    ACVP_TC_CONTROL control, *controls = NULL; /* Progress of the test case, of each in a batched group */
+    int use_batch = 0;
     ACVP_RESULT rv;
 
     ACVP_CIPHER alg_id;
-    char *json_result = NULL;
     unsigned int mod = 0;
     int info_gen_by_server, rand_pq, seed_len = 0;
     ACVP_HASH_ALG hash_alg = 0;
@@ -437,6 +418,7 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     tc.tc.rsa_keygen = &stc;
     memzero_s(&stc, sizeof(ACVP_RSA_KEYGEN_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     cap = acvp_locate_cap_entry(ctx, alg_id);
     if (!cap) {
@@ -456,7 +438,7 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -477,15 +459,15 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         test_type_str = json_object_get_string(groupobj, "testType");
         if (!test_type_str) {
@@ -612,11 +594,30 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Every test case generates its own key, so when parallel test
+         * cases were asked for the group is set up in one piece and then
+         * run together
+         */
+        use_batch = acvp_tc_batch_enabled(ctx, cap) && t_cnt > 0;
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_RSA_KEYGEN_TC));
+            controls = calloc(t_cnt, sizeof(ACVP_TC_CONTROL));
+            if (!stcs || !controls) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new RSA test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             ACVP_LOG_VERBOSE("        Test case: %d", j);
             ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
@@ -786,14 +787,29 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 }
             }
 
-            rv = acvp_rsa_keygen_init_tc(ctx, &stc, tc_id, test_type, info_gen_by_server, hash_alg, 
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_rsa_keygen_init_tc(ctx, cur, tc_id, test_type, info_gen_by_server, hash_alg, 
                                          key_format, pub_exp_mode, mod, prime_test, rand_pq, e_str,
                                          p_str, q_str, xp_str, xp1_str, xp2_str, xq_str, xq1_str, 
                                          xq2_str, seed, seed_len, bitlen1, bitlen2, bitlen3, bitlen4);
 
+            if (use_batch) {
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Init for test case %d failed", tc_id);
+                    acvp_rsa_keygen_release_tc(cur);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                /* Processed with the rest of the group below */
+                cur->control = acvp_tc_control_begin(ctx, &controls[j], alg_id, tgId, tc_id);
+                acvp_tc_batch_add(&batch, r_tval)->tc.rsa_keygen = cur;
+                continue;
+            }
+
             /* Process the current test vector... */
             if (rv == ACVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                stc.control = acvp_tc_control_begin(ctx, &control, alg_id, tgId, tc_id);
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -819,20 +835,83 @@ ACVP_RESULT acvp_rsa_keygen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        if (use_batch) {
+            rv = acvp_rsa_keygen_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_rsa_keygen_release_batch(&stcs, &controls, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_rsa_keygen_release_batch(&stcs, &controls, &batch);
     if (rv != ACVP_SUCCESS) {
         acvp_rsa_keygen_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_rsa_keygen_run_batch(ACVP_CTX *ctx,
+                                             ACVP_CAPS_LIST *cap,
+                                             ACVP_TC_BATCH *batch,
+                                             JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_rsa_output_tc(ctx, batch->tcs[i].tc.rsa_keygen, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in RSA keygen module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group and their controls along with
+ * the batch itself
+ */
+static void acvp_rsa_keygen_release_batch(ACVP_RSA_KEYGEN_TC **stcs,
+                                          ACVP_TC_CONTROL **controls,
+                                          ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_rsa_keygen_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    if (*controls) {
+        free(*controls);
+        *controls = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
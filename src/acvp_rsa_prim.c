@@ -17,6 +17,13 @@
 #include "parson.h"
 #include "safe_lib.h"
 
+static ACVP_RESULT acvp_rsa_prim_run_batch(ACVP_CTX *ctx,
+                                           ACVP_CAPS_LIST *cap,
+                                           ACVP_TC_BATCH *batch,
+                                           JSON_Array *r_tarr);
+
+static void acvp_rsa_prim_release_batch(ACVP_CIPHER cipher, ACVP_RSA_PRIM_TC **stcs, ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -25,93 +32,62 @@
  */
 static ACVP_RESULT acvp_rsa_decprim_output_tc_rev_1(ACVP_CTX *ctx, ACVP_RSA_PRIM_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_RSA_EXP_LEN_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_rsa_decprim tpm_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
-    rv = acvp_bin_to_hexstr(stc->e, stc->e_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "e", stc->e, stc->e_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (p)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "e", (const char *)tmp);
-    memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-    rv = acvp_bin_to_hexstr(stc->n, stc->n_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+    rv = acvp_json_set_hex(tc_rsp, "n", stc->n, stc->n_len, ACVP_RSA_EXP_LEN_MAX);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("hex conversion failure (q)");
         goto err;
     }
-    json_object_set_string(tc_rsp, "n", (const char *)tmp);
-    memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
     json_object_set_boolean(tc_rsp, "testPassed", stc->disposition);
 
     if (stc->disposition) {
-        rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "plainText", stc->pt, stc->pt_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (q)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "plainText", (const char *)tmp);
     }
 err:
-    if (tmp) free(tmp);
     return rv;
 }
 
 static ACVP_RESULT acvp_rsa_decprim_output_tc_rev_56br2(ACVP_CTX *ctx, ACVP_RSA_PRIM_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_RSA_EXP_LEN_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_rsa_decprim tpm_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     json_object_set_boolean(tc_rsp, "testPassed", stc->disposition);
     if (stc->disposition) {
-        rv = acvp_bin_to_hexstr(stc->pt, stc->pt_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "pt", stc->pt, stc->pt_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (pt)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "pt", (const char *)tmp);
     }
 err:
-    if (tmp) free(tmp);
     return rv;
 }
 
 static ACVP_RESULT acvp_rsa_sigprim_output_tc(ACVP_CTX *ctx, ACVP_RSA_PRIM_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
-
-    tmp = calloc(ACVP_RSA_EXP_LEN_MAX + 1, sizeof(char));
-    if (!tmp) {
-        ACVP_LOG_ERR("Unable to malloc in acvp_rsa_decprim tpm_output_tc");
-        return ACVP_MALLOC_FAIL;
-    }
 
     if (stc->disposition) {
-        rv = acvp_bin_to_hexstr(stc->signature, stc->sig_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "signature", stc->signature, stc->sig_len, ACVP_RSA_EXP_LEN_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (q)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "signature", (const char *)tmp);
         json_object_set_boolean(tc_rsp, "testPassed", stc->disposition);
     } else {
         json_object_set_boolean(tc_rsp, "testPassed", stc->disposition);
     }
 
 err:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -128,6 +104,15 @@ static ACVP_RESULT acvp_rsa_decprim_release_tc(ACVP_RSA_PRIM_TC *stc) {
     if (stc->iqmp) { free(stc->iqmp); }
     if (stc->dmp1) { free(stc->dmp1); }
     if (stc->dmq1) { free(stc->dmq1); }
+    acvp_bn_free(&stc->cipher_bn);
+    acvp_bn_free(&stc->n_bn);
+    acvp_bn_free(&stc->e_bn);
+    acvp_bn_free(&stc->d_bn);
+    acvp_bn_free(&stc->p_bn);
+    acvp_bn_free(&stc->q_bn);
+    acvp_bn_free(&stc->dmp1_bn);
+    acvp_bn_free(&stc->dmq1_bn);
+    acvp_bn_free(&stc->iqmp_bn);
     memzero_s(stc, sizeof(ACVP_RSA_PRIM_TC));
 
     return ACVP_SUCCESS;
@@ -145,6 +130,15 @@ static ACVP_RESULT acvp_rsa_sigprim_release_tc(ACVP_RSA_PRIM_TC *stc) {
     if (stc->pt) { free(stc->pt); }
     if (stc->msg) { free(stc->msg); }
     if (stc->signature) { free(stc->signature); }
+    acvp_bn_free(&stc->cipher_bn);
+    acvp_bn_free(&stc->n_bn);
+    acvp_bn_free(&stc->e_bn);
+    acvp_bn_free(&stc->d_bn);
+    acvp_bn_free(&stc->p_bn);
+    acvp_bn_free(&stc->q_bn);
+    acvp_bn_free(&stc->dmp1_bn);
+    acvp_bn_free(&stc->dmq1_bn);
+    acvp_bn_free(&stc->iqmp_bn);
     memzero_s(stc, sizeof(ACVP_RSA_PRIM_TC));
 
     return ACVP_SUCCESS;
@@ -157,7 +151,8 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_1(ACVP_CTX *ctx,
                                             int pass,
                                             int fail,
                                             const char *cipher,
-                                            int cipher_len) {
+                                            int cipher_len,
+                                            int limbs) {
 
     ACVP_RESULT rv = ACVP_SUCCESS;
 
@@ -169,7 +164,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_1(ACVP_CTX *ctx,
     stc->cipher_len = cipher_len;
     stc->cipher = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->cipher) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(cipher, stc->cipher, ACVP_RSA_EXP_BYTE_MAX, &(stc->cipher_len));
+    rv = acvp_hexstr_to_num(limbs, cipher, stc->cipher, ACVP_RSA_EXP_BYTE_MAX, &(stc->cipher_len), &stc->cipher_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (cipher)");
         return rv;
@@ -199,7 +194,8 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
                                                       const char *dmp1,
                                                       const char *dmq1,
                                                       const char *iqmp,
-                                                      const char *ct) {
+                                                      const char *ct,
+                                                      int limbs) {
     ACVP_RESULT rv = ACVP_SUCCESS;
 
     memzero_s(stc, sizeof(ACVP_RSA_PRIM_TC));
@@ -214,7 +210,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
 
     stc->cipher = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->cipher) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(ct, stc->cipher, ACVP_RSA_EXP_BYTE_MAX, &(stc->cipher_len));
+    rv = acvp_hexstr_to_num(limbs, ct, stc->cipher, ACVP_RSA_EXP_BYTE_MAX, &(stc->cipher_len), &stc->cipher_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (cipher)");
         return rv;
@@ -223,7 +219,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
 
     stc->n = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->n) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(n, stc->n, ACVP_RSA_EXP_BYTE_MAX, &(stc->n_len));
+    rv = acvp_hexstr_to_num(limbs, n, stc->n, ACVP_RSA_EXP_BYTE_MAX, &(stc->n_len), &stc->n_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (n)");
         return rv;
@@ -231,7 +227,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
 
     stc->e = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->e) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(e, stc->e, ACVP_RSA_EXP_BYTE_MAX, &(stc->e_len));
+    rv = acvp_hexstr_to_num(limbs, e, stc->e, ACVP_RSA_EXP_BYTE_MAX, &(stc->e_len), &stc->e_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (e)");
         return rv;
@@ -239,7 +235,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
 
     stc->d = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->d) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(d, stc->d, ACVP_RSA_EXP_BYTE_MAX, &(stc->d_len));
+    rv = acvp_hexstr_to_num(limbs, d, stc->d, ACVP_RSA_EXP_BYTE_MAX, &(stc->d_len), &stc->d_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (d)");
         return rv;
@@ -247,7 +243,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
 
     stc->p = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->p) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(p, stc->p, ACVP_RSA_EXP_BYTE_MAX, &(stc->p_len));
+    rv = acvp_hexstr_to_num(limbs, p, stc->p, ACVP_RSA_EXP_BYTE_MAX, &(stc->p_len), &stc->p_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (p)");
         return rv;
@@ -255,7 +251,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
 
     stc->q = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->q) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(q, stc->q, ACVP_RSA_EXP_BYTE_MAX, &(stc->q_len));
+    rv = acvp_hexstr_to_num(limbs, q, stc->q, ACVP_RSA_EXP_BYTE_MAX, &(stc->q_len), &stc->q_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (q");
         return rv;
@@ -264,7 +260,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
     if (dmp1) {
         stc->dmp1 = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->dmp1) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(dmp1, stc->dmp1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmp1_len));
+        rv = acvp_hexstr_to_num(limbs, dmp1, stc->dmp1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmp1_len), &stc->dmp1_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dmp1)");
             return rv;
@@ -274,7 +270,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
     if (dmq1) {
         stc->dmq1 = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->dmq1) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(dmq1, stc->dmq1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmq1_len));
+        rv = acvp_hexstr_to_num(limbs, dmq1, stc->dmq1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmq1_len), &stc->dmq1_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dmq1)");
             return rv;
@@ -284,7 +280,7 @@ static ACVP_RESULT acvp_rsa_decprim_init_tc_rev_56br2(ACVP_CTX *ctx,
     if (iqmp) {
         stc->iqmp = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->iqmp) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(iqmp, stc->iqmp, ACVP_RSA_EXP_BYTE_MAX, &(stc->iqmp_len));
+        rv = acvp_hexstr_to_num(limbs, iqmp, stc->iqmp, ACVP_RSA_EXP_BYTE_MAX, &(stc->iqmp_len), &stc->iqmp_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (iqmp)");
             return rv;
@@ -306,7 +302,8 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
                                             const char *dmp1_str,
                                             const char *dmq1_str,
                                             const char *iqmp_str,
-                                            const char *msg) {
+                                            const char *msg,
+                                            int limbs) {
 
     ACVP_RESULT rv = ACVP_SUCCESS;
 
@@ -314,7 +311,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
 
     stc->e = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->e) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(e_str, stc->e, ACVP_RSA_EXP_BYTE_MAX, &(stc->e_len));
+    rv = acvp_hexstr_to_num(limbs, e_str, stc->e, ACVP_RSA_EXP_BYTE_MAX, &(stc->e_len), &stc->e_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (e)");
         return rv;
@@ -323,7 +320,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
     if (d_str) {
         stc->d = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->d) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(d_str, stc->d, ACVP_RSA_EXP_BYTE_MAX, &(stc->d_len));
+        rv = acvp_hexstr_to_num(limbs, d_str, stc->d, ACVP_RSA_EXP_BYTE_MAX, &(stc->d_len), &stc->d_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (d)");
             return rv;
@@ -332,7 +329,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
 
     stc->n = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->n) { return ACVP_MALLOC_FAIL; }
-    rv = acvp_hexstr_to_bin(n_str, stc->n, ACVP_RSA_EXP_BYTE_MAX, &(stc->n_len));
+    rv = acvp_hexstr_to_num(limbs, n_str, stc->n, ACVP_RSA_EXP_BYTE_MAX, &(stc->n_len), &stc->n_bn);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Hex conversion failure (n)");
         return rv;
@@ -341,7 +338,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
     if (p_str) {
         stc->p = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->p) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(p_str, stc->p, ACVP_RSA_EXP_BYTE_MAX, &(stc->p_len));
+        rv = acvp_hexstr_to_num(limbs, p_str, stc->p, ACVP_RSA_EXP_BYTE_MAX, &(stc->p_len), &stc->p_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (p)");
             return rv;
@@ -351,7 +348,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
     if (q_str) {
         stc->q = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->q) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(q_str, stc->q, ACVP_RSA_EXP_BYTE_MAX, &(stc->q_len));
+        rv = acvp_hexstr_to_num(limbs, q_str, stc->q, ACVP_RSA_EXP_BYTE_MAX, &(stc->q_len), &stc->q_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (q");
             return rv;
@@ -361,7 +358,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
     if (dmp1_str) {
         stc->dmp1 = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->dmp1) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(dmp1_str, stc->dmp1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmp1_len));
+        rv = acvp_hexstr_to_num(limbs, dmp1_str, stc->dmp1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmp1_len), &stc->dmp1_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dmp1)");
             return rv;
@@ -371,7 +368,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
     if (dmq1_str) {
         stc->dmq1 = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->dmq1) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(dmq1_str, stc->dmq1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmq1_len));
+        rv = acvp_hexstr_to_num(limbs, dmq1_str, stc->dmq1, ACVP_RSA_EXP_BYTE_MAX, &(stc->dmq1_len), &stc->dmq1_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (dmq1)");
             return rv;
@@ -381,7 +378,7 @@ static ACVP_RESULT acvp_rsa_sigprim_init_tc(ACVP_CTX *ctx,
     if (iqmp_str) {
         stc->iqmp = calloc(ACVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->iqmp) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(iqmp_str, stc->iqmp, ACVP_RSA_EXP_BYTE_MAX, &(stc->iqmp_len));
+        rv = acvp_hexstr_to_num(limbs, iqmp_str, stc->iqmp, ACVP_RSA_EXP_BYTE_MAX, &(stc->iqmp_len), &stc->iqmp_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (iqmp)");
             return rv;
@@ -445,12 +442,14 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL, *r_cobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_RSA_PRIM_TC stc;
+    ACVP_RSA_PRIM_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
     ACVP_TEST_CASE tc;
+    ACVP_TC_BATCH batch;
     ACVP_RESULT rv;
+    int use_batch = 0;
 
     ACVP_CIPHER alg_id;
     ACVP_RSA_PUB_EXP_MODE pub_exp_mode = 0;
-    char *json_result = NULL;
     unsigned int mod = 0, total = 0, fail = 0, pass = 0;
     const char *alg_str = NULL, *mode_str = NULL, *cipher = NULL, *rev_str = NULL, *key_format = NULL, *pub_exp_mode_str = NULL,
                *e_str = NULL, *n_str = NULL, *d_str = NULL, *p_str = NULL, *q_str = NULL,
@@ -493,6 +492,7 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     tc.tc.rsa_prim = &stc;
     memzero_s(&stc, sizeof(ACVP_RSA_PRIM_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     cap = acvp_locate_cap_entry(ctx, alg_id);
     if (!cap) {
@@ -512,7 +512,7 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -533,15 +533,15 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
         if (old_rev) {
             mod = json_object_get_number(groupobj, "modulo");
             if (mod != 2048) {
@@ -613,11 +613,31 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Each test case of the newer revision carries its own key and
+         * ciphertext and is independent of the others, so the group can be
+         * set up in one piece and then run together. The 1.0 revision keeps
+         * going until the module has produced the requested number of
+         * passing and failing cases, which has to be done one at a time.
+         */
+        use_batch = !old_rev && t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_RSA_PRIM_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new RSA test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
 
             ACVP_LOG_VERBOSE("        Test case: %d", j);
             ACVP_LOG_VERBOSE("             tcId: %d", tc_id);
@@ -672,12 +692,13 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                         goto err;
                     }
 
-                    rv = acvp_rsa_decprim_init_tc_rev_1(ctx, &stc, mod, deferred, pass, fail, cipher, cipher_len);
+                    rv = acvp_rsa_decprim_init_tc_rev_1(ctx, &stc, mod, deferred, pass, fail, cipher, cipher_len,
+                                                         acvp_bn_limbs_enabled(cap));
                     if (rv == ACVP_SUCCESS) {
                        fail = stc.fail;
                        pass = stc.pass;
                        do {
-                           if ((cap->crypto_handler)(&tc)) {
+                           if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                                ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                                rv = ACVP_CRYPTO_MODULE_FAIL;
                                json_value_free(r_tval);
@@ -753,10 +774,23 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                     goto err;
                 }
 
-                rv = acvp_rsa_decprim_init_tc_rev_56br2(ctx, &stc, keyformat, mod, keyformat, d_str, e_str, n_str, p_str,
-                                                        q_str, dmp1_str, dmq1_str, iqmp_str, cipher);
+                cur = use_batch ? &stcs[j] : &stc;
+                rv = acvp_rsa_decprim_init_tc_rev_56br2(ctx, cur, keyformat, mod, keyformat, d_str, e_str, n_str, p_str,
+                                                        q_str, dmp1_str, dmq1_str, iqmp_str, cipher,
+                                                        acvp_bn_limbs_enabled(cap));
+                if (use_batch) {
+                    if (rv != ACVP_SUCCESS) {
+                        ACVP_LOG_ERR("Failed to initialize RSA decryption primitive test case");
+                        acvp_rsa_decprim_release_tc(cur);
+                        json_value_free(r_tval);
+                        goto err;
+                    }
+                    /* Run with the rest of the group below */
+                    acvp_tc_batch_add(&batch, r_tval)->tc.rsa_prim = cur;
+                    continue;
+                }
                 if (rv == ACVP_SUCCESS) {
-                    if ((cap->crypto_handler)(&tc)) {
+                    if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                         ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                         rv = ACVP_CRYPTO_MODULE_FAIL;
                         json_value_free(r_tval);
@@ -779,16 +813,22 @@ ACVP_RESULT acvp_rsa_decprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_rsa_prim_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_rsa_prim_release_batch(alg_id, &stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_rsa_prim_release_batch(alg_id, &stcs, &batch);
     if (rv != ACVP_SUCCESS) {
         acvp_rsa_decprim_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
@@ -819,13 +859,14 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
     ACVP_RSA_PRIM_TC stc;
+    ACVP_RSA_PRIM_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
     ACVP_TEST_CASE tc;
-    int old_rev = 0;
+    ACVP_TC_BATCH batch;
+    int old_rev = 0, use_batch = 0;
     unsigned int mod = 0;
     unsigned int keyformat = 0;
     const char *key_format = NULL;
     ACVP_CIPHER alg_id;
-    char *json_result = NULL;
     const char *mode_str;
     const char *msg;
     const char *e_str = NULL, *n_str = NULL, *d_str = NULL, *p_str = NULL, *q_str = NULL,
@@ -877,6 +918,7 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
 
     tc.tc.rsa_prim = &stc;
     memzero_s(&stc, sizeof(ACVP_RSA_PRIM_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     /*
      * Create ACVP array for response
@@ -890,7 +932,7 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -911,7 +953,8 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
@@ -956,8 +999,7 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         }
 
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         ACVP_LOG_VERBOSE("       Test Group: %d", i);
         ACVP_LOG_VERBOSE("       Key Format: %s", key_format);
@@ -966,11 +1008,29 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Each test case carries its own key and message and is independent
+         * of the others, so the group can be set up in one piece and then
+         * signed together
+         */
+        use_batch = t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_RSA_PRIM_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new RSA test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Missing tc_id");
                 rv = ACVP_MALFORMED_JSON;
@@ -1058,12 +1118,25 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             }
             ACVP_LOG_VERBOSE("              msg: %s", msg);
 
-            rv = acvp_rsa_sigprim_init_tc(ctx, &stc, mod, keyformat, d_str, e_str, n_str, p_str,
-                                          q_str, dmp1_str, dmq1_str, iqmp_str, msg);
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_rsa_sigprim_init_tc(ctx, cur, mod, keyformat, d_str, e_str, n_str, p_str,
+                                          q_str, dmp1_str, dmq1_str, iqmp_str, msg,
+                                          acvp_bn_limbs_enabled(cap));
+            if (use_batch) {
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to initialize RSA signature primitive test case");
+                    acvp_rsa_sigprim_release_tc(cur);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                /* Signed with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.rsa_prim = cur;
+                continue;
+            }
 
             /* Process the current test vector... */
             if (rv == ACVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -1089,17 +1162,23 @@ ACVP_RESULT acvp_rsa_sigprim_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_rsa_prim_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_rsa_prim_release_batch(alg_id, &stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_rsa_prim_release_batch(alg_id, &stcs, &batch);
     if (rv != ACVP_SUCCESS) {
         acvp_rsa_sigprim_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
@@ -1107,3 +1186,62 @@ err:
     return rv;
 }
 
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_rsa_prim_run_batch(ACVP_CTX *ctx,
+                                           ACVP_CAPS_LIST *cap,
+                                           ACVP_TC_BATCH *batch,
+                                           JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    rv = acvp_tc_batch_run(ctx, cap, batch);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        if (cap->cipher == ACVP_RSA_DECPRIM) {
+            rv = acvp_rsa_decprim_output_tc_rev_56br2(ctx, batch->tcs[i].tc.rsa_prim,
+                                                      json_value_get_object(batch->rsp[i]));
+        } else {
+            rv = acvp_rsa_sigprim_output_tc(ctx, batch->tcs[i].tc.rsa_prim,
+                                            json_value_get_object(batch->rsp[i]));
+        }
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in primitive module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_rsa_prim_release_batch(ACVP_CIPHER cipher, ACVP_RSA_PRIM_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            if (cipher == ACVP_RSA_DECPRIM) {
+                acvp_rsa_decprim_release_tc(&(*stcs)[i]);
+            } else {
+                acvp_rsa_sigprim_release_tc(&(*stcs)[i]);
+            }
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
+
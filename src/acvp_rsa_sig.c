@@ -19,6 +19,15 @@
 
 static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object *obj, ACVP_CIPHER cipher);
 
+static ACVP_RESULT acvp_rsa_sig_run_batch(ACVP_CTX *ctx,
+                                          ACVP_CAPS_LIST *cap,
+                                          ACVP_TC_BATCH *batch,
+                                          JSON_Array *r_tarr);
+
+static void acvp_rsa_sig_release_batch(ACVP_RSA_SIG_TC **stcs, ACVP_TC_BATCH *batch);
+
+static ACVP_RESULT acvp_rsa_sigver_run_soa(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch);
+
 /*
  * After the test case has been processed by the DUT, the results
  * need to be JSON formated to be included in the vector set results
@@ -27,26 +36,18 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
  */
 static ACVP_RESULT acvp_rsa_sig_output_tc(ACVP_CTX *ctx, ACVP_RSA_SIG_TC *stc, JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
     if (stc->sig_mode == ACVP_RSA_SIGVER) {
         json_object_set_boolean(tc_rsp, "testPassed", stc->ver_disposition);
     } else {
-        tmp = calloc(ACVP_RSA_SIGNATURE_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in rsa_sigver tpm_output_tc");
-            return ACVP_MALLOC_FAIL;
-        }
-        rv = acvp_bin_to_hexstr(stc->signature, stc->sig_len, tmp, ACVP_RSA_SIGNATURE_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "signature", stc->signature, stc->sig_len, ACVP_RSA_SIGNATURE_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (signature)");
             goto err;
         }
-        json_object_set_string(tc_rsp, "signature", (const char *)tmp);
     }
 
 err:
-    if (tmp) free(tmp);
     return rv;
 }
 
@@ -61,6 +62,9 @@ static ACVP_RESULT acvp_rsa_siggen_release_tc(ACVP_RSA_SIG_TC *stc) {
     if (stc->n) { free(stc->n); }
     if (stc->signature) { free(stc->signature); }
     if (stc->salt) { free(stc->salt); }
+    acvp_bn_free(&stc->e_bn);
+    acvp_bn_free(&stc->n_bn);
+    acvp_bn_free(&stc->sig_bn);
     memzero_s(stc, sizeof(ACVP_RSA_SIG_TC));
     return ACVP_SUCCESS;
 }
@@ -79,7 +83,8 @@ static ACVP_RESULT acvp_rsa_sig_init_tc(ACVP_CTX *ctx,
                                         const char *msg,
                                         char *signature,
                                         const char *salt,
-                                        int salt_len) {
+                                        int salt_len,
+                                        int limbs) {
     ACVP_RESULT rv;
 
     memzero_s(stc, sizeof(ACVP_RSA_SIG_TC));
@@ -104,17 +109,17 @@ static ACVP_RESULT acvp_rsa_sig_init_tc(ACVP_CTX *ctx,
 
     if (cipher == ACVP_RSA_SIGVER) {
         stc->sig_mode = ACVP_RSA_SIGVER;
-        rv = acvp_hexstr_to_bin(e, stc->e, ACVP_RSA_EXP_LEN_MAX, &(stc->e_len));
+        rv = acvp_hexstr_to_num(limbs, e, stc->e, ACVP_RSA_EXP_LEN_MAX, &(stc->e_len), &stc->e_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (e)");
             return rv;
         }
-        rv = acvp_hexstr_to_bin(n, stc->n, ACVP_RSA_EXP_LEN_MAX, &(stc->n_len));
+        rv = acvp_hexstr_to_num(limbs, n, stc->n, ACVP_RSA_EXP_LEN_MAX, &(stc->n_len), &stc->n_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (n)");
             return rv;
         }
-        rv = acvp_hexstr_to_bin(signature, stc->signature, ACVP_RSA_SIGNATURE_MAX, &stc->sig_len);
+        rv = acvp_hexstr_to_num(limbs, signature, stc->signature, ACVP_RSA_SIGNATURE_MAX, &(stc->sig_len), &stc->sig_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (signature)");
             return rv;
@@ -146,6 +151,54 @@ err:
     return ACVP_MALLOC_FAIL;
 }
 
+/*
+ * Sets up what the test cases of a group have in common for the group
+ * handler. For SigVer this includes the group's public key (e, n).
+ */
+static ACVP_RESULT acvp_rsa_sig_init_group(ACVP_CTX *ctx,
+                                           ACVP_CIPHER cipher,
+                                           ACVP_RSA_SIG_TC *group,
+                                           int tgId,
+                                           ACVP_RSA_SIG_TYPE sig_type,
+                                           ACVP_RSA_MASK_FUNCTION mask,
+                                           unsigned int mod,
+                                           ACVP_HASH_ALG hash_alg,
+                                           int salt_len,
+                                           const char *e,
+                                           const char *n) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    memzero_s(group, sizeof(ACVP_RSA_SIG_TC));
+    group->sig_mode = cipher;
+    group->tg_id = tgId;
+    group->sig_type = sig_type;
+    group->mask = mask;
+    group->modulo = mod;
+    group->hash_alg = hash_alg;
+    group->salt_len = salt_len;
+
+    if (cipher != ACVP_RSA_SIGVER) {
+        return ACVP_SUCCESS;
+    }
+
+    group->e = calloc(ACVP_RSA_EXP_LEN_MAX, sizeof(char));
+    if (!group->e) { return ACVP_MALLOC_FAIL; }
+    group->n = calloc(ACVP_RSA_EXP_LEN_MAX, sizeof(char));
+    if (!group->n) { return ACVP_MALLOC_FAIL; }
+
+    rv = acvp_hexstr_to_bin(e, group->e, ACVP_RSA_EXP_LEN_MAX, &(group->e_len));
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Hex conversion failure (e)");
+        return rv;
+    }
+    rv = acvp_hexstr_to_bin(n, group->n, ACVP_RSA_EXP_LEN_MAX, &(group->n_len));
+    if (rv != ACVP_SUCCESS) {
+        ACVP_LOG_ERR("Hex conversion failure (n)");
+        return rv;
+    }
+    return ACVP_SUCCESS;
+}
+
 ACVP_RESULT acvp_rsa_siggen_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     return acvp_rsa_sig_kat_handler_internal(ctx, obj, ACVP_RSA_SIGGEN);
 }
@@ -210,11 +263,13 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     ACVP_CAPS_LIST *cap;
-    ACVP_RSA_SIG_TC stc;
-    ACVP_TEST_CASE tc;
+    ACVP_RSA_SIG_TC stc, group_stc;
+    ACVP_RSA_SIG_TC *cur = NULL, *stcs = NULL; /* Test case being set up, all of a batched group */
+    ACVP_TEST_CASE tc, group_tc;
+    ACVP_TC_BATCH batch;
+    int group_open = 0, use_batch = 0;
 
     ACVP_CIPHER alg_id;
-    char *json_result = NULL;
     const char *mode_str;
     unsigned int mod = 0, padding = 0;
     const char *msg,  *tmp_signature = NULL;
@@ -259,6 +314,9 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
     tc.tc.rsa_sig = &stc;
     memzero_s(&stc, sizeof(ACVP_RSA_SIG_TC));
     stc.sig_mode = alg_id;
+    group_tc.tc.rsa_sig = &group_stc;
+    memzero_s(&group_stc, sizeof(ACVP_RSA_SIG_TC));
+    memzero_s(&batch, sizeof(ACVP_TC_BATCH));
 
     cap = acvp_locate_cap_entry(ctx, alg_id);
     if (!cap) {
@@ -280,7 +338,7 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -305,15 +363,15 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tgId = json_object_get_number(groupobj, "tgId");
+        tgId = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tgId);
         if (!tgId) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MALFORMED_JSON;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tgId);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         /*
          * Get a reference to the abstracted test case
@@ -401,11 +459,49 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
+        /*
+         * Let the crypto module set up what the tests of this group share,
+         * such as the SigGen key or the SigVer public key
+         */
+        if (cap->group_handler) {
+            rv = acvp_rsa_sig_init_group(ctx, alg_id, &group_stc, tgId, sig_type, mask,
+                                         mod, hash_alg, salt_len, e_str, n_str);
+            if (rv != ACVP_SUCCESS) {
+                ACVP_LOG_ERR("Failed to initialize RSA test group");
+                goto err;
+            }
+            if ((cap->group_handler)(&group_tc, ACVP_TG_BEGIN)) {
+                ACVP_LOG_ERR("crypto module failed to set up test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+            group_open = 1;
+        }
+
+        /*
+         * SigVer test cases of a group all verify against the same public
+         * key and are independent of each other, so the group can be set
+         * up in one piece and then verified together. Each test case keeps
+         * its own buffers.
+         */
+        use_batch = alg_id == ACVP_RSA_SIGVER && t_cnt && acvp_tc_batch_enabled(ctx, cap);
+        if (use_batch) {
+            stcs = calloc(t_cnt, sizeof(ACVP_RSA_SIG_TC));
+            if (!stcs) {
+                rv = ACVP_MALLOC_FAIL;
+                goto err;
+            }
+            rv = acvp_tc_batch_init(&batch, t_cnt);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+
         for (j = 0; j < t_cnt; j++) {
             ACVP_LOG_VERBOSE("Found new RSA test vector...");
             testval = json_array_get_value(tests, j);
             testobj = json_value_get_object(testval);
-            tc_id = json_object_get_number(testobj, "tcId");
+            tc_id = json_object_get_uint(testobj, "tcId");
             if (!tc_id) {
                 ACVP_LOG_ERR("Missing tc_id");
                 rv = ACVP_MALFORMED_JSON;
@@ -443,7 +539,6 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
             }
             ACVP_LOG_VERBOSE("              msg: %s", msg);
 
-
             if (alg_id == ACVP_RSA_SIGVER) {
                 tmp_signature = json_object_get_string(testobj, "signature");
                 if (!tmp_signature) {
@@ -480,14 +575,30 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
                 salt = json_object_get_string(testobj, "salt");
             }
 
-            rv = acvp_rsa_sig_init_tc(ctx, alg_id, &stc, tgId, tc_id,
+            cur = use_batch ? &stcs[j] : &stc;
+            rv = acvp_rsa_sig_init_tc(ctx, alg_id, cur, tgId, tc_id,
                                       sig_type, mask, mod, hash_alg, e_str,
-                                      n_str, msg, signature, salt, salt_len);
+                                      n_str, msg, signature, salt, salt_len,
+                                      acvp_bn_limbs_enabled(cap) && !cap->rsa_sigver_soa_handler);
             free(signature);
+            signature = NULL;
+            cur->tg_ctx = group_stc.tg_ctx;
+
+            if (use_batch) {
+                if (rv != ACVP_SUCCESS) {
+                    ACVP_LOG_ERR("Failed to initialize RSA test case");
+                    acvp_rsa_siggen_release_tc(cur);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                /* Verified with the rest of the group below */
+                acvp_tc_batch_add(&batch, r_tval)->tc.rsa_sig = cur;
+                continue;
+            }
 
             /* Process the current test vector... */
             if (rv == ACVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     ACVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -495,32 +606,19 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
                 }
             }
             if (alg_id == ACVP_RSA_SIGGEN) {
-                char *tmp = calloc(ACVP_RSA_EXP_LEN_MAX + 1, sizeof(char));
-                if (!tmp) {
-                    ACVP_LOG_ERR("Unable to malloc in rsa_siggen tpm_output_tc");
-                    rv = ACVP_MALLOC_FAIL;
-                    json_value_free(r_tval);
-                    goto err;
-                }
-                rv = acvp_bin_to_hexstr(stc.e, stc.e_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+                rv = acvp_json_set_hex(r_gobj, "e", stc.e, stc.e_len, ACVP_RSA_EXP_LEN_MAX);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("hex conversion failure (e)");
-                    free(tmp);
                     json_value_free(r_tval);
                     goto err;
                 }
-                json_object_set_string(r_gobj, "e", tmp);
-                memzero_s(tmp, ACVP_RSA_EXP_LEN_MAX);
 
-                rv = acvp_bin_to_hexstr(stc.n, stc.n_len, tmp, ACVP_RSA_EXP_LEN_MAX);
+                rv = acvp_json_set_hex(r_gobj, "n", stc.n, stc.n_len, ACVP_RSA_EXP_LEN_MAX);
                 if (rv != ACVP_SUCCESS) {
                     ACVP_LOG_ERR("hex conversion failure (n)");
-                    free(tmp);
                     json_value_free(r_tval);
                     goto err;
                 }
-                json_object_set_string(r_gobj, "n", tmp);
-                free(tmp);
             }
 
             /*
@@ -541,20 +639,184 @@ static ACVP_RESULT acvp_rsa_sig_kat_handler_internal(ACVP_CTX *ctx, JSON_Object
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        if (use_batch) {
+            rv = acvp_rsa_sig_run_batch(ctx, cap, &batch, r_tarr);
+            acvp_rsa_sig_release_batch(&stcs, &batch);
+            if (rv != ACVP_SUCCESS) {
+                goto err;
+            }
+        }
+        if (group_open) {
+            group_open = 0;
+            if ((cap->group_handler)(&group_tc, ACVP_TG_END)) {
+                ACVP_LOG_ERR("crypto module failed to finish test group %d", tgId);
+                rv = ACVP_CRYPTO_MODULE_FAIL;
+                goto err;
+            }
+        }
+        acvp_rsa_siggen_release_tc(&group_stc);
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
+    acvp_rsa_sig_release_batch(&stcs, &batch);
+    if (group_open) {
+        (cap->group_handler)(&group_tc, ACVP_TG_END);
+    }
+    acvp_rsa_siggen_release_tc(&group_stc);
     if (rv != ACVP_SUCCESS) {
         acvp_rsa_siggen_release_tc(&stc);
         acvp_release_json(r_vs_val, r_gval);
     }
     return rv;
 }
+
+/*
+ * Runs the test cases collected for a test group, see acvp_tc_batch_run(),
+ * and outputs their results, in test case order, into the group's
+ * tests array.
+ */
+static ACVP_RESULT acvp_rsa_sig_run_batch(ACVP_CTX *ctx,
+                                          ACVP_CAPS_LIST *cap,
+                                          ACVP_TC_BATCH *batch,
+                                          JSON_Array *r_tarr) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0;
+
+    if (cap->rsa_sigver_soa_handler && batch->count) {
+        rv = acvp_rsa_sigver_run_soa(ctx, cap, batch);
+    } else {
+        rv = acvp_tc_batch_run(ctx, cap, batch);
+    }
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->results[i]) {
+            ACVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return ACVP_CRYPTO_MODULE_FAIL;
+        }
+        rv = acvp_rsa_sig_output_tc(ctx, batch->tcs[i].tc.rsa_sig, json_value_get_object(batch->rsp[i]));
+        if (rv != ACVP_SUCCESS) {
+            ACVP_LOG_ERR("ERROR: JSON output failure in RSA module");
+            return rv;
+        }
+        json_array_append_value(r_tarr, batch->rsp[i]);
+        batch->rsp[i] = NULL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Hands a SigVer group to the SoA handler of the capability, see
+ * acvp_cap_rsa_sigver_set_soa_handler(). What the test cases share is
+ * taken from the first of them, the messages and signatures are packed,
+ * and the dispositions the module sets are copied back into the test
+ * cases for acvp_rsa_sig_output_tc().
+ */
+static ACVP_RESULT acvp_rsa_sigver_run_soa(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_RSA_SIG_TC *stc = batch->tcs[0].tc.rsa_sig;
+    ACVP_RSA_SIGVER_SOA soa;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long int start = 0;
+    size_t msg_bytes = 0;
+    int i = 0;
+
+    memzero_s(&soa, sizeof(ACVP_RSA_SIGVER_SOA));
+    soa.tg_id = stc->tg_id;
+    soa.sig_type = stc->sig_type;
+    soa.hash_alg = stc->hash_alg;
+    soa.mask = stc->mask;
+    soa.modulo = stc->modulo;
+    soa.salt_len = stc->salt_len;
+    soa.e = stc->e;
+    soa.e_len = stc->e_len;
+    soa.n = stc->n;
+    soa.n_len = stc->n_len;
+    soa.tg_ctx = stc->tg_ctx;
+    soa.count = batch->count;
+    for (i = 0; i < batch->count; i++) {
+        stc = batch->tcs[i].tc.rsa_sig;
+        msg_bytes += stc->msg_len;
+        if ((unsigned int)stc->sig_len > soa.sig_stride) {
+            soa.sig_stride = stc->sig_len;
+        }
+    }
+
+    soa.tc_id = calloc(soa.count, sizeof(unsigned int));
+    soa.msg = calloc(msg_bytes ? msg_bytes : 1, sizeof(unsigned char));
+    soa.msg_off = calloc(soa.count, sizeof(size_t));
+    soa.msg_len = calloc(soa.count, sizeof(int));
+    soa.sig = calloc(soa.sig_stride ? (size_t)soa.count * soa.sig_stride : 1, sizeof(unsigned char));
+    soa.sig_len = calloc(soa.count, sizeof(int));
+    soa.ver_disposition = calloc(soa.count, sizeof(int));
+    if (!soa.tc_id || !soa.msg || !soa.msg_off || !soa.msg_len || !soa.sig || !soa.sig_len ||
+            !soa.ver_disposition) {
+        ACVP_LOG_ERR("Unable to allocate the SoA view of the test group");
+        rv = ACVP_MALLOC_FAIL;
+        goto end;
+    }
+
+    msg_bytes = 0;
+    for (i = 0; i < soa.count; i++) {
+        stc = batch->tcs[i].tc.rsa_sig;
+        soa.tc_id[i] = stc->tc_id;
+        soa.msg_off[i] = msg_bytes;
+        soa.msg_len[i] = stc->msg_len;
+        if (stc->msg_len) {
+            memcpy_s(soa.msg + msg_bytes, stc->msg_len, stc->msg, stc->msg_len);
+        }
+        msg_bytes += stc->msg_len;
+        soa.sig_len[i] = stc->sig_len;
+        if (stc->sig_len) {
+            memcpy_s(soa.sig + (size_t)i * soa.sig_stride, soa.sig_stride, stc->signature, stc->sig_len);
+        }
+    }
+
+    memzero_s(batch->results, batch->max * sizeof(int));
+    ACVP_LOG_VERBOSE("Handing %d signatures to the SoA handler", soa.count);
+    if (ACVP_CRYPTO_TIMED(ctx)) start = acvp_metrics_now();
+    if ((cap->rsa_sigver_soa_handler)(&soa, batch->results)) {
+        ACVP_LOG_ERR("crypto module failed the SoA operation");
+        rv = ACVP_CRYPTO_MODULE_FAIL;
+        goto end;
+    }
+    acvp_metrics_crypto(ctx, start, soa.count, NULL);
+
+    for (i = 0; i < soa.count; i++) {
+        batch->tcs[i].tc.rsa_sig->ver_disposition = soa.ver_disposition[i] ?
+                                                   ACVP_TEST_DISPOSITION_PASS : ACVP_TEST_DISPOSITION_FAIL;
+    }
+
+end:
+    if (soa.tc_id) free(soa.tc_id);
+    if (soa.msg) free(soa.msg);
+    if (soa.msg_off) free(soa.msg_off);
+    if (soa.msg_len) free(soa.msg_len);
+    if (soa.sig) free(soa.sig);
+    if (soa.sig_len) free(soa.sig_len);
+    if (soa.ver_disposition) free(soa.ver_disposition);
+    return rv;
+}
+
+/*
+ * Releases the test cases of a batched group along with the batch itself
+ */
+static void acvp_rsa_sig_release_batch(ACVP_RSA_SIG_TC **stcs, ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (*stcs) {
+        for (i = 0; i < batch->count; i++) {
+            acvp_rsa_siggen_release_tc(&(*stcs)[i]);
+        }
+        free(*stcs);
+        *stcs = NULL;
+    }
+    acvp_tc_batch_free(batch);
+}
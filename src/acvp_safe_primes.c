@@ -29,7 +29,7 @@ static ACVP_SAFE_PRIMES_TEST_TYPE read_test_type(const char *str) {
     return 0;
 }
 
-static ACVP_SAFE_PRIMES_PARAM acvp_convert_dgm_string(const char *dgm_str)
+static ACVP_SAFE_PRIMES_MODE acvp_convert_dgm_string(const char *dgm_str)
 {
     int diff = 0;
 
@@ -64,6 +64,8 @@ static ACVP_SAFE_PRIMES_PARAM acvp_convert_dgm_string(const char *dgm_str)
 static ACVP_RESULT acvp_safe_primes_release_tc(ACVP_SAFE_PRIMES_TC *stc) {
     if (stc->x) free(stc->x);
     if (stc->y) free(stc->y);
+    acvp_bn_free(&stc->x_bn);
+    acvp_bn_free(&stc->y_bn);
     memzero_s(stc, sizeof(ACVP_SAFE_PRIMES_TC));
     return ACVP_SUCCESS;
 }
@@ -73,7 +75,6 @@ static ACVP_RESULT acvp_safe_primes_output_tc(ACVP_CTX *ctx,
                                               ACVP_SAFE_PRIMES_TC *stc,
                                               JSON_Object *tc_rsp) {
     ACVP_RESULT rv = ACVP_SUCCESS;
-    char *tmp = NULL;
 
     if (stc->cipher == ACVP_SAFE_PRIMES_KEYVER) {
 
@@ -84,31 +85,21 @@ static ACVP_RESULT acvp_safe_primes_output_tc(ACVP_CTX *ctx,
         }
 
     } else {
-        tmp = calloc(ACVP_SAFE_PRIMES_STR_MAX + 1, sizeof(char));
-        if (!tmp) {
-            ACVP_LOG_ERR("Unable to malloc in acvp_safe_primes_output_mct_tc");
-            return ACVP_MALLOC_FAIL;
-        }
 
-        memzero_s(tmp, ACVP_SAFE_PRIMES_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->x, stc->xlen, tmp, ACVP_SAFE_PRIMES_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "x", stc->x, stc->xlen, ACVP_SAFE_PRIMES_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (x)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "x", tmp);
 
-        memzero_s(tmp, ACVP_SAFE_PRIMES_STR_MAX);
-        rv = acvp_bin_to_hexstr(stc->y, stc->ylen, tmp, ACVP_SAFE_PRIMES_STR_MAX);
+        rv = acvp_json_set_hex(tc_rsp, "y", stc->y, stc->ylen, ACVP_SAFE_PRIMES_STR_MAX);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("hex conversion failure (y)");
             goto end;
         }
-        json_object_set_string(tc_rsp, "y", tmp);
     }
 
 end:
-    if (tmp) free(tmp);
 
     return rv;
 }
@@ -118,29 +109,31 @@ static ACVP_RESULT acvp_safe_primes_init_tc(ACVP_CTX *ctx,
                                             int tc_id,
                                             ACVP_CIPHER alg_id,
                                             ACVP_SAFE_PRIMES_TC *stc,
-                                            ACVP_SAFE_PRIMES_PARAM dgm,
+                                            ACVP_SAFE_PRIMES_MODE dgm,
                                             const char *x,
                                             const char *y,
-                                            ACVP_SAFE_PRIMES_TEST_TYPE test_type) {
+                                            ACVP_SAFE_PRIMES_TEST_TYPE test_type,
+                                            int limbs) {
     ACVP_RESULT rv;
 
     stc->tg_id = tg_id;
     stc->tc_id = tc_id;
     stc->dgm = dgm;
+    stc->group = acvp_lookup_safe_primes_group(dgm);
     stc->test_type = test_type;
     stc-> cipher = alg_id;
 
     if (alg_id == ACVP_SAFE_PRIMES_KEYVER) {
         stc->y = calloc(1, ACVP_SAFE_PRIMES_BYTE_MAX);
         if (!stc->y) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(y, stc->y, ACVP_SAFE_PRIMES_BYTE_MAX, &(stc->ylen));
+        rv = acvp_hexstr_to_num(limbs, y, stc->y, ACVP_SAFE_PRIMES_BYTE_MAX, &(stc->ylen), &stc->y_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (y)");
             return rv;
         }
         stc->x = calloc(1, ACVP_SAFE_PRIMES_BYTE_MAX);
         if (!stc->x) { return ACVP_MALLOC_FAIL; }
-        rv = acvp_hexstr_to_bin(x, stc->x, ACVP_SAFE_PRIMES_BYTE_MAX, &(stc->xlen));
+        rv = acvp_hexstr_to_num(limbs, x, stc->x, ACVP_SAFE_PRIMES_BYTE_MAX, &(stc->xlen), &stc->x_bn);
         if (rv != ACVP_SUCCESS) {
             ACVP_LOG_ERR("Hex conversion failure (x)");
             return rv;
@@ -174,11 +167,11 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     ACVP_CAPS_LIST *cap;
     ACVP_TEST_CASE tc;
     ACVP_SAFE_PRIMES_TC stc;
+    ACVP_TC_CONTROL control;
     ACVP_RESULT rv = ACVP_SUCCESS;
     const char *alg_str = NULL, *dgm_str = NULL, *test_type_str = NULL;
-    char *json_result = NULL;
     ACVP_CIPHER alg_id;
-    ACVP_SAFE_PRIMES_PARAM dgm;
+    ACVP_SAFE_PRIMES_MODE dgm;
     ACVP_SAFE_PRIMES_TEST_TYPE test_type;
     const char *mode_str = NULL, *x = NULL, *y = NULL;
     unsigned int i, g_cnt;
@@ -233,7 +226,7 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     /*
      * Start to build the JSON response
      */
-    rv = acvp_setup_json_rsp_group(&ctx, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
+    rv = acvp_setup_json_rsp_group(&ctx, obj, &reg_arry_val, &r_vs_val, &r_vs, alg_str, &r_garr);
     if (rv != ACVP_SUCCESS) {
         ACVP_LOG_ERR("Failed to setup json response");
         return rv;
@@ -253,15 +246,15 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
          */
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
-        tg_id = json_object_get_number(groupobj, "tgId");
+        tg_id = json_object_get_uint(groupobj, "tgId");
+        acvp_metrics_tg_begin(ctx, tg_id);
         if (!tg_id) {
             ACVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = ACVP_MISSING_ARG;
             goto err;
         }
         json_object_set_number(r_gobj, "tgId", tg_id);
-        json_object_set_value(r_gobj, "tests", json_value_init_array());
-        r_tarr = json_object_get_array(r_gobj, "tests");
+        r_tarr = acvp_setup_json_rsp_tests(r_gobj, groupobj);
 
         dgm_str = json_object_get_string(groupobj, "safePrimeGroup");
         if (!dgm_str) {
@@ -299,7 +292,7 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 ACVP_LOG_VERBOSE("Found new SAFE-PRIMES test vector...");
                 testval = json_array_get_value(tests, j);
                 testobj = json_value_get_object(testval);
-                tc_id = json_object_get_number(testobj, "tcId");
+                tc_id = json_object_get_uint(testobj, "tcId");
                 if (!tc_id) {
                     ACVP_LOG_ERR("Server JSON missing 'tcId'");
                     rv = ACVP_MISSING_ARG;
@@ -331,15 +324,18 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                  * the crypto module.
                  */
                 rv = acvp_safe_primes_init_tc(ctx, tg_id, tc_id, alg_id, 
-                                              &stc, dgm, x, y, test_type);
+                                              &stc, dgm, x, y, test_type,
+                                              acvp_bn_limbs_enabled(cap));
                 if (rv != ACVP_SUCCESS) {
                     acvp_safe_primes_release_tc(&stc);
                     json_value_free(r_tval);
                     goto err;
                 }
 
-                /* Process the current KAT test vector... */
-                if ((cap->crypto_handler)(&tc)) {
+                /* Process the current KAT test vector, from the key pool if there is one */
+                stc.control = acvp_tc_control_begin(ctx, &control, alg_id, tg_id, tc_id);
+                if (!acvp_key_pool_take(ctx, cap, dgm, 0, &tc) &&
+                        acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     acvp_safe_primes_release_tc(&stc);
                     ACVP_LOG_ERR("crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -377,7 +373,7 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 ACVP_LOG_VERBOSE("Found new SAFE-PRIMES test vector...");
                 testval = json_array_get_value(tests, j);
                 testobj = json_value_get_object(testval);
-                tc_id = json_object_get_number(testobj, "tcId");
+                tc_id = json_object_get_uint(testobj, "tcId");
                 if (!tc_id) {
                     ACVP_LOG_ERR("Server JSON missing 'tcId'");
                     rv = ACVP_MISSING_ARG;
@@ -428,7 +424,8 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                  * the crypto module.
                  */
                  rv = acvp_safe_primes_init_tc(ctx, tg_id, tc_id, alg_id, 
-                                               &stc, dgm, x, y, test_type);
+                                               &stc, dgm, x, y, test_type,
+                                               acvp_bn_limbs_enabled(cap));
                 if (rv != ACVP_SUCCESS) {
                     acvp_safe_primes_release_tc(&stc);
                     json_value_free(r_tval);
@@ -436,7 +433,7 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
                 }
 
                 /* Process the current KAT test vector... */
-                if ((cap->crypto_handler)(&tc)) {
+                if (acvp_crypto_call(ctx, cap->crypto_handler, &tc)) {
                     acvp_safe_primes_release_tc(&stc);
                     ACVP_LOG_ERR("crypto module failed the operation");
                     rv = ACVP_CRYPTO_MODULE_FAIL;
@@ -483,9 +480,7 @@ ACVP_RESULT acvp_safe_primes_kat_handler(ACVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
-    json_free_serialized_string(json_result);
+    acvp_log_kat_resp(ctx);
     rv = ACVP_SUCCESS;
 
 err:
@@ -0,0 +1,226 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Moves the test group responses of a vector set to disk once they get
+ * larger than the memory budget, see acvp_set_memory_budget(). Like the
+ * checkpoint journal, it is driven by acvp_metrics_tg_begin(): the groups
+ * the KAT handler has finished are counted as each group starts, and once
+ * they are over the budget they are serialized into a temporary file and
+ * freed. When the vector set is done, acvp_spill_finish() writes out the
+ * responses with the groups from the file ahead of those still in memory,
+ * for the upload or the response file to be streamed from.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+/*
+ * Whether the responses of ctx may be moved to disk. Uploads are read from
+ * a file, so builds that post from memory only spill offline runs.
+ */
+static int acvp_spill_enabled(ACVP_CTX *ctx) {
+    if (!ctx->memory_budget || !ctx->exec.rsp_groups || ctx->exec.spill.failed) {
+        return 0;
+    }
+    if (ctx->exec.journal || ctx->exec.memo) {
+        /* Merged back in among the responses by acvp_journal_end(), or looked at by acvp_memo_end() */
+        return 0;
+    }
+#ifdef USE_MURL
+    if (!ctx->pool || !ctx->pool->rsp_filename) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+/*
+ * Copies the first len bytes of from, all of it if len is negative, to the
+ * end of to
+ */
+static int acvp_spill_copy(FILE *from, long len, FILE *to) {
+    char buf[4096];
+    size_t n = 0, want = 0;
+
+    if (fflush(from) || fseek(from, 0, SEEK_SET)) {
+        return 1;
+    }
+    while (len) {
+        want = len < 0 || (size_t)len > sizeof(buf) ? sizeof(buf) : (size_t)len;
+        n = fread(buf, 1, want, from);
+        if (!n) {
+            break;
+        }
+        if (fwrite(buf, 1, n, to) != n) {
+            return 1;
+        }
+        if (len > 0) len -= (long)n;
+    }
+    return ferror(from) || len > 0;
+}
+
+/*
+ * Counts the test groups the KAT handler has finished since the last call
+ * and, once the responses are over the memory budget, moves all of them to
+ * the spill file. Called as each group starts, after acvp_journal_tg_done().
+ * Should the file not be written the groups are just kept in memory.
+ */
+void acvp_spill_tg_done(ACVP_CTX *ctx) {
+    ACVP_RSP_SPILL *spill = &ctx->exec.spill;
+    JSON_Value *group = NULL;
+    int i = 0, count = 0;
+
+    if (!acvp_spill_enabled(ctx)) {
+        return;
+    }
+    count = json_array_get_count(ctx->exec.rsp_groups);
+    for (i = spill->sized; i < count; i++) {
+        spill->size += json_serialization_size(json_array_get_value(ctx->exec.rsp_groups, i));
+    }
+    spill->sized = count;
+    if (spill->size <= ctx->memory_budget) {
+        return;
+    }
+
+    if (!spill->fp) {
+        spill->fp = tmpfile();
+    }
+    if (!spill->fp || fseek(spill->fp, spill->len, SEEK_SET)) {
+        goto err;
+    }
+    for (i = 0; i < count; i++) {
+        group = json_array_get_value(ctx->exec.rsp_groups, i);
+        if ((spill->count + i && fputc(',', spill->fp) == EOF) ||
+                json_serialize_to_fp(group, spill->fp) != JSONSuccess) {
+            goto err;
+        }
+    }
+    if (fflush(spill->fp) || (spill->len = ftell(spill->fp)) < 0) {
+        goto err;
+    }
+    ACVP_LOG_VERBOSE("Moved %d test group responses of vector set %d to disk, %lu bytes",
+                     count, ctx->exec.vs_id, (unsigned long)spill->size);
+    spill->count += count;
+    spill->sized = 0;
+    spill->size = 0;
+    json_array_clear(ctx->exec.rsp_groups);
+    /* Already written to the checkpoint journal, see acvp_journal_tg_done() */
+    ctx->exec.rsp_groups_saved = 0;
+    return;
+
+err:
+    ACVP_LOG_WARN("Unable to move test group responses to disk, keeping them in memory");
+    spill->failed = 1;
+}
+
+/*
+ * Writes the vector set responses of ctx to a temporary file, with the
+ * test groups moved to disk ahead of the rest, and frees them. With whole
+ * the file has the array posted to the server, version first, otherwise it
+ * only has the vector set object, as the response file has it. NULL when
+ * no groups were moved to disk, or the file could not be written; the
+ * responses are then left as they are.
+ */
+FILE *acvp_spill_finish(ACVP_CTX *ctx, int whole, int *len) {
+    ACVP_RSP_SPILL *spill = &ctx->exec.spill;
+    JSON_Array *kat_array = NULL, *groups = NULL;
+    JSON_Value *groups_val = NULL;
+    JSON_Object *r_vs = NULL;
+    FILE *fp = NULL;
+    char *hdr = NULL;
+    size_t hdr_len = 0;
+    long pos = 0;
+    int i = 0, count = 0, ok = 0;
+
+    if (!spill->count) {
+        return NULL;
+    }
+    kat_array = json_value_get_array(ctx->exec.kat_resp);
+    r_vs = json_array_get_object(kat_array, 1);
+    groups_val = json_object_get_value(r_vs, "testGroups");
+    groups = json_value_get_array(groups_val);
+    if (!groups || json_object_soft_remove(r_vs, "testGroups") != JSONSuccess) {
+        ACVP_LOG_ERR("Vector set responses are missing their test groups");
+        return NULL;
+    }
+    /* The rest of the vector set object, without its closing brace */
+    hdr = json_serialize_to_string(json_array_get_value(kat_array, 1), NULL);
+    if (hdr) hdr_len = strnlen_s(hdr, RSIZE_MAX_STR);
+
+    fp = tmpfile();
+    if (!fp || !hdr || hdr_len < 2) {
+        goto end;
+    }
+    if (whole && (fputc('[', fp) == EOF || json_serialize_to_fp(json_array_get_value(kat_array, 0), fp) != JSONSuccess ||
+                  fputc(',', fp) == EOF)) {
+        goto end;
+    }
+    if (fwrite(hdr, 1, hdr_len - 1, fp) != hdr_len - 1 || (hdr_len > 2 && fputc(',', fp) == EOF) ||
+            fputs("\"testGroups\":[", fp) == EOF || acvp_spill_copy(spill->fp, spill->len, fp)) {
+        goto end;
+    }
+    count = json_array_get_count(groups);
+    for (i = 0; i < count; i++) {
+        if (fputc(',', fp) == EOF || json_serialize_to_fp(json_array_get_value(groups, i), fp) != JSONSuccess) {
+            goto end;
+        }
+    }
+    if (fputs(whole ? "]}]" : "]}", fp) == EOF || fflush(fp)) {
+        goto end;
+    }
+    pos = ftell(fp);
+    ok = pos >= 0 && pos <= INT_MAX;
+
+end:
+    if (hdr) json_free_serialized_string(hdr);
+    json_object_set_value(r_vs, "testGroups", groups_val);
+    if (!ok) {
+        ACVP_LOG_ERR("Unable to write the vector set responses moved to disk");
+        if (fp) fclose(fp);
+        return NULL;
+    }
+    *len = (int)pos;
+    acvp_json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    acvp_spill_reset(ctx);
+    return fp;
+}
+
+/*
+ * Drops the test groups moved to disk, ahead of the next vector set
+ */
+void acvp_spill_reset(ACVP_CTX *ctx) {
+    if (ctx->exec.spill.fp) fclose(ctx->exec.spill.fp);
+    memzero_s(&ctx->exec.spill, sizeof(ACVP_RSP_SPILL));
+}
+
+/*
+ * Queues the vector set responses acvp_spill_finish() wrote to fp on the
+ * writer of the response file, as acvp_json_serialize_to_file_a() would
+ * append them. The writer closes fp.
+ */
+ACVP_RESULT acvp_spill_append(FILE *fp, ACVP_WRITER *writer) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    rv = acvp_writer_puts(writer, ", ");
+    if (rv != ACVP_SUCCESS) {
+        fclose(fp);
+        return rv;
+    }
+    return acvp_writer_file(writer, fp);
+}
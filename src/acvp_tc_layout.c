@@ -0,0 +1,201 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * The buffers of the test case structs that are handed to a crypto module
+ * outside of this process, over a shared memory ring (acvp_ring.c) or the
+ * wire to a remote device (acvp_dut.c): where each buffer and its length
+ * are in the struct, how large the kat handlers allocate it, and which way
+ * it is copied. Only test cases whose buffers all have such a bound can be
+ * carried this way.
+ */
+
+#include <stddef.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+#define ACVP_TC_NOT_CARRIED(type, field) { offsetof(type, field), 0, 0, 0, 0 }
+
+static const ACVP_TC_FIELD acvp_tc_layout_sym_fields[] = {
+    { offsetof(ACVP_SYM_CIPHER_TC, key), offsetof(ACVP_SYM_CIPHER_TC, key_len), 1,
+      ACVP_SYM_KEY_MAX_BYTES, ACVP_TC_FIELD_IN },
+    { offsetof(ACVP_SYM_CIPHER_TC, pt), offsetof(ACVP_SYM_CIPHER_TC, pt_len), 0,
+      ACVP_SYM_PT_BYTE_MAX, ACVP_TC_FIELD_IN | ACVP_TC_FIELD_OUT },
+    { offsetof(ACVP_SYM_CIPHER_TC, ct), offsetof(ACVP_SYM_CIPHER_TC, ct_len), 0,
+      ACVP_SYM_PT_BYTE_MAX, ACVP_TC_FIELD_IN | ACVP_TC_FIELD_OUT },
+    { offsetof(ACVP_SYM_CIPHER_TC, aad), offsetof(ACVP_SYM_CIPHER_TC, aad_len), 0,
+      ACVP_SYM_AAD_BYTE_MAX, ACVP_TC_FIELD_IN },
+    { offsetof(ACVP_SYM_CIPHER_TC, iv), offsetof(ACVP_SYM_CIPHER_TC, iv_len), 0,
+      ACVP_SYM_IV_BYTE_MAX, ACVP_TC_FIELD_IN | ACVP_TC_FIELD_OUT },
+    { offsetof(ACVP_SYM_CIPHER_TC, tag), offsetof(ACVP_SYM_CIPHER_TC, tag_len), 0,
+      ACVP_SYM_TAG_BYTE_MAX, ACVP_TC_FIELD_IN | ACVP_TC_FIELD_OUT },
+    { offsetof(ACVP_SYM_CIPHER_TC, salt), offsetof(ACVP_SYM_CIPHER_TC, salt_len), 0,
+      ACVP_AES_XPN_SALTLEN, ACVP_TC_FIELD_IN | ACVP_TC_FIELD_OUT },
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, iv_ret),
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, iv_ret_after),
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, mct_tail),
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, mct_key),
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, mct_iv),
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, mct_pt),
+    ACVP_TC_NOT_CARRIED(ACVP_SYM_CIPHER_TC, mct_ct)
+};
+
+static const ACVP_TC_FIELD acvp_tc_layout_hash_fields[] = {
+    { offsetof(ACVP_HASH_TC, msg), offsetof(ACVP_HASH_TC, msg_len), 0,
+      ACVP_SHAKE_MSG_BYTE_MAX, ACVP_TC_FIELD_IN },
+    { offsetof(ACVP_HASH_TC, md), offsetof(ACVP_HASH_TC, md_len), 0,
+      ACVP_HASH_XOF_MD_BYTE_MAX, ACVP_TC_FIELD_OUT },
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, md_sink),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, m1),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, m2),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, m3),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, mct_md),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, mct_md_len),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, ldt_chunk),
+    ACVP_TC_NOT_CARRIED(ACVP_HASH_TC, ldt_map)
+};
+
+static const ACVP_TC_FIELD acvp_tc_layout_hmac_fields[] = {
+    { offsetof(ACVP_HMAC_TC, msg), offsetof(ACVP_HMAC_TC, msg_len), 0,
+      ACVP_HMAC_MSG_MAX, ACVP_TC_FIELD_IN },
+    { offsetof(ACVP_HMAC_TC, key), offsetof(ACVP_HMAC_TC, key_len), 0,
+      ACVP_HMAC_KEY_BYTE_MAX, ACVP_TC_FIELD_IN },
+    { offsetof(ACVP_HMAC_TC, mac), offsetof(ACVP_HMAC_TC, mac_len), 0,
+      ACVP_HMAC_MAC_BYTE_MAX, ACVP_TC_FIELD_OUT },
+    ACVP_TC_NOT_CARRIED(ACVP_HMAC_TC, tg_ctx)
+};
+
+#define ACVP_TC_FIELD_CNT(fields) ((int)(sizeof(fields) / sizeof(ACVP_TC_FIELD)))
+
+/* The kinds of test case that can be handed out of process, by capability type */
+static const struct {
+    ACVP_CAP_TYPE cap_type;
+    ACVP_TC_KIND kind;
+} acvp_tc_layout_kind_tbl[] = {
+    { ACVP_SYM_TYPE,  ACVP_TC_KIND_SYM },
+    { ACVP_HASH_TYPE, ACVP_TC_KIND_HASH },
+    { ACVP_HMAC_TYPE, ACVP_TC_KIND_HMAC }
+};
+
+/*
+ * The kind of test case the capability has, ACVP_TC_KIND_NONE if its test
+ * cases can not be handed out of process
+ */
+ACVP_TC_KIND acvp_tc_layout_kind(ACVP_CAPS_LIST *cap) {
+    size_t i = 0;
+
+    if (cap->cipher == ACVP_AES_CFB1) {
+        /* Lengths in bits */
+        return ACVP_TC_KIND_NONE;
+    }
+    for (i = 0; i < sizeof(acvp_tc_layout_kind_tbl) / sizeof(acvp_tc_layout_kind_tbl[0]); i++) {
+        if (acvp_tc_layout_kind_tbl[i].cap_type == cap->cap_type) {
+            return acvp_tc_layout_kind_tbl[i].kind;
+        }
+    }
+    return ACVP_TC_KIND_NONE;
+}
+
+void acvp_tc_layout_fields(int kind, const ACVP_TC_FIELD **fields, int *cnt) {
+    switch (kind) {
+    case ACVP_TC_KIND_SYM:
+        *fields = acvp_tc_layout_sym_fields;
+        *cnt = ACVP_TC_FIELD_CNT(acvp_tc_layout_sym_fields);
+        break;
+    case ACVP_TC_KIND_HASH:
+        *fields = acvp_tc_layout_hash_fields;
+        *cnt = ACVP_TC_FIELD_CNT(acvp_tc_layout_hash_fields);
+        break;
+    case ACVP_TC_KIND_HMAC:
+        *fields = acvp_tc_layout_hmac_fields;
+        *cnt = ACVP_TC_FIELD_CNT(acvp_tc_layout_hmac_fields);
+        break;
+    default:
+        *fields = NULL;
+        *cnt = 0;
+        break;
+    }
+}
+
+size_t acvp_tc_layout_size(int kind) {
+    switch (kind) {
+    case ACVP_TC_KIND_SYM:
+        return sizeof(ACVP_SYM_CIPHER_TC);
+    case ACVP_TC_KIND_HASH:
+        return sizeof(ACVP_HASH_TC);
+    case ACVP_TC_KIND_HMAC:
+        return sizeof(ACVP_HMAC_TC);
+    default:
+        return 0;
+    }
+}
+
+void *acvp_tc_layout_struct(ACVP_TEST_CASE *tc, int kind) {
+    switch (kind) {
+    case ACVP_TC_KIND_SYM:
+        return tc->tc.symmetric;
+    case ACVP_TC_KIND_HASH:
+        return tc->tc.hash;
+    case ACVP_TC_KIND_HMAC:
+        return tc->tc.hmac;
+    default:
+        return NULL;
+    }
+}
+
+/* The test case to hand to a crypto handler for the struct stc of kind */
+ACVP_TEST_CASE acvp_tc_layout_wrap(void *stc, int kind) {
+    ACVP_TEST_CASE tc;
+
+    memzero_s(&tc, sizeof(ACVP_TEST_CASE));
+    switch (kind) {
+    case ACVP_TC_KIND_SYM:
+        tc.tc.symmetric = stc;
+        break;
+    case ACVP_TC_KIND_HASH:
+        tc.tc.hash = stc;
+        break;
+    case ACVP_TC_KIND_HMAC:
+    default:
+        tc.tc.hmac = stc;
+        break;
+    }
+    return tc;
+}
+
+unsigned char **acvp_tc_layout_ptr(char *stc, const ACVP_TC_FIELD *field) {
+    return (unsigned char **)(stc + field->ptr);
+}
+
+/* The length of the buffer of field in bytes, as the struct stc has it */
+size_t acvp_tc_layout_len(char *stc, const ACVP_TC_FIELD *field) {
+    unsigned int len = *(unsigned int *)(stc + field->len);
+
+    return field->bits ? ((size_t)len + 7) / 8 : len;
+}
+
+/*
+ * Whether the test case can be handed out of process. The rest are run by
+ * the crypto handler of the capability in this process.
+ */
+int acvp_tc_layout_carries(ACVP_TEST_CASE *tc, int kind) {
+    switch (kind) {
+    case ACVP_TC_KIND_HASH:
+        /* The message is streamed by acvp_hash_ldt_next_chunk() */
+        return tc->tc.hash->test_type != ACVP_HASH_TEST_TYPE_LDT;
+    case ACVP_TC_KIND_SYM:
+    case ACVP_TC_KIND_HMAC:
+        return 1;
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,123 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Trace spans, see acvp_set_trace_cb(). A span lives with whoever opened it,
+ * mostly on the stack; the exec context only keeps the id of the innermost
+ * open span, for the spans opened inside it to name as their parent, and the
+ * span of the test group in progress, which is opened and closed by the KAT
+ * handlers as they move from one group to the next.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+static const char *acvp_span_name[] = {
+    NULL,
+    "acvp.transport",
+    "acvp.parse",
+    "acvp.dispatch",
+    "acvp.kat_handler",
+    "acvp.test_group"
+};
+
+ACVP_RESULT acvp_set_trace_cb(ACVP_CTX *ctx,
+                              void (*start_cb)(const ACVP_SPAN *span, void *arg),
+                              void (*end_cb)(const ACVP_SPAN *span, void *arg),
+                              void *arg) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (start_cb && !end_cb) {
+        return ACVP_INVALID_ARG;
+    }
+    ctx->span_start_cb = start_cb;
+    ctx->span_end_cb = end_cb;
+    ctx->span_arg = arg;
+    return ACVP_SUCCESS;
+}
+
+/* Span ids are unique across the sessions of the process */
+static unsigned long long int acvp_span_next_id(void) {
+#ifdef _WIN32
+    static volatile LONG64 seq = 0;
+
+    return (unsigned long long int)InterlockedIncrement64(&seq);
+#else
+    static unsigned long long int seq = 0;
+
+    return __atomic_add_fetch(&seq, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/*
+ * Opens a span as the child of the innermost one open on ctx. The fields
+ * particular to the type may be filled in before or after; nothing is done
+ * while no trace callback is set.
+ */
+void acvp_span_begin(ACVP_CTX *ctx, ACVP_SPAN *span, ACVP_SPAN_TYPE type) {
+    memzero_s(span, sizeof(ACVP_SPAN));
+    if (!ctx->span_end_cb) {
+        return;
+    }
+    span->type = type;
+    span->name = acvp_span_name[type];
+    span->span_id = acvp_span_next_id();
+    span->parent_id = ctx->exec.span_cur;
+    span->vs_id = ctx->exec.vs_id;
+    span->start_ns = acvp_metrics_now();
+    ctx->exec.span_cur = span->span_id;
+    if (ctx->span_start_cb) {
+        (ctx->span_start_cb)(span, ctx->span_arg);
+    }
+}
+
+/*
+ * Closes a span opened by acvp_span_begin(), its parent becoming the
+ * innermost open span again
+ */
+void acvp_span_end(ACVP_CTX *ctx, ACVP_SPAN *span, ACVP_RESULT rv) {
+    if (!span->span_id) {
+        return;
+    }
+    span->result = rv;
+    span->end_ns = acvp_metrics_now();
+    ctx->exec.span_cur = span->parent_id;
+    if (ctx->span_end_cb) {
+        (ctx->span_end_cb)(span, ctx->span_arg);
+    }
+    span->span_id = 0;
+}
+
+/*
+ * Called as a KAT handler starts on a test group: the span of the group
+ * before it, if any, is closed, and one opened for this one.
+ */
+void acvp_span_tg_begin(ACVP_CTX *ctx, int tg_id) {
+    acvp_span_tg_end(ctx);
+    if (!ctx->span_end_cb) {
+        return;
+    }
+    acvp_span_begin(ctx, &ctx->exec.tg_span, ACVP_SPAN_TEST_GROUP);
+    ctx->exec.tg_span.tg_id = tg_id;
+}
+
+void acvp_span_tg_end(ACVP_CTX *ctx) {
+    acvp_span_end(ctx, &ctx->exec.tg_span, ACVP_SUCCESS);
+}
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #include "acvp.h"
 #include "acvp_lcl.h"
 #include "safe_lib.h"
@@ -75,11 +76,28 @@ typedef enum acvp_net_action {
 } ACVP_NET_ACTION;
 
 #ifndef ACVP_OFFLINE
+/* Names of the actions, for their trace spans */
+static const char *acvp_net_action_name[] = {
+    NULL,
+    "GET",
+    "GET_VS",
+    "GET_VS_RESULT",
+    "GET_VS_SAMPLE",
+    "POST",
+    "POST_LOGIN",
+    "POST_REG",
+    "POST_VS_RESP",
+    "PUT",
+    "PUT_VALIDATION",
+    "DELETE"
+};
+
 /*
  * Prototypes
  */
 static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx, ACVP_NET_ACTION action,
                                        const char *url, const char *data, int data_len);
+static FILE *acvp_stream_vs_resp(ACVP_CTX *ctx, int *len);
 
 static struct curl_slist *acvp_add_auth_hdr(ACVP_CTX *ctx, struct curl_slist *slist) {
     char *bearer = NULL;
@@ -133,125 +151,708 @@ end:
     return slist;
 }
 
+/*
+ * Makes room in the receive buffer for at least len more bytes plus the
+ * terminating NUL. The buffer grows geometrically so a large body arriving
+ * in many small chunks is only copied a handful of times. Once it is large
+ * enough it may be backed by huge pages, see acvp_big_alloc().
+ */
+static int acvp_curl_buf_reserve(ACVP_EXEC_CTX *exec, size_t len) {
+    size_t needed = 0, size = 0;
+    char *buf = NULL;
+    int huge = 0, mapped = 0;
+
+    needed = (size_t)exec->curl_read_ctr + len + 1;
+    if (needed > INT_MAX) {
+        return 0;
+    }
+    if (exec->curl_buf && needed <= (size_t)exec->curl_buf_size) {
+        return 1;
+    }
+
+    size = exec->curl_buf_size ? (size_t)exec->curl_buf_size : ACVP_CURL_BUF_INIT;
+    while (size < needed) {
+        size = (size > INT_MAX / 2) ? INT_MAX : size * 2;
+    }
+
+    /* Rounded up to huge pages, the size still has to fit curl_buf_size */
+    huge = exec->huge_pages && size >= ACVP_HUGE_PAGE_SIZE && (size_t)INT_MAX - size >= ACVP_HUGE_PAGE_SIZE;
+    if (!huge && !exec->curl_buf_mapped) {
+        buf = realloc(exec->curl_buf, size);
+        if (!buf) {
+            return 0;
+        }
+        if (!exec->curl_buf) {
+            buf[0] = 0;
+        }
+    } else {
+        buf = acvp_big_alloc(&size, huge, &mapped);
+        if (!buf) {
+            return 0;
+        }
+        buf[0] = 0;
+        if (exec->curl_buf) {
+            memcpy_s(buf, size, exec->curl_buf, (size_t)exec->curl_read_ctr + 1);
+            acvp_big_free(exec->curl_buf, (size_t)exec->curl_buf_size, exec->curl_buf_mapped);
+        }
+    }
+    acvp_mem_charge(exec->mem, size - (size_t)exec->curl_buf_size);
+    exec->curl_buf = buf;
+    exec->curl_buf_size = (int)size;
+    exec->curl_buf_mapped = mapped;
+    return 1;
+}
+
+/*
+ * Prepares the receive buffer for the next server response. Small buffers
+ * are kept for reuse, an unusually large one is given back rather than being
+ * held for the rest of the session.
+ */
+static void acvp_curl_buf_reset(ACVP_EXEC_CTX *exec) {
+    exec->curl_read_ctr = 0;
+    if (exec->curl_buf && exec->curl_buf_size > ACVP_CURL_BUF_RETAIN) {
+        acvp_mem_credit(exec->mem, (size_t)exec->curl_buf_size);
+        acvp_big_free(exec->curl_buf, (size_t)exec->curl_buf_size, exec->curl_buf_mapped);
+        exec->curl_buf = NULL;
+        exec->curl_buf_size = 0;
+        exec->curl_buf_mapped = 0;
+    }
+    if (exec->curl_buf) {
+        /* Clear the HTTP buffer for next server response */
+        exec->curl_buf[0] = 0;
+    }
+}
+
+/*
+ * This is a callback used by curl to hand us each response header.
+ * When the server tells us the size of the body up front the receive
+ * buffer is sized for it in one go. The value is only a hint; the
+ * write callback still grows the buffer as needed.
+ */
+#define ACVP_CONTENT_LENGTH_HDR "content-length:"
+#define ACVP_CONTENT_LENGTH_HDR_LEN 15
+static size_t acvp_curl_header_callback(char *ptr, size_t size, size_t nitems, void *userdata) {
+    ACVP_EXEC_CTX *exec = (ACVP_EXEC_CTX *)userdata;
+    size_t len = size * nitems;
+    size_t i = 0;
+    unsigned long long content_len = 0;
+    char c = 0;
+
+    if (len <= ACVP_CONTENT_LENGTH_HDR_LEN) {
+        return len;
+    }
+    for (i = 0; i < ACVP_CONTENT_LENGTH_HDR_LEN; i++) {
+        c = ptr[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != ACVP_CONTENT_LENGTH_HDR[i]) {
+            return len;
+        }
+    }
+    for (; i < len && ptr[i] == ' '; i++);
+    for (; i < len && ptr[i] >= '0' && ptr[i] <= '9'; i++) {
+        content_len = content_len * 10 + (ptr[i] - '0');
+        if (content_len > INT_MAX) {
+            return len;
+        }
+    }
+    if (content_len) {
+        /* A failure here is not fatal, the write callback will try again */
+        acvp_curl_buf_reserve(exec, (size_t)content_len);
+    }
+
+    return len;
+}
+
 /*
  * This is a callback used by curl to send the HTTP body
  * to the application (us).  We will store the HTTP body
- * in the ACVP_CTX curl_buf field.
+ * in the curl_buf field of the exec state of the ACVP_CTX
+ * performing the request.
  */
 static size_t acvp_curl_write_callback(void *ptr, size_t size, size_t nmemb, void *userdata) {
-    ACVP_CTX *ctx = (ACVP_CTX *)userdata;
+    ACVP_EXEC_CTX *exec = (ACVP_EXEC_CTX *)userdata;
 
     if (size != 1) {
         fprintf(stderr, "\ncurl size not 1\n");
         return 0;
     }
 
-    if (!ctx->curl_buf) {
-        ctx->curl_buf = calloc(ACVP_CURL_BUF_MAX, sizeof(char));
-        if (!ctx->curl_buf) {
-            fprintf(stderr, "\nmalloc failed in curl write reg func\n");
-            return 0;
-        }
-    }
-
-    if ((ctx->curl_read_ctr + nmemb) > ACVP_CURL_BUF_MAX) {
-        fprintf(stderr, "\nServer response is too large\n");
+    if (!acvp_curl_buf_reserve(exec, nmemb)) {
+        fprintf(stderr, "\nmalloc failed in curl write reg func\n");
         return 0;
     }
 
-    memcpy_s(&ctx->curl_buf[ctx->curl_read_ctr], (ACVP_CURL_BUF_MAX - ctx->curl_read_ctr), ptr, nmemb);
-    ctx->curl_buf[ctx->curl_read_ctr + nmemb] = 0;
-    ctx->curl_read_ctr += nmemb;
+    memcpy_s(&exec->curl_buf[exec->curl_read_ctr], (exec->curl_buf_size - exec->curl_read_ctr), ptr, nmemb);
+    exec->curl_buf[exec->curl_read_ctr + nmemb] = 0;
+    exec->curl_read_ctr += nmemb;
 
     return nmemb;
 }
 
+#ifndef USE_MURL
 /*
- * This function uses libcurl to send a simple HTTP GET
- * request with no Content-Type header.
- * TLS peer verification is enabled, but not HTTP authentication.
- * The parameters are:
- *
- * ctx: Ptr to ACVP_CTX, which contains the server name
- * url: URL to use for the GET request
- *
- * Return value is the HTTP status value from the server
- * (e.g. 200 for HTTP OK)
+ * Callbacks used by curl to pull a request body that was streamed to a
+ * file (the upload_fp of the exec state) instead of being held in memory.
+ * The seek callback lets curl rewind the body if it has to be resent.
  */
-static long acvp_curl_http_get(ACVP_CTX *ctx, const char *url) {
-    long http_code = 0;
-    CURL *hnd = NULL;
-    struct curl_slist *slist = NULL;
+static size_t acvp_curl_read_callback(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    FILE *fp = (FILE *)userdata;
+    size_t len = fread(ptr, size, nmemb, fp);
+
+    if (len < nmemb && ferror(fp)) {
+        return CURL_READFUNC_ABORT;
+    }
+    return len;
+}
+
+static int acvp_curl_seek_callback(void *userdata, curl_off_t offset, int origin) {
+    FILE *fp = (FILE *)userdata;
+
+    if (offset > LONG_MAX || fseek(fp, (long)offset, origin)) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    return CURL_SEEKFUNC_OK;
+}
+#endif
+
+/*
+ * Sets the body of a POST or PUT. It is read from the exec state's
+ * upload_fp when one is set, otherwise data is sent from memory.
+ */
+static CURLcode acvp_curl_set_body(ACVP_CTX *ctx, CURL *hnd, const char *data, int data_len) {
     CURLcode crv = CURLE_OK;
 
+#ifndef USE_MURL
+    if (ctx->exec.upload_fp) {
+        rewind(ctx->exec.upload_fp);
+        /* Makes curl read the body, the method is still set by the caller */
+        crv = curl_easy_setopt(hnd, CURLOPT_POST, 1L);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POST, stopping"); return crv; }
+        crv = curl_easy_setopt(hnd, CURLOPT_READFUNCTION, acvp_curl_read_callback);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_READFUNCTION, stopping"); return crv; }
+        crv = curl_easy_setopt(hnd, CURLOPT_READDATA, ctx->exec.upload_fp);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_READDATA, stopping"); return crv; }
+        crv = curl_easy_setopt(hnd, CURLOPT_SEEKFUNCTION, acvp_curl_seek_callback);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SEEKFUNCTION, stopping"); return crv; }
+        crv = curl_easy_setopt(hnd, CURLOPT_SEEKDATA, ctx->exec.upload_fp);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SEEKDATA, stopping"); return crv; }
+        crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)data_len);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDSIZE_LARGE, stopping"); }
+        return crv;
+    }
+#endif
+    crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDS, data);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDS, stopping"); return crv; }
+    crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)data_len);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDSIZE_LARGE, stopping"); }
+    return crv;
+}
+
+#ifndef USE_MURL
+/*
+ * State shared by the curl handles of a session and all exec contexts
+ * derived from it, so that a worker's first request can resume the TLS
+ * session negotiated by the session (or another worker) instead of doing
+ * a full handshake, and host lookups are only done once.
+ */
+typedef struct acvp_curl_share_t {
+    CURLSH *share;
+    ACVP_MUTEX locks[CURL_LOCK_DATA_LAST];
+} ACVP_CURL_SHARE;
+
+static void acvp_curl_share_lock(CURL *hnd, curl_lock_data data, curl_lock_access access, void *userptr) {
+    ACVP_CURL_SHARE *sh = (ACVP_CURL_SHARE *)userptr;
+
+    (void)hnd;
+    (void)access;
+    if (data < CURL_LOCK_DATA_LAST) {
+        acvp_mutex_lock(&sh->locks[data]);
+    }
+}
+
+static void acvp_curl_share_unlock(CURL *hnd, curl_lock_data data, void *userptr) {
+    ACVP_CURL_SHARE *sh = (ACVP_CURL_SHARE *)userptr;
+
+    (void)hnd;
+    if (data < CURL_LOCK_DATA_LAST) {
+        acvp_mutex_unlock(&sh->locks[data]);
+    }
+}
+
+static void acvp_curl_share_free(ACVP_CURL_SHARE *sh) {
+    int i = 0;
+
+    if (!sh) {
+        return;
+    }
+    if (sh->share) {
+        curl_share_cleanup(sh->share);
+    }
+    for (i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        acvp_mutex_destroy(&sh->locks[i]);
+    }
+    free(sh);
+}
+
+static ACVP_CURL_SHARE *acvp_curl_share_new(void) {
+    ACVP_CURL_SHARE *sh = NULL;
+    int i = 0;
+
+    sh = calloc(1, sizeof(ACVP_CURL_SHARE));
+    if (!sh) {
+        return NULL;
+    }
+    for (i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        acvp_mutex_init(&sh->locks[i]);
+    }
+    sh->share = curl_share_init();
+    if (!sh->share) {
+        acvp_curl_share_free(sh);
+        return NULL;
+    }
     /*
-     * Create the Authorzation header if needed
+     * The connection cache itself is deliberately not shared; libcurl does
+     * not support using one connection from several threads at once.
      */
-    slist = acvp_add_auth_hdr(ctx, slist);
+    if (curl_share_setopt(sh->share, CURLSHOPT_LOCKFUNC, acvp_curl_share_lock) ||
+            curl_share_setopt(sh->share, CURLSHOPT_UNLOCKFUNC, acvp_curl_share_unlock) ||
+            curl_share_setopt(sh->share, CURLSHOPT_USERDATA, sh) ||
+            curl_share_setopt(sh->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) ||
+            curl_share_setopt(sh->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION)) {
+        acvp_curl_share_free(sh);
+        return NULL;
+    }
+    return sh;
+}
 
-    ctx->curl_read_ctr = 0;
+/*
+ * Returns the share object of the session ctx belongs to. It is created
+ * once, by acvp_transport_init(), before any exec context can exist, so it
+ * is only ever read here.
+ */
+static CURLSH *acvp_curl_get_share(ACVP_CTX *ctx) {
+    ACVP_CTX *session = ctx->session ? ctx->session : ctx;
+
+    if (!session->curl_share) {
+        return NULL;
+    }
+    return ((ACVP_CURL_SHARE *)session->curl_share)->share;
+}
+#endif
+
+/*
+ * Returns the curl handle in slot, normally that of the exec state (see
+ * acvp_curl_handle()), to use for the next request made by ctx. The
+ * handle is kept open between requests, so the libcurl connection cache
+ * can keep the TCP/TLS connection to the server alive and resume TLS
+ * sessions. This avoids a full handshake, client cert included, for
+ * every vector set fetch, response upload and status poll. Murl keeps
+ * its connection and TLS session on the handle in the same way. Options
+ * are cleared each time and set again by the caller.
+ */
+static CURL *acvp_curl_handle_in(ACVP_CTX *ctx, void **slot) {
+    CURL *hnd = NULL;
+#ifndef USE_MURL
+    CURLSH *share = NULL;
+#endif
+
+    if (*slot) {
+        curl_easy_reset((CURL *)*slot);
+    } else {
+        *slot = curl_easy_init();
+    }
+    hnd = (CURL *)*slot;
+    if (!hnd) {
+        return NULL;
+    }
+
+#ifndef USE_MURL
+    share = acvp_curl_get_share(ctx);
+    if (share) {
+        curl_easy_setopt(hnd, CURLOPT_SHARE, share);
+    }
+    /*
+     * Negotiate HTTP/2 through ALPN where both ends support it; falls back
+     * to HTTP/1.1 otherwise. Not fatal if this libcurl lacks HTTP/2.
+     */
+    curl_easy_setopt(hnd, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    /*
+     * Offer the server every content encoding this libcurl can decode
+     * (gzip, deflate, ...). Vector sets are hex heavy JSON that compresses
+     * several times over; the body is decoded before it reaches
+     * acvp_curl_write_callback(). A server that does not compress answers
+     * as before.
+     */
+    curl_easy_setopt(hnd, CURLOPT_ACCEPT_ENCODING, "");
+    /*
+     * The server name is resolved once, for as long as the handle (or the
+     * share of the session) lives, rather than again every 60 seconds.
+     */
+    curl_easy_setopt(hnd, CURLOPT_DNS_CACHE_TIMEOUT, -1L);
+#endif
+    return hnd;
+}
+
+static CURL *acvp_curl_handle(ACVP_CTX *ctx) {
+    return acvp_curl_handle_in(ctx, &ctx->exec.curl_hnd);
+}
+
+#ifndef USE_MURL
+/*
+ * The pre-connect of a session, see acvp_transport_preconnect()
+ */
+typedef struct acvp_preconnect_t {
+    ACVP_THREAD thread;
+    ACVP_CTX *ctx;
+} ACVP_PRECONNECT;
+
+static size_t acvp_curl_discard_callback(void *ptr, size_t size, size_t nmemb, void *userdata) {
+    (void)ptr;
+    (void)userdata;
+    return size * nmemb;
+}
+
+/*
+ * Sends a HEAD request for the root of the server on the session's own
+ * handle. The response does not matter; what is left behind is the
+ * resolved server name and the TLS session in the share, and the open
+ * connection in the handle, which has the same TLS options as every other
+ * request so that libcurl reuses it for the login.
+ */
+static void acvp_preconnect_thread(void *arg) {
+    ACVP_PRECONNECT *pc = (ACVP_PRECONNECT *)arg;
+    ACVP_CTX *ctx = pc->ctx;
+    char url[ACVP_ATTR_URL_MAX] = {0};
+    CURL *hnd = NULL;
+    CURLcode crv = CURLE_OK;
+
+    hnd = acvp_curl_handle(ctx);
+    if (!hnd) {
+        return;
+    }
+    snprintf(url, ACVP_ATTR_URL_MAX - 1, "https://%s:%d/", ctx->server_name, ctx->server_port);
+    curl_easy_setopt(hnd, CURLOPT_URL, url);
+    curl_easy_setopt(hnd, CURLOPT_NOBODY, 1L);
+    curl_easy_setopt(hnd, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(hnd, CURLOPT_USERAGENT, acvp_http_user_agent(ctx));
+    curl_easy_setopt(hnd, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(hnd, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
+    curl_easy_setopt(hnd, CURLOPT_SSL_VERIFYPEER, 1L);
+    if (ctx->cacerts_file) {
+        curl_easy_setopt(hnd, CURLOPT_CAINFO, ctx->cacerts_file);
+    }
+    if (ctx->tls_cert && ctx->tls_key) {
+        curl_easy_setopt(hnd, CURLOPT_SSLCERTTYPE, "PEM");
+        curl_easy_setopt(hnd, CURLOPT_SSLCERT, ctx->tls_cert);
+        curl_easy_setopt(hnd, CURLOPT_SSLKEYTYPE, "PEM");
+        curl_easy_setopt(hnd, CURLOPT_SSLKEY, ctx->tls_key);
+    }
+    curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, acvp_curl_discard_callback);
+    curl_easy_setopt(hnd, CURLOPT_HEADERFUNCTION, acvp_curl_discard_callback);
+
+    crv = curl_easy_perform(hnd);
+    if (crv != CURLE_OK) {
+        /* The login connects as it always has */
+        ACVP_LOG_WARN("Unable to pre-connect to %s: %s", ctx->server_name, curl_easy_strerror(crv));
+    } else {
+        ACVP_LOG_VERBOSE("Pre-connected to %s:%d", ctx->server_name, ctx->server_port);
+    }
+}
+#endif
+
+/*
+ * Like acvp_curl_handle(), once the pre-connect of a session, if one is
+ * under way, is done with the handle.
+ */
+static CURL *acvp_curl_acquire(ACVP_CTX *ctx) {
+    acvp_transport_preconnect_wait(ctx);
+    return acvp_curl_handle(ctx);
+}
+
+/*
+ * Sets hnd up for a GET of url, with the headers in slist, that stores what
+ * the server sends in exec. The GET is given up on after timeout_ms, unless
+ * that is 0.
+ */
+static CURLcode acvp_curl_get_setup(ACVP_CTX *ctx, CURL *hnd, const char *url, struct curl_slist *slist,
+                                    ACVP_EXEC_CTX *exec, long timeout_ms) {
+    CURLcode crv = CURLE_OK;
 
-    //Setup Curl
-    hnd = curl_easy_init();
-    if (!hnd) { ACVP_LOG_ERR("Error initializing Curl structure, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_URL, url);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_URL, stopping"); goto end; }
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_URL, stopping"); return crv; }
     crv = curl_easy_setopt(hnd, CURLOPT_NOPROGRESS, 1L);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_NOPROGRESS, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, ctx->http_user_agent);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_USERAGENT, stopping"); goto end; }
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_NOPROGRESS, stopping"); return crv; }
+    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, acvp_http_user_agent(ctx));
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_USERAGENT, stopping"); return crv; }
     crv = curl_easy_setopt(hnd, CURLOPT_TCP_KEEPALIVE, 1L);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_TCP_KEEPALIVE, stopping"); goto end; }
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_TCP_KEEPALIVE, stopping"); return crv; }
     crv = curl_easy_setopt(hnd, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLVERSION, stopping"); goto end; }
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLVERSION, stopping"); return crv; }
     if (slist) {
         crv = curl_easy_setopt(hnd, CURLOPT_HTTPHEADER, slist);
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HTTPHEADER, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HTTPHEADER, stopping"); return crv; }
     }
     //Always verify the server
     crv = curl_easy_setopt(hnd, CURLOPT_SSL_VERIFYPEER, 1L);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSL_VERIFYPEER, stopping"); goto end; }
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSL_VERIFYPEER, stopping"); return crv; }
     if (ctx->cacerts_file) {
         crv = curl_easy_setopt(hnd, CURLOPT_CAINFO, ctx->cacerts_file);
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_CAINFO, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_CAINFO, stopping"); return crv; }
         crv = curl_easy_setopt(hnd, CURLOPT_CERTINFO, 1L);
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_CERTINFO, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_CERTINFO, stopping"); return crv; }
     }
     //Mutual-auth
     if (ctx->tls_cert && ctx->tls_key) {
         crv = curl_easy_setopt(hnd, CURLOPT_SSLCERTTYPE, "PEM");
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLCERTTYPE, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLCERTTYPE, stopping"); return crv; }
         crv = curl_easy_setopt(hnd, CURLOPT_SSLCERT, ctx->tls_cert);
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLCERT, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLCERT, stopping"); return crv; }
         crv = curl_easy_setopt(hnd, CURLOPT_SSLKEYTYPE, "PEM");
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEYTYPE, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEYTYPE, stopping"); return crv; }
         crv = curl_easy_setopt(hnd, CURLOPT_SSLKEY, ctx->tls_key);
-        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEY, stopping"); goto end; }
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEY, stopping"); return crv; }
     }
 
     //To record the HTTP data recieved from the server, set the callback function.
-    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, ctx);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEDATA, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, exec);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEDATA, stopping"); return crv; }
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, acvp_curl_write_callback);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); return crv; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERDATA, exec);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERDATA, stopping"); return crv; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERFUNCTION, acvp_curl_header_callback);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERFUNCTION, stopping"); return crv; }
 
-    if (ctx->curl_buf) {
-        /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, ACVP_CURL_BUF_MAX);
+#ifndef USE_MURL
+    if (timeout_ms) {
+        crv = curl_easy_setopt(hnd, CURLOPT_TIMEOUT_MS, timeout_ms);
+        if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_TIMEOUT_MS, stopping"); return crv; }
     }
+#else
+    (void)timeout_ms;
+#endif
+    return CURLE_OK;
+}
 
-    /*
-     * Send the HTTP GET request
-     */
-    curl_easy_perform(hnd);
+#ifndef USE_MURL
+/*
+ * Sets the handle for the second send of a GET going, see
+ * acvp_curl_hedged_get(). Its response goes to an exec state of its own,
+ * returned in hexec.
+ */
+static CURL *acvp_curl_hedge_start(ACVP_CTX *ctx, CURLM *multi, const char *url, struct curl_slist *slist,
+                                   long timeout_ms, ACVP_EXEC_CTX **hexec) {
+    CURL *hedge = NULL;
+    ACVP_EXEC_CTX *exec = NULL;
+
+    hedge = acvp_curl_handle_in(ctx, &ctx->exec.curl_hedge_hnd);
+    if (!hedge) {
+        return NULL;
+    }
+    exec = calloc(1, sizeof(ACVP_EXEC_CTX));
+    if (!exec) {
+        return NULL;
+    }
+    exec->huge_pages = ctx->exec.huge_pages;
+    exec->mem = ctx->exec.mem;
+    if (acvp_curl_get_setup(ctx, hedge, url, slist, exec, timeout_ms) ||
+            curl_multi_add_handle(multi, hedge) != CURLM_OK) {
+        free(exec);
+        return NULL;
+    }
+    *hexec = exec;
+    return hedge;
+}
+
+/*
+ * Sends the GET hnd is set up for through the multi handle of ctx. Should
+ * the server not have started to answer within acvp_hedge_delay(), the GET
+ * is sent again on a second handle, and whichever completes first is taken;
+ * one that fails is only taken if the other fails too. The response ends up
+ * in the exec state of ctx either way. Returns the result of the transfer
+ * taken, with its HTTP status in http_code.
+ */
+static CURLcode acvp_curl_hedged_get(ACVP_CTX *ctx, CURL *hnd, const char *url, struct curl_slist *slist,
+                                     long *http_code) {
+    CURLM *multi = NULL;
+    CURL *hedge = NULL, *winner = NULL;
+    CURLMsg *msg = NULL;
+    ACVP_EXEC_CTX *hexec = NULL;
+    CURLcode hnd_rv = CURLE_FAILED_INIT, hedge_rv = CURLE_FAILED_INIT, crv = CURLE_OK;
+    unsigned long long int start = 0, now = 0, delay = 0, hedge_at = 0;
+    curl_off_t ttfb = 0;
+    long remaining = 0, code = 0;
+    int running = 0, left = 0, hnd_done = 0, hedge_done = 0, wait_ms = 0;
+    char *buf = NULL;
+    int n = 0;
+
+    if (!ctx->exec.curl_multi) {
+        ctx->exec.curl_multi = curl_multi_init();
+    }
+    multi = (CURLM *)ctx->exec.curl_multi;
+    if (!multi || curl_multi_add_handle(multi, hnd) != CURLM_OK) {
+        crv = curl_easy_perform(hnd);
+        curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, http_code);
+        return crv;
+    }
+    delay = acvp_hedge_delay(ctx);
+    start = acvp_metrics_now();
+
+    for (;;) {
+        if (curl_multi_perform(multi, &running) != CURLM_OK) {
+            winner = hnd;
+            break;
+        }
+        while ((msg = curl_multi_info_read(multi, &left))) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            if (msg->easy_handle == hnd) {
+                hnd_done = 1;
+                hnd_rv = msg->data.result;
+            } else if (msg->easy_handle == hedge) {
+                hedge_done = 1;
+                hedge_rv = msg->data.result;
+            }
+        }
+        if (hnd_done && (hnd_rv == CURLE_OK || !hedge || hedge_done)) {
+            winner = hnd;
+            break;
+        }
+        if (hedge_done && (hedge_rv == CURLE_OK || hnd_done)) {
+            winner = hedge;
+            break;
+        }
+
+        now = acvp_metrics_now();
+        if (!hedge && delay && now - start >= delay) {
+            /* An answer that has started is let run at its own pace */
+            code = 0;
+            curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &code);
+            remaining = ctx->request_timeout - (long)((now - start) / 1000000ULL);
+            if (!code && !hnd_done && (!ctx->request_timeout || remaining > 0)) {
+                hedge = acvp_curl_hedge_start(ctx, multi, url, slist, ctx->request_timeout ? remaining : 0, &hexec);
+                if (hedge) {
+                    hedge_at = now - start;
+                    ACVP_LOG_VERBOSE("No answer within %llu ms, sending GET %s again",
+                                     delay / 1000000ULL, url);
+                }
+            }
+            delay = 0;
+        }
+
+        wait_ms = 100;
+        if (delay) {
+            now = acvp_metrics_now() - start;
+            wait_ms = now >= delay ? 0 : (int)((delay - now + 999999ULL) / 1000000ULL);
+            if (wait_ms > 100) wait_ms = 100;
+        }
+        curl_multi_wait(multi, NULL, 0, wait_ms, NULL);
+    }
+
+    crv = winner == hedge ? hedge_rv : hnd_rv;
+    *http_code = 0;
+    curl_easy_getinfo(winner, CURLINFO_RESPONSE_CODE, http_code);
+    if (crv == CURLE_OK && curl_easy_getinfo(winner, CURLINFO_STARTTRANSFER_TIME_T, &ttfb) == CURLE_OK) {
+        acvp_hedge_record(ctx, (winner == hedge ? hedge_at : 0) + (unsigned long long int)ttfb * 1000ULL,
+                          hedge != NULL, winner == hedge);
+    }
+    curl_multi_remove_handle(multi, hnd);
+    if (hedge) {
+        curl_multi_remove_handle(multi, hedge);
+    }
+
+    if (hexec) {
+        if (winner == hedge) {
+            /* The response of the second send becomes that of ctx */
+            buf = ctx->exec.curl_buf;
+            ctx->exec.curl_buf = hexec->curl_buf;
+            hexec->curl_buf = buf;
+            n = ctx->exec.curl_buf_size;
+            ctx->exec.curl_buf_size = hexec->curl_buf_size;
+            hexec->curl_buf_size = n;
+            n = ctx->exec.curl_buf_mapped;
+            ctx->exec.curl_buf_mapped = hexec->curl_buf_mapped;
+            hexec->curl_buf_mapped = n;
+            ctx->exec.curl_read_ctr = hexec->curl_read_ctr;
+            ACVP_LOG_VERBOSE("GET %s was answered first the second time", url);
+        }
+        if (hexec->curl_buf) {
+            acvp_mem_credit(hexec->mem, (size_t)hexec->curl_buf_size);
+            acvp_big_free(hexec->curl_buf, (size_t)hexec->curl_buf_size, hexec->curl_buf_mapped);
+        }
+        free(hexec);
+    }
+    return crv;
+}
+#endif
+
+/*
+ * This function uses libcurl to send a simple HTTP GET
+ * request with no Content-Type header.
+ * TLS peer verification is enabled, but not HTTP authentication.
+ * The parameters are:
+ *
+ * ctx: Ptr to ACVP_CTX, which contains the server name
+ * url: URL to use for the GET request
+ *
+ * A GET that runs past the request timeout of the session, see
+ * acvp_set_request_timeout(), is sent once more, on a new connection.
+ *
+ * Return value is the HTTP status value from the server
+ * (e.g. 200 for HTTP OK), 0 if the response did not come in whole
+ */
+static long acvp_curl_http_get(ACVP_CTX *ctx, const char *url) {
+    long http_code = 0;
+    CURL *hnd = NULL;
+    struct curl_slist *slist = NULL;
+    CURLcode crv = CURLE_OK;
+    int retried = 0;
 
     /*
-     * Get the HTTP reponse status code from the server
+     * Create the Authorzation header if needed
      */
-    curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &http_code);
+    slist = acvp_add_auth_hdr(ctx, slist);
+
+    for (;;) {
+        ctx->exec.curl_read_ctr = 0;
+
+        //Setup Curl
+        hnd = acvp_curl_acquire(ctx);
+        if (!hnd) { ACVP_LOG_ERR("Error initializing Curl structure, stopping"); goto end; }
+        if (acvp_curl_get_setup(ctx, hnd, url, slist, &ctx->exec, ctx->request_timeout)) goto end;
+
+        acvp_curl_buf_reset(&ctx->exec);
+
+        /*
+         * Send the HTTP GET request, and get the HTTP reponse status code
+         * from the server
+         */
+#ifndef USE_MURL
+        if (ctx->hedge) {
+            crv = acvp_curl_hedged_get(ctx, hnd, url, slist, &http_code);
+        } else
+#endif
+        {
+            crv = curl_easy_perform(hnd);
+            curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &http_code);
+        }
+        if (crv == CURLE_OK) {
+            break;
+        }
+        /* A body cut short is no response at all */
+        http_code = 0;
+        if (crv != CURLE_OPERATION_TIMEDOUT || !ctx->request_timeout || retried) {
+            ACVP_LOG_ERR("Curl failed with code %d (%s)", crv, curl_easy_strerror(crv));
+            break;
+        }
+        ACVP_LOG_WARN("GET %s took over %d ms, sending it again", url, ctx->request_timeout);
+        retried = 1;
+    }
 
 end:
-    if (hnd) curl_easy_cleanup(hnd);
     hnd = NULL;
     if (slist) curl_slist_free_all(slist);
     slist = NULL;
@@ -290,16 +891,16 @@ static long acvp_curl_http_post(ACVP_CTX *ctx, const char *url, const char *data
      */
     slist = acvp_add_auth_hdr(ctx, slist);
 
-    ctx->curl_read_ctr = 0;
+    ctx->exec.curl_read_ctr = 0;
 
    //Setup Curl
-    hnd = curl_easy_init();
+    hnd = acvp_curl_acquire(ctx);
     if (!hnd) { ACVP_LOG_ERR("Error initializing Curl structure, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_URL, url);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_URL, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_NOPROGRESS, 1L);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_NOPROGRESS, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, ctx->http_user_agent);
+    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, acvp_http_user_agent(ctx));
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_USERAGENT, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_HTTPHEADER, slist);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HTTPHEADER, stopping"); goto end; }
@@ -307,10 +908,8 @@ static long acvp_curl_http_post(ACVP_CTX *ctx, const char *url, const char *data
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_CUSTOMREQUEST, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_POST, 1L);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POST, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDS, data);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDS, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)data_len);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDSIZE_LARGE, stopping"); goto end; }
+    crv = acvp_curl_set_body(ctx, hnd, data, data_len);
+    if (crv) goto end;
     crv = curl_easy_setopt(hnd, CURLOPT_TCP_KEEPALIVE, 1L);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_TCP_KEEPALIVE, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
@@ -336,15 +935,16 @@ static long acvp_curl_http_post(ACVP_CTX *ctx, const char *url, const char *data
         if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEY, stopping"); goto end; }
     }
     // To record the HTTP data recieved from the server, set the callback function.
-    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, ctx);
+    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, &ctx->exec);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEDATA, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, acvp_curl_write_callback);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERDATA, &ctx->exec);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERDATA, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERFUNCTION, acvp_curl_header_callback);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERFUNCTION, stopping"); goto end; }
 
-    if (ctx->curl_buf) {
-        /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, ACVP_CURL_BUF_MAX);
-    }
+    acvp_curl_buf_reset(&ctx->exec);
 
     /*
      * Send the HTTP POST request
@@ -360,7 +960,6 @@ static long acvp_curl_http_post(ACVP_CTX *ctx, const char *url, const char *data
     curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &http_code);
 
 end:
-    if (hnd) curl_easy_cleanup(hnd);
     hnd = NULL;
     if (slist) curl_slist_free_all(slist);
     slist = NULL;
@@ -388,7 +987,7 @@ static long acvp_curl_http_put(ACVP_CTX *ctx, const char *url, const char *data,
     struct curl_slist *slist = NULL;
 
 
-    ctx->curl_read_ctr = 0;
+    ctx->exec.curl_read_ctr = 0;
     /*
      * Set the Content-Type header in the HTTP request
      */
@@ -400,22 +999,20 @@ static long acvp_curl_http_put(ACVP_CTX *ctx, const char *url, const char *data,
     slist = acvp_add_auth_hdr(ctx, slist);
 
     //Setup Curl
-    hnd = curl_easy_init();
+    hnd = acvp_curl_acquire(ctx);
     if (!hnd) { ACVP_LOG_ERR("Error initializing Curl structure, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_URL, url);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_URL, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_NOPROGRESS, 1L);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_NOPROGRESS, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, ctx->http_user_agent);
+    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, acvp_http_user_agent(ctx));
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_USERAGENT, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_HTTPHEADER, slist);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HTTPHEADER, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_CUSTOMREQUEST, "PUT");
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_CUSTOMREQUEST, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDS, data);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDS, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)data_len);
-    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_POSTFIELDSIZE_LARGE, stopping"); goto end; }
+    crv = acvp_curl_set_body(ctx, hnd, data, data_len);
+    if (crv) goto end;
     crv = curl_easy_setopt(hnd, CURLOPT_TCP_KEEPALIVE, 1L);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_TCP_KEEPALIVE, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
@@ -441,17 +1038,18 @@ static long acvp_curl_http_put(ACVP_CTX *ctx, const char *url, const char *data,
         if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEY, stopping"); goto end; }
     }
     //To record the HTTP data recieved from the server, set the callback function.
-    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, ctx);
+    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, &ctx->exec);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEDATA, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, acvp_curl_write_callback);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERDATA, &ctx->exec);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERDATA, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERFUNCTION, acvp_curl_header_callback);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERFUNCTION, stopping"); goto end; }
 
-    if (ctx->curl_buf) {
-        /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, ACVP_CURL_BUF_MAX);
-    }
+    acvp_curl_buf_reset(&ctx->exec);
 
-    if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
+    if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE && data) {
         printf("\nHTTP PUT:\n\n%s\n", data);
     }
 
@@ -469,7 +1067,6 @@ static long acvp_curl_http_put(ACVP_CTX *ctx, const char *url, const char *data,
     curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &http_code);
 
 end:
-    if (hnd) curl_easy_cleanup(hnd);
     hnd = NULL;
     if (slist) curl_slist_free_all(slist);
     slist = NULL;
@@ -497,7 +1094,7 @@ static long acvp_curl_http_delete(ACVP_CTX *ctx, const char *url) {
     struct curl_slist *slist = NULL;
 
 
-    ctx->curl_read_ctr = 0;
+    ctx->exec.curl_read_ctr = 0;
     /*
      * Set the Content-Type header in the HTTP request
      */
@@ -509,13 +1106,13 @@ static long acvp_curl_http_delete(ACVP_CTX *ctx, const char *url) {
     slist = acvp_add_auth_hdr(ctx, slist);
 
     //Setup Curl
-    hnd = curl_easy_init();
+    hnd = acvp_curl_acquire(ctx);
     if (!hnd) { ACVP_LOG_ERR("Error initializing Curl structure, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_URL, url);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_URL, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_NOPROGRESS, 1L);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_NOPROGRESS, stopping"); goto end; }
-    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, ctx->http_user_agent);
+    crv = curl_easy_setopt(hnd, CURLOPT_USERAGENT, acvp_http_user_agent(ctx));
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_USERAGENT, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_HTTPHEADER, slist);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HTTPHEADER, stopping"); goto end; }
@@ -546,15 +1143,16 @@ static long acvp_curl_http_delete(ACVP_CTX *ctx, const char *url) {
         if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_SSLKEY, stopping"); goto end; }
     }
     //To record the HTTP data recieved from the server, set the callback function.
-    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, ctx);
+    crv = curl_easy_setopt(hnd, CURLOPT_WRITEDATA, &ctx->exec);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEDATA, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, acvp_curl_write_callback);
     if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERDATA, &ctx->exec);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERDATA, stopping"); goto end; }
+    crv = curl_easy_setopt(hnd, CURLOPT_HEADERFUNCTION, acvp_curl_header_callback);
+    if (crv) { ACVP_LOG_ERR("Error setting curl option CURLOPT_HEADERFUNCTION, stopping"); goto end; }
 
-    if (ctx->curl_buf) {
-        /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, ACVP_CURL_BUF_MAX);
-    }
+    acvp_curl_buf_reset(&ctx->exec);
 
     if (ctx->log_lvl == ACVP_LOG_LVL_VERBOSE) {
         printf("\nHTTP DELETE: %s\n", url);
@@ -574,7 +1172,6 @@ static long acvp_curl_http_delete(ACVP_CTX *ctx, const char *url) {
     curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &http_code);
 
 end:
-    if (hnd) curl_easy_cleanup(hnd);
     hnd = NULL;
     if (slist) curl_slist_free_all(slist);
     slist = NULL;
@@ -620,6 +1217,159 @@ static ACVP_RESULT acvp_send_with_path_seg(ACVP_CTX *ctx,
 }
 #endif
 
+/*
+ * Releases the buffer holding the body of the last server response. Callers
+ * use this once the body has been parsed into a DOM that is going to live
+ * for a while (e.g. a vector set being processed), so the raw text and the
+ * DOM built from it are not both held for the lifetime of the operation.
+ */
+void acvp_transport_release_buf(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return;
+    }
+    if (ctx->exec.curl_buf) {
+        acvp_mem_credit(ctx->exec.mem, (size_t)ctx->exec.curl_buf_size);
+        acvp_big_free(ctx->exec.curl_buf, (size_t)ctx->exec.curl_buf_size, ctx->exec.curl_buf_mapped);
+        ctx->exec.curl_buf = NULL;
+    }
+    ctx->exec.curl_buf_size = 0;
+    ctx->exec.curl_buf_mapped = 0;
+    ctx->exec.curl_read_ctr = 0;
+}
+
+/*
+ * Sets up the curl state a session shares with its exec contexts. Failure
+ * is not fatal, requests then just go without it.
+ */
+void acvp_transport_init(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return;
+    }
+#if !defined ACVP_OFFLINE && !defined USE_MURL
+    if (!ctx->session && !ctx->curl_share) {
+        ctx->curl_share = acvp_curl_share_new();
+    }
+#endif
+}
+
+/*
+ * Starts connecting to the server of a session in the background, see
+ * acvp_preconnect(). Does nothing while a pre-connect is already under way.
+ */
+ACVP_RESULT acvp_transport_preconnect(ACVP_CTX *ctx) {
+#if !defined ACVP_OFFLINE && !defined USE_MURL
+    ACVP_PRECONNECT *pc = NULL;
+
+    if (ctx->preconnect) {
+        return ACVP_SUCCESS;
+    }
+    pc = calloc(1, sizeof(ACVP_PRECONNECT));
+    if (!pc) {
+        return ACVP_MALLOC_FAIL;
+    }
+    pc->ctx = ctx;
+    if (acvp_thread_create(&pc->thread, acvp_preconnect_thread, pc) != ACVP_SUCCESS) {
+        free(pc);
+        return ACVP_TRANSPORT_FAIL;
+    }
+    ctx->preconnect = pc;
+    return ACVP_SUCCESS;
+#else
+    (void)ctx;
+    return ACVP_UNSUPPORTED_OP;
+#endif
+}
+
+/*
+ * Waits for the pre-connect of a session, if one is under way. Anything
+ * that uses the session's curl handle or share, or changes the server and
+ * TLS settings the pre-connect reads, calls this first. Exec contexts never
+ * pre-connect.
+ */
+void acvp_transport_preconnect_wait(ACVP_CTX *ctx) {
+#if !defined ACVP_OFFLINE && !defined USE_MURL
+    ACVP_PRECONNECT *pc = NULL;
+
+    if (!ctx || ctx->session || !ctx->preconnect) {
+        return;
+    }
+    pc = (ACVP_PRECONNECT *)ctx->preconnect;
+    acvp_thread_join(pc->thread);
+    free(pc);
+    ctx->preconnect = NULL;
+#else
+    (void)ctx;
+#endif
+}
+
+/*
+ * Curl state like that of acvp_transport_init(), for the sessions run by an
+ * orchestrator to share, see acvp_orch_run(). NULL if it can not be had.
+ */
+void *acvp_transport_share_new(void) {
+#if !defined ACVP_OFFLINE && !defined USE_MURL
+    return acvp_curl_share_new();
+#else
+    return NULL;
+#endif
+}
+
+void acvp_transport_share_free(void *share) {
+#if !defined ACVP_OFFLINE && !defined USE_MURL
+    acvp_curl_share_free((ACVP_CURL_SHARE *)share);
+#else
+    (void)share;
+#endif
+}
+
+/*
+ * Closes a curl handle taken out of a context, see acvp_orch_run()
+ */
+void acvp_transport_free_handle(void *hnd) {
+#ifndef ACVP_OFFLINE
+    if (hnd) {
+        curl_easy_cleanup((CURL *)hnd);
+    }
+#else
+    (void)hnd;
+#endif
+}
+
+/*
+ * Closes the connection kept open by ctx, if any, and for a session
+ * context the curl state shared with its exec contexts. Called when the
+ * context is freed.
+ */
+void acvp_transport_close(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return;
+    }
+    acvp_transport_preconnect_wait(ctx);
+#ifndef ACVP_OFFLINE
+    if (ctx->exec.curl_hnd) {
+        curl_easy_cleanup((CURL *)ctx->exec.curl_hnd);
+    }
+#ifndef USE_MURL
+    if (ctx->exec.curl_hedge_hnd) {
+        curl_easy_cleanup((CURL *)ctx->exec.curl_hedge_hnd);
+    }
+    if (ctx->exec.curl_multi) {
+        curl_multi_cleanup((CURLM *)ctx->exec.curl_multi);
+    }
+    /* The share belongs to the session, exec contexts only borrow it */
+    if (!ctx->session && ctx->curl_share) {
+        acvp_curl_share_free((ACVP_CURL_SHARE *)ctx->curl_share);
+    }
+#endif
+#endif
+    ctx->exec.curl_hnd = NULL;
+    ctx->exec.curl_hedge_hnd = NULL;
+    ctx->exec.curl_multi = NULL;
+    if (!ctx->session) {
+        ctx->curl_share = NULL;
+    }
+}
+
 /*
  * This is the transport function used within libacvp to register
  * the DUT attributes with the ACVP server.
@@ -688,6 +1438,34 @@ ACVP_RESULT acvp_submit_vector_responses(ACVP_CTX *ctx, char *vsid_url) {
 #endif
 }
 
+/*
+ * Serializes the vector set responses of ctx to a temporary file ahead of
+ * their upload, releasing the responses. The file can be handed, as
+ * exec.vs_resp_fp, to any context of the session, whose next
+ * acvp_submit_vector_responses() posts it in place of its own responses.
+ * NULL if the responses can not be streamed to a file; they are then left
+ * as they are.
+ */
+FILE *acvp_serialize_vs_resp(ACVP_CTX *ctx, int *len) {
+#ifdef ACVP_OFFLINE
+    (void)ctx;
+    (void)len;
+    return NULL;
+#else
+    FILE *fp = NULL;
+    unsigned long long int start = 0;
+
+    if (ctx->metrics_cb) start = acvp_metrics_now();
+    fp = acvp_stream_vs_resp(ctx, len);
+    if (fp) {
+        acvp_json_value_free(ctx->exec.kat_resp);
+        ctx->exec.kat_resp = NULL;
+    }
+    acvp_metrics_add(ctx, ACVP_METRICS_SERIALIZE, start);
+    return fp;
+#endif
+}
+
 ACVP_RESULT acvp_transport_post(ACVP_CTX *ctx,
                                 const char *uri,
                                 char *data,
@@ -966,7 +1744,7 @@ static ACVP_RESULT inspect_http_code(ACVP_CTX *ctx, int code) {
     if (code == HTTP_UNAUTH) {
         char *diff = NULL;
 
-        root_value = json_parse_string(ctx->curl_buf);
+        root_value = json_parse_string(ctx->exec.curl_buf);
 
         arr = json_value_get_array(root_value);
         if (!arr) {
@@ -1016,21 +1794,108 @@ end:
     return result;
 }
 
+/*
+ * Streams the vector set responses of ctx to a temporary file, so big
+ * response sets can be uploaded without their text being held in memory.
+ * Returns the file, positioned at its end, with len set to the body size;
+ * NULL if no temporary file can be used, the caller then serializes to a
+ * string instead, unless test groups were moved to disk, see
+ * acvp_spill_finish().
+ */
+static FILE *acvp_stream_vs_resp(ACVP_CTX *ctx, int *len) {
+#ifdef USE_MURL
+    (void)ctx;
+    (void)len;
+    return NULL;
+#else
+    FILE *fp = NULL;
+    long pos = 0;
+
+    if (ctx->exec.spill.count) {
+        return acvp_spill_finish(ctx, 1, len);
+    }
+    fp = tmpfile();
+    if (!fp) {
+        return NULL;
+    }
+    if (json_serialize_to_fp(ctx->exec.kat_resp, fp) != JSONSuccess || fflush(fp)) {
+        ACVP_LOG_WARN("Unable to stream vector set responses, serializing in memory");
+        fclose(fp);
+        return NULL;
+    }
+    pos = ftell(fp);
+    if (pos < 0 || pos > INT_MAX) {
+        fclose(fp);
+        return NULL;
+    }
+    *len = (int)pos;
+    return fp;
+#endif
+}
+
+/*
+ * POSTs the vector set responses, or PUTs them when put is set. The body
+ * is read from resp_fp when it was streamed to a file, otherwise from resp.
+ * The file is only attached to the exec state for this one request, other
+ * requests made meanwhile (/large notification, JWT refresh) keep their
+ * own bodies.
+ */
+static long acvp_curl_send_vs_resp(ACVP_CTX *ctx, const char *url, FILE *resp_fp,
+                                   const char *resp, int resp_len, int put) {
+    long rc = 0;
+
+    ctx->exec.upload_fp = resp_fp;
+    if (put) {
+        rc = acvp_curl_http_put(ctx, url, resp, resp_len);
+    } else {
+        rc = acvp_curl_http_post(ctx, url, resp, resp_len);
+    }
+    ctx->exec.upload_fp = NULL;
+    return rc;
+}
+
+/* The HTTP method of an action, as the exporter counts requests by */
+static ACVP_OM_METHOD acvp_om_method(ACVP_NET_ACTION action) {
+    switch (action) {
+    case ACVP_NET_GET:
+    case ACVP_NET_GET_VS:
+    case ACVP_NET_GET_VS_RESULT:
+    case ACVP_NET_GET_VS_SAMPLE:
+        return ACVP_OM_GET;
+    case ACVP_NET_PUT:
+    case ACVP_NET_PUT_VALIDATION:
+        return ACVP_OM_PUT;
+    case ACVP_NET_DELETE:
+        return ACVP_OM_DELETE;
+    case ACVP_NET_POST:
+    case ACVP_NET_POST_LOGIN:
+    case ACVP_NET_POST_REG:
+    case ACVP_NET_POST_VS_RESP:
+    default:
+        return ACVP_OM_POST;
+    }
+}
+
 static ACVP_RESULT execute_network_action(ACVP_CTX *ctx,
                                           ACVP_NET_ACTION action,
                                           const char *url,
                                           const char *data,
                                           int data_len,
-                                          int *curl_code) {
+                                          int *curl_code,
+                                          ACVP_SPAN *span) {
     ACVP_RESULT result = 0;
     char *resp = NULL;
+    const char *body = NULL;
+    FILE *resp_fp = NULL;
 #ifdef ACVP_DEPRECATED
     char large_url[ACVP_ATTR_URL_MAX + 1] = {0};
     int large_submission = 0;
 #endif
     int resp_len = 0;
     int rc = 0;
+    unsigned long long int start = 0;
 
+    if (ctx->metrics_cb || ctx->event_cb || ctx->openmetrics) start = acvp_metrics_now();
     switch(action) {
     case ACVP_NET_GET:
     case ACVP_NET_GET_VS:
@@ -1051,11 +1916,40 @@ static ACVP_RESULT execute_network_action(ACVP_CTX *ctx,
         break;
 
     case ACVP_NET_POST_VS_RESP:
-        resp = json_serialize_to_string(ctx->kat_resp, &resp_len);
-        if (!resp) {
-            ACVP_LOG_ERR("Failed to post vector set responses");
-            return ACVP_JSON_ERR;
+        if (ctx->exec.vs_resp_fp) {
+            /* Serialized ahead of time, see acvp_serialize_vs_resp() */
+            resp_fp = ctx->exec.vs_resp_fp;
+            resp_len = ctx->exec.vs_resp_len;
+            ctx->exec.vs_resp_fp = NULL;
+        } else if (ctx->exec.vs_resp_str) {
+            /* Serialized by the caller, who keeps it */
+            body = ctx->exec.vs_resp_str;
+            resp_len = ctx->exec.vs_resp_len;
+            ctx->exec.vs_resp_str = NULL;
+        } else {
+            resp_fp = acvp_stream_vs_resp(ctx, &resp_len);
         }
+        if (!resp_fp && !body) {
+            if (ctx->exec.spill.count) {
+                /* Some of the responses are only on disk */
+                ACVP_LOG_ERR("Failed to post vector set responses");
+                return ACVP_JSON_ERR;
+            }
+            resp = json_serialize_to_string(ctx->exec.kat_resp, &resp_len);
+            if (!resp) {
+                ACVP_LOG_ERR("Failed to post vector set responses");
+                return ACVP_JSON_ERR;
+            }
+            body = resp;
+        }
+        /*
+         * Only the serialized body is needed from here on, release the
+         * response DOM now rather than holding both for the upload.
+         */
+        acvp_json_value_free(ctx->exec.kat_resp);
+        ctx->exec.kat_resp = NULL;
+        acvp_metrics_add(ctx, ACVP_METRICS_SERIALIZE, start);
+        if (ctx->metrics_cb || ctx->event_cb || ctx->openmetrics) start = acvp_metrics_now();
 
 #ifdef ACVP_DEPRECATED
         if (ctx->post_size_constraint && resp_len > ctx->post_size_constraint) {
@@ -1071,14 +1965,15 @@ static ACVP_RESULT execute_network_action(ACVP_CTX *ctx,
             result = acvp_notify_large(ctx, url, large_url, resp_len);
             if (result != ACVP_SUCCESS) goto end;
 
-            rc = acvp_curl_http_post(ctx, large_url, resp, resp_len);
+            rc = acvp_curl_send_vs_resp(ctx, large_url, resp_fp, body, resp_len, 0);
         } else {
 #endif
-            rc = acvp_curl_http_post(ctx, url, resp, resp_len);
+            rc = acvp_curl_send_vs_resp(ctx, url, resp_fp, body, resp_len, 0);
             //Check for code 400, which means we are reuploading a resp and must use PUT instead
             result = inspect_http_code(ctx, rc);
             if (result == ACVP_UNSUPPORTED_OP) {
-                rc = acvp_curl_http_put(ctx, url, resp, resp_len);
+                span->retries++;
+                rc = acvp_curl_send_vs_resp(ctx, url, resp_fp, body, resp_len, 1);
             }
 #ifdef ACVP_DEPRECATED
         }
@@ -1115,6 +2010,7 @@ static ACVP_RESULT execute_network_action(ACVP_CTX *ctx,
             }
 
             /* Try action again after the refresh */
+            span->retries++;
             switch(action) {
             case ACVP_NET_GET:
             case ACVP_NET_GET_VS:
@@ -1136,14 +2032,15 @@ static ACVP_RESULT execute_network_action(ACVP_CTX *ctx,
             case ACVP_NET_POST_VS_RESP:
 #ifdef ACVP_DEPRECATED
                 if (large_submission) {
-                    rc = acvp_curl_http_post(ctx, large_url, resp, resp_len);
+                    rc = acvp_curl_send_vs_resp(ctx, large_url, resp_fp, body, resp_len, 0);
                 } else {
 #endif
-                    rc = acvp_curl_http_post(ctx, url, resp, resp_len);
+                    rc = acvp_curl_send_vs_resp(ctx, url, resp_fp, body, resp_len, 0);
                     //Check for code 400, which means we are reuploading a resp and must use PUT instead
                     result = inspect_http_code(ctx, rc);
                     if (result == ACVP_UNSUPPORTED_OP) {
-                        rc = acvp_curl_http_put(ctx, url, resp, resp_len);
+                        span->retries++;
+                        rc = acvp_curl_send_vs_resp(ctx, url, resp_fp, body, resp_len, 1);
                     }
 #ifdef ACVP_DEPRECATED
                 }
@@ -1179,6 +2076,31 @@ static ACVP_RESULT execute_network_action(ACVP_CTX *ctx,
 
 end:
     if (resp) json_free_serialized_string(resp);
+    if (resp_fp) fclose(resp_fp);
+    acvp_metrics_add(ctx, ACVP_METRICS_TRANSPORT, start);
+    span->http_status = rc;
+    span->bytes_in = ctx->exec.curl_read_ctr;
+    span->bytes_out = resp_len ? resp_len : (data_len > 0 ? data_len : 0);
+    if (ctx->openmetrics) {
+        acvp_om_transfer(ctx, acvp_om_method(action), rc, span->bytes_in, span->bytes_out,
+                         acvp_metrics_now() - start);
+    }
+    if (ctx->event_cb) {
+        ACVP_EVENT event;
+
+        memzero_s(&event, sizeof(ACVP_EVENT));
+        event.type = ACVP_EVENT_TRANSFER;
+        if (action == ACVP_NET_POST_VS_RESP) {
+            event.vs_id = ctx->exec.vs_id;
+        }
+        event.result = result;
+        event.http_status = rc;
+        event.url = url;
+        event.bytes_in = span->bytes_in;
+        event.bytes_out = span->bytes_out;
+        event.elapsed_ns = acvp_metrics_now() - start;
+        acvp_event_emit(ctx, &event);
+    }
 
     *curl_code = rc;
 
@@ -1193,23 +2115,23 @@ static void log_network_status(ACVP_CTX *ctx,
     switch(action) {
     case ACVP_NET_GET:
         ACVP_LOG_VERBOSE("GET...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                      curl_code, url, ctx->curl_buf);
+                      curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_GET_VS:
         ACVP_LOG_VERBOSE("GET Vector Set...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                         curl_code, url, ctx->curl_buf);
+                         curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_GET_VS_RESULT:
         ACVP_LOG_VERBOSE("GET Vector Set Result...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_GET_VS_SAMPLE:
         ACVP_LOG_VERBOSE("GET Vector Set Sample...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_POST:
         ACVP_LOG_VERBOSE("POST...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_POST_LOGIN:
         ACVP_LOG_VERBOSE("POST Login...\n\tStatus: %d\n\tUrl: %s\n\tResp: Recieved\n",
@@ -1221,19 +2143,19 @@ static void log_network_status(ACVP_CTX *ctx,
         break;
     case ACVP_NET_POST_VS_RESP:
         ACVP_LOG_VERBOSE("POST Response Submission...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                      curl_code, url, ctx->curl_buf);
+                      curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_PUT:
         ACVP_LOG_VERBOSE("PUT...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_PUT_VALIDATION:
         ACVP_LOG_VERBOSE("PUT testSession Validation...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->exec.curl_buf);
         break;
     case ACVP_NET_DELETE:
         ACVP_LOG_VERBOSE("DELETE...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                       curl_code, url, ctx->curl_buf);
+                       curl_code, url, ctx->exec.curl_buf);
         break;
     default:
         ACVP_LOG_ERR("We should never be here!");
@@ -1245,7 +2167,7 @@ static void log_network_status(ACVP_CTX *ctx,
         ACVP_LOG_ERR("Received no response from server.");
     } else if (curl_code < 200 || curl_code >= 300) {
         ACVP_LOG_ERR("%d error received from server. Message:", curl_code);
-        ACVP_LOG_ERR("%s", ctx->curl_buf);
+        ACVP_LOG_ERR("%s", ctx->exec.curl_buf);
     }
 
 }
@@ -1255,6 +2177,16 @@ static void log_network_status(ACVP_CTX *ctx,
  * parameter. This removes repeated code without having to change the
  * API that the library uses to send registrations
  */
+/*
+ * Non-zero if the JWT of ctx runs out within ACVP_JWT_REFRESH_MARGIN
+ */
+static int acvp_jwt_expiring(ACVP_CTX *ctx) {
+    if (!ctx->jwt_token || ctx->use_tmp_jwt || !ctx->jwt_expiry) {
+        return 0;
+    }
+    return time(NULL) + ACVP_JWT_REFRESH_MARGIN >= ctx->jwt_expiry;
+}
+
 static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx,
                                        ACVP_NET_ACTION action,
                                        const char *url,
@@ -1264,6 +2196,7 @@ static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx,
     ACVP_NET_ACTION generic_action = 0;
     int check_data = 0;
     int curl_code = 0;
+    ACVP_SPAN span;
 
     if (!ctx) {
         ACVP_LOG_ERR("Missing ctx");
@@ -1275,6 +2208,18 @@ static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx,
         return ACVP_MISSING_ARG;
     }
 
+    /*
+     * Get a new JWT shortly before the old one runs out, rather than have
+     * the server reject the request and send it again, which for a large
+     * upload means sending the whole body twice.
+     */
+    if (action != ACVP_NET_POST_LOGIN && acvp_jwt_expiring(ctx)) {
+        ACVP_LOG_STATUS("JWT is about to expire, refreshing session...");
+        if (acvp_refresh(ctx) != ACVP_SUCCESS) {
+            ACVP_LOG_WARN("Early JWT refresh failed, continuing with the request");
+        }
+    }
+
     switch (action) {
     case ACVP_NET_GET:
     case ACVP_NET_GET_VS:
@@ -1293,6 +2238,7 @@ static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx,
         /* Clear jwt if logging in */
         if (ctx->jwt_token) free(ctx->jwt_token);
         ctx->jwt_token = NULL;
+        ctx->jwt_expiry = 0;
         check_data = 1;
         generic_action = ACVP_NET_POST_LOGIN;
         break;
@@ -1319,11 +2265,25 @@ static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx,
         return ACVP_NO_DATA;
     }
 
-    rv = execute_network_action(ctx, generic_action, url,
-                                data, data_len, &curl_code);
+    acvp_span_begin(ctx, &span, ACVP_SPAN_TRANSPORT);
+    span.action = acvp_net_action_name[action];
+    span.url = url;
+    if (action != ACVP_NET_POST_LOGIN && ctx->xfer) {
+        unsigned long long int start = acvp_metrics_now();
+
+        acvp_xfer_acquire(ctx);
+        rv = execute_network_action(ctx, generic_action, url,
+                                    data, data_len, &curl_code, &span);
+        acvp_xfer_release(ctx, span.http_status, span.bytes_in + span.bytes_out,
+                          acvp_metrics_now() - start);
+    } else {
+        rv = execute_network_action(ctx, generic_action, url,
+                                    data, data_len, &curl_code, &span);
+    }
 
     /* Log to the console */
     log_network_status(ctx, action, curl_code, url);
+    acvp_span_end(ctx, &span, rv);
 
     return rv;
 }
@@ -1331,50 +2291,63 @@ static ACVP_RESULT acvp_network_action(ACVP_CTX *ctx,
 #endif
 
 #ifndef ACVP_OFFLINE
-/**
- * This function is called to look for operating enivronment info in the environment
- * for the HTTP user-agent string when the library cannot automatically find it
+/*
+ * The user agent is worked out once for the process, the first time any
+ * context makes a request, rather than as each context is set up; offline
+ * runs never need it. What could not be found is kept for each context to
+ * log the first time it uses the user agent.
  */
-static void acvp_http_user_agent_check_env_for_var(ACVP_CTX *ctx, char *var_string, ACVP_OE_ENV_VAR var_to_check) {
-    unsigned int maxLength = 0;
-    const char *var;
+static char acvp_user_agent[ACVP_USER_AGENT_STR_MAX + 1];
+static ACVP_ONCE acvp_user_agent_once = ACVP_ONCE_INIT;
+static unsigned int acvp_user_agent_unset;    /* Bit per ACVP_OE_ENV_VAR not found */
+static unsigned int acvp_user_agent_too_long; /* Bit per ACVP_OE_ENV_VAR whose variable was too long */
 
+static const char *acvp_http_user_agent_env_var(ACVP_OE_ENV_VAR var_to_check, unsigned int *maxLength) {
     switch(var_to_check) {
     case ACVP_USER_AGENT_OSNAME:
-        var = ACVP_USER_AGENT_OSNAME_ENV;
-        maxLength = ACVP_USER_AGENT_OSNAME_STR_MAX;
-        break;
+        *maxLength = ACVP_USER_AGENT_OSNAME_STR_MAX;
+        return ACVP_USER_AGENT_OSNAME_ENV;
     case ACVP_USER_AGENT_OSVER:
-        var = ACVP_USER_AGENT_OSVER_ENV;
-        maxLength = ACVP_USER_AGENT_OSVER_STR_MAX;
-        break;
+        *maxLength = ACVP_USER_AGENT_OSVER_STR_MAX;
+        return ACVP_USER_AGENT_OSVER_ENV;
     case ACVP_USER_AGENT_ARCH:
-        var = ACVP_USER_AGENT_ARCH_ENV;
-        maxLength = ACVP_USER_AGENT_ARCH_STR_MAX;
-        break;
+        *maxLength = ACVP_USER_AGENT_ARCH_STR_MAX;
+        return ACVP_USER_AGENT_ARCH_ENV;
     case ACVP_USER_AGENT_PROC:
-        var = ACVP_USER_AGENT_PROC_ENV;
-        maxLength = ACVP_USER_AGENT_PROC_STR_MAX;
-        break;
+        *maxLength = ACVP_USER_AGENT_PROC_STR_MAX;
+        return ACVP_USER_AGENT_PROC_ENV;
     case ACVP_USER_AGENT_COMP:
-        var = ACVP_USER_AGENT_COMP_ENV;
-        maxLength = ACVP_USER_AGENT_COMP_STR_MAX;
-        break;
+        *maxLength = ACVP_USER_AGENT_COMP_STR_MAX;
+        return ACVP_USER_AGENT_COMP_ENV;
     case ACVP_USER_AGENT_NONE:
     default:
+        *maxLength = 0;
+        return NULL;
+    }
+}
+
+/**
+ * This function is called to look for operating enivronment info in the environment
+ * for the HTTP user-agent string when the library cannot automatically find it
+ */
+static void acvp_http_user_agent_check_env_for_var(char *var_string, ACVP_OE_ENV_VAR var_to_check) {
+    unsigned int maxLength = 0;
+    const char *var = acvp_http_user_agent_env_var(var_to_check, &maxLength);
+
+    if (!var) {
         return;
     }
 
-    //Check presence and length of variable's value, concatenate if valid, warn and ignore if not
+    //Check presence and length of variable's value, concatenate if valid, note and ignore if not
     char *envVal = getenv(var);
     if (envVal) {
         if (strnlen_s(envVal, maxLength + 1) > maxLength) {
-            ACVP_LOG_WARN("Environment-provided %s string too long! (%d char max.) Omitting...\n", var, maxLength);
+            acvp_user_agent_too_long |= 1u << var_to_check;
         } else {
             strncpy_s(var_string, maxLength + 1, envVal, maxLength);
         }
     } else {
-        ACVP_LOG_INFO("Unable to collect info for HTTP user-agent - consider defining %s (%d char max.) This is optional and will not affect testing.", var, maxLength);
+        acvp_user_agent_unset |= 1u << var_to_check;
     }
 }
 
@@ -1405,7 +2378,7 @@ static void acvp_http_user_agent_check_compiler_ver(char *comp_string) {
     snprintf(versionBuffer, sizeof(versionBuffer), "%d", _MSC_FULL_VER);
     strncat_s(comp_string, ACVP_USER_AGENT_COMP_STR_MAX + 1, versionBuffer, ACVP_USER_AGENT_COMP_STR_MAX);
 #else
-    acvp_http_user_agent_check_env_for_var(ctx, comp_string, ACVP_USER_AGENT_COMP);
+    acvp_http_user_agent_check_env_for_var(comp_string, ACVP_USER_AGENT_COMP);
 #endif
 }
 
@@ -1433,21 +2406,10 @@ static void acvp_http_user_agent_string_clean(char *str) {
 }
 #endif //for ifndef ACVP_OFFLINE
 
-void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
-#ifdef ACVP_OFFLINE
-    ACVP_LOG_INFO("Offline mode, skipping user agent...");
-    return;
-#else
-    if (!ctx || ctx->http_user_agent) {
-        ACVP_LOG_WARN("Error generating HTTP user-agent - no CTX or string already exists\n");
-        return;
-    } else {
-        ctx->http_user_agent = calloc(ACVP_USER_AGENT_STR_MAX + 1, sizeof(char));
-        if (!ctx->http_user_agent) {
-            ACVP_LOG_ERR("Unable to allocate memory for user agent, skipping...");
-            return;
-        }
-    }
+#ifndef ACVP_OFFLINE
+static void acvp_http_user_agent_build(void) {
+    /* Not built for any one context, so there is none to log to */
+    ACVP_CTX *ctx = NULL;
 
     char *libver = calloc(ACVP_USER_AGENT_ACVP_STR_MAX + 1, sizeof(char));
     char *osname = calloc(ACVP_USER_AGENT_OSNAME_STR_MAX + 1, sizeof(char));
@@ -1469,9 +2431,9 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
     //collects basic OS/hardware info
     struct utsname info;
     if (uname(&info) != 0) {
-        acvp_http_user_agent_check_env_for_var(ctx, osname, ACVP_USER_AGENT_OSNAME);
-        acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
-        acvp_http_user_agent_check_env_for_var(ctx, arch, ACVP_USER_AGENT_ARCH);
+        acvp_http_user_agent_check_env_for_var(osname, ACVP_USER_AGENT_OSNAME);
+        acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
+        acvp_http_user_agent_check_env_for_var(arch, ACVP_USER_AGENT_ARCH);
     } else {
         //usually Linux/Darwin
         strncpy_s(osname, ACVP_USER_AGENT_OSNAME_STR_MAX + 1, info.sysname, ACVP_USER_AGENT_OSNAME_STR_MAX);
@@ -1491,23 +2453,23 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
     char brandString[48];
 
     if (!__get_cpuid(0x80000002, &registers[0], &registers[1], &registers[2], &registers[3])) {
-        acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+        acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
     } else {
         memcpy_s(brandString, 16, &registers, 16);
     }
     if (!__get_cpuid(0x80000003, &registers[0], &registers[1], &registers[2], &registers[3])) {
-        acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+        acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
     } else {
         memcpy_s(brandString + 16, 16, &registers, 16);
     }
     if (!__get_cpuid(0x80000004, &registers[0], &registers[1], &registers[2], &registers[3])) {
-        acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+        acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
     } else {
         memcpy_s(brandString + 32, 16, &registers, 16);
         strncpy_s(proc, ACVP_USER_AGENT_PROC_STR_MAX + 1, brandString, ACVP_USER_AGENT_PROC_STR_MAX);
     }
 #else
-    acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+    acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
 #endif
 
     //gets compiler version, or checks environment for it
@@ -1519,14 +2481,14 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
     long status = RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion", 0,
                   KEY_QUERY_VALUE | KEY_WOW64_64KEY, &key);
     if (status != ERROR_SUCCESS) {
-        acvp_http_user_agent_check_env_for_var(ctx, osname, ACVP_USER_AGENT_OSNAME);
-        acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
+        acvp_http_user_agent_check_env_for_var(osname, ACVP_USER_AGENT_OSNAME);
+        acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
     } else {
         //product name string, containing general version of windows
         DWORD bufferLength;
         if (RegQueryValueExW(key, L"ProductName", NULL, NULL, NULL, &bufferLength) != ERROR_SUCCESS) {
             ACVP_LOG_WARN("Unable to access Windows OS name, checking environment or omitting from HTTP user-agent...\n");
-            acvp_http_user_agent_check_env_for_var(ctx, osname, ACVP_USER_AGENT_OSNAME);
+            acvp_http_user_agent_check_env_for_var(osname, ACVP_USER_AGENT_OSNAME);
         } else {
             //get string - registry strings not garuanteed to be null terminated
             wchar_t *productNameBuffer = calloc(bufferLength + 1, sizeof(wchar_t));
@@ -1535,13 +2497,13 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
             } else if (RegQueryValueExW(key, L"ProductName", NULL, NULL, productNameBuffer, &bufferLength) != ERROR_SUCCESS) {
                 ACVP_LOG_WARN("Unable to access Windows OS name, checking environment or omitting from HTTP user-agent...\n");
                 free(productNameBuffer);
-                acvp_http_user_agent_check_env_for_var(ctx, osname, ACVP_USER_AGENT_OSNAME);
+                acvp_http_user_agent_check_env_for_var(osname, ACVP_USER_AGENT_OSNAME);
             } else {
                 //Windows uses UTF16, and everyone else uses UTF8
                 char *utf8String = calloc(bufferLength + 1, sizeof(char));
                 if (!utf8String || !WideCharToMultiByte(CP_UTF8, 0, productNameBuffer, -1, utf8String, bufferLength + 1, NULL, NULL)) {
                     ACVP_LOG_ERR("Error converting Windows version to UTF8, checking environment or omitting from HTTP user-agent...\n");
-                    acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
+                    acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
                 } else {
                     strncpy_s(osname, ACVP_USER_AGENT_OSNAME_STR_MAX + 1, utf8String, ACVP_USER_AGENT_OSNAME_STR_MAX);
                 }
@@ -1554,7 +2516,7 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
         //get the "BuildLab" string, which contains more specific windows build information
         if (RegQueryValueExW(key, L"BuildLab", NULL, NULL, NULL, &bufferLength) != ERROR_SUCCESS) {
             ACVP_LOG_WARN("Unable to access Windows version, checking environment or omitting from HTTP user-agent...\n");
-            acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
+            acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
         } else {
             //get string - registry strings not garuanteed to be null terminated
             wchar_t *buildLabBuffer = calloc(bufferLength + 1, sizeof(wchar_t));
@@ -1562,14 +2524,14 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
                 ACVP_LOG_ERR("Unable to allocate memory while generating windows OS version, skipping...\n");
             } else if (RegQueryValueExW(key, L"BuildLab", NULL, NULL, buildLabBuffer, &bufferLength) != ERROR_SUCCESS) {
                 ACVP_LOG_WARN("Unable to access Windows version, checking environment or omitting from HTTP user-agent...\n");
-                acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
+                acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
                 free(buildLabBuffer);
             } else {
                 //Windows uses UTF16, and everyone else uses UTF8
                 char *utf8String = calloc(bufferLength + 1, sizeof(char));
                 if (!utf8String || !WideCharToMultiByte(CP_UTF8, 0, buildLabBuffer, -1, utf8String, bufferLength + 1, NULL, NULL)) {
                     ACVP_LOG_ERR("Error converting Windows build info to UTF8, checking environment or omitting from HTTP user-agent...\n");
-                    acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
+                    acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
                 } else {
                     strncpy_s(osver, ACVP_USER_AGENT_OSVER_STR_MAX + 1, utf8String, ACVP_USER_AGENT_OSVER_STR_MAX);
                 }
@@ -1582,8 +2544,8 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
     SYSTEM_INFO sysInfo;
     GetNativeSystemInfo(&sysInfo);
     if (!sysInfo.dwOemId) {
-        acvp_http_user_agent_check_env_for_var(ctx, arch, ACVP_USER_AGENT_ARCH);
-        acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+        acvp_http_user_agent_check_env_for_var(arch, ACVP_USER_AGENT_ARCH);
+        acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
     } else {
         char brandString[48];
         int brandString_resp[4];
@@ -1612,23 +2574,23 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
             break;
         case PROCESSOR_ARCHITECTURE_ARM64:
             strncpy_s(arch, ACVP_USER_AGENT_ARCH_STR_MAX + 1, "aarch64", ACVP_USER_AGENT_ARCH_STR_MAX);
-            acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+            acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
             break;
         case PROCESSOR_ARCHITECTURE_ARM:
             strncpy_s(arch, ACVP_USER_AGENT_ARCH_STR_MAX + 1, "arm", ACVP_USER_AGENT_ARCH_STR_MAX);
-            acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+            acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
             break;
         case PROCESSOR_ARCHITECTURE_PPC:
             strncpy_s(arch, ACVP_USER_AGENT_ARCH_STR_MAX + 1, "ppc", ACVP_USER_AGENT_ARCH_STR_MAX);
-            acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+            acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
             break;
         case PROCESSOR_ARCHITECTURE_MIPS:
             strncpy_s(arch, ACVP_USER_AGENT_ARCH_STR_MAX + 1, "mips", ACVP_USER_AGENT_ARCH_STR_MAX);
-            acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+            acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
             break;
         default:
-            acvp_http_user_agent_check_env_for_var(ctx, arch, ACVP_USER_AGENT_ARCH);
-            acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+            acvp_http_user_agent_check_env_for_var(arch, ACVP_USER_AGENT_ARCH);
+            acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
             break;
         }     
     }
@@ -1641,10 +2603,10 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
      * Code for getting OE information on platforms that   *
      * are not Windows, Linux, or Mac OS can be added here *
      *******************************************************/
-    acvp_http_user_agent_check_env_for_var(ctx, osname, ACVP_USER_AGENT_OSNAME);
-    acvp_http_user_agent_check_env_for_var(ctx, osver, ACVP_USER_AGENT_OSVER);
-    acvp_http_user_agent_check_env_for_var(ctx, arch, ACVP_USER_AGENT_ARCH);
-    acvp_http_user_agent_check_env_for_var(ctx, proc, ACVP_USER_AGENT_PROC);
+    acvp_http_user_agent_check_env_for_var(osname, ACVP_USER_AGENT_OSNAME);
+    acvp_http_user_agent_check_env_for_var(osver, ACVP_USER_AGENT_OSVER);
+    acvp_http_user_agent_check_env_for_var(arch, ACVP_USER_AGENT_ARCH);
+    acvp_http_user_agent_check_env_for_var(proc, ACVP_USER_AGENT_PROC);
     acvp_http_user_agent_check_compiler_ver(comp);
 #endif
 
@@ -1654,8 +2616,7 @@ void acvp_http_user_agent_handler(ACVP_CTX *ctx) {
     acvp_http_user_agent_string_clean(proc);
     acvp_http_user_agent_string_clean(comp);
 
-    snprintf(ctx->http_user_agent, ACVP_USER_AGENT_STR_MAX, "%s;%s;%s;%s;%s;%s", libver, osname, osver, arch, proc, comp);
-    ACVP_LOG_INFO("HTTP User-Agent: %s\n", ctx->http_user_agent);
+    snprintf(acvp_user_agent, ACVP_USER_AGENT_STR_MAX, "%s;%s;%s;%s;%s;%s", libver, osname, osver, arch, proc, comp);
 
 end:
     free(libver);
@@ -1664,5 +2625,34 @@ end:
     free(arch);
     free(proc);
     free(comp);
+}
+#endif
+
+/*
+ * The HTTP user-agent string sent with each request, worked out the first
+ * time it is asked for
+ */
+const char *acvp_http_user_agent(ACVP_CTX *ctx) {
+#ifdef ACVP_OFFLINE
+    return "";
+#else
+    unsigned int maxLength = 0;
+    const char *var = NULL;
+    int i = 0;
+
+    acvp_once(&acvp_user_agent_once, acvp_http_user_agent_build);
+    if (ctx && !ctx->user_agent_logged) {
+        ctx->user_agent_logged = 1;
+        for (i = ACVP_USER_AGENT_OSNAME; i < ACVP_USER_AGENT_NONE; i++) {
+            var = acvp_http_user_agent_env_var((ACVP_OE_ENV_VAR)i, &maxLength);
+            if (acvp_user_agent_too_long & (1u << i)) {
+                ACVP_LOG_WARN("Environment-provided %s string too long! (%d char max.) Omitting...\n", var, maxLength);
+            } else if (acvp_user_agent_unset & (1u << i)) {
+                ACVP_LOG_INFO("Unable to collect info for HTTP user-agent - consider defining %s (%d char max.) This is optional and will not affect testing.", var, maxLength);
+            }
+        }
+        ACVP_LOG_INFO("HTTP User-Agent: %s\n", acvp_user_agent);
+    }
+    return acvp_user_agent;
 #endif
 }
@@ -10,9 +10,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdarg.h>
 #include <ctype.h>
+#include <limits.h>
+#include <errno.h>
 #include "acvp.h"
 #include "acvp_lcl.h"
 #include "safe_lib.h"
@@ -22,7 +25,14 @@
 #include <Windows.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <stdint.h>
 #endif
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "acvp_sse2.h"
 
 #ifdef USE_MURL
 #include "murl.h"
@@ -32,10 +42,140 @@
 
 extern ACVP_ALG_HANDLER alg_tbl[];
 
-static int acvp_char_to_int(char ch);
+/*
+ * The async log sink. Messages are formatted by the thread logging them
+ * into the next free slot of the ring, and a writer thread hands them to
+ * the logging callback in the order they were put in. A thread logging to
+ * a full ring waits for a slot, so nothing is lost.
+ */
+struct acvp_log_ring_t {
+    ACVP_MUTEX lock;
+    ACVP_COND cond;          /* signaled as slots are filled and emptied */
+    ACVP_THREAD writer;
+    ACVP_RESULT (*cb) (char *msg, ACVP_LOG_LVL level);
+    ACVP_LOG_LVL *levels;
+    char *msgs;              /* size slots of ACVP_LOG_MAX_MSG_LEN + 1 */
+    int size;
+    int head;                /* oldest message */
+    int count;               /* messages not yet handed to cb */
+    int stop;
+};
+
+static void acvp_log_ring_put(ACVP_LOG_RING *ring, const char *msg, ACVP_LOG_LVL level) {
+    int slot = 0;
+
+    acvp_mutex_lock(&ring->lock);
+    while (ring->count == ring->size) {
+        acvp_cond_wait(&ring->cond, &ring->lock);
+    }
+    slot = (ring->head + ring->count) % ring->size;
+    strcpy_s(ring->msgs + (size_t)slot * (ACVP_LOG_MAX_MSG_LEN + 1), ACVP_LOG_MAX_MSG_LEN + 1, msg);
+    ring->levels[slot] = level;
+    ring->count++;
+    acvp_cond_broadcast(&ring->cond);
+    acvp_mutex_unlock(&ring->lock);
+}
+
+/*
+ * The writer thread. The callback is run without the lock held, so other
+ * threads keep logging while it writes; output is flushed whenever the ring
+ * runs empty rather than after every message.
+ */
+static void acvp_log_ring_writer(void *arg) {
+    ACVP_LOG_RING *ring = arg;
+    char msg[ACVP_LOG_MAX_MSG_LEN + 1];
+    ACVP_LOG_LVL level = ACVP_LOG_LVL_NONE;
+
+    acvp_mutex_lock(&ring->lock);
+    for (;;) {
+        while (!ring->count && !ring->stop) {
+            acvp_cond_wait(&ring->cond, &ring->lock);
+        }
+        if (!ring->count) {
+            break;
+        }
+        strcpy_s(msg, sizeof(msg), ring->msgs + (size_t)ring->head * (ACVP_LOG_MAX_MSG_LEN + 1));
+        level = ring->levels[ring->head];
+        ring->head = (ring->head + 1) % ring->size;
+        ring->count--;
+        acvp_cond_broadcast(&ring->cond);
+        acvp_mutex_unlock(&ring->lock);
+
+        ring->cb(msg, level);
+
+        acvp_mutex_lock(&ring->lock);
+        if (!ring->count) {
+            fflush(stdout);
+        }
+    }
+    acvp_mutex_unlock(&ring->lock);
+    fflush(stdout);
+}
+
+/*
+ * Starts the async log sink of ctx with room for entries messages
+ */
+ACVP_RESULT acvp_log_ring_new(ACVP_CTX *ctx, int entries) {
+    ACVP_LOG_RING *ring = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    ring = calloc(1, sizeof(ACVP_LOG_RING));
+    if (!ring) {
+        return ACVP_MALLOC_FAIL;
+    }
+    ring->levels = calloc(entries, sizeof(ACVP_LOG_LVL));
+    ring->msgs = calloc(entries, ACVP_LOG_MAX_MSG_LEN + 1);
+    if (!ring->levels || !ring->msgs) {
+        rv = ACVP_MALLOC_FAIL;
+        goto err;
+    }
+    ring->size = entries;
+    ring->cb = ctx->test_progress_cb;
+    acvp_mutex_init(&ring->lock);
+    acvp_cond_init(&ring->cond);
+
+    rv = acvp_thread_create(&ring->writer, acvp_log_ring_writer, ring);
+    if (rv != ACVP_SUCCESS) {
+        acvp_cond_destroy(&ring->cond);
+        acvp_mutex_destroy(&ring->lock);
+        goto err;
+    }
+    ctx->log_ring = ring;
+    return ACVP_SUCCESS;
+
+err:
+    if (ring->levels) free(ring->levels);
+    if (ring->msgs) free(ring->msgs);
+    free(ring);
+    return rv;
+}
+
+/*
+ * Stops the async log sink of ctx once every message in it is written
+ */
+void acvp_log_ring_free(ACVP_CTX *ctx) {
+    ACVP_LOG_RING *ring = ctx->log_ring;
+
+    if (!ring) {
+        return;
+    }
+    acvp_mutex_lock(&ring->lock);
+    ring->stop = 1;
+    acvp_cond_broadcast(&ring->cond);
+    acvp_mutex_unlock(&ring->lock);
+    acvp_thread_join(ring->writer);
+
+    ctx->log_ring = NULL;
+    acvp_cond_destroy(&ring->cond);
+    acvp_mutex_destroy(&ring->lock);
+    free(ring->levels);
+    free(ring->msgs);
+    free(ring);
+}
 
 /*
- * Basic logging for libacvp
+ * Basic logging for libacvp. The ACVP_LOG_* macros only call this for
+ * levels that are on, see ACVP_LOG_ENABLED.
  */
 void acvp_log_msg(ACVP_CTX *ctx, ACVP_LOG_LVL level, const char *func, int line, const char *fmt, ...) {
     va_list arguments;
@@ -44,7 +184,7 @@ void acvp_log_msg(ACVP_CTX *ctx, ACVP_LOG_LVL level, const char *func, int line,
     char tmp[ACVP_LOG_MAX_MSG_LEN + 1];
     tmp[ACVP_LOG_MAX_MSG_LEN] = '\0';
 
-    if (!ctx) {
+    if (!ACVP_LOG_ENABLED(ctx, level)) {
         return;
     }
 
@@ -52,21 +192,27 @@ void acvp_log_msg(ACVP_CTX *ctx, ACVP_LOG_LVL level, const char *func, int line,
         iter = snprintf(tmp, ACVP_LOG_MAX_MSG_LEN, "[%s:%d]: ", func, line);
     }
 
-    if (ctx->test_progress_cb && (ctx->log_lvl >= level)) {
-        /*  Pull the arguments from the stack and invoke the logger function */
-        va_start(arguments, fmt);
-        ret = vsnprintf(tmp + iter, ACVP_LOG_MAX_MSG_LEN + 1 - iter, fmt, arguments);
-        if (ret < 0 || ret >= ACVP_LOG_MAX_MSG_LEN + 1 - iter) {
-            memcpy_s(tmp + ACVP_LOG_MAX_MSG_LEN - ACVP_LOG_TRUNCATED_STR_LEN,
-                     ACVP_LOG_TRUNCATED_STR_LEN,
-                     ACVP_LOG_TRUNCATED_STR, ACVP_LOG_TRUNCATED_STR_LEN);
-            tmp[ACVP_LOG_MAX_MSG_LEN] = '\0';
-        } else {
-            iter += ret;
-            tmp[iter] = '\0';
-        }
-        ctx->test_progress_cb(tmp, level);
-        va_end(arguments);
+    /*  Pull the arguments from the stack and invoke the logger function */
+    va_start(arguments, fmt);
+    ret = vsnprintf(tmp + iter, ACVP_LOG_MAX_MSG_LEN + 1 - iter, fmt, arguments);
+    if (ret < 0 || ret >= ACVP_LOG_MAX_MSG_LEN + 1 - iter) {
+        memcpy_s(tmp + ACVP_LOG_MAX_MSG_LEN - ACVP_LOG_TRUNCATED_STR_LEN,
+                 ACVP_LOG_TRUNCATED_STR_LEN,
+                 ACVP_LOG_TRUNCATED_STR, ACVP_LOG_TRUNCATED_STR_LEN);
+        tmp[ACVP_LOG_MAX_MSG_LEN] = '\0';
+    } else {
+        iter += ret;
+        tmp[iter] = '\0';
+    }
+    va_end(arguments);
+
+    if (ctx->log_ring) {
+        acvp_log_ring_put(ctx->log_ring, tmp, level);
+        return;
+    }
+    ctx->test_progress_cb(tmp, level);
+    /* Errors and warnings are seen at once; the rest go out as stdout is flushed */
+    if (level <= ACVP_LOG_LVL_WARN) {
         fflush(stdout);
     }
 }
@@ -77,6 +223,11 @@ void acvp_log_msg(ACVP_CTX *ctx, ACVP_LOG_LVL level, const char *func, int line,
  */
 void acvp_log_newline(ACVP_CTX *ctx) {
      char tmp[] = "\n";
+
+     if (ctx->log_ring) {
+         acvp_log_ring_put(ctx->log_ring, tmp, ACVP_LOG_LVL_STATUS);
+         return;
+     }
      ctx->test_progress_cb(tmp, ACVP_LOG_LVL_STATUS);
  }
 
@@ -115,23 +266,70 @@ ACVP_RESULT acvp_cleanup(ACVP_CTX *ctx) {
 
 /*
  * This function is used to locate the callback function that's needed
- * when a particular crypto operation is needed by libacvp.
+ * when a particular crypto operation is needed by libacvp. Entries are
+ * indexed by cipher as they are appended to caps_list. Once the session
+ * is registered they are found in its snapshot, which the threads running
+ * vector sets share with no lock.
  */
 ACVP_CAPS_LIST *acvp_locate_cap_entry(ACVP_CTX *ctx, ACVP_CIPHER cipher) {
-    ACVP_CAPS_LIST *cap;
-
-    if (!ctx || !ctx->caps_list) {
+    if (!ctx || cipher <= ACVP_CIPHER_START || cipher >= ACVP_CIPHER_END) {
         return NULL;
     }
 
-    cap = ctx->caps_list;
-    while (cap) {
-        if (cap->cipher == cipher) {
-            return cap;
-        }
-        cap = cap->next;
+    if (ctx->caps_snap) {
+        return ctx->caps_snap->index[cipher];
     }
-    return NULL;
+    return ctx->caps_index[cipher];
+}
+
+/*
+ * Takes a snapshot of the capabilities of the session ctx, for the exec
+ * contexts made from here on. Exec contexts made before keep the snapshot
+ * they have until they are freed.
+ */
+ACVP_RESULT acvp_cap_snapshot_take(ACVP_CTX *ctx) {
+    ACVP_CAP_SNAPSHOT *snap = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session) {
+        return ACVP_INVALID_ARG;
+    }
+    snap = calloc(1, sizeof(ACVP_CAP_SNAPSHOT));
+    if (!snap) {
+        return ACVP_MALLOC_FAIL;
+    }
+    memcpy_s(snap->index, sizeof(snap->index), ctx->caps_index, sizeof(ctx->caps_index));
+    snap->refs = 1;
+
+    acvp_cap_snapshot_drop(ctx);
+    acvp_mutex_lock(&ctx->session_lock);
+    ctx->caps_snap = snap;
+    acvp_mutex_unlock(&ctx->session_lock);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Lets go of the snapshot ctx holds, which is freed with the last
+ * reference to it. The session ctx then finds its capabilities in
+ * caps_index again, as it does while they are being enabled.
+ */
+void acvp_cap_snapshot_drop(ACVP_CTX *ctx) {
+    ACVP_CTX *session = NULL;
+    ACVP_CAP_SNAPSHOT *snap = NULL;
+
+    if (!ctx || !ctx->caps_snap) {
+        return;
+    }
+    session = ctx->session ? ctx->session : ctx;
+    acvp_mutex_lock(&session->session_lock);
+    if (--ctx->caps_snap->refs == 0) {
+        snap = ctx->caps_snap;
+    }
+    ctx->caps_snap = NULL;
+    acvp_mutex_unlock(&session->session_lock);
+    if (snap) free(snap);
 }
 
 /*
@@ -179,17 +377,116 @@ const char *acvp_lookup_cipher_revision(ACVP_CIPHER alg) {
     return NULL;
 }
 
+/*
+ * Perfect-hash index over the names of an enum/string table. The seed is
+ * searched for on first use so that every name in the table lands in a slot
+ * of its own; a lookup is then one hash and one compare. Index tables with
+ * ACVP_NAME_INDEX_DEFINE and look names up with ACVP_NAME_INDEX_FIND.
+ */
+#define ACVP_NAME_INDEX_SLOTS 64
+#define ACVP_NAME_INDEX_SEED_TRIES 1000000
+
+typedef struct acvp_name_index_t {
+    const struct acvp_enum_string_pair *tbl;
+    int cnt;
+    int perfect; /* 0 if no seed was found; lookups then scan tbl */
+    unsigned int seed;
+    unsigned char slot[ACVP_NAME_INDEX_SLOTS]; /* tbl index + 1, 0 if empty */
+} ACVP_NAME_INDEX;
+
+#define ACVP_NAME_INDEX_DEFINE(idx, tbl) \
+    static ACVP_NAME_INDEX idx = { tbl, sizeof(tbl) / sizeof(tbl[0]), 0, 0, { 0 } }; \
+    static ACVP_ONCE idx##_once = ACVP_ONCE_INIT; \
+    static void idx##_build(void) { acvp_name_index_build(&idx); }
+
+#define ACVP_NAME_INDEX_FIND(idx, name) \
+    (acvp_once(&idx##_once, idx##_build), acvp_name_index_find(&idx, name))
+
+static unsigned int acvp_name_hash(unsigned int seed, const char *name) {
+    unsigned int h = 2166136261u ^ seed;
+
+    while (*name) {
+        h ^= (unsigned char)*name++;
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    return h & (ACVP_NAME_INDEX_SLOTS - 1);
+}
+
+static void acvp_name_index_build(ACVP_NAME_INDEX *idx) {
+    unsigned int seed = 0;
+    int i = 0;
+
+    if (idx->cnt > ACVP_NAME_INDEX_SLOTS / 2) {
+        return;
+    }
+    for (seed = 0; seed < ACVP_NAME_INDEX_SEED_TRIES; seed++) {
+        memzero_s(idx->slot, sizeof(idx->slot));
+        for (i = 0; i < idx->cnt; i++) {
+            unsigned int h = acvp_name_hash(seed, idx->tbl[i].string);
+
+            if (idx->slot[h]) {
+                break;
+            }
+            idx->slot[h] = (unsigned char)(i + 1);
+        }
+        if (i == idx->cnt) {
+            idx->seed = seed;
+            idx->perfect = 1;
+            return;
+        }
+    }
+}
+
+/*
+ * Returns the table entry whose name is exactly name, or NULL.
+ */
+static const struct acvp_enum_string_pair *acvp_name_index_find(const ACVP_NAME_INDEX *idx,
+                                                                 const char *name) {
+    int i = 0, diff = 1;
+
+    if (!name) {
+        return NULL;
+    }
+    if (!idx->perfect) {
+        for (i = 0; i < idx->cnt; i++) {
+            strcmp_s(idx->tbl[i].string, ACVP_ALG_NAME_MAX, name, &diff);
+            if (!diff) {
+                return &idx->tbl[i];
+            }
+        }
+        return NULL;
+    }
+    i = idx->slot[acvp_name_hash(idx->seed, name)];
+    if (!i) {
+        return NULL;
+    }
+    strcmp_s(idx->tbl[i - 1].string, ACVP_ALG_NAME_MAX, name, &diff);
+    return diff ? NULL : &idx->tbl[i - 1];
+}
+
+/*
+ * Returns the enum value of the entry named name in an indexed table, or 0.
+ */
+#define ACVP_NAME_INDEX_VALUE(idx, name) \
+    acvp_name_index_value(ACVP_NAME_INDEX_FIND(idx, name))
+
+static unsigned int acvp_name_index_value(const struct acvp_enum_string_pair *entry) {
+    return entry ? entry->enum_value : 0;
+}
+
 /**
  * This table maintains a list of strings for revisions that can be registered as capabilities.
  */
-static struct acvp_alt_revision_info alt_revision_tbl[] = {
+static struct acvp_enum_string_pair alt_revision_tbl[] = {
     { ACVP_REVISION_SP800_56AR3, ACVP_REV_STR_SP800_56AR3 },
     { ACVP_REVISION_SP800_56CR1, ACVP_REV_STR_SP800_56CR1 },
     { ACVP_REVISION_FIPS186_4, ACVP_REV_STR_FIPS186_4 },
     { ACVP_REVISION_1_0, ACVP_REV_STR_1_0 }
 };
 static int alt_revision_tbl_length =
-    sizeof(alt_revision_tbl) / sizeof(struct acvp_alt_revision_info);
+    sizeof(alt_revision_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(alt_revision_idx, alt_revision_tbl)
 
 /**
  * this function returns the string used in registration for an alternative revision registered by
@@ -198,8 +495,8 @@ static int alt_revision_tbl_length =
 const char *acvp_lookup_alt_revision_string(ACVP_REVISION rev) {
     int i = 0;
     for (i = 0; i < alt_revision_tbl_length; i++) {
-        if (alt_revision_tbl[i].revision == rev) {
-            return alt_revision_tbl[i].name;
+        if (alt_revision_tbl[i].enum_value == rev) {
+            return alt_revision_tbl[i].string;
         }
     }
     return NULL;
@@ -209,20 +506,80 @@ const char *acvp_lookup_alt_revision_string(ACVP_REVISION rev) {
  * This function returns the enum for a given alternative revision string, or 0 if not found
  */
 ACVP_REVISION acvp_lookup_alt_revision(const char *str) {
-    int i = 0, diff = 1;
-    for (i = 0; i < alt_revision_tbl_length; i++) {
-        strcmp_s(alt_revision_tbl[i].name, ACVP_ALG_NAME_MAX, str, &diff);
-        if (!diff) {
-            return alt_revision_tbl[i].revision;
+    return ACVP_NAME_INDEX_VALUE(alt_revision_idx, str);
+}
+
+/*
+ * alg_tbl indices sorted by algorithm name, entries sharing a name kept in
+ * table order. Built on first use so the name lookups below can binary search
+ * instead of comparing against every entry of the table.
+ */
+static int alg_tbl_order[ACVP_ALG_MAX];
+static ACVP_ONCE alg_tbl_order_once = ACVP_ONCE_INIT;
+
+static int acvp_alg_tbl_order_cmp(const void *a, const void *b) {
+    int i = *(const int *)a, j = *(const int *)b;
+    int diff = 0;
+
+    strcmp_s(alg_tbl[i].name, ACVP_ALG_NAME_MAX, alg_tbl[j].name, &diff);
+    if (diff) {
+        return diff;
+    }
+    return i - j;
+}
+
+static void acvp_build_alg_tbl_order(void) {
+    int i = 0;
+
+    for (i = 0; i < ACVP_ALG_MAX; i++) {
+        alg_tbl_order[i] = i;
+    }
+    qsort(alg_tbl_order, ACVP_ALG_MAX, sizeof(int), acvp_alg_tbl_order_cmp);
+}
+
+/*
+ * Returns the position in alg_tbl_order of the first entry named
+ * algorithm, or -1 if there is none.
+ */
+static int acvp_alg_tbl_find(const char *algorithm) {
+    int lo = 0, hi = ACVP_ALG_MAX, mid = 0, diff = 0;
+
+    acvp_once(&alg_tbl_order_once, acvp_build_alg_tbl_order);
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        strcmp_s(alg_tbl[alg_tbl_order[mid]].name, ACVP_ALG_NAME_MAX, algorithm, &diff);
+        if (diff < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
-    return 0;
+    if (lo == ACVP_ALG_MAX) {
+        return -1;
+    }
+    strcmp_s(alg_tbl[alg_tbl_order[lo]].name, ACVP_ALG_NAME_MAX, algorithm, &diff);
+    return diff ? -1 : lo;
+}
+
+/*
+ * Returns the entry at position pos of alg_tbl_order if it is still
+ * named algorithm, so callers can walk every entry with that name.
+ */
+static const ACVP_ALG_HANDLER *acvp_alg_tbl_next(const char *algorithm, int pos) {
+    int diff = 1;
+
+    if (pos < 0 || pos >= ACVP_ALG_MAX) {
+        return NULL;
+    }
+    strcmp_s(alg_tbl[alg_tbl_order[pos]].name, ACVP_ALG_NAME_MAX, algorithm, &diff);
+    return diff ? NULL : &alg_tbl[alg_tbl_order[pos]];
 }
 
 /**
- * @brief Loop through all entries in alg_tbl, trying to match
- *        \p algorithm to each name field. If successful, will
- *        return the ACVP_CIPHER id field.
+ * @brief Trying to match \p algorithm to the name field of the
+ *        entries in alg_tbl. If successful, will return the
+ *        ACVP_CIPHER id field.
  *
  * IMPORTANT: This only works accurately for algorithms that have
  * a 1:1 name to id entry. I.e. does not work for algorithms that
@@ -233,30 +590,23 @@ ACVP_REVISION acvp_lookup_alt_revision(const char *str) {
  * @return 0 if no-match
  */
 ACVP_CIPHER acvp_lookup_cipher_index(const char *algorithm) {
-    int i = 0;
+    int pos = 0;
 
     if (!algorithm) {
         return 0;
     }
 
-    for (i = 0; i < ACVP_ALG_MAX; i++) {
-        int diff = 1;
-
-        strcmp_s(alg_tbl[i].name,
-                 ACVP_ALG_NAME_MAX,
-                 algorithm, &diff);
-
-        if (!diff) {
-            return alg_tbl[i].cipher;
-        }
+    pos = acvp_alg_tbl_find(algorithm);
+    if (pos < 0) {
+        return 0;
     }
 
-    return 0;
+    return alg_tbl[alg_tbl_order[pos]].cipher;
 }
 
 /**
- * @brief Loop through all entries in alg_tbl, trying to match
- *        both \p algorithm and \p mode to their respective fields.
+ * @brief Trying to match both \p algorithm and \p mode to the
+ *        respective fields of the entries in alg_tbl.
  *        If successful, will return the ACVP_CIPHER id field.
  *
  * Useful for algorithms that have multiple modes (i.e. asymmetric).
@@ -266,33 +616,61 @@ ACVP_CIPHER acvp_lookup_cipher_index(const char *algorithm) {
  */
 ACVP_CIPHER acvp_lookup_cipher_w_mode_index(const char *algorithm,
                                             const char *mode) {
-    int i = 0;
+    const ACVP_ALG_HANDLER *entry = NULL;
+    int pos = 0;
 
     if (!algorithm || !mode) {
         return 0;
     }
 
-    for (i = 0; i < ACVP_ALG_MAX; i++) {
-        int diff = 0;
+    pos = acvp_alg_tbl_find(algorithm);
+    while ((entry = acvp_alg_tbl_next(algorithm, pos++))) {
+        int diff = 1;
+
+        if (entry->mode == NULL) continue;
 
-        if (alg_tbl[i].mode == NULL) continue;
+        /* Compare the mode string */
+        strcmp_s(entry->mode,
+                 ACVP_ALG_MODE_MAX,
+                 mode, &diff);
 
-        /* Compare the algorithm string */
-        strcmp_s(alg_tbl[i].name,
-                 ACVP_ALG_NAME_MAX,
-                 algorithm, &diff);
+        if (!diff) return entry->cipher;
+    }
 
-        if (!diff) {
-            /* Compare the mode string */
-            strcmp_s(alg_tbl[i].mode,
-                     ACVP_ALG_MODE_MAX,
-                     mode, &diff);
+    return 0;
+}
+
+/**
+ * @brief Finds the alg_tbl entry that handles a vector set with the
+ *        given \p algorithm and \p mode. A NULL \p mode matches the
+ *        first entry with that name, as does any mode for KDF108, whose
+ *        entry has no mode even though KDF108-KMAC vector sets carry one.
+ *
+ * @return ACVP_ALG_HANDLER entry
+ * @return NULL if no-match
+ */
+const ACVP_ALG_HANDLER *acvp_lookup_alg_handler(const char *algorithm, const char *mode) {
+    const ACVP_ALG_HANDLER *entry = NULL;
+    int pos = 0;
+
+    if (!algorithm) {
+        return NULL;
+    }
+
+    pos = acvp_alg_tbl_find(algorithm);
+    while ((entry = acvp_alg_tbl_next(algorithm, pos++))) {
+        int diff = 1;
 
-            if (!diff) return alg_tbl[i].cipher;
+        if (mode == NULL || entry->cipher == ACVP_KDF108) {
+            return entry;
         }
+        if (entry->mode == NULL) continue;
+
+        strcmp_s(entry->mode, ACVP_ALG_MODE_MAX, mode, &diff);
+        if (!diff) return entry;
     }
 
-    return 0;
+    return NULL;
 }
 
 /**
@@ -345,35 +723,38 @@ const char *acvp_lookup_rsa_mask_func_str(ACVP_RSA_MASK_FUNCTION func) {
     }
 }
 
+/*
+ * Local table for matching randPQ index values to name string and vice versa.
+ */
+static struct acvp_enum_string_pair rsa_randpq_tbl[] = {
+    { ACVP_RSA_KEYGEN_B32, ACVP_RSA_RANDPQ_STR_B32 }, // "provRP"
+    { ACVP_RSA_KEYGEN_B33, ACVP_RSA_RANDPQ_STR_B33 }, // "probRP"
+    { ACVP_RSA_KEYGEN_B34, ACVP_RSA_RANDPQ_STR_B34 }, // "provPC"
+    { ACVP_RSA_KEYGEN_B35, ACVP_RSA_RANDPQ_STR_B35 }, // "bothPC"
+    { ACVP_RSA_KEYGEN_B36, ACVP_RSA_RANDPQ_STR_B36 }, // "probPC"
+    { ACVP_RSA_KEYGEN_PROVABLE, ACVP_RSA_RANDPQ_STR_PROVABLE },
+    { ACVP_RSA_KEYGEN_PROBABLE, ACVP_RSA_RANDPQ_STR_PROBABLE },
+    { ACVP_RSA_KEYGEN_PROV_W_PROV_AUX, ACVP_RSA_RANDPQ_STR_PROV_W_PROV_AUX },
+    { ACVP_RSA_KEYGEN_PROB_W_PROV_AUX, ACVP_RSA_RANDPQ_STR_PROB_W_PROV_AUX },
+    { ACVP_RSA_KEYGEN_PROB_W_PROB_AUX, ACVP_RSA_RANDPQ_STR_PROB_W_PROB_AUX }
+};
+static int rsa_randpq_tbl_length =
+    sizeof(rsa_randpq_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(rsa_randpq_idx, rsa_randpq_tbl)
+
 /*
  * This method returns the string that corresponds to a randPQ
  * index value
  */
 const char *acvp_lookup_rsa_randpq_name(int value) {
-    switch (value) {
-    case ACVP_RSA_KEYGEN_B32:
-        return ACVP_RSA_RANDPQ_STR_B32; // "provRP"
-    case ACVP_RSA_KEYGEN_B33:
-        return ACVP_RSA_RANDPQ_STR_B33; // "probRP"
-    case ACVP_RSA_KEYGEN_B34:
-        return ACVP_RSA_RANDPQ_STR_B34; // "provPC"
-    case ACVP_RSA_KEYGEN_B35:
-        return ACVP_RSA_RANDPQ_STR_B35; // "bothPC"
-    case ACVP_RSA_KEYGEN_B36:
-        return ACVP_RSA_RANDPQ_STR_B36; // "probPC"
-    case ACVP_RSA_KEYGEN_PROVABLE:
-        return ACVP_RSA_RANDPQ_STR_PROVABLE;
-    case ACVP_RSA_KEYGEN_PROBABLE:
-        return ACVP_RSA_RANDPQ_STR_PROBABLE;
-    case ACVP_RSA_KEYGEN_PROV_W_PROV_AUX:
-        return ACVP_RSA_RANDPQ_STR_PROV_W_PROV_AUX;
-    case ACVP_RSA_KEYGEN_PROB_W_PROV_AUX:
-        return ACVP_RSA_RANDPQ_STR_PROB_W_PROV_AUX;
-    case ACVP_RSA_KEYGEN_PROB_W_PROB_AUX:
-        return ACVP_RSA_RANDPQ_STR_PROB_W_PROB_AUX;
-    default:
-        return NULL;
+    int i = 0;
+
+    for (i = 0; i < rsa_randpq_tbl_length; i++) {
+        if ((unsigned int)value == rsa_randpq_tbl[i].enum_value) {
+            return rsa_randpq_tbl[i].string;
+        }
     }
+    return NULL;
 }
 
 ACVP_RSA_PUB_EXP_MODE acvp_lookup_rsa_pub_exp_mode(const char *str) {
@@ -391,47 +772,10 @@ ACVP_RSA_PUB_EXP_MODE acvp_lookup_rsa_pub_exp_mode(const char *str) {
 }
 
 int acvp_lookup_rsa_randpq_index(const char *value) {
-    int diff = 0;
-
-    if (!value) {
-        return 0;
-    }
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_B32, sizeof(ACVP_RSA_RANDPQ_STR_B32) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_B32;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_B33, sizeof(ACVP_RSA_RANDPQ_STR_B33) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_B33;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_B34, sizeof(ACVP_RSA_RANDPQ_STR_B34) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_B34;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_B35, sizeof(ACVP_RSA_RANDPQ_STR_B35) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_B35;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_B36, sizeof(ACVP_RSA_RANDPQ_STR_B36) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_B36;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_PROVABLE, sizeof(ACVP_RSA_RANDPQ_STR_PROVABLE) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_PROVABLE;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_PROBABLE, sizeof(ACVP_RSA_RANDPQ_STR_PROBABLE) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_PROBABLE;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_PROV_W_PROV_AUX, sizeof(ACVP_RSA_RANDPQ_STR_PROV_W_PROV_AUX) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_PROV_W_PROV_AUX;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_PROB_W_PROV_AUX, sizeof(ACVP_RSA_RANDPQ_STR_PROB_W_PROV_AUX) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_PROB_W_PROV_AUX;
-
-    strcmp_s(ACVP_RSA_RANDPQ_STR_PROB_W_PROB_AUX, sizeof(ACVP_RSA_RANDPQ_STR_PROB_W_PROB_AUX) - 1, value, &diff);
-    if (!diff) return ACVP_RSA_KEYGEN_PROB_W_PROB_AUX;
-
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(rsa_randpq_idx, value);
 }
 
-#define DRBG_MODE_NAME_MAX 12
-static struct acvp_drbg_mode_name_t drbg_mode_tbl[] = {
+static struct acvp_enum_string_pair drbg_mode_tbl[] = {
     { ACVP_DRBG_SHA_1,       ACVP_STR_SHA_1          },
     { ACVP_DRBG_SHA_224,     ACVP_STR_SHA2_224       },
     { ACVP_DRBG_SHA_256,     ACVP_STR_SHA2_256       },
@@ -448,8 +792,7 @@ static struct acvp_drbg_mode_name_t drbg_mode_tbl[] = {
     { ACVP_DRBG_AES_192,     ACVP_DRBG_MODE_AES_192  },
     { ACVP_DRBG_AES_256,     ACVP_DRBG_MODE_AES_256  }
 };
-static int drbg_mode_tbl_length =
-    sizeof(drbg_mode_tbl) / sizeof(struct acvp_drbg_mode_name_t);
+ACVP_NAME_INDEX_DEFINE(drbg_mode_idx, drbg_mode_tbl)
 
 /*
  * This function returns the ID of a DRBG mode given an
@@ -457,20 +800,7 @@ static int drbg_mode_tbl_length =
  * returns 0 if none match.
  */
 ACVP_DRBG_MODE acvp_lookup_drbg_mode_index(const char *mode) {
-    int i = 0;
-
-    for (i = 0; i < drbg_mode_tbl_length; i++) {
-        int diff = 0;
-        strcmp_s(drbg_mode_tbl[i].name,
-                 DRBG_MODE_NAME_MAX,
-                 mode, &diff);
-
-        if (!diff) {
-            return drbg_mode_tbl[i].mode;
-        }
-    }
-
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(drbg_mode_idx, mode);
 }
 
 /* This function checks to see if the value is a valid
@@ -479,11 +809,10 @@ ACVP_RESULT is_valid_tf_param(int value) {
     if (value == 0 || value == 1) { return ACVP_SUCCESS; } else { return ACVP_INVALID_ARG; }
 }
 
-#define HASH_ALG_NAME_MAX 12
 /*
  * Local table for matching ACVP_HASH_ALG to name string and vice versa.
  */
-static struct acvp_hash_alg_info hash_alg_tbl[] = {
+static struct acvp_enum_string_pair hash_alg_tbl[] = {
     { ACVP_SHA1,       ACVP_STR_SHA_1        },
     { ACVP_SHA224,     ACVP_STR_SHA2_224     },
     { ACVP_SHA256,     ACVP_STR_SHA2_256     },
@@ -499,7 +828,8 @@ static struct acvp_hash_alg_info hash_alg_tbl[] = {
     { ACVP_SHAKE_256,  ACVP_ALG_SHAKE_256    }
 };
 static int hash_alg_tbl_length =
-    sizeof(hash_alg_tbl) / sizeof(struct acvp_hash_alg_info);
+    sizeof(hash_alg_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(hash_alg_idx, hash_alg_tbl)
 
 /**
  * @brief Using \p name, find the corresponding ACVP_HASH_ALG.
@@ -510,23 +840,7 @@ static int hash_alg_tbl_length =
  * @return 0 - fail
  */
 ACVP_HASH_ALG acvp_lookup_hash_alg(const char *name) {
-    int i = 0;
-
-    if (!name) return 0;
-
-    for (i = 0; i < hash_alg_tbl_length; i++) {
-        int diff = 0;
-
-        strcmp_s(hash_alg_tbl[i].name,
-                 HASH_ALG_NAME_MAX,
-                 name, &diff);
-
-        if (!diff) {
-            return hash_alg_tbl[i].id;
-        }
-    }
-
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(hash_alg_idx, name);
 }
 
 /**
@@ -543,8 +857,8 @@ const char *acvp_lookup_hash_alg_name(ACVP_HASH_ALG id) {
     if (!id) return NULL;
 
     for (i = 0; i < hash_alg_tbl_length; i++) {
-        if (id == hash_alg_tbl[i].id) {
-            return hash_alg_tbl[i].name;
+        if (id == hash_alg_tbl[i].enum_value) {
+            return hash_alg_tbl[i].string;
         }
     }
 
@@ -590,11 +904,10 @@ ACVP_RESULT is_valid_rsa_mod(int value) {
     } else { return ACVP_SUCCESS; }
 }
 
-#define EC_CURVE_NAME_MAX 5
 /*
  * Local table for matching ACVP_EC_CURVE to name string and vice versa.
  */
-static struct acvp_ec_curve_info ec_curve_tbl[] = {
+static struct acvp_enum_string_pair ec_curve_tbl[] = {
     { ACVP_EC_CURVE_P224, "P-224" },
     { ACVP_EC_CURVE_P256, "P-256" },
     { ACVP_EC_CURVE_P384, "P-384" },
@@ -609,34 +922,36 @@ static struct acvp_ec_curve_info ec_curve_tbl[] = {
     { ACVP_EC_CURVE_K571, "K-571" }
 };
 static int ec_curve_tbl_length =
-    sizeof(ec_curve_tbl) / sizeof(struct acvp_ec_curve_info);
+    sizeof(ec_curve_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(ec_curve_idx, ec_curve_tbl)
 
 /*
  * Local table for matching ACVP_EC_CURVE to name string and vice versa.
  * Containes "deprecated" curves (still allowed for ECDSA_KEYVER and ECDSA_SIGVER).
  */
-static struct acvp_ec_curve_info ec_curve_depr_tbl[] = {
+static struct acvp_enum_string_pair ec_curve_depr_tbl[] = {
     { ACVP_EC_CURVE_P192, "P-192" },
     { ACVP_EC_CURVE_B163, "B-163" },
     { ACVP_EC_CURVE_K163, "K-163" }
 };
 static int ec_curve_depr_tbl_length =
-    sizeof(ec_curve_depr_tbl) / sizeof(struct acvp_ec_curve_info);
+    sizeof(ec_curve_depr_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(ec_curve_depr_idx, ec_curve_depr_tbl)
 
 const char *acvp_lookup_ec_curve_name(ACVP_CIPHER cipher, ACVP_EC_CURVE id) {
     int i = 0;
 
     for (i = 0; i < ec_curve_tbl_length; i++) {
-        if (id == ec_curve_tbl[i].id) {
-            return ec_curve_tbl[i].name;
+        if (id == ec_curve_tbl[i].enum_value) {
+            return ec_curve_tbl[i].string;
         }
     }
 
     if (cipher == ACVP_ECDSA_KEYVER || cipher == ACVP_ECDSA_SIGVER) {
         /* Check the deprecated curves */
         for (i = 0; i < ec_curve_depr_tbl_length; i++) {
-            if (id == ec_curve_depr_tbl[i].id) {
-                return ec_curve_depr_tbl[i].name;
+            if (id == ec_curve_depr_tbl[i].enum_value) {
+                return ec_curve_depr_tbl[i].string;
             }
         }
     }
@@ -645,45 +960,23 @@ const char *acvp_lookup_ec_curve_name(ACVP_CIPHER cipher, ACVP_EC_CURVE id) {
 }
 
 ACVP_EC_CURVE acvp_lookup_ec_curve(ACVP_CIPHER cipher, const char *name) {
-    int i = 0;
-
-    for (i = 0; i < ec_curve_tbl_length; i++) {
-        int diff = 0;
-
-        strcmp_s(ec_curve_tbl[i].name,
-                 EC_CURVE_NAME_MAX,
-                 name, &diff);
-
-        if (!diff) {
-            return ec_curve_tbl[i].id;
-        }
-    }
+    ACVP_EC_CURVE id = ACVP_NAME_INDEX_VALUE(ec_curve_idx, name);
 
-    if (cipher == ACVP_ECDSA_KEYVER || cipher == ACVP_ECDSA_SIGVER) {
+    if (!id && (cipher == ACVP_ECDSA_KEYVER || cipher == ACVP_ECDSA_SIGVER)) {
         /* Check the deprecated curves */
-        for (i = 0; i < ec_curve_depr_tbl_length; i++) {
-            int diff = 0;
-
-            strcmp_s(ec_curve_depr_tbl[i].name,
-                     EC_CURVE_NAME_MAX,
-                     name, &diff);
-
-            if (!diff) {
-                return ec_curve_depr_tbl[i].id;
-            }
-        }
+        id = ACVP_NAME_INDEX_VALUE(ec_curve_depr_idx, name);
     }
 
-    return 0;
+    return id;
 }
 
-#define ED_CURVE_NAME_MAX 8
 static struct acvp_enum_string_pair ed_curve_tbl[] = {
     { ACVP_ED_CURVE_25519, "ED-25519" },
     { ACVP_ED_CURVE_448, "ED-448" }
 };
 static int ed_curve_tbl_length =
     sizeof(ed_curve_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(ed_curve_idx, ed_curve_tbl)
 
 const char *acvp_lookup_ed_curve_name(ACVP_ED_CURVE id) {
     int i = 0;
@@ -697,21 +990,10 @@ const char *acvp_lookup_ed_curve_name(ACVP_ED_CURVE id) {
 }
 
 ACVP_ED_CURVE acvp_lookup_ed_curve(const char *name) {
-    int i = 0;
-
-    for (i = 0; i < ed_curve_tbl_length; i++) {
-        int diff = 0;
-
-        strcmp_s(ed_curve_tbl[i].string, ED_CURVE_NAME_MAX, name, &diff);
-
-        if (!diff) {
-            return ed_curve_tbl[i].enum_value;
-        }
-    }
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(ed_curve_idx, name);
 }
 
-static struct acvp_function_info acvp_aux_function_tbl[] = {
+static struct acvp_enum_string_pair acvp_aux_function_tbl[] = {
     { ACVP_HASH_SHA1, ACVP_ALG_SHA1 },
     { ACVP_HASH_SHA224, ACVP_ALG_SHA224 },
     { ACVP_HASH_SHA256, ACVP_ALG_SHA256 },
@@ -736,31 +1018,23 @@ static struct acvp_function_info acvp_aux_function_tbl[] = {
     { ACVP_KMAC_128, ACVP_ALG_KMAC_128 },
     { ACVP_KMAC_256, ACVP_ALG_KMAC_256 }
 };
-static int acvp_aux_function_tbl_len = sizeof(acvp_aux_function_tbl) / sizeof(struct acvp_function_info);
+static int acvp_aux_function_tbl_len = sizeof(acvp_aux_function_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(acvp_aux_function_idx, acvp_aux_function_tbl)
 
 const char* acvp_lookup_aux_function_alg_str(ACVP_CIPHER alg) {
     int i = 0;
     for (i = 0; i < acvp_aux_function_tbl_len; i++) {
-        if (alg == acvp_aux_function_tbl[i].cipher) {
-            return acvp_aux_function_tbl[i].name;
+        if (alg == acvp_aux_function_tbl[i].enum_value) {
+            return acvp_aux_function_tbl[i].string;
         }
     }
     return NULL;
 }
 
 ACVP_CIPHER acvp_lookup_aux_function_alg_tbl(const char *str) {
-    int diff = 1, i = 0;
-    for (i = 0; i < acvp_aux_function_tbl_len; i++) {
-    strcmp_s(acvp_aux_function_tbl[i].name, strnlen_s(acvp_aux_function_tbl[i].name, ACVP_ALG_NAME_MAX), str, &diff);
-        if (!diff) {
-            return acvp_aux_function_tbl[i].cipher;
-        }
-    }
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(acvp_aux_function_idx, str);
 }
 
-#define ACVP_LMS_MODE_STR_MAX 64 /* arbitrary */
-
 static struct acvp_enum_string_pair lms_mode_tbl[] = {
     { ACVP_LMS_MODE_SHA256_M24_H5, "LMS_SHA256_M24_H5"},
     { ACVP_LMS_MODE_SHA256_M24_H10, "LMS_SHA256_M24_H10"},
@@ -785,16 +1059,10 @@ static struct acvp_enum_string_pair lms_mode_tbl[] = {
 };
 
 static int lms_mode_tbl_len = sizeof(lms_mode_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(lms_mode_idx, lms_mode_tbl)
 
 ACVP_LMS_MODE acvp_lookup_lms_mode(const char *str) {
-    int diff = 1, i = 0;
-    for (i = 0; i < lms_mode_tbl_len; i++) {
-        strcmp_s(lms_mode_tbl[i].string, strnlen_s(lms_mode_tbl[i].string, ACVP_LMS_MODE_STR_MAX), str, &diff);
-        if (!diff) {
-            return lms_mode_tbl[i].enum_value;
-        }
-    }
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(lms_mode_idx, str);
 }
 
 const char *acvp_lookup_lms_mode_str(ACVP_LMS_MODE mode) {
@@ -827,16 +1095,10 @@ static struct acvp_enum_string_pair lmots_mode_tbl[] = {
 };
 
 static int lmots_mode_tbl_len = sizeof(lmots_mode_tbl) / sizeof(struct acvp_enum_string_pair);
+ACVP_NAME_INDEX_DEFINE(lmots_mode_idx, lmots_mode_tbl)
 
 ACVP_LMOTS_MODE acvp_lookup_lmots_mode(const char *str) {
-    int diff = 1, i = 0;
-    for (i = 0; i < lmots_mode_tbl_len; i++) {
-        strcmp_s(lmots_mode_tbl[i].string, strnlen_s(lmots_mode_tbl[i].string, ACVP_LMS_MODE_STR_MAX), str, &diff);
-        if (!diff) {
-            return lmots_mode_tbl[i].enum_value;
-        }
-    }
-    return 0;
+    return ACVP_NAME_INDEX_VALUE(lmots_mode_idx, str);
 }
 
 const char *acvp_lookup_lmots_mode_str(ACVP_LMOTS_MODE mode) {
@@ -867,14 +1129,89 @@ const char *acvp_lookup_rsa_format_str(ACVP_RSA_KEY_FORMAT format) {
     return NULL;
 }
 
+/*
+ * Hex codec tables. hex_pairs holds the two characters for every byte value,
+ * hex_vals the value of every hex character; anything that is not a hex
+ * character decodes as 0.
+ */
+static const char hex_pairs[] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+static const unsigned char hex_vals[256] = {
+    ['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4,
+    ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
+    ['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15,
+    ['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15
+};
+
+#ifdef ACVP_SSE2
+/*
+ * SSE2 is part of the x86-64 baseline, so these need no runtime check.
+ * Both work on 16 bytes (32 hex characters) at a time and produce exactly
+ * what the table code would.
+ */
+static void acvp_bin_to_hex_sse2(const unsigned char *src, char *dest, int blocks) {
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero_chr = _mm_set1_epi8('0');
+    const __m128i alpha_off = _mm_set1_epi8('A' - '0' - 10);
+    __m128i v, hi, lo;
+
+    for (; blocks > 0; blocks--, src += 16, dest += 32) {
+        v = _mm_loadu_si128((const __m128i *)src);
+        hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        lo = _mm_and_si128(v, mask);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero_chr), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha_off));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero_chr), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha_off));
+        _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dest + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+}
+
+/* Value of each hex character in v, 0 for anything else */
+static __m128i acvp_hex_vals_sse2(__m128i v) {
+    const __m128i dig_lo = _mm_set1_epi8('0' - 1);
+    const __m128i dig_hi = _mm_set1_epi8('9' + 1);
+    const __m128i alp_lo = _mm_set1_epi8('a' - 1);
+    const __m128i alp_hi = _mm_set1_epi8('f' + 1);
+    const __m128i lower = _mm_set1_epi8(0x20);
+    __m128i is_dig, is_alp, l;
+
+    is_dig = _mm_and_si128(_mm_cmpgt_epi8(v, dig_lo), _mm_cmplt_epi8(v, dig_hi));
+    l = _mm_or_si128(v, lower);
+    is_alp = _mm_and_si128(_mm_cmpgt_epi8(l, alp_lo), _mm_cmplt_epi8(l, alp_hi));
+    return _mm_or_si128(_mm_and_si128(is_dig, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                        _mm_and_si128(is_alp, _mm_sub_epi8(l, _mm_set1_epi8('a' - 10))));
+}
+
+static void acvp_hex_to_bin_sse2(const char *src, unsigned char *dest, int blocks) {
+    const __m128i low_byte = _mm_set1_epi16(0x00ff);
+    __m128i a, b;
+
+    for (; blocks > 0; blocks--, src += 32, dest += 16) {
+        a = acvp_hex_vals_sse2(_mm_loadu_si128((const __m128i *)src));
+        b = acvp_hex_vals_sse2(_mm_loadu_si128((const __m128i *)(src + 16)));
+        /* Each 16 bit lane holds (first char, second char); make it one byte */
+        a = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(a, low_byte), 4), _mm_srli_epi16(a, 8));
+        b = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, low_byte), 4), _mm_srli_epi16(b, 8));
+        _mm_storeu_si128((__m128i *)dest, _mm_packus_epi16(a, b));
+    }
+}
+#endif
+
 /*
  * Convert a byte array from source to a hexadecimal string which is
  * stored in the destination.
  */
 ACVP_RESULT acvp_bin_to_hexstr(const unsigned char *src, int src_len, char *dest, int dest_max) {
-    int i, j;
-    unsigned char nibb_a, nibb_b;
-    unsigned char hex_chars[] = "0123456789ABCDEF";
+    int i = 0;
 
     if (!src || !dest) {
         return ACVP_CONVERT_DATA_ERR;
@@ -884,31 +1221,68 @@ ACVP_RESULT acvp_bin_to_hexstr(const unsigned char *src, int src_len, char *dest
         return ACVP_CONVERT_DATA_ERR;
     }
 
-    for (i = 0, j = 0; i < src_len; i++, j += 2) {
-        nibb_a = *src >> 4;   /* Get first half of byte */
-        nibb_b = *src & 0x0f; /* Get second half of byte */
+#ifdef ACVP_SSE2
+    i = src_len / 16 * 16;
+    acvp_bin_to_hex_sse2(src, dest, src_len / 16);
+#endif
+    for (; i < src_len; i++) {
+        dest[2 * i] = hex_pairs[2 * src[i]];
+        dest[2 * i + 1] = hex_pairs[2 * src[i] + 1];
+    }
+    dest[2 * src_len] = '\0';
+
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Convert the first src_len characters of a hexadecimal string to a byte
+ * array which is stored in the destination. The string does not need to be
+ * NUL terminated. An odd number of hex characters is allowed; the final
+ * character becomes the high nibble of the last byte, whose low nibble is
+ * zero, matching how the server left-aligns bit strings.
+ */
+ACVP_RESULT acvp_hexstr_to_bin_n(const char *src, int src_len, unsigned char *dest,
+                                 int dest_max, int *converted_len) {
+    const unsigned char *s = (const unsigned char *)src;
+    int byte_len;
+    int i = 0;
+
+    if (!src || !dest || src_len < 0) {
+        return ACVP_INVALID_ARG;
+    }
+
+    byte_len = (src_len + 1) / 2;
 
-        *dest = hex_chars[nibb_a];
-        *(dest + 1) = hex_chars[nibb_b];
+    /*
+     * Make sure the hex value isn't too large
+     */
+    if (byte_len > dest_max) {
+        return ACVP_DATA_TOO_LARGE;
+    }
 
-        dest += 2;
-        src++;
+    src_len /= 2;
+#ifdef ACVP_SSE2
+    i = src_len / 16 * 16;
+    acvp_hex_to_bin_sse2(src, dest, src_len / 16);
+#endif
+    for (; i < src_len; i++) {
+        dest[i] = (hex_vals[s[2 * i]] << 4) | hex_vals[s[2 * i + 1]];
+    }
+    if (byte_len > src_len) {
+        dest[src_len] = hex_vals[s[2 * src_len]] << 4;
     }
-    *dest = '\0';
 
+    if (converted_len) *converted_len = byte_len;
     return ACVP_SUCCESS;
 }
 
 /*
- * Convert a source hexadecimal string to a byte array which is stored
- * in the destination.
- * TODO: Enable the function to handle odd number of hex characters
+ * Convert a NUL terminated hexadecimal string to a byte array which is
+ * stored in the destination. Only an even number of hex characters is
+ * accepted; use acvp_hexstr_to_bin_n() for odd lengths.
  */
 ACVP_RESULT acvp_hexstr_to_bin(const char *src, unsigned char *dest, int dest_max, int *converted_len) {
     int src_len;
-    int byte_a, byte_b;
-    int is_odd = 0;
-    int length_converted = 0;
 
     if (!src || !dest) {
         return ACVP_INVALID_ARG;
@@ -924,47 +1298,91 @@ ACVP_RESULT acvp_hexstr_to_bin(const char *src, unsigned char *dest, int dest_ma
     }
 
     if (src_len & 1) {
-        is_odd = 1;
+        return ACVP_UNSUPPORTED_OP;
     }
 
-    if (!is_odd) {
-        while (*src && src[1]) {
-            byte_a = acvp_char_to_int((char)*src) << 4; /* Shift to left half of byte */
-            byte_b = acvp_char_to_int(*(src + 1));
+    return acvp_hexstr_to_bin_n(src, src_len, dest, dest_max, converted_len);
+}
+
+/*
+ * Converts a NUL terminated hexadecimal string of a big endian number to
+ * 64 bit limbs, least significant first. Each limb is built from its 16
+ * hex characters, starting from the end of the string, so the bytes are
+ * never put together in between.
+ */
+ACVP_RESULT acvp_hexstr_to_bn(const char *src, ACVP_BN *bn, int byte_max) {
+    const unsigned char *s = (const unsigned char *)src;
+    unsigned long long int limb = 0;
+    int src_len = 0, cnt = 0, i = 0, k = 0, start = 0, end = 0;
 
-            *dest = byte_a + byte_b; /* Combine left half with right half */
+    if (!src || !bn || byte_max < 0) {
+        return ACVP_INVALID_ARG;
+    }
+    acvp_bn_free(bn);
 
-            dest++;
-            src += 2;
-            length_converted++;
-        }
-    } else {
+    src_len = strnlen_s(src, ACVP_HEXSTR_MAX);
+    if (src_len > (2 * byte_max)) {
+        return ACVP_DATA_TOO_LARGE;
+    }
+    if (src_len & 1) {
         return ACVP_UNSUPPORTED_OP;
     }
 
-    if (converted_len) *converted_len = length_converted;
+    cnt = src_len ? (src_len + 15) / 16 : 1;
+    bn->limbs = calloc(cnt, sizeof(unsigned long long int));
+    if (!bn->limbs) {
+        return ACVP_MALLOC_FAIL;
+    }
+    for (i = 0; i < cnt; i++) {
+        end = src_len - 16 * i;
+        start = end > 16 ? end - 16 : 0;
+        limb = 0;
+        for (k = start; k < end; k++) {
+            limb = (limb << 4) | hex_vals[s[k]];
+        }
+        bn->limbs[i] = limb;
+    }
+
+    /* Leading zeros are not counted */
+    while (cnt > 1 && !bn->limbs[cnt - 1]) {
+        cnt--;
+    }
+    bn->limbs_cnt = cnt;
+    bn->bits = 64 * (cnt - 1);
+    for (limb = bn->limbs[cnt - 1]; limb; limb >>= 1) {
+        bn->bits++;
+    }
     return ACVP_SUCCESS;
 }
 
+void acvp_bn_free(ACVP_BN *bn) {
+    if (!bn) {
+        return;
+    }
+    if (bn->limbs) free(bn->limbs);
+    memzero_s(bn, sizeof(ACVP_BN));
+}
+
 /*
- * Local - helper function for acvp_hexstring_to_bytes
- * Used to convert a hexadecimal character to it's byte
- * representation.
+ * Whether the big number inputs of the capability's test cases are given
+ * as limbs, see acvp_cap_set_bn_limbs()
  */
-static int acvp_char_to_int(char ch) {
-    int ch_i;
+int acvp_bn_limbs_enabled(ACVP_CAPS_LIST *cap) {
+    return cap && cap->bn_limbs && !cap->ring && !cap->dut;
+}
 
-    if (ch >= '0' && ch <= '9') {
-        ch_i = ch - '0';
-    } else if (ch >= 'A' && ch <= 'F') {
-        ch_i = ch - 'A' + 10;
-    } else if (ch >= 'a' && ch <= 'f') {
-        ch_i = ch - 'a' + 10;
-    } else {
-        ch_i = 0;
+/*
+ * Decodes a big number input of a test case into bn when limbs is set,
+ * leaving converted_len 0, and into dest as acvp_hexstr_to_bin() does
+ * otherwise
+ */
+ACVP_RESULT acvp_hexstr_to_num(int limbs, const char *src, unsigned char *dest, int dest_max,
+                               int *converted_len, ACVP_BN *bn) {
+    if (!limbs) {
+        return acvp_hexstr_to_bin(src, dest, dest_max, converted_len);
     }
-
-    return ch_i;
+    if (converted_len) *converted_len = 0;
+    return acvp_hexstr_to_bn(src, bn, dest_max);
 }
 
 ACVP_DRBG_MODE_LIST *acvp_locate_drbg_mode_entry(ACVP_CAPS_LIST *cap, ACVP_DRBG_MODE mode) {
@@ -985,14 +1403,14 @@ ACVP_DRBG_MODE_LIST *acvp_locate_drbg_mode_entry(ACVP_CAPS_LIST *cap, ACVP_DRBG_
     return NULL;
 }
 
-ACVP_DRBG_MODE_LIST *acvp_create_drbg_mode_entry(ACVP_CAPS_LIST *cap, ACVP_DRBG_MODE mode) {
+ACVP_DRBG_MODE_LIST *acvp_create_drbg_mode_entry(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_DRBG_MODE mode) {
     ACVP_DRBG_MODE_LIST *entry = NULL, *list = NULL;
 
     if (acvp_locate_drbg_mode_entry(cap, mode) != NULL) {
         return NULL;
     }
 
-    entry = calloc(1, sizeof(ACVP_DRBG_MODE_LIST));
+    entry = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DRBG_MODE_LIST));
     if (!entry) {
         return NULL;
     }
@@ -1027,7 +1445,7 @@ ACVP_DRBG_CAP_GROUP *acvp_locate_drbg_group_entry(ACVP_DRBG_MODE_LIST *mode, int
 }
 
 
-ACVP_DRBG_CAP_GROUP *acvp_create_drbg_group(ACVP_DRBG_MODE_LIST *mode, int group) {
+ACVP_DRBG_CAP_GROUP *acvp_create_drbg_group(ACVP_CTX *ctx, ACVP_DRBG_MODE_LIST *mode, int group) {
     ACVP_DRBG_GROUP_LIST *entry = NULL, *list = NULL;
     ACVP_DRBG_CAP_GROUP *grp = NULL;
 
@@ -1035,13 +1453,9 @@ ACVP_DRBG_CAP_GROUP *acvp_create_drbg_group(ACVP_DRBG_MODE_LIST *mode, int group
         return NULL;
     }
 
-    entry = calloc(1, sizeof(ACVP_DRBG_GROUP_LIST));
-    if (!entry) {
-        return NULL;
-    }
-    grp = calloc(1, sizeof(ACVP_DRBG_CAP_GROUP));
-    if (!grp) {
-        free(entry);
+    entry = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DRBG_GROUP_LIST));
+    grp = acvp_cap_calloc(ctx, 1, sizeof(ACVP_DRBG_CAP_GROUP));
+    if (!entry || !grp) {
         return NULL;
     }
 
@@ -1199,16 +1613,23 @@ void acvp_kv_list_free(ACVP_KV_LIST *kv_list) {
     }
 }
 
+/*
+ * Starts the response to the vector set obj, with its testGroups array
+ * sized for the groups of the request
+ */
 ACVP_RESULT acvp_setup_json_rsp_group(ACVP_CTX **ctx,
+                                      JSON_Object *obj,
                                       JSON_Value **outer_arr_val,
                                       JSON_Value **r_vs_val,
                                       JSON_Object **r_vs,
                                       const char *alg_str,
                                       JSON_Array **groups_arr) {
-    if ((*ctx)->kat_resp) {
-        json_value_free((*ctx)->kat_resp);
+    if ((*ctx)->exec.kat_resp) {
+        json_value_free((*ctx)->exec.kat_resp);
     }
-    (*ctx)->kat_resp = *outer_arr_val;
+    (*ctx)->exec.kat_resp = *outer_arr_val;
+    (*ctx)->exec.rsp_groups = NULL;
+    (*ctx)->exec.rsp_groups_saved = 0;
 
     *r_vs_val = json_value_init_object();
     *r_vs = json_value_get_object(*r_vs_val);
@@ -1216,7 +1637,7 @@ ACVP_RESULT acvp_setup_json_rsp_group(ACVP_CTX **ctx,
         return ACVP_JSON_ERR;
     } 
 
-    if (json_object_set_number(*r_vs, "vsId", (*ctx)->vs_id) != JSONSuccess ||
+    if (json_object_set_number(*r_vs, "vsId", (*ctx)->exec.vs_id) != JSONSuccess ||
             json_object_set_string(*r_vs, "algorithm", alg_str) != JSONSuccess) {
         return ACVP_JSON_ERR;
     }
@@ -1227,10 +1648,26 @@ ACVP_RESULT acvp_setup_json_rsp_group(ACVP_CTX **ctx,
     if (!*groups_arr) {
         return ACVP_JSON_ERR;
     }
+    json_array_reserve(*groups_arr, json_array_get_count(json_object_get_array(obj, "testGroups")));
+    /* Finished groups are written from here to the checkpoint journal */
+    (*ctx)->exec.rsp_groups = *groups_arr;
 
     return ACVP_SUCCESS;
 }
 
+/*
+ * Adds the tests array to the group response r_gobj, sized for the test
+ * cases of the request group groupobj
+ */
+JSON_Array *acvp_setup_json_rsp_tests(JSON_Object *r_gobj, JSON_Object *groupobj) {
+    JSON_Array *r_tarr = NULL;
+
+    json_object_set_value(r_gobj, "tests", json_value_init_array());
+    r_tarr = json_object_get_array(r_gobj, "tests");
+    json_array_reserve(r_tarr, json_array_get_count(json_object_get_array(groupobj, "tests")));
+    return r_tarr;
+}
+
 static const char *acvp_get_version_from_rsp(JSON_Value *arry_val) {
     const char *version = NULL;
     JSON_Object *ver_obj = NULL;
@@ -1247,6 +1684,19 @@ static const char *acvp_get_version_from_rsp(JSON_Value *arry_val) {
     return version;
 }
 
+/*
+ * Returns the string value of key in obj, with its length in len, or NULL
+ * if there is no such string. The length is the one parson recorded while
+ * parsing, so long hex fields don't have to be scanned just to be measured.
+ */
+const char *acvp_json_get_string_n(const JSON_Object *obj, const char *key, int *len) {
+    JSON_Value *val = json_object_get_value(obj, key);
+    const char *str = json_value_get_string(val);
+
+    *len = str ? (int)json_value_get_string_len(val) : 0;
+    return str;
+}
+
 JSON_Object *acvp_get_obj_from_rsp(ACVP_CTX *ctx, JSON_Value *arry_val) {
     JSON_Object *obj = NULL;
     JSON_Array *reg_array;
@@ -1274,192 +1724,721 @@ void acvp_release_json(JSON_Value *r_vs_val,
     if (r_vs_val) json_value_free(r_vs_val);
 }
 
-/**
- * @brief Determine if the given \p string fits within the \p max_allowed length.
- *
- * Measure the length of the \p string to see whether it's length
- * (not including terminator) is <= \p max_allowed.
- *
- * @return 1 Length of \string <= \p max_allowed
- * @return 0 Length of \string > \p max_allowed
- * 
+/*
+ * Logs the responses built so far for the current vector set. The response
+ * is only serialized when verbose logging will actually print it, so the
+ * DOM and a full text copy of it do not both have to be held otherwise.
  */
-int string_fits(const char *string, unsigned int max_allowed) {
-    if (strnlen_s(string, max_allowed + 1) > max_allowed) {
-        return 0;
+void acvp_log_kat_resp(ACVP_CTX *ctx) {
+    char *json_result = NULL;
+
+    if (!ctx || !ctx->exec.kat_resp || !ctx->test_progress_cb ||
+        ctx->log_lvl < ACVP_LOG_LVL_VERBOSE) {
+        return;
     }
 
-    return 1;
+    json_result = json_serialize_to_string_pretty(ctx->exec.kat_resp, NULL);
+    if (!json_result) {
+        ACVP_LOG_WARN("Unable to serialize vector set responses for logging");
+        return;
+    }
+    ACVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
+    json_free_serialized_string(json_result);
 }
 
 /*
- * Simple utility function to free a string
- * list.
+ * Tells a kat handler whether to collect the test cases of a (non-MCT)
+ * test group into a batch: when the capability has a batch, async or
+ * SoA handler, a ring or a device under test, or when test cases are to be run in parallel, by threads of
+ * their own or by the workers of the pool, see ACVP_TC_SCHED.
  */
-void acvp_free_str_list(ACVP_STRING_LIST **list) {
-    ACVP_STRING_LIST *top = NULL;
-    ACVP_STRING_LIST *tmp = NULL;
+int acvp_tc_batch_enabled(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap) {
+    if (!ctx || !cap) {
+        return 0;
+    }
+    return cap->batch_handler || cap->async_handler || cap->soa_handler ||
+           cap->hash_soa_handler || cap->rsa_sigver_soa_handler || cap->ring || cap->dut || ctx->max_parallel_tc > 1 || (ctx->pool && ctx->pool->worker_cnt > 1);
+}
 
-    if (list == NULL) return;
-    top = *list;
-    if (top == NULL) return;
+/*
+ * Prepares a batch for up to max test cases.
+ */
+ACVP_RESULT acvp_tc_batch_init(ACVP_TC_BATCH *batch, int max) {
+    if (!batch || max <= 0) {
+        return ACVP_INVALID_ARG;
+    }
 
-    while (top) {
-        if (top->string) free(top->string);
-        tmp = top;
-        top = top->next;
-        free(tmp);
+    memzero_s(batch, sizeof(ACVP_TC_BATCH));
+    batch->tcs = calloc(max, sizeof(ACVP_TEST_CASE));
+    batch->results = calloc(max, sizeof(int));
+    batch->rsp = calloc(max, sizeof(JSON_Value *));
+    if (!batch->tcs || !batch->results || !batch->rsp) {
+        acvp_tc_batch_free(batch);
+        return ACVP_MALLOC_FAIL;
     }
+    batch->max = max;
+    return ACVP_SUCCESS;
+}
 
-    *list = NULL;
+/*
+ * Adds a test case to the batch along with its (not yet filled in) response.
+ * The batch holds on to the response until the caller takes it back out of
+ * batch->rsp. Returns the abstracted test case for the caller to point at
+ * its algorithm specific test case, or NULL if the batch is full.
+ */
+ACVP_TEST_CASE *acvp_tc_batch_add(ACVP_TC_BATCH *batch, JSON_Value *r_tval) {
+    if (!batch || batch->count >= batch->max) {
+        return NULL;
+    }
+
+    batch->rsp[batch->count] = r_tval;
+    return &batch->tcs[batch->count++];
 }
 
-/**
- * Simple utility function to add an entry to a SL list. if the list is NULL, it is created
- * with the given entry being the first one.
+/*
+ * Gives the test case last added to the batch an estimated cost, in any
+ * unit as long as it is the same for the whole batch. When test cases are
+ * run in parallel or through an async handler the most costly ones are
+ * started first, so that a long one does not hold up the end of the group.
+ * Results still come out in the order the test cases were added.
  */
-ACVP_RESULT acvp_append_sl_list(ACVP_SL_LIST **list, int length) {
-    ACVP_SL_LIST *current = NULL;
-    if (!list) {
-        return ACVP_NO_DATA;
+ACVP_RESULT acvp_tc_batch_set_cost(ACVP_TC_BATCH *batch, unsigned long long int cost) {
+    if (!batch || !batch->count) {
+        return ACVP_INVALID_ARG;
     }
-    
-    if (*list == NULL) {
-        *list = calloc(1, sizeof(ACVP_SL_LIST));
-        if (!*list) {
+
+    if (!batch->cost) {
+        batch->cost = calloc(batch->max, sizeof(unsigned long long int));
+        if (!batch->cost) {
             return ACVP_MALLOC_FAIL;
         }
-        (*list)->length = length;
-        return ACVP_SUCCESS;
     }
-    current = *list;
-    while (current) {
-        if (!current->next) {
-            current->next = calloc(1, sizeof(ACVP_SL_LIST));
-            if (!current->next) {
-                return ACVP_MALLOC_FAIL;
-            }
-            current->next->length = length;
-            return ACVP_SUCCESS;
-        }
-        current = current->next;
+    batch->cost[batch->count - 1] = cost;
+    return ACVP_SUCCESS;
+}
+
+typedef struct acvp_tc_cost_t {
+    unsigned long long int cost;
+    int index;
+} ACVP_TC_COST;
+
+/* Most costly first, ties in the order the test cases were added */
+static int acvp_tc_cost_cmp(const void *a, const void *b) {
+    const ACVP_TC_COST *x = a, *y = b;
+
+    if (x->cost != y->cost) {
+        return x->cost > y->cost ? -1 : 1;
+    }
+    return x->index - y->index;
+}
+
+/*
+ * Fills in batch->order when the test cases of the batch have costs.
+ * Without costs, or if the order cannot be allocated, test cases are
+ * simply started in the order they were added.
+ */
+static void acvp_tc_batch_order(ACVP_TC_BATCH *batch) {
+    ACVP_TC_COST *costs = NULL;
+    int i = 0;
+
+    if (!batch->cost || batch->count < 2) {
+        return;
+    }
+    costs = calloc(batch->count, sizeof(ACVP_TC_COST));
+    batch->order = calloc(batch->count, sizeof(int));
+    if (!costs || !batch->order) {
+        if (batch->order) free(batch->order);
+        batch->order = NULL;
+        if (costs) free(costs);
+        return;
     }
 
-    /* Code should never reach here */
-    return ACVP_UNSUPPORTED_OP;
+    for (i = 0; i < batch->count; i++) {
+        costs[i].cost = batch->cost[i];
+        costs[i].index = i;
+    }
+    qsort(costs, batch->count, sizeof(ACVP_TC_COST), acvp_tc_cost_cmp);
+    for (i = 0; i < batch->count; i++) {
+        batch->order[i] = costs[i].index;
+    }
+    free(costs);
 }
 
-/**
- * Simple utility function to add an entry to a param list. if the list is NULL, it is created
- * with the given entry being the first one.
+/*
+ * Submits the test cases of the batch to the async handler of the
+ * capability, most costly first if they have costs and otherwise in order,
+ * keeping up to async_depth of them in flight, and
+ * returns once every submitted test case has completed.
  */
-ACVP_RESULT acvp_append_param_list(ACVP_PARAM_LIST **list, int param) {
-    ACVP_PARAM_LIST *current = NULL;
-    if (!list) {
-        return ACVP_NO_DATA;
+static ACVP_RESULT acvp_tc_batch_run_async(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0, k = 0;
+
+    batch->handles = calloc(batch->count, sizeof(ACVP_TC_HANDLE));
+    if (!batch->handles) {
+        return ACVP_MALLOC_FAIL;
     }
-    
-    if (*list == NULL) {
-        *list = calloc(1, sizeof(ACVP_PARAM_LIST));
-        if (!*list) {
-            return ACVP_MALLOC_FAIL;
+    acvp_mutex_init(&batch->lock);
+    acvp_cond_init(&batch->completed);
+    batch->in_flight = 0;
+
+    ACVP_LOG_VERBOSE("Submitting %d test cases, up to %d at a time", batch->count, cap->async_depth);
+    for (i = 0; i < batch->count; i++) {
+        acvp_mutex_lock(&batch->lock);
+        while (batch->in_flight >= cap->async_depth) {
+            acvp_cond_wait(&batch->completed, &batch->lock);
         }
-        (*list)->param = param;
-        return ACVP_SUCCESS;
-    }
-    current = *list;
-    while (current) {
-        if (!current->next) {
-            current->next = calloc(1, sizeof(ACVP_PARAM_LIST));
-            if (!current->next) {
-                return ACVP_MALLOC_FAIL;
-            }
-            current->next->param = param;
-            return ACVP_SUCCESS;
+        batch->in_flight++;
+        acvp_mutex_unlock(&batch->lock);
+
+        k = batch->order ? batch->order[i] : i;
+        batch->handles[k].batch = batch;
+        batch->handles[k].index = k;
+        /* The lock is not held here, the module may complete from within the call */
+        if ((cap->async_handler)(&batch->tcs[k], &batch->handles[k])) {
+            ACVP_LOG_ERR("crypto module failed to accept test case %d", k);
+            acvp_mutex_lock(&batch->lock);
+            batch->in_flight--;
+            acvp_mutex_unlock(&batch->lock);
+            rv = ACVP_CRYPTO_MODULE_FAIL;
+            break;
         }
-        current = current->next;
     }
 
-    /* Code should never reach here */
-    return ACVP_INTERNAL_ERR;
+    /* Whatever was submitted has to come back before the test cases are released */
+    acvp_mutex_lock(&batch->lock);
+    while (batch->in_flight > 0) {
+        acvp_cond_wait(&batch->completed, &batch->lock);
+    }
+    acvp_mutex_unlock(&batch->lock);
+
+    acvp_cond_destroy(&batch->completed);
+    acvp_mutex_destroy(&batch->lock);
+    free(batch->handles);
+    batch->handles = NULL;
+    return rv;
 }
 
-/**
- * Simple utility function to add a entry to a name list. If the list is NULL, it is created
- * with the given entry being the first one. Note the string is REFERENCED, not copied.
- * This function should be able to accomdate the removal of names from the list if needed in the
- * future; if a name is removed from the list but its node remains (with a NULL value) then
- * the given string will be added to the "dummy" node
+void acvp_tc_sched_init(ACVP_TC_SCHED *sched) {
+    memzero_s(sched, sizeof(ACVP_TC_SCHED));
+    acvp_mutex_init(&sched->lock);
+    acvp_cond_init(&sched->cond);
+}
+
+void acvp_tc_sched_destroy(ACVP_TC_SCHED *sched) {
+    acvp_cond_destroy(&sched->cond);
+    acvp_mutex_destroy(&sched->lock);
+}
+
+/*
+ * Takes the next test case of batch or, when batch is NULL, of the open
+ * batch with the most left, those of numa_node first, which is closed once
+ * they are all taken. Returns its index, with *from set to its batch, or -1
+ * if there is none to take. Must be called with the scheduler lock held.
  */
-ACVP_RESULT acvp_append_name_list(ACVP_NAME_LIST **list, const char *string) {
-    ACVP_NAME_LIST *current = NULL;
-    if (!list) {
-        return ACVP_NO_DATA;
-    }
+static int acvp_tc_sched_take(ACVP_TC_SCHED *sched, ACVP_TC_BATCH *batch, int numa_node, ACVP_TC_BATCH **from) {
+    ACVP_TC_BATCH *b = NULL, **link = NULL;
+    int i = 0;
 
-    if (!*list) {
-        *list = calloc(1, sizeof(ACVP_NAME_LIST));
-        if (!*list) {
-            return ACVP_MALLOC_FAIL;
+    if (!batch) {
+        for (b = sched->open; b; b = b->next_open) {
+            if (!batch || (b->numa_node == numa_node && batch->numa_node != numa_node) ||
+                    ((b->numa_node == numa_node) == (batch->numa_node == numa_node) &&
+                     b->count - b->next > batch->count - batch->next)) {
+                batch = b;
+            }
         }
     }
-    current = *list;
-    while (current) {
-        if (!current->name) {
-            current->name = string;
-            return ACVP_SUCCESS;
-        }
-        if (!current->next) {
-            current->next = calloc(1, sizeof(ACVP_NAME_LIST));
-            if (!current->next) {
-                return ACVP_MALLOC_FAIL;
+    if (!batch || batch->next >= batch->count) {
+        return -1;
+    }
+
+    i = batch->next++;
+    if (batch->next == batch->count) {
+        for (link = &sched->open; *link; link = &(*link)->next_open) {
+            if (*link == batch) {
+                *link = batch->next_open;
+                break;
             }
         }
-        current = current->next;
+        batch->next_open = NULL;
     }
-    /* Code should never reach here */
-    return ACVP_UNSUPPORTED_OP;
+    *from = batch;
+    return batch->order ? batch->order[i] : i;
 }
 
-/**
- * Check if a REFERENCE to a certain string already exists in a name list
+/*
+ * Runs test case i of batch on the crypto handler of its capability, from
+ * whichever thread took it
  */
-int acvp_is_in_name_list(ACVP_NAME_LIST *list, const char *string) {
-    ACVP_NAME_LIST *current = NULL;
-    if (!list) {
-        return 0;
+static void acvp_tc_sched_run(ACVP_TC_SCHED *sched, ACVP_TC_BATCH *batch, int i) {
+    int result = (batch->cap->crypto_handler)(&batch->tcs[i]);
+
+    acvp_mutex_lock(&sched->lock);
+    batch->results[i] = result;
+    if (++batch->done == batch->count) {
+        acvp_cond_broadcast(&sched->cond);
     }
-    current = list;
-    while (current) {
-        if (current->name && current->name == string) {
-            return 1;
+    acvp_mutex_unlock(&sched->lock);
+}
+
+/*
+ * Counts a vector set of the pool in, and out once it stops being processed
+ * (done, or back in the pool to be retried), waking the idle workers so they
+ * can look for one to start.
+ */
+void acvp_tc_sched_vs_begin(ACVP_TC_SCHED *sched) {
+    acvp_mutex_lock(&sched->lock);
+    sched->active++;
+    acvp_mutex_unlock(&sched->lock);
+}
+
+void acvp_tc_sched_vs_end(ACVP_TC_SCHED *sched) {
+    acvp_mutex_lock(&sched->lock);
+    sched->active--;
+    sched->ended++;
+    acvp_cond_broadcast(&sched->cond);
+    acvp_mutex_unlock(&sched->lock);
+}
+
+/*
+ * Run by a worker of the pool with no vector set it can start: it takes on
+ * test cases of the batches the other workers have open, those on its own
+ * NUMA node first, until one of their vector sets stops being processed. Returns 0 right away if none is being
+ * processed, when there is nothing left for the worker to do.
+ */
+int acvp_tc_sched_steal(ACVP_TC_SCHED *sched, int numa_node) {
+    ACVP_TC_BATCH *from = NULL;
+    unsigned int ended = 0;
+    int i = 0, active = 0;
+
+    acvp_mutex_lock(&sched->lock);
+    active = sched->active;
+    ended = sched->ended;
+    while (sched->active && sched->ended == ended) {
+        i = acvp_tc_sched_take(sched, NULL, numa_node, &from);
+        if (i < 0) {
+            acvp_cond_wait(&sched->cond, &sched->lock);
+            continue;
         }
-        current = current->next;
+        acvp_mutex_unlock(&sched->lock);
+        acvp_tc_sched_run(sched, from, i);
+        acvp_mutex_lock(&sched->lock);
     }
-    return 0;
+    acvp_mutex_unlock(&sched->lock);
+    return active > 0;
 }
 
-/**
- * Simple utility function to add a string to a string list.
- * Note that the string is COPIED and not referenced.
+typedef struct acvp_tc_run_t {
+    ACVP_CTX *ctx;
+    ACVP_TC_SCHED *sched;
+    ACVP_TC_BATCH *batch;
+} ACVP_TC_RUN;
+
+/*
+ * Takes test cases off the batch and runs them on the crypto handler of the
+ * capability until none are left. Run by each thread of a parallel batch.
  */
-ACVP_RESULT acvp_append_str_list(ACVP_STRING_LIST **list, const char *string) {
-    ACVP_STRING_LIST *current = NULL;
-    ACVP_STRING_LIST *prev = NULL;
-    char *word = NULL;
+static void acvp_tc_batch_worker(void *arg) {
+    ACVP_TC_RUN *run = (ACVP_TC_RUN *)arg;
+    ACVP_TC_BATCH *from = NULL;
+    int i = 0;
 
-    if (!list) {
-        return ACVP_NO_DATA;
+    while (1) {
+        acvp_mutex_lock(&run->sched->lock);
+        i = acvp_tc_sched_take(run->sched, run->batch, 0, &from);
+        acvp_mutex_unlock(&run->sched->lock);
+        if (i < 0) {
+            break;
+        }
+        acvp_tc_sched_run(run->sched, from, i);
     }
+}
 
-    int len = strnlen_s(string, ACVP_STRING_LIST_MAX_LEN);
-    word = calloc(len + 1, sizeof(char));
-    if (!word) {
-        return ACVP_MALLOC_FAIL;
-    }
-    strncpy_s(word, len + 1, string, len);
+/*
+ * Entry of the threads started for a batch, on the CPUs of the worker that
+ * started them
+ */
+static void acvp_tc_batch_helper(void *arg) {
+    ACVP_TC_RUN *run = (ACVP_TC_RUN *)arg;
 
-    if (*list == NULL) {
+    acvp_worker_pin(run->ctx, 1);
+    acvp_tc_batch_worker(arg);
+}
+
+/*
+ * Runs the test cases of the batch on the crypto handler of the capability
+ * from up to max_parallel_tc threads, the calling thread being one of them.
+ * While it does, the batch is open to the idle workers of the pool too, see
+ * ACVP_TC_SCHED, so a vector set with a long tail of test cases is finished
+ * by every worker that has run out of vector sets of its own.
+ */
+static ACVP_RESULT acvp_tc_batch_run_parallel(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_THREAD *threads = NULL;
+    ACVP_TC_SCHED local;
+    ACVP_TC_RUN run;
+    int thread_cnt = 0, started = 0, i = 0;
+
+    thread_cnt = ctx->max_parallel_tc < batch->count ? ctx->max_parallel_tc : batch->count;
+    if (thread_cnt < 1) {
+        thread_cnt = 1;
+    }
+    threads = calloc(thread_cnt, sizeof(ACVP_THREAD));
+    if (!threads) {
+        return ACVP_MALLOC_FAIL;
+    }
+    run.ctx = ctx;
+    run.sched = ctx->pool ? &ctx->pool->sched : &local;
+    run.batch = batch;
+    if (!ctx->pool) {
+        acvp_tc_sched_init(&local);
+    }
+    batch->next = 0;
+    batch->done = 0;
+    batch->cap = cap;
+    batch->numa_node = ctx->exec.numa_node;
+
+    acvp_mutex_lock(&run.sched->lock);
+    batch->next_open = run.sched->open;
+    run.sched->open = batch;
+    acvp_cond_broadcast(&run.sched->cond);
+    acvp_mutex_unlock(&run.sched->lock);
+
+    ACVP_LOG_VERBOSE("Running %d test cases on %d threads", batch->count, thread_cnt);
+    for (i = 1; i < thread_cnt; i++) {
+        if (acvp_thread_create(&threads[started], acvp_tc_batch_helper, &run) != ACVP_SUCCESS) {
+            ACVP_LOG_WARN("Unable to start test case thread %d, continuing with %d", i, started + 1);
+            break;
+        }
+        started++;
+    }
+    acvp_tc_batch_worker(&run);
+    for (i = 0; i < started; i++) {
+        acvp_thread_join(threads[i]);
+    }
+
+    /* The last of the test cases may still be out with idle workers */
+    acvp_mutex_lock(&run.sched->lock);
+    while (batch->done < batch->count) {
+        acvp_cond_wait(&run.sched->cond, &run.sched->lock);
+    }
+    acvp_mutex_unlock(&run.sched->lock);
+
+    if (!ctx->pool) {
+        acvp_tc_sched_destroy(&local);
+    }
+    batch->cap = NULL;
+    free(threads);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Runs every test case of the batch on the capability: through the ring of
+ * a crypto module in another process or over the link to a remote device
+ * when it has one, in one call to its batch handler when it has that,
+ * through its async handler, or else on its crypto handler from several
+ * threads. The per test case results are left in batch->results.
+ */
+static ACVP_RESULT acvp_tc_batch_dispatch(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    memzero_s(batch->results, batch->max * sizeof(int));
+    if (cap->ring || cap->dut || !cap->batch_handler) {
+        acvp_tc_batch_order(batch);
+        if (cap->ring) {
+            rv = acvp_ring_run_batch(ctx, cap, batch);
+        } else if (cap->dut) {
+            rv = acvp_dut_run_batch(ctx, cap, batch);
+        } else if (cap->async_handler) {
+            rv = acvp_tc_batch_run_async(ctx, cap, batch);
+        } else {
+            rv = acvp_tc_batch_run_parallel(ctx, cap, batch);
+        }
+        if (batch->order) free(batch->order);
+        batch->order = NULL;
+        return rv;
+    }
+
+    ACVP_LOG_VERBOSE("Handing %d test cases to the batch handler", batch->count);
+    if ((cap->batch_handler)(batch->tcs, batch->results, batch->count)) {
+        ACVP_LOG_ERR("crypto module failed the batch operation");
+        return ACVP_CRYPTO_MODULE_FAIL;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * The module may be working on the test cases from several threads, so for
+ * the metrics the wall time of the whole batch is what counts as crypto.
+ */
+ACVP_RESULT acvp_tc_batch_run(ACVP_CTX *ctx, ACVP_CAPS_LIST *cap, ACVP_TC_BATCH *batch) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long int start = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (!cap || !batch) {
+        return ACVP_INVALID_ARG;
+    }
+    if (!batch->count) {
+        return ACVP_SUCCESS;
+    }
+
+    if (!ACVP_CRYPTO_TIMED(ctx)) {
+        return acvp_tc_batch_dispatch(ctx, cap, batch);
+    }
+    start = acvp_metrics_now();
+    rv = acvp_tc_batch_dispatch(ctx, cap, batch);
+    acvp_metrics_crypto(ctx, start, batch->count, NULL);
+    return rv;
+}
+
+void acvp_tc_complete(ACVP_TC_HANDLE *handle, int result) {
+    ACVP_TC_BATCH *batch = NULL;
+
+    if (!handle || !handle->batch) {
+        return;
+    }
+    batch = handle->batch;
+
+    acvp_mutex_lock(&batch->lock);
+    handle->batch = NULL;
+    batch->results[handle->index] = result;
+    batch->in_flight--;
+    acvp_cond_broadcast(&batch->completed);
+    acvp_mutex_unlock(&batch->lock);
+}
+
+/*
+ * Frees a batch, including any responses it still holds.
+ */
+void acvp_tc_batch_free(ACVP_TC_BATCH *batch) {
+    int i = 0;
+
+    if (!batch) {
+        return;
+    }
+    if (batch->rsp) {
+        for (i = 0; i < batch->count; i++) {
+            if (batch->rsp[i]) json_value_free(batch->rsp[i]);
+        }
+        free(batch->rsp);
+    }
+    if (batch->tcs) free(batch->tcs);
+    if (batch->results) free(batch->results);
+    if (batch->cost) free(batch->cost);
+    if (batch->order) free(batch->order);
+    memzero_s(batch, sizeof(ACVP_TC_BATCH));
+}
+
+/**
+ * @brief Determine if the given \p string fits within the \p max_allowed length.
+ *
+ * Measure the length of the \p string to see whether it's length
+ * (not including terminator) is <= \p max_allowed.
+ *
+ * @return 1 Length of \string <= \p max_allowed
+ * @return 0 Length of \string > \p max_allowed
+ * 
+ */
+int string_fits(const char *string, unsigned int max_allowed) {
+    if (strnlen_s(string, max_allowed + 1) > max_allowed) {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Simple utility function to free a string
+ * list.
+ */
+void acvp_free_str_list(ACVP_STRING_LIST **list) {
+    ACVP_STRING_LIST *top = NULL;
+    ACVP_STRING_LIST *tmp = NULL;
+
+    if (list == NULL) return;
+    top = *list;
+    if (top == NULL) return;
+
+    while (top) {
+        if (top->string) free(top->string);
+        tmp = top;
+        top = top->next;
+        free(tmp);
+    }
+
+    *list = NULL;
+}
+
+/*
+ * Returns zeroed memory for a capability of ctx. It is allocated from the
+ * cap_pool of ctx and released with everything else the capabilities
+ * hold by acvp_free_test_session(); it must not be passed to free().
+ */
+void *acvp_cap_calloc(ACVP_CTX *ctx, size_t count, size_t size) {
+    if (!ctx || !count || !size || count > (size_t)-1 / size) {
+        return NULL;
+    }
+    return acvp_arena_calloc(&ctx->cap_pool, count * size);
+}
+
+/*
+ * The nodes of the SL, param and name lists of the capabilities live in one
+ * array per list, in order and linked through next as before, so a list is
+ * walked through contiguous memory. The array holds 4 nodes and doubles
+ * whenever it is full, which is when the count of nodes it has is 4 or a
+ * larger power of 2; the arrays it outgrows stay in the cap_pool.
+ *
+ * Returns the (zeroed) node to append to a list of count nodes, moving the
+ * list to a larger array first if it needs one, or NULL if out of memory.
+ */
+static void *acvp_list_append_node(ACVP_CTX *ctx, void **list, size_t node_size, size_t next_offset, int count) {
+    unsigned char *nodes = *list, *grown = NULL;
+    int cap = 4, i = 0;
+
+    if (!nodes || (count >= cap && !(count & (count - 1)))) {
+        while (cap <= count) {
+            cap *= 2;
+        }
+        grown = acvp_cap_calloc(ctx, cap, node_size);
+        if (!grown) {
+            return NULL;
+        }
+        if (nodes) {
+            memcpy_s(grown, cap * node_size, nodes, count * node_size);
+        }
+        for (i = 0; i < count - 1; i++) {
+            *(void **)(grown + i * node_size + next_offset) = grown + (i + 1) * node_size;
+        }
+        nodes = grown;
+        *list = nodes;
+    }
+    if (count > 0) {
+        *(void **)(nodes + (count - 1) * node_size + next_offset) = nodes + count * node_size;
+    }
+    return nodes + count * node_size;
+}
+
+/**
+ * Simple utility function to add an entry to a SL list. if the list is NULL, it is created
+ * with the given entry being the first one.
+ */
+ACVP_RESULT acvp_append_sl_list(ACVP_CTX *ctx, ACVP_SL_LIST **list, int length) {
+    ACVP_SL_LIST *current = NULL;
+    int count = 0;
+
+    if (!list) {
+        return ACVP_NO_DATA;
+    }
+
+    for (current = *list; current; current = current->next) {
+        count++;
+    }
+    current = acvp_list_append_node(ctx, (void **)list, sizeof(ACVP_SL_LIST),
+                                    offsetof(ACVP_SL_LIST, next), count);
+    if (!current) {
+        return ACVP_MALLOC_FAIL;
+    }
+    current->length = length;
+    return ACVP_SUCCESS;
+}
+
+/**
+ * Simple utility function to add an entry to a param list. if the list is NULL, it is created
+ * with the given entry being the first one.
+ */
+ACVP_RESULT acvp_append_param_list(ACVP_CTX *ctx, ACVP_PARAM_LIST **list, int param) {
+    ACVP_PARAM_LIST *current = NULL;
+    int count = 0;
+
+    if (!list) {
+        return ACVP_NO_DATA;
+    }
+
+    for (current = *list; current; current = current->next) {
+        count++;
+    }
+    current = acvp_list_append_node(ctx, (void **)list, sizeof(ACVP_PARAM_LIST),
+                                    offsetof(ACVP_PARAM_LIST, next), count);
+    if (!current) {
+        return ACVP_MALLOC_FAIL;
+    }
+    current->param = param;
+    return ACVP_SUCCESS;
+}
+
+/**
+ * Simple utility function to add a entry to a name list. If the list is NULL, it is created
+ * with the given entry being the first one. Note the string is REFERENCED, not copied.
+ * This function should be able to accomdate the removal of names from the list if needed in the
+ * future; if a name is removed from the list but its node remains (with a NULL value) then
+ * the given string will be added to the "dummy" node
+ */
+ACVP_RESULT acvp_append_name_list(ACVP_CTX *ctx, ACVP_NAME_LIST **list, const char *string) {
+    ACVP_NAME_LIST *current = NULL;
+    int count = 0;
+
+    if (!list) {
+        return ACVP_NO_DATA;
+    }
+
+    for (current = *list; current; current = current->next) {
+        if (!current->name) {
+            current->name = string;
+            return ACVP_SUCCESS;
+        }
+        count++;
+    }
+    current = acvp_list_append_node(ctx, (void **)list, sizeof(ACVP_NAME_LIST),
+                                    offsetof(ACVP_NAME_LIST, next), count);
+    if (!current) {
+        return ACVP_MALLOC_FAIL;
+    }
+    current->name = string;
+    return ACVP_SUCCESS;
+}
+
+/**
+ * Check if a REFERENCE to a certain string already exists in a name list
+ */
+int acvp_is_in_name_list(ACVP_NAME_LIST *list, const char *string) {
+    ACVP_NAME_LIST *current = NULL;
+    if (!list) {
+        return 0;
+    }
+    current = list;
+    while (current) {
+        if (current->name && current->name == string) {
+            return 1;
+        }
+        current = current->next;
+    }
+    return 0;
+}
+
+/**
+ * Simple utility function to add a string to a string list.
+ * Note that the string is COPIED and not referenced.
+ */
+ACVP_RESULT acvp_append_str_list(ACVP_STRING_LIST **list, const char *string) {
+    ACVP_STRING_LIST *current = NULL;
+    ACVP_STRING_LIST *prev = NULL;
+    char *word = NULL;
+
+    if (!list) {
+        return ACVP_NO_DATA;
+    }
+
+    int len = strnlen_s(string, ACVP_STRING_LIST_MAX_LEN);
+    word = calloc(len + 1, sizeof(char));
+    if (!word) {
+        return ACVP_MALLOC_FAIL;
+    }
+    strncpy_s(word, len + 1, string, len);
+
+    if (*list == NULL) {
         *list = calloc(1, sizeof(ACVP_STRING_LIST));
         if (*list == NULL) {
             free(word);
@@ -1539,16 +2518,56 @@ int acvp_is_domain_already_set(ACVP_JSON_DOMAIN_OBJ *domain) {
     return domain->min + domain->max + domain->increment;
 }
 
-ACVP_RESULT acvp_json_serialize_to_file_pretty_a(const JSON_Value *value, const char *filename) {
+/*
+ * Writes sep and then value to fp, streamed rather than serialized to a
+ * string first, pretty printed unless compact is set.
+ */
+static ACVP_RESULT acvp_json_write_fp(const JSON_Value *value, FILE *fp, const char *sep, int compact) {
+    JSON_Status status = JSONFailure;
+
+    if (fputs(sep, fp) == EOF) {
+        return ACVP_JSON_ERR;
+    }
+    if (compact) {
+        status = json_serialize_to_fp(value, fp);
+    } else {
+        status = json_serialize_to_fp_pretty(value, fp);
+    }
+    return status == JSONSuccess ? ACVP_SUCCESS : ACVP_JSON_ERR;
+}
+
+/*
+ * Opens a file the JSON of an offline run is written to, "-" being stdout,
+ * which acvp_json_out_close() then flushes rather than closes: the vector
+ * sets go out down the pipe as they are done.
+ */
+FILE *acvp_json_out_open(const char *filename, const char *mode) {
+    if (ACVP_IS_STDIO(filename)) {
+        return stdout;
+    }
+    return fopen(filename, mode);
+}
+
+int acvp_json_out_close(FILE *fp) {
+    if (fp == stdout) {
+        return fflush(fp);
+    }
+    return fclose(fp);
+}
+
+/*
+ * Appends ", " and value to a JSON array file started with
+ * acvp_json_serialize_to_file_w(), or the closing " ]" if value is NULL.
+ */
+ACVP_RESULT acvp_json_serialize_to_file_a(const JSON_Value *value, const char *filename, int compact) {
     ACVP_RESULT return_code = ACVP_SUCCESS;
     FILE *fp = NULL;
-    char *serialized_string = NULL; 
 
     if (!filename) {
         return ACVP_INVALID_ARG;
     }
 
-    fp = fopen(filename, "a");
+    fp = acvp_json_out_open(filename, "a");
     if (fp == NULL) {
         return ACVP_JSON_ERR;
     }
@@ -1557,32 +2576,20 @@ ACVP_RESULT acvp_json_serialize_to_file_pretty_a(const JSON_Value *value, const
             return_code = ACVP_JSON_ERR;
         }
     } else {
-
-        serialized_string = json_serialize_to_string_pretty(value, NULL);
-        if (serialized_string == NULL) {
-            fclose(fp);
-            return ACVP_JSON_ERR;
-        }
-        if (fputs(", ", fp) == EOF) {
-            return_code = ACVP_JSON_ERR;
-            goto end;
-        }
-        if (fputs(serialized_string, fp) == EOF) {
-            return_code = ACVP_JSON_ERR;
-        }
+        return_code = acvp_json_write_fp(value, fp, ", ", compact);
     }
-end:
-    if (fclose(fp) == EOF) {
+    if (acvp_json_out_close(fp) == EOF) {
         return_code = ACVP_JSON_ERR;
     }
-    json_free_serialized_string(serialized_string);
     return return_code;
 }
 
-ACVP_RESULT acvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const char *filename) {
+/*
+ * Starts a JSON array file with "[ " and value.
+ */
+ACVP_RESULT acvp_json_serialize_to_file_w(const JSON_Value *value, const char *filename, int compact) {
     ACVP_RESULT return_code = ACVP_SUCCESS;
     FILE *fp = NULL;
-    char *serialized_string = NULL;
 
     if (!value) {
         return ACVP_JSON_ERR;
@@ -1591,36 +2598,2295 @@ ACVP_RESULT acvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const
         return ACVP_INVALID_ARG;
     }
 
-    serialized_string = json_serialize_to_string_pretty(value, NULL);
-    if (serialized_string == NULL) {
-        return ACVP_JSON_ERR;
-    }
-    fp = fopen(filename, "w");
+    fp = acvp_json_out_open(filename, "w");
     if (fp == NULL) {
-        json_free_serialized_string(serialized_string);
         return ACVP_JSON_ERR;
     }
-    if (fputs("[ ", fp) == EOF) {
-        return_code = ACVP_JSON_ERR;
-        goto end;
-    }
-    if (fputs(serialized_string, fp) == EOF) {
-        json_free_serialized_string(serialized_string);
+    return_code = acvp_json_write_fp(value, fp, "[ ", compact);
+    if (acvp_json_out_close(fp) == EOF) {
         return_code = ACVP_JSON_ERR;
     }
-end:
-    if (fclose(fp) == EOF) {
-        return_code = ACVP_JSON_ERR;
-    }
-    json_free_serialized_string(serialized_string);
     return return_code;
 }
 
-void acvp_sleep(int seconds) {
-#ifdef _WIN32
-    Sleep(seconds * 1000);
-#else
-    sleep(seconds);
+ACVP_RESULT acvp_json_serialize_to_file_pretty_a(const JSON_Value *value, const char *filename) {
+    return acvp_json_serialize_to_file_a(value, filename, 0);
+}
+
+ACVP_RESULT acvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const char *filename) {
+    return acvp_json_serialize_to_file_w(value, filename, 0);
+}
+
+/*
+ * Loads a file for parsing, followed by at least one zero byte so it can be
+ * handled as a string. On POSIX systems the file is mapped rather than read
+ * into a heap buffer, so a large file costs no more memory than what is
+ * built from it: the rest of the last file page reads as zeroes, and when
+ * the file ends on a page boundary an anonymous page reserved behind it
+ * does. map_len is set to the mapped size, or 0 if the file was read into
+ * the heap instead. Release with acvp_file_unload().
+ */
+char *acvp_file_load(const char *filename, size_t *len, size_t *map_len) {
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long size = 0;
+#ifndef _WIN32
+    struct stat st;
+    size_t page = 0;
+    long page_size = 0;
+    char *base = NULL;
+    int fd = -1;
+#endif
+
+    *len = 0;
+    *map_len = 0;
+    if (!filename) {
+        return NULL;
+    }
+
+#ifndef _WIN32
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    page_size = sysconf(_SC_PAGESIZE);
+    if (!fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0 && page_size > 0 &&
+            (unsigned long long)st.st_size < (unsigned long long)(SIZE_MAX - page_size)) {
+        page = (size_t)page_size;
+        *len = (size_t)st.st_size;
+        *map_len = (*len / page + 1) * page;
+        base = mmap(NULL, *map_len, PROT_READ, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (base != MAP_FAILED) {
+            if (mmap(base, *len, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                close(fd);
+                madvise(base, *len, MADV_SEQUENTIAL);
+                return base;
+            }
+            munmap(base, *map_len);
+        }
+        *len = 0;
+        *map_len = 0;
+    }
+    close(fd);
+#endif
+
+    /* Not mappable, read it in */
+    fp = fopen(filename, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    if (fseek(fp, 0L, SEEK_END) || (size = ftell(fp)) < 0 || fseek(fp, 0L, SEEK_SET)) {
+        fclose(fp);
+        return NULL;
+    }
+    buf = malloc((size_t)size + 1);
+    if (!buf) {
+        fclose(fp);
+        return NULL;
+    }
+    *len = fread(buf, 1, (size_t)size, fp);
+    fclose(fp);
+    if (*len != (size_t)size) {
+        free(buf);
+        *len = 0;
+        return NULL;
+    }
+    buf[*len] = '\0';
+    return buf;
+}
+
+void acvp_file_unload(char *buf, size_t map_len) {
+    if (!buf) {
+        return;
+    }
+#ifndef _WIN32
+    if (map_len) {
+        munmap(buf, map_len);
+        return;
+    }
+#endif
+    free(buf);
+}
+
+/*
+ * Parses a JSON file such as a saved request or response file, without
+ * first copying it into the heap where the file can be mapped.
+ */
+JSON_Value *acvp_json_parse_file(const char *filename) {
+    JSON_Value *val = NULL;
+    size_t len = 0, map_len = 0;
+    char *buf = NULL;
+
+    buf = acvp_file_load(filename, &len, &map_len);
+    if (!buf) {
+        return NULL;
+    }
+    val = json_parse_string(buf);
+    acvp_file_unload(buf, map_len);
+    return val;
+}
+
+/*
+ * A light scan of JSON text, for finding the values of a large document
+ * without building a DOM of it; the values found are not validated. Each
+ * returns where the text after what it skipped starts, or NULL if the text
+ * ends first.
+ */
+static const char *acvp_json_scan_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        p++;
+    }
+    return p;
+}
+
+static const char *acvp_json_scan_string(const char *p, const char *end) {
+    for (p++; p < end; p++) {
+        if (*p == '\\') {
+            p++;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return NULL;
+}
+
+static const char *acvp_json_scan_value(const char *p, const char *end) {
+    int depth = 0;
+
+    if (p >= end) {
+        return NULL;
+    }
+    if (*p == '"') {
+        return acvp_json_scan_string(p, end);
+    }
+    if (*p != '{' && *p != '[') {
+        while (p < end && !strchr(",]} \t\r\n", *p)) {
+            p++;
+        }
+        return p;
+    }
+    while (p < end) {
+        switch (*p) {
+        case '"':
+            p = acvp_json_scan_string(p, end);
+            if (!p) {
+                return NULL;
+            }
+            continue;
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0) {
+                return p + 1;
+            }
+            break;
+        default:
+            break;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/*
+ * Finds the elements of the top level array of a JSON text, without parsing
+ * them. Returns the number of elements with *slices set to a heap array of
+ * them, or -1 if the text is not an array or ends before the array does.
+ */
+int acvp_json_slice_array(const char *text, size_t len, ACVP_JSON_SLICE **slices) {
+    const char *p = text, *end = text + len, *next = NULL;
+    ACVP_JSON_SLICE *arr = NULL, *tmp = NULL;
+    int count = 0, size = 0;
+
+    *slices = NULL;
+    p = acvp_json_scan_ws(p, end);
+    if (p >= end || *p != '[') {
+        return -1;
+    }
+    p = acvp_json_scan_ws(p + 1, end);
+    while (p < end && *p != ']') {
+        next = acvp_json_scan_value(p, end);
+        if (!next || next == p) {
+            goto err;
+        }
+        if (count == size) {
+            size = size ? size * 2 : 16;
+            tmp = realloc(arr, size * sizeof(ACVP_JSON_SLICE));
+            if (!tmp) {
+                goto err;
+            }
+            arr = tmp;
+        }
+        arr[count].p = p;
+        arr[count].len = (size_t)(next - p);
+        count++;
+
+        p = acvp_json_scan_ws(next, end);
+        if (p < end && *p == ',') {
+            p = acvp_json_scan_ws(p + 1, end);
+        } else if (p >= end || *p != ']') {
+            goto err;
+        }
+    }
+    if (p >= end) {
+        goto err;
+    }
+    *slices = arr;
+    return count;
+
+err:
+    if (arr) free(arr);
+    return -1;
+}
+
+/*
+ * The number that the object in slice has for name, without parsing the
+ * rest of it; 0 if it has none.
+ */
+long acvp_json_slice_get_number(const ACVP_JSON_SLICE *slice, const char *name) {
+    const char *p = slice->p, *end = slice->p + slice->len, *key_end = NULL;
+    size_t name_len = strnlen_s(name, RSIZE_MAX_STR);
+    int match = 0;
+
+    if (p >= end || *p != '{') {
+        return 0;
+    }
+    p = acvp_json_scan_ws(p + 1, end);
+    while (p < end && *p == '"') {
+        key_end = acvp_json_scan_string(p, end);
+        if (!key_end) {
+            return 0;
+        }
+        match = (size_t)(key_end - p) == name_len + 2 && !strncmp(p + 1, name, name_len);
+        p = acvp_json_scan_ws(key_end, end);
+        if (p >= end || *p != ':') {
+            return 0;
+        }
+        p = acvp_json_scan_ws(p + 1, end);
+        if (match) {
+            return (p < end && (*p == '-' || isdigit((unsigned char)*p))) ? strtol(p, NULL, 10) : 0;
+        }
+        p = acvp_json_scan_value(p, end);
+        if (!p) {
+            return 0;
+        }
+        p = acvp_json_scan_ws(p, end);
+        if (p < end && *p == ',') {
+            p = acvp_json_scan_ws(p + 1, end);
+        }
+    }
+    return 0;
+}
+
+void acvp_json_stream_init(ACVP_JSON_STREAM *s, FILE *fp) {
+    memzero_s(s, sizeof(ACVP_JSON_STREAM));
+    s->fp = fp;
+}
+
+void acvp_json_stream_free(ACVP_JSON_STREAM *s) {
+    if (s->buf) free(s->buf);
+    memzero_s(s, sizeof(ACVP_JSON_STREAM));
+}
+
+/*
+ * Reads more of the stream into its buffer, after dropping what was handed
+ * out already. As much is asked for as the buffer holds, so that a value
+ * larger than a chunk is scanned a number of times that grows with the log
+ * of its size only. Returns 1 if anything was read, 0 at the end of the
+ * stream and -1 on error.
+ */
+static int acvp_json_stream_fill(ACVP_JSON_STREAM *s) {
+    size_t want = 0, got = 0, cap = 0;
+    char *tmp = NULL;
+#ifndef _WIN32
+    ssize_t n = 0;
+#endif
+
+    if (s->pos) {
+        memmove(s->buf, s->buf + s->pos, s->len - s->pos);
+        s->len -= s->pos;
+        s->pos = 0;
+    }
+    want = s->len > ACVP_JSON_STREAM_CHUNK ? s->len : ACVP_JSON_STREAM_CHUNK;
+    if (s->len + want + 1 > s->cap) {
+        cap = s->len + want + 1;
+        tmp = realloc(s->buf, cap);
+        if (!tmp) {
+            return -1;
+        }
+        s->buf = tmp;
+        s->cap = cap;
+    }
+#ifndef _WIN32
+    /* What the pipe has so far, where fread() would wait for all of it */
+    do {
+        n = read(fileno(s->fp), s->buf + s->len, want);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return -1;
+    }
+    got = (size_t)n;
+#else
+    got = fread(s->buf + s->len, 1, want, s->fp);
+    if (!got && ferror(s->fp)) {
+        return -1;
+    }
+#endif
+    s->len += got;
+    s->buf[s->len] = '\0';
+    return got ? 1 : 0;
+}
+
+/*
+ * Sets slice to the next value of the JSON array of the stream, reading as
+ * far as it ends and no further; the value stays in the buffer of the
+ * stream until the next call. Returns 1 if there is one, 0 at the end of
+ * the array and -1 if the stream is not a JSON array or ends before it does.
+ */
+int acvp_json_stream_next(ACVP_JSON_STREAM *s, ACVP_JSON_SLICE *slice) {
+    const char *p = NULL, *end = NULL, *next = NULL;
+    int rc = 0;
+
+    while (s->state != ACVP_JSON_STREAM_DONE) {
+        if (s->buf) {
+            end = s->buf + s->len;
+            p = acvp_json_scan_ws(s->buf + s->pos, end);
+            s->pos = (size_t)(p - s->buf);
+        }
+        if (p && p < end) {
+            if (s->state == ACVP_JSON_STREAM_START) {
+                if (*p != '[') {
+                    return -1;
+                }
+                s->state = ACVP_JSON_STREAM_FIRST;
+                s->pos++;
+                continue;
+            }
+            if (s->state == ACVP_JSON_STREAM_AFTER || (s->state == ACVP_JSON_STREAM_FIRST && *p == ']')) {
+                if (*p == ']') {
+                    s->state = ACVP_JSON_STREAM_DONE;
+                    s->pos++;
+                    return 0;
+                }
+                if (*p != ',') {
+                    return -1;
+                }
+                s->state = ACVP_JSON_STREAM_VALUE;
+                s->pos++;
+                continue;
+            }
+            next = acvp_json_scan_value(p, end);
+            /* A number or literal may go on in what is not read yet */
+            if (next && (next < end || *p == '{' || *p == '[' || *p == '"')) {
+                if (next == p) {
+                    return -1;
+                }
+                slice->p = p;
+                slice->len = (size_t)(next - p);
+                s->pos = (size_t)(next - s->buf);
+                s->state = ACVP_JSON_STREAM_AFTER;
+                return 1;
+            }
+        }
+        rc = acvp_json_stream_fill(s);
+        if (rc <= 0) {
+            return -1;
+        }
+        p = NULL;
+    }
+    return 0;
+}
+
+/*
+ * Parses the value acvp_json_stream_next() last handed out, in place
+ */
+JSON_Value *acvp_json_stream_parse(ACVP_JSON_STREAM *s, const ACVP_JSON_SLICE *slice) {
+    JSON_Value *val = NULL;
+    char c = s->buf[s->pos];
+
+    s->buf[s->pos] = '\0';
+    val = json_parse_string(slice->p);
+    s->buf[s->pos] = c;
+    return val;
+}
+
+static size_t acvp_gcd(size_t a, size_t b) {
+    size_t t = 0;
+
+    while (b) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*
+ * Builds a read-only buffer of at least total bytes that is tile repeated
+ * over and over, without the memory for all of it. A temporary file gets a
+ * segment of whole tiles, whole pages long, and that one segment is mapped
+ * again and again back to back, so what backs the buffer is the segment in
+ * the page cache however large total is. map_len is set to the size to pass
+ * to acvp_unmap_repeated(). Returns NULL where this cannot be done (and on
+ * Windows), in which case the caller has to do without.
+ */
+unsigned char *acvp_map_repeated(const unsigned char *tile,
+                                 size_t tile_len,
+                                 unsigned long long int total,
+                                 size_t *map_len) {
+#ifndef _WIN32
+    FILE *fp = NULL;
+    unsigned char *unit_buf = NULL, *base = NULL;
+    size_t page = 0, unit = 0, seg = 0, i = 0, segs = 0;
+    long page_size = 0;
+    int fd = -1, ok = 0;
+
+    *map_len = 0;
+    page_size = sysconf(_SC_PAGESIZE);
+    if (!tile || !tile_len || !total || page_size <= 0) {
+        return NULL;
+    }
+    page = (size_t)page_size;
+
+    /* The shortest run of whole tiles that is also whole pages */
+    unit = tile_len / acvp_gcd(tile_len, page) * page;
+    if (unit > ACVP_MAP_REPEAT_SEGMENT_MAX) {
+        return NULL;
+    }
+    seg = unit * (ACVP_MAP_REPEAT_SEGMENT / unit ? ACVP_MAP_REPEAT_SEGMENT / unit : 1);
+    if (total > (unsigned long long int)(SIZE_MAX / 2)) {
+        return NULL;
+    }
+    segs = (size_t)((total + seg - 1) / seg);
+    *map_len = segs * seg;
+
+    unit_buf = malloc(unit);
+    fp = tmpfile();
+    if (!unit_buf || !fp) {
+        goto end;
+    }
+    for (i = 0; i < unit; i += tile_len) {
+        memcpy_s(unit_buf + i, unit - i, tile, tile_len);
+    }
+    for (i = 0; i < seg; i += unit) {
+        if (fwrite(unit_buf, 1, unit, fp) != unit) {
+            goto end;
+        }
+    }
+    if (fflush(fp)) {
+        goto end;
+    }
+    fd = fileno(fp);
+
+    base = mmap(NULL, *map_len, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (base == MAP_FAILED) {
+        base = NULL;
+        goto end;
+    }
+    for (i = 0; i < segs; i++) {
+        if (mmap(base + i * seg, seg, PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            goto end;
+        }
+    }
+    madvise(base, *map_len, MADV_SEQUENTIAL);
+    ok = 1;
+
+end:
+    /* The mappings keep the file alive */
+    if (fp) fclose(fp);
+    if (unit_buf) free(unit_buf);
+    if (!ok) {
+        if (base) munmap(base, *map_len);
+        *map_len = 0;
+        return NULL;
+    }
+    return base;
+#else
+    *map_len = 0;
+    return NULL;
+#endif
+}
+
+void acvp_unmap_repeated(unsigned char *buf, size_t map_len) {
+#ifndef _WIN32
+    if (buf && map_len) {
+        munmap(buf, map_len);
+    }
+#endif
+}
+
+/*
+ * Allocates a buffer that may be large, such as the receive buffer of a big
+ * vector set. With huge set, see acvp_set_huge_pages(), one of at least
+ * ACVP_HUGE_PAGE_SIZE bytes is an anonymous mapping: of explicit huge pages
+ * if the system has some reserved, otherwise of normal pages the kernel is
+ * advised to back with transparent huge pages, so touching it takes a
+ * fraction of the page faults and TLB entries. Smaller buffers, systems
+ * without anonymous mappings and mappings that fail come from the heap.
+ * mapped is set to say which, and size to the size of the buffer, rounded
+ * up to whole huge pages when it is mapped; both are needed by
+ * acvp_big_free().
+ */
+char *acvp_big_alloc(size_t *size, int huge, int *mapped) {
+#if !defined _WIN32 && defined MAP_ANON
+    void *base = MAP_FAILED;
+    size_t len = 0;
+#endif
+
+    *mapped = 0;
+#if !defined _WIN32 && defined MAP_ANON
+    if (huge && *size >= ACVP_HUGE_PAGE_SIZE && *size <= SIZE_MAX - ACVP_HUGE_PAGE_SIZE) {
+        len = (*size + ACVP_HUGE_PAGE_SIZE - 1) & ~((size_t)ACVP_HUGE_PAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+        base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+#endif
+        if (base == MAP_FAILED) {
+            /* No huge pages reserved */
+            base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (base != MAP_FAILED) {
+                madvise(base, len, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (base != MAP_FAILED) {
+            *size = len;
+            *mapped = 1;
+            return base;
+        }
+    }
+#endif
+    return malloc(*size);
+}
+
+void acvp_big_free(char *buf, size_t size, int mapped) {
+    if (!buf) {
+        return;
+    }
+#ifndef _WIN32
+    if (mapped) {
+        munmap(buf, size);
+        return;
+    }
+#endif
+    free(buf);
+}
+
+/*
+ * Vector set cache
+ *
+ * A compiled form of a request file, so repeated offline runs over the same
+ * file skip JSON text parsing (tokenizing, unescaping and number
+ * conversion) and load the DOM from length-prefixed binary records. The
+ * header records the size and modification time of the request file the
+ * cache was built from; a cache that does not match is rebuilt.
+ *
+ * Layout, integers little endian:
+ *   header: magic "ACVPVC01", u64 source size, i64 source mtime
+ *   value:  u8 type, then
+ *           null/false/true: nothing       number: IEEE 754 double as u64
+ *           string: u32 length, bytes      array: u32 count, values
+ *           object: u32 count, then count times (u32 name length, name, value)
+ */
+#define ACVP_VS_CACHE_MAGIC "ACVPVC01"
+#define ACVP_VS_CACHE_MAGIC_LEN 8
+#define ACVP_VS_CACHE_HDR_LEN (ACVP_VS_CACHE_MAGIC_LEN + 16)
+#define ACVP_VS_CACHE_MAX_DEPTH 2048
+#define ACVP_VS_CACHE_NAME_MAX 128
+
+enum {
+    ACVP_VS_CACHE_NULL = 0,
+    ACVP_VS_CACHE_FALSE,
+    ACVP_VS_CACHE_TRUE,
+    ACVP_VS_CACHE_NUMBER,
+    ACVP_VS_CACHE_STRING,
+    ACVP_VS_CACHE_ARRAY,
+    ACVP_VS_CACHE_OBJECT
+};
+
+typedef struct acvp_vs_cache_rd_t {
+    const unsigned char *p;
+    const unsigned char *end;
+} ACVP_VS_CACHE_RD;
+
+static int acvp_vs_cache_put(FILE *fp, unsigned long long v, int bytes) {
+    unsigned char b[8];
+    int i = 0;
+
+    for (i = 0; i < bytes; i++) {
+        b[i] = (unsigned char)(v >> (8 * i));
+    }
+    return fwrite(b, 1, bytes, fp) == (size_t)bytes;
+}
+
+static int acvp_vs_cache_get(ACVP_VS_CACHE_RD *rd, unsigned long long *v, int bytes) {
+    int i = 0;
+
+    if (rd->end - rd->p < bytes) {
+        return 0;
+    }
+    *v = 0;
+    for (i = 0; i < bytes; i++) {
+        *v |= (unsigned long long)rd->p[i] << (8 * i);
+    }
+    rd->p += bytes;
+    return 1;
+}
+
+static int acvp_vs_cache_put_str(FILE *fp, const char *str, size_t len) {
+    if (len > 0xFFFFFFFFUL || !acvp_vs_cache_put(fp, len, 4)) {
+        return 0;
+    }
+    return fwrite(str, 1, len, fp) == len;
+}
+
+static int acvp_vs_cache_write_value(FILE *fp, const JSON_Value *val) {
+    JSON_Array *arr = NULL;
+    JSON_Object *obj = NULL;
+    const char *name = NULL;
+    unsigned long long bits = 0;
+    double num = 0;
+    size_t i = 0, count = 0;
+
+    switch (json_value_get_type(val)) {
+    case JSONNull:
+        return acvp_vs_cache_put(fp, ACVP_VS_CACHE_NULL, 1);
+    case JSONBoolean:
+        return acvp_vs_cache_put(fp, json_value_get_boolean(val) ?
+                                 ACVP_VS_CACHE_TRUE : ACVP_VS_CACHE_FALSE, 1);
+    case JSONNumber:
+        num = json_value_get_number(val);
+        memcpy_s(&bits, sizeof(bits), &num, sizeof(num));
+        return acvp_vs_cache_put(fp, ACVP_VS_CACHE_NUMBER, 1) && acvp_vs_cache_put(fp, bits, 8);
+    case JSONString:
+        return acvp_vs_cache_put(fp, ACVP_VS_CACHE_STRING, 1) &&
+               acvp_vs_cache_put_str(fp, json_value_get_string(val), json_value_get_string_len(val));
+    case JSONArray:
+        arr = json_value_get_array(val);
+        count = json_array_get_count(arr);
+        if (!acvp_vs_cache_put(fp, ACVP_VS_CACHE_ARRAY, 1) || !acvp_vs_cache_put(fp, count, 4)) {
+            return 0;
+        }
+        for (i = 0; i < count; i++) {
+            if (!acvp_vs_cache_write_value(fp, json_array_get_value(arr, i))) {
+                return 0;
+            }
+        }
+        return 1;
+    case JSONObject:
+        obj = json_value_get_object(val);
+        count = json_object_get_count(obj);
+        if (!acvp_vs_cache_put(fp, ACVP_VS_CACHE_OBJECT, 1) || !acvp_vs_cache_put(fp, count, 4)) {
+            return 0;
+        }
+        for (i = 0; i < count; i++) {
+            name = json_object_get_name(obj, i);
+            if (!name ||
+                    !acvp_vs_cache_put_str(fp, name, strnlen_s(name, ACVP_VS_CACHE_NAME_MAX + 1)) ||
+                    !acvp_vs_cache_write_value(fp, json_object_get_value_at(obj, i))) {
+                return 0;
+            }
+        }
+        return 1;
+    case JSONError:
+    default:
+        return 0;
+    }
+}
+
+static JSON_Value *acvp_vs_cache_read_value(ACVP_VS_CACHE_RD *rd, int depth) {
+    JSON_Value *val = NULL, *child = NULL;
+    JSON_Array *arr = NULL;
+    JSON_Object *obj = NULL;
+    char name[ACVP_VS_CACHE_NAME_MAX + 1];
+    unsigned long long type = 0, v = 0, count = 0, i = 0;
+    double num = 0;
+
+    if (depth > ACVP_VS_CACHE_MAX_DEPTH || !acvp_vs_cache_get(rd, &type, 1)) {
+        return NULL;
+    }
+
+    switch (type) {
+    case ACVP_VS_CACHE_NULL:
+        return json_value_init_null();
+    case ACVP_VS_CACHE_FALSE:
+    case ACVP_VS_CACHE_TRUE:
+        return json_value_init_boolean(type == ACVP_VS_CACHE_TRUE);
+    case ACVP_VS_CACHE_NUMBER:
+        if (!acvp_vs_cache_get(rd, &v, 8)) {
+            return NULL;
+        }
+        memcpy_s(&num, sizeof(num), &v, sizeof(v));
+        return json_value_init_number(num);
+    case ACVP_VS_CACHE_STRING:
+        if (!acvp_vs_cache_get(rd, &v, 4) || (unsigned long long)(rd->end - rd->p) < v) {
+            return NULL;
+        }
+        val = json_value_init_string_with_len((const char *)rd->p, (size_t)v);
+        rd->p += v;
+        return val;
+    case ACVP_VS_CACHE_ARRAY:
+        if (!acvp_vs_cache_get(rd, &count, 4)) {
+            return NULL;
+        }
+        val = json_value_init_array();
+        arr = json_value_get_array(val);
+        for (i = 0; arr && i < count; i++) {
+            child = acvp_vs_cache_read_value(rd, depth + 1);
+            if (!child || json_array_append_value(arr, child) != JSONSuccess) {
+                if (child) json_value_free(child);
+                json_value_free(val);
+                return NULL;
+            }
+        }
+        return val;
+    case ACVP_VS_CACHE_OBJECT:
+        if (!acvp_vs_cache_get(rd, &count, 4)) {
+            return NULL;
+        }
+        val = json_value_init_object();
+        obj = json_value_get_object(val);
+        for (i = 0; obj && i < count; i++) {
+            if (!acvp_vs_cache_get(rd, &v, 4) || v > ACVP_VS_CACHE_NAME_MAX ||
+                    (unsigned long long)(rd->end - rd->p) < v) {
+                json_value_free(val);
+                return NULL;
+            }
+            memcpy_s(name, sizeof(name), rd->p, (size_t)v);
+            name[v] = '\0';
+            rd->p += v;
+            child = acvp_vs_cache_read_value(rd, depth + 1);
+            if (!child || json_object_set_value(obj, name, child) != JSONSuccess) {
+                if (child) json_value_free(child);
+                json_value_free(val);
+                return NULL;
+            }
+        }
+        return val;
+    default:
+        return NULL;
+    }
+}
+
+/*
+ * Loads the DOM of a request file from its cache when the cache was built
+ * from the file as it is now. Otherwise the request file is parsed and the
+ * cache (re)built from it; failing to write the cache is not an error.
+ */
+JSON_Value *acvp_vs_cache_load(ACVP_CTX *ctx, const char *req_filename, const char *cache_filename) {
+    JSON_Value *val = NULL;
+    ACVP_VS_CACHE_RD rd;
+    struct stat st;
+    unsigned long long src_size = 0, src_mtime = 0;
+    size_t len = 0, map_len = 0;
+    char *buf = NULL;
+    FILE *fp = NULL;
+    int ok = 0;
+
+    if (stat(req_filename, &st)) {
+        ACVP_LOG_ERR("Unable to access request file %s", req_filename);
+        return NULL;
+    }
+
+    buf = acvp_file_load(cache_filename, &len, &map_len);
+    if (buf && len > ACVP_VS_CACHE_HDR_LEN && !memcmp(buf, ACVP_VS_CACHE_MAGIC, ACVP_VS_CACHE_MAGIC_LEN)) {
+        rd.p = (const unsigned char *)buf + ACVP_VS_CACHE_MAGIC_LEN;
+        rd.end = (const unsigned char *)buf + len;
+        if (acvp_vs_cache_get(&rd, &src_size, 8) && acvp_vs_cache_get(&rd, &src_mtime, 8) &&
+                src_size == (unsigned long long)st.st_size &&
+                src_mtime == (unsigned long long)st.st_mtime) {
+            val = acvp_vs_cache_read_value(&rd, 0);
+            if (val && rd.p != rd.end) {
+                json_value_free(val);
+                val = NULL;
+            }
+        }
+    }
+    acvp_file_unload(buf, map_len);
+    if (val) {
+        ACVP_LOG_STATUS("Loaded vector sets from cache %s", cache_filename);
+        return val;
+    }
+
+    val = acvp_json_parse_file(req_filename);
+    if (!val) {
+        return NULL;
+    }
+
+    fp = fopen(cache_filename, "wb");
+    if (fp) {
+        ok = fwrite(ACVP_VS_CACHE_MAGIC, 1, ACVP_VS_CACHE_MAGIC_LEN, fp) == ACVP_VS_CACHE_MAGIC_LEN &&
+             acvp_vs_cache_put(fp, (unsigned long long)st.st_size, 8) &&
+             acvp_vs_cache_put(fp, (unsigned long long)st.st_mtime, 8) &&
+             acvp_vs_cache_write_value(fp, val);
+        if (fclose(fp) == EOF) {
+            ok = 0;
+        }
+    }
+    if (ok) {
+        ACVP_LOG_STATUS("Saved vector set cache %s", cache_filename);
+    } else {
+        ACVP_LOG_WARN("Unable to write vector set cache %s", cache_filename);
+        remove(cache_filename);
+    }
+    return val;
+}
+
+/*
+ * Registration cache
+ *
+ * The serialized registration of a set of capabilities, so repeated
+ * sessions with the same capabilities skip writing it out as JSON text. The
+ * fingerprint is taken over the algorithms JSON the registration is
+ * serialized from, together with the isSample flag and the protocol
+ * version, so a cache made for different capabilities is never used.
+ *
+ * Layout, integers little endian:
+ *   magic "ACVPRC01", u64 fingerprint, u32 length, length bytes of JSON text
+ */
+#define ACVP_REG_CACHE_MAGIC "ACVPRC01"
+#define ACVP_REG_CACHE_MAGIC_LEN 8
+#define ACVP_REG_CACHE_HDR_LEN (ACVP_REG_CACHE_MAGIC_LEN + 12)
+#define ACVP_FP_PRIME 1099511628211ULL
+
+/*
+ * FNV-1a, 64 bit; fp starts out as ACVP_FP_OFFSET. Also used for the keys
+ * of the validation metadata cache, see acvp_operating_env.c
+ */
+void acvp_fp_bytes(unsigned long long *fp, const void *data, size_t len) {
+    const unsigned char *p = data;
+    size_t i = 0;
+
+    for (i = 0; i < len; i++) {
+        *fp ^= p[i];
+        *fp *= ACVP_FP_PRIME;
+    }
+}
+
+static void acvp_reg_fp_len(unsigned long long *fp, size_t len) {
+    unsigned char b[4];
+
+    b[0] = len & 0xFF;
+    b[1] = (len >> 8) & 0xFF;
+    b[2] = (len >> 16) & 0xFF;
+    b[3] = (len >> 24) & 0xFF;
+    acvp_fp_bytes(fp, b, sizeof(b));
+}
+
+static void acvp_reg_fp_value(unsigned long long *fp, const JSON_Value *val) {
+    unsigned char type = (unsigned char)json_value_get_type(val);
+    const char *name = NULL;
+    JSON_Object *obj = NULL;
+    JSON_Array *arr = NULL;
+    double num = 0;
+    size_t i = 0, count = 0;
+
+    acvp_fp_bytes(fp, &type, 1);
+    switch (json_value_get_type(val)) {
+    case JSONBoolean:
+        type = (unsigned char)json_value_get_boolean(val);
+        acvp_fp_bytes(fp, &type, 1);
+        break;
+    case JSONNumber:
+        num = json_value_get_number(val);
+        acvp_fp_bytes(fp, &num, sizeof(num));
+        break;
+    case JSONString:
+        count = json_value_get_string_len(val);
+        acvp_reg_fp_len(fp, count);
+        acvp_fp_bytes(fp, json_value_get_string(val), count);
+        break;
+    case JSONArray:
+        arr = json_value_get_array(val);
+        count = json_array_get_count(arr);
+        acvp_reg_fp_len(fp, count);
+        for (i = 0; i < count; i++) {
+            acvp_reg_fp_value(fp, json_array_get_value(arr, i));
+        }
+        break;
+    case JSONObject:
+        obj = json_value_get_object(val);
+        count = json_object_get_count(obj);
+        acvp_reg_fp_len(fp, count);
+        for (i = 0; i < count; i++) {
+            name = json_object_get_name(obj, i);
+            acvp_reg_fp_len(fp, strlen(name));
+            acvp_fp_bytes(fp, name, strlen(name));
+            acvp_reg_fp_value(fp, json_object_get_value_at(obj, i));
+        }
+        break;
+    case JSONNull:
+    case JSONError:
+    default:
+        break;
+    }
+}
+
+/*
+ * Fingerprint of a registration, see the registration cache above
+ */
+unsigned long long int acvp_reg_fingerprint(const JSON_Value *algorithms, int is_sample) {
+    unsigned long long int fp = ACVP_FP_OFFSET;
+    unsigned char sample = is_sample ? 1 : 0;
+
+    acvp_fp_bytes(&fp, ACVP_PROTOCOL_VERSION, strlen(ACVP_PROTOCOL_VERSION));
+    acvp_fp_bytes(&fp, &sample, 1);
+    acvp_reg_fp_value(&fp, algorithms);
+    return fp;
+}
+
+/*
+ * Returns the serialized registration saved in the cache file if it was
+ * saved for the same fingerprint, NULL otherwise. The string is to be
+ * released with json_free_serialized_string().
+ */
+char *acvp_reg_cache_load(ACVP_CTX *ctx, const char *cache_filename, unsigned long long int fp, int *out_len) {
+    ACVP_VS_CACHE_RD rd;
+    unsigned long long int saved_fp = 0, saved_len = 0;
+    size_t len = 0, map_len = 0;
+    char *buf = NULL, *out = NULL;
+
+    buf = acvp_file_load(cache_filename, &len, &map_len);
+    if (buf && len >= ACVP_REG_CACHE_HDR_LEN && !memcmp(buf, ACVP_REG_CACHE_MAGIC, ACVP_REG_CACHE_MAGIC_LEN)) {
+        rd.p = (const unsigned char *)buf + ACVP_REG_CACHE_MAGIC_LEN;
+        rd.end = (const unsigned char *)buf + len;
+        if (acvp_vs_cache_get(&rd, &saved_fp, 8) && acvp_vs_cache_get(&rd, &saved_len, 4) &&
+                saved_fp == fp && saved_len == (unsigned long long int)(rd.end - rd.p) &&
+                saved_len < INT_MAX) {
+            out = malloc((size_t)saved_len + 1);
+            if (out) {
+                memcpy_s(out, (size_t)saved_len + 1, rd.p, (size_t)saved_len);
+                out[saved_len] = '\0';
+                *out_len = (int)saved_len;
+            }
+        }
+    }
+    acvp_file_unload(buf, map_len);
+    if (out) {
+        ACVP_LOG_STATUS("Loaded registration from cache %s", cache_filename);
+    }
+    return out;
+}
+
+/*
+ * Saves a serialized registration in the cache file; failing to is not an
+ * error, the next session just serializes the registration again.
+ */
+void acvp_reg_cache_save(ACVP_CTX *ctx, const char *cache_filename, unsigned long long int fp,
+                         const char *reg, int reg_len) {
+    FILE *fp_out = NULL;
+    int ok = 0;
+
+    if (reg_len < 0) {
+        return;
+    }
+    fp_out = fopen(cache_filename, "wb");
+    if (fp_out) {
+        ok = fwrite(ACVP_REG_CACHE_MAGIC, 1, ACVP_REG_CACHE_MAGIC_LEN, fp_out) == ACVP_REG_CACHE_MAGIC_LEN &&
+             acvp_vs_cache_put(fp_out, fp, 8) &&
+             acvp_vs_cache_put(fp_out, (unsigned long long int)reg_len, 4) &&
+             fwrite(reg, 1, (size_t)reg_len, fp_out) == (size_t)reg_len;
+        if (fclose(fp_out) == EOF) {
+            ok = 0;
+        }
+    }
+    if (ok) {
+        ACVP_LOG_STATUS("Saved registration cache %s", cache_filename);
+    } else {
+        ACVP_LOG_WARN("Unable to write registration cache %s", cache_filename);
+        remove(cache_filename);
+    }
+}
+
+/*
+ * Download cache of vector sets, see acvp_set_vector_set_download_cache().
+ * Each vector set is kept, as the server sent it, in a file of its own in
+ * the cache directory, named for a fingerprint of the server, the test
+ * session and the vsId URL:
+ *
+ *     <dir>/vs-<fingerprint>.json
+ *
+ * A download is written to the file with ".part" added to its name first,
+ * and only renamed to the cache file once it turns out to be the vector set
+ * itself rather than a request to retry later.
+ */
+static int acvp_vs_dl_cache_path(ACVP_CTX *ctx, const char *vsid_url, int part, char *path, size_t len) {
+    unsigned long long int fp = ACVP_FP_OFFSET;
+    const char *session_url = ctx->session_url ? ctx->session_url : "";
+    int n = 0;
+
+    if (ctx->server_name) {
+        acvp_fp_bytes(&fp, ctx->server_name, strnlen_s(ctx->server_name, ACVP_SESSION_PARAMS_STR_LEN_MAX + 1));
+    }
+    acvp_fp_bytes(&fp, &ctx->server_port, sizeof(ctx->server_port));
+    /* The zero bytes keep the session and vsId URLs apart */
+    acvp_fp_bytes(&fp, session_url, strnlen_s(session_url, ACVP_ATTR_URL_MAX) + 1);
+    acvp_fp_bytes(&fp, vsid_url, strnlen_s(vsid_url, ACVP_ATTR_URL_MAX) + 1);
+
+    n = snprintf(path, len, "%s/vs-%016llx.json%s", ctx->vs_dl_cache_dir, fp, part ? ".part" : "");
+    return n > 0 && (size_t)n < len;
+}
+
+/*
+ * Loads the vector set the cache has for vsid_url into the download buffer
+ * of ctx, as acvp_retrieve_vector_set() would have left it. Returns 0 when
+ * the cache does not have it.
+ */
+int acvp_vs_dl_cache_load(ACVP_CTX *ctx, const char *vsid_url) {
+    char path[ACVP_JSON_FILENAME_MAX + 32];
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long size = 0;
+    size_t buf_size = 0;
+    int huge = 0, mapped = 0;
+
+    if (!ctx->vs_dl_cache_dir || !acvp_vs_dl_cache_path(ctx, vsid_url, 0, path, sizeof(path))) {
+        return 0;
+    }
+    fp = fopen(path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    if (fseek(fp, 0L, SEEK_END) || (size = ftell(fp)) <= 0 || size >= INT_MAX || fseek(fp, 0L, SEEK_SET)) {
+        fclose(fp);
+        return 0;
+    }
+    buf_size = (size_t)size + 1;
+    /* Rounded up to huge pages, the size still has to fit curl_buf_size */
+    huge = ctx->exec.huge_pages && (size_t)INT_MAX - buf_size >= ACVP_HUGE_PAGE_SIZE;
+    buf = acvp_big_alloc(&buf_size, huge, &mapped);
+    if (buf && fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        acvp_big_free(buf, buf_size, mapped);
+        buf = NULL;
+    }
+    fclose(fp);
+    if (!buf) {
+        return 0;
+    }
+    buf[size] = '\0';
+
+    acvp_transport_release_buf(ctx);
+    ctx->exec.curl_buf = buf;
+    ctx->exec.curl_buf_size = (int)buf_size;
+    ctx->exec.curl_buf_mapped = mapped;
+    acvp_mem_charge(ctx->exec.mem, buf_size);
+    ctx->exec.curl_read_ctr = (int)size;
+    ACVP_LOG_STATUS("Loaded vector set %s from the download cache", vsid_url);
+    return 1;
+}
+
+/*
+ * Writes the vector set just downloaded for vsid_url to the cache, pending
+ * acvp_vs_dl_cache_keep(). Failing to is not an error, the vector set is just
+ * downloaded again next time.
+ */
+void acvp_vs_dl_cache_save(ACVP_CTX *ctx, const char *vsid_url) {
+    char path[ACVP_JSON_FILENAME_MAX + 32];
+    FILE *fp = NULL;
+    size_t len = (size_t)ctx->exec.curl_read_ctr;
+    int ok = 0;
+
+    if (!ctx->vs_dl_cache_dir || !ctx->exec.curl_buf || !len ||
+            !acvp_vs_dl_cache_path(ctx, vsid_url, 1, path, sizeof(path))) {
+        return;
+    }
+    fp = fopen(path, "wb");
+    if (fp) {
+        ok = fwrite(ctx->exec.curl_buf, 1, len, fp) == len;
+        if (fclose(fp) == EOF) {
+            ok = 0;
+        }
+    }
+    if (!ok) {
+        ACVP_LOG_WARN("Unable to write vector set %s to the download cache", vsid_url);
+        remove(path);
+    }
+}
+
+/*
+ * Makes the vector set written by acvp_vs_dl_cache_save() part of the cache
+ * if keep is set, and discards it otherwise.
+ */
+void acvp_vs_dl_cache_keep(ACVP_CTX *ctx, const char *vsid_url, int keep) {
+    char part[ACVP_JSON_FILENAME_MAX + 32];
+    char path[ACVP_JSON_FILENAME_MAX + 32];
+
+    if (!ctx->vs_dl_cache_dir || !acvp_vs_dl_cache_path(ctx, vsid_url, 1, part, sizeof(part)) ||
+            !acvp_vs_dl_cache_path(ctx, vsid_url, 0, path, sizeof(path))) {
+        return;
+    }
+    if (!keep) {
+        remove(part);
+        return;
+    }
+    /* rename() does not replace an existing file everywhere */
+    remove(path);
+    if (rename(part, path)) {
+        remove(part);
+        return;
+    }
+    ACVP_LOG_INFO("Saved vector set %s to the download cache", vsid_url);
+}
+
+/*
+ * Timing for the metrics callback, see acvp_set_metrics_cb(). Nothing is
+ * measured unless a callback is set. Time spent before a vector set has been
+ * started (logging in, registering) is not reported.
+ */
+unsigned long long int acvp_metrics_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (unsigned long long int)(count.QuadPart / freq.QuadPart) * 1000000000ULL +
+           (unsigned long long int)(count.QuadPart % freq.QuadPart) * 1000000000ULL / freq.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long int)ts.tv_sec * 1000000000ULL + (unsigned long long int)ts.tv_nsec;
+#endif
+}
+
+/*
+ * Adds the time since start to a phase of the vector set, and of the current
+ * test group when there is one.
+ */
+void acvp_metrics_add(ACVP_CTX *ctx, ACVP_METRICS_PHASE phase, unsigned long long int start) {
+    unsigned long long int ns = 0;
+
+    if (!ctx->metrics_cb) {
+        return;
+    }
+    ns = acvp_metrics_now() - start;
+    ctx->exec.vs_metrics.ns[phase] += ns;
+    if (ctx->exec.tg_metrics.tg_id) {
+        ctx->exec.tg_metrics.ns[phase] += ns;
+    }
+}
+
+/*
+ * Adds the time since start to the crypto phase, along with the number of
+ * crypto calls made in it. tc is the test case of a single call, NULL for a
+ * batch.
+ */
+void acvp_metrics_crypto(ACVP_CTX *ctx, unsigned long long int start, int calls, ACVP_TEST_CASE *tc) {
+    unsigned long long int ns = 0;
+
+    if (ctx->openmetrics || ctx->lat_enabled) {
+        ns = acvp_metrics_now() - start;
+    }
+    if (ctx->openmetrics) {
+        acvp_om_crypto(ctx, ns, calls);
+    }
+    if (ctx->lat_enabled) {
+        acvp_lat_add(ctx, ns, calls, tc);
+    }
+    if (!ctx->metrics_cb) {
+        return;
+    }
+    acvp_metrics_add(ctx, ACVP_METRICS_CRYPTO, start);
+    ctx->exec.vs_metrics.crypto_calls += calls;
+    if (ctx->exec.tg_metrics.tg_id) {
+        ctx->exec.tg_metrics.crypto_calls += calls;
+    }
+}
+
+void acvp_metrics_vs_begin(ACVP_CTX *ctx) {
+    memzero_s(&ctx->exec.vs_metrics, sizeof(ACVP_METRICS));
+    memzero_s(&ctx->exec.tg_metrics, sizeof(ACVP_METRICS));
+}
+
+void acvp_metrics_vs_end(ACVP_CTX *ctx) {
+    acvp_mem_metrics(ctx, &ctx->exec.vs_metrics);
+    acvp_mem_vs_done(ctx, &ctx->exec.vs_metrics);
+    if (!ctx->metrics_cb) {
+        return;
+    }
+    acvp_metrics_tg_end(ctx);
+    ctx->exec.vs_metrics.vs_id = ctx->exec.vs_id;
+    (ctx->metrics_cb)(&ctx->exec.vs_metrics, ctx->metrics_arg);
+}
+
+/*
+ * Called by the KAT handlers as they start on each test group. The group
+ * before it, if any, is finished: it is written to the checkpoint journal,
+ * moved to disk when over the memory budget, and reported first.
+ */
+void acvp_metrics_tg_begin(ACVP_CTX *ctx, int tg_id) {
+    acvp_journal_tg_done(ctx);
+    acvp_spill_tg_done(ctx);
+    acvp_om_flush(ctx);
+    acvp_span_tg_begin(ctx, tg_id);
+    ctx->exec.tg_id = tg_id;
+    if (ctx->event_cb) {
+        acvp_event_tg_end(ctx);
+        ctx->exec.event_tg_id = tg_id;
+        ctx->exec.event_tg_start = acvp_metrics_now();
+    }
+    if (!ctx->metrics_cb) {
+        return;
+    }
+    acvp_metrics_tg_end(ctx);
+    ctx->exec.tg_metrics.vs_id = ctx->exec.vs_id;
+    ctx->exec.tg_metrics.tg_id = tg_id;
+    ctx->exec.tg_start = acvp_metrics_now();
+}
+
+/*
+ * Reports the current test group. Whatever of its time was not spent in the
+ * crypto module is put down to building the output.
+ */
+void acvp_metrics_tg_end(ACVP_CTX *ctx) {
+    ACVP_METRICS *tg = &ctx->exec.tg_metrics;
+    unsigned long long int total = 0;
+
+    if (!ctx->metrics_cb || !tg->tg_id) {
+        return;
+    }
+    total = acvp_metrics_now() - ctx->exec.tg_start;
+    tg->ns[ACVP_METRICS_OUTPUT] = total > tg->ns[ACVP_METRICS_CRYPTO] ? total - tg->ns[ACVP_METRICS_CRYPTO] : 0;
+    acvp_mem_metrics(ctx, tg);
+    (ctx->metrics_cb)(tg, ctx->metrics_arg);
+    memzero_s(tg, sizeof(ACVP_METRICS));
+}
+
+/*
+ * Hands an event to the event callback, see acvp_set_event_cb(). The vsId
+ * of the vector set in progress and the time are filled in.
+ */
+void acvp_event_emit(ACVP_CTX *ctx, ACVP_EVENT *event) {
+    if (!ctx->event_cb) {
+        return;
+    }
+    if (event->type != ACVP_EVENT_RETRY_WAIT && event->type != ACVP_EVENT_TRANSFER) {
+        event->vs_id = ctx->exec.vs_id;
+        event->tg_done = ctx->exec.tg_done;
+        event->tg_cnt = ctx->exec.tg_cnt;
+    }
+    event->time_ns = acvp_metrics_now();
+    (ctx->event_cb)(event, ctx->event_arg);
+}
+
+/*
+ * Called as the vector set is handed to its KAT handler, with the number of
+ * test groups it is to run.
+ */
+void acvp_event_vs_begin(ACVP_CTX *ctx, int tg_cnt) {
+    ACVP_EVENT event;
+
+    ctx->exec.tg_cnt = tg_cnt;
+    ctx->exec.tg_done = 0;
+    ctx->exec.event_tg_id = 0;
+    memzero_s(&event, sizeof(ACVP_EVENT));
+    event.type = ACVP_EVENT_VS_START;
+    acvp_event_emit(ctx, &event);
+    ctx->exec.vs_start = event.time_ns;
+}
+
+/*
+ * Called once the vector set is submitted or written to file, or has
+ * failed. Nothing is reported for a vector set that never got to its KAT
+ * handler.
+ */
+void acvp_event_vs_end(ACVP_CTX *ctx, ACVP_RESULT rv) {
+    ACVP_EVENT event;
+
+    if (!ctx->event_cb || !ctx->exec.vs_start) {
+        return;
+    }
+    memzero_s(&event, sizeof(ACVP_EVENT));
+    event.type = ACVP_EVENT_VS_DONE;
+    event.result = rv;
+    event.elapsed_ns = acvp_metrics_now() - ctx->exec.vs_start;
+    ctx->exec.vs_start = 0;
+    acvp_event_emit(ctx, &event);
+}
+
+/*
+ * Reports the test group in progress, if any, as done
+ */
+void acvp_event_tg_end(ACVP_CTX *ctx) {
+    ACVP_EVENT event;
+
+    if (!ctx->event_cb || !ctx->exec.event_tg_id) {
+        return;
+    }
+    ctx->exec.tg_done++;
+    memzero_s(&event, sizeof(ACVP_EVENT));
+    event.type = ACVP_EVENT_TG_DONE;
+    event.tg_id = ctx->exec.event_tg_id;
+    event.elapsed_ns = acvp_metrics_now() - ctx->exec.event_tg_start;
+    ctx->exec.event_tg_id = 0;
+    acvp_event_emit(ctx, &event);
+}
+
+/*
+ * Calls into the crypto module for a test case, timing the call when there
+ * is a metrics callback, an exporter or latency to keep.
+ */
+int acvp_crypto_call(ACVP_CTX *ctx, int (*handler)(ACVP_TEST_CASE *test_case), ACVP_TEST_CASE *tc) {
+    unsigned long long int start = 0;
+    int rc = 0;
+
+    if (!ACVP_CRYPTO_TIMED(ctx)) {
+        return handler(tc);
+    }
+    start = acvp_metrics_now();
+    rc = handler(tc);
+    acvp_metrics_crypto(ctx, start, 1, tc);
+    return rc;
+}
+
+/*
+ * Sets up the control of a long running test case just before it is handed
+ * to the crypto module. Returns the control for the test case to point at,
+ * or NULL when there is neither a deadline nor a progress callback, so that
+ * the crypto module has nothing to check. The clock starts when the crypto
+ * module first reports progress, so that test cases queued up to be run in
+ * parallel are not charged for the time they wait.
+ */
+ACVP_TC_CONTROL *acvp_tc_control_begin(ACVP_CTX *ctx, ACVP_TC_CONTROL *control, ACVP_CIPHER cipher,
+                                       int tg_id, int tc_id) {
+    if (!ctx->tc_deadline && !ctx->tc_progress_cb) {
+        return NULL;
+    }
+
+    memzero_s(control, sizeof(ACVP_TC_CONTROL));
+    control->ctx = ctx;
+    control->progress.cipher = cipher;
+    control->progress.vs_id = ctx->exec.vs_id;
+    control->progress.tg_id = tg_id;
+    control->progress.tc_id = tc_id;
+    return control;
+}
+
+int acvp_tc_progress(ACVP_TC_CONTROL *control) {
+    ACVP_CTX *ctx = NULL;
+    unsigned long long int now = 0;
+
+    if (!control) {
+        return 0;
+    }
+    if (control->cancelled) {
+        return 1;
+    }
+
+    ctx = control->ctx;
+    now = acvp_metrics_now();
+    if (!control->progress.calls) {
+        control->start = now;
+        if (ctx->tc_deadline) {
+            control->deadline = now + (unsigned long long int)ctx->tc_deadline * 1000000000ULL;
+        }
+    }
+    control->progress.calls++;
+    control->progress.elapsed_ms = (now - control->start) / 1000000ULL;
+    if (control->deadline && now > control->deadline) {
+        ACVP_LOG_ERR("Test case %d of test group %d (vsId %d) passed its deadline of %d seconds, giving up on it",
+                     control->progress.tc_id, control->progress.tg_id, control->progress.vs_id,
+                     ctx->tc_deadline);
+        control->cancelled = 1;
+    } else if (ctx->tc_progress_cb && (ctx->tc_progress_cb)(&control->progress, ctx->tc_progress_arg)) {
+        ACVP_LOG_ERR("Test case %d of test group %d (vsId %d) cancelled after %llu ms",
+                     control->progress.tc_id, control->progress.tg_id, control->progress.vs_id,
+                     control->progress.elapsed_ms);
+        control->cancelled = 1;
+    }
+    return control->cancelled;
+}
+
+/*
+ * Numbers the keys of a test group so the crypto module can tell when a
+ * test case uses the same key as an earlier one: test cases whose part_cnt
+ * key strings all match (the key, the three TDES keys, ...) get the same
+ * number, counting from 1. Every test case of the group gives the same
+ * number of parts. Returns 0 when a part is missing, or when the key can
+ * not be remembered, in which case it shares nothing.
+ */
+unsigned int acvp_tg_key_id_parts(ACVP_TG_KEYS *keys, const char **parts, int part_cnt, int max_len) {
+    const char **tmp = NULL;
+    unsigned int i, size = 0;
+    int k = 0, diff = 1;
+
+    if (!keys || !parts || part_cnt < 1 || (keys->count && part_cnt != keys->part_cnt)) {
+        return 0;
+    }
+    for (k = 0; k < part_cnt; k++) {
+        if (!parts[k]) {
+            return 0;
+        }
+    }
+
+    for (i = 0; i < keys->count; i++) {
+        for (k = 0; k < part_cnt; k++) {
+            strcmp_s(keys->parts[i * part_cnt + k], max_len, parts[k], &diff);
+            if (diff) {
+                break;
+            }
+        }
+        if (k == part_cnt) {
+            return i + 1;
+        }
+    }
+
+    if (keys->count == keys->size) {
+        size = keys->size ? keys->size * 2 : 8;
+        tmp = realloc(keys->parts, (size_t)size * part_cnt * sizeof(char *));
+        if (!tmp) {
+            return 0;
+        }
+        keys->parts = tmp;
+        keys->size = size;
+    }
+    for (k = 0; k < part_cnt; k++) {
+        keys->parts[keys->count * part_cnt + k] = parts[k];
+    }
+    keys->part_cnt = part_cnt;
+    return ++keys->count;
+}
+
+/*
+ * The IUT keys of KAS-IFC and KTS-IFC, told apart by their modulus n and
+ * private part (d, or dmp1 for CRT keys). 0 when there is no IUT key.
+ */
+unsigned int acvp_tg_key_id(ACVP_TG_KEYS *keys, const char *n, const char *priv, int max_len) {
+    const char *parts[2];
+
+    parts[0] = n;
+    parts[1] = priv;
+    return acvp_tg_key_id_parts(keys, parts, 2, max_len);
+}
+
+void acvp_tg_keys_clear(ACVP_TG_KEYS *keys) {
+    if (!keys) {
+        return;
+    }
+    if (keys->parts) free(keys->parts);
+    memzero_s(keys, sizeof(ACVP_TG_KEYS));
+}
+
+static int acvp_base64url_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-' || c == '+') return 62;
+    if (c == '_' || c == '/') return 63;
+    return -1;
+}
+
+/*
+ * Returns when the JWT expires, going by the "exp" claim of its payload, or
+ * 0 if that can not be told. The signature is not checked; the expiry is
+ * only used to get a new token from the server before this one runs out.
+ * A token that by our clock is already within twice ACVP_JWT_REFRESH_MARGIN
+ * of expiring also gives 0, so clock skew or short lived tokens can not
+ * make every request log in again first.
+ */
+time_t acvp_jwt_expiry(const char *jwt) {
+    const char *payload = NULL, *end = NULL;
+    char *json = NULL;
+    JSON_Value *val = NULL;
+    unsigned int bits = 0;
+    size_t len = 0, i = 0, out = 0;
+    int nbits = 0, v = 0;
+    double exp = 0;
+
+    if (!jwt) {
+        return 0;
+    }
+    payload = strchr(jwt, '.');
+    if (!payload) {
+        return 0;
+    }
+    payload++;
+    end = strchr(payload, '.');
+    if (!end) {
+        return 0;
+    }
+    len = (size_t)(end - payload);
+
+    json = calloc(len * 3 / 4 + 1, sizeof(char));
+    if (!json) {
+        return 0;
+    }
+    for (i = 0; i < len && payload[i] != '='; i++) {
+        v = acvp_base64url_value(payload[i]);
+        if (v < 0) {
+            free(json);
+            return 0;
+        }
+        bits = (bits << 6) | (unsigned int)v;
+        nbits += 6;
+        if (nbits >= 8) {
+            nbits -= 8;
+            json[out++] = (char)((bits >> nbits) & 0xff);
+        }
+    }
+
+    val = json_parse_string(json);
+    exp = json_object_get_number(json_value_get_object(val), "exp");
+    json_value_free(val);
+    free(json);
+    if (exp <= (double)(time(NULL) + 2 * ACVP_JWT_REFRESH_MARGIN)) {
+        return 0;
+    }
+    return (time_t)exp;
+}
+
+void acvp_sleep(int seconds) {
+#ifdef _WIN32
+    Sleep(seconds * 1000);
+#else
+    sleep(seconds);
+#endif
+}
+
+static void acvp_sleep_ms(unsigned int ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) && errno == EINTR) {}
+#endif
+}
+
+/*
+ * Waits seconds for the server, giving the time to the idle callback of
+ * ctx, see acvp_set_idle_cb(), for as long as it has work to do, and
+ * sleeping out the rest
+ */
+void acvp_idle(ACVP_CTX *ctx, int seconds) {
+    unsigned long long int now = 0, end = 0;
+    int more = 1;
+
+    if (seconds <= 0) {
+        return;
+    }
+    if (!ctx || !ctx->idle_cb) {
+        acvp_sleep(seconds);
+        return;
+    }
+
+    now = acvp_metrics_now();
+    end = now + (unsigned long long int)seconds * 1000000000ULL;
+    while (more && now < end) {
+        more = (ctx->idle_cb)((unsigned int)((end - now) / 1000000ULL), ctx->idle_arg);
+        now = acvp_metrics_now();
+    }
+    if (now < end) {
+        acvp_sleep_ms((unsigned int)((end - now) / 1000000ULL));
+    }
+}
+
+
+/*
+ * Minimal cross-platform threading primitives used when the library
+ * processes work concurrently. The thread body is wrapped so callers
+ * can use a single function signature on every platform.
+ */
+typedef struct acvp_thread_start_t {
+    void (*func)(void *arg);
+    void *arg;
+} ACVP_THREAD_START;
+
+#ifdef _WIN32
+static DWORD WINAPI acvp_thread_trampoline(LPVOID param) {
+#else
+static void *acvp_thread_trampoline(void *param) {
+#endif
+    ACVP_THREAD_START start = *(ACVP_THREAD_START *)param;
+
+    free(param);
+    start.func(start.arg);
+    return 0;
+}
+
+ACVP_RESULT acvp_thread_create(ACVP_THREAD *thread, void (*func)(void *arg), void *arg) {
+    ACVP_THREAD_START *start = NULL;
+
+    if (!thread || !func) {
+        return ACVP_INVALID_ARG;
+    }
+
+    start = calloc(1, sizeof(ACVP_THREAD_START));
+    if (!start) {
+        return ACVP_MALLOC_FAIL;
+    }
+    start->func = func;
+    start->arg = arg;
+
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, acvp_thread_trampoline, start, 0, NULL);
+    if (*thread == NULL) {
+        free(start);
+        return ACVP_INTERNAL_ERR;
+    }
+#else
+    if (pthread_create(thread, NULL, acvp_thread_trampoline, start)) {
+        free(start);
+        return ACVP_INTERNAL_ERR;
+    }
+#endif
+    return ACVP_SUCCESS;
+}
+
+void acvp_thread_join(ACVP_THREAD thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+void acvp_mutex_init(ACVP_MUTEX *mutex) {
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+void acvp_mutex_lock(ACVP_MUTEX *mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+void acvp_mutex_unlock(ACVP_MUTEX *mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+void acvp_mutex_destroy(ACVP_MUTEX *mutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+void acvp_cond_init(ACVP_COND *cond) {
+#ifdef _WIN32
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif
+}
+
+/*
+ * Waits for cond to be signalled; mutex must be held and is held again
+ * on return
+ */
+void acvp_cond_wait(ACVP_COND *cond, ACVP_MUTEX *mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif
+}
+
+void acvp_cond_broadcast(ACVP_COND *cond) {
+#ifdef _WIN32
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+void acvp_cond_destroy(ACVP_COND *cond) {
+#ifdef _WIN32
+    (void)cond; /* Windows condition variables need no cleanup */
+#else
+    pthread_cond_destroy(cond);
+#endif
+}
+
+#ifdef _WIN32
+static BOOL CALLBACK acvp_once_trampoline(PINIT_ONCE once, PVOID param, PVOID *unused) {
+    ((void (*)(void))param)();
+    return TRUE;
+}
+#endif
+
+/*
+ * Runs func exactly once per once object, no matter how many threads get here
+ */
+void acvp_once(ACVP_ONCE *once, void (*func)(void)) {
+#ifdef _WIN32
+    InitOnceExecuteOnce(once, acvp_once_trampoline, (PVOID)func, NULL);
+#else
+    pthread_once(once, func);
+#endif
+}
+
+#ifdef _WIN32
+#ifdef _WIN64
+#define ACVP_ATOMIC_ADD(p, n) ((size_t)InterlockedExchangeAdd64((volatile LONG64 *)(p), (LONG64)(n)) + (n))
+#define ACVP_ATOMIC_CAS(p, old, new) \
+    (InterlockedCompareExchange64((volatile LONG64 *)(p), (LONG64)(new), (LONG64)(old)) == (LONG64)(old))
+#else
+#define ACVP_ATOMIC_ADD(p, n) ((size_t)InterlockedExchangeAdd((volatile LONG *)(p), (LONG)(n)) + (n))
+#define ACVP_ATOMIC_CAS(p, old, new) \
+    (InterlockedCompareExchange((volatile LONG *)(p), (LONG)(new), (LONG)(old)) == (LONG)(old))
+#endif
+#else
+#define ACVP_ATOMIC_ADD(p, n) __atomic_add_fetch((p), (n), __ATOMIC_RELAXED)
+#define ACVP_ATOMIC_CAS(p, old, new) \
+    __atomic_compare_exchange_n((p), &(old), (new), 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
 #endif
+
+/*
+ * The memory counters of the context the calling thread is processing a
+ * vector set for, see acvp_mem_enter(). JSON values made on the heap are
+ * charged to them.
+ */
+static ACVP_THREAD_LOCAL ACVP_MEM_ACCT *mem_acct = NULL;
+
+static void acvp_mem_raise(volatile size_t *peak, size_t now) {
+    size_t seen = *peak;
+
+    while (now > seen && !ACVP_ATOMIC_CAS(peak, seen, now)) {
+        seen = *peak;
+    }
+}
+
+/*
+ * Counts bytes allocated against acct and the session it belongs to. The
+ * counters are shared between threads, so they are updated atomically.
+ */
+void acvp_mem_charge(ACVP_MEM_ACCT *acct, size_t bytes) {
+    size_t now = 0;
+
+    for (; acct; acct = acct->parent) {
+        now = ACVP_ATOMIC_ADD(&acct->current, bytes);
+        acvp_mem_raise(&acct->peak, now);
+        acvp_mem_raise(&acct->vs_peak, now);
+    }
+}
+
+void acvp_mem_credit(ACVP_MEM_ACCT *acct, size_t bytes) {
+    for (; acct; acct = acct->parent) {
+        ACVP_ATOMIC_ADD(&acct->current, (size_t)0 - bytes);
+    }
+}
+
+/*
+ * Gives ctx its memory counters, and points its arenas at them. Those of an
+ * exec context are kept on the list of its session, since JSON values made
+ * by the exec context may be freed after it.
+ */
+void acvp_mem_init(ACVP_CTX *ctx) {
+    ACVP_CTX *session = ctx->session;
+    ACVP_MEM_ACCT *acct = NULL;
+
+    acct = calloc(1, sizeof(ACVP_MEM_ACCT));
+    if (!acct) {
+        return;
+    }
+    if (session) {
+        acct->parent = session->exec.mem;
+        acvp_mutex_lock(&session->session_lock);
+        acct->next = session->mem_accts;
+        session->mem_accts = acct;
+        acvp_mutex_unlock(&session->session_lock);
+    } else {
+        ctx->cap_pool.acct = acct;
+    }
+    ctx->exec.mem = acct;
+    ctx->exec.tc_arena.acct = acct;
+    ctx->exec.json_arena.acct = acct;
+}
+
+/*
+ * Frees the memory counters of a session along with those of its exec
+ * contexts, once nothing allocated against them is left.
+ */
+void acvp_mem_free(ACVP_CTX *ctx) {
+    ACVP_MEM_ACCT *acct = NULL, *next_acct = NULL;
+    ACVP_MEM_VS *vs = NULL, *next_vs = NULL;
+
+    if (mem_acct && mem_acct == ctx->exec.mem) {
+        mem_acct = NULL;
+    }
+    for (acct = ctx->mem_accts; acct; acct = next_acct) {
+        next_acct = acct->next;
+        free(acct);
+    }
+    for (vs = ctx->mem_vs; vs; vs = next_vs) {
+        next_vs = vs->next;
+        free(vs);
+    }
+    if (ctx->exec.mem) free(ctx->exec.mem);
+    ctx->mem_accts = NULL;
+    ctx->mem_vs = NULL;
+    ctx->exec.mem = NULL;
+}
+
+/*
+ * Has the JSON values the calling thread makes on the heap charged to ctx
+ * while it processes a vector set, and starts the peak of the vector set
+ * over. Returns the counters to go back to with acvp_mem_leave().
+ */
+ACVP_MEM_ACCT *acvp_mem_enter(ACVP_CTX *ctx) {
+    ACVP_MEM_ACCT *prev = mem_acct;
+
+    mem_acct = ctx->exec.mem;
+    if (mem_acct) {
+        mem_acct->vs_peak = mem_acct->current;
+    }
+    return prev;
+}
+
+void acvp_mem_leave(ACVP_MEM_ACCT *prev) {
+    mem_acct = prev;
+}
+
+/*
+ * Fills in the memory figures of metrics as of now. Responses posted by a
+ * sender keep the peak the worker that computed them saw.
+ */
+void acvp_mem_metrics(ACVP_CTX *ctx, ACVP_METRICS *metrics) {
+    ACVP_MEM_ACCT *acct = ctx->exec.mem;
+
+    if (!acct) {
+        return;
+    }
+    metrics->mem_current = acct->current;
+    if (acct->vs_peak > metrics->mem_peak) {
+        metrics->mem_peak = acct->vs_peak;
+    }
+}
+
+/*
+ * Keeps what the vector set of ctx used, for acvp_get_memory_usage()
+ */
+void acvp_mem_vs_done(ACVP_CTX *ctx, const ACVP_METRICS *metrics) {
+    ACVP_CTX *session = ctx->session ? ctx->session : ctx;
+    ACVP_MEM_VS *vs = NULL;
+
+    if (!ctx->exec.vs_id) {
+        return;
+    }
+    acvp_mutex_lock(&session->session_lock);
+    for (vs = session->mem_vs; vs && vs->vs_id != ctx->exec.vs_id; vs = vs->next);
+    if (!vs) {
+        vs = calloc(1, sizeof(ACVP_MEM_VS));
+        if (vs) {
+            vs->vs_id = ctx->exec.vs_id;
+            vs->next = session->mem_vs;
+            session->mem_vs = vs;
+        }
+    }
+    if (vs) {
+        vs->usage.current = metrics->mem_current;
+        vs->usage.peak = metrics->mem_peak;
+    }
+    acvp_mutex_unlock(&session->session_lock);
+}
+
+/* Chunk header rounded up so the data that follows it stays aligned */
+#define ACVP_ARENA_HDR ((sizeof(ACVP_ARENA_CHUNK) + ACVP_ARENA_ALIGN - 1) & ~((size_t)ACVP_ARENA_ALIGN - 1))
+
+/*
+ * Returns size zeroed bytes from the arena, aligned to ACVP_ARENA_ALIGN.
+ * Only the newest chunk is allocated from; when it is full a new chunk at
+ * least as large as everything used before the last reset is started.
+ */
+void *acvp_arena_calloc(ACVP_ARENA *arena, size_t size) {
+    ACVP_ARENA_CHUNK *chunk = NULL;
+    size_t chunk_size = 0;
+    void *ptr = NULL;
+
+    if (!arena || !size) {
+        return NULL;
+    }
+    size = (size + ACVP_ARENA_ALIGN - 1) & ~((size_t)ACVP_ARENA_ALIGN - 1);
+
+    chunk = arena->head;
+    if (!chunk || chunk->size - chunk->used < size) {
+        chunk_size = arena->hint > ACVP_ARENA_CHUNK_MIN ? arena->hint : ACVP_ARENA_CHUNK_MIN;
+        /* Grow geometrically so a large first use only takes a few chunks */
+        if (chunk && chunk_size < chunk->size * 2) {
+            chunk_size = chunk->size * 2;
+        }
+        if (chunk_size < size) {
+            chunk_size = size;
+        }
+        chunk = calloc(1, ACVP_ARENA_HDR + chunk_size);
+        if (!chunk) {
+            return NULL;
+        }
+        acvp_mem_charge(arena->acct, ACVP_ARENA_HDR + chunk_size);
+        chunk->size = chunk_size;
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    ptr = (unsigned char *)chunk + ACVP_ARENA_HDR + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+/*
+ * Gives back everything allocated from the arena. The memory is wiped since
+ * it may hold key material; if it took more than one chunk they are all
+ * released so the next allocation makes a single chunk big enough for all.
+ */
+void acvp_arena_reset(ACVP_ARENA *arena) {
+    ACVP_ARENA_CHUNK *chunk = NULL, *next = NULL;
+    size_t total = 0;
+
+    if (!arena || !arena->head) {
+        return;
+    }
+
+    for (chunk = arena->head; chunk; chunk = chunk->next) {
+        if (chunk->used) {
+            memzero_s((unsigned char *)chunk + ACVP_ARENA_HDR, chunk->used);
+        }
+        chunk->used = 0;
+        total += chunk->size;
+    }
+
+    if (arena->head->next) {
+        for (chunk = arena->head; chunk; chunk = next) {
+            next = chunk->next;
+            acvp_mem_credit(arena->acct, ACVP_ARENA_HDR + chunk->size);
+            free(chunk);
+        }
+        arena->head = NULL;
+        arena->hint = total;
+    }
+}
+
+void acvp_arena_free(ACVP_ARENA *arena) {
+    ACVP_ARENA_CHUNK *chunk = NULL, *next = NULL;
+
+    if (!arena) {
+        return;
+    }
+
+    acvp_arena_reset(arena);
+    for (chunk = arena->head; chunk; chunk = next) {
+        next = chunk->next;
+        acvp_mem_credit(arena->acct, ACVP_ARENA_HDR + chunk->size);
+        free(chunk);
+    }
+    arena->head = NULL;
+    arena->hint = 0;
+}
+
+/*
+ * Allocates size bytes for sb, releasing what it held before. Only the first
+ * byte is cleared; acvp_sbuf_bin_to_hexstr() terminates what it writes.
+ */
+ACVP_RESULT acvp_sbuf_init(ACVP_SBUF *sb, size_t size) {
+    if (!sb || !size) {
+        return ACVP_INVALID_ARG;
+    }
+    acvp_sbuf_release(sb);
+    sb->buf = malloc(size);
+    if (!sb->buf) {
+        memzero_s(sb, sizeof(ACVP_SBUF));
+        return ACVP_MALLOC_FAIL;
+    }
+    sb->buf[0] = '\0';
+    sb->size = size;
+    sb->used = 1;
+    sb->owned = 1;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * acvp_sbuf_init() with buf taken from the test case arena of ctx, so the
+ * output of a test case costs no allocation once the arena has grown to
+ * fit. It is given back with the buffers of the test case, by
+ * acvp_arena_reset().
+ */
+ACVP_RESULT acvp_sbuf_init_tc(ACVP_CTX *ctx, ACVP_SBUF *sb, size_t size) {
+    if (!ctx || !sb || !size) {
+        return ACVP_INVALID_ARG;
+    }
+    acvp_sbuf_release(sb);
+    sb->buf = acvp_arena_calloc(&ctx->exec.tc_arena, size);
+    if (!sb->buf) {
+        memzero_s(sb, sizeof(ACVP_SBUF));
+        return ACVP_MALLOC_FAIL;
+    }
+    sb->size = size;
+    sb->used = 1;
+    sb->owned = 0;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * acvp_bin_to_hexstr() into sb, with dest_max capped to what sb holds. The
+ * rest of a longer value written before is wiped.
+ */
+ACVP_RESULT acvp_sbuf_bin_to_hexstr(ACVP_SBUF *sb, const unsigned char *src, int src_len, int dest_max) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    size_t len = 0;
+
+    if (!sb || !sb->buf || src_len < 0) {
+        return ACVP_CONVERT_DATA_ERR;
+    }
+    if (dest_max < 0 || (size_t)dest_max >= sb->size) {
+        dest_max = (int)(sb->size - 1);
+    }
+    rv = acvp_bin_to_hexstr(src, src_len, sb->buf, dest_max);
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+    len = 2 * (size_t)src_len + 1;
+    if (len < sb->used) {
+        memzero_s(sb->buf + len, sb->used - len);
+    }
+    sb->used = len;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Sets name in obj to src, src_len bytes, as a hex string that parson encodes
+ * only as the response is serialized, straight into its output. Fails as
+ * acvp_bin_to_hexstr() would for more than dest_max hex characters.
+ */
+ACVP_RESULT acvp_json_set_hex(JSON_Object *obj, const char *name, const unsigned char *src, int src_len, int dest_max) {
+    if (!obj || !name || !src || src_len < 0) {
+        return ACVP_CONVERT_DATA_ERR;
+    }
+    if ((src_len * 2) > dest_max) {
+        return ACVP_CONVERT_DATA_ERR;
+    }
+    if (json_object_set_hex(obj, name, src, (size_t)src_len) != JSONSuccess) {
+        return ACVP_JSON_ERR;
+    }
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Wipes the used part of sb and frees it if acvp_sbuf_init() allocated it.
+ * Safe to call more than once.
+ */
+void acvp_sbuf_release(ACVP_SBUF *sb) {
+    if (!sb || !sb->buf) {
+        return;
+    }
+    if (sb->used) {
+        memzero_s(sb->buf, sb->used);
+    }
+    sb->used = 0;
+    if (sb->owned) {
+        free(sb->buf);
+        memzero_s(sb, sizeof(ACVP_SBUF));
+    }
+}
+
+/*
+ * Whether the test cases of cap get an output sink. Those carried to
+ * another process or a remote device have their output copied back into a
+ * buffer, so they keep it.
+ */
+int acvp_output_sink_enabled(ACVP_CAPS_LIST *cap) {
+    return cap && cap->output_sink && !cap->ring && !cap->dut;
+}
+
+/*
+ * A sink for max bytes of output. The string is sized to exactly what the
+ * test case outputs, rather than to the largest output it could have.
+ */
+ACVP_OUTPUT_SINK *acvp_output_sink_new(unsigned int max) {
+    ACVP_OUTPUT_SINK *sink = NULL;
+
+    sink = calloc(1, sizeof(ACVP_OUTPUT_SINK));
+    if (!sink) {
+        return NULL;
+    }
+    sink->hex = acvp_json_malloc(2 * (size_t)max + 1);
+    if (!sink->hex) {
+        free(sink);
+        return NULL;
+    }
+    sink->hex[0] = '\0';
+    sink->max = max;
+    return sink;
+}
+
+ACVP_RESULT acvp_output_write(ACVP_OUTPUT_SINK *sink, const unsigned char *data, unsigned int len) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!sink || !sink->hex || (!data && len)) {
+        return ACVP_INVALID_ARG;
+    }
+    if (len > sink->max - sink->len) {
+        return ACVP_DATA_TOO_LARGE;
+    }
+    if (!len) {
+        return ACVP_SUCCESS;
+    }
+    rv = acvp_bin_to_hexstr(data, (int)len, sink->hex + 2 * (size_t)sink->len,
+                            (int)(2 * (sink->max - sink->len)));
+    if (rv != ACVP_SUCCESS) {
+        return rv;
+    }
+    sink->len += len;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Moves the output written to sink into obj as name, without copying it.
+ * Fails with ACVP_CRYPTO_MODULE_FAIL if the crypto module wrote less than
+ * the test case outputs.
+ */
+ACVP_RESULT acvp_output_sink_set(ACVP_OUTPUT_SINK *sink, JSON_Object *obj, const char *name) {
+    JSON_Value *val = NULL;
+
+    if (!sink || !sink->hex || !obj || !name) {
+        return ACVP_INVALID_ARG;
+    }
+    if (sink->len != sink->max) {
+        return ACVP_CRYPTO_MODULE_FAIL;
+    }
+    val = json_value_init_string_take(sink->hex, 2 * (size_t)sink->len);
+    if (!val) {
+        return ACVP_JSON_ERR;
+    }
+    /* The value owns the string now, whether or not it makes it into obj */
+    sink->hex = NULL;
+    if (json_object_set_value(obj, name, val) != JSONSuccess) {
+        json_value_free(val);
+        return ACVP_JSON_ERR;
+    }
+    return ACVP_SUCCESS;
+}
+
+/* Safe to call with NULL, or after the output has gone into the response */
+void acvp_output_sink_free(ACVP_OUTPUT_SINK *sink) {
+    if (!sink) {
+        return;
+    }
+    if (sink->hex) {
+        acvp_json_free(sink->hex);
+    }
+    free(sink);
+}
+
+/*
+ * Whether ptr was handed out by the arena since its last reset
+ */
+static int acvp_arena_owns(const ACVP_ARENA *arena, const void *ptr) {
+    const ACVP_ARENA_CHUNK *chunk = NULL;
+    const unsigned char *p = ptr;
+
+    for (chunk = arena->head; chunk; chunk = chunk->next) {
+        if (p >= (const unsigned char *)chunk + ACVP_ARENA_HDR &&
+                p < (const unsigned char *)chunk + ACVP_ARENA_HDR + chunk->used) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * The JSON arena of the calling thread, if it is processing a vector set.
+ * While json_arena_paused is set new values come from the heap again, for
+ * those that have to outlive the vector set.
+ */
+static ACVP_THREAD_LOCAL ACVP_ARENA *json_arena = NULL;
+static ACVP_THREAD_LOCAL int json_arena_paused = 0;
+
+/*
+ * Heap values are preceded by their size and the counters they were charged
+ * to, so they can be credited whichever thread frees them. These are the
+ * default allocation functions of parson, see parson.c, so every value
+ * carries the header; serialized strings are allocated with malloc().
+ */
+typedef struct acvp_json_hdr_t {
+    ACVP_MEM_ACCT *acct;
+    size_t size;
+} ACVP_JSON_HDR;
+
+#define ACVP_JSON_HDR_SIZE ((sizeof(ACVP_JSON_HDR) + ACVP_ARENA_ALIGN - 1) & ~((size_t)ACVP_ARENA_ALIGN - 1))
+
+void *acvp_json_malloc(size_t size) {
+    ACVP_JSON_HDR *hdr = NULL;
+
+    if (json_arena && !json_arena_paused) {
+        return acvp_arena_calloc(json_arena, size ? size : 1);
+    }
+    if (size > (size_t)-1 - ACVP_JSON_HDR_SIZE) {
+        return NULL;
+    }
+    hdr = malloc(ACVP_JSON_HDR_SIZE + size);
+    if (!hdr) {
+        return NULL;
+    }
+    hdr->acct = mem_acct;
+    hdr->size = ACVP_JSON_HDR_SIZE + size;
+    acvp_mem_charge(hdr->acct, hdr->size);
+    return (unsigned char *)hdr + ACVP_JSON_HDR_SIZE;
+}
+
+void acvp_json_free(void *ptr) {
+    ACVP_JSON_HDR *hdr = NULL;
+
+    if (!ptr) {
+        return;
+    }
+    if (json_arena && acvp_arena_owns(json_arena, ptr)) {
+        /* Given back all at once by acvp_json_arena_end() */
+        return;
+    }
+    hdr = (ACVP_JSON_HDR *)((unsigned char *)ptr - ACVP_JSON_HDR_SIZE);
+    acvp_mem_credit(hdr->acct, hdr->size);
+    free(hdr);
+}
+
+/*
+ * Has every JSON value the calling thread creates come from arena until
+ * acvp_json_arena_end(), so a vector set DOM and the responses built for it
+ * cost a few chunk allocations rather than one per value, and are torn down
+ * by a single reset instead of a walk over every value. Nothing allocated in
+ * between may be kept past acvp_json_arena_end(), other than what is made
+ * while paused by acvp_json_arena_pause().
+ */
+void acvp_json_arena_begin(ACVP_ARENA *arena) {
+    json_arena = arena;
+    json_arena_paused = 0;
+}
+
+void acvp_json_arena_pause(int pause) {
+    json_arena_paused = pause;
 }
 
+void acvp_json_arena_end(void) {
+    ACVP_ARENA *arena = json_arena;
+
+    json_arena = NULL;
+    json_arena_paused = 0;
+    acvp_arena_reset(arena);
+}
+
+/*
+ * json_value_free() for values that may be in the JSON arena: those are left
+ * for the arena reset rather than walked value by value.
+ */
+void acvp_json_value_free(JSON_Value *val) {
+    if (!val || (json_arena && acvp_arena_owns(json_arena, val))) {
+        return;
+    }
+    json_value_free(val);
+}
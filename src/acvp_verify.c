@@ -0,0 +1,346 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Checks a response file written by acvp_run_vectors_from_file() against the
+ * expected results of a sample session, as saved by
+ * acvp_get_expected_results(), without going to the server. See
+ * acvp_verify_vectors_from_file().
+ *
+ * Every value of a test case response is compared with the expected value of
+ * the same name, if the expected results have one; hex strings are compared
+ * without regard to case. The test groups are compared by
+ * acvp_set_max_parallel_vector_sets() threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+/*
+ * A test group to compare, the expected one and ours. rsp is NULL when the
+ * response file is missing the group.
+ */
+typedef struct acvp_verify_tg_t {
+    int vs_id;
+    int tg_id;
+    JSON_Object *expected;
+    JSON_Object *rsp;
+    int mismatches;
+} ACVP_VERIFY_TG;
+
+typedef struct acvp_verify_t {
+    ACVP_CTX *ctx;
+    ACVP_VERIFY_TG *tgs;
+    int count;
+    int next;
+    ACVP_MUTEX lock;
+} ACVP_VERIFY;
+
+/*
+ * The vector set of an entry of the expected results file. The server sends
+ * each one with the protocol version in front, which the file keeps.
+ */
+static JSON_Object *acvp_verify_vs_obj(JSON_Value *val) {
+    JSON_Array *arr = json_value_get_array(val);
+
+    if (arr) {
+        return json_array_get_object(arr, json_array_get_count(arr) - 1);
+    }
+    return json_value_get_object(val);
+}
+
+static JSON_Object *acvp_verify_find(JSON_Array *arr, const char *name, int id) {
+    JSON_Object *obj = NULL;
+    int i = 0, count = json_array_get_count(arr);
+
+    for (i = 0; i < count; i++) {
+        obj = json_array_get_object(arr, i);
+        if ((int)json_object_get_uint(obj, name) == id) {
+            return obj;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Whether a response value is the one expected. Objects only need to agree
+ * on the names the response has, as with test cases.
+ */
+static int acvp_verify_value(JSON_Value *expected, JSON_Value *rsp) {
+    JSON_Object *e_obj = NULL, *r_obj = NULL;
+    JSON_Array *e_arr = NULL, *r_arr = NULL;
+    const char *e_str = NULL, *r_str = NULL, *name = NULL;
+    size_t len = 0;
+    int i = 0, count = 0, diff = 0;
+
+    if (json_value_get_type(expected) != json_value_get_type(rsp)) {
+        return 0;
+    }
+    switch (json_value_get_type(rsp)) {
+    case JSONString:
+        e_str = json_value_get_string(expected);
+        r_str = json_value_get_string(rsp);
+        len = strnlen_s(r_str, RSIZE_MAX_STR);
+        if (strnlen_s(e_str, RSIZE_MAX_STR) != len) {
+            return 0;
+        }
+        if (!len) {
+            return 1;
+        }
+        strcasecmp_s(e_str, len, r_str, &diff);
+        return !diff;
+    case JSONObject:
+        e_obj = json_value_get_object(expected);
+        r_obj = json_value_get_object(rsp);
+        count = json_object_get_count(r_obj);
+        for (i = 0; i < count; i++) {
+            name = json_object_get_name(r_obj, i);
+            if (json_object_has_value(e_obj, name) &&
+                    !acvp_verify_value(json_object_get_value(e_obj, name), json_object_get_value_at(r_obj, i))) {
+                return 0;
+            }
+        }
+        return 1;
+    case JSONArray:
+        e_arr = json_value_get_array(expected);
+        r_arr = json_value_get_array(rsp);
+        count = json_array_get_count(r_arr);
+        if ((int)json_array_get_count(e_arr) != count) {
+            return 0;
+        }
+        for (i = 0; i < count; i++) {
+            if (!acvp_verify_value(json_array_get_value(e_arr, i), json_array_get_value(r_arr, i))) {
+                return 0;
+            }
+        }
+        return 1;
+    default:
+        return json_value_equals(expected, rsp);
+    }
+}
+
+static void acvp_verify_log_value(ACVP_CTX *ctx, const char *what, JSON_Value *val) {
+    char *str = NULL;
+
+    if (ctx->log_lvl < ACVP_LOG_LVL_INFO) {
+        return;
+    }
+    str = json_serialize_to_string(val, NULL);
+    ACVP_LOG_INFO("    %s: %s", what, str ? str : "(unavailable)");
+    if (str) json_free_serialized_string(str);
+}
+
+/*
+ * Compares the test cases of one group, logging each one that does not
+ * match by tcId.
+ */
+static void acvp_verify_tg(ACVP_CTX *ctx, ACVP_VERIFY_TG *tg) {
+    JSON_Array *e_tests = NULL, *r_tests = NULL;
+    JSON_Object *e_tc = NULL, *r_tc = NULL;
+    JSON_Value *e_val = NULL;
+    const char *name = NULL;
+    int i = 0, j = 0, count = 0, tc_id = 0;
+
+    e_tests = json_object_get_array(tg->expected, "tests");
+    count = json_array_get_count(e_tests);
+    if (!tg->rsp) {
+        ACVP_LOG_WARN("vsId %d tgId %d: test group is missing from the responses", tg->vs_id, tg->tg_id);
+        tg->mismatches = count ? count : 1;
+        return;
+    }
+    r_tests = json_object_get_array(tg->rsp, "tests");
+
+    for (i = 0; i < count; i++) {
+        e_tc = json_array_get_object(e_tests, i);
+        tc_id = (int)json_object_get_uint(e_tc, "tcId");
+        r_tc = acvp_verify_find(r_tests, "tcId", tc_id);
+        if (!r_tc) {
+            ACVP_LOG_WARN("vsId %d tgId %d tcId %d: test case is missing from the responses",
+                          tg->vs_id, tg->tg_id, tc_id);
+            tg->mismatches++;
+            continue;
+        }
+        for (j = 0; j < (int)json_object_get_count(r_tc); j++) {
+            name = json_object_get_name(r_tc, j);
+            e_val = json_object_get_value(e_tc, name);
+            if (!e_val || acvp_verify_value(e_val, json_object_get_value_at(r_tc, j))) {
+                continue;
+            }
+            ACVP_LOG_WARN("vsId %d tgId %d tcId %d: '%s' does not match the expected results",
+                          tg->vs_id, tg->tg_id, tc_id, name);
+            acvp_verify_log_value(ctx, "expected", e_val);
+            acvp_verify_log_value(ctx, "     got", json_object_get_value_at(r_tc, j));
+            tg->mismatches++;
+            break;
+        }
+    }
+}
+
+static void acvp_verify_worker(void *arg) {
+    ACVP_VERIFY *verify = arg;
+    int i = 0;
+
+    for (;;) {
+        acvp_mutex_lock(&verify->lock);
+        i = verify->next++;
+        acvp_mutex_unlock(&verify->lock);
+        if (i >= verify->count) {
+            return;
+        }
+        acvp_verify_tg(verify->ctx, &verify->tgs[i]);
+    }
+}
+
+/*
+ * Lists the test groups of the expected results, paired with the response
+ * groups, for the vector sets that are in the response file.
+ */
+static ACVP_RESULT acvp_verify_collect(ACVP_CTX *ctx, JSON_Array *expected, JSON_Array *rsp,
+                                       ACVP_VERIFY *verify) {
+    JSON_Object *e_vs = NULL, *r_vs = NULL, *e_tg = NULL;
+    JSON_Array *e_tgs = NULL, *r_tgs = NULL;
+    int i = 0, j = 0, vs_id = 0, total = 0, vs_cnt = 0;
+
+    for (i = 1; i < (int)json_array_get_count(expected); i++) {
+        total += json_array_get_count(json_object_get_array(
+                     acvp_verify_vs_obj(json_array_get_value(expected, i)), "testGroups"));
+    }
+    verify->tgs = calloc(total ? total : 1, sizeof(ACVP_VERIFY_TG));
+    if (!verify->tgs) {
+        return ACVP_MALLOC_FAIL;
+    }
+
+    for (i = 1; i < (int)json_array_get_count(rsp); i++) {
+        r_vs = json_array_get_object(rsp, i);
+        vs_id = (int)json_object_get_uint(r_vs, "vsId");
+        e_vs = NULL;
+        for (j = 1; j < (int)json_array_get_count(expected) && !e_vs; j++) {
+            e_vs = acvp_verify_vs_obj(json_array_get_value(expected, j));
+            if ((int)json_object_get_uint(e_vs, "vsId") != vs_id) {
+                e_vs = NULL;
+            }
+        }
+        if (!e_vs) {
+            ACVP_LOG_WARN("vsId %d: no expected results for the vector set, not checked", vs_id);
+            continue;
+        }
+        vs_cnt++;
+
+        e_tgs = json_object_get_array(e_vs, "testGroups");
+        r_tgs = json_object_get_array(r_vs, "testGroups");
+        for (j = 0; j < (int)json_array_get_count(e_tgs); j++) {
+            e_tg = json_array_get_object(e_tgs, j);
+            verify->tgs[verify->count].vs_id = vs_id;
+            verify->tgs[verify->count].tg_id = (int)json_object_get_uint(e_tg, "tgId");
+            verify->tgs[verify->count].expected = e_tg;
+            verify->tgs[verify->count].rsp = acvp_verify_find(r_tgs, "tgId", verify->tgs[verify->count].tg_id);
+            verify->count++;
+        }
+    }
+    ACVP_LOG_STATUS("Checking %d test groups of %d vector sets against the expected results...",
+                    verify->count, vs_cnt);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Compares the responses of rsp_filename with the expected results in
+ * expected_filename, see acvp_verify_vectors_from_file() in acvp.h.
+ */
+ACVP_RESULT acvp_verify_vectors_from_file(ACVP_CTX *ctx, const char *rsp_filename,
+                                          const char *expected_filename, int *mismatches) {
+    JSON_Value *e_val = NULL, *r_val = NULL;
+    JSON_Array *e_arr = NULL, *r_arr = NULL;
+    ACVP_THREAD *threads = NULL;
+    ACVP_VERIFY verify;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int i = 0, worker_cnt = 0, started = 0, total = 0;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (mismatches) {
+        *mismatches = 0;
+    }
+    if (!rsp_filename || !expected_filename) {
+        ACVP_LOG_ERR("Must provide the response file and the expected results file");
+        return ACVP_MISSING_ARG;
+    }
+    if (strnlen_s(rsp_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX ||
+            strnlen_s(expected_filename, ACVP_JSON_FILENAME_MAX + 1) > ACVP_JSON_FILENAME_MAX) {
+        ACVP_LOG_ERR("Provided filename length > max(%d)", ACVP_JSON_FILENAME_MAX);
+        return ACVP_INVALID_ARG;
+    }
+
+    memzero_s(&verify, sizeof(ACVP_VERIFY));
+    verify.ctx = ctx;
+    acvp_mutex_init(&verify.lock);
+
+    r_val = acvp_json_parse_file(rsp_filename);
+    r_arr = json_value_get_array(r_val);
+    if (!r_arr) {
+        ACVP_LOG_ERR("Unable to parse response file %s", rsp_filename);
+        rv = ACVP_MALFORMED_JSON;
+        goto end;
+    }
+    e_val = acvp_json_parse_file(expected_filename);
+    e_arr = json_value_get_array(e_val);
+    if (!e_arr) {
+        ACVP_LOG_ERR("Unable to parse expected results file %s", expected_filename);
+        rv = ACVP_MALFORMED_JSON;
+        goto end;
+    }
+
+    rv = acvp_verify_collect(ctx, e_arr, r_arr, &verify);
+    if (rv != ACVP_SUCCESS) {
+        goto end;
+    }
+
+    worker_cnt = ctx->max_parallel_vs < verify.count ? ctx->max_parallel_vs : verify.count;
+    if (worker_cnt > 1) {
+        threads = calloc(worker_cnt, sizeof(ACVP_THREAD));
+    }
+    for (i = 0; threads && i < worker_cnt; i++) {
+        if (acvp_thread_create(&threads[i], acvp_verify_worker, &verify) != ACVP_SUCCESS) {
+            break;
+        }
+        started++;
+    }
+    /* Whatever the threads did not get to */
+    acvp_verify_worker(&verify);
+    for (i = 0; i < started; i++) {
+        acvp_thread_join(threads[i]);
+    }
+
+    for (i = 0; i < verify.count; i++) {
+        total += verify.tgs[i].mismatches;
+    }
+    if (total) {
+        ACVP_LOG_STATUS("%d test cases do not match the expected results", total);
+    } else {
+        ACVP_LOG_STATUS("All responses match the expected results");
+    }
+    if (mismatches) {
+        *mismatches = total;
+    }
+
+end:
+    if (threads) free(threads);
+    if (verify.tgs) free(verify.tgs);
+    acvp_mutex_destroy(&verify.lock);
+    if (e_val) json_value_free(e_val);
+    if (r_val) json_value_free(r_val);
+    return rv;
+}
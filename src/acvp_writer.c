@@ -0,0 +1,362 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Output files written by a thread of their own, so the threads processing
+ * vector sets do not wait on the file system, which can be slow when it is
+ * a network one. The JSON is serialized by the caller, in memory, and
+ * queued; small pieces, such as the separators between vector sets, are
+ * gathered into one buffer. The writer thread takes everything queued at
+ * once and writes it through a large stdio buffer, so the file sees few
+ * large writes. The file is synced once, when it is closed.
+ *
+ * The caller waits only when more than ACVP_WRITER_QUEUE_MAX bytes are
+ * queued. A write error is kept, and returned by every later call and by
+ * acvp_writer_close().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define ACVP_WRITER_BUF_SIZE (1024 * 1024)        /* stdio buffer of the file */
+#define ACVP_WRITER_GATHER_SIZE (1024 * 64)       /* small writes are gathered in buffers this big */
+#define ACVP_WRITER_QUEUE_MAX (1024 * 1024 * 64)  /* bytes queued before callers wait */
+
+/* Something queued, either bytes or the rest of a file to be copied */
+typedef struct acvp_writer_buf_t {
+    struct acvp_writer_buf_t *next;
+    char *data;
+    size_t len;
+    size_t size;
+    FILE *src;                  /* Copied from its start and closed, when set */
+} ACVP_WRITER_BUF;
+
+struct acvp_writer_t {
+    FILE *fp;
+    char *fp_buf;               /* stdio buffer of fp, NULL for stdout */
+    ACVP_THREAD thread;
+    ACVP_MUTEX lock;
+    ACVP_COND cond;             /* Signalled as bufs are queued and written */
+    ACVP_WRITER_BUF *head;      /* Oldest first */
+    ACVP_WRITER_BUF *tail;
+    size_t queued;              /* Bytes queued and not yet written */
+    int closing;
+    int failed;
+};
+
+static int acvp_writer_copy(FILE *from, FILE *to) {
+    char buf[4096];
+    size_t n = 0;
+
+    if (fflush(from) || fseek(from, 0, SEEK_SET)) {
+        return 1;
+    }
+    while ((n = fread(buf, 1, sizeof(buf), from)) > 0) {
+        if (fwrite(buf, 1, n, to) != n) {
+            return 1;
+        }
+    }
+    return ferror(from);
+}
+
+static void acvp_writer_run(void *arg) {
+    ACVP_WRITER *writer = arg;
+    ACVP_WRITER_BUF *list = NULL, *next = NULL;
+    size_t done = 0;
+    int failed = 0;
+
+    acvp_mutex_lock(&writer->lock);
+    for (;;) {
+        while (!writer->head && !writer->closing) {
+            acvp_cond_wait(&writer->cond, &writer->lock);
+        }
+        if (!writer->head) {
+            break;
+        }
+        list = writer->head;
+        writer->head = writer->tail = NULL;
+        acvp_mutex_unlock(&writer->lock);
+
+        done = 0;
+        for (; list; list = next) {
+            next = list->next;
+            if (!failed) {
+                if (list->src) {
+                    failed = acvp_writer_copy(list->src, writer->fp);
+                } else if (list->len) {
+                    failed = fwrite(list->data, 1, list->len, writer->fp) != list->len;
+                }
+            }
+            done += list->len;
+            if (list->src) fclose(list->src);
+            if (list->data) free(list->data);
+            free(list);
+        }
+        if (!failed && writer->fp == stdout) {
+            /* Down the pipe as each piece is done */
+            failed = fflush(writer->fp) == EOF;
+        }
+
+        acvp_mutex_lock(&writer->lock);
+        writer->queued -= done;
+        if (failed) {
+            writer->failed = 1;
+        }
+        acvp_cond_broadcast(&writer->cond);
+    }
+    acvp_mutex_unlock(&writer->lock);
+}
+
+/*
+ * Appends buf to the queue, waiting for room first. Takes buf over, and
+ * frees it on failure. Called with the lock held.
+ */
+static ACVP_RESULT acvp_writer_queue(ACVP_WRITER *writer, ACVP_WRITER_BUF *buf) {
+    while (writer->queued > ACVP_WRITER_QUEUE_MAX && !writer->failed) {
+        acvp_cond_wait(&writer->cond, &writer->lock);
+    }
+    if (writer->failed) {
+        if (buf->src) fclose(buf->src);
+        if (buf->data) free(buf->data);
+        free(buf);
+        return ACVP_JSON_ERR;
+    }
+    if (writer->tail) {
+        writer->tail->next = buf;
+    } else {
+        writer->head = buf;
+    }
+    writer->tail = buf;
+    writer->queued += buf->len;
+    acvp_cond_broadcast(&writer->cond);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Opens filename with mode, "w" or "a", for writing by a thread of its own.
+ * A filename of "-" is stdout, which acvp_writer_close() flushes rather
+ * than closes.
+ */
+ACVP_RESULT acvp_writer_open(ACVP_WRITER **writer, const char *filename, const char *mode) {
+    ACVP_WRITER *w = NULL;
+
+    if (!writer || !filename || !mode) {
+        return ACVP_INVALID_ARG;
+    }
+    *writer = NULL;
+
+    w = calloc(1, sizeof(ACVP_WRITER));
+    if (!w) {
+        return ACVP_MALLOC_FAIL;
+    }
+    w->fp = acvp_json_out_open(filename, mode);
+    if (!w->fp) {
+        free(w);
+        return ACVP_JSON_ERR;
+    }
+    if (w->fp != stdout) {
+        w->fp_buf = malloc(ACVP_WRITER_BUF_SIZE);
+        if (w->fp_buf) {
+            setvbuf(w->fp, w->fp_buf, _IOFBF, ACVP_WRITER_BUF_SIZE);
+        }
+    }
+    acvp_mutex_init(&w->lock);
+    acvp_cond_init(&w->cond);
+    if (acvp_thread_create(&w->thread, acvp_writer_run, w) != ACVP_SUCCESS) {
+        acvp_json_out_close(w->fp);
+        acvp_cond_destroy(&w->cond);
+        acvp_mutex_destroy(&w->lock);
+        if (w->fp_buf) free(w->fp_buf);
+        free(w);
+        return ACVP_INTERNAL_ERR;
+    }
+    *writer = w;
+    return ACVP_SUCCESS;
+}
+
+/*
+ * Queues a copy of the len bytes at data, gathered with the small writes
+ * before it while the writer thread has not taken them yet.
+ */
+ACVP_RESULT acvp_writer_write(ACVP_WRITER *writer, const char *data, size_t len) {
+    ACVP_WRITER_BUF *buf = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!writer || (!data && len)) {
+        return ACVP_INVALID_ARG;
+    }
+    if (!len) {
+        return ACVP_SUCCESS;
+    }
+
+    acvp_mutex_lock(&writer->lock);
+    if (writer->failed) {
+        acvp_mutex_unlock(&writer->lock);
+        return ACVP_JSON_ERR;
+    }
+    buf = writer->tail;
+    if (buf && !buf->src && buf->size - buf->len >= len) {
+        memcpy_s(buf->data + buf->len, buf->size - buf->len, data, len);
+        buf->len += len;
+        writer->queued += len;
+        acvp_mutex_unlock(&writer->lock);
+        return ACVP_SUCCESS;
+    }
+    acvp_mutex_unlock(&writer->lock);
+
+    buf = calloc(1, sizeof(ACVP_WRITER_BUF));
+    if (!buf) {
+        return ACVP_MALLOC_FAIL;
+    }
+    buf->size = len > ACVP_WRITER_GATHER_SIZE ? len : ACVP_WRITER_GATHER_SIZE;
+    buf->data = malloc(buf->size);
+    if (!buf->data) {
+        free(buf);
+        return ACVP_MALLOC_FAIL;
+    }
+    memcpy_s(buf->data, buf->size, data, len);
+    buf->len = len;
+
+    acvp_mutex_lock(&writer->lock);
+    rv = acvp_writer_queue(writer, buf);
+    acvp_mutex_unlock(&writer->lock);
+    return rv;
+}
+
+ACVP_RESULT acvp_writer_puts(ACVP_WRITER *writer, const char *str) {
+    if (!str) {
+        return ACVP_INVALID_ARG;
+    }
+    return acvp_writer_write(writer, str, strnlen_s(str, ACVP_WRITER_GATHER_SIZE));
+}
+
+/*
+ * Queues sep and then value, pretty printed unless compact is set. The
+ * value is serialized here, and the string queued as it is.
+ */
+ACVP_RESULT acvp_writer_json(ACVP_WRITER *writer, const char *sep, const JSON_Value *value, int compact) {
+    ACVP_WRITER_BUF *buf = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    int len = 0;
+
+    if (!writer || !value) {
+        return ACVP_INVALID_ARG;
+    }
+    if (sep) {
+        rv = acvp_writer_puts(writer, sep);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+    }
+
+    buf = calloc(1, sizeof(ACVP_WRITER_BUF));
+    if (!buf) {
+        return ACVP_MALLOC_FAIL;
+    }
+    if (compact) {
+        buf->data = json_serialize_to_string(value, &len);
+    } else {
+        buf->data = json_serialize_to_string_pretty(value, &len);
+    }
+    if (!buf->data) {
+        free(buf);
+        return ACVP_JSON_ERR;
+    }
+    buf->len = buf->size = (size_t)len;
+
+    acvp_mutex_lock(&writer->lock);
+    rv = acvp_writer_queue(writer, buf);
+    acvp_mutex_unlock(&writer->lock);
+    return rv;
+}
+
+/*
+ * Queues the contents of fp, from its start. The writer thread closes fp
+ * once they are written, or when this fails.
+ */
+ACVP_RESULT acvp_writer_file(ACVP_WRITER *writer, FILE *fp) {
+    ACVP_WRITER_BUF *buf = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!writer || !fp) {
+        if (fp) fclose(fp);
+        return ACVP_INVALID_ARG;
+    }
+    buf = calloc(1, sizeof(ACVP_WRITER_BUF));
+    if (!buf) {
+        fclose(fp);
+        return ACVP_MALLOC_FAIL;
+    }
+    buf->src = fp;
+
+    acvp_mutex_lock(&writer->lock);
+    rv = acvp_writer_queue(writer, buf);
+    acvp_mutex_unlock(&writer->lock);
+    return rv;
+}
+
+/*
+ * Flushes the file to its storage; pipes and character devices that
+ * cannot be synced are let be.
+ */
+static int acvp_writer_sync(FILE *fp) {
+#ifdef _WIN32
+    return _commit(_fileno(fp)) && errno != EBADF && errno != EINVAL;
+#else
+    return fsync(fileno(fp)) && errno != EINVAL && errno != EROFS;
+#endif
+}
+
+/*
+ * Waits for everything queued to be written, then syncs and closes the
+ * file and frees the writer. Returns the first error there was.
+ */
+ACVP_RESULT acvp_writer_close(ACVP_WRITER *writer) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!writer) {
+        return ACVP_SUCCESS;
+    }
+    acvp_mutex_lock(&writer->lock);
+    writer->closing = 1;
+    acvp_cond_broadcast(&writer->cond);
+    acvp_mutex_unlock(&writer->lock);
+    acvp_thread_join(writer->thread);
+
+    if (writer->failed || fflush(writer->fp) == EOF) {
+        rv = ACVP_JSON_ERR;
+    }
+    if (writer->fp != stdout) {
+        if (rv == ACVP_SUCCESS && acvp_writer_sync(writer->fp)) {
+            rv = ACVP_JSON_ERR;
+        }
+        if (fclose(writer->fp) == EOF) {
+            rv = ACVP_JSON_ERR;
+        }
+    }
+    acvp_cond_destroy(&writer->cond);
+    acvp_mutex_destroy(&writer->lock);
+    if (writer->fp_buf) free(writer->fp_buf);
+    free(writer);
+    return rv;
+}
@@ -0,0 +1,343 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Adaptive transfer concurrency, see acvp_set_adaptive_transfers(). The
+ * exec contexts of a session take a slot before each request to the server
+ * and give it back after, and the number of slots is tuned the way TCP
+ * tunes its window (AIMD):
+ *
+ *  - A 429 or 5xx response halves it, at most once per round trip, as that
+ *    is the server saying it has more than it can take.
+ *  - Otherwise, once as many requests as there are slots are done (a
+ *    window), one slot is added if the window used all of them, unless the
+ *    slot added last time did not bring at least ACVP_XFER_GAIN_PCT more
+ *    throughput, or the latency of the window is over twice the best seen,
+ *    in which case one slot is taken away again: a link that is already
+ *    full only gets slower with more requests on it.
+ *
+ * Logins are never held back: a refresh of the JWT is made while holding
+ * the session_lock, which a request holding a slot may be waiting on.
+ *
+ * Hedged GETs, see acvp_set_hedged_requests(). GETs are idempotent, so one
+ * that has had no answer from the server within the 95th percentile of the
+ * time recent GETs took to their first byte is sent again on a second
+ * connection, and whichever answers first is taken. The time to the first
+ * byte is what a stalled connection or a slow path through a proxy shows
+ * up in; the size of the body does not, so a large vector set that is
+ * coming in at its own pace is not fetched twice.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acvp.h"
+#include "acvp_lcl.h"
+#include "safe_lib.h"
+
+#define ACVP_XFER_LIMIT_START 2
+#define ACVP_XFER_GAIN_PCT 5
+#define ACVP_XFER_HOLD_WINDOWS 4     /* Windows to wait before trying a slot again that did not pay */
+
+ACVP_RESULT acvp_set_adaptive_transfers(ACVP_CTX *ctx, int enable) {
+    ACVP_XFER_CTL *xfer = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session || ctx->pool) {
+        ACVP_LOG_ERR("Adaptive transfers can only be set on the context of the session");
+        return ACVP_INVALID_ARG;
+    }
+    if (!enable) {
+        acvp_xfer_free(ctx);
+        return ACVP_SUCCESS;
+    }
+    if (ctx->xfer) {
+        return ACVP_SUCCESS;
+    }
+    xfer = calloc(1, sizeof(ACVP_XFER_CTL));
+    if (!xfer) {
+        return ACVP_MALLOC_FAIL;
+    }
+    acvp_mutex_init(&xfer->lock);
+    acvp_cond_init(&xfer->cond);
+    xfer->limit = ACVP_XFER_LIMIT_START;
+    xfer->max = ACVP_MAX_PARALLEL_VS + 1;
+    ctx->xfer = xfer;
+    return ACVP_SUCCESS;
+}
+
+int acvp_get_transfer_limit(ACVP_CTX *ctx) {
+    ACVP_XFER_CTL *xfer = NULL;
+    int limit = 0;
+
+    if (!ctx || !ctx->xfer) {
+        return 0;
+    }
+    xfer = ctx->xfer;
+    acvp_mutex_lock(&xfer->lock);
+    limit = xfer->limit;
+    acvp_mutex_unlock(&xfer->lock);
+    return limit;
+}
+
+void acvp_xfer_free(ACVP_CTX *ctx) {
+    if (!ctx->xfer) {
+        return;
+    }
+    acvp_cond_destroy(&ctx->xfer->cond);
+    acvp_mutex_destroy(&ctx->xfer->lock);
+    free(ctx->xfer);
+    ctx->xfer = NULL;
+}
+
+static void acvp_xfer_window_reset(ACVP_XFER_CTL *xfer, unsigned long long int now) {
+    xfer->win_done = 0;
+    xfer->win_bytes = 0;
+    xfer->win_ns = 0;
+    xfer->win_full = xfer->in_flight >= xfer->limit;
+    xfer->win_start = now;
+}
+
+/*
+ * Waits for a slot to make a request to the server in
+ */
+void acvp_xfer_acquire(ACVP_CTX *ctx) {
+    ACVP_XFER_CTL *xfer = ctx->xfer;
+
+    if (!xfer) {
+        return;
+    }
+    acvp_mutex_lock(&xfer->lock);
+    while (xfer->in_flight >= xfer->limit) {
+        xfer->win_full = 1;
+        acvp_cond_wait(&xfer->cond, &xfer->lock);
+    }
+    xfer->in_flight++;
+    if (xfer->in_flight >= xfer->limit) {
+        xfer->win_full = 1;
+    }
+    if (!xfer->win_start) {
+        xfer->win_start = acvp_metrics_now();
+    }
+    acvp_mutex_unlock(&xfer->lock);
+}
+
+/*
+ * Ends the window when as many requests as there are slots are done
+ */
+static void acvp_xfer_window_done(ACVP_XFER_CTL *xfer, unsigned long long int now) {
+    unsigned long long int elapsed = now - xfer->win_start;
+    unsigned long long int rate = 0, lat = 0;
+
+    if (!elapsed) {
+        elapsed = 1;
+    }
+    /* Bytes per millisecond, which is plenty fine for comparing windows */
+    rate = (unsigned long long int)xfer->win_bytes * 1000000ULL / elapsed;
+    lat = xfer->win_ns / xfer->win_done;
+    if (!xfer->best_lat || lat < xfer->best_lat) {
+        xfer->best_lat = lat;
+    }
+
+    if (xfer->grew && rate * 100 < xfer->prev_rate * (100 + ACVP_XFER_GAIN_PCT)) {
+        /* The slot added last did not pay for itself */
+        if (xfer->limit > 1) xfer->limit--;
+        xfer->hold = ACVP_XFER_HOLD_WINDOWS;
+        xfer->grew = 0;
+    } else if (lat > 2 * xfer->best_lat && xfer->limit > 1) {
+        xfer->limit--;
+        xfer->grew = 0;
+    } else if (xfer->hold) {
+        xfer->hold--;
+        xfer->grew = 0;
+    } else if (xfer->win_full && xfer->limit < xfer->max) {
+        xfer->limit++;
+        xfer->grew = 1;
+    } else {
+        xfer->grew = 0;
+    }
+    xfer->prev_rate = rate;
+    acvp_xfer_window_reset(xfer, now);
+}
+
+/*
+ * Gives back the slot of a request, with the HTTP status it got, the bytes
+ * it moved and the time it took
+ */
+void acvp_xfer_release(ACVP_CTX *ctx, int http_status, size_t bytes, unsigned long long int ns) {
+    ACVP_XFER_CTL *xfer = ctx->xfer;
+    unsigned long long int now = 0;
+
+    if (!xfer) {
+        return;
+    }
+    now = acvp_metrics_now();
+    acvp_mutex_lock(&xfer->lock);
+    if (xfer->in_flight > 0) {
+        xfer->in_flight--;
+    }
+    if (http_status == 429 || http_status >= 500) {
+        if (now >= xfer->backoff_until) {
+            xfer->limit = xfer->limit > 1 ? xfer->limit / 2 : 1;
+            /* The requests already out went before the server could hear of this */
+            xfer->backoff_until = now + (ns > xfer->best_lat ? ns : xfer->best_lat);
+            xfer->grew = 0;
+            xfer->hold = ACVP_XFER_HOLD_WINDOWS;
+            acvp_xfer_window_reset(xfer, now);
+        }
+    } else {
+        xfer->win_done++;
+        xfer->win_bytes += bytes;
+        xfer->win_ns += ns;
+        if (xfer->win_done >= xfer->limit) {
+            acvp_xfer_window_done(xfer, now);
+        }
+    }
+    acvp_cond_broadcast(&xfer->cond);
+    acvp_mutex_unlock(&xfer->lock);
+}
+
+ACVP_RESULT acvp_set_request_timeout(ACVP_CTX *ctx, int timeout_ms) {
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session || ctx->pool) {
+        ACVP_LOG_ERR("The request timeout can only be set on the context of the session");
+        return ACVP_INVALID_ARG;
+    }
+    if (timeout_ms < 0) {
+        return ACVP_INVALID_ARG;
+    }
+#ifdef USE_MURL
+    if (timeout_ms) {
+        ACVP_LOG_ERR("Request timeouts need libcurl");
+        return ACVP_UNSUPPORTED_OP;
+    }
+#endif
+    ctx->request_timeout = timeout_ms;
+    return ACVP_SUCCESS;
+}
+
+ACVP_RESULT acvp_set_hedged_requests(ACVP_CTX *ctx, int enable) {
+    ACVP_HEDGE_CTL *hedge = NULL;
+
+    if (!ctx) {
+        return ACVP_NO_CTX;
+    }
+    if (ctx->session || ctx->pool) {
+        ACVP_LOG_ERR("Hedged requests can only be set on the context of the session");
+        return ACVP_INVALID_ARG;
+    }
+    if (!enable) {
+        acvp_hedge_free(ctx);
+        return ACVP_SUCCESS;
+    }
+#ifdef USE_MURL
+    (void)hedge;
+    ACVP_LOG_ERR("Hedged requests need libcurl");
+    return ACVP_UNSUPPORTED_OP;
+#else
+    if (ctx->hedge) {
+        return ACVP_SUCCESS;
+    }
+    hedge = calloc(1, sizeof(ACVP_HEDGE_CTL));
+    if (!hedge) {
+        return ACVP_MALLOC_FAIL;
+    }
+    acvp_mutex_init(&hedge->lock);
+    ctx->hedge = hedge;
+    return ACVP_SUCCESS;
+#endif
+}
+
+int acvp_get_hedge_delay(ACVP_CTX *ctx) {
+    if (!ctx) {
+        return 0;
+    }
+    return (int)(acvp_hedge_delay(ctx) / 1000000ULL);
+}
+
+void acvp_hedge_free(ACVP_CTX *ctx) {
+    if (!ctx->hedge) {
+        return;
+    }
+    if (ctx->hedge->hedged) {
+        ACVP_LOG_STATUS("%llu GETs were sent again, %llu of them answered first the second time",
+                        ctx->hedge->hedged, ctx->hedge->won);
+    }
+    acvp_mutex_destroy(&ctx->hedge->lock);
+    free(ctx->hedge);
+    ctx->hedge = NULL;
+}
+
+/*
+ * Nanoseconds a GET may go unanswered before it is sent again; 0 while
+ * too few GETs have been seen to tell, or when hedging is not enabled.
+ */
+unsigned long long int acvp_hedge_delay(ACVP_CTX *ctx) {
+    ACVP_HEDGE_CTL *hedge = ctx->hedge;
+    unsigned long long int ttfb[ACVP_HEDGE_SAMPLES];
+    unsigned long long int v = 0, delay = 0;
+    int cnt = 0, i = 0, j = 0;
+
+    if (!hedge) {
+        return 0;
+    }
+    acvp_mutex_lock(&hedge->lock);
+    cnt = hedge->cnt;
+    if (cnt >= ACVP_HEDGE_SAMPLES_MIN) {
+        memcpy_s(ttfb, sizeof(ttfb), hedge->ttfb, cnt * sizeof(ttfb[0]));
+    }
+    acvp_mutex_unlock(&hedge->lock);
+    if (cnt < ACVP_HEDGE_SAMPLES_MIN) {
+        return 0;
+    }
+
+    for (i = 1; i < cnt; i++) {
+        v = ttfb[i];
+        for (j = i; j > 0 && ttfb[j - 1] > v; j--) {
+            ttfb[j] = ttfb[j - 1];
+        }
+        ttfb[j] = v;
+    }
+    delay = ttfb[(cnt * 95 + 99) / 100 - 1];
+    if (delay < ACVP_HEDGE_DELAY_MIN_MS * 1000000ULL) {
+        delay = ACVP_HEDGE_DELAY_MIN_MS * 1000000ULL;
+    }
+    return delay;
+}
+
+/*
+ * Adds the time a GET took to its first byte, and whether it was hedged
+ * and the second one won
+ */
+void acvp_hedge_record(ACVP_CTX *ctx, unsigned long long int ttfb_ns, int hedged, int won) {
+    ACVP_HEDGE_CTL *hedge = ctx->hedge;
+
+    if (!hedge) {
+        return;
+    }
+    acvp_mutex_lock(&hedge->lock);
+    hedge->ttfb[hedge->next] = ttfb_ns;
+    hedge->next = (hedge->next + 1) % ACVP_HEDGE_SAMPLES;
+    if (hedge->cnt < ACVP_HEDGE_SAMPLES) {
+        hedge->cnt++;
+    }
+    if (hedged) {
+        hedge->hedged++;
+        if (won) {
+            hedge->won++;
+        }
+    }
+    acvp_mutex_unlock(&hedge->lock);
+}
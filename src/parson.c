@@ -36,21 +36,40 @@
 #include <ctype.h>
 #include <math.h>
 #include <errno.h>
+#include <limits.h>
 #include "safe_lib.h"    /* needs to be after errno.h */
 
+/* ACVP: strings and whitespace are scanned 16 bytes at a time, see skip_plain() */
+#include "acvp_sse2.h"
+#ifdef ACVP_SSE2
+#define PARSON_SCAN_SSE2
+#elif defined __ARM_NEON || defined _M_ARM64
+#include <arm_neon.h>
+#define PARSON_SCAN_NEON
+#endif
+#if (defined PARSON_SCAN_SSE2 || defined PARSON_SCAN_NEON) && defined _MSC_VER
+#include <intrin.h>
+#endif
+
 /* Apparently sscanf is not implemented in some "standard" libraries, so don't use it, if you
  * don't have to. */
 #define sscanf THINK_TWICE_ABOUT_USING_SSCANF
 
 #define STARTING_CAPACITY 16
+#define OBJECT_INDEX_MIN  16 /* ACVP: objects with this many names get a hash index */
+#define OBJECT_NOT_FOUND  ((size_t)-1)
 #define MAX_NESTING       2048
+#define LAZY_ARRAY_NAME   "testGroups"
+#define INTERNED_NAME_SIZE 33 /* ACVP: longest interned name plus its terminator */
 
 #define FLOAT_FORMAT "%1.17g" /* do not increase precision without incresing NUM_BUF_SIZE */
 #define NUM_BUF_SIZE 64 /* double printed with "%1.17g" shouldn't be longer than 25 bytes so let's be paranoid and use 64 */
+#define FAST_INT_DIGITS 15 /* ACVP: integers this long are exact as doubles, and parsed without strtod() */
+#define FAST_INT_MAX 1e15  /* ACVP: whole numbers below this are serialized without sprintf() */
 
 #define SIZEOF_TOKEN(a)       (sizeof(a) - 1)
 #define SKIP_CHAR(str)        ((*str)++)
-#define SKIP_WHITESPACES(str) while (isspace((unsigned char)(**str))) { SKIP_CHAR(str); }
+#define SKIP_WHITESPACES(str) (*(str) = skip_whitespaces(*(str)))
 #define MAX(a, b)             ((a) > (b) ? (a) : (b))
 
 #define STRING_VALUE_MAX 8000000 /* SAFEC arbitrarily set max string value to 8 MB */
@@ -65,8 +84,11 @@
 #define IS_NUMBER_INVALID(x) (((x) * 0.0) != 0.0)
 #endif
 
-static JSON_Malloc_Function parson_malloc = malloc;
-static JSON_Free_Function parson_free = free;
+/* ACVP: values are allocated by libacvp, which keeps count of them, see acvp_util.c */
+void *acvp_json_malloc(size_t size);
+void acvp_json_free(void *ptr);
+static JSON_Malloc_Function parson_malloc = acvp_json_malloc;
+static JSON_Free_Function parson_free = acvp_json_free;
 
 static int parson_escape_slashes = 1;
 
@@ -90,22 +112,42 @@ typedef union json_value_value {
 struct json_value_t {
     JSON_Value      *parent;
     JSON_Value_Type  type;
+    int              borrowed; /* ACVP: string chars point into an in situ parsed buffer */
+    int              hex;      /* ACVP: string chars are followed by length / 2 bytes, hex encoded when serialized or read */
     JSON_Value_Value value;
 };
 
 struct json_object_t {
-    JSON_Value  *wrapping_value;
-    char       **names;
-    JSON_Value **values;
-    size_t       count;
-    size_t       capacity;
+    JSON_Value     *wrapping_value;
+    char          **names;
+    JSON_Value    **values;
+    unsigned long  *hashes;         /* ACVP: hash of each name, checked before comparing */
+    size_t         *cells;          /* ACVP: open addressing index, item index + 1, 0 if empty */
+    size_t          cell_capacity;  /* ACVP: power of two, 0 while there is no index */
+    size_t          count;
+    size_t          capacity;
 };
 
+/* ACVP: the text of an item of a lazy array */
+typedef struct json_span_t {
+    const char *text;
+    size_t      len;
+} JSON_Span;
+
+/* ACVP: the writable text a string is parsed in place from */
+typedef struct json_situ_t {
+    char *text;
+    int   lazy; /* leave LAZY_ARRAY_NAME arrays unparsed */
+} JSON_Situ;
+
 struct json_array_t {
     JSON_Value  *wrapping_value;
     JSON_Value **items;
     size_t       count;
     size_t       capacity;
+    JSON_Span   *spans;       /* ACVP: set for a lazy array, items are NULL until asked for */
+    size_t       loaded;      /* ACVP: index of the one item of a lazy array that is parsed */
+    char        *loaded_text; /* ACVP: copy of its text, the item was parsed in situ from */
 };
 
 /* Various */
@@ -123,6 +165,7 @@ static int    num_bytes_in_utf8_sequence(unsigned char c);
 static int    verify_utf8_sequence(const unsigned char *string, int *len);
 static int    is_valid_utf8(const char *string, size_t string_len);
 static int    is_decimal(const char *string, size_t length);
+static int    serialize_number(double num, char *buf);
 
 /* JSON Object */
 static JSON_Object * json_object_init(JSON_Value *wrapping_value);
@@ -130,6 +173,10 @@ static JSON_Status   json_object_add(JSON_Object *object, const char *name, JSON
 static JSON_Status   json_object_addn(JSON_Object *object, const char *name, size_t name_len, JSON_Value *value);
 static JSON_Status   json_object_resize(JSON_Object *object, size_t new_capacity);
 static JSON_Value  * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len);
+static unsigned long json_name_hash(const char *name, size_t name_len);
+static size_t        json_object_find(const JSON_Object *object, const char *name, size_t name_len, unsigned long hash);
+static void          json_object_index_insert(JSON_Object *object, size_t index);
+static void          json_object_index_rebuild(JSON_Object *object);
 static JSON_Status   json_object_remove_internal(JSON_Object *object, const char *name, int free_value);
 static JSON_Status   json_object_dotremove_internal(JSON_Object *object, const char *name, int free_value);
 static void          json_object_free(JSON_Object *object);
@@ -139,29 +186,48 @@ static JSON_Array * json_array_init(JSON_Value *wrapping_value);
 static JSON_Status  json_array_add(JSON_Array *array, JSON_Value *value);
 static JSON_Status  json_array_resize(JSON_Array *array, size_t new_capacity);
 static void         json_array_free(JSON_Array *array);
+static JSON_Value * json_array_load(JSON_Array *array, size_t index);
+static void         json_array_unload(JSON_Array *array);
 
 /* JSON Value */
 static JSON_Value * json_value_init_string_no_copy(char *string, size_t length);
 static const JSON_String * json_value_get_string_desc(const JSON_Value *value);
 
 /* Parser */
+static const char * skip_plain(const char *string);
+static const char * skip_whitespaces(const char *string);
 static JSON_Status  skip_quotes(const char **string);
+static JSON_Status  skip_value(const char **string);
 static int          parse_utf16(const char **unprocessed, char **processed);
-static char *       process_string(const char *input, size_t input_len, size_t *output_len);
-static char *       get_quoted_string(const char **string, size_t *output_string_len);
-static JSON_Value * parse_object_value(const char **string, size_t nesting);
-static JSON_Value * parse_array_value(const char **string, size_t nesting);
-static JSON_Value * parse_string_value(const char **string);
+static char *       process_string(const char *input, size_t input_len, size_t *output_len, const JSON_Situ *in_situ);
+static char *       get_quoted_string(const char **string, size_t *output_string_len, const JSON_Situ *in_situ);
+static JSON_Value * parse_object_value(const char **string, size_t nesting, const JSON_Situ *in_situ);
+static JSON_Value * parse_array_value(const char **string, size_t nesting, const JSON_Situ *in_situ);
+static JSON_Value * parse_lazy_array_value(const char **string);
+static JSON_Value * parse_string_value(const char **string, const JSON_Situ *in_situ);
 static JSON_Value * parse_boolean_value(const char **string);
 static JSON_Value * parse_number_value(const char **string);
 static JSON_Value * parse_null_value(const char **string);
-static JSON_Value * parse_value(const char **string, size_t nesting);
+static JSON_Value * parse_value(const char **string, size_t nesting, const JSON_Situ *in_situ);
 
 /* Serialization */
+/* ACVP: where a streamed serialization goes, fp if set and buf otherwise */
+typedef struct json_sink_t {
+    FILE   *fp;
+    char   *buf;
+    size_t  len;
+    size_t  cap;
+} JSON_Sink;
+
 static int    json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int level, int is_pretty, char *num_buf);
 static int    json_serialize_string(const char *string, size_t len, char *buf);
+static int    json_serialize_hex(const unsigned char *bytes, size_t len, char *buf);
+static const unsigned char * json_value_hex_bytes(const JSON_Value *value);
 static int    append_indent(char *buf, int level);
 static int    append_string(char *buf, const char *string);
+static int    json_serialize_to_sink_r(const JSON_Value *value, JSON_Sink *sink, int level, int is_pretty, char *num_buf);
+static int    json_serialize_string_to_sink(const char *string, size_t len, JSON_Sink *sink);
+static char * json_serialize_to_string_r(const JSON_Value *value, int is_pretty, int *len);
 
 /* Various */
 static char * parson_strndup(const char *string, size_t n) {
@@ -175,6 +241,94 @@ static char * parson_strndup(const char *string, size_t n) {
     return output_string;
 }
 
+/* ACVP: names of the fields libacvp writes, in strcmp order. An object keeps a
+ * pointer into this table instead of a copy of such a name, so building a
+ * response does not allocate a name for every field of every test case. Not
+ * const, as the names of an object are char *, but nothing ever writes to it. */
+static char interned_names[][INTERNED_NAME_SIZE] = {
+    "KAS1", "KAS2", "Z", "aadLen", "accessToken", "acvVersion", "additionalInputLen",
+    "addressUrl", "aesKeyLength", "algorithm", "algorithms", "associatedDataPattern",
+    "authenticationMethod", "auxFunctionName", "auxFunctions", "auxSharedSecretLen", "bitlens",
+    "capabilities", "cipher", "clientApplicationTrafficSecret", "clientEarlyTrafficSecret",
+    "clientHandshakeTrafficSecret", "componentTest", "conformances", "contactUrls",
+    "contextLength", "counter", "ct", "curve", "d", "dataUnitLen", "dataUnitLenMatchesPayload",
+    "dependencies", "dependencyUrls", "derFuncEnabled", "derivedKey", "derivedKeyLength",
+    "derivedKeyingMaterial", "derivedKeyingMaterialChild", "derivedKeyingMaterialDh",
+    "derivedKeyingMaterialLength", "description", "dhEphem", "diffieHellmanSharedSecretLength",
+    "direction", "dkm", "domainParameterGenerationMethods", "domainSeed", "e",
+    "earlyExporterMasterSecret", "eb", "ec", "ed", "ee", "encoding", "encryptionKeyClient",
+    "encryptionKeyServer", "engineId", "entries", "entropyInputLen", "ephemeralPrivateIut",
+    "ephemeralPublicIut", "ephemeralPublicIutX", "ephemeralPublicIutY", "ephemeralUnified",
+    "exporterMasterSecret", "family", "fb", "fc", "fieldSize", "fixedData", "fixedInfoPattern",
+    "fixedPubExp", "function", "g", "gGen", "hashAlg", "hashAlgs", "hashFunctionZ", "hashPair",
+    "hashZ", "hashZIut", "hexCustomization", "hmacAlg", "inBit", "inEmpty", "increment",
+    "incrementalCounter", "infoGeneratedByServer", "initialIvClient", "initialIvServer",
+    "initiatorNonceLength", "integrityKeyClient", "integrityKeyServer", "isSample",
+    "iterationCount", "iutC", "iutHashZ", "iutId", "iutZ", "iv", "ivGenMode", "ivLen", "jwt",
+    "kasRole", "kdfKc", "kdfMode", "kdfNoKc", "kdfType", "kdrExponent", "key", "key1", "key2",
+    "key3", "keyBlock", "keyData", "keyDataLength", "keyDerivationKeyLength", "keyFormat",
+    "keyGenerationMethods", "keyLen", "keyOut", "keyingOption", "ktsMethod", "kwCipher", "l",
+    "labelLength", "lmOtsModes", "lmotsMode", "lmsMode", "lmsModes", "mac", "macLen", "macMode",
+    "macSaltMethods", "manufacturer", "maskFunction", "masterSecret", "max", "md",
+    "messageLength", "min", "mode", "module", "moduleUrl", "modulo", "msgLen", "n", "name",
+    "noKdfNoKc", "nonceLen", "oe", "oeUrl", "oid", "order", "otherInfoLen", "outBit", "outLen",
+    "outputLen", "overflowCounter", "p", "pMod8", "parameterSet", "password", "passwordLen",
+    "passwordLength", "payloadLen", "performCounterTests", "performLargeDataTest",
+    "performMultiExpansionTests", "persoStringLen", "plainText", "pqGen", "preHash",
+    "preSharedKeyLength", "predResistanceEnabled", "primeResult", "primeTest", "properties",
+    "pt", "pubExpMode", "publicIutX", "publicIutY", "publicKey", "pure", "q", "qMod8", "qx",
+    "qy", "r", "randPQ", "registration", "reseedImplemented", "responderNonceLength",
+    "resultsArray", "resumptionMasterSecret", "returnedBits", "returnedBitsLen", "revision",
+    "runningMode", "s", "sKeyId", "sKeyIdA", "sKeyIdD", "sKeyIdE", "sKeySeed", "sKeySeedReKey",
+    "safePrimeGroups", "salt", "saltGen", "saltLen", "saved", "scheme", "secretGenerationMode",
+    "seed", "series", "serverApplicationTrafficSecret", "serverHandshakeTrafficSecret",
+    "sharedInfoLength", "sharedKey", "sigType", "signature", "specificCapabilities", "srtcpKa",
+    "srtcpKe", "srtcpKs", "srtpKa", "srtpKe", "srtpKs", "submissionSize", "suppInfoLen",
+    "supportsNullAssociatedData", "supportsZeroKdr", "tag", "tagLen", "tcId", "testGroups",
+    "testPassed", "tests", "tgId", "tweakMode", "type", "url", "urls", "usesHybridSharedSecret",
+    "validationRequestUrl", "vectorSetUrl", "vectorSetUrls", "vendorUrl", "version", "x", "xP",
+    "xP1", "xP2", "xQ", "xQ1", "xQ2", "xof", "y", "z", "zzLen"
+};
+
+#define INTERNED_NAME_COUNT (sizeof(interned_names) / sizeof(interned_names[0]))
+
+static int interned_name_cmp(const char *interned, const char *name, size_t name_len) {
+    size_t i = 0;
+    for (i = 0; i < name_len; i++) {
+        if (interned[i] != name[i]) {
+            return (unsigned char)interned[i] - (unsigned char)name[i];
+        }
+    }
+    return (unsigned char)interned[name_len];
+}
+
+/* ACVP: the interned copy of a name if there is one, else an allocated copy */
+static char * json_name_dup(const char *name, size_t name_len) {
+    size_t lo = 0, hi = INTERNED_NAME_COUNT, mid = 0;
+    int cmp = 0;
+    if (name_len < INTERNED_NAME_SIZE) {
+        while (lo < hi) {
+            mid = lo + (hi - lo) / 2;
+            cmp = interned_name_cmp(interned_names[mid], name, name_len);
+            if (cmp == 0) {
+                return interned_names[mid];
+            } else if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+    }
+    return parson_strndup(name, name_len);
+}
+
+static void json_name_free(char *name) {
+    if (name >= interned_names[0] && name < interned_names[INTERNED_NAME_COUNT]) {
+        return;
+    }
+    parson_free(name);
+}
+
 #if 0 /* Unused, compiler warning */
 static char * parson_strdup(const char *string) {
     int len = strnlen_s(string, STRING_VALUE_MAX + 1);
@@ -310,6 +464,39 @@ static int is_decimal(const char *string, size_t length) {
     return 1;
 }
 
+/*
+ * ACVP: Writes num to buf as "%1.17g" would, whole numbers below
+ * FAST_INT_MAX without sprintf(). Returns the length written, or -1.
+ */
+static int serialize_number(double num, char *buf) {
+    char digits[NUM_BUF_SIZE];
+    unsigned long long int n = 0;
+    long long int whole = 0;
+    int len = 0, i = 0;
+
+    if (!(num > -FAST_INT_MAX && num < FAST_INT_MAX)) {
+        return sprintf(buf, FLOAT_FORMAT, num);
+    }
+    /* Zero, which may be -0, and numbers with a fraction */
+    whole = (long long int)num;
+    if (!whole || (double)whole < num || (double)whole > num) {
+        return sprintf(buf, FLOAT_FORMAT, num);
+    }
+    n = (unsigned long long int)(whole < 0 ? -whole : whole);
+    while (n) {
+        digits[len++] = (char)('0' + n % 10);
+        n /= 10;
+    }
+    if (num < 0) {
+        buf[i++] = '-';
+    }
+    while (len) {
+        buf[i++] = digits[--len];
+    }
+    buf[i] = '\0';
+    return i;
+}
+
 static char * read_file(const char * filename) {
     FILE *fp = fopen(filename, "r");
     size_t size_to_read = 0;
@@ -389,6 +576,9 @@ static JSON_Object * json_object_init(JSON_Value *wrapping_value) {
     new_obj->wrapping_value = wrapping_value;
     new_obj->names = (char**)NULL;
     new_obj->values = (JSON_Value**)NULL;
+    new_obj->hashes = (unsigned long*)NULL;
+    new_obj->cells = (size_t*)NULL;
+    new_obj->cell_capacity = 0;
     new_obj->capacity = 0;
     new_obj->count = 0;
     return new_obj;
@@ -403,10 +593,12 @@ static JSON_Status json_object_add(JSON_Object *object, const char *name, JSON_V
 
 static JSON_Status json_object_addn(JSON_Object *object, const char *name, size_t name_len, JSON_Value *value) {
     size_t index = 0;
+    unsigned long hash = 0;
     if (object == NULL || name == NULL || value == NULL) {
         return JSONFailure;
     }
-    if (json_object_getn_value(object, name, name_len) != NULL) {
+    hash = json_name_hash(name, name_len);
+    if (json_object_find(object, name, name_len, hash) != OBJECT_NOT_FOUND) {
         return JSONFailure;
     }
     if (object->count >= object->capacity) {
@@ -416,19 +608,27 @@ static JSON_Status json_object_addn(JSON_Object *object, const char *name, size_
         }
     }
     index = object->count;
-    object->names[index] = parson_strndup(name, name_len);
+    object->names[index] = json_name_dup(name, name_len);
     if (object->names[index] == NULL) {
         return JSONFailure;
     }
     value->parent = json_object_get_wrapping_value(object);
     object->values[index] = value;
+    object->hashes[index] = hash;
     object->count++;
+    /* ACVP: keep the index at most half full */
+    if (object->count >= OBJECT_INDEX_MIN && object->count * 2 > object->cell_capacity) {
+        json_object_index_rebuild(object);
+    } else if (object->cells != NULL) {
+        json_object_index_insert(object, index);
+    }
     return JSONSuccess;
 }
 
 static JSON_Status json_object_resize(JSON_Object *object, size_t new_capacity) {
     char **temp_names = NULL;
     JSON_Value **temp_values = NULL;
+    unsigned long *temp_hashes = NULL;
 
     if ((object->names == NULL && object->values != NULL) ||
         (object->names != NULL && object->values == NULL) ||
@@ -444,63 +644,153 @@ static JSON_Status json_object_resize(JSON_Object *object, size_t new_capacity)
         parson_free(temp_names);
         return JSONFailure;
     }
+    temp_hashes = (unsigned long*)parson_malloc(new_capacity * sizeof(unsigned long));
+    if (temp_hashes == NULL) {
+        parson_free(temp_names);
+        parson_free(temp_values);
+        return JSONFailure;
+    }
     if (object->names != NULL && object->values != NULL && object->count > 0) {
         /* SAFEC */
         memcpy_s(temp_names, new_capacity * sizeof(char*),
                  object->names, object->count * sizeof(char*));
         memcpy_s(temp_values, new_capacity * sizeof(JSON_Value*),
                  object->values, object->count * sizeof(JSON_Value*));
+        memcpy_s(temp_hashes, new_capacity * sizeof(unsigned long),
+                 object->hashes, object->count * sizeof(unsigned long));
     }
     parson_free(object->names);
     parson_free(object->values);
+    parson_free(object->hashes);
     object->names = temp_names;
     object->values = temp_values;
+    object->hashes = temp_hashes;
     object->capacity = new_capacity;
     return JSONSuccess;
 }
 
 static JSON_Value * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len) {
-    size_t i, name_length;
+    size_t i = 0;
+    if (object == NULL || name == NULL) {
+        return NULL;
+    }
+    i = json_object_find(object, name, name_len, json_name_hash(name, name_len));
+    return i == OBJECT_NOT_FOUND ? NULL : object->values[i];
+}
+
+/* ACVP: FNV-1a */
+static unsigned long json_name_hash(const char *name, size_t name_len) {
+    unsigned long hash = 2166136261UL;
+    size_t i = 0;
+    for (i = 0; i < name_len; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/*
+ * ACVP: Returns the index of name in object, or OBJECT_NOT_FOUND. Objects with
+ * an index are probed through it, smaller ones are scanned comparing hashes
+ * first, so names are only compared when they are likely to match.
+ */
+static size_t json_object_find(const JSON_Object *object, const char *name, size_t name_len, unsigned long hash) {
+    size_t i = 0, cell = 0, mask = 0;
     int diff = 1;
-    for (i = 0; i < json_object_get_count(object); i++) {
-        name_length = strnlen_s(object->names[i], STRING_NAME_MAX);
-        if (name_length != name_len) {
+
+    if (object->cells != NULL) {
+        mask = object->cell_capacity - 1;
+        for (cell = hash & mask; object->cells[cell] != 0; cell = (cell + 1) & mask) {
+            i = object->cells[cell] - 1;
+            if (object->hashes[i] != hash || strnlen_s(object->names[i], STRING_NAME_MAX) != name_len) {
+                continue;
+            }
+            strcmp_s(name, name_len, object->names[i], &diff); /* SAFEC */
+            if (!diff) {
+                return i;
+            }
+        }
+        return OBJECT_NOT_FOUND;
+    }
+    for (i = 0; i < object->count; i++) {
+        if (object->hashes[i] != hash || strnlen_s(object->names[i], STRING_NAME_MAX) != name_len) {
             continue;
         }
         strcmp_s(name, name_len, object->names[i], &diff); /* SAFEC */
         if (!diff) {
-            return object->values[i];
+            return i;
         }
     }
-    return NULL;
+    return OBJECT_NOT_FOUND;
+}
+
+static void json_object_index_insert(JSON_Object *object, size_t index) {
+    size_t mask = object->cell_capacity - 1;
+    size_t cell = object->hashes[index] & mask;
+    while (object->cells[cell] != 0) {
+        cell = (cell + 1) & mask;
+    }
+    object->cells[cell] = index + 1;
+}
+
+/*
+ * ACVP: (Re)builds the index of an object for its current names, or drops it
+ * if the object has become too small to need one. The index only speeds up
+ * lookups, so if it can't be allocated the object goes on being scanned.
+ */
+static void json_object_index_rebuild(JSON_Object *object) {
+    size_t i = 0, cell_capacity = OBJECT_INDEX_MIN * 2;
+
+    parson_free(object->cells);
+    object->cells = NULL;
+    object->cell_capacity = 0;
+    if (object->count < OBJECT_INDEX_MIN) {
+        return;
+    }
+    while (cell_capacity < object->count * 4) {
+        cell_capacity *= 2;
+    }
+    object->cells = (size_t*)parson_malloc(cell_capacity * sizeof(size_t));
+    if (object->cells == NULL) {
+        return;
+    }
+    for (i = 0; i < cell_capacity; i++) {
+        object->cells[i] = 0;
+    }
+    object->cell_capacity = cell_capacity;
+    for (i = 0; i < object->count; i++) {
+        json_object_index_insert(object, i);
+    }
 }
 
 static JSON_Status json_object_remove_internal(JSON_Object *object, const char *name, int free_value) {
-    size_t i = 0, last_item_index = 0;
-    if (object == NULL || json_object_get_value(object, name) == NULL) {
+    size_t i = 0, last_item_index = 0, name_len = 0;
+    if (object == NULL || name == NULL) {
+        return JSONFailure;
+    }
+    name_len = strnlen_s(name, STRING_NAME_MAX); /* SAFEC */
+    i = json_object_find(object, name, name_len, json_name_hash(name, name_len));
+    if (i == OBJECT_NOT_FOUND) {
         return JSONFailure;
     }
     last_item_index = json_object_get_count(object) - 1;
-    for (i = 0; i < json_object_get_count(object); i++) {
-        int diff = 1;
-        strcmp_s(object->names[i], STRING_NAME_MAX, name, &diff); /* SAFEC */
-        if (!diff) {
-            parson_free(object->names[i]);
-            if (free_value) {
-                json_value_free(object->values[i]);
-            /* ACVP: If remove a value from an object without freeing, make sure its parent is NULL */
-            } else {
-                object->values[i]->parent = NULL;
-            }
-            if (i != last_item_index) { /* Replace key value pair with one from the end */
-                object->names[i] = object->names[last_item_index];
-                object->values[i] = object->values[last_item_index];
-            }
-            object->count -= 1;
-            return JSONSuccess;
-        }
+    json_name_free(object->names[i]);
+    if (free_value) {
+        json_value_free(object->values[i]);
+    /* ACVP: If remove a value from an object without freeing, make sure its parent is NULL */
+    } else {
+        object->values[i]->parent = NULL;
+    }
+    if (i != last_item_index) { /* Replace key value pair with one from the end */
+        object->names[i] = object->names[last_item_index];
+        object->values[i] = object->values[last_item_index];
+        object->hashes[i] = object->hashes[last_item_index];
     }
-    return JSONFailure; /* No execution path should end here */
+    object->count -= 1;
+    if (object->cells != NULL) {
+        json_object_index_rebuild(object);
+    }
+    return JSONSuccess;
 }
 
 static JSON_Status json_object_dotremove_internal(JSON_Object *object, const char *name, int free_value) {
@@ -534,11 +824,13 @@ static JSON_Status json_object_dotremove_internal(JSON_Object *object, const cha
 static void json_object_free(JSON_Object *object) {
     size_t i;
     for (i = 0; i < object->count; i++) {
-        parson_free(object->names[i]);
+        json_name_free(object->names[i]);
         json_value_free(object->values[i]);
     }
     parson_free(object->names);
     parson_free(object->values);
+    parson_free(object->hashes);
+    parson_free(object->cells);
     parson_free(object);
 }
 
@@ -552,10 +844,16 @@ static JSON_Array * json_array_init(JSON_Value *wrapping_value) {
     new_array->items = (JSON_Value**)NULL;
     new_array->capacity = 0;
     new_array->count = 0;
+    new_array->spans = NULL;
+    new_array->loaded = 0;
+    new_array->loaded_text = NULL;
     return new_array;
 }
 
 static JSON_Status json_array_add(JSON_Array *array, JSON_Value *value) {
+    if (array->spans != NULL) { /* ACVP: lazy arrays are read only */
+        return JSONFailure;
+    }
     if (array->count >= array->capacity) {
         size_t new_capacity = MAX(array->capacity * 2, STARTING_CAPACITY);
         if (json_array_resize(array, new_capacity) == JSONFailure) {
@@ -589,13 +887,53 @@ static JSON_Status json_array_resize(JSON_Array *array, size_t new_capacity) {
 
 static void json_array_free(JSON_Array *array) {
     size_t i;
+    json_array_unload(array);
     for (i = 0; i < array->count; i++) {
         json_value_free(array->items[i]);
     }
     parson_free(array->items);
+    parson_free(array->spans);
     parson_free(array);
 }
 
+/* ACVP: Parses an item of a lazy array, once the one parsed before it is freed */
+static JSON_Value * json_array_load(JSON_Array *array, size_t index) {
+    JSON_Situ situ = { NULL, 0 };
+    const char *text = NULL;
+    JSON_Value *value = NULL;
+    if (array->items[index] != NULL) {
+        return array->items[index];
+    }
+    json_array_unload(array);
+    array->loaded_text = parson_strndup(array->spans[index].text, array->spans[index].len);
+    if (array->loaded_text == NULL) {
+        return NULL;
+    }
+    situ.text = array->loaded_text;
+    text = situ.text;
+    value = parse_value(&text, 0, &situ);
+    if (value == NULL) {
+        parson_free(array->loaded_text);
+        array->loaded_text = NULL;
+        return NULL;
+    }
+    value->parent = json_array_get_wrapping_value(array);
+    array->items[index] = value;
+    array->loaded = index;
+    return value;
+}
+
+/* ACVP: Frees the parsed item of a lazy array, if there is one */
+static void json_array_unload(JSON_Array *array) {
+    if (array->loaded_text == NULL) {
+        return;
+    }
+    json_value_free(array->items[array->loaded]);
+    array->items[array->loaded] = NULL;
+    parson_free(array->loaded_text);
+    array->loaded_text = NULL;
+}
+
 /* JSON Value */
 static JSON_Value * json_value_init_string_no_copy(char *string, size_t length) {
     JSON_Value *new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
@@ -604,18 +942,169 @@ static JSON_Value * json_value_init_string_no_copy(char *string, size_t length)
     }
     new_value->parent = NULL;
     new_value->type = JSONString;
+    new_value->borrowed = 0;
+    new_value->hex = 0;
     new_value->value.string.chars = string;
     new_value->value.string.length = length;
     return new_value;
 }
 
 /* Parser */
+
+/*
+ * ACVP: A byte that needs no more than copying inside a string, and those
+ * that isspace() takes in the C locale
+ */
+#define IS_PLAIN(c) ((c) != '\"' && (c) != '\\' && (unsigned char)(c) >= 0x20)
+#define IS_SPACE(c) ((c) == ' ' || (unsigned int)((unsigned char)(c) - '\t') <= '\r' - '\t')
+
+#if defined PARSON_SCAN_SSE2 || defined PARSON_SCAN_NEON
+#define SCAN_BLOCK 16
+
+/*
+ * ACVP: scan_mask() reads whole aligned blocks, so the last one of a string
+ * may take in bytes after its NUL terminator that the allocation does not
+ * own. An aligned block is never split across pages, and the NUL ends every
+ * run, so such a read can not fault; it only looks like an overflow to
+ * AddressSanitizer.
+ */
+#if defined __clang__ || (defined __GNUC__ && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)))
+#define SCAN_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define SCAN_NO_SANITIZE
+#endif
+
+/*
+ * ACVP: Index of the lowest set bit of mask, which is not 0. For NEON each
+ * byte is 4 bits of the mask, see scan_mask().
+ */
+static unsigned int scan_first(unsigned long long int mask) {
+#if defined _MSC_VER && defined _M_X64 || defined _M_ARM64
+    unsigned long i = 0;
+    _BitScanForward64(&i, mask);
+    return (unsigned int)i;
+#elif defined _MSC_VER
+    unsigned long i = 0;
+    if (!_BitScanForward(&i, (unsigned long)mask)) {
+        _BitScanForward(&i, (unsigned long)(mask >> 32));
+        i += 32;
+    }
+    return (unsigned int)i;
+#else
+    return (unsigned int)__builtin_ctzll(mask);
+#endif
+}
+
+/*
+ * ACVP: The bytes of the aligned block at s that end a run, as a mask: those
+ * that are not plain if plain is set, and those that are not spaces otherwise
+ */
+SCAN_NO_SANITIZE
+static unsigned long long int scan_mask(const char *s, int plain) {
+#ifdef PARSON_SCAN_SSE2
+    __m128i v = _mm_load_si128((const __m128i *)s);
+    __m128i stop;
+    if (plain) {
+        stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')),
+                            _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+        stop = _mm_or_si128(stop, _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F)));
+        return (unsigned long long int)_mm_movemask_epi8(stop);
+    }
+    v = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ' - '\t')),
+                        _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8('\r' - '\t')), _mm_set1_epi8('\r' - '\t')));
+    return (unsigned long long int)(_mm_movemask_epi8(stop) ^ 0xFFFF);
+#else
+    uint8x16_t v = vld1q_u8((const uint8_t *)s);
+    uint8x16_t stop;
+    if (plain) {
+        stop = vorrq_u8(vceqq_u8(v, vdupq_n_u8('\"')), vceqq_u8(v, vdupq_n_u8('\\')));
+        stop = vorrq_u8(stop, vcleq_u8(v, vdupq_n_u8(0x1F)));
+    } else {
+        v = vsubq_u8(v, vdupq_n_u8('\t'));
+        stop = vmvnq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ' - '\t')), vcleq_u8(v, vdupq_n_u8('\r' - '\t'))));
+    }
+    /* 4 bits a byte */
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(stop), 4)), 0);
+#endif
+}
+
+#ifdef PARSON_SCAN_SSE2
+#define SCAN_INDEX(mask) scan_first(mask)
+#else
+#define SCAN_INDEX(mask) (scan_first(mask) >> 2)
+#endif
+
+/*
+ * ACVP: Skips the run of plain bytes, or of spaces, at string. Bytes are
+ * taken one at a time up to a block boundary, so that every block read
+ * is aligned, see SCAN_NO_SANITIZE.
+ */
+static const char * scan_run(const char *string, int plain) {
+    unsigned long long int mask = 0;
+    while (((size_t)string & (SCAN_BLOCK - 1)) != 0) {
+        if (plain ? !IS_PLAIN(*string) : !IS_SPACE(*string)) {
+            return string;
+        }
+        string++;
+    }
+    for (;;) {
+        mask = scan_mask(string, plain);
+        if (mask) {
+            return string + SCAN_INDEX(mask);
+        }
+        string += SCAN_BLOCK;
+    }
+}
+#endif
+
+/* ACVP: Skips the bytes of a string that need no more than copying */
+static const char * skip_plain(const char *string) {
+#if defined PARSON_SCAN_SSE2 || defined PARSON_SCAN_NEON
+    /* Names and short values are mostly over before a block would start */
+    if (!IS_PLAIN(string[0]) || !IS_PLAIN(string[1]) || !IS_PLAIN(string[2]) || !IS_PLAIN(string[3])) {
+        while (IS_PLAIN(*string)) {
+            string++;
+        }
+        return string;
+    }
+    return scan_run(string + 4, 1);
+#else
+    while (IS_PLAIN(*string)) {
+        string++;
+    }
+    return string;
+#endif
+}
+
+static const char * skip_whitespaces(const char *string) {
+#if defined PARSON_SCAN_SSE2 || defined PARSON_SCAN_NEON
+    /* Runs of indentation are worth scanning, a space or a newline is not */
+    if (!IS_SPACE(string[0]) || !IS_SPACE(string[1]) || !IS_SPACE(string[2]) || !IS_SPACE(string[3])) {
+        while (IS_SPACE(*string)) {
+            string++;
+        }
+        return string;
+    }
+    return scan_run(string + 4, 0);
+#else
+    while (IS_SPACE(*string)) {
+        string++;
+    }
+    return string;
+#endif
+}
+
 static JSON_Status skip_quotes(const char **string) {
     if (**string != '\"') {
         return JSONFailure;
     }
     SKIP_CHAR(string);
     while (**string != '\"') {
+        *string = skip_plain(*string);
+        if (**string == '\"') {
+            break;
+        }
         if (**string == '\0') {
             return JSONFailure;
         } else if (**string == '\\') {
@@ -630,6 +1119,44 @@ static JSON_Status skip_quotes(const char **string) {
     return JSONSuccess;
 }
 
+/* ACVP: Skips over a JSON value without parsing it; it is checked once it is parsed */
+static JSON_Status skip_value(const char **string) {
+    size_t depth = 0;
+    if (**string != '{' && **string != '[') {
+        if (**string == '\"') {
+            return skip_quotes(string);
+        }
+        while (**string != '\0' && **string != ',' && **string != ']' && **string != '}' &&
+               !isspace((unsigned char)(**string))) {
+            SKIP_CHAR(string);
+        }
+        return JSONSuccess;
+    }
+    do {
+        switch (**string) {
+            case '\0':
+                return JSONFailure;
+            case '\"':
+                if (skip_quotes(string) == JSONFailure) {
+                    return JSONFailure;
+                }
+                continue;
+            case '{': case '[':
+                if (++depth > MAX_NESTING) {
+                    return JSONFailure;
+                }
+                break;
+            case '}': case ']':
+                depth--;
+                break;
+            default:
+                break;
+        }
+        SKIP_CHAR(string);
+    } while (depth > 0);
+    return JSONSuccess;
+}
+
 static int parse_utf16(const char **unprocessed, char **processed) {
     unsigned int cp, lead, trail;
     int parse_succeeded = 0;
@@ -678,18 +1205,38 @@ static int parse_utf16(const char **unprocessed, char **processed) {
 
 
 /* Copies and processes passed string up to supplied length.
-Example: "\u006Corem ipsum" -> lorem ipsum */
-static char* process_string(const char *input, size_t input_len, size_t *output_len) {
+Example: "\u006Corem ipsum" -> lorem ipsum
+ACVP: With in_situ the string is processed in place instead, which is safe
+since unescaping never makes it longer, and NUL terminated where it ends. */
+static char* process_string(const char *input, size_t input_len, size_t *output_len, const JSON_Situ *in_situ) {
     const char *input_ptr = input;
     size_t initial_size = (input_len + 1) * sizeof(char);
     size_t final_size = 0;
     char *output = NULL, *output_ptr = NULL, *resized_output = NULL;
-    output = (char*)parson_malloc(initial_size);
+    if (in_situ) {
+        output = in_situ->text + (input - in_situ->text);
+    } else {
+        output = (char*)parson_malloc(initial_size);
+    }
     if (output == NULL) {
         goto error;
     }
     output_ptr = output;
     while ((*input_ptr != '\0') && (size_t)(input_ptr - input) < input_len) {
+        /* ACVP: copy the run up to the next escape at once, or leave it be in situ until there is one */
+        const char *run_end = skip_plain(input_ptr);
+        size_t run = (size_t)(run_end - input_ptr);
+        if (run > input_len - (size_t)(input_ptr - input)) {
+            run = input_len - (size_t)(input_ptr - input);
+        }
+        if (run) {
+            if (output_ptr != input_ptr) {
+                memmove(output_ptr, input_ptr, run);
+            }
+            output_ptr += run;
+            input_ptr += run;
+            continue;
+        }
         if (*input_ptr == '\\') {
             input_ptr++;
             switch (*input_ptr) {
@@ -720,6 +1267,10 @@ static char* process_string(const char *input, size_t input_len, size_t *output_
     *output_ptr = '\0';
     /* resize to new length */
     final_size = (size_t)(output_ptr-output) + 1;
+    if (in_situ) {
+        *output_len = final_size - 1;
+        return output;
+    }
     /* todo: don't resize if final_size == initial_size */
     resized_output = (char*)parson_malloc(final_size);
     if (resized_output == NULL) {
@@ -730,13 +1281,15 @@ static char* process_string(const char *input, size_t input_len, size_t *output_
     parson_free(output);
     return resized_output;
 error:
-    parson_free(output);
+    if (!in_situ) {
+        parson_free(output);
+    }
     return NULL;
 }
 
 /* Return processed contents of a string between quotes and
    skips passed argument to a matching quote. */
-static char * get_quoted_string(const char **string, size_t *output_string_len) {
+static char * get_quoted_string(const char **string, size_t *output_string_len, const JSON_Situ *in_situ) {
     const char *string_start = *string;
     size_t input_string_len = 0;
     JSON_Status status = skip_quotes(string);
@@ -744,21 +1297,21 @@ static char * get_quoted_string(const char **string, size_t *output_string_len)
         return NULL;
     }
     input_string_len = *string - string_start - 2; /* length without quotes */
-    return process_string(string_start + 1, input_string_len, output_string_len);
+    return process_string(string_start + 1, input_string_len, output_string_len, in_situ);
 }
 
-static JSON_Value * parse_value(const char **string, size_t nesting) {
+static JSON_Value * parse_value(const char **string, size_t nesting, const JSON_Situ *in_situ) {
     if (nesting > MAX_NESTING) {
         return NULL;
     }
     SKIP_WHITESPACES(string);
     switch (**string) {
         case '{':
-            return parse_object_value(string, nesting + 1);
+            return parse_object_value(string, nesting + 1, in_situ);
         case '[':
-            return parse_array_value(string, nesting + 1);
+            return parse_array_value(string, nesting + 1, in_situ);
         case '\"':
-            return parse_string_value(string);
+            return parse_string_value(string, in_situ);
         case 'f': case 't':
             return parse_boolean_value(string);
         case '-':
@@ -772,10 +1325,11 @@ static JSON_Value * parse_value(const char **string, size_t nesting) {
     }
 }
 
-static JSON_Value * parse_object_value(const char **string, size_t nesting) {
+static JSON_Value * parse_object_value(const char **string, size_t nesting, const JSON_Situ *in_situ) {
     JSON_Value *output_value = NULL, *new_value = NULL;
     JSON_Object *output_object = NULL;
     char *new_key = NULL;
+    int diff = 1;
     output_value = json_value_init_object();
     if (output_value == NULL) {
         return NULL;
@@ -793,35 +1347,42 @@ static JSON_Value * parse_object_value(const char **string, size_t nesting) {
     }
     while (**string != '\0') {
         size_t key_len = 0;
-        new_key = get_quoted_string(string, &key_len);
+        new_key = get_quoted_string(string, &key_len, in_situ);
         /* We do not support key names with embedded \0 chars */
         if (new_key == NULL || key_len != strnlen_s(new_key, STRING_NAME_MAX)) {
-            if (new_key) {
-                parson_free(new_key);
-            }
+            if (new_key && !in_situ) parson_free(new_key);
             json_value_free(output_value);
             return NULL;
         }
         SKIP_WHITESPACES(string);
         if (**string != ':') {
-            parson_free(new_key);
+            if (!in_situ) parson_free(new_key);
             json_value_free(output_value);
             return NULL;
         }
         SKIP_CHAR(string);
-        new_value = parse_value(string, nesting);
+        SKIP_WHITESPACES(string);
+        diff = 1;
+        if (in_situ && in_situ->lazy && **string == '[' && key_len == SIZEOF_TOKEN(LAZY_ARRAY_NAME)) {
+            strncmp_s(new_key, key_len, LAZY_ARRAY_NAME, key_len, &diff); /* SAFEC */
+        }
+        if (!diff) {
+            new_value = parse_lazy_array_value(string);
+        } else {
+            new_value = parse_value(string, nesting, in_situ);
+        }
         if (new_value == NULL) {
-            parson_free(new_key);
+            if (!in_situ) parson_free(new_key);
             json_value_free(output_value);
             return NULL;
         }
         if (json_object_add(output_object, new_key, new_value) == JSONFailure) {
-            parson_free(new_key);
+            if (!in_situ) parson_free(new_key);
             json_value_free(new_value);
             json_value_free(output_value);
             return NULL;
         }
-        parson_free(new_key);
+        if (!in_situ) parson_free(new_key);
         SKIP_WHITESPACES(string);
         if (**string != ',') {
             break;
@@ -839,7 +1400,7 @@ static JSON_Value * parse_object_value(const char **string, size_t nesting) {
     return output_value;
 }
 
-static JSON_Value * parse_array_value(const char **string, size_t nesting) {
+static JSON_Value * parse_array_value(const char **string, size_t nesting, const JSON_Situ *in_situ) {
     JSON_Value *output_value = NULL, *new_array_value = NULL;
     JSON_Array *output_array = NULL;
     output_value = json_value_init_array();
@@ -858,7 +1419,7 @@ static JSON_Value * parse_array_value(const char **string, size_t nesting) {
         return output_value;
     }
     while (**string != '\0') {
-        new_array_value = parse_value(string, nesting);
+        new_array_value = parse_value(string, nesting, in_situ);
         if (new_array_value == NULL) {
             json_value_free(output_value);
             return NULL;
@@ -885,18 +1446,82 @@ static JSON_Value * parse_array_value(const char **string, size_t nesting) {
     return output_value;
 }
 
-static JSON_Value * parse_string_value(const char **string) {
+/* ACVP: Only notes where each item is, see json_parse_string_lazy() */
+static JSON_Value * parse_lazy_array_value(const char **string) {
+    JSON_Value *output_value = NULL;
+    JSON_Array *output_array = NULL;
+    JSON_Span *new_spans = NULL;
+    size_t capacity = 0, i = 0;
+    output_value = json_value_init_array();
+    if (output_value == NULL) {
+        return NULL;
+    }
+    output_array = json_value_get_array(output_value);
+    SKIP_CHAR(string);
+    SKIP_WHITESPACES(string);
+    if (**string == ']') { /* empty array */
+        SKIP_CHAR(string);
+        return output_value;
+    }
+    while (**string != '\0') {
+        if (output_array->count >= capacity) {
+            capacity = MAX(capacity * 2, STARTING_CAPACITY);
+            new_spans = (JSON_Span*)parson_malloc(capacity * sizeof(JSON_Span));
+            if (new_spans == NULL) {
+                goto error;
+            }
+            if (output_array->count > 0) {
+                memcpy_s(new_spans, capacity * sizeof(JSON_Span),
+                         output_array->spans, output_array->count * sizeof(JSON_Span)); /* SAFEC */
+            }
+            parson_free(output_array->spans);
+            output_array->spans = new_spans;
+        }
+        output_array->spans[output_array->count].text = *string;
+        if (skip_value(string) == JSONFailure || *string == output_array->spans[output_array->count].text) {
+            goto error;
+        }
+        output_array->spans[output_array->count].len = *string - output_array->spans[output_array->count].text;
+        output_array->count++;
+        SKIP_WHITESPACES(string);
+        if (**string != ',') {
+            break;
+        }
+        SKIP_CHAR(string);
+        SKIP_WHITESPACES(string);
+    }
+    if (**string != ']') {
+        goto error;
+    }
+    SKIP_CHAR(string);
+    output_array->items = (JSON_Value**)parson_malloc(output_array->count * sizeof(JSON_Value*));
+    if (output_array->items == NULL) {
+        goto error;
+    }
+    for (i = 0; i < output_array->count; i++) {
+        output_array->items[i] = NULL;
+    }
+    output_array->capacity = output_array->count;
+    return output_value;
+error:
+    output_array->count = 0;
+    json_value_free(output_value);
+    return NULL;
+}
+
+static JSON_Value * parse_string_value(const char **string, const JSON_Situ *in_situ) {
     JSON_Value *value = NULL;
     size_t new_string_len = 0;
-    char *new_string = get_quoted_string(string, &new_string_len);
+    char *new_string = get_quoted_string(string, &new_string_len, in_situ);
     if (new_string == NULL) {
         return NULL;
     }
     value = json_value_init_string_no_copy(new_string, new_string_len);
     if (value == NULL) {
-        parson_free(new_string);
+        if (!in_situ) parson_free(new_string);
         return NULL;
     }
+    value->borrowed = in_situ != NULL;
     return value;
 }
 
@@ -917,9 +1542,42 @@ static JSON_Value * parse_boolean_value(const char **string) {
     return NULL;
 }
 
+/*
+ * ACVP: Most numbers in vector sets are ids and lengths, plain runs of
+ * digits, which are added up here. Anything else, or anything longer than
+ * FAST_INT_DIGITS, is left to strtod().
+ */
+static int parse_integer(const char **string, double *number) {
+    const char *p = *string;
+    unsigned long long int acc = 0;
+    int negative = 0, digits = 0;
+
+    if (*p == '-') {
+        negative = 1;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9' && digits <= FAST_INT_DIGITS) {
+        acc = acc * 10 + (unsigned long long int)(*p - '0');
+        p++;
+        digits++;
+    }
+    if (!digits || digits > FAST_INT_DIGITS || (digits > 1 && p[-digits] == '0')) {
+        return 0;
+    }
+    if (*p == '.' || *p == 'e' || *p == 'E' || *p == 'x' || *p == 'X') {
+        return 0;
+    }
+    *number = negative ? -(double)acc : (double)acc;
+    *string = p;
+    return 1;
+}
+
 static JSON_Value * parse_number_value(const char **string) {
     char *end;
     double number = 0;
+    if (parse_integer(string, &number)) {
+        return json_value_init_number(number);
+    }
     errno = 0;
     number = strtod(*string, &end);
     if (errno == ERANGE && (number <= -HUGE_VAL || number >= HUGE_VAL)) {
@@ -1048,6 +1706,15 @@ static int json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int le
             APPEND_STRING("}");
             return written_total;
         case JSONString:
+            if (value->hex) {
+                written = json_serialize_hex(json_value_hex_bytes(value),
+                                             value->value.string.length / 2, buf);
+                if (buf != NULL) {
+                    buf += written;
+                }
+                written_total += written;
+                return written_total;
+            }
             string = json_value_get_string(value);
             if (string == NULL) {
                 return -1;
@@ -1074,7 +1741,7 @@ static int json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int le
             if (buf != NULL) {
                 num_buf = buf;
             }
-            written = sprintf(num_buf, FLOAT_FORMAT, num);
+            written = serialize_number(num, num_buf);
             if (written < 0) {
                 return -1;
             }
@@ -1160,6 +1827,33 @@ static int json_serialize_string(const char *string, size_t len, char *buf) {
     return written_total;
 }
 
+/* ACVP: upper case, as acvp_bin_to_hexstr() writes them */
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static void hex_encode(const unsigned char *bytes, size_t len, char *buf) {
+    size_t i = 0;
+    for (i = 0; i < len; i++) {
+        buf[2 * i] = hex_digits[bytes[i] >> 4];
+        buf[2 * i + 1] = hex_digits[bytes[i] & 0x0f];
+    }
+}
+
+/* ACVP: the bytes of a hex value, kept after room for their encoding */
+static const unsigned char * json_value_hex_bytes(const JSON_Value *value) {
+    return (const unsigned char*)value->value.string.chars + value->value.string.length + 1;
+}
+
+/* ACVP: hex digits need no escaping, so they are written as they are encoded */
+static int json_serialize_hex(const unsigned char *bytes, size_t len, char *buf) {
+    if (buf != NULL) {
+        buf[0] = '\"';
+        hex_encode(bytes, len, buf + 1);
+        buf[2 * len + 1] = '\"';
+        buf[2 * len + 2] = '\0';
+    }
+    return (int)(2 * len + 2);
+}
+
 static int append_indent(char *buf, int level) {
     int i;
     int written = -1, written_total = 0;
@@ -1211,7 +1905,37 @@ JSON_Value * json_parse_string(const char *string) {
     if (string[0] == '\xEF' && string[1] == '\xBB' && string[2] == '\xBF') {
         string = string + 3; /* Support for UTF-8 BOM */
     }
-    return parse_value((const char**)&string, 0);
+    return parse_value((const char**)&string, 0, NULL);
+}
+
+/* ACVP */
+JSON_Value * json_parse_string_in_situ(char *string) {
+    JSON_Situ situ = { NULL, 0 };
+    const char *text = NULL;
+    if (string == NULL) {
+        return NULL;
+    }
+    if (string[0] == '\xEF' && string[1] == '\xBB' && string[2] == '\xBF') {
+        string = string + 3; /* Support for UTF-8 BOM */
+    }
+    situ.text = string;
+    text = string;
+    return parse_value(&text, 0, &situ);
+}
+
+/* ACVP */
+JSON_Value * json_parse_string_lazy(char *string) {
+    JSON_Situ situ = { NULL, 1 };
+    const char *text = NULL;
+    if (string == NULL) {
+        return NULL;
+    }
+    if (string[0] == '\xEF' && string[1] == '\xBB' && string[2] == '\xBF') {
+        string = string + 3; /* Support for UTF-8 BOM */
+    }
+    situ.text = string;
+    text = string;
+    return parse_value(&text, 0, &situ);
 }
 
 #if 0 /* Removed, does not currently comply with SAFEC */
@@ -1225,7 +1949,7 @@ JSON_Value * json_parse_string_with_comments(const char *string) {
     remove_comments(string_mutable_copy, "/*", "*/");
     remove_comments(string_mutable_copy, "//", "\n");
     string_mutable_copy_ptr = string_mutable_copy;
-    result = parse_value((const char**)&string_mutable_copy_ptr, 0);
+    result = parse_value((const char**)&string_mutable_copy_ptr, 0, 0);
     parson_free(string_mutable_copy);
     return result;
 }
@@ -1252,6 +1976,10 @@ double json_object_get_number(const JSON_Object *object, const char *name) {
     return json_value_get_number(json_object_get_value(object, name));
 }
 
+unsigned int json_object_get_uint(const JSON_Object *object, const char *name) {
+    return json_value_get_uint(json_object_get_value(object, name));
+}
+
 JSON_Object * json_object_get_object(const JSON_Object *object, const char *name) {
     return json_value_get_object(json_object_get_value(object, name));
 }
@@ -1355,6 +2083,9 @@ JSON_Value * json_array_get_value(const JSON_Array *array, size_t index) {
     if (array == NULL || index >= json_array_get_count(array)) {
         return NULL;
     }
+    if (array->spans != NULL) { /* ACVP: loads through the wrapping value, which is not const */
+        return json_array_load(json_value_get_array(array->wrapping_value), index);
+    }
     return array->items[index];
 }
 
@@ -1371,6 +2102,10 @@ double json_array_get_number(const JSON_Array *array, size_t index) {
     return json_value_get_number(json_array_get_value(array, index));
 }
 
+unsigned int json_array_get_uint(const JSON_Array *array, size_t index) {
+    return json_value_get_uint(json_array_get_value(array, index));
+}
+
 JSON_Object * json_array_get_object(const JSON_Array *array, size_t index) {
     return json_value_get_object(json_array_get_value(array, index));
 }
@@ -1404,8 +2139,25 @@ JSON_Array * json_value_get_array(const JSON_Value *value) {
     return json_value_get_type(value) == JSONArray ? value->value.array : NULL;
 }
 
+/*
+ * ACVP: a hex value is encoded into the front of its buffer the first time
+ * its string is read; only the chars it points to are written.
+ */
+static void json_value_hex_to_string(const JSON_Value *value) {
+    char *chars = value->value.string.chars;
+    if (value->value.string.length && chars[0] == '\0') {
+        hex_encode(json_value_hex_bytes(value), value->value.string.length / 2, chars);
+    }
+}
+
 static const JSON_String * json_value_get_string_desc(const JSON_Value *value) {
-    return json_value_get_type(value) == JSONString ? &value->value.string : NULL;
+    if (json_value_get_type(value) != JSONString) {
+        return NULL;
+    }
+    if (value->hex) {
+        json_value_hex_to_string(value);
+    }
+    return &value->value.string;
 }
 
 const char * json_value_get_string(const JSON_Value *value) {
@@ -1414,14 +2166,26 @@ const char * json_value_get_string(const JSON_Value *value) {
 }
 
 size_t json_value_get_string_len(const JSON_Value *value) {
-    const JSON_String *str = json_value_get_string_desc(value);
-    return str ? str->length : 0;
+    if (json_value_get_type(value) != JSONString) {
+        return 0;
+    }
+    /* ACVP: the length of a hex value is known before it is encoded */
+    return value->value.string.length;
 }
 
 double json_value_get_number(const JSON_Value *value) {
     return json_value_get_type(value) == JSONNumber ? value->value.number : 0;
 }
 
+/* ACVP: 0 unless value is a whole number that fits, rather than a cast that may not */
+unsigned int json_value_get_uint(const JSON_Value *value) {
+    double num = json_value_get_number(value);
+    if (!(num > 0 && num <= UINT_MAX) || (double)(unsigned int)num < num) {
+        return 0;
+    }
+    return (unsigned int)num;
+}
+
 int json_value_get_boolean(const JSON_Value *value) {
     return json_value_get_type(value) == JSONBoolean ? value->value.boolean : -1;
 }
@@ -1436,7 +2200,9 @@ void json_value_free(JSON_Value *value) {
             json_object_free(value->value.object);
             break;
         case JSONString:
-            parson_free(value->value.string.chars);
+            if (!value->borrowed) {
+                parson_free(value->value.string.chars);
+            }
             break;
         case JSONArray:
             json_array_free(value->value.array);
@@ -1508,6 +2274,41 @@ JSON_Value * json_value_init_string_with_len(const char *string, size_t length)
     return value;
 }
 
+JSON_Value * json_value_init_string_take(char *string, size_t length) {
+    if (string == NULL || string[length] != '\0') {
+        return NULL;
+    }
+    if (!is_valid_utf8(string, length)) {
+        return NULL;
+    }
+    return json_value_init_string_no_copy(string, length);
+}
+
+JSON_Value * json_value_init_hex(const unsigned char *bytes, size_t length) {
+    JSON_Value *value = NULL;
+    char *copy = NULL;
+    if ((bytes == NULL && length) || length > ((size_t)-1 - 1) / 3) {
+        return NULL;
+    }
+    /* ACVP: room for the encoding and its terminator, then the bytes */
+    copy = (char*)parson_malloc(3 * length + 1);
+    if (copy == NULL) {
+        return NULL;
+    }
+    copy[0] = '\0';
+    copy[2 * length] = '\0';
+    if (length) {
+        memcpy_s(copy + 2 * length + 1, length, bytes, length); /* SAFEC */
+    }
+    value = json_value_init_string_no_copy(copy, 2 * length);
+    if (value == NULL) {
+        parson_free(copy);
+        return NULL;
+    }
+    value->hex = 1;
+    return value;
+}
+
 JSON_Value * json_value_init_number(double number) {
     JSON_Value *new_value = NULL;
     if (IS_NUMBER_INVALID(number)) {
@@ -1665,30 +2466,265 @@ JSON_Status json_serialize_to_file(const JSON_Value *value, const char *filename
     return return_code;
 }
 
-char * json_serialize_to_string(const JSON_Value *value, int *len) {
-    JSON_Status serialization_result = JSONFailure;
-    size_t buf_size_bytes = json_serialization_size(value);
-    char *buf = NULL;
-    if (buf_size_bytes == 0) {
-        return NULL;
+/*
+ * Streams the serialization of a value to a sink, either fp or a buffer
+ * that grows as it is written. Containers are walked here and only one
+ * string is ever escaped at a time, so large documents can be written out
+ * without a copy of the whole text, and a string is produced in a single
+ * walk of the value instead of one to size the buffer and one to fill it.
+ */
+static int json_sink_reserve(JSON_Sink *sink, size_t n) {
+    char *grown = NULL;
+    size_t cap = sink->cap ? sink->cap : 1024;
+
+    if (sink->len + n < sink->cap) {
+        return 0;
     }
-    if (len != NULL) {
-        /*
-         * The user wants to be provided with the string length
-         * Subtract by 1 to get string length (ommitting the added NULL byte).
-         */
-        *len = buf_size_bytes - 1;
+    while (sink->len + n >= cap) {
+        cap *= 2;
     }
-    buf = (char*)parson_malloc(buf_size_bytes);
-    if (buf == NULL) {
+    /* ACVP: serialized strings come from malloc(), applications free() some of them */
+    grown = (char*)malloc(cap);
+    if (grown == NULL) {
+        return -1;
+    }
+    if (sink->buf != NULL) {
+        memcpy_s(grown, cap, sink->buf, sink->len); /* SAFEC */
+        free(sink->buf);
+    }
+    sink->buf = grown;
+    sink->cap = cap;
+    return 0;
+}
+
+static int json_sink_write(JSON_Sink *sink, const char *string, size_t n) {
+    if (sink->fp != NULL) {
+        return fwrite(string, 1, n, sink->fp) == n ? 0 : -1;
+    }
+    if (json_sink_reserve(sink, n) < 0) {
+        return -1;
+    }
+    memcpy_s(sink->buf + sink->len, sink->cap - sink->len, string, n); /* SAFEC */
+    sink->len += n;
+    return 0;
+}
+
+static int json_sink_puts(JSON_Sink *sink, const char *string) {
+    return json_sink_write(sink, string, strnlen_s(string, STRING_VALUE_MAX)); /* SAFEC */
+}
+
+static int json_serialize_string_to_sink(const char *string, size_t len, JSON_Sink *sink) {
+    char tmp[256];
+    char *buf = tmp;
+    int written = json_serialize_string(string, len, NULL);
+
+    if (written < 0) {
+        return -1;
+    }
+    if (sink->fp == NULL) {
+        /* Escape it straight into the buffer */
+        if (json_sink_reserve(sink, (size_t)written) < 0) {
+            return -1;
+        }
+        json_serialize_string(string, len, sink->buf + sink->len);
+        sink->len += written;
+        return written;
+    }
+    if ((size_t)written >= sizeof(tmp)) {
+        buf = (char*)parson_malloc(written + 1);
+        if (buf == NULL) {
+            return -1;
+        }
+    }
+    json_serialize_string(string, len, buf);
+    if (json_sink_write(sink, buf, written) < 0) {
+        written = -1;
+    }
+    if (buf != tmp) {
+        parson_free(buf);
+    }
+    return written;
+}
+
+static int json_serialize_hex_to_sink(const JSON_Value *value, JSON_Sink *sink) {
+    const unsigned char *bytes = json_value_hex_bytes(value);
+    size_t len = value->value.string.length / 2, n = 0;
+    char tmp[256];
+
+    if (sink->fp == NULL) {
+        if (json_sink_reserve(sink, 2 * len + 2) < 0) {
+            return -1;
+        }
+        sink->len += json_serialize_hex(bytes, len, sink->buf + sink->len);
+        return 0;
+    }
+    if (json_sink_write(sink, "\"", 1) < 0) {
+        return -1;
+    }
+    while (len) {
+        n = len < sizeof(tmp) / 2 ? len : sizeof(tmp) / 2;
+        hex_encode(bytes, n, tmp);
+        if (json_sink_write(sink, tmp, 2 * n) < 0) {
+            return -1;
+        }
+        bytes += n;
+        len -= n;
+    }
+    return json_sink_write(sink, "\"", 1);
+}
+
+static int json_sink_indent(JSON_Sink *sink, int level) {
+    int i;
+    for (i = 0; i < level; i++) {
+        if (json_sink_write(sink, "    ", 4) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int json_serialize_to_sink_r(const JSON_Value *value, JSON_Sink *sink, int level, int is_pretty, char *num_buf) {
+    const char *key = NULL, *string = NULL;
+    JSON_Array *array = NULL;
+    JSON_Object *object = NULL;
+    size_t i = 0, count = 0;
+
+    switch (json_value_get_type(value)) {
+        case JSONArray:
+            array = json_value_get_array(value);
+            count = json_array_get_count(array);
+            if (json_sink_puts(sink, count > 0 && is_pretty ? "[\n" : "[") < 0) {
+                return -1;
+            }
+            for (i = 0; i < count; i++) {
+                if (is_pretty && json_sink_indent(sink, level+1) < 0) {
+                    return -1;
+                }
+                if (json_serialize_to_sink_r(json_array_get_value(array, i), sink, level+1, is_pretty, num_buf) < 0) {
+                    return -1;
+                }
+                if (i < (count - 1) && json_sink_write(sink, ",", 1) < 0) {
+                    return -1;
+                }
+                if (is_pretty && json_sink_write(sink, "\n", 1) < 0) {
+                    return -1;
+                }
+            }
+            if (count > 0 && is_pretty && json_sink_indent(sink, level) < 0) {
+                return -1;
+            }
+            return json_sink_write(sink, "]", 1);
+        case JSONObject:
+            object = json_value_get_object(value);
+            count  = json_object_get_count(object);
+            if (json_sink_puts(sink, count > 0 && is_pretty ? "{\n" : "{") < 0) {
+                return -1;
+            }
+            for (i = 0; i < count; i++) {
+                key = json_object_get_name(object, i);
+                if (key == NULL) {
+                    return -1;
+                }
+                if (is_pretty && json_sink_indent(sink, level+1) < 0) {
+                    return -1;
+                }
+                if (json_serialize_string_to_sink(key, strnlen_s(key, STRING_NAME_MAX), sink) < 0 ||
+                        json_sink_puts(sink, is_pretty ? ": " : ":") < 0) {
+                    return -1;
+                }
+                if (json_serialize_to_sink_r(json_object_get_value_at(object, i), sink, level+1, is_pretty, num_buf) < 0) {
+                    return -1;
+                }
+                if (i < (count - 1) && json_sink_write(sink, ",", 1) < 0) {
+                    return -1;
+                }
+                if (is_pretty && json_sink_write(sink, "\n", 1) < 0) {
+                    return -1;
+                }
+            }
+            if (count > 0 && is_pretty && json_sink_indent(sink, level) < 0) {
+                return -1;
+            }
+            return json_sink_write(sink, "}", 1);
+        case JSONString:
+            if (value->hex) {
+                return json_serialize_hex_to_sink(value, sink);
+            }
+            string = json_value_get_string(value);
+            if (string == NULL) {
+                return -1;
+            }
+            return json_serialize_string_to_sink(string, json_value_get_string_len(value), sink) < 0 ? -1 : 0;
+        case JSONBoolean:
+            return json_sink_puts(sink, json_value_get_boolean(value) ? "true" : "false");
+        case JSONNumber:
+            if (serialize_number(json_value_get_number(value), num_buf) < 0) {
+                return -1;
+            }
+            return json_sink_puts(sink, num_buf);
+        case JSONNull:
+            return json_sink_write(sink, "null", 4);
+        default:
+            return -1;
+    }
+}
+
+/*
+ * Serializes value into a buffer that is grown as needed, see
+ * json_serialize_to_sink_r(), handing the buffer to the caller.
+ */
+static char * json_serialize_to_string_r(const JSON_Value *value, int is_pretty, int *len) {
+    char num_buf[NUM_BUF_SIZE];
+    JSON_Sink sink;
+
+    if (value == NULL) {
         return NULL;
     }
-    serialization_result = json_serialize_to_buffer(value, buf, buf_size_bytes);
-    if (serialization_result == JSONFailure) {
-        json_free_serialized_string(buf);
+    memset(&sink, 0, sizeof(sink));
+    if (json_sink_reserve(&sink, 0) < 0) {
         return NULL;
     }
-    return buf;
+    if (json_serialize_to_sink_r(value, &sink, 0, is_pretty, num_buf) < 0) {
+        free(sink.buf);
+        return NULL;
+    }
+    sink.buf[sink.len] = '\0';
+    if (len != NULL) {
+        *len = (int)sink.len;
+    }
+    return sink.buf;
+}
+
+JSON_Status json_serialize_to_fp(const JSON_Value *value, FILE *fp) {
+    char num_buf[NUM_BUF_SIZE];
+    JSON_Sink sink;
+    if (value == NULL || fp == NULL) {
+        return JSONFailure;
+    }
+    memset(&sink, 0, sizeof(sink));
+    sink.fp = fp;
+    if (json_serialize_to_sink_r(value, &sink, 0, 0, num_buf) < 0) {
+        return JSONFailure;
+    }
+    return JSONSuccess;
+}
+
+JSON_Status json_serialize_to_fp_pretty(const JSON_Value *value, FILE *fp) {
+    char num_buf[NUM_BUF_SIZE];
+    JSON_Sink sink;
+    if (value == NULL || fp == NULL) {
+        return JSONFailure;
+    }
+    memset(&sink, 0, sizeof(sink));
+    sink.fp = fp;
+    if (json_serialize_to_sink_r(value, &sink, 0, 1, num_buf) < 0) {
+        return JSONFailure;
+    }
+    return JSONSuccess;
+}
+
+char * json_serialize_to_string(const JSON_Value *value, int *len) {
+    return json_serialize_to_string_r(value, 0, len);
 }
 
 size_t json_serialization_size_pretty(const JSON_Value *value) {
@@ -1733,33 +2769,11 @@ JSON_Status json_serialize_to_file_pretty(const JSON_Value *value, const char *f
 }
 
 char * json_serialize_to_string_pretty(const JSON_Value *value, int *len) {
-    JSON_Status serialization_result = JSONFailure;
-    size_t buf_size_bytes = json_serialization_size_pretty(value);
-    char *buf = NULL;
-    if (buf_size_bytes == 0) {
-        return NULL;
-    }
-    if (len != NULL) {
-        /*
-         * The user wants to be provided with the string length
-         * Subtract by 1 to get string length (ommitting the added NULL byte).
-         */
-        *len = buf_size_bytes - 1;
-    }
-    buf = (char*)parson_malloc(buf_size_bytes);
-    if (buf == NULL) {
-        return NULL;
-    }
-    serialization_result = json_serialize_to_buffer_pretty(value, buf, buf_size_bytes);
-    if (serialization_result == JSONFailure) {
-        json_free_serialized_string(buf);
-        return NULL;
-    }
-    return buf;
+    return json_serialize_to_string_r(value, 1, len);
 }
 
 void json_free_serialized_string(char *string) {
-    parson_free(string);
+    free(string); /* ACVP: see json_sink_reserve() */
 }
 
 #if 0 /* Removed, does not currently comply with SAFEC */
@@ -1777,7 +2791,8 @@ JSON_Status json_array_remove(JSON_Array *array, size_t ix) {
 #endif
 
 JSON_Status json_array_replace_value(JSON_Array *array, size_t ix, JSON_Value *value) {
-    if (array == NULL || value == NULL || value->parent != NULL || ix >= json_array_get_count(array)) {
+    if (array == NULL || value == NULL || value->parent != NULL || ix >= json_array_get_count(array) ||
+            array->spans != NULL) {
         return JSONFailure;
     }
     json_value_free(json_array_get_value(array, ix));
@@ -1848,7 +2863,7 @@ JSON_Status json_array_replace_null(JSON_Array *array, size_t i) {
 
 JSON_Status json_array_clear(JSON_Array *array) {
     size_t i = 0;
-    if (array == NULL) {
+    if (array == NULL || array->spans != NULL) {
         return JSONFailure;
     }
     for (i = 0; i < json_array_get_count(array); i++) {
@@ -1858,6 +2873,16 @@ JSON_Status json_array_clear(JSON_Array *array) {
     return JSONSuccess;
 }
 
+JSON_Status json_array_reserve(JSON_Array *array, size_t capacity) {
+    if (array == NULL || array->spans != NULL) {
+        return JSONFailure;
+    }
+    if (capacity <= array->capacity) {
+        return JSONSuccess;
+    }
+    return json_array_resize(array, capacity);
+}
+
 JSON_Status json_array_append_value(JSON_Array *array, JSON_Value *value) {
     if (array == NULL || value == NULL || value->parent != NULL) {
         return JSONFailure;
@@ -1926,26 +2951,20 @@ JSON_Status json_array_append_null(JSON_Array *array) {
 }
 
 JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Value *value) {
-    size_t i = 0;
-    JSON_Value *old_value;
+    size_t i = 0, name_len = 0;
     if (object == NULL || name == NULL || value == NULL || value->parent != NULL) {
         return JSONFailure;
     }
-    old_value = json_object_get_value(object, name);
-    if (old_value != NULL) { /* free and overwrite old value */
-        json_value_free(old_value);
-        for (i = 0; i < json_object_get_count(object); i++) {
-            int diff = 1;
-            strcmp_s(object->names[i], STRING_NAME_MAX, name, &diff); /* SAFEC */
-            if (!diff) {
-                value->parent = json_object_get_wrapping_value(object);
-                object->values[i] = value;
-                return JSONSuccess;
-            }
-        }
+    name_len = strnlen_s(name, STRING_NAME_MAX); /* SAFEC */
+    i = json_object_find(object, name, name_len, json_name_hash(name, name_len));
+    if (i != OBJECT_NOT_FOUND) { /* free and overwrite old value */
+        json_value_free(object->values[i]);
+        value->parent = json_object_get_wrapping_value(object);
+        object->values[i] = value;
+        return JSONSuccess;
     }
     /* add new key value pair */
-    return json_object_add(object, name, value);
+    return json_object_addn(object, name, name_len, value);
 }
 
 JSON_Status json_object_set_string(JSON_Object *object, const char *name, const char *string) {
@@ -1966,6 +2985,15 @@ JSON_Status json_object_set_string_with_len(JSON_Object *object, const char *nam
     return status;
 }
 
+JSON_Status json_object_set_hex(JSON_Object *object, const char *name, const unsigned char *bytes, size_t length) {
+    JSON_Value *value = json_value_init_hex(bytes, length);
+    JSON_Status status = json_object_set_value(object, name, value);
+    if (status == JSONFailure) {
+        json_value_free(value);
+    }
+    return status;
+}
+
 JSON_Status json_object_set_number(JSON_Object *object, const char *name, double number) {
     JSON_Value *value = json_value_init_number(number);
     JSON_Status status = json_object_set_value(object, name, value);
@@ -2131,10 +3159,11 @@ JSON_Status json_object_clear(JSON_Object *object) {
         return JSONFailure;
     }
     for (i = 0; i < json_object_get_count(object); i++) {
-        parson_free(object->names[i]);
+        json_name_free(object->names[i]);
         json_value_free(object->values[i]);
     }
     object->count = 0;
+    json_object_index_rebuild(object);
     return JSONSuccess;
 }
 
@@ -0,0 +1,904 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * Micro-benchmarks for the hot paths of libacvp: the hex codec, parson
+ * parse/serialize of the vector sets in json/, and the KAT handlers (AFT and
+ * MCT groups separately) against a crypto handler that does nothing, so only
+ * the library's own work is measured.
+ *
+ * Build and run with "make bench" from the top or test directory, which runs
+ * this from the test directory. Iteration counts are fixed so numbers can be
+ * compared from one build to the next; pass -s to scale them (e.g. -s 10 for
+ * steadier numbers, -s 0.1 for a quick smoke run) and a substring to run only
+ * the matching benchmarks, and -r to run each several rounds and keep the
+ * fastest. Each reports the bytes allocated per iteration too (glibc only),
+ * and the KAT handlers the test cases done a second.
+ *
+ * There is a benchmark for the KAT handler of every family with a vector set
+ * in json/; "make bench-check" runs them all and compares them against the
+ * baseline in bench_baseline.txt (see bench_check()), failing on a slowdown
+ * or an allocation growth past the tolerance.
+ *
+ * With -f, a whole request file is run instead, such as one written by
+ * acvp_vs_gen: acvp_run_vectors_from_file() on it, the ciphers of its vector
+ * sets enabled as they come against the same crypto handler that does nothing
+ * (see bench_cap_loader()), and the responses written to the file given to -o.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "acvp/acvp.h"
+#include "acvp/acvp_lcl.h"
+#include "safe_lib.h"
+
+#define BENCH_HEX_LEN (64 * 1024)
+
+typedef struct bench_vs_t {
+    const char *file;
+    char *text;            /* File contents */
+    JSON_Value *val;        /* Parsed file, the vector set is its second entry */
+} BENCH_VS;
+
+typedef struct bench_t {
+    const char *name;
+    void (*func)(struct bench_t *b);
+    unsigned int iters;     /* Iterations at scale 1 */
+    BENCH_VS *vs;
+    const char *test_type;  /* Only keep test groups of this testType, if set */
+    ACVP_RESULT (*handler)(ACVP_CTX *ctx, JSON_Object *obj); /* Looked up by algorithm if NULL */
+    unsigned long long int bytes; /* Bytes processed per iteration, for the throughput */
+    unsigned long long int cases; /* Test cases per iteration, for the KAT handlers */
+    unsigned int run_iters; /* Results, of the fastest round */
+    unsigned long long int ns;
+    double us;              /* Time and allocations per iteration */
+    double alloc;
+    int done;               /* 1 once run, -1 if it failed */
+} BENCH;
+
+typedef struct bench_base_t {
+    char name[32];
+    double us;
+    double alloc;
+} BENCH_BASE;
+
+#define BENCH_BASE_MAX 128
+#define BENCH_TIME_TOLERANCE_PCT 50
+#define BENCH_ALLOC_TOLERANCE_PCT 5
+
+static ACVP_CTX *ctx = NULL;
+static double scale = 1.0;
+
+static BENCH_VS hash_vs = { "json/hash/hash.json", NULL, NULL };
+static BENCH_VS aes_vs = { "json/aes/aes.json", NULL, NULL };
+static BENCH_VS des_vs = { "json/des/des.json", NULL, NULL };
+static BENCH_VS aes_xts_vs = { "json/aes/aes_xts.json", NULL, NULL };
+static BENCH_VS hmac_vs = { "json/hmac/hmac1.json", NULL, NULL };
+static BENCH_VS cmac_aes_vs = { "json/cmac/cmac_aes.json", NULL, NULL };
+static BENCH_VS cmac_tdes_vs = { "json/cmac/cmac_tdes.json", NULL, NULL };
+static BENCH_VS kmac_vs = { "json/kmac/kmac.json", NULL, NULL };
+static BENCH_VS drbg_vs = { "json/drbg/drbg.json", NULL, NULL };
+static BENCH_VS dsa_keygen_vs = { "json/dsa/dsa_keygen1.json", NULL, NULL };
+static BENCH_VS dsa_pqggen_vs = { "json/dsa/dsa_pqggen1.json", NULL, NULL };
+static BENCH_VS dsa_pqgver_vs = { "json/dsa/dsa_pqgver1.json", NULL, NULL };
+static BENCH_VS dsa_siggen_vs = { "json/dsa/dsa_siggen1.json", NULL, NULL };
+static BENCH_VS dsa_sigver_vs = { "json/dsa/dsa_sigver1.json", NULL, NULL };
+static BENCH_VS rsa_keygen_vs = { "json/rsa/rsa_keygen.json", NULL, NULL };
+static BENCH_VS rsa_siggen_vs = { "json/rsa/rsa_siggen.json", NULL, NULL };
+static BENCH_VS rsa_sigver_vs = { "json/rsa/rsa_sigver.json", NULL, NULL };
+static BENCH_VS rsa_decprim_vs = { "json/rsa/rsa_decprim.json", NULL, NULL };
+static BENCH_VS rsa_sigprim_vs = { "json/rsa/rsa_sigprim.json", NULL, NULL };
+static BENCH_VS ecdsa_keygen_vs = { "json/ecdsa/ecdsa_keygen.json", NULL, NULL };
+static BENCH_VS ecdsa_keyver_vs = { "json/ecdsa/ecdsa_keyver.json", NULL, NULL };
+static BENCH_VS ecdsa_siggen_vs = { "json/ecdsa/ecdsa_siggen.json", NULL, NULL };
+static BENCH_VS ecdsa_sigver_vs = { "json/ecdsa/ecdsa_sigver.json", NULL, NULL };
+static BENCH_VS kas_ecc_cdh_vs = { "json/kas_ecc/kas_ecc_cdh.json", NULL, NULL };
+static BENCH_VS kas_ecc_comp_vs = { "json/kas_ecc/kas_ecc_comp.json", NULL, NULL };
+static BENCH_VS kas_ecc_ssc_vs = { "json/kas_ecc/kas_ecc_ssc.json", NULL, NULL };
+static BENCH_VS kas_ffc_comp_vs = { "json/kas_ffc/kas_ffc_comp.json", NULL, NULL };
+static BENCH_VS kas_ffc_ssc_vs = { "json/kas_ffc/kas_ffc_ssc.json", NULL, NULL };
+static BENCH_VS kas_ifc_ssc_vs = { "json/kas_ifc/kas_ifc_ssc.json", NULL, NULL };
+static BENCH_VS kts_ifc_vs = { "json/kts_ifc/kts_ifc.json", NULL, NULL };
+static BENCH_VS kda_vs = { "json/kda/kda.json", NULL, NULL };
+static BENCH_VS kdf108_vs = { "json/kdf108/kdf108.json", NULL, NULL };
+static BENCH_VS ikev1_vs = { "json/kdf135_ikev1/kdf135_ikev1.json", NULL, NULL };
+static BENCH_VS ikev2_vs = { "json/kdf135_ikev2/kdf135_ikev2.json", NULL, NULL };
+static BENCH_VS snmp_vs = { "json/kdf135_snmp/kdf135_snmp.json", NULL, NULL };
+static BENCH_VS srtp_vs = { "json/kdf135_srtp/kdf135_srtp.json", NULL, NULL };
+static BENCH_VS ssh_vs = { "json/kdf135_ssh/kdf135_ssh1.json", NULL, NULL };
+static BENCH_VS tls12_vs = { "json/kdf_tls12/tls12.json", NULL, NULL };
+static BENCH_VS tls13_vs = { "json/kdf_tls13/tls13.json", NULL, NULL };
+static BENCH_VS pbkdf_vs = { "json/pbkdf/pbkdf.json", NULL, NULL };
+static BENCH_VS safe_primes_vs = { "json/safe_primes/safe_primes.json", NULL, NULL };
+
+#ifdef __GLIBC__
+/*
+ * Counts the bytes asked of the allocator by the whole process, the library
+ * included, these taking the place of the libc ones
+ */
+#define BENCH_ALLOC_COUNTED 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static unsigned long long int alloc_bytes = 0;
+
+void *malloc(size_t size) {
+    __atomic_add_fetch(&alloc_bytes, size, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    __atomic_add_fetch(&alloc_bytes, nmemb * size, __ATOMIC_RELAXED);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    __atomic_add_fetch(&alloc_bytes, size, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+static unsigned long long int bench_allocated(void) {
+    return __atomic_load_n(&alloc_bytes, __ATOMIC_RELAXED);
+}
+#else
+static unsigned long long int bench_allocated(void) {
+    return 0;
+}
+#endif
+
+static unsigned long long int alloc_mark = 0;
+
+static int bench_null_handler(ACVP_TEST_CASE *test_case) {
+    return 0;
+}
+
+/* The RSA decryption primitive handler loops until a case is marked passed or failed */
+static int bench_rsa_prim_handler(ACVP_TEST_CASE *test_case) {
+    test_case->tc.rsa_prim->pass++;
+    return 0;
+}
+
+static ACVP_RESULT bench_quiet(char *msg, ACVP_LOG_LVL level) {
+    return ACVP_SUCCESS;
+}
+
+static char *bench_read_file(const char *file) {
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long len = 0;
+
+    fp = fopen(file, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    if (!fseek(fp, 0, SEEK_END) && (len = ftell(fp)) > 0 && !fseek(fp, 0, SEEK_SET)) {
+        buf = calloc((size_t)len + 1, 1);
+        if (buf && fread(buf, 1, (size_t)len, fp) != (size_t)len) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+    fclose(fp);
+    return buf;
+}
+
+static int bench_load_vs(BENCH_VS *vs) {
+    if (vs->val) {
+        return 1;
+    }
+    vs->text = bench_read_file(vs->file);
+    if (vs->text) {
+        vs->val = json_parse_string(vs->text);
+    }
+    if (!vs->val) {
+        printf("Unable to load %s (run from the test directory)\n", vs->file);
+        return 0;
+    }
+    return 1;
+}
+
+/* Marks the start of the timed part of a benchmark */
+static unsigned long long int bench_start(void) {
+    alloc_mark = bench_allocated();
+    return acvp_metrics_now();
+}
+
+/* Keeps the results of a round of a benchmark, if the fastest yet */
+static void bench_report(BENCH *b, unsigned int iters, unsigned long long int ns) {
+    if (b->done > 0 && ns >= b->ns) {
+        return;
+    }
+    b->run_iters = iters;
+    b->ns = ns;
+    b->us = (double)ns / 1e3 / iters;
+    b->alloc = (double)(bench_allocated() - alloc_mark) / iters;
+    b->done = 1;
+}
+
+static void bench_print(const BENCH *b) {
+    double secs = (double)b->ns / 1e9;
+
+    printf("%-22s %8u %12.3f %12.3f", b->name, b->run_iters, (double)b->ns / 1e6, b->us);
+    if (b->bytes) {
+        printf(" %10.1f", (double)b->bytes * b->run_iters / 1e6 / secs);
+    } else {
+        printf(" %10s", "-");
+    }
+    if (b->cases) {
+        printf(" %10.0f", (double)b->cases * b->run_iters / secs);
+    } else {
+        printf(" %10s", "-");
+    }
+#ifdef BENCH_ALLOC_COUNTED
+    printf(" %12.0f", b->alloc);
+#else
+    printf(" %12s", "-");
+#endif
+    printf("\n");
+}
+
+static unsigned int bench_iters(BENCH *b) {
+    unsigned int iters = (unsigned int)(b->iters * scale);
+
+    return iters ? iters : 1;
+}
+
+/*
+ * Work that does not involve the library, to tell how fast the machine is
+ * running at the time: bench_check() scales the baseline by it
+ */
+static void bench_calibrate(BENCH *b) {
+    static unsigned char buf[BENCH_HEX_LEN];
+    unsigned long long int start = 0, h = 1469598103934665603ULL;
+    unsigned int i = 0, j = 0, iters = bench_iters(b);
+
+    start = bench_start();
+    for (i = 0; i < iters; i++) {
+        for (j = 0; j < BENCH_HEX_LEN; j++) {
+            h = (h ^ buf[j]) * 1099511628211ULL;
+            buf[j] = (unsigned char)(h >> 32);
+        }
+    }
+    bench_report(b, iters, acvp_metrics_now() - start);
+}
+
+static void bench_hex_to_bin(BENCH *b) {
+    static char hex[BENCH_HEX_LEN * 2 + 1];
+    static unsigned char bin[BENCH_HEX_LEN];
+    unsigned long long int start = 0;
+    unsigned int i = 0, iters = bench_iters(b);
+    int len = 0;
+
+    for (i = 0; i < BENCH_HEX_LEN; i++) {
+        bin[i] = (unsigned char)(i * 131 + 7);
+    }
+    acvp_bin_to_hexstr(bin, BENCH_HEX_LEN, hex, sizeof(hex) - 1);
+    b->bytes = BENCH_HEX_LEN * 2;
+
+    start = bench_start();
+    for (i = 0; i < iters; i++) {
+        acvp_hexstr_to_bin(hex, bin, BENCH_HEX_LEN, &len);
+    }
+    bench_report(b, iters, acvp_metrics_now() - start);
+}
+
+static void bench_bin_to_hex(BENCH *b) {
+    static char hex[BENCH_HEX_LEN * 2 + 1];
+    static unsigned char bin[BENCH_HEX_LEN];
+    unsigned long long int start = 0;
+    unsigned int i = 0, iters = bench_iters(b);
+
+    for (i = 0; i < BENCH_HEX_LEN; i++) {
+        bin[i] = (unsigned char)(i * 131 + 7);
+    }
+    b->bytes = BENCH_HEX_LEN;
+
+    start = bench_start();
+    for (i = 0; i < iters; i++) {
+        acvp_bin_to_hexstr(bin, BENCH_HEX_LEN, hex, sizeof(hex) - 1);
+    }
+    bench_report(b, iters, acvp_metrics_now() - start);
+}
+
+static void bench_json_parse(BENCH *b) {
+    unsigned long long int start = 0;
+    unsigned int i = 0, iters = bench_iters(b);
+
+    if (!bench_load_vs(b->vs)) {
+        return;
+    }
+    b->bytes = strnlen_s(b->vs->text, RSIZE_MAX_STR);
+
+    start = bench_start();
+    for (i = 0; i < iters; i++) {
+        json_value_free(json_parse_string(b->vs->text));
+    }
+    bench_report(b, iters, acvp_metrics_now() - start);
+}
+
+static void bench_json_serialize(BENCH *b) {
+    unsigned long long int start = 0;
+    unsigned int i = 0, iters = bench_iters(b);
+    char *text = NULL;
+
+    if (!bench_load_vs(b->vs)) {
+        return;
+    }
+    b->bytes = json_serialization_size(b->vs->val);
+
+    start = bench_start();
+    for (i = 0; i < iters; i++) {
+        text = json_serialize_to_string(b->vs->val, NULL);
+        json_free_serialized_string(text);
+    }
+    bench_report(b, iters, acvp_metrics_now() - start);
+}
+
+static ACVP_RESULT bench_sym_enable(ACVP_CTX *ctx, ACVP_CIPHER cipher) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    rv = acvp_cap_sym_cipher_enable(ctx, cipher, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, cipher, ACVP_SYM_CIPH_PARM_DIR, ACVP_SYM_CIPH_DIR_BOTH);
+    if (rv != ACVP_SUCCESS) return rv;
+    if (cipher >= ACVP_TDES_ECB) {
+        return acvp_cap_sym_cipher_set_parm(ctx, cipher, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
+    }
+    rv = acvp_cap_sym_cipher_set_parm(ctx, cipher, ACVP_SYM_CIPH_KEYLEN, 128);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, cipher, ACVP_SYM_CIPH_KEYLEN, 192);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, cipher, ACVP_SYM_CIPH_KEYLEN, 256);
+    if (rv != ACVP_SUCCESS || cipher != ACVP_AES_GCM) return rv;
+    return acvp_cap_sym_cipher_set_parm(ctx, cipher, ACVP_SYM_CIPH_PARM_IVGEN_SRC, ACVP_SYM_CIPH_IVGEN_SRC_EXT);
+}
+
+/*
+ * Enables a cipher against the crypto handler that does nothing, with the
+ * parameters its KAT handler reads; the ones that need none are just enabled
+ */
+static ACVP_RESULT bench_cap_loader(ACVP_CTX *ctx, ACVP_CIPHER cipher, void *arg) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (cipher >= ACVP_AES_GCM && cipher <= ACVP_TDES_KW) {
+        return bench_sym_enable(ctx, cipher);
+    }
+    if (cipher >= ACVP_HASH_SHA1 && cipher <= ACVP_HASH_SHAKE_256) {
+        return acvp_cap_hash_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_HASHDRBG && cipher <= ACVP_CTRDRBG) {
+        return acvp_cap_drbg_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_HMAC_SHA1 && cipher <= ACVP_HMAC_SHA3_512) {
+        return acvp_cap_hmac_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher == ACVP_CMAC_AES || cipher == ACVP_CMAC_TDES) {
+        return acvp_cap_cmac_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher == ACVP_KMAC_128 || cipher == ACVP_KMAC_256) {
+        return acvp_cap_kmac_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_DSA_KEYGEN && cipher <= ACVP_DSA_SIGVER) {
+        return acvp_cap_dsa_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher == ACVP_RSA_KEYGEN) {
+        return acvp_cap_rsa_keygen_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher == ACVP_RSA_SIGGEN || cipher == ACVP_RSA_SIGVER) {
+        return acvp_cap_rsa_sig_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher == ACVP_RSA_DECPRIM || cipher == ACVP_RSA_SIGPRIM) {
+        return acvp_cap_rsa_prim_enable(ctx, cipher, &bench_rsa_prim_handler);
+    }
+    if (cipher >= ACVP_ECDSA_KEYGEN && cipher <= ACVP_DET_ECDSA_SIGGEN) {
+        return acvp_cap_ecdsa_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_EDDSA_KEYGEN && cipher <= ACVP_EDDSA_SIGVER) {
+        return acvp_cap_eddsa_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_KAS_ECC_CDH && cipher <= ACVP_KAS_ECC_SSC) {
+        return acvp_cap_kas_ecc_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_KAS_FFC_COMP && cipher <= ACVP_KAS_FFC_SSC) {
+        return acvp_cap_kas_ffc_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_KDA_ONESTEP && cipher <= ACVP_KDA_HKDF) {
+        /* The handler takes only the derived key length registered, that of json/kda */
+        rv = acvp_cap_kda_enable(ctx, cipher, &bench_null_handler);
+        if (rv != ACVP_SUCCESS) return rv;
+        return acvp_cap_kda_set_parm(ctx, cipher, ACVP_KDA_L, 2048, NULL);
+    }
+    if (cipher == ACVP_SAFE_PRIMES_KEYGEN || cipher == ACVP_SAFE_PRIMES_KEYVER) {
+        return acvp_cap_safe_primes_enable(ctx, cipher, &bench_null_handler);
+    }
+    if (cipher >= ACVP_LMS_KEYGEN && cipher <= ACVP_LMS_SIGVER) {
+        return acvp_cap_lms_enable(ctx, cipher, &bench_null_handler);
+    }
+
+    switch (cipher) {
+    case ACVP_KDF135_SNMP:
+        return acvp_cap_kdf135_snmp_enable(ctx, &bench_null_handler);
+    case ACVP_KDF135_SSH:
+        return acvp_cap_kdf135_ssh_enable(ctx, &bench_null_handler);
+    case ACVP_KDF135_SRTP:
+        return acvp_cap_kdf135_srtp_enable(ctx, &bench_null_handler);
+    case ACVP_KDF135_IKEV2:
+        return acvp_cap_kdf135_ikev2_enable(ctx, &bench_null_handler);
+    case ACVP_KDF135_IKEV1:
+        return acvp_cap_kdf135_ikev1_enable(ctx, &bench_null_handler);
+    case ACVP_KDF135_X942:
+        return acvp_cap_kdf135_x942_enable(ctx, &bench_null_handler);
+    case ACVP_KDF135_X963:
+        return acvp_cap_kdf135_x963_enable(ctx, &bench_null_handler);
+    case ACVP_KDF108:
+        return acvp_cap_kdf108_enable(ctx, &bench_null_handler);
+    case ACVP_PBKDF:
+        return acvp_cap_pbkdf_enable(ctx, &bench_null_handler);
+    case ACVP_KDF_TLS12:
+        return acvp_cap_kdf_tls12_enable(ctx, &bench_null_handler);
+    case ACVP_KDF_TLS13:
+        return acvp_cap_kdf_tls13_enable(ctx, &bench_null_handler);
+    case ACVP_KAS_IFC_SSC:
+        return acvp_cap_kas_ifc_enable(ctx, cipher, &bench_null_handler);
+    case ACVP_KTS_IFC:
+        return acvp_cap_kts_ifc_enable(ctx, cipher, &bench_null_handler);
+    default:
+        return ACVP_UNSUPPORTED_OP;
+    }
+}
+
+/*
+ * The vector set of the benchmark, keeping only the test groups of
+ * b->test_type when that is set.
+ */
+static JSON_Value *bench_vector_set(BENCH *b) {
+    JSON_Value *val = NULL, *groups_val = NULL;
+    JSON_Object *obj = NULL, *group = NULL;
+    JSON_Array *groups = NULL;
+    const char *type = NULL;
+    size_t i = 0;
+    int diff = 1;
+
+    val = json_value_deep_copy(json_array_get_value(json_value_get_array(b->vs->val), 1));
+    if (!val) {
+        return NULL;
+    }
+    obj = json_value_get_object(val);
+    groups = json_object_get_array(obj, "testGroups");
+    b->cases = 0;
+    if (!b->test_type) {
+        for (i = 0; i < json_array_get_count(groups); i++) {
+            b->cases += json_array_get_count(json_object_get_array(json_array_get_object(groups, i), "tests"));
+        }
+        return val;
+    }
+    groups_val = json_value_init_array();
+    for (i = 0; i < json_array_get_count(groups); i++) {
+        group = json_array_get_object(groups, i);
+        type = json_object_get_string(group, "testType");
+        diff = 1;
+        if (type) {
+            strcmp_s(b->test_type, strnlen_s(b->test_type, 8), type, &diff);
+        }
+        if (!diff) {
+            json_array_append_value(json_value_get_array(groups_val),
+                                    json_value_deep_copy(json_array_get_value(groups, i)));
+            b->cases += json_array_get_count(json_object_get_array(group, "tests"));
+        }
+    }
+    json_object_set_value(obj, "testGroups", groups_val);
+    return val;
+}
+
+/*
+ * The KAT handler of the algorithm of a vector set, as acvp_run_vectors_from_file()
+ * would pick it, its cipher being enabled if it is not yet
+ */
+static ACVP_RESULT bench_lookup_handler(BENCH *b, JSON_Object *obj) {
+    const ACVP_ALG_HANDLER *alg = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    alg = acvp_lookup_alg_handler(json_object_get_string(obj, "algorithm"),
+                                  json_object_get_string(obj, "mode"));
+    if (!alg || !alg->handler) {
+        return ACVP_UNSUPPORTED_OP;
+    }
+    if (!acvp_locate_cap_entry(ctx, alg->cipher)) {
+        rv = bench_cap_loader(ctx, alg->cipher, NULL);
+        if (rv != ACVP_SUCCESS) {
+            return rv;
+        }
+    }
+    b->handler = alg->handler;
+    return ACVP_SUCCESS;
+}
+
+static void bench_kat_handler(BENCH *b) {
+    JSON_Value *val = NULL;
+    unsigned long long int start = 0, ns = 0;
+    unsigned int i = 0, iters = bench_iters(b);
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    if (!bench_load_vs(b->vs)) {
+        return;
+    }
+    val = bench_vector_set(b);
+    if (!val) {
+        printf("%-22s unable to build the vector set\n", b->name);
+        return;
+    }
+    if (!b->handler) {
+        rv = bench_lookup_handler(b, json_value_get_object(val));
+        if (rv != ACVP_SUCCESS) {
+            printf("%-22s unable to enable the KAT handler (%d)\n", b->name, rv);
+            b->done = -1;
+            json_value_free(val);
+            return;
+        }
+    }
+
+    /* One untimed run first, so what the library caches is not counted */
+    rv = (b->handler)(ctx, json_value_get_object(val));
+    json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+
+    alloc_mark = bench_allocated();
+    for (i = 0; i < iters && rv == ACVP_SUCCESS; i++) {
+        start = acvp_metrics_now();
+        rv = (b->handler)(ctx, json_value_get_object(val));
+        ns += acvp_metrics_now() - start;
+        json_value_free(ctx->exec.kat_resp);
+        ctx->exec.kat_resp = NULL;
+    }
+    json_value_free(val);
+    if (rv != ACVP_SUCCESS) {
+        printf("%-22s handler failed (%d)\n", b->name, rv);
+        b->done = -1;
+        return;
+    }
+    bench_report(b, iters, ns);
+}
+
+static BENCH benches[] = {
+    { "calibrate",           bench_calibrate,      100,  NULL,             NULL,  NULL },
+    { "hex_to_bin",          bench_hex_to_bin,     2000, NULL,             NULL,  NULL },
+    { "bin_to_hex",          bench_bin_to_hex,     2000, NULL,             NULL,  NULL },
+    { "json_parse_hash",     bench_json_parse,     100,  &hash_vs,         NULL,  NULL },
+    { "json_parse_aes",      bench_json_parse,     100,  &aes_vs,          NULL,  NULL },
+    { "json_parse_des",      bench_json_parse,     100,  &des_vs,          NULL,  NULL },
+    { "json_serialize_hash", bench_json_serialize, 100,  &hash_vs,         NULL,  NULL },
+    { "json_serialize_aes",  bench_json_serialize, 100,  &aes_vs,          NULL,  NULL },
+    { "json_serialize_des",  bench_json_serialize, 100,  &des_vs,          NULL,  NULL },
+    { "kat_hash_aft",        bench_kat_handler,    100,  &hash_vs,         "AFT", acvp_hash_kat_handler },
+    { "kat_aes_aft",         bench_kat_handler,    100,  &aes_vs,          "AFT", acvp_aes_kat_handler },
+    { "kat_des_aft",         bench_kat_handler,    100,  &des_vs,          "AFT", acvp_des_kat_handler },
+    { "mct_hash",            bench_kat_handler,    100,  &hash_vs,         "MCT", acvp_hash_kat_handler },
+    { "mct_aes",             bench_kat_handler,    10,   &aes_vs,          "MCT", acvp_aes_kat_handler },
+    { "mct_des",             bench_kat_handler,    2,    &des_vs,          "MCT", acvp_des_kat_handler },
+    { "kat_aes_xts",         bench_kat_handler,    1000, &aes_xts_vs,      NULL,  NULL },
+    { "kat_hmac",            bench_kat_handler,    1000, &hmac_vs,         NULL,  NULL },
+    { "kat_cmac_aes",        bench_kat_handler,    100,  &cmac_aes_vs,     NULL,  NULL },
+    { "kat_cmac_tdes",       bench_kat_handler,    100,  &cmac_tdes_vs,    NULL,  NULL },
+    { "kat_kmac",            bench_kat_handler,    100,  &kmac_vs,         NULL,  NULL },
+    { "kat_drbg",            bench_kat_handler,    10,   &drbg_vs,         NULL,  NULL },
+    { "kat_dsa_keygen",      bench_kat_handler,    1000, &dsa_keygen_vs,   NULL,  NULL },
+    { "kat_dsa_pqggen",      bench_kat_handler,    100,  &dsa_pqggen_vs,   NULL,  NULL },
+    { "kat_dsa_pqgver",      bench_kat_handler,    1000, &dsa_pqgver_vs,   NULL,  NULL },
+    { "kat_dsa_siggen",      bench_kat_handler,    1000, &dsa_siggen_vs,   NULL,  NULL },
+    { "kat_dsa_sigver",      bench_kat_handler,    1000, &dsa_sigver_vs,   NULL,  NULL },
+    { "kat_rsa_keygen",      bench_kat_handler,    1000, &rsa_keygen_vs,   NULL,  NULL },
+    { "kat_rsa_siggen",      bench_kat_handler,    1000, &rsa_siggen_vs,   NULL,  NULL },
+    { "kat_rsa_sigver",      bench_kat_handler,    1000, &rsa_sigver_vs,   NULL,  NULL },
+    { "kat_rsa_decprim",     bench_kat_handler,    1000, &rsa_decprim_vs,  NULL,  NULL },
+    { "kat_rsa_sigprim",     bench_kat_handler,    100,  &rsa_sigprim_vs,  NULL,  NULL },
+    { "kat_ecdsa_keygen",    bench_kat_handler,    1000, &ecdsa_keygen_vs, NULL,  NULL },
+    { "kat_ecdsa_keyver",    bench_kat_handler,    1000, &ecdsa_keyver_vs, NULL,  NULL },
+    { "kat_ecdsa_siggen",    bench_kat_handler,    1000, &ecdsa_siggen_vs, NULL,  NULL },
+    { "kat_ecdsa_sigver",    bench_kat_handler,    1000, &ecdsa_sigver_vs, NULL,  NULL },
+    { "kat_kas_ecc_cdh",     bench_kat_handler,    100,  &kas_ecc_cdh_vs,  NULL,  NULL },
+    { "kat_kas_ecc_comp",    bench_kat_handler,    100,  &kas_ecc_comp_vs, NULL,  NULL },
+    { "kat_kas_ecc_ssc",     bench_kat_handler,    100,  &kas_ecc_ssc_vs,  NULL,  NULL },
+    { "kat_kas_ffc_comp",    bench_kat_handler,    100,  &kas_ffc_comp_vs, NULL,  NULL },
+    { "kat_kas_ffc_ssc",     bench_kat_handler,    100,  &kas_ffc_ssc_vs,  NULL,  NULL },
+    { "kat_kas_ifc_ssc",     bench_kat_handler,    100,  &kas_ifc_ssc_vs,  NULL,  NULL },
+    { "kat_kts_ifc",         bench_kat_handler,    100,  &kts_ifc_vs,      NULL,  NULL },
+    { "kat_kda",             bench_kat_handler,    100,  &kda_vs,          NULL,  NULL },
+    { "kat_kdf108",          bench_kat_handler,    100,  &kdf108_vs,       NULL,  NULL },
+    { "kat_kdf135_ikev1",    bench_kat_handler,    100,  &ikev1_vs,        NULL,  NULL },
+    { "kat_kdf135_ikev2",    bench_kat_handler,    100,  &ikev2_vs,        NULL,  NULL },
+    { "kat_kdf135_snmp",     bench_kat_handler,    1000, &snmp_vs,         NULL,  NULL },
+    { "kat_kdf135_srtp",     bench_kat_handler,    100,  &srtp_vs,         NULL,  NULL },
+    { "kat_kdf135_ssh",      bench_kat_handler,    1000, &ssh_vs,          NULL,  NULL },
+    { "kat_kdf_tls12",       bench_kat_handler,    100,  &tls12_vs,        NULL,  NULL },
+    { "kat_kdf_tls13",       bench_kat_handler,    100,  &tls13_vs,        NULL,  NULL },
+    { "kat_pbkdf",           bench_kat_handler,    10,   &pbkdf_vs,        NULL,  NULL },
+    { "kat_safe_primes",     bench_kat_handler,    100,  &safe_primes_vs,  NULL,  NULL },
+};
+
+/*
+ * Runs a whole request file through acvp_run_vectors_from_file() and reports
+ * the time and the rate at which the file was gone through
+ */
+static int bench_request_file(const char *req, const char *rsp) {
+    ACVP_CTX *run_ctx = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned long long int start = 0, ns = 0;
+    long long int bytes = 0;
+    FILE *fp = NULL;
+
+    /* "-" is read from stdin as it comes, its size is not known */
+    if (!ACVP_IS_STDIO(req)) {
+        fp = fopen(req, "rb");
+        if (!fp) {
+            printf("Unable to open %s\n", req);
+            return 1;
+        }
+        if (!fseek(fp, 0, SEEK_END)) {
+            bytes = ftell(fp);
+        }
+        fclose(fp);
+    }
+
+    rv = acvp_create_test_session(&run_ctx, &bench_quiet, ACVP_LOG_LVL_ERR);
+    if (rv == ACVP_SUCCESS) {
+        rv = acvp_set_cap_loader(run_ctx, &bench_cap_loader, NULL);
+    }
+    if (rv != ACVP_SUCCESS) {
+        printf("Unable to set up the benchmark context\n");
+        acvp_free_test_session(run_ctx);
+        return 1;
+    }
+
+    start = acvp_metrics_now();
+    rv = acvp_run_vectors_from_file(run_ctx, req, rsp);
+    ns = acvp_metrics_now() - start;
+    acvp_free_test_session(run_ctx);
+    if (rv != ACVP_SUCCESS) {
+        printf("Running %s failed (%d)\n", req, rv);
+        return 1;
+    }
+    printf("%-22s %12s %10s\n", "request file", "total ms", "MB/s");
+    printf("%-22s %12.3f", req, (double)ns / 1e6);
+    if (bytes > 0) {
+        printf(" %10.1f", (double)bytes / 1e6 / ((double)ns / 1e9));
+    }
+    printf("\n");
+    return 0;
+}
+
+/*
+ * Writes the results as a baseline, a line of "name us/iter alloc/iter" for
+ * each benchmark run
+ */
+static int bench_write_baseline(const char *file) {
+    FILE *fp = NULL;
+    size_t i = 0;
+
+    fp = fopen(file, "w");
+    if (!fp) {
+        printf("Unable to write %s\n", file);
+        return 1;
+    }
+    fprintf(fp, "# acvp_bench baseline: name, microseconds and bytes allocated per iteration\n");
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (benches[i].done > 0) {
+            fprintf(fp, "%s %.3f %.0f\n", benches[i].name, benches[i].us, benches[i].alloc);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static int bench_read_baseline(const char *file, BENCH_BASE *base, int max) {
+    FILE *fp = NULL;
+    char line[128];
+    int cnt = 0;
+
+    fp = fopen(file, "r");
+    if (!fp) {
+        return -1;
+    }
+    while (cnt < max && fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line, "%31s %lf %lf", base[cnt].name, &base[cnt].us, &base[cnt].alloc) == 3) {
+            cnt++;
+        }
+    }
+    fclose(fp);
+    return cnt;
+}
+
+/*
+ * Compares the results against a baseline: a benchmark fails when it takes
+ * more than tolerance percent longer per iteration, or allocates more than
+ * BENCH_ALLOC_TOLERANCE_PCT more. Allocations only move with the code, times
+ * with the machine and its load as well, so the baseline times are first
+ * scaled by how much slower or faster the calibration runs now than it did
+ * for the baseline, and the default tolerance is wide all the same. A
+ * benchmark that fails fails the check; ones not in the baseline, or not run,
+ * are skipped, as is the allocation check where they cannot be counted.
+ */
+static int bench_check(const char *file, int tolerance) {
+    static BENCH_BASE base[BENCH_BASE_MAX];
+    const BENCH *b = NULL;
+    size_t i = 0;
+    double speed = 1.0;
+    int cnt = 0, j = 0, diff = 1, failed = 0;
+
+    cnt = bench_read_baseline(file, base, BENCH_BASE_MAX);
+    if (cnt < 0) {
+        printf("Unable to read the baseline %s\n", file);
+        return 1;
+    }
+    /* The baseline times as they would be on this machine as it runs now */
+    for (j = 0; j < cnt; j++) {
+        strcmp_s(base[j].name, sizeof(base[j].name), benches[0].name, &diff);
+        if (!diff && base[j].us > 0 && benches[0].done > 0) {
+            speed = benches[0].us / base[j].us;
+        }
+    }
+    printf("\nBaseline %s, tolerance %d%% in time, %d%% in allocations, times scaled by %.2f:\n", file,
+           tolerance, BENCH_ALLOC_TOLERANCE_PCT, speed);
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        b = &benches[i];
+        if (!b->done || b == &benches[0]) {
+            continue;
+        }
+        if (b->done < 0) {
+            printf("%-22s FAILED\n", b->name);
+            failed = 1;
+            continue;
+        }
+        for (j = 0; j < cnt; j++) {
+            strcmp_s(base[j].name, sizeof(base[j].name), b->name, &diff);
+            if (!diff) {
+                break;
+            }
+        }
+        if (j == cnt) {
+            printf("%-22s not in the baseline\n", b->name);
+            continue;
+        }
+        if (b->us * 100 > base[j].us * speed * (100 + tolerance)) {
+            printf("%-22s SLOWER: %.3f us/iter, baseline %.3f\n", b->name, b->us, base[j].us * speed);
+            failed = 1;
+        }
+#ifdef BENCH_ALLOC_COUNTED
+        if (b->alloc * 100 > base[j].alloc * (100 + BENCH_ALLOC_TOLERANCE_PCT)) {
+            printf("%-22s ALLOCATES MORE: %.0f bytes/iter, baseline %.0f\n", b->name, b->alloc, base[j].alloc);
+            failed = 1;
+        }
+#endif
+    }
+    printf("%s\n", failed ? "Regressions against the baseline" : "No regressions against the baseline");
+    return failed;
+}
+
+static ACVP_RESULT bench_setup(void) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    rv = acvp_create_test_session(&ctx, &bench_quiet, ACVP_LOG_LVL_ERR);
+    if (rv != ACVP_SUCCESS) return rv;
+
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA256, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA256, ACVP_HASH_MESSAGE_LEN, 0, 65528, 8);
+    if (rv != ACVP_SUCCESS) return rv;
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_CBC, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_PARM_DIR, ACVP_SYM_CIPH_DIR_BOTH);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_KEYLEN, 128);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_KEYLEN, 192);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_KEYLEN, 256);
+    if (rv != ACVP_SUCCESS) return rv;
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_TDES_CBC, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CBC, ACVP_SYM_CIPH_PARM_DIR, ACVP_SYM_CIPH_DIR_BOTH);
+    if (rv != ACVP_SUCCESS) return rv;
+    return acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CBC, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
+}
+
+int main(int argc, char **argv) {
+    const char *filter = NULL, *req = NULL, *rsp = "bench_rsp.json";
+    const char *baseline = NULL, *new_baseline = NULL;
+    size_t i = 0;
+    int arg = 1, rounds = 1, round = 0, tolerance = BENCH_TIME_TOLERANCE_PCT, rc = 0;
+
+    for (arg = 1; arg < argc; arg++) {
+        if (!strncmp(argv[arg], "-s", 3) && arg + 1 < argc) {
+            scale = atof(argv[++arg]);
+            if (scale <= 0) {
+                printf("Invalid scale %s\n", argv[arg]);
+                return 1;
+            }
+        } else if (!strncmp(argv[arg], "-f", 3) && arg + 1 < argc) {
+            req = argv[++arg];
+        } else if (!strncmp(argv[arg], "-o", 3) && arg + 1 < argc) {
+            rsp = argv[++arg];
+        } else if (!strncmp(argv[arg], "-r", 3) && arg + 1 < argc) {
+            rounds = atoi(argv[++arg]);
+            if (rounds < 1) {
+                printf("Invalid number of rounds %s\n", argv[arg]);
+                return 1;
+            }
+        } else if (!strncmp(argv[arg], "-b", 3) && arg + 1 < argc) {
+            baseline = argv[++arg];
+        } else if (!strncmp(argv[arg], "-w", 3) && arg + 1 < argc) {
+            new_baseline = argv[++arg];
+        } else if (!strncmp(argv[arg], "-t", 3) && arg + 1 < argc) {
+            tolerance = atoi(argv[++arg]);
+            if (tolerance < 0) {
+                printf("Invalid tolerance %s\n", argv[arg]);
+                return 1;
+            }
+        } else if (argv[arg][0] == '-') {
+            printf("usage: %s [-s scale] [-r rounds] [-b baseline] [-t tolerance %%] [-w new baseline] [name filter]\n", argv[0]);
+            printf("       %s -f <request file> [-o <response file>]\n", argv[0]);
+            return 1;
+        } else {
+            filter = argv[arg];
+        }
+    }
+
+    if (req) {
+        return bench_request_file(req, rsp);
+    }
+
+    if (bench_setup() != ACVP_SUCCESS) {
+        printf("Unable to set up the benchmark context\n");
+        return 1;
+    }
+
+    printf("%-22s %8s %12s %12s %10s %10s %12s\n", "benchmark", "iters", "total ms", "us/iter", "MB/s",
+           "cases/s", "alloc/iter");
+    /* Rounds go through all the benchmarks, so a slow spell of the machine only hits one round of each */
+    for (round = 0; round < rounds; round++) {
+        for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+            if (filter && !strstr(benches[i].name, filter) && (i || (!baseline && !new_baseline))) {
+                continue;
+            }
+            if (benches[i].done >= 0) {
+                benches[i].func(&benches[i]);
+            }
+        }
+    }
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (benches[i].done > 0) {
+            bench_print(&benches[i]);
+        }
+    }
+    if (new_baseline) {
+        rc = bench_write_baseline(new_baseline);
+    }
+    if (baseline && !rc) {
+        rc = bench_check(baseline, tolerance);
+    }
+
+    acvp_free_test_session(ctx);
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (benches[i].vs && benches[i].vs->val) {
+            json_value_free(benches[i].vs->val);
+            free(benches[i].vs->text);
+            benches[i].vs->val = NULL;
+            benches[i].vs->text = NULL;
+        }
+    }
+    return rc;
+}
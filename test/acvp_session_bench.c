@@ -0,0 +1,337 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+/*
+ * End-to-end benchmark of a test session against the loopback mock server in
+ * mock_acvp_server.c: login, registration, vector set downloads (with as many
+ * retries as asked for), response uploads and the results check all go over
+ * TLS as they would with the demo server, with a crypto handler that does
+ * nothing. It reports the wall time of acvp_run(), what went over the wire
+ * and the library's own breakdown from acvp_set_metrics_cb(). With -S the
+ * session is registered that many times over, by as many contexts run
+ * together through acvp_orch_run().
+ *
+ * The session replayed is made from recordings laid out like offline request
+ * files, or plain vector set files, json/req.json by default. Build and run
+ * with "make bench-session" from the top or test directory.
+ *
+ * Note that the library treats retry periods of 5 seconds or less as missing,
+ * so retries need a period of at least 6 seconds.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "acvp/acvp.h"
+#include "acvp/acvp_lcl.h"
+#include "safe_lib.h"
+#include "mock_acvp_server.h"
+
+#define BENCH_MAX_RECORDINGS 16
+#define BENCH_MAX_SESSIONS 64
+#define BENCH_SESSION_URL "/acvp/v1/testSessions/1"
+
+static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+static ACVP_METRICS totals;
+static unsigned int vs_reported = 0;
+
+static int bench_null_handler(ACVP_TEST_CASE *test_case) {
+    return 0;
+}
+
+static ACVP_RESULT bench_quiet(char *msg, ACVP_LOG_LVL level) {
+    return ACVP_SUCCESS;
+}
+
+static ACVP_RESULT bench_log(char *msg, ACVP_LOG_LVL level) {
+    printf("[ACVP]: %s\n", msg);
+    return ACVP_SUCCESS;
+}
+
+static void bench_metrics(const ACVP_METRICS *metrics, void *arg) {
+    int i = 0;
+
+    if (metrics->tg_id) {
+        return;
+    }
+    pthread_mutex_lock(&metrics_lock);
+    for (i = 0; i < ACVP_METRICS_PHASE_MAX; i++) {
+        totals.ns[i] += metrics->ns[i];
+    }
+    totals.crypto_calls += metrics->crypto_calls;
+    vs_reported++;
+    pthread_mutex_unlock(&metrics_lock);
+}
+
+/*
+ * Builds the session to replay: the session object of the first recording
+ * that has one, then every vector set of every recording, copies times over
+ * with distinct vsIds.
+ */
+static JSON_Value *bench_build_session(const char **files, int file_count, int copies) {
+    JSON_Value *session = NULL, *val = NULL, *vs_val = NULL, *sess_val = NULL;
+    JSON_Array *arr = NULL, *out = NULL;
+    JSON_Object *first = NULL;
+    const char *url = NULL;
+    int f = 0, c = 0, vs_id = 0;
+    size_t i = 0;
+
+    session = json_value_init_array();
+    out = json_value_get_array(session);
+    sess_val = json_value_init_object();
+    json_array_append_value(out, sess_val);
+
+    for (f = 0; f < file_count; f++) {
+        val = json_parse_file(files[f]);
+        arr = json_value_get_array(val);
+        if (!arr || json_array_get_count(arr) < 2) {
+            printf("Unable to read recording %s\n", files[f]);
+            json_value_free(val);
+            json_value_free(session);
+            return NULL;
+        }
+        first = json_array_get_object(arr, 0);
+        url = json_object_get_string(first, "url");
+        if (url && !json_object_get_string(json_value_get_object(sess_val), "url")) {
+            json_object_set_string(json_value_get_object(sess_val), "url", url);
+        }
+        for (i = 1; i < json_array_get_count(arr); i++) {
+            for (c = 0; c < copies; c++) {
+                vs_val = json_value_deep_copy(json_array_get_value(arr, i));
+                vs_id = (int)json_object_get_number(json_value_get_object(vs_val), "vsId");
+                if (c || f) {
+                    /* Keep the copies apart from every recorded vsId */
+                    vs_id = 100000 * (f * copies + c + 1) + vs_id % 100000;
+                    json_object_set_number(json_value_get_object(vs_val), "vsId", vs_id);
+                }
+                json_array_append_value(out, vs_val);
+            }
+        }
+        json_value_free(val);
+    }
+    if (!json_object_get_string(json_value_get_object(sess_val), "url")) {
+        json_object_set_string(json_value_get_object(sess_val), "url", BENCH_SESSION_URL);
+    }
+    return session;
+}
+
+/*
+ * A null handler for every algorithm the unit test collateral in json/
+ * replays through here.
+ */
+static ACVP_RESULT bench_enable_caps(ACVP_CTX *ctx) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    rv = acvp_cap_cmac_enable(ctx, ACVP_CMAC_AES, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_cmac_set_parm(ctx, ACVP_CMAC_AES, ACVP_CMAC_MACLEN, 128);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_cmac_set_parm(ctx, ACVP_CMAC_AES, ACVP_CMAC_KEYLEN, 128);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_cmac_set_parm(ctx, ACVP_CMAC_AES, ACVP_CMAC_DIRECTION_GEN, 1);
+    if (rv != ACVP_SUCCESS) return rv;
+
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA256, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA256, ACVP_HASH_MESSAGE_LEN, 0, 65528, 8);
+    if (rv != ACVP_SUCCESS) return rv;
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_CBC, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_PARM_DIR, ACVP_SYM_CIPH_DIR_BOTH);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_KEYLEN, 128);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_KEYLEN, 192);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_CBC, ACVP_SYM_CIPH_KEYLEN, 256);
+    if (rv != ACVP_SUCCESS) return rv;
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_TDES_CBC, &bench_null_handler);
+    if (rv != ACVP_SUCCESS) return rv;
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CBC, ACVP_SYM_CIPH_PARM_DIR, ACVP_SYM_CIPH_DIR_BOTH);
+    if (rv != ACVP_SUCCESS) return rv;
+    return acvp_cap_sym_cipher_set_parm(ctx, ACVP_TDES_CBC, ACVP_SYM_CIPH_PARM_KO, ACVP_SYM_CIPH_KO_ONE);
+}
+
+static ACVP_RESULT bench_setup_ctx(ACVP_CTX **ctx, MOCK_ACVP_SERVER *srv, int workers, int threads,
+                                   int preconnect, int timeout_ms, int hedge, int verbose) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+
+    rv = acvp_create_test_session(ctx, verbose ? &bench_log : &bench_quiet,
+                                  verbose ? ACVP_LOG_LVL_STATUS : ACVP_LOG_LVL_ERR);
+    if (rv == ACVP_SUCCESS) rv = acvp_set_server(*ctx, "localhost", mock_acvp_server_port(srv));
+    if (rv == ACVP_SUCCESS) rv = acvp_set_path_segment(*ctx, "/acvp/v1/");
+    if (rv == ACVP_SUCCESS) rv = acvp_set_cacerts(*ctx, mock_acvp_server_ca_file(srv));
+    if (rv == ACVP_SUCCESS && preconnect) rv = acvp_preconnect(*ctx);
+    if (rv == ACVP_SUCCESS && timeout_ms) rv = acvp_set_request_timeout(*ctx, timeout_ms);
+    if (rv == ACVP_SUCCESS && hedge) rv = acvp_set_hedged_requests(*ctx, 1);
+    if (rv == ACVP_SUCCESS) rv = acvp_set_max_parallel_vector_sets(*ctx, workers);
+    if (rv == ACVP_SUCCESS) rv = acvp_set_max_parallel_test_cases(*ctx, threads);
+    if (rv == ACVP_SUCCESS) rv = acvp_set_metrics_cb(*ctx, bench_metrics, NULL);
+    if (rv == ACVP_SUCCESS) rv = bench_enable_caps(*ctx);
+    return rv;
+}
+
+static void bench_usage(const char *prog) {
+    printf("usage: %s [options] [recording.json ...]\n"
+           "  -c copies   run each recorded vector set this many times (default 1)\n"
+           "  -l ms       latency the server adds to every response (default 0)\n"
+           "  -s n        the server holds every nth GET back -L ms more (default 0, none)\n"
+           "  -L ms       how long -s holds a response back (default 1000)\n"
+           "  -T ms       acvp_set_request_timeout() (default 0, none)\n"
+           "  -H          acvp_set_hedged_requests()\n"
+           "  -R retries  retry answers before each vector set is handed out (default 0)\n"
+           "  -p seconds  retry period the server asks for, at least 6 (default 6)\n"
+           "  -r retries  retry answers before the session results are handed out (default 0)\n"
+           "  -F          the server reports every vector set as failed\n"
+           "  -w workers  acvp_set_max_parallel_vector_sets(), or orchestrator workers with -S (default 1)\n"
+           "  -t threads  acvp_set_max_parallel_test_cases() (default 1)\n"
+           "  -S sessions run this many sessions with acvp_orch_run() (default: one with acvp_run())\n"
+           "  -P          acvp_preconnect() while the capabilities are set up\n"
+           "  -v          log library status output\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *files[BENCH_MAX_RECORDINGS];
+    MOCK_ACVP_CONFIG config;
+    MOCK_ACVP_STATS stats;
+    MOCK_ACVP_SERVER *srv = NULL;
+    JSON_Value *session = NULL;
+    ACVP_CTX *ctxs[BENCH_MAX_SESSIONS] = { NULL };
+    ACVP_ORCH *orch = NULL;
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    char save_dir[] = "/tmp/acvp_session_bench_XXXXXX";
+    unsigned long long int start = 0, wall = 0;
+    int opt = 0, file_count = 0, copies = 1, workers = 1, threads = 1, sessions = 0, verbose = 0, rc = 1;
+    int preconnect = 0, timeout_ms = 0, hedge = 0;
+    const char *phases[ACVP_METRICS_PHASE_MAX] = { "parse", "crypto", "output", "serialize", "transport" };
+    int i = 0;
+
+    memzero_s(&config, sizeof(MOCK_ACVP_CONFIG));
+    config.retry_period = 6;
+    config.stall_ms = 1000;
+    while ((opt = getopt(argc, argv, "c:l:s:L:T:R:p:r:w:t:S:FHPvh")) != -1) {
+        switch (opt) {
+        case 'c': copies = atoi(optarg); break;
+        case 'l': config.latency_ms = atoi(optarg); break;
+        case 's': config.stall_every = atoi(optarg); break;
+        case 'L': config.stall_ms = atoi(optarg); break;
+        case 'T': timeout_ms = atoi(optarg); break;
+        case 'H': hedge = 1; break;
+        case 'R': config.retries = atoi(optarg); break;
+        case 'p': config.retry_period = atoi(optarg); break;
+        case 'r': config.results_retries = atoi(optarg); break;
+        case 'F': config.fail = 1; break;
+        case 'w': workers = atoi(optarg); break;
+        case 't': threads = atoi(optarg); break;
+        case 'S': sessions = atoi(optarg); break;
+        case 'P': preconnect = 1; break;
+        case 'v': verbose = 1; break;
+        default:
+            bench_usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    for (; optind < argc && file_count < BENCH_MAX_RECORDINGS; optind++) {
+        files[file_count++] = argv[optind];
+    }
+    if (!file_count) {
+        files[file_count++] = "json/req.json";
+    }
+    if (copies < 1 || config.latency_ms < 0 || config.stall_every < 0 || config.stall_ms < 0 || timeout_ms < 0 ||
+            config.retries < 0 || config.results_retries < 0 ||
+            sessions < 0 || sessions > BENCH_MAX_SESSIONS ||
+            ((config.retries || config.results_retries) && config.retry_period <= ACVP_RETRY_TIME_MIN)) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    session = bench_build_session(files, file_count, copies);
+    if (!session) {
+        return 1;
+    }
+    srv = mock_acvp_server_start(session, &config);
+    if (!srv) {
+        printf("Unable to start the mock ACVP server\n");
+        goto end;
+    }
+
+    /* Session files from acvp_run() go somewhere temporary */
+    if (!mkdtemp(save_dir)) {
+        printf("Unable to create a directory for session files\n");
+        goto end;
+    }
+    setenv("ACV_SESSION_SAVE_PATH", save_dir, 1);
+
+    if (sessions && acvp_orch_create(&orch, workers) != ACVP_SUCCESS) {
+        printf("Unable to create the orchestrator\n");
+        goto end;
+    }
+
+    for (i = 0; i < (sessions ? sessions : 1); i++) {
+        rv = bench_setup_ctx(&ctxs[i], srv, sessions ? 1 : workers, threads, preconnect,
+                             timeout_ms, hedge, verbose);
+        if (rv == ACVP_SUCCESS && sessions) rv = acvp_orch_add_session(orch, ctxs[i], 0);
+        if (rv != ACVP_SUCCESS) {
+            printf("Unable to set up the test session (%d)\n", rv);
+            goto end;
+        }
+    }
+
+    start = acvp_metrics_now();
+    if (sessions) {
+        rv = acvp_orch_run(orch);
+    } else {
+        rv = acvp_run(ctxs[0], 0);
+    }
+    wall = acvp_metrics_now() - start;
+    mock_acvp_server_stats(srv, &stats);
+
+    if (sessions) {
+        printf("sessions               %d %s\n", sessions, rv == ACVP_SUCCESS ? "passed" : "FAILED");
+    } else {
+        printf("session                %s\n", rv == ACVP_SUCCESS ? "passed" : "FAILED");
+    }
+    printf("vector sets            %d (%u reported)\n",
+           ((int)json_array_get_count(json_value_get_array(session)) - 1) * (sessions ? sessions : 1),
+           vs_reported);
+    printf("wall time              %.3f ms\n", (double)wall / 1e6);
+    printf("requests               %u over %u connections\n", stats.requests, stats.connections);
+    printf("retries                %u\n", stats.retries);
+    printf("responses received     %u\n", stats.responses);
+    printf("unmatched requests     %u\n", stats.errors);
+    printf("bytes to server        %llu\n", stats.bytes_in);
+    printf("bytes from server      %llu\n", stats.bytes_out);
+    printf("crypto calls           %u\n", totals.crypto_calls);
+    for (i = 0; i < ACVP_METRICS_PHASE_MAX; i++) {
+        printf("%-22s %.3f ms\n", phases[i], (double)totals.ns[i] / 1e6);
+    }
+    rc = rv == ACVP_SUCCESS && !stats.errors ? 0 : 1;
+
+end:
+    acvp_orch_free(orch);
+    for (i = 0; i < BENCH_MAX_SESSIONS; i++) {
+        if (ctxs[i]) acvp_free_test_session(ctxs[i]);
+    }
+    mock_acvp_server_stop(srv);
+    json_value_free(session);
+    if (save_dir[sizeof(save_dir) - 7] != 'X') {
+        char cmd[sizeof(save_dir) + 16];
+
+        snprintf(cmd, sizeof(cmd), "rm -rf %s", save_dir);
+        if (system(cmd)) {
+            printf("Unable to remove %s\n", save_dir);
+        }
+    }
+    return rc;
+}
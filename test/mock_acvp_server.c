@@ -0,0 +1,658 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include "mock_acvp_server.h"
+
+#define MOCK_MAX_CONNS 128
+#define MOCK_URL_MAX 256
+#define MOCK_HDR_MAX (16 * 1024)
+#define MOCK_POLL_MS 200
+
+typedef struct mock_vs_t {
+    char url[MOCK_URL_MAX];
+    char *body;             /* The vector set, as sent on download */
+    size_t body_len;
+    int retries_left;
+} MOCK_VS;
+
+struct mock_acvp_server_t {
+    MOCK_ACVP_CONFIG config;
+    SSL_CTX *ssl_ctx;
+    int listen_fd;
+    int port;
+    volatile int stop;
+    char ca_file[64];
+    char session_url[MOCK_URL_MAX - 32];  /* Leaves room for the vector set urls */
+    char *register_body;
+    char *results_body;
+    int results_retries_left;
+    unsigned int gets;      /* GETs answered, counted for stall_every */
+    MOCK_VS *vs;
+    int vs_count;
+    pthread_t accept_thread;
+    int accepting;          /* accept_thread was started */
+    pthread_t conn_threads[MOCK_MAX_CONNS];
+    int conn_count;
+    pthread_mutex_t lock;
+    MOCK_ACVP_STATS stats;
+};
+
+typedef struct mock_conn_t {
+    MOCK_ACVP_SERVER *srv;
+    SSL *ssl;
+    int fd;
+    char *buf;              /* Bytes read and not yet consumed */
+    size_t len;
+    size_t max;
+} MOCK_CONN;
+
+static const char mock_version[] = "{\"acvVersion\": \"1.0\"}";
+
+/*
+ * Returns the two entry array of the protocol version and obj, serialized
+ */
+static char *mock_wrap(JSON_Value *obj) {
+    JSON_Value *arr_val = json_value_init_array();
+    char *text = NULL;
+
+    json_array_append_value(json_value_get_array(arr_val), json_parse_string(mock_version));
+    json_array_append_value(json_value_get_array(arr_val), obj);
+    text = json_serialize_to_string(arr_val, NULL);
+    json_value_free(arr_val);
+    return text;
+}
+
+static EVP_PKEY *mock_make_key(void) {
+    EVP_PKEY_CTX *pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+    EVP_PKEY *pkey = NULL;
+
+    if (pctx && EVP_PKEY_keygen_init(pctx) > 0 &&
+            EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, NID_X9_62_prime256v1) > 0) {
+        EVP_PKEY_keygen(pctx, &pkey);
+    }
+    EVP_PKEY_CTX_free(pctx);
+    return pkey;
+}
+
+static int mock_add_ext(X509 *cert, int nid, const char *value) {
+    X509V3_CTX v3ctx;
+    X509_EXTENSION *ext = NULL;
+    int ok = 0;
+
+    X509V3_set_ctx_nodb(&v3ctx);
+    X509V3_set_ctx(&v3ctx, cert, cert, NULL, NULL, 0);
+    ext = X509V3_EXT_conf_nid(NULL, &v3ctx, nid, value);
+    if (ext) {
+        ok = X509_add_ext(cert, ext, -1);
+        X509_EXTENSION_free(ext);
+    }
+    return ok;
+}
+
+/*
+ * A throwaway self-signed certificate for localhost, written out to ca_file
+ * for the client to trust
+ */
+static int mock_setup_tls(MOCK_ACVP_SERVER *srv) {
+    EVP_PKEY *pkey = NULL;
+    X509 *cert = NULL;
+    X509_NAME *name = NULL;
+    FILE *fp = NULL;
+    int fd = -1, ok = 0;
+
+    pkey = mock_make_key();
+    cert = X509_new();
+    if (!pkey || !cert) {
+        goto end;
+    }
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), -3600);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 86400);
+    X509_set_pubkey(cert, pkey);
+    name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *)"localhost", -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    if (!mock_add_ext(cert, NID_basic_constraints, "critical,CA:TRUE") ||
+            !mock_add_ext(cert, NID_subject_alt_name, "DNS:localhost,IP:127.0.0.1") ||
+            !X509_sign(cert, pkey, EVP_sha256())) {
+        goto end;
+    }
+
+    snprintf(srv->ca_file, sizeof(srv->ca_file), "/tmp/mock_acvp_ca_XXXXXX");
+    fd = mkstemp(srv->ca_file);
+    if (fd < 0) {
+        srv->ca_file[0] = '\0';
+        goto end;
+    }
+    fp = fdopen(fd, "w");
+    if (!fp || !PEM_write_X509(fp, cert)) {
+        goto end;
+    }
+
+    srv->ssl_ctx = SSL_CTX_new(TLS_server_method());
+    if (!srv->ssl_ctx || SSL_CTX_use_certificate(srv->ssl_ctx, cert) != 1 ||
+            SSL_CTX_use_PrivateKey(srv->ssl_ctx, pkey) != 1) {
+        goto end;
+    }
+    ok = 1;
+
+end:
+    if (fp) {
+        fclose(fp);
+    } else if (fd >= 0) {
+        close(fd);
+    }
+    X509_free(cert);
+    EVP_PKEY_free(pkey);
+    return ok;
+}
+
+/*
+ * Takes the session object and vector sets from the recording, and builds
+ * everything the server will send up front
+ */
+static int mock_load_recording(MOCK_ACVP_SERVER *srv, JSON_Value *recording) {
+    JSON_Array *arr = json_value_get_array(recording);
+    JSON_Object *session = json_array_get_object(arr, 0);
+    JSON_Value *reg_val = NULL, *results_val = NULL, *urls_val = NULL, *list_val = NULL;
+    JSON_Value *vs_val = NULL, *entry_val = NULL;
+    const char *url = NULL;
+    int i = 0, count = (int)json_array_get_count(arr) - 1;
+
+    url = json_object_get_string(session, "url");
+    if (!url || count < 1 || strlen(url) >= sizeof(srv->session_url)) {
+        return 0;
+    }
+    snprintf(srv->session_url, sizeof(srv->session_url), "%s", url);
+
+    srv->vs = calloc(count, sizeof(MOCK_VS));
+    if (!srv->vs) {
+        return 0;
+    }
+    srv->vs_count = count;
+
+    urls_val = json_value_init_array();
+    list_val = json_value_init_array();
+    for (i = 0; i < count; i++) {
+        vs_val = json_array_get_value(arr, i + 1);
+        snprintf(srv->vs[i].url, MOCK_URL_MAX, "%s/vectorSets/%d", srv->session_url,
+                 (int)json_object_get_number(json_value_get_object(vs_val), "vsId"));
+        srv->vs[i].body = mock_wrap(json_value_deep_copy(vs_val));
+        srv->vs[i].body_len = srv->vs[i].body ? strlen(srv->vs[i].body) : 0;
+        srv->vs[i].retries_left = srv->config.retries;
+        json_array_append_string(json_value_get_array(urls_val), srv->vs[i].url);
+
+        entry_val = json_value_init_object();
+        json_object_set_string(json_value_get_object(entry_val), "vectorSetUrl", srv->vs[i].url);
+        json_object_set_string(json_value_get_object(entry_val), "status",
+                               srv->config.fail ? "fail" : "passed");
+        json_array_append_value(json_value_get_array(list_val), entry_val);
+    }
+
+    reg_val = json_value_init_object();
+    json_object_set_string(json_value_get_object(reg_val), "url", srv->session_url);
+    json_object_set_string(json_value_get_object(reg_val), "accessToken", "mock-session-token");
+    json_object_set_boolean(json_value_get_object(reg_val), "isSample", 0);
+    json_object_set_value(json_value_get_object(reg_val), "vectorSetUrls", urls_val);
+    srv->register_body = mock_wrap(reg_val);
+
+    results_val = json_value_init_object();
+    json_object_set_boolean(json_value_get_object(results_val), "passed", !srv->config.fail);
+    json_object_set_value(json_value_get_object(results_val), "results", list_val);
+    srv->results_body = mock_wrap(results_val);
+    srv->results_retries_left = srv->config.results_retries;
+
+    return srv->register_body && srv->results_body;
+}
+
+/*
+ * Reads more bytes of the connection into its buffer, waiting in short
+ * steps so a stopping server is noticed. Returns 0 once the connection is
+ * done with.
+ */
+static int mock_read_more(MOCK_CONN *conn) {
+    struct pollfd pfd;
+    char *tmp = NULL;
+    int n = 0;
+
+    if (conn->len == conn->max) {
+        tmp = realloc(conn->buf, conn->max * 2 + 1);
+        if (!tmp) {
+            return 0;
+        }
+        conn->buf = tmp;
+        conn->max *= 2;
+    }
+    while (!SSL_pending(conn->ssl)) {
+        if (conn->srv->stop) {
+            return 0;
+        }
+        pfd.fd = conn->fd;
+        pfd.events = POLLIN;
+        n = poll(&pfd, 1, MOCK_POLL_MS);
+        if (n > 0) {
+            break;
+        }
+        if (n < 0 && errno != EINTR) {
+            return 0;
+        }
+    }
+    n = SSL_read(conn->ssl, conn->buf + conn->len, (int)(conn->max - conn->len));
+    if (n <= 0) {
+        return 0;
+    }
+    conn->len += (size_t)n;
+    conn->buf[conn->len] = '\0';
+    return 1;
+}
+
+static int mock_write(MOCK_CONN *conn, const char *data, size_t len) {
+    int n = 0;
+
+    while (len) {
+        n = SSL_write(conn->ssl, data, (int)len);
+        if (n <= 0) {
+            return 0;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 1;
+}
+
+static int mock_respond(MOCK_CONN *conn, int code, const char *body, size_t body_len) {
+    MOCK_ACVP_SERVER *srv = conn->srv;
+    char hdr[256];
+    int hdr_len = 0;
+
+    /* No body is asked for only to probe the connection, which takes no work */
+    if (srv->config.latency_ms > 0 && body) {
+        usleep((useconds_t)srv->config.latency_ms * 1000);
+    }
+    hdr_len = snprintf(hdr, sizeof(hdr),
+                       "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n",
+                       code, code == 200 ? "OK" : "Not Found", body_len);
+    pthread_mutex_lock(&srv->lock);
+    srv->stats.bytes_out += (unsigned long long int)hdr_len + body_len;
+    pthread_mutex_unlock(&srv->lock);
+    return mock_write(conn, hdr, (size_t)hdr_len) && (!body || mock_write(conn, body, body_len));
+}
+
+static const char *mock_find_header(const char *hdrs, const char *name) {
+    size_t name_len = strlen(name);
+    const char *p = strstr(hdrs, "\r\n");
+
+    while (p && p[2] != '\r') {
+        p += 2;
+        if (!strncasecmp(p, name, name_len) && p[name_len] == ':') {
+            p += name_len + 1;
+            while (*p == ' ') p++;
+            return p;
+        }
+        p = strstr(p, "\r\n");
+    }
+    return NULL;
+}
+
+/*
+ * Answers one request, whose method, path and body have been read
+ */
+static int mock_route(MOCK_CONN *conn, const char *method, const char *path) {
+    MOCK_ACVP_SERVER *srv = conn->srv;
+    static const char empty_ok[] = "[{\"acvVersion\": \"1.0\"}, {}]";
+    char retry_body[128];
+    size_t path_len = strlen(path), url_len = 0;
+    const char *body = NULL;
+    size_t body_len = 0;
+    int i = 0, is_get = !strcmp(method, "GET"), retry = 0, stall = 0;
+    char login_body[] = "[{\"acvVersion\": \"1.0\"}, {\"accessToken\": \"mock-login-token\", "
+                        "\"largeEndpointRequired\": false, \"sizeConstraint\": -1}]";
+
+    if (is_get && srv->config.stall_every > 0 && srv->config.stall_ms > 0) {
+        pthread_mutex_lock(&srv->lock);
+        stall = ++srv->gets % (unsigned int)srv->config.stall_every == 0;
+        pthread_mutex_unlock(&srv->lock);
+        if (stall) {
+            usleep((useconds_t)srv->config.stall_ms * 1000);
+        }
+    }
+
+    if (!strcmp(method, "HEAD")) {
+        /* A client probing the connection, see acvp_preconnect() */
+        return mock_respond(conn, 200, NULL, 0);
+    }
+    if (!is_get && path_len >= 6 && !strcmp(path + path_len - 6, "/login")) {
+        return mock_respond(conn, 200, login_body, strlen(login_body));
+    }
+    if (!is_get && path_len >= 13 && !strcmp(path + path_len - 13, "/testSessions")) {
+        return mock_respond(conn, 200, srv->register_body, strlen(srv->register_body));
+    }
+    url_len = strlen(srv->session_url);
+    if (is_get && path_len == url_len + 8 && !strncmp(path, srv->session_url, url_len) &&
+            !strcmp(path + url_len, "/results")) {
+        pthread_mutex_lock(&srv->lock);
+        if (srv->results_retries_left > 0) {
+            srv->results_retries_left--;
+            srv->stats.retries++;
+            retry = 1;
+        }
+        pthread_mutex_unlock(&srv->lock);
+        if (retry) {
+            snprintf(retry_body, sizeof(retry_body), "[{\"acvVersion\": \"1.0\"}, {\"retry\": %d}]",
+                     srv->config.retry_period);
+            return mock_respond(conn, 200, retry_body, strlen(retry_body));
+        }
+        return mock_respond(conn, 200, srv->results_body, strlen(srv->results_body));
+    }
+
+    for (i = 0; i < srv->vs_count; i++) {
+        url_len = strlen(srv->vs[i].url);
+        if (strncmp(path, srv->vs[i].url, url_len)) {
+            continue;
+        }
+        if (is_get && path_len == url_len) {
+            pthread_mutex_lock(&srv->lock);
+            if (srv->vs[i].retries_left > 0) {
+                srv->vs[i].retries_left--;
+                srv->stats.retries++;
+                retry = 1;
+            }
+            pthread_mutex_unlock(&srv->lock);
+            if (retry) {
+                snprintf(retry_body, sizeof(retry_body), "[{\"acvVersion\": \"1.0\"}, {\"retry\": %d}]",
+                         srv->config.retry_period);
+                return mock_respond(conn, 200, retry_body, strlen(retry_body));
+            }
+            body = srv->vs[i].body;
+            body_len = srv->vs[i].body_len;
+            return mock_respond(conn, 200, body, body_len);
+        }
+        if (is_get && !strcmp(path + url_len, "/results")) {
+            /* The results of the vector set, with no test cases to show */
+            snprintf(retry_body, sizeof(retry_body), "[{\"acvVersion\": \"1.0\"}, {\"status\": \"%s\", \"tests\": []}]",
+                     srv->config.fail ? "fail" : "passed");
+            return mock_respond(conn, 200, retry_body, strlen(retry_body));
+        }
+        if (!is_get && !strcmp(path + url_len, "/results")) {
+            pthread_mutex_lock(&srv->lock);
+            srv->stats.responses++;
+            pthread_mutex_unlock(&srv->lock);
+            return mock_respond(conn, 200, empty_ok, strlen(empty_ok));
+        }
+    }
+
+    pthread_mutex_lock(&srv->lock);
+    srv->stats.errors++;
+    pthread_mutex_unlock(&srv->lock);
+    return mock_respond(conn, 404, "[]", 2);
+}
+
+/*
+ * Reads the body of a request into place right after its headers, decoding
+ * a chunked body. Returns the body length or -1.
+ */
+static long mock_read_body(MOCK_CONN *conn, size_t hdr_len, const char *hdrs) {
+    const char *val = NULL;
+    size_t want = 0, out = hdr_len, in = hdr_len, chunk = 0;
+    char *end = NULL, *eol = NULL;
+
+    val = mock_find_header(hdrs, "Expect");
+    if (val && !strncasecmp(val, "100-continue", 12) && !mock_write(conn, "HTTP/1.1 100 Continue\r\n\r\n", 25)) {
+        return -1;
+    }
+
+    val = mock_find_header(hdrs, "Transfer-Encoding");
+    if (!val || strncasecmp(val, "chunked", 7)) {
+        val = mock_find_header(hdrs, "Content-Length");
+        want = val ? strtoul(val, NULL, 10) : 0;
+        while (conn->len < hdr_len + want) {
+            if (!mock_read_more(conn)) {
+                return -1;
+            }
+        }
+        return (long)want;
+    }
+
+    /* Chunks are moved down over their size lines as they arrive */
+    while (1) {
+        while (!(eol = memchr(conn->buf + in, '\n', conn->len - in))) {
+            if (!mock_read_more(conn)) {
+                return -1;
+            }
+        }
+        chunk = strtoul(conn->buf + in, &end, 16);
+        in = (size_t)(eol - conn->buf) + 1;
+        while (conn->len < in + chunk + 2) {
+            if (!mock_read_more(conn)) {
+                return -1;
+            }
+        }
+        memmove(conn->buf + out, conn->buf + in, chunk);
+        out += chunk;
+        in += chunk + 2;
+        if (!chunk) {
+            memmove(conn->buf + out, conn->buf + in, conn->len - in);
+            conn->len = out + (conn->len - in);
+            conn->buf[conn->len] = '\0';
+            return (long)(out - hdr_len);
+        }
+    }
+}
+
+static void *mock_conn_thread(void *arg) {
+    MOCK_CONN *conn = arg;
+    MOCK_ACVP_SERVER *srv = conn->srv;
+    char method[16], path[MOCK_URL_MAX];
+    char *hdr_end = NULL, *q = NULL;
+    size_t hdr_len = 0, used = 0;
+    long body_len = 0;
+
+    if (SSL_accept(conn->ssl) != 1) {
+        goto end;
+    }
+
+    while (!srv->stop) {
+        while (!(hdr_end = strstr(conn->buf, "\r\n\r\n"))) {
+            if (conn->len > MOCK_HDR_MAX || !mock_read_more(conn)) {
+                goto end;
+            }
+        }
+        hdr_len = (size_t)(hdr_end - conn->buf) + 4;
+        hdr_end[2] = '\0';
+        if (sscanf(conn->buf, "%15s %255s", method, path) != 2) {
+            goto end;
+        }
+        q = strchr(path, '?');
+        if (q) *q = '\0';
+
+        body_len = mock_read_body(conn, hdr_len, conn->buf);
+        if (body_len < 0) {
+            goto end;
+        }
+        used = hdr_len + (size_t)body_len;
+        pthread_mutex_lock(&srv->lock);
+        srv->stats.requests++;
+        srv->stats.bytes_in += used;
+        pthread_mutex_unlock(&srv->lock);
+
+        if (!mock_route(conn, method, path)) {
+            goto end;
+        }
+
+        /* Keep whatever came in after this request */
+        memmove(conn->buf, conn->buf + used, conn->len - used);
+        conn->len -= used;
+        conn->buf[conn->len] = '\0';
+    }
+
+end:
+    SSL_shutdown(conn->ssl);
+    SSL_free(conn->ssl);
+    close(conn->fd);
+    free(conn->buf);
+    free(conn);
+    return NULL;
+}
+
+static void *mock_accept_thread(void *arg) {
+    MOCK_ACVP_SERVER *srv = arg;
+    MOCK_CONN *conn = NULL;
+    struct pollfd pfd;
+    int fd = -1, one = 1;
+
+    while (!srv->stop) {
+        pfd.fd = srv->listen_fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, MOCK_POLL_MS) <= 0) {
+            continue;
+        }
+        fd = accept(srv->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        /* Headers and body are written apart; don't hold the body for the ACK */
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        conn = calloc(1, sizeof(MOCK_CONN));
+        if (conn) {
+            conn->max = 64 * 1024;
+            conn->buf = malloc(conn->max + 1);
+            conn->ssl = SSL_new(srv->ssl_ctx);
+        }
+        if (!conn || !conn->buf || !conn->ssl || srv->conn_count == MOCK_MAX_CONNS) {
+            if (conn) {
+                if (conn->ssl) SSL_free(conn->ssl);
+                free(conn->buf);
+                free(conn);
+            }
+            close(fd);
+            continue;
+        }
+        conn->srv = srv;
+        conn->fd = fd;
+        conn->buf[0] = '\0';
+        SSL_set_fd(conn->ssl, fd);
+        if (pthread_create(&srv->conn_threads[srv->conn_count], NULL, mock_conn_thread, conn)) {
+            SSL_free(conn->ssl);
+            free(conn->buf);
+            free(conn);
+            close(fd);
+            continue;
+        }
+        srv->conn_count++;
+        pthread_mutex_lock(&srv->lock);
+        srv->stats.connections++;
+        pthread_mutex_unlock(&srv->lock);
+    }
+    return NULL;
+}
+
+MOCK_ACVP_SERVER *mock_acvp_server_start(JSON_Value *recording, const MOCK_ACVP_CONFIG *config) {
+    MOCK_ACVP_SERVER *srv = NULL;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    int one = 1;
+
+    srv = calloc(1, sizeof(MOCK_ACVP_SERVER));
+    if (!srv) {
+        return NULL;
+    }
+    srv->listen_fd = -1;
+    srv->config = *config;
+    pthread_mutex_init(&srv->lock, NULL);
+
+    if (!mock_load_recording(srv, recording) || !mock_setup_tls(srv)) {
+        goto err;
+    }
+
+    srv->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (srv->listen_fd < 0) {
+        goto err;
+    }
+    setsockopt(srv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(srv->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+            listen(srv->listen_fd, 64) ||
+            getsockname(srv->listen_fd, (struct sockaddr *)&addr, &addr_len)) {
+        goto err;
+    }
+    srv->port = ntohs(addr.sin_port);
+
+    if (pthread_create(&srv->accept_thread, NULL, mock_accept_thread, srv)) {
+        goto err;
+    }
+    srv->accepting = 1;
+    return srv;
+
+err:
+    mock_acvp_server_stop(srv);
+    return NULL;
+}
+
+int mock_acvp_server_port(MOCK_ACVP_SERVER *srv) {
+    return srv->port;
+}
+
+const char *mock_acvp_server_ca_file(MOCK_ACVP_SERVER *srv) {
+    return srv->ca_file;
+}
+
+void mock_acvp_server_stats(MOCK_ACVP_SERVER *srv, MOCK_ACVP_STATS *stats) {
+    pthread_mutex_lock(&srv->lock);
+    *stats = srv->stats;
+    pthread_mutex_unlock(&srv->lock);
+}
+
+void mock_acvp_server_stop(MOCK_ACVP_SERVER *srv) {
+    int i = 0;
+
+    if (!srv) {
+        return;
+    }
+    srv->stop = 1;
+    if (srv->accepting) {
+        pthread_join(srv->accept_thread, NULL);
+    }
+    for (i = 0; i < srv->conn_count; i++) {
+        pthread_join(srv->conn_threads[i], NULL);
+    }
+    if (srv->listen_fd >= 0) close(srv->listen_fd);
+    if (srv->ssl_ctx) SSL_CTX_free(srv->ssl_ctx);
+    if (srv->ca_file[0]) remove(srv->ca_file);
+    for (i = 0; i < srv->vs_count; i++) {
+        if (srv->vs[i].body) json_free_serialized_string(srv->vs[i].body);
+    }
+    free(srv->vs);
+    if (srv->register_body) json_free_serialized_string(srv->register_body);
+    if (srv->results_body) json_free_serialized_string(srv->results_body);
+    pthread_mutex_destroy(&srv->lock);
+    free(srv);
+}
@@ -0,0 +1,61 @@
+/** @file */
+/*
+ * Copyright (c) 2024, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libacvp/LICENSE
+ */
+
+#ifndef MOCK_ACVP_SERVER_H
+#define MOCK_ACVP_SERVER_H
+
+#include "acvp/parson.h"
+
+/*
+ * A loopback HTTPS server that plays the part of the ACVP server for a
+ * recorded session: it accepts any login, answers the registration with the
+ * vector sets of the recording, makes each vector set download wait for a
+ * number of retries first, takes the responses, and reports every vector set
+ * as passed, or as failed if asked to. It listens on 127.0.0.1 with a self-signed certificate for
+ * localhost written to ca_file, which the client is to trust.
+ */
+typedef struct mock_acvp_server_t MOCK_ACVP_SERVER;
+
+typedef struct mock_acvp_config_t {
+    int latency_ms;         /* Added before every response */
+    int stall_every;        /* Every this many GETs one is held back stall_ms more, 0 for none */
+    int stall_ms;
+    int retries;            /* Times each vector set download is answered with a retry */
+    int retry_period;       /* Seconds the server asks the client to wait on a retry */
+    int results_retries;    /* Times the session results are answered with a retry */
+    int fail;               /* Reports every vector set as failed */
+} MOCK_ACVP_CONFIG;
+
+typedef struct mock_acvp_stats_t {
+    unsigned int connections;
+    unsigned int requests;
+    unsigned int retries;       /* Retry answers sent */
+    unsigned int responses;     /* Vector set responses received */
+    unsigned int errors;        /* Requests nothing in the recording matched */
+    unsigned long long int bytes_in;    /* HTTP bytes received, headers included */
+    unsigned long long int bytes_out;   /* HTTP bytes sent, headers included */
+} MOCK_ACVP_STATS;
+
+/*
+ * Starts a server for the session in recording, an array laid out like an
+ * offline request file: the session object (with "url") followed by the
+ * vector sets. The recording is only read during the call.
+ */
+MOCK_ACVP_SERVER *mock_acvp_server_start(JSON_Value *recording, const MOCK_ACVP_CONFIG *config);
+
+int mock_acvp_server_port(MOCK_ACVP_SERVER *srv);
+
+const char *mock_acvp_server_ca_file(MOCK_ACVP_SERVER *srv);
+
+void mock_acvp_server_stats(MOCK_ACVP_SERVER *srv, MOCK_ACVP_STATS *stats);
+
+void mock_acvp_server_stop(MOCK_ACVP_SERVER *srv);
+
+#endif
@@ -304,6 +304,28 @@ Test(SET_SESSION_PARAMS, set_server_overflow, .init = setup, .fini = teardown) {
     cr_assert(rv == ACVP_INVALID_ARG);
 }
 
+/*
+ * The pre-connect needs the server, and is waited for when the server
+ * changes and when the context is freed
+ */
+Test(SET_SESSION_PARAMS, preconnect, .init = setup, .fini = teardown) {
+    rv = acvp_preconnect(NULL);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_preconnect(ctx);
+    cr_assert(rv == ACVP_MISSING_ARG);
+
+    rv = acvp_set_server(ctx, "for test", 1111);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_preconnect(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_preconnect(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_server(ctx, "for test again", 1111);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_preconnect(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
 /*
  * This test sets path_segment info
  */
@@ -449,6 +471,35 @@ Test(FREE_TEST_SESSION, good_full, .init = setup_full_ctx) {
     cr_assert(rv == ACVP_SUCCESS);
 }
 
+/*
+ * Resets the session state and keeps the capabilities
+ */
+Test(RESET_SESSION, good, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_CAPS_LIST *caps = ctx->caps_list;
+
+    ctx->session_url = strdup("/acvp/v1/testSessions/1");
+    ctx->jwt_token = strdup("abc");
+    ctx->vs_list = calloc(1, sizeof(ACVP_VS_LIST));
+    rv = acvp_append_str_list(&ctx->vsid_url_list, "/acvp/v1/testSessions/1/vectorSets/1");
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx->session_passed = 1;
+
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert_null(ctx->session_url);
+    cr_assert_null(ctx->jwt_token);
+    cr_assert_null(ctx->vs_list);
+    cr_assert_null(ctx->vsid_url_list);
+    cr_assert(ctx->session_passed == 0);
+    cr_assert(ctx->caps_list == caps);
+    cr_assert_not_null(acvp_locate_cap_entry(ctx, ACVP_AES_CBC));
+}
+
+Test(RESET_SESSION, null_ctx) {
+    rv = acvp_reset_session(NULL);
+    cr_assert(rv == ACVP_NO_CTX);
+}
+
 /*
  * Calls run with missing path segment
  */
@@ -535,6 +586,149 @@ Test(RUN, bad_totp_cb, .init = setup_full_ctx, .fini = teardown) {
     cr_assert(rv == ACVP_TOTP_FAIL);
 }
 
+/*
+ * Checks the arguments of the orchestrator calls
+ */
+Test(ORCH, bad_args, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_ORCH *orch = NULL;
+    ACVP_RESULT result = ACVP_SUCCESS;
+
+    rv = acvp_orch_create(NULL, 2);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_orch_create(&orch, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_orch_create(&orch, 65);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_orch_create(&orch, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_orch_create(&orch, 2);
+    cr_assert(rv == ACVP_CTX_NOT_EMPTY);
+
+    rv = acvp_orch_run(orch);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_orch_add_session(NULL, ctx, 0);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_orch_add_session(orch, NULL, 0);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_orch_get_result(orch, ctx, &result);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_orch_add_session(orch, ctx, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_orch_add_session(orch, ctx, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_orch_get_result(orch, ctx, NULL);
+    cr_assert(rv == ACVP_MISSING_ARG);
+
+    acvp_orch_free(orch);
+}
+
+/*
+ * Contexts set up for a GET are not run by an orchestrator
+ */
+Test(ORCH, marked_as_get, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_ORCH *orch = NULL;
+
+    rv = acvp_mark_as_get_only(ctx, "/acvp/v1/test", NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_orch_create(&orch, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_orch_add_session(orch, ctx, 0);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+    acvp_orch_free(orch);
+}
+
+/*
+ * The failure of one session is kept apart from the others; the
+ * overflowing totp fails the first login before anything goes out
+ */
+Test(ORCH, session_fails, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_ORCH *orch = NULL;
+    ACVP_CTX *ctx2 = NULL;
+    ACVP_RESULT result = ACVP_SUCCESS;
+
+    setup_empty_ctx(&ctx2);
+    rv = acvp_set_2fa_callback(ctx, &dummy_totp_overflow);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_2fa_callback(ctx2, &dummy_totp_overflow);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_orch_create(&orch, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_orch_add_session(orch, ctx, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_orch_add_session(orch, ctx2, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_orch_run(orch);
+    cr_assert(rv == ACVP_TOTP_FAIL);
+    rv = acvp_orch_get_result(orch, ctx2, &result);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(result == ACVP_TOTP_FAIL);
+
+    acvp_orch_free(orch);
+    teardown_ctx(&ctx2);
+}
+
+/*
+ * Checks the arguments of acvp_session_step()
+ */
+Test(STEP, bad_args, .init = setup_full_ctx, .fini = teardown) {
+    int fd = 0, timeout = 0;
+
+    rv = acvp_session_step(NULL, 0, &fd, &timeout);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_session_step(ctx, 0, NULL, &timeout);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_session_step(ctx, 0, &fd, NULL);
+    cr_assert(rv == ACVP_MISSING_ARG);
+
+    rv = acvp_mark_as_get_only(ctx, "/acvp/v1/test", NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_session_step(ctx, 0, &fd, &timeout);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+    cr_assert(fd == -1);
+    cr_assert(timeout == 0);
+}
+
+/*
+ * A failed step ends the session, and the result is kept until the
+ * session is reset; the overflowing totp fails the login
+ */
+Test(STEP, login_fails, .init = setup_full_ctx, .fini = teardown) {
+    int fd = 0, timeout = 1;
+
+    rv = acvp_set_2fa_callback(ctx, &dummy_totp_overflow);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_session_step(ctx, 0, &fd, &timeout);
+    cr_assert(rv == ACVP_TOTP_FAIL);
+    cr_assert(fd == -1);
+    cr_assert(timeout == 0);
+    rv = acvp_session_step(ctx, 0, &fd, &timeout);
+    cr_assert(rv == ACVP_TOTP_FAIL);
+
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_2fa_callback(ctx, &dummy_totp);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_session_step(ctx, 0, &fd, &timeout);
+    cr_assert(rv != ACVP_TOTP_FAIL);
+}
+
+/*
+ * Rerunning the failed vector sets needs the session info file of the
+ * session, as resuming it does
+ */
+Test(RERUN_FAILED, bad_args, .init = setup_full_ctx, .fini = teardown) {
+    rv = acvp_rerun_failed_vector_sets(NULL, "testSession_0.json", 0);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_rerun_failed_vector_sets(ctx, NULL, 0);
+    cr_assert(rv != ACVP_SUCCESS);
+    rv = acvp_rerun_failed_vector_sets(ctx, "json/no_such_session.json", 0);
+    cr_assert(rv != ACVP_SUCCESS);
+    cr_assert(ctx->rerun_failed == 0);
+}
+
 /*
  * This calls run without adding totp callback - we expect
  * transport fail because we should make it through the rest
@@ -676,6 +870,911 @@ Test(PROCESS_TESTS, run_vectors_from_file, .init = setup_full_ctx, .fini = teard
 
 }
 
+typedef struct test_metrics_t {
+    int groups;
+    int totals;
+    int last_tg;
+    unsigned int tg_calls;
+    ACVP_METRICS vs;
+} TEST_METRICS;
+
+static void test_metrics_cb(const ACVP_METRICS *metrics, void *arg) {
+    TEST_METRICS *seen = arg;
+
+    if (metrics->tg_id) {
+        seen->groups++;
+        seen->last_tg = metrics->tg_id;
+        seen->tg_calls += metrics->crypto_calls;
+    } else {
+        seen->totals++;
+        seen->vs = *metrics;
+    }
+}
+
+/*
+ * Test that acvp_set_metrics_cb reports each test group and then the vector set
+ */
+Test(PROCESS_TESTS, metrics_cb, .init = setup_full_ctx, .fini = teardown) {
+    TEST_METRICS seen;
+
+    memzero_s(&seen, sizeof(TEST_METRICS));
+    rv = acvp_set_metrics_cb(NULL, test_metrics_cb, &seen);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_metrics_cb(ctx, test_metrics_cb, &seen);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_metrics.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.groups == 18);
+    cr_assert(seen.last_tg == 18);
+    cr_assert(seen.totals == 1);
+    cr_assert(seen.vs.vs_id == 7968 && seen.vs.tg_id == 0);
+    cr_assert(seen.vs.crypto_calls > 0);
+    cr_assert(seen.vs.crypto_calls == seen.tg_calls);
+    cr_assert(seen.vs.ns[ACVP_METRICS_OUTPUT] > 0);
+    cr_assert(seen.vs.ns[ACVP_METRICS_SERIALIZE] > 0);
+
+    /* Nothing more once the callback is taken away */
+    rv = acvp_set_metrics_cb(ctx, NULL, NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_metrics.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.totals == 1);
+    remove("json/rsp_metrics.json");
+}
+
+typedef struct test_events_t {
+    int vs_start;
+    int vs_done;
+    int tg_done;
+    int in_order;
+    ACVP_EVENT last;
+} TEST_EVENTS;
+
+static void test_event_cb(const ACVP_EVENT *event, void *arg) {
+    TEST_EVENTS *seen = arg;
+
+    switch (event->type) {
+    case ACVP_EVENT_VS_START:
+        seen->vs_start++;
+        break;
+    case ACVP_EVENT_TG_DONE:
+        seen->tg_done++;
+        if (event->tg_done == seen->tg_done && event->tg_id == seen->tg_done) {
+            seen->in_order++;
+        }
+        break;
+    case ACVP_EVENT_VS_DONE:
+        seen->vs_done++;
+        break;
+    case ACVP_EVENT_TRANSFER:
+    case ACVP_EVENT_RETRY_WAIT:
+    default:
+        break;
+    }
+    seen->last = *event;
+}
+
+/*
+ * Test that acvp_set_event_cb reports the vector set, and each test group
+ * in turn as it is done
+ */
+Test(PROCESS_TESTS, event_cb, .init = setup_full_ctx, .fini = teardown) {
+    TEST_EVENTS seen;
+
+    memzero_s(&seen, sizeof(TEST_EVENTS));
+    rv = acvp_set_event_cb(NULL, test_event_cb, &seen);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_event_cb(ctx, test_event_cb, &seen);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_events.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.vs_start == 1);
+    cr_assert(seen.tg_done == 18);
+    cr_assert(seen.in_order == 18);
+    cr_assert(seen.vs_done == 1);
+    cr_assert(seen.last.type == ACVP_EVENT_VS_DONE);
+    cr_assert(seen.last.vs_id == 7968);
+    cr_assert(seen.last.result == ACVP_SUCCESS);
+    cr_assert(seen.last.tg_done == 18 && seen.last.tg_cnt == 18);
+    cr_assert(seen.last.elapsed_ns > 0);
+
+    /* Nothing more once the callback is taken away */
+    rv = acvp_set_event_cb(ctx, NULL, NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_events.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.vs_done == 1);
+    remove("json/rsp_events.json");
+}
+
+/* Expands the request file to several vector sets with distinct vsIds */
+static void write_req_multi(const char *path) {
+    JSON_Value *val = NULL, *vs_val = NULL;
+    JSON_Array *arr = NULL, *urls = NULL;
+    char url[64];
+    int i = 0;
+
+    val = json_parse_file("json/req.json");
+    cr_assert(val != NULL);
+    arr = json_value_get_array(val);
+    urls = json_object_get_array(json_array_get_object(arr, 0), "vectorSetUrls");
+    json_array_clear(urls);
+    vs_val = json_array_get_value(arr, 1);
+    for (i = 0; i < 6; i++) {
+        snprintf(url, sizeof(url), "/acvp/v1/testSessions/2153/vectorSets/%d", 8000 + i);
+        json_array_append_string(urls, url);
+        if (i) {
+            json_array_append_value(arr, json_value_deep_copy(vs_val));
+        }
+        json_object_set_number(json_array_get_object(arr, i + 1), "vsId", 8000 + i);
+    }
+    cr_assert(json_serialize_to_file(val, path) == JSONSuccess);
+    json_value_free(val);
+}
+
+static char *read_rsp_string(const char *path) {
+    JSON_Value *val = NULL;
+    char *str = NULL;
+
+    val = json_parse_file(path);
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    return str;
+}
+
+/*
+ * acvp_run_vectors_from_file with several workers writes the same
+ * responses, in the same order, as a serial run
+ */
+Test(PROCESS_TESTS, run_vectors_from_file_parallel, .init = setup_full_ctx, .fini = teardown) {
+    JSON_Value *val = NULL;
+    char *serial = NULL, *parallel = NULL;
+
+    write_req_multi("json/req_multi.json");
+
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_serial.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_free_test_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx = NULL;
+    setup_full_ctx();
+    rv = acvp_set_max_parallel_vector_sets(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_parallel.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/rsp_serial.json");
+    cr_assert(val != NULL);
+    cr_assert(json_array_get_count(json_value_get_array(val)) == 7);
+    serial = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    val = json_parse_file("json/rsp_parallel.json");
+    cr_assert(val != NULL);
+    parallel = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    cr_assert(serial != NULL && parallel != NULL);
+    cr_assert(strcmp(serial, parallel) == 0);
+
+    json_free_serialized_string(serial);
+    json_free_serialized_string(parallel);
+    remove("json/req_multi.json");
+    remove("json/rsp_serial.json");
+    remove("json/rsp_parallel.json");
+}
+
+/*
+ * With a memory budget smaller than any test group, every finished group
+ * is moved to disk, and the response file still has the same responses
+ */
+Test(PROCESS_TESTS, memory_budget, .init = setup_full_ctx, .fini = teardown) {
+    char *expected = NULL, *spilled = NULL;
+
+    rv = acvp_set_memory_budget(NULL, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_memory.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    expected = read_rsp_string("json/rsp_memory.json");
+
+    rv = acvp_free_test_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx = NULL;
+    setup_full_ctx();
+    rv = acvp_set_memory_budget(ctx, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_max_parallel_vector_sets(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_memory.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    spilled = read_rsp_string("json/rsp_memory.json");
+    cr_assert(strcmp(expected, spilled) == 0);
+
+    json_free_serialized_string(expected);
+    json_free_serialized_string(spilled);
+    remove("json/req_multi.json");
+    remove("json/rsp_memory.json");
+}
+
+/*
+ * Test that acvp_get_memory_usage gives what the session holds, and what a
+ * finished vector set held, as the metrics callback was told
+ */
+Test(PROCESS_TESTS, memory_usage, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_MEMORY_USAGE session, vs;
+    TEST_METRICS seen;
+
+    rv = acvp_get_memory_usage(NULL, 0, &session);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_get_memory_usage(ctx, 0, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_get_memory_usage(ctx, 7968, &vs);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    memzero_s(&seen, sizeof(TEST_METRICS));
+    rv = acvp_set_metrics_cb(ctx, test_metrics_cb, &seen);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_memory.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_get_memory_usage(ctx, 7968, &vs);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(vs.peak > 0 && vs.peak >= vs.current);
+    cr_assert(vs.peak == seen.vs.mem_peak && vs.current == seen.vs.mem_current);
+    rv = acvp_get_memory_usage(ctx, 0, &session);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(session.current > 0);
+    cr_assert(session.peak >= vs.peak && session.peak >= session.current);
+
+    /* Counted the same with the responses built on the heap */
+    rv = acvp_set_memory_budget(ctx, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_memory.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_get_memory_usage(ctx, 7968, &vs);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(vs.peak > 0 && vs.peak == seen.vs.mem_peak);
+    remove("json/rsp_memory.json");
+}
+
+typedef struct test_starts_t {
+    int count;
+    int vs_id[6];
+} TEST_STARTS;
+
+static void test_start_cb(const ACVP_EVENT *event, void *arg) {
+    TEST_STARTS *starts = arg;
+
+    if (event->type == ACVP_EVENT_VS_START && starts->count < 6) {
+        starts->vs_id[starts->count++] = event->vs_id;
+    }
+}
+
+/*
+ * With several workers the vector set with the most work in it is started
+ * first, even though it is listed last
+ */
+Test(PROCESS_TESTS, longest_vector_set_first, .init = setup_full_ctx, .fini = teardown) {
+    JSON_Value *val = NULL;
+    JSON_Array *groups = NULL;
+    TEST_STARTS starts;
+    int i = 0, count = 0;
+
+    rv = acvp_set_test_case_cost(NULL, ACVP_CMAC_AES, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_test_case_cost(ctx, ACVP_CIPHER_END, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_test_case_cost(ctx, ACVP_CMAC_AES, 50000);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    /* The last vector set gets its test groups twice over */
+    write_req_multi("json/req_multi.json");
+    val = json_parse_file("json/req_multi.json");
+    cr_assert(val != NULL);
+    groups = json_object_get_array(json_array_get_object(json_value_get_array(val), 6), "testGroups");
+    count = (int)json_array_get_count(groups);
+    for (i = 0; i < count; i++) {
+        json_array_append_value(groups, json_value_deep_copy(json_array_get_value(groups, i)));
+    }
+    cr_assert(json_serialize_to_file(val, "json/req_multi.json") == JSONSuccess);
+    json_value_free(val);
+
+    memzero_s(&starts, sizeof(TEST_STARTS));
+    rv = acvp_set_event_cb(ctx, test_start_cb, &starts);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_max_parallel_vector_sets(ctx, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_multi.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(starts.count == 6);
+    cr_assert(starts.vs_id[0] == 8005 || starts.vs_id[1] == 8005 || starts.vs_id[2] == 8005);
+    remove("json/req_multi.json");
+    remove("json/rsp_multi.json");
+}
+
+/*
+ * The estimates cover the vector sets acvp_get_vector_set_count() counts,
+ * and the critical path is the worker that finishes last
+ */
+Test(PROCESS_TESTS, estimate_vector_sets, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_VS_ESTIMATE est[32];
+    ACVP_RUN_ESTIMATE run;
+    unsigned long long int critical = 0, longest = 0, pqg = 0;
+    int count = 0, i = 0;
+
+    rv = acvp_estimate_vector_sets(NULL, 0, est, 32, &count, &run);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_estimate_vector_sets(ctx, 0, NULL, 32, &count, &run);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_estimate_vector_sets(ctx, 0, est, 32, NULL, &run);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_estimate_vector_sets(ctx, 0, NULL, 0, &count, NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(count == acvp_get_vector_set_count(ctx));
+    cr_assert(count <= 32);
+
+    rv = acvp_estimate_vector_sets(ctx, 1, est, 32, &count, &run);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(run.parallel == 1);
+    cr_assert(run.wall_ns == run.total_ns);
+    for (i = 0; i < count; i++) {
+        cr_assert(est[i].test_cases > 0 && est[i].ns > 0 && est[i].bytes > 0);
+        cr_assert(est[i].worker == 0 && est[i].critical);
+        if (est[i].cipher == ACVP_DSA_PQGGEN) pqg = est[i].ns;
+    }
+    /* The Monte Carlo tests of CBC make it the longer of the two */
+    cr_assert(est[0].cipher == ACVP_AES_CBC && est[1].cipher == ACVP_AES_GCM);
+    cr_assert(est[0].ns > est[1].ns);
+
+    rv = acvp_set_test_case_cost(ctx, ACVP_DSA_PQGGEN, 1000000000ULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_estimate_vector_sets(ctx, 4, est, 32, &count, &run);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(run.parallel == 4);
+    cr_assert(run.wall_ns < run.total_ns);
+    for (i = 0; i < count; i++) {
+        cr_assert(est[i].worker >= 0 && est[i].worker < 4);
+        if (est[i].critical) critical += est[i].ns;
+        if (est[i].ns > longest) longest = est[i].ns;
+        if (est[i].cipher == ACVP_DSA_PQGGEN) {
+            cr_assert(est[i].ns > pqg);
+            cr_assert(est[i].critical && est[i].start_ns == 0);
+        }
+    }
+    cr_assert(critical == run.wall_ns);
+    cr_assert(run.wall_ns >= longest);
+    cr_assert(run.peak_bytes > 0);
+}
+
+typedef struct test_loader_t {
+    int calls;
+    ACVP_CIPHER cipher;
+    ACVP_RESULT rv;
+} TEST_LOADER;
+
+static ACVP_RESULT test_cap_loader(ACVP_CTX *c, ACVP_CIPHER cipher, void *arg) {
+    TEST_LOADER *loader = arg;
+
+    loader->calls++;
+    loader->cipher = cipher;
+    if (loader->rv != ACVP_SUCCESS) {
+        return loader->rv;
+    }
+    cr_assert(acvp_cap_cmac_enable(c, ACVP_CMAC_AES, &dummy_handler_success) == ACVP_SUCCESS);
+    cr_assert(acvp_cap_cmac_set_parm(c, ACVP_CMAC_AES, ACVP_CMAC_MACLEN, 128) == ACVP_SUCCESS);
+    cr_assert(acvp_cap_cmac_set_parm(c, ACVP_CMAC_AES, ACVP_CMAC_KEYLEN, 128) == ACVP_SUCCESS);
+    cr_assert(acvp_cap_cmac_set_parm(c, ACVP_CMAC_AES, ACVP_CMAC_DIRECTION_GEN, 1) == ACVP_SUCCESS);
+    return ACVP_SUCCESS;
+}
+
+/*
+ * With a capability loader, a context without capabilities asks for each
+ * cipher of the request file once, before any vector set is run, and gives
+ * the same responses as one with every capability enabled
+ */
+Test(PROCESS_TESTS, cap_loader, .init = setup, .fini = teardown) {
+    TEST_LOADER loader;
+    char *full = NULL, *loaded = NULL;
+
+    memset(&loader, 0, sizeof(loader));
+    rv = acvp_set_cap_loader(NULL, test_cap_loader, &loader);
+    cr_assert(rv == ACVP_NO_CTX);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_set_cap_loader(ctx, test_cap_loader, &loader);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_max_parallel_vector_sets(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_loaded.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(loader.calls == 1);
+    cr_assert(loader.cipher == ACVP_CMAC_AES);
+    loaded = read_rsp_string("json/rsp_loaded.json");
+
+    acvp_free_test_session(ctx);
+    ctx = NULL;
+    setup_full_ctx();
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_full.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    full = read_rsp_string("json/rsp_full.json");
+    cr_assert(strcmp(full, loaded) == 0);
+
+    /* Not asked for what is enabled already; a failure stops the run */
+    memset(&loader, 0, sizeof(loader));
+    rv = acvp_set_cap_loader(ctx, test_cap_loader, &loader);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_full.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(loader.calls == 0);
+    acvp_free_test_session(ctx);
+    ctx = NULL;
+    setup_empty_ctx(&ctx);
+    loader.rv = ACVP_UNSUPPORTED_OP;
+    rv = acvp_set_cap_loader(ctx, test_cap_loader, &loader);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_loaded.json");
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+    cr_assert(loader.calls == 1);
+
+    json_free_serialized_string(full);
+    json_free_serialized_string(loaded);
+    remove("json/req_multi.json");
+    remove("json/rsp_loaded.json");
+    remove("json/rsp_full.json");
+}
+
+/*
+ * acvp_set_vector_set_shard splits a request file into shards that
+ * acvp_merge_vector_rsp_files puts back together as a serial run has it
+ */
+Test(PROCESS_TESTS, run_vectors_from_file_shards, .init = setup_full_ctx, .fini = teardown) {
+    const char *shards[] = { "json/rsp_shard2.json", "json/rsp_shard1.json" };
+    const char *twice[] = { "json/rsp_shard1.json", "json/rsp_shard1.json" };
+    JSON_Value *val = NULL;
+    JSON_Array *arr = NULL, *urls = NULL;
+    char *serial = NULL, *merged = NULL;
+
+    rv = acvp_set_vector_set_shard(NULL, 1, 2);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_vector_set_shard(ctx, 0, 2);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_vector_set_shard(ctx, 3, 2);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_merge_vector_rsp_files(ctx, NULL, 2, "json/rsp_merged.json");
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_merge_vector_rsp_files(ctx, shards, 2, NULL);
+    cr_assert(rv == ACVP_MISSING_ARG);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_serial.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_vector_set_shard(ctx, 1, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_shard1.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_vector_set_shard(ctx, 2, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_shard2.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    /* Every other vector set, with only its URLs */
+    val = json_parse_file("json/rsp_shard1.json");
+    cr_assert(val != NULL);
+    arr = json_value_get_array(val);
+    cr_assert(json_array_get_count(arr) == 4);
+    urls = json_object_get_array(json_array_get_object(arr, 0), "vectorSetUrls");
+    cr_assert(json_array_get_count(urls) == 3);
+    cr_assert(strcmp(json_array_get_string(urls, 1), "/acvp/v1/testSessions/2153/vectorSets/8002") == 0);
+    cr_assert(json_object_get_uint(json_array_get_object(arr, 3), "vsId") == 8004);
+    json_value_free(val);
+
+    rv = acvp_merge_vector_rsp_files(ctx, shards, 2, "json/rsp_merged.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    serial = read_rsp_string("json/rsp_serial.json");
+    merged = read_rsp_string("json/rsp_merged.json");
+    cr_assert(serial != NULL && merged != NULL);
+    cr_assert(strcmp(serial, merged) == 0);
+
+    /* A vector set can only come from one of the files */
+    rv = acvp_merge_vector_rsp_files(ctx, twice, 2, "json/rsp_merged.json");
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    json_free_serialized_string(serial);
+    json_free_serialized_string(merged);
+    remove("json/req_multi.json");
+    remove("json/rsp_serial.json");
+    remove("json/rsp_shard1.json");
+    remove("json/rsp_shard2.json");
+    remove("json/rsp_merged.json");
+}
+
+/*
+ * Turns a response file into expected results as the server would give
+ * them, each vector set behind its protocol version
+ */
+static void write_expected(const char *rsp_filename, const char *path) {
+    JSON_Value *val = NULL, *out_val = NULL, *vs_val = NULL;
+    JSON_Array *arr = NULL, *out = NULL, *vs = NULL;
+    int i = 0;
+
+    val = json_parse_file(rsp_filename);
+    cr_assert(val != NULL);
+    arr = json_value_get_array(val);
+    out_val = json_value_init_array();
+    out = json_value_get_array(out_val);
+    json_array_append_value(out, json_value_deep_copy(json_array_get_value(arr, 0)));
+    for (i = 1; i < (int)json_array_get_count(arr); i++) {
+        vs_val = json_value_init_array();
+        vs = json_value_get_array(vs_val);
+        json_array_append_value(vs, json_parse_string("{\"acvVersion\":\"1.0\"}"));
+        json_array_append_value(vs, json_value_deep_copy(json_array_get_value(arr, i)));
+        json_array_append_value(out, vs_val);
+    }
+    cr_assert(json_serialize_to_file(out_val, path) == JSONSuccess);
+    json_value_free(out_val);
+    json_value_free(val);
+}
+
+static JSON_Array *expected_tests(JSON_Value *val, int vs, int tg) {
+    JSON_Array *vs_arr = json_array_get_array(json_value_get_array(val), vs);
+
+    return json_object_get_array(json_array_get_object(json_object_get_array(
+               json_array_get_object(vs_arr, 1), "testGroups"), tg), "tests");
+}
+
+/*
+ * acvp_verify_vectors_from_file finds the test cases whose responses are
+ * not the expected ones
+ */
+Test(PROCESS_TESTS, verify_vectors_from_file, .init = setup_full_ctx, .fini = teardown) {
+    JSON_Value *val = NULL, *tc_val = NULL;
+    JSON_Object *tc = NULL;
+    int mismatches = -1;
+
+    rv = acvp_verify_vectors_from_file(NULL, "json/rsp_verify.json", "json/expected.json", &mismatches);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_verify_vectors_from_file(ctx, NULL, "json/expected.json", &mismatches);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_verify_vectors_from_file(ctx, "json/rsp_verify.json", NULL, &mismatches);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_verify_vectors_from_file(ctx, "json/missing.json", "json/missing.json", &mismatches);
+    cr_assert(rv == ACVP_MALFORMED_JSON);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_verify.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    write_expected("json/rsp_verify.json", "json/expected.json");
+
+    rv = acvp_set_max_parallel_vector_sets(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_verify_vectors_from_file(ctx, "json/rsp_verify.json", "json/expected.json", &mismatches);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mismatches == 0);
+
+    /* One answer changed, one test case the responses do not have */
+    val = json_parse_file("json/expected.json");
+    cr_assert(val != NULL);
+    tc = json_array_get_object(expected_tests(val, 3, 0), 0);
+    tc_val = json_object_get_value_at(tc, 1);
+    if (json_value_get_type(tc_val) == JSONBoolean) {
+        json_object_set_boolean(tc, json_object_get_name(tc, 1), !json_value_get_boolean(tc_val));
+    } else {
+        json_object_set_string(tc, json_object_get_name(tc, 1), "FF");
+    }
+    tc = json_array_get_object(expected_tests(val, 5, 1), 0);
+    json_object_set_number(tc, "tcId", 99999);
+    cr_assert(json_serialize_to_file(val, "json/expected.json") == JSONSuccess);
+    json_value_free(val);
+
+    rv = acvp_verify_vectors_from_file(ctx, "json/rsp_verify.json", "json/expected.json", &mismatches);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mismatches == 2);
+
+    remove("json/req_multi.json");
+    remove("json/rsp_verify.json");
+    remove("json/expected.json");
+}
+
+/*
+ * acvp_set_vector_set_filter runs only the vector sets with the given vsIds
+ */
+Test(PROCESS_TESTS, run_vectors_from_file_filter, .init = setup_full_ctx, .fini = teardown) {
+    int vs_ids[] = { 8005, 8001, 9999 };
+    JSON_Value *val = NULL;
+    JSON_Array *arr = NULL, *urls = NULL;
+
+    rv = acvp_set_vector_set_filter(NULL, vs_ids, 3);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_vector_set_filter(ctx, NULL, 3);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_vector_set_filter(ctx, vs_ids, 3);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_filter.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/rsp_filter.json");
+    cr_assert(val != NULL);
+    arr = json_value_get_array(val);
+    cr_assert(json_array_get_count(arr) == 3);
+    urls = json_object_get_array(json_array_get_object(arr, 0), "vectorSetUrls");
+    cr_assert(json_array_get_count(urls) == 2);
+    cr_assert(strcmp(json_array_get_string(urls, 0), "/acvp/v1/testSessions/2153/vectorSets/8001") == 0);
+    cr_assert(json_object_get_uint(json_array_get_object(arr, 1), "vsId") == 8001);
+    cr_assert(json_object_get_uint(json_array_get_object(arr, 2), "vsId") == 8005);
+    json_value_free(val);
+
+    /* Cleared again, every vector set runs */
+    rv = acvp_set_vector_set_filter(ctx, NULL, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_filter.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    val = json_parse_file("json/rsp_filter.json");
+    cr_assert(val != NULL);
+    cr_assert(json_array_get_count(json_value_get_array(val)) == 7);
+    json_value_free(val);
+
+    remove("json/req_multi.json");
+    remove("json/rsp_filter.json");
+}
+
+/* Keeps the first lines of a file, followed by part of the next line */
+static int keep_lines(const char *path, int lines) {
+    FILE *in = NULL, *out = NULL;
+    int count = 0, c = 0;
+
+    in = fopen(path, "r");
+    out = fopen("json/journal_part.txt", "w");
+    cr_assert(in != NULL && out != NULL);
+    while ((c = fgetc(in)) != EOF) {
+        if (count == lines) {
+            /* A line cut short, as by a crash */
+            fputs("{\"vsId\":7968,\"tgId\":6,\"resp", out);
+            break;
+        }
+        fputc(c, out);
+        if (c == '\n') count++;
+    }
+    fclose(in);
+    fclose(out);
+    remove(path);
+    rename("json/journal_part.txt", path);
+    return count;
+}
+
+static int count_lines(const char *path) {
+    FILE *fp = NULL;
+    int count = 0, c = 0;
+
+    fp = fopen(path, "r");
+    if (!fp) {
+        return 0;
+    }
+    while ((c = fgetc(fp)) != EOF) {
+        if (c == '\n') count++;
+    }
+    fclose(fp);
+    return count;
+}
+
+/*
+ * With a checkpoint journal, a rerun of the vector set skips the test groups
+ * already in it and writes the same responses
+ */
+Test(PROCESS_TESTS, checkpoint_journal, .init = setup_full_ctx, .fini = teardown) {
+    TEST_METRICS seen;
+    char *first = NULL, *resumed = NULL;
+
+    remove("json/journal.txt");
+    rv = acvp_set_checkpoint_journal(NULL, "json/journal.txt");
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_checkpoint_journal(ctx, NULL);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_set_checkpoint_journal(ctx, "json/journal.txt");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_journal.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(count_lines("json/journal.txt") == 18);
+    first = read_rsp_string("json/rsp_journal.json");
+
+    /* Stopped after the fifth group */
+    cr_assert(keep_lines("json/journal.txt", 5) == 5);
+
+    rv = acvp_free_test_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx = NULL;
+    setup_full_ctx();
+    memzero_s(&seen, sizeof(TEST_METRICS));
+    rv = acvp_set_metrics_cb(ctx, test_metrics_cb, &seen);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_checkpoint_journal(ctx, "json/journal.txt");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_journal.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.groups == 13);
+    resumed = read_rsp_string("json/rsp_journal.json");
+    cr_assert(first != NULL && resumed != NULL);
+    cr_assert(strcmp(first, resumed) == 0);
+
+    /* Nothing is left to run */
+    memzero_s(&seen, sizeof(TEST_METRICS));
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_journal.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.groups == 0);
+
+    json_free_serialized_string(first);
+    json_free_serialized_string(resumed);
+    remove("json/journal.txt");
+    remove("json/rsp_journal.json");
+}
+
+/* Gives a MAC other than dummy_handler_success does */
+static int memo_drift_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_CMAC_TC *tc = test_case->tc.cmac;
+
+    if (!tc->verify) {
+        tc->mac[0] = 0xAB;
+        tc->mac_len = 1;
+    }
+    return 0;
+}
+
+/*
+ * With a result memo, a replay of the request file takes the test groups
+ * from the store instead of running them and writes the same responses, and
+ * sampled groups whose responses have changed are caught and stored again
+ */
+Test(PROCESS_TESTS, result_memo, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_MEMO_STATS stats;
+    TEST_METRICS seen;
+    char *first = NULL, *replayed = NULL;
+
+    remove("json/memo.txt");
+    rv = acvp_get_memo_stats(ctx, &stats);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+    rv = acvp_set_result_memo(NULL, "json/memo.txt", 10);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_result_memo(ctx, "json/memo.txt", 101);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_result_memo(ctx, "json/memo.txt", 0);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_memo.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_get_memo_stats(ctx, &stats);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(stats.hits == 0 && stats.misses == 18 && stats.stored == 18);
+    cr_assert(count_lines("json/memo.txt") == 18);
+    first = read_rsp_string("json/rsp_memo.json");
+
+    /* Replayed by a new context, nothing is run */
+    rv = acvp_free_test_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx = NULL;
+    setup_full_ctx();
+    memzero_s(&seen, sizeof(TEST_METRICS));
+    rv = acvp_set_metrics_cb(ctx, test_metrics_cb, &seen);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_result_memo(ctx, "json/memo.txt", 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_memo.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(seen.groups == 0);
+    rv = acvp_get_memo_stats(ctx, &stats);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(stats.hits == 18 && stats.misses == 0 && stats.sampled == 0 && stats.stored == 0);
+    replayed = read_rsp_string("json/rsp_memo.json");
+    cr_assert(first != NULL && replayed != NULL);
+    cr_assert(strcmp(first, replayed) == 0);
+    json_free_serialized_string(replayed);
+
+    /* Every group sampled against a module that now gives another MAC */
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    acvp_locate_cap_entry(ctx, ACVP_CMAC_AES)->crypto_handler = &memo_drift_handler;
+    rv = acvp_set_result_memo(ctx, "json/memo.txt", 100);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_memo.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_get_memo_stats(ctx, &stats);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(stats.hits > 0 && stats.sampled == stats.hits);
+    cr_assert(stats.drifted > 0 && stats.stored >= stats.drifted);
+    replayed = read_rsp_string("json/rsp_memo.json");
+    cr_assert(replayed != NULL && strcmp(first, replayed) != 0);
+
+    /* The store now has what the module gives */
+    json_free_serialized_string(first);
+    first = replayed;
+    rv = acvp_reset_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_result_memo(ctx, "json/memo.txt", 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_memo.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_get_memo_stats(ctx, &stats);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(stats.hits == 18 && stats.drifted == 0);
+    replayed = read_rsp_string("json/rsp_memo.json");
+    cr_assert(replayed != NULL && strcmp(first, replayed) == 0);
+
+    json_free_serialized_string(first);
+    json_free_serialized_string(replayed);
+    remove("json/memo.txt");
+    remove("json/rsp_memo.json");
+}
+
+static int log_msgs = 0;
+
+static ACVP_RESULT count_log(char *msg, ACVP_LOG_LVL level) {
+    log_msgs++;
+    return ACVP_SUCCESS;
+}
+
+/* Runs json/req.json at the verbose level, counting the messages logged */
+static int count_log_msgs(int async_entries) {
+    ACVP_CTX *log_ctx = NULL;
+
+    log_msgs = 0;
+    rv = acvp_create_test_session(&log_ctx, &count_log, ACVP_LOG_LVL_VERBOSE);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_cmac_enable(log_ctx, ACVP_CMAC_AES, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    if (async_entries) {
+        rv = acvp_set_async_log(log_ctx, async_entries);
+        cr_assert(rv == ACVP_SUCCESS);
+    }
+    rv = acvp_run_vectors_from_file(log_ctx, "json/req.json", "json/rsp_log.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    /* The sink is drained before the session is freed */
+    rv = acvp_free_test_session(log_ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    remove("json/rsp_log.json");
+    return log_msgs;
+}
+
+/*
+ * The async log sink hands the callback every message, even when it has to
+ * wait for room in a small ring
+ */
+Test(PROCESS_TESTS, async_log, .init = setup_full_ctx, .fini = teardown) {
+    int sync_msgs = 0;
+
+    rv = acvp_set_async_log(NULL, 16);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_async_log(ctx, -1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_async_log(ctx, ACVP_LOG_RING_MAX + 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_async_log(ctx, 16);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_async_log(ctx, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    sync_msgs = count_log_msgs(0);
+    cr_assert(sync_msgs > 100);
+    cr_assert(count_log_msgs(2) == sync_msgs);
+    cr_assert(count_log_msgs(ACVP_LOG_RING_MAX) == sync_msgs);
+}
+
 /*
  * Test acvp_upload_vectors_from_file
  */
@@ -818,6 +1917,236 @@ Test(PROCESS_TESTS, get_vector_set_count, .init = setup_full_ctx, .fini = teardo
 
 }
 
+/*
+ * Test acvp_set_max_parallel_vector_sets
+ */
+Test(PROCESS_TESTS, set_max_parallel_vector_sets, .init = setup_full_ctx, .fini = teardown) {
+    rv = acvp_set_max_parallel_vector_sets(NULL, 4);
+    cr_assert(rv == ACVP_NO_CTX);
+
+    rv = acvp_set_max_parallel_vector_sets(ctx, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_set_max_parallel_vector_sets(ctx, 65);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_set_max_parallel_vector_sets(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    /* Still nothing to process without any vector sets from the server */
+    rv = acvp_process_tests(ctx);
+    cr_assert(rv == ACVP_MISSING_ARG);
+}
+
+/*
+ * Test acvp_set_worker_affinity, and that pinned workers write the same
+ * responses as a serial run
+ */
+Test(PROCESS_TESTS, set_worker_affinity, .init = setup_full_ctx, .fini = teardown) {
+    char *serial = NULL, *pinned = NULL;
+    JSON_Value *val = NULL;
+    int cpus[2] = { 0, 0 }, bad = -1;
+
+    rv = acvp_set_worker_affinity(NULL, ACVP_AFFINITY_CPUS, cpus, 2);
+    cr_assert(rv == ACVP_NO_CTX);
+
+    rv = acvp_set_worker_affinity(ctx, ACVP_AFFINITY_CPUS, NULL, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_set_worker_affinity(ctx, ACVP_AFFINITY_CPUS, &bad, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_set_worker_affinity(ctx, ACVP_AFFINITY_NUMA, NULL, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_set_worker_affinity(ctx, ACVP_AFFINITY_NONE, NULL, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_serial.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_free_test_session(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx = NULL;
+    setup_full_ctx();
+    rv = acvp_set_max_parallel_vector_sets(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_max_parallel_test_cases(ctx, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_worker_affinity(ctx, ACVP_AFFINITY_CPUS, cpus, 2);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_pinned.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/rsp_serial.json");
+    cr_assert(val != NULL);
+    serial = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    val = json_parse_file("json/rsp_pinned.json");
+    cr_assert(val != NULL);
+    pinned = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    cr_assert(serial != NULL && pinned != NULL);
+    cr_assert(strcmp(serial, pinned) == 0);
+
+    json_free_serialized_string(serial);
+    json_free_serialized_string(pinned);
+    remove("json/req_multi.json");
+    remove("json/rsp_serial.json");
+    remove("json/rsp_pinned.json");
+}
+
+/*
+ * acvp_run_remote_worker takes the request files left in its directory and
+ * writes the same responses for them as acvp_run_vectors_from_file, then
+ * stops once the coordinator is done
+ */
+Test(PROCESS_TESTS, run_remote_worker, .init = setup_full_ctx, .fini = teardown) {
+    char *local = NULL, *remote = NULL;
+    JSON_Value *val = NULL;
+    FILE *fp = NULL;
+
+    rv = acvp_run_remote_worker(NULL, "json", 0);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_run_remote_worker(ctx, NULL, 0);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_set_remote_workers(ctx, "json", -1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_remote_workers(ctx, NULL, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    write_req_multi("json/req_multi.json");
+    rv = acvp_run_vectors_from_file(ctx, "json/req_multi.json", "json/rsp_local.json");
+    cr_assert(rv == ACVP_SUCCESS);
+
+    write_req_multi("json/vs-1.req.json");
+    fp = fopen("json/done", "w");
+    cr_assert(fp != NULL);
+    fclose(fp);
+    rv = acvp_run_remote_worker(ctx, "json", 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(fopen("json/vs-1.req.json", "r") == NULL);
+    cr_assert(fopen("json/vs-1.run.json", "r") == NULL);
+
+    val = json_parse_file("json/rsp_local.json");
+    cr_assert(val != NULL);
+    local = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    val = json_parse_file("json/vs-1.rsp.json");
+    cr_assert(val != NULL);
+    remote = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    cr_assert(local != NULL && remote != NULL);
+    cr_assert(strcmp(local, remote) == 0);
+
+    json_free_serialized_string(local);
+    json_free_serialized_string(remote);
+    remove("json/req_multi.json");
+    remove("json/rsp_local.json");
+    remove("json/vs-1.rsp.json");
+    remove("json/done");
+}
+
+/*
+ * Test acvp_create_exec_ctx
+ */
+Test(PROCESS_TESTS, create_exec_ctx, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_CTX *exec = NULL;
+
+    exec = acvp_create_exec_ctx(NULL);
+    cr_assert(exec == NULL);
+
+    exec = acvp_create_exec_ctx(ctx);
+    cr_assert(exec != NULL);
+    cr_assert(exec->session == ctx);
+    cr_assert(exec->caps_list == ctx->caps_list);
+    cr_assert(exec->exec.kat_resp == NULL);
+    cr_assert(exec->exec.curl_buf == NULL);
+    cr_assert(exec->exec.curl_read_ctr == 0);
+    acvp_free_exec_ctx(exec);
+}
+
+/*
+ * The serialized registration is kept until a capability changes, and each
+ * caller gets a copy of its own
+ */
+Test(PROCESS_TESTS, get_current_registration, .init = setup_full_ctx, .fini = teardown) {
+    char *reg = NULL, *reg2 = NULL;
+    int len = 0, len2 = 0;
+
+    cr_assert(acvp_get_current_registration(NULL, &len) == NULL);
+    reg = acvp_get_current_registration(ctx, &len);
+    cr_assert(reg != NULL);
+    cr_assert(len == (int)strlen(reg));
+    cr_assert(strstr(reg, "ECB") == NULL);
+    reg2 = acvp_get_current_registration(ctx, &len2);
+    cr_assert(reg2 != NULL && reg2 != reg);
+    cr_assert(len2 == len);
+    cr_assert(!strcmp(reg, reg2));
+    free(reg2);
+
+    /* Changed capabilities are serialized again */
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_ECB, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_ECB, ACVP_SYM_CIPH_PARM_DIR, ACVP_SYM_CIPH_DIR_BOTH);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_ECB, ACVP_SYM_CIPH_KEYLEN, 128);
+    cr_assert(rv == ACVP_SUCCESS);
+    reg2 = acvp_get_current_registration(ctx, &len2);
+    cr_assert(reg2 != NULL);
+    cr_assert(strstr(reg2, "ECB") != NULL);
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_ECB, ACVP_SYM_CIPH_KEYLEN, 256);
+    cr_assert(rv == ACVP_SUCCESS);
+    free(reg);
+    reg = acvp_get_current_registration(ctx, &len);
+    cr_assert(reg != NULL);
+    cr_assert(len > len2);
+    free(reg);
+    free(reg2);
+}
+
+/*
+ * Exec contexts look capabilities up in the snapshot they were made with;
+ * one enabled afterwards is only seen by the session, and by exec contexts
+ * made from the next snapshot
+ */
+Test(PROCESS_TESTS, cap_snapshot, .init = setup_full_ctx, .fini = teardown) {
+    ACVP_CTX *exec = NULL, *exec2 = NULL;
+    ACVP_CAP_SNAPSHOT *snap = NULL;
+
+    rv = acvp_cap_snapshot_take(NULL);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_snapshot_take(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    snap = ctx->caps_snap;
+    cr_assert(snap != NULL);
+
+    exec = acvp_create_exec_ctx(ctx);
+    cr_assert(exec != NULL);
+    cr_assert(exec->caps_snap == snap);
+    cr_assert(snap->refs == 2);
+    cr_assert(acvp_locate_cap_entry(exec, ACVP_AES_GCM) == ctx->caps_index[ACVP_AES_GCM]);
+    rv = acvp_cap_snapshot_take(exec);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_ECB, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(ctx->caps_snap == NULL);
+    cr_assert(snap->refs == 1);
+    cr_assert(acvp_locate_cap_entry(ctx, ACVP_AES_ECB) != NULL);
+    cr_assert(acvp_locate_cap_entry(exec, ACVP_AES_ECB) == NULL);
+
+    rv = acvp_cap_snapshot_take(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+    exec2 = acvp_create_exec_ctx(ctx);
+    cr_assert(exec2 != NULL);
+    cr_assert(acvp_locate_cap_entry(exec2, ACVP_AES_ECB) != NULL);
+    acvp_free_exec_ctx(exec);
+    acvp_free_exec_ctx(exec2);
+    cr_assert(ctx->caps_snap->refs == 1);
+}
+
 /*
  * Test acvp_mark_as_put_after_test
  */
@@ -11,6 +11,8 @@
 
 #include "ut_common.h"
 #include "acvp/acvp_lcl.h"
+#include <unistd.h>
+#include <sys/socket.h>
 
 static ACVP_CTX *ctx = NULL;
 static ACVP_RESULT rv = 0;
@@ -1229,6 +1231,668 @@ Test(AES_HANDLER, good, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static int batch_calls = 0;
+static int batch_cases = 0;
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        if (!test_cases[i].tc.symmetric || !test_cases[i].tc.symmetric->key) {
+            return 1;
+        }
+        results[i] = 0;
+    }
+    batch_cases += count;
+    return 0;
+}
+
+/*
+ * Each AFT group goes to the batch handler in one call, the MCT groups still
+ * go through the per test case handler
+ */
+Test(AES_HANDLER, batch, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/aes/aes.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_AES_CBC, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    batch_calls = 0;
+    batch_cases = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls == 30);
+    cr_assert(batch_cases == 2138);
+    json_value_free(val);
+}
+
+static int soa_calls = 0;
+static int soa_cases = 0;
+
+/*
+ * Checks the layout of the arrays, and "encrypts" by copying the input
+ */
+static int soa_handler(ACVP_SYM_CIPHER_SOA *group, int *results) {
+    unsigned char *in = NULL, *out = NULL;
+    int i = 0;
+
+    if (group->cipher != ACVP_AES_CBC || group->count <= 0 || group->iv_len != 16 ||
+            (group->key_len != 16 && group->key_len != 24 && group->key_len != 32)) {
+        return 1;
+    }
+    in = group->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? group->pt : group->ct;
+    out = group->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? group->ct : group->pt;
+    soa_calls++;
+    for (i = 0; i < group->count; i++) {
+        if (!group->tc_id[i] || group->data_len[i] > group->data_stride || group->data_len[i] % 16) {
+            return 1;
+        }
+        memcpy(out + i * group->data_stride, in + i * group->data_stride, group->data_len[i]);
+        results[i] = 0;
+    }
+    soa_cases += group->count;
+    return 0;
+}
+
+/*
+ * Settings that depend on each other can be made in any order once their
+ * checks are deferred, and the checks still catch a conflict
+ */
+Test(AES_CAPABILITY, deferred_validation) {
+    JSON_Value *reg = NULL;
+
+    setup_empty_ctx(&ctx);
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_XTS, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    /* The data unit length matches the payload length until told otherwise */
+    rv = acvp_cap_sym_cipher_set_domain(ctx, ACVP_AES_XTS, ACVP_SYM_CIPH_DOMAIN_DULEN, 256, 65536, 256);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_set_deferred_validation(NULL, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_set_deferred_validation(ctx, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_set_domain(ctx, ACVP_AES_XTS, ACVP_SYM_CIPH_DOMAIN_DULEN, 256, 65536, 256);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_finalize(ctx);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_XTS, ACVP_SYM_CIPH_PARM_DULEN_MATCHES_PAYLOADLEN, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_finalize(ctx);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    /* A value is still checked as it is set */
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_XTS, ACVP_SYM_CIPH_PARM_DULEN_MATCHES_PAYLOADLEN, 2);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_GCM, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_set_domain(ctx, ACVP_AES_GCM, ACVP_SYM_CIPH_DOMAIN_IVLEN, 96, 1024, 8);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_set_parm(ctx, ACVP_AES_GCM, ACVP_SYM_CIPH_IVLEN, 96);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_finalize(ctx);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    /* The registration is not built with the conflict in it */
+    rv = acvp_build_registration_json(ctx, &reg);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    cr_assert(reg == NULL);
+    rv = acvp_cap_finalize(NULL);
+    cr_assert(rv == ACVP_NO_CTX);
+    teardown_ctx(&ctx);
+}
+
+Test(AES_CAPABILITY, soa_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_sym_cipher_set_soa_handler(NULL, ACVP_AES_CBC, &soa_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_CBC, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_GMAC, &soa_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_OFB, &soa_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_CBC, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_CCM, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * Each AFT group goes to the SoA handler in one call, with the payloads a
+ * stride apart; the MCT groups still go through the per test case handler
+ */
+Test(AES_HANDLER, soa, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL, *tc_rsp = NULL, *tc_req = NULL;
+
+    val = json_parse_file("json/aes/aes.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_CBC, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    soa_calls = 0;
+    soa_cases = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(soa_calls == 30);
+    cr_assert(soa_cases == 2138);
+
+    /* The copied payload made it back into the response */
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    tc_rsp = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(r_vs, "testGroups"), 0), "tests"), 0);
+    tc_req = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(obj, "testGroups"), 0), "tests"), 0);
+    cr_assert(!strcasecmp(json_object_get_string(tc_rsp, "ct"), json_object_get_string(tc_req, "pt")));
+    json_value_free(val);
+}
+
+static int aead_soa_shared = 0;
+
+/*
+ * "Encrypts" by copying the payload under a tag of 0xA5 bytes, and on
+ * decryption fails the tags that are not that
+ */
+static int aead_soa_handler(ACVP_SYM_CIPHER_SOA *group, int *results) {
+    unsigned char *tag = NULL;
+    int i = 0, j = 0;
+
+    if (group->cipher != ACVP_AES_CCM || group->tag_len != 4) {
+        return 1;
+    }
+    aead_soa_shared += group->key_shared;
+    for (i = 0; i < group->count; i++) {
+        tag = group->tag + i * group->tag_len;
+        if (group->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+            memcpy(group->ct + i * group->data_stride, group->pt + i * group->data_stride, group->data_len[i]);
+            memset(tag, 0xA5, group->tag_len);
+        } else {
+            if (!group->tag_ok || !group->tag_ok[i]) {
+                return 1;
+            }
+            memcpy(group->pt + i * group->data_stride, group->ct + i * group->data_stride, group->data_len[i]);
+            for (j = 0; j < (int)group->tag_len; j++) {
+                if (tag[j] != 0xA5) group->tag_ok[i] = 0;
+            }
+        }
+        results[i] = 0;
+    }
+    return 0;
+}
+
+/*
+ * The CCM tag is handed over apart from the ciphertext it is carried in,
+ * and a tag the module fails is reported as a failed test case
+ */
+Test(AES_HANDLER, soa_aead, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL;
+    JSON_Array *r_tgs = NULL, *r_tests = NULL;
+    const char *vs =
+        "{ \"vsId\": 1, \"algorithm\": \"ACVP-AES-CCM\", \"testGroups\": ["
+        "{ \"tgId\": 1, \"testType\": \"AFT\", \"direction\": \"encrypt\", \"keyLen\": 128,"
+        "  \"ivLen\": 56, \"payloadLen\": 128, \"aadLen\": 0, \"tagLen\": 32, \"tests\": ["
+        "  { \"tcId\": 1, \"key\": \"000102030405060708090A0B0C0D0E0F\", \"iv\": \"10111213141516\","
+        "    \"aad\": \"\", \"pt\": \"202122232425262728292A2B2C2D2E2F\" },"
+        "  { \"tcId\": 2, \"key\": \"000102030405060708090A0B0C0D0E0F\", \"iv\": \"10111213141517\","
+        "    \"aad\": \"\", \"pt\": \"303132333435363738393A3B3C3D3E3F\" } ] },"
+        "{ \"tgId\": 2, \"testType\": \"AFT\", \"direction\": \"decrypt\", \"keyLen\": 128,"
+        "  \"ivLen\": 56, \"payloadLen\": 128, \"aadLen\": 0, \"tagLen\": 32, \"tests\": ["
+        "  { \"tcId\": 3, \"key\": \"000102030405060708090A0B0C0D0E0F\", \"iv\": \"10111213141516\","
+        "    \"aad\": \"\", \"ct\": \"202122232425262728292A2B2C2D2E2FA5A5A5A5\" },"
+        "  { \"tcId\": 4, \"key\": \"0F0E0D0C0B0A09080706050403020100\", \"iv\": \"10111213141516\","
+        "    \"aad\": \"\", \"ct\": \"202122232425262728292A2B2C2D2E2F00000000\" } ] } ] }";
+
+    val = json_parse_string(vs);
+    obj = json_value_get_object(val);
+    cr_assert(obj != NULL);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_CCM, &aead_soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    aead_soa_shared = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    /* Only the encrypt group has one key for every test case */
+    cr_assert(aead_soa_shared == 1);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    r_tgs = json_object_get_array(r_vs, "testGroups");
+    r_tests = json_object_get_array(json_array_get_object(r_tgs, 0), "tests");
+    cr_assert(!strcasecmp(json_object_get_string(json_array_get_object(r_tests, 1), "ct"),
+                          "303132333435363738393A3B3C3D3E3FA5A5A5A5"));
+    r_tests = json_object_get_array(json_array_get_object(r_tgs, 1), "tests");
+    cr_assert(json_object_get_boolean(json_array_get_object(r_tests, 0), "testPassed") == 1);
+    cr_assert(!strcasecmp(json_object_get_string(json_array_get_object(r_tests, 0), "pt"),
+                          "202122232425262728292A2B2C2D2E2F"));
+    cr_assert(json_object_get_boolean(json_array_get_object(r_tests, 1), "testPassed") == 0);
+    json_value_free(val);
+}
+
+/*
+ * "Wraps" by putting the default initial value of RFC 3394 in front of the
+ * payload, and "unwraps" by checking it is there
+ */
+static int kw_soa_handler(ACVP_SYM_CIPHER_SOA *group, int *results) {
+    unsigned char *in = NULL, *out = NULL;
+    unsigned int len = 0;
+    int i = 0;
+
+    if (group->cipher != ACVP_AES_KW || group->kwcipher != ACVP_SYM_KW_CIPHER || !group->out_len) {
+        return 1;
+    }
+    for (i = 0; i < group->count; i++) {
+        len = group->data_len[i];
+        if (group->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+            in = group->pt + i * group->data_stride;
+            out = group->ct + i * group->data_stride;
+            group->out_len[i] = len + 8;
+            if (group->out_len[i] > group->data_stride) {
+                return 1;
+            }
+            memset(out, 0xA6, 8);
+            memcpy(out + 8, in, len);
+            results[i] = 0;
+        } else {
+            in = group->ct + i * group->data_stride;
+            out = group->pt + i * group->data_stride;
+            results[i] = len < 16 || in[0] != 0xA6;
+            group->out_len[i] = results[i] ? 0 : len - 8;
+            memcpy(out, in + 8, group->out_len[i]);
+        }
+    }
+    return 0;
+}
+
+/*
+ * Key wrap outputs are as long as the module says they are, and an
+ * unwrap that fails is a failed test case
+ */
+Test(AES_HANDLER, soa_kw, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL;
+    JSON_Array *r_tgs = NULL, *r_tests = NULL;
+    const char *vs =
+        "{ \"vsId\": 1, \"algorithm\": \"ACVP-AES-KW\", \"testGroups\": ["
+        "{ \"tgId\": 1, \"testType\": \"AFT\", \"direction\": \"encrypt\", \"kwCipher\": \"cipher\","
+        "  \"keyLen\": 128, \"payloadLen\": 128, \"tests\": ["
+        "  { \"tcId\": 1, \"key\": \"000102030405060708090A0B0C0D0E0F\","
+        "    \"pt\": \"202122232425262728292A2B2C2D2E2F\" } ] },"
+        "{ \"tgId\": 2, \"testType\": \"AFT\", \"direction\": \"decrypt\", \"kwCipher\": \"cipher\","
+        "  \"keyLen\": 128, \"payloadLen\": 64, \"tests\": ["
+        "  { \"tcId\": 2, \"key\": \"000102030405060708090A0B0C0D0E0F\","
+        "    \"ct\": \"A6A6A6A6A6A6A6A62021222324252627\" },"
+        "  { \"tcId\": 3, \"key\": \"000102030405060708090A0B0C0D0E0F\","
+        "    \"ct\": \"00A6A6A6A6A6A6A62021222324252627\" } ] } ] }";
+
+    val = json_parse_string(vs);
+    obj = json_value_get_object(val);
+    cr_assert(obj != NULL);
+    rv = acvp_cap_sym_cipher_set_soa_handler(ctx, ACVP_AES_KW, &kw_soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    r_tgs = json_object_get_array(r_vs, "testGroups");
+    r_tests = json_object_get_array(json_array_get_object(r_tgs, 0), "tests");
+    cr_assert(!strcasecmp(json_object_get_string(json_array_get_object(r_tests, 0), "ct"),
+                          "A6A6A6A6A6A6A6A6202122232425262728292A2B2C2D2E2F"));
+    r_tests = json_object_get_array(json_array_get_object(r_tgs, 1), "tests");
+    cr_assert(json_object_get_boolean(json_array_get_object(r_tests, 0), "testPassed") == 1);
+    cr_assert(!strcasecmp(json_object_get_string(json_array_get_object(r_tests, 0), "pt"),
+                          "2021222324252627"));
+    cr_assert(json_object_get_boolean(json_array_get_object(r_tests, 1), "testPassed") == 0);
+    json_value_free(val);
+}
+
+static int ring_cases = 0;
+
+/*
+ * Serves the ring from the other side, "encrypting" by copying the input
+ * as the SoA handler does
+ */
+static int ring_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *stc = test_case->tc.symmetric;
+
+    if (stc->cipher != ACVP_AES_CBC || !stc->key || !stc->iv || stc->mct_iv || stc->test_type == ACVP_SYM_TEST_TYPE_MCT) {
+        return 1;
+    }
+    if (stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT) {
+        memcpy(stc->ct, stc->pt, stc->pt_len);
+        stc->ct_len = stc->pt_len;
+    } else {
+        memcpy(stc->pt, stc->ct, stc->ct_len);
+        stc->pt_len = stc->ct_len;
+    }
+    ring_cases++;
+    return 0;
+}
+
+static void *ring_serve(void *arg) {
+    ACVP_RING *ring = NULL;
+
+    /* A ring of its own, as the module process would have it */
+    if (acvp_ring_open((const char *)arg, &ring) == ACVP_SUCCESS) {
+        acvp_ring_serve(ring, &ring_handler);
+        acvp_ring_close(ring);
+    }
+    return NULL;
+}
+
+Test(AES_CAPABILITY, ring_handler, .init = setup, .fini = teardown) {
+    ACVP_RING *ring = NULL;
+
+    rv = acvp_ring_create("ring_test.shm", 0, &ring);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_ring_open("ring_missing.shm", &ring);
+    cr_assert(rv == ACVP_TRANSPORT_FAIL);
+    rv = acvp_ring_create("ring_test.shm", 2, &ring);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_cap_set_ring_handler(NULL, ACVP_AES_CBC, ring, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_set_ring_handler(ctx, ACVP_AES_CBC, NULL, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_ring_handler(ctx, ACVP_AES_CBC, ring, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_ring_handler(ctx, ACVP_AES_GMAC, ring, 1);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_set_ring_handler(ctx, ACVP_AES_CBC, ring, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    acvp_ring_close(ring);
+}
+
+/*
+ * The AFT test cases are run across the ring by another thread, standing
+ * in for the module process, and what it wrote makes it back into the
+ * response; the MCT groups still go through the per test case handler
+ */
+Test(AES_HANDLER, ring, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL, *tc_rsp = NULL, *tc_req = NULL;
+    ACVP_RING *ring = NULL;
+    pthread_t server;
+    char ring_path[] = "ring_test.shm";
+
+    val = json_parse_file("json/aes/aes.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_ring_create(ring_path, 8, &ring);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(!pthread_create(&server, NULL, ring_serve, ring_path));
+    rv = acvp_cap_set_ring_handler(ctx, ACVP_AES_CBC, ring, 6);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    ring_cases = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(ring_cases == 2138);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    tc_rsp = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(r_vs, "testGroups"), 0), "tests"), 0);
+    tc_req = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(obj, "testGroups"), 0), "tests"), 0);
+    cr_assert(!strcasecmp(json_object_get_string(tc_rsp, "ct"), json_object_get_string(tc_req, "pt")));
+
+    /* Shutting the ring down ends the server */
+    acvp_ring_close(ring);
+    pthread_join(server, NULL);
+    cr_assert(fopen("ring_test.shm", "r") == NULL);
+    json_value_free(val);
+}
+
+static int dut_send(void *arg, const unsigned char *buf, unsigned int len) {
+    ssize_t n = 0;
+
+    while (len) {
+        n = write(*(int *)arg, buf, len);
+        if (n <= 0) {
+            return 1;
+        }
+        buf += n;
+        len -= (unsigned int)n;
+    }
+    return 0;
+}
+
+static int dut_recv(void *arg, unsigned char *buf, unsigned int len) {
+    ssize_t n = 0;
+
+    while (len) {
+        n = read(*(int *)arg, buf, len);
+        if (n <= 0) {
+            return 1;
+        }
+        buf += n;
+        len -= (unsigned int)n;
+    }
+    return 0;
+}
+
+/* The device end of the link, running the same handler as the ring */
+static void *dut_serve(void *arg) {
+    ACVP_DUT *dut = NULL;
+
+    if (acvp_dut_create(&dut_send, &dut_recv, arg, &dut) == ACVP_SUCCESS) {
+        acvp_dut_serve(dut, &ring_handler);
+        acvp_dut_free(dut);
+    }
+    return NULL;
+}
+
+Test(AES_CAPABILITY, dut_handler, .init = setup, .fini = teardown) {
+    ACVP_DUT *dut = NULL;
+    int fd = -1;
+
+    rv = acvp_dut_create(NULL, &dut_recv, &fd, &dut);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    rv = acvp_dut_create(&dut_send, &dut_recv, &fd, &dut);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_cap_set_dut_handler(NULL, ACVP_AES_CBC, dut, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_set_dut_handler(ctx, ACVP_AES_CBC, NULL, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_dut_handler(ctx, ACVP_AES_CBC, dut, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_dut_handler(ctx, ACVP_AES_GMAC, dut, 1);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_set_dut_handler(ctx, ACVP_AES_CBC, dut, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    acvp_dut_free(dut);
+}
+
+/*
+ * The AFT test cases are sent over a socket to another thread, standing in
+ * for the device, many at a time, and its answers make it back into the
+ * response
+ */
+Test(AES_HANDLER, dut, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL, *tc_rsp = NULL, *tc_req = NULL;
+    ACVP_DUT *dut = NULL;
+    pthread_t device;
+    int fds[2];
+
+    val = json_parse_file("json/aes/aes.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    cr_assert(!socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    cr_assert(!pthread_create(&device, NULL, dut_serve, &fds[1]));
+    rv = acvp_dut_create(&dut_send, &dut_recv, &fds[0], &dut);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_dut_handler(ctx, ACVP_AES_CBC, dut, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    ring_cases = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(ring_cases == 2138);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    tc_rsp = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(r_vs, "testGroups"), 12), "tests"), 0);
+    tc_req = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(obj, "testGroups"), 12), "tests"), 0);
+    cr_assert(!strcasecmp(json_object_get_string(tc_rsp, "pt"), json_object_get_string(tc_req, "ct")));
+
+    /* Closing the link ends the device */
+    close(fds[0]);
+    pthread_join(device, NULL);
+    close(fds[1]);
+    acvp_dut_free(dut);
+    json_value_free(val);
+}
+
+static int unit_calls = 0;
+
+/*
+ * Stands in for an XTS module that only knows about one data unit. The
+ * "ciphertext" of a unit is the low byte of its tweak, after a byte
+ * holding the second one, so the response shows which tweak each unit got
+ */
+static int xts_unit_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *stc = test_case->tc.symmetric;
+    unsigned char *out = NULL;
+    unsigned int len = 0;
+
+    len = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? stc->pt_len : stc->ct_len;
+    if (stc->cipher != ACVP_AES_XTS || !len || stc->data_unit_len != len) {
+        return 1;
+    }
+    out = stc->direction == ACVP_SYM_CIPH_DIR_ENCRYPT ? stc->ct : stc->pt;
+    memset(out, stc->iv[0], len);
+    out[0] = stc->iv[1];
+    stc->ct_len = stc->pt_len = len;
+    unit_calls++;
+    return 0;
+}
+
+static const char *xts_rsp_value(int group, int test, const char *name) {
+    JSON_Object *r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+
+    return json_object_get_string(json_array_get_object(json_object_get_array(json_array_get_object(
+               json_object_get_array(r_vs, "testGroups"), group), "tests"), test), name);
+}
+
+/*
+ * A payload longer than its dataUnitLen goes to the module one data unit
+ * at a time, each with the next tweak
+ */
+Test(AES_HANDLER, xts_data_units, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/aes/aes_xts.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    acvp_locate_cap_entry(ctx, ACVP_AES_XTS)->crypto_handler = &xts_unit_handler;
+
+    unit_calls = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(unit_calls == 7);
+    cr_assert(!strcasecmp(xts_rsp_value(0, 0, "ct"),
+                          "00FEFEFEFEFEFEFEFEFEFEFEFEFEFEFE00FFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+                          "0100000000000000000000000000000001010101010101010101010101010101"));
+    cr_assert(strnlen_s(xts_rsp_value(0, 1, "ct"), 512) == 128);
+    cr_assert(!strcasecmp(xts_rsp_value(1, 0, "pt"),
+                          "0000000000000000000000000000000000000000000000000000000000000000"
+                          "00010101010101010101010101010101"));
+
+    /* The units are test cases of the batch like any other */
+    json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_AES_XTS, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    batch_calls = 0;
+    batch_cases = 0;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls == 2);
+    cr_assert(batch_cases == 7);
+    json_value_free(val);
+}
+
+static int mct_calls = 0;
+static int mct_fail_at = -1;
+
+/*
+ * Stands in for a module running the 1000 block inner loop itself
+ */
+static int mct_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *stc = test_case->tc.symmetric;
+
+    if (!stc || !stc->mct_tail || stc->mct_index != 0 || stc->test_type != ACVP_SYM_TEST_TYPE_MCT) {
+        return 1;
+    }
+    memset(stc->mct_tail, mct_calls, ACVP_SYM_MCT_TAIL_LEN);
+    mct_calls++;
+    return mct_calls == mct_fail_at;
+}
+
+Test(AES_CAPABILITY, mct_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_sym_cipher_set_mct_handler(NULL, ACVP_AES_CBC, &mct_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_AES_CBC, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_AES_GMAC, &mct_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_AES_GCM, &mct_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_AES_CBC, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * Each MCT group takes one call per checkpoint instead of one per block
+ */
+Test(AES_HANDLER, mct_handler, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/aes/aes.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_AES_CBC, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    mct_calls = 0;
+    mct_fail_at = -1;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mct_calls == 6 * ACVP_AES_MCT_OUTER);
+
+    json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    mct_calls = 0;
+    mct_fail_at = 150;
+    rv = acvp_aes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+}
+
 
 /*
  * The value for key:"algorithm" is wrong.
@@ -2200,3 +2200,51 @@ Test(BUILD_TEST_SESSION, kas_ffc_no_params, .fini = teardown) {
     rv = acvp_build_registration_json(ctx, &generated_value);
     cr_assert(rv == ACVP_MISSING_ARG);
 }
+
+/*
+ * With a registration cache, the registration is serialized once and then
+ * taken from the cache for as long as the registration stays the same
+ */
+Test(BUILD_TEST_SESSION, registration_cache, .fini = teardown) {
+    const char *cache_file = "reg_cache_test.bin";
+    char *cached = NULL, *sample = NULL;
+    FILE *fp = NULL;
+    long pos = 0;
+
+    remove(cache_file);
+    setup_empty_ctx(&ctx);
+    add_hash_details_good();
+
+    rv = acvp_set_registration_cache_file(ctx, cache_file);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_build_registration_json(ctx, &reg_value);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx->registration = reg_value;
+
+    rv = acvp_build_full_registration(ctx, &reg, NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    /* Mark the cached copy, so it can be told apart from a new serialization */
+    fp = fopen(cache_file, "r+b");
+    cr_assert(fp != NULL);
+    cr_assert(fseek(fp, 0, SEEK_END) == 0);
+    pos = ftell(fp) - (long)strlen(reg) + (long)(strstr(reg, "false") - reg);
+    cr_assert(fseek(fp, pos, SEEK_SET) == 0);
+    cr_assert(fputc('F', fp) == 'F');
+    fclose(fp);
+
+    rv = acvp_build_full_registration(ctx, &cached, NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(strstr(cached, "False") != NULL);
+    cr_assert(strlen(cached) == strlen(reg));
+
+    /* A different registration does not use the cache */
+    ctx->is_sample = 1;
+    rv = acvp_build_full_registration(ctx, &sample, NULL);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(strstr(sample, "\"isSample\":true") != NULL);
+
+    free(cached);
+    free(sample);
+    remove(cache_file);
+}
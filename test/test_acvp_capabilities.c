@@ -90,6 +90,54 @@ Test(EnableCapHash, invalid_args, .fini = teardown) {
     cr_assert(rv == ACVP_INVALID_ARG);
 }
 
+/*
+ * Sets the parameters of several capabilities from one table, and rejects
+ * tables that name a cipher that was not enabled or of another type.
+ */
+Test(EnableCapParms, table, .fini = teardown) {
+    static const ACVP_CAP_PARM_ENTRY good[] = {
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_256, ACVP_HASH_IN_BIT, 0, 0, 0 },
+        { ACVP_CAP_HASH_PARM, ACVP_HASH_SHA3_256, ACVP_HASH_IN_EMPTY, 1, 0, 0 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HMAC_DOMAIN, ACVP_HMAC_SHA1, ACVP_HMAC_KEYLEN, 8, 524288, 8 },
+        { ACVP_CAP_HMAC_PARM, ACVP_HMAC_SHA1, ACVP_HMAC_MACLEN, 160, 0, 0 }
+    };
+    static const ACVP_CAP_PARM_ENTRY not_enabled[] = {
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_256, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 },
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA512, ACVP_HASH_MESSAGE_LEN, 0, 65536, 8 }
+    };
+    static const ACVP_CAP_PARM_ENTRY wrong_type[] = {
+        { ACVP_CAP_HMAC_PARM, ACVP_HASH_SHA3_256, ACVP_HMAC_MACLEN, 160, 0, 0 }
+    };
+    static const ACVP_CAP_PARM_ENTRY bad_value[] = {
+        { ACVP_CAP_HASH_DOMAIN, ACVP_HASH_SHA3_256, ACVP_HASH_MESSAGE_LEN, 0, 65535, 8 }
+    };
+
+    setup_empty_ctx(&ctx);
+
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA3_256, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hmac_enable(ctx, ACVP_HMAC_SHA1, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_cap_set_parms(ctx, good, sizeof(good) / sizeof(good[0]));
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_cap_set_parms(ctx, not_enabled, sizeof(not_enabled) / sizeof(not_enabled[0]));
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_set_parms(ctx, wrong_type, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_parms(ctx, bad_value, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_set_parms(ctx, NULL, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_parms(ctx, good, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_parms(NULL, good, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+}
+
 /*
  * Tests a good kdf108 api sequence
  */
@@ -694,3 +694,124 @@ Test(DES_HANDLER, cryptoFail4, .init = setup_fail, .fini = teardown) {
 }
 
 
+
+static int mct_calls = 0;
+
+/*
+ * Stands in for a module running the 10000 block inner loop itself
+ */
+static int mct_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *stc = test_case->tc.symmetric;
+
+    if (!stc || !stc->mct_tail || !stc->iv_ret || !stc->iv_ret_after ||
+            stc->mct_index != 0 || stc->test_type != ACVP_SYM_TEST_TYPE_MCT) {
+        return 1;
+    }
+    memset(stc->mct_tail, mct_calls, ACVP_SYM_MCT_TAIL_LEN);
+    mct_calls++;
+    return 0;
+}
+
+Test(DES_CAPABILITY, mct_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_sym_cipher_set_mct_handler(NULL, ACVP_TDES_CBC, &mct_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CBC, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_OFB, &mct_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CTR, &mct_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CBC, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * Each MCT group takes one call per checkpoint instead of one per block
+ */
+Test(DES_HANDLER, mct_handler, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/des/des.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_sym_cipher_set_mct_handler(ctx, ACVP_TDES_CBC, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    mct_calls = 0;
+    rv = acvp_des_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mct_calls == 2 * ACVP_DES_MCT_OUTER);
+    json_value_free(val);
+}
+
+static int mct_loop_calls = 0;
+
+/*
+ * Stands in for a module running the whole MCT, leaving the chaining of
+ * the checkpoints to the reference loop of libacvp
+ */
+static int mct_loop_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SYM_CIPHER_TC *stc = test_case->tc.symmetric;
+
+    if (!stc || !stc->mct_key || !stc->mct_iv || !stc->mct_pt || !stc->mct_ct) {
+        return 1;
+    }
+    mct_loop_calls++;
+    return acvp_des_mct_loop(test_case, &mct_handler) == ACVP_SUCCESS ? 0 : 1;
+}
+
+Test(DES_CAPABILITY, mct_loop_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(NULL, ACVP_TDES_CBC, &mct_loop_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CBC, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_OFB, &mct_loop_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CTR, &mct_loop_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CBC, &mct_loop_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * Each MCT group takes one call, and the reference loop one inner loop
+ * call per checkpoint
+ */
+Test(DES_HANDLER, mct_loop_handler, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/des/des.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_sym_cipher_set_mct_loop_handler(ctx, ACVP_TDES_CBC, &mct_loop_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    mct_calls = 0;
+    mct_loop_calls = 0;
+    rv = acvp_des_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mct_loop_calls == 2);
+    cr_assert(mct_calls == 2 * ACVP_DES_MCT_OUTER);
+    json_value_free(val);
+}
+
+/*
+ * The reference loop only runs a test case given to an MCT loop handler
+ */
+Test(DES_API, mct_loop) {
+    ACVP_TEST_CASE tc;
+    ACVP_SYM_CIPHER_TC stc;
+
+    memset(&stc, 0x0, sizeof(ACVP_SYM_CIPHER_TC));
+    tc.tc.symmetric = &stc;
+    cr_assert(acvp_des_mct_loop(NULL, &mct_handler) == ACVP_INVALID_ARG);
+    cr_assert(acvp_des_mct_loop(&tc, NULL) == ACVP_INVALID_ARG);
+    stc.test_type = ACVP_SYM_TEST_TYPE_MCT;
+    cr_assert(acvp_des_mct_loop(&tc, &mct_handler) == ACVP_INVALID_ARG);
+}
@@ -1062,3 +1062,124 @@ Test(DRBG_HANDDLER, tcFail1, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+
+static int group_begins = 0, group_ends = 0, group_misses = 0;
+static int group_state = 0;
+
+static int group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_DRBG_TC *tc = test_case->tc.drbg;
+
+    if (event == ACVP_TG_BEGIN) {
+        if (tc->tc_id || tc->drb || !tc->tg_id || !tc->entropy_len) group_misses++;
+        tc->tg_ctx = &group_state;
+        group_begins++;
+    } else {
+        if (tc->tg_ctx != &group_state) group_misses++;
+        group_ends++;
+    }
+    return 0;
+}
+
+static int group_crypto_handler(ACVP_TEST_CASE *test_case) {
+    if (test_case->tc.drbg->tg_ctx != &group_state) group_misses++;
+    return 0;
+}
+
+/*
+ * A group handler sees every test group start and end, also when the
+ * vector set fails part way, and its tg_ctx reaches every test case
+ */
+Test(DRBG_HANDLER, group_handler, .fini = teardown) {
+    int groups = 0;
+
+    setup_empty_ctx(&ctx);
+    rv = acvp_cap_drbg_enable(ctx, ACVP_HASHDRBG, &group_crypto_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HASHDRBG, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMACDRBG, &group_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HASHDRBG, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/drbg/drbg.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    groups = json_array_get_count(json_object_get_array(obj, "testGroups"));
+    rv = acvp_drbg_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_begins == groups);
+    cr_assert(group_ends == groups);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+
+    group_begins = group_ends = 0;
+    val = json_parse_file("json/drbg/drbg_34.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_drbg_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    cr_assert(group_begins > 0);
+    cr_assert(group_ends == group_begins);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+}
+
+/* Writes the returned bits of the test case through its sink, a byte at a time */
+static int sink_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_DRBG_TC *tc = test_case->tc.drbg;
+    unsigned char b = 0xab;
+    unsigned int i = 0;
+
+    if (!tc->drb_sink || tc->drb) {
+        return 1;
+    }
+    for (i = 0; i < tc->drb_len; i++) {
+        if (acvp_output_write(tc->drb_sink, &b, 1) != ACVP_SUCCESS) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * The returned bits go through the sink into the response
+ */
+Test(DRBG_HANDLER, output_sink, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL, *r_tg = NULL, *tg = NULL;
+    const char *bits = NULL;
+    size_t i = 0, len = 0;
+    int good = 1;
+
+    acvp_locate_cap_entry(ctx, ACVP_HASHDRBG)->crypto_handler = &sink_handler;
+    rv = acvp_cap_set_output_sink(ctx, ACVP_HASHDRBG, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/drbg/drbg.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_drbg_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    tg = json_array_get_object(json_object_get_array(obj, "testGroups"), 0);
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    r_tg = json_array_get_object(json_object_get_array(r_vs, "testGroups"), 0);
+    bits = json_object_get_string(json_array_get_object(json_object_get_array(r_tg, "tests"), 0),
+                                  "returnedBits");
+    cr_assert(bits != NULL);
+    len = strlen(bits);
+    cr_assert(len == json_object_get_uint(tg, "returnedBitsLen") / 4);
+    for (i = 0; i < len && good; i++) {
+        good = bits[i] == (i % 2 ? 'B' : 'A');
+    }
+    cr_assert(good);
+
+    /* Back to the output buffer */
+    rv = acvp_cap_set_output_sink(ctx, ACVP_HASHDRBG, 0);
+    cr_assert(rv == ACVP_SUCCESS);
+    json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    rv = acvp_drbg_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+}
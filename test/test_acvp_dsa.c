@@ -528,6 +528,64 @@ Test(DsaKeyGenFunc, null_ctx) {
 }
 
 
+static int pqg_generated = 0, pqg_mismatch = 0;
+
+/*
+ * Makes up domain parameters of the right size when libacvp has none to
+ * give, and checks the ones it gives are those made for the same l and n
+ */
+static int pqg_reuse_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_DSA_TC *tc = test_case->tc.dsa;
+
+    if (tc->pqg_given) {
+        if (tc->p_len != tc->l / 8 || tc->q_len != tc->n / 8 || tc->p[0] != (tc->l + tc->n) % 256) {
+            pqg_mismatch++;
+        }
+    } else {
+        pqg_generated++;
+        tc->p_len = tc->l / 8;
+        memset(tc->p, (tc->l + tc->n) % 256, tc->p_len);
+        tc->q_len = tc->n / 8;
+        memset(tc->q, 2, tc->q_len);
+        tc->g_len = tc->l / 8;
+        memset(tc->g, 3, tc->g_len);
+    }
+    tc->x_len = tc->y_len = 1;
+    return 0;
+}
+
+/*
+ * Domain parameters generated for one KeyGen group are given to the later
+ * groups with the same l and n, also in other vector sets
+ */
+Test(DsaKeyGenFunc, pqg_reuse) {
+    ACVP_RESULT rv;
+    JSON_Object *obj;
+    JSON_Value *val;
+    const char *files[] = { "json/dsa/dsa_keygen1.json", "json/dsa/dsa_keygen1.json",
+                            "json/dsa/dsa_keygen5.json" };
+    int i;
+
+    setup_empty_ctx(&ctx);
+    rv = acvp_cap_dsa_enable(ctx, ACVP_DSA_KEYGEN, &pqg_reuse_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    setup_keygen();
+
+    for (i = 0; i < 3; i++) {
+        val = json_parse_file(files[i]);
+        obj = ut_get_obj_from_rsp(val);
+        cr_assert(obj != NULL);
+        rv = acvp_dsa_kat_handler(ctx, obj);
+        cr_assert(rv == ACVP_SUCCESS);
+        json_value_free(val);
+    }
+    cr_assert(pqg_generated == 2);
+    cr_assert(pqg_mismatch == 0);
+
+    teardown_ctx(&ctx);
+}
+
+
 /*
  * Test DSA SIGGEN handler API inputs
  */
@@ -1575,3 +1633,71 @@ Test(SigGen_HANDLER, cryptoFail2) {
 
     teardown_ctx(&ctx);
 }
+
+static int batch_calls = 0, batch_tcs = 0, batch_misses = 0, batch_fail = 0;
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_DSA_TC *tc = test_cases[i].tc.dsa;
+
+        if (!tc->cipher || !tc->p_len || !tc->q_len) batch_misses++;
+        if (tc->mode == ACVP_DSA_MODE_SIGVER && (!tc->msglen || !tc->y_len)) batch_misses++;
+        if (i && tc == test_cases[i - 1].tc.dsa) batch_misses++;
+        tc->result = 1;
+        results[i] = batch_fail;
+        batch_tcs++;
+    }
+    return 0;
+}
+
+/*
+ * PQGVer and SigVer test groups are verified in one call to the batch
+ * handler, each test case with its own ACVP_DSA_TC
+ */
+Test(DsaVer_HANDLER, batch_handler) {
+    ACVP_RESULT rv;
+    JSON_Object *obj;
+    JSON_Value *val;
+
+    setup_empty_ctx(&ctx);
+
+    rv = acvp_cap_dsa_enable(ctx, ACVP_DSA_PQGVER, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_dsa_enable(ctx, ACVP_DSA_SIGVER, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_DSA_PQGVER, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_DSA_SIGVER, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    batch_calls = batch_tcs = batch_misses = batch_fail = 0;
+    val = json_parse_file("json/dsa/dsa_pqgver1.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_dsa_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs == 2);
+    json_value_free(val);
+
+    batch_calls = batch_tcs = 0;
+    val = json_parse_file("json/dsa/dsa_sigver1.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_dsa_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs == 4);
+    cr_assert(batch_misses == 0);
+
+    /* A test case the crypto module fails fails the vector set */
+    batch_fail = 1;
+    rv = acvp_dsa_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+
+    teardown_ctx(&ctx);
+}
@@ -350,6 +350,200 @@ Test(ECDSA_HANDLER, good_sg, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static int group_begins = 0, group_ends = 0, group_misses = 0;
+static int group_state = 0;
+
+static int group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_ECDSA_TC *tc = test_case->tc.ecdsa;
+
+    if (event == ACVP_TG_BEGIN) {
+        if (tc->tc_id || tc->message || !tc->tg_id || !tc->curve || !tc->hash_alg) group_misses++;
+        tc->tg_ctx = &group_state;
+        group_begins++;
+    } else {
+        if (tc->tg_ctx != &group_state) group_misses++;
+        group_ends++;
+    }
+    return 0;
+}
+
+static int group_crypto_handler(ACVP_TEST_CASE *test_case) {
+    if (test_case->tc.ecdsa->tg_ctx != &group_state) group_misses++;
+    return 0;
+}
+
+/*
+ * A group handler sees every SigGen test group start and end, also when
+ * the vector set fails part way, and its tg_ctx reaches every test case
+ */
+Test(ECDSA_HANDLER, group_handler, .init = setup, .fini = teardown) {
+    acvp_locate_cap_entry(ctx, ACVP_ECDSA_SIGGEN)->crypto_handler = &group_crypto_handler;
+    rv = acvp_cap_set_group_handler(ctx, ACVP_ECDSA_SIGGEN, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    group_begins = group_ends = group_misses = 0;
+    val = json_parse_file("json/ecdsa/ecdsa_siggen.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_siggen_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_begins == 2);
+    cr_assert(group_ends == 2);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+
+    group_begins = group_ends = 0;
+    val = json_parse_file("json/ecdsa/ecdsa_10.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_siggen_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    cr_assert(group_begins > 0);
+    cr_assert(group_ends == group_begins);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+}
+
+static int batch_calls = 0, batch_tcs = 0, batch_misses = 0;
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_ECDSA_TC *tc = test_cases[i].tc.ecdsa;
+
+        if (!tc->tc_id || !tc->curve || !tc->qx_len || !tc->qy_len) batch_misses++;
+        if (i && tc == test_cases[i - 1].tc.ecdsa) batch_misses++;
+        tc->ver_disposition = ACVP_TEST_DISPOSITION_PASS;
+        results[i] = 0;
+        batch_tcs++;
+    }
+    return 0;
+}
+
+/*
+ * KeyVer and SigVer test groups are verified in one call to the batch
+ * handler, each test case with its own ACVP_ECDSA_TC
+ */
+Test(ECDSA_HANDLER, batch_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_ECDSA_KEYVER, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_ECDSA_SIGVER, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_ECDSA_SIGGEN, &batch_handler);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+
+    batch_calls = batch_tcs = batch_misses = 0;
+    val = json_parse_file("json/ecdsa/ecdsa_keyver.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_keyver_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs == 2);
+    json_value_free(val);
+
+    batch_calls = batch_tcs = 0;
+    val = json_parse_file("json/ecdsa/ecdsa_sigver.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_sigver_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs == 2);
+    cr_assert(batch_misses == 0);
+    json_value_free(val);
+
+    /* A test case missing a field still fails the vector set */
+    val = json_parse_file("json/ecdsa/ecdsa_sigver_2.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_sigver_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_MISSING_ARG);
+    json_value_free(val);
+}
+
+static int pool_keys = 0, pool_crypto_calls = 0, pool_misses = 0;
+
+static int pool_producer(ACVP_TEST_CASE *test_case) {
+    ACVP_ECDSA_TC *tc = test_case->tc.ecdsa;
+
+    if (tc->tc_id || tc->curve != ACVP_EC_CURVE_P224 || tc->secret_gen_mode != ACVP_ECDSA_SECRET_GEN_EXTRA_BITS) {
+        pool_misses++;
+    }
+    memset(tc->d, 0x11, 28);
+    tc->d_len = 28;
+    memset(tc->qx, 0x22, 28);
+    tc->qx_len = 28;
+    memset(tc->qy, 0x33, 28);
+    tc->qy_len = 28;
+    __sync_fetch_and_add(&pool_keys, 1);
+    return 0;
+}
+
+static int pool_failing_producer(ACVP_TEST_CASE *test_case) {
+    (void)test_case;
+    return 1;
+}
+
+static int pool_crypto_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_ECDSA_TC *tc = test_case->tc.ecdsa;
+
+    tc->d_len = tc->qx_len = tc->qy_len = 1;
+    pool_crypto_calls++;
+    return 0;
+}
+
+Test(ECDSA_CAPABILITY, key_pool, .init = setup, .fini = teardown) {
+    rv = acvp_cap_set_key_pool(ctx, ACVP_ECDSA_KEYGEN, &pool_producer, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_key_pool(ctx, ACVP_ECDSA_KEYGEN, &pool_producer, ACVP_KEY_POOL_DEPTH_MAX + 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_key_pool(ctx, ACVP_ECDSA_SIGGEN, &pool_producer, 4);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+    rv = acvp_cap_set_key_pool(ctx, ACVP_SAFE_PRIMES_KEYGEN, &pool_producer, 4);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_set_key_pool(ctx, ACVP_ECDSA_KEYGEN, &pool_producer, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * KeyGen test cases take their keys from the pool instead of going to the
+ * crypto_handler, and go back to it if the producer fails
+ */
+Test(ECDSA_HANDLER, key_pool, .init = setup, .fini = teardown) {
+    acvp_locate_cap_entry(ctx, ACVP_ECDSA_KEYGEN)->crypto_handler = &pool_crypto_handler;
+    rv = acvp_cap_set_key_pool(ctx, ACVP_ECDSA_KEYGEN, &pool_producer, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    pool_keys = pool_crypto_calls = pool_misses = 0;
+    val = json_parse_file("json/ecdsa/ecdsa_keygen.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_keygen_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(pool_crypto_calls == 0);
+    cr_assert(__sync_fetch_and_add(&pool_keys, 0) >= 2);
+    cr_assert(pool_misses == 0);
+    json_value_free(val);
+}
+
+Test(ECDSA_HANDLER, key_pool_fail, .init = setup, .fini = teardown) {
+    acvp_locate_cap_entry(ctx, ACVP_ECDSA_KEYGEN)->crypto_handler = &pool_crypto_handler;
+    rv = acvp_cap_set_key_pool(ctx, ACVP_ECDSA_KEYGEN, &pool_failing_producer, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    pool_crypto_calls = 0;
+    val = json_parse_file("json/ecdsa/ecdsa_keygen.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_ecdsa_keygen_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(pool_crypto_calls == 2);
+    json_value_free(val);
+}
+
 /*
  * The value for key:"algorithm" is wrong.
  */
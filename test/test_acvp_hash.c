@@ -11,6 +11,7 @@
 
 #include "ut_common.h"
 #include "acvp/acvp_lcl.h"
+#include <unistd.h>
 
 static ACVP_CTX *ctx = NULL;
 static ACVP_RESULT rv = 0;
@@ -353,3 +354,672 @@ Test(HASH_HANDLER, cryptoFail4, .init = fail_setup, .fini = teardown) {
 }
 
 
+
+static int batch_calls = 0;
+static int batch_cases = 0;
+static int batch_fail_at = -1;
+
+/*
+ * Checks the test cases arrive in order and with their inputs set up
+ */
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    unsigned int prev_id = 0;
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_HASH_TC *stc = test_cases[i].tc.hash;
+
+        if (!stc || !stc->msg || stc->tc_id <= prev_id) {
+            return 1;
+        }
+        prev_id = stc->tc_id;
+        results[i] = (batch_cases == batch_fail_at);
+        batch_cases++;
+    }
+    return 0;
+}
+
+Test(HASH_CAPABILITY, batch_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_set_batch_handler(NULL, ACVP_HASH_SHA256, &batch_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_HASH_SHA256, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_HASH_SHA1, &batch_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+
+    rv = acvp_cap_cmac_enable(ctx, ACVP_CMAC_AES, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_CMAC_AES, &batch_handler);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_HASH_SHA256, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * The AFT group goes to the batch handler in one call, the MCT group still
+ * goes through the per test case handler
+ */
+Test(HASH_HANDLER, batch, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/hash/hash.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_HASH_SHA256, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    batch_calls = 0;
+    batch_cases = 0;
+    batch_fail_at = -1;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls == 1);
+    cr_assert(batch_cases == 129);
+
+    /* A failed test case fails the vector set like it does unbatched */
+    json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    batch_cases = 0;
+    batch_fail_at = 5;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+}
+
+static int soa_calls = 0;
+static int soa_cases = 0;
+
+/*
+ * Checks the messages are packed back to back, and gives each the digest
+ * of its index repeated
+ */
+static int soa_handler(ACVP_HASH_SOA *group, int *results) {
+    int i = 0;
+
+    if (group->cipher != ACVP_HASH_SHA256 || group->count <= 0 || group->md_stride < 32) {
+        return 1;
+    }
+    soa_calls++;
+    for (i = 0; i < group->count; i++) {
+        if (!group->tc_id[i] ||
+                (i && group->msg_off[i] != group->msg_off[i - 1] + group->msg_len[i - 1])) {
+            return 1;
+        }
+        memset(group->md + i * group->md_stride, i, 32);
+        group->md_len[i] = 32;
+        results[i] = 0;
+    }
+    soa_cases += group->count;
+    return 0;
+}
+
+Test(HASH_CAPABILITY, soa_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_hash_set_soa_handler(NULL, ACVP_HASH_SHA256, &soa_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_hash_set_soa_handler(ctx, ACVP_HASH_SHA256, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_hash_set_soa_handler(ctx, ACVP_HASH_SHA1, &soa_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHAKE_128, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hash_set_soa_handler(ctx, ACVP_HASH_SHAKE_128, &soa_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_hash_set_soa_handler(ctx, ACVP_HASH_SHA256, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * The messages of the AFT group go to the SoA handler in one call, and
+ * each digest ends up in the response of its own test case
+ */
+Test(HASH_HANDLER, soa, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL;
+    JSON_Array *r_tests = NULL;
+
+    val = json_parse_file("json/hash/hash.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_hash_set_soa_handler(ctx, ACVP_HASH_SHA256, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    soa_calls = 0;
+    soa_cases = 0;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(soa_calls == 1);
+    cr_assert(soa_cases == 129);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    r_tests = json_object_get_array(json_array_get_object(json_object_get_array(r_vs, "testGroups"), 0), "tests");
+    cr_assert(!strcmp(json_object_get_string(json_array_get_object(r_tests, 2), "md"),
+                      "0202020202020202020202020202020202020202020202020202020202020202"));
+    json_value_free(val);
+}
+
+#define ASYNC_DEPTH 4
+#define ASYNC_QUEUE_MAX 256
+
+static ACVP_MUTEX async_lock;
+static ACVP_TC_HANDLE *async_queue[ASYNC_QUEUE_MAX];
+static int async_head = 0, async_tail = 0;
+static int async_in_flight = 0, async_max_in_flight = 0;
+static int async_done = 0, async_expected = 0;
+
+/*
+ * Queues the test case for the completer thread, like a module waiting on
+ * a device would
+ */
+static int async_handler(ACVP_TEST_CASE *test_case, ACVP_TC_HANDLE *handle) {
+    if (!test_case->tc.hash || !test_case->tc.hash->msg) {
+        return 1;
+    }
+
+    acvp_mutex_lock(&async_lock);
+    if (async_tail == ASYNC_QUEUE_MAX) {
+        acvp_mutex_unlock(&async_lock);
+        return 1;
+    }
+    async_queue[async_tail++] = handle;
+    async_in_flight++;
+    if (async_in_flight > async_max_in_flight) {
+        async_max_in_flight = async_in_flight;
+    }
+    acvp_mutex_unlock(&async_lock);
+    return 0;
+}
+
+static void async_completer(void *arg) {
+    ACVP_TC_HANDLE *handle = NULL;
+    int done = 0;
+
+    while (!done) {
+        handle = NULL;
+        acvp_mutex_lock(&async_lock);
+        if (async_head < async_tail) {
+            handle = async_queue[async_head++];
+            async_in_flight--;
+            async_done++;
+        }
+        done = async_done == async_expected;
+        acvp_mutex_unlock(&async_lock);
+
+        if (handle) {
+            acvp_tc_complete(handle, 0);
+        } else {
+            usleep(100);
+        }
+    }
+}
+
+Test(HASH_CAPABILITY, async_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_set_async_handler(NULL, ACVP_HASH_SHA256, &async_handler, ASYNC_DEPTH);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_set_async_handler(ctx, ACVP_HASH_SHA256, NULL, ASYNC_DEPTH);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_async_handler(ctx, ACVP_HASH_SHA256, &async_handler, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_async_handler(ctx, ACVP_HASH_SHA1, &async_handler, ASYNC_DEPTH);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_set_async_handler(ctx, ACVP_HASH_SHA256, &async_handler, ASYNC_DEPTH);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * The AFT group is completed from another thread with no more than the
+ * requested depth in flight, and the results land in test case order
+ */
+Test(HASH_HANDLER, async, .init = setup, .fini = teardown) {
+    ACVP_THREAD completer;
+    JSON_Array *tests = NULL;
+    JSON_Object *group = NULL;
+    int i = 0;
+
+    val = json_parse_file("json/hash/hash.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_set_async_handler(ctx, ACVP_HASH_SHA256, &async_handler, ASYNC_DEPTH);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    acvp_mutex_init(&async_lock);
+    async_head = async_tail = 0;
+    async_in_flight = async_max_in_flight = 0;
+    async_done = 0;
+    async_expected = 129;
+    cr_assert(acvp_thread_create(&completer, async_completer, NULL) == ACVP_SUCCESS);
+
+    rv = acvp_hash_kat_handler(ctx, obj);
+    acvp_thread_join(completer);
+    acvp_mutex_destroy(&async_lock);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(async_done == 129);
+    cr_assert(async_max_in_flight >= 1 && async_max_in_flight <= ASYNC_DEPTH);
+
+    group = json_array_get_object(json_object_get_array(json_array_get_object(
+                json_value_get_array(ctx->exec.kat_resp), 1), "testGroups"), 0);
+    tests = json_object_get_array(group, "tests");
+    cr_assert(json_array_get_count(tests) == 129);
+    for (i = 1; i < 129; i++) {
+        cr_assert(json_object_get_number(json_array_get_object(tests, i), "tcId") >
+                  json_object_get_number(json_array_get_object(tests, i - 1), "tcId"));
+    }
+    json_value_free(val);
+}
+
+static ACVP_MUTEX par_lock;
+static int par_calls = 0, par_running = 0, par_max_running = 0;
+
+static int parallel_handler(ACVP_TEST_CASE *test_case) {
+    if (test_case->tc.hash->test_type == ACVP_HASH_TEST_TYPE_MCT) {
+        return 0;
+    }
+
+    acvp_mutex_lock(&par_lock);
+    par_calls++;
+    par_running++;
+    if (par_running > par_max_running) {
+        par_max_running = par_running;
+    }
+    acvp_mutex_unlock(&par_lock);
+
+    usleep(200);
+
+    acvp_mutex_lock(&par_lock);
+    par_running--;
+    acvp_mutex_unlock(&par_lock);
+    return 0;
+}
+
+Test(HASH_API, max_parallel_test_cases) {
+    setup_empty_ctx(&ctx);
+
+    rv = acvp_set_max_parallel_test_cases(NULL, 4);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_set_max_parallel_test_cases(ctx, 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_max_parallel_test_cases(ctx, 65);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_set_max_parallel_test_cases(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    teardown_ctx(&ctx);
+}
+
+/*
+ * The AFT group is spread across the threads, and the responses still come
+ * out in test case order
+ */
+Test(HASH_HANDLER, parallel, .fini = teardown) {
+    JSON_Array *tests = NULL;
+    JSON_Object *group = NULL;
+    int i = 0;
+
+    setup_empty_ctx(&ctx);
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA256, &parallel_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hash_set_domain(ctx, ACVP_HASH_SHA256, ACVP_HASH_MESSAGE_LEN, 0, 65528, 8);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_max_parallel_test_cases(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/hash/hash.json");
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+
+    acvp_mutex_init(&par_lock);
+    par_calls = par_running = par_max_running = 0;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    acvp_mutex_destroy(&par_lock);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(par_calls == 129);
+    cr_assert(par_max_running >= 2 && par_max_running <= 4);
+
+    group = json_array_get_object(json_object_get_array(json_array_get_object(
+                json_value_get_array(ctx->exec.kat_resp), 1), "testGroups"), 0);
+    tests = json_object_get_array(group, "tests");
+    cr_assert(json_array_get_count(tests) == 129);
+    for (i = 1; i < 129; i++) {
+        cr_assert(json_object_get_number(json_array_get_object(tests, i), "tcId") >
+                  json_object_get_number(json_array_get_object(tests, i - 1), "tcId"));
+    }
+    json_value_free(val);
+}
+
+static int mct_calls = 0;
+
+/*
+ * Stands in for a module running the 1000 digest inner loop itself
+ */
+static int mct_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_HASH_TC *stc = test_case->tc.hash;
+
+    if (!stc || !stc->msg || !stc->md || stc->test_type != ACVP_HASH_TEST_TYPE_MCT) {
+        return 1;
+    }
+    memzero_s(stc->md, 32);
+    stc->md[0] = (unsigned char)mct_calls;
+    stc->md_len = 32;
+    mct_calls++;
+    return 0;
+}
+
+Test(HASH_CAPABILITY, mct_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_hash_set_mct_handler(NULL, ACVP_HASH_SHA256, &mct_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_hash_set_mct_handler(ctx, ACVP_HASH_SHA256, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_hash_set_mct_handler(ctx, ACVP_HASH_SHA1, &mct_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+
+    rv = acvp_cap_cmac_enable(ctx, ACVP_CMAC_AES, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hash_set_mct_handler(ctx, ACVP_CMAC_AES, &mct_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_hash_set_mct_handler(ctx, ACVP_HASH_SHA256, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * The MCT group takes one call per checkpoint instead of one per digest
+ */
+Test(HASH_HANDLER, mct_handler, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/hash/hash.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_hash_set_mct_handler(ctx, ACVP_HASH_SHA256, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    mct_calls = 0;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mct_calls == ACVP_HASH_MCT_OUTER);
+    json_value_free(val);
+}
+
+static int mct_loop_calls = 0;
+
+/*
+ * Stands in for a module running every checkpoint of the MCT itself
+ */
+static int mct_loop_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_HASH_TC *stc = test_case->tc.hash;
+    int i = 0;
+
+    if (!stc || !stc->msg || !stc->mct_md || !stc->mct_md_len ||
+            stc->test_type != ACVP_HASH_TEST_TYPE_MCT || stc->mct_md_stride < 32) {
+        return 1;
+    }
+    for (i = 0; i < ACVP_HASH_MCT_OUTER; i++) {
+        memset(stc->mct_md + (size_t)i * stc->mct_md_stride, i, 32);
+        stc->mct_md_len[i] = 32;
+    }
+    mct_loop_calls++;
+    return 0;
+}
+
+/*
+ * Leaves a checkpoint without a digest
+ */
+static int mct_loop_handler_short(ACVP_TEST_CASE *test_case) {
+    ACVP_HASH_TC *stc = test_case->tc.hash;
+    int i = 0;
+
+    for (i = 0; i < ACVP_HASH_MCT_OUTER - 1; i++) {
+        stc->mct_md_len[i] = 32;
+    }
+    return 0;
+}
+
+Test(HASH_CAPABILITY, mct_loop_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_hash_set_mct_loop_handler(NULL, ACVP_HASH_SHA256, &mct_loop_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+    rv = acvp_cap_hash_set_mct_loop_handler(ctx, ACVP_HASH_SHA256, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_hash_set_mct_loop_handler(ctx, ACVP_HASH_SHA1, &mct_loop_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+
+    rv = acvp_cap_cmac_enable(ctx, ACVP_CMAC_AES, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hash_set_mct_loop_handler(ctx, ACVP_CMAC_AES, &mct_loop_handler);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_cap_hash_set_mct_loop_handler(ctx, ACVP_HASH_SHA256, &mct_loop_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * The whole MCT takes one call, ahead of the per checkpoint handler
+ */
+Test(HASH_HANDLER, mct_loop_handler, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/hash/hash.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_hash_set_mct_handler(ctx, ACVP_HASH_SHA256, &mct_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hash_set_mct_loop_handler(ctx, ACVP_HASH_SHA256, &mct_loop_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    mct_calls = 0;
+    mct_loop_calls = 0;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(mct_loop_calls == 1);
+    cr_assert(mct_calls == 0);
+    json_value_free(val);
+}
+
+/*
+ * A checkpoint the module did not fill in fails the test
+ */
+Test(HASH_HANDLER, mct_loop_handler_short, .init = setup, .fini = teardown) {
+    val = json_parse_file("json/hash/hash.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_cap_hash_set_mct_loop_handler(ctx, ACVP_HASH_SHA256, &mct_loop_handler_short);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+}
+
+/*
+ * The chunks add up to the expanded content, even when it ends part way
+ * through a copy of the message
+ */
+Test(HASH_API, ldt_next_chunk) {
+    ACVP_HASH_TC tc;
+    unsigned char msg[3] = { 0x61, 0x62, 0x63 };
+    const unsigned char *chunk = NULL;
+    unsigned long long int total = 0;
+    unsigned int chunk_len = 0, i = 0, calls = 0;
+    int good = 1;
+
+    memzero_s(&tc, sizeof(ACVP_HASH_TC));
+    cr_assert(acvp_hash_ldt_next_chunk(NULL, &chunk, &chunk_len) == ACVP_INVALID_ARG);
+    tc.test_type = ACVP_HASH_TEST_TYPE_AFT;
+    tc.msg = msg;
+    tc.msg_len = sizeof(msg);
+    cr_assert(acvp_hash_ldt_next_chunk(&tc, &chunk, &chunk_len) == ACVP_INVALID_ARG);
+
+    tc.test_type = ACVP_HASH_TEST_TYPE_LDT;
+    tc.exp_len = 3ULL * ACVP_HASH_LDT_CHUNK_SIZE + 2;
+    do {
+        rv = acvp_hash_ldt_next_chunk(&tc, &chunk, &chunk_len);
+        cr_assert(rv == ACVP_SUCCESS);
+        for (i = 0; i < chunk_len && good; i++) {
+            good = chunk[i] == msg[(total + i) % sizeof(msg)];
+        }
+        total += chunk_len;
+        calls++;
+    } while (chunk_len && calls < 16);
+    cr_assert(good);
+    cr_assert(total == tc.exp_len);
+    cr_assert(calls == 5);
+
+    /* Nothing more once it has all been handed out */
+    rv = acvp_hash_ldt_next_chunk(&tc, &chunk, &chunk_len);
+    cr_assert(rv == ACVP_SUCCESS && chunk_len == 0);
+    free(tc.ldt_chunk);
+}
+
+/*
+ * Test that the LDT content maps as one buffer of the repeated message
+ */
+Test(HASH_API, ldt_map) {
+    ACVP_HASH_TC tc;
+    unsigned char msg[3] = { 0x61, 0x62, 0x63 };
+    const unsigned char *data = NULL, *again = NULL;
+    unsigned long long int i = 0;
+    int good = 1;
+
+    memzero_s(&tc, sizeof(ACVP_HASH_TC));
+    cr_assert(acvp_hash_ldt_map(NULL, &data) == ACVP_INVALID_ARG);
+    tc.test_type = ACVP_HASH_TEST_TYPE_AFT;
+    tc.msg = msg;
+    tc.msg_len = sizeof(msg);
+    tc.exp_len = 30;
+    cr_assert(acvp_hash_ldt_map(&tc, NULL) == ACVP_INVALID_ARG);
+    cr_assert(acvp_hash_ldt_map(&tc, &data) == ACVP_INVALID_ARG);
+
+    tc.test_type = ACVP_HASH_TEST_TYPE_LDT;
+    tc.exp_len = 40ULL * 1024 * 1024 + 2;
+    rv = acvp_hash_ldt_map(&tc, &data);
+#ifdef _WIN32
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+#else
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(tc.ldt_map_len >= tc.exp_len);
+    for (i = 0; i < tc.exp_len && good; i++) {
+        good = data[i] == msg[i % sizeof(msg)];
+    }
+    cr_assert(good);
+
+    /* The same mapping is handed out again */
+    cr_assert(acvp_hash_ldt_map(&tc, &again) == ACVP_SUCCESS);
+    cr_assert(again == data);
+    acvp_unmap_repeated(tc.ldt_map, (size_t)tc.ldt_map_len);
+#endif
+}
+
+static const char *shake_vot_json =
+    "[{\"acvVersion\": \"1.0\"},"
+    " {\"vsId\": 1, \"algorithm\": \"SHAKE-128\", \"testGroups\": ["
+    "  {\"tgId\": 1, \"testType\": \"VOT\", \"tests\": ["
+    "   {\"tcId\": 1, \"msg\": \"00\", \"len\": 8, \"outLen\": 16},"
+    "   {\"tcId\": 2, \"msg\": \"01\", \"len\": 8, \"outLen\": 56}]}]}]";
+
+static int sink_short = 0;
+
+/*
+ * Writes the output as the counting bytes 0, 1, 2, ... three at a time,
+ * the way an XOF would be squeezed, one byte short if sink_short is set
+ */
+static int sink_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_HASH_TC *tc = test_case->tc.hash;
+    unsigned char block[3];
+    unsigned int i = 0, n = 0, out = 0;
+
+    if (!tc->md_sink || tc->md) {
+        return 1;
+    }
+    out = tc->xof_len - (sink_short ? 1 : 0);
+    for (i = 0; i < out; i += n) {
+        n = out - i < sizeof(block) ? out - i : sizeof(block);
+        block[0] = i;
+        block[1] = i + 1;
+        block[2] = i + 2;
+        if (acvp_output_write(tc->md_sink, block, n) != ACVP_SUCCESS) {
+            return 1;
+        }
+    }
+    /* Nothing past the output of the test case */
+    if (!sink_short && acvp_output_write(tc->md_sink, block, 1) != ACVP_DATA_TOO_LARGE) {
+        return 1;
+    }
+    return 0;
+}
+
+Test(HASH_CAPABILITY, output_sink, .init = setup, .fini = teardown) {
+    rv = acvp_cap_set_output_sink(ctx, ACVP_HASH_SHA256, 1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_set_output_sink(ctx, ACVP_HASH_SHAKE_128, 1);
+    cr_assert(rv == ACVP_NO_CAP);
+
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHAKE_128, &sink_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_output_sink(ctx, ACVP_HASH_SHAKE_128, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_output_sink(NULL, ACVP_HASH_SHAKE_128, 1);
+    cr_assert(rv == ACVP_NO_CTX);
+}
+
+/*
+ * The output of a SHAKE VOT test case is written through the sink into
+ * the response, and one written short fails the vector set
+ */
+Test(HASH_HANDLER, output_sink, .init = setup, .fini = teardown) {
+    JSON_Object *r_vs = NULL;
+    JSON_Array *r_tests = NULL;
+    JSON_Object *r_tc = NULL;
+
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHAKE_128, &sink_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_output_sink(ctx, ACVP_HASH_SHAKE_128, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_string(shake_vot_json);
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+
+    sink_short = 0;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    r_tests = json_object_get_array(json_array_get_object(json_object_get_array(r_vs, "testGroups"), 0), "tests");
+    r_tc = json_array_get_object(r_tests, 0);
+    cr_assert(!strcmp(json_object_get_string(r_tc, "md"), "0001"));
+    cr_assert(json_object_get_uint(r_tc, "outLen") == 16);
+    r_tc = json_array_get_object(r_tests, 1);
+    cr_assert(!strcmp(json_object_get_string(r_tc, "md"), "00010203040506"));
+    cr_assert(json_object_get_uint(r_tc, "outLen") == 56);
+
+    json_value_free(ctx->exec.kat_resp);
+    ctx->exec.kat_resp = NULL;
+    sink_short = 1;
+    rv = acvp_hash_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+}
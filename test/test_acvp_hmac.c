@@ -421,3 +421,114 @@ Test(HMAC_HANDLER, cryptoFail2, .init = setup_fail, .fini = teardown) {
     cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
     json_value_free(val);
 }
+
+/*
+ * Test cases spread across threads give the same results as serially
+ */
+Test(HMAC_HANDLER, parallel, .fini = teardown) {
+    ACVP_RESULT rv;
+
+    setup_empty_ctx(&ctx);
+    setup(ctx);
+    rv = acvp_set_max_parallel_test_cases(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/hmac/hmac1.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    rv = acvp_hmac_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    json_value_free(val);
+}
+
+/*
+ * A failing test case run on another thread still fails the vector set
+ */
+Test(HMAC_HANDLER, parallel_cryptoFail, .init = setup_fail, .fini = teardown) {
+    ACVP_RESULT rv;
+
+    rv = acvp_set_max_parallel_test_cases(ctx, 4);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/hmac/hmac1.json");
+
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    counter_set = 0;
+    counter_fail = 0; /* fail on first iteration of AFT */
+
+    rv = acvp_hmac_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    json_value_free(val);
+}
+
+static int group_marker = 0;
+static int group_begin_cnt = 0;
+static int group_end_cnt = 0;
+static unsigned int key_ids[16];
+static int key_id_cnt = 0;
+
+static int group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    if (event == ACVP_TG_BEGIN) {
+        test_case->tc.hmac->tg_ctx = &group_marker;
+        group_begin_cnt++;
+    } else {
+        group_end_cnt++;
+    }
+    return 0;
+}
+
+static int key_id_handler(ACVP_TEST_CASE *test_case) {
+    if (test_case->tc.hmac->tg_ctx != &group_marker) {
+        return 1;
+    }
+    if (key_id_cnt < 16) {
+        key_ids[key_id_cnt] = test_case->tc.hmac->key_id;
+    }
+    key_id_cnt++;
+    return 0;
+}
+
+/*
+ * Each test case gets the context the group handler set up, and those of a
+ * group with the same key get the same key_id
+ */
+Test(HMAC_HANDLER, group_key_id, .fini = teardown) {
+    ACVP_RESULT rv;
+    JSON_Array *tests = NULL;
+
+    setup_empty_ctx(&ctx);
+    setup(ctx);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_HMAC_SHA1, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    acvp_locate_cap_entry(ctx, ACVP_HMAC_SHA1)->crypto_handler = &key_id_handler;
+
+    val = json_parse_file("json/hmac/hmac1.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    /* Let the third test case use the key of the first */
+    tests = json_object_get_array(json_array_get_object(json_object_get_array(obj, "testGroups"), 0), "tests");
+    json_object_set_string(json_array_get_object(tests, 2), "key",
+                           json_object_get_string(json_array_get_object(tests, 0), "key"));
+
+    group_begin_cnt = group_end_cnt = key_id_cnt = 0;
+    rv = acvp_hmac_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_begin_cnt == 1);
+    cr_assert(group_end_cnt == 1);
+    cr_assert(key_id_cnt == 10);
+    cr_assert(key_ids[0] == 1);
+    cr_assert(key_ids[1] == 2);
+    cr_assert(key_ids[2] == 1);
+    cr_assert(key_ids[3] == 3);
+    cr_assert(key_ids[9] == 9);
+    json_value_free(val);
+}
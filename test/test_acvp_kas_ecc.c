@@ -1271,3 +1271,74 @@ Test(KAS_ECC_SSC_HANDLER, missing_ephemeralPublicIutY, .init = setup, .fini = te
 }
 
 
+
+static int batch_calls = 0, batch_tcs = 0, batch_misses = 0;
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_KAS_ECC_TC *tc = test_cases[i].tc.kas_ecc;
+
+        if (!tc->cipher || !tc->curve || !tc->psxlen || !tc->psylen) batch_misses++;
+        if (tc->curve != test_cases[0].tc.kas_ecc->curve) batch_misses++;
+        if (i && tc == test_cases[i - 1].tc.kas_ecc) batch_misses++;
+        tc->pixlen = tc->piylen = tc->dlen = tc->chashlen = 1;
+        results[i] = 0;
+        batch_tcs++;
+    }
+    return 0;
+}
+
+/*
+ * A CDH, Component or SSC test group goes to the batch handler in one
+ * call, all of its test cases on the curve of the group
+ */
+Test(KAS_ECC_HANDLER, batch_handler, .init = setup, .fini = teardown) {
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_KAS_ECC_CDH, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_KAS_ECC_COMP, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_KAS_ECC_SSC, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    batch_calls = batch_tcs = batch_misses = 0;
+    val = json_parse_file("json/kas_ecc/kas_ecc_cdh.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_kas_ecc_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs > batch_calls);
+    json_value_free(val);
+
+    batch_calls = batch_tcs = 0;
+    val = json_parse_file("json/kas_ecc/kas_ecc_comp.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_kas_ecc_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs > batch_calls);
+    json_value_free(val);
+
+    batch_calls = batch_tcs = 0;
+    val = json_parse_file("json/kas_ecc/kas_ecc_ssc.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_kas_ecc_ssc_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls > 0);
+    cr_assert(batch_tcs > batch_calls);
+    cr_assert(batch_misses == 0);
+    json_value_free(val);
+
+    /* A test case missing a field still fails the vector set */
+    val = json_parse_file("json/kas_ecc/kas_ecc_ssc_2.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_kas_ecc_ssc_kat_handler(ctx, obj);
+    cr_assert(rv != ACVP_SUCCESS);
+    json_value_free(val);
+}
@@ -305,6 +305,51 @@ Test(KAS_FFC_COMP_HANDLER, good, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static int group_begins = 0, group_ends = 0, group_misses = 0;
+static int group_state = 0;
+
+static int group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_KAS_FFC_TC *tc = test_case->tc.kas_ffc;
+
+    if (event == ACVP_TG_BEGIN) {
+        if (tc->eps || !tc->p || !tc->plen || !tc->q || !tc->g || !tc->md) group_misses++;
+        tc->tg_ctx = &group_state;
+        group_begins++;
+    } else {
+        if (tc->tg_ctx != &group_state) group_misses++;
+        group_ends++;
+    }
+    return 0;
+}
+
+static int group_crypto_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_KAS_FFC_TC *tc = test_case->tc.kas_ffc;
+
+    if (tc->tg_ctx != &group_state || !tc->plen || !tc->epslen) group_misses++;
+    return 0;
+}
+
+/*
+ * A group handler sees every test group start and end with the domain
+ * parameters of the group, and its tg_ctx reaches every test case
+ */
+Test(KAS_FFC_COMP_HANDLER, group_handler, .init = setup, .fini = teardown) {
+    acvp_locate_cap_entry(ctx, ACVP_KAS_FFC_COMP)->crypto_handler = &group_crypto_handler;
+    rv = acvp_cap_set_group_handler(ctx, ACVP_KAS_FFC_COMP, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    group_begins = group_ends = group_misses = 0;
+    val = json_parse_file("json/kas_ffc/kas_ffc_comp.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_kas_ffc_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_begins == 8);
+    cr_assert(group_ends == 8);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+}
+
 /*
  * The key:"algorithm" is missing.
  */
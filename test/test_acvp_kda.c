@@ -736,6 +736,57 @@ Test(KDA_HKDF_HANDLER, missing_context, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static unsigned char fixed_info_first[256];
+static int fixed_info_first_len = 0, fixed_info_cnt = 0;
+
+static int fixed_info_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_KDA_HKDF_TC *stc = test_case->tc.kda_hkdf;
+
+    if (!stc->fixedInfo || stc->fixedInfoLen <= 0) {
+        return 1;
+    }
+    if (!fixed_info_cnt++) {
+        memcpy_s(fixed_info_first, sizeof(fixed_info_first), stc->fixedInfo, stc->fixedInfoLen);
+        fixed_info_first_len = stc->fixedInfoLen;
+    }
+    return 0;
+}
+
+/*
+ * The crypto module gets the fixedInfo assembled from the group's
+ * fixedInfoPattern: literal, both parties, context, algorithmId, label, L
+ */
+Test(KDA_HKDF_HANDLER, fixed_info, .init = setup, .fini = teardown) {
+    const char *expected = "0123456789ABCDEF"
+                           "BF49E007554DF52F56C78E583F27214E"
+                           "5DCA6705DA3EADB32237104313DE9D114D135136B3031A5F065779EABA27DE"
+                           "DE1F138B3EE021CAD56A214D07EE2F0B"
+                           "9F96F92F22490932F0000C6306A8A54FF7007C3B3D0705A67A7C35016A44FF"
+                           "CC0165BE697F4982D6ADED7D6535FE11"
+                           "7BCFD1455C82483743104E555519D34D"
+                           "5A26E8EE34D86FDB2A7E0EF94311EFFB"
+                           "00000800";
+    unsigned char bin[256];
+    int bin_len = 0, diff = 1;
+
+    val = json_parse_file("json/kda/kda_hkdf_1.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    acvp_locate_cap_entry(ctx, ACVP_KDA_HKDF)->crypto_handler = &fixed_info_handler;
+    fixed_info_cnt = 0;
+    rv = acvp_kda_hkdf_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(fixed_info_cnt > 1);
+
+    rv = acvp_hexstr_to_bin(expected, bin, sizeof(bin), &bin_len);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(fixed_info_first_len == bin_len);
+    memcmp_s(fixed_info_first, sizeof(fixed_info_first), bin, bin_len, &diff);
+    cr_assert(!diff);
+    json_value_free(val);
+}
+
 //Since they share much of the same code, test the common code using
 //HKDF and test the diffs using onestep
 /*
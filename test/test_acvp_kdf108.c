@@ -182,6 +182,52 @@ Test(KDF108_HANDLER, good, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static int group_begins = 0, group_ends = 0, group_misses = 0, group_cases = 0;
+static int group_state = 0;
+
+static int group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_KDF108_TC *tc = test_case->tc.kdf108;
+
+    if (event == ACVP_TG_BEGIN) {
+        if (tc->tc_id || tc->key_in || tc->mode != ACVP_KDF108_MODE_COUNTER || !tc->mac_mode ||
+            tc->counter_len != 8 || !tc->counter_location || !tc->key_out_len) group_misses++;
+        tc->tg_ctx = &group_state;
+        group_begins++;
+    } else {
+        if (tc->tg_ctx != &group_state) group_misses++;
+        group_ends++;
+    }
+    return 0;
+}
+
+static int group_crypto_handler(ACVP_TEST_CASE *test_case) {
+    if (test_case->tc.kdf108->tg_ctx != &group_state) group_misses++;
+    group_cases++;
+    return 0;
+}
+
+/*
+ * A group handler sees every test group start and end with the group's
+ * PRF and lengths, and its tg_ctx reaches every test case
+ */
+Test(KDF108_HANDLER, group_handler, .init = setup, .fini = teardown) {
+    acvp_locate_cap_entry(ctx, ACVP_KDF108)->crypto_handler = &group_crypto_handler;
+    rv = acvp_cap_set_group_handler(ctx, ACVP_KDF108, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    group_begins = group_ends = group_misses = group_cases = 0;
+    val = json_parse_file("json/kdf108/kdf108.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_kdf108_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_begins == 11);
+    cr_assert(group_ends == 11);
+    cr_assert(group_cases == 22);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+}
+
 /*
  * The value for key:"algorithm" is wrong.
  */
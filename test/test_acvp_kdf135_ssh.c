@@ -449,3 +449,70 @@ Test(Kdf135SshFail, tcFail) {
     teardown_ctx(&ctx);
 }
 
+
+static int ssh_k_len = 0;
+
+/*
+ * Fills each output with the byte of its position in the response, and
+ * keeps the length of the first k that it was handed
+ */
+static int ssh_fill_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_KDF135_SSH_TC *stc = test_case->tc.kdf135_ssh;
+
+    if (!ssh_k_len) {
+        ssh_k_len = stc->shared_secret_len;
+    }
+    memset(stc->cs_init_iv, 0x01, stc->iv_len);
+    memset(stc->cs_encrypt_key, 0x02, stc->e_key_len);
+    memset(stc->cs_integrity_key, 0x03, stc->i_key_len);
+    memset(stc->sc_init_iv, 0x04, stc->iv_len);
+    memset(stc->sc_encrypt_key, 0x05, stc->e_key_len);
+    memset(stc->sc_integrity_key, 0x06, stc->i_key_len);
+    return 0;
+}
+
+/*
+ * The outputs of the field table make it into the response, at the lengths
+ * of the group's cipher and hash
+ */
+Test(Kdf135SshFunc, output_fields) {
+    ACVP_RESULT rv;
+    JSON_Object *obj, *r_vs, *tc_rsp;
+    JSON_Value *val;
+    const char *hex = NULL;
+
+    setup_empty_ctx(&ctx);
+
+    rv = acvp_cap_kdf135_ssh_enable(ctx, &ssh_fill_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_prereq(ctx, ACVP_KDF135_SSH, ACVP_PREREQ_SHA, cvalue);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_prereq(ctx, ACVP_KDF135_SSH, ACVP_PREREQ_TDES, cvalue);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_kdf135_ssh_set_parm(ctx, ACVP_KDF135_SSH, ACVP_SSH_METH_TDES_CBC, ACVP_SHA1);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/kdf135_ssh/kdf135_ssh1.json");
+    obj = ut_get_obj_from_rsp(val);
+    if (!obj) {
+        ACVP_LOG_ERR("JSON obj parse error");
+        return;
+    }
+    ssh_k_len = 0;
+    rv  = acvp_kdf135_ssh_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(ssh_k_len == 260);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    tc_rsp = json_array_get_object(json_object_get_array(json_array_get_object(
+                 json_object_get_array(r_vs, "testGroups"), 0), "tests"), 0);
+    cr_assert(json_object_get_uint(tc_rsp, "tcId") == 1);
+    hex = json_object_get_string(tc_rsp, "initialIvClient");
+    cr_assert(hex && !strcmp(hex, "0101010101010101"));
+    hex = json_object_get_string(tc_rsp, "encryptionKeyServer");
+    cr_assert(hex && strlen(hex) == 48 && !strncmp(hex, "0505", 4));
+    hex = json_object_get_string(tc_rsp, "integrityKeyServer");
+    cr_assert(hex && strlen(hex) == 40 && !strncmp(hex, "0606", 4));
+    json_value_free(val);
+    teardown_ctx(&ctx);
+}
@@ -568,3 +568,56 @@ Test(Kdf135x963Fail, tcFail) {
     teardown_ctx(&ctx);
 }
 
+
+static int batch_calls = 0, batch_tcs = 0, batch_misses = 0;
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_KDF135_X963_TC *tc = test_cases[i].tc.kdf135_x963;
+
+        if (!tc->tc_id || !tc->z_len || !tc->shared_info || !tc->key_data) batch_misses++;
+        /* Each test case of the batch gets buffers of its own */
+        if (i && tc->key_data == test_cases[i - 1].tc.kdf135_x963->key_data) batch_misses++;
+        results[i] = 0;
+        batch_tcs++;
+    }
+    return 0;
+}
+
+/*
+ * With a batch handler, the test cases of each group are handed to the
+ * crypto module in one call
+ */
+Test(Kdf135x963Batch, batch_handler) {
+    ACVP_RESULT rv;
+    JSON_Object *obj;
+    JSON_Value *val;
+
+    setup_empty_ctx(&ctx);
+
+    rv = acvp_cap_kdf135_x963_enable(ctx, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_prereq(ctx, ACVP_KDF135_X963, ACVP_PREREQ_SHA, cvalue);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_kdf135_x963_set_parm(ctx, ACVP_KDF_X963_HASH_ALG, ACVP_SHA224);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_KDF135_X963, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/kdf135_x963/kdf135_x963_1.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    batch_calls = batch_tcs = batch_misses = 0;
+    rv  = acvp_kdf135_x963_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls == 1);
+    cr_assert(batch_tcs == 13);
+    cr_assert(batch_misses == 0);
+
+    json_value_free(val);
+    teardown_ctx(&ctx);
+}
@@ -199,6 +199,55 @@ Test(KTS_IFC_HANDLER, good, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static unsigned int key_ids[32];
+static int key_id_cnt = 0;
+
+static int key_id_handler(ACVP_TEST_CASE *test_case) {
+    if (key_id_cnt < 32) {
+        key_ids[key_id_cnt] = test_case->tc.kts_ifc->key_id;
+    }
+    key_id_cnt++;
+    return 0;
+}
+
+/*
+ * Test cases of a group with the same IUT key get the same key_id,
+ * and test cases without an IUT key get none
+ */
+Test(KTS_IFC_HANDLER, key_id, .init = setup, .fini = teardown) {
+    JSON_Array *tests = NULL;
+    JSON_Object *first = NULL, *reuse = NULL;
+    const char *fields[] = { "iutN", "iutE", "iutP", "iutQ", "iutD" };
+    int i;
+
+    val = json_parse_file("json/kts_ifc/kts_ifc.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    /* Let the third test case of the responder group use the key of the first */
+    tests = json_object_get_array(json_array_get_object(json_object_get_array(obj, "testGroups"), 0), "tests");
+    first = json_array_get_object(tests, 0);
+    reuse = json_array_get_object(tests, 2);
+    for (i = 0; i < 5; i++) {
+        json_object_set_string(reuse, fields[i], json_object_get_string(first, fields[i]));
+    }
+
+    acvp_locate_cap_entry(ctx, ACVP_KTS_IFC)->crypto_handler = &key_id_handler;
+    key_id_cnt = 0;
+    rv = acvp_kts_ifc_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(key_id_cnt == 20);
+    cr_assert(key_ids[0] == 1);
+    cr_assert(key_ids[1] == 2);
+    cr_assert(key_ids[2] == 1);
+    cr_assert(key_ids[3] == 3);
+    cr_assert(key_ids[9] == 9);
+    for (i = 10; i < 20; i++) {
+        cr_assert(key_ids[i] == 0);
+    }
+    json_value_free(val);
+}
+
 /*
  * The key:"algorithm" is missing.
  */
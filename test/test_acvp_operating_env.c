@@ -9,6 +9,8 @@
  */
 
 
+#include <time.h>
+
 #include "ut_common.h"
 #include "acvp/acvp_lcl.h"
 
@@ -105,6 +107,72 @@ Test(VERIFY_FIPS_OPERATING_ENV, verify_fips_operating_env, .init = setup, .fini
 #endif
 }
 
+/*
+ * Test  acvp_set_metadata_cache_file
+ */
+Test(METADATA_CACHE, set_metadata_cache_file, .init = setup, .fini = teardown) {
+    char long_name[ACVP_JSON_FILENAME_MAX + 2];
+
+    rv = acvp_set_metadata_cache_file(NULL, "meta_cache_test.json", 60);
+    cr_assert(rv == ACVP_NO_CTX);
+
+    rv = acvp_set_metadata_cache_file(ctx, NULL, 60);
+    cr_assert(rv == ACVP_MISSING_ARG);
+
+    memset(long_name, 'a', sizeof(long_name) - 1);
+    long_name[sizeof(long_name) - 1] = '\0';
+    rv = acvp_set_metadata_cache_file(ctx, long_name, 60);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_set_metadata_cache_file(ctx, "meta_cache_test.json", 0);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_set_metadata_cache_file(ctx, "meta_cache_test.json", 60);
+    cr_assert(rv == ACVP_SUCCESS);
+}
+
+/*
+ * Entries of the metadata cache that are older than the TTL are dropped
+ * from the file, the others are kept
+ */
+Test(METADATA_CACHE, expired_entries, .init = setup, .fini = teardown) {
+    const char *cache_file = "meta_cache_test.json";
+    JSON_Value *val = NULL;
+    JSON_Array *entries = NULL;
+    FILE *fp = NULL;
+    time_t now = time(NULL);
+
+    remove(cache_file);
+    fp = fopen(cache_file, "w");
+    cr_assert(fp != NULL);
+    fprintf(fp, "{\"version\": 1, \"entries\": ["
+                "{\"key\": \"0000000000000001\", \"saved\": 1, \"urls\": [\"/acvp/v1/oes/1\"]},"
+                "{\"key\": \"0000000000000002\", \"saved\": %.0f, \"urls\": [\"/acvp/v1/oes/2\"]}]}",
+            (double)now);
+    fclose(fp);
+
+    rv = acvp_oe_ingest_metadata(ctx, "json/meta.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_oe_set_fips_validation_metadata(ctx, 1, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_set_metadata_cache_file(ctx, cache_file, 3600);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    /* There is no server to find the metadata on */
+    rv = acvp_verify_fips_validation_metadata(ctx);
+    cr_assert(rv != ACVP_SUCCESS);
+    cr_assert(ctx->meta_cache == NULL);
+
+    val = json_parse_file(cache_file);
+    cr_assert(val != NULL);
+    entries = json_object_get_array(json_value_get_object(val), "entries");
+    cr_assert(json_array_get_count(entries) == 1);
+    cr_assert(strcmp(json_object_get_string(json_array_get_object(entries, 0), "key"), "0000000000000002") == 0);
+
+    json_value_free(val);
+    remove(cache_file);
+}
+
 /*
  * Test  acvp_oe_dependency_new
  */
@@ -179,3 +247,55 @@ Test(MODULE_SET_TYPE_VERSION_DESC, module_set_type_version_desc, .init = setup,
     cr_assert(rv == ACVP_INVALID_ARG);
 
 }
+
+/*
+ * A lookup of the validation metadata that fails is not left pending in the
+ * lookups shared by the sessions of an orchestrator, so the next session
+ * looks it up itself rather than waiting for it
+ */
+static int shared_lookups_pending(ACVP_META_SHARE *share) {
+    JSON_Array *entries = json_value_get_array(share->entries);
+    int i = 0, pending = 0;
+
+    for (i = 0; i < (int)json_array_get_count(entries); i++) {
+        if (json_object_get_boolean(json_array_get_object(entries, i), "pending") == 1) pending++;
+    }
+    return pending;
+}
+
+Test(METADATA_CACHE, shared_lookup_fails, .init = setup, .fini = teardown) {
+    ACVP_META_SHARE *share = NULL;
+    ACVP_CTX *ctx2 = NULL;
+
+    share = acvp_meta_share_new();
+    cr_assert(share != NULL);
+    setup_empty_ctx(&ctx2);
+
+    rv = acvp_oe_ingest_metadata(ctx, "json/meta.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_oe_set_fips_validation_metadata(ctx, 1, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_oe_ingest_metadata(ctx2, "json/meta.json");
+    cr_assert(rv == ACVP_SUCCESS);
+    /* The ids of the metadata go on from the first context's */
+    rv = acvp_oe_set_fips_validation_metadata(ctx2, ctx2->op_env.modules.module[0].id,
+                                              ctx2->op_env.oes.oe[0].id);
+    cr_assert(rv == ACVP_SUCCESS);
+    ctx->meta_share = share;
+    ctx2->meta_share = share;
+
+    /* There is no server to find the metadata on */
+    rv = acvp_verify_fips_validation_metadata(ctx);
+    cr_assert(rv != ACVP_SUCCESS);
+    cr_assert(json_array_get_count(json_value_get_array(share->entries)) > 0);
+    cr_assert(shared_lookups_pending(share) == 0);
+
+    rv = acvp_verify_fips_validation_metadata(ctx2);
+    cr_assert(rv != ACVP_SUCCESS);
+    cr_assert(shared_lookups_pending(share) == 0);
+
+    ctx->meta_share = NULL;
+    ctx2->meta_share = NULL;
+    teardown_ctx(&ctx2);
+    acvp_meta_share_free(share);
+}
@@ -165,6 +165,79 @@ Test(PBKDF_HANDLER, good, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+static ACVP_HASH_ALG async_hmac = 0;
+static unsigned long long int async_last_cost = 0;
+static int async_started = 0, async_out_of_order = 0;
+
+/* Iterations times output blocks, as the library estimates a test case */
+static unsigned long long int pbkdf_cost(ACVP_PBKDF_TC *tc) {
+    int block_len = 32;
+
+    switch (tc->hmac_type) {
+    case ACVP_SHA1: block_len = 20; break;
+    case ACVP_SHA224: case ACVP_SHA512_224: case ACVP_SHA3_224: block_len = 28; break;
+    case ACVP_SHA384: case ACVP_SHA3_384: block_len = 48; break;
+    case ACVP_SHA512: case ACVP_SHA3_512: block_len = 64; break;
+    case ACVP_SHA256: case ACVP_SHA512_256: case ACVP_SHA3_256: break;
+    case ACVP_NO_SHA: case ACVP_SHAKE_128: case ACVP_SHAKE_256: case ACVP_HASH_ALG_MAX:
+    default: break;
+    }
+    return (unsigned long long int)tc->iterationCount * ((tc->key_len + block_len - 1) / block_len);
+}
+
+/* Completes each test case right away, noting the order they are started in */
+static int async_handler(ACVP_TEST_CASE *test_case, ACVP_TC_HANDLE *handle) {
+    ACVP_PBKDF_TC *tc = test_case->tc.pbkdf;
+    unsigned long long int cost = pbkdf_cost(tc);
+
+    /* Each test group of the vector set uses its own HMAC */
+    if (tc->hmac_type != async_hmac) {
+        async_hmac = tc->hmac_type;
+        async_last_cost = cost;
+    }
+    if (cost > async_last_cost) {
+        async_out_of_order++;
+    }
+    async_last_cost = cost;
+    async_started++;
+    acvp_tc_complete(handle, 0);
+    return 0;
+}
+
+/*
+ * Test cases with the most iterations are started first, and their
+ * results still land in test case order
+ */
+Test(PBKDF_HANDLER, async_longest_first, .init = setup, .fini = teardown) {
+    JSON_Array *tests = NULL;
+    JSON_Object *group = NULL;
+    int i = 0;
+
+    rv = acvp_cap_set_async_handler(ctx, ACVP_PBKDF, &async_handler, 1);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/pbkdf/pbkdf.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    async_hmac = 0;
+    async_started = async_out_of_order = 0;
+    rv  = acvp_pbkdf_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(async_started == 450);
+    cr_assert(async_out_of_order == 0);
+
+    group = json_array_get_object(json_object_get_array(json_array_get_object(
+                json_value_get_array(ctx->exec.kat_resp), 1), "testGroups"), 0);
+    tests = json_object_get_array(group, "tests");
+    cr_assert(json_array_get_count(tests) == 50);
+    for (i = 1; i < 50; i++) {
+        cr_assert(json_object_get_number(json_array_get_object(tests, i), "tcId") >
+                  json_object_get_number(json_array_get_object(tests, i - 1), "tcId"));
+    }
+    json_value_free(val);
+}
+
 /*
  * The value for key:"algorithm" is wrong.
  */
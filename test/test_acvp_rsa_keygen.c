@@ -9,6 +9,7 @@
  */
 
 
+#include <unistd.h>
 #include "ut_common.h"
 #include "acvp/acvp_lcl.h"
 
@@ -195,6 +196,136 @@ Test(RSA_KEYGEN_HANDLER, good, .init = setup, .fini = teardown) {
 }
 
 
+static ACVP_MUTEX par_lock;
+static int par_calls = 0, par_running = 0, par_max_running = 0;
+
+/*
+ * Stands in for a module generating keys, with a modulus that tells which
+ * test case it was generated for
+ */
+static int parallel_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_RSA_KEYGEN_TC *tc = test_case->tc.rsa_keygen;
+
+    acvp_mutex_lock(&par_lock);
+    par_calls++;
+    par_running++;
+    if (par_running > par_max_running) {
+        par_max_running = par_running;
+    }
+    acvp_mutex_unlock(&par_lock);
+
+    usleep(2000);
+    tc->n[0] = (unsigned char)tc->tc_id;
+    tc->n_len = 1;
+
+    acvp_mutex_lock(&par_lock);
+    par_running--;
+    acvp_mutex_unlock(&par_lock);
+    return 0;
+}
+
+/*
+ * The test cases of a group are spread across the threads, and each
+ * response gets the key of its own test case, in test case order
+ */
+Test(RSA_KEYGEN_HANDLER, parallel, .init = setup, .fini = teardown) {
+    JSON_Array *groups = NULL, *tests = NULL;
+    JSON_Object *test = NULL;
+    char n_str[3];
+    int i = 0, j = 0, tc_id = 0, count = 0;
+
+    acvp_locate_cap_entry(ctx, ACVP_RSA_KEYGEN)->crypto_handler = &parallel_handler;
+    rv = acvp_set_max_parallel_test_cases(ctx, 3);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/rsa/rsa_keygen.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    acvp_mutex_init(&par_lock);
+    par_calls = par_running = par_max_running = 0;
+    rv = acvp_rsa_keygen_kat_handler(ctx, obj);
+    acvp_mutex_destroy(&par_lock);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(par_calls == 6);
+    cr_assert(par_max_running >= 2 && par_max_running <= 3);
+
+    groups = json_object_get_array(json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1),
+                                   "testGroups");
+    for (i = 0; i < (int)json_array_get_count(groups); i++) {
+        tests = json_object_get_array(json_array_get_object(groups, i), "tests");
+        for (j = 0; j < (int)json_array_get_count(tests); j++) {
+            test = json_array_get_object(tests, j);
+            tc_id = json_object_get_number(test, "tcId");
+            snprintf(n_str, sizeof(n_str), "%02X", tc_id & 0xff);
+            cr_assert(strcmp(json_object_get_string(test, "n"), n_str) == 0);
+            count++;
+        }
+    }
+    cr_assert(count == 6);
+    json_value_free(val);
+}
+
+static int progress_calls = 0;
+
+/*
+ * Cancels the test case it is given progress on the third time round
+ */
+static int cancel_progress_cb(const ACVP_TC_PROGRESS *progress, void *arg) {
+    int *tc_id = arg;
+
+    *tc_id = progress->tc_id;
+    return progress->calls >= 3;
+}
+
+/*
+ * Stands in for a module that reports progress while it generates primes,
+ * and gives up when told to
+ */
+static int progress_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_RSA_KEYGEN_TC *tc = test_case->tc.rsa_keygen;
+
+    if (!tc->control) {
+        return 0;
+    }
+    while (!acvp_tc_progress(tc->control)) {
+        progress_calls++;
+    }
+    progress_calls++;
+    return 1;
+}
+
+/*
+ * A test case that is cancelled through its progress fails the vector set,
+ * and the crypto module only sees a control when there is something to check
+ */
+Test(RSA_KEYGEN_HANDLER, progress_cancel, .init = setup, .fini = teardown) {
+    int tc_id = 0;
+
+    acvp_locate_cap_entry(ctx, ACVP_RSA_KEYGEN)->crypto_handler = &progress_handler;
+    val = json_parse_file("json/rsa/rsa_keygen.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    progress_calls = 0;
+    rv = acvp_rsa_keygen_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(progress_calls == 0);
+
+    rv = acvp_set_tc_progress_cb(ctx, &cancel_progress_cb, &tc_id);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_rsa_keygen_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_CRYPTO_MODULE_FAIL);
+    cr_assert(progress_calls == 3);
+    cr_assert(tc_id == 1);
+    cr_assert(acvp_tc_progress(NULL) == 0);
+
+    rv = acvp_set_tc_deadline(ctx, -1);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    json_value_free(val);
+}
+
+
 /*
  * The value for key:"algorithm" is wrong.
  */
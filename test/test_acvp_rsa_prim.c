@@ -198,6 +198,49 @@ end:
     if (ctx) teardown();
 }
 
+static int batch_calls = 0, batch_tcs = 0, batch_misses = 0;
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_RSA_PRIM_TC *tc = test_cases[i].tc.rsa_prim;
+
+        if (!tc->n_len || !tc->e_len || !tc->msg_len || !tc->signature) batch_misses++;
+        tc->disposition = 0;
+        results[i] = 0;
+        batch_tcs++;
+    }
+    return 0;
+}
+
+/*
+ * With a batch handler, the test cases of each SigPrim test group are
+ * handed to the crypto module in one call
+ */
+Test(RSA_SIGPRIM_API, batch_handler) {
+
+    setup();
+
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_RSA_SIGPRIM, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    val = json_parse_file("json/rsa/rsa_sigprim.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+
+    batch_calls = batch_tcs = batch_misses = 0;
+    rv  = acvp_rsa_sigprim_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls == 1);
+    cr_assert(batch_tcs == 30);
+    cr_assert(batch_misses == 0);
+    json_value_free(val);
+
+    teardown();
+}
+
 /*
  * Test the KAT handler API paths.
  */
@@ -673,6 +673,134 @@ Test(RSA_SIGVER_HANDLER, missing_tgid, .init = setup_sigver, .fini = teardown) {
     json_value_free(val);
 }
 
+static int group_begins = 0, group_ends = 0, group_misses = 0, batch_calls = 0, batch_tcs = 0;
+static int group_state = 0;
+
+static int group_handler(ACVP_TEST_CASE *test_case, ACVP_TG_EVENT event) {
+    ACVP_RSA_SIG_TC *tc = test_case->tc.rsa_sig;
+
+    if (event == ACVP_TG_BEGIN) {
+        if (tc->tc_id || tc->msg || !tc->e_len || !tc->n_len || !tc->modulo) group_misses++;
+        tc->tg_ctx = &group_state;
+        group_begins++;
+    } else {
+        if (tc->tg_ctx != &group_state) group_misses++;
+        group_ends++;
+    }
+    return 0;
+}
+
+static int batch_handler(ACVP_TEST_CASE *test_cases, int *results, int count) {
+    int i = 0;
+
+    batch_calls++;
+    for (i = 0; i < count; i++) {
+        ACVP_RSA_SIG_TC *tc = test_cases[i].tc.rsa_sig;
+
+        if (tc->tg_ctx != &group_state || !tc->n_len || !tc->sig_len) group_misses++;
+        tc->ver_disposition = 1;
+        results[i] = 0;
+        batch_tcs++;
+    }
+    return 0;
+}
+
+/*
+ * With a group and a batch handler, each SigVer test group is set up once
+ * with its public key and then verified in one call to the batch handler
+ */
+Test(RSA_SIGVER_HANDLER, batch_handler, .init = setup_sigver, .fini = teardown) {
+    rv = acvp_cap_set_batch_handler(ctx, ACVP_RSA_SIGVER, &batch_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_RSA_SIGVER, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    group_begins = group_ends = group_misses = batch_calls = batch_tcs = 0;
+    val = json_parse_file("json/rsa/rsa_sigver.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_rsa_sigver_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_begins == 3);
+    cr_assert(group_ends == 3);
+    cr_assert(batch_calls == 3);
+    cr_assert(batch_tcs == 3);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+}
+
+/*
+ * Checks the group shares one key and the signatures are packed, and
+ * verifies every other one
+ */
+static int soa_handler(ACVP_RSA_SIGVER_SOA *group, int *results) {
+    int i = 0;
+
+    batch_calls++;
+    if (group->tg_ctx != &group_state || !group->e_len || !group->n_len || !group->modulo ||
+            group->count <= 0 || group->sig_stride < group->modulo / 8) {
+        group_misses++;
+    }
+    for (i = 0; i < group->count; i++) {
+        if (!group->tc_id[i] || !group->sig_len[i] ||
+                (i && group->msg_off[i] != group->msg_off[i - 1] + group->msg_len[i - 1])) {
+            group_misses++;
+        }
+        group->ver_disposition[i] = (batch_tcs++ % 2) == 0;
+        results[i] = 0;
+    }
+    return 0;
+}
+
+Test(RSA_SIGVER_CAPABILITY, soa_handler) {
+    rv = acvp_cap_rsa_sigver_set_soa_handler(NULL, &soa_handler);
+    cr_assert(rv == ACVP_NO_CTX);
+
+    setup_empty_ctx(&ctx);
+    rv = acvp_cap_rsa_sigver_set_soa_handler(ctx, &soa_handler);
+    cr_assert(rv == ACVP_NO_CAP);
+    rv = acvp_cap_rsa_sig_enable(ctx, ACVP_RSA_SIGVER, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_rsa_sigver_set_soa_handler(ctx, NULL);
+    cr_assert(rv == ACVP_INVALID_ARG);
+    rv = acvp_cap_rsa_sigver_set_soa_handler(ctx, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    teardown_ctx(&ctx);
+}
+
+/*
+ * Each SigVer group goes to the SoA handler in one call, and each
+ * disposition ends up in the response of its own test case
+ */
+Test(RSA_SIGVER_HANDLER, soa_handler, .init = setup_sigver, .fini = teardown) {
+    JSON_Object *r_vs = NULL;
+    JSON_Array *r_groups = NULL;
+    JSON_Array *r_tests = NULL;
+
+    rv = acvp_cap_rsa_sigver_set_soa_handler(ctx, &soa_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_set_group_handler(ctx, ACVP_RSA_SIGVER, &group_handler);
+    cr_assert(rv == ACVP_SUCCESS);
+
+    group_begins = group_ends = group_misses = batch_calls = batch_tcs = 0;
+    val = json_parse_file("json/rsa/rsa_sigver.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_rsa_sigver_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(batch_calls == 3);
+    cr_assert(batch_tcs == 3);
+    cr_assert(group_misses == 0);
+
+    r_vs = json_array_get_object(json_value_get_array(ctx->exec.kat_resp), 1);
+    r_groups = json_object_get_array(r_vs, "testGroups");
+    r_tests = json_object_get_array(json_array_get_object(r_groups, 0), "tests");
+    cr_assert(json_object_get_boolean(json_array_get_object(r_tests, 0), "testPassed") == 1);
+    r_tests = json_object_get_array(json_array_get_object(r_groups, 1), "tests");
+    cr_assert(json_object_get_boolean(json_array_get_object(r_tests, 0), "testPassed") == 0);
+    json_value_free(val);
+}
+
 /*
  * The key: crypto handler operation fails on last crypto call
  */
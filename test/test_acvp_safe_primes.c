@@ -307,3 +307,79 @@ Test(SAFE_PRIMES_HANDLER, bad_testtype, .init = setup, .fini = teardown) {
     json_value_free(val);
 }
 
+
+/*
+ * The named group tables hold each p and q big endian and as limbs, with
+ * p = 2q + 1 and g = 2
+ */
+Test(SAFE_PRIMES_GROUPS, tables) {
+    const ACVP_FFC_GROUP *group = NULL;
+    unsigned long long int limb = 0, carry = 0;
+    int dgm = 0, i = 0, k = 0;
+
+    cr_assert(acvp_lookup_safe_primes_group(0) == NULL);
+    cr_assert(acvp_lookup_safe_primes_group(ACVP_SAFE_PRIMES_FFDHE8192 + 1) == NULL);
+    cr_assert(acvp_lookup_kas_ffc_group(ACVP_KAS_FFC_FB) == NULL);
+    cr_assert(acvp_lookup_kas_ffc_group(ACVP_KAS_FFC_FFDHE4096) ==
+              acvp_lookup_safe_primes_group(ACVP_SAFE_PRIMES_FFDHE4096));
+    cr_assert(!strcmp(acvp_lookup_safe_primes_group(ACVP_SAFE_PRIMES_MODP6144)->name, "MODP-6144"));
+
+    for (dgm = ACVP_SAFE_PRIMES_MODP2048; dgm <= ACVP_SAFE_PRIMES_FFDHE8192; dgm++) {
+        group = acvp_lookup_safe_primes_group(dgm);
+        cr_assert(group != NULL);
+        cr_assert(group->plen * 8 == group->bits);
+        cr_assert(group->qlen == group->plen);
+        cr_assert(group->p_limbs_cnt * 64 == group->bits);
+        cr_assert(group->q_limbs_cnt == group->p_limbs_cnt);
+        cr_assert(group->glen == 1 && group->g[0] == 2);
+        cr_assert(group->g_limbs_cnt == 1 && group->g_limbs[0] == 2);
+        cr_assert(group->p[0] == 0xff && group->p[group->plen - 1] == 0xff);
+
+        carry = 1;
+        for (i = 0; i < group->p_limbs_cnt; i++) {
+            limb = 0;
+            for (k = 0; k < 8; k++) {
+                limb = (limb << 8) | group->p[group->plen - 8 * i - 8 + k];
+            }
+            cr_assert(group->p_limbs[i] == limb);
+
+            limb = 0;
+            for (k = 0; k < 8; k++) {
+                limb = (limb << 8) | group->q[group->qlen - 8 * i - 8 + k];
+            }
+            cr_assert(group->q_limbs[i] == limb);
+
+            /* p = 2q + 1, a limb at a time */
+            cr_assert(group->p_limbs[i] == ((group->q_limbs[i] << 1) | carry));
+            carry = group->q_limbs[i] >> 63;
+        }
+        cr_assert(carry == 0);
+    }
+}
+
+static int group_misses = 0;
+
+static int group_crypto_handler(ACVP_TEST_CASE *test_case) {
+    ACVP_SAFE_PRIMES_TC *tc = test_case->tc.safe_primes;
+
+    if (!tc->group || tc->group != acvp_lookup_safe_primes_group(tc->dgm)) group_misses++;
+    tc->xlen = tc->ylen = 1;
+    return 0;
+}
+
+/*
+ * Every test case points at the domain parameters of its group
+ */
+Test(SAFE_PRIMES_HANDLER, group_params, .init = setup, .fini = teardown) {
+    acvp_locate_cap_entry(ctx, ACVP_SAFE_PRIMES_KEYGEN)->crypto_handler = &group_crypto_handler;
+    acvp_locate_cap_entry(ctx, ACVP_SAFE_PRIMES_KEYVER)->crypto_handler = &group_crypto_handler;
+
+    group_misses = 0;
+    val = json_parse_file("json/safe_primes/safe_primes.json");
+    obj = ut_get_obj_from_rsp(val);
+    cr_assert(obj != NULL);
+    rv = acvp_safe_primes_kat_handler(ctx, obj);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(group_misses == 0);
+    json_value_free(val);
+}
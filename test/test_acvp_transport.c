@@ -521,6 +521,25 @@ Test(TRANSPORT_DELETE, good, .init = test_setup_session_parameters, .fini = tear
 
 }
 
+/*
+ * Releasing the receive buffer leaves the ctx ready for the next response
+ */
+Test(TRANSPORT_RELEASE_BUF, good, .init = setup, .fini = teardown) {
+    acvp_transport_release_buf(NULL);
+
+    ctx->exec.curl_buf = calloc(16, sizeof(char));
+    cr_assert(ctx->exec.curl_buf != NULL);
+    ctx->exec.curl_read_ctr = 8;
+
+    acvp_transport_release_buf(ctx);
+    cr_assert(ctx->exec.curl_buf == NULL);
+    cr_assert(ctx->exec.curl_read_ctr == 0);
+
+    /* Nothing to release */
+    acvp_transport_release_buf(ctx);
+    cr_assert(ctx->exec.curl_buf == NULL);
+}
+
 #if 0 // TODO NIST does not have these enabled via API, we don't have Cisco server yet
 /*
  * missing vector set id url
@@ -671,4 +690,21 @@ Test(TRANSPORT_SEND_OE_REG, good, .init = setup, .fini = teardown) {
 }
 #endif
 
+/*
+ * The user agent is worked out on first use and shared by every context
+ */
+Test(TRANSPORT_USER_AGENT, cached, .init = setup, .fini = teardown) {
+    ACVP_CTX *ctx2 = NULL;
+    const char *ua = NULL;
+
+    ua = acvp_http_user_agent(ctx);
+    cr_assert(ua != NULL);
+    cr_assert(!strncmp(ua, "libacvp/", strlen("libacvp/")));
+    cr_assert(ua == acvp_http_user_agent(ctx));
+
+    setup_empty_ctx(&ctx2);
+    cr_assert(ua == acvp_http_user_agent(ctx2));
+    teardown_ctx(&ctx2);
+}
+
 #endif //ACVP_OFFLINE
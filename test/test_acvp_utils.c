@@ -11,6 +11,9 @@
 
 #include "ut_common.h"
 #include "acvp/acvp_lcl.h"
+#include <unistd.h>
+
+extern ACVP_ALG_HANDLER alg_tbl[];
 
 ACVP_CTX *ctx;
 
@@ -72,6 +75,38 @@ Test(LocateCapEntry, null_ctx) {
     cr_assert_null(list);
 }
 
+/*
+ * Registered ciphers are found by cipher, others and out of range values are not
+ */
+Test(LocateCapEntry, indexed) {
+    ACVP_CAPS_LIST *list;
+    ACVP_RESULT rv;
+
+    setup_empty_ctx(&ctx);
+
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_GCM, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_hash_enable(ctx, ACVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == ACVP_SUCCESS);
+    rv = acvp_cap_sym_cipher_enable(ctx, ACVP_AES_GCM, &dummy_handler_success);
+    cr_assert(rv == ACVP_DUP_CIPHER);
+
+    list = acvp_locate_cap_entry(ctx, ACVP_AES_GCM);
+    cr_assert(list == ctx->caps_list);
+    list = acvp_locate_cap_entry(ctx, ACVP_HASH_SHA256);
+    cr_assert(list == ctx->caps_list->next);
+    cr_assert(list->cipher == ACVP_HASH_SHA256);
+
+    list = acvp_locate_cap_entry(ctx, ACVP_AES_CBC);
+    cr_assert(list == NULL);
+    list = acvp_locate_cap_entry(ctx, ACVP_CIPHER_START);
+    cr_assert(list == NULL);
+    list = acvp_locate_cap_entry(ctx, ACVP_CIPHER_END);
+    cr_assert(list == NULL);
+
+    teardown_ctx(&ctx);
+}
+
 
 Test(LookupCipherIndex, null_param) {
     ACVP_CIPHER cipher;
@@ -86,11 +121,105 @@ Test(LookupCipherIndex, null_param) {
 
 }
 
+/*
+ * Every entry of alg_tbl that has a mode can be found by name and mode,
+ * and every name resolves to the first entry carrying it.
+ */
+Test(LookupCipherIndex, whole_table) {
+    ACVP_CIPHER cipher;
+    int i = 0, j = 0, diff = 1;
+
+    for (i = 0; i < ACVP_ALG_MAX; i++) {
+        if (alg_tbl[i].mode) {
+            cipher = acvp_lookup_cipher_w_mode_index(alg_tbl[i].name, alg_tbl[i].mode);
+            cr_assert(cipher == alg_tbl[i].cipher);
+        }
+
+        for (j = 0; j < i; j++) {
+            strcmp_s(alg_tbl[j].name, ACVP_ALG_NAME_MAX, alg_tbl[i].name, &diff);
+            if (!diff) break;
+        }
+        cipher = acvp_lookup_cipher_index(alg_tbl[i].name);
+        cr_assert(cipher == alg_tbl[j].cipher);
+    }
+
+    cipher = acvp_lookup_cipher_w_mode_index(ACVP_ALG_RSA, "Bad Mode");
+    cr_assert(cipher == ACVP_CIPHER_START);
+
+    cipher = acvp_lookup_cipher_w_mode_index(ACVP_ALG_RSA, NULL);
+    cr_assert(cipher == ACVP_CIPHER_START);
+}
+
+/*
+ * Vector set dispatch lookups, including KDF108 which ignores the mode
+ */
+Test(LookupAlgHandler, modes) {
+    const ACVP_ALG_HANDLER *entry = NULL;
+
+    entry = acvp_lookup_alg_handler(NULL, NULL);
+    cr_assert(entry == NULL);
+
+    entry = acvp_lookup_alg_handler("Bad Name", NULL);
+    cr_assert(entry == NULL);
+
+    entry = acvp_lookup_alg_handler(ACVP_ALG_ECDSA, ACVP_MODE_SIGVER);
+    cr_assert(entry != NULL);
+    cr_assert(entry->cipher == ACVP_ECDSA_SIGVER);
+
+    entry = acvp_lookup_alg_handler(ACVP_ALG_ECDSA, "Bad Mode");
+    cr_assert(entry == NULL);
+
+    entry = acvp_lookup_alg_handler(ACVP_ALG_RSA, NULL);
+    cr_assert(entry != NULL);
+    cr_assert(entry->cipher == ACVP_RSA_KEYGEN);
+
+    entry = acvp_lookup_alg_handler(ACVP_ALG_KDF108, "KMAC");
+    cr_assert(entry != NULL);
+    cr_assert(entry->cipher == ACVP_KDF108);
+}
+
 Test(LookupRSARandPQIndex, null_param) {
     int rv = acvp_lookup_rsa_randpq_index(NULL);
     cr_assert(!rv);
 }
 
+/*
+ * The hashed name lookups must round trip every entry and only match
+ * whole names
+ */
+Test(LookupNameIndex, round_trip) {
+    int i = 0;
+    const char *name = NULL;
+
+    for (i = ACVP_SHA1; i < ACVP_HASH_ALG_MAX; i <<= 1) {
+        name = acvp_lookup_hash_alg_name(i);
+        cr_assert(name != NULL);
+        cr_assert(acvp_lookup_hash_alg(name) == (ACVP_HASH_ALG)i);
+    }
+    for (i = ACVP_RSA_KEYGEN_B32; i <= ACVP_RSA_KEYGEN_PROB_W_PROB_AUX; i++) {
+        name = acvp_lookup_rsa_randpq_name(i);
+        cr_assert(name != NULL);
+        cr_assert(acvp_lookup_rsa_randpq_index(name) == i);
+    }
+    for (i = ACVP_LMS_MODE_SHA256_M24_H5; i < ACVP_LMS_MODE_MAX; i++) {
+        name = acvp_lookup_lms_mode_str(i);
+        cr_assert(name != NULL);
+        cr_assert(acvp_lookup_lms_mode(name) == (ACVP_LMS_MODE)i);
+    }
+
+    cr_assert(acvp_lookup_hash_alg("SHA2-512/224") == ACVP_SHA512_224);
+    cr_assert(!acvp_lookup_hash_alg("SHA2-51"));
+    cr_assert(!acvp_lookup_hash_alg("SHA2-5122"));
+    cr_assert(!acvp_lookup_hash_alg(NULL));
+    cr_assert(acvp_lookup_aux_function_alg_tbl(ACVP_ALG_SHA512_224) == ACVP_HASH_SHA512_224);
+    cr_assert(acvp_lookup_ed_curve("ED-448") == ACVP_ED_CURVE_448);
+    cr_assert(!acvp_lookup_ed_curve("ED-4480"));
+
+    cr_assert(acvp_lookup_ec_curve(ACVP_ECDSA_KEYGEN, "P-256") == ACVP_EC_CURVE_P256);
+    cr_assert(!acvp_lookup_ec_curve(ACVP_ECDSA_KEYGEN, "P-192"));
+    cr_assert(acvp_lookup_ec_curve(ACVP_ECDSA_SIGVER, "P-192") == ACVP_EC_CURVE_P192);
+}
+
 Test(JsonSerializeToFilePrettyW, null_param) {
     ACVP_RESULT rv = ACVP_SUCCESS;
     JSON_Value *value;
@@ -137,6 +266,98 @@ Test(JsonSerializeToFilePrettyA, null_param) {
     json_value_free(value);
 }
 
+/*
+ * Array files written compact parse back to the same values as pretty
+ * printed ones, and are smaller
+ */
+Test(JsonSerializeToFile, compact) {
+    JSON_Value *value = NULL, *read_back = NULL;
+    char *expected = NULL, *str = NULL;
+    long sizes[2] = { 0, 0 };
+    FILE *fp = NULL;
+    int compact = 0;
+
+    value = json_parse_file("json/aes/aes.json");
+    cr_assert(value != NULL);
+    for (compact = 0; compact < 2; compact++) {
+        cr_assert(acvp_json_serialize_to_file_w(value, "ser.json", compact) == ACVP_SUCCESS);
+        cr_assert(acvp_json_serialize_to_file_a(json_array_get_value(json_value_get_array(value), 1),
+                                                "ser.json", compact) == ACVP_SUCCESS);
+        cr_assert(acvp_json_serialize_to_file_a(NULL, "ser.json", compact) == ACVP_SUCCESS);
+
+        read_back = json_parse_file("ser.json");
+        cr_assert(read_back != NULL);
+        cr_assert(json_array_get_count(json_value_get_array(read_back)) == 2);
+        str = json_serialize_to_string(json_array_get_value(json_value_get_array(read_back), 0), NULL);
+        if (!expected) {
+            expected = str;
+        } else {
+            cr_assert(strcmp(str, expected) == 0);
+            json_free_serialized_string(str);
+        }
+        json_value_free(read_back);
+
+        fp = fopen("ser.json", "r");
+        cr_assert(fp != NULL);
+        fseek(fp, 0, SEEK_END);
+        sizes[compact] = ftell(fp);
+        fclose(fp);
+    }
+    cr_assert(sizes[1] < sizes[0]);
+
+    cr_assert(acvp_json_serialize_to_file_w(NULL, "ser.json", 1) == ACVP_JSON_ERR);
+    cr_assert(acvp_json_serialize_to_file_a(value, NULL, 1) == ACVP_INVALID_ARG);
+    remove("ser.json");
+    json_free_serialized_string(expected);
+    json_value_free(value);
+}
+
+/*
+ * What is queued on a writer ends up in the file in order, whether it is
+ * small pieces gathered together, JSON or the contents of another file,
+ * once the writer is closed
+ */
+Test(JsonSerializeToFile, writer) {
+    ACVP_WRITER *writer = NULL;
+    JSON_Value *value = NULL, *read_back = NULL;
+    JSON_Array *arr = NULL;
+    FILE *fp = NULL;
+    int i = 0;
+
+    cr_assert(acvp_writer_open(&writer, "no_such_dir/ser.json", "w") == ACVP_JSON_ERR);
+    cr_assert(writer == NULL);
+    cr_assert(acvp_writer_open(NULL, "ser.json", "w") == ACVP_INVALID_ARG);
+
+    value = json_parse_file("json/aes/aes.json");
+    cr_assert(value != NULL);
+    cr_assert(acvp_writer_open(&writer, "ser.json", "w") == ACVP_SUCCESS);
+    cr_assert(acvp_writer_json(writer, "[ ", value, 0) == ACVP_SUCCESS);
+    for (i = 0; i < 1000; i++) {
+        cr_assert(acvp_writer_puts(writer, ", ") == ACVP_SUCCESS);
+        cr_assert(acvp_writer_write(writer, "12", 2) == ACVP_SUCCESS);
+    }
+    fp = tmpfile();
+    cr_assert(fp != NULL);
+    fputs("\"from a file\"", fp);
+    cr_assert(acvp_writer_puts(writer, ", ") == ACVP_SUCCESS);
+    cr_assert(acvp_writer_file(writer, fp) == ACVP_SUCCESS);
+    cr_assert(acvp_writer_json(writer, ", ", value, 1) == ACVP_SUCCESS);
+    cr_assert(acvp_writer_puts(writer, " ]") == ACVP_SUCCESS);
+    cr_assert(acvp_writer_close(writer) == ACVP_SUCCESS);
+
+    read_back = json_parse_file("ser.json");
+    cr_assert(read_back != NULL);
+    arr = json_value_get_array(read_back);
+    cr_assert(json_array_get_count(arr) == 1003);
+    cr_assert(json_value_equals(json_array_get_value(arr, 0), value));
+    cr_assert(json_array_get_uint(arr, 1000) == 12);
+    cr_assert(!strcmp(json_array_get_string(arr, 1001), "from a file"));
+    cr_assert(json_value_equals(json_array_get_value(arr, 1002), value));
+    json_value_free(read_back);
+    remove("ser.json");
+    json_value_free(value);
+}
+
 /*
  * Exercise string_fits logic
  */
@@ -237,3 +458,1523 @@ Test(GetObjFromRsp, null_ctx) {
     acvp_free_test_session(ctx);
 }
 
+/*
+ * A shorter value written into a scratch buffer leaves nothing of the longer
+ * one before it, and release wipes what was used
+ */
+Test(SecureBuf, reuse) {
+    unsigned char bin[8] = { 0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04 };
+    char arr[32];
+    ACVP_SBUF wrapped = ACVP_SBUF_WRAP(arr);
+    ACVP_SBUF sb = { 0 };
+    int i = 0;
+
+    cr_assert(acvp_sbuf_bin_to_hexstr(&sb, bin, 8, 16) == ACVP_CONVERT_DATA_ERR);
+    cr_assert(acvp_sbuf_init(&sb, 17) == ACVP_SUCCESS);
+    cr_assert(acvp_sbuf_bin_to_hexstr(&sb, bin, 8, 16) == ACVP_SUCCESS);
+    cr_assert(!strcmp(sb.buf, "DEADBEEF01020304"));
+    cr_assert(acvp_sbuf_bin_to_hexstr(&sb, bin, 2, 16) == ACVP_SUCCESS);
+    cr_assert(!strcmp(sb.buf, "DEAD"));
+    for (i = 5; i < 17; i++) {
+        cr_assert(sb.buf[i] == 0);
+    }
+    /* dest_max is capped to the buffer */
+    cr_assert(acvp_sbuf_bin_to_hexstr(&sb, bin, 8, 1024) == ACVP_SUCCESS);
+    acvp_sbuf_release(&sb);
+    cr_assert(sb.buf == NULL);
+    acvp_sbuf_release(&sb);
+
+    memset(arr, 'x', sizeof(arr));
+    cr_assert(acvp_sbuf_bin_to_hexstr(&wrapped, bin, 4, 8) == ACVP_SUCCESS);
+    cr_assert(acvp_sbuf_bin_to_hexstr(&wrapped, bin, 8, 8) == ACVP_CONVERT_DATA_ERR);
+    acvp_sbuf_release(&wrapped);
+    for (i = 0; i < 9; i++) {
+        cr_assert(arr[i] == 0);
+    }
+    cr_assert(arr[9] == 'x');
+}
+
+/*
+ * A scratch buffer from the test case arena comes back from the same memory
+ * once the arena is reset, so test case output costs no allocation
+ */
+Test(SecureBuf, test_case_arena) {
+    unsigned char bin[4] = { 0xde, 0xad, 0xbe, 0xef };
+    ACVP_SBUF sb = { 0 };
+    char *first = NULL;
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_sbuf_init_tc(NULL, &sb, 9) == ACVP_INVALID_ARG);
+    cr_assert(acvp_sbuf_init_tc(ctx, &sb, 0) == ACVP_INVALID_ARG);
+    cr_assert(acvp_sbuf_init_tc(ctx, &sb, 9) == ACVP_SUCCESS);
+    cr_assert(!sb.owned);
+    cr_assert(acvp_sbuf_bin_to_hexstr(&sb, bin, 4, 8) == ACVP_SUCCESS);
+    cr_assert(!strcmp(sb.buf, "DEADBEEF"));
+    first = sb.buf;
+    acvp_sbuf_release(&sb);
+    /* Left for the arena, wiped */
+    cr_assert(sb.buf == first && first[0] == 0);
+
+    acvp_arena_reset(&ctx->exec.tc_arena);
+    memzero_s(&sb, sizeof(ACVP_SBUF));
+    cr_assert(acvp_sbuf_init_tc(ctx, &sb, 9) == ACVP_SUCCESS);
+    cr_assert(sb.buf == first);
+    acvp_sbuf_release(&sb);
+    acvp_free_test_session(ctx);
+    ctx = NULL;
+}
+
+/*
+ * Hex encode/decode across the block sizes used by the vectorized path
+ */
+Test(HexCodec, round_trip) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned char bin[100], out[100];
+    char hex[201];
+    const char *digits = "0123456789ABCDEF";
+    int i = 0, j = 0, len = 0;
+
+    for (i = 0; i < 100; i++) {
+        bin[i] = (unsigned char)(i * 37 + 11);
+    }
+
+    for (i = 0; i <= 100; i++) {
+        rv = acvp_bin_to_hexstr(bin, i, hex, sizeof(hex));
+        cr_assert(rv == ACVP_SUCCESS);
+        cr_assert(strnlen_s(hex, sizeof(hex)) == (size_t)(2 * i));
+        for (j = 0; j < i; j++) {
+            cr_assert(hex[2 * j] == digits[bin[j] >> 4]);
+            cr_assert(hex[2 * j + 1] == digits[bin[j] & 0x0f]);
+        }
+
+        memzero_s(out, sizeof(out));
+        rv = acvp_hexstr_to_bin(hex, out, sizeof(out), &len);
+        cr_assert(rv == ACVP_SUCCESS);
+        cr_assert(len == i);
+        cr_assert(memcmp(out, bin, i) == 0);
+    }
+
+    rv = acvp_bin_to_hexstr(bin, 100, hex, 199);
+    cr_assert(rv == ACVP_CONVERT_DATA_ERR);
+}
+
+/*
+ * Lower case digits are accepted and anything else decodes as 0
+ */
+Test(HexCodec, decode_chars) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned char out[32];
+    const unsigned char expected[20] = { 0xab, 0xcd, 0xef, 0xAB, 0xCD, 0xEF, 0x01, 0x23, 0x45, 0x67,
+                                         0x89, 0x00, 0x0a, 0xa0, 0x00, 0x00, 0xfa, 0xaf, 0x09, 0x90 };
+    int len = 0;
+
+    rv = acvp_hexstr_to_bin("abcdefABCDEF0123456789zz0aa0:/@Gfaaf0990", out, sizeof(out), &len);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(len == 20);
+    cr_assert(memcmp(out, expected, 20) == 0);
+
+    rv = acvp_hexstr_to_bin("abc", out, sizeof(out), &len);
+    cr_assert(rv == ACVP_UNSUPPORTED_OP);
+
+    rv = acvp_hexstr_to_bin("abcdef", out, 2, &len);
+    cr_assert(rv == ACVP_DATA_TOO_LARGE);
+}
+
+/*
+ * Known length decode: stops at src_len without a terminator and
+ * keeps an odd trailing digit as the high nibble
+ */
+Test(HexCodec, decode_known_len) {
+    ACVP_RESULT rv = ACVP_SUCCESS;
+    unsigned char out[40];
+    char hex[80];
+    int len = 0, i = 0;
+
+    rv = acvp_hexstr_to_bin_n("a1b2c3d4", 4, out, sizeof(out), &len);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(len == 2);
+    cr_assert(out[0] == 0xa1 && out[1] == 0xb2);
+
+    rv = acvp_hexstr_to_bin_n("abc", 3, out, sizeof(out), &len);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(len == 2);
+    cr_assert(out[0] == 0xab && out[1] == 0xc0);
+
+    for (i = 0; i < 73; i++) {
+        hex[i] = "0123456789abcdef"[(i * 7 + 3) & 0x0f];
+    }
+    rv = acvp_hexstr_to_bin_n(hex, 73, out, 37, &len);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(len == 37);
+    for (i = 0; i < 36; i++) {
+        cr_assert(out[i] == (unsigned char)((((i * 14 + 3) & 0x0f) << 4) | ((i * 14 + 10) & 0x0f)));
+    }
+    cr_assert(out[36] == (unsigned char)(((72 * 7 + 3) & 0x0f) << 4));
+
+    rv = acvp_hexstr_to_bin_n("", 0, out, sizeof(out), &len);
+    cr_assert(rv == ACVP_SUCCESS);
+    cr_assert(len == 0);
+
+    rv = acvp_hexstr_to_bin_n(hex, 73, out, 36, &len);
+    cr_assert(rv == ACVP_DATA_TOO_LARGE);
+
+    rv = acvp_hexstr_to_bin_n(hex, -1, out, sizeof(out), &len);
+    cr_assert(rv == ACVP_INVALID_ARG);
+
+    rv = acvp_hexstr_to_bin_n(NULL, 2, out, sizeof(out), &len);
+    cr_assert(rv == ACVP_INVALID_ARG);
+}
+
+/*
+ * Arena memory comes back zeroed and aligned, is reused after a reset,
+ * and settles into a single chunk once it has needed more than one
+ */
+Test(Arena, reuse) {
+    ACVP_ARENA arena;
+    unsigned char *a = NULL, *b = NULL, *c = NULL;
+    int i = 0;
+
+    memzero_s(&arena, sizeof(ACVP_ARENA));
+
+    a = acvp_arena_calloc(&arena, 10);
+    b = acvp_arena_calloc(&arena, 100);
+    cr_assert(a != NULL && b != NULL);
+    cr_assert(((size_t)a % ACVP_ARENA_ALIGN) == 0);
+    cr_assert(((size_t)b % ACVP_ARENA_ALIGN) == 0);
+    cr_assert(b >= a + 10);
+    for (i = 0; i < 100; i++) {
+        cr_assert(b[i] == 0);
+    }
+    memset(a, 0xaa, 10);
+    memset(b, 0xbb, 100);
+
+    acvp_arena_reset(&arena);
+    c = acvp_arena_calloc(&arena, 10);
+    cr_assert(c == a);
+    for (i = 0; i < 10; i++) {
+        cr_assert(c[i] == 0);
+    }
+
+    /* Overflow the first chunk */
+    b = acvp_arena_calloc(&arena, ACVP_ARENA_CHUNK_MIN);
+    cr_assert(b != NULL);
+    cr_assert(arena.head->next != NULL);
+    memset(b, 0xcc, ACVP_ARENA_CHUNK_MIN);
+
+    acvp_arena_reset(&arena);
+    cr_assert(arena.head == NULL);
+    a = acvp_arena_calloc(&arena, 10);
+    b = acvp_arena_calloc(&arena, ACVP_ARENA_CHUNK_MIN);
+    cr_assert(a != NULL && b != NULL);
+    cr_assert(arena.head->next == NULL);
+    for (i = 0; i < ACVP_ARENA_CHUNK_MIN; i++) {
+        if (b[i]) break;
+    }
+    cr_assert(i == ACVP_ARENA_CHUNK_MIN);
+
+    cr_assert(acvp_arena_calloc(&arena, 0) == NULL);
+    cr_assert(acvp_arena_calloc(NULL, 10) == NULL);
+
+    acvp_arena_free(&arena);
+    cr_assert(arena.head == NULL);
+}
+
+/*
+ * JSON values made while an arena is in use come from it and are released
+ * by its reset, those made while it is paused and before it was begun come
+ * from the heap and outlive it
+ */
+Test(JsonArena, scope) {
+    ACVP_ARENA arena;
+    JSON_Value *heap_val = NULL, *val = NULL, *kept = NULL;
+    unsigned char *start = NULL;
+    char *str = NULL;
+
+    memzero_s(&arena, sizeof(ACVP_ARENA));
+    heap_val = json_parse_string("{\"before\":1}");
+    cr_assert(heap_val != NULL);
+
+    acvp_json_arena_begin(&arena);
+    val = json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    cr_assert(arena.head != NULL);
+    start = (unsigned char *)arena.head;
+    cr_assert((unsigned char *)val > start);
+
+    acvp_json_arena_pause(1);
+    kept = json_value_deep_copy(json_array_get_value(json_value_get_array(val), 1));
+    acvp_json_arena_pause(0);
+    cr_assert(kept != NULL);
+
+    /* Frees of arena values are left for the reset */
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(str != NULL);
+    json_free_serialized_string(str);
+    acvp_json_value_free(val);
+    json_value_free(heap_val);
+    acvp_json_arena_end();
+
+    /* Back on the heap */
+    cr_assert(json_object_get_number(json_value_get_object(kept), "vsId") > 0);
+    acvp_json_value_free(kept);
+    acvp_arena_free(&arena);
+}
+
+/*
+ * Streaming a DOM to a file produces the same text as serializing it
+ * to a string.
+ */
+Test(JsonStream, matches_string) {
+    JSON_Value *val = NULL;
+    JSON_Object *obj = NULL;
+    FILE *fp = NULL;
+    char *str = NULL, *streamed = NULL;
+    char long_str[1024];
+    int len = 0;
+    long pos = 0;
+
+    val = json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    obj = json_array_get_object(json_value_get_array(val), 1);
+    cr_assert(obj != NULL);
+    /* Escapes, and a string too long for the stack buffer */
+    json_object_set_string(obj, "escaped", "a/b\"c\\d\n\x01");
+    memset(long_str, 'A', sizeof(long_str) - 1);
+    long_str[sizeof(long_str) - 1] = '\0';
+    json_object_set_string(obj, "long", long_str);
+    json_object_set_number(obj, "num", 0.1);
+    json_object_set_boolean(obj, "flag", 1);
+    json_object_set_null(obj, "none");
+
+    str = json_serialize_to_string(val, &len);
+    cr_assert(str != NULL);
+
+    fp = tmpfile();
+    cr_assert(fp != NULL);
+    cr_assert(json_serialize_to_fp(val, fp) == JSONSuccess);
+    pos = ftell(fp);
+    cr_assert(pos == len);
+    rewind(fp);
+    streamed = calloc(len + 1, 1);
+    cr_assert(fread(streamed, 1, len, fp) == (size_t)len);
+    cr_assert(memcmp(streamed, str, len) == 0);
+
+    cr_assert(json_serialize_to_fp(NULL, fp) == JSONFailure);
+    cr_assert(json_serialize_to_fp(val, NULL) == JSONFailure);
+
+    fclose(fp);
+    free(streamed);
+    json_free_serialized_string(str);
+
+    /* Same again for the pretty form */
+    str = json_serialize_to_string_pretty(val, NULL);
+    cr_assert(str != NULL);
+    len = (int)strlen(str);
+
+    fp = tmpfile();
+    cr_assert(fp != NULL);
+    cr_assert(json_serialize_to_fp_pretty(val, fp) == JSONSuccess);
+    pos = ftell(fp);
+    cr_assert(pos == len);
+    rewind(fp);
+    streamed = calloc(len + 1, 1);
+    cr_assert(fread(streamed, 1, len, fp) == (size_t)len);
+    cr_assert(memcmp(streamed, str, len) == 0);
+
+    fclose(fp);
+    free(streamed);
+    json_free_serialized_string(str);
+    json_value_free(val);
+}
+
+/*
+ * Serializing to a string in one pass produces the same text as sizing a
+ * buffer first and serializing into it, for the compact and pretty forms.
+ */
+Test(JsonStream, string_matches_buffer) {
+    JSON_Value *val = NULL;
+    char *str = NULL, *buf = NULL;
+    size_t size = 0;
+    int len = 0;
+
+    val = json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    json_object_set_string(json_array_get_object(json_value_get_array(val), 1),
+                           "escaped", "a/b\"c\\d\n\x01");
+
+    str = json_serialize_to_string(val, &len);
+    cr_assert(str != NULL);
+    size = json_serialization_size(val);
+    cr_assert(size == (size_t)len + 1);
+    buf = calloc(size, 1);
+    cr_assert(json_serialize_to_buffer(val, buf, size) == JSONSuccess);
+    cr_assert(strcmp(buf, str) == 0);
+    free(buf);
+    json_free_serialized_string(str);
+
+    str = json_serialize_to_string_pretty(val, &len);
+    cr_assert(str != NULL);
+    size = json_serialization_size_pretty(val);
+    cr_assert(size == (size_t)len + 1);
+    buf = calloc(size, 1);
+    cr_assert(json_serialize_to_buffer_pretty(val, buf, size) == JSONSuccess);
+    cr_assert(strcmp(buf, str) == 0);
+    free(buf);
+    json_free_serialized_string(str);
+
+    cr_assert(json_serialize_to_string(NULL, NULL) == NULL);
+    json_value_free(val);
+}
+
+/*
+ * Bytes set as hex serialize the same, by every serializer, as the hex
+ * string would, and read back as that string.
+ */
+Test(JsonHex, lazy_encode) {
+    JSON_Value *hex_val = NULL, *str_val = NULL;
+    JSON_Object *hex_obj = NULL, *str_obj = NULL;
+    unsigned char bytes[600];
+    char hex[2 * sizeof(bytes) + 1];
+    char *expected = NULL, *str = NULL, *buf = NULL, *streamed = NULL;
+    FILE *fp = NULL;
+    size_t size = 0;
+    int len = 0, i = 0;
+
+    for (i = 0; i < (int)sizeof(bytes); i++) {
+        bytes[i] = (unsigned char)(i * 7);
+    }
+    hex_val = json_value_init_object();
+    hex_obj = json_value_get_object(hex_val);
+    str_val = json_value_init_object();
+    str_obj = json_value_get_object(str_val);
+
+    /* Short, longer than the stack buffer of a streamed write, and empty */
+    cr_assert(acvp_json_set_hex(hex_obj, "short", bytes, 16, 32) == ACVP_SUCCESS);
+    cr_assert(acvp_json_set_hex(hex_obj, "long", bytes, sizeof(bytes), sizeof(hex)) == ACVP_SUCCESS);
+    cr_assert(acvp_json_set_hex(hex_obj, "empty", bytes, 0, 0) == ACVP_SUCCESS);
+    acvp_bin_to_hexstr(bytes, 16, hex, sizeof(hex));
+    json_object_set_string(str_obj, "short", hex);
+    acvp_bin_to_hexstr(bytes, sizeof(bytes), hex, sizeof(hex));
+    json_object_set_string(str_obj, "long", hex);
+    json_object_set_string(str_obj, "empty", "");
+
+    expected = json_serialize_to_string_pretty(str_val, NULL);
+    cr_assert(expected != NULL);
+    str = json_serialize_to_string_pretty(hex_val, &len);
+    cr_assert(str != NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+
+    size = json_serialization_size_pretty(hex_val);
+    cr_assert(size == (size_t)len + 1);
+    buf = calloc(size, 1);
+    cr_assert(json_serialize_to_buffer_pretty(hex_val, buf, size) == JSONSuccess);
+    cr_assert(strcmp(buf, expected) == 0);
+    free(buf);
+
+    fp = tmpfile();
+    cr_assert(fp != NULL);
+    cr_assert(json_serialize_to_fp_pretty(hex_val, fp) == JSONSuccess);
+    cr_assert(ftell(fp) == len);
+    rewind(fp);
+    streamed = calloc(len + 1, 1);
+    cr_assert(fread(streamed, 1, len, fp) == (size_t)len);
+    cr_assert(strcmp(streamed, expected) == 0);
+    fclose(fp);
+    free(streamed);
+
+    /* Read back, after which it is an ordinary string */
+    cr_assert(json_value_get_string_len(json_object_get_value(hex_obj, "long")) == 2 * sizeof(bytes));
+    cr_assert(strcmp(json_object_get_string(hex_obj, "long"), hex) == 0);
+    cr_assert(strcmp(json_object_get_string(hex_obj, "empty"), "") == 0);
+    str = json_serialize_to_string_pretty(hex_val, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+
+    /* Limits as acvp_bin_to_hexstr() has them */
+    cr_assert(acvp_json_set_hex(hex_obj, "big", bytes, 16, 31) == ACVP_CONVERT_DATA_ERR);
+    cr_assert(acvp_json_set_hex(hex_obj, "none", NULL, 0, 32) == ACVP_CONVERT_DATA_ERR);
+    cr_assert(acvp_json_set_hex(NULL, "none", bytes, 1, 32) == ACVP_CONVERT_DATA_ERR);
+    cr_assert(json_object_get_value(hex_obj, "big") == NULL);
+
+    json_free_serialized_string(expected);
+    json_value_free(hex_val);
+    json_value_free(str_val);
+}
+
+/*
+ * A mapped request file parses the same as one read with json_parse_file,
+ * including a file that ends exactly on a page boundary
+ */
+Test(JsonParseFile, mapped) {
+    JSON_Value *val = NULL;
+    char *expected = NULL, *str = NULL;
+    FILE *fp = NULL;
+    long page = sysconf(_SC_PAGESIZE);
+    long i = 0;
+
+    val = json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    expected = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+
+    val = acvp_json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+    json_value_free(val);
+
+    fp = fopen("page.json", "w");
+    cr_assert(fp != NULL);
+    fputs("[\"page\"", fp);
+    for (i = (long)strlen("[\"page\""); i < page - 1; i++) {
+        fputc(' ', fp);
+    }
+    fputc(']', fp);
+    fclose(fp);
+    val = acvp_json_parse_file("page.json");
+    cr_assert(val != NULL);
+    cr_assert(strcmp(json_array_get_string(json_value_get_array(val), 0), "page") == 0);
+    json_value_free(val);
+    remove("page.json");
+
+    cr_assert(acvp_json_parse_file("no_such_file.json") == NULL);
+    cr_assert(acvp_json_parse_file(NULL) == NULL);
+
+    json_free_serialized_string(expected);
+}
+
+/*
+ * The vector set cache is built on first use, gives back the same DOM as
+ * the request file on later loads, and is rebuilt when it is not valid
+ */
+Test(VsCache, load) {
+    JSON_Value *val = NULL;
+    char *expected = NULL, *str = NULL;
+    FILE *fp = NULL;
+
+    setup_empty_ctx(&ctx);
+    val = json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    expected = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+
+    remove("vs.cache");
+    /* Built from the request file */
+    val = acvp_vs_cache_load(ctx, "json/aes/aes.json", "vs.cache");
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+    json_value_free(val);
+
+    /* Loaded from the cache */
+    fp = fopen("vs.cache", "rb");
+    cr_assert(fp != NULL);
+    fclose(fp);
+    val = acvp_vs_cache_load(ctx, "json/aes/aes.json", "vs.cache");
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+    json_value_free(val);
+
+    /* A truncated cache is not used */
+    fp = fopen("vs.cache", "wb");
+    cr_assert(fp != NULL);
+    fputs("ACVPVC01", fp);
+    fclose(fp);
+    val = acvp_vs_cache_load(ctx, "json/aes/aes.json", "vs.cache");
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+    json_value_free(val);
+
+    cr_assert(acvp_vs_cache_load(ctx, "no_such_file.json", "vs.cache") == NULL);
+
+    remove("vs.cache");
+    json_free_serialized_string(expected);
+    acvp_free_test_session(ctx);
+    ctx = NULL;
+}
+
+/*
+ * Removes the download cache file of vsid_url, named as described in
+ * acvp_util.c
+ */
+static void remove_dl_cache(ACVP_CTX *c, const char *vsid_url) {
+    unsigned long long int fp = ACVP_FP_OFFSET;
+    char path[64];
+
+    acvp_fp_bytes(&fp, c->server_name, strlen(c->server_name));
+    acvp_fp_bytes(&fp, &c->server_port, sizeof(c->server_port));
+    acvp_fp_bytes(&fp, c->session_url, strlen(c->session_url) + 1);
+    acvp_fp_bytes(&fp, vsid_url, strlen(vsid_url) + 1);
+    snprintf(path, sizeof(path), "./vs-%016llx.json", fp);
+    cr_assert(remove(path) == 0);
+}
+
+/*
+ * A downloaded vector set is only loaded from the download cache once it has
+ * been kept, and the cache is separate for each test session
+ */
+Test(VsDlCache, save_keep_load) {
+    const char *vs = "[{\"acvVersion\":\"1.0\"},{\"vsId\":1,\"algorithm\":\"ACVP-AES-GCM\"}]";
+    const char *url = "/acvp/v1/testSessions/1/vectorSets/1";
+    int len = (int)strlen(vs);
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_set_vector_set_download_cache(NULL, ".") == ACVP_NO_CTX);
+    cr_assert(acvp_set_vector_set_download_cache(ctx, NULL) == ACVP_MISSING_ARG);
+    cr_assert(acvp_set_vector_set_download_cache(ctx, ".") == ACVP_SUCCESS);
+    cr_assert(acvp_set_server(ctx, "localhost", 443) == ACVP_SUCCESS);
+    ctx->session_url = strdup("/acvp/v1/testSessions/1");
+    cr_assert(ctx->session_url != NULL);
+
+    /* Downloaded, but discarded as a retry would be */
+    ctx->exec.curl_buf = strdup(vs);
+    ctx->exec.curl_buf_size = len + 1;
+    ctx->exec.curl_read_ctr = len;
+    acvp_vs_dl_cache_save(ctx, url);
+    acvp_vs_dl_cache_keep(ctx, url, 0);
+    acvp_transport_release_buf(ctx);
+    cr_assert(acvp_vs_dl_cache_load(ctx, url) == 0);
+
+    /* Downloaded and kept */
+    ctx->exec.curl_buf = strdup(vs);
+    ctx->exec.curl_buf_size = len + 1;
+    ctx->exec.curl_read_ctr = len;
+    acvp_vs_dl_cache_save(ctx, url);
+    acvp_vs_dl_cache_keep(ctx, url, 1);
+    acvp_transport_release_buf(ctx);
+    cr_assert(acvp_vs_dl_cache_load(ctx, url) == 1);
+    cr_assert(ctx->exec.curl_read_ctr == len);
+    cr_assert(strcmp(ctx->exec.curl_buf, vs) == 0);
+    acvp_transport_release_buf(ctx);
+
+    /* Not for another vector set or session */
+    cr_assert(acvp_vs_dl_cache_load(ctx, "/acvp/v1/testSessions/1/vectorSets/2") == 0);
+    free(ctx->session_url);
+    ctx->session_url = strdup("/acvp/v1/testSessions/2");
+    cr_assert(acvp_vs_dl_cache_load(ctx, url) == 0);
+    free(ctx->session_url);
+    ctx->session_url = strdup("/acvp/v1/testSessions/1");
+
+    /* Kept again over the first */
+    ctx->exec.curl_buf = strdup(vs);
+    ctx->exec.curl_buf_size = len + 1;
+    ctx->exec.curl_read_ctr = len;
+    acvp_vs_dl_cache_save(ctx, url);
+    acvp_vs_dl_cache_keep(ctx, url, 1);
+    acvp_transport_release_buf(ctx);
+    cr_assert(acvp_vs_dl_cache_load(ctx, url) == 1);
+    acvp_transport_release_buf(ctx);
+
+    remove_dl_cache(ctx, url);
+    cr_assert(acvp_vs_dl_cache_load(ctx, url) == 0);
+    acvp_free_test_session(ctx);
+    ctx = NULL;
+}
+
+/*
+ * Large buffers are mapped when huge pages are asked for, falling back to
+ * the heap, and small ones always come from the heap
+ */
+Test(BigAlloc, huge_and_heap) {
+    size_t size = 0, i = 0;
+    int mapped = 1;
+    char *buf = NULL;
+
+    size = 100;
+    buf = acvp_big_alloc(&size, 1, &mapped);
+    cr_assert(buf != NULL);
+    cr_assert(!mapped);
+    cr_assert(size == 100);
+    acvp_big_free(buf, size, mapped);
+
+    size = ACVP_HUGE_PAGE_SIZE + 1;
+    buf = acvp_big_alloc(&size, 0, &mapped);
+    cr_assert(buf != NULL);
+    cr_assert(!mapped);
+    cr_assert(size == ACVP_HUGE_PAGE_SIZE + 1);
+    acvp_big_free(buf, size, mapped);
+
+    size = ACVP_HUGE_PAGE_SIZE + 1;
+    buf = acvp_big_alloc(&size, 1, &mapped);
+    cr_assert(buf != NULL);
+    if (mapped) {
+        cr_assert(size == 2 * ACVP_HUGE_PAGE_SIZE);
+    } else {
+        cr_assert(size == ACVP_HUGE_PAGE_SIZE + 1);
+    }
+    for (i = 0; i < size; i += 4096) {
+        buf[i] = 1;
+    }
+    buf[size - 1] = 1;
+    acvp_big_free(buf, size, mapped);
+    acvp_big_free(NULL, 0, 0);
+
+    cr_assert(acvp_set_huge_pages(NULL, 1) == ACVP_NO_CTX);
+}
+
+/*
+ * The elements of a top level array are found without parsing them, past
+ * strings that hold brackets and escaped quotes, and match what the parser
+ * finds in a response file
+ */
+Test(JsonSlice, array) {
+    const char *text = " [ {\"a\":\"]}\\\"{\",\"vsId\":42,\"b\":[1,{\"vsId\":7}]} ,\n\"x\", 12 ,[ ] ]\n";
+    ACVP_JSON_SLICE *slices = NULL;
+    JSON_Value *val = NULL, *elem = NULL;
+    char *str = NULL, *expected = NULL, *buf = NULL;
+    size_t len = 0, map_len = 0;
+    int count = 0, i = 0;
+
+    count = acvp_json_slice_array(text, strlen(text), &slices);
+    cr_assert(count == 4);
+    cr_assert(slices[1].len == 3 && !strncmp(slices[1].p, "\"x\"", 3));
+    cr_assert(slices[2].len == 2 && !strncmp(slices[2].p, "12", 2));
+    cr_assert(slices[3].len == 3 && !strncmp(slices[3].p, "[ ]", 3));
+    /* Only the names of the object itself */
+    cr_assert(acvp_json_slice_get_number(&slices[0], "vsId") == 42);
+    cr_assert(acvp_json_slice_get_number(&slices[0], "tgId") == 0);
+    cr_assert(acvp_json_slice_get_number(&slices[1], "vsId") == 0);
+    free(slices);
+
+    cr_assert(acvp_json_slice_array("[]", 2, &slices) == 0);
+    free(slices);
+    cr_assert(acvp_json_slice_array("{\"a\":1}", 7, &slices) == -1);
+    cr_assert(acvp_json_slice_array("[{\"a\":\"]\"}", 10, &slices) == -1);
+    cr_assert(acvp_json_slice_array("[1 2]", 5, &slices) == -1);
+    cr_assert(slices == NULL);
+
+    buf = acvp_file_load("json/rsp.json", &len, &map_len);
+    cr_assert(buf != NULL);
+    val = json_parse_file("json/rsp.json");
+    cr_assert(val != NULL);
+    count = acvp_json_slice_array(buf, len, &slices);
+    cr_assert(count == (int)json_array_get_count(json_value_get_array(val)));
+    for (i = 0; i < count; i++) {
+        str = calloc(slices[i].len + 1, 1);
+        cr_assert(str != NULL);
+        memcpy(str, slices[i].p, slices[i].len);
+        elem = json_parse_string(str);
+        cr_assert(elem != NULL);
+        free(str);
+        str = json_serialize_to_string(elem, NULL);
+        expected = json_serialize_to_string(json_array_get_value(json_value_get_array(val), i), NULL);
+        cr_assert(strcmp(str, expected) == 0);
+        if (i) {
+            cr_assert(acvp_json_slice_get_number(&slices[i], "vsId") ==
+                      (long)json_object_get_uint(json_value_get_object(elem), "vsId"));
+        }
+        json_free_serialized_string(str);
+        json_free_serialized_string(expected);
+        json_value_free(elem);
+    }
+    free(slices);
+    json_value_free(val);
+    acvp_file_unload(buf, map_len);
+}
+
+/*
+ * The values of an array are read from a pipe one at a time, each as soon
+ * as it ends, and a stream that ends before its array does is an error
+ */
+Test(JsonSlice, stream) {
+    const char *text = " [ {\"a\":\"]}\\\"{\",\"vsId\":42} ,\n\"x\", 12 ,[ ] ]\n";
+    ACVP_JSON_STREAM stream;
+    ACVP_JSON_SLICE slice;
+    JSON_Value *val = NULL, *elem = NULL;
+    FILE *fp = NULL;
+    int fds[2];
+    int count = 0;
+
+    cr_assert(pipe(fds) == 0);
+    /* Only the first value is there yet */
+    cr_assert(write(fds[1], text, 26) == 26);
+    fp = fdopen(fds[0], "r");
+    acvp_json_stream_init(&stream, fp);
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 1);
+    val = acvp_json_stream_parse(&stream, &slice);
+    cr_assert(json_object_get_uint(json_value_get_object(val), "vsId") == 42);
+    json_value_free(val);
+    cr_assert(write(fds[1], text + 26, strlen(text) - 26) == (ssize_t)(strlen(text) - 26));
+    close(fds[1]);
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 1);
+    cr_assert(slice.len == 3 && !strncmp(slice.p, "\"x\"", 3));
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 1);
+    cr_assert(slice.len == 2 && !strncmp(slice.p, "12", 2));
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 1);
+    cr_assert(slice.len == 3 && !strncmp(slice.p, "[ ]", 3));
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 0);
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 0);
+    acvp_json_stream_free(&stream);
+    fclose(fp);
+
+    /* A file larger than a read, each value as the parser finds it */
+    val = json_parse_file("json/rsp.json");
+    cr_assert(val != NULL);
+    fp = fopen("json/rsp.json", "rb");
+    cr_assert(fp != NULL);
+    acvp_json_stream_init(&stream, fp);
+    while (acvp_json_stream_next(&stream, &slice) == 1) {
+        elem = acvp_json_stream_parse(&stream, &slice);
+        cr_assert(json_value_equals(elem, json_array_get_value(json_value_get_array(val), count)));
+        json_value_free(elem);
+        count++;
+    }
+    cr_assert(count == (int)json_array_get_count(json_value_get_array(val)));
+    acvp_json_stream_free(&stream);
+    fclose(fp);
+    json_value_free(val);
+
+    fp = tmpfile();
+    fputs("[{\"a\":1}, {\"b\"", fp);
+    rewind(fp);
+    acvp_json_stream_init(&stream, fp);
+    cr_assert(acvp_json_stream_next(&stream, &slice) == 1);
+    cr_assert(acvp_json_stream_next(&stream, &slice) == -1);
+    acvp_json_stream_free(&stream);
+    fclose(fp);
+}
+
+/*
+ * Strings and whitespace are scanned a block at a time; escapes, control
+ * characters and the ends of strings at every offset into a block are still
+ * found, copying and in situ
+ */
+Test(JsonString, scan) {
+    char *text = NULL, *copy = NULL, *p = NULL;
+    const char *str = NULL;
+    JSON_Value *val = NULL;
+    size_t len = 0, pos = 0, ws = 0;
+
+    text = malloc(256);
+    copy = malloc(256);
+    cr_assert(text && copy);
+    for (len = 0; len < 70; len++) {
+        for (pos = 0; pos <= len; pos++) {
+            for (ws = 0; ws < 40; ws += 13) {
+                /* ws spaces, then len + 2 bytes with an escaped quote at pos */
+                p = text;
+                memset(p, ' ', ws);
+                p += ws;
+                *p++ = '"';
+                memset(p, 'A', len + 2);
+                p[pos] = '\\';
+                p[pos + 1] = '"';
+                p += len + 2;
+                *p++ = '"';
+                memset(p, '\n', ws);
+                p += ws;
+                *p = '\0';
+
+                val = json_parse_string(text);
+                cr_assert(val != NULL);
+                str = json_value_get_string(val);
+                cr_assert(json_value_get_string_len(val) == len + 1);
+                cr_assert(str[pos] == '"' && (pos == 0 || str[pos - 1] == 'A'));
+                json_value_free(val);
+
+                memcpy(copy, text, (size_t)(p - text) + 1);
+                val = json_parse_string_in_situ(copy);
+                cr_assert(val != NULL);
+                cr_assert(json_value_get_string_len(val) == len + 1);
+                cr_assert(json_value_get_string(val)[pos] == '"');
+                json_value_free(val);
+
+                /* A control character is refused wherever it is */
+                text[ws + 1 + pos] = '\t';
+                text[ws + 2 + pos] = 'A';
+                cr_assert(json_parse_string(text) == NULL);
+                /* As is a string that does not end */
+                text[ws + 1 + len + 2] = '\0';
+                cr_assert(json_parse_string(text) == NULL);
+            }
+        }
+    }
+    free(text);
+    free(copy);
+
+    val = json_parse_string(" \t\r\n\v\f [ \v1 ,\f\"a\" \r\n ] \n\n      \t");
+    cr_assert(val != NULL);
+    cr_assert(json_array_get_count(json_value_get_array(val)) == 2);
+    json_value_free(val);
+}
+
+/*
+ * Integers are parsed and serialized without strtod() and sprintf(), the same
+ * as they would be with them, and the numbers that are not integers still
+ * go through them
+ */
+Test(JsonNumber, integers) {
+    static const char *numbers[] = {
+        "0", "-0", "7", "-42", "999999999999999", "-999999999999999", "1000000000000000",
+        "12345678901234567890", "4294967295", "4294967296", "1.5", "-2.25e3", "1E2", "0.0"
+    };
+    static const char *invalid[] = { "01", "-01", "0x1F", "-", "--1" };
+    JSON_Value *val = NULL;
+    JSON_Array *arr = NULL;
+    char buf[64], *str = NULL;
+    double num = 0, expect = 0;
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++) {
+        snprintf(buf, sizeof(buf), "[%s]", numbers[i]);
+        val = json_parse_string(buf);
+        cr_assert(val != NULL, "%s", numbers[i]);
+        /* The very same double, sign of zero included */
+        num = json_array_get_number(json_value_get_array(val), 0);
+        expect = strtod(numbers[i], NULL);
+        cr_assert(!memcmp(&num, &expect, sizeof(num)), "%s", numbers[i]);
+        json_value_free(val);
+    }
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        snprintf(buf, sizeof(buf), "[%s]", invalid[i]);
+        cr_assert(json_parse_string(buf) == NULL, "%s", invalid[i]);
+    }
+
+    val = json_parse_string("[1, 4294967295, 0, -3, 4294967296, 2.5, \"5\", 1e3]");
+    cr_assert(val != NULL);
+    arr = json_value_get_array(val);
+    cr_assert(json_array_get_uint(arr, 0) == 1);
+    cr_assert(json_array_get_uint(arr, 1) == 4294967295U);
+    cr_assert(json_array_get_uint(arr, 2) == 0);
+    cr_assert(json_array_get_uint(arr, 3) == 0);
+    cr_assert(json_array_get_uint(arr, 4) == 0);
+    cr_assert(json_array_get_uint(arr, 5) == 0);
+    cr_assert(json_array_get_uint(arr, 6) == 0);
+    cr_assert(json_array_get_uint(arr, 7) == 1000);
+    cr_assert(json_array_get_uint(arr, 8) == 0);
+    cr_assert(json_object_get_uint(NULL, "tcId") == 0);
+    json_value_free(val);
+
+    val = json_parse_string("[0, -0, 12, -345, 999999999999999, 1000000000000000, 0.5, -1e-7]");
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(str != NULL);
+    cr_assert(!strcmp(str, "[0,-0,12,-345,999999999999999,1000000000000000,0.5,-9.9999999999999995e-08]"));
+    json_free_serialized_string(str);
+    json_value_free(val);
+}
+
+/*
+ * Objects large enough to be indexed find, replace and remove names the same
+ * as small ones, including when they shrink back below the index threshold
+ */
+Test(JsonObject, indexed) {
+    JSON_Value *val = NULL, *parsed = NULL;
+    JSON_Object *obj = NULL;
+    char name[16], *str = NULL;
+    int i = 0;
+
+    val = json_value_init_object();
+    obj = json_value_get_object(val);
+    for (i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "key%d", i);
+        cr_assert(json_object_set_number(obj, name, i) == JSONSuccess);
+    }
+    cr_assert(json_object_get_count(obj) == 200);
+    for (i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "key%d", i);
+        cr_assert(json_object_get_uint(obj, name) == (unsigned int)i);
+    }
+    cr_assert(json_object_get_value(obj, "key200") == NULL);
+    cr_assert(json_object_get_value(obj, "key") == NULL);
+
+    /* Replacing keeps the count, duplicates are rejected when parsing */
+    cr_assert(json_object_set_number(obj, "key7", 700) == JSONSuccess);
+    cr_assert(json_object_get_count(obj) == 200);
+    cr_assert(json_object_get_uint(obj, "key7") == 700);
+
+    str = json_serialize_to_string(val, NULL);
+    parsed = json_parse_string(str);
+    cr_assert(parsed != NULL);
+    cr_assert(json_object_get_uint(json_value_get_object(parsed), "key199") == 199);
+    json_value_free(parsed);
+    json_free_serialized_string(str);
+    cr_assert(json_parse_string("{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"f\":6,\"g\":7,\"h\":8,"
+                                "\"i\":9,\"j\":10,\"k\":11,\"l\":12,\"m\":13,\"n\":14,\"o\":15,"
+                                "\"p\":16,\"q\":17,\"a\":18}") == NULL);
+
+    for (i = 0; i < 195; i++) {
+        snprintf(name, sizeof(name), "key%d", i);
+        cr_assert(json_object_remove(obj, name) == JSONSuccess);
+        cr_assert(json_object_get_value(obj, name) == NULL);
+    }
+    cr_assert(json_object_get_count(obj) == 5);
+    for (i = 195; i < 200; i++) {
+        snprintf(name, sizeof(name), "key%d", i);
+        cr_assert(json_object_get_uint(obj, name) == (unsigned int)i);
+    }
+
+    cr_assert(json_object_clear(obj) == JSONSuccess);
+    cr_assert(json_object_get_value(obj, "key199") == NULL);
+    cr_assert(json_object_set_number(obj, "key199", 1) == JSONSuccess);
+    cr_assert(json_object_get_count(obj) == 1);
+    json_value_free(val);
+}
+
+/*
+ * Reserving keeps the values, never shrinks and makes room for appends
+ */
+Test(JsonArray, reserve) {
+    JSON_Value *val = NULL, *lazy = NULL;
+    JSON_Array *arr = NULL;
+    char text[] = "{\"testGroups\": [{\"tgId\": 1}]}";
+    int i = 0;
+
+    cr_assert(json_array_reserve(NULL, 4) == JSONFailure);
+    val = json_value_init_array();
+    arr = json_value_get_array(val);
+    cr_assert(json_array_append_number(arr, 1) == JSONSuccess);
+    cr_assert(json_array_reserve(arr, 100) == JSONSuccess);
+    cr_assert(json_array_reserve(arr, 2) == JSONSuccess);
+    for (i = 2; i <= 100; i++) {
+        cr_assert(json_array_append_number(arr, i) == JSONSuccess);
+    }
+    cr_assert(json_array_get_count(arr) == 100);
+    for (i = 0; i < 100; i++) {
+        cr_assert(json_array_get_uint(arr, i) == (unsigned int)i + 1);
+    }
+    json_value_free(val);
+
+    lazy = json_parse_string_lazy(text);
+    cr_assert(lazy != NULL);
+    arr = json_object_get_array(json_value_get_object(lazy), "testGroups");
+    cr_assert(json_array_reserve(arr, 4) == JSONFailure);
+    json_value_free(lazy);
+}
+
+/*
+ * Field names libacvp writes are shared between objects rather than copied,
+ * including by the parser, and other names still get their own copy
+ */
+Test(JsonObject, interned_names) {
+    JSON_Value *a = NULL, *b = NULL;
+    JSON_Object *obj_a = NULL, *obj_b = NULL;
+
+    a = json_value_init_object();
+    obj_a = json_value_get_object(a);
+    cr_assert(json_object_set_number(obj_a, "tcId", 1) == JSONSuccess);
+    cr_assert(json_object_set_string(obj_a, "KAS1", "x") == JSONSuccess);
+    cr_assert(json_object_set_string(obj_a, "zzLen", "x") == JSONSuccess);
+    cr_assert(json_object_set_string(obj_a, "tcIdx", "x") == JSONSuccess);
+
+    b = json_parse_string("{\"tcId\": 2, \"KAS1\": 0, \"zzLen\": 0, \"tcIdx\": 0}");
+    cr_assert(b != NULL);
+    obj_b = json_value_get_object(b);
+    cr_assert(json_object_get_name(obj_a, 0) == json_object_get_name(obj_b, 0));
+    cr_assert(json_object_get_name(obj_a, 1) == json_object_get_name(obj_b, 1));
+    cr_assert(json_object_get_name(obj_a, 2) == json_object_get_name(obj_b, 2));
+    cr_assert(json_object_get_name(obj_a, 3) != json_object_get_name(obj_b, 3));
+    cr_assert(json_object_get_uint(obj_b, "tcId") == 2);
+
+    cr_assert(json_object_remove(obj_a, "tcId") == JSONSuccess);
+    cr_assert(json_object_clear(obj_b) == JSONSuccess);
+    json_value_free(a);
+    json_value_free(b);
+}
+
+/*
+ * A vector set parsed in situ gives the same DOM as a copying parse, with
+ * escapes undone in place and string values pointing into the buffer
+ */
+Test(JsonParseInSitu, matches_copy) {
+    JSON_Value *val = NULL, *copy = NULL;
+    char *buf = NULL, *expected = NULL, *str = NULL;
+    const char *s = NULL;
+    char esc[] = "{\"k\\u0065y\":\"a\\\"b\\\\c\\/d\\u00e9\\ud83d\\ude00\", \"n\":[1,\"x\"]}";
+
+    val = json_parse_file("json/aes/aes.json");
+    cr_assert(val != NULL);
+    expected = json_serialize_to_string(val, NULL);
+    buf = json_serialize_to_string_pretty(val, NULL);
+    json_value_free(val);
+
+    val = json_parse_string_in_situ(buf);
+    cr_assert(val != NULL);
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+
+    /* Copies do not depend on the buffer */
+    copy = json_value_deep_copy(val);
+    json_value_free(val);
+    memset(buf, 'x', strlen(expected) / 2);
+    str = json_serialize_to_string(copy, NULL);
+    cr_assert(strcmp(str, expected) == 0);
+    json_free_serialized_string(str);
+    json_value_free(copy);
+    json_free_serialized_string(buf);
+
+    val = json_parse_string_in_situ(esc);
+    cr_assert(val != NULL);
+    s = json_object_get_string(json_value_get_object(val), "key");
+    cr_assert(s != NULL);
+    cr_assert(strcmp(s, "a\"b\\c/d\xc3\xa9\xf0\x9f\x98\x80") == 0);
+    cr_assert(s > esc && s < esc + sizeof(esc));
+    cr_assert(strcmp(json_array_get_string(json_object_get_array(json_value_get_object(val), "n"), 1), "x") == 0);
+    json_value_free(val);
+
+    cr_assert(json_parse_string_in_situ(NULL) == NULL);
+    json_free_serialized_string(expected);
+}
+
+/*
+ * A lazily parsed vector set gives the same test groups as a copying parse,
+ * each parsed from its own copy as it is asked for, and the test groups
+ * array can not be changed
+ */
+Test(JsonParseLazy, test_groups) {
+    JSON_Value *val = NULL, *copy = NULL;
+    JSON_Array *groups = NULL, *expected = NULL;
+    char *buf = NULL, *expected_str = NULL, *str = NULL;
+    const char *s = NULL;
+    char empty[] = "{\"vsId\":1,\"testGroups\": [ ]}";
+    char bad_group[] = "{\"testGroups\":[{\"tgId\":1},{\"tgId\":}]}";
+    char cut[] = "{\"testGroups\":[{\"tgId\":1},{\"tgId\":\"2}]}";
+    size_t i = 0;
+
+    copy = json_parse_file("json/aes/aes.json");
+    cr_assert(copy != NULL);
+    expected_str = json_serialize_to_string(copy, NULL);
+    expected = json_object_get_array(json_array_get_object(json_value_get_array(copy), 1), "testGroups");
+    cr_assert(json_array_get_count(expected) > 1);
+    buf = json_serialize_to_string_pretty(copy, NULL);
+
+    val = json_parse_string_lazy(buf);
+    cr_assert(val != NULL);
+    groups = json_object_get_array(json_array_get_object(json_value_get_array(val), 1), "testGroups");
+    cr_assert(json_array_get_count(groups) == json_array_get_count(expected));
+    for (i = 0; i < json_array_get_count(groups); i++) {
+        cr_assert(json_value_equals(json_array_get_value(groups, i), json_array_get_value(expected, i)));
+        s = json_object_get_string(json_array_get_object(groups, i), "testType");
+        cr_assert(s != NULL);
+        cr_assert(s < buf || s > buf + strlen(buf));
+    }
+    /* Back to the first, parsed again */
+    cr_assert(json_value_equals(json_array_get_value(groups, 0), json_array_get_value(expected, 0)));
+    cr_assert(json_array_append_number(groups, 1) == JSONFailure);
+    cr_assert(json_array_clear(groups) == JSONFailure);
+    cr_assert(json_array_get_count(groups) == json_array_get_count(expected));
+
+    str = json_serialize_to_string(val, NULL);
+    cr_assert(strcmp(str, expected_str) == 0);
+    json_free_serialized_string(str);
+    json_value_free(val);
+    json_free_serialized_string(buf);
+    json_free_serialized_string(expected_str);
+    json_value_free(copy);
+
+    val = json_parse_string_lazy(empty);
+    cr_assert(val != NULL);
+    cr_assert(json_array_get_count(json_object_get_array(json_value_get_object(val), "testGroups")) == 0);
+    json_value_free(val);
+
+    /* A group that is not valid JSON only fails once it is asked for */
+    val = json_parse_string_lazy(bad_group);
+    cr_assert(val != NULL);
+    groups = json_object_get_array(json_value_get_object(val), "testGroups");
+    cr_assert(json_array_get_count(groups) == 2);
+    cr_assert(json_array_get_value(groups, 0) != NULL);
+    cr_assert(json_array_get_value(groups, 1) == NULL);
+    json_value_free(val);
+
+    cr_assert(json_parse_string_lazy(cut) == NULL);
+    cr_assert(json_parse_string_lazy(NULL) == NULL);
+}
+
+/*
+ * String lengths come from the parsed value and match the string itself,
+ * including after escapes were decoded
+ */
+Test(JsonGetStringN, lengths) {
+    char buf[] = "{\"pt\":\"00112233\",\"esc\":\"a\\u00e9\",\"n\":1}";
+    JSON_Value *val = NULL;
+    JSON_Object *obj = NULL;
+    const char *s = NULL;
+    int len = -1;
+
+    val = json_parse_string_in_situ(buf);
+    cr_assert(val != NULL);
+    obj = json_value_get_object(val);
+
+    s = acvp_json_get_string_n(obj, "pt", &len);
+    cr_assert(s != NULL);
+    cr_assert(len == 8);
+    cr_assert(len == (int)strlen(s));
+
+    s = acvp_json_get_string_n(obj, "esc", &len);
+    cr_assert(s != NULL);
+    cr_assert(len == 3);
+    cr_assert(len == (int)strlen(s));
+
+    s = acvp_json_get_string_n(obj, "n", &len);
+    cr_assert(s == NULL);
+    cr_assert(len == 0);
+
+    len = -1;
+    s = acvp_json_get_string_n(obj, "missing", &len);
+    cr_assert(s == NULL);
+    cr_assert(len == 0);
+
+    json_value_free(val);
+}
+
+/*
+ * Test that the expiry is read from the payload of a JWT
+ */
+Test(JwtExpiry, payload) {
+    cr_assert(acvp_jwt_expiry("eyJhbGciOiJIUzI1NiJ9.eyJzdWIiOiJ4IiwiZXhwIjo0MTAyNDQ0ODAwfQ.c2ln") == 4102444800);
+    /* Long gone, no exp, not a JWT */
+    cr_assert(acvp_jwt_expiry("eyJhbGciOiJIUzI1NiJ9.eyJleHAiOjk0NjY4NDgwMH0.c2ln") == 0);
+    cr_assert(acvp_jwt_expiry("eyJhbGciOiJIUzI1NiJ9.eyJzdWIiOiJ4In0.c2ln") == 0);
+    cr_assert(acvp_jwt_expiry("eyJhbGciOiJIUzI1NiJ9") == 0);
+    cr_assert(acvp_jwt_expiry("a.b!c.d") == 0);
+    cr_assert(acvp_jwt_expiry(NULL) == 0);
+}
+
+static int idle_calls = 0;
+static unsigned int idle_first_budget = 0;
+
+/* Has three pieces of work, then nothing more to do */
+static int idle_cb(unsigned int budget_ms, void *arg) {
+    if (!idle_calls) idle_first_budget = budget_ms;
+    idle_calls++;
+    return idle_calls < *(int *)arg;
+}
+
+/*
+ * Test that a wait on the server is handed to the idle callback until it
+ * has nothing more to do, and is still waited out in full
+ */
+Test(Idle, callback) {
+    unsigned long long int start = 0;
+    int pieces = 3;
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_set_idle_cb(NULL, &idle_cb, &pieces) == ACVP_NO_CTX);
+    cr_assert(acvp_set_idle_cb(ctx, &idle_cb, &pieces) == ACVP_SUCCESS);
+
+    start = acvp_metrics_now();
+    acvp_idle(ctx, 1);
+    cr_assert(acvp_metrics_now() - start >= 990000000ULL);
+    cr_assert(idle_calls == 3);
+    cr_assert(idle_first_budget > 900 && idle_first_budget <= 1000);
+
+    /* No time, no callback */
+    acvp_idle(ctx, 0);
+    cr_assert(idle_calls == 3);
+    teardown_ctx(&ctx);
+}
+
+static char om_text[8192];
+static size_t om_len;
+
+static int om_writer(const char *buf, size_t len, void *arg) {
+    int *fail = arg;
+
+    if (*fail || om_len + len >= sizeof(om_text)) {
+        return 1;
+    }
+    memcpy(om_text + om_len, buf, len);
+    om_len += len;
+    om_text[om_len] = '\0';
+    return 0;
+}
+
+/*
+ * Test the counters the OpenMetrics exporter keeps and its text output
+ */
+Test(OpenMetrics, write) {
+    ACVP_OPENMETRICS *om = NULL;
+    int fail = 0;
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_openmetrics_create(NULL) == ACVP_INVALID_ARG);
+    cr_assert(acvp_openmetrics_create(&om) == ACVP_SUCCESS);
+    cr_assert(acvp_set_openmetrics(NULL, om) == ACVP_NO_CTX);
+    cr_assert(acvp_set_openmetrics(ctx, om) == ACVP_SUCCESS);
+
+    ctx->exec.cipher = ACVP_AES_GCM;
+    /* One test case of 2ms, then a batch of four taking 20us each */
+    acvp_om_crypto(ctx, 2000000ULL, 1);
+    acvp_om_crypto(ctx, 80000ULL, 4);
+    acvp_om_vs_done(ctx, ACVP_SUCCESS);
+    acvp_om_vs_done(ctx, ACVP_TRANSPORT_FAIL);
+    acvp_om_retry_wait(ctx, 30);
+    acvp_om_transfer(ctx, ACVP_OM_GET, 200, 1000, 0, 200000000ULL);
+    acvp_om_transfer(ctx, ACVP_OM_POST, 0, 0, 512, 40000000ULL);
+    acvp_om_jwt_refresh(ctx, ACVP_SUCCESS);
+
+    cr_assert(acvp_openmetrics_write(om, NULL, NULL) == ACVP_INVALID_ARG);
+    cr_assert(acvp_openmetrics_write(om, &om_writer, &fail) == ACVP_SUCCESS);
+    cr_assert(strstr(om_text, "acvp_vector_sets_total{result=\"success\"} 1\n"));
+    cr_assert(strstr(om_text, "acvp_vector_sets_total{result=\"failure\"} 1\n"));
+    cr_assert(strstr(om_text, "acvp_test_cases_total{algorithm=\"ACVP-AES-GCM\"} 5\n"));
+    cr_assert(strstr(om_text, "acvp_test_case_seconds_total{algorithm=\"ACVP-AES-GCM\"} 0.002080000\n"));
+    cr_assert(strstr(om_text, "acvp_crypto_handler_seconds_bucket{le=\"0.0001\"} 4\n"));
+    cr_assert(strstr(om_text, "acvp_crypto_handler_seconds_bucket{le=\"0.01\"} 5\n"));
+    cr_assert(strstr(om_text, "acvp_crypto_handler_seconds_count 5\n"));
+    cr_assert(strstr(om_text, "acvp_retry_wait_seconds_total 30\n"));
+    cr_assert(strstr(om_text, "acvp_http_errors_total{method=\"POST\"} 1\n"));
+    cr_assert(strstr(om_text, "acvp_http_received_bytes_total{method=\"GET\"} 1000\n"));
+    cr_assert(strstr(om_text, "acvp_http_request_seconds_bucket{le=\"0.05\"} 1\n"));
+    cr_assert(strstr(om_text, "acvp_http_request_seconds_bucket{le=\"+Inf\"} 2\n"));
+    cr_assert(strstr(om_text, "acvp_jwt_refreshes_total{result=\"success\"} 1\n"));
+    cr_assert(om_len > 6 && !strcmp(om_text + om_len - 6, "# EOF\n"));
+
+    fail = 1;
+    cr_assert(acvp_openmetrics_write(om, &om_writer, &fail) == ACVP_TRANSPORT_FAIL);
+
+    acvp_set_openmetrics(ctx, NULL);
+    teardown_ctx(&ctx);
+    cr_assert(acvp_openmetrics_free(om) == ACVP_SUCCESS);
+}
+
+static ACVP_SPAN trace_spans[8];
+static int trace_starts, trace_ends;
+
+static void trace_start(const ACVP_SPAN *span, void *arg) {
+    (void)arg;
+    cr_assert(!span->end_ns);
+    trace_starts++;
+}
+
+static void trace_end(const ACVP_SPAN *span, void *arg) {
+    (void)arg;
+    cr_assert(span->end_ns >= span->start_ns);
+    if (trace_ends < 8) {
+        trace_spans[trace_ends] = *span;
+    }
+    trace_ends++;
+}
+
+/*
+ * Test that trace spans nest, the test group spans inside the span open as
+ * the groups start
+ */
+Test(Trace, nesting) {
+    ACVP_SPAN handler, transport;
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_set_trace_cb(NULL, NULL, &trace_end, NULL) == ACVP_NO_CTX);
+    cr_assert(acvp_set_trace_cb(ctx, &trace_start, NULL, NULL) == ACVP_INVALID_ARG);
+
+    /* Nothing while there is no callback */
+    acvp_span_begin(ctx, &handler, ACVP_SPAN_KAT_HANDLER);
+    cr_assert(!handler.span_id && !ctx->exec.span_cur);
+    acvp_span_end(ctx, &handler, ACVP_SUCCESS);
+
+    cr_assert(acvp_set_trace_cb(ctx, &trace_start, &trace_end, NULL) == ACVP_SUCCESS);
+    ctx->exec.vs_id = 42;
+    acvp_span_begin(ctx, &handler, ACVP_SPAN_KAT_HANDLER);
+    cr_assert(handler.span_id && !handler.parent_id);
+    acvp_span_tg_begin(ctx, 1);
+    acvp_span_tg_begin(ctx, 2);
+    acvp_span_begin(ctx, &transport, ACVP_SPAN_TRANSPORT);
+    acvp_span_end(ctx, &transport, ACVP_TRANSPORT_FAIL);
+    acvp_span_tg_end(ctx);
+    acvp_span_end(ctx, &handler, ACVP_SUCCESS);
+    cr_assert(!ctx->exec.span_cur);
+
+    cr_assert(trace_starts == 4 && trace_ends == 4);
+    cr_assert(trace_spans[0].type == ACVP_SPAN_TEST_GROUP && trace_spans[0].tg_id == 1);
+    cr_assert(trace_spans[0].parent_id == trace_spans[3].span_id);
+    cr_assert(trace_spans[1].type == ACVP_SPAN_TRANSPORT);
+    cr_assert(trace_spans[1].parent_id == trace_spans[2].span_id);
+    cr_assert(trace_spans[1].result == ACVP_TRANSPORT_FAIL);
+    cr_assert(trace_spans[2].tg_id == 2 && trace_spans[2].parent_id == trace_spans[3].span_id);
+    cr_assert(trace_spans[3].type == ACVP_SPAN_KAT_HANDLER && trace_spans[3].vs_id == 42);
+    cr_assert(!strcmp(trace_spans[3].name, "acvp.kat_handler"));
+    teardown_ctx(&ctx);
+}
+
+/*
+ * Test the crypto handler latency histograms and the slowest test cases
+ * kept for the session info file
+ */
+Test(CryptoLatency, histogram) {
+    ACVP_LATENCY lat;
+    ACVP_SYM_CIPHER_TC stc;
+    ACVP_TEST_CASE tc;
+    JSON_Value *val = NULL;
+    JSON_Array *tests = NULL;
+    JSON_Object *obj = NULL;
+    int i = 0;
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_set_crypto_latency(ctx, 0, 2) == ACVP_INVALID_ARG);
+    cr_assert(acvp_set_crypto_latency(ctx, 1, ACVP_LAT_SLOWEST_MAX + 1) == ACVP_INVALID_ARG);
+    cr_assert(acvp_set_crypto_latency(ctx, 1, 2) == ACVP_SUCCESS);
+    cr_assert(acvp_get_crypto_latency(ctx, ACVP_AES_GCM, NULL) == ACVP_INVALID_ARG);
+    cr_assert(acvp_get_crypto_latency(ctx, ACVP_AES_GCM, &lat) == ACVP_SUCCESS);
+    cr_assert(lat.count == 0);
+
+    memset(&stc, 0, sizeof(stc));
+    tc.tc.symmetric = &stc;
+    ctx->exec.vs_id = 7;
+    ctx->exec.cipher = ACVP_AES_GCM;
+    acvp_lat_vs_begin(ctx, ACVP_AES_GCM);
+    ctx->exec.lat_tc_id_off = (int)offsetof(ACVP_SYM_CIPHER_TC, tc_id);
+    ctx->exec.tg_id = 3;
+    /* 1us to 100us, then one slow test case */
+    for (i = 1; i <= 100; i++) {
+        stc.tc_id = i;
+        acvp_lat_add(ctx, i * 1000ULL, 1, &tc);
+    }
+    stc.tc_id = 500;
+    acvp_lat_add(ctx, 5000000ULL, 1, &tc);
+    /* A batch: counted, but not kept as the slowest */
+    acvp_lat_add(ctx, 90000000ULL, 9, NULL);
+    acvp_lat_vs_done(ctx);
+
+    cr_assert(acvp_get_crypto_latency(ctx, ACVP_AES_GCM, &lat) == ACVP_SUCCESS);
+    cr_assert(lat.count == 110);
+    cr_assert(lat.min_ns == 1000);
+    cr_assert(lat.max_ns == 10000000ULL);
+    cr_assert(lat.p50_ns >= 55000 && lat.p50_ns <= 55000 + 55000 / 16);
+    cr_assert(lat.p99_ns == 10000000ULL);
+
+    val = acvp_lat_slowest_json(ctx);
+    cr_assert(val != NULL);
+    obj = json_array_get_object(json_value_get_array(val), 0);
+    cr_assert(json_object_get_uint(obj, "vsId") == 7);
+    tests = json_object_get_array(obj, "tests");
+    cr_assert(json_array_get_count(tests) == 2);
+    cr_assert(json_object_get_uint(json_array_get_object(tests, 0), "tcId") == 500);
+    cr_assert(json_object_get_uint(json_array_get_object(tests, 0), "tgId") == 3);
+    cr_assert(json_object_get_uint(json_array_get_object(tests, 1), "tcId") == 100);
+    json_value_free(val);
+    teardown_ctx(&ctx);
+}
+
+/*
+ * Test the adaptive transfer limit: raised after a window that used all
+ * of its slots, halved once per round trip on a 5xx or 429
+ */
+Test(AdaptiveTransfers, aimd) {
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_get_transfer_limit(ctx) == 0);
+    cr_assert(acvp_set_adaptive_transfers(ctx, 1) == ACVP_SUCCESS);
+    cr_assert(acvp_get_transfer_limit(ctx) == 2);
+
+    acvp_xfer_acquire(ctx);
+    acvp_xfer_acquire(ctx);
+    acvp_xfer_release(ctx, 200, 1000, 1000000ULL);
+    acvp_xfer_release(ctx, 200, 1000, 1000000ULL);
+    cr_assert(acvp_get_transfer_limit(ctx) == 3);
+
+    acvp_xfer_acquire(ctx);
+    acvp_xfer_release(ctx, 503, 0, 1000000000ULL);
+    cr_assert(acvp_get_transfer_limit(ctx) == 1);
+    /* Within the same round trip, and never below 1 */
+    acvp_xfer_acquire(ctx);
+    acvp_xfer_release(ctx, 429, 0, 1000ULL);
+    cr_assert(acvp_get_transfer_limit(ctx) == 1);
+
+    cr_assert(acvp_set_adaptive_transfers(ctx, 0) == ACVP_SUCCESS);
+    cr_assert(acvp_get_transfer_limit(ctx) == 0);
+    teardown_ctx(&ctx);
+}
+
+/*
+ * Test the hedge delay: none until enough GETs have been seen, then the
+ * 95th percentile of their time to the first byte, but never below the
+ * minimum
+ */
+Test(HedgedRequests, p95_delay) {
+    int i = 0;
+
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_set_request_timeout(ctx, -1) == ACVP_INVALID_ARG);
+    cr_assert(acvp_set_request_timeout(ctx, 5000) == ACVP_SUCCESS);
+    cr_assert(acvp_get_hedge_delay(ctx) == 0);
+    cr_assert(acvp_set_hedged_requests(ctx, 1) == ACVP_SUCCESS);
+
+    for (i = 0; i < ACVP_HEDGE_SAMPLES_MIN - 1; i++) {
+        acvp_hedge_record(ctx, 50000000ULL, 0, 0);
+    }
+    cr_assert(acvp_get_hedge_delay(ctx) == 0);
+
+    /* 1..100 ms, the oldest 36 fall out of the ring */
+    for (i = 1; i <= 100; i++) {
+        acvp_hedge_record(ctx, i * 1000000ULL, 0, 0);
+    }
+    cr_assert(acvp_get_hedge_delay(ctx) == 97);
+
+    for (i = 0; i < ACVP_HEDGE_SAMPLES; i++) {
+        acvp_hedge_record(ctx, 1000000ULL, 1, i & 1);
+    }
+    cr_assert(acvp_get_hedge_delay(ctx) == ACVP_HEDGE_DELAY_MIN_MS);
+
+    cr_assert(acvp_set_hedged_requests(ctx, 0) == ACVP_SUCCESS);
+    cr_assert(acvp_get_hedge_delay(ctx) == 0);
+    teardown_ctx(&ctx);
+}
+
+/*
+ * Test hex to limbs, least significant limb first, with the leading zero
+ * limbs dropped
+ */
+Test(BigNum, hexstr_to_bn) {
+    ACVP_BN bn = { 0 };
+
+    cr_assert(acvp_hexstr_to_bn("00000000000000000102030405060708090a", &bn, 32) == ACVP_SUCCESS);
+    cr_assert(bn.limbs_cnt == 2);
+    cr_assert(bn.limbs[0] == 0x030405060708090aULL);
+    cr_assert(bn.limbs[1] == 0x0102ULL);
+    cr_assert(bn.bits == 73);
+    acvp_bn_free(&bn);
+    cr_assert(bn.limbs == NULL && bn.limbs_cnt == 0);
+
+    cr_assert(acvp_hexstr_to_bn("0000", &bn, 16) == ACVP_SUCCESS);
+    cr_assert(bn.limbs_cnt == 1);
+    cr_assert(bn.limbs[0] == 0 && bn.bits == 0);
+    acvp_bn_free(&bn);
+
+    cr_assert(acvp_hexstr_to_bn("010203", &bn, 2) == ACVP_DATA_TOO_LARGE);
+    cr_assert(acvp_hexstr_to_bn("123", &bn, 16) == ACVP_UNSUPPORTED_OP);
+    cr_assert(acvp_hexstr_to_bn(NULL, &bn, 16) == ACVP_INVALID_ARG);
+    cr_assert(bn.limbs == NULL);
+}
+
+/* A device link that is never used */
+static int idle_send(void *arg, const unsigned char *buf, unsigned int len) {
+    (void)arg; (void)buf; (void)len;
+    return -1;
+}
+
+static int idle_recv(void *arg, unsigned char *buf, unsigned int len) {
+    (void)arg; (void)buf; (void)len;
+    return -1;
+}
+
+/*
+ * Test the limbs option is only taken by the families that read numbers
+ */
+Test(BigNum, cap_set_bn_limbs) {
+    ACVP_CAPS_LIST *cap = NULL;
+    ACVP_DUT *dut = NULL;
+
+    cr_assert(acvp_cap_set_bn_limbs(NULL, ACVP_DSA_SIGVER, 1) == ACVP_NO_CTX);
+    setup_empty_ctx(&ctx);
+    cr_assert(acvp_cap_set_bn_limbs(ctx, ACVP_DSA_SIGVER, 1) == ACVP_NO_CAP);
+    cr_assert(acvp_cap_dsa_enable(ctx, ACVP_DSA_SIGVER, &dummy_handler_success) == ACVP_SUCCESS);
+    cr_assert(acvp_cap_set_bn_limbs(ctx, ACVP_DSA_SIGVER, 1) == ACVP_SUCCESS);
+    cap = acvp_locate_cap_entry(ctx, ACVP_DSA_SIGVER);
+    cr_assert(acvp_bn_limbs_enabled(cap));
+    cr_assert(acvp_dut_create(&idle_send, &idle_recv, NULL, &dut) == ACVP_SUCCESS);
+    cap->dut = dut;
+    cr_assert(!acvp_bn_limbs_enabled(cap));
+    cap->dut = NULL;
+    acvp_dut_free(dut);
+    cr_assert(acvp_cap_set_bn_limbs(ctx, ACVP_DSA_SIGVER, 0) == ACVP_SUCCESS);
+    cr_assert(!acvp_bn_limbs_enabled(cap));
+    cr_assert(acvp_cap_set_bn_limbs(ctx, ACVP_AES_GCM, 1) == ACVP_INVALID_ARG);
+    teardown_ctx(&ctx);
+}
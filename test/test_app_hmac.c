@@ -130,3 +130,56 @@ Test(APP_HMAC_HANDLER, disposition_mem_not_allocated) {
     free(hmac_tc);
     free(test_case);
 }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/*
+ * Test cases run with the context of a group handler, keyed again only when
+ * the key_id changes, give the same MACs as those run on their own
+ */
+Test(APP_HMAC_HANDLER, group_ctx) {
+    unsigned char key1[16] = { 0x01 }, key2[16] = { 0x02 }, msg[32] = { 0xa5 };
+    unsigned char expect[2][ACVP_HMAC_MAC_BYTE_MAX];
+    unsigned char *keys[] = { key1, key2, key1, key1 };
+    unsigned int key_ids[] = { 1, 2, 1, 1 };
+    ACVP_HMAC_TC group_tc;
+    ACVP_TEST_CASE group_case;
+    int i;
+
+    hmac_tc = calloc(1, sizeof(ACVP_HMAC_TC));
+    test_case = calloc(1, sizeof(ACVP_TEST_CASE));
+    cr_assert(hmac_tc && test_case);
+    test_case->tc.hmac = hmac_tc;
+    hmac_tc->cipher = ACVP_HMAC_SHA2_256;
+    hmac_tc->msg = msg;
+    hmac_tc->msg_len = sizeof(msg);
+    hmac_tc->key_len = sizeof(key1);
+
+    for (i = 0; i < 2; i++) {
+        hmac_tc->key = keys[i];
+        hmac_tc->mac = expect[i];
+        cr_assert(app_hmac_handler(test_case) == 0);
+    }
+
+    memset(&group_tc, 0x0, sizeof(ACVP_HMAC_TC));
+    group_tc.cipher = ACVP_HMAC_SHA2_256;
+    group_case.tc.hmac = &group_tc;
+    cr_assert(app_hmac_group_handler(&group_case, ACVP_TG_BEGIN) == 0);
+    cr_assert(group_tc.tg_ctx != NULL);
+
+    hmac_tc->tg_ctx = group_tc.tg_ctx;
+    for (i = 0; i < 4; i++) {
+        unsigned char mac[ACVP_HMAC_MAC_BYTE_MAX] = { 0 };
+
+        hmac_tc->key = keys[i];
+        hmac_tc->key_id = key_ids[i];
+        hmac_tc->mac = mac;
+        cr_assert(app_hmac_handler(test_case) == 0);
+        cr_assert(memcmp(mac, expect[key_ids[i] - 1], hmac_tc->mac_len) == 0);
+    }
+
+    cr_assert(app_hmac_group_handler(&group_case, ACVP_TG_END) == 0);
+    cr_assert(group_tc.tg_ctx == NULL);
+    free(hmac_tc);
+    free(test_case);
+}
+#endif
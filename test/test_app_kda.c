@@ -31,6 +31,7 @@ void free_kda_hkdf_tc(ACVP_KDA_HKDF_TC *stc) {
     if (stc->vEphemeralData) free(stc->vEphemeralData);
     if (stc->providedDkm) free(stc->providedDkm);
     if (stc->outputDkm) free(stc->outputDkm);
+    if (stc->fixedInfo) free(stc->fixedInfo);
     free(stc);
 }
 
@@ -47,9 +48,39 @@ void free_kda_onestep_tc(ACVP_KDA_ONESTEP_TC *stc) {
     if (stc->vEphemeralData) free(stc->vEphemeralData);
     if (stc->providedDkm) free(stc->providedDkm);
     if (stc->outputDkm) free(stc->outputDkm);
+    if (stc->fixedInfo) free(stc->fixedInfo);
     free(stc);
 }
 
+/*
+ * libacvp assembles fixedInfo from the group's fixedInfoPattern before the
+ * app sees the test case; stand in for that with uPartyId || vPartyId
+ * whenever the pattern given is one libacvp would accept.
+ */
+static int set_fixed_info(ACVP_KDA_PATTERN_CANDIDATE *fixedArr,
+                          unsigned char *uPartyId, int uPartyIdLen,
+                          unsigned char *vPartyId, int vPartyIdLen,
+                          unsigned char **fixedInfo, int *fixedInfoLen) {
+    int i = 0;
+
+    if (!fixedArr || !uPartyId || !vPartyId) {
+        return 1;
+    }
+    for (i = 0; i < ACVP_KDA_PATTERN_MAX && fixedArr[i] != ACVP_KDA_PATTERN_NONE; i++) {
+        if (fixedArr[i] >= ACVP_KDA_PATTERN_MAX) {
+            return 1;
+        }
+    }
+    *fixedInfo = calloc(uPartyIdLen + vPartyIdLen, 1);
+    if (!*fixedInfo) {
+        return 0;
+    }
+    memcpy_s(*fixedInfo, uPartyIdLen + vPartyIdLen, uPartyId, uPartyIdLen);
+    memcpy_s(*fixedInfo + uPartyIdLen, vPartyIdLen, vPartyId, vPartyIdLen);
+    *fixedInfoLen = uPartyIdLen + vPartyIdLen;
+    return 1;
+}
+
 int initialize_kda_hkdf_tc(ACVP_KDA_HKDF_TC *stc,
                             ACVP_HASH_ALG hmac_alg,
                             const char *salt,
@@ -187,6 +218,11 @@ int initialize_kda_hkdf_tc(ACVP_KDA_HKDF_TC *stc,
         }
     }
 
+    if (!set_fixed_info(fixedArr, stc->uPartyId, stc->uPartyIdLen, stc->vPartyId,
+                        stc->vPartyIdLen, &stc->fixedInfo, &stc->fixedInfoLen)) {
+        goto err;
+    }
+
     return 1;
 
 err:
@@ -328,6 +364,11 @@ int initialize_kda_onestep_tc(ACVP_KDA_ONESTEP_TC *stc,
         }
     }
 
+    if (!set_fixed_info(fixedArr, stc->uPartyId, stc->uPartyIdLen, stc->vPartyId,
+                        stc->vPartyIdLen, &stc->fixedInfo, &stc->fixedInfoLen)) {
+        goto err;
+    }
+
     return 1;
 
 err:
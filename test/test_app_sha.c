@@ -309,3 +309,77 @@ Test(APP_SHA_HANDLER, properly_sha384_37456) {
     free(tmp);
 }
 
+
+/*
+ * Runs the MCT of alg through app_sha_mct_loop_handler() and, one
+ * checkpoint at a time, through app_sha_mct_handler(), seeding each
+ * checkpoint as libacvp does; both must give the same checkpoints
+ */
+static int app_sha_mct_loop_matches(ACVP_CIPHER alg, int shake) {
+    ACVP_TEST_CASE loop_case, step_case;
+    ACVP_HASH_TC loop_tc, step_tc;
+    unsigned int stride = shake ? ACVP_HASH_XOF_MD_BYTE_MAX : ACVP_HASH_MD_BYTE_MAX;
+    unsigned int lens[ACVP_HASH_MCT_OUTER];
+    unsigned char *checkpoints = calloc(ACVP_HASH_MCT_OUTER, stride);
+    unsigned char *loop_msg = calloc(1, ACVP_SHAKE_MSG_BYTE_MAX), *step_msg = calloc(1, ACVP_SHAKE_MSG_BYTE_MAX);
+    unsigned char *loop_md = calloc(1, stride), *step_md = calloc(1, stride);
+    int i = 0, good = 0;
+
+    memset(&loop_tc, 0x0, sizeof(ACVP_HASH_TC));
+    loop_tc.cipher = alg;
+    loop_tc.test_type = ACVP_HASH_TEST_TYPE_MCT;
+    loop_tc.msg = loop_msg;
+    loop_tc.msg_len = shake ? 16 : 32;
+    memset(loop_tc.msg, 0xA5, loop_tc.msg_len);
+    loop_tc.md = loop_md;
+    if (shake) {
+        loop_tc.xof_min_len = 16;
+        loop_tc.xof_max_len = 144;
+        loop_tc.xof_len = loop_tc.xof_max_len;
+    }
+    loop_tc.mct_md = checkpoints;
+    loop_tc.mct_md_stride = stride;
+    loop_tc.mct_md_len = lens;
+
+    step_tc = loop_tc;
+    step_tc.msg = step_msg;
+    step_tc.md = step_md;
+    memcpy(step_tc.msg, loop_tc.msg, loop_tc.msg_len);
+
+    loop_case.tc.hash = &loop_tc;
+    step_case.tc.hash = &step_tc;
+    if (app_sha_mct_loop_handler(&loop_case)) {
+        goto end;
+    }
+    for (i = 0; i < ACVP_HASH_MCT_OUTER; i++) {
+        if (app_sha_mct_handler(&step_case) || step_tc.md_len != lens[i] ||
+                memcmp(step_tc.md, checkpoints + (size_t)i * stride, lens[i])) {
+            goto end;
+        }
+        memset(step_tc.msg, 0x0, ACVP_SHAKE_MSG_BYTE_MAX);
+        if (shake) {
+            memcpy(step_tc.msg, step_tc.md, step_tc.md_len < 16 ? step_tc.md_len : 16);
+            step_tc.msg_len = 16;
+        } else {
+            memcpy(step_tc.msg, step_tc.md, step_tc.md_len);
+            step_tc.msg_len = step_tc.md_len;
+        }
+    }
+    good = 1;
+
+end:
+    free(checkpoints);
+    free(loop_msg);
+    free(step_msg);
+    free(loop_md);
+    free(step_md);
+    return good;
+}
+
+Test(APP_SHA_HANDLER, mct_loop_sha3_256) {
+    cr_assert(app_sha_mct_loop_matches(ACVP_HASH_SHA3_256, 0));
+}
+
+Test(APP_SHA_HANDLER, mct_loop_shake_128) {
+    cr_assert(app_sha_mct_loop_matches(ACVP_HASH_SHAKE_128, 1));
+}